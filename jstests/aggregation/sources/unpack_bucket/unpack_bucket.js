@@ -0,0 +1,71 @@
+/**
+ * Tests that $_internalUnpackBucket unpacks time-series bucket documents into measurements, and
+ * that a following $match on the time and meta fields returns the same measurements as filtering
+ * the unpacked measurements directly.
+ */
+(function() {
+    "use strict";
+
+    load("jstests/aggregation/extras/utils.js");  // For arrayEq.
+
+    const coll = db.unpack_bucket;
+    coll.drop();
+
+    // Each bucket holds ten minutes of per-minute measurements from one sensor. Every third
+    // measurement is missing its 'value'.
+    const start = ISODate("2019-06-01T00:00:00Z");
+    const minute = 60 * 1000;
+    let measurements = [];
+    for (let b = 0; b < 6; ++b) {
+        const sensor = "sensor" + (b % 2);
+        let bucket = {
+            _id: b,
+            control: {min: {t: new Date(start.getTime() + b * 10 * minute)}, max: {}},
+            meta: {sensor: sensor},
+            data: {t: {}, value: {}}
+        };
+        for (let i = 0; i < 10; ++i) {
+            const t = new Date(start.getTime() + (b * 10 + i) * minute);
+            bucket.data.t[i] = t;
+            bucket.control.max.t = t;
+            let measurement = {t: t};
+            if (i % 3 !== 0) {
+                bucket.data.value[i] = b * 10 + i;
+                measurement.value = b * 10 + i;
+            }
+            measurement.m = {sensor: sensor};
+            measurements.push(measurement);
+        }
+        assert.writeOK(coll.insert(bucket));
+    }
+    assert.commandWorked(coll.createIndex({"control.max.t": 1, "control.min.t": 1}));
+
+    const unpackStage = {$_internalUnpackBucket: {timeField: "t", metaField: "m"}};
+    const unpacked = coll.aggregate([unpackStage, {$project: {_id: 0}}]).toArray();
+    assert(arrayEq(measurements, unpacked), tojson(unpacked));
+
+    const cutoff = new Date(start.getTime() + 25 * minute);
+    const filters = [
+        {t: {$gte: cutoff}},
+        {t: {$lt: cutoff}},
+        {t: cutoff},
+        {t: {$gt: cutoff, $lte: new Date(cutoff.getTime() + 10 * minute)}, "m.sensor": "sensor1"},
+        {m: {sensor: "sensor0"}, value: {$gt: 20}},
+    ];
+
+    // Compare against the same filters applied to a collection of the unpacked measurements.
+    const expectedColl = db.unpack_bucket_expected;
+    expectedColl.drop();
+    assert.writeOK(expectedColl.insert(measurements));
+    for (let filter of filters) {
+        const expected = expectedColl.find(filter, {_id: 0}).toArray();
+        const actual =
+            coll.aggregate([unpackStage, {$match: filter}, {$project: {_id: 0}}]).toArray();
+        assert(arrayEq(expected, actual), tojson({filter: filter, actual: actual}));
+    }
+
+    assert.commandFailedWithCode(
+        db.runCommand(
+            {aggregate: coll.getName(), pipeline: [{$_internalUnpackBucket: {}}], cursor: {}}),
+        ErrorCodes.FailedToParse);
+})();
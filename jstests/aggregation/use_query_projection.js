@@ -89,6 +89,17 @@
     assertQueryCoversProjection(
         {pipeline: [{$match: {_id: 0, x: "string"}}, {$project: {_id: 1, x: 1, a: 1}}]});
 
+    // Test that a pipeline with no $match or $sort whose dependencies are all in the index can scan
+    // the whole index instead of the collection.
+    assertQueryCoversProjection({
+        pipeline: [{$group: {_id: "$x", total: {$sum: "$a"}}}],
+        pipelineOptimizedAway: false
+    });
+    assertQueryCoversProjection(
+        {pipeline: [{$project: {_id: 0, x: 1, a: 1}}, {$skip: 1}], pipelineOptimizedAway: false});
+    assert.eq([{_id: "string", total: -4950}],
+              coll.aggregate([{$group: {_id: "$x", total: {$sum: "$a"}}}]).toArray());
+
     // Test that a pipeline requiring a field that is not in the index cannot use a covered plan.
     assertQueryDoesNotCoverProjection({
         pipeline: [{$match: {x: "string"}}, {$project: {notThere: 1}}],
@@ -0,0 +1,42 @@
+// Tests that benchRun reports latency percentiles and that 'opsPerSecond' limits the rate at which
+// operations are started.
+// @tags: [
+//   uses_multiple_connections,
+// ]
+(function() {
+    "use strict";
+
+    const coll = db.bench_test_open_loop;
+    coll.drop();
+    assert.writeOK(coll.insert({_id: 1, x: 1}));
+
+    const seconds = 5;
+    const opsPerSecond = 100;
+    const benchArgs = {
+        ops: [{op: "findOne", ns: coll.getFullName(), query: {_id: 1}}],
+        parallel: 2,
+        seconds: seconds,
+        opsPerSecond: opsPerSecond,
+        host: db.getMongo().host
+    };
+
+    if (jsTest.options().auth) {
+        benchArgs['db'] = 'admin';
+        benchArgs['username'] = jsTest.options().authUser;
+        benchArgs['password'] = jsTest.options().authPassword;
+    }
+    const res = benchRun(benchArgs);
+
+    // The workers start operations on a fixed schedule rather than as fast as they can.
+    assert.gt(res.findOnes, 0, tojson(res));
+    assert.lte(res.findOnes, opsPerSecond * seconds * 1.1, tojson(res));
+
+    const latencies = res.findOneLatencyMicros;
+    assert(latencies, tojson(res));
+    assert.lte(latencies.p50, latencies.p95, tojson(res));
+    assert.lte(latencies.p95, latencies.p99, tojson(res));
+    assert.lte(latencies.p99, latencies.p99_9, tojson(res));
+    assert.lte(latencies.p99_9, latencies.max, tojson(res));
+
+    assert.throws(() => benchRun(Object.merge(benchArgs, {opsPerSecond: -1})));
+})();
@@ -0,0 +1,33 @@
+/**
+ * Tests simple top-level inclusion projections, which copy runs of adjacent included fields, on
+ * documents where included and excluded fields interleave.
+ */
+(function() {
+    "use strict";
+
+    let coll = db.projection_simple_inclusion;
+    coll.drop();
+
+    let doc = {_id: 0};
+    for (let i = 0; i < 100; i++) {
+        doc["f" + i] = i;
+    }
+    const longName = "aFieldNameWhichIsLongerThanSixtyThreeCharactersSoThatItSharesALengthBit";
+    const otherLongName = "anotherFieldNameLongerThanSixtyThreeCharactersWhichSharesThatLengthBit";
+    doc[longName] = "x";
+    doc[otherLongName] = "y";
+    assert.writeOK(coll.insert(doc));
+
+    // A run at the start, a run in the middle, and a single field at the end.
+    assert.eq({_id: 0, f0: 0, f1: 1, f50: 50, f51: 51, f52: 52, f99: 99},
+              coll.findOne({}, {f0: 1, f1: 1, f50: 1, f51: 1, f52: 1, f99: 1}));
+
+    // Without _id, fields in projection order that differs from document order.
+    assert.eq({f3: 3, f10: 10}, coll.findOne({}, {f10: 1, _id: 0, f3: 1}));
+
+    // Names of 63 or more characters are told apart by name, not only by their length.
+    assert.eq({_id: 0, [otherLongName]: "y"}, coll.findOne({}, {[otherLongName]: 1}));
+
+    // Fields which do not exist are skipped.
+    assert.eq({_id: 0, f7: 7}, coll.findOne({}, {f7: 1, missing: 1}));
+})();
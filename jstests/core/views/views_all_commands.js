@@ -110,6 +110,7 @@
         abortTransaction: {skip: isUnrelated},
         addShard: {skip: isUnrelated},
         addShardToZone: {skip: isUnrelated},
+        analyze: {command: {analyze: "view"}, expectFailure: true, skipSharded: true},
         aggregate: {command: {aggregate: "view", pipeline: [{$match: {}}], cursor: {}}},
         appendOplogNote: {skip: isUnrelated},
         applyOps: {
@@ -0,0 +1,53 @@
+/**
+ * Tests that online compaction reclaims space from a collection and its indexes while other
+ * operations keep writing to the collection, and that it validates its options.
+ * @tags: [requires_wiredtiger, requires_persistence]
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const coll = testDB.compact_online;
+
+    assert.commandWorked(coll.createIndex({a: 1}));
+    const payload = "x".repeat(1000);
+    let bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 20000; ++i) {
+        bulk.insert({_id: i, a: i, payload: payload});
+    }
+    assert.writeOK(bulk.execute());
+    assert.writeOK(coll.remove({_id: {$gte: 1000}}));
+    assert.commandWorked(testDB.adminCommand({fsync: 1}));
+
+    assert.commandFailedWithCode(coll.runCommand("compact", {maxBytesPerSecond: 1024}),
+                                 ErrorCodes.InvalidOptions);
+    assert.commandFailedWithCode(
+        coll.runCommand("compact", {online: true, maxBytesPerSecond: -1}),
+        ErrorCodes.InvalidOptions);
+    assert.commandFailedWithCode(testDB.runCommand({compact: "missing", online: true}),
+                                 ErrorCodes.NamespaceNotFound);
+
+    // Writes proceed while the compaction runs.
+    const awaitWriter = startParallelShell(function() {
+        const coll = db.getSiblingDB("test").compact_online;
+        for (let i = 0; i < 500; ++i) {
+            assert.writeOK(coll.insert({_id: 100000 + i, a: i}));
+        }
+    }, conn.port);
+
+    const res = assert.commandWorked(coll.runCommand("compact", {online: true}));
+    awaitWriter();
+    assert.gte(res.bytesReclaimed, 0, tojson(res));
+
+    assert.eq(1500, coll.find().itcount());
+    assert.eq(1500, coll.find().hint({a: 1}).itcount());
+    assert.commandWorked(coll.validate({full: true}));
+
+    // A throttled compaction completes too.
+    assert.commandWorked(coll.runCommand("compact", {online: true, maxBytesPerSecond: 1 << 30}));
+    assert.eq(1500, coll.find().itcount());
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,42 @@
+// Tests that the count command's 'estimateSampleSize' option estimates large counts from a random
+// sample of documents, and falls back to an exact count when the collection is small.
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const coll = testDB.getCollection(jsTest.name());
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 10000; i++) {
+        bulk.insert({_id: i, status: (i % 4 === 0) ? "open" : "closed"});
+    }
+    assert.commandWorked(bulk.execute());
+
+    // A sample of 1000 documents estimates the 2500 open documents to within a few hundred.
+    let res = assert.commandWorked(testDB.runCommand(
+        {count: coll.getName(), query: {status: "open"}, estimateSampleSize: 1000}));
+    assert.eq(true, res.estimated, tojson(res));
+    assert.between(2000, res.n, 3000, tojson(res));
+
+    // Limit and skip are applied to the estimate.
+    res = assert.commandWorked(testDB.runCommand(
+        {count: coll.getName(), query: {status: "open"}, estimateSampleSize: 1000, limit: 10}));
+    assert.eq(10, res.n, tojson(res));
+
+    // A sample at least as large as the collection yields the exact count.
+    res = assert.commandWorked(testDB.runCommand(
+        {count: coll.getName(), query: {status: "open"}, estimateSampleSize: 10000}));
+    assert.eq(2500, res.n, tojson(res));
+    assert(!res.hasOwnProperty("estimated"), tojson(res));
+
+    assert.commandFailedWithCode(
+        testDB.runCommand({count: coll.getName(), estimateSampleSize: 0}), ErrorCodes.BadValue);
+
+    assert.commandWorked(testDB.createView("view", coll.getName(), []));
+    assert.commandFailedWithCode(testDB.runCommand({count: "view", estimateSampleSize: 10}),
+                                 ErrorCodes.OptionNotSupportedOnView);
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,61 @@
+/**
+ * Tests the 'hashRanges' option of the dbHash command, which hashes a collection in _id ranges so
+ * that only the ranges which differ need to be compared further.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const coll = testDB.getCollection(jsTest.name());
+
+    assert.commandWorked(coll.insert(Array.from({length: 1000}, (_, i) => ({_id: i, x: i}))));
+
+    const hashRanges = function(spec) {
+        spec.collection = coll.getName();
+        return assert.commandWorked(testDB.runCommand({dbHash: 1, hashRanges: spec})).ranges;
+    };
+
+    // The documents are split evenly over the requested number of ranges.
+    const ranges = hashRanges({numRanges: 10});
+    assert.eq(10, ranges.length, tojson(ranges));
+    ranges.forEach(range => assert.eq(100, range.count, tojson(ranges)));
+    assert.eq(MinKey, ranges[0].min, tojson(ranges));
+    assert.eq(MaxKey, ranges[9].max, tojson(ranges));
+
+    // Hashing with the bounds reported by the first request gives the same ranges back, which is
+    // how another member would hash the same ranges.
+    const bounds = ranges.map(range => range.min).concat([MaxKey]);
+    assert.eq(ranges, hashRanges({bounds: bounds}));
+
+    // A change is only reflected in the range containing it.
+    assert.commandWorked(coll.update({_id: 250}, {$set: {x: -1}}));
+    const changed = hashRanges({bounds: bounds});
+    for (let i = 0; i < ranges.length; i++) {
+        assert.eq(i === 2, ranges[i].hash !== changed[i].hash, tojson(changed));
+        assert.eq(ranges[i].count, changed[i].count, tojson(changed));
+    }
+
+    // A differing range can be split further on its own.
+    const subRanges = hashRanges({numRanges: 4, min: ranges[2].min, max: ranges[2].max});
+    assert.eq(4, subRanges.length, tojson(subRanges));
+    assert.eq(100, subRanges.reduce((total, range) => total + range.count, 0), tojson(subRanges));
+
+    // Bounds with no documents in between produce empty ranges.
+    assert.eq([1000, 0],
+              hashRanges({bounds: [MinKey, 1000, MaxKey]}).map(range => range.count));
+
+    assert.commandFailedWithCode(
+        testDB.runCommand(
+            {dbHash: 1, hashRanges: {collection: coll.getName(), numRanges: 2, bounds: [0, 1]}}),
+        ErrorCodes.InvalidOptions);
+    assert.commandFailedWithCode(
+        testDB.runCommand({dbHash: 1, hashRanges: {collection: coll.getName(), bounds: [1, 0]}}),
+        ErrorCodes.InvalidOptions);
+    assert.commandFailedWithCode(
+        testDB.runCommand({dbHash: 1, hashRanges: {collection: "missing", numRanges: 1}}),
+        ErrorCodes.NamespaceNotFound);
+
+    MongoRunner.stopMongod(conn);
+})();
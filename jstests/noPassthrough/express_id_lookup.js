@@ -0,0 +1,48 @@
+// Tests that with 'internalQueryEnableExpressIdLookup' set, finds by _id are answered without a
+// plan executor, and that shapes the express path does not cover still run through the planner.
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const coll = testDB.express_id_lookup;
+
+    assert.commandWorked(coll.insert([{_id: 1, a: 1}, {_id: "x", a: 2}, {_id: {b: 1}, a: 3}]));
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalQueryEnableExpressIdLookup: true}));
+    assert.commandWorked(testDB.setProfilingLevel(2));
+
+    const getProfileEntry = function(comment) {
+        const entry = testDB.system.profile.findOne({"command.comment": comment});
+        assert.neq(null, entry, "no profiler entry for " + comment);
+        return entry;
+    };
+
+    // Point reads are answered by the express path, whether or not the document exists.
+    assert.eq([{_id: 1, a: 1}], coll.find({_id: 1}).comment("int").toArray());
+    assert.eq([{_id: "x", a: 2}], coll.find({_id: "x"}).comment("string").toArray());
+    assert.eq([{_id: {b: 1}, a: 3}], coll.find({_id: {b: 1}}).comment("object").toArray());
+    assert.eq([], coll.find({_id: 2}).comment("missing").toArray());
+    assert.eq({_id: 1, a: 1}, coll.findOne({_id: 1}));
+
+    let entry = getProfileEntry("int");
+    assert.eq("EXPRESS_IDHACK", entry.planSummary, tojson(entry));
+    assert.eq(1, entry.nreturned, tojson(entry));
+    assert.eq(1, entry.docsExamined, tojson(entry));
+    entry = getProfileEntry("missing");
+    assert.eq("EXPRESS_IDHACK", entry.planSummary, tojson(entry));
+    assert.eq(0, entry.nreturned, tojson(entry));
+
+    // A projection takes the regular IDHACK plan.
+    assert.eq([{a: 1}], coll.find({_id: 1}, {_id: 0, a: 1}).comment("projection").toArray());
+    assert.eq("IDHACK", getProfileEntry("projection").planSummary);
+
+    // With the parameter unset, point reads use the plan executor again.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalQueryEnableExpressIdLookup: false}));
+    assert.eq([{_id: 1, a: 1}], coll.find({_id: 1}).comment("disabled").toArray());
+    assert.eq("IDHACK", getProfileEntry("disabled").planSummary);
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,57 @@
+// @tags: [requires_profiling]
+
+// Confirms that a blocking sort in a find command spills to disk when 'allowDiskUse' is set, and
+// that 'usedDisk' is reported in explain and the profiler.
+
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For getPlanStage.
+    load("jstests/libs/profiler.js");      // For getLatestProfilerEntry.
+
+    const conn = MongoRunner.runMongod();
+    const testDB = conn.getDB("find_sort_use_disk");
+    const coll = testDB.getCollection("test");
+
+    coll.drop();
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 100; ++i) {
+        bulk.insert({_id: i, a: 100 - i, pad: "x".repeat(100)});
+    }
+    assert.writeOK(bulk.execute());
+
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalQueryExecMaxBlockingSortBytes: 1000}));
+
+    // Without 'allowDiskUse' the sort fails once it exceeds the memory limit.
+    assert.commandFailedWithCode(
+        testDB.runCommand({find: coll.getName(), sort: {a: 1}}), ErrorCodes.OperationFailed);
+
+    // With 'allowDiskUse' the sort spills and returns every document in order.
+    const results = coll.find().sort({a: 1}).allowDiskUse().toArray();
+    assert.eq(100, results.length);
+    for (let i = 0; i < results.length; ++i) {
+        assert.eq(i + 1, results[i].a, tojson(results[i]));
+    }
+
+    // The same holds for a sort with a limit.
+    const limited = coll.find().sort({a: -1}).limit(50).allowDiskUse().toArray();
+    assert.eq(50, limited.length);
+    assert.eq(100, limited[0].a, tojson(limited[0]));
+    assert.eq(51, limited[49].a, tojson(limited[49]));
+
+    // Explain reports that the sort used disk.
+    const explain = coll.find().sort({a: 1}).allowDiskUse().explain("executionStats");
+    const sortStage = getPlanStage(explain.executionStats.executionStages, "SORT");
+    assert.neq(null, sortStage, tojson(explain));
+    assert.eq(true, sortStage.usedDisk, tojson(explain));
+
+    // The profiler records 'usedDisk' for the find command.
+    testDB.setProfilingLevel(2);
+    assert.eq(100, coll.find().sort({a: 1}).allowDiskUse().itcount());
+    const profileObj = getLatestProfilerEntry(testDB, {op: "query"});
+    assert.eq(true, profileObj.usedDisk, tojson(profileObj));
+    assert.eq(true, profileObj.hasSortStage, tojson(profileObj));
+
+    MongoRunner.stopMongod(conn);
+})();
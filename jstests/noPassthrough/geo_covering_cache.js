@@ -0,0 +1,70 @@
+// Tests that 2dsphere queries return the same results with the S2 covering cache and adaptive
+// $geoNear annuli enabled as without them.
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const coll = testDB.geo_covering_cache;
+
+    assert.commandWorked(coll.createIndex({loc: "2dsphere"}));
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 5000; ++i) {
+        // Dense near the origin, sparse further out.
+        const r = Math.pow(i / 5000, 3) * 20;
+        const theta = i * 2.39996;
+        const coordinates = [r * Math.cos(theta), r * Math.sin(theta)];
+        bulk.insert({_id: i, loc: {type: "Point", coordinates: coordinates}});
+    }
+    assert.writeOK(bulk.execute());
+
+    const setParams = function(enabled) {
+        assert.commandWorked(testDB.adminCommand({
+            setParameter: 1,
+            internalQueryS2CoveringCacheSize: enabled ? 100 : 0,
+            internalGeoNearAdaptiveAnnulus: enabled,
+        }));
+    };
+
+    const runQueries = function() {
+        let results = [];
+        for (let radius of [0.001, 0.01, 0.1]) {
+            for (let i = 0; i < 2; ++i) {
+                results.push(coll.find({loc: {$geoWithin: {$centerSphere: [[0, 0], radius]}}})
+                                 .sort({_id: 1})
+                                 .toArray());
+            }
+        }
+        const polygon = {
+            type: "Polygon",
+            coordinates: [[[-1, -1], [1, -1], [1, 1], [-1, 1], [-1, -1]]]
+        };
+        results.push(coll.find({loc: {$geoWithin: {$geometry: polygon}}}).sort({_id: 1}).toArray());
+        results.push(coll.find({loc: {$geoIntersects: {$geometry: polygon}}})
+                         .sort({_id: 1})
+                         .toArray());
+        results.push(coll.aggregate([
+                             {
+                               $geoNear: {
+                                   near: {type: "Point", coordinates: [0, 0]},
+                                   distanceField: "dist",
+                                   spherical: true
+                               }
+                             },
+                             {$limit: 2000},
+                             {$project: {_id: 1}}
+                         ])
+                         .toArray());
+        return results;
+    };
+
+    setParams(false);
+    const expected = runQueries();
+    setParams(true);
+    assert.eq(expected, runQueries());
+    // Once cached, the coverings are reused.
+    assert.eq(expected, runQueries());
+
+    MongoRunner.stopMongod(conn);
+})();
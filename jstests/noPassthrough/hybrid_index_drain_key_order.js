@@ -0,0 +1,60 @@
+/**
+ * Tests that side writes made during a hybrid index build are drained correctly, now that each
+ * batch of them is applied in index key order rather than in the order they were made. The side
+ * writes include repeated inserts and deletes of the same keys, whose order must be kept.
+ *
+ * @tags: [requires_document_locking, requires_replication]
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/check_log.js");
+
+    const replSetTest = new ReplSetTest({nodes: 1});
+    replSetTest.startSet();
+    replSetTest.initiate();
+
+    const conn = replSetTest.getPrimary();
+    const testDB = conn.getDB("test");
+    const coll = testDB.hybrid_drain;
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; ++i) {
+        bulk.insert({_id: i, a: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    assert.commandWorked(testDB.adminCommand(
+        {configureFailPoint: "hangAfterIndexBuildDumpsInsertsFromBulk", mode: "alwaysOn"}));
+    const awaitBuild = startParallelShell(function() {
+        assert.commandWorked(db.hybrid_drain.createIndex({a: 1}, {background: true}));
+    }, conn.port);
+    checkLog.contains(conn, "Hanging after dumping inserts from bulk builder");
+
+    // Writes in descending key order, several writes to the same documents, and documents which
+    // are inserted, deleted, then inserted again with the same key.
+    for (let i = 999; i >= 0; i -= 3) {
+        assert.writeOK(coll.update({_id: i}, {$set: {a: -i}}));
+        assert.writeOK(coll.update({_id: i}, {$set: {a: i + 0.5}}));
+    }
+    for (let i = 1000; i < 1200; ++i) {
+        assert.writeOK(coll.insert({_id: i, a: i % 7}));
+        assert.writeOK(coll.remove({_id: i}));
+        if (i % 2 === 0) {
+            assert.writeOK(coll.insert({_id: i, a: i % 7}));
+        }
+    }
+    assert.writeOK(coll.remove({_id: {$lt: 100}}));
+
+    assert.commandWorked(testDB.adminCommand(
+        {configureFailPoint: "hangAfterIndexBuildDumpsInsertsFromBulk", mode: "off"}));
+    awaitBuild();
+
+    assert.commandWorked(coll.validate({full: true}));
+    const expected = coll.find({}, {_id: 1, a: 1}).sort({a: 1, _id: 1}).toArray();
+    const actual = coll.find({a: {$gte: MinKey}}, {_id: 1, a: 1}).hint({a: 1}).toArray();
+    actual.sort((x, y) => x.a === y.a ? x._id - y._id : x.a - y.a);
+    assert.eq(expected, actual);
+
+    replSetTest.stopSet();
+})();
@@ -0,0 +1,65 @@
+/**
+ * Tests that with 'maxIndexBuildDrainPassesUnderIntentLocks' set, a hybrid index build drains its
+ * side writes under intent locks instead of stopping writes for a drain under a shared lock, and
+ * that the index build reports the duration of each of its phases in currentOp.
+ *
+ * @tags: [requires_document_locking]
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/check_log.js");
+
+    const conn = MongoRunner.runMongod({
+        setParameter: {
+            maxIndexBuildDrainPassesUnderIntentLocks: 10,
+            maxIndexBuildSideWritesForExclusiveDrain: 0,
+        }
+    });
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB(jsTestName());
+    const coll = testDB.getCollection("test");
+
+    const insertDocs = function(start, count) {
+        let bulk = coll.initializeUnorderedBulkOp();
+        for (let i = start; i < start + count; i++) {
+            bulk.insert({i: i});
+        }
+        assert.commandWorked(bulk.execute());
+    };
+    insertDocs(0, 1000);
+
+    assert.commandWorked(testDB.adminCommand(
+        {configureFailPoint: "hangAfterIndexBuildFirstDrain", mode: "alwaysOn"}));
+    assert.commandWorked(testDB.adminCommand(
+        {configureFailPoint: "hangAfterIndexBuildSecondDrain", mode: "alwaysOn"}));
+
+    const bgBuild = startParallelShell(function() {
+        assert.commandWorked(
+            db.getSiblingDB(jsTestName()).test.createIndex({i: 1}, {background: true}));
+    }, conn.port);
+
+    checkLog.contains(conn, "Hanging after index build first drain");
+
+    // The phases completed so far are reported in currentOp.
+    const ops = testDB.currentOp({"command.createIndexes": coll.getName()}).inprog;
+    assert.eq(1, ops.length, tojson(ops));
+    const phases = ops[0].command.phaseDurationsMillis;
+    assert(phases.hasOwnProperty("collectionScan"), tojson(ops[0]));
+    assert(phases.hasOwnProperty("firstDrain"), tojson(ops[0]));
+
+    // These writes are drained under intent locks, so the drain under a shared lock is skipped.
+    insertDocs(1000, 1000);
+    assert.commandWorked(
+        testDB.adminCommand({configureFailPoint: "hangAfterIndexBuildFirstDrain", mode: "off"}));
+
+    bgBuild();
+    assert(!checkLog.checkContainsOnce(conn, "Hanging after index build second drain"));
+    assert.commandWorked(
+        testDB.adminCommand({configureFailPoint: "hangAfterIndexBuildSecondDrain", mode: "off"}));
+
+    assert.eq(2000, coll.find().hint({i: 1}).itcount());
+    assert.commandWorked(coll.validate({full: true}));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,68 @@
+// Tests that index builds which generate keys with several threads build the same indexes as
+// builds which generate keys with one.
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+
+    const specs = [
+        {key: {a: 1}, name: "a_1"},
+        {key: {"b.c": 1, a: -1}, name: "bc_1_a_-1"},
+        {key: {tags: 1}, name: "tags_1"},
+        {key: {a: 1}, name: "a_1_partial", partialFilterExpression: {a: {$gt: 500}}},
+        {key: {u: 1}, name: "u_1", unique: true},
+        {key: {text: "text"}, name: "text_text"},
+        {key: {"$**": 1}, name: "wildcard"},
+    ];
+
+    const buildIndexes = function(coll, numThreads) {
+        assert.commandWorked(
+            testDB.adminCommand({setParameter: 1, bulkIndexKeyGenerationThreads: numThreads}));
+        coll.drop();
+        const bulk = coll.initializeUnorderedBulkOp();
+        for (let i = 0; i < 5000; ++i) {
+            bulk.insert({
+                _id: i,
+                a: i % 1000,
+                b: {c: "x" + (i % 37)},
+                tags: [i % 3, i % 5, i % 7],
+                u: i,
+                text: "word" + (i % 11) + " other" + (i % 13),
+            });
+        }
+        assert.writeOK(bulk.execute());
+        assert.commandWorked(coll.createIndexes(specs));
+        assert.commandWorked(coll.validate({full: true}));
+    };
+
+    const queries = [
+        {filter: {a: {$gte: 990}}, hint: "a_1"},
+        {filter: {"b.c": "x5"}, hint: "bc_1_a_-1"},
+        {filter: {tags: 4}, hint: "tags_1"},
+        {filter: {a: {$gt: 900}}, hint: "a_1_partial"},
+        {filter: {u: {$lt: 100}}, hint: "u_1"},
+        {filter: {"b.c": "x7"}, hint: "wildcard"},
+    ];
+
+    const runQueries = function(coll) {
+        let results = queries.map(
+            (query) => coll.find(query.filter, {_id: 1}).hint(query.hint).sort({_id: 1}).toArray());
+        results.push(coll.find({$text: {$search: "word3"}}, {_id: 1}).sort({_id: 1}).toArray());
+        return results;
+    };
+
+    buildIndexes(testDB.one_thread, 1);
+    buildIndexes(testDB.many_threads, 8);
+    assert.eq(runQueries(testDB.one_thread), runQueries(testDB.many_threads));
+
+    // Key generation errors still fail the build.
+    const coll = testDB.many_threads;
+    assert.commandFailedWithCode(coll.createIndex({"b.c": 1}, {unique: true}),
+                                 ErrorCodes.DuplicateKey);
+    assert.commandWorked(coll.insert({_id: "badGeo", loc: {type: "Point", coordinates: "bad"}}));
+    assert.commandFailedWithCode(coll.createIndex({loc: "2dsphere"}), 16755);
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,76 @@
+// Tests that with 'mapReduceUseAggregation' enabled, mapReduce commands with recognized map and
+// reduce functions run as aggregations and produce the same output as the JavaScript
+// implementation, while other mapReduce commands still run in JavaScript.
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const coll = testDB.map_reduce_use_aggregation;
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; ++i) {
+        bulk.insert({_id: i, cust: "c" + (i % 17), price: i % 13, status: i % 3 ? "A" : "B"});
+    }
+    assert.writeOK(bulk.execute());
+
+    const map = function() {
+        emit(this.cust, this.price);
+    };
+    const sumReduce = function(key, values) {
+        var total = 0;
+        for (var i = 0; i < values.length; i++) {
+            total += values[i];
+        }
+        return total;
+    };
+    const maxReduce = function(key, values) {
+        return Math.max.apply(Math, values);
+    };
+
+    const runMapReduce = function(reduce, out, query) {
+        const cmd = {mapReduce: coll.getName(), map: map, reduce: reduce, out: out, verbose: true};
+        if (query) {
+            cmd.query = query;
+        }
+        return assert.commandWorked(testDB.runCommand(cmd));
+    };
+
+    const setUseAggregation = function(enabled) {
+        assert.commandWorked(
+            testDB.adminCommand({setParameter: 1, mapReduceUseAggregation: enabled}));
+    };
+
+    for (let reduce of [sumReduce, maxReduce]) {
+        const jsInline = runMapReduce(reduce, {inline: 1}, {status: "A"});
+        runMapReduce(reduce, "js_out");
+
+        setUseAggregation(true);
+        const aggInline = runMapReduce(reduce, {inline: 1}, {status: "A"});
+        assert.eq("aggregation", aggInline.timing.mode, tojson(aggInline));
+        assert.eq(jsInline.results, aggInline.results);
+        assert.eq(jsInline.counts.input, aggInline.counts.input);
+        assert.eq(jsInline.counts.output, aggInline.counts.output);
+
+        const aggOut = runMapReduce(reduce, "agg_out");
+        assert.eq("agg_out", aggOut.result);
+        assert.eq(testDB.js_out.find().sort({_id: 1}).toArray(),
+                  testDB.agg_out.find().sort({_id: 1}).toArray());
+
+        // Merging replaces documents with the same key and keeps the others.
+        assert.writeOK(testDB.agg_out.insert({_id: "extra", value: 1}));
+        const aggMerge = runMapReduce(reduce, {merge: "agg_out"});
+        assert.eq(aggOut.counts.output + 1, aggMerge.counts.output, tojson(aggMerge));
+        setUseAggregation(false);
+    }
+
+    // Unrecognized functions still run in JavaScript.
+    setUseAggregation(true);
+    const res = runMapReduce(function(key, values) {
+        return values.length;
+    }, {inline: 1});
+    assert.neq("aggregation", res.timing.mode, tojson(res));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,32 @@
+// Tests that a batched insert which makes an index multikey writes the catalog once, and that the
+// multikey catalog write counters are reported in serverStatus.
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const coll = testDB.getCollection(jsTest.name());
+
+    assert.commandWorked(coll.createIndex({a: 1}));
+
+    const getMultikeyMetrics = function() {
+        return assert.commandWorked(testDB.serverStatus()).metrics.multikey;
+    };
+
+    const before = getMultikeyMetrics();
+    assert.commandWorked(coll.insert(Array.from({length: 10}, (_, i) => ({_id: i, a: [i, -i]}))));
+    let after = getMultikeyMetrics();
+    assert.eq(1, after.catalogWrites - before.catalogWrites, tojson(after));
+    assert.gt(after.catalogWritesCoalesced, before.catalogWritesCoalesced, tojson(after));
+    assert.eq(9, coll.find({a: {$lt: 0}}).hint({a: 1}).itcount());
+
+    // Once committed, later inserts see the index as multikey and skip the catalog entirely.
+    const committed = after;
+    assert.commandWorked(coll.insert({_id: 10, a: [1, 2]}));
+    after = getMultikeyMetrics();
+    assert.eq(committed.catalogWrites, after.catalogWrites, tojson(after));
+    assert.eq(committed.catalogWritesCoalesced, after.catalogWritesCoalesced, tojson(after));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,58 @@
+/**
+ * Tests that with 'opLatencyHistogramPrecisionBits' and 'opLatencyHistogramsByCommand' set, the
+ * operation latency histograms use log-linear buckets, are broken down by command name and are
+ * sampled into FTDC.
+ */
+(function() {
+    "use strict";
+
+    const kPrecisionBits = 3;
+    const conn = MongoRunner.runMongod({
+        setParameter: {
+            opLatencyHistogramPrecisionBits: kPrecisionBits,
+            opLatencyHistogramsByCommand: true,
+            diagnosticDataCollectionPeriodMillis: 100,
+        }
+    });
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB(jsTestName());
+    const coll = testDB.getCollection("test");
+
+    for (let i = 0; i < 10; i++) {
+        assert.commandWorked(coll.insert({_id: i}));
+        assert.eq(1, coll.find({_id: i}).itcount());
+    }
+
+    // Every reported bucket starts at a log-linear lower bound: below 2^p every latency has its own
+    // bucket, and above it only the top p bits after the leading one may be set.
+    const assertLogLinear = function(histogram) {
+        assert.gt(histogram.length, 0);
+        for (let bucket of histogram) {
+            let micros = bucket.micros;
+            while (micros >= (1 << (kPrecisionBits + 1))) {
+                assert.eq(0, micros % 2, tojson(histogram));
+                micros /= 2;
+            }
+        }
+    };
+
+    const opLatencies =
+        assert.commandWorked(testDB.adminCommand({serverStatus: 1, opLatencies: {histograms: 1}}))
+            .opLatencies;
+    assertLogLinear(opLatencies.reads.histogram);
+    assert.gte(opLatencies.byCommand.find.ops, 10, tojson(opLatencies.byCommand));
+    assert.gte(opLatencies.byCommand.insert.ops, 10, tojson(opLatencies.byCommand));
+    assertLogLinear(opLatencies.byCommand.find.histogram);
+
+    const latencyStats =
+        coll.aggregate([{$collStats: {latencyStats: {histograms: true}}}]).next().latencyStats;
+    assert.gte(latencyStats.writes.ops, 10, tojson(latencyStats));
+    assertLogLinear(latencyStats.writes.histogram);
+
+    assert.soon(function() {
+        const data = assert.commandWorked(testDB.adminCommand({getDiagnosticData: 1})).data;
+        return data.hasOwnProperty("opLatencies") && data.opLatencies.hasOwnProperty("byCommand");
+    });
+
+    MongoRunner.stopMongod(conn);
+})();
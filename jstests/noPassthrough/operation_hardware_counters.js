@@ -0,0 +1,40 @@
+// Tests that with 'operationHardwareCounters' enabled, profiler entries report the hardware
+// performance counters of the operation when the platform makes them available.
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({setParameter: {operationHardwareCounters: true}});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const coll = testDB.operation_hardware_counters;
+
+    for (let i = 0; i < 1000; ++i) {
+        assert.writeOK(coll.insert({_id: i, a: i}));
+    }
+
+    assert.commandWorked(testDB.setProfilingLevel(2));
+    assert.eq(1, coll.find({a: 500}).comment("hwCounters").itcount());
+    assert.commandWorked(testDB.setProfilingLevel(0));
+
+    const entry = testDB.system.profile.findOne({"command.comment": "hwCounters"});
+    assert.neq(null, entry);
+    if (entry.hardwareCounters === undefined) {
+        jsTestLog("Hardware performance counters are unavailable on this host");
+    } else {
+        assert.gt(entry.hardwareCounters.instructions, 0, tojson(entry));
+        assert.gt(entry.hardwareCounters.cycles, 0, tojson(entry));
+        assert.gte(entry.hardwareCounters.cacheMisses, 0, tojson(entry));
+        assert.gte(entry.hardwareCounters.branchMisses, 0, tojson(entry));
+    }
+
+    // Once disabled, operations no longer report the counters.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, operationHardwareCounters: false}));
+    assert.commandWorked(testDB.setProfilingLevel(2));
+    assert.eq(1, coll.find({a: 501}).comment("noHwCounters").itcount());
+    assert.commandWorked(testDB.setProfilingLevel(0));
+    const disabledEntry = testDB.system.profile.findOne({"command.comment": "noHwCounters"});
+    assert.eq(undefined, disabledEntry.hardwareCounters, tojson(disabledEntry));
+
+    MongoRunner.stopMongod(conn);
+})();
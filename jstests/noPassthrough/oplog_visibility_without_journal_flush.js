@@ -0,0 +1,55 @@
+/**
+ * Tests that with 'wiredTigerOplogVisibilityWithoutJournalFlush' set, unjournaled writes become
+ * visible to oplog readers and change streams, and that waiting for oplog visibility still works.
+ * @tags: [requires_replication, requires_wiredtiger, requires_majority_read_concern]
+ */
+(function() {
+    "use strict";
+
+    const rst = new ReplSetTest({
+        nodes: 1,
+        nodeOptions: {setParameter: {wiredTigerOplogVisibilityWithoutJournalFlush: true}}
+    });
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const testDB = primary.getDB(jsTestName());
+    const coll = testDB.getCollection("test");
+    assert.commandWorked(testDB.createCollection(coll.getName()));
+
+    const csCursor = coll.watch();
+    for (let i = 0; i < 10; i++) {
+        assert.commandWorked(coll.insert({_id: i}, {writeConcern: {w: 1, j: false}}));
+    }
+
+    // Every insert shows up in the oplog when read with a forward cursor, which is subject to the
+    // oplog read timestamp.
+    const oplog = primary.getDB("local").oplog.rs;
+    assert.soon(function() {
+        return oplog.find({ns: coll.getFullName(), op: "i"}).itcount() === 10;
+    });
+
+    for (let i = 0; i < 10; i++) {
+        assert.soon(() => csCursor.hasNext());
+        assert.eq(i, csCursor.next().documentKey._id);
+    }
+    csCursor.close();
+
+    // Causally consistent reads wait for all earlier oplog writes to become visible.
+    const session = primary.startSession({causalConsistency: true});
+    const sessionColl = session.getDatabase(testDB.getName()).getCollection(coll.getName());
+    assert.commandWorked(sessionColl.insert({_id: "causal"}, {writeConcern: {w: 1, j: false}}));
+    assert.eq(1, sessionColl.find({_id: "causal"}).readConcern("majority").itcount());
+    session.endSession();
+
+    // The parameter can be turned off at runtime.
+    assert.commandWorked(primary.adminCommand(
+        {setParameter: 1, wiredTigerOplogVisibilityWithoutJournalFlush: false}));
+    assert.commandWorked(coll.insert({_id: "journaled"}));
+    assert.soon(function() {
+        return oplog.find({ns: coll.getFullName(), "o._id": "journaled"}).itcount() === 1;
+    });
+
+    rst.stopSet();
+})();
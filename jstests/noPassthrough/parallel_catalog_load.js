@@ -0,0 +1,50 @@
+/**
+ * Tests that a mongod restarted with 'storageEngineCatalogLoadThreads' > 1 opens every collection
+ * in the catalog, including their indexes, and logs how long each startup phase took.
+ * @tags: [requires_persistence]
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/check_log.js");
+
+    let conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+    const dbpath = conn.dbpath;
+
+    const kNumDbs = 3;
+    const kNumCollsPerDb = 40;
+    for (let d = 0; d < kNumDbs; ++d) {
+        const testDB = conn.getDB("catalog_load_" + d);
+        for (let c = 0; c < kNumCollsPerDb; ++c) {
+            assert.writeOK(testDB["coll" + c].insert({_id: c, a: c}));
+            assert.commandWorked(testDB["coll" + c].createIndex({a: 1}));
+        }
+    }
+    MongoRunner.stopMongod(conn);
+
+    conn = MongoRunner.runMongod(
+        {dbpath: dbpath, noCleanData: true, setParameter: {storageEngineCatalogLoadThreads: 4}});
+    assert.neq(null, conn, "mongod was unable to restart with a parallel catalog load");
+
+    checkLog.contains(conn, "thread(s)");
+    checkLog.contains(conn, "Startup phase 'storage engine initialization' took");
+    checkLog.contains(conn, "Startup phase 'database recovery and version check' took");
+
+    for (let d = 0; d < kNumDbs; ++d) {
+        const testDB = conn.getDB("catalog_load_" + d);
+        assert.eq(kNumCollsPerDb, testDB.getCollectionNames().length);
+        for (let c = 0; c < kNumCollsPerDb; ++c) {
+            const coll = testDB["coll" + c];
+            assert.eq(2, coll.getIndexes().length, tojson(coll.getIndexes()));
+            assert.eq({_id: c, a: c}, coll.find({a: c}).hint({a: 1}).next());
+        }
+    }
+
+    // Collections opened by the parallel load accept writes and new collections can be created.
+    assert.writeOK(conn.getDB("catalog_load_0").coll0.insert({_id: 1000, a: 1000}));
+    assert.writeOK(conn.getDB("catalog_load_new").coll.insert({a: 1}));
+    assert.commandWorked(conn.getDB("catalog_load_0").coll0.validate({full: true}));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,50 @@
+// Tests that with 'queryShapeStatsEnabled' set, queries are aggregated per query shape and can be
+// read back through the $queryShapeStats aggregation stage.
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({setParameter: {queryShapeStatsEnabled: true}});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const adminDB = conn.getDB("admin");
+    const coll = testDB.query_shape_stats;
+
+    const getShapes = function() {
+        return adminDB.aggregate([{$queryShapeStats: {}}, {$match: {ns: coll.getFullName()}}])
+            .toArray();
+    };
+
+    assert.commandFailedWithCode(
+        testDB.runCommand({aggregate: 1, pipeline: [{$queryShapeStats: {}}], cursor: {}}),
+        ErrorCodes.InvalidNamespace);
+
+    for (let i = 0; i < 10; ++i) {
+        assert.writeOK(coll.insert({_id: i, a: i, b: i}));
+    }
+
+    // Queries with the same shape but different constants share an entry.
+    for (let i = 0; i < 5; ++i) {
+        assert.eq(1, coll.find({a: i}).itcount());
+    }
+    assert.eq(1, coll.find({b: 1}).itcount());
+
+    let shapes = getShapes();
+    assert.eq(2, shapes.length, tojson(shapes));
+    const byA = shapes.find((shape) => shape.count === 5);
+    assert.neq(undefined, byA, tojson(shapes));
+    assert.eq(50, byA.docsExamined, tojson(byA));
+    assert.eq(5, byA.nreturned, tojson(byA));
+    assert.eq(5, byA.latencyStats.reads.ops, tojson(byA));
+    assert.gt(byA.bytesReturned, 0, tojson(byA));
+
+    const status = testDB.serverStatus().metrics.queryShapeStats;
+    assert.gte(status.shapes, 2, tojson(status));
+
+    // Once disabled, operations are no longer aggregated.
+    assert.commandWorked(adminDB.runCommand({setParameter: 1, queryShapeStatsEnabled: false}));
+    assert.eq(1, coll.find({a: 1}).itcount());
+    shapes = getShapes();
+    assert.eq(5, shapes.find((shape) => shape.queryHash === byA.queryHash).count, tojson(shapes));
+
+    MongoRunner.stopMongod(conn);
+})();
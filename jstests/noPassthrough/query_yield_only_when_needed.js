@@ -0,0 +1,44 @@
+// Tests that with 'internalQueryExecYieldOnlyWhenNeeded' set, a collection scan which nothing is
+// waiting on skips its periodic yields, and that explain reports the yields and skipped yields.
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const coll = testDB.getCollection(jsTest.name());
+
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalQueryExecYieldIterations: 10}));
+    assert.commandWorked(coll.insert(Array.from({length: 200}, (_, i) => ({_id: i}))));
+
+    const getYieldStats = function() {
+        const explain = coll.find().explain("executionStats");
+        assert.eq(200, explain.executionStats.nReturned, tojson(explain));
+        assert(explain.executionStats.hasOwnProperty("yieldStats"), tojson(explain));
+        return explain.executionStats.yieldStats;
+    };
+
+    // By default every periodic yield releases the plan's locks and snapshot.
+    let stats = getYieldStats();
+    assert.gt(stats.numYields, 0, tojson(stats));
+    assert.eq(stats.numSkippedYields, 0, tojson(stats));
+
+    // With nothing queued behind the scan and a generous snapshot age, yields are skipped.
+    assert.commandWorked(testDB.adminCommand({
+        setParameter: 1,
+        internalQueryExecYieldOnlyWhenNeeded: true,
+        internalQueryExecYieldMaxSnapshotAgeMS: 10 * 60 * 1000
+    }));
+    stats = getYieldStats();
+    assert.gt(stats.numSkippedYields, 0, tojson(stats));
+
+    // A snapshot age of zero makes every periodic yield necessary again.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalQueryExecYieldMaxSnapshotAgeMS: 0}));
+    stats = getYieldStats();
+    assert.gt(stats.numYields, 0, tojson(stats));
+    assert.eq(stats.numSkippedYields, 0, tojson(stats));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,36 @@
+// Tests that the JavaScript scope cache limits can be changed at runtime, including disabling
+// scope reuse entirely, without affecting the results of $where queries.
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod(
+        {setParameter: {scriptingScopeCacheMaxSize: 0, scriptingScopeCacheMaxReuseTimeSecs: 60}});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const coll = testDB.scope_cache;
+
+    for (let i = 0; i < 10; ++i) {
+        assert.writeOK(coll.insert({_id: i, a: i}));
+    }
+
+    const runWhere = function() {
+        assert.eq(5, coll.find({$where: "this.a >= 5"}).itcount());
+        assert.eq(1, coll.find({$where: "this.a == 3"}).itcount());
+    };
+
+    runWhere();
+
+    assert.commandWorked(testDB.adminCommand({setParameter: 1, scriptingScopeCacheMaxSize: 50}));
+    runWhere();
+    runWhere();
+
+    assert.commandFailed(testDB.adminCommand({setParameter: 1, scriptingScopeCacheMaxSize: -1}));
+    assert.commandFailed(
+        testDB.adminCommand({setParameter: 1, scriptingScopeCacheMaxReuseTimeSecs: -1}));
+
+    // Shrinking the cache below the number of idle scopes trims it on the next release.
+    assert.commandWorked(testDB.adminCommand({setParameter: 1, scriptingScopeCacheMaxSize: 1}));
+    runWhere();
+
+    MongoRunner.stopMongod(conn);
+})();
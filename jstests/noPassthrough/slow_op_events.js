@@ -0,0 +1,59 @@
+// Tests that with 'slowOpEventBufferSize' set, slow operations are recorded as structured events
+// that can be read back through the $slowOpEvents aggregation stage, keyed by query shape.
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({setParameter: {slowOpEventBufferSize: 5}});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const adminDB = conn.getDB("admin");
+    const coll = testDB.slow_op_events;
+
+    const getEvents = function() {
+        return adminDB.aggregate([{$slowOpEvents: {}}, {$match: {ns: coll.getFullName()}}])
+            .toArray();
+    };
+
+    assert.commandFailedWithCode(
+        testDB.runCommand({aggregate: 1, pipeline: [{$slowOpEvents: {}}], cursor: {}}),
+        ErrorCodes.InvalidNamespace);
+    assert.commandFailedWithCode(
+        adminDB.runCommand({aggregate: 1, pipeline: [{$slowOpEvents: {x: 1}}], cursor: {}}),
+        ErrorCodes.FailedToParse);
+
+    for (let i = 0; i < 10; ++i) {
+        assert.writeOK(coll.insert({_id: i, a: i}));
+    }
+
+    // Treat every operation as slow.
+    assert.commandWorked(testDB.setProfilingLevel(0, -1));
+    assert.eq(1, coll.find({a: 3}).itcount());
+    assert.eq(1, coll.find({a: 4}).itcount());
+
+    let events = getEvents();
+    assert.eq(2, events.length, tojson(events));
+    assert.eq("find", events[0].command, tojson(events));
+    assert.eq("COLLSCAN", events[0].planSummary, tojson(events));
+    assert.eq(10, events[0].docsExamined, tojson(events));
+    assert.eq(1, events[0].nreturned, tojson(events));
+    assert.gte(events[0].durationMicros, 0, tojson(events));
+
+    // Both queries have the same shape.
+    assert.neq(undefined, events[0].queryHash, tojson(events));
+    assert.eq(events[0].queryHash, events[1].queryHash, tojson(events));
+
+    // The buffer retains only the most recent events.
+    for (let i = 0; i < 10; ++i) {
+        assert.eq(1, coll.find({_id: i}).itcount());
+    }
+    events = adminDB.aggregate([{$slowOpEvents: {}}]).toArray();
+    assert.lte(events.length, 5, tojson(events));
+
+    // A sample rate of zero records nothing.
+    assert.commandWorked(adminDB.runCommand({setParameter: 1, slowOpEventSampleRate: 0}));
+    const countBefore = getEvents().filter((event) => event.op === "query").length;
+    assert.eq(1, coll.find({a: 5}).itcount());
+    assert.eq(countBefore, getEvents().filter((event) => event.op === "query").length);
+
+    MongoRunner.stopMongod(conn);
+})();
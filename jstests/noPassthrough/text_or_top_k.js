@@ -0,0 +1,63 @@
+// Tests that with 'internalQueryTextOrTopK' enabled, a $text query sorted by text score with a
+// limit returns the same results as without it, while fetching only the documents it returns.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For getPlanStage.
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+    const coll = conn.getDB("test").text_or_top_k;
+
+    assert.commandWorked(coll.createIndex({text: "text"}));
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; ++i) {
+        let words = ["apple"];
+        for (let j = 0; j < i % 7; ++j) {
+            words.push("banana");
+        }
+        if (i % 3 === 0) {
+            words.push("cherry");
+        }
+        words.push("filler" + i);
+        bulk.insert({_id: i, text: words.join(" ")});
+    }
+    assert.writeOK(bulk.execute());
+
+    const setTopK = function(enabled) {
+        assert.commandWorked(
+            conn.adminCommand({setParameter: 1, internalQueryTextOrTopK: enabled}));
+    };
+
+    const runQuery = function(search, limit) {
+        return coll.find({$text: {$search: search}}, {score: {$meta: "textScore"}})
+            .sort({score: {$meta: "textScore"}})
+            .limit(limit);
+    };
+
+    const queries = [
+        {search: "apple", limit: 5},
+        {search: "banana cherry", limit: 10},
+        {search: "apple banana cherry", limit: 1},
+        {search: "apple banana cherry", limit: 2000},
+        {search: "banana -cherry", limit: 5},
+        {search: "\"apple banana\"", limit: 5},
+    ];
+
+    for (let query of queries) {
+        setTopK(false);
+        const expected = runQuery(query.search, query.limit).toArray().map((doc) => doc.score);
+        setTopK(true);
+        const actual = runQuery(query.search, query.limit).toArray().map((doc) => doc.score);
+        assert.eq(expected, actual, tojson(query));
+    }
+
+    // With only positive terms, TEXT_OR fetches no more documents than the limit.
+    setTopK(true);
+    const explain = runQuery("banana cherry", 10).explain("executionStats");
+    const textOr = getPlanStage(explain.executionStats.executionStages, "TEXT_OR");
+    assert.neq(null, textOr, tojson(explain));
+    assert.lte(textOr.fetches, 10, tojson(explain));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,55 @@
+// Tests that with 'ttlMonitorBatchedDeletes' enabled the TTL monitor removes every expired
+// document, leaves unexpired documents alone, and works off a backlog that exceeds the per-pass
+// limit.
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({
+        setParameter: {
+            ttlMonitorSleepSecs: 1,
+            ttlMonitorBatchedDeletes: true,
+            ttlMonitorBatchedDeletesBatchSize: 7,
+            ttlMonitorBatchedDeletesPerIndexPerPass: 50,
+        }
+    });
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const coll = testDB.ttl_batched_deletes;
+
+    assert.commandWorked(coll.createIndex({x: 1}, {expireAfterSeconds: 0}));
+
+    const past = new Date(Date.now() - 60 * 1000);
+    const future = new Date(Date.now() + 24 * 60 * 60 * 1000);
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 500; ++i) {
+        bulk.insert({_id: i, x: past});
+    }
+    for (let i = 500; i < 510; ++i) {
+        bulk.insert({_id: i, x: future});
+    }
+    // A document expires as soon as any element of an indexed array does.
+    bulk.insert({_id: 510, x: [future, past]});
+    assert.writeOK(bulk.execute());
+
+    const getDeleted = () => testDB.serverStatus().metrics.ttl.deletedDocuments;
+    const deletedBefore = getDeleted();
+
+    // 501 expired documents need more than the 50 allowed per pass; the monitor keeps going until
+    // only the unexpired documents remain.
+    assert.soon(() => coll.count() === 10, () => "documents left: " + coll.count());
+    assert.eq(501, getDeleted() - deletedBefore);
+    assert.eq(10, coll.find({x: future}).itcount());
+    assert.commandWorked(coll.validate({full: true}));
+
+    // With a deletion rate limit the monitor still removes expired documents.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, ttlMonitorMaxDeletesPerSecond: 100}));
+    const bulk2 = coll.initializeUnorderedBulkOp();
+    for (let i = 1000; i < 1100; ++i) {
+        bulk2.insert({_id: i, x: past});
+    }
+    assert.writeOK(bulk2.execute());
+    assert.soon(() => coll.count() === 10, () => "documents left: " + coll.count());
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,54 @@
+// Tests that with 'internalUpdateInPlaceFastPath' enabled, simple $set and $inc updates produce the
+// same documents and oplog entries as the regular update path, and that other updates still work.
+// @tags: [requires_replication]
+(function() {
+    "use strict";
+
+    const rst = new ReplSetTest({nodes: 1});
+    rst.startSet({setParameter: {internalUpdateInPlaceFastPath: true}});
+    rst.initiate();
+
+    const testDB = rst.getPrimary().getDB("test");
+    const coll = testDB.update_in_place_fast_path;
+    const oplog = rst.getPrimary().getDB("local").oplog.rs;
+    assert.commandWorked(coll.createIndex({indexed: 1}));
+
+    const lastUpdateEntry = function() {
+        return oplog.find({op: "u", ns: coll.getFullName()}).sort({$natural: -1}).limit(1).next();
+    };
+
+    assert.writeOK(coll.insert(
+        {_id: 0, count: NumberInt(1), total: 1.5, flag: false, indexed: 1, name: "a"}));
+
+    // Eligible updates.
+    assert.writeOK(coll.update({_id: 0}, {$inc: {count: NumberInt(2), total: 1}}));
+    assert.eq({$v: 1, $set: {count: 3, total: 2.5}}, lastUpdateEntry().o);
+    assert.writeOK(coll.update({_id: 0}, {$set: {flag: true}}));
+    assert.eq({$v: 1, $set: {flag: true}}, lastUpdateEntry().o);
+
+    // A no-op update matches without modifying the document.
+    let res = assert.writeOK(coll.update({_id: 0}, {$set: {flag: true}}));
+    assert.eq(1, res.nMatched);
+    assert.eq(0, res.nModified);
+
+    // Updates which change the document's layout or indexed fields fall back to the regular path.
+    assert.writeOK(coll.update({_id: 0}, {$inc: {count: NumberInt(2147483647)}}));
+    assert.writeOK(coll.update({_id: 0}, {$set: {name: "longer"}}));
+    assert.writeOK(coll.update({_id: 0}, {$set: {indexed: 2}}));
+    assert.writeOK(coll.update({_id: 0}, {$set: {added: 1}}));
+
+    assert.eq({
+        _id: 0,
+        count: NumberLong(2147483650),
+        total: 2.5,
+        flag: true,
+        indexed: 2,
+        name: "longer",
+        added: 1
+    },
+              coll.findOne());
+    assert.eq(1, coll.find({indexed: 2}).hint({indexed: 1}).itcount());
+    assert.commandWorked(coll.validate({full: true}));
+
+    rst.stopSet();
+})();
@@ -0,0 +1,53 @@
+// Tests that multi-updates batched with 'internalUpdateMultiBatchSize' update every matching
+// document exactly once, keep indexes consistent and replicate one oplog entry per document.
+// @tags: [requires_replication]
+(function() {
+    "use strict";
+
+    const rst = new ReplSetTest({nodes: 2});
+    rst.startSet({setParameter: {internalUpdateMultiBatchSize: 64}});
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const testDB = primary.getDB("test");
+    const coll = testDB.update_multi_batched;
+    assert.commandWorked(coll.createIndex({a: 1}));
+
+    const numDocs = 1000;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < numDocs; ++i) {
+        bulk.insert({_id: i, a: i, b: 0});
+    }
+    assert.writeOK(bulk.execute());
+
+    // An index scan on the updated field must not see a moved document again.
+    let res = assert.writeOK(coll.update({a: {$gte: 0}}, {$inc: {a: numDocs}}, {multi: true}));
+    assert.eq(numDocs, res.nMatched);
+    assert.eq(numDocs, res.nModified);
+    assert.eq(numDocs, coll.find({a: {$gte: numDocs}}).hint({a: 1}).itcount());
+
+    res = assert.writeOK(coll.update({}, {$set: {b: 1}}, {multi: true, writeConcern: {w: 2}}));
+    assert.eq(numDocs, res.nModified);
+    assert.eq(numDocs,
+              primary.getDB("local")
+                  .oplog.rs.find({op: "u", ns: coll.getFullName(), "o.$set.b": 1})
+                  .itcount());
+
+    // Concurrent multi-updates of the same documents conflict with each other and retry.
+    const awaitShells = [];
+    for (let i = 0; i < 4; ++i) {
+        awaitShells.push(startParallelShell(
+            "assert.writeOK(db.getSiblingDB('test').update_multi_batched.update(" +
+                "{}, {$inc: {b: 1}}, {multi: true}));",
+            primary.port));
+    }
+    awaitShells.forEach((awaitShell) => awaitShell());
+    assert.eq(numDocs, coll.find({b: 5}).itcount());
+
+    rst.awaitReplication();
+    const secondaryColl = rst.getSecondary().getDB("test").update_multi_batched;
+    assert.eq(numDocs, secondaryColl.find({b: 5}).itcount());
+    assert.commandWorked(coll.validate({full: true}));
+
+    rst.stopSet();
+})();
@@ -0,0 +1,55 @@
+// Tests that with 'internalUpdateSkipUnaffectedIndexes' enabled, updates keep every kind of index
+// consistent with the documents, whether or not they touch the index's paths.
+(function() {
+    "use strict";
+
+    const conn =
+        MongoRunner.runMongod({setParameter: {internalUpdateSkipUnaffectedIndexes: true}});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const coll = conn.getDB("test").update_skip_unaffected_indexes;
+
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({"arr.x": 1}));
+    assert.commandWorked(coll.createIndex({b: 1}, {partialFilterExpression: {flag: true}}));
+    assert.commandWorked(coll.createIndex({"sub.$**": 1}));
+    assert.commandWorked(coll.createIndex({text: "text"}));
+    assert.commandWorked(coll.createIndex({untouched: 1}));
+
+    for (let i = 0; i < 10; ++i) {
+        assert.writeOK(coll.insert({
+            _id: i,
+            a: i,
+            arr: [{x: i}],
+            b: i,
+            flag: false,
+            sub: {y: i},
+            text: "hello",
+            untouched: i,
+            other: 0
+        }));
+    }
+
+    // Updates which touch no indexed path, some indexed paths, or an ancestor of one.
+    assert.writeOK(coll.update({}, {$inc: {other: 1}}, {multi: true}));
+    assert.writeOK(coll.update({_id: 1}, {$set: {a: 100}}));
+    assert.writeOK(coll.update({_id: 2}, {$push: {arr: {x: 200}}}));
+    assert.writeOK(coll.update({_id: 3}, {$set: {flag: true}}));
+    assert.writeOK(coll.update({_id: 4}, {$set: {"sub.z": 400}}));
+    assert.writeOK(coll.update({_id: 5}, {$set: {text: "goodbye"}}));
+    assert.writeOK(coll.update({_id: 6}, {$set: {arr: [{x: 600}]}}));
+    assert.writeOK(coll.update({_id: 7}, {$rename: {untouched: "moved"}}));
+
+    assert.eq(10, coll.find({other: 1}).itcount());
+    assert.eq([1], coll.find({a: 100}, {_id: 1}).hint({a: 1}).toArray().map(doc => doc._id));
+    assert.eq(1, coll.find({"arr.x": 200}).hint({"arr.x": 1}).itcount());
+    assert.eq(1, coll.find({"arr.x": 600}).hint({"arr.x": 1}).itcount());
+    assert.eq(0, coll.find({"arr.x": 6}).hint({"arr.x": 1}).itcount());
+    assert.eq(1, coll.find({b: 3, flag: true}).hint({b: 1}).itcount());
+    assert.eq(1, coll.find({"sub.z": 400}).itcount());
+    assert.eq(1, coll.find({$text: {$search: "goodbye"}}).itcount());
+    assert.eq(9, coll.find({untouched: {$exists: true}}).hint({untouched: 1}).itcount());
+
+    assert.commandWorked(coll.validate({full: true}));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,51 @@
+/**
+ * Tests that validate reports the same results when it traverses indexes on several threads and
+ * when it throttles the rate at which it reads data, and that it still detects corruption.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({setParameter: {validateIndexTraversalThreads: 4}});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+    const coll = testDB.validate_parallel_throttled;
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; ++i) {
+        bulk.insert({_id: i, a: i % 10, b: [i, i + 1], c: "x".repeat(100)});
+    }
+    assert.writeOK(bulk.execute());
+    for (let key of [{a: 1}, {b: 1}, {c: 1}, {a: 1, c: -1}, {"$**": 1}]) {
+        assert.commandWorked(coll.createIndex(key));
+    }
+
+    const checkValid = function(full) {
+        const res = assert.commandWorked(coll.validate({full: full}));
+        assert(res.valid, tojson(res));
+        assert.eq(1000, res.nrecords, tojson(res));
+        assert.eq(6, res.nIndexes, tojson(res));
+        assert.eq(1000, res.keysPerIndex["test.validate_parallel_throttled.$_id_"], tojson(res));
+        assert.eq(2000, res.keysPerIndex["test.validate_parallel_throttled.$b_1"], tojson(res));
+        return res;
+    };
+
+    const parallel = checkValid(true);
+    assert.commandWorked(testDB.adminCommand({setParameter: 1, validateIndexTraversalThreads: 1}));
+    const serial = checkValid(true);
+    assert.eq(serial.keysPerIndex, parallel.keysPerIndex);
+    checkValid(false);
+
+    // About 120KB of documents and a similar amount of index keys read at 1MB/s take a while.
+    assert.commandWorked(testDB.adminCommand({setParameter: 1, validateIndexTraversalThreads: 4}));
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, validateMaxBytesPerSecond: 1024 * 1024}));
+    const start = Date.now();
+    checkValid(false);
+    assert.gte(Date.now() - start, 100);
+    assert.commandWorked(testDB.adminCommand({setParameter: 1, validateMaxBytesPerSecond: 0}));
+
+    assert.commandFailed(testDB.adminCommand({setParameter: 1, validateIndexTraversalThreads: 0}));
+    assert.commandFailed(testDB.adminCommand({setParameter: 1, validateMaxBytesPerSecond: -1}));
+
+    MongoRunner.stopMongod(conn);
+})();
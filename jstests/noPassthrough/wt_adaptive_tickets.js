@@ -0,0 +1,37 @@
+// Tests that with 'wiredTigerAdaptiveTickets' enabled, the ticket controller reports its state in
+// serverStatus and keeps the read and write ticket pools within the configured bounds.
+// @tags: [requires_wiredtiger]
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({
+        setParameter:
+            {wiredTigerAdaptiveTickets: true, wiredTigerAdaptiveTicketsIntervalMillis: 100}
+    });
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+
+    const getConcurrentTransactions = function() {
+        return testDB.serverStatus().wiredTiger.concurrentTransactions;
+    };
+
+    const stats = getConcurrentTransactions();
+    assert(stats.hasOwnProperty("adaptive"), tojson(stats));
+    assert(stats.adaptive.hasOwnProperty("read"), tojson(stats));
+    assert(stats.adaptive.hasOwnProperty("write"), tojson(stats));
+
+    // Lowering the upper bound shrinks both pools to it, even while idle.
+    assert.commandWorked(testDB.adminCommand({setParameter: 1, wiredTigerAdaptiveTicketsMax: 32}));
+    assert.soon(() => {
+        const current = getConcurrentTransactions();
+        return current.read.totalTickets === 32 && current.write.totalTickets === 32;
+    }, () => tojson(getConcurrentTransactions()));
+
+    // The pools keep serving operations after being resized.
+    for (let i = 0; i < 100; ++i) {
+        assert.writeOK(testDB.coll.insert({i: i}));
+    }
+    assert.eq(100, testDB.coll.find().itcount());
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,46 @@
+// Tests that with 'wiredTigerJournalGroupCommit' enabled, concurrent j:true writes are made durable
+// by the group commit flusher and that the setting can be toggled at runtime.
+// @tags: [requires_journaling, requires_wiredtiger]
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod({setParameter: {wiredTigerJournalGroupCommit: true}});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const testDB = conn.getDB("test");
+
+    const getSessionCacheStats = function() {
+        return testDB.serverStatus().wiredTiger.sessionCache;
+    };
+
+    const startWriters = function(numWriters, numWrites) {
+        let shells = [];
+        for (let i = 0; i < numWriters; ++i) {
+            shells.push(startParallelShell(
+                "for (let j = 0; j < " + numWrites + "; ++j) {" +
+                    "    assert.writeOK(db.getSiblingDB('test').coll.insert(" +
+                    "        {writer: " + i + ", j: j}, {writeConcern: {j: true}}));" +
+                    "}",
+                conn.port));
+        }
+        shells.forEach((awaitShell) => awaitShell());
+    };
+
+    const before = getSessionCacheStats();
+    startWriters(8, 200);
+    const after = getSessionCacheStats();
+    assert.eq(8 * 200, testDB.coll.count());
+
+    // Every j:true write waited on a group commit, and at least some of them shared one.
+    const commits = after.journalGroupCommits - before.journalGroupCommits;
+    const waiters = after.journalGroupCommitWaiters - before.journalGroupCommitWaiters;
+    assert.gt(commits, 0, tojson(after));
+    assert.gte(waiters, 8 * 200, tojson(after));
+
+    // Once disabled, writers flush the journal themselves.
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, wiredTigerJournalGroupCommit: false}));
+    startWriters(2, 10);
+    assert.eq(8 * 200 + 2 * 10, testDB.coll.count());
+
+    MongoRunner.stopMongod(conn);
+})();
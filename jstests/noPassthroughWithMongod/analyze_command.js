@@ -0,0 +1,42 @@
+// Tests the 'analyze' command, which samples a collection to build the histograms used to order
+// candidate plans.
+(function() {
+    "use strict";
+
+    const coll = db.analyze_command;
+    coll.drop();
+
+    assert.commandFailedWithCode(db.runCommand({analyze: coll.getName()}),
+                                 ErrorCodes.NamespaceNotFound);
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; ++i) {
+        bulk.insert({a: i % 100, b: i, c: "word" + i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({b: 1, a: 1}));
+    assert.commandWorked(coll.createIndex({c: "text"}));
+
+    assert.commandFailedWithCode(db.runCommand({analyze: coll.getName(), sampleSize: 0}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailedWithCode(db.runCommand({analyze: coll.getName(), buckets: "ten"}),
+                                 ErrorCodes.TypeMismatch);
+
+    // The whole collection fits in the sample, so the distinct counts are exact.
+    let res = assert.commandWorked(db.runCommand({analyze: coll.getName(), buckets: 10}));
+    assert.eq(res.statistics.sampleSize, 1000, tojson(res));
+    assert.eq(res.statistics.fields.a.numDistinct, 100, tojson(res));
+    assert.eq(res.statistics.fields.b.numDistinct, 1000, tojson(res));
+    assert.eq(res.statistics.fields._id.numDistinct, 1000, tojson(res));
+    assert.lte(res.statistics.fields.a.buckets.length, 10, tojson(res));
+    assert(!res.statistics.fields.hasOwnProperty("c"), tojson(res));
+
+    // A smaller sample is taken when asked for.
+    res = assert.commandWorked(db.runCommand({analyze: coll.getName(), sampleSize: 100}));
+    assert.eq(res.statistics.sampleSize, 100, tojson(res));
+
+    // Queries planned with the statistics still return the right results.
+    assert.eq(coll.find({a: 5, b: {$gte: 0}}).itcount(), 10);
+    assert.eq(coll.find({$or: [{a: 5}, {b: {$lt: 10}}]}).itcount(), 19);
+}());
@@ -0,0 +1,57 @@
+// Tests that a clustered collection stores documents keyed by their integral _id without an _id
+// index, rejects documents with duplicate or unsupported _id values, and answers _id equality
+// queries with a bounded collection scan rather than a full one.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For getPlanStage.
+
+    if (db.serverStatus().storageEngine.name !== "wiredTiger") {
+        jsTestLog("Skipping clustered_collection.js since the storage engine is not WiredTiger");
+        return;
+    }
+
+    const coll = db.clustered_collection;
+    coll.drop();
+
+    assert.commandFailedWithCode(
+        db.createCollection(coll.getName(), {clustered: true, capped: true, size: 4096}),
+        ErrorCodes.InvalidOptions);
+    assert.commandWorked(db.createCollection(coll.getName(), {clustered: true}));
+    assert.eq(0, coll.getIndexes().length);
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 1; i <= 100; ++i) {
+        bulk.insert({_id: i, a: i % 5});
+    }
+    assert.writeOK(bulk.execute());
+
+    // Numerically equal _id values of any type identify the same document.
+    assert.writeErrorWithCode(coll.insert({_id: NumberLong(7)}), ErrorCodes.DuplicateKey);
+    assert.writeErrorWithCode(coll.insert({_id: "str"}), ErrorCodes.BadValue);
+    assert.writeErrorWithCode(coll.insert({_id: 1.5}), ErrorCodes.BadValue);
+    assert.writeErrorWithCode(coll.insert({_id: 0}), ErrorCodes.BadValue);
+    assert.writeErrorWithCode(coll.insert({a: 1}), ErrorCodes.BadValue);
+
+    assert.eq({_id: 42, a: 2}, coll.findOne({_id: 42}));
+    assert.eq({_id: 42, a: 2}, coll.findOne({_id: NumberInt(42)}));
+    assert.eq({_id: 42, a: 2}, coll.findOne({_id: NumberDecimal("42")}));
+    assert.eq(null, coll.findOne({_id: 1000}));
+    assert.eq(null, coll.findOne({_id: "42"}));
+
+    // The lookup seeks straight to the document.
+    const explain = coll.find({_id: 42}).explain("executionStats");
+    const collScan = getPlanStage(explain.executionStats.executionStages, "COLLSCAN");
+    assert.neq(null, collScan, tojson(explain));
+    assert.eq(1, collScan.docsExamined, tojson(explain));
+
+    // Updates and deletes by _id find the document too.
+    assert.writeOK(coll.update({_id: 42}, {$set: {a: -1}}));
+    assert.eq({_id: 42, a: -1}, coll.findOne({_id: 42}));
+    assert.writeOK(coll.remove({_id: 42}));
+    assert.eq(null, coll.findOne({_id: 42}));
+    assert.eq(99, coll.find().itcount());
+
+    // Other queries still see every document.
+    assert.eq(20, coll.find({a: 1}).itcount());
+})();
@@ -0,0 +1,46 @@
+// Tests that a $out with mode "replaceCollection" produces the same collection and indexes when its
+// results are inserted by several writer threads.
+(function() {
+    "use strict";
+
+    const source = db.out_parallel_writers_source;
+    const target = db.out_parallel_writers_target;
+    source.drop();
+    target.drop();
+
+    const bulk = source.initializeUnorderedBulkOp();
+    for (let i = 0; i < 5000; ++i) {
+        bulk.insert({_id: i, a: i % 7, s: "str" + i});
+    }
+    assert.writeOK(bulk.execute());
+
+    assert.commandWorked(target.createIndex({a: 1}));
+    assert.commandWorked(target.createIndex({s: 1}, {unique: true}));
+    const originalIndexes = target.getIndexes();
+
+    const getParam = (name) => assert.commandWorked(db.adminCommand({getParameter: 1, [name]: 1}));
+    const originalWriters = getParam("internalQueryAggregationOutWriterThreads")
+                                .internalQueryAggregationOutWriterThreads;
+    try {
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalQueryAggregationOutWriterThreads: 4}));
+
+        source.aggregate([{$addFields: {b: {$multiply: ["$_id", 2]}}}, {$out: target.getName()}]);
+        assert.eq(5000, target.find().itcount());
+        assert.eq(0, target.find({$expr: {$ne: ["$b", {$multiply: ["$_id", 2]}]}}).itcount());
+        assert.sameMembers(originalIndexes, target.getIndexes());
+
+        // A violation of a deferred unique index fails the $out and leaves the target unchanged.
+        assert.commandFailedWithCode(db.runCommand({
+            aggregate: source.getName(),
+            pipeline: [{$addFields: {s: "same"}}, {$out: target.getName()}],
+            cursor: {}
+        }),
+                                     ErrorCodes.DuplicateKey);
+        assert.eq(5000, target.find().itcount());
+        assert.eq(0, target.find({s: "same"}).itcount());
+    } finally {
+        assert.commandWorked(db.adminCommand(
+            {setParameter: 1, internalQueryAggregationOutWriterThreads: originalWriters}));
+    }
+})();
@@ -0,0 +1,63 @@
+// Tests that aggregations which group the output of a collection scan return the same results when
+// the scan is split across several worker threads.
+(function() {
+    "use strict";
+
+    const coll = db.parallel_collection_scan_agg;
+    coll.drop();
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 5000; ++i) {
+        bulk.insert({_id: i, a: i % 7, b: i, s: "str" + (i % 3)});
+    }
+    assert.writeOK(bulk.execute());
+    // Leave holes in the RecordId space, some of which may fall on partition boundaries.
+    assert.writeOK(coll.remove({b: {$mod: [10, 3]}}));
+
+    const pipelines = [
+        [{$group: {_id: "$a", count: {$sum: 1}, total: {$sum: "$b"}}}],
+        [{$match: {b: {$gte: 1000}}}, {$group: {_id: "$s", lo: {$min: "$b"}, hi: {$max: "$b"}}}],
+        [{$group: {_id: null, avg: {$avg: "$b"}, first: {$first: "$b"}, last: {$last: "$b"}}}],
+        [{$group: {_id: "$a", values: {$push: "$b"}}}],
+        [{$match: {a: 100}}, {$group: {_id: "$a", count: {$sum: 1}}}],
+    ];
+
+    function runAll() {
+        return pipelines.map(pipeline => coll.aggregate(pipeline.concat([{$sort: {_id: 1}}]))
+                                             .toArray());
+    }
+
+    const serialResults = runAll();
+
+    const getParam = (name) => assert.commandWorked(db.adminCommand({getParameter: 1, [name]: 1}));
+    const originalWorkers = getParam("internalQueryAggregationParallelScanWorkers")
+                                .internalQueryAggregationParallelScanWorkers;
+    const originalMinRecords = getParam("internalQueryAggregationParallelScanMinRecordsPerWorker")
+                                   .internalQueryAggregationParallelScanMinRecordsPerWorker;
+    try {
+        assert.commandWorked(db.adminCommand({
+            setParameter: 1,
+            internalQueryAggregationParallelScanWorkers: 4,
+            internalQueryAggregationParallelScanMinRecordsPerWorker: 100
+        }));
+
+        const parallelResults = runAll();
+        for (let i = 0; i < pipelines.length; ++i) {
+            assert.eq(serialResults[i], parallelResults[i], tojson(pipelines[i]));
+        }
+
+        // An error raised by a worker fails the aggregation.
+        assert.commandFailedWithCode(db.runCommand({
+            aggregate: coll.getName(),
+            pipeline: [{$group: {_id: {$divide: ["$b", 0]}}}],
+            cursor: {}
+        }),
+                                     16608);
+    } finally {
+        assert.commandWorked(db.adminCommand({
+            setParameter: 1,
+            internalQueryAggregationParallelScanWorkers: originalWorkers,
+            internalQueryAggregationParallelScanMinRecordsPerWorker: originalMinRecords
+        }));
+    }
+}());
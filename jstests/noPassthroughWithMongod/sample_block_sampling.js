@@ -0,0 +1,40 @@
+// Tests that a $sample which is too large a proportion of the collection for a random cursor reads
+// blocks of consecutive records from random positions when block sampling is enabled.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For aggPlanHasStage.
+
+    const coll = db.sample_block_sampling;
+    coll.drop();
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 2000; ++i) {
+        bulk.insert({_id: i, a: i % 7});
+    }
+    assert.writeOK(bulk.execute());
+
+    const pipeline = [{$sample: {size: 400}}];
+    assert(!aggPlanHasStage(coll.explain().aggregate(pipeline), "$sampleFromRandomCursor"));
+
+    const getParam = (name) => assert.commandWorked(db.adminCommand({getParameter: 1, [name]: 1}));
+    const originalBlockSize = getParam("internalQueryAggregationSampleBlockSize")
+                                  .internalQueryAggregationSampleBlockSize;
+    try {
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalQueryAggregationSampleBlockSize: 16}));
+        assert(aggPlanHasStage(coll.explain().aggregate(pipeline), "$sampleFromRandomCursor"));
+
+        // The sample has the requested number of distinct documents.
+        const results = coll.aggregate(pipeline).toArray();
+        assert.eq(400, results.length);
+        assert.eq(400, new Set(results.map(doc => doc._id)).size);
+
+        // Samples of more than half of the collection still sort the whole collection.
+        assert(!aggPlanHasStage(coll.explain().aggregate([{$sample: {size: 1500}}]),
+                                "$sampleFromRandomCursor"));
+    } finally {
+        assert.commandWorked(db.adminCommand(
+            {setParameter: 1, internalQueryAggregationSampleBlockSize: originalBlockSize}));
+    }
+})();
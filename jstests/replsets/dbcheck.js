@@ -274,6 +274,25 @@
 
     testDbCheckParameters();
 
+    // Check every collection at once with adaptively sized batches.
+    function testParallelAdaptiveBatches() {
+        let master = replSet.getPrimary();
+        let db = master.getDB(dbName);
+        clearLog();
+
+        assert.commandWorked(
+            db.runCommand({dbCheck: 1, numParallelCollections: 4, maxBatchTimeMillis: 10}));
+        awaitDbCheckCompletion(db);
+
+        checkLogAllConsistent(master);
+        forEachSecondary(secondary => checkLogAllConsistent(secondary));
+
+        assert.commandFailedWithCode(db.runCommand({dbCheck: 1, numParallelCollections: 0}),
+                                     ErrorCodes.InvalidOptions);
+    }
+
+    testParallelAdaptiveBatches();
+
     // Now, test some unusual cases where the command should fail.
     function testErrorOnNonexistent() {
         let master = replSet.getPrimary();
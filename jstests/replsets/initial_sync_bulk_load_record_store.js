@@ -0,0 +1,52 @@
+/**
+ * Tests that initial sync with 'initialSyncBulkLoadRecordStore' enabled clones collections
+ * completely, including their indexes, and that the cloned collections accept writes afterwards.
+ */
+(function() {
+    "use strict";
+
+    const testName = "initial_sync_bulk_load_record_store";
+    const replTest = new ReplSetTest({name: testName, nodes: 1});
+    replTest.startSet();
+    replTest.initiate();
+
+    const primaryDB = replTest.getPrimary().getDB(testName);
+    assert.commandWorked(primaryDB.coll.createIndex({a: 1}));
+
+    const bulk = primaryDB.coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 5000; ++i) {
+        bulk.insert({_id: i, a: i % 10, payload: "x".repeat(100)});
+    }
+    assert.writeOK(bulk.execute());
+
+    // Collections with validators and capped collections use the regular insert path.
+    assert.commandWorked(primaryDB.createCollection("validated", {validator: {a: {$gte: 0}}}));
+    assert.writeOK(primaryDB.validated.insert({a: 1}));
+    assert.commandWorked(primaryDB.createCollection("capped", {capped: true, size: 4096}));
+    assert.writeOK(primaryDB.capped.insert({a: 1}));
+
+    jsTestLog("Adding a secondary which bulk loads cloned collections.");
+    const secondary = replTest.add(
+        {setParameter: {initialSyncBulkLoadRecordStore: true, collectionClonerBatchSize: 100}});
+    replTest.reInitiate();
+    replTest.awaitSecondaryNodes();
+    replTest.awaitReplication();
+
+    const secondaryDB = secondary.getDB(testName);
+    secondary.setSlaveOk();
+    assert.eq(5000, secondaryDB.coll.find().itcount());
+    assert.eq(5000, secondaryDB.coll.count());
+    assert.eq(500, secondaryDB.coll.find({a: 3}).hint({a: 1}).itcount());
+    assert.eq(1, secondaryDB.validated.find().itcount());
+    assert.eq(1, secondaryDB.capped.find().itcount());
+
+    // Writes replicated after initial sync apply to the bulk-loaded collection.
+    assert.writeOK(primaryDB.coll.insert({_id: 5000, a: 3}, {writeConcern: {w: 2}}));
+    assert.writeOK(primaryDB.coll.remove({_id: 0}, {writeConcern: {w: 2}}));
+    assert.eq(5000, secondaryDB.coll.find().itcount());
+    assert.eq(501, secondaryDB.coll.find({a: 3}).hint({a: 1}).itcount());
+
+    assert.commandWorked(secondaryDB.coll.validate({full: true}));
+
+    replTest.stopSet();
+})();
@@ -0,0 +1,52 @@
+/**
+ * Tests that a secondary can initial sync and then replicate with both its initial sync and
+ * steady state oplog buffers backed by a memory-mapped ring file.
+ */
+(function() {
+    "use strict";
+
+    const kRingFileSizeMB = 64;
+    const rst = new ReplSetTest({
+        nodes: 2,
+        nodeOptions: {
+            setParameter: {
+                initialSyncOplogBuffer: "ringFile",
+                steadyStateOplogBuffer: "ringFile",
+                oplogBufferRingFileSizeMB: kRingFileSizeMB,
+            }
+        }
+    });
+    rst.startSet();
+    rst.initiate();
+
+    const primary = rst.getPrimary();
+    const secondary = rst.getSecondary();
+    const coll = primary.getDB("test").getCollection(jsTestName());
+
+    let bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 1000; i++) {
+        bulk.insert({_id: i, padding: "x".repeat(1024)});
+    }
+    assert.commandWorked(bulk.execute({w: 2}));
+    assert.eq(1000, secondary.getDB("test").getCollection(jsTestName()).find().itcount());
+
+    const buffer =
+        assert.commandWorked(secondary.adminCommand({serverStatus: 1})).metrics.repl.buffer;
+    assert.eq(kRingFileSizeMB * 1024 * 1024, buffer.maxSizeBytes, tojson(buffer));
+
+    // Initial sync a new node through a ring file buffer while the primary takes writes.
+    const newNode = rst.add({
+        setParameter: {
+            initialSyncOplogBuffer: "ringFile",
+            oplogBufferRingFileSizeMB: kRingFileSizeMB,
+            numInitialSyncAttempts: 1,
+        }
+    });
+    rst.reInitiate();
+    assert.commandWorked(coll.insert({_id: "during initial sync"}));
+    rst.awaitSecondaryNodes();
+    rst.awaitReplication();
+    assert.eq(1001, newNode.getDB("test").getCollection(jsTestName()).find().itcount());
+
+    rst.stopSet();
+})();
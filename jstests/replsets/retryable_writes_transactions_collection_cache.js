@@ -0,0 +1,94 @@
+/**
+ * Tests that with 'transactionsCollectionCacheMaxEntries' set, a node which steps up loads the
+ * config.transactions records into memory, and that sessions refreshed from those records only walk
+ * the oplog chain of their last write when the write is retried.
+ * @tags: [requires_replication]
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/retryable_writes_util.js");
+
+    if (!RetryableWritesUtil.storageEngineSupportsRetryableWrites(jsTest.options().storageEngine)) {
+        jsTestLog("Retryable writes are not supported, skipping test");
+        return;
+    }
+
+    const numSessions = 10;
+
+    const replTest = new ReplSetTest(
+        {nodes: 2, nodeOptions: {setParameter: {transactionsCollectionCacheMaxEntries: 100}}});
+    replTest.startSet();
+    replTest.initiate();
+
+    let primary = replTest.getPrimary();
+    let testDB = primary.getDB("test");
+
+    const insertCmds = [];
+    for (let i = 0; i < numSessions; i++) {
+        const insertCmd = {
+            insert: "foo",
+            documents: [{_id: i, x: 0}, {_id: i + numSessions, x: 1}],
+            ordered: false,
+            lsid: {id: UUID()},
+            txnNumber: NumberLong(5)
+        };
+        assert.commandWorked(testDB.runCommand(insertCmd));
+        insertCmds.push(insertCmd);
+    }
+    replTest.awaitReplication();
+
+    // Step up the secondary and wait for it to load the records of every session.
+    replTest.stepUp(replTest.getSecondary());
+    primary = replTest.getPrimary();
+    testDB = primary.getDB("test");
+
+    const getStats = function() {
+        return assert.commandWorked(primary.adminCommand({serverStatus: 1})).transactions;
+    };
+    assert.soon(() => getStats().transactionsCollectionCacheSize === numSessions,
+                () => tojson(getStats()));
+    let stats = getStats();
+
+    // Retrying a write uses the cached record and walks the oplog chain to find that both of its
+    // statements have already executed.
+    const oplog = primary.getDB("local").oplog.rs;
+    const insertOplogEntries = oplog.find({ns: "test.foo", op: "i"}).itcount();
+
+    const retryResult = assert.commandWorked(testDB.runCommand(insertCmds[0]));
+    assert.eq(2, retryResult.n, tojson(retryResult));
+    assert.eq(insertOplogEntries, oplog.find({ns: "test.foo", op: "i"}).itcount());
+    assert.eq(2 * numSessions, testDB.foo.find().itcount());
+
+    let newStats = getStats();
+    assert.eq(stats.transactionsCollectionCacheHitCount + 1,
+              newStats.transactionsCollectionCacheHitCount,
+              tojson(newStats));
+    assert.eq(stats.deferredWriteHistoryFetchCount + 1,
+              newStats.deferredWriteHistoryFetchCount,
+              tojson(newStats));
+    assert.eq(numSessions - 1, newStats.transactionsCollectionCacheSize, tojson(newStats));
+    stats = newStats;
+
+    // A write at a newer transaction number uses the cached record but never needs the history of
+    // the previous write.
+    const newInsertCmd = Object.assign({}, insertCmds[1]);
+    newInsertCmd.documents = [{_id: 2 * numSessions}];
+    newInsertCmd.txnNumber = NumberLong(6);
+    assert.commandWorked(testDB.runCommand(newInsertCmd));
+
+    newStats = getStats();
+    assert.eq(stats.transactionsCollectionCacheHitCount + 1,
+              newStats.transactionsCollectionCacheHitCount,
+              tojson(newStats));
+    assert.eq(stats.deferredWriteHistoryFetchCount,
+              newStats.deferredWriteHistoryFetchCount,
+              tojson(newStats));
+
+    // A stale transaction number is still rejected for a session whose record came from the cache.
+    const staleInsertCmd = Object.assign({}, insertCmds[2]);
+    staleInsertCmd.txnNumber = NumberLong(4);
+    assert.commandFailedWithCode(testDB.runCommand(staleInsertCmd), ErrorCodes.TransactionTooOld);
+
+    replTest.stopSet();
+})();
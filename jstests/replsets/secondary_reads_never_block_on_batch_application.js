@@ -0,0 +1,76 @@
+/**
+ * Tests that a secondary read which conflicts with a catalog change in the batch being applied
+ * waits for the batch to complete rather than queueing for the PBWM lock, unless
+ * 'secondaryReadsNeverBlockOnBatchApplication' is disabled.
+ */
+(function() {
+    "use strict";
+
+    load('jstests/replsets/libs/secondary_reads_test.js');
+
+    const name = "secondaryReadsNeverBlockOnBatchApplication";
+    let secondaryReadsTest = new SecondaryReadsTest(name);
+
+    let primaryDB = secondaryReadsTest.getPrimaryDB();
+    let secondaryDB = secondaryReadsTest.getSecondaryDB();
+
+    if (!primaryDB.serverStatus().storageEngine.supportsSnapshotReadConcern) {
+        secondaryReadsTest.stop();
+        return;
+    }
+
+    const getSecondaryReadStats = function() {
+        return secondaryDB.serverStatus().metrics.repl.secondaryReads;
+    };
+
+    // Reads 'collName' on the secondary while a batch which builds an index on it is paused, and
+    // returns the secondary read metrics from before and after the read.
+    const readDuringIndexBuildBatch = function(collName) {
+        let primaryColl = primaryDB.getCollection(collName);
+        assert.commandWorked(primaryDB.runCommand({create: collName}));
+        for (let i = 0; i < 10; i++) {
+            assert.commandWorked(primaryColl.insert({_id: i, x: i}));
+        }
+        secondaryReadsTest.getReplset().awaitReplication();
+        const before = getSecondaryReadStats();
+
+        let pauseAwait = secondaryReadsTest.pauseSecondaryBatchApplication();
+        assert.commandWorked(primaryColl.createIndex({x: 1}));
+        pauseAwait();
+
+        TestData.dbName = primaryDB.getName();
+        TestData.collName = collName;
+        const awaitRead = startParallelShell(function() {
+            db.getMongo().setSlaveOk();
+            const coll = db.getSiblingDB(TestData.dbName).getCollection(TestData.collName);
+            assert.eq(10, coll.find().itcount());
+        }, secondaryDB.getMongo().port);
+
+        assert.soon(function() {
+            return secondaryDB.currentOp({ns: primaryColl.getFullName(), op: "query"})
+                       .inprog.length > 0;
+        });
+
+        secondaryReadsTest.resumeSecondaryBatchApplication();
+        awaitRead();
+        return {before: before, after: getSecondaryReadStats()};
+    };
+
+    let stats = readDuringIndexBuildBatch("neverBlock");
+    assert.gt(stats.after.waitedForLastApplied.num,
+              stats.before.waitedForLastApplied.num,
+              tojson(stats));
+    assert.eq(stats.after.blockedByBatchApplication.num,
+              stats.before.blockedByBatchApplication.num,
+              tojson(stats));
+
+    // Without the parameter the read conflicts with batch application by taking the PBWM lock.
+    assert.commandWorked(secondaryDB.adminCommand(
+        {setParameter: 1, secondaryReadsNeverBlockOnBatchApplication: false}));
+    stats = readDuringIndexBuildBatch("mayBlock");
+    assert.gt(stats.after.blockedByBatchApplication.num,
+              stats.before.blockedByBatchApplication.num,
+              tojson(stats));
+
+    secondaryReadsTest.stop();
+})();
@@ -0,0 +1,68 @@
+/**
+ * Tests that with 'secondaryReadMaxWaitForCatalogChangesMillis' set, a secondary read which
+ * conflicts with a catalog change in the batch being applied waits for the batch to complete
+ * instead of taking the PBWM lock, and that the wait is reported in serverStatus.
+ */
+(function() {
+    "use strict";
+
+    load('jstests/replsets/libs/secondary_reads_test.js');
+
+    const name = "secondaryReadsWaitForCatalogChanges";
+    const collName = "testColl";
+    let secondaryReadsTest = new SecondaryReadsTest(name);
+
+    let primaryDB = secondaryReadsTest.getPrimaryDB();
+    let secondaryDB = secondaryReadsTest.getSecondaryDB();
+
+    if (!primaryDB.serverStatus().storageEngine.supportsSnapshotReadConcern) {
+        secondaryReadsTest.stop();
+        return;
+    }
+
+    const getSecondaryReadStats = function() {
+        return secondaryDB.serverStatus().metrics.repl.secondaryReads;
+    };
+
+    let primaryColl = primaryDB.getCollection(collName);
+    assert.commandWorked(primaryDB.runCommand({create: collName}));
+    for (let i = 0; i < 100; i++) {
+        assert.commandWorked(primaryColl.insert({_id: i, x: i}));
+    }
+    secondaryReadsTest.getReplset().awaitReplication();
+
+    assert.commandWorked(secondaryDB.adminCommand(
+        {setParameter: 1, secondaryReadMaxWaitForCatalogChangesMillis: 5 * 60 * 1000}));
+    const before = getSecondaryReadStats();
+
+    // Build an index in a batch that stays paused before the last applied optime advances, so
+    // that the collection has catalog changes newer than the last applied timestamp.
+    let pauseAwait = secondaryReadsTest.pauseSecondaryBatchApplication();
+    assert.commandWorked(primaryColl.createIndex({x: 1}));
+    pauseAwait();
+
+    TestData.dbName = primaryDB.getName();
+    TestData.collName = collName;
+    const awaitRead = startParallelShell(function() {
+        db.getMongo().setSlaveOk();
+        const coll = db.getSiblingDB(TestData.dbName).getCollection(TestData.collName);
+        assert.eq(100, coll.find().itcount());
+    }, secondaryDB.getMongo().port);
+
+    // The read is waiting for the last applied optime, not for the PBWM lock.
+    assert.soon(function() {
+        return secondaryDB.currentOp({ns: primaryColl.getFullName(), op: "query"})
+                   .inprog.length > 0;
+    });
+
+    secondaryReadsTest.resumeSecondaryBatchApplication();
+    awaitRead();
+
+    const after = getSecondaryReadStats();
+    assert.gt(after.waitedForLastApplied.num, before.waitedForLastApplied.num, tojson(after));
+    assert.eq(after.blockedByBatchApplication.num,
+              before.blockedByBatchApplication.num,
+              tojson(after));
+
+    secondaryReadsTest.stop();
+})();
@@ -0,0 +1,81 @@
+// Tests that a $lookup whose foreign collection is sharded on the foreignField only sends its
+// sub-pipelines to the shards which own the join keys, and that with
+// 'internalLookupStageForeignBatchSize' set, input documents are joined in batches with a single
+// query each.
+(function() {
+    "use strict";
+
+    load("jstests/noPassthrough/libs/server_parameter_helpers.js");  // For setParameterOnAllHosts.
+    load("jstests/libs/discover_topology.js");                       // For findNonConfigNodes.
+
+    const testName = "lookup_foreign_sharded_targeted";
+    const st = new ShardingTest({shards: 2, mongos: 1});
+    const nodes = DiscoverTopology.findNonConfigNodes(st.s);
+    setParameterOnAllHosts(nodes, "internalQueryAllowShardedLookup", true);
+
+    const mongosDB = st.s.getDB(testName);
+    const localColl = mongosDB[testName + "_local"];
+    const foreignColl = mongosDB[testName + "_foreign"];
+
+    assert.commandWorked(mongosDB.adminCommand({enableSharding: mongosDB.getName()}));
+    st.ensurePrimaryShard(mongosDB.getName(), st.shard0.shardName);
+
+    // Shard the foreign collection on the join key, with the negative keys on shard0 and the
+    // non-negative keys on shard1.
+    st.shardColl(foreignColl, {key: 1}, {key: 0}, {key: 0}, mongosDB.getName());
+    for (let i = -10; i < 10; i++) {
+        assert.commandWorked(foreignColl.insert({_id: i, key: i}));
+    }
+    for (let i = 0; i < 10; i++) {
+        assert.commandWorked(localColl.insert({_id: i, a: -i - 1}));
+    }
+
+    const shardDBs = [st.shard0.getDB(testName), st.shard1.getDB(testName)];
+    const numForeignQueries = function(shardDB) {
+        return shardDB.system.profile.find({"command.aggregate": foreignColl.getName()}).itcount();
+    };
+    const resetProfilers = function() {
+        for (let shardDB of shardDBs) {
+            assert.commandWorked(shardDB.setProfilingLevel(0));
+            shardDB.system.profile.drop();
+            assert.commandWorked(shardDB.setProfilingLevel(2));
+        }
+    };
+
+    const pipeline = [
+        {
+          $lookup:
+              {from: foreignColl.getName(), localField: "a", foreignField: "key", as: "joined"}
+        },
+        {$sort: {_id: 1}}
+    ];
+    const expected = [];
+    for (let i = 0; i < 10; i++) {
+        expected.push({_id: i, a: -i - 1, joined: [{_id: -i - 1, key: -i - 1}]});
+    }
+
+    // Every sub-pipeline is targeted at shard0, which owns all of the join keys.
+    resetProfilers();
+    assert.eq(expected, localColl.aggregate(pipeline).toArray());
+    assert.eq(10, numForeignQueries(shardDBs[0]));
+    assert.eq(0, numForeignQueries(shardDBs[1]));
+
+    // With batching, the ten input documents are joined with two queries.
+    setParameterOnAllHosts(nodes, "internalLookupStageForeignBatchSize", 5);
+    resetProfilers();
+    assert.eq(expected, localColl.aggregate(pipeline).toArray());
+    assert.eq(2, numForeignQueries(shardDBs[0]));
+    assert.eq(0, numForeignQueries(shardDBs[1]));
+
+    // A batch whose join keys span both chunks is sent to both shards, once.
+    assert.commandWorked(localColl.update({_id: 0}, {$set: {a: 5}}));
+    expected[0] = {_id: 0, a: 5, joined: [{_id: 5, key: 5}]};
+    resetProfilers();
+    assert.eq(expected, localColl.aggregate(pipeline).toArray());
+    assert.eq(2, numForeignQueries(shardDBs[0]));
+    assert.eq(1, numForeignQueries(shardDBs[1]));
+
+    setParameterOnAllHosts(nodes, "internalLookupStageForeignBatchSize", 0);
+    setParameterOnAllHosts(nodes, "internalQueryAllowShardedLookup", false);
+    st.stop();
+})();
@@ -0,0 +1,104 @@
+/**
+ * Tests that with 'enableNonTransactionalSnapshotReads' set on the shards, find and aggregate
+ * through mongos can use readConcern level snapshot outside of a transaction, and that every shard
+ * and every batch of the cursor reads at the same point in time.
+ *
+ * @tags: [requires_majority_read_concern, requires_find_command]
+ */
+(function() {
+    "use strict";
+
+    // This test runs snapshot reads without a transaction, which is not compatible with implicit
+    // sessions that would otherwise be attached to them.
+    TestData.disableImplicitSessions = true;
+
+    const dbName = "test";
+    const collName = "coll";
+    const ns = dbName + "." + collName;
+
+    const st = new ShardingTest({
+        shards: 2,
+        rs: {nodes: 1},
+        other: {rsOptions: {setParameter: {enableNonTransactionalSnapshotReads: true}}}
+    });
+
+    assert.commandWorked(st.s.adminCommand({enableSharding: dbName}));
+    st.ensurePrimaryShard(dbName, st.shard0.shardName);
+    assert.commandWorked(st.s.adminCommand({shardCollection: ns, key: {_id: 1}}));
+    assert.commandWorked(st.s.adminCommand({split: ns, middle: {_id: 0}}));
+    assert.commandWorked(
+        st.s.adminCommand({moveChunk: ns, find: {_id: 0}, to: st.shard1.shardName}));
+
+    const testDB = st.s.getDB(dbName);
+    const coll = testDB.getCollection(collName);
+    let docs = [];
+    for (let i = -5; i < 5; i++) {
+        docs.push({_id: i});
+    }
+    const insertRes = assert.commandWorked(
+        testDB.runCommand({insert: collName, documents: docs, writeConcern: {w: "majority"}}));
+    const insertTime = insertRes.operationTime;
+
+    const majority = {writeConcern: {w: "majority"}};
+
+    // Drains the cursor opened by 'res' with getMores while both shards change underneath it.
+    const readWhileWriting = function(res) {
+        let results = res.cursor.firstBatch;
+        assert.eq(2, results.length, tojson(res));
+        assert.commandWorked(coll.insert([{_id: -100}, {_id: 100}], majority));
+        assert.commandWorked(coll.remove({_id: {$in: [-1, 1]}}, majority));
+
+        let cursorId = res.cursor.id;
+        while (cursorId != 0) {
+            const more = assert.commandWorked(
+                testDB.runCommand({getMore: cursorId, collection: collName, batchSize: 2}));
+            results = results.concat(more.cursor.nextBatch);
+            cursorId = more.cursor.id;
+        }
+
+        assert.commandWorked(coll.remove({_id: {$in: [-100, 100]}}, majority));
+        assert.commandWorked(coll.insert([{_id: -1}, {_id: 1}], majority));
+        return results;
+    };
+
+    // mongos chooses one atClusterTime for both shards and all of the cursor's batches.
+    let results = readWhileWriting(assert.commandWorked(testDB.runCommand({
+        find: collName,
+        sort: {_id: 1},
+        batchSize: 2,
+        readConcern: {level: "snapshot"},
+    })));
+    assert.eq(docs, results);
+
+    results = readWhileWriting(assert.commandWorked(testDB.runCommand({
+        aggregate: collName,
+        pipeline: [{$sort: {_id: 1}}],
+        cursor: {batchSize: 2},
+        readConcern: {level: "snapshot"},
+    })));
+    assert.eq(docs, results);
+
+    // An explicit atClusterTime reads at that time.
+    assert.commandWorked(coll.insert({_id: 50}, majority));
+    const res = assert.commandWorked(testDB.runCommand({
+        find: collName,
+        readConcern: {level: "snapshot", atClusterTime: insertTime},
+    }));
+    assert.eq(docs.length, res.cursor.firstBatch.length, tojson(res));
+
+    // Only find and aggregate may read at a snapshot outside of a transaction.
+    assert.commandFailedWithCode(
+        testDB.runCommand({distinct: collName, key: "_id", readConcern: {level: "snapshot"}}),
+        ErrorCodes.InvalidOptions);
+
+    // Without the parameter the shards reject the read.
+    for (let shard of [st.rs0.getPrimary(), st.rs1.getPrimary()]) {
+        assert.commandWorked(
+            shard.adminCommand({setParameter: 1, enableNonTransactionalSnapshotReads: false}));
+    }
+    assert.commandFailedWithCode(
+        testDB.runCommand({find: collName, readConcern: {level: "snapshot"}}),
+        ErrorCodes.InvalidOptions);
+
+    st.stop();
+})();
@@ -0,0 +1,72 @@
+/**
+ * Tests that cross-shard transactions commit when coordinators batch their participant list and
+ * decision writes, and that the coordinator step latencies are reported in serverStatus.
+ *
+ * @tags: [uses_transactions, uses_prepare_transaction, uses_multi_shard_transaction]
+ */
+
+(function() {
+    'use strict';
+
+    const dbName = "test";
+    const collName = "foo";
+    const ns = dbName + "." + collName;
+
+    const st = new ShardingTest({
+        shards: 2,
+        rs: {nodes: 1},
+        other: {rsOptions: {setParameter: {coordinatorBatchedDocumentWrites: true}}}
+    });
+
+    assert.commandWorked(st.s.adminCommand({enableSharding: dbName}));
+    st.ensurePrimaryShard(dbName, st.shard0.shardName);
+    assert.commandWorked(st.s.adminCommand({shardCollection: ns, key: {_id: 1}}));
+    assert.commandWorked(st.s.adminCommand({split: ns, middle: {_id: 0}}));
+    assert.commandWorked(
+        st.s.adminCommand({moveChunk: ns, find: {_id: 0}, to: st.shard1.shardName}));
+
+    // Each transaction writes to both shards, so its commit goes through a coordinator.
+    const kNumWriters = 8;
+    const kNumTxnsPerWriter = 10;
+    let shells = [];
+    for (let i = 0; i < kNumWriters; ++i) {
+        shells.push(startParallelShell(
+            "const session = db.getMongo().startSession();" +
+                "const coll = session.getDatabase('" + dbName + "')." + collName + ";" +
+                "for (let j = 0; j < " + kNumTxnsPerWriter + "; ++j) {" +
+                "    const id = " + i + " * 1000 + j + 1;" +
+                "    session.startTransaction();" +
+                "    assert.commandWorked(coll.insert({_id: id}));" +
+                "    assert.commandWorked(coll.insert({_id: -id}));" +
+                "    assert.commandWorked(session.commitTransaction_forTesting());" +
+                "}",
+            st.s.port));
+    }
+    shells.forEach((awaitShell) => awaitShell());
+
+    assert.eq(2 * kNumWriters * kNumTxnsPerWriter, st.s.getCollection(ns).find().itcount());
+
+    const getStepLatencies = function(shard) {
+        return assert.commandWorked(shard.adminCommand({serverStatus: 1}))
+            .twoPhaseCommitCoordinator.stepLatencies;
+    };
+
+    let numDecisionsWritten = 0;
+    [st.rs0.getPrimary(), st.rs1.getPrimary()].forEach(function(shard) {
+        const stepLatencies = getStepLatencies(shard);
+        numDecisionsWritten += stepLatencies.writingDecision.count;
+        assert.eq(stepLatencies.writingParticipantList.count,
+                  stepLatencies.writingDecision.count,
+                  tojson(stepLatencies));
+    });
+    assert.eq(kNumWriters * kNumTxnsPerWriter, numDecisionsWritten);
+
+    // The coordinator documents are removed once the transactions are done.
+    assert.soon(function() {
+        return st.rs0.getPrimary().getDB("config").transaction_coordinators.find().itcount() ===
+            0 &&
+            st.rs1.getPrimary().getDB("config").transaction_coordinators.find().itcount() === 0;
+    });
+
+    st.stop();
+})();
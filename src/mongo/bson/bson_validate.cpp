@@ -27,9 +27,9 @@
  *    it in the license file.
  */
 
+#include <boost/container/small_vector.hpp>
 #include <cstring>
 #include <limits>
-#include <vector>
 
 #include "mongo/base/data_view.h"
 #include "mongo/bson/bson_depth.h"
@@ -306,9 +306,12 @@ Status validateElementInfo(Buffer* buffer,
     }
 }
 
+// Nesting depth up to which validation does not need to allocate. Most documents are far
+// shallower, and validateBSON() runs on every document received from the network.
+constexpr size_t kInlineValidationFrames = 16;
+
 Status validateBSONIterative(Buffer* buffer) {
-    std::vector<ValidationObjectFrame> frames;
-    frames.reserve(16);
+    boost::container::small_vector<ValidationObjectFrame, kInlineValidationFrames> frames;
     ValidationObjectFrame* curr = NULL;
     ValidationState::State state = ValidationState::BeginObj;
 
@@ -0,0 +1,103 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <string>
+
+#include "mongo/base/status.h"
+#include "mongo/bson/bson_validate.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/oid.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Builds a document shaped roughly like a typical insert: an ObjectId _id followed by 'numFields'
+ * fields cycling through common scalar types, strings, and small subdocuments.
+ */
+BSONObj makeFlatDocument(int numFields) {
+    BSONObjBuilder bob;
+    bob.append("_id", OID::gen());
+    for (int i = 0; i < numFields; ++i) {
+        const std::string fieldName = "field" + std::to_string(i);
+        switch (i % 5) {
+            case 0:
+                bob.append(fieldName, i);
+                break;
+            case 1:
+                bob.append(fieldName, static_cast<double>(i) / 3);
+                break;
+            case 2:
+                bob.append(fieldName, std::string(32, 'x'));
+                break;
+            case 3:
+                bob.append(fieldName, BSON("nested" << i << "flag" << true));
+                break;
+            case 4:
+                bob.appendDate(fieldName, Date_t::fromMillisSinceEpoch(i));
+                break;
+        }
+    }
+    return bob.obj();
+}
+
+BSONObj makeNestedDocument(int depth) {
+    BSONObj obj = BSON("leaf" << 1);
+    for (int i = 0; i < depth; ++i) {
+        obj = BSON("a" << obj << "b" << i);
+    }
+    return obj;
+}
+
+void runValidateBSON(benchmark::State& state, const BSONObj& obj) {
+    size_t totalBytes = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest));
+        totalBytes += obj.objsize();
+    }
+    state.SetBytesProcessed(totalBytes);
+}
+
+void BM_validateFlatDocument(benchmark::State& state) {
+    runValidateBSON(state, makeFlatDocument(state.range(0)));
+}
+
+void BM_validateNestedDocument(benchmark::State& state) {
+    runValidateBSON(state, makeNestedDocument(state.range(0)));
+}
+
+BENCHMARK(BM_validateFlatDocument)->Ranges({{{1}, {1'000}}});
+BENCHMARK(BM_validateNestedDocument)->Ranges({{{1}, {100}}});
+
+}  // namespace
+}  // namespace mongo
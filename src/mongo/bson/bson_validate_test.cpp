@@ -251,6 +251,17 @@ TEST(BSONValidateFast, NestedObject) {
     ASSERT_NOT_OK(validateBSON(x.objdata(), x.objsize() / 2, BSONVersion::kLatest));
 }
 
+TEST(BSONValidateFast, DeeplyNestedObject) {
+    // Nest well past the number of frames the validator keeps inline, so that its frame stack has
+    // to grow while the innermost frames are being validated.
+    BSONObj x = BSON("leaf" << 1);
+    for (int i = 0; i < 100; ++i) {
+        x = BSON("a" << x << "b" << BSON_ARRAY(i << BSON("c" << i)));
+    }
+    ASSERT_OK(validateBSON(x.objdata(), x.objsize(), BSONVersion::kLatest));
+    ASSERT_NOT_OK(validateBSON(x.objdata(), x.objsize() / 2, BSONVersion::kLatest));
+}
+
 TEST(BSONValidateFast, ErrorWithId) {
     BufBuilder bb;
     BSONObjBuilder ob(bb);
@@ -42,6 +42,7 @@
 #include "mongo/util/base64.h"
 #include "mongo/util/duration.h"
 #include "mongo/util/hex.h"
+#include "mongo/util/itoa.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
@@ -57,8 +58,52 @@ using std::string;
 const double BSONElement::kLongLongMaxPlusOneAsDouble =
     scalbn(1, std::numeric_limits<long long>::digits);
 
+namespace {
+
+/**
+ * Appends 'sd' to 's' with the same escaping as str::escape(), but without building an
+ * intermediate string. Runs of characters which need no escaping, which for most field names and
+ * values is all of them, are appended in one piece.
+ */
+void appendEscaped(StringBuilder& s, StringData sd, bool escapeSlash = false) {
+    const char* runStart = sd.rawData();
+    const char* const end = runStart + sd.size();
+    for (const char* p = runStart; p != end; ++p) {
+        const char c = *p;
+        if (c != '"' && c != '\\' && (c != '/' || !escapeSlash) && (c < 0 || c > 0x1f))
+            continue;
+        s << StringData(runStart, p - runStart) << str::escape(StringData(p, 1), escapeSlash);
+        runStart = p + 1;
+    }
+    s << StringData(runStart, end - runStart);
+}
+
+void appendInteger(StringBuilder& s, long long value) {
+    if (value < 0) {
+        s << '-';
+    }
+    // Negate in unsigned arithmetic so that the minimum value does not overflow.
+    const auto magnitude = value < 0 ? 0 - static_cast<unsigned long long>(value)
+                                     : static_cast<unsigned long long>(value);
+    ItoA digits(magnitude);
+    s << StringData(digits);
+}
+
+/**
+ * Doubles are written with 16 significant digits, which is what the std::stringstream based
+ * writer used to produce; StringBuilder's own operator<<(double) only keeps 6.
+ */
+void appendDouble(StringBuilder& s, double value) {
+    char buf[32];
+    const int len = snprintf(buf, sizeof(buf), "%.16g", value);
+    invariant(len > 0 && len < static_cast<int>(sizeof(buf)));
+    s << StringData(buf, len);
+}
+
+}  // namespace
+
 string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames, int pretty) const {
-    std::stringstream s;
+    StringBuilder s;
     BSONElement::jsonStringStream(format, includeFieldNames, pretty, s);
     return s.str();
 }
@@ -66,33 +111,41 @@ string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames,
 void BSONElement::jsonStringStream(JsonStringFormat format,
                                    bool includeFieldNames,
                                    int pretty,
-                                   std::stringstream& s) const {
-    if (includeFieldNames)
-        s << '"' << str::escape(fieldName()) << "\" : ";
+                                   StringBuilder& s) const {
+    if (includeFieldNames) {
+        s << '"';
+        appendEscaped(s, fieldNameStringData());
+        s << "\" : ";
+    }
     switch (type()) {
         case mongo::String:
         case Symbol:
-            s << '"' << str::escape(string(valuestr(), valuestrsize() - 1)) << '"';
+            s << '"';
+            appendEscaped(s, valueStringData());
+            s << '"';
             break;
         case NumberLong:
             if (format == TenGen) {
-                s << "NumberLong(" << _numberLong() << ")";
+                s << "NumberLong(";
+                appendInteger(s, _numberLong());
+                s << ")";
             } else {
-                s << "{ \"$numberLong\" : \"" << _numberLong() << "\" }";
+                s << "{ \"$numberLong\" : \"";
+                appendInteger(s, _numberLong());
+                s << "\" }";
             }
             break;
         case NumberInt:
             if (format == TenGen) {
-                s << "NumberInt(" << _numberInt() << ")";
+                s << "NumberInt(";
+                appendInteger(s, _numberInt());
+                s << ")";
                 break;
             }
         case NumberDouble:
             if (number() >= -std::numeric_limits<double>::max() &&
                 number() <= std::numeric_limits<double>::max()) {
-                auto origPrecision = s.precision();
-                auto guard = makeGuard([&s, origPrecision]() { s.precision(origPrecision); });
-                s.precision(16);
-                s << number();
+                appendDouble(s, number());
             }
             // This is not valid JSON, but according to RFC-4627, "Numeric values that cannot be
             // represented as sequences of digits (such as Infinity and NaN) are not permitted." so
@@ -183,7 +236,7 @@ void BSONElement::jsonStringStream(JsonStringFormat format,
             s << '"' << valuestr() << "\", ";
             if (format != TenGen)
                 s << "\"$id\" : ";
-            s << '"' << mongo::OID::from(valuestr() + valuestrsize()) << "\" ";
+            s << '"' << mongo::OID::from(valuestr() + valuestrsize()).toString() << "\" ";
             if (format == TenGen)
                 s << ')';
             else
@@ -196,7 +249,7 @@ void BSONElement::jsonStringStream(JsonStringFormat format,
             } else {
                 s << "{ \"$oid\" : ";
             }
-            s << '"' << __oid() << '"';
+            s << '"' << __oid().toString() << '"';
             if (format == TenGen) {
                 s << " )";
             } else {
@@ -208,25 +261,11 @@ void BSONElement::jsonStringStream(JsonStringFormat format,
             const int len = reader.readAndAdvance<LittleEndian<int>>();
             BinDataType type = static_cast<BinDataType>(reader.readAndAdvance<uint8_t>());
 
-            s << "{ \"$binary\" : \"";
-            base64::encode(s, reader.view(), len);
+            s << "{ \"$binary\" : \"" << base64::encode(reader.view(), len);
 
-            auto origFill = s.fill();
-            auto origFmtF = s.flags();
-            auto origWidth = s.width();
-            auto guard = makeGuard([&s, origFill, origFmtF, origWidth] {
-                s.fill(origFill);
-                s.setf(origFmtF);
-                s.width(origWidth);
-            });
-
-            s.setf(std::ios_base::hex, std::ios_base::basefield);
-
-            s << "\", \"$type\" : \"";
-            s.width(2);
-            s.fill('0');
-            s << type;
-            s << "\" }";
+            char typeBuf[8];
+            const int typeLen = snprintf(typeBuf, sizeof(typeBuf), "%02x", static_cast<int>(type));
+            s << "\", \"$type\" : \"" << StringData(typeBuf, typeLen) << "\" }";
             break;
         }
         case mongo::Date:
@@ -242,7 +281,9 @@ void BSONElement::jsonStringStream(JsonStringFormat format,
                 if (d.isFormattable()) {
                     s << "\"" << dateToISOStringLocal(date()) << "\"";
                 } else {
-                    s << "{ \"$numberLong\" : \"" << d.toMillisSinceEpoch() << "\" }";
+                    s << "{ \"$numberLong\" : \"";
+                    appendInteger(s, d.toMillisSinceEpoch());
+                    s << "\" }";
                 }
                 s << " }";
             } else {
@@ -260,20 +301,23 @@ void BSONElement::jsonStringStream(JsonStringFormat format,
                     } else {
                         // FIXME: This is not parseable by the shell, since it may not fit in a
                         // float
-                        s << d.toMillisSinceEpoch();
+                        appendInteger(s, d.toMillisSinceEpoch());
                     }
                 } else {
-                    s << date().asInt64();
+                    appendInteger(s, date().asInt64());
                 }
                 s << " )";
             }
             break;
         case RegEx:
             if (format == Strict) {
-                s << "{ \"$regex\" : \"" << str::escape(regex());
+                s << "{ \"$regex\" : \"";
+                appendEscaped(s, regex());
                 s << "\", \"$options\" : \"" << regexFlags() << "\" }";
             } else {
-                s << "/" << str::escape(regex(), true) << "/";
+                s << "/";
+                appendEscaped(s, regex(), true);
+                s << "/";
                 // FIXME Worry about alpha order?
                 for (const char* f = regexFlags(); *f; ++f) {
                     switch (*f) {
@@ -291,14 +335,19 @@ void BSONElement::jsonStringStream(JsonStringFormat format,
         case CodeWScope: {
             BSONObj scope = codeWScopeObject();
             if (!scope.isEmpty()) {
-                s << "{ \"$code\" : \"" << str::escape(_asCode()) << "\" , "
-                  << "\"$scope\" : " << scope.jsonString() << " }";
+                s << "{ \"$code\" : \"";
+                appendEscaped(s, _asCode());
+                s << "\" , \"$scope\" : ";
+                scope.jsonStringStream(Strict, 0, false, s);
+                s << " }";
                 break;
             }
         }
 
         case Code:
-            s << "\"" << str::escape(_asCode()) << "\"";
+            s << "\"";
+            appendEscaped(s, _asCode());
+            s << "\"";
             break;
 
         case bsonTimestamp:
@@ -215,7 +215,7 @@ public:
     void jsonStringStream(JsonStringFormat format,
                           bool includeFieldNames,
                           int pretty,
-                          std::stringstream& s) const;
+                          StringBuilder& s) const;
 
     operator std::string() const {
         return toString();
@@ -111,7 +111,7 @@ BSONObj BSONObj::getOwned() const {
 }
 
 std::string BSONObj::jsonString(JsonStringFormat format, int pretty, bool isArray) const {
-    std::stringstream s;
+    StringBuilder s;
     BSONObj::jsonStringStream(format, pretty, isArray, s);
     return s.str();
 }
@@ -119,7 +119,7 @@ std::string BSONObj::jsonString(JsonStringFormat format, int pretty, bool isArra
 void BSONObj::jsonStringStream(JsonStringFormat format,
                                int pretty,
                                bool isArray,
-                               std::stringstream& s) const {
+                               StringBuilder& s) const {
     if (isEmpty()) {
         s << (isArray ? "[]" : "{}");
         return;
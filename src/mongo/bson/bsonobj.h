@@ -264,7 +264,7 @@ public:
     void jsonStringStream(JsonStringFormat format,
                           int pretty,
                           bool isArray,
-                          std::stringstream& s) const;
+                          StringBuilder& s) const;
 
     /** note: addFields always adds _id even if not specified */
     int addFields(BSONObj& from, std::set<std::string>& fields); /* returns n added */
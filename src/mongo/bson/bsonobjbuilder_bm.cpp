@@ -30,6 +30,7 @@
 #include "mongo/platform/basic.h"
 
 #include <benchmark/benchmark.h>
+#include <string>
 
 #include "mongo/bson/bsonobjbuilder.h"
 
@@ -50,4 +51,42 @@ void BM_arrayBuilder(benchmark::State& state) {
 
 BENCHMARK(BM_arrayBuilder)->Ranges({{{1}, {100'000}}});
 
+/**
+ * Builds documents of state.range(0) string fields into a builder whose buffer starts at
+ * state.range(1) bytes, or at the default size if that is 0, and reports how many buffer
+ * allocations each document took.
+ */
+void BM_objBuilderAllocations(benchmark::State& state) {
+    const std::string value(32, 'x');
+    size_t totalBytes = 0;
+    int64_t totalAllocations = 0;
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        BSONObjBuilder builder = state.range(1) ? BSONObjBuilder(state.range(1)) : BSONObjBuilder();
+
+        // Every change of the buffer's capacity is an allocation, as is the initial one.
+        int capacity = builder.bb().getSize();
+        int64_t allocations = 1;
+        for (auto j = 0; j < state.range(0); j++) {
+            builder.append("field" + std::to_string(j), value);
+            if (builder.bb().getSize() != capacity) {
+                capacity = builder.bb().getSize();
+                ++allocations;
+            }
+        }
+        totalAllocations += allocations;
+        totalBytes += builder.len();
+        benchmark::DoNotOptimize(builder.done());
+    }
+    state.SetBytesProcessed(totalBytes);
+    state.counters["allocationsPerDoc"] =
+        benchmark::Counter(totalAllocations, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_objBuilderAllocations)
+    ->Args({10, 0})
+    ->Args({300, 0})
+    ->Args({10, 1024})
+    ->Args({300, 16 * 1024});
+
 }  // namespace mongo
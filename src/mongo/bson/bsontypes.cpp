@@ -174,6 +174,8 @@ const char* typeName(BinDataType type) {
             return "MD5";
         case Encrypt:
             return "encrypt";
+        case Column:
+            return "column";
         case bdtCustom:
             return "Custom";
         default:
@@ -190,6 +192,7 @@ bool isValidBinDataType(int type) {
         case newUUID:
         case MD5Type:
         case Encrypt:
+        case Column:
         case bdtCustom:
             return true;
         default:
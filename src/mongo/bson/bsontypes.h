@@ -160,6 +160,7 @@ enum BinDataType {
     newUUID = 4,             /* language-independent UUID format across all drivers */
     MD5Type = 5,
     Encrypt = 6, /* encryption placeholder or encrypted data */
+    Column = 7,  /* compressed column of values, see bson/util/column_codec.h */
     bdtCustom = 128
 };
 
@@ -493,6 +493,10 @@ private:
     const char* const _buf;
     const char* _input;
     const char* const _input_end;
+
+    // Holds each string value while it is unescaped, so that its buffer is reused from one
+    // value to the next.
+    std::string _scratch;
 };
 
 }  // namespace mongo
@@ -0,0 +1,99 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <string>
+
+#include "mongo/bson/json.h"
+
+namespace mongo {
+namespace {
+
+std::string makeDocumentJson(int numFields) {
+    std::string json = "{";
+    for (int i = 0; i < numFields; ++i) {
+        if (i > 0) {
+            json += ", ";
+        }
+        const std::string name = "\"field" + std::to_string(i) + "\": ";
+        switch (i % 6) {
+            case 0:
+                json += name + "\"a string value of moderate length " + std::to_string(i) + "\"";
+                break;
+            case 1:
+                json += name + std::to_string(i * 1000);
+                break;
+            case 2:
+                json += name + std::to_string(i) + ".5";
+                break;
+            case 3:
+                json += name + "{\"nested\": true, \"count\": " + std::to_string(i) + "}";
+                break;
+            case 4:
+                json += name + "[1, 2, \"three\"]";
+                break;
+            case 5:
+                json += name + "{\"$date\": \"2019-06-01T12:00:00.000Z\"}";
+                break;
+        }
+    }
+    return json + ", \"_id\": {\"$oid\": \"5d0a1b2c3d4e5f6a7b8c9d0e\"}" +
+        ", \"big\": {\"$numberLong\": \"9007199254740993\"}}";
+}
+
+void BM_fromjson(benchmark::State& state) {
+    const std::string json = makeDocumentJson(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(fromjson(json));
+    }
+    state.SetBytesProcessed(state.iterations() * json.size());
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_fromjson)->Arg(10)->Arg(300);
+
+void BM_jsonString(benchmark::State& state) {
+    const BSONObj obj = fromjson(makeDocumentJson(state.range(0)));
+    size_t bytes = 0;
+    for (auto _ : state) {
+        const std::string json = obj.jsonString(Strict);
+        bytes += json.size();
+        benchmark::DoNotOptimize(json);
+    }
+    state.SetBytesProcessed(bytes);
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_jsonString)->Arg(10)->Arg(300);
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,552 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/util/column_codec.h"
+
+#include <algorithm>
+#include <boost/optional.hpp>
+#include <cstring>
+#include <limits>
+#include <third_party/s2/util/coding/varint.h>
+
+#include "mongo/bson/bson_validate.h"
+#include "mongo/platform/bits.h"
+#include "mongo/util/itoa.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace column_codec {
+namespace {
+
+enum class Encoding : uint8_t {
+    kRaw = 0,
+    kDeltaOfDelta = 1,
+    kXor = 2,
+};
+
+// In the XOR encoding, the number of leading zero bits of a value is stored in 5 bits, and the
+// number of its meaningful bits, minus one, in 6 bits.
+const int kLeadingZerosBits = 5;
+const int kMaxLeadingZeros = (1 << kLeadingZerosBits) - 1;
+const int kMeaningfulBitsBits = 6;
+
+Status malformed(StringData reason) {
+    return Status(ErrorCodes::BadValue, str::stream() << "Malformed encoded column: " << reason);
+}
+
+uint64_t zigzagEncode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t zigzagDecode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+void appendVarint(uint64_t value, BufBuilder* out) {
+    char buf[Varint::kMax64];
+    const char* end = Varint::Encode64(buf, value);
+    out->appendBuf(buf, end - buf);
+}
+
+/**
+ * Returns the position named by 'fieldName', which must be the canonical decimal representation
+ * of an integer, or boost::none.
+ */
+boost::optional<uint64_t> parsePosition(StringData fieldName) {
+    if (fieldName.empty() || fieldName.size() > 18 || (fieldName[0] == '0' && fieldName.size() > 1))
+        return boost::none;
+
+    uint64_t position = 0;
+    for (char c : fieldName) {
+        if (c < '0' || c > '9')
+            return boost::none;
+        position = position * 10 + (c - '0');
+    }
+    return position;
+}
+
+/**
+ * Writes varints, storing a run of zeros as a single zero followed by the run's length minus one.
+ */
+class ZeroRunVarintWriter {
+public:
+    explicit ZeroRunVarintWriter(BufBuilder* out) : _out(out) {}
+
+    void append(uint64_t value) {
+        if (value == 0) {
+            ++_zeros;
+            return;
+        }
+        flush();
+        appendVarint(value, _out);
+    }
+
+    void flush() {
+        if (_zeros > 0) {
+            appendVarint(0, _out);
+            appendVarint(_zeros - 1, _out);
+            _zeros = 0;
+        }
+    }
+
+private:
+    BufBuilder* _out;
+    uint64_t _zeros = 0;
+};
+
+class ZeroRunVarintReader {
+public:
+    ZeroRunVarintReader(const char* begin, const char* end) : _pos(begin), _end(end) {}
+
+    StatusWith<uint64_t> next() {
+        if (_zeros > 0) {
+            --_zeros;
+            return 0;
+        }
+
+        auto value = _readVarint();
+        if (!value.isOK() || value.getValue() != 0)
+            return value;
+
+        auto runLength = _readVarint();
+        if (!runLength.isOK())
+            return runLength;
+        _zeros = runLength.getValue();
+        return 0;
+    }
+
+    /**
+     * Returns whether every value of the stream has been read.
+     */
+    bool atEnd() const {
+        return _zeros == 0 && _pos == _end;
+    }
+
+private:
+    StatusWith<uint64_t> _readVarint() {
+        uint64 value;
+        const char* next = Varint::Parse64WithLimit(_pos, _end, &value);
+        if (!next)
+            return malformed("bad varint");
+        _pos = next;
+        return static_cast<uint64_t>(value);
+    }
+
+    const char* _pos;
+    const char* _end;
+    uint64_t _zeros = 0;
+};
+
+/**
+ * Writes bit strings most significant bit first.
+ */
+class BitWriter {
+public:
+    explicit BitWriter(BufBuilder* out) : _out(out) {}
+
+    /**
+     * Writes the low 'numBits' bits of 'value', where 'numBits' is at most 64.
+     */
+    void write(uint64_t value, int numBits) {
+        while (numBits > 0) {
+            if (_bitsInLastByte == 8) {
+                _out->appendChar(0);
+                _bitsInLastByte = 0;
+            }
+            const int available = 8 - _bitsInLastByte;
+            const int take = std::min(available, numBits);
+            const auto chunk = (value >> (numBits - take)) & ((1u << take) - 1);
+            _out->buf()[_out->len() - 1] |= static_cast<char>(chunk << (available - take));
+            _bitsInLastByte += take;
+            numBits -= take;
+        }
+    }
+
+private:
+    BufBuilder* _out;
+    int _bitsInLastByte = 8;
+};
+
+class BitReader {
+public:
+    BitReader(const char* begin, const char* end)
+        : _data(reinterpret_cast<const unsigned char*>(begin)), _numBits((end - begin) * 8) {}
+
+    StatusWith<uint64_t> read(int numBits) {
+        if (_numBits - _bitPos < static_cast<size_t>(numBits))
+            return malformed("truncated bit stream");
+
+        uint64_t value = 0;
+        while (numBits > 0) {
+            const int available = 8 - static_cast<int>(_bitPos % 8);
+            const int take = std::min(available, numBits);
+            const auto chunk = (_data[_bitPos / 8] >> (available - take)) & ((1u << take) - 1);
+            value = (value << take) | chunk;
+            _bitPos += take;
+            numBits -= take;
+        }
+        return value;
+    }
+
+    /**
+     * Returns whether fewer than 8 bits are left unread, as the last byte may be padded.
+     */
+    bool atEnd() const {
+        return _numBits - _bitPos < 8;
+    }
+
+private:
+    const unsigned char* _data;
+    const size_t _numBits;
+    size_t _bitPos = 0;
+};
+
+void encodeDeltaOfDelta(const std::vector<uint64_t>& values, BufBuilder* out) {
+    // Differences are taken modulo 2**64, which decoding undoes exactly.
+    ZeroRunVarintWriter writer(out);
+    writer.append(zigzagEncode(static_cast<int64_t>(values[0])));
+    uint64_t prevDelta = 0;
+    for (size_t i = 1; i < values.size(); ++i) {
+        const uint64_t delta = values[i] - values[i - 1];
+        writer.append(zigzagEncode(static_cast<int64_t>(delta - prevDelta)));
+        prevDelta = delta;
+    }
+    writer.flush();
+}
+
+void encodeXor(const std::vector<uint64_t>& values, BufBuilder* out) {
+    BitWriter writer(out);
+    writer.write(values[0], 64);
+
+    // The window of meaningful bits of the last value that was stored with one.
+    int prevLeading = -1;
+    int prevTrailing = 0;
+    for (size_t i = 1; i < values.size(); ++i) {
+        const uint64_t xorValue = values[i] ^ values[i - 1];
+        if (xorValue == 0) {
+            writer.write(0, 1);
+            continue;
+        }
+
+        const int leading = std::min(countLeadingZeros64(xorValue), kMaxLeadingZeros);
+        const int trailing = countTrailingZeros64(xorValue);
+        if (prevLeading >= 0 && leading >= prevLeading && trailing >= prevTrailing) {
+            // The differing bits fit the previous window.
+            writer.write(0b10, 2);
+            writer.write(xorValue >> prevTrailing, 64 - prevLeading - prevTrailing);
+        } else {
+            const int meaningful = 64 - leading - trailing;
+            writer.write(0b11, 2);
+            writer.write(leading, kLeadingZerosBits);
+            writer.write(meaningful - 1, kMeaningfulBitsBits);
+            writer.write(xorValue >> trailing, meaningful);
+            prevLeading = leading;
+            prevTrailing = trailing;
+        }
+    }
+}
+
+class DeltaOfDeltaReader {
+public:
+    DeltaOfDeltaReader(const char* begin, const char* end) : _reader(begin, end) {}
+
+    StatusWith<uint64_t> next() {
+        auto encoded = _reader.next();
+        if (!encoded.isOK())
+            return encoded;
+
+        const uint64_t decoded = static_cast<uint64_t>(zigzagDecode(encoded.getValue()));
+        if (_first) {
+            _first = false;
+            _prev = decoded;
+        } else {
+            _prevDelta += decoded;
+            _prev += _prevDelta;
+        }
+        return _prev;
+    }
+
+    bool atEnd() const {
+        return _reader.atEnd();
+    }
+
+private:
+    ZeroRunVarintReader _reader;
+    bool _first = true;
+    uint64_t _prev = 0;
+    uint64_t _prevDelta = 0;
+};
+
+class XorReader {
+public:
+    XorReader(const char* begin, const char* end) : _reader(begin, end) {}
+
+    StatusWith<uint64_t> next() {
+        if (_first) {
+            _first = false;
+            auto value = _reader.read(64);
+            if (value.isOK())
+                _prev = value.getValue();
+            return value;
+        }
+
+        auto changed = _reader.read(1);
+        if (!changed.isOK())
+            return changed;
+        if (changed.getValue() == 0)
+            return _prev;
+
+        auto newWindow = _reader.read(1);
+        if (!newWindow.isOK())
+            return newWindow;
+        if (newWindow.getValue() == 1) {
+            auto leading = _reader.read(kLeadingZerosBits);
+            if (!leading.isOK())
+                return leading;
+            auto meaningful = _reader.read(kMeaningfulBitsBits);
+            if (!meaningful.isOK())
+                return meaningful;
+            const int numMeaningful = static_cast<int>(meaningful.getValue()) + 1;
+            if (static_cast<int>(leading.getValue()) + numMeaningful > 64)
+                return malformed("bad XOR window");
+            _leading = static_cast<int>(leading.getValue());
+            _trailing = 64 - _leading - numMeaningful;
+        } else if (_leading < 0) {
+            return malformed("XOR window used before being set");
+        }
+
+        auto bits = _reader.read(64 - _leading - _trailing);
+        if (!bits.isOK())
+            return bits;
+        _prev ^= bits.getValue() << _trailing;
+        return _prev;
+    }
+
+    bool atEnd() const {
+        return _reader.atEnd();
+    }
+
+private:
+    BitReader _reader;
+    bool _first = true;
+    uint64_t _prev = 0;
+    int _leading = -1;
+    int _trailing = 0;
+};
+
+/**
+ * Appends the value with bits 'bits' of BSON type 'type' to 'builder'.
+ */
+Status appendValue(BSONType type, StringData fieldName, uint64_t bits, BSONObjBuilder* builder) {
+    const auto asLong = static_cast<long long>(bits);
+    switch (type) {
+        case NumberInt:
+            if (asLong < std::numeric_limits<int>::min() ||
+                asLong > std::numeric_limits<int>::max())
+                return malformed("32-bit integer out of range");
+            builder->append(fieldName, static_cast<int>(asLong));
+            return Status::OK();
+        case NumberLong:
+            builder->append(fieldName, asLong);
+            return Status::OK();
+        case Date:
+            builder->appendDate(fieldName, Date_t::fromMillisSinceEpoch(asLong));
+            return Status::OK();
+        case bsonTimestamp:
+            builder->append(fieldName, Timestamp(bits));
+            return Status::OK();
+        case NumberDouble: {
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            builder->append(fieldName, value);
+            return Status::OK();
+        }
+        default:
+            return malformed("unsupported value type");
+    }
+}
+
+template <typename ValueReader>
+StatusWith<BSONObj> decodeValues(BSONType type,
+                                 uint64_t count,
+                                 ZeroRunVarintReader* positions,
+                                 ValueReader* values) {
+    BSONObjBuilder builder;
+    uint64_t position = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+        auto gap = positions->next();
+        if (!gap.isOK())
+            return gap.getStatus();
+        if (i > 0 && gap.getValue() >= std::numeric_limits<uint64_t>::max() - position)
+            return malformed("position out of range");
+        position = i == 0 ? gap.getValue() : position + gap.getValue() + 1;
+
+        auto value = values->next();
+        if (!value.isOK())
+            return value.getStatus();
+        auto status = appendValue(type, ItoA(position), value.getValue(), &builder);
+        if (!status.isOK())
+            return status;
+
+        if (builder.len() > BSONObjMaxInternalSize)
+            return malformed("column too large");
+    }
+
+    if (!positions->atEnd() || !values->atEnd())
+        return malformed("trailing data");
+    return builder.obj();
+}
+
+}  // namespace
+
+void encode(const BSONObj& column, BufBuilder* out) {
+    // Columns of canonical, increasing positions holding values of a single supported type are
+    // compressed, and anything else is stored as is.
+    std::vector<uint64_t> positions;
+    std::vector<uint64_t> values;
+    BSONType type = EOO;
+    bool compressible = !column.isEmpty();
+    for (auto&& elem : column) {
+        const auto position = parsePosition(elem.fieldNameStringData());
+        if (!position || (!positions.empty() && *position <= positions.back()) ||
+            (type != EOO && elem.type() != type)) {
+            compressible = false;
+            break;
+        }
+
+        type = elem.type();
+        switch (type) {
+            case NumberInt:
+                values.push_back(static_cast<uint64_t>(static_cast<int64_t>(elem._numberInt())));
+                break;
+            case NumberLong:
+                values.push_back(static_cast<uint64_t>(elem._numberLong()));
+                break;
+            case Date:
+                values.push_back(static_cast<uint64_t>(elem.date().toMillisSinceEpoch()));
+                break;
+            case bsonTimestamp:
+                values.push_back(elem.timestamp().asULL());
+                break;
+            case NumberDouble: {
+                const double value = elem._numberDouble();
+                uint64_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                values.push_back(bits);
+                break;
+            }
+            default:
+                compressible = false;
+        }
+        if (!compressible)
+            break;
+        positions.push_back(*position);
+    }
+
+    if (!compressible) {
+        out->appendChar(static_cast<char>(Encoding::kRaw));
+        out->appendBuf(column.objdata(), column.objsize());
+        return;
+    }
+
+    const auto encoding = type == NumberDouble ? Encoding::kXor : Encoding::kDeltaOfDelta;
+    out->appendChar(static_cast<char>(encoding));
+    out->appendChar(static_cast<char>(type));
+    appendVarint(positions.size(), out);
+
+    BufBuilder gaps;
+    ZeroRunVarintWriter gapWriter(&gaps);
+    gapWriter.append(positions[0]);
+    for (size_t i = 1; i < positions.size(); ++i) {
+        gapWriter.append(positions[i] - positions[i - 1] - 1);
+    }
+    gapWriter.flush();
+    appendVarint(gaps.len(), out);
+    out->appendBuf(gaps.buf(), gaps.len());
+
+    if (encoding == Encoding::kXor) {
+        encodeXor(values, out);
+    } else {
+        encodeDeltaOfDelta(values, out);
+    }
+}
+
+void appendEncoded(const BSONObj& column, StringData fieldName, BSONObjBuilder* builder) {
+    BufBuilder encoded;
+    encode(column, &encoded);
+    builder->appendBinData(fieldName, encoded.len(), BinDataType::Column, encoded.buf());
+}
+
+StatusWith<BSONObj> decode(ConstDataRange encoded) {
+    const char* pos = encoded.data();
+    const char* const end = pos + encoded.length();
+    if (pos == end)
+        return malformed("empty");
+
+    const auto encoding = static_cast<Encoding>(*pos++);
+    if (encoding == Encoding::kRaw) {
+        auto status = validateBSON(pos, end - pos, BSONVersion::kLatest);
+        if (!status.isOK())
+            return status;
+        BSONObj column(pos);
+        if (column.objsize() != end - pos)
+            return malformed("trailing data");
+        return column.getOwned();
+    }
+    if (encoding != Encoding::kDeltaOfDelta && encoding != Encoding::kXor)
+        return malformed("unknown encoding");
+
+    if (pos == end)
+        return malformed("missing type");
+    const auto type = static_cast<BSONType>(*pos++);
+    if ((encoding == Encoding::kXor) != (type == NumberDouble))
+        return malformed("type does not match encoding");
+
+    uint64 count;
+    pos = Varint::Parse64WithLimit(pos, end, &count);
+    uint64 gapsLength;
+    if (pos)
+        pos = Varint::Parse64WithLimit(pos, end, &gapsLength);
+    if (!pos || count == 0 || gapsLength > static_cast<uint64_t>(end - pos))
+        return malformed("bad header");
+
+    ZeroRunVarintReader positions(pos, pos + gapsLength);
+    pos += gapsLength;
+    if (encoding == Encoding::kXor) {
+        XorReader values(pos, end);
+        return decodeValues(type, count, &positions, &values);
+    }
+    DeltaOfDeltaReader values(pos, end);
+    return decodeValues(type, count, &positions, &values);
+}
+
+}  // namespace column_codec
+}  // namespace mongo
@@ -0,0 +1,77 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/data_range.h"
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/util/builder.h"
+
+namespace mongo {
+namespace column_codec {
+
+/**
+ * Compression of a column of values, stored as a BSON object whose field names are the increasing
+ * positions of the values in some sequence: {'0': <value>, '1': <value>, '5': <value>, ...}.
+ * Positions may be skipped. This is the layout of a field of a time-series bucket's 'data'.
+ *
+ * Depending on the values, the column is encoded as one of the following, after a leading byte
+ * naming the encoding:
+ *  - dates, timestamps and 32- or 64-bit integers of a single type: delta-of-delta encoding of
+ *    the values as zigzag varints, where runs of zeros are stored as a single count. Regularly
+ *    spaced times and repeated or evenly increasing counters take a few bytes per run.
+ *  - doubles: the XOR encoding of "Gorilla: A Fast, Scalable, In-Memory Time Series Database"
+ *    (Pelkonen et al., VLDB 2015), which stores each value as its differing bits from the previous
+ *    one, and repeated values as a single bit.
+ *  - anything else: the column object as is.
+ * Positions are stored as varint gaps, with runs of consecutive positions stored as one count.
+ *
+ * The encoded column is meant to be stored as BinData of subtype BinDataType::Column.
+ */
+
+/**
+ * Appends the encoded form of 'column' to 'out'.
+ */
+void encode(const BSONObj& column, BufBuilder* out);
+
+/**
+ * Appends 'column', encoded as BinData of subtype BinDataType::Column, to 'builder'.
+ */
+void appendEncoded(const BSONObj& column, StringData fieldName, BSONObjBuilder* builder);
+
+/**
+ * Decodes a column encoded by encode(). Returns an error status if 'encoded' is malformed.
+ */
+StatusWith<BSONObj> decode(ConstDataRange encoded);
+
+}  // namespace column_codec
+}  // namespace mongo
@@ -0,0 +1,176 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <limits>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/util/column_codec.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+BufBuilder encode(const BSONObj& column) {
+    BufBuilder encoded;
+    column_codec::encode(column, &encoded);
+    return encoded;
+}
+
+/**
+ * Encodes and decodes 'column', asserts that the result is identical to 'column', and returns the
+ * size of its encoded form.
+ */
+int assertRoundTrips(const BSONObj& column) {
+    auto encoded = encode(column);
+    auto decoded = column_codec::decode(ConstDataRange(encoded.buf(), encoded.len()));
+    ASSERT_OK(decoded.getStatus());
+    ASSERT_TRUE(column.binaryEqual(decoded.getValue())) << decoded.getValue();
+    return encoded.len();
+}
+
+Status decodeBytes(const std::vector<char>& bytes) {
+    return column_codec::decode(ConstDataRange(bytes.data(), bytes.size())).getStatus();
+}
+
+TEST(ColumnCodecTest, RegularlySpacedDatesCompressWell) {
+    BSONObjBuilder builder;
+    const long long start = 1546300800000LL;
+    for (int i = 0; i < 1000; ++i) {
+        builder.appendDate(std::to_string(i), Date_t::fromMillisSinceEpoch(start + i * 1000));
+    }
+    auto column = builder.obj();
+    ASSERT_LT(assertRoundTrips(column), 32);
+    ASSERT_GT(column.objsize(), 10000);
+}
+
+TEST(ColumnCodecTest, RoundTripsIntegersOfEachType) {
+    assertRoundTrips(BSON("0" << 1 << "1" << -7 << "2" << std::numeric_limits<int>::max() << "3"
+                              << std::numeric_limits<int>::min()));
+    assertRoundTrips(BSON("0" << std::numeric_limits<long long>::min() << "1"
+                              << std::numeric_limits<long long>::max() << "2" << 0LL << "3"
+                              << std::numeric_limits<long long>::min()));
+    assertRoundTrips(BSON("0" << Timestamp(1, 1) << "1" << Timestamp(1, 2) << "2"
+                              << Timestamp(std::numeric_limits<unsigned int>::max(), 0)));
+    assertRoundTrips(BSON("0" << Date_t::fromMillisSinceEpoch(-5) << "1"
+                              << Date_t::max() << "2" << Date_t::min()));
+}
+
+TEST(ColumnCodecTest, RoundTripsDoubles) {
+    assertRoundTrips(BSON("0" << 1.5 << "1" << 1.5 << "2" << 1.75 << "3" << -0.0 << "4" << 0.0
+                              << "5" << std::numeric_limits<double>::quiet_NaN() << "6"
+                              << std::numeric_limits<double>::infinity() << "7"
+                              << std::numeric_limits<double>::denorm_min() << "8" << 1e308));
+
+    BSONObjBuilder builder;
+    for (int i = 0; i < 1000; ++i) {
+        builder.append(std::to_string(i), 20.0 + (i % 10) * 0.25);
+    }
+    assertRoundTrips(builder.obj());
+}
+
+TEST(ColumnCodecTest, RepeatedDoublesCompressWell) {
+    BSONObjBuilder builder;
+    for (int i = 0; i < 1000; ++i) {
+        builder.append(std::to_string(i), 98.6);
+    }
+    ASSERT_LT(assertRoundTrips(builder.obj()), 150);
+}
+
+TEST(ColumnCodecTest, RoundTripsSparsePositions) {
+    assertRoundTrips(BSON("3" << 1 << "4" << 2 << "10" << 3 << "1000000" << 4));
+    assertRoundTrips(BSON("0" << 2.5 << "7" << 3.5));
+    assertRoundTrips(BSON("12" << 5LL));
+}
+
+TEST(ColumnCodecTest, StoresUnsupportedColumnsAsIs) {
+    // Mixed types, unsupported types, non-canonical or unordered positions, and empty columns.
+    assertRoundTrips(BSON("0" << 1 << "1" << 2LL));
+    assertRoundTrips(BSON("0"
+                          << "a"
+                          << "1"
+                          << "b"));
+    assertRoundTrips(BSON("00" << 1 << "1" << 2));
+    assertRoundTrips(BSON("1" << 1 << "0" << 2));
+    assertRoundTrips(BSON("0" << 1 << "0" << 2));
+    assertRoundTrips(BSON("a" << 1));
+    assertRoundTrips(BSONObj());
+}
+
+TEST(ColumnCodecTest, AppendEncodedAppendsColumnBinData) {
+    auto column = BSON("0" << 1 << "1" << 2);
+    BSONObjBuilder builder;
+    column_codec::appendEncoded(column, "a", &builder);
+    auto obj = builder.obj();
+
+    ASSERT_EQ(BinData, obj["a"].type());
+    ASSERT_EQ(BinDataType::Column, obj["a"].binDataType());
+    int length;
+    const char* data = obj["a"].binData(length);
+    auto decoded = column_codec::decode(ConstDataRange(data, length));
+    ASSERT_OK(decoded.getStatus());
+    ASSERT_TRUE(column.binaryEqual(decoded.getValue())) << decoded.getValue();
+}
+
+TEST(ColumnCodecTest, RejectsMalformedInput) {
+    ASSERT_EQ(ErrorCodes::BadValue, decodeBytes({}));
+    ASSERT_EQ(ErrorCodes::BadValue, decodeBytes({9}));
+    // Raw encoding of a truncated object.
+    ASSERT_EQ(ErrorCodes::BadValue, decodeBytes({0, 5, 0, 0}));
+    // Delta-of-delta encoding of a type it does not support, or of doubles.
+    ASSERT_EQ(ErrorCodes::BadValue, decodeBytes({1, String, 1, 2, 0, 0, 2}));
+    ASSERT_EQ(ErrorCodes::BadValue, decodeBytes({1, NumberDouble, 1, 2, 0, 0, 2}));
+    // A count that does not match the streams.
+    ASSERT_EQ(ErrorCodes::BadValue, decodeBytes({1, NumberInt, 2, 2, 0, 0, 2}));
+    ASSERT_EQ(ErrorCodes::BadValue, decodeBytes({1, NumberInt, 1, 2, 0, 0, 2, 2}));
+    // A positions stream longer than the input.
+    ASSERT_EQ(ErrorCodes::BadValue, decodeBytes({1, NumberInt, 1, 9, 0, 0, 2}));
+    // A 32-bit integer column holding a 64-bit value.
+    ASSERT_EQ(ErrorCodes::BadValue,
+              decodeBytes({1, NumberInt, 1, 2, 0, 0, char(0x80), char(0x80), char(0x80),
+                           char(0x80), 0x10}));
+    // {'0': NumberInt(1)}
+    ASSERT_OK(decodeBytes({1, NumberInt, 1, 2, 0, 0, 2}));
+}
+
+TEST(ColumnCodecTest, RejectsTruncatedInput) {
+    BSONObjBuilder builder;
+    for (int i = 0; i < 100; ++i) {
+        builder.append(std::to_string(i * 2), i * 0.1);
+    }
+    auto encoded = encode(builder.obj());
+    for (int length = 0; length < encoded.len(); ++length) {
+        ASSERT_NOT_OK(
+            column_codec::decode(ConstDataRange(encoded.buf(), length)).getStatus());
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -32,6 +32,7 @@
 #include "mongo/client/native_sasl_client_session.h"
 
 #include "mongo/base/init.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/client/sasl_client_conversation.h"
 #include "mongo/client/sasl_plain_client_conversation.h"
 #include "mongo/client/sasl_scram_client_conversation.h"
@@ -56,6 +57,17 @@ MONGO_INITIALIZER(NativeSaslClientContext)(InitializerContext* context) {
 auto* scramsha1ClientCache = new SCRAMClientCache<SHA1Block>;
 auto* scramsha256ClientCache = new SCRAMClientCache<SHA256Block>;
 
+template <typename HashBlock>
+void appendCacheStats(const SCRAMClientCache<HashBlock>& cache,
+                      StringData mechanism,
+                      BSONObjBuilder* builder) {
+    const auto stats = cache.getStats();
+    BSONObjBuilder sub(builder->subobjStart(mechanism));
+    sub.append("hits", stats.hits);
+    sub.append("misses", stats.misses);
+    sub.append("entries", stats.entries);
+}
+
 }  // namespace
 
 NativeSaslClientSession::NativeSaslClientSession()
@@ -63,6 +75,11 @@ NativeSaslClientSession::NativeSaslClientSession()
 
 NativeSaslClientSession::~NativeSaslClientSession() {}
 
+void NativeSaslClientSession::appendSCRAMClientCacheStats(BSONObjBuilder* builder) {
+    appendCacheStats(*scramsha1ClientCache, "SCRAM-SHA-1", builder);
+    appendCacheStats(*scramsha256ClientCache, "SCRAM-SHA-256", builder);
+}
+
 Status NativeSaslClientSession::initialize() {
     if (_saslConversation)
         return Status(ErrorCodes::AlreadyInitialized,
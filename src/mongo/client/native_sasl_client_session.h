@@ -32,6 +32,7 @@
 
 namespace mongo {
 
+class BSONObjBuilder;
 class SaslClientConversation;
 
 /**
@@ -54,6 +55,12 @@ public:
         return _success;
     }
 
+    /**
+     * Appends the hit, miss and entry counts of the process-wide caches of SCRAM client keys,
+     * one subdocument per mechanism.
+     */
+    static void appendSCRAMClientCacheStats(BSONObjBuilder* builder);
+
 private:
     /// Number of successfully completed conversation steps.
     int _step;
@@ -28,12 +28,12 @@
  */
 #pragma once
 
-#include <boost/optional.hpp>
 #include <string>
+#include <utility>
 
 #include "mongo/crypto/mechanism_scram.h"
 #include "mongo/stdx/mutex.h"
-#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/lru_cache.h"
 #include "mongo/util/net/hostandport.h"
 
 namespace mongo {
@@ -64,61 +64,68 @@ namespace mongo {
 template <typename HashBlock>
 class SCRAMClientCache {
 private:
-    using HostToSecretsPair = std::pair<scram::Presecrets<HashBlock>, scram::Secrets<HashBlock>>;
-    using HostToSecretsMap = stdx::unordered_map<HostAndPort, HostToSecretsPair>;
+    // Entries are keyed on the full presecrets, which carry the password, salt and iteration
+    // count, so a process authenticating as several users against one host keeps all of their
+    // secrets, and a credential change on the server is simply a miss for the new presecrets.
+    using CacheKey = std::pair<HostAndPort, scram::Presecrets<HashBlock>>;
+    using Cache = LRUCache<CacheKey, scram::Secrets<HashBlock>>;
 
 public:
+    static constexpr std::size_t kDefaultMaxEntries = 256;
+
+    struct Stats {
+        long long hits = 0;
+        long long misses = 0;
+        long long entries = 0;
+    };
+
+    explicit SCRAMClientCache(std::size_t maxEntries = kDefaultMaxEntries) : _cache(maxEntries) {}
+
     /**
      * Returns precomputed SCRAMSecrets, if one has already been
-     * stored for the specified hostname and the provided presecrets
-     * match those recorded for the hostname. Otherwise, no secrets
-     * are returned.
+     * stored for the specified hostname and presecrets. Otherwise,
+     * no secrets are returned.
      */
-    scram::Secrets<HashBlock> getCachedSecrets(
-        const HostAndPort& target, const scram::Presecrets<HashBlock>& presecrets) const {
-        const stdx::lock_guard<stdx::mutex> lock(_hostToSecretsMutex);
+    scram::Secrets<HashBlock> getCachedSecrets(const HostAndPort& target,
+                                               const scram::Presecrets<HashBlock>& presecrets) {
+        const stdx::lock_guard<stdx::mutex> lock(_mutex);
 
-        // Search the cache for a record associated with the host we're trying to connect to.
-        auto foundSecret = _hostToSecrets.find(target);
-        if (foundSecret == _hostToSecrets.end()) {
+        // Presecrets contain parameters provided by the server, which may change. Since they are
+        // part of the key, stale secrets for old parameters are never returned; they age out of
+        // the cache instead.
+        auto it = _cache.find(std::make_pair(target, presecrets));
+        if (it == _cache.end()) {
+            ++_stats.misses;
             return {};
         }
 
-        // Presecrets contain parameters provided by the server, which may change. If the
-        // cached presecrets don't match the presecrets we have on hand, we must not return the
-        // stale cached secrets. We'll need to rerun the SCRAM computation.
-        const auto& foundPresecrets = foundSecret->second.first;
-        if (foundPresecrets == presecrets) {
-            return foundSecret->second.second;
-        } else {
-            return {};
-        }
+        ++_stats.hits;
+        return it->second;
     }
 
     /**
      * Records a set of precomputed SCRAMSecrets for the specified
-     * host, along with the presecrets used to generate them.
+     * host, along with the presecrets used to generate them. Evicts
+     * the least recently used entry if the cache is full.
      */
     void setCachedSecrets(HostAndPort target,
                           scram::Presecrets<HashBlock> presecrets,
                           scram::Secrets<HashBlock> secrets) {
-        const stdx::lock_guard<stdx::mutex> lock(_hostToSecretsMutex);
+        const stdx::lock_guard<stdx::mutex> lock(_mutex);
+        _cache.add(std::make_pair(std::move(target), std::move(presecrets)), std::move(secrets));
+    }
 
-        typename HostToSecretsMap::iterator it;
-        bool insertionSuccessful;
-        auto cacheRecord = std::make_pair(std::move(presecrets), std::move(secrets));
-        // Insert the presecrets, and the secrets we computed for them into the cache
-        std::tie(it, insertionSuccessful) = _hostToSecrets.emplace(std::move(target), cacheRecord);
-        // If there was already a cache entry for the target HostAndPort, we should overwrite it.
-        // We have fresher presecrets and secrets.
-        if (!insertionSuccessful) {
-            it->second = std::move(cacheRecord);
-        }
+    Stats getStats() const {
+        const stdx::lock_guard<stdx::mutex> lock(_mutex);
+        Stats stats = _stats;
+        stats.entries = _cache.size();
+        return stats;
     }
 
 private:
-    mutable stdx::mutex _hostToSecretsMutex;
-    HostToSecretsMap _hostToSecrets;
+    mutable stdx::mutex _mutex;
+    Cache _cache;
+    Stats _stats;
 };
 
 }  // namespace mongo
@@ -113,6 +113,14 @@ public:
                                              saltLength());
     }
 
+    template <typename H>
+    friend H AbslHashValue(H h, const Presecrets& presecrets) {
+        return H::combine(std::move(h),
+                          presecrets._password,
+                          presecrets._salt,
+                          presecrets._iterationCount);
+    }
+
 private:
     template <typename T>
     friend bool operator==(const Presecrets<T>&, const Presecrets<T>&);
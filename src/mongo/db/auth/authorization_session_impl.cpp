@@ -807,6 +807,7 @@ void AuthorizationSessionImpl::_refreshUserInfoAsNeeded(OperationContext* opCtx)
 }
 
 void AuthorizationSessionImpl::_buildAuthenticatedRolesVector() {
+    _userActionsByResource.clear();
     _authenticatedRoleNames.clear();
     for (UserSet::iterator it = _authenticatedUsers.begin(); it != _authenticatedUsers.end();
          ++it) {
@@ -887,38 +888,61 @@ bool AuthorizationSessionImpl::isAuthorizedForAnyActionOnResource(const Resource
 bool AuthorizationSessionImpl::_isAuthorizedForPrivilege(const Privilege& privilege) {
     const ResourcePattern& target(privilege.getResourcePattern());
 
-    ResourcePattern resourceSearchList[resourceSearchListCapacity];
-    const int resourceSearchListLength = buildResourceSearchList(target, resourceSearchList);
-
     ActionSet unmetRequirements = privilege.getActions();
 
+    // Default privileges only exist while the localhost exception is in effect, so the search
+    // list for them is built on demand; user privileges are looked up through
+    // _getUserActionsForResource().
     PrivilegeVector defaultPrivileges = getDefaultPrivileges();
-    for (PrivilegeVector::iterator it = defaultPrivileges.begin(); it != defaultPrivileges.end();
-         ++it) {
-        for (int i = 0; i < resourceSearchListLength; ++i) {
-            if (!(it->getResourcePattern() == resourceSearchList[i]))
-                continue;
+    if (!defaultPrivileges.empty()) {
+        ResourcePattern resourceSearchList[resourceSearchListCapacity];
+        const int resourceSearchListLength = buildResourceSearchList(target, resourceSearchList);
+
+        for (PrivilegeVector::iterator it = defaultPrivileges.begin();
+             it != defaultPrivileges.end();
+             ++it) {
+            for (int i = 0; i < resourceSearchListLength; ++i) {
+                if (!(it->getResourcePattern() == resourceSearchList[i]))
+                    continue;
+
+                ActionSet userActions = it->getActions();
+                unmetRequirements.removeAllActionsFromSet(userActions);
+
+                if (unmetRequirements.empty())
+                    return true;
+            }
+        }
+    }
 
-            ActionSet userActions = it->getActions();
-            unmetRequirements.removeAllActionsFromSet(userActions);
+    unmetRequirements.removeAllActionsFromSet(_getUserActionsForResource(target));
+    return unmetRequirements.empty();
+}
 
-            if (unmetRequirements.empty())
-                return true;
-        }
+const ActionSet& AuthorizationSessionImpl::_getUserActionsForResource(
+    const ResourcePattern& target) {
+    // Sessions normally touch a handful of namespaces; start over rather than grow without bound
+    // for the rare one which walks through many.
+    constexpr size_t kMaxMemoizedResources = 1024;
+
+    auto it = _userActionsByResource.find(target);
+    if (it != _userActionsByResource.end()) {
+        return it->second;
     }
 
+    ResourcePattern resourceSearchList[resourceSearchListCapacity];
+    const int resourceSearchListLength = buildResourceSearchList(target, resourceSearchList);
+
+    ActionSet userActions;
     for (const auto& user : _authenticatedUsers) {
         for (int i = 0; i < resourceSearchListLength; ++i) {
-            ActionSet userActions = user->getActionsForResource(resourceSearchList[i]);
-            unmetRequirements.removeAllActionsFromSet(userActions);
-
-            if (unmetRequirements.empty()) {
-                return true;
-            }
+            userActions.addAllActionsFromSet(user->getActionsForResource(resourceSearchList[i]));
         }
     }
 
-    return false;
+    if (_userActionsByResource.size() >= kMaxMemoizedResources) {
+        _userActionsByResource.clear();
+    }
+    return _userActionsByResource.emplace(target, std::move(userActions)).first->second;
 }
 
 void AuthorizationSessionImpl::setImpersonatedUserData(std::vector<UserName> usernames,
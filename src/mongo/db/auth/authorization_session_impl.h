@@ -42,6 +42,7 @@
 #include "mongo/db/auth/user_name.h"
 #include "mongo/db/auth/user_set.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
 
@@ -199,7 +200,8 @@ public:
 protected:
     // Builds a vector of all roles held by users who are authenticated on this connection. The
     // vector is stored in _authenticatedRoleNames. This function is called when users are
-    // logged in or logged out, as well as when the user cache is determined to be out of date.
+    // logged in or logged out, as well as when the user cache is determined to be out of date,
+    // and so also discards the actions memoized in _userActionsByResource.
     void _buildAuthenticatedRolesVector();
 
     // All Users who have been authenticated on this connection.
@@ -220,12 +222,21 @@ private:
     // lock on the admin database (to update out-of-date user privilege information).
     bool _isAuthorizedForPrivilege(const Privilege& privilege);
 
+    // Returns the union of the actions that the authenticated users hold on every resource pattern
+    // matching 'target', computing it on the first check against 'target'.
+    const ActionSet& _getUserActionsForResource(const ResourcePattern& target);
+
     std::tuple<std::vector<UserName>*, std::vector<RoleName>*> _getImpersonations() override {
         return std::make_tuple(&_impersonatedUserNames, &_impersonatedRoleNames);
     }
 
     std::unique_ptr<AuthzSessionExternalState> _externalState;
 
+    // Memoizes _getUserActionsForResource(), so that repeated checks against the same resource
+    // cost a single lookup no matter how many users and roles are authenticated. Only valid for
+    // the current contents of _authenticatedUsers.
+    stdx::unordered_map<ResourcePattern, ActionSet> _userActionsByResource;
+
     // A vector of impersonated UserNames and a vector of those users' RoleNames.
     // These are used in the auditing system. They are not used for authz checks.
     std::vector<UserName> _impersonatedUserNames;
@@ -482,6 +482,35 @@ TEST_F(AuthorizationSessionTest, InvalidateUser) {
     ASSERT_FALSE(authzSession->lookupUser(UserName("spencer", "test")));
 }
 
+TEST_F(AuthorizationSessionTest, RepeatedChecksReflectChangesToAuthenticatedUsers) {
+    ASSERT_FALSE(
+        authzSession->isAuthorizedForActionsOnResource(testFooCollResource, ActionType::find));
+
+    authzSession->assumePrivilegesForDB(Privilege(testDBResource, ActionType::find), "test");
+    ASSERT_TRUE(
+        authzSession->isAuthorizedForActionsOnResource(testFooCollResource, ActionType::find));
+    ASSERT_TRUE(
+        authzSession->isAuthorizedForActionsOnResource(testFooCollResource, ActionType::find));
+    ASSERT_FALSE(
+        authzSession->isAuthorizedForActionsOnResource(testFooCollResource, ActionType::insert));
+
+    // Actions granted by different users on different patterns combine.
+    authzSession->assumePrivilegesForDB(Privilege(testFooCollResource, ActionType::insert),
+                                        "admin");
+    ASSERT_TRUE(authzSession->isAuthorizedForActionsOnResource(
+        testFooCollResource, ActionSet{ActionType::find, ActionType::insert}));
+
+    authzSession->revokePrivilegesForDB("test");
+    ASSERT_FALSE(
+        authzSession->isAuthorizedForActionsOnResource(testFooCollResource, ActionType::find));
+    ASSERT_TRUE(
+        authzSession->isAuthorizedForActionsOnResource(testFooCollResource, ActionType::insert));
+
+    authzSession->revokeAllPrivileges();
+    ASSERT_FALSE(
+        authzSession->isAuthorizedForActionsOnResource(testFooCollResource, ActionType::insert));
+}
+
 TEST_F(AuthorizationSessionTest, UseOldUserInfoInFaceOfConnectivityProblems) {
     // Add a readWrite user
     ASSERT_OK(managerState->insertPrivilegeDocument(_opCtx.get(),
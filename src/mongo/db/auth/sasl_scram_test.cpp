@@ -631,7 +631,7 @@ TEST(SCRAMCache, testSetAndGetWithDifferentParameters) {
 }
 
 template <typename HashBlock>
-void testSetAndReset() {
+void testSetMultipleForHost() {
     SCRAMClientCache<HashBlock> cache;
     const auto salt = scram::Presecrets<HashBlock>::generateSecureRandomSalt();
     HostAndPort host("localhost:27017");
@@ -643,17 +643,51 @@ void testSetAndReset() {
     const auto secretsB = scram::Secrets<HashBlock>(presecretsB);
     cache.setCachedSecrets(host, presecretsB, secretsB);
 
-    ASSERT_FALSE(cache.getCachedSecrets(host, presecretsA));
-    const auto cachedSecret = cache.getCachedSecrets(host, presecretsB);
-    ASSERT_TRUE(cachedSecret);
-    ASSERT_TRUE(secretsB.clientKey() == cachedSecret.clientKey());
-    ASSERT_TRUE(secretsB.serverKey() == cachedSecret.serverKey());
-    ASSERT_TRUE(secretsB.storedKey() == cachedSecret.storedKey());
+    // Both sets of secrets are kept for the host.
+    const auto cachedSecretA = cache.getCachedSecrets(host, presecretsA);
+    ASSERT_TRUE(cachedSecretA);
+    ASSERT_TRUE(secretsA.clientKey() == cachedSecretA.clientKey());
+    const auto cachedSecretB = cache.getCachedSecrets(host, presecretsB);
+    ASSERT_TRUE(cachedSecretB);
+    ASSERT_TRUE(secretsB.clientKey() == cachedSecretB.clientKey());
+    ASSERT_TRUE(secretsB.serverKey() == cachedSecretB.serverKey());
+    ASSERT_TRUE(secretsB.storedKey() == cachedSecretB.storedKey());
 }
 
-TEST(SCRAMCache, testSetAndReset) {
-    testSetAndReset<SHA1Block>();
-    testSetAndReset<SHA256Block>();
+TEST(SCRAMCache, testSetMultipleForHost) {
+    testSetMultipleForHost<SHA1Block>();
+    testSetMultipleForHost<SHA256Block>();
+}
+
+template <typename HashBlock>
+void testEvictionAndStats() {
+    SCRAMClientCache<HashBlock> cache(2);
+    const auto salt = scram::Presecrets<HashBlock>::generateSecureRandomSalt();
+    HostAndPort host("localhost:27017");
+
+    const auto presecretsA = scram::Presecrets<HashBlock>("aaa", salt, 10000);
+    const auto presecretsB = scram::Presecrets<HashBlock>("aab", salt, 10000);
+    const auto presecretsC = scram::Presecrets<HashBlock>("aac", salt, 10000);
+    cache.setCachedSecrets(host, presecretsA, scram::Secrets<HashBlock>(presecretsA));
+    cache.setCachedSecrets(host, presecretsB, scram::Secrets<HashBlock>(presecretsB));
+
+    // Touch A so that B is the least recently used entry when C is added.
+    ASSERT_TRUE(cache.getCachedSecrets(host, presecretsA));
+    cache.setCachedSecrets(host, presecretsC, scram::Secrets<HashBlock>(presecretsC));
+
+    ASSERT_TRUE(cache.getCachedSecrets(host, presecretsA));
+    ASSERT_FALSE(cache.getCachedSecrets(host, presecretsB));
+    ASSERT_TRUE(cache.getCachedSecrets(host, presecretsC));
+
+    const auto stats = cache.getStats();
+    ASSERT_EQ(3, stats.hits);
+    ASSERT_EQ(1, stats.misses);
+    ASSERT_EQ(2, stats.entries);
+}
+
+TEST(SCRAMCache, testEvictionAndStats) {
+    testEvictionAndStats<SHA1Block>();
+    testEvictionAndStats<SHA256Block>();
 }
 
 }  // namespace
@@ -0,0 +1,89 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonelement.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+/**
+ * Answers top-level field lookups on a single BSONObj, for callers which look up many fields of
+ * the same document. The first lookups scan the object like BSONObj::getField() does. Once more
+ * than 'kLinearLookupLimit' lookups have been made, a table from field name to element is built
+ * with one pass over the object, and later lookups no longer rescan it. This keeps the cost of
+ * extracting several fields from a wide document proportional to its size rather than to its size
+ * times the number of fields looked up.
+ *
+ * The table refers into the object's buffer, which must outlive this. Not thread safe.
+ */
+class BSONObjFieldIndex {
+    BSONObjFieldIndex(const BSONObjFieldIndex&) = delete;
+    BSONObjFieldIndex& operator=(const BSONObjFieldIndex&) = delete;
+
+public:
+    /**
+     * Number of lookups served by scanning the object before the table is built.
+     */
+    static constexpr int kLinearLookupLimit = 4;
+
+    explicit BSONObjFieldIndex(const BSONObj& obj) : _obj(obj) {}
+
+    const BSONObj& obj() const {
+        return _obj;
+    }
+
+    /**
+     * Returns the first top-level element named 'name', or EOO if there is none. Equivalent to
+     * obj().getField(name).
+     */
+    BSONElement getField(StringData name);
+
+    /**
+     * Returns whether the field table has been built. For testing.
+     */
+    bool isIndexed() const {
+        return _indexed;
+    }
+
+private:
+    const BSONObj& _obj;
+
+    int _numLookups = 0;
+    bool _indexed = false;
+
+    // Keyed by field names which point into '_obj', so building the table copies no strings.
+    absl::flat_hash_map<StringData, BSONElement, StringMapHasher, StringMapEq> _fields;
+};
+
+}  // namespace mongo
@@ -0,0 +1,98 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/bson/bsonobj_field_index.h"
+#include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+namespace dps = ::mongo::dotted_path_support;
+
+BSONObj makeWideObj(int numFields) {
+    BSONObjBuilder builder;
+    for (int i = 0; i < numFields; ++i) {
+        builder.append("f" + std::to_string(i), i);
+    }
+    return builder.obj();
+}
+
+TEST(BSONObjFieldIndex, LookupsMatchGetFieldBeforeAndAfterIndexing) {
+    const BSONObj obj = makeWideObj(300);
+    BSONObjFieldIndex fieldIndex(obj);
+
+    for (int i = 0; i < 300; i += 7) {
+        const auto fieldName = "f" + std::to_string(i);
+        ASSERT_EQ(fieldIndex.isIndexed(), i / 7 > BSONObjFieldIndex::kLinearLookupLimit);
+        ASSERT_BSONELT_EQ(obj.getField(fieldName), fieldIndex.getField(fieldName));
+    }
+    ASSERT_TRUE(fieldIndex.isIndexed());
+
+    ASSERT_TRUE(fieldIndex.getField("missing").eoo());
+    ASSERT_TRUE(fieldIndex.getField("").eoo());
+}
+
+TEST(BSONObjFieldIndex, DuplicateFieldNamesResolveToTheFirstOccurrence) {
+    const BSONObj obj = BSON("a" << 1 << "b" << 2 << "a" << 3);
+    BSONObjFieldIndex fieldIndex(obj);
+
+    for (int i = 0; i <= BSONObjFieldIndex::kLinearLookupLimit; ++i) {
+        ASSERT_EQ(1, fieldIndex.getField("a").numberInt());
+    }
+    ASSERT_TRUE(fieldIndex.isIndexed());
+    ASSERT_EQ(1, fieldIndex.getField("a").numberInt());
+    ASSERT_EQ(2, fieldIndex.getField("b").numberInt());
+}
+
+TEST(BSONObjFieldIndex, ExtractElementAtPathOrArrayAlongPath) {
+    const BSONObj obj = BSON("a" << BSON("b" << BSON_ARRAY(1 << 2)) << "c"
+                                 << BSON_ARRAY(BSON("d" << 1))
+                                 << "e"
+                                 << 5);
+    BSONObjFieldIndex fieldIndex(obj);
+
+    for (int i = 0; i <= BSONObjFieldIndex::kLinearLookupLimit; ++i) {
+        for (auto&& path : {"a.b", "c.d", "e", "e.f", "x.y"}) {
+            const char* indexedPath = path;
+            const char* scannedPath = path;
+            ASSERT_BSONELT_EQ(dps::extractElementAtPathOrArrayAlongPath(obj, scannedPath),
+                              dps::extractElementAtPathOrArrayAlongPath(&fieldIndex, indexedPath));
+            ASSERT_EQ(StringData(scannedPath), StringData(indexedPath));
+        }
+    }
+    ASSERT_TRUE(fieldIndex.isIndexed());
+}
+
+}  // namespace
+}  // namespace mongo
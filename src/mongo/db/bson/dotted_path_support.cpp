@@ -138,16 +138,23 @@ BSONElement extractElementAtPath(const BSONObj& obj, StringData path) {
     return e;
 }
 
-BSONElement extractElementAtPathOrArrayAlongPath(const BSONObj& obj, const char*& path) {
+namespace {
+
+/**
+ * Looks up the first component of 'path' with 'getField', advances 'path' past it and continues
+ * the extraction from the element found.
+ */
+template <typename GetFieldFn>
+BSONElement extractElementAtPathOrArrayAlongPathImpl(GetFieldFn&& getField, const char*& path) {
     const char* p = strchr(path, '.');
 
     BSONElement sub;
 
     if (p) {
-        sub = obj.getField(std::string(path, p - path));
+        sub = getField(StringData(path, p - path));
         path = p + 1;
     } else {
-        sub = obj.getField(path);
+        sub = getField(StringData(path));
         path = path + strlen(path);
     }
 
@@ -161,6 +168,19 @@ BSONElement extractElementAtPathOrArrayAlongPath(const BSONObj& obj, const char*
         return BSONElement();
 }
 
+}  // namespace
+
+BSONElement extractElementAtPathOrArrayAlongPath(const BSONObj& obj, const char*& path) {
+    return extractElementAtPathOrArrayAlongPathImpl(
+        [&](StringData fieldName) { return obj.getField(fieldName); }, path);
+}
+
+BSONElement extractElementAtPathOrArrayAlongPath(BSONObjFieldIndex* fieldIndex,
+                                                 const char*& path) {
+    return extractElementAtPathOrArrayAlongPathImpl(
+        [&](StringData fieldName) { return fieldIndex->getField(fieldName); }, path);
+}
+
 void extractAllElementsAlongPath(const BSONObj& obj,
                                  StringData path,
                                  BSONElementSet& elements,
@@ -34,6 +34,7 @@
 
 #include "mongo/bson/bsonelement_comparator_interface.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/db/bson/bsonobj_field_index.h"
 
 namespace mongo {
 namespace dotted_path_support {
@@ -78,6 +79,12 @@ BSONElement extractElementAtPath(const BSONObj& obj, StringData path);
  */
 BSONElement extractElementAtPathOrArrayAlongPath(const BSONObj& obj, const char*& path);
 
+/**
+ * Same as above, but looks up the first component of 'path' through 'fieldIndex' rather than by
+ * scanning the object it indexes.
+ */
+BSONElement extractElementAtPathOrArrayAlongPath(BSONObjFieldIndex* fieldIndex, const char*& path);
+
 /**
  * Expands arrays along the specified path and adds all elements to the 'elements' set.
  *
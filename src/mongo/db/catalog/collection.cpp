@@ -38,7 +38,8 @@
 namespace mongo {
 
 std::string CompactOptions::toString() const {
-    return str::stream() << " validateDocuments: " << validateDocuments;
+    return str::stream() << " validateDocuments: " << validateDocuments << " online: " << online
+                         << " maxBytesPerSecond: " << maxBytesPerSecond;
 }
 
 //
@@ -42,6 +42,7 @@
 #include "mongo/db/catalog/collection_info_cache.h"
 #include "mongo/db/catalog/collection_options.h"
 #include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/field_ref_set.h"
 #include "mongo/db/logical_session_id.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/collation/collator_interface.h"
@@ -93,6 +94,13 @@ struct CollectionUpdateArgs {
     // True if this update comes from a chunk migration.
     bool fromMigrate = false;
 
+    // If set, every path changed by the update. Indexes which do not depend on any of them are
+    // not updated.
+    const FieldRefSetWithStorage* modifiedPaths = nullptr;
+
+    // If not null, the slot reserved for the update's oplog entry.
+    OplogSlot oplogSlot;
+
     StoreDocOption storeDocOption = StoreDocOption::None;
 };
 
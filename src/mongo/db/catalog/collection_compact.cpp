@@ -31,17 +31,31 @@
 
 #include "mongo/db/catalog/collection_compact.h"
 
+#include <deque>
+
 #include "mongo/db/catalog/document_validation.h"
 #include "mongo/db/catalog/index_key_validate.h"
 #include "mongo/db/catalog/multi_index_block.h"
+#include "mongo/db/client.h"
+#include "mongo/db/curop.h"
+#include "mongo/db/db_raii.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
+#include "mongo/util/progress_meter.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
+namespace {
+
+// How long online compaction works on a table before releasing its locks.
+const Seconds kOnlineCompactChunkTime{1};
+
+}  // namespace
+
 StatusWith<CompactStats> compactCollection(OperationContext* opCtx,
                                            Collection* collection,
                                            const CompactOptions* compactOptions) {
@@ -151,4 +165,98 @@ StatusWith<CompactStats> compactCollection(OperationContext* opCtx,
     return StatusWith<CompactStats>(stats);
 }
 
+StatusWith<CompactStats> compactCollectionOnline(OperationContext* opCtx,
+                                                 const NamespaceString& nss,
+                                                 const CompactOptions* compactOptions) {
+    invariant(compactOptions->online);
+
+    // The tables left to compact: the record store, named by boost::none, then each index.
+    std::deque<boost::optional<std::string>> remaining;
+    {
+        AutoGetCollection autoColl(opCtx, nss, MODE_IX);
+        Collection* collection = autoColl.getCollection();
+        if (!collection) {
+            return {ErrorCodes::NamespaceNotFound, "collection does not exist"};
+        }
+
+        auto recordStore = collection->getRecordStore();
+        if (!recordStore->compactSupported() || !recordStore->compactsOnline()) {
+            return {ErrorCodes::CommandNotSupported,
+                    str::stream() << "cannot compact collection online with record store: "
+                                  << recordStore->name()};
+        }
+
+        remaining.push_back(boost::none);
+        std::unique_ptr<IndexCatalog::IndexIterator> ii(
+            collection->getIndexCatalog()->getIndexIterator(opCtx, false));
+        while (ii->more()) {
+            remaining.push_back(ii->next()->descriptor()->indexName());
+        }
+    }
+
+    ProgressMeterHolder progress;
+    {
+        stdx::unique_lock<Client> lk(*opCtx->getClient());
+        progress.set(CurOp::get(opCtx)->setProgress_inlock("Online compact: tables compacted",
+                                                           remaining.size()));
+    }
+
+    CompactStats stats;
+    Timer timer;
+    while (!remaining.empty()) {
+        opCtx->checkForInterrupt();
+
+        {
+            AutoGetCollection autoColl(opCtx, nss, MODE_IX);
+            Collection* collection = autoColl.getCollection();
+            if (!collection) {
+                return {ErrorCodes::NamespaceNotFound, "collection dropped during compact"};
+            }
+
+            long long sizeBefore = 0;
+            long long sizeAfter = 0;
+            StatusWith<bool> finished = true;
+            if (!remaining.front()) {
+                auto recordStore = collection->getRecordStore();
+                sizeBefore = recordStore->storageSize(opCtx);
+                finished = recordStore->compactChunk(opCtx, kOnlineCompactChunkTime);
+                sizeAfter = recordStore->storageSize(opCtx);
+            } else if (auto descriptor = collection->getIndexCatalog()->findIndexByName(
+                           opCtx, *remaining.front())) {
+                // An index dropped since compaction started is skipped.
+                auto index = collection->getIndexCatalog()
+                                 ->getEntry(descriptor)
+                                 ->accessMethod()
+                                 ->getSortedDataInterface();
+                sizeBefore = index->getSpaceUsedBytes(opCtx);
+                finished = index->compactChunk(opCtx, kOnlineCompactChunkTime);
+                sizeAfter = index->getSpaceUsedBytes(opCtx);
+            }
+
+            if (!finished.isOK()) {
+                return finished.getStatus();
+            }
+            stats.bytesReclaimed += std::max(sizeBefore - sizeAfter, 0LL);
+            if (finished.getValue()) {
+                remaining.pop_front();
+                progress.hit();
+            }
+        }
+
+        // Compaction moves blocks from the end of a file into free space nearer its start and
+        // then truncates the file, so the space it reclaims is close to the data it rewrites.
+        // Pace the I/O by waiting until the space reclaimed so far is within the budget.
+        if (compactOptions->maxBytesPerSecond > 0) {
+            const Milliseconds allowed(stats.bytesReclaimed * 1000 /
+                                       compactOptions->maxBytesPerSecond);
+            const Milliseconds elapsed(timer.millis());
+            if (allowed > elapsed) {
+                opCtx->sleepFor(allowed - elapsed);
+            }
+        }
+    }
+
+    return stats;
+}
+
 }  // namespace mongo
@@ -43,4 +43,18 @@ StatusWith<CompactStats> compactCollection(OperationContext* opCtx,
                                            Collection* collection,
                                            const CompactOptions* options);
 
+/**
+ * Compacts the collection 'nss' and its indexes while allowing concurrent reads and writes. The
+ * record store and then each index are compacted in chunks of about a second, each under a MODE_IX
+ * collection lock that is released between chunks, so that the operation can be interrupted and
+ * exclusive lock requests are not held up. Between chunks, waits as needed to keep the rate at
+ * which space is reclaimed under 'options->maxBytesPerSecond'. Reports progress through CurOp.
+ *
+ * Must be called without the collection locked. Fails with CommandNotSupported if the record
+ * store cannot compact online.
+ */
+StatusWith<CompactStats> compactCollectionOnline(OperationContext* opCtx,
+                                                 const NamespaceString& nss,
+                                                 const CompactOptions* options);
+
 }  // namespace mongo
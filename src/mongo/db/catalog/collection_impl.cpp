@@ -51,6 +51,8 @@
 #include "mongo/db/catalog/index_key_validate.h"
 #include "mongo/db/catalog/namespace_uuid_cache.h"
 #include "mongo/db/catalog/uuid_catalog.h"
+#include "mongo/db/catalog/validate_gen.h"
+#include "mongo/db/client.h"
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/d_concurrency.h"
@@ -74,6 +76,7 @@
 
 #include "mongo/db/auth/user_document_parser.h"  // XXX-ANDY
 #include "mongo/rpc/object_check.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 
@@ -683,8 +686,13 @@ RecordId CollectionImpl::updateDocument(OperationContext* opCtx,
     if (indexesAffected) {
         int64_t keysInserted, keysDeleted;
 
-        uassertStatusOK(_indexCatalog->updateRecord(
-            opCtx, args->preImageDoc.get(), newDoc, oldLocation, &keysInserted, &keysDeleted));
+        uassertStatusOK(_indexCatalog->updateRecord(opCtx,
+                                                    args->preImageDoc.get(),
+                                                    newDoc,
+                                                    oldLocation,
+                                                    args->modifiedPaths,
+                                                    &keysInserted,
+                                                    &keysDeleted));
 
         if (opDebug) {
             opDebug->additiveMetrics.incrementKeysInserted(keysInserted);
@@ -1039,6 +1047,7 @@ void _genericRecordStoreValidate(OperationContext* opCtx,
         ++nrecords;
         auto dataSize = record->data.size();
         dataSizeTotal += dataSize;
+        indexValidator->throttle(opCtx, dataSize);
         size_t validatedSize;
         Status status = indexValidator->validate(record->id, record->data, &validatedSize);
 
@@ -1088,6 +1097,77 @@ void _validateRecordStore(OperationContext* opCtx,
     }
 }
 
+// The state of the validation of one index.
+struct IndexToValidate {
+    const IndexDescriptor* descriptor;
+    const IndexAccessMethod* iam;
+    ValidateResults* results;
+    int64_t numTraversedKeys = 0;
+    int64_t numValidatedKeys = 0;
+};
+
+void _validateIndex(OperationContext* opCtx,
+                    RecordStoreValidateAdaptor* indexValidator,
+                    ValidateCmdLevel level,
+                    IndexToValidate* index) {
+    log(LogComponent::kIndex) << "validating index " << index->descriptor->indexNamespace()
+                              << endl;
+    if (level == kValidateFull) {
+        index->iam->validate(opCtx, &index->numValidatedKeys, index->results);
+    }
+
+    if (index->results->valid) {
+        indexValidator->traverseIndex(
+            opCtx, index->iam, index->descriptor, index->results, &index->numTraversedKeys);
+    }
+}
+
+/**
+ * Validates 'indexes' on 'numThreads' threads, including this one. Each other thread reads the
+ * indexes it claims through an operation context of its own. The collection lock held by 'opCtx'
+ * keeps the collection from changing, so every thread's snapshot sees the same data.
+ */
+void _validateIndexesOnThreads(OperationContext* opCtx,
+                               RecordStoreValidateAdaptor* indexValidator,
+                               ValidateCmdLevel level,
+                               size_t numThreads,
+                               std::vector<IndexToValidate>* indexes) {
+    AtomicWord<size_t> nextIndex{0};
+    std::vector<Status> statuses(numThreads, Status::OK());
+    auto validateClaimedIndexes = [&](OperationContext* threadOpCtx, size_t threadNumber) {
+        try {
+            for (size_t i = nextIndex.fetchAndAdd(1); i < indexes->size();
+                 i = nextIndex.fetchAndAdd(1)) {
+                // Only the kill status of another thread's operation may be read concurrently.
+                const auto killStatus = opCtx->getKillStatus();
+                uassert(killStatus, "validate interrupted", killStatus == ErrorCodes::OK);
+                _validateIndex(threadOpCtx, indexValidator, level, &(*indexes)[i]);
+            }
+        } catch (const DBException& ex) {
+            statuses[threadNumber] = ex.toStatus();
+            nextIndex.store(indexes->size());
+        }
+    };
+
+    std::vector<stdx::thread> threads;
+    for (size_t threadNumber = 1; threadNumber < numThreads; ++threadNumber) {
+        threads.emplace_back([&, threadNumber] {
+            ThreadClient tc("validateIndexes", opCtx->getServiceContext());
+            auto threadOpCtx = tc->makeOperationContext();
+            validateClaimedIndexes(threadOpCtx.get(), threadNumber);
+        });
+    }
+    validateClaimedIndexes(opCtx, 0);
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    opCtx->checkForInterrupt();
+    for (auto&& status : statuses) {
+        uassertStatusOK(status);
+    }
+}
+
 void _validateIndexes(OperationContext* opCtx,
                       IndexCatalog* indexCatalog,
                       BSONObjBuilder* keysPerIndex,
@@ -1098,43 +1178,47 @@ void _validateIndexes(OperationContext* opCtx,
 
     std::unique_ptr<IndexCatalog::IndexIterator> it = indexCatalog->getIndexIterator(opCtx, false);
 
-    // Validate Indexes.
+    std::vector<IndexToValidate> indexes;
     while (it->more()) {
-        opCtx->checkForInterrupt();
         const IndexCatalogEntry* entry = it->next();
         const IndexDescriptor* descriptor = entry->descriptor();
-        const IndexAccessMethod* iam = entry->accessMethod();
+        indexes.push_back({descriptor,
+                           entry->accessMethod(),
+                           &(*indexNsResultsMap)[descriptor->indexNamespace()]});
+    }
 
-        log(LogComponent::kIndex) << "validating index " << descriptor->indexNamespace() << endl;
-        ValidateResults& curIndexResults = (*indexNsResultsMap)[descriptor->indexNamespace()];
-        bool checkCounts = false;
-        int64_t numTraversedKeys;
-        int64_t numValidatedKeys;
+    // Validate Indexes.
+    const size_t numThreads =
+        std::min(static_cast<size_t>(gValidateIndexTraversalThreads.load()), indexes.size());
+    if (numThreads > 1) {
+        _validateIndexesOnThreads(opCtx, indexValidator, level, numThreads, &indexes);
+    } else {
+        for (auto&& index : indexes) {
+            opCtx->checkForInterrupt();
+            _validateIndex(opCtx, indexValidator, level, &index);
+        }
+    }
 
-        if (level == kValidateFull) {
-            iam->validate(opCtx, &numValidatedKeys, &curIndexResults);
-            checkCounts = true;
+    for (auto&& index : indexes) {
+        ValidateResults& curIndexResults = *index.results;
+        if (!curIndexResults.valid) {
+            results->valid = false;
+            continue;
         }
 
-        if (curIndexResults.valid) {
-            indexValidator->traverseIndex(iam, descriptor, &curIndexResults, &numTraversedKeys);
-
-            if (checkCounts && (numValidatedKeys != numTraversedKeys)) {
-                curIndexResults.valid = false;
-                string msg = str::stream()
-                    << "number of traversed index entries (" << numTraversedKeys
-                    << ") does not match the number of expected index entries (" << numValidatedKeys
-                    << ")";
-                results->errors.push_back(msg);
-                results->valid = false;
-            }
+        if (level == kValidateFull && index.numValidatedKeys != index.numTraversedKeys) {
+            curIndexResults.valid = false;
+            string msg = str::stream()
+                << "number of traversed index entries (" << index.numTraversedKeys
+                << ") does not match the number of expected index entries ("
+                << index.numValidatedKeys << ")";
+            results->errors.push_back(msg);
+            results->valid = false;
+        }
 
-            if (curIndexResults.valid) {
-                keysPerIndex->appendNumber(descriptor->indexNamespace(),
-                                           static_cast<long long>(numTraversedKeys));
-            } else {
-                results->valid = false;
-            }
+        if (curIndexResults.valid) {
+            keysPerIndex->appendNumber(index.descriptor->indexNamespace(),
+                                       static_cast<long long>(index.numTraversedKeys));
         } else {
             results->valid = false;
         }
@@ -1283,7 +1367,7 @@ Status CollectionImpl::validate(OperationContext* opCtx,
         BSONObjBuilder keysPerIndex;  // not using subObjStart to be exception safe
         IndexConsistency indexConsistency(
             opCtx, this, ns(), _recordStore, std::move(collLk), background);
-        RecordStoreValidateAdaptor indexValidator = RecordStoreValidateAdaptor(
+        RecordStoreValidateAdaptor indexValidator(
             opCtx, &indexConsistency, level, _indexCatalog.get(), &indexNsResultsMap);
 
         // Validate the record store
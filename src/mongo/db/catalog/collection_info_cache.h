@@ -30,6 +30,7 @@
 #pragma once
 
 #include "mongo/db/collection_index_usage_tracker.h"
+#include "mongo/db/query/collection_statistics.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/update_index_data.h"
@@ -67,6 +68,13 @@ public:
     */
     virtual const UpdateIndexData& getIndexKeys(OperationContext* const opCtx) const = 0;
 
+    /**
+     * Returns the paths whose modification may affect the keys of the index named 'indexName', or
+     * nullptr if the cache does not know about that index.
+     */
+    virtual const UpdateIndexData* getIndexKeys(OperationContext* const opCtx,
+                                                StringData indexName) const = 0;
+
     /**
      * Returns cached index usage statistics for this collection.  The map returned will contain
      * entry for each index in the collection along with both a usage counter and a timestamp
@@ -76,6 +84,17 @@ public:
      */
     virtual CollectionIndexUsageMap getIndexUsageStats() const = 0;
 
+    /**
+     * Returns the statistics last gathered for this collection by the 'analyze' command, or
+     * nullptr if there are none.
+     */
+    virtual std::shared_ptr<const CollectionStatistics> getStatistics() const = 0;
+
+    /**
+     * Replaces the statistics used by the query planner for this collection.
+     */
+    virtual void setStatistics(std::shared_ptr<const CollectionStatistics> statistics) = 0;
+
     /**
      * Register a newly-created index with the cache.  Must be called whenever an index is
      * built on the associated collection.
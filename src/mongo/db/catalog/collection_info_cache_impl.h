@@ -35,6 +35,8 @@
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/update_index_data.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -67,6 +69,9 @@ public:
     */
     const UpdateIndexData& getIndexKeys(OperationContext* opCtx) const;
 
+    const UpdateIndexData* getIndexKeys(OperationContext* opCtx,
+                                        StringData indexName) const override;
+
     /**
      * Returns cached index usage statistics for this collection.  The map returned will contain
      * entry for each index in the collection along with both a usage counter and a timestamp
@@ -76,6 +81,10 @@ public:
      */
     CollectionIndexUsageMap getIndexUsageStats() const;
 
+    std::shared_ptr<const CollectionStatistics> getStatistics() const override;
+
+    void setStatistics(std::shared_ptr<const CollectionStatistics> statistics) override;
+
     /**
      * Builds internal cache state based on the current state of the Collection's IndexCatalog
      */
@@ -127,6 +136,7 @@ private:
     // ---  index keys cache
     bool _keysComputed;
     UpdateIndexData _indexedPaths;
+    StringMap<UpdateIndexData> _indexedPathsByIndex;
 
     // A cache for query plans.
     std::unique_ptr<PlanCache> _planCache;
@@ -138,6 +148,11 @@ private:
     // Tracks index usage statistics for this collection.
     CollectionIndexUsageTracker _indexUsageTracker;
 
+    // Statistics gathered by the 'analyze' command. Queries read them under an intent lock, so
+    // they are swapped under '_statisticsMutex' rather than the collection lock.
+    mutable stdx::mutex _statisticsMutex;
+    std::shared_ptr<const CollectionStatistics> _statistics;
+
     bool _hasTTLIndex = false;
 };
 
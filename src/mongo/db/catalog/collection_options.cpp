@@ -176,6 +176,8 @@ Status CollectionOptions::parse(const BSONObj& options, ParseKind kind) {
             continue;
         } else if (fieldName == "temp") {
             temp = e.trueValue();
+        } else if (fieldName == "clustered") {
+            clustered = e.trueValue();
         } else if (fieldName == "storageEngine") {
             Status status = checkStorageEngineOptions(e);
             if (!status.isOK()) {
@@ -266,6 +268,16 @@ Status CollectionOptions::parse(const BSONObj& options, ParseKind kind) {
         return Status(ErrorCodes::BadValue, "'pipeline' cannot be specified without 'viewOn'");
     }
 
+    if (clustered) {
+        if (capped) {
+            return Status(ErrorCodes::InvalidOptions, "a clustered collection cannot be capped");
+        }
+        if (autoIndexId == YES || !idIndex.isEmpty()) {
+            return Status(ErrorCodes::InvalidOptions,
+                          "a clustered collection cannot have an _id index");
+        }
+    }
+
     return Status::OK();
 }
 
@@ -299,6 +311,9 @@ void CollectionOptions::appendBSON(BSONObjBuilder* builder) const {
     if (temp)
         builder->appendBool("temp", true);
 
+    if (clustered)
+        builder->appendBool("clustered", true);
+
     if (!storageEngine.isEmpty()) {
         builder->append("storageEngine", storageEngine);
     }
@@ -372,6 +387,10 @@ bool CollectionOptions::matchesStorageOptions(const CollectionOptions& other,
         return false;
     }
 
+    if (clustered != other.clustered) {
+        return false;
+    }
+
     if (storageEngine.woCompare(other.storageEngine) != 0) {
         return false;
     }
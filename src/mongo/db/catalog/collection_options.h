@@ -119,6 +119,10 @@ struct CollectionOptions {
 
     bool temp = false;
 
+    // Store documents keyed by their _id in the record store instead of maintaining an _id index.
+    // Requires storage engine support; see StorageEngine::supportsClusteredCollections().
+    bool clustered = false;
+
     // Storage engine collection options. Always owned or empty.
     BSONObj storageEngine;
 
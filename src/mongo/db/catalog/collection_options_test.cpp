@@ -252,6 +252,24 @@ TEST(CollectionOptions, PipelineFieldRequiresViewOn) {
     ASSERT_NOT_OK(options.parse(fromjson("{pipeline: [{$match: {}}]}")));
 }
 
+TEST(CollectionOptions, ClusteredParsesCorrectly) {
+    CollectionOptions options;
+    ASSERT_OK(options.parse(fromjson("{clustered: true}")));
+    ASSERT_TRUE(options.clustered);
+    ASSERT_BSONOBJ_EQ(options.toBSON(), fromjson("{clustered: true}"));
+}
+
+TEST(CollectionOptions, ClusteredIsIncompatibleWithCappedAndIdIndex) {
+    CollectionOptions options;
+    ASSERT_EQ(options.parse(fromjson("{clustered: true, capped: true, size: 1024}")).code(),
+              ErrorCodes::InvalidOptions);
+    ASSERT_EQ(options.parse(fromjson("{clustered: true, autoIndexId: true}")).code(),
+              ErrorCodes::InvalidOptions);
+    ASSERT_EQ(options.parse(fromjson("{clustered: true, idIndex: {key: {_id: 1}, name: 'a'}}"))
+                  .code(),
+              ErrorCodes::InvalidOptions);
+}
+
 TEST(CollectionOptions, UnknownTopLevelOptionFailsToParse) {
     CollectionOptions options;
     auto status = options.parse(fromjson("{invalidOption: 1}"));
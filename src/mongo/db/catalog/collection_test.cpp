@@ -33,7 +33,9 @@
 #include "mongo/db/catalog/capped_utils.h"
 #include "mongo/db/catalog/catalog_test_fixture.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/repl/storage_interface_impl.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/thread.h"
@@ -266,6 +268,50 @@ TEST_F(CollectionTest, Validate) {
     checkValidate(coll, true, inserts.size(), 0, 0);
 }
 
+// Verify that inserting a batch of documents indexes the keys of every document in the batch.
+TEST_F(CollectionTest, InsertBatchIndexesEveryDocument) {
+    NamespaceString nss("test.t");
+    makeUncapped(nss);
+
+    auto opCtx = operationContext();
+    AutoGetCollection agc(opCtx, nss, MODE_X);
+    Collection* coll = agc.getCollection();
+
+    {
+        WriteUnitOfWork wuow(opCtx);
+        auto indexSpec = BSON("v" << int(IndexDescriptor::kLatestIndexVersion) << "key"
+                                  << BSON("a" << 1)
+                                  << "name"
+                                  << "a_1"
+                                  << "ns"
+                                  << nss.ns());
+        ASSERT_OK(coll->getIndexCatalog()->createIndexOnEmptyCollection(opCtx, indexSpec));
+        wuow.commit();
+    }
+
+    // Keys of later documents sort before keys of earlier ones, and one document is multikey.
+    std::vector<InsertStatement> inserts;
+    for (int i = 0; i < 10; i++) {
+        auto doc = i == 5 ? BSON("_id" << i << "a" << BSON_ARRAY(-1 << 100))
+                          : BSON("_id" << i << "a" << 10 - i);
+        inserts.push_back(InsertStatement(doc));
+    }
+
+    OpDebug opDebug;
+    {
+        WriteUnitOfWork wuow(opCtx);
+        ASSERT_OK(coll->insertDocuments(opCtx, inserts.begin(), inserts.end(), &opDebug, false));
+        wuow.commit();
+    }
+
+    // One _id key for each document, plus an 'a' key for each element of 'a'.
+    ASSERT_EQ(21, *opDebug.additiveMetrics.keysInserted);
+    auto descriptor = coll->getIndexCatalog()->findIndexByName(opCtx, "a_1");
+    ASSERT(descriptor);
+    ASSERT(coll->getIndexCatalog()->isMultikey(opCtx, descriptor));
+    checkValidate(coll, true, inserts.size(), 0, 0);
+}
+
 // Verify calling validate() on a collection with an invalid document.
 TEST_F(CollectionTest, ValidateError) {
     NamespaceString nss("test.t");
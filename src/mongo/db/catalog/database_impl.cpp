@@ -612,6 +612,11 @@ void DatabaseImpl::_checkCanCreateCollection(OperationContext* opCtx,
 
     uassert(17316, "cannot create a blank collection", nss.coll() > 0);
     uassert(28838, "cannot create a non-capped oplog collection", options.capped || !nss.isOplog());
+    uassert(ErrorCodes::InvalidOptions,
+            str::stream() << "Cannot create collection " << nss
+                          << " - the storage engine does not support clustered collections.",
+            !options.clustered ||
+                opCtx->getServiceContext()->getStorageEngine()->supportsClusteredCollections());
     uassert(ErrorCodes::DatabaseDropPending,
             str::stream() << "Cannot create collection " << nss
                           << " - database is in the process of being dropped.",
@@ -710,7 +715,8 @@ Collection* DatabaseImpl::createCollection(OperationContext* opCtx,
 
     BSONObj fullIdIndexSpec;
 
-    if (createIdIndex) {
+    // A clustered collection is keyed by _id in the record store and has no _id index.
+    if (createIdIndex && !optionsWithUUID.clustered) {
         if (collection->requiresIdIndex()) {
             if (optionsWithUUID.autoIndexId == CollectionOptions::YES ||
                 optionsWithUUID.autoIndexId == CollectionOptions::DEFAULT) {
@@ -830,7 +836,7 @@ void DatabaseImpl::checkForIdIndexesAndDropPendingCollections(OperationContext*
         if (!coll)
             continue;
 
-        if (coll->getIndexCatalog()->findIdIndex(opCtx))
+        if (coll->getIndexCatalog()->findIdIndex(opCtx) || coll->getRecordStore()->isClustered())
             continue;
 
         log() << "WARNING: the collection '" << nss << "' lacks a unique index on _id."
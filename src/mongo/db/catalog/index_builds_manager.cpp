@@ -211,6 +211,10 @@ Status IndexBuildsManager::drainBackgroundWrites(OperationContext* opCtx,
     return builder->drainBackgroundWrites(opCtx, readSource);
 }
 
+long long IndexBuildsManager::getNumPendingSideWrites(const UUID& buildUUID) {
+    return _getBuilder(buildUUID)->getNumPendingSideWrites();
+}
+
 Status IndexBuildsManager::finishBuildingPhase(const UUID& buildUUID) {
     auto multiIndexBlockPtr = _getBuilder(buildUUID);
     // TODO: verify that the index builder is in the expected state.
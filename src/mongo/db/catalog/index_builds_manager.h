@@ -122,6 +122,12 @@ public:
                                  const UUID& buildUUID,
                                  RecoveryUnit::ReadSource readSource);
 
+    /**
+     * Returns an estimate of the number of side writes that the next call to
+     * drainBackgroundWrites() would apply.
+     */
+    long long getNumPendingSideWrites(const UUID& buildUUID);
+
     /**
      * Persists information in the index catalog entry to reflect the successful completion of the
      * scanning/insertion phase.
@@ -44,6 +44,7 @@
 namespace mongo {
 class Client;
 class Collection;
+class FieldRefSetWithStorage;
 
 class IndexDescriptor;
 struct InsertDeleteOptions;
@@ -454,12 +455,16 @@ public:
      * Both 'keysInsertedOut' and 'keysDeletedOut' are required and will be set to the number of
      * index keys inserted and deleted by this operation, respectively.
      *
+     * If 'modifiedPaths' is not null, it must hold every path the update changed, and ready
+     * indexes which cannot be affected by a change to those paths are left untouched.
+     *
      * This method may throw.
      */
     virtual Status updateRecord(OperationContext* const opCtx,
                                 const BSONObj& oldDoc,
                                 const BSONObj& newDoc,
                                 const RecordId& recordId,
+                                const FieldRefSetWithStorage* modifiedPaths,
                                 int64_t* const keysInsertedOut,
                                 int64_t* const keysDeletedOut) = 0;
 
@@ -35,10 +35,12 @@
 
 #include <algorithm>
 
+#include "mongo/base/counter.h"
 #include "mongo/base/init.h"
 #include "mongo/db/catalog/collection_catalog_entry.h"
 #include "mongo/db/catalog/collection_info_cache_impl.h"
 #include "mongo/db/catalog/head_manager.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/index/index_access_method.h"
@@ -58,6 +60,39 @@ namespace mongo {
 
 using std::string;
 
+namespace {
+
+// Counts the catalog updates made when an index gains new multikey paths. 'catalogWrites' are the
+// updates which changed the index metadata, 'catalogWritesCoalesced' the ones skipped because the
+// same unit of work had already written the paths, and 'catalogWritesDeferred' the ones handed to
+// the MultikeyPathTracker to be applied at the end of a secondary's batch.
+Counter64 multikeyCatalogWrites;
+Counter64 multikeyCatalogWritesCoalesced;
+Counter64 multikeyCatalogWritesDeferred;
+
+ServerStatusMetricField<Counter64> displayMultikeyCatalogWrites("multikey.catalogWrites",
+                                                                &multikeyCatalogWrites);
+ServerStatusMetricField<Counter64> displayMultikeyCatalogWritesCoalesced(
+    "multikey.catalogWritesCoalesced", &multikeyCatalogWritesCoalesced);
+ServerStatusMetricField<Counter64> displayMultikeyCatalogWritesDeferred(
+    "multikey.catalogWritesDeferred", &multikeyCatalogWritesDeferred);
+
+/**
+ * Returns true if every path component in 'paths' is also present in 'superset'.
+ */
+bool multikeyPathsInclude(const MultikeyPaths& superset, const MultikeyPaths& paths) {
+    invariant(superset.size() == paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (!std::includes(
+                superset[i].begin(), superset[i].end(), paths[i].begin(), paths[i].end())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
 class HeadManagerImpl : public HeadManager {
 public:
     HeadManagerImpl(IndexCatalogEntry* ice) : _catalogEntry(ice) {}
@@ -303,9 +338,24 @@ void IndexCatalogEntryImpl::setMultikey(OperationContext* opCtx,
         info.indexName = _descriptor->indexName();
         info.multikeyPaths = paths;
         MultikeyPathTracker::get(opCtx).addMultikeyPathInfo(info);
+        multikeyCatalogWritesDeferred.increment();
         return;
     }
 
+    // A batched insert can make the index multikey on many of its documents before the unit of
+    // work commits and '_indexMultikeyPaths' is updated. Once these paths have been written in
+    // this unit of work, the write commits or rolls back along with every later document, so
+    // there is no need to read and rewrite the collection's metadata for each of them.
+    RecoveryUnit* const ru = opCtx->recoveryUnit();
+    {
+        stdx::lock_guard<stdx::mutex> lk(_indexMultikeyPathsMutex);
+        auto it = _uncommittedMultikeyPaths.find(ru);
+        if (it != _uncommittedMultikeyPaths.end() && multikeyPathsInclude(it->second, paths)) {
+            multikeyCatalogWritesCoalesced.increment();
+            return;
+        }
+    }
+
     // It's possible that the index type (e.g. ascending/descending index) supports tracking
     // path-level multikey information, but this particular index doesn't.
     // CollectionCatalogEntry::setIndexIsMultikey() requires that we discard the path-level
@@ -313,6 +363,26 @@ void IndexCatalogEntryImpl::setMultikey(OperationContext* opCtx,
     // information on an index created before 3.4.
     const bool indexMetadataHasChanged =
         _collection->setIndexIsMultikey(opCtx, _descriptor->indexName(), paths);
+    if (indexMetadataHasChanged) {
+        multikeyCatalogWrites.increment();
+    }
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_indexMultikeyPathsMutex);
+        auto inserted = _uncommittedMultikeyPaths.emplace(ru, paths);
+        if (inserted.second) {
+            auto forgetUncommittedPaths = [this, ru] {
+                stdx::lock_guard<stdx::mutex> lk(_indexMultikeyPathsMutex);
+                _uncommittedMultikeyPaths.erase(ru);
+            };
+            ru->onCommit([forgetUncommittedPaths](boost::optional<Timestamp>) {
+                forgetUncommittedPaths();
+            });
+            ru->onRollback(forgetUncommittedPaths);
+        } else {
+            MultikeyPathTracker::mergeMultikeyPaths(&inserted.first->second, paths);
+        }
+    }
 
     // When the recovery unit commits, update the multikey paths if needed and clear the plan cache
     // if the index metadata has changed.
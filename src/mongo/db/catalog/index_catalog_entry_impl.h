@@ -42,6 +42,7 @@
 #include "mongo/db/storage/kv/kv_prefix.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
 
@@ -53,6 +54,7 @@ class IndexAccessMethod;
 class IndexDescriptor;
 class MatchExpression;
 class OperationContext;
+class RecoveryUnit;
 
 class IndexCatalogEntryImpl : public IndexCatalogEntry {
     IndexCatalogEntryImpl(const IndexCatalogEntryImpl&) = delete;
@@ -254,6 +256,11 @@ private:
     // causes the index to be multikey.
     MultikeyPaths _indexMultikeyPaths;
 
+    // Multikey paths which have been written to the catalog by a still open unit of work, keyed by
+    // its recovery unit. Further writes in that unit of work which add no new paths skip reading
+    // and rewriting the collection's metadata. Guarded by '_indexMultikeyPathsMutex'.
+    stdx::unordered_map<RecoveryUnit*, MultikeyPaths> _uncommittedMultikeyPaths;
+
     // KVPrefix used to differentiate between index entries in different logical indexes sharing the
     // same underlying sorted data interface.
     const KVPrefix _prefix;
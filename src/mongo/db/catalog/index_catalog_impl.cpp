@@ -48,6 +48,7 @@
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/field_ref.h"
+#include "mongo/db/field_ref_set.h"
 #include "mongo/db/index/2d_access_method.h"
 #include "mongo/db/index/btree_access_method.h"
 #include "mongo/db/index/fts_access_method.h"
@@ -74,6 +75,7 @@
 #include "mongo/db/storage/kv/kv_catalog.h"
 #include "mongo/db/storage/kv/kv_storage_engine.h"
 #include "mongo/db/storage/storage_engine_init.h"
+#include "mongo/db/update_index_data.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/represent_as.h"
@@ -1247,6 +1249,37 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
     InsertDeleteOptions options;
     prepareInsertDeleteOptions(opCtx, index->descriptor(), &options);
 
+    // When every record is written at the same timestamp, the keys of the whole batch can be
+    // inserted together in index key order.
+    const bool canInsertBatch = bsonRecords.size() > 1 && !index->isHybridBuilding() &&
+        std::all_of(bsonRecords.begin(), bsonRecords.end(), [&](const BsonRecord& bsonRecord) {
+            return bsonRecord.ts == bsonRecords.front().ts;
+        });
+    if (canInsertBatch) {
+        if (!bsonRecords.front().ts.isNull()) {
+            Status status = opCtx->recoveryUnit()->setTimestamp(bsonRecords.front().ts);
+            if (!status.isOK())
+                return status;
+        }
+
+        std::vector<const BSONObj*> objs;
+        std::vector<RecordId> locs;
+        objs.reserve(bsonRecords.size());
+        locs.reserve(bsonRecords.size());
+        for (const auto& bsonRecord : bsonRecords) {
+            invariant(bsonRecord.id != RecordId());
+            objs.push_back(bsonRecord.docPtr);
+            locs.push_back(bsonRecord.id);
+        }
+
+        InsertResult result;
+        Status status = index->accessMethod()->insertBatch(opCtx, objs, locs, options, &result);
+        if (keysInsertedOut) {
+            *keysInsertedOut += result.numInserted;
+        }
+        return status;
+    }
+
     for (auto bsonRecord : bsonRecords) {
         invariant(bsonRecord.id != RecordId());
 
@@ -1374,10 +1407,30 @@ Status IndexCatalogImpl::indexRecords(OperationContext* opCtx,
     return Status::OK();
 }
 
+namespace {
+/**
+ * Returns whether a change to any of 'modifiedPaths' may change the keys of an index which depends
+ * on 'indexedPaths'. An unknown index, for which 'indexedPaths' is null, may always be affected.
+ */
+bool mightAffectIndex(const FieldRefSetWithStorage& modifiedPaths,
+                      const UpdateIndexData* indexedPaths) {
+    if (!indexedPaths) {
+        return true;
+    }
+    for (const FieldRef* path : modifiedPaths) {
+        if (indexedPaths->mightBeIndexed(*path)) {
+            return true;
+        }
+    }
+    return false;
+}
+}  // namespace
+
 Status IndexCatalogImpl::updateRecord(OperationContext* const opCtx,
                                       const BSONObj& oldDoc,
                                       const BSONObj& newDoc,
                                       const RecordId& recordId,
+                                      const FieldRefSetWithStorage* modifiedPaths,
                                       int64_t* const keysInsertedOut,
                                       int64_t* const keysDeletedOut) {
     *keysInsertedOut = 0;
@@ -1392,6 +1445,15 @@ Status IndexCatalogImpl::updateRecord(OperationContext* const opCtx,
         IndexDescriptor* descriptor = entry->descriptor();
         IndexAccessMethod* iam = entry->accessMethod();
 
+        // Generating and diffing the old and new keys of an index cannot find any difference if
+        // the update did not touch any path the index depends on.
+        if (modifiedPaths &&
+            !mightAffectIndex(*modifiedPaths,
+                              _collection->infoCache()->getIndexKeys(opCtx,
+                                                                     descriptor->indexName()))) {
+            continue;
+        }
+
         InsertDeleteOptions options;
         prepareInsertDeleteOptions(opCtx, descriptor, &options);
 
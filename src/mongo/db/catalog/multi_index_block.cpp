@@ -33,6 +33,7 @@
 
 #include "mongo/db/catalog/multi_index_block.h"
 
+#include <algorithm>
 #include <ostream>
 
 #include "mongo/base/error_codes.h"
@@ -51,6 +52,8 @@
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/storage/write_unit_of_work.h"
 #include "mongo/logger/redaction.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/log.h"
@@ -343,6 +346,11 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlock::init(OperationContext* opCtx,
     return indexInfoObjs;
 }
 
+// When a collection scan indexes documents in batches, the most documents, and bytes of documents,
+// in each batch.
+const size_t kIndexBuildBatchSize = 1000;
+const size_t kIndexBuildBatchSizeBytes = 16 * 1024 * 1024;
+
 void failPointHangDuringBuild(FailPoint* fp, StringData where, const BSONObj& doc) {
     MONGO_FAIL_POINT_BLOCK(*fp, data) {
         int i = doc.getIntField("i");
@@ -403,6 +411,35 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(OperationContext* opCtx,
         _method != IndexBuildMethod::kBackground && useReadOnceCursorsForIndexBuilds.load();
     opCtx->recoveryUnit()->setReadOnce(readOnce);
 
+    // Hybrid and foreground builds only add keys to the external sorters, so the documents can be
+    // indexed in batches whose keys are generated by several threads. Background builds write to
+    // the indexes directly, and the failpoints that hang on a particular document need each
+    // document indexed as soon as it is read.
+    const bool indexInBatches = _method != IndexBuildMethod::kBackground &&
+        bulkIndexKeyGenerationThreads.load() > 1 &&
+        std::all_of(_indexes.begin(),
+                    _indexes.end(),
+                    [](const IndexToBuild& index) { return bool(index.bulk); }) &&
+        !MONGO_FAIL_POINT(hangBeforeIndexBuildOf) && !MONGO_FAIL_POINT(hangAfterIndexBuildOf);
+    std::vector<BSONObj> batchDocs;
+    std::vector<BsonRecord> batchRecords;
+    size_t batchBytes = 0;
+    auto indexBatch = [&]() -> Status {
+        WriteUnitOfWork wunit(opCtx);
+        Status status = insertBatch(opCtx, batchRecords);
+        if (!status.isOK()) {
+            return status;
+        }
+        wunit.commit();
+
+        progress->hit(static_cast<int>(batchRecords.size()));
+        n += batchRecords.size();
+        batchDocs.clear();
+        batchRecords.clear();
+        batchBytes = 0;
+        return Status::OK();
+    };
+
     Snapshotted<BSONObj> objToIndex;
     RecordId loc;
     PlanExecutor::ExecState state;
@@ -430,6 +467,25 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(OperationContext* opCtx,
             // Done before insert so we can retry document if it WCEs.
             progress->setTotalWhileRunning(collection->numRecords(opCtx));
 
+            if (indexInBatches) {
+                // The documents must outlive the executor's buffers, and 'batchDocs' must not be
+                // reallocated once 'batchRecords' points into it.
+                if (batchDocs.empty()) {
+                    batchDocs.reserve(kIndexBuildBatchSize);
+                }
+                batchDocs.push_back(objToIndex.value().getOwned());
+                batchRecords.push_back(BsonRecord{loc, Timestamp(), &batchDocs.back()});
+                batchBytes += batchDocs.back().objsize();
+                if (batchDocs.size() == kIndexBuildBatchSize ||
+                    batchBytes >= kIndexBuildBatchSizeBytes) {
+                    Status status = indexBatch();
+                    if (!status.isOK()) {
+                        return status;
+                    }
+                }
+                continue;
+            }
+
             failPointHangDuringBuild(&hangBeforeIndexBuildOf, "before", objToIndex.value());
 
             WriteUnitOfWork wunit(opCtx);
@@ -480,6 +536,13 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(OperationContext* opCtx,
         return exec->getMemberObjectStatus(objToIndex.value());
     }
 
+    if (!batchRecords.empty()) {
+        Status status = indexBatch();
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
     if (MONGO_FAIL_POINT(leaveIndexBuildUnfinishedForShutdown)) {
         log() << "Index build interrupted due to 'leaveIndexBuildUnfinishedForShutdown' failpoint. "
                  "Mimicing shutdown error code.";
@@ -545,6 +608,114 @@ Status MultiIndexBlock::insert(OperationContext* opCtx, const BSONObj& doc, cons
     return Status::OK();
 }
 
+Status MultiIndexBlock::insertBatch(OperationContext* opCtx,
+                                    const std::vector<BsonRecord>& records) {
+    const bool allBulk = std::all_of(
+        _indexes.begin(), _indexes.end(), [](const IndexToBuild& index) { return bool(index.bulk); });
+    const size_t numThreads = std::min(
+        static_cast<size_t>(bulkIndexKeyGenerationThreads.load()), _indexes.size());
+    if (!allBulk || bulkIndexKeyGenerationThreads.load() <= 1) {
+        for (auto&& record : records) {
+            auto status = insert(opCtx, *record.docPtr, record.id);
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+        return Status::OK();
+    }
+
+    if (State::kAborted == _getState()) {
+        return {ErrorCodes::IndexBuildAborted,
+                str::stream() << "Index build aborted: " << _abortReason};
+    }
+
+    // Generating keys is the expensive part, so it is split by document across the threads,
+    // each generating the keys of its documents for every index.
+    struct GeneratedKeys {
+        bool skipped = false;
+        Status status = Status::OK();
+        BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        BSONObjSet multikeyMetadataKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        MultikeyPaths multikeyPaths;
+    };
+    std::vector<GeneratedKeys> generatedKeys(records.size() * _indexes.size());
+
+    const size_t kDocumentsPerClaim = 16;
+    AtomicWord<unsigned> nextDocument{0};
+    auto generateKeys = [&] {
+        for (size_t begin = nextDocument.fetchAndAdd(kDocumentsPerClaim); begin < records.size();
+             begin = nextDocument.fetchAndAdd(kDocumentsPerClaim)) {
+            const size_t end = std::min(begin + kDocumentsPerClaim, records.size());
+            for (size_t doc = begin; doc < end; ++doc) {
+                const BSONObj& obj = *records[doc].docPtr;
+                for (size_t i = 0; i < _indexes.size(); ++i) {
+                    auto& index = _indexes[i];
+                    auto& generated = generatedKeys[doc * _indexes.size() + i];
+                    if (index.filterExpression && !index.filterExpression->matchesBSON(obj)) {
+                        generated.skipped = true;
+                        continue;
+                    }
+                    try {
+                        index.real->getKeys(obj,
+                                            index.options.getKeysMode,
+                                            &generated.keys,
+                                            &generated.multikeyMetadataKeys,
+                                            &generated.multikeyPaths);
+                    } catch (...) {
+                        generated.status = exceptionToStatus();
+                    }
+                }
+            }
+        }
+    };
+
+    // Each index's bulk builder is only used by the thread that claimed the index.
+    std::vector<Status> statuses(_indexes.size(), Status::OK());
+    AtomicWord<unsigned> nextIndex{0};
+    auto fillIndexes = [&] {
+        for (size_t i = nextIndex.fetchAndAdd(1); i < _indexes.size();
+             i = nextIndex.fetchAndAdd(1)) {
+            auto& index = _indexes[i];
+            for (size_t doc = 0; doc < records.size(); ++doc) {
+                const auto& generated = generatedKeys[doc * _indexes.size() + i];
+                if (generated.skipped) {
+                    continue;
+                }
+                statuses[i] = generated.status;
+                if (!statuses[i].isOK()) {
+                    break;
+                }
+                index.bulk->insertKeys(generated.keys,
+                                       generated.multikeyMetadataKeys,
+                                       generated.multikeyPaths,
+                                       records[doc].id);
+            }
+        }
+    };
+
+    auto runOnThreads = [](size_t numThreads, const auto& work) {
+        std::vector<stdx::thread> threads;
+        for (size_t i = 1; i < numThreads; ++i) {
+            threads.emplace_back(work);
+        }
+        work();
+        for (auto&& thread : threads) {
+            thread.join();
+        }
+    };
+    runOnThreads(std::min(static_cast<size_t>(bulkIndexKeyGenerationThreads.load()),
+                          (records.size() + kDocumentsPerClaim - 1) / kDocumentsPerClaim),
+                 generateKeys);
+    runOnThreads(numThreads, fillIndexes);
+
+    for (auto&& status : statuses) {
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+    return Status::OK();
+}
+
 Status MultiIndexBlock::dumpInsertsFromBulk(OperationContext* opCtx) {
     return dumpInsertsFromBulk(opCtx, nullptr);
 }
@@ -631,6 +802,17 @@ Status MultiIndexBlock::drainBackgroundWrites(OperationContext* opCtx,
     return Status::OK();
 }
 
+long long MultiIndexBlock::getNumPendingSideWrites() const {
+    long long numPending = 0;
+    for (const auto& index : _indexes) {
+        auto interceptor = index.block->getEntry()->indexBuildInterceptor();
+        if (interceptor) {
+            numPending += interceptor->getNumPendingSideWrites();
+        }
+    }
+    return numPending;
+}
+
 Status MultiIndexBlock::checkConstraints(OperationContext* opCtx) {
     if (State::kAborted == _getState()) {
         return {ErrorCodes::IndexBuildAborted,
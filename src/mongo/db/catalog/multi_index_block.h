@@ -142,6 +142,9 @@ public:
      *
      * Will fail if violators of uniqueness constraints exist.
      *
+     * Unless building in the background, the scanned documents are added to the indexes in
+     * batches with insertBatch().
+     *
      * Can throw an exception if interrupted.
      *
      * Should not be called inside of a WriteUnitOfWork.
@@ -157,6 +160,19 @@ public:
      */
     Status insert(OperationContext* opCtx, const BSONObj& wholeDocument, const RecordId& loc);
 
+    /**
+     * Call this after init() for a batch of documents already inserted into the collection, in
+     * place of calling insert() for each of them.
+     *
+     * When every index uses a bulk builder, up to 'bulkIndexKeyGenerationThreads' threads first
+     * generate the keys of the documents for all indexes, each thread taking its own documents.
+     * The indexes' sorters are then filled concurrently, each index by one thread. Otherwise this
+     * behaves like calling insert() for each document.
+     *
+     * Should be called inside of a WriteUnitOfWork.
+     */
+    Status insertBatch(OperationContext* opCtx, const std::vector<BsonRecord>& records);
+
     /**
      * Call this after the last insert(). This gives the index builder a chance to do any
      * long-running operations in separate units of work from commit().
@@ -189,6 +205,12 @@ public:
         OperationContext* opCtx,
         RecoveryUnit::ReadSource readSource = RecoveryUnit::ReadSource::kUnset);
 
+    /**
+     * Returns an estimate of the number of side writes captured for the indexes being built that
+     * have not yet been drained by drainBackgroundWrites().
+     */
+    long long getNumPendingSideWrites() const;
+
     /**
      * Check any constraits that may have been temporarily violated during the index build for
      * background indexes using an IndexBuildInterceptor to capture writes. The caller is
@@ -208,6 +208,26 @@ TEST_F(MultiIndexBlockTest, InsertingSingleDocumentFailsAfterAbort) {
     ASSERT_FALSE(indexer->isCommitted());
 }
 
+TEST_F(MultiIndexBlockTest, InsertingBatchFailsAfterAbort) {
+    auto indexer = getIndexer();
+    ASSERT_EQUALS(MultiIndexBlock::State::kUninitialized, indexer->getState_forTest());
+
+    auto specs = unittest::assertGet(indexer->init(
+        getOpCtx(), getCollection(), std::vector<BSONObj>(), MultiIndexBlock::kNoopOnInitFn));
+    ASSERT_EQUALS(0U, specs.size());
+    ASSERT_OK(indexer->insertBatch(getOpCtx(), {}));
+
+    indexer->abort("test"_sd);
+    ASSERT_EQUALS(MultiIndexBlock::State::kAborted, indexer->getState_forTest());
+
+    BSONObj doc = BSON("_id" << 123 << "a" << 456);
+    ASSERT_EQUALS(ErrorCodes::IndexBuildAborted,
+                  indexer->insertBatch(getOpCtx(), {BsonRecord{RecordId(1), Timestamp(), &doc}}));
+    ASSERT_EQUALS(MultiIndexBlock::State::kAborted, indexer->getState_forTest());
+
+    ASSERT_FALSE(indexer->isCommitted());
+}
+
 TEST_F(MultiIndexBlockTest, DumpInsertsFromBulkFailsAfterAbort) {
     auto indexer = getIndexer();
     ASSERT_EQUALS(MultiIndexBlock::State::kUninitialized, indexer->getState_forTest());
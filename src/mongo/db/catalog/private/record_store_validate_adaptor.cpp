@@ -36,6 +36,7 @@
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/catalog/index_consistency.h"
+#include "mongo/db/catalog/validate_gen.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index/wildcard_access_method.h"
@@ -147,7 +148,8 @@ Status RecordStoreValidateAdaptor::validate(const RecordId& recordId,
     return status;
 }
 
-void RecordStoreValidateAdaptor::traverseIndex(const IndexAccessMethod* iam,
+void RecordStoreValidateAdaptor::traverseIndex(OperationContext* opCtx,
+                                               const IndexAccessMethod* iam,
                                                const IndexDescriptor* descriptor,
                                                ValidateResults* results,
                                                int64_t* numTraversedKeys) {
@@ -161,9 +163,10 @@ void RecordStoreValidateAdaptor::traverseIndex(const IndexAccessMethod* iam,
     std::unique_ptr<KeyString> prevIndexKeyString = nullptr;
     bool isFirstEntry = true;
 
-    std::unique_ptr<SortedDataInterface::Cursor> cursor = iam->newCursor(_opCtx, true);
+    std::unique_ptr<SortedDataInterface::Cursor> cursor = iam->newCursor(opCtx, true);
     // Seeking to BSONObj() is equivalent to seeking to the first entry of an index.
     for (auto indexEntry = cursor->seek(BSONObj(), true); indexEntry; indexEntry = cursor->next()) {
+        throttle(opCtx, indexEntry->key.objsize());
 
         // We want to use the latest version of KeyString here.
         std::unique_ptr<KeyString> indexKeyString =
@@ -227,6 +230,7 @@ void RecordStoreValidateAdaptor::traverseRecordStore(RecordStore* recordStore,
 
         auto dataSize = record->data.size();
         dataSizeTotal += dataSize;
+        throttle(_opCtx, dataSize);
         size_t validatedSize;
         Status status = validate(record->id, record->data, &validatedSize);
 
@@ -258,6 +262,28 @@ void RecordStoreValidateAdaptor::traverseRecordStore(RecordStore* recordStore,
     output->appendNumber("nrecords", nrecords);
 }
 
+void RecordStoreValidateAdaptor::throttle(OperationContext* opCtx, size_t bytesRead) {
+    const long long maxBytesPerSecond = gValidateMaxBytesPerSecond.load();
+    if (maxBytesPerSecond <= 0) {
+        return;
+    }
+
+    // Wait until enough time has passed since the validation started to have read every byte so
+    // far at the allowed rate.
+    Microseconds wait;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_throttleMutex);
+        _throttledBytes += bytesRead;
+        const auto allowedMicros = static_cast<long long>(
+            static_cast<double>(_throttledBytes) * 1000 * 1000 / maxBytesPerSecond);
+        wait = Microseconds(allowedMicros - _throttleTimer.micros());
+    }
+
+    if (wait >= Milliseconds(1)) {
+        opCtx->sleepFor(duration_cast<Milliseconds>(wait));
+    }
+}
+
 void RecordStoreValidateAdaptor::validateIndexKeyCount(const IndexDescriptor* idx,
                                                        int64_t numRecs,
                                                        ValidateResults& results) {
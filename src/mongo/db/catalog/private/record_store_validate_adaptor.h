@@ -35,6 +35,8 @@
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/storage/record_store.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -71,9 +73,11 @@ public:
 
     /**
      * Traverses the index getting index entriess to validate them and keep track of the index keys
-     * for index consistency.
+     * for index consistency. Reads the index through 'opCtx', which may belong to another thread
+     * than the adaptor's, so that several indexes can be traversed at once.
      */
-    void traverseIndex(const IndexAccessMethod* iam,
+    void traverseIndex(OperationContext* opCtx,
+                       const IndexAccessMethod* iam,
                        const IndexDescriptor* descriptor,
                        ValidateResults* results,
                        int64_t* numTraversedKeys);
@@ -94,11 +98,23 @@ public:
                                int64_t numRecs,
                                ValidateResults& results);
 
+    /**
+     * Sleeps on 'opCtx' for as long as needed to keep the rate at which this validation has read
+     * data, including 'bytesRead', under 'validateMaxBytesPerSecond'. May be called from several
+     * threads at once.
+     */
+    void throttle(OperationContext* opCtx, size_t bytesRead);
+
 private:
     OperationContext* _opCtx;             // Not owned.
     IndexConsistency* _indexConsistency;  // Not owned.
     ValidateCmdLevel _level;
     IndexCatalog* _indexCatalog;             // Not owned.
     ValidateResultsMap* _indexNsResultsMap;  // Not owned.
+
+    // Guards the bytes read since '_throttleTimer' started, which throttle() paces.
+    stdx::mutex _throttleMutex;
+    Timer _throttleTimer;
+    long long _throttledBytes = 0;
 };
 }  // namespace
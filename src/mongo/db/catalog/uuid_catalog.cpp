@@ -44,6 +44,10 @@ namespace mongo {
 namespace {
 const ServiceContext::Decoration<UUIDCatalog> getCatalog =
     ServiceContext::declareDecoration<UUIDCatalog>();
+
+// A new lookup snapshot is built once the number of lookups taking the locked path since the last
+// catalog change, multiplied by this factor, reaches the number of collections in the catalog.
+const std::size_t kLookupSnapshotRebuildFactor = 64;
 }  // namespace
 
 void UUIDCatalogObserver::onCollMod(OperationContext* opCtx,
@@ -281,6 +285,7 @@ void UUIDCatalog::setCollectionNamespace(OperationContext* opCtx,
 
     _collections[toCollection] = _collections[fromCollection];
     _collections.erase(fromCollection);
+    _invalidateLookupSnapshot_inlock();
 
     ResourceId oldRid = ResourceId(RESOURCE_COLLECTION, fromCollection.ns());
     ResourceId newRid = ResourceId(RESOURCE_COLLECTION, toCollection.ns());
@@ -295,6 +300,7 @@ void UUIDCatalog::setCollectionNamespace(OperationContext* opCtx,
 
         _collections[fromCollection] = _collections[toCollection];
         _collections.erase(toCollection);
+        _invalidateLookupSnapshot_inlock();
 
         ResourceId oldRid = ResourceId(RESOURCE_COLLECTION, fromCollection.ns());
         ResourceId newRid = ResourceId(RESOURCE_COLLECTION, toCollection.ns());
@@ -334,7 +340,48 @@ void UUIDCatalog::onOpenCatalog(OperationContext* opCtx) {
     _shadowCatalog.reset();
 }
 
+std::shared_ptr<const UUIDCatalog::LookupSnapshot> UUIDCatalog::_getLookupSnapshot() const {
+    auto snapshot = std::atomic_load(&_lookupSnapshot);
+    if (snapshot) {
+        return snapshot;
+    }
+
+    stdx::lock_guard<stdx::mutex> lock(_catalogLock);
+    snapshot = std::atomic_load(&_lookupSnapshot);
+    if (snapshot) {
+        return snapshot;
+    }
+    if (++_lockedLookupsSinceInvalidation * kLookupSnapshotRebuildFactor < _catalog.size()) {
+        return nullptr;
+    }
+
+    auto newSnapshot = std::make_shared<LookupSnapshot>();
+    newSnapshot->byUUID.reserve(_catalog.size());
+    newSnapshot->byNss.reserve(_catalog.size());
+    for (auto&& entry : _catalog) {
+        LookupSnapshot::Entry snapshotEntry{entry.second.collectionPtr,
+                                            entry.second.collectionCatalogEntry.get(),
+                                            entry.first,
+                                            entry.second.collectionCatalogEntry->ns()};
+        newSnapshot->byUUID.emplace(entry.first, snapshotEntry);
+        newSnapshot->byNss.emplace(snapshotEntry.nss, snapshotEntry);
+    }
+    snapshot = std::move(newSnapshot);
+    std::atomic_store(&_lookupSnapshot, snapshot);
+    return snapshot;
+}
+
+void UUIDCatalog::_invalidateLookupSnapshot_inlock() {
+    std::atomic_store(&_lookupSnapshot, std::shared_ptr<const LookupSnapshot>());
+    _lockedLookupsSinceInvalidation = 0;
+}
+
 Collection* UUIDCatalog::lookupCollectionByUUID(CollectionUUID uuid) const {
+    if (auto snapshot = _getLookupSnapshot()) {
+        auto it = snapshot->byUUID.find(uuid);
+        return it == snapshot->byUUID.end() ? nullptr : it->second.collection;
+    }
+
     stdx::lock_guard<stdx::mutex> lock(_catalogLock);
     auto foundIt = _catalog.find(uuid);
     return foundIt == _catalog.end() || foundIt->second.collectionPtr == nullptr
@@ -343,6 +390,11 @@ Collection* UUIDCatalog::lookupCollectionByUUID(CollectionUUID uuid) const {
 }
 
 Collection* UUIDCatalog::lookupCollectionByNamespace(const NamespaceString& nss) const {
+    if (auto snapshot = _getLookupSnapshot()) {
+        auto it = snapshot->byNss.find(nss);
+        return it == snapshot->byNss.end() ? nullptr : it->second.collection;
+    }
+
     stdx::lock_guard<stdx::mutex> lock(_catalogLock);
     auto it = _collections.find(nss);
     return it == _collections.end() || it->second->collectionPtr == nullptr
@@ -351,6 +403,11 @@ Collection* UUIDCatalog::lookupCollectionByNamespace(const NamespaceString& nss)
 }
 
 CollectionCatalogEntry* UUIDCatalog::lookupCollectionCatalogEntryByUUID(CollectionUUID uuid) const {
+    if (auto snapshot = _getLookupSnapshot()) {
+        auto it = snapshot->byUUID.find(uuid);
+        return it == snapshot->byUUID.end() ? nullptr : it->second.catalogEntry;
+    }
+
     stdx::lock_guard<stdx::mutex> lock(_catalogLock);
     auto foundIt = _catalog.find(uuid);
     return foundIt == _catalog.end() ? nullptr : foundIt->second.collectionCatalogEntry.get();
@@ -358,12 +415,25 @@ CollectionCatalogEntry* UUIDCatalog::lookupCollectionCatalogEntryByUUID(Collecti
 
 CollectionCatalogEntry* UUIDCatalog::lookupCollectionCatalogEntryByNamespace(
     const NamespaceString& nss) const {
+    if (auto snapshot = _getLookupSnapshot()) {
+        auto it = snapshot->byNss.find(nss);
+        return it == snapshot->byNss.end() ? nullptr : it->second.catalogEntry;
+    }
+
     stdx::lock_guard<stdx::mutex> lock(_catalogLock);
     auto it = _collections.find(nss);
     return it == _collections.end() ? nullptr : it->second->collectionCatalogEntry.get();
 }
 
 NamespaceString UUIDCatalog::lookupNSSByUUID(CollectionUUID uuid) const {
+    // Unknown UUIDs may still resolve through '_shadowCatalog', so only hits use the snapshot.
+    if (auto snapshot = _getLookupSnapshot()) {
+        auto it = snapshot->byUUID.find(uuid);
+        if (it != snapshot->byUUID.end() && it->second.collection) {
+            return it->second.nss;
+        }
+    }
+
     stdx::lock_guard<stdx::mutex> lock(_catalogLock);
     auto foundIt = _catalog.find(uuid);
     if (foundIt != _catalog.end())
@@ -381,6 +451,12 @@ NamespaceString UUIDCatalog::lookupNSSByUUID(CollectionUUID uuid) const {
 }
 
 boost::optional<CollectionUUID> UUIDCatalog::lookupUUIDByNSS(const NamespaceString& nss) const {
+    if (auto snapshot = _getLookupSnapshot()) {
+        auto it = snapshot->byNss.find(nss);
+        return it == snapshot->byNss.end() ? boost::none
+                                           : boost::optional<CollectionUUID>(it->second.uuid);
+    }
+
     stdx::lock_guard<stdx::mutex> lock(_catalogLock);
     auto minUuid = UUID::parse("00000000-0000-0000-0000-000000000000").getValue();
     auto it = _orderedCollections.lower_bound(std::make_pair(nss.db().toString(), minUuid));
@@ -506,6 +582,7 @@ void UUIDCatalog::registerCatalogEntry(
     _catalog[uuid] = std::move(collectionInfo);
     _collections[ns] = &_catalog[uuid];
     _orderedCollections[dbIdPair] = &_catalog[uuid];
+    _invalidateLookupSnapshot_inlock();
 }
 
 void UUIDCatalog::registerCollectionObject(CollectionUUID uuid, std::unique_ptr<Collection> coll) {
@@ -533,6 +610,7 @@ void UUIDCatalog::registerCollectionObject(CollectionUUID uuid, std::unique_ptr<
 
     _catalog[uuid].collection = std::move(coll);
     _catalog[uuid].collectionPtr = _catalog[uuid].collection.get();
+    _invalidateLookupSnapshot_inlock();
 
     auto dbRid = ResourceId(RESOURCE_DATABASE, dbName);
     addResource(dbRid, dbName);
@@ -560,6 +638,7 @@ std::unique_ptr<Collection> UUIDCatalog::deregisterCollectionObject(CollectionUU
 
     _catalog[uuid].collection = nullptr;
     _catalog[uuid].collectionPtr = nullptr;
+    _invalidateLookupSnapshot_inlock();
 
     // Make sure collection catalog entry still exists.
     invariant(_catalog[uuid].collectionCatalogEntry);
@@ -598,6 +677,7 @@ std::unique_ptr<CollectionCatalogEntry> UUIDCatalog::deregisterCatalogEntry(Coll
     _orderedCollections.erase(dbIdPair);
     _collections.erase(ns);
     _catalog.erase(uuid);
+    _invalidateLookupSnapshot_inlock();
 
     // Removal from an ordered map will invalidate iterators and potentially references to the
     // references to the erased element.
@@ -625,6 +705,7 @@ void UUIDCatalog::deregisterAllCatalogEntriesAndCollectionObjects() {
     _collections.clear();
     _orderedCollections.clear();
     _catalog.clear();
+    _invalidateLookupSnapshot_inlock();
 
     stdx::lock_guard<stdx::mutex> resourceLock(_resourceLock);
     _resourceInformation.clear();
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <memory>
 #include <set>
 #include <unordered_map>
 
@@ -427,9 +428,44 @@ private:
     class FinishDropChange;
     friend class UUIDCatalog::iterator;
 
+    /**
+     * An immutable copy of the UUID and namespace lookup maps. Lookups read the most recently
+     * published snapshot with a single atomic load instead of acquiring '_catalogLock'.
+     */
+    struct LookupSnapshot {
+        struct Entry {
+            Collection* collection;
+            CollectionCatalogEntry* catalogEntry;
+            CollectionUUID uuid;
+            // Copied under '_catalogLock', since renames modify the namespace in place.
+            NamespaceString nss;
+        };
+        stdx::unordered_map<CollectionUUID, Entry, CollectionUUID::Hash> byUUID;
+        stdx::unordered_map<NamespaceString, Entry> byNss;
+    };
+
+    /**
+     * Returns the published lookup snapshot, or nullptr if the catalog changed since the last one
+     * was built and the caller must fall back to reading under '_catalogLock'.
+     *
+     * Every change to the catalog discards the snapshot. Rebuilding one costs time linear in the
+     * number of collections, so a new snapshot is only built once enough lookups have gone through
+     * the locked path to pay for it. A burst of DDL, such as opening every collection at startup,
+     * therefore does not rebuild the snapshot after each change.
+     */
+    std::shared_ptr<const LookupSnapshot> _getLookupSnapshot() const;
+    void _invalidateLookupSnapshot_inlock();
+
     const std::vector<CollectionUUID>& _getOrdering_inlock(const StringData& db,
                                                            const stdx::lock_guard<stdx::mutex>&);
     mutable mongo::stdx::mutex _catalogLock;
+
+    // Accessed only through std::atomic_load and std::atomic_store. Stored under '_catalogLock'.
+    mutable std::shared_ptr<const LookupSnapshot> _lookupSnapshot;
+
+    // Number of lookups which took the locked path since '_lookupSnapshot' was last discarded.
+    // Protected by '_catalogLock'.
+    mutable std::size_t _lockedLookupsSinceInvalidation = 0;
     /**
      * When present, indicates that the catalog is in closed state, and contains a map from UUID
      * to pre-close NSS. See also onCloseCatalog.
@@ -568,6 +568,58 @@ TEST_F(UUIDCatalogTest, RenameCollection) {
     ASSERT_EQUALS(catalog.lookupCollectionByUUID(uuid), collection);
 }
 
+TEST_F(UUIDCatalogTest, LookupsReflectRenameAndDrop) {
+    auto uuid = CollectionUUID::gen();
+    NamespaceString oldNss(nss.db(), "oldcol");
+    auto collUnique = std::make_unique<CollectionMock>(oldNss);
+    auto catalogEntry = std::make_unique<CollectionCatalogEntryMock>(oldNss.ns());
+    auto collection = collUnique.get();
+    catalog.registerCatalogEntry(uuid, std::move(catalogEntry));
+    catalog.onCreateCollection(&opCtx, std::move(collUnique), uuid);
+    ASSERT_EQUALS(catalog.lookupCollectionByNamespace(oldNss), collection);
+    ASSERT_EQUALS(catalog.lookupUUIDByNSS(oldNss), uuid);
+
+    NamespaceString newNss(nss.db(), "newcol");
+    catalog.setCollectionNamespace(&opCtx, collection, oldNss, newNss);
+    ASSERT(catalog.lookupCollectionByNamespace(oldNss) == nullptr);
+    ASSERT(catalog.lookupCollectionCatalogEntryByNamespace(oldNss) == nullptr);
+    ASSERT_FALSE(catalog.lookupUUIDByNSS(oldNss));
+    ASSERT_EQUALS(catalog.lookupCollectionByNamespace(newNss), collection);
+    ASSERT_EQUALS(catalog.lookupUUIDByNSS(newNss), uuid);
+    ASSERT_EQUALS(catalog.lookupNSSByUUID(uuid), newNss);
+
+    catalog.onDropCollection(&opCtx, uuid);
+    ASSERT(catalog.lookupCollectionByUUID(uuid) == nullptr);
+    ASSERT(catalog.lookupCollectionByNamespace(newNss) == nullptr);
+    ASSERT(catalog.lookupCollectionCatalogEntryByUUID(uuid) != nullptr);
+}
+
+TEST_F(UUIDCatalogTest, LookupsAreConsistentWhileRegisteringManyCollections) {
+    // With many collections, lookups between registrations take the locked path until enough of
+    // them have accumulated to rebuild the lookup snapshot. Both paths must agree.
+    std::vector<std::pair<CollectionUUID, CollectionMock*>> collections;
+    for (int i = 0; i < 500; ++i) {
+        NamespaceString newNss(nss.db(), "coll" + std::to_string(i));
+        auto uuid = CollectionUUID::gen();
+        auto collUnique = std::make_unique<CollectionMock>(newNss);
+        collections.emplace_back(uuid, collUnique.get());
+        catalog.registerCatalogEntry(
+            uuid, std::make_unique<CollectionCatalogEntryMock>(newNss.ns()));
+        catalog.onCreateCollection(&opCtx, std::move(collUnique), uuid);
+
+        for (int j = 0; j <= i; j += 50) {
+            ASSERT_EQUALS(catalog.lookupCollectionByUUID(collections[j].first),
+                          collections[j].second);
+        }
+        ASSERT_EQUALS(catalog.lookupCollectionByNamespace(newNss), collections.back().second);
+    }
+
+    for (auto&& entry : collections) {
+        ASSERT_EQUALS(catalog.lookupCollectionByUUID(entry.first), entry.second);
+        ASSERT_EQUALS(catalog.lookupNSSByUUID(entry.first), entry.second->ns());
+    }
+}
+
 TEST_F(UUIDCatalogTest, NonExistingNextCol) {
     ASSERT_FALSE(catalog.next(nss.db(), colUUID));
     ASSERT_FALSE(catalog.next(nss.db(), nextUUID));
@@ -0,0 +1,181 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kCommand
+
+#include "mongo/platform/basic.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index_names.h"
+#include "mongo/db/query/collection_statistics.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+namespace {
+
+const long long kDefaultSampleSize = 1000;
+const long long kMaxSampleSize = 100000;
+const long long kDefaultNumBuckets = 100;
+const long long kMaxNumBuckets = 1000;
+
+long long parsePositiveOption(const BSONObj& cmdObj,
+                              StringData fieldName,
+                              long long defaultValue,
+                              long long maxValue) {
+    BSONElement elt = cmdObj[fieldName];
+    if (!elt) {
+        return defaultValue;
+    }
+    uassert(ErrorCodes::TypeMismatch,
+            str::stream() << "'" << fieldName << "' must be a number",
+            elt.isNumber());
+    const long long value = elt.safeNumberLong();
+    uassert(ErrorCodes::BadValue,
+            str::stream() << "'" << fieldName << "' must be between 1 and " << maxValue,
+            value > 0 && value <= maxValue);
+    return value;
+}
+
+/**
+ * Samples a collection and builds histograms of the fields of its btree indexes, which the query
+ * planner then uses to order candidate plans. The statistics are kept in memory only.
+ *
+ * { analyze: <collection>, sampleSize: <number>, buckets: <number> }
+ */
+class AnalyzeCmd : public BasicCommand {
+public:
+    AnalyzeCmd() : BasicCommand("analyze") {}
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kOptIn;
+    }
+
+    std::string help() const override {
+        return "Sample a collection to gather the statistics used by the query planner.\n"
+               "Add sampleSize:<n> to change the number of documents sampled and buckets:<n> to "
+               "change the number of histogram buckets per field.";
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) const override {
+        ActionSet actions;
+        actions.addAction(ActionType::planCacheWrite);
+        out->push_back(Privilege(parseResourcePattern(dbname, cmdObj), actions));
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const NamespaceString nss(CommandHelpers::parseNsCollectionRequired(dbname, cmdObj));
+        const long long sampleSize =
+            parsePositiveOption(cmdObj, "sampleSize", kDefaultSampleSize, kMaxSampleSize);
+        const long long numBuckets =
+            parsePositiveOption(cmdObj, "buckets", kDefaultNumBuckets, kMaxNumBuckets);
+
+        AutoGetCollectionForReadCommand ctx(opCtx, nss);
+        uassert(ErrorCodes::CommandNotSupportedOnView, "Cannot analyze a view", !ctx.getView());
+        Collection* collection = ctx.getCollection();
+        uassert(ErrorCodes::NamespaceNotFound, "ns not found", collection);
+
+        std::set<std::string> paths;
+        std::unique_ptr<IndexCatalog::IndexIterator> ii =
+            collection->getIndexCatalog()->getIndexIterator(opCtx, false);
+        while (ii->more()) {
+            const IndexDescriptor* desc = ii->next()->descriptor();
+            if (IndexNames::findPluginName(desc->keyPattern()) != IndexNames::BTREE) {
+                continue;
+            }
+            for (auto&& field : desc->keyPattern()) {
+                paths.insert(field.fieldName());
+            }
+        }
+
+        const long long numRecords = static_cast<long long>(collection->numRecords(opCtx));
+        std::vector<BSONObj> sample;
+        sample.reserve(std::min(numRecords, sampleSize));
+
+        std::unique_ptr<RecordCursor> randomCursor;
+        if (numRecords > sampleSize) {
+            randomCursor = collection->getRecordStore()->getRandomCursor(opCtx);
+        }
+        if (randomCursor) {
+            while (static_cast<long long>(sample.size()) < sampleSize) {
+                opCtx->checkForInterrupt();
+                auto record = randomCursor->next();
+                if (!record) {
+                    break;
+                }
+                sample.push_back(record->data.toBson().getOwned());
+            }
+        } else {
+            // Without a random cursor, take evenly spaced documents from a collection scan.
+            const long long stride = std::max(1LL, numRecords / sampleSize);
+            auto cursor = collection->getCursor(opCtx);
+            long long position = 0;
+            while (static_cast<long long>(sample.size()) < sampleSize) {
+                opCtx->checkForInterrupt();
+                auto record = cursor->next();
+                if (!record) {
+                    break;
+                }
+                if (position++ % stride == 0) {
+                    sample.push_back(record->data.toBson().getOwned());
+                }
+            }
+        }
+
+        auto statistics = std::make_shared<const CollectionStatistics>(CollectionStatistics::make(
+            sample, numRecords, paths, static_cast<size_t>(numBuckets)));
+        LOG(1) << "Analyzed " << nss << ": sampled " << sample.size() << " of " << numRecords
+               << " documents over " << paths.size() << " fields";
+
+        result.append("ns", nss.ns());
+        result.append("statistics", statistics->toBSON());
+        collection->infoCache()->setStatistics(std::move(statistics));
+        return true;
+    }
+} analyzeCmd;
+
+}  // namespace
+}  // namespace mongo
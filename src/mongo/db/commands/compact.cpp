@@ -79,10 +79,13 @@ public:
         return "compact collection\n"
                "warning: this operation locks the database and is slow. you can cancel with "
                "killOp()\n"
-               "{ compact : <collection_name>, [force:<bool>], [validate:<bool>] }\n"
+               "{ compact : <collection_name>, [force:<bool>], [validate:<bool>], [online:<bool>], "
+               "[maxBytesPerSecond:<number>] }\n"
                "  force - allows to run on a replica set primary\n"
                "  validate - check records are noncorrupt before adding to newly compacting "
-               "extents. slower but safer (defaults to true in this version)\n";
+               "extents. slower but safer (defaults to true in this version)\n"
+               "  online - compact in short chunks that allow concurrent reads and writes\n"
+               "  maxBytesPerSecond - with online, limits the rate at which space is reclaimed\n";
     }
     CompactCmd() : ErrmsgCommandDeprecated("compact") {}
 
@@ -93,8 +96,27 @@ public:
                            BSONObjBuilder& result) {
         NamespaceString nss = CommandHelpers::parseNsCollectionRequired(db, cmdObj);
 
+        CompactOptions compactOptions;
+
+        if (cmdObj.hasElement("validate"))
+            compactOptions.validateDocuments = cmdObj["validate"].trueValue();
+
+        compactOptions.online = cmdObj["online"].trueValue();
+        if (cmdObj.hasElement("maxBytesPerSecond")) {
+            uassert(ErrorCodes::InvalidOptions,
+                    "maxBytesPerSecond requires online:true",
+                    compactOptions.online);
+            const auto maxBytesPerSecond = cmdObj["maxBytesPerSecond"];
+            uassert(ErrorCodes::InvalidOptions,
+                    "maxBytesPerSecond must be a non-negative number",
+                    maxBytesPerSecond.isNumber() && maxBytesPerSecond.safeNumberLong() >= 0);
+            compactOptions.maxBytesPerSecond = maxBytesPerSecond.safeNumberLong();
+        }
+
+        // Online compaction does not block other operations, so it may run on a primary.
         repl::ReplicationCoordinator* replCoord = repl::ReplicationCoordinator::get(opCtx);
-        if (replCoord->getMemberState().primary() && !cmdObj["force"].trueValue()) {
+        if (replCoord->getMemberState().primary() && !compactOptions.online &&
+            !cmdObj["force"].trueValue()) {
             errmsg =
                 "will not run compact on an active replica set primary as this is a slow blocking "
                 "operation. use force:true to force";
@@ -112,10 +134,16 @@ public:
             return false;
         }
 
-        CompactOptions compactOptions;
-
-        if (cmdObj.hasElement("validate"))
-            compactOptions.validateDocuments = cmdObj["validate"].trueValue();
+        if (compactOptions.online) {
+            log() << "compact " << nss.ns() << " begin, options: " << compactOptions;
+            StatusWith<CompactStats> status =
+                compactCollectionOnline(opCtx, nss, &compactOptions);
+            uassertStatusOK(status.getStatus());
+            result.appendNumber("bytesReclaimed", status.getValue().bytesReclaimed);
+            log() << "compact " << nss.ns() << " end, reclaimed "
+                  << status.getValue().bytesReclaimed << " bytes";
+            return true;
+        }
 
         AutoGetDb autoDb(opCtx, db, MODE_X);
         Database* const collDB = autoDb.getDb();
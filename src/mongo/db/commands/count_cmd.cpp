@@ -31,6 +31,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <cmath>
+
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands.h"
@@ -39,6 +41,9 @@
 #include "mongo/db/curop_failpoint_helpers.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/count.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/query/count_command_as_aggregation_command.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/get_executor.h"
@@ -58,6 +63,62 @@ using std::stringstream;
 // Failpoint which causes to hang "count" cmd after acquiring the DB lock.
 MONGO_FAIL_POINT_DEFINE(hangBeforeCollectionCount);
 
+/**
+ * Estimates the number of documents in 'collection' matching 'request' by evaluating its query
+ * against 'sampleSize' randomly chosen documents and scaling by the number of records. Returns
+ * boost::none if the collection is small enough to count exactly, or if its record store cannot
+ * produce random documents. The estimate does not filter out orphaned documents.
+ */
+boost::optional<long long> estimateCount(OperationContext* opCtx,
+                                         Collection* collection,
+                                         const CountCommand& request,
+                                         long long sampleSize) {
+    const long long numRecords = collection->numRecords(opCtx);
+    if (numRecords <= sampleSize) {
+        return boost::none;
+    }
+
+    auto cursor = collection->getRecordStore()->getRandomCursor(opCtx);
+    if (!cursor) {
+        return boost::none;
+    }
+
+    std::unique_ptr<CollatorInterface> collator;
+    if (auto collation = request.getCollation()) {
+        collator = uassertStatusOK(
+            CollatorFactoryInterface::get(opCtx->getServiceContext())->makeFromBSON(*collation));
+    } else if (collection->getDefaultCollator()) {
+        collator = collection->getDefaultCollator()->clone();
+    }
+    boost::intrusive_ptr<ExpressionContext> expCtx(new ExpressionContext(opCtx, collator.get()));
+    auto matcher = uassertStatusOK(MatchExpressionParser::parse(request.getQuery(), expCtx));
+
+    long long numSampled = 0;
+    long long numMatched = 0;
+    while (numSampled < sampleSize) {
+        auto record = cursor->next();
+        if (!record) {
+            break;
+        }
+        ++numSampled;
+        if (matcher->matchesBSON(record->data.toBson())) {
+            ++numMatched;
+        }
+    }
+    if (numSampled == 0) {
+        return boost::none;
+    }
+
+    long long estimate = std::llround(static_cast<double>(numMatched) / numSampled * numRecords);
+    if (auto skip = request.getSkip()) {
+        estimate = std::max(0LL, estimate - static_cast<long long>(*skip));
+    }
+    if (auto limit = request.getLimit(); limit && *limit > 0) {
+        estimate = std::min(estimate, static_cast<long long>(*limit));
+    }
+    return estimate;
+}
+
 /**
  * Implements the MongoD side of the count command.
  */
@@ -203,7 +264,16 @@ public:
         uassertStatusOK(replCoord->checkCanServeReadsFor(
             opCtx, nss, ReadPreferenceSetting::get(opCtx).canRunOnSecondary()));
 
+        const auto estimateSampleSize = request.getEstimateSampleSize();
+        uassert(ErrorCodes::BadValue,
+                "'estimateSampleSize' must be positive",
+                !estimateSampleSize || *estimateSampleSize > 0);
+
         if (ctx->getView()) {
+            uassert(ErrorCodes::OptionNotSupportedOnView,
+                    "'estimateSampleSize' is not supported on views",
+                    !estimateSampleSize);
+
             auto viewAggregation = countCommandAsAggregationCommand(request, nss);
 
             // Relinquish locks. The aggregation command will re-acquire them.
@@ -224,6 +294,18 @@ public:
         // version on initial entry into count.
         auto rangePreserver = CollectionShardingState::get(opCtx, nss)->getCurrentMetadata();
 
+        if (estimateSampleSize) {
+            if (!collection) {
+                result.appendNumber("n", 0LL);
+                return true;
+            }
+            if (auto estimate = estimateCount(opCtx, collection, request, *estimateSampleSize)) {
+                result.appendNumber("n", *estimate);
+                result.append("estimated", true);
+                return true;
+            }
+        }
+
         auto statusWithPlanExecutor =
             getExecutorCount(opCtx, collection, request, false /*explain*/, nss);
         uassertStatusOK(statusWithPlanExecutor.getStatus());
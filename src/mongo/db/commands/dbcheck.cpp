@@ -45,7 +45,11 @@
 #include "mongo/db/repl/dbcheck.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/optime.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/background.h"
+#include "mongo/util/timer.h"
 
 #include "mongo/util/log.h"
 
@@ -55,6 +59,11 @@ namespace {
 constexpr uint64_t kBatchDocs = 5'000;
 constexpr uint64_t kBatchBytes = 20'000'000;
 
+// Bounds on the batch size when batches are resized to take 'maxBatchTimeMillis'.
+constexpr int64_t kMinAdaptiveBatchDocs = 100;
+constexpr int64_t kMaxAdaptiveBatchDocs = 100'000;
+
+constexpr int64_t kMaxParallelCollections = 16;
 
 /**
  * All the information needed to run dbCheck on a single collection.
@@ -65,13 +74,56 @@ struct DbCheckCollectionInfo {
     BSONKey end;
     int64_t maxCount;
     int64_t maxSize;
+    int64_t maxBatchMillis;
+};
+
+/**
+ * A run of dbCheck consists of a series of collections, checked under a shared rate limit.
+ */
+struct DbCheckRun {
+    std::vector<DbCheckCollectionInfo> collections;
     int64_t maxRate;
+    int64_t numParallelCollections = 1;
 };
 
 /**
- * A run of dbCheck consists of a series of collections.
+ * Limits the number of documents checked per second across all the threads of a run. Up to a
+ * second's worth of documents may be checked in a burst.
  */
-using DbCheckRun = std::vector<DbCheckCollectionInfo>;
+class DbCheckRateLimiter {
+public:
+    explicit DbCheckRateLimiter(int64_t maxRate) : _maxRate(maxRate) {}
+
+    /**
+     * Accounts for 'docs' checked documents, then sleeps for as long as the run is over budget.
+     */
+    void consume(int64_t docs) {
+        using namespace std::literals::chrono_literals;
+        using Clock = stdx::chrono::steady_clock;
+
+        if (_maxRate <= 0 || docs <= 0) {
+            return;
+        }
+
+        Clock::time_point wakeUp;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            const auto now = Clock::now();
+            const auto cost = stdx::chrono::duration_cast<Clock::duration>(
+                stdx::chrono::duration<double>(static_cast<double>(docs) / _maxRate));
+            _budgetEnd = std::max(_budgetEnd, now) + cost;
+            wakeUp = _budgetEnd - 1s;
+        }
+        stdx::this_thread::sleep_until(wakeUp);
+    }
+
+private:
+    const int64_t _maxRate;
+
+    stdx::mutex _mutex;
+    // The time at which everything checked so far will have been within the rate.
+    stdx::chrono::steady_clock::time_point _budgetEnd;
+};
 
 /**
  * Check if dbCheck can run on the given namespace.
@@ -116,10 +168,11 @@ std::unique_ptr<DbCheckRun> singleCollectionRun(OperationContext* opCtx,
     auto end = invocation.getMaxKey();
     auto maxCount = invocation.getMaxCount();
     auto maxSize = invocation.getMaxSize();
-    auto maxRate = invocation.getMaxCountPerSecond();
-    auto info = DbCheckCollectionInfo{nss, start, end, maxCount, maxSize, maxRate};
+    auto maxBatchMillis = invocation.getMaxBatchTimeMillis();
+    auto info = DbCheckCollectionInfo{nss, start, end, maxCount, maxSize, maxBatchMillis};
     auto result = stdx::make_unique<DbCheckRun>();
-    result->push_back(info);
+    result->collections.push_back(info);
+    result->maxRate = invocation.getMaxCountPerSecond();
     return result;
 }
 
@@ -136,8 +189,16 @@ std::unique_ptr<DbCheckRun> fullDatabaseRun(OperationContext* opCtx,
 
     uassert(ErrorCodes::NamespaceNotFound, "Database " + dbName + " not found", agd.getDb());
 
+    uassert(ErrorCodes::InvalidOptions,
+            str::stream() << "numParallelCollections must be between 1 and "
+                          << kMaxParallelCollections,
+            invocation.getNumParallelCollections() >= 1 &&
+                invocation.getNumParallelCollections() <= kMaxParallelCollections);
+    result->maxRate = invocation.getMaxCountPerSecond();
+    result->numParallelCollections = invocation.getNumParallelCollections();
+
     int64_t max = std::numeric_limits<int64_t>::max();
-    auto rate = invocation.getMaxCountPerSecond();
+    auto batchMillis = invocation.getMaxBatchTimeMillis();
 
     for (auto collIt = db->begin(opCtx); collIt != db->end(opCtx); ++collIt) {
         auto coll = *collIt;
@@ -145,8 +206,9 @@ std::unique_ptr<DbCheckRun> fullDatabaseRun(OperationContext* opCtx,
             break;
         }
 
-        DbCheckCollectionInfo info{coll->ns(), BSONKey::min(), BSONKey::max(), max, max, rate};
-        result->push_back(info);
+        DbCheckCollectionInfo info{
+            coll->ns(), BSONKey::min(), BSONKey::max(), max, max, batchMillis};
+        result->collections.push_back(info);
     }
 
     return result;
@@ -188,7 +250,12 @@ std::unique_ptr<DbCheckRun> getRun(OperationContext* opCtx,
 class DbCheckJob : public BackgroundJob {
 public:
     DbCheckJob(const StringData& dbName, std::unique_ptr<DbCheckRun> run)
-        : BackgroundJob(true), _done(false), _dbName(dbName.toString()), _run(std::move(run)) {}
+        : BackgroundJob(true),
+          _done(false),
+          _failed(false),
+          _dbName(dbName.toString()),
+          _run(std::move(run)),
+          _rateLimiter(_run->maxRate) {}
 
 protected:
     virtual std::string name() const override {
@@ -199,59 +266,102 @@ protected:
         // Every dbCheck runs in its own client.
         ThreadClient tc(name(), getGlobalServiceContext());
 
-        for (const auto& coll : *_run) {
+        const auto numWorkers = std::min<size_t>(_run->numParallelCollections,
+                                                 _run->collections.size());
+        if (numWorkers <= 1) {
+            _checkCollections();
+            return;
+        }
+
+        // Each worker thread has its own client, as a client can only run one operation at a time.
+        // They share the job's name so that they show up as dbCheck in currentOp.
+        std::vector<stdx::thread> workers;
+        for (size_t i = 0; i < numWorkers; ++i) {
+            workers.emplace_back([this] {
+                ThreadClient tc(name(), getGlobalServiceContext());
+                _checkCollections();
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+private:
+    /**
+     * Checks collections from the run until none are left, or until the run fails or is stopped
+     * by a stepdown. Safe to call from several threads at once.
+     */
+    void _checkCollections() {
+        while (!_failed.load()) {
+            const auto index = _nextCollection.fetchAndAdd(1);
+            if (index >= _run->collections.size()) {
+                return;
+            }
+
+            const auto& coll = _run->collections[index];
             try {
                 _doCollection(coll);
             } catch (const DBException& e) {
                 auto logEntry = dbCheckErrorHealthLogEntry(
                     coll.nss, "dbCheck failed", OplogEntriesEnum::Batch, e.toStatus());
                 HealthLog::get(Client::getCurrent()->getServiceContext()).log(*logEntry);
+                _failed.store(true);
                 return;
             }
 
-            if (_done) {
+            if (_done.load()) {
                 log() << "dbCheck terminated due to stepdown";
                 return;
             }
         }
     }
 
-private:
+    /**
+     * Returns the number of documents for the batch after one which hashed 'nDocs' documents in
+     * 'elapsedMillis', aiming for 'targetMillis' per batch. The size changes at most twofold at a
+     * time, so that one unusually slow or fast batch does not swing it too far.
+     */
+    static int64_t _nextBatchDocs(int64_t batchDocs,
+                                  int64_t nDocs,
+                                  int64_t elapsedMillis,
+                                  int64_t targetMillis) {
+        if (nDocs < batchDocs && elapsedMillis <= targetMillis) {
+            // The batch was cut short by the byte limit or the end of the range, which says
+            // nothing about whether a larger batch would have fit in the target.
+            return batchDocs;
+        }
+
+        const int64_t estimate = nDocs * targetMillis / std::max<int64_t>(elapsedMillis, 1);
+        const int64_t lower = std::max(kMinAdaptiveBatchDocs, batchDocs / 2);
+        const int64_t upper = std::min(kMaxAdaptiveBatchDocs, batchDocs * 2);
+        return std::max(lower, std::min(upper, estimate));
+    }
+
     void _doCollection(const DbCheckCollectionInfo& info) {
         // If we can't find the collection, abort the check.
         if (!_getCollectionMetadata(info)) {
             return;
         }
 
-        if (_done) {
+        if (_done.load()) {
             return;
         }
 
         // Parameters for the hasher.
         auto start = info.start;
         bool reachedEnd = false;
+        int64_t batchDocs = kBatchDocs;
 
         // Make sure the totals over all of our batches don't exceed the provided limits.
         int64_t totalBytesSeen = 0;
         int64_t totalDocsSeen = 0;
 
-        // Limit the rate of the check.
-        using Clock = stdx::chrono::system_clock;
-        using TimePoint = stdx::chrono::time_point<Clock>;
-        TimePoint lastStart = Clock::now();
-        int64_t docsInCurrentInterval = 0;
-
         do {
-            using namespace std::literals::chrono_literals;
+            Timer batchTimer;
+            auto result = _runBatch(info, start, batchDocs, kBatchBytes);
 
-            if (Clock::now() - lastStart > 1s) {
-                lastStart = Clock::now();
-                docsInCurrentInterval = 0;
-            }
-
-            auto result = _runBatch(info, start, kBatchDocs, kBatchBytes);
-
-            if (_done) {
+            if (_done.load()) {
                 return;
             }
 
@@ -282,7 +392,6 @@ private:
             // Update our running totals.
             totalDocsSeen += stats.nDocs;
             totalBytesSeen += stats.nBytes;
-            docsInCurrentInterval += stats.nDocs;
 
             // Check if we've exceeded any limits.
             bool reachedLast = stats.lastKey >= info.end;
@@ -290,13 +399,14 @@ private:
             bool tooManyBytes = totalBytesSeen >= info.maxSize;
             reachedEnd = reachedLast || tooManyDocs || tooManyBytes;
 
-            if (docsInCurrentInterval > info.maxRate && info.maxRate > 0) {
-                // If an extremely low max rate has been set (substantially smaller than the batch
-                // size) we might want to sleep for multiple seconds between batches.
-                int64_t timesExceeded = docsInCurrentInterval / info.maxRate;
-
-                stdx::this_thread::sleep_for(timesExceeded * 1s - (Clock::now() - lastStart));
+            // Secondaries hash the same range when applying the batch's oplog entry, so the time
+            // taken here approximates the cost of applying it.
+            if (info.maxBatchMillis > 0) {
+                batchDocs = _nextBatchDocs(
+                    batchDocs, stats.nDocs, batchTimer.millis(), info.maxBatchMillis);
             }
+
+            _rateLimiter.consume(stats.nDocs);
         } while (!reachedEnd);
     }
 
@@ -312,9 +422,14 @@ private:
     };
 
     // Set if the job cannot proceed.
-    bool _done;
+    AtomicWord<bool> _done;
+    // Set if checking a collection failed, which stops the whole run.
+    AtomicWord<bool> _failed;
     std::string _dbName;
     std::unique_ptr<DbCheckRun> _run;
+    // The index in '_run' of the next collection for a worker to check.
+    AtomicWord<size_t> _nextCollection{0};
+    DbCheckRateLimiter _rateLimiter;
 
     bool _getCollectionMetadata(const DbCheckCollectionInfo& info) {
         auto uniqueOpCtx = Client::getCurrent()->makeOperationContext();
@@ -325,7 +440,7 @@ private:
         AutoGetDbForDbCheck agd(opCtx, info.nss);
 
         if (_stepdownHasOccurred(opCtx, info.nss)) {
-            _done = true;
+            _done.store(true);
             return true;
         }
 
@@ -395,7 +510,7 @@ private:
         AutoGetCollectionForDbCheck agc(opCtx, info.nss, OplogEntriesEnum::Batch);
 
         if (_stepdownHasOccurred(opCtx, info.nss)) {
-            _done = true;
+            _done.store(true);
             return Status(ErrorCodes::PrimarySteppedDown, "dbCheck terminated due to stepdown");
         }
 
@@ -519,9 +634,14 @@ public:
                "              maxKey: <last key, inclusive>,\n"
                "              maxCount: <max number of docs>,\n"
                "              maxSize: <max size of docs>,\n"
-               "              maxCountPerSecond: <max rate in docs/sec> } "
+               "              maxCountPerSecond: <max rate in docs/sec>,\n"
+               "              maxBatchTimeMillis: <target time per batch> } "
                "to check a collection.\n"
-               "Invoke with {dbCheck: 1} to check all collections in the database.";
+               "Invoke with {dbCheck: 1,\n"
+               "              maxCountPerSecond: <max rate in docs/sec>,\n"
+               "              maxBatchTimeMillis: <target time per batch>,\n"
+               "              numParallelCollections: <collections to check at once> } "
+               "to check all collections in the database.";
     }
 
     virtual Status checkAuthForCommand(Client* client,
@@ -31,9 +31,13 @@
 
 #include "mongo/platform/basic.h"
 
+#include <array>
 #include <boost/optional.hpp>
 #include <map>
 #include <string>
+#include <third_party/murmurhash3/MurmurHash3.h>
+
+#include "mongo/base/data_view.h"
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
@@ -49,6 +53,7 @@
 #include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/transaction_participant.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/hex.h"
 #include "mongo/util/log.h"
 #include "mongo/util/md5.hpp"
 #include "mongo/util/net/socket_utils.h"
@@ -58,6 +63,9 @@ namespace mongo {
 
 namespace {
 
+// Caps the size of a 'hashRanges' response.
+const long long kMaxHashRanges = 10000;
+
 class DBHashCmd : public ErrmsgCommandDeprecated {
 public:
     DBHashCmd() : ErrmsgCommandDeprecated("dbHash", "dbhash") {}
@@ -102,6 +110,14 @@ public:
             }
         }
 
+        boost::optional<BSONObj> hashRangesSpec;
+        if (auto elem = cmdObj["hashRanges"]) {
+            uassert(ErrorCodes::TypeMismatch,
+                    "'hashRanges' must be an object",
+                    elem.type() == BSONType::Object);
+            hashRangesSpec = elem.Obj();
+        }
+
         const std::string ns = parseNs(dbname, cmdObj);
         uassert(ErrorCodes::InvalidNamespace,
                 str::stream() << "Invalid db name: " << ns,
@@ -204,6 +220,12 @@ public:
 
         result.append("host", prettyHostName());
 
+        if (hashRangesSpec) {
+            _hashRanges(opCtx, db, dbname, *hashRangesSpec, &result);
+            result.appendNumber("timeMillis", timer.millis());
+            return true;
+        }
+
         md5_state_t globalState;
         md5_init(&globalState);
 
@@ -277,17 +299,14 @@ public:
     }
 
 private:
-    std::string _hashCollection(OperationContext* opCtx,
+    /**
+     * Makes sure 'collection' can be read consistently, taking its lock in intent mode into
+     * 'collLock' when reading at a timestamp with only an intent lock on the database.
+     */
+    void _lockCollectionForRead(OperationContext* opCtx,
                                 Database* db,
-                                const std::string& fullCollectionName) {
-
-        NamespaceString ns(fullCollectionName);
-
-        Collection* collection = db->getCollection(opCtx, ns);
-        if (!collection)
-            return "";
-
-        boost::optional<Lock::CollectionLock> collLock;
+                                Collection* collection,
+                                boost::optional<Lock::CollectionLock>* collLock) {
         if (opCtx->recoveryUnit()->getTimestampReadSource() ==
             RecoveryUnit::ReadSource::kProvided) {
             // When performing a read at a timestamp, we are only holding the database lock in
@@ -295,7 +314,7 @@ private:
             // reading from the consistent snapshot doesn't overlap with any catalog operations on
             // the collection.
             invariant(opCtx->lockState()->isDbLockedForMode(db->name(), MODE_IS));
-            collLock.emplace(opCtx, ns, MODE_IS);
+            collLock->emplace(opCtx, collection->ns(), MODE_IS);
 
             auto minSnapshot = collection->getMinimumVisibleSnapshot();
             auto mySnapshot = opCtx->recoveryUnit()->getPointInTimeReadTimestamp();
@@ -312,6 +331,188 @@ private:
         } else {
             invariant(opCtx->lockState()->isDbLockedForMode(db->name(), MODE_S));
         }
+    }
+
+    /**
+     * Hashes the documents of one collection in consecutive _id ranges and appends a 'ranges'
+     * array of {min, max, count, hash} objects to 'result'. A range's hash is the sum of the
+     * 128-bit MurmurHash3 of each document in it, so it equals the sum of the hashes of any split
+     * of the range: members can compare coarse ranges and only split the ones which differ.
+     *
+     * The ranges are either the given 'bounds', or at most 'numRanges' ranges of roughly equal
+     * document counts between the optional 'min' and 'max'. The upper bound is always exclusive.
+     */
+    void _hashRanges(OperationContext* opCtx,
+                     Database* db,
+                     const std::string& dbname,
+                     const BSONObj& spec,
+                     BSONObjBuilder* result) {
+        auto collElem = spec["collection"];
+        uassert(ErrorCodes::TypeMismatch,
+                "'hashRanges.collection' must be a string",
+                collElem.type() == BSONType::String);
+        const NamespaceString nss(dbname, collElem.valueStringData());
+
+        Collection* collection = db ? db->getCollection(opCtx, nss) : nullptr;
+        uassert(ErrorCodes::NamespaceNotFound,
+                str::stream() << "Collection " << nss.ns() << " not found",
+                collection);
+        uassert(ErrorCodes::InvalidOptions,
+                "'hashRanges' is not supported on collections with a default collation",
+                !collection->getDefaultCollator());
+
+        boost::optional<Lock::CollectionLock> collLock;
+        _lockCollectionForRead(opCtx, db, collection, &collLock);
+
+        auto desc = collection->getIndexCatalog()->findIdIndex(opCtx);
+        uassert(ErrorCodes::IndexNotFound,
+                str::stream() << "'hashRanges' requires an _id index on " << nss.ns(),
+                desc);
+
+        BSONObj minKey = BSON("" << MINKEY);
+        BSONObj maxKey = BSON("" << MAXKEY);
+        std::vector<BSONElement> bounds;
+        long long docsPerRange = 0;
+        if (auto boundsElem = spec["bounds"]) {
+            uassert(ErrorCodes::InvalidOptions,
+                    "'hashRanges.bounds' cannot be combined with 'numRanges', 'min' or 'max'",
+                    !spec.hasField("numRanges") && !spec.hasField("min") && !spec.hasField("max"));
+            uassert(ErrorCodes::TypeMismatch,
+                    "'hashRanges.bounds' must be an array",
+                    boundsElem.type() == BSONType::Array);
+            bounds = boundsElem.Array();
+            uassert(ErrorCodes::InvalidOptions,
+                    str::stream() << "'hashRanges.bounds' must have between 2 and "
+                                  << kMaxHashRanges + 1
+                                  << " elements",
+                    bounds.size() >= 2 &&
+                        bounds.size() <= static_cast<size_t>(kMaxHashRanges + 1));
+            for (size_t i = 1; i < bounds.size(); ++i) {
+                uassert(ErrorCodes::InvalidOptions,
+                        "'hashRanges.bounds' must be strictly increasing",
+                        bounds[i - 1].woCompare(bounds[i], false) < 0);
+            }
+            minKey = bounds.front().wrap("");
+            maxKey = bounds.back().wrap("");
+        } else {
+            auto numRangesElem = spec["numRanges"];
+            uassert(ErrorCodes::InvalidOptions,
+                    "'hashRanges' requires either 'bounds' or 'numRanges'",
+                    numRangesElem.isNumber());
+            const long long numRanges = numRangesElem.safeNumberLong();
+            uassert(ErrorCodes::InvalidOptions,
+                    str::stream() << "'hashRanges.numRanges' must be between 1 and "
+                                  << kMaxHashRanges,
+                    numRanges >= 1 && numRanges <= kMaxHashRanges);
+            if (auto minElem = spec["min"]) {
+                minKey = minElem.wrap("");
+            }
+            if (auto maxElem = spec["max"]) {
+                maxKey = maxElem.wrap("");
+            }
+            uassert(ErrorCodes::InvalidOptions,
+                    "'hashRanges.min' must be less than 'hashRanges.max'",
+                    minKey.firstElement().woCompare(maxKey.firstElement(), false) < 0);
+
+            // Count the documents from the index keys alone, to split them evenly.
+            auto countExec = InternalPlanner::indexScan(opCtx,
+                                                        collection,
+                                                        desc,
+                                                        minKey,
+                                                        maxKey,
+                                                        BoundInclusion::kIncludeStartKeyOnly,
+                                                        PlanExecutor::NO_YIELD);
+            long long count = 0;
+            BSONObj key;
+            PlanExecutor::ExecState state;
+            while (PlanExecutor::ADVANCED == (state = countExec->getNext(&key, nullptr))) {
+                count++;
+            }
+            uassert(51770,
+                    "Plan executor error while running dbHash command: " +
+                        WorkingSetCommon::toStatusString(key),
+                    PlanExecutor::IS_EOF == state);
+            docsPerRange = std::max(1LL, (count + numRanges - 1) / numRanges);
+        }
+
+        auto exec = InternalPlanner::indexScan(opCtx,
+                                               collection,
+                                               desc,
+                                               minKey,
+                                               maxKey,
+                                               BoundInclusion::kIncludeStartKeyOnly,
+                                               PlanExecutor::NO_YIELD,
+                                               InternalPlanner::FORWARD,
+                                               InternalPlanner::IXSCAN_FETCH);
+
+        BSONArrayBuilder ranges(result->subarrayStart("ranges"));
+        BSONObj rangeMin = minKey;
+        long long rangeCount = 0;
+        std::array<uint64_t, 2> rangeHash{};
+        auto closeRange = [&](const BSONElement& rangeMax) {
+            char hashBytes[16];
+            DataView(hashBytes).write<LittleEndian<uint64_t>>(rangeHash[0], 0);
+            DataView(hashBytes).write<LittleEndian<uint64_t>>(rangeHash[1], 8);
+
+            BSONObjBuilder range(ranges.subobjStart());
+            range.appendAs(rangeMin.firstElement(), "min");
+            range.appendAs(rangeMax, "max");
+            range.appendNumber("count", rangeCount);
+            range.append("hash", toHexLower(hashBytes, sizeof(hashBytes)));
+
+            rangeMin = rangeMax.wrap("");
+            rangeCount = 0;
+            rangeHash = {};
+        };
+
+        size_t nextBound = 1;
+        BSONObj doc;
+        PlanExecutor::ExecState state;
+        while (PlanExecutor::ADVANCED == (state = exec->getNext(&doc, nullptr))) {
+            BSONElement id = doc["_id"];
+            if (!bounds.empty()) {
+                // Close every range which ends at or before this document, including empty ones.
+                while (nextBound < bounds.size() - 1 &&
+                       id.woCompare(bounds[nextBound], false) >= 0) {
+                    closeRange(bounds[nextBound++]);
+                }
+            } else if (rangeCount == docsPerRange) {
+                closeRange(id);
+            }
+
+            uint64_t docHash[2];
+            MurmurHash3_x64_128(doc.objdata(), doc.objsize(), 0, docHash);
+            rangeHash[0] += docHash[0];
+            rangeHash[1] += docHash[1];
+            rangeCount++;
+        }
+        uassert(51771,
+                "Plan executor error while running dbHash command: " +
+                    WorkingSetCommon::toStatusString(doc),
+                PlanExecutor::IS_EOF == state);
+
+        if (!bounds.empty()) {
+            while (nextBound < bounds.size()) {
+                closeRange(bounds[nextBound++]);
+            }
+        } else {
+            closeRange(maxKey.firstElement());
+        }
+        ranges.done();
+    }
+
+    std::string _hashCollection(OperationContext* opCtx,
+                                Database* db,
+                                const std::string& fullCollectionName) {
+
+        NamespaceString ns(fullCollectionName);
+
+        Collection* collection = db->getCollection(opCtx, ns);
+        if (!collection)
+            return "";
+
+        boost::optional<Lock::CollectionLock> collLock;
+        _lockCollectionForRead(opCtx, db, collection, &collLock);
 
         auto desc = collection->getIndexCatalog()->findIdIndex(opCtx);
 
@@ -31,6 +31,7 @@
 
 #include "mongo/db/command_can_run_here.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/util/str.h"
 
@@ -101,6 +102,7 @@ public:
                 "Are you explaining a write command on a secondary?",
                 commandCanRunHere(
                     opCtx, _dbName, _innerInvocation->definition(), inMultiDocumentTransaction));
+        PlanStage::setAlwaysTimeStages(opCtx);
         _innerInvocation->explain(opCtx, _verbosity, result);
     }
 
@@ -40,13 +40,18 @@
 #include "mongo/db/curop_failpoint_helpers.h"
 #include "mongo/db/cursor_manager.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/idhack.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/index/index_access_method.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/find.h"
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/service_context.h"
@@ -62,6 +67,93 @@ namespace {
 
 const auto kTermField = "term"_sd;
 
+/**
+ * Returns true if 'cq' over 'collection' may skip the plan executor and be answered by a direct
+ * _id index lookup: a plain equality on _id which needs no projection, sort, hint, skip or index
+ * bounds, and no shard filtering.
+ */
+bool canUseExpressIdLookup(OperationContext* opCtx,
+                           Collection* collection,
+                           const CanonicalQuery& cq) {
+    if (!internalQueryEnableExpressIdLookup.load() || !collection ||
+        collection->ns().isOplog() || !collection->getIndexCatalog()->findIdIndex(opCtx)) {
+        return false;
+    }
+
+    const auto& qr = cq.getQueryRequest();
+    if (!IDHackStage::supportsQuery(collection, cq) || cq.getProj() || !qr.getSort().isEmpty() ||
+        !qr.getMin().isEmpty() || !qr.getMax().isEmpty() || qr.returnKey() ||
+        (qr.getBatchSize() && *qr.getBatchSize() == 0)) {
+        return false;
+    }
+
+    // Orphaned documents are filtered by the plan executor, so sharded collections take the
+    // regular path. The shard version was already checked when the collection was locked.
+    return !CollectionShardingState::get(opCtx, collection->ns())
+                ->getCurrentMetadata()
+                ->isSharded();
+}
+
+/**
+ * Answers a find which canUseExpressIdLookup() accepted by looking up the _id index and fetching
+ * the document, and fills out CurOp as endQueryOp() would for the equivalent IDHACK plan.
+ */
+void runExpressIdLookup(OperationContext* opCtx,
+                        Collection* collection,
+                        const CanonicalQuery& cq,
+                        rpc::ReplyBuilderInterface* result) {
+    const auto& nss = collection->ns();
+    const IndexDescriptor* idIndex = collection->getIndexCatalog()->findIdIndex(opCtx);
+    const IndexAccessMethod* accessMethod =
+        collection->getIndexCatalog()->getEntry(idIndex)->accessMethod();
+    const BSONObj key = cq.getQueryObj()["_id"].wrap();
+
+    {
+        stdx::lock_guard<Client> lk(*opCtx->getClient());
+        CurOp::get(opCtx)->setPlanSummary_inlock("EXPRESS_IDHACK");
+    }
+
+    opCtx->checkForInterrupt();
+
+    PlanSummaryStats summaryStats;
+    boost::optional<Snapshotted<BSONObj>> doc;
+    writeConflictRetry(opCtx, "find", nss.ns(), [&] {
+        doc.reset();
+        summaryStats.totalKeysExamined = 0;
+        summaryStats.totalDocsExamined = 0;
+
+        const RecordId recordId = accessMethod->findSingle(opCtx, key);
+        if (recordId.isNull()) {
+            return;
+        }
+        ++summaryStats.totalKeysExamined;
+        ++summaryStats.totalDocsExamined;
+
+        Snapshotted<BSONObj> found;
+        if (collection->findDoc(opCtx, recordId, &found)) {
+            doc = std::move(found);
+        }
+    });
+
+    CursorResponseBuilder::Options options;
+    options.isInitialResponse = true;
+    CursorResponseBuilder firstBatch(result, options);
+    if (doc) {
+        firstBatch.append(doc->value());
+    }
+
+    summaryStats.nReturned = doc ? 1 : 0;
+    summaryStats.indexesUsed.insert(idIndex->indexName());
+    auto curOp = CurOp::get(opCtx);
+    curOp->debug().nreturned = summaryStats.nReturned;
+    curOp->debug().cursorid = -1;
+    curOp->debug().cursorExhausted = true;
+    curOp->debug().setPlanSummaryMetrics(summaryStats);
+    collection->infoCache()->notifyOfQuery(opCtx, summaryStats.indexesUsed);
+
+    firstBatch.done(0, nss.ns());
+}
+
 /**
  * A command for running .find() queries.
  */
@@ -402,6 +494,18 @@ public:
                 opCtx->recoveryUnit()->setReadOnce(true);
             }
 
+            // Point reads by _id need neither a plan nor an executor.
+            if (canUseExpressIdLookup(opCtx, collection, *cq)) {
+                CurOpFailpointHelpers::waitWhileFailPointEnabled(&waitInFindBeforeMakingBatch,
+                                                                 opCtx,
+                                                                 "waitInFindBeforeMakingBatch",
+                                                                 []() {},
+                                                                 false,
+                                                                 nss);
+                runExpressIdLookup(opCtx, collection, *cq, result);
+                return;
+            }
+
             // Get the execution plan for the query.
             auto exec = uassertStatusOK(getExecutorFind(opCtx, collection, std::move(cq)));
 
@@ -430,6 +534,13 @@ public:
 
             const QueryRequest& originalQR = exec->getCanonicalQuery()->getQueryRequest();
 
+            // Size the reply for the expected first batch so that appending large documents
+            // doesn't repeatedly grow and copy the reply buffer.
+            if (auto bytes = FindCommon::bytesToReserveForFirstBatch(
+                    originalQR, collection->averageObjectSize(opCtx))) {
+                result->reserveBytes(bytes);
+            }
+
             // Stream query results, adding them to a BSONArray as we go.
             CursorResponseBuilder::Options options;
             options.isInitialResponse = true;
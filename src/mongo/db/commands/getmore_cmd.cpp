@@ -156,6 +156,16 @@ void applyCursorReadConcern(OperationContext* opCtx, repl::ReadConcernArgs rcArg
                 break;
             }
         }
+    } else if (rcArgs.getLevel() == repl::ReadConcernLevel::kSnapshotReadConcern &&
+               rcArgs.getArgsAtClusterTime() &&
+               opCtx->recoveryUnit()->getTimestampReadSource() ==
+                   RecoveryUnit::ReadSource::kUnset) {
+        // A snapshot cursor outside of a transaction reads each batch at the timestamp chosen
+        // when it was established. The timestamp is not pinned between batches, so this fails
+        // with SnapshotTooOld if it has since fallen out of the snapshot history window. Cursors
+        // in a transaction find their read source already restored with the transaction.
+        opCtx->recoveryUnit()->setTimestampReadSource(
+            RecoveryUnit::ReadSource::kProvided, rcArgs.getArgsAtClusterTime()->asTimestamp());
     }
 
     // For cursor commands that take locks internally, the read concern on the
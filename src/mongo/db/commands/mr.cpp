@@ -47,6 +47,8 @@
 #include "mongo/db/client.h"
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/commands/mr_aggregation.h"
+#include "mongo/db/commands/mr_params_gen.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbhelpers.h"
@@ -65,6 +67,7 @@
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/service_context.h"
+#include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/catalog_cache.h"
 #include "mongo/s/client/parallel.h"
 #include "mongo/s/client/shard_connection.h"
@@ -217,6 +220,96 @@ void dropTempCollections(OperationContext* cleanupOpCtx,
     }
 }
 
+/**
+ * Runs the mapReduce described by 'config' as the aggregation 'pipeline' produced by
+ * translateToAggregationPipeline(), and appends the fields of a mapReduce response to 'result'.
+ */
+void runAsAggregation(OperationContext* opCtx,
+                      const Config& config,
+                      const std::vector<BSONObj>& pipeline,
+                      const BSONObj& cmd,
+                      const Timer& timer,
+                      BSONObjBuilder& result) {
+    {
+        AutoGetCollectionForReadCommand autoColl(opCtx, config.nss);
+        uassert(ErrorCodes::NamespaceNotFound,
+                str::stream() << "namespace does not exist: " << config.nss.ns(),
+                autoColl.getCollection());
+    }
+
+    DBDirectClient client(opCtx);
+    const std::string dbname = config.nss.db().toString();
+
+    // The aggregation does not report how many documents went into it, so count them separately.
+    BSONObjBuilder countCmd;
+    countCmd.append("count", config.nss.coll());
+    countCmd.append("query", config.filter);
+    if (config.limit) {
+        countCmd.append("limit", config.limit);
+    }
+    if (!config.collation.isEmpty()) {
+        countCmd.append("collation", config.collation);
+    }
+    BSONObj countResult;
+    client.runCommand(dbname, countCmd.obj(), countResult);
+    uassertStatusOK(getStatusFromCommandResult(countResult));
+    const long long numInputs = countResult["n"].numberLong();
+
+    BSONObjBuilder aggCmd;
+    aggCmd.append("aggregate", config.nss.coll());
+    aggCmd.append("pipeline", pipeline);
+    // Inline results have to fit in the first batch, just as they have to fit in a single response
+    // when computed in JavaScript.
+    aggCmd.append("cursor", BSON("batchSize" << std::numeric_limits<int>::max()));
+    if (!config.collation.isEmpty()) {
+        aggCmd.append("collation", config.collation);
+    }
+    if (shouldBypassDocumentValidationForCommand(cmd)) {
+        aggCmd.append("bypassDocumentValidation", true);
+    }
+    BSONObj aggResult;
+    client.runCommand(dbname, aggCmd.obj(), aggResult);
+    uassertStatusOK(getStatusFromCommandResult(aggResult));
+
+    long long numOutputs;
+    if (config.outputOptions.outType == Config::INMEMORY) {
+        const BSONObj cursor = aggResult.getObjectField("cursor");
+        const long long cursorId = cursor["id"].numberLong();
+        if (cursorId != 0) {
+            client.killCursor(config.nss, cursorId);
+            uasserted(13604, "too much data for in memory map/reduce");
+        }
+        const BSONObj results = cursor.getObjectField("firstBatch");
+        numOutputs = results.nFields();
+        result.appendArray("results", results);
+    } else {
+        numOutputs = client.count(config.outputOptions.finalNamespace.ns());
+        if (!config.outputOptions.outDB.empty()) {
+            result.append("result",
+                          BSON("db" << config.outputOptions.outDB << "collection"
+                                    << config.outputOptions.collectionName));
+        } else {
+            result.append("result", config.outputOptions.collectionName);
+        }
+    }
+
+    result.appendNumber("timeMillis", timer.millis());
+    if (config.verbose) {
+        result.append("timing",
+                      BSON("mode"
+                           << "aggregation"
+                           << "total"
+                           << timer.millis()));
+    }
+
+    // No reduce function runs, so none is counted.
+    BSONObjBuilder countsBuilder(result.subobjStart("counts"));
+    countsBuilder.appendNumber("input", numInputs);
+    countsBuilder.appendNumber("emit", numInputs);
+    countsBuilder.appendNumber("reduce", 0);
+    countsBuilder.appendNumber("output", numOutputs);
+}
+
 }  // namespace
 
 AtomicWord<unsigned> Config::JOB_NUMBER;
@@ -1428,6 +1521,14 @@ public:
 
         LOG(1) << "mr ns: " << config.nss;
 
+        if (gMapReduceUseAggregation.load()) {
+            if (auto pipeline = translateToAggregationPipeline(config, cmd)) {
+                LOG(1) << "mr running as aggregation: " << redact(BSON("pipeline" << *pipeline));
+                runAsAggregation(opCtx, config, *pipeline, cmd, t, result);
+                return true;
+            }
+        }
+
         uassert(16149, "cannot run map reduce without the js engine", getGlobalScriptEngine());
 
         const auto metadata = [&] {
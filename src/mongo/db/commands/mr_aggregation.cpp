@@ -0,0 +1,257 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/commands/mr_aggregation.h"
+
+#include <pcrecpp.h>
+#include <string>
+
+#include "mongo/base/parse_number.h"
+#include "mongo/db/commands/mr.h"
+
+namespace mongo {
+namespace mr {
+namespace {
+
+// A JavaScript identifier, restricted to the characters which may also appear in a field path.
+const std::string kIdentifier = "[A-Za-z_][A-Za-z0-9_]*";
+const std::string kPath = kIdentifier + "(?:\\." + kIdentifier + ")*";
+
+// function() { emit(this.<path>, this.<path> | <number>); }
+const pcrecpp::RE kMapRE("\\s*function\\s*\\(\\s*\\)\\s*\\{\\s*"
+                         "emit\\s*\\(\\s*this\\.(" +
+                         kPath + ")\\s*,\\s*(this\\." + kPath +
+                         "|-?[0-9]+(?:\\.[0-9]+)?)\\s*\\)\\s*;?\\s*\\}\\s*");
+
+// function(<key>, <values>) { <body> }
+const pcrecpp::RE kReduceRE("\\s*function\\s*\\(\\s*" + kIdentifier + "\\s*,\\s*(" + kIdentifier +
+                                ")\\s*\\)\\s*\\{\\s*(.*?)\\s*\\}\\s*",
+                            pcrecpp::RE_Options().set_dotall(true));
+
+// return Array.sum(<values>);
+const pcrecpp::RE kArraySumRE("return\\s+Array\\.sum\\s*\\(\\s*(" + kIdentifier +
+                              ")\\s*\\)\\s*;?");
+
+// var <total> = 0; for (var <i> = 0; <i> < <values>.length; <i>++) { <total> += <values>[<i>]; }
+// return <total>;
+const pcrecpp::RE kLoopSumRE("var\\s+(" + kIdentifier + ")\\s*=\\s*0\\s*;\\s*"
+                             "for\\s*\\(\\s*var\\s+(" +
+                             kIdentifier + ")\\s*=\\s*0\\s*;\\s*\\2\\s*<\\s*(" + kIdentifier +
+                             ")\\.length\\s*;\\s*(?:\\2\\s*\\+\\+|\\+\\+\\s*\\2)\\s*\\)\\s*"
+                             "(?:\\{\\s*\\1\\s*\\+=\\s*\\3\\s*\\[\\s*\\2\\s*\\]\\s*;?\\s*\\}|"
+                             "\\1\\s*\\+=\\s*\\3\\s*\\[\\s*\\2\\s*\\]\\s*;)\\s*"
+                             "return\\s+\\1\\s*;?");
+
+// return Math.max.apply(Math | null, <values>);
+const pcrecpp::RE kMathApplyRE("return\\s+Math\\.(max|min)\\.apply\\s*\\(\\s*(?:Math|null)\\s*,"
+                               "\\s*(" +
+                               kIdentifier + ")\\s*\\)\\s*;?");
+
+/**
+ * Returns the source of a map or reduce function, which may be given as a string or as code.
+ * Code with scope is left to the JavaScript implementation.
+ */
+boost::optional<std::string> functionSource(const BSONElement& elem) {
+    if (elem.type() != String && elem.type() != Code) {
+        return boost::none;
+    }
+    return elem.valueStringData().toString();
+}
+
+/**
+ * Returns true if 'filter' uses a query operator which $match does not accept.
+ */
+bool usesOperatorUnsupportedByMatch(const BSONObj& filter) {
+    for (auto&& elem : filter) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName == "$where" || fieldName == "$near" || fieldName == "$nearSphere") {
+            return true;
+        }
+        if ((elem.type() == Object || elem.type() == Array) &&
+            usesOperatorUnsupportedByMatch(elem.embeddedObject())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Appends the accumulator argument for the value emitted by a recognized map function: either a
+ * field path or a numeric constant.
+ */
+bool appendEmittedValue(const std::string& value, StringData fieldName, BSONObjBuilder* builder) {
+    constexpr StringData kThisPrefix = "this."_sd;
+    if (StringData(value).startsWith(kThisPrefix)) {
+        builder->append(fieldName, "$" + value.substr(kThisPrefix.size()));
+        return true;
+    }
+
+    double number;
+    if (!parseNumberFromString(value, &number).isOK()) {
+        return false;
+    }
+    builder->append(fieldName, number);
+    return true;
+}
+
+/**
+ * Returns the accumulator equivalent to a recognized reduce function, or an empty string.
+ */
+std::string reduceAccumulator(const std::string& source) {
+    std::string valuesParam;
+    std::string body;
+    if (!kReduceRE.FullMatch(source, &valuesParam, &body)) {
+        return "";
+    }
+
+    std::string valuesArg;
+    if (kArraySumRE.FullMatch(body, &valuesArg) && valuesArg == valuesParam) {
+        return "$sum";
+    }
+
+    std::string total;
+    std::string index;
+    if (kLoopSumRE.FullMatch(body, &total, &index, &valuesArg) && valuesArg == valuesParam &&
+        total != index && total != valuesParam && index != valuesParam) {
+        return "$sum";
+    }
+
+    std::string op;
+    if (kMathApplyRE.FullMatch(body, &op, &valuesArg) && valuesArg == valuesParam) {
+        return "$" + op;
+    }
+
+    return "";
+}
+
+}  // namespace
+
+boost::optional<std::vector<BSONObj>> translateToAggregationPipeline(const Config& config,
+                                                                     const BSONObj& cmdObj) {
+    if (config.finalizer || !config.scopeSetup.isEmpty() || config.shardedFirstPass ||
+        config.finalOutputCollUUID) {
+        return boost::none;
+    }
+
+    const auto& outputOptions = config.outputOptions;
+    const bool sameOutputDb = outputOptions.outDB.empty() || outputOptions.outDB == config.dbname;
+    if (outputOptions.outType == Config::REDUCE ||
+        (outputOptions.outType == Config::REPLACE && !sameOutputDb)) {
+        return boost::none;
+    }
+
+    if (usesOperatorUnsupportedByMatch(config.filter)) {
+        return boost::none;
+    }
+
+    const auto mapSource = functionSource(cmdObj["map"]);
+    const auto reduceSource = functionSource(cmdObj["reduce"]);
+    if (!mapSource || !reduceSource) {
+        return boost::none;
+    }
+
+    std::string keyPath;
+    std::string emittedValue;
+    if (!kMapRE.FullMatch(*mapSource, &keyPath, &emittedValue)) {
+        return boost::none;
+    }
+
+    const std::string accumulator = reduceAccumulator(*reduceSource);
+    if (accumulator.empty()) {
+        return boost::none;
+    }
+
+    std::vector<BSONObj> pipeline;
+    if (!config.filter.isEmpty()) {
+        pipeline.push_back(BSON("$match" << config.filter));
+    }
+    if (!config.sort.isEmpty()) {
+        pipeline.push_back(BSON("$sort" << config.sort));
+    }
+    if (config.limit) {
+        pipeline.push_back(BSON("$limit" << config.limit));
+    }
+
+    {
+        BSONObjBuilder group;
+        {
+            BSONObjBuilder groupSpec(group.subobjStart("$group"));
+            groupSpec.append("_id", "$" + keyPath);
+            BSONObjBuilder valueSpec(groupSpec.subobjStart("value"));
+            if (!appendEmittedValue(emittedValue, accumulator, &valueSpec)) {
+                return boost::none;
+            }
+        }
+        pipeline.push_back(group.obj());
+    }
+
+    // JavaScript numbers are doubles, so the JavaScript implementation outputs sums, and the
+    // maximum or minimum of integers, as doubles.
+    if (accumulator == "$sum") {
+        pipeline.push_back(BSON("$project" << BSON("value" << BSON("$toDouble"
+                                                                   << "$value"))));
+    } else {
+        pipeline.push_back(BSON(
+            "$project" << BSON(
+                "value" << BSON("$cond" << BSON_ARRAY(
+                                    BSON("$in" << BSON_ARRAY(BSON("$type"
+                                                                  << "$value")
+                                                             << BSON_ARRAY("int"
+                                                                           << "long")))
+                                    << BSON("$toDouble"
+                                            << "$value")
+                                    << "$value")))));
+    }
+
+    switch (outputOptions.outType) {
+        case Config::INMEMORY:
+            pipeline.push_back(BSON("$sort" << BSON("_id" << 1)));
+            break;
+        case Config::REPLACE:
+            pipeline.push_back(BSON("$out" << BSON("to" << outputOptions.collectionName << "mode"
+                                                        << "replaceCollection")));
+            break;
+        case Config::MERGE:
+            pipeline.push_back(
+                BSON("$out" << BSON("to" << outputOptions.collectionName << "db"
+                                         << outputOptions.finalNamespace.db()
+                                         << "mode"
+                                         << "replaceDocuments")));
+            break;
+        case Config::REDUCE:
+            MONGO_UNREACHABLE;
+    }
+
+    return pipeline;
+}
+
+}  // namespace mr
+}  // namespace mongo
@@ -0,0 +1,76 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+namespace mr {
+
+class Config;
+
+/**
+ * Translates a mapReduce command whose map and reduce functions follow one of a few common shapes
+ * into an equivalent aggregation pipeline, so that it can run without the JavaScript engine.
+ * Returns boost::none if any part of the command falls outside what can be translated, in which
+ * case the command must run through the JavaScript implementation.
+ *
+ * Recognized map functions emit a field of the document as the key and either another field or a
+ * numeric constant as the value:
+ *
+ *     function() { emit(this.<path>, this.<path>); }
+ *     function() { emit(this.<path>, <number>); }
+ *
+ * Recognized reduce functions sum the values or take their maximum or minimum:
+ *
+ *     function(key, values) { return Array.sum(values); }
+ *     function(key, values) {
+ *         var total = 0;
+ *         for (var i = 0; i < values.length; i++) { total += values[i]; }
+ *         return total;
+ *     }
+ *     function(key, values) { return Math.max.apply(Math, values); }
+ *     function(key, values) { return Math.min.apply(null, values); }
+ *
+ * The 'query', 'sort', 'limit' and 'collation' options carry over. Commands with 'finalize' or
+ * 'scope', those run by mongos as the first pass of a sharded mapReduce, and those whose output
+ * mode is 'reduce' or 'replace' into another database are not translated.
+ *
+ * As in the JavaScript implementation, summed values, and integral maxima and minima, are output as
+ * doubles. Unlike it, non-numeric values are ignored by a sum rather than concatenated.
+ */
+boost::optional<std::vector<BSONObj>> translateToAggregationPipeline(const Config& config,
+                                                                     const BSONObj& cmdObj);
+
+}  // namespace mr
+}  // namespace mongo
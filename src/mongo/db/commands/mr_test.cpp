@@ -41,6 +41,7 @@
 #include "mongo/db/catalog/collection_options.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/commands/mr_aggregation.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/json.h"
 #include "mongo/db/op_observer_noop.h"
@@ -272,6 +273,96 @@ TEST(ConfigTest, CollationNotAnObjectFailsToParse) {
     ASSERT_THROWS(mr::Config(dbname, cmdObj), AssertionException);
 }
 
+/**
+ * Tests for mr::translateToAggregationPipeline()
+ */
+
+boost::optional<std::vector<BSONObj>> translate(const std::string& cmdJson) {
+    const BSONObj cmdObj = fromjson(cmdJson);
+    const mr::Config config("myDB", cmdObj);
+    return mr::translateToAggregationPipeline(config, cmdObj);
+}
+
+void assertPipelineEq(const std::string& expectedJson,
+                      const boost::optional<std::vector<BSONObj>>& pipeline) {
+    ASSERT(pipeline);
+    BSONArrayBuilder actual;
+    for (auto&& stage : *pipeline) {
+        actual.append(stage);
+    }
+    ASSERT_BSONOBJ_EQ(fromjson(expectedJson).firstElement().Obj(), actual.arr());
+}
+
+TEST(TranslateToAggregationTest, SumOfFieldInline) {
+    assertPipelineEq(
+        "{p: [{$match: {status: 'A'}}, {$sort: {cust_id: 1}}, {$limit: 10},"
+        "     {$group: {_id: '$cust_id', value: {$sum: '$price'}}},"
+        "     {$project: {value: {$toDouble: '$value'}}},"
+        "     {$sort: {_id: 1}}]}",
+        translate("{mapReduce: 'orders',"
+                  " map: 'function() { emit(this.cust_id, this.price); }',"
+                  " reduce: 'function(key, values) { return Array.sum(values); }',"
+                  " query: {status: 'A'}, sort: {cust_id: 1}, limit: 10,"
+                  " out: {inline: 1}}"));
+}
+
+TEST(TranslateToAggregationTest, CountWithLoopReduceReplacesOutput) {
+    assertPipelineEq(
+        "{p: [{$group: {_id: '$a.b', value: {$sum: 1}}},"
+        "     {$project: {value: {$toDouble: '$value'}}},"
+        "     {$out: {to: 'out', mode: 'replaceCollection'}}]}",
+        translate("{mapReduce: 'coll',"
+                  " map: 'function() {\\n  emit(this.a.b, 1);\\n}',"
+                  " reduce: 'function(k, vals) {\\n  var total = 0;\\n"
+                  "   for (var i = 0; i < vals.length; i++) {\\n    total += vals[i];\\n  }\\n"
+                  "   return total;\\n}',"
+                  " out: 'out'}"));
+}
+
+TEST(TranslateToAggregationTest, MaxMergesIntoOtherDatabase) {
+    assertPipelineEq(
+        "{p: [{$group: {_id: '$k', value: {$max: '$v'}}},"
+        "     {$project: {value: {$cond: [{$in: [{$type: '$value'}, ['int', 'long']]},"
+        "                                 {$toDouble: '$value'}, '$value']}}},"
+        "     {$out: {to: 'out', db: 'otherDB', mode: 'replaceDocuments'}}]}",
+        translate("{mapReduce: 'coll',"
+                  " map: 'function() { emit(this.k, this.v); }',"
+                  " reduce: 'function(k, v) { return Math.max.apply(Math, v); }',"
+                  " out: {merge: 'out', db: 'otherDB'}}"));
+}
+
+TEST(TranslateToAggregationTest, UnrecognizedCommandsAreNotTranslated) {
+    const std::string map = "map: 'function() { emit(this.k, 1); }', ";
+    const std::string reduce = "reduce: 'function(k, v) { return Array.sum(v); }', ";
+
+    // Supported as a baseline.
+    ASSERT(translate("{mapReduce: 'coll', " + map + reduce + "out: {inline: 1}}"));
+
+    // Map functions which do more than emit a field.
+    ASSERT_FALSE(translate("{mapReduce: 'coll', map: 'function() { emit(this.k, this.v * 2); }', " +
+                           reduce + "out: {inline: 1}}"));
+    ASSERT_FALSE(translate(
+        "{mapReduce: 'coll', map: 'function() { emit(this.k, 1); emit(0, 1); }', " + reduce +
+        "out: {inline: 1}}"));
+
+    // Reduce functions which do something other than sum, or sum a different array.
+    ASSERT_FALSE(translate("{mapReduce: 'coll', " + map +
+                           "reduce: 'function(k, v) { return v.length; }', out: {inline: 1}}"));
+    ASSERT_FALSE(translate("{mapReduce: 'coll', " + map +
+                           "reduce: 'function(k, v) { return Array.sum(k); }', out: {inline: 1}}"));
+
+    // Options which have no equivalent in the translation.
+    ASSERT_FALSE(translate("{mapReduce: 'coll', " + map + reduce +
+                           "finalize: 'function(k, v) { return v; }', out: {inline: 1}}"));
+    ASSERT_FALSE(
+        translate("{mapReduce: 'coll', " + map + reduce + "scope: {x: 1}, out: {inline: 1}}"));
+    ASSERT_FALSE(translate("{mapReduce: 'coll', " + map + reduce + "out: {reduce: 'out'}}"));
+    ASSERT_FALSE(
+        translate("{mapReduce: 'coll', " + map + reduce + "out: {replace: 'out', db: 'otherDB'}}"));
+    ASSERT_FALSE(translate("{mapReduce: 'coll', " + map + reduce +
+                           "query: {$or: [{$where: 'this.a > 1'}]}, out: {inline: 1}}"));
+}
+
 /**
  * OpObserver for mapReduce test fixture.
  */
@@ -34,13 +34,16 @@
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/server_status.h"
+#include "mongo/db/commands/server_status_gen.h"
 #include "mongo/db/commands/server_status_internal.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/http_client.h"
 #include "mongo/util/net/socket_utils.h"
 #include "mongo/util/ramlog.h"
+#include "mongo/util/timer.h"
 #include "mongo/util/version.h"
 
 namespace mongo {
@@ -125,7 +128,7 @@ public:
                 continue;
             }
 
-            section->appendSection(opCtx, elem, &result);
+            section->appendSectionCached(opCtx, elem, &result);
             timeBuilder.appendNumber(
                 static_cast<string>(str::stream() << "after " << section->getSectionName()),
                 durationCount<Milliseconds>(clock->now() - runStart));
@@ -180,6 +183,13 @@ public:
         _sections[section->getSectionName()] = section;
     }
 
+    void appendSectionGenerationStats(BSONObjBuilder* builder) const {
+        for (auto&& entry : _sections) {
+            BSONObjBuilder sectionBuilder(builder->subobjStart(entry.first));
+            entry.second->appendGenerationStats(&sectionBuilder);
+        }
+    }
+
 private:
     const Date_t _started;
     bool _runCalled;
@@ -210,6 +220,62 @@ ServerStatusSection::ServerStatusSection(const string& sectionName) : _sectionNa
     CmdServerStatusInstantiator::getInstance().addSection(this);
 }
 
+Milliseconds ServerStatusSection::cacheTTL() const {
+    if (cost() == Cost::kCheap) {
+        return Milliseconds(0);
+    }
+    return Milliseconds(gServerStatusExpensiveSectionCacheMillis.load());
+}
+
+void ServerStatusSection::appendSectionCached(OperationContext* opCtx,
+                                              const BSONElement& configElement,
+                                              BSONObjBuilder* result) {
+    auto recordGeneration = [this](long long micros) {
+        _numGenerated.addAndFetch(1);
+        _totalGenerationMicros.addAndFetch(micros);
+        _lastGenerationMicros.store(micros);
+    };
+
+    // Section-specific options may change the output, so only plain requests use the cache.
+    const auto ttl = configElement.isABSONObj() ? Milliseconds(0) : cacheTTL();
+    if (ttl <= Milliseconds(0)) {
+        Timer timer;
+        appendSection(opCtx, configElement, result);
+        recordGeneration(timer.micros());
+        return;
+    }
+
+    const auto now = Date_t::now();
+    {
+        stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
+        if (_cachedAt != Date_t() && now - _cachedAt < ttl) {
+            _numCacheHits.addAndFetch(1);
+            result->appendElements(_cachedOutput);
+            return;
+        }
+    }
+
+    Timer timer;
+    BSONObjBuilder sectionBuilder;
+    appendSection(opCtx, configElement, &sectionBuilder);
+    const auto output = sectionBuilder.obj();
+    recordGeneration(timer.micros());
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
+        _cachedOutput = output;
+        _cachedAt = now;
+    }
+    result->appendElements(output);
+}
+
+void ServerStatusSection::appendGenerationStats(BSONObjBuilder* builder) const {
+    builder->append("generated", _numGenerated.load());
+    builder->append("cacheHits", _numCacheHits.load());
+    builder->append("totalMicros", _totalGenerationMicros.load());
+    builder->append("lastMicros", _lastGenerationMicros.load());
+}
+
 OpCounterServerStatusSection::OpCounterServerStatusSection(const string& sectionName,
                                                            OpCounters* counters)
     : ServerStatusSection(sectionName), _counters(counters) {}
@@ -288,6 +354,17 @@ public:
     }
 } memBase;
 
+// Reports the generation statistics of every section as serverStatus.metrics.serverStatus.sections.
+class SectionGenerationStats : public ServerStatusMetric {
+public:
+    SectionGenerationStats() : ServerStatusMetric("serverStatus.sections") {}
+
+    void appendAtLeaf(BSONObjBuilder& b) const override {
+        BSONObjBuilder sectionsBuilder(b.subobjStart(_leafName));
+        CmdServerStatusInstantiator::getInstance().appendSectionGenerationStats(&sectionsBuilder);
+    }
+} sectionGenerationStats;
+
 class HttpClientServerStatus : public ServerStatusSection {
 public:
     HttpClientServerStatus() : ServerStatusSection("http_client") {}
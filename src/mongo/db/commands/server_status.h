@@ -33,12 +33,20 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
 #include <string>
 
 namespace mongo {
 
 class ServerStatusSection {
 public:
+    /**
+     * How expensive a section is to generate. The serverStatus command may reuse the recent output
+     * of expensive sections rather than generating them on every call.
+     */
+    enum class Cost { kCheap, kExpensive };
+
     ServerStatusSection(const std::string& sectionName);
     virtual ~ServerStatusSection() = default;
 
@@ -64,6 +72,18 @@ public:
      */
     virtual bool includeByDefault() const = 0;
 
+    virtual Cost cost() const {
+        return Cost::kCheap;
+    }
+
+    /**
+     * How long the serverStatus command may return this section's previously generated output
+     * instead of generating it again. Output is only reused when the section was requested without
+     * section-specific options. Defaults to 'serverStatusExpensiveSectionCacheMillis' for
+     * expensive sections and to zero, meaning never, for cheap ones.
+     */
+    virtual Milliseconds cacheTTL() const;
+
     /**
      * Adds the privileges that are required to view this section
      * TODO: Remove this empty default implementation and implement for every section.
@@ -103,8 +123,31 @@ public:
         result->append(getSectionName(), ret);
     }
 
+    /**
+     * Appends this section to 'result' as appendSection() does, but reuses output generated within
+     * the last cacheTTL() when possible. Records how long generation took.
+     */
+    void appendSectionCached(OperationContext* opCtx,
+                             const BSONElement& configElement,
+                             BSONObjBuilder* result);
+
+    /**
+     * Appends statistics about how often and for how long this section was generated.
+     */
+    void appendGenerationStats(BSONObjBuilder* builder) const;
+
 private:
     const std::string _sectionName;
+
+    // The output of the last generation of this section, and when it was generated.
+    stdx::mutex _cacheMutex;
+    BSONObj _cachedOutput;
+    Date_t _cachedAt;
+
+    AtomicWord<long long> _numGenerated{0};
+    AtomicWord<long long> _numCacheHits{0};
+    AtomicWord<long long> _totalGenerationMicros{0};
+    AtomicWord<long long> _lastGenerationMicros{0};
 };
 
 class OpCounterServerStatusSection : public ServerStatusSection {
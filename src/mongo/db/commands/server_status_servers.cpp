@@ -31,6 +31,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/client/native_sasl_client_session.h"
 #include "mongo/config.h"
 #include "mongo/db/commands/server_status.h"
 #include "mongo/transport/message_compressor_registry.h"
@@ -116,6 +117,22 @@ public:
 } security;
 #endif
 
+class SCRAMClientCacheServerStatus final : public ServerStatusSection {
+public:
+    SCRAMClientCacheServerStatus() : ServerStatusSection("scramClientCache") {}
+
+    bool includeByDefault() const override {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder builder;
+        NativeSaslClientSession::appendSCRAMClientCacheStats(&builder);
+        return builder.obj();
+    }
+} scramClientCacheServerStatus;
+
 class AdvisoryHostFQDNs final : public ServerStatusSection {
 public:
     AdvisoryHostFQDNs() : ServerStatusSection("advisoryHostFQDNs") {}
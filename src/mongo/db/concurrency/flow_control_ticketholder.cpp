@@ -33,7 +33,11 @@
 
 #include "mongo/db/concurrency/flow_control_ticketholder.h"
 
+#include <algorithm>
+
+#include "mongo/db/client.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/rpc/metadata/client_metadata_ismaster.h"
 #include "mongo/util/log.h"
 #include "mongo/util/time_support.h"
 
@@ -41,6 +45,16 @@ namespace mongo {
 namespace {
 const auto getFlowControlTicketholder =
     ServiceContext::declareDecoration<std::unique_ptr<FlowControlTicketholder>>();
+
+/**
+ * Returns the application name the client sent in its metadata, or the empty string for clients
+ * that did not send one. Those are accounted together.
+ */
+std::string getClientTag(OperationContext* opCtx) {
+    const auto& metadata =
+        ClientMetadataIsMasterState::get(opCtx->getClient()).getClientMetadata();
+    return metadata ? metadata->getApplicationName().toString() : "";
+}
 }  // namespace
 
 void FlowControlTicketholder::CurOp::writeToBuilder(BSONObjBuilder& infoBuilder) {
@@ -57,6 +71,10 @@ void FlowControlTicketholder::CurOp::writeToBuilder(BSONObjBuilder& infoBuilder)
     if (timeAcquiringMicros) {
         flowControl.append("timeAcquiringMicros", timeAcquiringMicros);
     }
+
+    if (shareExhaustedWaitCount) {
+        flowControl.append("shareExhaustedWaitCount", shareExhaustedWaitCount);
+    }
     flowControl.done();
 }
 
@@ -78,23 +96,48 @@ void FlowControlTicketholder::set(ServiceContext* service,
     globalFlow = std::move(flowControl);
 }
 
-void FlowControlTicketholder::refreshTo(int numTickets) {
+void FlowControlTicketholder::refreshTo(int numTickets, bool shareByClient) {
     invariant(numTickets >= 0);
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     LOG(4) << "Refreshing tickets. Before: " << _tickets << " Now: " << numTickets;
     _tickets = numTickets;
+    _periodTickets = numTickets;
+    _shareByClient = shareByClient;
+    _lastPeriodTicketsByClient.clear();
+    _lastPeriodTicketsByClient.swap(_ticketsByClient);
     _cv.notify_all();
 }
 
+long long FlowControlTicketholder::_clientShare() const {
+    // Clients that took tickets last period are expected to want them again this period, so they
+    // count towards the split even before they take their first ticket.
+    const long long numClients = std::max<size_t>(
+        1, std::max(_ticketsByClient.size(), _lastPeriodTicketsByClient.size()));
+    return (_periodTickets + numClients - 1) / numClients;
+}
+
 void FlowControlTicketholder::getTicket(OperationContext* opCtx,
                                         FlowControlTicketholder::CurOp* stats) {
+    const std::string clientTag = getClientTag(opCtx);
     stdx::unique_lock<stdx::mutex> lk(_mutex);
     LOG(4) << "Taking ticket. Available: " << _tickets;
-    if (_tickets == 0) {
+
+    auto shareExhausted = [&] {
+        if (!_shareByClient) {
+            return false;
+        }
+        auto it = _ticketsByClient.find(clientTag);
+        return it != _ticketsByClient.end() && it->second >= _clientShare();
+    };
+
+    if (_tickets == 0 || shareExhausted()) {
         ++stats->acquireWaitCount;
+        if (_tickets > 0) {
+            ++stats->shareExhaustedWaitCount;
+        }
     }
 
-    while (_tickets == 0) {
+    while (_tickets == 0 || shareExhausted()) {
         stats->waiting = true;
         const std::uint64_t startWaitTime = curTimeMicros64();
 
@@ -120,6 +163,22 @@ void FlowControlTicketholder::getTicket(OperationContext* opCtx,
     ++stats->ticketsAcquired;
 
     --_tickets;
+    if (_shareByClient) {
+        ++_ticketsByClient[clientTag];
+    }
+}
+
+void FlowControlTicketholder::appendClientShares(BSONObjBuilder* builder) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_shareByClient) {
+        return;
+    }
+
+    builder->append("clientShare", _clientShare());
+    BSONObjBuilder clients(builder->subobjStart("ticketsByClient"));
+    for (const auto& entry : _lastPeriodTicketsByClient) {
+        clients.append(entry.first.empty() ? "<none>" : entry.first, entry.second);
+    }
 }
 
 }  // namespace mongo
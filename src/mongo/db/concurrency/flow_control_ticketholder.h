@@ -33,6 +33,7 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -50,6 +51,11 @@ class ServiceContext;
  * is an external service that calculates the maximum number of tickets that should be allotted for
  * the next time period (one second). The consumers will call `getTicket` and the producer will call
  * `refreshTo`.
+ *
+ * When refreshed with `shareByClient`, each period's tickets are also divided evenly between the
+ * clients (identified by the application name in their client metadata) that are taking them. A
+ * client that has used up its share waits for the next period even if tickets remain, so the
+ * writers generating the most load absorb the throttling instead of every writer equally.
  */
 class FlowControlTicketholder {
 public:
@@ -61,6 +67,8 @@ public:
         long long ticketsAcquired = 0;
         long long acquireWaitCount = 0;
         long long timeAcquiringMicros = 0;
+        // Number of acquisitions that waited because the client had used up its share.
+        long long shareExhaustedWaitCount = 0;
 
         /**
          * Create a sub-object "flowControlStats" on the input builder and write in the structure's
@@ -79,7 +87,7 @@ public:
 
     static void set(ServiceContext* service, std::unique_ptr<FlowControlTicketholder> flowControl);
 
-    void refreshTo(int numTickets);
+    void refreshTo(int numTickets, bool shareByClient = false);
 
     void getTicket(OperationContext* opCtx, FlowControlTicketholder::CurOp* stats);
 
@@ -87,13 +95,30 @@ public:
         return _totalTimeAcquiringMicros.load();
     }
 
+    /**
+     * Appends the number of tickets each client took in the last complete period, along with the
+     * per-client share in effect, to 'builder'. Appends nothing unless sharing by client.
+     */
+    void appendClientShares(BSONObjBuilder* builder);
+
 private:
+    /**
+     * Returns how many tickets a single client may take in the current period. Requires '_mutex'.
+     */
+    long long _clientShare() const;
+
     // Use an int64_t as this is serialized to bson which does not support unsigned 64-bit numbers.
     AtomicWord<std::int64_t> _totalTimeAcquiringMicros;
 
     stdx::mutex _mutex;
     stdx::condition_variable _cv;
     int _tickets;
+
+    bool _shareByClient = false;
+    int _periodTickets = 0;
+    // Tickets taken by each client in the current and the last complete period.
+    StringMap<long long> _ticketsByClient;
+    StringMap<long long> _lastPeriodTicketsByClient;
 };
 
 }  // namespace mongo
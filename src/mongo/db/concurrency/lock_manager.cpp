@@ -33,6 +33,8 @@
 
 #include "mongo/db/concurrency/lock_manager.h"
 
+#include <array>
+
 #include "mongo/base/data_type_endian.h"
 #include "mongo/base/data_view.h"
 #include "mongo/base/static_assert.h"
@@ -40,6 +42,7 @@
 #include "mongo/config.h"
 #include "mongo/db/catalog/uuid_catalog.h"
 #include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/concurrency/lock_manager_gen.h"
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
@@ -109,8 +112,84 @@ static const char* LockRequestStatusNames[] = {
 MONGO_STATIC_ASSERT((sizeof(LockRequestStatusNames) / sizeof(LockRequestStatusNames[0])) ==
                     LockRequest::StatusCount);
 
+// Layout of a fast path stripe's state: the number of MODE_IS holders in the low bits, the number
+// of MODE_IX holders above them, and the number of diverting requests in the high bits.
+const int kFastPathCountBits = 24;
+const uint64_t kFastPathCountMask = (1ULL << kFastPathCountBits) - 1;
+const uint64_t kFastPathDivertUnit = 1ULL << (2 * kFastPathCountBits);
+
+bool isIntentMode(LockMode mode) {
+    return (modeMask(mode) & intentModes) != 0;
+}
+
+int fastPathShift(LockMode mode) {
+    invariant(isIntentMode(mode));
+    return mode == MODE_IS ? 0 : kFastPathCountBits;
+}
+
+uint64_t fastPathCount(uint64_t state, LockMode mode) {
+    return (state >> fastPathShift(mode)) & kFastPathCountMask;
+}
+
 }  // namespace
 
+/**
+ * Every operation locks the global resources in MODE_IS or MODE_IX, so with enough threads even
+ * the partition mutexes of their PartitionedLockHeads are contended. While no request in another
+ * mode is pending or granted on a global resource, intent requests on it are instead granted by
+ * incrementing a counter in its FastPathSlot, which is striped by locker to spread the cache line
+ * traffic.
+ *
+ * A request in any other mode first diverts the slot by incrementing the divert count of every
+ * stripe. From then on new intent requests take the regular path and the fast path counts can
+ * only go down. The fast path holders are accounted as granted modes of the resource's LockHead
+ * until they drain, at which point the last holder of each stripe grants the waiting requests.
+ *
+ * The counts are anonymous, so a slot must belong to exactly one resource: a conflicting request
+ * that waited on the holders of an unrelated resource could deadlock.
+ */
+struct FastPathSlot {
+    static const unsigned kNumStripes = 8;
+
+    struct alignas(64) Stripe {
+        AtomicWord<uint64_t> state{0};
+    };
+
+    Stripe& stripeFor(const LockRequest* request) {
+        return stripes[request->locker->getId() % kNumStripes];
+    }
+
+    /**
+     * Bit-mask of the modes held through the fast path.
+     */
+    uint32_t grantedModes() const {
+        uint32_t modes = 0;
+        for (const auto& stripe : stripes) {
+            const uint64_t state = stripe.state.load();
+            if (fastPathCount(state, MODE_IS))
+                modes |= modeMask(MODE_IS);
+            if (fastPathCount(state, MODE_IX))
+                modes |= modeMask(MODE_IX);
+        }
+        return modes;
+    }
+
+    void divert() {
+        for (auto& stripe : stripes) {
+            stripe.state.fetchAndAdd(kFastPathDivertUnit);
+        }
+    }
+
+    void undivert() {
+        for (auto& stripe : stripes) {
+            stripe.state.subtractAndFetch(kFastPathDivertUnit);
+        }
+    }
+
+    ResourceId resourceId;
+    std::array<Stripe, kNumStripes> stripes;
+};
+
 /**
  * There is one of these objects for each resource that has a lock request. Empty objects (i.e.
  * LockHead with no requests) are allowed to exist on the lock manager's hash table.
@@ -126,8 +205,9 @@ struct LockHead {
      * Used for initialization of a LockHead, which might have been retrieved from cache and also in
      * order to keep the LockHead structure a POD.
      */
-    void initNew(ResourceId resId) {
+    void initNew(ResourceId resId, FastPathSlot* slot) {
         resourceId = resId;
+        fastPathSlot = slot;
 
         grantedList.reset();
         memset(grantedCounts, 0, sizeof(grantedCounts));
@@ -148,6 +228,13 @@ struct LockHead {
         return !partitions.empty();
     }
 
+    /**
+     * Bit-mask of the granted modes, including those held through the fast path.
+     */
+    uint32_t allGrantedModes() const {
+        return fastPathSlot ? grantedModes | fastPathSlot->grantedModes() : grantedModes;
+    }
+
     /**
      * Locates the request corresponding to the particular locker or returns nullptr. Must be called
      * with the bucket holding this lock head locked.
@@ -184,7 +271,7 @@ struct LockHead {
 
         // New lock request. Queue after all granted modes and after any already requested
         // conflicting modes
-        if (conflicts(request->mode, grantedModes) ||
+        if (conflicts(request->mode, allGrantedModes()) ||
             (!compatibleFirstCount && conflicts(request->mode, conflictModes))) {
             request->status = LockRequest::STATUS_WAITING;
 
@@ -291,6 +378,10 @@ struct LockHead {
     // conflictCounts array.
     uint32_t conflictModes;
 
+    // The fast path slot of this resource, or nullptr if it has none. Its holders are granted
+    // requests of this resource that are not on the granted queue.
+    FastPathSlot* fastPathSlot;
+
     // References partitions that may have PartitionedLockHeads for this LockHead.
     // Non-empty implies the lock has no conflicts and only has intent modes as grantedModes.
     // TODO: Remove this vector and make LockHead a POD
@@ -397,9 +488,16 @@ const unsigned LockManager::_numLockBuckets(128);
 // The exact value doesn't appear very important, but should be power of two
 const unsigned LockManager::_numPartitions = 32;
 
+// One slot for each of the global resources, indexed by their hash id.
+const unsigned LockManager::_numFastPathSlots = ResourceId::SINGLETON_GLOBAL + 1;
+
 LockManager::LockManager() {
     _lockBuckets = new LockBucket[_numLockBuckets];
     _partitions = new Partition[_numPartitions];
+    _fastPathSlots = new FastPathSlot[_numFastPathSlots];
+    for (unsigned i = 0; i < _numFastPathSlots; i++) {
+        _fastPathSlots[i].resourceId = ResourceId(RESOURCE_GLOBAL, i);
+    }
 }
 
 LockManager::~LockManager() {
@@ -410,8 +508,15 @@ LockManager::~LockManager() {
         invariant(_lockBuckets[i].data.empty());
     }
 
+    for (unsigned i = 0; i < _numFastPathSlots; i++) {
+        for (const auto& stripe : _fastPathSlots[i].stripes) {
+            invariant(stripe.state.load() == 0);
+        }
+    }
+
     delete[] _lockBuckets;
     delete[] _partitions;
+    delete[] _fastPathSlots;
 }
 
 LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mode) {
@@ -422,6 +527,13 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
     request->partitioned = (mode == MODE_IX || mode == MODE_IS);
     request->mode = mode;
 
+    // Fastest path for intent locks on the global resources
+    FastPathSlot* fastPathSlot = _getFastPathSlot(resId);
+    if (fastPathSlot && request->partitioned && gLockManagerIntentFastPath.load() &&
+        _tryLockFastPath(fastPathSlot, request)) {
+        return LOCK_OK;
+    }
+
     // For intent modes, try the PartitionedLockHead
     if (request->partitioned) {
         Partition* partition = _getPartition(request);
@@ -443,7 +555,7 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
     LockBucket* bucket = _getBucket(resId);
     stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
 
-    LockHead* lock = bucket->findOrInsert(resId);
+    LockHead* lock = bucket->findOrInsert(resId, fastPathSlot);
 
     // Start a partitioned lock if possible
     if (request->partitioned && !(lock->grantedModes & (~intentModes)) && !lock->conflictModes) {
@@ -462,7 +574,19 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
     }
 
     request->partitioned = false;
-    return lock->newRequest(request);
+
+    // Keep new intent requests off the fast path while this request is pending or granted. This
+    // must happen before newRequest() looks at the modes held through the fast path.
+    if (fastPathSlot && !isIntentMode(mode)) {
+        fastPathSlot->divert();
+        request->divertsFastPath = true;
+    }
+
+    const LockResult result = lock->newRequest(request);
+    if (result == LOCK_WAITING) {
+        _numConflictingRequests.fetchAndAdd(1);
+    }
+    return result;
 }
 
 LockResult LockManager::convert(ResourceId resId, LockRequest* request, LockMode newMode) {
@@ -488,6 +612,10 @@ LockResult LockManager::convert(ResourceId resId, LockRequest* request, LockMode
     invariant((LockConflictsTable[request->mode] | LockConflictsTable[newMode]) ==
               LockConflictsTable[newMode]);
 
+    if (request->fastPathSlot) {
+        _moveFromFastPath(resId, request);
+    }
+
     LockBucket* bucket = _getBucket(resId);
     stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
 
@@ -500,6 +628,11 @@ LockResult LockManager::convert(ResourceId resId, LockRequest* request, LockMode
         lock->migratePartitionedLockHeads();
     }
 
+    if (lock->fastPathSlot && !isIntentMode(newMode) && !request->divertsFastPath) {
+        lock->fastPathSlot->divert();
+        request->divertsFastPath = true;
+    }
+
     // Construct granted mask without our current mode, so that it is not counted as
     // conflicting
     uint32_t grantedModesWithoutCurrentRequest = 0;
@@ -514,6 +647,10 @@ LockResult LockManager::convert(ResourceId resId, LockRequest* request, LockMode
         }
     }
 
+    if (lock->fastPathSlot) {
+        grantedModesWithoutCurrentRequest |= lock->fastPathSlot->grantedModes();
+    }
+
     // This check favours conversion requests over pending requests. For example:
     //
     // T1 requests lock L in IS
@@ -529,6 +666,7 @@ LockResult LockManager::convert(ResourceId resId, LockRequest* request, LockMode
         lock->conversionsCount++;
         lock->incGrantedModeCount(request->convertMode);
 
+        _numConflictingRequests.fetchAndAdd(1);
         return LOCK_WAITING;
     } else {  // No conflict, existing request
         lock->incGrantedModeCount(newMode);
@@ -550,6 +688,12 @@ bool LockManager::unlock(LockRequest* request) {
         return false;
     }
 
+    if (request->fastPathSlot) {
+        invariant(request->status == LockRequest::STATUS_GRANTED);
+        _unlockFastPath(request);
+        return true;
+    }
+
     if (request->partitioned) {
         // Unlocking a lock that was acquired as partitioned. The lock request may since have
         // moved to the lock head, but there is no safe way to find out without synchronizing
@@ -587,6 +731,11 @@ bool LockManager::unlock(LockRequest* request) {
             invariant(lock->compatibleFirstCount == 0 || !lock->grantedList.empty());
         }
 
+        if (request->divertsFastPath) {
+            lock->fastPathSlot->undivert();
+            request->divertsFastPath = false;
+        }
+
         _onLockModeChanged(lock, lock->grantedCounts[request->mode] == 0);
     } else if (request->status == LockRequest::STATUS_WAITING) {
         // This cancels a pending lock request
@@ -595,6 +744,11 @@ bool LockManager::unlock(LockRequest* request) {
         lock->conflictList.remove(request);
         lock->decConflictModeCount(request->mode);
 
+        if (request->divertsFastPath) {
+            lock->fastPathSlot->undivert();
+            request->divertsFastPath = false;
+        }
+
         _onLockModeChanged(lock, true);
     } else if (request->status == LockRequest::STATUS_CONVERTING) {
         // This cancels a pending convert request
@@ -620,7 +774,6 @@ bool LockManager::unlock(LockRequest* request) {
 }
 
 void LockManager::downgrade(LockRequest* request, LockMode newMode) {
-    invariant(request->lock);
     invariant(request->status == LockRequest::STATUS_GRANTED);
     invariant(request->recursiveCount > 0);
 
@@ -629,6 +782,24 @@ void LockManager::downgrade(LockRequest* request, LockMode newMode) {
     invariant((LockConflictsTable[request->mode] | LockConflictsTable[newMode]) ==
               LockConflictsTable[request->mode]);
 
+    if (request->fastPathSlot) {
+        // Only MODE_IX -> MODE_IS is possible here. Count the new mode before dropping the old
+        // one, so that the request is never missing from the counts.
+        FastPathSlot* slot = request->fastPathSlot;
+        auto& state = slot->stripeFor(request).state;
+        state.fetchAndAdd(1ULL << fastPathShift(newMode));
+        const uint64_t newState = state.subtractAndFetch(1ULL << fastPathShift(request->mode));
+        const bool drained =
+            newState >= kFastPathDivertUnit && fastPathCount(newState, request->mode) == 0;
+        request->mode = newMode;
+        if (drained) {
+            _onFastPathDrained(slot);
+        }
+        return;
+    }
+
+    invariant(request->lock);
+
     LockHead* lock = request->lock;
 
     LockBucket* bucket = _getBucket(lock->resourceId);
@@ -659,7 +830,8 @@ void LockManager::_cleanupUnusedLocksInBucket(LockBucket* bucket) {
             lock->migratePartitionedLockHeads();
         }
 
-        if (lock->grantedModes == 0) {
+        // A request may be waiting only on the fast path holders of the resource.
+        if (lock->grantedModes == 0 && !(lock->fastPathSlot && lock->conflictModes)) {
             invariant(lock->grantedModes == 0);
             invariant(lock->grantedList._front == nullptr);
             invariant(lock->grantedList._back == nullptr);
@@ -709,6 +881,10 @@ void LockManager::_onLockModeChanged(LockHead* lock, bool checkConflictQueue) {
                 }
             }
 
+            if (lock->fastPathSlot) {
+                grantedModesWithoutCurrentRequest |= lock->fastPathSlot->grantedModes();
+            }
+
             if (!conflicts(iter->convertMode, grantedModesWithoutCurrentRequest)) {
                 lock->conversionsCount--;
                 lock->decGrantedModeCount(iter->mode);
@@ -748,7 +924,7 @@ void LockManager::_onLockModeChanged(LockHead* lock, bool checkConflictQueue) {
         // the granted queue.
         iterNext = iter->next;
 
-        if (conflicts(iter->mode, lock->grantedModes)) {
+        if (conflicts(iter->mode, lock->allGrantedModes())) {
             // If iter doesn't have a previous pointer, this means that it is at the front of the
             // queue. If we continue scanning the queue beyond this point, we will starve it by
             // granting more and more requests. However, if we newly transition to compatibleFirst
@@ -796,6 +972,70 @@ LockManager::Partition* LockManager::_getPartition(LockRequest* request) const {
     return &_partitions[request->locker->getId() % _numPartitions];
 }
 
+FastPathSlot* LockManager::_getFastPathSlot(ResourceId resId) const {
+    if (resId.getType() != RESOURCE_GLOBAL || resId.getHashId() >= _numFastPathSlots) {
+        return nullptr;
+    }
+    return &_fastPathSlots[resId.getHashId()];
+}
+
+bool LockManager::_tryLockFastPath(FastPathSlot* slot, LockRequest* request) {
+    auto& state = slot->stripeFor(request).state;
+    const uint64_t increment = 1ULL << fastPathShift(request->mode);
+
+    uint64_t current = state.load();
+    while (current < kFastPathDivertUnit) {
+        const uint64_t observed = state.compareAndSwap(current, current + increment);
+        if (observed == current) {
+            request->fastPathSlot = slot;
+            request->partitioned = false;
+            request->status = LockRequest::STATUS_GRANTED;
+            return true;
+        }
+        current = observed;
+    }
+    return false;
+}
+
+void LockManager::_unlockFastPath(LockRequest* request) {
+    FastPathSlot* slot = request->fastPathSlot;
+    request->fastPathSlot = nullptr;
+
+    const uint64_t state =
+        slot->stripeFor(request).state.subtractAndFetch(1ULL << fastPathShift(request->mode));
+    if (state >= kFastPathDivertUnit && fastPathCount(state, request->mode) == 0) {
+        _onFastPathDrained(slot);
+    }
+}
+
+void LockManager::_moveFromFastPath(ResourceId resId, LockRequest* request) {
+    FastPathSlot* slot = request->fastPathSlot;
+    LockBucket* bucket = _getBucket(resId);
+    stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
+
+    // The request is already granted, so it goes straight onto the granted queue, ahead of any
+    // conflicting request waiting for the fast path to drain. It is counted on the queue before it
+    // leaves the fast path, so it is never missing from the granted modes. Since it still holds
+    // the resource, there is nothing to grant even if the fast path drains.
+    LockHead* lock = bucket->findOrInsert(resId, slot);
+    request->lock = lock;
+    lock->grantedList.push_back(request);
+    lock->incGrantedModeCount(request->mode);
+
+    request->fastPathSlot = nullptr;
+    slot->stripeFor(request).state.subtractAndFetch(1ULL << fastPathShift(request->mode));
+}
+
+void LockManager::_onFastPathDrained(FastPathSlot* slot) {
+    LockBucket* bucket = _getBucket(slot->resourceId);
+    stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
+
+    LockBucket::Map::iterator it = bucket->data.find(slot->resourceId);
+    if (it != bucket->data.end()) {
+        _onLockModeChanged(it->second, true);
+    }
+}
+
 void LockManager::dump() const {
     log() << "Dumping LockManager @ " << static_cast<const void*>(this) << '\n';
 
@@ -940,12 +1180,12 @@ PartitionedLockHead* LockManager::Partition::findOrInsert(ResourceId resId) {
     return lock;
 }
 
-LockHead* LockManager::LockBucket::findOrInsert(ResourceId resId) {
+LockHead* LockManager::LockBucket::findOrInsert(ResourceId resId, FastPathSlot* fastPathSlot) {
     LockHead* lock;
     Map::iterator it = data.find(resId);
     if (it == data.end()) {
         lock = new LockHead();
-        lock->initNew(resId);
+        lock->initNew(resId, fastPathSlot);
 
         data.insert(Map::value_type(resId, lock));
     } else {
@@ -992,6 +1232,8 @@ void LockRequest::initNew(Locker* locker, LockGrantNotification* notify) {
 
     lock = nullptr;
     partitionedLock = nullptr;
+    fastPathSlot = nullptr;
+    divertsFastPath = false;
     prev = nullptr;
     next = nullptr;
     status = STATUS_NEW;
@@ -114,6 +114,15 @@ public:
      */
     void downgrade(LockRequest* request, LockMode newMode);
 
+    /**
+     * Returns the number of lock and conversion requests which have so far had to wait behind a
+     * conflicting granted request. Lock holders can compare two readings to learn whether anyone
+     * may have started waiting on them in between, without visiting any lock heads.
+     */
+    unsigned long long getNumConflictingRequests() const {
+        return _numConflictingRequests.load();
+    }
+
     /**
      * Iterates through all buckets and deletes all locks, which have no requests on them. This
      * call is kind of expensive and should only be used for reducing the memory footprint of
@@ -143,7 +152,7 @@ private:
         SimpleMutex mutex;
         typedef stdx::unordered_map<ResourceId, LockHead*> Map;
         Map data;
-        LockHead* findOrInsert(ResourceId resId);
+        LockHead* findOrInsert(ResourceId resId, FastPathSlot* fastPathSlot);
     };
 
     // Each locker maps to a partition that is used for resources acquired in intent modes
@@ -169,6 +178,35 @@ private:
      */
     Partition* _getPartition(LockRequest* request) const;
 
+    /**
+     * Retrieves the fast path slot for intent requests on the particular resource, or nullptr if
+     * the resource has none. Only the global resources have one.
+     */
+    FastPathSlot* _getFastPathSlot(ResourceId resId) const;
+
+    /**
+     * Grants an intent mode request by incrementing its fast path slot's counter. Returns false,
+     * leaving the request untouched, if a request in another mode is pending or granted.
+     */
+    bool _tryLockFastPath(FastPathSlot* slot, LockRequest* request);
+
+    /**
+     * Releases a request granted through the fast path.
+     */
+    void _unlockFastPath(LockRequest* request);
+
+    /**
+     * Moves a request granted through the fast path onto the granted queue of its LockHead, so
+     * that it can be converted.
+     */
+    void _moveFromFastPath(ResourceId resId, LockRequest* request);
+
+    /**
+     * Called after the fast path holders of a mode on a diverted slot may have drained, to grant
+     * the requests waiting for them. Must not be called with any bucket mutex held.
+     */
+    void _onFastPathDrained(FastPathSlot* slot);
+
     /**
      * Prints the contents of a bucket to the log.
      */
@@ -215,5 +253,10 @@ private:
 
     static const unsigned _numPartitions;
     Partition* _partitions;
+
+    static const unsigned _numFastPathSlots;
+    FastPathSlot* _fastPathSlots;
+
+    AtomicWord<unsigned long long> _numConflictingRequests{0};
 };
 }  // namespace mongo
@@ -46,6 +46,7 @@ namespace mongo {
 
 class Locker;
 
+struct FastPathSlot;
 struct LockHead;
 struct PartitionedLockHead;
 
@@ -434,6 +435,23 @@ struct LockRequest {
     // Protected by LockHead bucket's mutex
     PartitionedLockHead* partitionedLock;
 
+    // Pointer to the fast path slot whose counter this request incremented to be granted, or null
+    // if the request went through a LockHead or a PartitionedLockHead. A request can only
+    // transition from 'fastPathSlot' to 'lock', when it is converted.
+    //
+    // Written by LockManager on Locker thread
+    // Read by LockManager on Locker thread
+    // No synchronization
+    FastPathSlot* fastPathSlot;
+
+    // Set while this request, in a mode other than MODE_IS or MODE_IX, keeps intent requests on
+    // its resource off the fast path.
+    //
+    // Written by LockManager on Locker thread
+    // Read by LockManager on Locker thread
+    // No synchronization
+    bool divertsFastPath;
+
     // The linked list chain on which this request hangs off the owning lock head. The reason
     // intrusive linked list is used instead of the std::list class is to allow for entries to be
     // removed from the middle of the list in O(1) time, if they are known instead of having to
@@ -28,6 +28,7 @@
  */
 
 #include "mongo/db/concurrency/lock_manager_defs.h"
+#include "mongo/db/concurrency/lock_manager_gen.h"
 #include "mongo/db/concurrency/lock_manager_test_help.h"
 #include "mongo/unittest/unittest.h"
 
@@ -952,4 +953,96 @@ TEST(LockManager, Fairness) {
     ASSERT(lockMgr.unlock(&requestIX1));
 }
 
+/**
+ * Enables the intent lock fast path for the lifetime of the object.
+ */
+class EnableIntentFastPath {
+public:
+    EnableIntentFastPath() : _previous(gLockManagerIntentFastPath.swap(true)) {}
+    ~EnableIntentFastPath() {
+        gLockManagerIntentFastPath.store(_previous);
+    }
+
+private:
+    const bool _previous;
+};
+
+TEST(LockManager, IntentFastPathConflictWaitsForHolders) {
+    EnableIntentFastPath enableFastPath;
+    LockManager lockMgr;
+
+    LockerImpl lockerIX;
+    LockRequestCombo requestIX(&lockerIX);
+    ASSERT(LOCK_OK == lockMgr.lock(resourceIdGlobal, &requestIX, MODE_IX));
+    ASSERT(requestIX.fastPathSlot);
+
+    // A conflicting request waits for the fast path holder
+    LockerImpl lockerX;
+    LockRequestCombo requestX(&lockerX);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resourceIdGlobal, &requestX, MODE_X));
+
+    // Intent requests no longer take the fast path and queue behind it
+    LockerImpl lockerIS;
+    LockRequestCombo requestIS(&lockerIS);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resourceIdGlobal, &requestIS, MODE_IS));
+    ASSERT(!requestIS.fastPathSlot);
+
+    // Draining the fast path grants the X lock
+    ASSERT(lockMgr.unlock(&requestIX));
+    ASSERT_EQ(LOCK_OK, requestX.lastResult);
+    ASSERT_EQ(1, requestX.numNotifies);
+    ASSERT_EQ(0, requestIS.numNotifies);
+
+    ASSERT(lockMgr.unlock(&requestX));
+    ASSERT_EQ(LOCK_OK, requestIS.lastResult);
+    ASSERT_EQ(1, requestIS.numNotifies);
+    ASSERT(lockMgr.unlock(&requestIS));
+
+    // Once no conflicting request is left, intent requests take the fast path again
+    LockRequestCombo requestIX1(&lockerIX);
+    ASSERT(LOCK_OK == lockMgr.lock(resourceIdGlobal, &requestIX1, MODE_IX));
+    ASSERT(requestIX1.fastPathSlot);
+    ASSERT(lockMgr.unlock(&requestIX1));
+}
+
+TEST(LockManager, IntentFastPathConversion) {
+    EnableIntentFastPath enableFastPath;
+    LockManager lockMgr;
+
+    LockerImpl locker1;
+    LockRequestCombo request1(&locker1);
+    ASSERT(LOCK_OK == lockMgr.lock(resourceIdGlobal, &request1, MODE_IS));
+    ASSERT(request1.fastPathSlot);
+
+    LockerImpl locker2;
+    LockRequestCombo request2(&locker2);
+    ASSERT(LOCK_OK == lockMgr.lock(resourceIdGlobal, &request2, MODE_IX));
+    ASSERT(request2.fastPathSlot);
+
+    // The conversion leaves the fast path and waits for the other holder's IX to drain
+    ASSERT(LOCK_WAITING == lockMgr.convert(resourceIdGlobal, &request1, MODE_S));
+    ASSERT(!request1.fastPathSlot);
+    ASSERT_EQ(0, request1.numNotifies);
+
+    ASSERT(lockMgr.unlock(&request2));
+    ASSERT_EQ(LOCK_OK, request1.lastResult);
+    ASSERT_EQ(1, request1.numNotifies);
+    ASSERT(request1.mode == MODE_S);
+
+    ASSERT_FALSE(lockMgr.unlock(&request1));
+    ASSERT(lockMgr.unlock(&request1));
+}
+
+TEST(LockManager, IntentFastPathOnlyForGlobalResources) {
+    EnableIntentFastPath enableFastPath;
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
+
+    LockerImpl locker;
+    LockRequestCombo request(&locker);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request, MODE_IX));
+    ASSERT(!request.fastPathSlot);
+    ASSERT(lockMgr.unlock(&request));
+}
+
 }  // namespace mongo
@@ -335,11 +335,13 @@ bool LockerImpl::_acquireTicket(OperationContext* opCtx, LockMode mode, Date_t d
         auto restoreStateOnErrorGuard = makeGuard([&] { _clientState.store(kInactive); });
 
         OperationContext* interruptible = _uninterruptibleLocksRequested ? nullptr : opCtx;
-        if (deadline == Date_t::max()) {
-            holder->waitForTicket(interruptible);
-        } else if (!holder->waitForTicketUntil(interruptible, deadline)) {
+        const auto priority =
+            opCtx ? TicketHolder::getAdmissionPriority(opCtx) : AdmissionPriority::kNormal;
+        // Any ticket after the first is being reacquired after yielding.
+        if (!holder->waitForTicketUntil(interruptible, deadline, priority, _hasAcquiredTicket)) {
             return false;
         }
+        _hasAcquiredTicket = true;
         restoreStateOnErrorGuard.dismiss();
     }
     _clientState.store(reader ? kActiveReader : kActiveWriter);
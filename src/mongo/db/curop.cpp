@@ -44,9 +44,14 @@
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/locker.h"
+#include "mongo/db/curop_gen.h"
 #include "mongo/db/json.h"
+#include "mongo/db/operation_memory_tracker.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/slow_op_event_buffer.h"
+#include "mongo/db/slow_op_event_buffer_gen.h"
+#include "mongo/db/stats/query_shape_stats.h"
 #include "mongo/rpc/metadata/client_metadata.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
 #include "mongo/rpc/metadata/impersonated_user_metadata.h"
@@ -293,6 +298,10 @@ void CurOp::reportCurrentOpForClient(OperationContext* opCtx,
         }
 
         CurOp::get(clientOpCtx)->reportState(infoBuilder, truncateOps);
+
+        if (const auto memBytes = OperationMemoryTracker::get(clientOpCtx)->currentBytes()) {
+            infoBuilder->append("trackedMemBytes", memBytes);
+        }
     }
 }
 
@@ -359,12 +368,16 @@ ProgressMeter& CurOp::setProgress_inlock(StringData message,
 }
 
 void CurOp::setNS_inlock(StringData ns) {
-    _ns = ns.toString();
+    // Assign in place, so that the buffer already allocated for '_ns' is reused.
+    _ns.assign(ns.rawData(), ns.size());
 }
 
 void CurOp::ensureStarted() {
     if (_start == 0) {
         _start = curTimeMicros64();
+        if (gOperationHardwareCounters.load()) {
+            _hardwareCountersStart = ThreadHardwareCounters::read();
+        }
     }
 }
 
@@ -400,10 +413,49 @@ bool CurOp::completeAndLogOperation(OperationContext* opCtx,
     _end = curTimeMicros64();
     _debug.executionTimeMicros = durationCount<Microseconds>(elapsedTimeExcludingPauses());
 
+    if (const auto peakMemBytes = OperationMemoryTracker::get(opCtx)->peakBytes()) {
+        _debug.peakTrackedMemBytes = peakMemBytes;
+    }
+
+    if (_hardwareCountersStart) {
+        if (const auto hardwareCountersEnd = ThreadHardwareCounters::read()) {
+            _debug.hardwareCounters = *hardwareCountersEnd - *_hardwareCountersStart;
+        }
+    }
+
+    if (_debug.queryHash && QueryShapeStats::isEnabled()) {
+        QueryShapeStats::Observation observation;
+        observation.docsExamined = _debug.additiveMetrics.docsExamined.value_or(0);
+        observation.keysExamined = _debug.additiveMetrics.keysExamined.value_or(0);
+        observation.nreturned = std::max(_debug.nreturned, 0LL);
+        observation.bytesReturned = std::max(_debug.responseLength, 0);
+        QueryShapeStats::get(opCtx->getServiceContext())
+            .record(getNS(),
+                    *_debug.queryHash,
+                    _debug.executionTimeMicros,
+                    getReadWriteType(),
+                    observation);
+    }
+
     const bool shouldSample =
         client->getPrng().nextCanonicalDouble() < serverGlobalParams.sampleRate;
+    const bool isSlow = _debug.executionTimeMicros > slowMs * 1000LL;
+
+    // Slow operations may be recorded as structured events in addition to, or instead of, being
+    // formatted into the log.
+    bool shouldLogSlowOp = shouldSample && isSlow;
+    auto slowOpEvents = SlowOpEventBuffer::get(opCtx->getServiceContext());
+    if (isSlow && slowOpEvents && slowOpEvents->isEnabled() &&
+        client->getPrng().nextCanonicalDouble() < gSlowOpEventSampleRate.load()) {
+        BSONObjBuilder event;
+        _debug.appendSlowOpEvent(client, *this, event);
+        slowOpEvents->record(event.obj());
+        if (gSlowOpEventsReplaceLog.load()) {
+            shouldLogSlowOp = false;
+        }
+    }
 
-    if (shouldLogOp || (shouldSample && _debug.executionTimeMicros > slowMs * 1000LL)) {
+    if (shouldLogOp || shouldLogSlowOp) {
         auto lockerInfo = opCtx->lockState()->getLockerInfo(_lockStatsBase);
         if (_debug.storageStats == nullptr && opCtx->lockState()->wasGlobalLockTaken() &&
             opCtx->getServiceContext()->getStorageEngine()) {
@@ -681,10 +733,15 @@ string OpDebug::report(Client* client,
     OPDEBUG_TOSTRING_HELP_OPTIONAL("keysDeleted", additiveMetrics.keysDeleted);
     OPDEBUG_TOSTRING_HELP_ATOMIC("prepareReadConflicts", additiveMetrics.prepareReadConflicts);
     OPDEBUG_TOSTRING_HELP_ATOMIC("writeConflicts", additiveMetrics.writeConflicts);
+    OPDEBUG_TOSTRING_HELP_OPTIONAL("peakTrackedMemBytes", peakTrackedMemBytes);
 
     s << " numYields:" << curop.numYields();
     OPDEBUG_TOSTRING_HELP(nreturned);
 
+    if (hardwareCounters) {
+        s << " hardwareCounters:" << hardwareCounters->toBSON();
+    }
+
     if (queryHash) {
         s << " queryHash:" << unsignedIntToFixedLengthHex(*queryHash);
         invariant(planCacheKey);
@@ -749,8 +806,7 @@ void OpDebug::append(const CurOp& curop,
 
     b.append("op", logicalOpToString(logicalOp));
 
-    NamespaceString nss = NamespaceString(curop.getNS());
-    b.append("ns", nss.ns());
+    b.append("ns", curop.getNS());
 
     appendAsObjOrString("command", curop.opDescription(), maxElementSize, &b);
 
@@ -781,10 +837,15 @@ void OpDebug::append(const CurOp& curop,
     OPDEBUG_APPEND_OPTIONAL("keysDeleted", additiveMetrics.keysDeleted);
     OPDEBUG_APPEND_ATOMIC("prepareReadConflicts", additiveMetrics.prepareReadConflicts);
     OPDEBUG_APPEND_ATOMIC("writeConflicts", additiveMetrics.writeConflicts);
+    OPDEBUG_APPEND_OPTIONAL("peakTrackedMemBytes", peakTrackedMemBytes);
 
     b.appendNumber("numYield", curop.numYields());
     OPDEBUG_APPEND_NUMBER(nreturned);
 
+    if (hardwareCounters) {
+        b.append("hardwareCounters", hardwareCounters->toBSON());
+    }
+
     if (queryHash) {
         b.append("queryHash", unsignedIntToFixedLengthHex(*queryHash));
         invariant(planCacheKey);
@@ -830,6 +891,58 @@ void OpDebug::append(const CurOp& curop,
     }
 }
 
+void OpDebug::appendSlowOpEvent(Client* client, const CurOp& curop, BSONObjBuilder& b) const {
+    b.append("ts", Date_t::now());
+    b.append("op", logicalOpToString(logicalOp));
+    b.append("ns", curop.getNS());
+
+    if (iscommand && curop.getCommand()) {
+        b.append("command", curop.getCommand()->getName());
+    }
+
+    const auto& clientMetadata = ClientMetadataIsMasterState::get(client).getClientMetadata();
+    if (clientMetadata) {
+        auto appName = clientMetadata.get().getApplicationName();
+        if (!appName.empty()) {
+            b.append("appName", appName);
+        }
+    }
+
+    if (queryHash) {
+        b.append("queryHash", unsignedIntToFixedLengthHex(*queryHash));
+        invariant(planCacheKey);
+        b.append("planCacheKey", unsignedIntToFixedLengthHex(*planCacheKey));
+    }
+
+    if (!curop.getPlanSummary().empty()) {
+        b.append("planSummary", curop.getPlanSummary());
+    }
+
+    OPDEBUG_APPEND_OPTIONAL("keysExamined", additiveMetrics.keysExamined);
+    OPDEBUG_APPEND_OPTIONAL("docsExamined", additiveMetrics.docsExamined);
+    OPDEBUG_APPEND_BOOL(hasSortStage);
+    OPDEBUG_APPEND_BOOL(usedDisk);
+    OPDEBUG_APPEND_OPTIONAL("nMatched", additiveMetrics.nMatched);
+    OPDEBUG_APPEND_OPTIONAL("nModified", additiveMetrics.nModified);
+    OPDEBUG_APPEND_OPTIONAL("ninserted", additiveMetrics.ninserted);
+    OPDEBUG_APPEND_OPTIONAL("ndeleted", additiveMetrics.ndeleted);
+    OPDEBUG_APPEND_ATOMIC("writeConflicts", additiveMetrics.writeConflicts);
+    OPDEBUG_APPEND_OPTIONAL("peakTrackedMemBytes", peakTrackedMemBytes);
+    b.appendNumber("numYield", curop.numYields());
+    OPDEBUG_APPEND_NUMBER(nreturned);
+    OPDEBUG_APPEND_NUMBER(responseLength);
+
+    if (hardwareCounters) {
+        b.append("hardwareCounters", hardwareCounters->toBSON());
+    }
+
+    if (!errInfo.isOK()) {
+        b.append("errCode", errInfo.code());
+    }
+
+    b.appendNumber("durationMicros", executionTimeMicros);
+}
+
 void OpDebug::setPlanSummaryMetrics(const PlanSummaryStats& planSummaryStats) {
     additiveMetrics.keysExamined = planSummaryStats.totalKeysExamined;
     additiveMetrics.docsExamined = planSummaryStats.totalDocsExamined;
@@ -853,6 +966,10 @@ BSONObj OpDebug::makeFlowControlObject(FlowControlTicketholder::CurOp stats) con
         builder.append("timeAcquiringMicros", stats.timeAcquiringMicros);
     }
 
+    if (stats.shareExhaustedWaitCount > 0) {
+        builder.append("shareExhaustedWaitCount", stats.shareExhaustedWaitCount);
+    }
+
     return builder.obj();
 }
 
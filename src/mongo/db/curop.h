@@ -36,6 +36,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/server_options.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/util/hardware_counters.h"
 #include "mongo/util/progress_meter.h"
 #include "mongo/util/time_support.h"
 
@@ -158,6 +159,12 @@ public:
                 FlowControlTicketholder::CurOp flowControlStats,
                 BSONObjBuilder& builder) const;
 
+    /**
+     * Appends the compact description of a slow operation that is kept in the SlowOpEventBuffer.
+     * Unlike append(), this omits the command body, lock statistics and execution stats.
+     */
+    void appendSlowOpEvent(Client* client, const CurOp& curop, BSONObjBuilder& builder) const;
+
     /**
      * Copies relevant plan summary metrics to this OpDebug instance.
      */
@@ -226,6 +233,13 @@ public:
     // Stores storage statistics.
     std::shared_ptr<StorageStats> storageStats;
 
+    // The most memory that query execution stages reported holding at once for this operation.
+    boost::optional<long long> peakTrackedMemBytes;
+
+    // Hardware performance counters of the operation's thread while it ran, when
+    // 'operationHardwareCounters' is enabled and the counters are available.
+    boost::optional<HardwareCounterSample> hardwareCounters;
+
     bool waitingForFlowControl{false};
 };
 
@@ -361,9 +375,11 @@ public:
     }
 
     /**
-     * Gets the name of the namespace on which the current operation operates.
+     * Gets the name of the namespace on which the current operation operates. Only the thread
+     * executing the operation may hold on to the returned reference; other threads must copy it
+     * while holding the Client lock.
      */
-    std::string getNS() const {
+    const std::string& getNS() const {
         return _ns;
     }
 
@@ -384,6 +400,14 @@ public:
         return elapsedTimeExcludingPauses() >= Milliseconds{serverGlobalParams.slowMS};
     }
 
+    /**
+     * Returns the profiling level for this operation: 0 for off, 1 for slow operations and 2 for
+     * all operations.
+     */
+    int dbProfileLevel() const {
+        return _dbprofile;
+    }
+
     /**
      * Raises the profiling level for this operation to "dbProfileLevel" if it was previously
      * less than "dbProfileLevel".
@@ -623,6 +647,8 @@ private:
 
     // The time at which this CurOp instance was marked as started.
     long long _start{0};
+    // Hardware performance counters when the operation started, if they are being collected.
+    boost::optional<HardwareCounterSample> _hardwareCountersStart;
 
     // The time at which this CurOp instance was marked as done.
     long long _end{0};
@@ -100,8 +100,12 @@ std::pair<Status, int> CursorManager::killCursorsWithMatchingSessions(
 }
 
 CursorManager::CursorManager()
-    : _random(stdx::make_unique<PseudoRandom>(SecureRandom::create()->nextInt64())),
-      _cursorMap(stdx::make_unique<Partitioned<stdx::unordered_map<CursorId, ClientCursor*>>>()) {}
+    : _cursorMap(stdx::make_unique<Partitioned<stdx::unordered_map<CursorId, ClientCursor*>>>()) {
+    auto seedSource = SecureRandom::create();
+    for (auto&& random : _random) {
+        random = stdx::make_unique<PseudoRandom>(seedSource->nextInt64());
+    }
+}
 
 CursorManager::~CursorManager() {
     auto allPartitions = _cursorMap->lockAllPartitions();
@@ -282,15 +286,18 @@ size_t CursorManager::numCursors() const {
     return _cursorMap->size();
 }
 
-CursorId CursorManager::allocateCursorId_inlock() {
-    for (int i = 0; i < 10000; i++) {
-        CursorId id = _random->nextInt64();
+std::size_t CursorManager::nextRegistrationPartition() {
+    return _nextRegistrationPartition.fetchAndAdd(1) % kNumPartitions;
+}
 
-        // A cursor id of zero is reserved to indicate that the cursor has been closed. If the
-        // random number generator gives us zero, then try again.
-        if (id == 0) {
-            continue;
-        }
+CursorId CursorManager::allocateCursorId_inlock(
+    Partitioned<stdx::unordered_map<CursorId, ClientCursor*>, kNumPartitions>::OnePartition&
+        partition,
+    std::size_t partitionId) {
+    static_assert((kNumPartitions & (kNumPartitions - 1)) == 0,
+                  "the number of partitions must be a power of two");
+    for (int i = 0; i < 10000; i++) {
+        CursorId id = _random[partitionId]->nextInt64();
 
         // Avoid negative cursor ids by taking the absolute value. If the cursor id is the minimum
         // representable negative number, then just generate another random id.
@@ -299,11 +306,19 @@ CursorId CursorManager::allocateCursorId_inlock() {
         }
         id = std::abs(id);
 
-        auto partition = _cursorMap->lockOnePartition(id);
+        // Replace the low bits with the partition id, so that the cursor id maps to 'partition'.
+        id = (id & ~static_cast<CursorId>(kNumPartitions - 1)) | static_cast<CursorId>(partitionId);
+
+        // A cursor id of zero is reserved to indicate that the cursor has been closed. If the
+        // random number generator gives us zero, then try again.
+        if (id == 0) {
+            continue;
+        }
+
+        dassert(Partitioner<CursorId>()(id, kNumPartitions) == partitionId);
         if (partition->count(id) == 0) {
-            // The cursor id is not already in use, so return it. Even though we drop the lock on
-            // the '_cursorMap' partition, another thread cannot register a cursor with the same id
-            // because we still hold '_registrationLock'.
+            // The cursor id is not already in use, so return it. No other thread can register a
+            // cursor with the same id, since it would have to hold the same partition mutex.
             return id;
         }
 
@@ -324,10 +339,11 @@ ClientCursorPin CursorManager::registerCursor(OperationContext* opCtx,
     invariant(cursorParams.exec);
     cursorParams.exec.get_deleter().dismissDisposal();
 
-    // Note we must hold the registration lock from now until insertion into '_cursorMap' to ensure
+    // Note we must hold the partition mutex from now until insertion into '_cursorMap' to ensure
     // we don't insert two cursors with the same cursor id.
-    stdx::lock_guard<SimpleMutex> lock(_registrationLock);
-    CursorId cursorId = allocateCursorId_inlock();
+    const auto partitionId = nextRegistrationPartition();
+    auto partition = _cursorMap->lockOnePartitionById(partitionId);
+    CursorId cursorId = allocateCursorId_inlock(partition, partitionId);
     std::unique_ptr<ClientCursor, ClientCursor::Deleter> clientCursor(
         new ClientCursor(std::move(cursorParams), cursorId, opCtx, now));
 
@@ -337,7 +353,6 @@ ClientCursorPin CursorManager::registerCursor(OperationContext* opCtx,
     }
 
     // Transfer ownership of the cursor to '_cursorMap'.
-    auto partition = _cursorMap->lockOnePartition(cursorId);
     ClientCursor* unownedCursor = clientCursor.release();
     partition->emplace(cursorId, unownedCursor);
     return ClientCursorPin(opCtx, unownedCursor, this);
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <array>
 #include <utility>
 
 #include "mongo/db/catalog/util/partitioned.h"
@@ -39,6 +40,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/session_killer.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/stdx/unordered_set.h"
 #include "mongo/util/concurrency/mutex.h"
@@ -176,7 +178,20 @@ private:
     static constexpr int kNumPartitions = 16;
     friend class ClientCursorPin;
 
-    CursorId allocateCursorId_inlock();
+    /**
+     * Returns the partition of '_cursorMap' in which the next cursor should be registered.
+     * Registrations are spread across the partitions in round-robin order.
+     */
+    std::size_t nextRegistrationPartition();
+
+    /**
+     * Generates a cursor id which is not in use and which belongs to 'partition'. The caller must
+     * hold the mutex for 'partition' until the cursor has been inserted.
+     */
+    CursorId allocateCursorId_inlock(
+        Partitioned<stdx::unordered_map<CursorId, ClientCursor*>, kNumPartitions>::OnePartition&
+            partition,
+        std::size_t partitionId);
 
     ClientCursorPin _registerCursor(
         OperationContext* opCtx, std::unique_ptr<ClientCursor, ClientCursor::Deleter> clientCursor);
@@ -196,19 +211,17 @@ private:
     // CursorManager, except when they are in use by a ClientCursorPin. When in use by a pin, an
     // unowned pointer remains to ensure they still receive kill notifications while in use.
     //
-    // There are several mutexes at work to protect concurrent access to data structures managed by
-    // this cursor manager. The '_cursorMap' is partitioned to decrease contention, and each
-    // partition of the structure is protected by its own mutex. Separately, there is a
-    // '_registrationLock' which protects concurrent access to '_random' for cursor id generation,
-    // and must be held from cursor id generation until insertion into '_cursorMap'. If you ever
-    // need to acquire more than one of these mutexes at once, you must follow the following rules:
-    // - '_registrationLock' must be acquired first, if at all.
-    // - Mutex(es) for '_cursorMap' must be acquired next.
-    // - If you need to access multiple partitions within '_cursorMap' at once, you must acquire the
+    // The '_cursorMap' is partitioned to decrease contention, and each partition of the structure
+    // is protected by its own mutex. The partition of a cursor is determined by the low bits of its
+    // id, so that looking up, pinning or killing a cursor only locks the partition it lives in.
+    // Registration picks a partition first and then generates an id which maps to it, using the
+    // random number generator in '_random' owned by that partition. The partition mutex protects
+    // that generator, so registering a cursor never takes a lock shared by all partitions. If you
+    // need to access multiple partitions within '_cursorMap' at once, you must acquire the
     // mutexes for those partitions in ascending order, or use the partition helpers to acquire
     // mutexes for all partitions.
-    mutable SimpleMutex _registrationLock;
-    std::unique_ptr<PseudoRandom> _random;
+    std::array<std::unique_ptr<PseudoRandom>, kNumPartitions> _random;
+    AtomicWord<unsigned> _nextRegistrationPartition{0};
     std::unique_ptr<Partitioned<stdx::unordered_map<CursorId, ClientCursor*>, kNumPartitions>>
         _cursorMap;
 };
@@ -176,6 +176,7 @@
 #include "mongo/util/startup_test.h"
 #include "mongo/util/text.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 #include "mongo/util/version.h"
 
 #include "mongo/db/storage/flow_control.h"
@@ -331,7 +332,17 @@ ExitCode _initAndListen(int listenPort) {
                      stdx::make_unique<FlowControl>(
                          serviceContext, repl::ReplicationCoordinator::get(serviceContext)));
 
+    // Startup of a node with many collections is dominated by a few phases; log how long each one
+    // took so that slow startups can be attributed.
+    Timer startupTimer;
+    Timer startupPhaseTimer;
+    const auto logStartupPhase = [&startupPhaseTimer](StringData phase) {
+        log() << "Startup phase '" << phase << "' took " << startupPhaseTimer.millis() << "ms";
+        startupPhaseTimer.reset();
+    };
+
     initializeStorageEngine(serviceContext, StorageEngineInitFlags::kNone);
+    logStartupPhase("storage engine initialization");
 
 #ifdef MONGO_CONFIG_WIREDTIGER_ENABLED
     if (EncryptionHooks::get(serviceContext)->restartRequired()) {
@@ -422,12 +433,14 @@ ExitCode _initAndListen(int listenPort) {
     }
 
     bool nonLocalDatabases;
+    startupPhaseTimer.reset();
     try {
         nonLocalDatabases = repairDatabasesAndCheckVersion(startupOpCtx.get());
     } catch (const ExceptionFor<ErrorCodes::MustDowngrade>& error) {
         severe(LogComponent::kControl) << "** IMPORTANT: " << error.toStatus().reason();
         exitCleanly(EXIT_NEED_DOWNGRADE);
     }
+    logStartupPhase("database recovery and version check");
 
     // Assert that the in-memory featureCompatibilityVersion parameter has been explicitly set. If
     // we are part of a replica set and are started up with no data files, we do not set the
@@ -447,6 +460,7 @@ ExitCode _initAndListen(int listenPort) {
 
     auto const globalAuthzManager = AuthorizationManager::get(serviceContext);
     uassertStatusOK(globalAuthzManager->initialize(startupOpCtx.get()));
+    logStartupPhase("authorization initialization");
 
     // This is for security on certain platforms (nonce generation)
     srand((unsigned)(curTimeMicros64()) ^ (unsigned(uintptr_t(&startupOpCtx))));
@@ -618,6 +632,8 @@ ExitCode _initAndListen(int listenPort) {
         kind = LogicalSessionCacheServer::kReplicaSet;
     }
 
+    logStartupPhase("replication and background task startup");
+
     auto sessionCache = makeLogicalSessionCacheD(kind);
     LogicalSessionCache::set(serviceContext, std::move(sessionCache));
 
@@ -646,6 +662,8 @@ ExitCode _initAndListen(int listenPort) {
     }
 
     serviceContext->notifyStartupComplete();
+    log() << "Startup completed " << startupTimer.millis()
+          << "ms after storage engine initialization began";
 
 #ifndef _WIN32
     mongo::signalForkSuccess();
@@ -34,11 +34,13 @@
 #include "mongo/db/db_raii.h"
 
 #include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii_gen.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
+#include "mongo/db/stats/timer_stats.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -46,6 +48,37 @@ namespace {
 
 const boost::optional<int> kDoNotChangeProfilingLevel = boost::none;
 
+// Number and time of secondary reads that waited for the last applied optime to move past a pending
+// catalog change instead of conflicting with batch application.
+TimerStats waitedForLastAppliedStats;
+ServerStatusMetricField<TimerStats> displayWaitedForLastApplied(
+    "repl.secondaryReads.waitedForLastApplied", &waitedForLastAppliedStats);
+
+// Number and time of secondary reads that were blocked by batch application, either because they
+// had to take the PBWM lock or because they waited for a new majority committed snapshot.
+TimerStats blockedByBatchApplicationStats;
+ServerStatusMetricField<TimerStats> displayBlockedByBatchApplication(
+    "repl.secondaryReads.blockedByBatchApplication", &blockedByBatchApplicationStats);
+
+// How long a read which must not block on batch application waits for the batch in progress before
+// checking again whether it can conflict with batch application without blocking.
+const Milliseconds kBatchApplicationPollInterval{100};
+
+/**
+ * Returns true if a secondary batch is being applied, or is about to be, such that taking the PBWM
+ * lock in MODE_IS would block. Must be called without holding any locks.
+ */
+bool isBatchApplicationInProgress(OperationContext* opCtx) {
+    invariant(!opCtx->lockState()->isLocked());
+    try {
+        opCtx->lockState()->lock(opCtx, resourceIdParallelBatchWriterMode, MODE_IS, Date_t::now());
+    } catch (const ExceptionFor<ErrorCodes::LockTimeout>&) {
+        return true;
+    }
+    opCtx->lockState()->unlock(resourceIdParallelBatchWriterMode);
+    return false;
+}
+
 }  // namespace
 
 AutoStatsTracker::AutoStatsTracker(OperationContext* opCtx,
@@ -106,6 +139,10 @@ AutoGetCollectionForRead::AutoGetCollectionForRead(OperationContext* opCtx,
     repl::ReplicationCoordinator* const replCoord = repl::ReplicationCoordinator::get(opCtx);
     const auto readConcernLevel = repl::ReadConcernArgs::get(opCtx).getLevel();
 
+    // Each read waits for the last applied optime at most once before falling back to the PBWM
+    // lock, so that a read cannot be starved by a steady stream of catalog changes.
+    bool waitedForLastApplied = false;
+
     // If the collection doesn't exist or disappears after releasing locks and waiting, there is no
     // need to check for pending catalog changes.
     while (auto coll = _autoColl->getCollection()) {
@@ -171,6 +208,41 @@ AutoGetCollectionForRead::AutoGetCollectionForRead(OperationContext* opCtx,
         // Yield locks in order to do the blocking call below.
         _autoColl = boost::none;
 
+        // Rather than conflicting with in-progress batches straight away, give batch application a
+        // bounded amount of time to apply past the pending catalog change and then retry at the
+        // new last applied timestamp, still without the PBWM lock. Long-running analytics reads
+        // would otherwise hold the PBWM lock across yields and stall replication.
+        const bool canWaitForLastApplied =
+            lastAppliedTimestamp || readSource == RecoveryUnit::ReadSource::kNoOverlap;
+        const auto maxWaitMillis = gSecondaryReadMaxWaitForCatalogChangesMillis.load();
+        if (maxWaitMillis > 0 && !waitedForLastApplied && canWaitForLastApplied) {
+            waitedForLastApplied = true;
+            _waitForLastApplied(opCtx,
+                                nss,
+                                *minSnapshot,
+                                opCtx->getServiceContext()->getFastClockSource()->now() +
+                                    Milliseconds(maxWaitMillis));
+            _autoColl.emplace(opCtx, nsOrUUID, collectionLockMode, viewMode, deadline);
+            continue;
+        }
+
+        // Only conflict with secondary batch application below if that does not make this read
+        // wait for a batch. While a batch is in progress, wait for it to complete instead and
+        // retry at its timestamp. A batch which does not move the last applied optime past the
+        // catalog change is not waited on forever, because the PBWM lock is checked again after
+        // every poll interval.
+        if (gSecondaryReadsNeverBlockOnBatchApplication.load() && canWaitForLastApplied &&
+            _shouldNotConflictWithSecondaryBatchApplicationBlock &&
+            isBatchApplicationInProgress(opCtx)) {
+            _waitForLastApplied(opCtx,
+                                nss,
+                                *minSnapshot,
+                                opCtx->getServiceContext()->getFastClockSource()->now() +
+                                    kBatchApplicationPollInterval);
+            _autoColl.emplace(opCtx, nsOrUUID, collectionLockMode, viewMode, deadline);
+            continue;
+        }
+
         // If there are pending catalog changes, we should conflict with any in-progress batches (by
         // taking the PBWM lock) and choose not to read from the last applied timestamp by unsetting
         // _shouldNotConflictWithSecondaryBatchApplicationBlock. Index builds on secondaries can
@@ -210,6 +282,8 @@ AutoGetCollectionForRead::AutoGetCollectionForRead(OperationContext* opCtx,
             opCtx->recoveryUnit()->abandonSnapshot();
         }
 
+        TimerHolder blockedTimer(&blockedByBatchApplicationStats);
+
         if (readSource == RecoveryUnit::ReadSource::kMajorityCommitted) {
             replCoord->waitUntilSnapshotCommitted(opCtx, *minSnapshot);
             uassertStatusOK(opCtx->recoveryUnit()->obtainMajorityCommittedSnapshot());
@@ -224,6 +298,30 @@ AutoGetCollectionForRead::AutoGetCollectionForRead(OperationContext* opCtx,
     }
 }
 
+void AutoGetCollectionForRead::_waitForLastApplied(OperationContext* opCtx,
+                                                   const NamespaceString& nss,
+                                                   Timestamp minSnapshot,
+                                                   Date_t waitDeadline) const {
+    invariant(!_autoColl);
+    TimerHolder waitTimer(&waitedForLastAppliedStats);
+
+    const auto waitStatus = repl::ReplicationCoordinator::get(opCtx)->waitUntilOpTimeForReadUntil(
+        opCtx,
+        repl::ReadConcernArgs(LogicalTime(minSnapshot), repl::ReadConcernLevel::kLocalReadConcern),
+        waitDeadline);
+    if (!waitStatus.isOK()) {
+        LOG(2) << "Failed waiting for last-applied time to reach " << minSnapshot
+               << " on ns: " << nss.ns() << causedBy(waitStatus);
+    }
+
+    // Select a new read timestamp on the next loop iteration without changing the read source.
+    opCtx->recoveryUnit()->abandonSnapshot();
+    {
+        stdx::lock_guard<Client> lk(*opCtx->getClient());
+        CurOp::get(opCtx)->yielded();
+    }
+}
+
 bool AutoGetCollectionForRead::_shouldReadAtLastAppliedTimestamp(
     OperationContext* opCtx,
     const NamespaceString& nss,
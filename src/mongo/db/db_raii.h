@@ -144,6 +144,14 @@ private:
     bool _conflictingCatalogChanges(OperationContext* opCtx,
                                     boost::optional<Timestamp> minSnapshot,
                                     boost::optional<Timestamp> lastAppliedTimestamp) const;
+
+    // Waits, without holding any locks, until either the last applied optime reaches 'minSnapshot'
+    // or 'waitDeadline' passes, then abandons the snapshot so that the next read timestamp is
+    // selected again from the same read source.
+    void _waitForLastApplied(OperationContext* opCtx,
+                             const NamespaceString& nss,
+                             Timestamp minSnapshot,
+                             Date_t waitDeadline) const;
 };
 
 /**
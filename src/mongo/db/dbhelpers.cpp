@@ -51,6 +51,7 @@
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/clustered_id.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/db/write_concern_options.h"
 #include "mongo/util/log.h"
@@ -149,13 +150,13 @@ bool Helpers::findById(OperationContext* opCtx,
     IndexCatalog* catalog = collection->getIndexCatalog();
     const IndexDescriptor* desc = catalog->findIdIndex(opCtx);
 
-    if (!desc)
+    if (!desc && !collection->getRecordStore()->isClustered())
         return false;
 
     if (indexFound)
         *indexFound = 1;
 
-    RecordId loc = catalog->getEntry(desc)->accessMethod()->findSingle(opCtx, query["_id"].wrap());
+    RecordId loc = findById(opCtx, collection, query);
     if (loc.isNull())
         return false;
     result = collection->docFor(opCtx, loc).value();
@@ -168,6 +169,16 @@ RecordId Helpers::findById(OperationContext* opCtx,
     verify(collection);
     IndexCatalog* catalog = collection->getIndexCatalog();
     const IndexDescriptor* desc = catalog->findIdIndex(opCtx);
+    if (!desc && collection->getRecordStore()->isClustered()) {
+        // Clustered collections store each document under the RecordId derived from its _id.
+        auto key = clusteredid::keyForId(idquery["_id"]);
+        if (!key.isOK())
+            return RecordId();
+        RecordData unused;
+        return collection->getRecordStore()->findRecord(opCtx, key.getValue(), &unused)
+            ? key.getValue()
+            : RecordId();
+    }
     uassert(13430, "no _id index", desc);
     return catalog->getEntry(desc)->accessMethod()->findSingle(opCtx, idquery["_id"].wrap());
 }
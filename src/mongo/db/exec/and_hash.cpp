@@ -161,6 +161,8 @@ PlanStage::StageState AndHashStage::doWork(WorkingSetID* out) {
     // table with subsequent children, or checking the last child's results to see if they're
     // in the hash table.
 
+    _trackedMemory.set(getOpCtx(), _memUsage);
+
     // We read the first child into our hash table.
     if (_hashingChildren) {
         // Check memory usage of previously hashed results.
@@ -331,7 +333,7 @@ PlanStage::StageState AndHashStage::hashOtherChildren(WorkingSetID* out) {
         // Keep elements of _dataMap that are in _seenMap.
         DataMap::iterator it = _dataMap.begin();
         while (it != _dataMap.end()) {
-            if (_seenMap.end() == _seenMap.find(it->first)) {
+            if (!_seenMap.contains(it->first)) {
                 DataMap::iterator toErase = it;
                 ++it;
 
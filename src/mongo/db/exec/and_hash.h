@@ -32,11 +32,12 @@
 #include <vector>
 
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/record_id_bitmap.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
+#include "mongo/db/operation_memory_tracker.h"
 #include "mongo/db/record_id.h"
 #include "mongo/stdx/unordered_map.h"
-#include "mongo/stdx/unordered_set.h"
 
 namespace mongo {
 
@@ -98,8 +99,7 @@ private:
 
     // Keeps track of what elements from _dataMap subsequent children have seen.
     // Only used while _hashingChildren.
-    typedef stdx::unordered_set<RecordId, RecordId::Hasher> SeenMap;
-    SeenMap _seenMap;
+    RecordIdBitmap _seenMap;
 
     // True if we're still intersecting _children[0..._children.size()-1].
     bool _hashingChildren;
@@ -115,6 +115,9 @@ private:
     // For simplicity, results in _lookAheadResults do not count towards the limit.
     size_t _memUsage;
 
+    // Reports '_memUsage' to the memory tracker of the operation we are running in.
+    TrackedMemoryUsage _trackedMemory;
+
     // Upper limit for buffered data memory usage.
     // Defaults to 32 MB (See kMaxBytes in and_hash.cpp).
     size_t _maxMemUsage;
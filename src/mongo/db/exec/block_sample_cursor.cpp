@@ -0,0 +1,120 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/block_sample_cursor.h"
+
+
+namespace mongo {
+
+namespace {
+// The number of consecutive random picks of already-returned records after which the cursor gives
+// up on starting a new block.
+const int kMaxBlockStartAttempts = 100;
+}  // namespace
+
+std::unique_ptr<BlockSampleRecordCursor> BlockSampleRecordCursor::make(
+    OperationContext* opCtx, const RecordStore* recordStore, size_t blockSize) {
+    invariant(blockSize > 0);
+    auto randomCursor = recordStore->getRandomCursor(opCtx);
+    if (!randomCursor) {
+        return nullptr;
+    }
+    return std::unique_ptr<BlockSampleRecordCursor>(new BlockSampleRecordCursor(
+        std::move(randomCursor), recordStore->getCursor(opCtx), blockSize));
+}
+
+BlockSampleRecordCursor::BlockSampleRecordCursor(std::unique_ptr<RecordCursor> randomCursor,
+                                                 std::unique_ptr<SeekableRecordCursor> cursor,
+                                                 size_t blockSize)
+    : _randomCursor(std::move(randomCursor)), _cursor(std::move(cursor)), _blockSize(blockSize) {}
+
+boost::optional<Record> BlockSampleRecordCursor::next() {
+    if (_remainingInBlock > 0) {
+        auto record = _cursor->next();
+        if (record && _returned.insert(record->id).second) {
+            --_remainingInBlock;
+            record->data.makeOwned();
+            return record;
+        }
+        _remainingInBlock = 0;
+    }
+
+    for (int attempt = 0; attempt < kMaxBlockStartAttempts; ++attempt) {
+        auto start = _randomCursor->next();
+        if (!start) {
+            return boost::none;
+        }
+        if (_returned.count(start->id)) {
+            continue;
+        }
+
+        // The record may have been deleted since the random cursor read it.
+        auto record = _cursor->seekExact(start->id);
+        if (!record) {
+            continue;
+        }
+        _returned.insert(record->id);
+        _remainingInBlock = _blockSize - 1;
+        record->data.makeOwned();
+        return record;
+    }
+    return boost::none;
+}
+
+void BlockSampleRecordCursor::save() {
+    _randomCursor->save();
+    if (_remainingInBlock > 0) {
+        _cursor->save();
+    } else {
+        _cursor->saveUnpositioned();
+    }
+}
+
+bool BlockSampleRecordCursor::restore() {
+    // If the current block can't be continued, the next call to next() starts a new one.
+    if (!_cursor->restore()) {
+        _remainingInBlock = 0;
+    }
+    return _randomCursor->restore();
+}
+
+void BlockSampleRecordCursor::detachFromOperationContext() {
+    _randomCursor->detachFromOperationContext();
+    _cursor->detachFromOperationContext();
+}
+
+void BlockSampleRecordCursor::reattachToOperationContext(OperationContext* opCtx) {
+    _randomCursor->reattachToOperationContext(opCtx);
+    _cursor->reattachToOperationContext(opCtx);
+}
+
+}  // namespace mongo
@@ -0,0 +1,85 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <memory>
+
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/stdx/unordered_set.h"
+
+namespace mongo {
+
+/**
+ * A RecordCursor which samples a collection in blocks of consecutive records. The start of each
+ * block is a record picked by the record store's random cursor, from which up to 'blockSize'
+ * records are read in RecordId order. A block ends early when it reaches a record which has
+ * already been returned, so no record is returned twice.
+ *
+ * This reads far fewer random positions than a random cursor for the same number of records, at
+ * the price of the records of each block being correlated. The cursor is exhausted once it fails
+ * to start a new block after a number of random picks, which happens as most of the collection has
+ * been returned.
+ */
+class BlockSampleRecordCursor final : public RecordCursor {
+public:
+    /**
+     * Returns nullptr if 'recordStore' has no random cursor support.
+     */
+    static std::unique_ptr<BlockSampleRecordCursor> make(OperationContext* opCtx,
+                                                         const RecordStore* recordStore,
+                                                         size_t blockSize);
+
+    boost::optional<Record> next() final;
+
+    void save() final;
+    bool restore() final;
+
+    void detachFromOperationContext() final;
+    void reattachToOperationContext(OperationContext* opCtx) final;
+
+private:
+    BlockSampleRecordCursor(std::unique_ptr<RecordCursor> randomCursor,
+                            std::unique_ptr<SeekableRecordCursor> cursor,
+                            size_t blockSize);
+
+    const std::unique_ptr<RecordCursor> _randomCursor;
+    const std::unique_ptr<SeekableRecordCursor> _cursor;
+    const size_t _blockSize;
+
+    // The number of records still to be read from the current block. Zero if '_cursor' is not
+    // positioned in a block.
+    size_t _remainingInBlock = 0;
+
+    stdx::unordered_set<RecordId, RecordId::Hasher> _returned;
+};
+
+}  // namespace mongo
@@ -63,11 +63,14 @@ CollectionScan::CollectionScan(OperationContext* opCtx,
     : RequiresCollectionStage(kStageType, opCtx, collection),
       _workingSet(workingSet),
       _filter(filter),
+      _compiledFilter(CompiledMatchExpression::compile(filter)),
       _params(params) {
     // Explain reports the direction of the collection scan.
     _specificStats.direction = params.direction;
     _specificStats.maxTs = params.maxTs;
     invariant(!_params.shouldTrackLatestOplogTimestamp || collection->ns().isOplog());
+    invariant((!_params.minRecord && !_params.maxRecord) ||
+              (_params.direction == CollectionScanParams::FORWARD && !_params.tailable));
 
     if (params.maxTs) {
         _endConditionBSON = BSON("$gte" << *(params.maxTs));
@@ -130,6 +133,8 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
 
         if (_lastSeenId.isNull() && !_params.start.isNull()) {
             record = _cursor->seekExact(_params.start);
+        } else if (_lastSeenId.isNull() && _params.minRecord) {
+            record = seekToMinRecord();
         } else {
             record = _cursor->next();
         }
@@ -154,6 +159,11 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
+    if (_params.maxRecord && record->id >= *_params.maxRecord) {
+        _commonStats.isEOF = true;
+        return PlanStage::IS_EOF;
+    }
+
     _lastSeenId = record->id;
     if (_params.shouldTrackLatestOplogTimestamp) {
         auto status = setLatestOplogEntryTimestamp(*record);
@@ -163,13 +173,22 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         }
     }
 
-    WorkingSetID id = _workingSet->allocate();
-    WorkingSetMember* member = _workingSet->get(id);
-    member->recordId = record->id;
-    member->obj = {getOpCtx()->recoveryUnit()->getSnapshotId(), record->data.releaseToBson()};
-    _workingSet->transitionToRecordIdAndObj(id);
+    return returnIfMatches(&*record, out);
+}
+
+boost::optional<Record> CollectionScan::seekToMinRecord() {
+    if (auto record = _cursor->seekExact(*_params.minRecord)) {
+        return record;
+    }
 
-    return returnIfMatches(member, id, out);
+    // The record at the bound has been deleted. Cursors can only seek to an existing record, so
+    // scan up to the bound from the beginning of the collection.
+    _cursor = collection()->getCursor(getOpCtx(), true);
+    auto record = _cursor->next();
+    while (record && record->id < *_params.minRecord) {
+        record = _cursor->next();
+    }
+    return record;
 }
 
 Status CollectionScan::setLatestOplogEntryTimestamp(const Record& record) {
@@ -185,23 +204,30 @@ Status CollectionScan::setLatestOplogEntryTimestamp(const Record& record) {
     return Status::OK();
 }
 
-PlanStage::StageState CollectionScan::returnIfMatches(WorkingSetMember* member,
-                                                      WorkingSetID memberID,
-                                                      WorkingSetID* out) {
+PlanStage::StageState CollectionScan::returnIfMatches(Record* record, WorkingSetID* out) {
     ++_specificStats.docsTested;
 
-    if (Filter::passes(member, _filter)) {
+    // Match the record's buffer directly, so that a working set member is only allocated for a
+    // document which is returned.
+    const BSONObj obj = record->data.toBson();
+    if (Filter::passes(obj, _filter, _compiledFilter.get())) {
         if (_params.stopApplyingFilterAfterFirstMatch) {
             _filter = nullptr;
+            _compiledFilter.reset();
         }
-        *out = memberID;
+
+        WorkingSetID id = _workingSet->allocate();
+        WorkingSetMember* member = _workingSet->get(id);
+        member->recordId = record->id;
+        member->obj = {getOpCtx()->recoveryUnit()->getSnapshotId(), record->data.releaseToBson()};
+        _workingSet->transitionToRecordIdAndObj(id);
+
+        *out = id;
         return PlanStage::ADVANCED;
-    } else if (_endCondition && Filter::passes(member, _endCondition.get())) {
-        _workingSet->free(memberID);
+    } else if (_endCondition && _endCondition->matchesBSON(obj)) {
         _commonStats.isEOF = true;
         return PlanStage::IS_EOF;
     } else {
-        _workingSet->free(memberID);
         return PlanStage::NEED_TIME;
     }
 }
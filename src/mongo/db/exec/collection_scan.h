@@ -33,6 +33,7 @@
 
 #include "mongo/db/exec/collection_scan_common.h"
 #include "mongo/db/exec/requires_collection_stage.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
 #include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/record_id.h"
 
@@ -84,10 +85,16 @@ protected:
 
 private:
     /**
-     * If the member (with id memberID) passes our filter, set *out to memberID and return that
-     * ADVANCED.  Otherwise, free memberID and return NEED_TIME.
+     * If 'record' passes our filter, allocate a working set member for it, set *out to the
+     * member's id and return ADVANCED. Otherwise, return NEED_TIME without allocating one.
      */
-    StageState returnIfMatches(WorkingSetMember* member, WorkingSetID memberID, WorkingSetID* out);
+    StageState returnIfMatches(Record* record, WorkingSetID* out);
+
+    /**
+     * Positions '_cursor' at the first record with a RecordId at or after the 'minRecord' bound
+     * and returns it, or returns boost::none if there is no such record.
+     */
+    boost::optional<Record> seekToMinRecord();
 
     /**
      * Extracts the timestamp from the 'ts' field of 'record', and sets '_latestOplogEntryTimestamp'
@@ -102,6 +109,9 @@ private:
     // The filter is not owned by us.
     const MatchExpression* _filter;
 
+    // The execution form of '_filter', or null if it has none.
+    std::unique_ptr<CompiledMatchExpression> _compiledFilter;
+
     // If a document does not pass '_filter' but passes '_endCondition', stop scanning and return
     // IS_EOF.
     BSONObj _endConditionBSON;
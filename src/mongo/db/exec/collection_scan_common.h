@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "mongo/bson/timestamp.h"
 #include "mongo/db/record_id.h"
 
@@ -45,6 +47,12 @@ struct CollectionScanParams {
     // The RecordId to which we should seek to as the first document of the scan.
     RecordId start;
 
+    // If set, the scan only returns records with a RecordId at or after 'minRecord' and before
+    // 'maxRecord'. Unlike 'start', 'minRecord' need not be the RecordId of an existing record. Only
+    // forward, non-tailable scans support these bounds.
+    boost::optional<RecordId> minRecord;
+    boost::optional<RecordId> maxRecord;
+
     // If present, the collection scan will stop and return EOF the first time it sees a document
     // that does not pass the filter and has 'ts' greater than 'maxTs'.
     boost::optional<Timestamp> maxTs;
@@ -136,7 +136,7 @@ PlanStage::StageState CountScan::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
-    if (_shouldDedup && !_returned.insert(entry->loc).second) {
+    if (_shouldDedup && !_returned.insert(entry->loc)) {
         // *loc was already in _returned.
         return PlanStage::NEED_TIME;
     }
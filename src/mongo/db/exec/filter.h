@@ -30,6 +30,7 @@
 #pragma once
 
 #include "mongo/db/exec/working_set.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/matchable.h"
 
@@ -158,6 +159,35 @@ public:
         return filter->matches(&doc, NULL);
     }
 
+    /**
+     * As above, but matches a fetched document with 'compiled', the compiled form of 'filter',
+     * when there is one.
+     */
+    static bool passes(WorkingSetMember* wsm,
+                       const MatchExpression* filter,
+                       CompiledMatchExpression* compiled) {
+        if (NULL == filter) {
+            return true;
+        }
+        if (compiled && wsm->hasObj()) {
+            return compiled->matchesBSON(wsm->obj.value());
+        }
+        return passes(wsm, filter);
+    }
+
+    /**
+     * Returns true if filter is NULL or if 'obj' satisfies the filter, using 'compiled', the
+     * compiled form of 'filter', when there is one.
+     */
+    static bool passes(const BSONObj& obj,
+                       const MatchExpression* filter,
+                       CompiledMatchExpression* compiled) {
+        if (NULL == filter) {
+            return true;
+        }
+        return compiled ? compiled->matchesBSON(obj) : filter->matchesBSON(obj);
+    }
+
     static bool passes(const BSONObj& keyData,
                        const BSONObj& keyPattern,
                        const MatchExpression* filter) {
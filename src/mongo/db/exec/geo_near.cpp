@@ -31,6 +31,7 @@
 
 #include "mongo/db/exec/geo_near.h"
 
+#include <cmath>
 #include <memory>
 #include <vector>
 
@@ -580,6 +581,44 @@ static double min2DBoundsIncrement(const GeoNearExpression& query,
     return minBoundsIncrement * kMetersPerDegreeAtEquator;
 }
 
+/**
+ * Returns the width of the next search annulus, given the results of the last one and its width
+ * 'boundsIncrement'.
+ *
+ * By default the width is doubled or halved to keep the number of results per annulus within a
+ * fixed range. With 'internalGeoNearAdaptiveAnnulus', the width is instead chosen so that the next
+ * annulus holds about as many results as the target, assuming the density of results seen in the
+ * last annulus. The annulus is treated as planar, so the results within a radius grow with its
+ * square.
+ */
+static double nextBoundsIncrement(const IntervalStats& lastIntervalStats, double boundsIncrement) {
+    const double kMinResultsPerInterval = 300;
+    const double kMaxResultsPerInterval = 600;
+
+    if (!gInternalGeoNearAdaptiveAnnulus.load()) {
+        // TODO: Generally we want small numbers of results fast, then larger numbers later
+        if (lastIntervalStats.numResultsReturned < kMinResultsPerInterval)
+            return boundsIncrement * 2;
+        else if (lastIntervalStats.numResultsReturned > kMaxResultsPerInterval)
+            return boundsIncrement / 2;
+        return boundsIncrement;
+    }
+
+    const double inner = std::max(lastIntervalStats.minDistanceAllowed, 0.0);
+    const double outer = lastIntervalStats.maxDistanceAllowed;
+    if (lastIntervalStats.numResultsBuffered == 0 || outer <= inner) {
+        return boundsIncrement * 2;
+    }
+
+    const double kTargetResultsPerInterval = (kMinResultsPerInterval + kMaxResultsPerInterval) / 2;
+    const double areaPerResult =
+        (outer * outer - inner * inner) / lastIntervalStats.numResultsBuffered;
+    const double nextOuter = std::sqrt(outer * outer + kTargetResultsPerInterval * areaPerResult);
+
+    // Don't let a single sparse or dense annulus swing the width too far.
+    return std::max(boundsIncrement / 2, std::min(nextOuter - outer, boundsIncrement * 4));
+}
+
 static R2Annulus projectBoundsToTwoDDegrees(R2Annulus sphereBounds) {
     const double outerDegrees = rad2deg(sphereBounds.getOuter() / kRadiusOfEarthInMeters);
     const double innerDegrees = rad2deg(sphereBounds.getInner() / kRadiusOfEarthInMeters);
@@ -604,13 +643,8 @@ StatusWith<NearStage::CoveredInterval*>  //
     //
 
     if (!_specificStats.intervalStats.empty()) {
-        const IntervalStats& lastIntervalStats = _specificStats.intervalStats.back();
-
-        // TODO: Generally we want small numbers of results fast, then larger numbers later
-        if (lastIntervalStats.numResultsReturned < 300)
-            _boundsIncrement *= 2;
-        else if (lastIntervalStats.numResultsReturned > 600)
-            _boundsIncrement /= 2;
+        _boundsIncrement =
+            nextBoundsIncrement(_specificStats.intervalStats.back(), _boundsIncrement);
     }
 
     _boundsIncrement =
@@ -1024,13 +1058,8 @@ StatusWith<NearStage::CoveredInterval*>  //
     //
 
     if (!_specificStats.intervalStats.empty()) {
-        const IntervalStats& lastIntervalStats = _specificStats.intervalStats.back();
-
-        // TODO: Generally we want small numbers of results fast, then larger numbers later
-        if (lastIntervalStats.numResultsReturned < 300)
-            _boundsIncrement *= 2;
-        else if (lastIntervalStats.numResultsReturned > 600)
-            _boundsIncrement /= 2;
+        _boundsIncrement =
+            nextBoundsIncrement(_specificStats.intervalStats.back(), _boundsIncrement);
     }
 
     invariant(_boundsIncrement > 0.0);
@@ -46,6 +46,7 @@
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_ranker.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/str.h"
@@ -72,6 +73,7 @@ MultiPlanStage::MultiPlanStage(OperationContext* opCtx,
       _backupPlanIdx(kNoSuchPlan),
       _failure(false),
       _failureCount(0),
+      _prunedCount(0),
       _statusMemberId(WorkingSet::INVALID_ID) {}
 
 void MultiPlanStage::addPlan(std::unique_ptr<QuerySolution> solution,
@@ -202,6 +204,7 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
 
     size_t numWorks = getTrialPeriodWorks(getOpCtx(), collection());
     size_t numResults = getTrialPeriodNumToReturn(*_query);
+    size_t pruneWorks = static_cast<size_t>(internalQueryPlanEvaluationPruneWorks.load());
 
     // Work the plans, stopping when a plan hits EOF or returns some
     // fixed number of results.
@@ -210,6 +213,10 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
         if (!moreToDo) {
             break;
         }
+
+        if (pruneWorks > 0 && (ix + 1) % pruneWorks == 0) {
+            pruneCandidates();
+        }
     }
 
     if (_failure) {
@@ -336,7 +343,7 @@ bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolic
 
     for (size_t ix = 0; ix < _candidates.size(); ++ix) {
         CandidatePlan& candidate = _candidates[ix];
-        if (candidate.failed) {
+        if (candidate.failed || candidate.pruned) {
             continue;
         }
 
@@ -394,12 +401,55 @@ bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolic
                 _failure = true;
                 return false;
             }
+
+            // If every plan which survived pruning has failed, go back to working the pruned
+            // plans rather than failing the query.
+            if (_failureCount + _prunedCount == _candidates.size()) {
+                for (auto&& other : _candidates) {
+                    other.pruned = false;
+                }
+                _prunedCount = 0;
+            }
         }
     }
 
     return !doneWorking;
 }
 
+void MultiPlanStage::pruneCandidates() {
+    std::vector<std::pair<double, size_t>> liveScores;
+    for (size_t ix = 0; ix < _candidates.size(); ++ix) {
+        const CandidatePlan& candidate = _candidates[ix];
+        if (candidate.failed || candidate.pruned) {
+            continue;
+        }
+        auto stats = candidate.root->getStats();
+        liveScores.push_back(std::make_pair(PlanRanker::scoreTree(stats.get()), ix));
+    }
+
+    const size_t minCandidates =
+        static_cast<size_t>(internalQueryPlanEvaluationPruneMinCandidates.load());
+    if (liveScores.size() < minCandidates) {
+        return;
+    }
+
+    // Keep the higher-scoring half. Ties are broken in favor of the earlier candidate, as in the
+    // final ranking.
+    using ScoreAndIndex = std::pair<double, size_t>;
+    std::stable_sort(liveScores.begin(),
+                     liveScores.end(),
+                     [](const ScoreAndIndex& lhs, const ScoreAndIndex& rhs) {
+                         return lhs.first > rhs.first;
+                     });
+    for (size_t ix = (liveScores.size() + 1) / 2; ix < liveScores.size(); ++ix) {
+        CandidatePlan& candidate = _candidates[liveScores[ix].second];
+        LOG(2) << "Pruning query plan with score " << liveScores[ix].first << ": "
+               << Explain::getPlanSummary(candidate.root);
+        candidate.pruned = true;
+        ++_prunedCount;
+    }
+}
+
 bool MultiPlanStage::hasBackupPlan() const {
     return kNoSuchPlan != _backupPlanIdx;
 }
@@ -172,6 +172,13 @@ private:
      */
     bool workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolicy);
 
+    /**
+     * Scores the candidates which are still being worked and prunes the lower-scoring half of
+     * them, so that the rest of the trial period is spent on the plans most likely to win. Does
+     * nothing unless at least 'internalQueryPlanEvaluationPruneMinCandidates' plans are live.
+     */
+    void pruneCandidates();
+
     /**
      * Checks whether we need to perform either a timing-based yield or a yield for a document
      * fetch. If so, then uses 'yieldPolicy' to actually perform the yield.
@@ -219,6 +226,9 @@ private:
     // If everything fails during the plan competition, we can't pick one.
     size_t _failureCount;
 
+    // The number of candidates pruned from the plan competition.
+    size_t _prunedCount;
+
     // if pickBestPlan fails, this is set to the wsid of the statusMember
     // returned by ::work()
     WorkingSetID _statusMemberId;
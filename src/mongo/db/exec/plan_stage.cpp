@@ -33,15 +33,39 @@
 
 #include "mongo/db/exec/plan_stage.h"
 
+#include "mongo/db/curop.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/service_context.h"
 
 namespace mongo {
 
+namespace {
+const auto alwaysTimeStages = OperationContext::declareDecoration<bool>();
+}  // namespace
+
+void PlanStage::setAlwaysTimeStages(OperationContext* opCtx) {
+    alwaysTimeStages(opCtx) = true;
+}
+
 PlanStage::StageState PlanStage::work(WorkingSetID* out) {
     invariant(_opCtx);
-    ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    if (_shouldTimeWork()) {
+        ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+        return _doWorkAndCount(out);
+    }
+    return _doWorkAndCount(out);
+}
+
+bool PlanStage::_shouldTimeWork() const {
+    if (!internalQueryExecTimeStagesOnlyWhenNeeded.load()) {
+        return true;
+    }
+    return alwaysTimeStages(_opCtx) || CurOp::get(_opCtx)->dbProfileLevel() > 0;
+}
+
+PlanStage::StageState PlanStage::_doWorkAndCount(WorkingSetID* out) {
     ++_commonStats.works;
 
     StageState workResult = doWork(out);
@@ -186,6 +186,13 @@ public:
     }
 
 
+    /**
+     * Makes the stages run on behalf of 'opCtx' time their work() calls even when
+     * 'internalQueryExecTimeStagesOnlyWhenNeeded' is set. Used by explain, which reports the
+     * per-stage timings.
+     */
+    static void setAlwaysTimeStages(OperationContext* opCtx);
+
     /**
      * Perform a unit of work on the query.  Ask the stage to produce the next unit of output.
      * Stage returns StageState::ADVANCED if *out is set to the next unit of output.  Otherwise,
@@ -385,6 +392,17 @@ protected:
     CommonStats _commonStats;
 
 private:
+    /**
+     * Returns whether work() should time itself into 'executionTimeMillis'. Timing reads the clock
+     * twice per call, and only explain and the profiler report the result.
+     */
+    bool _shouldTimeWork() const;
+
+    /**
+     * Calls doWork() and updates the counters in '_commonStats'.
+     */
+    StageState _doWorkAndCount(WorkingSetID* out);
+
     OperationContext* _opCtx;
 };
 
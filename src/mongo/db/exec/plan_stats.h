@@ -491,6 +491,9 @@ struct SortStats : public SpecificStats {
 
     // The pattern according to which we are sorting.
     BSONObj sortPattern;
+
+    // Whether the sort spilled data to disk.
+    bool usedDisk = false;
 };
 
 struct MergeSortStats : public SpecificStats {
@@ -294,6 +294,9 @@ ProjectionStageSimple::ProjectionStageSimple(OperationContext* opCtx,
     invariant(projObjHasOwnedData());
     // Figure out what fields are in the projection.
     getSimpleInclusionFields(_projObj, &_includedFields);
+    for (auto&& field : _includedFields) {
+        _includedNameLengths |= 1ULL << std::min<size_t>(field.first.size(), 63);
+    }
 }
 
 Status ProjectionStageSimple::transform(WorkingSetMember* member) const {
@@ -303,16 +306,27 @@ Status ProjectionStageSimple::transform(WorkingSetMember* member) const {
     invariant(member->hasObj());
 
     // Apply the SIMPLE_DOC projection.
-    // Look at every field in the source document and see if we're including it.
+    // Look at every field in the source document and see if we're including it. The elements of
+    // a BSONObj are laid out back to back, so each run of adjacent included fields is copied into
+    // the builder as one block of bytes.
+    const char* runStart = nullptr;
+    const char* runEnd = nullptr;
     BSONObjIterator inputIt(member->obj.value());
     while (inputIt.more()) {
         BSONElement elt = inputIt.next();
-        auto fieldIt = _includedFields.find(elt.fieldNameStringData());
-        if (_includedFields.end() != fieldIt) {
-            // If so, add it to the builder.
-            bob.append(elt);
+        if (isIncluded(elt.fieldNameStringData())) {
+            if (!runStart) {
+                runStart = elt.rawdata();
+            }
+            runEnd = elt.rawdata() + elt.size();
+        } else if (runStart) {
+            bob.bb().appendBuf(runStart, runEnd - runStart);
+            runStart = nullptr;
         }
     }
+    if (runStart) {
+        bob.bb().appendBuf(runStart, runEnd - runStart);
+    }
 
     transitionMemberToOwnedObj(bob.obj(), member);
     return Status::OK();
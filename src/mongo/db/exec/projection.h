@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <algorithm>
+
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/exec/projection_exec.h"
 #include "mongo/db/jsobj.h"
@@ -179,8 +181,23 @@ public:
 private:
     Status transform(WorkingSetMember* member) const final;
 
+    /**
+     * Returns whether the projection includes the top-level field 'fieldName'.
+     */
+    bool isIncluded(StringData fieldName) const {
+        // Most fields of a wide document can be ruled out by the length of their name alone.
+        if (!(_includedNameLengths & (1ULL << std::min<size_t>(fieldName.size(), 63)))) {
+            return false;
+        }
+        return _includedFields.find(fieldName) != _includedFields.end();
+    }
+
     // Has the field names present in the simple projection.
     FieldSet _includedFields;
+
+    // Bit i is set if some field in '_includedFields' has a name of length i, where bit 63 stands
+    // for every length of 63 or more.
+    uint64_t _includedNameLengths = 0;
 };
 
 }  // namespace mongo
@@ -104,6 +104,10 @@ public:
         return applyTransformation(Document{inputDoc}).toBson();
     }
 
+    BSONObj serializeTransformation() const {
+        return _projection->serializeTransformation(boost::none).toBson();
+    }
+
     bool applyProjectionToOneField(StringData field) const {
         MutableDocument doc;
         const FieldPath f{field};
@@ -154,6 +158,10 @@ ProjectionExecAgg::ProjectionType ProjectionExecAgg::getType() const {
     return _exec->getType();
 }
 
+BSONObj ProjectionExecAgg::serializeTransformation() const {
+    return _exec->serializeTransformation();
+}
+
 BSONObj ProjectionExecAgg::applyProjection(BSONObj inputDoc) const {
     return _exec->applyProjection(inputDoc);
 }
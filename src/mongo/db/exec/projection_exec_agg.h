@@ -84,6 +84,12 @@ public:
 
     ProjectionType getType() const;
 
+    /**
+     * Returns the projection in normalized form: dotted paths are expanded into nested objects,
+     * every projected leaf is a boolean, and the default _id policy has been applied.
+     */
+    BSONObj serializeTransformation() const;
+
     BSONObj getProjectionSpec() const {
         return _projSpec;
     }
@@ -37,10 +37,12 @@
 
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/service_context_d_test_fixture.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
+#include "mongo/util/scopeguard.h"
 
 using namespace mongo;
 
@@ -124,4 +126,66 @@ TEST_F(QueuedDataStageTest, validateStats) {
     unique_ptr<PlanStageStats> allStats(mock->getStats());
     ASSERT_TRUE(stats->isEOF);
 }
+
+/**
+ * Wraps a child stage and advances the mock fast clock by 10 milliseconds in every work() call.
+ */
+class ClockAdvancingStage final : public PlanStage {
+public:
+    ClockAdvancingStage(OperationContext* opCtx, unique_ptr<PlanStage> child)
+        : PlanStage(opCtx, std::move(child), "CLOCK_ADVANCING") {}
+
+    StageState doWork(WorkingSetID* out) final {
+        auto clock = getOpCtx()->getServiceContext()->getFastClockSource();
+        static_cast<ClockSourceMock*>(clock)->advance(Milliseconds(10));
+        return child()->work(out);
+    }
+
+    bool isEOF() final {
+        return child()->isEOF();
+    }
+
+    StageType stageType() const final {
+        return STAGE_UNKNOWN;
+    }
+
+    unique_ptr<PlanStageStats> getStats() final {
+        return make_unique<PlanStageStats>(_commonStats, stageType());
+    }
+
+    const SpecificStats* getSpecificStats() const final {
+        return nullptr;
+    }
+};
+
+//
+// Test that stages only time their work when needed if asked to.
+//
+TEST_F(QueuedDataStageTest, TimesWorkOnlyWhenNeeded) {
+    WorkingSet ws;
+    WorkingSetID wsID;
+    auto queued = make_unique<QueuedDataStage>(getOpCtx(), &ws);
+    for (int i = 0; i < 3; ++i) {
+        queued->pushBack(PlanStage::NEED_TIME);
+    }
+    ClockAdvancingStage stage(getOpCtx(), std::move(queued));
+    const CommonStats* stats = stage.getCommonStats();
+
+    stage.work(&wsID);
+    ASSERT_EQUALS(stats->executionTimeMillis, 10);
+
+    internalQueryExecTimeStagesOnlyWhenNeeded.store(true);
+    ON_BLOCK_EXIT([] { internalQueryExecTimeStagesOnlyWhenNeeded.store(false); });
+
+    // Nothing will report the timings, but the counters are still maintained.
+    stage.work(&wsID);
+    ASSERT_EQUALS(stats->executionTimeMillis, 10);
+    ASSERT_EQUALS(stats->works, 2U);
+    ASSERT_EQUALS(stats->needTime, 2U);
+
+    // Explain reports the timings.
+    PlanStage::setAlwaysTimeStages(getOpCtx());
+    stage.work(&wsID);
+    ASSERT_EQUALS(stats->executionTimeMillis, 20);
+}
 }
@@ -0,0 +1,238 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_bitmap.h"
+
+#include <algorithm>
+#include <bitset>
+#include <iterator>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+constexpr size_t kBitsetWords = (1 << 16) / 64;
+
+size_t popCount(const std::vector<uint64_t>& bitset) {
+    size_t count = 0;
+    for (auto word : bitset) {
+        count += std::bitset<64>(word).count();
+    }
+    return count;
+}
+
+}  // namespace
+
+bool RecordIdBitmap::insert(const RecordId& id) {
+    const auto key = _toKey(id);
+    if (!_blocks[key >> kLowBits].insert(static_cast<uint16_t>(key))) {
+        return false;
+    }
+    ++_size;
+    return true;
+}
+
+bool RecordIdBitmap::contains(const RecordId& id) const {
+    const auto key = _toKey(id);
+    const auto it = _blocks.find(key >> kLowBits);
+    return it != _blocks.end() && it->second.contains(static_cast<uint16_t>(key));
+}
+
+void RecordIdBitmap::intersectWith(const RecordIdBitmap& other) {
+    _size = 0;
+    for (auto it = _blocks.begin(); it != _blocks.end();) {
+        const auto otherIt = other._blocks.find(it->first);
+        if (otherIt != other._blocks.end()) {
+            it->second.intersectWith(otherIt->second);
+        }
+
+        if (otherIt == other._blocks.end() || it->second.size() == 0) {
+            it = _blocks.erase(it);
+        } else {
+            _size += it->second.size();
+            ++it;
+        }
+    }
+}
+
+void RecordIdBitmap::unionWith(const RecordIdBitmap& other) {
+    _size = 0;
+    for (const auto& otherBlock : other._blocks) {
+        _blocks[otherBlock.first].unionWith(otherBlock.second);
+    }
+    for (const auto& block : _blocks) {
+        _size += block.second.size();
+    }
+}
+
+void RecordIdBitmap::clear() {
+    _blocks.clear();
+    _size = 0;
+}
+
+size_t RecordIdBitmap::getMemUsage() const {
+    // Approximates the overhead of a std::map node with four pointers.
+    size_t memUsage = sizeof(*this);
+    for (const auto& block : _blocks) {
+        memUsage += 4 * sizeof(void*) + sizeof(block) + block.second.getMemUsage();
+    }
+    return memUsage;
+}
+
+bool RecordIdBitmap::Block::insert(uint16_t low) {
+    if (_isBitset) {
+        auto& word = _bitset[low / 64];
+        const uint64_t bit = 1ULL << (low % 64);
+        if (word & bit) {
+            return false;
+        }
+        word |= bit;
+        ++_size;
+        return true;
+    }
+
+    const auto it = std::lower_bound(_array.begin(), _array.end(), low);
+    if (it != _array.end() && *it == low) {
+        return false;
+    }
+    _array.insert(it, low);
+    ++_size;
+
+    if (_size > kMaxArraySize) {
+        _toBitset();
+    }
+    return true;
+}
+
+bool RecordIdBitmap::Block::contains(uint16_t low) const {
+    if (_isBitset) {
+        return _bitset[low / 64] & (1ULL << (low % 64));
+    }
+    return std::binary_search(_array.begin(), _array.end(), low);
+}
+
+void RecordIdBitmap::Block::intersectWith(const Block& other) {
+    if (_isBitset && other._isBitset) {
+        for (size_t word = 0; word < kBitsetWords; ++word) {
+            _bitset[word] &= other._bitset[word];
+        }
+        _size = popCount(_bitset);
+        _toArrayIfSmall();
+        return;
+    }
+
+    // At least one side is a sorted array, so the result fits in a sorted array.
+    std::vector<uint16_t> result;
+    if (!_isBitset && !other._isBitset) {
+        std::set_intersection(_array.begin(),
+                              _array.end(),
+                              other._array.begin(),
+                              other._array.end(),
+                              std::back_inserter(result));
+    } else {
+        const auto& array = _isBitset ? other._array : _array;
+        const auto& bitset = _isBitset ? *this : other;
+        std::copy_if(array.begin(),
+                     array.end(),
+                     std::back_inserter(result),
+                     [&](uint16_t low) { return bitset.contains(low); });
+    }
+
+    _isBitset = false;
+    _bitset = std::vector<uint64_t>();
+    _array = std::move(result);
+    _size = _array.size();
+}
+
+void RecordIdBitmap::Block::unionWith(const Block& other) {
+    if (!_isBitset && !other._isBitset) {
+        std::vector<uint16_t> result;
+        result.reserve(_array.size() + other._array.size());
+        std::set_union(_array.begin(),
+                       _array.end(),
+                       other._array.begin(),
+                       other._array.end(),
+                       std::back_inserter(result));
+        _array = std::move(result);
+        _size = _array.size();
+        if (_size > kMaxArraySize) {
+            _toBitset();
+        }
+        return;
+    }
+
+    if (!other._isBitset) {
+        for (auto low : other._array) {
+            insert(low);
+        }
+        return;
+    }
+
+    if (!_isBitset) {
+        _toBitset();
+    }
+    for (size_t word = 0; word < kBitsetWords; ++word) {
+        _bitset[word] |= other._bitset[word];
+    }
+    _size = popCount(_bitset);
+}
+
+size_t RecordIdBitmap::Block::getMemUsage() const {
+    return _array.capacity() * sizeof(uint16_t) + _bitset.capacity() * sizeof(uint64_t);
+}
+
+void RecordIdBitmap::Block::_toBitset() {
+    invariant(!_isBitset);
+    _bitset.assign(kBitsetWords, 0);
+    for (auto low : _array) {
+        _bitset[low / 64] |= 1ULL << (low % 64);
+    }
+    _array = std::vector<uint16_t>();
+    _isBitset = true;
+}
+
+void RecordIdBitmap::Block::_toArrayIfSmall() {
+    invariant(_isBitset);
+    if (_size > kMaxArraySize) {
+        return;
+    }
+
+    std::vector<uint16_t> array;
+    array.reserve(_size);
+    forEach([&](uint16_t low) { array.push_back(low); });
+    _array = std::move(array);
+    _bitset = std::vector<uint64_t>();
+    _isBitset = false;
+}
+
+}  // namespace mongo
@@ -0,0 +1,156 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "mongo/db/record_id.h"
+#include "mongo/platform/bits.h"
+
+namespace mongo {
+
+/**
+ * A compressed set of RecordIds which can be iterated in ascending RecordId order.
+ *
+ * The RecordIds are split by their high 48 bits into blocks of 65536 consecutive values. A block
+ * holding few RecordIds keeps their low 16 bits in a sorted array, and a block holding many keeps
+ * a bitset instead, so that a set of RecordIds from a mostly dense range costs about a bit each.
+ * This makes it cheaper than a hash set for deduplicating and intersecting the outputs of index
+ * scans, which only need to know whether a RecordId has been seen.
+ */
+class RecordIdBitmap {
+public:
+    /**
+     * Adds 'id' to the set. Returns true if it was not already present.
+     */
+    bool insert(const RecordId& id);
+
+    bool contains(const RecordId& id) const;
+
+    /**
+     * Removes all RecordIds which are not also in 'other'.
+     */
+    void intersectWith(const RecordIdBitmap& other);
+
+    /**
+     * Adds all RecordIds from 'other'.
+     */
+    void unionWith(const RecordIdBitmap& other);
+
+    void clear();
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    /**
+     * Returns an estimate of the memory used by this set, in bytes.
+     */
+    size_t getMemUsage() const;
+
+    /**
+     * Calls 'fn' with each RecordId of the set, in ascending order.
+     */
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const auto& block : _blocks) {
+            const uint64_t high = block.first << kLowBits;
+            block.second.forEach([&](uint16_t low) { fn(_toRecordId(high | low)); });
+        }
+    }
+
+private:
+    static constexpr int kLowBits = 16;
+
+    /**
+     * The low 16 bits of the RecordIds of one block, either as a sorted array or as a bitset.
+     */
+    class Block {
+    public:
+        bool insert(uint16_t low);
+        bool contains(uint16_t low) const;
+        void intersectWith(const Block& other);
+        void unionWith(const Block& other);
+        size_t getMemUsage() const;
+
+        size_t size() const {
+            return _size;
+        }
+
+        template <typename Fn>
+        void forEach(Fn&& fn) const {
+            if (!_isBitset) {
+                for (auto low : _array) {
+                    fn(low);
+                }
+                return;
+            }
+
+            for (size_t word = 0; word < _bitset.size(); ++word) {
+                for (uint64_t bits = _bitset[word]; bits; bits &= bits - 1) {
+                    fn(static_cast<uint16_t>(word * 64 + countTrailingZeros64(bits)));
+                }
+            }
+        }
+
+    private:
+        // Past this size, a sorted array of 16-bit values takes more memory than the bitset.
+        static constexpr size_t kMaxArraySize = 4096;
+
+        void _toBitset();
+        void _toArrayIfSmall();
+
+        bool _isBitset = false;
+        size_t _size = 0;
+        std::vector<uint16_t> _array;
+        std::vector<uint64_t> _bitset;
+    };
+
+    // Maps the RecordId space onto unsigned integers while preserving order.
+    static uint64_t _toKey(const RecordId& id) {
+        return static_cast<uint64_t>(id.repr()) ^ (1ULL << 63);
+    }
+
+    static RecordId _toRecordId(uint64_t key) {
+        return RecordId(static_cast<int64_t>(key ^ (1ULL << 63)));
+    }
+
+    // Keyed by the high 48 bits of the keys of the RecordIds they contain.
+    std::map<uint64_t, Block> _blocks;
+    size_t _size = 0;
+};
+
+}  // namespace mongo
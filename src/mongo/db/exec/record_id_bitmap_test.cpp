@@ -0,0 +1,154 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_bitmap.h"
+
+#include <algorithm>
+#include <iterator>
+#include <set>
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::vector<RecordId> toVector(const RecordIdBitmap& bitmap) {
+    std::vector<RecordId> ids;
+    bitmap.forEach([&](const RecordId& id) { ids.push_back(id); });
+    return ids;
+}
+
+TEST(RecordIdBitmapTest, InsertAndContains) {
+    RecordIdBitmap bitmap;
+    ASSERT(bitmap.empty());
+
+    ASSERT(bitmap.insert(RecordId(5)));
+    ASSERT(bitmap.insert(RecordId(1)));
+    ASSERT(bitmap.insert(RecordId(1LL << 40)));
+    ASSERT(!bitmap.insert(RecordId(5)));
+
+    ASSERT_EQ(3U, bitmap.size());
+    ASSERT(bitmap.contains(RecordId(1)));
+    ASSERT(bitmap.contains(RecordId(5)));
+    ASSERT(bitmap.contains(RecordId(1LL << 40)));
+    ASSERT(!bitmap.contains(RecordId(2)));
+    ASSERT(!bitmap.contains(RecordId((1LL << 40) + 1)));
+
+    bitmap.clear();
+    ASSERT(bitmap.empty());
+    ASSERT(!bitmap.contains(RecordId(5)));
+}
+
+TEST(RecordIdBitmapTest, IteratesInRecordIdOrder) {
+    RecordIdBitmap bitmap;
+    const std::vector<RecordId> ids = {RecordId::min(),
+                                       RecordId(-70000),
+                                       RecordId(-1),
+                                       RecordId(1),
+                                       RecordId(65535),
+                                       RecordId(65536),
+                                       RecordId(1LL << 40),
+                                       RecordId::max()};
+    for (auto it = ids.rbegin(); it != ids.rend(); ++it) {
+        ASSERT(bitmap.insert(*it));
+    }
+
+    ASSERT(ids == toVector(bitmap));
+}
+
+TEST(RecordIdBitmapTest, DenseBlockUsesLessMemory) {
+    RecordIdBitmap sparse;
+    RecordIdBitmap dense;
+    for (int64_t i = 1; i <= 60000; ++i) {
+        ASSERT(sparse.insert(RecordId(i * 65536)));
+        ASSERT(dense.insert(RecordId(i)));
+    }
+
+    ASSERT_EQ(60000U, dense.size());
+    ASSERT_LT(dense.getMemUsage(), 10000U);
+    ASSERT_GT(sparse.getMemUsage(), dense.getMemUsage());
+
+    int64_t expected = 1;
+    dense.forEach([&](const RecordId& id) { ASSERT_EQ(RecordId(expected++), id); });
+    ASSERT_EQ(60001, expected);
+    ASSERT(!dense.insert(RecordId(30000)));
+    ASSERT(!dense.contains(RecordId(60001)));
+}
+
+TEST(RecordIdBitmapTest, IntersectAndUnionMatchStdSet) {
+    // Mixes sparse and dense blocks on both sides.
+    RecordIdBitmap left;
+    RecordIdBitmap right;
+    std::set<RecordId> leftSet;
+    std::set<RecordId> rightSet;
+    for (int64_t i = 0; i < 20000; ++i) {
+        for (auto id : {RecordId(i * 2), RecordId(200000 + i * 7)}) {
+            left.insert(id);
+            leftSet.insert(id);
+        }
+        for (auto id : {RecordId(i * 3), RecordId(200000 + i * 5)}) {
+            right.insert(id);
+            rightSet.insert(id);
+        }
+    }
+
+    std::vector<RecordId> expectedIntersection;
+    std::set_intersection(leftSet.begin(),
+                          leftSet.end(),
+                          rightSet.begin(),
+                          rightSet.end(),
+                          std::back_inserter(expectedIntersection));
+    std::vector<RecordId> expectedUnion;
+    std::set_union(leftSet.begin(),
+                   leftSet.end(),
+                   rightSet.begin(),
+                   rightSet.end(),
+                   std::back_inserter(expectedUnion));
+
+    RecordIdBitmap intersection = left;
+    intersection.intersectWith(right);
+    ASSERT_EQ(expectedIntersection.size(), intersection.size());
+    ASSERT(expectedIntersection == toVector(intersection));
+
+    RecordIdBitmap unioned = left;
+    unioned.unionWith(right);
+    ASSERT_EQ(expectedUnion.size(), unioned.size());
+    ASSERT(expectedUnion == toVector(unioned));
+
+    // Shrinking a dense block back into a sparse one keeps it usable.
+    intersection.intersectWith(RecordIdBitmap());
+    ASSERT(intersection.empty());
+    ASSERT(intersection.insert(RecordId(4)));
+    ASSERT(toVector(intersection) == std::vector<RecordId>{RecordId(4)});
+}
+
+}  // namespace
+}  // namespace mongo
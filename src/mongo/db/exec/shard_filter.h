@@ -29,8 +29,12 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+#include <memory>
+
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/s/scoped_collection_metadata.h"
+#include "mongo/s/shard_key_pattern.h"
 
 namespace mongo {
 
@@ -99,6 +103,10 @@ private:
     // Note: it is important that this is the metadata from the time this stage is constructed.
     // See class comment for details.
     ScopedCollectionMetadata _metadata;
+
+    // Set up from '_metadata' when the first result is filtered, rather than for each result.
+    boost::optional<ShardKeyPattern> _shardKeyPattern;
+    std::shared_ptr<const OwnedChunkRanges> _ownedChunkRanges;
 };
 
 }  // namespace mongo
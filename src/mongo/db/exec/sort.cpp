@@ -42,6 +42,8 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 
@@ -52,13 +54,107 @@ using std::unique_ptr;
 using std::vector;
 using stdx::make_unique;
 
+namespace {
+
+/**
+ * Generates a new file name on each call using a static, atomic and monotonically increasing
+ * number. See the comment on nextFileName() in document_source_sort.cpp.
+ */
+std::string nextFileName() {
+    static AtomicWord<unsigned> sortStageFileCounter;
+    return "extsort-sort-stage." + std::to_string(sortStageFileCounter.fetchAndAdd(1));
+}
+
+// Flags describing which optional fields follow a serialized SpilledItem.
+enum SpilledItemFlags : char {
+    kHasRecordId = 1 << 0,
+    kHasTextScore = 1 << 1,
+    kHasGeoDistance = 1 << 2,
+};
+
+}  // namespace
+
 // static
 const char* SortStage::kStageType = "SORT";
 
-SortStage::WorkingSetComparator::WorkingSetComparator(BSONObj p) : pattern(p) {}
+void SortStage::SpilledItem::serializeForSorter(BufBuilder& buf) const {
+    char flags = 0;
+    if (hasRecordId) {
+        flags |= kHasRecordId;
+    }
+    if (textScore) {
+        flags |= kHasTextScore;
+    }
+    if (geoDistance) {
+        flags |= kHasGeoDistance;
+    }
+    buf.appendChar(flags);
+    if (hasRecordId) {
+        buf.appendNum(static_cast<long long>(recordId.repr()));
+    }
+    if (textScore) {
+        buf.appendNum(*textScore);
+    }
+    if (geoDistance) {
+        buf.appendNum(*geoDistance);
+    }
+    obj.serializeForSorter(buf);
+}
+
+SortStage::SpilledItem SortStage::SpilledItem::deserializeForSorter(
+    BufReader& buf, const SorterDeserializeSettings& settings) {
+    SpilledItem item;
+    const char flags = buf.read<char>();
+    if (flags & kHasRecordId) {
+        item.hasRecordId = true;
+        item.recordId = RecordId(buf.read<LittleEndian<long long>>());
+    }
+    if (flags & kHasTextScore) {
+        item.textScore = buf.read<LittleEndian<double>>();
+    }
+    if (flags & kHasGeoDistance) {
+        item.geoDistance = buf.read<LittleEndian<double>>();
+    }
+    item.obj = BSONObj::deserializeForSorter(buf, BSONObj::SorterDeserializeSettings());
+    return item;
+}
+
+int SortStage::SpilledItem::memUsageForSorter() const {
+    return sizeof(SpilledItem) + obj.objsize();
+}
+
+SortStage::SpilledItem SortStage::SpilledItem::getOwned() const {
+    SpilledItem owned(*this);
+    owned.obj = obj.getOwned();
+    return owned;
+}
+
+int SortStage::SpilledItemComparator::operator()(const std::pair<BSONObj, SpilledItem>& lhs,
+                                                 const std::pair<BSONObj, SpilledItem>& rhs) const {
+    // False means ignore field names.
+    int result = lhs.first.woCompare(rhs.first, pattern, false);
+    if (0 != result) {
+        return result;
+    }
+    // Break ties on RecordId, matching WorkingSetComparator.
+    const RecordId lhsId = lhs.second.hasRecordId ? lhs.second.recordId : RecordId();
+    const RecordId rhsId = rhs.second.hasRecordId ? rhs.second.recordId : RecordId();
+    return lhsId.compare(rhsId);
+}
+
+SortStage::WorkingSetComparator::WorkingSetComparator(BSONObj p) : pattern(p) {
+    if (static_cast<size_t>(pattern.nFields()) <= Ordering::kMaxCompoundIndexKeys) {
+        ordering = Ordering::make(pattern);
+    }
+}
 
 bool SortStage::WorkingSetComparator::operator()(const SortableDataItem& lhs,
                                                  const SortableDataItem& rhs) const {
+    if (ordering) {
+        // The encoded keys already end with the RecordId which breaks ties.
+        return lhs.encodedKey < rhs.encodedKey;
+    }
+
     // False means ignore field names.
     int result = lhs.sortKey.woCompare(rhs.sortKey, pattern, false);
     if (0 != result) {
@@ -76,6 +172,7 @@ SortStage::SortStage(OperationContext* opCtx,
       _ws(ws),
       _pattern(params.pattern),
       _limit(params.limit),
+      _allowDiskUse(params.allowDiskUse),
       _sorted(false),
       _resultIterator(_data.end()),
       _memUsage(0) {
@@ -83,13 +180,6 @@ SortStage::SortStage(OperationContext* opCtx,
 
     BSONObj sortComparator = FindCommon::transformSortSpec(_pattern);
     _sortKeyComparator = stdx::make_unique<WorkingSetComparator>(sortComparator);
-
-    // If limit > 1, we need to initialize _dataSet here to maintain ordered set of data items while
-    // fetching from the child stage.
-    if (_limit > 1) {
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
-        _dataSet.reset(new SortableDataItemSet(cmp));
-    }
 }
 
 SortStage::~SortStage() {}
@@ -97,18 +187,30 @@ SortStage::~SortStage() {}
 bool SortStage::isEOF() {
     // We're done when our child has no more results, we've sorted the child's results, and
     // we've returned all sorted results.
-    return child()->isEOF() && _sorted && (_data.end() == _resultIterator);
+    if (!child()->isEOF() || !_sorted) {
+        return false;
+    }
+    return _spilledIterator ? !_spilledIterator->more() : (_data.end() == _resultIterator);
 }
 
 PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
+    _trackedMemory.set(getOpCtx(), _memUsage);
+
     const size_t maxBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load());
-    if (_memUsage > maxBytes) {
-        str::stream ss;
-        ss << "Sort operation used more than the maximum " << maxBytes
-           << " bytes of RAM. Add an index, or specify a smaller limit.";
-        Status status(ErrorCodes::OperationFailed, ss);
-        *out = WorkingSetCommon::allocateStatusMember(_ws, status);
-        return PlanStage::FAILURE;
+    if (!_sorter && _memUsage > maxBytes) {
+        if (_allowDiskUse && _allBufferedSpillable) {
+            spillBufferToSorter();
+        } else {
+            str::stream ss;
+            ss << "Sort operation used more than the maximum " << maxBytes
+               << " bytes of RAM. Add an index, or specify a smaller limit.";
+            if (!_allowDiskUse) {
+                ss << " Alternatively, pass allowDiskUse:true to spill the sort to disk.";
+            }
+            Status status(ErrorCodes::OperationFailed, ss);
+            *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+            return PlanStage::FAILURE;
+        }
     }
 
     if (isEOF()) {
@@ -137,7 +239,11 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
                 item.recordId = member->recordId;
             }
 
-            addToBuffer(item);
+            if (_sorter) {
+                addToSorter(item);
+            } else {
+                addToBuffer(std::move(item));
+            }
 
             return PlanStage::NEED_TIME;
         } else if (PlanStage::IS_EOF == code) {
@@ -161,6 +267,12 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
     }
 
     // Returning results.
+    if (_spilledIterator) {
+        auto next = _spilledIterator->next();
+        *out = restoreSpilledItem(next.first, next.second);
+        return PlanStage::ADVANCED;
+    }
+
     verify(_resultIterator != _data.end());
     verify(_sorted);
     *out = _resultIterator->wsid;
@@ -176,6 +288,9 @@ unique_ptr<PlanStageStats> SortStage::getStats() {
     _specificStats.memUsage = _memUsage;
     _specificStats.limit = _limit;
     _specificStats.sortPattern = _pattern.getOwned();
+    if (_sorter) {
+        _specificStats.usedDisk = _sorter->usedDisk();
+    }
 
     unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_SORT);
     ret->specific = make_unique<SortStats>(_specificStats);
@@ -202,16 +317,33 @@ const SpecificStats* SortStage::getSpecificStats() const {
  *                     Updates memory usage if item was replaced.
  *     sortBuffer() - Does nothing.
  * limit > 1:
- *     addToBuffer() - Does not update vector. Adds item to set.
- *                     If size of set exceeds limit, remove item from set
- *                     with lowest key. Updates memory usage accordingly.
- *     sortBuffer() - Copies items from set to vectors.
+ *     addToBuffer() - Adds item to the max-heap in vector.
+ *                     If size of heap exceeds limit, remove item from heap
+ *                     with highest key. Updates memory usage accordingly.
+ *     sortBuffer() - Sorts the heap in place.
+ *
+ * Once the stage has spilled, addToSorter() is used in place of addToBuffer() and sortBuffer()
+ * obtains the sorted iterator from the external sorter.
  */
-void SortStage::addToBuffer(const SortableDataItem& item) {
+void SortStage::encodeSortKey(SortableDataItem* item) const {
+    if (!_sortKeyComparator->ordering) {
+        return;
+    }
+    KeyString encoded(KeyString::Version::V1,
+                      item->sortKey,
+                      *_sortKeyComparator->ordering,
+                      item->recordId);
+    item->encodedKey.assign(encoded.getBuffer(), encoded.getSize());
+}
+
+void SortStage::addToBuffer(SortableDataItem item) {
     // Holds ID of working set member to be freed at end of this function.
     WorkingSetID wsidToFree = WorkingSet::INVALID_ID;
 
+    encodeSortKey(&item);
+
     WorkingSetMember* member = _ws->get(item.wsid);
+    _allBufferedSpillable = _allBufferedSpillable && isSpillable(*member);
     if (_limit == 0) {
         // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
         member->makeObjOwnedIfNeeded();
@@ -234,33 +366,27 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
             _memUsage = member->getMemUsage();
         }
     } else {
-        // Update data item set instead of vector
-        // Limit not reached - insert and return
-        vector<SortableDataItem>::size_type limit(_limit);
-        if (_dataSet->size() < limit) {
+        // Limit not reached - push onto the heap and return.
+        const WorkingSetComparator& cmp = *_sortKeyComparator;
+        if (_data.size() < _limit) {
             member->makeObjOwnedIfNeeded();
-            _dataSet->insert(item);
+            _data.push_back(std::move(item));
+            std::push_heap(_data.begin(), _data.end(), cmp);
             _memUsage += member->getMemUsage();
             return;
         }
-        // Limit will be exceeded - compare with item with lowest key
-        // If new item does not have a lower key value than last item,
-        // do nothing.
+        // Limit will be exceeded - compare with the item with the highest key at the top of the
+        // heap. If new item does not have a lower key value than that item, do nothing.
         wsidToFree = item.wsid;
-        SortableDataItemSet::const_iterator lastItemIt = --(_dataSet->end());
-        const SortableDataItem& lastItem = *lastItemIt;
-        const WorkingSetComparator& cmp = *_sortKeyComparator;
-        if (cmp(item, lastItem)) {
+        if (cmp(item, _data.front())) {
+            std::pop_heap(_data.begin(), _data.end(), cmp);
+            SortableDataItem& lastItem = _data.back();
             _memUsage -= _ws->get(lastItem.wsid)->getMemUsage();
             _memUsage += member->getMemUsage();
             wsidToFree = lastItem.wsid;
-            // According to std::set iterator validity rules,
-            // it does not matter which of erase()/insert() happens first.
-            // Here, we choose to erase first to release potential resources
-            // used by the last item and to keep the scope of the iterator to a minimum.
-            _dataSet->erase(lastItemIt);
             member->makeObjOwnedIfNeeded();
-            _dataSet->insert(item);
+            lastItem = std::move(item);
+            std::push_heap(_data.begin(), _data.end(), cmp);
         }
     }
 
@@ -273,6 +399,12 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
 }
 
 void SortStage::sortBuffer() {
+    if (_sorter) {
+        _spilledIterator.reset(_sorter->done());
+        _specificStats.usedDisk = _sorter->usedDisk();
+        return;
+    }
+
     if (_limit == 0) {
         const WorkingSetComparator& cmp = *_sortKeyComparator;
         std::sort(_data.begin(), _data.end(), cmp);
@@ -280,13 +412,87 @@ void SortStage::sortBuffer() {
         // Buffer contains either 0 or 1 item so it is already in a sorted state.
         return;
     } else {
-        // Set already contains items in sorted order, so we simply copy the items
-        // from the set to the vector.
-        // Release the memory for the set after the copy.
-        vector<SortableDataItem> newData(_dataSet->begin(), _dataSet->end());
-        _data.swap(newData);
-        _dataSet.reset();
+        const WorkingSetComparator& cmp = *_sortKeyComparator;
+        std::sort_heap(_data.begin(), _data.end(), cmp);
+    }
+}
+
+bool SortStage::isSpillable(const WorkingSetMember& member) {
+    return member.hasObj() && !member.hasComputed(WSM_INDEX_KEY) &&
+        !member.hasComputed(WSM_GEO_NEAR_POINT);
+}
+
+void SortStage::addToSorter(const SortableDataItem& item) {
+    WorkingSetMember* member = _ws->get(item.wsid);
+    uassert(ErrorCodes::OperationFailed,
+            "Sort operation cannot spill results which are not fully fetched documents",
+            isSpillable(*member));
+
+    SpilledItem spilled;
+    spilled.hasRecordId = member->hasRecordId();
+    spilled.recordId = member->recordId;
+    spilled.obj = member->obj.value();
+    if (member->hasComputed(WSM_COMPUTED_TEXT_SCORE)) {
+        spilled.textScore = static_cast<const TextScoreComputedData*>(
+                                member->getComputed(WSM_COMPUTED_TEXT_SCORE))
+                                ->getScore();
+    }
+    if (member->hasComputed(WSM_COMPUTED_GEO_DISTANCE)) {
+        spilled.geoDistance = static_cast<const GeoDistanceComputedData*>(
+                                  member->getComputed(WSM_COMPUTED_GEO_DISTANCE))
+                                  ->getDist();
+    }
+
+    _sorter->add(item.sortKey, spilled);
+    _ws->free(item.wsid);
+}
+
+void SortStage::spillBufferToSorter() {
+    invariant(!_sorter);
+    const size_t maxBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load());
+    SortOptions opts;
+    opts.Limit(_limit)
+        .MaxMemoryUsageBytes(maxBytes)
+        .ExtSortAllowed()
+        .TempDir(storageGlobalParams.dbpath + "/_tmp");
+    _sorter.reset(
+        SpillingSorter::make(opts, SpilledItemComparator(_sortKeyComparator->pattern)));
+
+    for (auto&& item : _data) {
+        addToSorter(item);
+    }
+    _data.clear();
+    _resultIterator = _data.end();
+    _memUsage = 0;
+}
+
+WorkingSetID SortStage::restoreSpilledItem(const BSONObj& sortKey, const SpilledItem& item) {
+    WorkingSetID id = _ws->allocate();
+    WorkingSetMember* member = _ws->get(id);
+
+    // The snapshot the object was read in is unknown once it has been spilled. Leaving the
+    // snapshot id unset ensures that stages which care, such as updates, re-fetch the document.
+    member->obj = Snapshotted<BSONObj>(SnapshotId(), item.obj.getOwned());
+    if (item.hasRecordId) {
+        member->recordId = item.recordId;
+        _ws->transitionToRecordIdAndObj(id);
+    } else {
+        _ws->transitionToOwnedObj(id);
     }
+
+    member->addComputed(new SortKeyComputedData(sortKey));
+    if (item.textScore) {
+        member->addComputed(new TextScoreComputedData(*item.textScore));
+    }
+    if (item.geoDistance) {
+        member->addComputed(new GeoDistanceComputedData(*item.geoDistance));
+    }
+    return id;
 }
 
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+MONGO_CREATE_SORTER(mongo::BSONObj,
+                    mongo::SortStage::SpilledItem,
+                    mongo::SortStage::SpilledItemComparator);
@@ -29,15 +29,17 @@
 
 #pragma once
 
-#include <set>
 #include <vector>
 
+#include "mongo/bson/ordering.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/exec/sort_key_generator.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/operation_memory_tracker.h"
 #include "mongo/db/query/index_bounds.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/sorter/sorter.h"
 #include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
@@ -54,6 +56,9 @@ public:
 
     // Equal to 0 for no limit.
     size_t limit = 0;
+
+    // Whether the stage may spill buffered results to disk once it exceeds the in-memory limit.
+    bool allowDiskUse = false;
 };
 
 /**
@@ -63,6 +68,15 @@ public:
  *   -- For each field in 'pattern', all inputs in the child must handle a getFieldDotted for that
  *   field.
  *   -- All WSMs produced by the child stage must have the sort key available as WSM computed data.
+ *
+ * If 'allowDiskUse' is set and the buffered data grows beyond the in-memory limit, the stage hands
+ * its data to an external Sorter which spills sorted runs to the server's temporary directory.
+ * This is only possible when every buffered member is fetched, since covered members reference
+ * index data which cannot outlive the WorkingSet.
+ *
+ * In memory, each buffered member is ordered by its sort key and RecordId encoded together as a
+ * KeyString, so comparisons are a memcmp. With a limit of k, only the k smallest members are kept
+ * in a max-heap: each new member is compared against the largest one kept and the loser is freed.
  */
 class SortStage final : public PlanStage {
 public:
@@ -99,6 +113,9 @@ private:
     // Equal to 0 for no limit.
     size_t _limit;
 
+    // Whether we may hand buffered data to an external sorter when over the memory limit.
+    const bool _allowDiskUse;
+
     //
     // Data storage
     //
@@ -115,11 +132,14 @@ private:
         // RecordId to break sortKey ties.
         // See sorta.js.
         RecordId recordId;
+        // 'sortKey' followed by 'recordId' as a KeyString in the order of the sort pattern. Empty
+        // if the pattern has too many fields for an Ordering.
+        std::string encodedKey;
     };
 
-    // Comparison object for data buffers (vector and set). Items are compared on (sortKey, loc).
-    // This is also how the items are ordered in the indices. Keys are compared using
-    // BSONObj::woCompare() with RecordId as a tie-breaker.
+    // Comparison object for the data buffer. Items are compared on (sortKey, loc). This is also
+    // how the items are ordered in the indices. Keys are compared as encoded KeyStrings when the
+    // pattern allows, and otherwise using BSONObj::woCompare() with RecordId as a tie-breaker.
     //
     // We are comparing keys generated by the SortKeyGenerator, which are already ordered with
     // respect the collation. Therefore, we explicitly avoid comparing using a collator here.
@@ -129,19 +149,77 @@ private:
         bool operator()(const SortableDataItem& lhs, const SortableDataItem& rhs) const;
 
         BSONObj pattern;
+
+        // Set if 'pattern' has few enough fields to encode sort keys with.
+        boost::optional<Ordering> ordering;
+    };
+
+    /**
+     * Fills out the encoded key of 'item' if the sort pattern allows encoding.
+     */
+    void encodeSortKey(SortableDataItem* item) const;
+
+    /**
+     * The serialized form of a working set member handed to the external sorter. Only fetched
+     * members are spilled, so the object, its RecordId, and the computed data that can be
+     * requested through $meta are enough to rebuild an equivalent member.
+     */
+    struct SpilledItem {
+        struct SorterDeserializeSettings {};  // unused
+        void serializeForSorter(BufBuilder& buf) const;
+        static SpilledItem deserializeForSorter(BufReader& buf, const SorterDeserializeSettings&);
+        int memUsageForSorter() const;
+        SpilledItem getOwned() const;
+
+        bool hasRecordId = false;
+        RecordId recordId;
+        BSONObj obj;
+        boost::optional<double> textScore;
+        boost::optional<double> geoDistance;
+    };
+
+    // Orders (sortKey, SpilledItem) pairs in the same way as WorkingSetComparator.
+    struct SpilledItemComparator {
+        explicit SpilledItemComparator(BSONObj p) : pattern(std::move(p)) {}
+
+        int operator()(const std::pair<BSONObj, SpilledItem>& lhs,
+                       const std::pair<BSONObj, SpilledItem>& rhs) const;
+
+        BSONObj pattern;
     };
 
+    using SpillingSorter = Sorter<BSONObj, SpilledItem>;
+
+    /**
+     * Returns true if the member can be serialized to a SpilledItem without losing data.
+     */
+    static bool isSpillable(const WorkingSetMember& member);
+
     /**
-     * Inserts one item into data buffer (vector or set).
-     * If limit is exceeded, remove item with lowest key.
+     * Converts the member with id 'wsid' to a SpilledItem, adds it to '_sorter', and frees the
+     * member.
      */
-    void addToBuffer(const SortableDataItem& item);
+    void addToSorter(const SortableDataItem& item);
+
+    /**
+     * Creates '_sorter' and moves all of the data buffered in memory into it.
+     */
+    void spillBufferToSorter();
+
+    /**
+     * Allocates a new working set member holding the contents of 'item'.
+     */
+    WorkingSetID restoreSpilledItem(const BSONObj& sortKey, const SpilledItem& item);
+
+    /**
+     * Inserts one item into the data buffer.
+     * If limit is exceeded, remove item with highest key.
+     */
+    void addToBuffer(SortableDataItem item);
 
     /**
      * Sorts data buffer.
      * Assumes no more items will be added to buffer.
-     * If data is stored in set, copy set
-     * contents to vector and clear set.
      */
     void sortBuffer();
 
@@ -153,20 +231,28 @@ private:
     // _data will contain sorted data when all data is gathered
     // and sorted.
     // When _limit is greater than 1 and not all data has been gathered from child stage,
-    // _dataSet is used instead to maintain an ordered set of the incomplete data set.
-    // When the data set is complete, we copy the items from _dataSet to _data which will
-    // be used to provide the results of this stage through _resultIterator.
+    // _data is a max-heap of the _limit smallest items seen so far.
     std::vector<SortableDataItem> _data;
-    typedef std::set<SortableDataItem, WorkingSetComparator> SortableDataItemSet;
-    std::unique_ptr<SortableDataItemSet> _dataSet;
 
     // Iterates through _data post-sort returning it.
     std::vector<SortableDataItem>::iterator _resultIterator;
 
+    // Set once the buffered data exceeds the memory limit and has been handed off to an external
+    // sorter. From then on, all inputs are added to '_sorter' and results are returned from
+    // '_spilledIterator'.
+    std::unique_ptr<SpillingSorter> _sorter;
+    std::unique_ptr<SpillingSorter::Iterator> _spilledIterator;
+
+    // False once a member that cannot be spilled (for example, a covered member) is buffered.
+    bool _allBufferedSpillable = true;
+
     SortStats _specificStats;
 
     // The usage in bytes of all buffered data that we're sorting.
     size_t _memUsage;
+
+    // Reports '_memUsage' to the memory tracker of the operation we are running in.
+    TrackedMemoryUsage _trackedMemory;
 };
 
 }  // namespace mongo
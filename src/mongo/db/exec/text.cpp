@@ -123,7 +123,15 @@ unique_ptr<PlanStage> TextStage::buildTextTree(OperationContext* opCtx,
     if (wantTextScore) {
         // We use a TEXT_OR stage to get the union of the results from the index scans and then
         // compute their text scores. This is a blocking operation.
-        auto textScorer = make_unique<TextOrStage>(opCtx, _params.spec, ws, filter, collection);
+        // TEXT_OR can stop early with the top k results only if the TEXT_MATCH stage above it is
+        // guaranteed to pass every document it returns.
+        const bool matchCanRejectDocuments = !_params.query.getNegatedTerms().empty() ||
+            !_params.query.getPositivePhr().empty() || !_params.query.getNegatedPhr().empty() ||
+            _params.query.getCaseSensitive() || _params.query.getDiacriticSensitive();
+        const size_t topK = matchCanRejectDocuments ? 0 : _params.topK;
+
+        auto textScorer =
+            make_unique<TextOrStage>(opCtx, _params.spec, ws, filter, collection, topK);
 
         textScorer->addChildren(std::move(indexScanList));
 
@@ -64,6 +64,9 @@ struct TextStageParams {
     // True if we need the text score in the output, because the projection includes the 'textScore'
     // metadata field.
     bool wantTextScore = true;
+
+    // If non-zero, only the 'topK' highest scoring results are needed by the consumer.
+    size_t topK = 0u;
 };
 
 /**
@@ -29,6 +29,7 @@
 
 #include "mongo/db/exec/text_or.h"
 
+#include <algorithm>
 #include <map>
 #include <vector>
 
@@ -58,11 +59,13 @@ TextOrStage::TextOrStage(OperationContext* opCtx,
                          const FTSSpec& ftsSpec,
                          WorkingSet* ws,
                          const MatchExpression* filter,
-                         const Collection* collection)
+                         const Collection* collection,
+                         size_t topK)
     : RequiresCollectionStage(kStageType, opCtx, collection),
       _ftsSpec(ftsSpec),
       _ws(ws),
       _scoreIterator(_scores.end()),
+      _topK(topK),
       _filter(filter),
       _idRetrying(WorkingSet::INVALID_ID) {}
 
@@ -137,10 +140,10 @@ PlanStage::StageState TextOrStage::doWork(WorkingSetID* out) {
             stageState = initStage(out);
             break;
         case State::kReadingTerms:
-            stageState = readFromChildren(out);
+            stageState = _topK ? readFromChildrenTopK(out) : readFromChildren(out);
             break;
         case State::kReturningResults:
-            stageState = returnResults(out);
+            stageState = _topK ? returnTopKResults(out) : returnResults(out);
             break;
         case State::kDone:
             // Should have been handled above.
@@ -156,6 +159,16 @@ PlanStage::StageState TextOrStage::initStage(WorkingSetID* out) {
     try {
         _recordCursor = collection()->getCursor(getOpCtx());
         _internalState = State::kReadingTerms;
+
+        // Each document tracks the children which returned it in a 64-bit mask.
+        if (_children.empty() || _children.size() > 64) {
+            _topK = 0;
+        }
+        if (_topK) {
+            _childMaxScores.assign(_children.size(), fts::MAX_WEIGHT);
+            _childExhausted.assign(_children.size(), false);
+            _nextTopKCheck = _topK;
+        }
         return PlanStage::NEED_TIME;
     } catch (const WriteConflictException&) {
         invariant(_internalState == State::kInit);
@@ -219,6 +232,148 @@ PlanStage::StageState TextOrStage::readFromChildren(WorkingSetID* out) {
     }
 }
 
+PlanStage::StageState TextOrStage::readFromChildrenTopK(WorkingSetID* out) {
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    StageState childState = _children[_currentChild]->work(&id);
+
+    if (PlanStage::ADVANCED == childState) {
+        addTermTopK(id);
+        ++_entriesRead;
+    } else if (PlanStage::IS_EOF == childState) {
+        _childMaxScores[_currentChild] = 0;
+        _childExhausted[_currentChild] = true;
+        ++_numChildrenExhausted;
+    } else if (PlanStage::FAILURE == childState) {
+        if (WorkingSet::INVALID_ID == id) {
+            str::stream ss;
+            ss << "TEXT_OR stage failed to read in results from child";
+            Status status(ErrorCodes::InternalError, ss);
+            *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+        } else {
+            *out = id;
+        }
+        return PlanStage::FAILURE;
+    } else {
+        // Propagate WSID from below, and keep working the same child.
+        *out = id;
+        return childState;
+    }
+
+    const bool allChildrenExhausted = _numChildrenExhausted == _children.size();
+    if (allChildrenExhausted || _entriesRead >= _nextTopKCheck) {
+        if (selectTopK()) {
+            _internalState = State::kReturningResults;
+            return PlanStage::NEED_TIME;
+        }
+        invariant(!allChildrenExhausted);
+
+        // Testing the bounds is linear in the number of documents seen, so test less often as
+        // more of them are read.
+        _nextTopKCheck = 2 * _entriesRead;
+    }
+
+    do {
+        _currentChild = (_currentChild + 1) % _children.size();
+    } while (_childExhausted[_currentChild]);
+    return PlanStage::NEED_TIME;
+}
+
+bool TextOrStage::selectTopK() {
+    const bool allChildrenExhausted = _numChildrenExhausted == _children.size();
+
+    // The highest score a document can reach is its score so far, plus the bound of each child
+    // which has not returned it yet.
+    auto maxPossibleScore = [this](const TextRecordData& data) {
+        double maxScore = data.score;
+        for (size_t i = 0; i < _childMaxScores.size(); ++i) {
+            if (!(data.childrenSeen & (uint64_t{1} << i))) {
+                maxScore += _childMaxScores[i];
+            }
+        }
+        return maxScore;
+    };
+
+    std::vector<const TextRecordData*> candidates;
+    for (auto&& scorePair : _scores) {
+        if (scorePair.second.score >= 0) {
+            candidates.push_back(&scorePair.second);
+        }
+    }
+    if (candidates.size() < _topK && !allChildrenExhausted) {
+        return false;
+    }
+
+    const size_t numResults = std::min(_topK, candidates.size());
+    if (numResults > 0) {
+        std::nth_element(candidates.begin(),
+                         candidates.begin() + numResults - 1,
+                         candidates.end(),
+                         [](const TextRecordData* lhs, const TextRecordData* rhs) {
+                             return lhs->score > rhs->score;
+                         });
+    }
+
+    if (!allChildrenExhausted) {
+        const double kthScore = candidates[numResults - 1]->score;
+
+        // A document none of the children has returned yet scores at most the sum of their bounds.
+        double unseenMaxScore = 0;
+        for (double childMaxScore : _childMaxScores) {
+            unseenMaxScore += childMaxScore;
+        }
+        if (unseenMaxScore > kthScore) {
+            return false;
+        }
+
+        // The scores of the chosen documents must be final, and no other document may be able to
+        // overtake them.
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            const double bound = i < numResults ? candidates[i]->score : kthScore;
+            if (maxPossibleScore(*candidates[i]) > bound) {
+                return false;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (i < numResults) {
+            _topKResults.emplace_back(candidates[i]->wsid, candidates[i]->score);
+        } else {
+            _ws->free(candidates[i]->wsid);
+        }
+    }
+    _scores.clear();
+    return true;
+}
+
+PlanStage::StageState TextOrStage::returnTopKResults(WorkingSetID* out) {
+    if (_topKResultsPos == _topKResults.size()) {
+        _internalState = State::kDone;
+        return PlanStage::IS_EOF;
+    }
+
+    const auto result = _topKResults[_topKResultsPos];
+    try {
+        if (!WorkingSetCommon::fetch(getOpCtx(), _ws, result.first, _recordCursor)) {
+            // The document was deleted, or no longer has the indexed term, since it was scored.
+            _ws->free(result.first);
+            ++_topKResultsPos;
+            return PlanStage::NEED_TIME;
+        }
+        ++_specificStats.fetches;
+    } catch (const WriteConflictException&) {
+        *out = WorkingSet::INVALID_ID;
+        return PlanStage::NEED_YIELD;
+    }
+    ++_topKResultsPos;
+
+    WorkingSetMember* wsm = _ws->get(result.first);
+    wsm->makeObjOwnedIfNeeded();
+    wsm->addComputed(new TextScoreComputedData(result.second));
+    *out = result.first;
+    return PlanStage::ADVANCED;
+}
+
 PlanStage::StageState TextOrStage::returnResults(WorkingSetID* out) {
     if (_scoreIterator == _scores.end()) {
         _internalState = State::kDone;
@@ -297,8 +452,51 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
         wsm = _ws->get(textRecordData->wsid);
     }
 
+    // Aggregate relevance score, term keys.
+    textRecordData->score += getTermScore(newKeyData.keyData);
+    return NEED_TIME;
+}
+
+PlanStage::StageState TextOrStage::addTermTopK(WorkingSetID wsid) {
+    WorkingSetMember* wsm = _ws->get(wsid);
+    invariant(wsm->getState() == WorkingSetMember::RID_AND_IDX);
+    invariant(1 == wsm->keyData.size());
+    const IndexKeyDatum& keyDatum = wsm->keyData.back();
+    const double documentTermScore = getTermScore(keyDatum.keyData);
+
+    // The child scans its term's entries in descending score order.
+    _childMaxScores[_currentChild] = documentTermScore;
+
+    TextRecordData* textRecordData = &_scores[wsm->recordId];
+    if (textRecordData->score < 0) {
+        // We have already rejected this document for not matching the filter.
+        _ws->free(wsid);
+        return NEED_TIME;
+    }
+
+    if (WorkingSet::INVALID_ID == textRecordData->wsid) {
+        if (!Filter::passes(keyDatum.keyData, keyDatum.indexKeyPattern, _filter)) {
+            _ws->free(wsid);
+            textRecordData->score = -1;
+            return NEED_TIME;
+        }
+
+        // Keep the index entry rather than fetching the document now; it is fetched only if it
+        // makes the top k.
+        textRecordData->wsid = wsid;
+    } else {
+        invariant(wsid != textRecordData->wsid);
+        _ws->free(wsid);
+    }
+
+    textRecordData->score += documentTermScore;
+    textRecordData->childrenSeen |= uint64_t{1} << _currentChild;
+    return NEED_TIME;
+}
+
+double TextOrStage::getTermScore(const BSONObj& keyData) const {
     // Locate score within possibly compound key: {prefix,term,score,suffix}.
-    BSONObjIterator keyIt(newKeyData.keyData);
+    BSONObjIterator keyIt(keyData);
     for (unsigned i = 0; i < _ftsSpec.numExtraBefore(); i++) {
         keyIt.next();
     }
@@ -306,11 +504,7 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
     keyIt.next();  // Skip past 'term'.
 
     BSONElement scoreElement = keyIt.next();
-    double documentTermScore = scoreElement.number();
-
-    // Aggregate relevance score, term keys.
-    textRecordData->score += documentTermScore;
-    return NEED_TIME;
+    return scoreElement.number();
 }
 
 }  // namespace mongo
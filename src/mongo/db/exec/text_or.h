@@ -30,6 +30,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "mongo/db/exec/requires_collection_stage.h"
 #include "mongo/db/fts/fts_spec.h"
@@ -47,6 +48,12 @@ class OperationContext;
  * the positive terms in the search query, as well as their scores.
  *
  * The WorkingSetMembers returned are fetched and in the LOC_AND_OBJ state.
+ *
+ * If constructed with a non-zero 'topK', only the 'topK' highest scoring documents are returned.
+ * Each child scans a single term's index entries in descending score order, so the score of the
+ * entry a child returned last bounds the score of every entry it has yet to return. The children
+ * are read in turn, and reading stops as soon as the best 'topK' documents have complete scores
+ * which no other document, seen or unseen, can exceed. Only those documents are fetched.
  */
 class TextOrStage final : public RequiresCollectionStage {
 public:
@@ -71,7 +78,8 @@ public:
                 const FTSSpec& ftsSpec,
                 WorkingSet* ws,
                 const MatchExpression* filter,
-                const Collection* collection);
+                const Collection* collection,
+                size_t topK = 0);
 
     void addChild(std::unique_ptr<PlanStage> child);
 
@@ -112,17 +120,46 @@ private:
      */
     StageState readFromChildren(WorkingSetID* out);
 
+    /**
+     * Variant of readFromChildren used when only the top k documents are wanted. Reads one entry
+     * from each child in turn, and moves on to kReturningResults as soon as selectTopK() succeeds.
+     */
+    StageState readFromChildrenTopK(WorkingSetID* out);
+
     /**
      * Helper called from readFromChildren to update aggregate score with a newfound (term, score)
      * pair for this document.
      */
     StageState addTerm(WorkingSetID wsid, WorkingSetID* out);
 
+    /**
+     * Variant of addTerm used when only the top k documents are wanted. Accumulates the score of
+     * the document without fetching it.
+     */
+    StageState addTermTopK(WorkingSetID wsid);
+
+    /**
+     * Returns true, and keeps the best 'topK' documents in '_topKResults', if no document outside
+     * them could outscore them. Documents which can no longer make the cut are freed.
+     */
+    bool selectTopK();
+
     /**
      * Worker for kReturningResults. Returns a wsm with RecordID and Score.
      */
     StageState returnResults(WorkingSetID* out);
 
+    /**
+     * Worker for kReturningResults when only the top k documents are wanted. Fetches and returns
+     * the documents chosen by selectTopK().
+     */
+    StageState returnTopKResults(WorkingSetID* out);
+
+    /**
+     * Returns the score stored in a text index key.
+     */
+    double getTermScore(const BSONObj& keyData) const;
+
     // The index spec used to determine where to find the score.
     FTSSpec _ftsSpec;
 
@@ -144,12 +181,35 @@ private:
         TextRecordData() : wsid(WorkingSet::INVALID_ID), score(0.0) {}
         WorkingSetID wsid;
         double score;
+
+        // When reading for the top k documents, the bitmask of children which returned this
+        // document. The document's score is complete once every child has either returned it or
+        // reached the end of its scan.
+        uint64_t childrenSeen = 0;
     };
 
     typedef stdx::unordered_map<RecordId, TextRecordData, RecordId::Hasher> ScoreMap;
     ScoreMap _scores;
     ScoreMap::const_iterator _scoreIterator;
 
+    // If non-zero, the number of highest scoring documents to return.
+    size_t _topK;
+
+    // The score of the entry each child returned last, which no later entry from that child
+    // exceeds. Zero once the child is exhausted.
+    std::vector<double> _childMaxScores;
+    std::vector<bool> _childExhausted;
+    size_t _numChildrenExhausted = 0;
+
+    // The number of index entries read so far, and the number at which to next test whether the
+    // top k documents have been found.
+    size_t _entriesRead = 0;
+    size_t _nextTopKCheck = 0;
+
+    // The documents chosen by selectTopK(), and the next one to return.
+    std::vector<std::pair<WorkingSetID, double>> _topKResults;
+    size_t _topKResultsPos = 0;
+
     TextOrStats _specificStats;
 
     // Members needed only for using the TextMatchableDocument.
@@ -45,6 +45,8 @@
 #include "mongo/db/exec/write_stage_common.h"
 #include "mongo/db/op_observer.h"
 #include "mongo/db/query/explain.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/duplicate_key_error_info.h"
@@ -167,6 +169,10 @@ UpdateStage::UpdateStage(OperationContext* opCtx,
       _ws(ws),
       _idRetrying(WorkingSet::INVALID_ID),
       _idReturning(WorkingSet::INVALID_ID),
+      _batchSize(params.request->isMulti() && !params.request->shouldReturnAnyDocs() &&
+                         !params.request->isExplain() && !opCtx->getTxnNumber()
+                     ? internalUpdateMultiBatchSize.load()
+                     : 1),
       _updatedRecordIds(params.request->isMulti() ? new RecordIdSet() : NULL),
       _doc(params.driver->getDocument()) {
     _children.emplace_back(child);
@@ -190,17 +196,6 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
     // If asked to return new doc, default to the oldObj, in case nothing changes.
     BSONObj newObj = oldObj.value();
 
-    // Ask the driver to apply the mods. It may be that the driver can apply those "in
-    // place", that is, some values of the old document just get adjusted without any
-    // change to the binary layout on the bson layer. It may be that a whole new document
-    // is needed to accomodate the new bson layout of the resulting document. In any event,
-    // only enable in-place mutations if the underlying storage engine offers support for
-    // writing damage events.
-    _doc.reset(oldObj.value(),
-               (collection()->updateWithDamagesSupported()
-                    ? mutablebson::Document::kInPlaceEnabled
-                    : mutablebson::Document::kInPlaceDisabled));
-
     BSONObj logObj;
 
     bool docWasModified = false;
@@ -223,58 +218,96 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
         }
         immutablePaths.keepShortest(&idFieldRef);
     }
-    if (!driver->needMatchDetails()) {
-        // If we don't need match details, avoid doing the rematch
-        status = driver->update(StringData(),
-                                &_doc,
-                                validateForStorage,
-                                immutablePaths,
-                                isInsert,
-                                &logObj,
-                                &docWasModified);
-    } else {
-        // If there was a matched field, obtain it.
-        MatchDetails matchDetails;
-        matchDetails.requestElemMatchKey();
-
-        dassert(cq);
-        verify(cq->root()->matchesBSON(oldObj.value(), &matchDetails));
-
-        string matchedField;
-        if (matchDetails.hasElemMatchKey())
-            matchedField = matchDetails.elemMatchKey();
 
-        status = driver->update(matchedField,
-                                &_doc,
-                                validateForStorage,
-                                immutablePaths,
-                                isInsert,
-                                &logObj,
-                                &docWasModified);
-    }
-
-    if (!status.isOK()) {
-        uasserted(16837, status.reason());
-    }
+    // Simple $set and $inc updates which keep the document's layout can be applied directly to
+    // the bytes of the old document, without building a mutablebson::Document. Sharded
+    // collections need the Document to check for shard key changes.
+    const char* source = NULL;
+    bool trackModifiedPaths = false;
+    _damageSource.reset();
+    bool inPlace = collection()->updateWithDamagesSupported() && !metadata->isSharded() &&
+        !driver->needMatchDetails() &&
+        driver->updateInPlace(oldObj.value(),
+                              immutablePaths,
+                              &_damageSource,
+                              &_damages,
+                              &logObj,
+                              &docWasModified);
+
+    if (inPlace) {
+        source = _damageSource.buf();
+    } else {
+        // Ask the driver to apply the mods. It may be that the driver can apply those "in
+        // place", that is, some values of the old document just get adjusted without any
+        // change to the binary layout on the bson layer. It may be that a whole new document
+        // is needed to accomodate the new bson layout of the resulting document. In any event,
+        // only enable in-place mutations if the underlying storage engine offers support for
+        // writing damage events.
+        _doc.reset(oldObj.value(),
+                   (collection()->updateWithDamagesSupported()
+                        ? mutablebson::Document::kInPlaceEnabled
+                        : mutablebson::Document::kInPlaceDisabled));
+
+        // Only operator updates report the paths they modify.
+        _modifiedPaths.clear();
+        trackModifiedPaths = internalUpdateSkipUnaffectedIndexes.load() &&
+            driver->type() == UpdateDriver::UpdateType::kOperator;
+
+        if (!driver->needMatchDetails()) {
+            // If we don't need match details, avoid doing the rematch
+            status = driver->update(StringData(),
+                                    &_doc,
+                                    validateForStorage,
+                                    immutablePaths,
+                                    isInsert,
+                                    &logObj,
+                                    &docWasModified,
+                                    trackModifiedPaths ? &_modifiedPaths : nullptr);
+        } else {
+            // If there was a matched field, obtain it.
+            MatchDetails matchDetails;
+            matchDetails.requestElemMatchKey();
+
+            dassert(cq);
+            verify(cq->root()->matchesBSON(oldObj.value(), &matchDetails));
+
+            string matchedField;
+            if (matchDetails.hasElemMatchKey())
+                matchedField = matchDetails.elemMatchKey();
+
+            status = driver->update(matchedField,
+                                    &_doc,
+                                    validateForStorage,
+                                    immutablePaths,
+                                    isInsert,
+                                    &logObj,
+                                    &docWasModified,
+                                    trackModifiedPaths ? &_modifiedPaths : nullptr);
+        }
 
-    // Skip adding _id field if the collection is capped (since capped collection documents can
-    // neither grow nor shrink).
-    const auto createIdField = !collection()->isCapped();
+        if (!status.isOK()) {
+            uasserted(16837, status.reason());
+        }
 
-    // Ensure if _id exists it is first
-    status = ensureIdFieldIsFirst(&_doc);
-    if (status.code() == ErrorCodes::InvalidIdField) {
-        // Create ObjectId _id field if we are doing that
-        if (createIdField) {
-            addObjectIDIdField(&_doc);
+        // Skip adding _id field if the collection is capped (since capped collection documents
+        // can neither grow nor shrink).
+        const auto createIdField = !collection()->isCapped();
+
+        // Ensure if _id exists it is first
+        status = ensureIdFieldIsFirst(&_doc);
+        if (status.code() == ErrorCodes::InvalidIdField) {
+            // Create ObjectId _id field if we are doing that
+            if (createIdField) {
+                addObjectIDIdField(&_doc);
+                trackModifiedPaths = false;
+            }
+        } else {
+            uassertStatusOK(status);
         }
-    } else {
-        uassertStatusOK(status);
-    }
 
-    // See if the changes were applied in place
-    const char* source = NULL;
-    const bool inPlace = _doc.getInPlaceUpdates(&_damages, &source);
+        // See if the changes were applied in place
+        inPlace = _doc.getInPlaceUpdates(&_damages, &source);
+    }
 
     if (inPlace && _damages.empty()) {
         // An interesting edge case. A modifier didn't notice that it was really a no-op
@@ -301,6 +334,16 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
                     "Multi-update operations require all documents to have an '_id' field",
                     !request->isMulti() || args.criteria.hasField("_id"_sd));
             args.fromMigrate = request->isFromMigration();
+            if (_batchWuow &&
+                !repl::ReplicationCoordinator::get(getOpCtx())
+                     ->isOplogDisabledFor(getOpCtx(), collection()->ns())) {
+                // The updates of a batch share one storage transaction, so each document must be
+                // written at the timestamp of its own oplog entry.
+                args.oplogSlot = repl::getNextOpTimes(getOpCtx(), 1U)[0];
+            }
+            if (trackModifiedPaths) {
+                args.modifiedPaths = &_modifiedPaths;
+            }
             args.storeDocOption = getStoreDocMode(*request);
             if (args.storeDocOption == CollectionUpdateArgs::StoreDocOption::PreImage) {
                 args.preImageDoc = oldObj.value().getOwned();
@@ -603,6 +646,7 @@ bool UpdateStage::doneUpdating() {
     // We're done updating if either the child has no more results to give us, or we've
     // already gotten a result back and we're not a multi-update.
     return _idRetrying == WorkingSet::INVALID_ID && _idReturning == WorkingSet::INVALID_ID &&
+        _idsToRetry.empty() && !_batchWuow &&
         (child()->isEOF() || (_specificStats.nMatched > 0 && !_params.request->isMulti()));
 }
 
@@ -667,12 +711,16 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
     // Either retry the last WSM we worked on or get a new one from our child.
     WorkingSetID id;
     StageState status;
-    if (_idRetrying == WorkingSet::INVALID_ID) {
-        status = child()->work(&id);
-    } else {
+    if (_idRetrying != WorkingSet::INVALID_ID) {
         status = ADVANCED;
         id = _idRetrying;
         _idRetrying = WorkingSet::INVALID_ID;
+    } else if (!_idsToRetry.empty()) {
+        status = ADVANCED;
+        id = _idsToRetry.front();
+        _idsToRetry.pop_front();
+    } else {
+        status = child()->work(&id);
     }
 
     if (PlanStage::ADVANCED == status) {
@@ -707,6 +755,7 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
         } catch (const WriteConflictException&) {
             // There was a problem trying to detect if the document still exists, so retry.
             memberFreer.dismiss();
+            abortBatch();
             return prepareToRetryWSM(id, out);
         }
 
@@ -737,15 +786,30 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
             oldObj = member->obj.value().getOwned();
         }
 
+        // Open a batch unless the update is already part of a larger WriteUnitOfWork, such as a
+        // multi-document transaction.
+        if (_batchSize > 1 && !_batchWuow && !getOpCtx()->lockState()->inAWriteUnitOfWork()) {
+            _batchWuow = stdx::make_unique<WriteUnitOfWork>(getOpCtx());
+            _batchStartStats = _specificStats;
+        }
+
         BSONObj newObj;
         try {
             // Do the update, get us the new version of the doc.
             newObj = transformAndUpdate(member->obj, recordId);
         } catch (const WriteConflictException&) {
             memberFreer.dismiss();  // Keep this member around so we can retry updating it.
+            abortBatch();
             return prepareToRetryWSM(id, out);
         }
 
+        if (_batchWuow) {
+            // Keep this member around in case the batch has to be retried.
+            memberFreer.dismiss();
+            _batchMembers.push_back(id);
+            _batchRecordIds.push_back(recordId);
+        }
+
         // Set member's obj to be the doc we want to return.
         if (_params.request->shouldReturnAnyDocs()) {
             if (_params.request->shouldReturnNewDocs()) {
@@ -769,6 +833,13 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
         try {
             child()->restoreState();
         } catch (const WriteConflictException&) {
+            if (_batchWuow) {
+                // The update has not been committed yet, so it is retried with the whole batch.
+                abortBatch();
+                *out = WorkingSet::INVALID_ID;
+                return NEED_YIELD;
+            }
+
             // Note we don't need to retry updating anything in this case since the update
             // already was committed. However, we still need to return the updated document
             // (if it was requested).
@@ -793,8 +864,22 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
             return PlanStage::ADVANCED;
         }
 
+        if (_batchWuow && _batchMembers.size() >= static_cast<size_t>(_batchSize)) {
+            commitBatch();
+        }
+
         return PlanStage::NEED_TIME;
-    } else if (PlanStage::IS_EOF == status) {
+    }
+
+    // A child asks to yield after a WriteConflictException, which leaves the storage transaction
+    // unusable, so the batch is retried. Otherwise the child has nothing more for the batch.
+    if (_batchWuow && PlanStage::NEED_YIELD == status) {
+        abortBatch();
+    } else if (_batchWuow && PlanStage::NEED_TIME != status) {
+        commitBatch();
+    }
+
+    if (PlanStage::IS_EOF == status) {
         // The child is out of results, but we might not be done yet because we still might
         // have to do an insert.
         return PlanStage::NEED_TIME;
@@ -816,6 +901,13 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+void UpdateStage::doSaveStateRequiresCollection() {
+    // The batch must not stay open while the operation yields its locks.
+    if (_batchWuow) {
+        commitBatch();
+    }
+}
+
 void UpdateStage::doRestoreStateRequiresCollection() {
     const UpdateRequest& request = *_params.request;
     const NamespaceString& nsString(request.getNamespaceString());
@@ -896,6 +988,39 @@ PlanStage::StageState UpdateStage::prepareToRetryWSM(WorkingSetID idToRetry, Wor
     return NEED_YIELD;
 }
 
+void UpdateStage::commitBatch() {
+    invariant(_batchWuow);
+    _batchWuow->commit();
+    _batchWuow.reset();
+
+    for (auto id : _batchMembers) {
+        _ws->free(id);
+    }
+    _batchMembers.clear();
+    _batchRecordIds.clear();
+}
+
+void UpdateStage::abortBatch() {
+    if (!_batchWuow) {
+        return;
+    }
+
+    // Destroying the uncommitted WriteUnitOfWork rolls back every update of the batch.
+    _batchWuow.reset();
+    _specificStats = _batchStartStats;
+
+    // None of these documents had been updated before the batch, or they would have been skipped.
+    if (_updatedRecordIds) {
+        for (const auto& recordId : _batchRecordIds) {
+            _updatedRecordIds->erase(recordId);
+        }
+    }
+    _batchRecordIds.clear();
+
+    _idsToRetry.insert(_idsToRetry.end(), _batchMembers.begin(), _batchMembers.end());
+    _batchMembers.clear();
+}
+
 bool UpdateStage::checkUpdateChangesShardKeyFields(ScopedCollectionMetadata metadata,
                                                    const Snapshotted<BSONObj>& oldObj) {
     auto newObj = _doc.getObject();
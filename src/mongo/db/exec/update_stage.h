@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <deque>
+#include <vector>
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/requires_collection_stage.h"
@@ -37,6 +39,7 @@
 #include "mongo/db/ops/update_request.h"
 #include "mongo/db/ops/update_result.h"
 #include "mongo/db/s/collection_sharding_state.h"
+#include "mongo/db/storage/write_unit_of_work.h"
 #include "mongo/db/update/update_driver.h"
 
 namespace mongo {
@@ -154,7 +157,7 @@ public:
                                                  const DuplicateKeyErrorInfo& errorInfo);
 
 protected:
-    void doSaveStateRequiresCollection() final {}
+    void doSaveStateRequiresCollection() final;
 
     void doRestoreStateRequiresCollection() final;
 
@@ -198,6 +201,17 @@ private:
      */
     StageState prepareToRetryWSM(WorkingSetID idToRetry, WorkingSetID* out);
 
+    /**
+     * Commits the updates made since the current batch was opened.
+     */
+    void commitBatch();
+
+    /**
+     * Rolls back the updates made since the current batch was opened, along with the stats they
+     * contributed, and queues their WorkingSetMembers to be updated again.
+     */
+    void abortBatch();
+
     /**
      * Checks that the updated doc has all required shard key fields and throws if it does not.
      *
@@ -223,6 +237,20 @@ private:
     // If not WorkingSet::INVALID_ID, we return this member to our caller.
     WorkingSetID _idReturning;
 
+    // The number of matching documents a multi-update writes in one WriteUnitOfWork. Batching is
+    // disabled when this is 1.
+    const int _batchSize;
+
+    // While a batch is open, the WriteUnitOfWork holding its updates, the members and RecordIds
+    // of the documents it updated and the stats from before it was opened.
+    std::unique_ptr<WriteUnitOfWork> _batchWuow;
+    std::vector<WorkingSetID> _batchMembers;
+    std::vector<RecordId> _batchRecordIds;
+    UpdateStats _batchStartStats;
+
+    // Members of an aborted batch which must be updated again before asking our child for more.
+    std::deque<WorkingSetID> _idsToRetry;
+
     // Stats
     UpdateStats _specificStats;
 
@@ -247,6 +275,8 @@ private:
     // These get reused for each update.
     mutablebson::Document& _doc;
     mutablebson::DamageVector _damages;
+    BufBuilder _damageSource;
+    FieldRefSetWithStorage _modifiedPaths;
 };
 
 }  // namespace mongo
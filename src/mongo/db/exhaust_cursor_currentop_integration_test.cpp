@@ -76,6 +76,41 @@ bool confirmCurrentOpContents(DBClientBase* conn,
 }
 }  // namespace
 
+TEST(ExhaustCursorTest, StreamsAllGetMoreBatchesOnAnyTopology) {
+    const NamespaceString testNSS{"exhaust_cursor_currentop.exhaust_cursor_stream"};
+    auto conn = connect("exhaust_cursor_stream_test");
+
+    conn->dropCollection(testNSS.ns());
+    for (int i = 0; i < 10; i++) {
+        auto insertCmd =
+            BSON("insert" << testNSS.coll() << "documents" << BSON_ARRAY(BSON("a" << i)));
+        auto reply = conn->runCommand(OpMsgRequest::fromDBAndBody(testNSS.db(), insertCmd));
+        ASSERT_OK(getStatusFromCommandResult(reply->getCommandReply()));
+    }
+
+    // The first getMore is sent with 'exhaustAllowed', after which mongod or mongos streams every
+    // remaining batch back on its own. Sort so that the order is deterministic through mongos.
+    auto projSpec = BSON("_id" << 0 << "a" << 1);
+    auto cursor = conn->query(testNSS,
+                              Query().sort(BSON("a" << 1)),
+                              0,
+                              0,
+                              &projSpec,
+                              QueryOption_Exhaust,
+                              2);
+    ASSERT(cursor);
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_BSONOBJ_EQ(cursor->nextSafe(), BSON("a" << i));
+    }
+    cursor->setBatchSize(1);
+    for (int i = 2; i < 10; ++i) {
+        ASSERT(cursor->more());
+        ASSERT_BSONOBJ_EQ(cursor->nextSafe(), BSON("a" << i));
+    }
+    ASSERT_FALSE(cursor->more());
+    ASSERT_EQ(0, cursor->getCursorId());
+}
+
 TEST(CurrentOpExhaustCursorTest, CanSeeEachExhaustCursorPseudoGetMoreInCurrentOpOutput) {
     const NamespaceString testNSS{"exhaust_cursor_currentop.exhaust_cursor_currentop"};
     auto conn = connect("curop_exhaust_cursor_test");
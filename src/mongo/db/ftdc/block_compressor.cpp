@@ -32,12 +32,107 @@
 #include "mongo/db/ftdc/block_compressor.h"
 
 #include <zlib.h>
+#include <zstd.h>
 
+#include "mongo/base/data_view.h"
+#include "mongo/util/assert_util.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
 
-StatusWith<ConstDataRange> BlockCompressor::compress(ConstDataRange source) {
+namespace {
+
+// Every zstd frame starts with this little endian magic number. Its first two bytes never form a
+// valid zlib stream header, so chunks written by either algorithm can be told apart.
+const std::uint32_t kZstdFrameMagic = 0xFD2FB528;
+
+// Metric chunks are mostly varint-packed deltas, on which zstd's fastest level already compresses
+// about as well as zlib's default level at a fraction of the CPU cost.
+const int kZstdCompressionLevel = 1;
+
+bool isZstdFrame(ConstDataRange source) {
+    return source.length() >= sizeof(kZstdFrameMagic) &&
+        ConstDataView(source.data()).read<LittleEndian<std::uint32_t>>() == kZstdFrameMagic;
+}
+
+}  // namespace
+
+void BlockCompressor::ZstdCompressionContextDeleter::operator()(ZSTD_CCtx_s* context) const {
+    ZSTD_freeCCtx(context);
+}
+
+void BlockCompressor::ZstdDecompressionContextDeleter::operator()(ZSTD_DCtx_s* context) const {
+    ZSTD_freeDCtx(context);
+}
+
+StatusWith<ConstDataRange> BlockCompressor::compress(ConstDataRange source,
+                                                     FTDCBlockCompression compression) {
+    switch (compression) {
+        case FTDCBlockCompression::kZlib:
+            return _compressZlib(source);
+        case FTDCBlockCompression::kZstd:
+            return _compressZstd(source);
+    }
+    MONGO_UNREACHABLE;
+}
+
+StatusWith<ConstDataRange> BlockCompressor::uncompress(ConstDataRange source,
+                                                       size_t uncompressedLength) {
+    if (isZstdFrame(source)) {
+        return _uncompressZstd(source, uncompressedLength);
+    }
+    return _uncompressZlib(source, uncompressedLength);
+}
+
+StatusWith<ConstDataRange> BlockCompressor::_compressZstd(ConstDataRange source) {
+    if (!_zstdCompressionContext) {
+        _zstdCompressionContext.reset(ZSTD_createCCtx());
+        if (!_zstdCompressionContext) {
+            return {ErrorCodes::ExceededMemoryLimit, "ZSTD_createCCtx failed"};
+        }
+    }
+
+    _buffer.resize(ZSTD_compressBound(source.length()));
+
+    size_t ret = ZSTD_compressCCtx(_zstdCompressionContext.get(),
+                                   _buffer.data(),
+                                   _buffer.size(),
+                                   source.data(),
+                                   source.length(),
+                                   kZstdCompressionLevel);
+    if (ZSTD_isError(ret)) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "ZSTD_compressCCtx failed with " << ZSTD_getErrorName(ret)};
+    }
+
+    return ConstDataRange(_buffer.data(), ret);
+}
+
+StatusWith<ConstDataRange> BlockCompressor::_uncompressZstd(ConstDataRange source,
+                                                            size_t uncompressedLength) {
+    if (!_zstdDecompressionContext) {
+        _zstdDecompressionContext.reset(ZSTD_createDCtx());
+        if (!_zstdDecompressionContext) {
+            return {ErrorCodes::ExceededMemoryLimit, "ZSTD_createDCtx failed"};
+        }
+    }
+
+    _buffer.resize(uncompressedLength);
+
+    size_t ret = ZSTD_decompressDCtx(_zstdDecompressionContext.get(),
+                                     _buffer.data(),
+                                     _buffer.size(),
+                                     source.data(),
+                                     source.length());
+    if (ZSTD_isError(ret)) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "ZSTD_decompressDCtx failed with " << ZSTD_getErrorName(ret)};
+    }
+
+    return ConstDataRange(_buffer.data(), ret);
+}
+
+StatusWith<ConstDataRange> BlockCompressor::_compressZlib(ConstDataRange source) {
     z_stream stream;
     int level = Z_DEFAULT_COMPRESSION;
 
@@ -77,8 +172,8 @@ StatusWith<ConstDataRange> BlockCompressor::compress(ConstDataRange source) {
     return ConstDataRange(_buffer.data(), stream.total_out);
 }
 
-StatusWith<ConstDataRange> BlockCompressor::uncompress(ConstDataRange source,
-                                                       size_t uncompressedLength) {
+StatusWith<ConstDataRange> BlockCompressor::_uncompressZlib(ConstDataRange source,
+                                                            size_t uncompressedLength) {
     z_stream stream;
 
     stream.next_in = reinterpret_cast<unsigned char*>(const_cast<char*>(source.data()));
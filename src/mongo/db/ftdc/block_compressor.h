@@ -30,15 +30,20 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 #include "mongo/base/data_range.h"
 #include "mongo/base/status_with.h"
+#include "mongo/db/ftdc/config.h"
+
+struct ZSTD_CCtx_s;
+struct ZSTD_DCtx_s;
 
 namespace mongo {
 
 /**
- * Compesses and uncompresses a block of buffer using zlib.
+ * Compesses and uncompresses a block of buffer using zlib or zstd.
  */
 class BlockCompressor {
     BlockCompressor(const BlockCompressor&) = delete;
@@ -48,18 +53,20 @@ public:
     BlockCompressor() = default;
 
     /**
-     * Compress a buffer of data.
+     * Compress a buffer of data with the given algorithm.
      *
      * Returns a pointer to a buffer that BlockCompressor owns.
      * The returned buffer is valid until the next call to compress or uncompress.
      */
-    StatusWith<ConstDataRange> compress(ConstDataRange source);
+    StatusWith<ConstDataRange> compress(
+        ConstDataRange source, FTDCBlockCompression compression = FTDCBlockCompression::kZlib);
 
     /**
      * Uncompress a buffer of data.
      *
      * maxUncompressedLength is the upper bound on the size of the uncompressed data
-     * so that an internal buffer can be allocated to fit it.
+     * so that an internal buffer can be allocated to fit it. The algorithm the data was compressed
+     * with is detected from its header.
      *
      * Returns a pointer to a buffer that BlockCompressor owns.
      * The returned buffer is valid until the next call to compress or uncompress.
@@ -67,7 +74,25 @@ public:
     StatusWith<ConstDataRange> uncompress(ConstDataRange source, size_t maxUncompressedLength);
 
 private:
+    struct ZstdCompressionContextDeleter {
+        void operator()(ZSTD_CCtx_s* context) const;
+    };
+
+    struct ZstdDecompressionContextDeleter {
+        void operator()(ZSTD_DCtx_s* context) const;
+    };
+
+    StatusWith<ConstDataRange> _compressZlib(ConstDataRange source);
+    StatusWith<ConstDataRange> _compressZstd(ConstDataRange source);
+    StatusWith<ConstDataRange> _uncompressZlib(ConstDataRange source, size_t maxUncompressedLength);
+    StatusWith<ConstDataRange> _uncompressZstd(ConstDataRange source, size_t maxUncompressedLength);
+
     std::vector<std::uint8_t> _buffer;
+
+    // Created on first use and kept, so that compressing a chunk every few minutes does not
+    // reallocate zstd's working memory each time.
+    std::unique_ptr<ZSTD_CCtx_s, ZstdCompressionContextDeleter> _zstdCompressionContext;
+    std::unique_ptr<ZSTD_DCtx_s, ZstdDecompressionContextDeleter> _zstdDecompressionContext;
 };
 
 }  // namespace mongo
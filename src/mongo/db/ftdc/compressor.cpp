@@ -46,10 +46,9 @@ using std::swap;
 StatusWith<boost::optional<std::tuple<ConstDataRange, FTDCCompressor::CompressorState, Date_t>>>
 FTDCCompressor::addSample(const BSONObj& sample, Date_t date) {
     if (_referenceDoc.isEmpty()) {
-        auto swMatchesReference =
-            FTDCBSONUtil::extractMetricsFromDocument(sample, sample, &_metrics);
-        if (!swMatchesReference.isOK()) {
-            return swMatchesReference.getStatus();
+        auto status = FTDCBSONUtil::extractMetricsFromDocument(sample, &_metrics);
+        if (!status.isOK()) {
+            return status;
         }
 
         _reset(sample, date);
@@ -199,7 +198,8 @@ StatusWith<std::tuple<ConstDataRange, Date_t>> FTDCCompressor::getCompressedSamp
     }
 
     auto swDest = _compressor.compress(
-        ConstDataRange(_uncompressedChunkBuffer.buf(), _uncompressedChunkBuffer.len()));
+        ConstDataRange(_uncompressedChunkBuffer.buf(), _uncompressedChunkBuffer.len()),
+        _config->compression);
 
     // The only way for compression to fail is if the buffer size calculations are wrong
     if (!swDest.isOK()) {
@@ -128,8 +128,15 @@ TEST_F(FTDCCompressorTest, TestStrings) {
  */
 class TestTie {
 public:
-    TestTie(FTDCValidationMode mode = FTDCValidationMode::kStrict)
-        : _compressor(&_config), _mode(mode) {}
+    TestTie(FTDCValidationMode mode = FTDCValidationMode::kStrict,
+            FTDCBlockCompression compression = FTDCBlockCompression::kZlib)
+        : _compressor(&_config), _mode(mode) {
+        _config.compression = compression;
+    }
+
+    void setCompression(FTDCBlockCompression compression) {
+        _config.compression = compression;
+    }
 
     ~TestTie() {
         validate(boost::none);
@@ -610,6 +617,64 @@ TEST_F(FTDCCompressorTest, TestFull) {
     }
 }
 
+// Test that zstd compressed chunks round trip, including across schema changes and full chunks
+TEST_F(FTDCCompressorTest, TestZstd) {
+    TestTie c(FTDCValidationMode::kStrict, FTDCBlockCompression::kZstd);
+
+    auto st = c.addSample(BSON("name"
+                               << "joe"
+                               << "key1"
+                               << 33
+                               << "key2"
+                               << 42));
+    ASSERT_HAS_SPACE(st);
+
+    for (size_t i = 0; i != FTDCConfig::kMaxSamplesPerArchiveMetricChunkDefault - 2; i++) {
+        st = c.addSample(BSON("name"
+                              << "joe"
+                              << "key1"
+                              << static_cast<long long int>(i)
+                              << "key2"
+                              << 45));
+        ASSERT_HAS_SPACE(st);
+    }
+
+    st = c.addSample(BSON("name"
+                          << "joe"
+                          << "key1"
+                          << 34
+                          << "key2"
+                          << 45));
+    ASSERT_FULL(st);
+
+    st = c.addSample(BSON("name"
+                          << "joe"
+                          << "key1"
+                          << 34
+                          << "key2"
+                          << 45));
+    ASSERT_HAS_SPACE(st);
+
+    // Switch back to zlib part way through, the decompressor must handle both
+    c.setCompression(FTDCBlockCompression::kZlib);
+
+    st = c.addSample(BSON("name"
+                          << "joe"
+                          << "key1"
+                          << 34
+                          << "key3"
+                          << 45));
+    ASSERT_SCHEMA_CHANGED(st);
+
+    st = c.addSample(BSON("name"
+                          << "joe"
+                          << "key1"
+                          << 35
+                          << "key3"
+                          << 46));
+    ASSERT_HAS_SPACE(st);
+}
+
 template <typename T>
 BSONObj generateSample(std::random_device& rd, T generator, size_t count) {
     BSONObjBuilder builder;
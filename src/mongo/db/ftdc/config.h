@@ -35,6 +35,20 @@
 
 namespace mongo {
 
+/**
+ * Algorithm used to compress FTDC metric chunks.
+ *
+ * The decompressor recognizes both formats, so files may contain a mix of chunks compressed with
+ * either algorithm.
+ */
+enum class FTDCBlockCompression {
+    // Compatible with every version of the FTDC file format.
+    kZlib,
+
+    // Cheaper to compress than zlib at a similar compression ratio for metric chunks.
+    kZstd,
+};
+
 /**
  * Configuration settings for full-time diagnostic data capture (FTDC).
  *
@@ -47,7 +61,8 @@ struct FTDCConfig {
           maxFileSizeBytes(kMaxFileSizeBytesDefault),
           period(kPeriodMillisDefault),
           maxSamplesPerArchiveMetricChunk(kMaxSamplesPerArchiveMetricChunkDefault),
-          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault) {}
+          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault),
+          compression(kCompressionDefault) {}
 
     /**
      * True if FTDC is collecting data. False otherwise
@@ -84,6 +99,11 @@ struct FTDCConfig {
      */
     std::uint32_t maxSamplesPerInterimMetricChunk;
 
+    /**
+     * Algorithm used to compress metric chunks.
+     */
+    FTDCBlockCompression compression;
+
     static const bool kEnabledDefault = true;
 
     static const std::int64_t kPeriodMillisDefault;
@@ -94,6 +114,7 @@ struct FTDCConfig {
 
     static const std::uint32_t kMaxSamplesPerArchiveMetricChunkDefault = 300;
     static const std::uint32_t kMaxSamplesPerInterimMetricChunkDefault = 10;
+    static const FTDCBlockCompression kCompressionDefault = FTDCBlockCompression::kZlib;
 };
 
 }  // namespace mongo
@@ -87,6 +87,12 @@ void FTDCController::setMaxSamplesPerArchiveMetricChunk(size_t size) {
     _condvar.notify_one();
 }
 
+void FTDCController::setCompression(FTDCBlockCompression compression) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _configTemp.compression = compression;
+    _condvar.notify_one();
+}
+
 void FTDCController::setMaxSamplesPerInterimMetricChunk(size_t size) {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
     _configTemp.maxSamplesPerInterimMetricChunk = size;
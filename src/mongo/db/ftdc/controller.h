@@ -99,6 +99,11 @@ public:
      */
     void setMaxSamplesPerInterimMetricChunk(size_t size);
 
+    /**
+     * Set the algorithm used to compress metric chunks. Takes effect with the next chunk written.
+     */
+    void setCompression(FTDCBlockCompression compression);
+
     /*
      * Set the path to store FTDC files if not already set.
      *
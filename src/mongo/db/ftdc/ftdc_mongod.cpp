@@ -37,12 +37,34 @@
 #include "mongo/db/ftdc/controller.h"
 #include "mongo/db/ftdc/ftdc_server.h"
 #include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/stats/top.h"
+#include "mongo/db/stats/top_gen.h"
 #include "mongo/db/storage/storage_options.h"
 
 namespace mongo {
 
 namespace {
+
+/**
+ * Collects the global and per-command operation latency histograms. Only installed when the
+ * histograms have fine-grained buckets, since serverStatus leaves them out by default.
+ */
+class OpLatencyHistogramCollector final : public FTDCCollectorInterface {
+public:
+    std::string name() const final {
+        return "opLatencies";
+    }
+
+    void collect(OperationContext* opCtx, BSONObjBuilder& builder) final {
+        Top::get(opCtx->getServiceContext()).appendGlobalLatencyStats(true, &builder);
+    }
+};
+
 void registerMongoDCollectors(FTDCController* controller) {
+    if (gOpLatencyHistogramPrecisionBits > 0) {
+        controller->addPeriodicCollector(stdx::make_unique<OpLatencyHistogramCollector>());
+    }
+
     // These metrics are only collected if replication is enabled
     if (repl::ReplicationCoordinator::get(getGlobalServiceContext())->getReplicationMode() !=
         repl::ReplicationCoordinator::modeNone) {
@@ -68,8 +68,25 @@ FTDCController* getGlobalFTDCController() {
  */
 synchronized_value<boost::filesystem::path> ftdcDirectoryPathParameter;
 
+StatusWith<FTDCBlockCompression> parseFTDCCompressor(StringData name) {
+    if (name == FTDCStartupParams::kFTDCCompressorZlib) {
+        return FTDCBlockCompression::kZlib;
+    }
+    if (name == FTDCStartupParams::kFTDCCompressorZstd) {
+        return FTDCBlockCompression::kZstd;
+    }
+    return Status(ErrorCodes::BadValue,
+                  str::stream() << "diagnosticDataCollectionCompressor must be '"
+                                << FTDCStartupParams::kFTDCCompressorZlib << "' or '"
+                                << FTDCStartupParams::kFTDCCompressorZstd << "', not '" << name
+                                << "'");
+}
+
 }  // namespace
 
+constexpr StringData FTDCStartupParams::kFTDCCompressorZlib;
+constexpr StringData FTDCStartupParams::kFTDCCompressorZstd;
+
 FTDCStartupParams ftdcStartupParams;
 
 void DiagnosticDataCollectionDirectoryPathServerParameter::append(OperationContext* opCtx,
@@ -170,6 +187,23 @@ Status onUpdateFTDCPerInterimUpdate(const std::int32_t potentialNewValue) {
     return Status::OK();
 }
 
+Status validateFTDCCompressor(const std::string& value) {
+    return parseFTDCCompressor(value).getStatus();
+}
+
+Status onUpdateFTDCCompressor(const std::string& value) {
+    auto controller = getGlobalFTDCController();
+    if (controller) {
+        auto swCompression = parseFTDCCompressor(value);
+        if (!swCompression.isOK()) {
+            return swCompression.getStatus();
+        }
+        controller->setCompression(swCompression.getValue());
+    }
+
+    return Status::OK();
+}
+
 FTDCSimpleInternalCommandCollector::FTDCSimpleInternalCommandCollector(StringData command,
                                                                        StringData name,
                                                                        StringData ns,
@@ -208,6 +242,8 @@ void startFTDC(boost::filesystem::path& path,
         ftdcStartupParams.maxSamplesPerArchiveMetricChunk.load();
     config.maxSamplesPerInterimMetricChunk =
         ftdcStartupParams.maxSamplesPerInterimMetricChunk.load();
+    config.compression =
+        uassertStatusOK(parseFTDCCompressor(ftdcStartupParams.compressor.get()));
 
     ftdcDirectoryPathParameter = path;
 
@@ -295,6 +295,10 @@ StatusWith<bool> extractMetricsFromDocument(const BSONObj& referenceDoc,
     return extractMetricsFromDocument(referenceDoc, currentDoc, metrics, true, 0);
 }
 
+Status extractMetricsFromDocument(const BSONObj& doc, std::vector<std::uint64_t>* metrics) {
+    return extractMetricsFromDocument(BSONObj(), doc, metrics, false, 0).getStatus();
+}
+
 namespace {
 Status constructDocumentFromMetrics(const BSONObj& referenceDocument,
                                     BSONObjBuilder& builder,
@@ -98,6 +98,14 @@ StatusWith<bool> extractMetricsFromDocument(const BSONObj& referenceDoc,
                                             const BSONObj& doc,
                                             std::vector<std::uint64_t>* metrics);
 
+/**
+ * Extract an array of numbers from a document without comparing it against a reference document.
+ *
+ * Used when 'doc' becomes the reference document, in which case the schema check above would
+ * only compare the document with itself.
+ */
+Status extractMetricsFromDocument(const BSONObj& doc, std::vector<std::uint64_t>* metrics);
+
 /**
  * Construct a document from a reference document and array of metrics.
  *
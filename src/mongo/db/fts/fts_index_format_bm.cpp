@@ -0,0 +1,100 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/fts/fts_index_format.h"
+#include "mongo/db/fts/fts_spec.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace fts {
+namespace {
+
+const std::vector<std::string> kVocabulary = {
+    "wireless", "headphones", "noise",   "cancelling", "bluetooth", "battery", "hours", "charging",
+    "portable", "speaker",    "outdoor", "camping",    "stainless", "steel",   "kitchen", "knives",
+    "handle",   "cooking",    "running", "shoes",      "trainers",  "the",     "and",     "with",
+    "for",      "of",         "a",       "in"};
+
+// Builds product-catalog-like documents: a short title and a longer description drawn from a
+// shared vocabulary, so that words repeat across documents as they do in real catalogs.
+std::vector<BSONObj> makeDocuments(size_t count, size_t descriptionWords) {
+    std::mt19937 gen(1234);
+    std::uniform_int_distribution<size_t> pick(0, kVocabulary.size() - 1);
+    auto makeText = [&](size_t words) {
+        std::string text;
+        for (size_t i = 0; i < words; ++i) {
+            text += kVocabulary[pick(gen)];
+            text += ' ';
+        }
+        return text;
+    };
+
+    std::vector<BSONObj> docs;
+    for (size_t i = 0; i < count; ++i) {
+        docs.push_back(BSON("_id" << static_cast<int>(i) << "title" << makeText(6)
+                                  << "description"
+                                  << makeText(descriptionWords)));
+    }
+    return docs;
+}
+
+void BM_FTSGetKeys(benchmark::State& state, const char* language) {
+    FTSSpec spec(uassertStatusOK(
+        FTSSpec::fixSpec(BSON("key" << BSON("title"
+                                            << "text"
+                                            << "description"
+                                            << "text")
+                                    << "default_language"
+                                    << language))));
+    const auto docs = makeDocuments(100, state.range(0));
+
+    size_t numKeys = 0;
+    for (auto _ : state) {
+        for (auto&& doc : docs) {
+            BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+            FTSIndexFormat::getKeys(spec, doc, &keys);
+            numKeys += keys.size();
+        }
+    }
+    benchmark::DoNotOptimize(numKeys);
+    state.SetItemsProcessed(state.iterations() * docs.size());
+}
+
+BENCHMARK_CAPTURE(BM_FTSGetKeys, English, "english")->Arg(10)->Arg(100)->Arg(1000);
+BENCHMARK_CAPTURE(BM_FTSGetKeys, None, "none")->Arg(10)->Arg(100)->Arg(1000);
+
+}  // namespace
+}  // namespace fts
+}  // namespace mongo
@@ -55,6 +55,21 @@ namespace {
 // Default language.  Used for new indexes.
 const std::string moduleDefaultLanguage("english");
 
+/**
+ * Returns this thread's tokenizer for 'language'. Creating a tokenizer builds a Snowball stemmer,
+ * and a stemmer's cache of stems only pays off if it outlives the document being indexed, so
+ * tokenizers are kept for the life of the thread rather than created for every string.
+ */
+FTSTokenizer* getThreadTokenizer(const FTSLanguage* language) {
+    static thread_local stdx::unordered_map<const FTSLanguage*, std::unique_ptr<FTSTokenizer>>
+        tokenizers;
+    auto& tokenizer = tokenizers[language];
+    if (!tokenizer) {
+        tokenizer = language->createTokenizer();
+    }
+    return tokenizer.get();
+}
+
 /** Validate the given language override string. */
 bool validateOverride(const string& override) {
     // The override field can't be empty, can't be prefixed with a dollar sign, and
@@ -181,8 +196,7 @@ void FTSSpec::scoreDocument(const BSONObj& obj, TermFrequencyMap* term_freqs) co
 
     while (it.more()) {
         FTSIteratorValue val = it.next();
-        std::unique_ptr<FTSTokenizer> tokenizer(val._language->createTokenizer());
-        _scoreStringV2(tokenizer.get(), val._text, term_freqs, val._weight);
+        _scoreStringV2(getThreadTokenizer(val._language), val._text, term_freqs, val._weight);
     }
 }
 
@@ -36,6 +36,13 @@ namespace mongo {
 
 namespace fts {
 
+namespace {
+// Bounds the memory each stemmer spends on cached stems. Tokenizers, and so stemmers, are kept per
+// thread and language, so this is multiplied by the number of threads building text index keys.
+const size_t kMaxCachedStems = 1024;
+const size_t kMaxCachedWordLength = 64;
+}  // namespace
+
 Stemmer::Stemmer(const FTSLanguage* language) {
     _stemmer = NULL;
     if (language->str() != "none")
@@ -53,6 +60,10 @@ StringData Stemmer::stem(StringData word) const {
     if (!_stemmer)
         return word;
 
+    auto cached = _cache.find(word);
+    if (cached != _cache.end())
+        return cached->second;
+
     const sb_symbol* sb_sym =
         sb_stemmer_stem(_stemmer, (const sb_symbol*)word.rawData(), word.size());
 
@@ -61,7 +72,16 @@ StringData Stemmer::stem(StringData word) const {
         MONGO_UNREACHABLE;
     }
 
-    return StringData((const char*)(sb_sym), sb_stemmer_length(_stemmer));
+    StringData stemmed((const char*)(sb_sym), sb_stemmer_length(_stemmer));
+    if (word.size() > kMaxCachedWordLength)
+        return stemmed;
+
+    // 'word' may be a stem returned by an earlier call, which lives in the cache, so copy it before
+    // the cache is emptied.
+    std::string key = word.toString();
+    if (_cache.size() >= kMaxCachedStems)
+        _cache.clear();
+    return _cache.emplace(std::move(key), stemmed.toString()).first->second;
 }
 }
 }
@@ -32,6 +32,7 @@
 
 #include "mongo/base/string_data.h"
 #include "mongo/db/fts/fts_language.h"
+#include "mongo/util/string_map.h"
 #include "third_party/libstemmer_c/include/libstemmer.h"
 
 namespace mongo {
@@ -62,6 +63,10 @@ public:
 
 private:
     struct sb_stemmer* _stemmer;
+
+    // Stemming dominates the cost of tokenizing text, and the words of a corpus repeat heavily, so
+    // the stems of recently seen words are remembered. The cache is emptied whenever it fills up.
+    mutable StringMap<std::string> _cache;
 };
 }
 }
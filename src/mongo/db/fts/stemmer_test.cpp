@@ -47,5 +47,19 @@ TEST(English, Caps) {
     ASSERT_EQUALS("unit", s.stem("united"));
     ASSERT_EQUALS("Unite", s.stem("United"));
 }
+
+TEST(English, RepeatedWordsStemConsistently) {
+    Stemmer s(&languageEnglishV2);
+    for (int i = 0; i < 3000; ++i) {
+        ASSERT_EQUALS("run", s.stem("running"));
+        ASSERT_EQUALS("walk", s.stem("walked"));
+        ASSERT_EQUALS(std::to_string(i), s.stem(std::to_string(i)));
+    }
+
+    // Stemming a stem returned by an earlier call must not be affected by the stem cache.
+    Stemmer fresh(&languageEnglishV2);
+    std::string expected = fresh.stem(fresh.stem("generalizations")).toString();
+    ASSERT_EQUALS(expected, s.stem(s.stem("generalizations")));
+}
 }
 }
@@ -1311,6 +1311,11 @@ double GeometryContainer::minDistance(const PointWithCRS& otherPoint) const {
     }
 }
 
+const PointWithCRS& GeometryContainer::getPoint() const {
+    invariant(_point);
+    return *_point;
+}
+
 const CapWithCRS* GeometryContainer::getCapGeometryHack() const {
     return _cap.get();
 }
@@ -120,6 +120,9 @@ public:
     // Returns a string related to the type of the geometry (for debugging queries)
     std::string getDebugType() const;
 
+    // The point held by this geometry. It is an error to call this unless isPoint() is true.
+    const PointWithCRS& getPoint() const;
+
     // Needed for 2D wrapping check (for now)
     // TODO: Remove these hacks
     const CapWithCRS* getCapGeometryHack() const;
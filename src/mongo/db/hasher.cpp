@@ -33,7 +33,10 @@
 
 #include "mongo/db/hasher.h"
 
+#include <algorithm>
+#include <string>
 
+#include "mongo/base/data_view.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/util/md5.hpp"
 #include "mongo/util/startup_test.h"
@@ -100,7 +103,44 @@ void Hasher::finish(HashDigest out) {
     md5_finish(&_md5State, out);
 }
 
-void recursiveHash(Hasher* h, const BSONElement& e, bool includeFieldName) {
+/**
+ * Collects the input of a hash in a buffer instead of feeding it to MD5 directly, so that the MD5
+ * computations of many inputs can be run side by side.
+ */
+class HashInputBuffer {
+    HashInputBuffer(const HashInputBuffer&) = delete;
+    HashInputBuffer& operator=(const HashInputBuffer&) = delete;
+
+public:
+    HashInputBuffer(HashSeed seed, std::string* buffer) : _buffer(buffer) {
+        _buffer->clear();
+        addSeed(seed);
+    }
+
+    void addData(const void* keyData, size_t numBytes) {
+        _buffer->append(static_cast<const char*>(keyData), numBytes);
+    }
+
+    void addSeed(int32_t number) {
+        addIntegerData(number);
+    }
+
+    void addNumber(int64_t number) {
+        addIntegerData(number);
+    }
+
+private:
+    template <typename T>
+    void addIntegerData(T number) {
+        const auto data = endian::nativeToLittle(number);
+        addData(&data, sizeof(data));
+    }
+
+    std::string* _buffer;
+};
+
+template <typename HasherType>
+void recursiveHash(HasherType* h, const BSONElement& e, bool includeFieldName) {
     int canonicalType = endian::nativeToLittle(e.canonicalType());
     h->addData(&canonicalType, sizeof(canonicalType));
 
@@ -137,6 +177,144 @@ void recursiveHash(Hasher* h, const BSONElement& e, bool includeFieldName) {
     }
 }
 
+/**
+ * An MD5 implementation which processes the messages of kMD5Lanes lanes at once. Every operation
+ * of the compression function is applied to all lanes before the next one, so the compiler can
+ * vectorize the lanes. The digests are identical to those of md5_append() and md5_finish().
+ */
+constexpr size_t kMD5Lanes = 4;
+constexpr size_t kMD5BlockSize = 64;
+
+constexpr uint32_t kMD5Sines[64] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391};
+
+constexpr int kMD5Shifts[64] = {7,  12, 17, 22, 7,  12, 17, 22, 7,  12, 17, 22, 7,  12, 17, 22,
+                                5,  9,  14, 20, 5,  9,  14, 20, 5,  9,  14, 20, 5,  9,  14, 20,
+                                4,  11, 16, 23, 4,  11, 16, 23, 4,  11, 16, 23, 4,  11, 16, 23,
+                                6,  10, 15, 21, 6,  10, 15, 21, 6,  10, 15, 21, 6,  10, 15, 21};
+
+struct MD5Lanes {
+    uint32_t a[kMD5Lanes];
+    uint32_t b[kMD5Lanes];
+    uint32_t c[kMD5Lanes];
+    uint32_t d[kMD5Lanes];
+};
+
+inline uint32_t rotateLeft(uint32_t x, int n) {
+    return (x << n) | (x >> (32 - n));
+}
+
+/**
+ * Runs the MD5 compression function on one block of each lane. 'words' holds the sixteen
+ * little-endian words of each lane's block. Lanes for which 'active' is false keep their state.
+ */
+void md5CompressLanes(MD5Lanes* state,
+                      const uint32_t words[16][kMD5Lanes],
+                      const bool active[kMD5Lanes]) {
+    uint32_t a[kMD5Lanes], b[kMD5Lanes], c[kMD5Lanes], d[kMD5Lanes];
+    for (size_t lane = 0; lane < kMD5Lanes; ++lane) {
+        a[lane] = state->a[lane];
+        b[lane] = state->b[lane];
+        c[lane] = state->c[lane];
+        d[lane] = state->d[lane];
+    }
+
+    for (int i = 0; i < 64; ++i) {
+        const int round = i / 16;
+        const int kWordMultipliers[4] = {1, 5, 3, 7};
+        const int kWordOffsets[4] = {0, 1, 5, 0};
+        const int word = (kWordMultipliers[round] * i + kWordOffsets[round]) % 16;
+        for (size_t lane = 0; lane < kMD5Lanes; ++lane) {
+            uint32_t f;
+            if (round == 0) {
+                f = (b[lane] & c[lane]) | (~b[lane] & d[lane]);
+            } else if (round == 1) {
+                f = (b[lane] & d[lane]) | (c[lane] & ~d[lane]);
+            } else if (round == 2) {
+                f = b[lane] ^ c[lane] ^ d[lane];
+            } else {
+                f = c[lane] ^ (b[lane] | ~d[lane]);
+            }
+            const uint32_t rotated =
+                rotateLeft(a[lane] + f + kMD5Sines[i] + words[word][lane], kMD5Shifts[i]);
+            a[lane] = d[lane];
+            d[lane] = c[lane];
+            c[lane] = b[lane];
+            b[lane] = b[lane] + rotated;
+        }
+    }
+
+    for (size_t lane = 0; lane < kMD5Lanes; ++lane) {
+        if (active[lane]) {
+            state->a[lane] += a[lane];
+            state->b[lane] += b[lane];
+            state->c[lane] += c[lane];
+            state->d[lane] += d[lane];
+        }
+    }
+}
+
+/**
+ * Appends the MD5 padding, the 0x80 byte, zeros, and the message length in bits, to 'message'.
+ */
+void md5Pad(std::string* message) {
+    const uint64_t lengthInBits = endian::nativeToLittle(uint64_t{message->size()} * 8);
+    message->push_back('\x80');
+    const size_t lengthOffset = kMD5BlockSize - sizeof(lengthInBits);
+    const size_t used = message->size() % kMD5BlockSize;
+    message->append((kMD5BlockSize + lengthOffset - used) % kMD5BlockSize, '\0');
+    message->append(reinterpret_cast<const char*>(&lengthInBits), sizeof(lengthInBits));
+    invariant(message->size() % kMD5BlockSize == 0);
+}
+
+/**
+ * Computes the MD5 of up to kMD5Lanes padded messages and returns the first 8 bytes of each digest
+ * as a little-endian integer, as BSONElementHasher::hash64() does.
+ */
+void md5Lanes(const std::string* messages, size_t numMessages, long long int* out) {
+    invariant(numMessages <= kMD5Lanes);
+
+    MD5Lanes state;
+    size_t maxBlocks = 0;
+    for (size_t lane = 0; lane < kMD5Lanes; ++lane) {
+        state.a[lane] = 0x67452301;
+        state.b[lane] = 0xefcdab89;
+        state.c[lane] = 0x98badcfe;
+        state.d[lane] = 0x10325476;
+        if (lane < numMessages) {
+            maxBlocks = std::max(maxBlocks, messages[lane].size() / kMD5BlockSize);
+        }
+    }
+
+    uint32_t words[16][kMD5Lanes] = {};
+    bool active[kMD5Lanes];
+    for (size_t block = 0; block < maxBlocks; ++block) {
+        for (size_t lane = 0; lane < kMD5Lanes; ++lane) {
+            active[lane] = lane < numMessages && block < messages[lane].size() / kMD5BlockSize;
+            if (!active[lane]) {
+                continue;
+            }
+            ConstDataView blockView(messages[lane].data() + block * kMD5BlockSize);
+            for (size_t word = 0; word < 16; ++word) {
+                words[word][lane] =
+                    blockView.read<LittleEndian<uint32_t>>(word * sizeof(uint32_t));
+            }
+        }
+        md5CompressLanes(&state, words, active);
+    }
+
+    for (size_t lane = 0; lane < numMessages; ++lane) {
+        out[lane] = static_cast<long long int>((uint64_t{state.b[lane]} << 32) | state.a[lane]);
+    }
+}
+
 struct HasherUnitTest : public StartupTest {
     void run() {
         // Hard-coded check to ensure the hash function is consistent across platforms
@@ -157,4 +335,20 @@ long long int BSONElementHasher::hash64(const BSONElement& e, HashSeed seed) {
     return digestView.read<LittleEndian<long long int>>();
 }
 
+std::vector<long long int> BSONElementHasher::hash64Batch(const std::vector<BSONElement>& elements,
+                                                          HashSeed seed) {
+    std::vector<long long int> hashes(elements.size());
+    std::string messages[kMD5Lanes];
+    for (size_t i = 0; i < elements.size(); i += kMD5Lanes) {
+        const size_t numMessages = std::min(kMD5Lanes, elements.size() - i);
+        for (size_t lane = 0; lane < numMessages; ++lane) {
+            HashInputBuffer h(seed, &messages[lane]);
+            recursiveHash(&h, elements[i + lane], false);
+            md5Pad(&messages[lane]);
+        }
+        md5Lanes(messages, numMessages, &hashes[i]);
+    }
+    return hashes;
+}
+
 }  // namespace mongo
@@ -33,6 +33,7 @@
  * Defines a simple hash function class
  */
 
+#include <vector>
 
 #include "mongo/bson/bsonelement.h"
 
@@ -68,6 +69,14 @@ public:
      */
     static long long int hash64(const BSONElement& e, HashSeed seed);
 
+    /* Computes hash64(e, seed) for each element of "elements", in order. The
+     * MD5 computations of several elements are interleaved, which makes this
+     * cheaper than hashing each element separately when there are many of
+     * them, for example the shard keys of an insert batch.
+     */
+    static std::vector<long long int> hash64Batch(const std::vector<BSONElement>& elements,
+                                                  HashSeed seed);
+
 private:
     BSONElementHasher();
 };
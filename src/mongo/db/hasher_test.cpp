@@ -372,5 +372,44 @@ TEST(BSONElementHasher, HashWithNonZeroSeed) {
     ASSERT_EQUALS(hashIt(o, seed), -9222615859251096151LL);
 }
 
+TEST(BSONElementHasher, BatchHashesMatchSingleHashes) {
+    BSONArrayBuilder arrBuilder;
+    arrBuilder.append(42);
+    arrBuilder.append(-3.7);
+    arrBuilder.append(OID::gen());
+    arrBuilder.append(BSON("a" << 1 << "b" << BSON_ARRAY("x"
+                                                     << "y")));
+    arrBuilder.append(BSONCodeWScope("func f() { return 1; }", BSON("c" << true)));
+    arrBuilder.appendNull();
+    // Strings of every length up to several MD5 blocks, to cover each padding case.
+    for (int length = 0; length < 200; ++length) {
+        arrBuilder.append(std::string(length, static_cast<char>('a' + length % 26)));
+    }
+    BSONObj arr = arrBuilder.arr();
+
+    std::vector<BSONElement> elements;
+    for (auto&& element : arr) {
+        elements.push_back(element);
+    }
+
+    for (HashSeed seed : {0, 40513}) {
+        // Batches of every size, so that partially filled groups of lanes are covered too.
+        for (size_t batchSize = 0; batchSize <= 9; ++batchSize) {
+            std::vector<BSONElement> batch(elements.begin(), elements.begin() + batchSize);
+            auto hashes = BSONElementHasher::hash64Batch(batch, seed);
+            ASSERT_EQUALS(batchSize, hashes.size());
+            for (size_t i = 0; i < batchSize; ++i) {
+                ASSERT_EQUALS(BSONElementHasher::hash64(batch[i], seed), hashes[i]);
+            }
+        }
+
+        auto hashes = BSONElementHasher::hash64Batch(elements, seed);
+        ASSERT_EQUALS(elements.size(), hashes.size());
+        for (size_t i = 0; i < elements.size(); ++i) {
+            ASSERT_EQUALS(BSONElementHasher::hash64(elements[i], seed), hashes[i]);
+        }
+    }
+}
+
 }  // namespace
 }  // namespace mongo
@@ -84,12 +84,12 @@ static void assertParallelArrays(const char* first, const char* second) {
     uasserted(ErrorCodes::CannotIndexParallelArrays, ss.str());
 }
 
-BSONElement BtreeKeyGenerator::_extractNextElement(const BSONObj& obj,
+BSONElement BtreeKeyGenerator::_extractNextElement(BSONObjFieldIndex* fieldIndex,
                                                    const PositionalPathInfo& positionalInfo,
                                                    const char** field,
                                                    bool* arrayNestedArray) const {
     StringData firstField = str::before(*field, '.');
-    bool haveObjField = !obj.getField(firstField).eoo();
+    bool haveObjField = !fieldIndex->getField(firstField).eoo();
     BSONElement arrField = positionalInfo.positionallyIndexedElt;
 
     // An index component field name cannot exist in both a document
@@ -105,7 +105,7 @@ BSONElement BtreeKeyGenerator::_extractNextElement(const BSONObj& obj,
 
     *arrayNestedArray = false;
     if (haveObjField) {
-        return dps::extractElementAtPathOrArrayAlongPath(obj, *field);
+        return dps::extractElementAtPathOrArrayAlongPath(fieldIndex, *field);
     } else if (positionalInfo.hasPositionallyIndexedElt()) {
         if (arrField.type() == Array) {
             *arrayNestedArray = true;
@@ -220,6 +220,7 @@ void BtreeKeyGenerator::_getKeysWithArray(std::vector<const char*> fieldNames,
     std::vector<boost::optional<size_t>> arrComponents(fieldNames.size());
 
     bool mayExpandArrayUnembedded = true;
+    BSONObjFieldIndex fieldIndex(obj);
     for (size_t i = 0; i < fieldNames.size(); ++i) {
         if (*fieldNames[i] == '\0') {
             continue;
@@ -227,8 +228,8 @@ void BtreeKeyGenerator::_getKeysWithArray(std::vector<const char*> fieldNames,
 
         bool arrayNestedArray;
         // Extract element matching fieldName[ i ] from object xor array.
-        BSONElement e =
-            _extractNextElement(obj, positionalInfo[i], &fieldNames[i], &arrayNestedArray);
+        BSONElement e = _extractNextElement(
+            &fieldIndex, positionalInfo[i], &fieldNames[i], &arrayNestedArray);
 
         if (e.eoo()) {
             // if field not present, set to null
@@ -34,6 +34,7 @@
 #include <vector>
 
 #include "mongo/bson/bsonobj_comparator_interface.h"
+#include "mongo/db/bson/bsonobj_field_index.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index/multikey_paths.h"
 #include "mongo/db/jsobj.h"
@@ -173,8 +174,11 @@ private:
      *   'obj' {b: {c: 98}} and '*field' pointing to "b.c". It will return element 98 and
      *   set '*field' to "". Similarly, it will return elemtn 99 and set '*field' to "" for
      *   the second array element.
+     *
+     * 'obj' is accessed through 'fieldIndex', which is shared by the lookups of every indexed
+     * field in the same object so that wide documents are not rescanned for each of them.
      */
-    BSONElement _extractNextElement(const BSONObj& obj,
+    BSONElement _extractNextElement(BSONObjFieldIndex* fieldIndex,
                                     const PositionalPathInfo& positionalInfo,
                                     const char** field,
                                     bool* arrayNestedArray) const;
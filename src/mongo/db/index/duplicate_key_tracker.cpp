@@ -33,6 +33,8 @@
 
 #include "mongo/db/index/duplicate_key_tracker.h"
 
+#include <algorithm>
+
 #include "mongo/db/catalog/index_catalog_entry.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/index/index_access_method.h"
@@ -44,6 +46,10 @@ namespace mongo {
 
 namespace {
 static constexpr StringData kKeyField = "key"_sd;
+
+// Upper bound on the size of the recorded conflicts rechecked together. Each batch is sorted so
+// that the index is probed in key order, and its records are removed in one write unit of work.
+constexpr int kMaxCheckBatchBytes = 16 * 1024 * 1024;
 }
 
 DuplicateKeyTracker::DuplicateKeyTracker(OperationContext* opCtx, const IndexCatalogEntry* entry)
@@ -99,9 +105,15 @@ Status DuplicateKeyTracker::checkConstraints(OperationContext* opCtx) const {
     invariant(!opCtx->lockState()->inAWriteUnitOfWork());
 
     auto constraintsCursor = _keyConstraintsTable->rs()->getCursor(opCtx);
-    auto record = constraintsCursor->next();
 
     auto index = _indexCatalogEntry->accessMethod()->getSortedDataInterface();
+    const Ordering ordering = Ordering::make(_indexCatalogEntry->descriptor()->keyPattern());
+    auto keyLess = [&ordering](const BSONObj& lhs, const BSONObj& rhs) {
+        return lhs.woCompare(rhs, ordering) < 0;
+    };
+    auto keyEqual = [&ordering](const BSONObj& lhs, const BSONObj& rhs) {
+        return lhs.woCompare(rhs, ordering) == 0;
+    };
 
     static const char* curopMessage = "Index Build: checking for duplicate keys";
     ProgressMeterHolder progress;
@@ -111,26 +123,54 @@ Status DuplicateKeyTracker::checkConstraints(OperationContext* opCtx) const {
             CurOp::get(opCtx)->setProgress_inlock(curopMessage, _duplicateCounter.load(), 1));
     }
 
-
     int resolved = 0;
-    while (record) {
-        resolved++;
-        BSONObj conflict = record->data.toBson();
-        BSONObj keyObj = conflict[kKeyField].Obj();
-
-        auto status = index->dupKeyCheck(opCtx, keyObj);
-        if (!status.isOK())
-            return status;
-
-        WriteUnitOfWork wuow(opCtx);
-        _keyConstraintsTable->rs()->deleteRecord(opCtx, record->id);
+    std::vector<RecordId> batchIds;
+    std::vector<BSONObj> batchKeys;
+    bool exhausted = false;
+    while (!exhausted) {
+        batchIds.clear();
+        batchKeys.clear();
+        int batchBytes = 0;
+        while (batchBytes < kMaxCheckBatchBytes) {
+            auto record = constraintsCursor->next();
+            if (!record) {
+                exhausted = true;
+                break;
+            }
+
+            BSONObj conflict = record->data.toBson();
+            batchBytes += conflict.objsize();
+            batchKeys.push_back(conflict[kKeyField].Obj().getOwned());
+            batchIds.push_back(record->id);
+        }
+
+        if (batchIds.empty()) {
+            break;
+        }
+
+        // A key is often recorded once for each of its conflicting writes, so check each distinct
+        // key only once, and in index order rather than in the order the conflicts were recorded.
+        std::sort(batchKeys.begin(), batchKeys.end(), keyLess);
+        batchKeys.erase(std::unique(batchKeys.begin(), batchKeys.end(), keyEqual),
+                        batchKeys.end());
+        for (auto&& key : batchKeys) {
+            auto status = index->dupKeyCheck(opCtx, key);
+            if (!status.isOK())
+                return status;
+        }
 
         constraintsCursor->save();
-        wuow.commit();
+        {
+            WriteUnitOfWork wuow(opCtx);
+            for (auto&& id : batchIds) {
+                _keyConstraintsTable->rs()->deleteRecord(opCtx, id);
+            }
+            wuow.commit();
+        }
         constraintsCursor->restore();
 
-        progress->hit();
-        record = constraintsCursor->next();
+        resolved += batchIds.size();
+        progress->hit(batchIds.size());
     }
     progress->finished();
 
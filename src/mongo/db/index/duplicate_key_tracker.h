@@ -70,7 +70,8 @@ public:
     /**
      * Returns Status::OK if all previously recorded duplicate key constraint violations have been
      * resolved for the index. Returns a DuplicateKey error if there are still duplicate key
-     * constraint violations on the index.
+     * constraint violations on the index. The recorded keys are rechecked in sorted batches, each
+     * distinct key once per batch.
      *
      * Must not be in a WriteUnitOfWork.
      */
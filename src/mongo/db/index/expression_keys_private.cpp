@@ -91,9 +91,6 @@ Status S2GetKeysForElement(const BSONElement& element,
     if (!status.isOK())
         return status;
 
-    S2RegionCoverer coverer;
-    params.configureCoverer(geoContainer, &coverer);
-
     // Don't index big polygon
     if (geoContainer.getNativeCRS() == STRICT_SPHERE) {
         return Status(ErrorCodes::BadValue, "can't index geometry with strict winding order");
@@ -116,6 +113,17 @@ Status S2GetKeysForElement(const BSONElement& element,
 
     invariant(geoContainer.hasS2Region());
 
+    // Points are indexed by the leaf cell containing them, which is exactly what the region
+    // coverer would produce, so skip the coverer for them.
+    if (params.indexVersion >= S2_INDEX_VERSION_3 && geoContainer.isPoint()) {
+        const S2Cell& cell = geoContainer.getPoint().cell;
+        invariant(cell.is_leaf());
+        out->push_back(cell.id());
+        return Status::OK();
+    }
+
+    S2RegionCoverer coverer;
+    params.configureCoverer(geoContainer, &coverer);
     coverer.GetCovering(geoContainer.getS2Region(), out);
     return Status::OK();
 }
@@ -33,6 +33,7 @@
 
 #include "mongo/db/index/btree_access_method.h"
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 
@@ -206,33 +207,9 @@ Status AbstractIndexAccessMethod::insertKeys(OperationContext* opCtx,
     for (const auto keySet : {&keys, &multikeyMetadataKeys}) {
         const auto& recordId = (keySet == &keys ? loc : kMultikeyMetadataKeyId);
         for (const auto& key : *keySet) {
-            Status status = checkIndexKeySize ? checkKeySize(key) : Status::OK();
-            if (status.isOK()) {
-                bool unique = _descriptor->unique();
-                StatusWith<SpecialFormatInserted> ret =
-                    _newInterface->insert(opCtx, key, recordId, !unique /* dupsAllowed */);
-                status = ret.getStatus();
-
-                // When duplicates are encountered and allowed, retry with dupsAllowed. Add the
-                // key to the output vector so callers know which duplicate keys were inserted.
-                if (ErrorCodes::DuplicateKey == status.code() && options.dupsAllowed) {
-                    invariant(unique);
-                    ret = _newInterface->insert(opCtx, key, recordId, true /* dupsAllowed */);
-                    status = ret.getStatus();
-
-                    // This is speculative in that the 'dupsInserted' vector is not used by any code
-                    // today. It is currently in place to test detecting duplicate key errors during
-                    // hybrid index builds. Duplicate detection in the future will likely not take
-                    // place in this insert() method.
-                    if (status.isOK() && result) {
-                        result->dupsInserted.push_back(key);
-                    }
-                }
-
-                if (status.isOK() && ret.getValue() == SpecialFormatInserted::LongTypeBitsInserted)
-                    _btreeState->setIndexKeyStringWithLongTypeBitsExistsOnDisk(opCtx);
-            }
-            if (isFatalError(opCtx, status, key)) {
+            Status status =
+                insertOneKey(opCtx, key, recordId, options, checkIndexKeySize, result);
+            if (!status.isOK()) {
                 return status;
             }
         }
@@ -248,6 +225,117 @@ Status AbstractIndexAccessMethod::insertKeys(OperationContext* opCtx,
     return Status::OK();
 }
 
+Status AbstractIndexAccessMethod::insertBatch(OperationContext* opCtx,
+                                              const std::vector<const BSONObj*>& objs,
+                                              const std::vector<RecordId>& locs,
+                                              const InsertDeleteOptions& options,
+                                              InsertResult* result) {
+    invariant(options.fromIndexBuilder || !_btreeState->isHybridBuilding());
+    invariant(objs.size() == locs.size());
+
+    // Generate the keys of every document up front, merging the multikey state of the batch the
+    // same way the bulk builder does.
+    std::vector<std::pair<BSONObj, RecordId>> keysToInsert;
+    BSONObjSet multikeyMetadataKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    MultikeyPaths batchMultikeyPaths;
+    bool isMultikey = false;
+    for (size_t i = 0; i < objs.size(); ++i) {
+        BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        MultikeyPaths multikeyPaths;
+        getKeys(*objs[i], options.getKeysMode, &keys, &multikeyMetadataKeys, &multikeyPaths);
+
+        if (!multikeyPaths.empty()) {
+            if (batchMultikeyPaths.empty()) {
+                batchMultikeyPaths = multikeyPaths;
+            } else {
+                invariant(batchMultikeyPaths.size() == multikeyPaths.size());
+                for (size_t j = 0; j < multikeyPaths.size(); ++j) {
+                    batchMultikeyPaths[j].insert(multikeyPaths[j].begin(), multikeyPaths[j].end());
+                }
+            }
+        }
+        isMultikey =
+            isMultikey || shouldMarkIndexAsMultikey(keys, multikeyMetadataKeys, multikeyPaths);
+
+        for (const auto& key : keys) {
+            keysToInsert.emplace_back(key, locs[i]);
+        }
+    }
+
+    // Sort the keys in the order of the index, so that they are inserted as an ascending run.
+    const Ordering ordering = Ordering::make(_descriptor->keyPattern());
+    using KeyAndLoc = std::pair<BSONObj, RecordId>;
+    std::sort(keysToInsert.begin(),
+              keysToInsert.end(),
+              [&](const KeyAndLoc& lhs, const KeyAndLoc& rhs) {
+                  const int cmp = lhs.first.woCompare(rhs.first, ordering, false);
+                  return cmp < 0 || (cmp == 0 && lhs.second < rhs.second);
+              });
+
+    const bool checkIndexKeySize = shouldCheckIndexKeySize(opCtx);
+    for (const auto& keyAndLoc : keysToInsert) {
+        Status status = insertOneKey(
+            opCtx, keyAndLoc.first, keyAndLoc.second, options, checkIndexKeySize, result);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+    for (const auto& key : multikeyMetadataKeys) {
+        Status status =
+            insertOneKey(opCtx, key, kMultikeyMetadataKeyId, options, checkIndexKeySize, result);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    if (result) {
+        result->numInserted += keysToInsert.size() + multikeyMetadataKeys.size();
+    }
+
+    if (isMultikey) {
+        _btreeState->setMultikey(opCtx, batchMultikeyPaths);
+    }
+    return Status::OK();
+}
+
+Status AbstractIndexAccessMethod::insertOneKey(OperationContext* opCtx,
+                                               const BSONObj& key,
+                                               const RecordId& loc,
+                                               const InsertDeleteOptions& options,
+                                               bool checkIndexKeySize,
+                                               InsertResult* result) {
+    Status status = checkIndexKeySize ? checkKeySize(key) : Status::OK();
+    if (status.isOK()) {
+        bool unique = _descriptor->unique();
+        StatusWith<SpecialFormatInserted> ret =
+            _newInterface->insert(opCtx, key, loc, !unique /* dupsAllowed */);
+        status = ret.getStatus();
+
+        // When duplicates are encountered and allowed, retry with dupsAllowed. Add the key to the
+        // output vector so callers know which duplicate keys were inserted.
+        if (ErrorCodes::DuplicateKey == status.code() && options.dupsAllowed) {
+            invariant(unique);
+            ret = _newInterface->insert(opCtx, key, loc, true /* dupsAllowed */);
+            status = ret.getStatus();
+
+            // This is speculative in that the 'dupsInserted' vector is not used by any code today.
+            // It is currently in place to test detecting duplicate key errors during hybrid index
+            // builds. Duplicate detection in the future will likely not take place in this
+            // insert() method.
+            if (status.isOK() && result) {
+                result->dupsInserted.push_back(key);
+            }
+        }
+
+        if (status.isOK() && ret.getValue() == SpecialFormatInserted::LongTypeBitsInserted)
+            _btreeState->setIndexKeyStringWithLongTypeBitsExistsOnDisk(opCtx);
+    }
+    if (isFatalError(opCtx, status, key)) {
+        return status;
+    }
+    return Status::OK();
+}
+
 void AbstractIndexAccessMethod::removeOneKey(OperationContext* opCtx,
                                              const BSONObj& key,
                                              const RecordId& loc,
@@ -530,6 +618,11 @@ public:
                   const RecordId& loc,
                   const InsertDeleteOptions& options) final;
 
+    void insertKeys(const BSONObjSet& keys,
+                    const BSONObjSet& multikeyMetadataKeys,
+                    const MultikeyPaths& multikeyPaths,
+                    const RecordId& loc) final;
+
     const MultikeyPaths& getMultikeyPaths() const final;
 
     bool isMultikey() const final;
@@ -543,6 +636,12 @@ public:
     int64_t getKeysInserted() const final;
 
 private:
+    /**
+     * Adds the keys of the document at 'loc' to the sorter, and notes whether they make the index
+     * multikey.
+     */
+    void _addKeys(const BSONObjSet& keys, const MultikeyPaths& multikeyPaths, const RecordId& loc);
+
     std::unique_ptr<Sorter> _sorter;
     const IndexAccessMethod* _real;
     int64_t _keysInserted = 0;
@@ -589,6 +688,21 @@ Status AbstractIndexAccessMethod::BulkBuilderImpl::insert(OperationContext* opCt
         return exceptionToStatus();
     }
 
+    _addKeys(keys, multikeyPaths, loc);
+    return Status::OK();
+}
+
+void AbstractIndexAccessMethod::BulkBuilderImpl::insertKeys(const BSONObjSet& keys,
+                                                            const BSONObjSet& multikeyMetadataKeys,
+                                                            const MultikeyPaths& multikeyPaths,
+                                                            const RecordId& loc) {
+    _multikeyMetadataKeys.insert(multikeyMetadataKeys.begin(), multikeyMetadataKeys.end());
+    _addKeys(keys, multikeyPaths, loc);
+}
+
+void AbstractIndexAccessMethod::BulkBuilderImpl::_addKeys(const BSONObjSet& keys,
+                                                          const MultikeyPaths& multikeyPaths,
+                                                          const RecordId& loc) {
     if (!multikeyPaths.empty()) {
         if (_indexMultikeyPaths.empty()) {
             _indexMultikeyPaths = multikeyPaths;
@@ -607,8 +721,6 @@ Status AbstractIndexAccessMethod::BulkBuilderImpl::insert(OperationContext* opCt
 
     _isMultiKey =
         _isMultiKey || _real->shouldMarkIndexAsMultikey(keys, _multikeyMetadataKeys, multikeyPaths);
-
-    return Status::OK();
 }
 
 const MultikeyPaths& AbstractIndexAccessMethod::BulkBuilderImpl::getMultikeyPaths() const {
@@ -706,12 +818,16 @@ Status AbstractIndexAccessMethod::commitBulk(OperationContext* opCtx,
             return status;
         }
 
-        previousKey = data.first.getOwned();
-
-        if (isDup && dupsAllowed && dupKeysInserted) {
-            dupKeysInserted->push_back(data.first.getOwned());
+        // The sorter returns equal keys next to each other. Recording a key once for its whole run
+        // of duplicates is enough for it to be rechecked when the build commits.
+        if (isDup && dupsAllowed && dupKeysInserted &&
+            (dupKeysInserted->empty() ||
+             dupKeysInserted->back().woCompare(data.first, ordering) != 0)) {
+            dupKeysInserted->push_back(previousKey);
         }
 
+        previousKey = data.first.getOwned();
+
         // If we're here either it's a dup and we're cool with it or the addKey went just fine.
         pm.hit();
         wunit.commit();
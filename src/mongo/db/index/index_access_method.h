@@ -32,6 +32,7 @@
 #include <atomic>
 #include <memory>
 #include <set>
+#include <vector>
 
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/field_ref.h"
@@ -100,6 +101,18 @@ public:
                               const InsertDeleteOptions& options,
                               InsertResult* result) = 0;
 
+    /**
+     * Inserts the keys of each 'objs[i]' pointing to 'locs[i]', as insert() does for one document.
+     * The keys of all documents are generated first and then inserted in index key order, so the
+     * storage engine sees ascending inserts. The caller must not depend on the order in which the
+     * keys of different documents are written, e.g. by timestamping each document separately.
+     */
+    virtual Status insertBatch(OperationContext* opCtx,
+                               const std::vector<const BSONObj*>& objs,
+                               const std::vector<RecordId>& locs,
+                               const InsertDeleteOptions& options,
+                               InsertResult* result) = 0;
+
     /**
      * Analogous to above, but remove the records instead of inserting them.
      * 'numDeleted' will be set to the number of keys removed from the index for the document.
@@ -237,6 +250,16 @@ public:
                               const RecordId& loc,
                               const InsertDeleteOptions& options) = 0;
 
+        /**
+         * Adds keys already generated by getKeys() for the document at 'loc'. insert() is
+         * equivalent to calling getKeys() followed by insertKeys(), which lets callers generate
+         * the keys of many documents concurrently and only add them to the sorter serially.
+         */
+        virtual void insertKeys(const BSONObjSet& keys,
+                                const BSONObjSet& multikeyMetadataKeys,
+                                const MultikeyPaths& multikeyPaths,
+                                const RecordId& loc) = 0;
+
         virtual const MultikeyPaths& getMultikeyPaths() const = 0;
 
         virtual bool isMultikey() const = 0;
@@ -464,6 +487,12 @@ public:
                       const InsertDeleteOptions& options,
                       InsertResult* result) final;
 
+    Status insertBatch(OperationContext* opCtx,
+                       const std::vector<const BSONObj*>& objs,
+                       const std::vector<RecordId>& locs,
+                       const InsertDeleteOptions& options,
+                       InsertResult* result) final;
+
     Status remove(OperationContext* opCtx,
                   const BSONObj& obj,
                   const RecordId& loc,
@@ -581,6 +610,18 @@ private:
      */
     bool shouldCheckIndexKeySize(OperationContext* opCtx);
 
+    /**
+     * Inserts a single key into the index, returning a non-OK status only if the error is fatal.
+     *
+     * Used by insertKeys() and insertBatch() only.
+     */
+    Status insertOneKey(OperationContext* opCtx,
+                        const BSONObj& key,
+                        const RecordId& loc,
+                        const InsertDeleteOptions& options,
+                        bool checkIndexKeySize,
+                        InsertResult* result);
+
     /**
      * Removes a single key from the index.
      *
@@ -33,6 +33,8 @@
 
 #include "mongo/db/index/index_build_interceptor.h"
 
+#include <algorithm>
+
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/catalog/index_timestamp_helper.h"
 #include "mongo/db/catalog_raii.h"
@@ -202,13 +204,29 @@ Status IndexBuildInterceptor::drainWritesIntoIndex(OperationContext* opCtx,
 
         cursor->save();
 
+        // Apply the batch in index key order rather than in the order the writes were made, so
+        // that consecutive writes land next to each other in the index. The sort is stable, so the
+        // writes of any one key are still applied in their original order, and writes of different
+        // keys commute.
+        const Ordering& ordering = _indexCatalogEntry->ordering();
+        std::vector<std::pair<BSONObj, const SideWriteRecord*>> sortedBatch;
+        sortedBatch.reserve(batch.size());
+        for (const auto& operation : batch) {
+            sortedBatch.emplace_back(operation.second["key"].Obj(), &operation);
+        }
+        std::stable_sort(
+            sortedBatch.begin(), sortedBatch.end(), [&](const auto& lhs, const auto& rhs) {
+                return lhs.first.woCompare(rhs.first, ordering, false) < 0;
+            });
+
         // If we are here, either we have reached the end of the table or the batch is full, so
         // insert everything in one WriteUnitOfWork, and delete each inserted document from the side
         // writes table.
         auto status =
             writeConflictRetry(opCtx, "index build drain", _indexCatalogEntry->ns().ns(), [&] {
                 WriteUnitOfWork wuow(opCtx);
-                for (auto& operation : batch) {
+                for (const auto& sorted : sortedBatch) {
+                    const SideWriteRecord& operation = *sorted.second;
                     auto status = _applyWrite(
                         opCtx, operation.second, options, &totalInserted, &totalDeleted);
                     if (!status.isOK()) {
@@ -360,6 +378,10 @@ bool IndexBuildInterceptor::areAllWritesApplied(OperationContext* opCtx) const {
     return false;
 }
 
+long long IndexBuildInterceptor::getNumPendingSideWrites() const {
+    return std::max(_sideWritesCounter.load() - _numApplied, 0LL);
+}
+
 boost::optional<MultikeyPaths> IndexBuildInterceptor::getMultikeyPaths() const {
     stdx::unique_lock<stdx::mutex> lk(_multikeyPathMutex);
     return _multikeyPaths;
@@ -113,6 +113,12 @@ public:
      */
     bool areAllWritesApplied(OperationContext* opCtx) const;
 
+    /**
+     * Returns an estimate of the number of side writes recorded but not yet drained into the
+     * index. Must be called by the thread that drains this interceptor.
+     */
+    long long getNumPendingSideWrites() const;
+
     /**
      * Returns true if all recorded duplicate key constraint violations have been checked.
      */
@@ -44,6 +44,9 @@
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
 #include "mongo/util/str.h"
+#include "third_party/s2/s2cell.h"
+#include "third_party/s2/s2latlng.h"
+#include "third_party/s2/s2regioncoverer.h"
 
 using namespace mongo;
 
@@ -494,4 +497,37 @@ TEST(S2KeyGeneratorTest, MidPathSingleElementArrayIsConsideredMultikey) {
     assertMultikeyPathsEqual(MultikeyPaths{{0U}, std::set<size_t>{}}, actualMultikeyPaths);
 }
 
+TEST(S2KeyGeneratorTest, PointKeyMatchesRegionCovering) {
+    for (auto&& coords : {std::make_pair(0.0, 0.0),
+                          std::make_pair(-73.97, 40.77),
+                          std::make_pair(179.99, -89.99),
+                          std::make_pair(-180.0, 90.0)}) {
+        S2RegionCoverer coverer;
+        coverer.set_min_level(S2::kMaxCellLevel);
+        coverer.set_max_level(S2::kMaxCellLevel);
+        std::vector<S2CellId> cover;
+        coverer.GetCovering(
+            S2Cell(S2LatLng::FromDegrees(coords.second, coords.first).Normalized().ToPoint()),
+            &cover);
+        ASSERT_EQUALS(1U, cover.size());
+
+        BSONObj obj = BSON("a" << BSON("type"
+                                       << "Point"
+                                       << "coordinates"
+                                       << BSON_ARRAY(coords.first << coords.second)));
+        BSONObj keyPattern = fromjson("{a: '2dsphere'}");
+        BSONObj infoObj = fromjson("{key: {a: '2dsphere'}, '2dsphereIndexVersion': 3}");
+        S2IndexingParams params;
+        const CollatorInterface* collator = nullptr;
+        ExpressionParams::initialize2dsphereParams(infoObj, collator, &params);
+
+        BSONObjSet actualKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        ExpressionKeysPrivate::getS2Keys(obj, keyPattern, params, &actualKeys, nullptr);
+
+        BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        expectedKeys.insert(S2CellIdToIndexKey(cover[0], params.indexVersion));
+        ASSERT_TRUE(assertKeysetsEqual(expectedKeys, actualKeys));
+    }
+}
+
 }  // namespace
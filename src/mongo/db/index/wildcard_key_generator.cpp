@@ -33,6 +33,7 @@
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/collation/collation_index_key.h"
+#include "mongo/stdx/memory.h"
 
 namespace mongo {
 namespace {
@@ -96,17 +97,39 @@ WildcardKeyGenerator::WildcardKeyGenerator(BSONObj keyPattern,
                                            const CollatorInterface* collator)
     : _collator(collator), _keyPattern(keyPattern) {
     _projExec = createProjectionExec(keyPattern, pathProjection);
+    _isInclusion = _projExec->getType() == ProjectionExecAgg::ProjectionType::kInclusionProjection;
+    _buildProjectionTrie(_projExec->serializeTransformation(), _isInclusion, &_projectionRoot);
+}
+
+void WildcardKeyGenerator::_buildProjectionTrie(const BSONObj& normalizedSpec,
+                                                bool isInclusion,
+                                                ProjectionNode* node) {
+    // The normalized spec has no dotted paths, and its leaves are booleans. A leaf whose value does
+    // not match the projection type is an explicit '_id' inclusion or exclusion which leaves the
+    // document as the projection would have left it anyway.
+    for (auto&& elem : normalizedSpec) {
+        if (elem.type() == BSONType::Object) {
+            auto& child = node->children[elem.fieldNameStringData()];
+            child = stdx::make_unique<ProjectionNode>();
+            _buildProjectionTrie(elem.embeddedObject(), isInclusion, child.get());
+        } else if (elem.trueValue() == isInclusion) {
+            auto& child = node->children[elem.fieldNameStringData()];
+            child = stdx::make_unique<ProjectionNode>();
+            child->isLeaf = true;
+        }
+    }
 }
 
 void WildcardKeyGenerator::generateKeys(BSONObj inputDoc,
                                         BSONObjSet* keys,
                                         BSONObjSet* multikeyPaths) const {
     FieldRef rootPath;
-    _traverseWildcard(_projExec->applyProjection(inputDoc), false, &rootPath, keys, multikeyPaths);
+    _traverseWildcard(inputDoc, false, &_projectionRoot, &rootPath, keys, multikeyPaths);
 }
 
 void WildcardKeyGenerator::_traverseWildcard(BSONObj obj,
                                              bool objIsArray,
+                                             const ProjectionNode* node,
                                              FieldRef* path,
                                              BSONObjSet* keys,
                                              BSONObjSet* multikeyPaths) const {
@@ -115,6 +138,30 @@ void WildcardKeyGenerator::_traverseWildcard(BSONObj obj,
         if (elem.fieldNameStringData().find('.', 0) != std::string::npos)
             continue;
 
+        // Work out which part of the element survives the projection. The elements of an array
+        // are projected by the array's own node. Inclusions drop scalars and nested arrays found
+        // beneath a projected path, while exclusions keep them.
+        const ProjectionNode* elemNode = node;
+        if (node && objIsArray) {
+            if (_isInclusion && elem.type() != BSONType::Object)
+                continue;
+        } else if (node) {
+            auto it = node->children.find(elem.fieldNameStringData());
+            if (it == node->children.end()) {
+                if (_isInclusion)
+                    continue;
+                elemNode = nullptr;
+            } else if (it->second->isLeaf) {
+                if (!_isInclusion)
+                    continue;
+                elemNode = nullptr;
+            } else {
+                if (_isInclusion && !elem.isABSONObj())
+                    continue;
+                elemNode = it->second.get();
+            }
+        }
+
         // Append the element's fieldname to the path, if the enclosing object is not an array.
         pushPathComponent(elem, objIsArray, path);
 
@@ -128,11 +175,15 @@ void WildcardKeyGenerator::_traverseWildcard(BSONObj obj,
                 _addMultiKey(*path, multikeyPaths);
 
             case BSONType::Object:
-                if (_addKeyForEmptyLeaf(elem, *path, keys))
+                if (_addKeyForEmptyLeaf(elem, elemNode, *path, keys))
                     break;
 
-                _traverseWildcard(
-                    elem.Obj(), elem.type() == BSONType::Array, path, keys, multikeyPaths);
+                _traverseWildcard(elem.Obj(),
+                                  elem.type() == BSONType::Array,
+                                  elemNode,
+                                  path,
+                                  keys,
+                                  multikeyPaths);
                 break;
 
             default:
@@ -156,11 +207,40 @@ bool WildcardKeyGenerator::_addKeyForNestedArray(BSONElement elem,
     return false;
 }
 
+bool WildcardKeyGenerator::_isEmptyAfterProjection(BSONObj obj,
+                                                   bool objIsArray,
+                                                   const ProjectionNode* node) const {
+    if (!node || obj.isEmpty()) {
+        return obj.isEmpty();
+    }
+    // Mirrors the filtering in _traverseWildcard, except that fields with a "." in their name count
+    // towards the projected object even though they are never indexed.
+    for (auto&& elem : obj) {
+        if (objIsArray) {
+            if (!_isInclusion || elem.type() == BSONType::Object)
+                return false;
+            continue;
+        }
+        auto it = node->children.find(elem.fieldNameStringData());
+        if (it == node->children.end()) {
+            if (!_isInclusion)
+                return false;
+        } else if (it->second->isLeaf) {
+            if (_isInclusion)
+                return false;
+        } else if (!_isInclusion || elem.isABSONObj()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool WildcardKeyGenerator::_addKeyForEmptyLeaf(BSONElement elem,
+                                               const ProjectionNode* node,
                                                const FieldRef& fullPath,
                                                BSONObjSet* keys) const {
     invariant(elem.isABSONObj());
-    if (elem.embeddedObject().isEmpty()) {
+    if (_isEmptyAfterProjection(elem.embeddedObject(), elem.type() == BSONType::Array, node)) {
         // In keeping with the behaviour of regular indexes, an empty object is indexed as-is while
         // empty arrays are indexed as 'undefined'.
         _addKey(elem.type() == BSONType::Array ? BSONElement{} : elem, fullPath, keys);
@@ -32,6 +32,7 @@
 #include "mongo/db/exec/projection_exec_agg.h"
 #include "mongo/db/field_ref.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -64,23 +65,43 @@ public:
     }
 
     /**
-     * Applies the appropriate Wildcard projection to the input doc, and then adds one key-value
-     * pair to the BSONObjSet 'keys' for each leaf node in the post-projection document:
+     * Adds one key-value pair to the BSONObjSet 'keys' for each leaf node in the document that
+     * results from applying the Wildcard projection to the input doc:
      *      { '': 'path.to.field', '': <collation-aware-field-value> }
      * Also adds one entry to 'multikeyPaths' for each array encountered in the post-projection
      * document, in the following format:
      *      { '': 1, '': 'path.to.array' }
+     * The projection is evaluated while walking the input doc, so the post-projection document is
+     * never materialized.
      */
     void generateKeys(BSONObj inputDoc, BSONObjSet* keys, BSONObjSet* multikeyPaths) const;
 
 private:
+    // A node of the projection's path trie. A leaf includes (for an inclusion projection) or
+    // excludes (for an exclusion projection) the entire subtree rooted at its path; a node with
+    // children applies the projection to the fields beneath it.
+    struct ProjectionNode {
+        bool isLeaf = false;
+        StringMap<std::unique_ptr<ProjectionNode>> children;
+    };
+
+    static void _buildProjectionTrie(const BSONObj& normalizedSpec,
+                                     bool isInclusion,
+                                     ProjectionNode* node);
+
     // Traverses every path of the post-projection document, adding keys to the set as it goes.
+    // 'node' is the projection applied to the fields of 'obj', or nullptr if the whole of 'obj'
+    // survives the projection.
     void _traverseWildcard(BSONObj obj,
                            bool objIsArray,
+                           const ProjectionNode* node,
                            FieldRef* path,
                            BSONObjSet* keys,
                            BSONObjSet* multikeyPaths) const;
 
+    // Returns true if applying 'node' to 'obj' would leave an empty object or array.
+    bool _isEmptyAfterProjection(BSONObj obj, bool objIsArray, const ProjectionNode* node) const;
+
     // Helper functions to format the entry appropriately before adding it to the key/path tracker.
     void _addMultiKey(const FieldRef& fullPath, BSONObjSet* multikeyPaths) const;
     void _addKey(BSONElement elem, const FieldRef& fullPath, BSONObjSet* keys) const;
@@ -90,9 +111,14 @@ private:
                                const FieldRef& fullPath,
                                bool enclosingObjIsArray,
                                BSONObjSet* keys) const;
-    bool _addKeyForEmptyLeaf(BSONElement elem, const FieldRef& fullPath, BSONObjSet* keys) const;
+    bool _addKeyForEmptyLeaf(BSONElement elem,
+                             const ProjectionNode* node,
+                             const FieldRef& fullPath,
+                             BSONObjSet* keys) const;
 
     std::unique_ptr<ProjectionExecAgg> _projExec;
+    ProjectionNode _projectionRoot;
+    bool _isInclusion;
     const CollatorInterface* _collator;
     const BSONObj _keyPattern;
 };
@@ -490,6 +490,42 @@ TEST(WildcardKeyGeneratorInclusionTest, InclusionProjectionMultipleSubtrees) {
     ASSERT(assertKeysetsEqual(expectedMultikeyPaths, multikeyMetadataKeys));
 }
 
+TEST(WildcardKeyGeneratorInclusionTest, IndexObjectsEmptiedByInclusionProjection) {
+    WildcardKeyGenerator keyGen{fromjson("{'$**': 1}"), fromjson("{'a.b': 1, 'c.d': 1}"), nullptr};
+
+    auto inputDoc = fromjson("{a: [{b: 1, c: 2}, 3, [{b: 4}], {c: 5}], c: {e: 6}, f: 7}");
+
+    auto expectedKeys = makeKeySet({fromjson("{'': 'a.b', '': 1}"),
+                                    fromjson("{'': 'a', '': {}}"),
+                                    fromjson("{'': 'c', '': {}}")});
+
+    auto expectedMultikeyPaths = makeKeySet({fromjson("{'': 1, '': 'a'}")});
+
+    auto outputKeys = makeKeySet();
+    auto multikeyMetadataKeys = makeKeySet();
+    keyGen.generateKeys(inputDoc, &outputKeys, &multikeyMetadataKeys);
+
+    ASSERT(assertKeysetsEqual(expectedKeys, outputKeys));
+    ASSERT(assertKeysetsEqual(expectedMultikeyPaths, multikeyMetadataKeys));
+}
+
+TEST(WildcardKeyGeneratorInclusionTest, IndexArrayEmptiedByInclusionProjectionAsUndefined) {
+    WildcardKeyGenerator keyGen{fromjson("{'$**': 1}"), fromjson("{'a.b': 1}"), nullptr};
+
+    auto inputDoc = fromjson("{a: [1, [{b: 2}]], c: 3}");
+
+    auto expectedKeys = makeKeySet({fromjson("{'': 'a', '': undefined}")});
+
+    auto expectedMultikeyPaths = makeKeySet({fromjson("{'': 1, '': 'a'}")});
+
+    auto outputKeys = makeKeySet();
+    auto multikeyMetadataKeys = makeKeySet();
+    keyGen.generateKeys(inputDoc, &outputKeys, &multikeyMetadataKeys);
+
+    ASSERT(assertKeysetsEqual(expectedKeys, outputKeys));
+    ASSERT(assertKeysetsEqual(expectedMultikeyPaths, multikeyMetadataKeys));
+}
+
 // Explicit exclusion tests.
 
 TEST(WildcardKeyGeneratorExclusionTest, ExclusionProjectionSingleSubtree) {
@@ -646,6 +682,27 @@ TEST(WildcardKeyGeneratorExclusionTest, ExclusionProjectionMultipleSubtrees) {
     ASSERT(assertKeysetsEqual(expectedMultikeyPaths, multikeyMetadataKeys));
 }
 
+TEST(WildcardKeyGeneratorExclusionTest, ExclusionProjectionKeepsScalarsAndNestedArrays) {
+    WildcardKeyGenerator keyGen{fromjson("{'$**': 1}"), fromjson("{'a.b': 0}"), nullptr};
+
+    auto inputDoc = fromjson("{a: [{b: 1, c: 2}, 3, [{b: 4}], {b: 5}], d: {b: 6}}");
+
+    auto expectedKeys = makeKeySet({fromjson("{'': 'a.c', '': 2}"),
+                                    fromjson("{'': 'a', '': 3}"),
+                                    fromjson("{'': 'a', '': [{b: 4}]}"),
+                                    fromjson("{'': 'a', '': {}}"),
+                                    fromjson("{'': 'd.b', '': 6}")});
+
+    auto expectedMultikeyPaths = makeKeySet({fromjson("{'': 1, '': 'a'}")});
+
+    auto outputKeys = makeKeySet();
+    auto multikeyMetadataKeys = makeKeySet();
+    keyGen.generateKeys(inputDoc, &outputKeys, &multikeyMetadataKeys);
+
+    ASSERT(assertKeysetsEqual(expectedKeys, outputKeys));
+    ASSERT(assertKeysetsEqual(expectedMultikeyPaths, multikeyMetadataKeys));
+}
+
 // Test _id inclusion and exclusion behaviour.
 
 TEST(WildcardKeyGeneratorIdTest, ExcludeIdFieldIfProjectionIsEmpty) {
@@ -36,6 +36,7 @@
 #include "mongo/db/catalog/commit_quorum_options.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/index_build_entry_gen.h"
+#include "mongo/db/catalog/multi_index_block_gen.h"
 #include "mongo/db/catalog/uuid_catalog.h"
 #include "mongo/db/catalog_raii.h"
 #include "mongo/db/concurrency/locker.h"
@@ -53,6 +54,7 @@
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -66,6 +68,7 @@ namespace {
 
 constexpr StringData kCreateIndexesFieldName = "createIndexes"_sd;
 constexpr StringData kIndexesFieldName = "indexes"_sd;
+constexpr StringData kPhaseDurationsMillisFieldName = "phaseDurationsMillis"_sd;
 constexpr StringData kKeyFieldName = "key"_sd;
 constexpr StringData kUniqueFieldName = "unique"_sd;
 
@@ -469,6 +472,17 @@ void IndexBuildsCoordinator::_updateCurOpOpDescription(
     curOp->ensureStarted();
 }
 
+void IndexBuildsCoordinator::_updateCurOpPhaseDurations(OperationContext* opCtx,
+                                                        const BSONObj& phaseDurations) const {
+    BSONObjBuilder builder;
+    builder.append(kPhaseDurationsMillisFieldName, phaseDurations);
+
+    stdx::unique_lock<Client> lk(*opCtx->getClient());
+    auto curOp = CurOp::get(opCtx);
+    builder.appendElementsUnique(curOp->opDescription());
+    curOp->setOpDescription_inlock(builder.obj());
+}
+
 Status IndexBuildsCoordinator::_registerIndexBuild(
     WithLock lk, std::shared_ptr<ReplIndexBuildState> replIndexBuildState) {
 
@@ -843,6 +857,15 @@ void IndexBuildsCoordinator::_buildIndex(OperationContext* opCtx,
         }
     });
 
+    // Records how long each phase of the index build took in this operation's CurOp entry.
+    BSONObjBuilder phaseDurations;
+    Timer phaseTimer;
+    auto endPhase = [&](StringData phaseName) {
+        phaseDurations.append(phaseName, phaseTimer.millis());
+        phaseTimer.reset();
+        _updateCurOpPhaseDurations(opCtx, phaseDurations.asTempObj());
+    };
+
     // Collection scan and insert into index, followed by a drain of writes received in the
     // background.
     {
@@ -850,6 +873,7 @@ void IndexBuildsCoordinator::_buildIndex(OperationContext* opCtx,
         uassertStatusOK(
             _indexBuildsManager.startBuildingIndex(opCtx, collection, replState->buildUUID));
     }
+    endPhase("collectionScan"_sd);
 
     if (MONGO_FAIL_POINT(hangAfterIndexBuildDumpsInsertsFromBulk)) {
         log() << "Hanging after dumping inserts from bulk builder";
@@ -866,24 +890,60 @@ void IndexBuildsCoordinator::_buildIndex(OperationContext* opCtx,
         uassertStatusOK(_indexBuildsManager.drainBackgroundWrites(
             opCtx, replState->buildUUID, RecoveryUnit::ReadSource::kNoOverlap));
     }
+    endPhase("firstDrain"_sd);
 
     if (MONGO_FAIL_POINT(hangAfterIndexBuildFirstDrain)) {
         log() << "Hanging after index build first drain";
         MONGO_FAIL_POINT_PAUSE_WHILE_SET(hangAfterIndexBuildFirstDrain);
     }
 
-    // Perform the second drain while stopping writes on the collection.
-    {
+    // Keep draining while holding an intent lock until few enough side writes remain that the
+    // final drain under the exclusive lock is short. Once that happens, writers are never stopped
+    // for a drain under a shared lock.
+    const int maxIntentLockDrainPasses = maxIndexBuildDrainPassesUnderIntentLocks.load();
+    const long long maxSideWritesForExclusiveDrain =
+        maxIndexBuildSideWritesForExclusiveDrain.load();
+    bool drainedUnderIntentLocks = false;
+    int intentLockDrainPasses = 0;
+    while (_indexBuildsManager.isBackgroundBuilding(replState->buildUUID) &&
+           intentLockDrainPasses < maxIntentLockDrainPasses) {
+        if (_indexBuildsManager.getNumPendingSideWrites(replState->buildUUID) <=
+            maxSideWritesForExclusiveDrain) {
+            drainedUnderIntentLocks = true;
+            break;
+        }
+
+        opCtx->recoveryUnit()->abandonSnapshot();
+        Lock::CollectionLock colLock(opCtx, nss, MODE_IS);
+        uassertStatusOK(_indexBuildsManager.drainBackgroundWrites(
+            opCtx, replState->buildUUID, RecoveryUnit::ReadSource::kNoOverlap));
+        ++intentLockDrainPasses;
+    }
+    if (maxIntentLockDrainPasses > 0) {
+        if (!drainedUnderIntentLocks) {
+            drainedUnderIntentLocks =
+                _indexBuildsManager.getNumPendingSideWrites(replState->buildUUID) <=
+                maxSideWritesForExclusiveDrain;
+        }
+        LOG(1) << "Index build: " << replState->buildUUID << ": performed "
+               << intentLockDrainPasses << " additional drains under intent locks";
+        endPhase("intentLockDrains"_sd);
+    }
+
+    // Perform the second drain while stopping writes on the collection, unless the drains under
+    // intent locks have left little enough for the final drain.
+    if (!drainedUnderIntentLocks) {
         opCtx->recoveryUnit()->abandonSnapshot();
         Lock::CollectionLock colLock(opCtx, nss, MODE_S);
 
         uassertStatusOK(_indexBuildsManager.drainBackgroundWrites(
             opCtx, replState->buildUUID, RecoveryUnit::ReadSource::kUnset));
-    }
+        endPhase("secondDrain"_sd);
 
-    if (MONGO_FAIL_POINT(hangAfterIndexBuildSecondDrain)) {
-        log() << "Hanging after index build second drain";
-        MONGO_FAIL_POINT_PAUSE_WHILE_SET(hangAfterIndexBuildSecondDrain);
+        if (MONGO_FAIL_POINT(hangAfterIndexBuildSecondDrain)) {
+            log() << "Hanging after index build second drain";
+            MONGO_FAIL_POINT_PAUSE_WHILE_SET(hangAfterIndexBuildSecondDrain);
+        }
     }
 
     relockOnErrorGuard.dismiss();
@@ -916,12 +976,14 @@ void IndexBuildsCoordinator::_buildIndex(OperationContext* opCtx,
                                 << " ("
                                 << replState->collectionUUID
                                 << ")");
+        endPhase("exclusiveLockWait"_sd);
     }
 
     // Perform the third and final drain after releasing a shared lock and reacquiring an
     // exclusive lock on the database.
     uassertStatusOK(_indexBuildsManager.drainBackgroundWrites(
         opCtx, replState->buildUUID, RecoveryUnit::ReadSource::kUnset));
+    endPhase("finalDrain"_sd);
 
     // Index constraint checking phase.
     uassertStatusOK(
@@ -952,6 +1014,7 @@ void IndexBuildsCoordinator::_buildIndex(OperationContext* opCtx,
     // Commit index build.
     uassertStatusOK(_indexBuildsManager.commitIndexBuild(
         opCtx, collection, nss, replState->buildUUID, onCreateEachFn, onCommitFn));
+    endPhase("commit"_sd);
 
     return;
 }
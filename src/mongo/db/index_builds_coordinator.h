@@ -329,6 +329,12 @@ private:
                                    const NamespaceString& nss,
                                    const std::vector<BSONObj>& indexSpecs) const;
 
+    /**
+     * Replaces the 'phaseDurationsMillis' field of CurOp's 'opDescription' with 'phaseDurations',
+     * which maps each completed phase of this index build to the time it took.
+     */
+    void _updateCurOpPhaseDurations(OperationContext* opCtx, const BSONObj& phaseDurations) const;
+
     /**
      * Registers an index build so that the rest of the system can discover it.
      *
@@ -47,7 +47,11 @@
 
 #include "mongo/base/init.h"
 #include "mongo/config.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/service_context.h"
+#include "mongo/logger/async_file_appender.h"
+#include "mongo/logger/async_log_writer.h"
 #include "mongo/logger/console_appender.h"
 #include "mongo/logger/logger.h"
 #include "mongo/logger/message_event.h"
@@ -63,6 +67,7 @@
 #include "mongo/util/quick_exit.h"
 #include "mongo/util/signal_handlers_synchronous.h"
 #include "mongo/util/str.h"
+#include "mongo/util/tsc_tick_source.h"
 
 #if defined(__APPLE__)
 #include <TargetConditionals.h>
@@ -205,6 +210,53 @@ void forkServerOrDie() {
         quickExit(EXIT_FAILURE);
 }
 
+namespace {
+
+// Background writer for the log file when 'logAsyncQueueLines' is set. Never destroyed, since
+// logging continues until the process exits.
+logger::AsyncLogWriter* asyncLogWriter = nullptr;
+
+/**
+ * Reports one of the counters of asyncLogWriter under serverStatus().metrics.log.async.
+ */
+class AsyncLogWriterMetric : public ServerStatusMetric {
+public:
+    AsyncLogWriterMetric(const std::string& name, long long logger::AsyncLogWriter::Stats::*field)
+        : ServerStatusMetric(name), _field(field) {}
+
+    void appendAtLeaf(BSONObjBuilder& b) const override {
+        b.append(_leafName, asyncLogWriter ? asyncLogWriter->getStats().*_field : 0LL);
+    }
+
+private:
+    long long logger::AsyncLogWriter::Stats::*const _field;
+};
+
+AsyncLogWriterMetric asyncLogLinesWritten("log.async.linesWritten",
+                                          &logger::AsyncLogWriter::Stats::linesWritten);
+AsyncLogWriterMetric asyncLogLinesDropped("log.async.linesDropped",
+                                          &logger::AsyncLogWriter::Stats::linesDropped);
+AsyncLogWriterMetric asyncLogBlockedAppends("log.async.blockedAppends",
+                                            &logger::AsyncLogWriter::Stats::blockedAppends);
+
+/**
+ * Attaches an appender for "writer" to "domain", going through asyncLogWriter if it is set.
+ */
+void attachFileAppender(logger::MessageLogDomain* domain, logger::RotatableFileWriter* writer) {
+    using logger::MessageEventEphemeral;
+
+    if (asyncLogWriter) {
+        domain->attachAppender(std::make_unique<logger::AsyncFileAppender<MessageEventEphemeral>>(
+            std::make_unique<logger::MessageEventDetailsEncoder>(), asyncLogWriter));
+    } else {
+        domain->attachAppender(
+            std::make_unique<logger::RotatableFileAppender<MessageEventEphemeral>>(
+                std::make_unique<logger::MessageEventDetailsEncoder>(), writer));
+    }
+}
+
+}  // namespace
+
 // On POSIX platforms we need to set our umask before opening any log files, so this
 // should depend on MungeUmask above, but not on Windows.
 MONGO_INITIALIZER_GENERAL(
@@ -217,7 +269,6 @@ MONGO_INITIALIZER_GENERAL(
     using logger::MessageEventDetailsEncoder;
     using logger::MessageEventWithContextEncoder;
     using logger::MessageLogDomain;
-    using logger::RotatableFileAppender;
     using logger::StatusWithRotatableFileWriter;
 
     // Hook up this global into our logging encoder
@@ -291,14 +342,19 @@ MONGO_INITIALIZER_GENERAL(
             return writer.getStatus();
         }
 
+        if (gLogAsyncQueueLines > 0) {
+            auto policy = logger::AsyncLogWriter::parseOverflowPolicy(gLogAsyncOverflowPolicy);
+            if (!policy.isOK()) {
+                return policy.getStatus();
+            }
+            asyncLogWriter = new logger::AsyncLogWriter(
+                writer.getValue(), gLogAsyncQueueLines, policy.getValue());
+        }
+
         LogManager* manager = logger::globalLogManager();
         manager->getGlobalDomain()->clearAppenders();
-        manager->getGlobalDomain()->attachAppender(
-            std::make_unique<RotatableFileAppender<MessageEventEphemeral>>(
-                std::make_unique<MessageEventDetailsEncoder>(), writer.getValue()));
-        manager->getNamedDomain("javascriptOutput")
-            ->attachAppender(std::make_unique<RotatableFileAppender<MessageEventEphemeral>>(
-                std::make_unique<MessageEventDetailsEncoder>(), writer.getValue()));
+        attachFileAppender(manager->getGlobalDomain(), writer.getValue());
+        attachFileAppender(manager->getNamedDomain("javascriptOutput"), writer.getValue());
 
         if (serverGlobalParams.logAppend && exists) {
             log() << "***** SERVER RESTARTED *****";
@@ -375,6 +431,19 @@ bool initializeServerGlobalState(ServiceContext* service) {
         }
     }
 
+    // Must happen before anything caches the service context's tick source, such as the transport
+    // layer's service executors.
+    if (gUseTscTickSource) {
+        if (auto tscTickSource = TscTickSource::create()) {
+            log() << "Using the time stamp counter as the tick source, at "
+                  << tscTickSource->getTicksPerSecond() << " ticks per second";
+            service->setTickSource(std::move(tscTickSource));
+        } else {
+            warning() << "useTscTickSource was set, but this processor does not have an "
+                         "invariant time stamp counter; using the system tick source";
+        }
+    }
+
     return true;
 }
 
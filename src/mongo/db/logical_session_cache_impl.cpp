@@ -272,6 +272,8 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
         _stats.setLastSessionsCollectionJobEntriesRefreshed(0);
         _stats.setLastSessionsCollectionJobEntriesEnded(0);
         _stats.setLastSessionsCollectionJobCursorsClosed(0);
+        _stats.setLastSessionsCollectionJobRefreshBatches(0);
+        _stats.setLastSessionsCollectionJobEntriesSkipped(0);
 
         // Start the new run.
         _stats.setLastSessionsCollectionJobTimestamp(now());
@@ -343,11 +345,32 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
 
     auto runningOpSessions = _service->getActiveOpSessions();
 
+    const size_t batchSize = logicalSessionRefreshBatchSize.load();
+    LogicalSessionIdMap<Date_t> previousRunningOpSessions;
+    LogicalSessionIdMap<Date_t> runningOpSessionsRefreshed;
+    if (batchSize > 0) {
+        stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
+        previousRunningOpSessions = _runningOpSessionsLastRefreshed;
+    }
+    size_t numSkipped = 0;
+
     for (const auto& it : runningOpSessions) {
         // if a running op is the cause of an upsert, we won't have a user name for the record
         if (explicitlyEndingSessions.count(it) > 0) {
             continue;
         }
+        if (batchSize > 0) {
+            // A session which was not used since the last refresh and which an earlier refresh
+            // wrote recently enough cannot expire before the next refresh, so skip the write.
+            auto previous = previousRunningOpSessions.find(it);
+            if (!activeSessions.count(it) && previous != previousRunningOpSessions.end() &&
+                now() - previous->second < _sessionTimeout / 2) {
+                runningOpSessionsRefreshed.emplace(it, previous->second);
+                ++numSkipped;
+                continue;
+            }
+            runningOpSessionsRefreshed.emplace(it, now());
+        }
         activeSessionRecords.insert(makeLogicalSessionRecord(it, now()));
     }
     for (const auto& it : activeSessions) {
@@ -355,11 +378,41 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
     }
 
     // Refresh the active sessions in the sessions collection.
-    uassertStatusOK(_sessionsColl->refreshSessions(opCtx, activeSessionRecords));
+    long long numBatches = 0;
+    if (batchSize == 0 || activeSessionRecords.size() <= batchSize) {
+        uassertStatusOK(_sessionsColl->refreshSessions(opCtx, activeSessionRecords));
+        numBatches = activeSessionRecords.empty() ? 0 : 1;
+    } else {
+        // Write bounded batches, paced evenly across the spread window so that a large number of
+        // active sessions does not turn into a single burst of writes.
+        const auto totalBatches =
+            static_cast<long long>((activeSessionRecords.size() + batchSize - 1) / batchSize);
+        const auto spread = std::min(Milliseconds(logicalSessionRefreshSpreadMillis.load()),
+                                     _refreshInterval / 2);
+        const auto start = now();
+
+        LogicalSessionRecordSet batch;
+        for (auto it = activeSessionRecords.begin(); it != activeSessionRecords.end();) {
+            batch.insert(*it);
+            if (++it != activeSessionRecords.end() && batch.size() < batchSize) {
+                continue;
+            }
+
+            if (numBatches > 0 && spread > Milliseconds(0)) {
+                opCtx->sleepUntil(start + spread * numBatches / totalBatches);
+            }
+            uassertStatusOK(_sessionsColl->refreshSessions(opCtx, batch));
+            batch.clear();
+            ++numBatches;
+        }
+    }
     activeSessionsBackSwapper.dismiss();
     {
         stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
         _stats.setLastSessionsCollectionJobEntriesRefreshed(activeSessionRecords.size());
+        _stats.setLastSessionsCollectionJobRefreshBatches(numBatches);
+        _stats.setLastSessionsCollectionJobEntriesSkipped(numSkipped);
+        _runningOpSessionsLastRefreshed = std::move(runningOpSessionsRefreshed);
     }
 
     // Remove the ending sessions from the sessions collection.
@@ -168,6 +168,10 @@ private:
 
     LogicalSessionIdSet _endingSessions;
 
+    // Sessions which a refresh wrote to the sessions collection only because an operation was
+    // running on them, with the time of that write. Only maintained when refreshes are batched.
+    LogicalSessionIdMap<Date_t> _runningOpSessionsLastRefreshed;
+
     Date_t lastRefreshTime;
 };
 
@@ -38,6 +38,7 @@
 #include "mongo/db/auth/authz_session_external_state_mock.h"
 #include "mongo/db/auth/user_name.h"
 #include "mongo/db/logical_session_cache.h"
+#include "mongo/db/logical_session_cache_impl_gen.h"
 #include "mongo/db/logical_session_id.h"
 #include "mongo/db/logical_session_id_helpers.h"
 #include "mongo/db/operation_context.h"
@@ -49,6 +50,7 @@
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/ensure_fcv.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -247,6 +249,51 @@ TEST_F(LogicalSessionCacheTest, ManySignedLsidsInCacheRefresh) {
     ASSERT(cache()->refreshNow(getClient()).isOK());
 }
 
+// Test that refreshes write bounded batches and skip sessions kept alive only by running operations
+// which a recent refresh already wrote
+TEST_F(LogicalSessionCacheTest, BatchedRefreshSkipsRecentlyRefreshedRunningOpSessions) {
+    logicalSessionRefreshBatchSize.store(100);
+    ON_BLOCK_EXIT([] { logicalSessionRefreshBatchSize.store(0); });
+
+    const size_t count = 250;
+    for (size_t i = 0; i < count; i++) {
+        ASSERT_OK(cache()->startSession(opCtx(), makeLogicalSessionRecordForTest()));
+    }
+    auto runningOpLsid = makeLogicalSessionIdForTest();
+    service()->add(runningOpLsid);
+
+    size_t batches = 0;
+    size_t refreshed = 0;
+    sessions()->setRefreshHook([&](const LogicalSessionRecordSet& sessions) {
+        ASSERT_LTE(sessions.size(), 100UL);
+        ++batches;
+        refreshed += sessions.size();
+        return Status::OK();
+    });
+
+    clearOpCtx();
+    service()->fastForward(kForceRefresh);
+    ASSERT_OK(cache()->refreshNow(getClient()));
+    ASSERT_EQ(3UL, batches);
+    ASSERT_EQ(count + 1, refreshed);
+    ASSERT_EQ(3, cache()->getStats().getLastSessionsCollectionJobRefreshBatches());
+    ASSERT_EQ(0, cache()->getStats().getLastSessionsCollectionJobEntriesSkipped());
+
+    // The operation is still running, but the session was written moments ago.
+    batches = 0;
+    refreshed = 0;
+    service()->fastForward(kForceRefresh);
+    ASSERT_OK(cache()->refreshNow(getClient()));
+    ASSERT_EQ(0UL, refreshed);
+    ASSERT_EQ(1, cache()->getStats().getLastSessionsCollectionJobEntriesSkipped());
+
+    // Once half a session timeout has passed since the write, it is written again.
+    service()->fastForward(kSessionTimeout / 2);
+    ASSERT_OK(cache()->refreshNow(getClient()));
+    ASSERT_EQ(1UL, refreshed);
+    ASSERT_EQ(0, cache()->getStats().getLastSessionsCollectionJobEntriesSkipped());
+}
+
 //
 TEST_F(LogicalSessionCacheTest, RefreshMatrixSessionState) {
     const std::vector<std::vector<std::string>> stateNames = {
@@ -0,0 +1,142 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include <algorithm>
+
+#include "mongo/db/matcher/expression_path.h"
+
+namespace mongo {
+
+namespace {
+
+/**
+ * Returns true if 'expr' tests the values of a top-level field, such that a non-array value can be
+ * passed to matchesSingleElement() directly.
+ */
+bool isTopLevelPathPredicate(const MatchExpression* expr) {
+    if (!dynamic_cast<const PathMatchExpression*>(expr)) {
+        return false;
+    }
+    const StringData path = expr->path();
+    return !path.empty() && path.find('.') == std::string::npos;
+}
+
+}  // namespace
+
+// static
+std::unique_ptr<CompiledMatchExpression> CompiledMatchExpression::compile(
+    const MatchExpression* expr) {
+    if (!expr || MatchExpression::AND != expr->matchType() || expr->numChildren() < 2) {
+        return nullptr;
+    }
+
+    std::unique_ptr<CompiledMatchExpression> program(new CompiledMatchExpression());
+    for (size_t i = 0; i < expr->numChildren(); ++i) {
+        const MatchExpression* child = expr->getChild(i);
+        int slot = -1;
+        if (isTopLevelPathPredicate(child)) {
+            auto it = program->_slots.find(child->path());
+            if (it == program->_slots.end()) {
+                slot = static_cast<int>(program->_values.size());
+                program->_slots[child->path()] = slot;
+                program->_values.emplace_back();
+            } else {
+                slot = it->second;
+            }
+        }
+        program->_predicates.push_back({child, slot, 0});
+    }
+
+    if (program->_slots.empty()) {
+        return nullptr;
+    }
+
+    program->reorderPredicates();
+    return program;
+}
+
+void CompiledMatchExpression::reorderPredicates() {
+    // Predicates matched against the whole document are the most expensive, so they stay last.
+    std::stable_sort(
+        _predicates.begin(), _predicates.end(), [](const Predicate& lhs, const Predicate& rhs) {
+            if ((lhs.slot < 0) != (rhs.slot < 0)) {
+                return rhs.slot < 0;
+            }
+            return lhs.numRejected > rhs.numRejected;
+        });
+
+    // Let older documents count for less, so that the order follows changes in the data.
+    for (auto&& predicate : _predicates) {
+        predicate.numRejected /= 2;
+    }
+}
+
+bool CompiledMatchExpression::matchesBSON(const BSONObj& doc) {
+    if (++_numMatched % kReorderInterval == 0) {
+        reorderPredicates();
+    }
+
+    // Like the ElementPath lookup, take the first occurrence of a duplicated field name.
+    std::fill(_values.begin(), _values.end(), BSONElement());
+    size_t numFound = 0;
+    for (auto&& elem : doc) {
+        auto it = _slots.find(elem.fieldNameStringData());
+        if (it == _slots.end() || !_values[it->second].eoo()) {
+            continue;
+        }
+        _values[it->second] = elem;
+        if (++numFound == _values.size()) {
+            break;
+        }
+    }
+
+    for (auto&& predicate : _predicates) {
+        bool matched;
+        if (predicate.slot < 0) {
+            matched = predicate.expr->matchesBSON(doc);
+        } else {
+            // Arrays are traversed according to the predicate's own array semantics.
+            const BSONElement& value = _values[predicate.slot];
+            matched = Array == value.type() ? predicate.expr->matchesBSON(doc)
+                                            : predicate.expr->matchesSingleElement(value);
+        }
+
+        if (!matched) {
+            ++predicate.numRejected;
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace mongo
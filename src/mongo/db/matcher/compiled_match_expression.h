@@ -0,0 +1,97 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+/**
+ * The execution form of a filter that is a conjunction of predicates. Matching a document takes
+ * one pass over its top-level fields to find the values of every predicate over a top-level path,
+ * after which those predicates test the values directly instead of each walking the document
+ * through an ElementPath. The other children of the conjunction are evaluated as usual.
+ *
+ * The predicates are reordered as documents are matched, so that the ones which reject the most
+ * documents run first. A CompiledMatchExpression is therefore not safe to share between threads.
+ * The MatchExpression it was compiled from must outlive it.
+ */
+class CompiledMatchExpression {
+    CompiledMatchExpression(const CompiledMatchExpression&) = delete;
+    CompiledMatchExpression& operator=(const CompiledMatchExpression&) = delete;
+
+public:
+    /**
+     * Returns nullptr if 'expr' has no top-level path predicates for the program to look up, in
+     * which case matching with 'expr' itself is just as fast.
+     */
+    static std::unique_ptr<CompiledMatchExpression> compile(const MatchExpression* expr);
+
+    /**
+     * Returns the same result as 'expr->matchesBSON(doc)'.
+     */
+    bool matchesBSON(const BSONObj& doc);
+
+private:
+    // The number of documents matched between the times the predicates are reordered.
+    static const size_t kReorderInterval = 1024;
+
+    struct Predicate {
+        const MatchExpression* expr;
+
+        // The index in '_values' of the top-level field 'expr' tests, or -1 if 'expr' must be
+        // matched against the whole document.
+        int slot;
+
+        // The number of documents this predicate rejected since the last reordering.
+        size_t numRejected;
+    };
+
+    CompiledMatchExpression() = default;
+
+    void reorderPredicates();
+
+    std::vector<Predicate> _predicates;
+
+    // Maps each top-level field name tested to its index in '_values'.
+    StringMap<int> _slots;
+
+    // The values of the tested fields in the document being matched. A missing field is EOO.
+    std::vector<BSONElement> _values;
+
+    size_t _numMatched = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,141 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::unique_ptr<MatchExpression> parse(const BSONObj& filter) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto statusWithMatcher = MatchExpressionParser::parse(filter, std::move(expCtx));
+    ASSERT_OK(statusWithMatcher.getStatus());
+    return std::move(statusWithMatcher.getValue());
+}
+
+/**
+ * Asserts that 'filter' compiles and that the compiled form agrees with the MatchExpression on
+ * every one of 'docs'.
+ */
+void assertMatchesLikeExpression(const BSONObj& filter, const std::vector<BSONObj>& docs) {
+    auto expr = parse(filter);
+    auto compiled = CompiledMatchExpression::compile(expr.get());
+    ASSERT(compiled);
+    for (auto&& doc : docs) {
+        ASSERT_EQ(compiled->matchesBSON(doc), expr->matchesBSON(doc))
+            << "filter: " << filter << " document: " << doc;
+    }
+}
+
+TEST(CompiledMatchExpressionTest, OnlyConjunctionsWithTopLevelPathsCompile) {
+    ASSERT_FALSE(CompiledMatchExpression::compile(nullptr));
+    auto single = parse(fromjson("{a: 1}"));
+    ASSERT_FALSE(CompiledMatchExpression::compile(single.get()));
+    auto dotted = parse(fromjson("{'a.b': 1, 'c.d': 2}"));
+    ASSERT_FALSE(CompiledMatchExpression::compile(dotted.get()));
+    auto disjunction = parse(fromjson("{$or: [{a: 1}, {b: 2}]}"));
+    ASSERT_FALSE(CompiledMatchExpression::compile(disjunction.get()));
+
+    auto mixed = parse(fromjson("{a: 1, 'b.c': 2}"));
+    ASSERT(CompiledMatchExpression::compile(mixed.get()));
+}
+
+TEST(CompiledMatchExpressionTest, ComparisonsAgreeWithExpression) {
+    assertMatchesLikeExpression(fromjson("{a: {$gt: 1, $lte: 5}, b: 'x', c: {$ne: null}}"),
+                                {fromjson("{a: 2, b: 'x', c: 1}"),
+                                 fromjson("{a: 6, b: 'x', c: 1}"),
+                                 fromjson("{a: 2, b: 'y', c: 1}"),
+                                 fromjson("{a: 2, b: 'x'}"),
+                                 fromjson("{a: 2, b: 'x', c: null}"),
+                                 fromjson("{b: 'x', c: 1}"),
+                                 fromjson("{c: 1, b: 'x', a: 3}"),
+                                 BSONObj()});
+}
+
+TEST(CompiledMatchExpressionTest, MissingFieldsMatchNull) {
+    assertMatchesLikeExpression(fromjson("{a: null, b: {$exists: false}}"),
+                                {fromjson("{}"),
+                                 fromjson("{a: null}"),
+                                 fromjson("{a: 1}"),
+                                 fromjson("{b: 1}"),
+                                 fromjson("{a: [null]}")});
+}
+
+TEST(CompiledMatchExpressionTest, ArraysAreTraversedLikeExpression) {
+    assertMatchesLikeExpression(fromjson("{a: 2, b: {$size: 2}, c: {$elemMatch: {$gt: 3}}}"),
+                                {fromjson("{a: [1, 2], b: [1, 1], c: [4]}"),
+                                 fromjson("{a: [1, 3], b: [1, 1], c: [4]}"),
+                                 fromjson("{a: 2, b: [1], c: [4]}"),
+                                 fromjson("{a: 2, b: [1, 1], c: 4}"),
+                                 fromjson("{a: [[2]], b: [1, 1], c: [1, 5]}")});
+    assertMatchesLikeExpression(fromjson("{a: [1, 2], b: 1}"),
+                                {fromjson("{a: [1, 2], b: 1}"),
+                                 fromjson("{a: [[1, 2]], b: 1}"),
+                                 fromjson("{a: [2, 1], b: 1}")});
+}
+
+TEST(CompiledMatchExpressionTest, DuplicateFieldNamesUseFirstOccurrence) {
+    BSONObjBuilder bob;
+    bob.append("a", 1);
+    bob.append("a", 2);
+    bob.append("b", 1);
+    assertMatchesLikeExpression(fromjson("{a: 1, b: 1}"), {bob.obj()});
+}
+
+TEST(CompiledMatchExpressionTest, ResidualPredicatesAgreeWithExpression) {
+    assertMatchesLikeExpression(
+        fromjson("{a: 1, 'b.c': {$gt: 0}, $or: [{d: 1}, {e: 1}], a: {$type: 'number'}}"),
+        {fromjson("{a: 1, b: {c: 1}, d: 1}"),
+         fromjson("{a: 1, b: [{c: 0}, {c: 2}], e: 1}"),
+         fromjson("{a: 1, b: {c: 0}, d: 1}"),
+         fromjson("{a: 1, b: {c: 1}}"),
+         fromjson("{a: '1', b: {c: 1}, d: 1}")});
+}
+
+TEST(CompiledMatchExpressionTest, ResultsAreUnchangedByReordering) {
+    auto expr = parse(fromjson("{a: {$gte: 0}, b: {$lt: 10}, c: {$ne: 3}}"));
+    auto compiled = CompiledMatchExpression::compile(expr.get());
+    ASSERT(compiled);
+
+    // 'b' rejects most documents, so it moves to the front after a while.
+    for (int i = 0; i < 5000; ++i) {
+        BSONObj doc = BSON("a" << i % 7 << "b" << i % 100 << "c" << i % 5);
+        ASSERT_EQ(compiled->matchesBSON(doc), expr->matchesBSON(doc)) << doc;
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -107,6 +107,10 @@ public:
         return *_query;
     }
 
+    const BSONObj& getRawObj() const {
+        return _rawObj;
+    }
+
 private:
     ExpressionOptimizerFunc getOptimizer() const final {
         return [](std::unique_ptr<MatchExpression> expression) { return expression; };
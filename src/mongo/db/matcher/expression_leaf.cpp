@@ -43,6 +43,7 @@
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/matcher/path.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/regex_util.h"
 #include "mongo/util/str.h"
@@ -377,6 +378,7 @@ std::unique_ptr<MatchExpression> InMatchExpression::shallowClone() const {
     next->_hasEmptyArray = _hasEmptyArray;
     next->_equalitySet = _equalitySet;
     next->_originalEqualityVector = _originalEqualityVector;
+    next->_updateHashedEqualitySet();
     for (auto&& regex : _regexes) {
         std::unique_ptr<RegexMatchExpression> clonedRegex(
             static_cast<RegexMatchExpression*>(regex->shallowClone().release()));
@@ -389,7 +391,11 @@ bool InMatchExpression::matchesSingleElement(const BSONElement& e, MatchDetails*
     if (_hasNull && e.eoo()) {
         return true;
     }
-    if (_equalitySet.find(e) != _equalitySet.end()) {
+    if (_hashedEqualitySet) {
+        if (_hashedEqualitySet->count(e)) {
+            return true;
+        }
+    } else if (_equalitySet.find(e) != _equalitySet.end()) {
         return true;
     }
     for (auto&& regex : _regexes) {
@@ -493,6 +499,7 @@ void InMatchExpression::_doSetCollator(const CollatorInterface* collator) {
         _originalEqualityVector.begin(),
         std::unique(
             _originalEqualityVector.begin(), _originalEqualityVector.end(), _eltCmp.makeEqualTo()));
+    _updateHashedEqualitySet();
 }
 
 Status InMatchExpression::setEqualities(std::vector<BSONElement> equalities) {
@@ -525,10 +532,25 @@ Status InMatchExpression::setEqualities(std::vector<BSONElement> equalities) {
         _originalEqualityVector.begin(),
         std::unique(
             _originalEqualityVector.begin(), _originalEqualityVector.end(), _eltCmp.makeEqualTo()));
+    _updateHashedEqualitySet();
 
     return Status::OK();
 }
 
+void InMatchExpression::_updateHashedEqualitySet() {
+    const auto threshold = internalQueryInHashedMembershipThreshold.load();
+    if (threshold == 0 || _equalitySet.size() < static_cast<size_t>(threshold)) {
+        _hashedEqualitySet = boost::none;
+        return;
+    }
+
+    // The set's hasher and equality predicate refer to '_eltCmp', so it must be rebuilt whenever
+    // the comparator changes.
+    _hashedEqualitySet = _eltCmp.makeBSONEltUnorderedSet();
+    _hashedEqualitySet->reserve(_equalitySet.size());
+    _hashedEqualitySet->insert(_equalitySet.begin(), _equalitySet.end());
+}
+
 Status InMatchExpression::addRegex(std::unique_ptr<RegexMatchExpression> expr) {
     _regexes.push_back(std::move(expr));
     return Status::OK();
@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "mongo/bson/bsonelement_comparator.h"
 #include "mongo/bson/bsonmisc.h"
 #include "mongo/bson/bsonobj.h"
@@ -449,6 +451,12 @@ public:
 private:
     ExpressionOptimizerFunc getOptimizer() const final;
 
+    /**
+     * Rebuilds '_hashedEqualitySet' from '_equalitySet', or clears it if there are fewer
+     * equalities than 'internalQueryInHashedMembershipThreshold'.
+     */
+    void _updateHashedEqualitySet();
+
     // Whether or not '_equalities' has a jstNULL element in it.
     bool _hasNull = false;
 
@@ -475,6 +483,10 @@ private:
     // for this set.
     BSONEltFlatSet _equalitySet;
 
+    // For large $in lists, a copy of '_equalitySet' hashed with respect to '_eltCmp', so that
+    // matching a document is a constant time lookup rather than a binary search.
+    boost::optional<BSONEltUnorderedSet> _hashedEqualitySet;
+
     // Container of regex elements this object owns.
     std::vector<std::unique_ptr<RegexMatchExpression>> _regexes;
 };
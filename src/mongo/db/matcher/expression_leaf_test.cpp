@@ -37,7 +37,9 @@
 #include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/unittest/death_test.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -1370,6 +1372,55 @@ TEST(InMatchExpression, ChangingCollationAfterAddingEqualitiesPreservesEqualitie
     ASSERT(in.getEqualities().count(obj2.firstElement()));
 }
 
+TEST(InMatchExpression, HashedMembershipMatchesLikeTheSortedEqualities) {
+    internalQueryInHashedMembershipThreshold.store(2);
+    ON_BLOCK_EXIT([] { internalQueryInHashedMembershipThreshold.store(0); });
+
+    BSONArray operand = BSON_ARRAY(1 << 2.0 << "r" << BSON("b" << 1) << 1LL);
+    InMatchExpression in("a");
+    std::vector<BSONElement> equalities;
+    for (auto&& elt : operand) {
+        equalities.push_back(elt);
+    }
+    ASSERT_OK(in.setEqualities(std::move(equalities)));
+    ASSERT_EQ(4U, in.getEqualities().size());
+
+    ASSERT(in.matchesBSON(BSON("a" << 1.0), nullptr));
+    ASSERT(in.matchesBSON(BSON("a" << 2), nullptr));
+    ASSERT(in.matchesBSON(BSON("a"
+                               << "r"),
+                          nullptr));
+    ASSERT(in.matchesBSON(BSON("a" << BSON("b" << 1LL)), nullptr));
+    ASSERT(in.matchesBSON(BSON("a" << BSON_ARRAY(5 << 2)), nullptr));
+    ASSERT(!in.matchesBSON(BSON("a" << 3), nullptr));
+    ASSERT(!in.matchesBSON(BSON("a"
+                                << "s"),
+                           nullptr));
+    ASSERT(!in.matchesBSON(BSONObj(), nullptr));
+
+    auto clone = in.shallowClone();
+    ASSERT(clone->matchesBSON(BSON("a" << 2), nullptr));
+    ASSERT(!clone->matchesBSON(BSON("a" << 3), nullptr));
+}
+
+TEST(InMatchExpression, HashedMembershipRespectsCollation) {
+    internalQueryInHashedMembershipThreshold.store(1);
+    ON_BLOCK_EXIT([] { internalQueryInHashedMembershipThreshold.store(0); });
+
+    BSONArray operand = BSON_ARRAY("string1"
+                                   << "string2");
+    CollatorInterfaceMock collatorAlwaysEqual(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    InMatchExpression in("");
+    std::vector<BSONElement> equalities{operand[0], operand[1]};
+    ASSERT_OK(in.setEqualities(std::move(equalities)));
+
+    BSONObj other = BSON(""
+                         << "other");
+    ASSERT(!in.matchesSingleElement(other.firstElement()));
+    in.setCollator(&collatorAlwaysEqual);
+    ASSERT(in.matchesSingleElement(other.firstElement()));
+}
+
 std::vector<uint32_t> bsonArrayToBitPositions(const BSONArray& ba) {
     std::vector<uint32_t> bitPositions;
 
@@ -0,0 +1,138 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+
+namespace mongo {
+namespace {
+
+// A user profile with nested objects, arrays of scalars and arrays of subdocuments.
+BSONObj makeDocument(int i) {
+    BSONObjBuilder builder;
+    builder.append("_id", i);
+    builder.append("name", "user");
+    builder.append("age", 20 + i % 50);
+    builder.append("active", i % 3 != 0);
+    {
+        BSONObjBuilder address(builder.subobjStart("address"));
+        address.append("city", "Springfield");
+        address.append("zip", 10000 + i % 1000);
+        address.append("geo", BSON("lat" << 40.7 << "lng" << -74.0));
+    }
+    {
+        BSONArrayBuilder tags(builder.subarrayStart("tags"));
+        tags.append("red").append("green").append("blue").append("tag" + std::to_string(i % 10));
+    }
+    {
+        BSONArrayBuilder orders(builder.subarrayStart("orders"));
+        orders.append(BSON("sku"
+                           << "A1"
+                           << "qty"
+                           << 1
+                           << "price"
+                           << 9.99));
+        orders.append(BSON("sku"
+                           << "B2"
+                           << "qty"
+                           << i % 7
+                           << "price"
+                           << 19.99));
+        orders.append(BSON("sku"
+                           << "C3"
+                           << "qty"
+                           << 3
+                           << "price"
+                           << 4.5));
+    }
+    builder.append("email", "user" + std::to_string(i) + "@example.com");
+    return builder.obj();
+}
+
+void runMatchBenchmark(benchmark::State& state, const char* filter) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto expr = uassertStatusOK(MatchExpressionParser::parse(fromjson(filter), expCtx));
+
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < 100; ++i) {
+        docs.push_back(makeDocument(i));
+    }
+
+    for (auto _ : state) {
+        for (auto&& doc : docs) {
+            benchmark::DoNotOptimize(expr->matchesBSON(doc));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * docs.size());
+}
+
+void BM_MatchEquality(benchmark::State& state) {
+    runMatchBenchmark(state, "{age: 30}");
+}
+
+void BM_MatchRangeConjunction(benchmark::State& state) {
+    runMatchBenchmark(state, "{age: {$gte: 25, $lt: 40}, active: true}");
+}
+
+void BM_MatchIn(benchmark::State& state) {
+    runMatchBenchmark(state, "{'address.zip': {$in: [10001, 10010, 10020, 10030, 10040]}}");
+}
+
+void BM_MatchDottedPathThroughArray(benchmark::State& state) {
+    runMatchBenchmark(state, "{'orders.qty': {$gt: 5}}");
+}
+
+void BM_MatchElemMatch(benchmark::State& state) {
+    runMatchBenchmark(state, "{orders: {$elemMatch: {sku: 'B2', qty: {$gte: 3}}}}");
+}
+
+void BM_MatchOr(benchmark::State& state) {
+    runMatchBenchmark(state, "{$or: [{age: 21}, {tags: 'tag7'}, {'address.city': 'Shelbyville'}]}");
+}
+
+void BM_MatchRegex(benchmark::State& state) {
+    runMatchBenchmark(state, "{email: {$regex: '^user1.*@example\\\\.com$'}}");
+}
+
+BENCHMARK(BM_MatchEquality);
+BENCHMARK(BM_MatchRangeConjunction);
+BENCHMARK(BM_MatchIn);
+BENCHMARK(BM_MatchDottedPathThroughArray);
+BENCHMARK(BM_MatchElemMatch);
+BENCHMARK(BM_MatchOr);
+BENCHMARK(BM_MatchRegex);
+
+}  // namespace
+}  // namespace mongo
@@ -239,7 +239,7 @@ OpTimeBundle replLogUpdate(OperationContext* opCtx, const OplogUpdateEntryArgs&
                                        oplogLink,
                                        false /* prepare */,
                                        false /* inTxn */,
-                                       OplogSlot());
+                                       args.updateArgs.oplogSlot);
 
     return opTimes;
 }
@@ -1012,12 +1012,15 @@ void OpObserverImpl::onEmptyCapped(OperationContext* opCtx,
 namespace {
 
 OpTimeBundle logApplyOpsForTransaction(OperationContext* opCtx,
-                                       std::vector<repl::ReplOperation> stmts,
+                                       const std::vector<repl::ReplOperation>& stmts,
                                        const OplogSlot& prepareOplogSlot) {
     BSONObjBuilder applyOpsBuilder;
     BSONArrayBuilder opsArray(applyOpsBuilder.subarrayStart("applyOps"_sd));
-    for (auto& stmt : stmts) {
-        opsArray.append(stmt.toBSON());
+    // Serialize each statement straight into the applyOps array rather than materializing a
+    // temporary BSONObj per statement and copying it in.
+    for (const auto& stmt : stmts) {
+        BSONObjBuilder stmtBuilder(opsArray.subobjStart());
+        stmt.serialize(&stmtBuilder);
     }
     opsArray.done();
 
@@ -238,6 +238,19 @@ public:
 
     void markKillOnClientDisconnect();
 
+    /**
+     * Returns true if the request being served was sent with the 'exhaustAllowed' OP_MSG flag, in
+     * which case the reply may be followed by more replies streamed to the client without it
+     * sending further requests.
+     */
+    bool isExhaust() const {
+        return _exhaust;
+    }
+
+    void setExhaust(bool exhaust) {
+        _exhaust = exhaust;
+    }
+
     /**
      * Identifies the opCtx as an operation which is executing global shutdown.  This has the effect
      * of masking any existing time limits, removing markKill-ability and is slightly stronger than
@@ -459,6 +472,7 @@ private:
     bool _markKillOnClientDisconnect = false;
     Date_t _lastClientCheck;
     bool _isExecutingShutdown = false;
+    bool _exhaust = false;
 
     // Max operation time requested by the user or by the cursor in the case of a getMore with no
     // user-specified maxTime. This is tracked with microsecond granularity for the purpose of
@@ -0,0 +1,97 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <boost/optional.hpp>
+
+#include "mongo/db/operation_context.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+/**
+ * OperationMemoryTracker sums the memory that query execution stages report holding on behalf of
+ * an operation, and remembers the largest total seen. It is declared as a decoration on
+ * OperationContext, and the peak is reported in the slow query log and the profiler.
+ *
+ * Only the thread running the operation updates the tracker. The values are atomic so that they
+ * can be read concurrently, e.g. by $currentOp.
+ */
+class OperationMemoryTracker {
+public:
+    static OperationMemoryTracker* get(OperationContext* opCtx);
+
+    /**
+     * Adjusts the number of bytes currently held by 'delta', which may be negative.
+     */
+    void add(long long delta);
+
+    long long currentBytes() const {
+        return _currentBytes.load();
+    }
+
+    long long peakBytes() const {
+        return _peakBytes.load();
+    }
+
+private:
+    AtomicWord<long long> _currentBytes{0};
+    AtomicWord<long long> _peakBytes{0};
+};
+
+/**
+ * The share of an OperationMemoryTracker owned by a single memory consumer, such as a plan stage.
+ * The consumer calls set() whenever its memory usage changes.
+ *
+ * A consumer may outlive the operation it was charged to, for example when a cursor is continued
+ * by a getMore. The OperationContext is therefore supplied on every call rather than retained,
+ * and when it belongs to a different operation than the previous call, the whole amount is
+ * charged to the new operation.
+ */
+class TrackedMemoryUsage {
+public:
+    /**
+     * Records that the consumer now holds 'bytes' on behalf of the operation running on 'opCtx'.
+     */
+    void set(OperationContext* opCtx, long long bytes);
+
+    long long bytes() const {
+        return _bytes;
+    }
+
+private:
+    long long _bytes = 0;
+
+    // The operation that '_bytes' is currently charged to.
+    boost::optional<unsigned int> _opId;
+};
+
+}  // namespace mongo
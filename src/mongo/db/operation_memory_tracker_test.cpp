@@ -0,0 +1,84 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/operation_memory_tracker.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(OperationMemoryTracker, PeakIsHighestTotalSeen) {
+    OperationMemoryTracker tracker;
+    tracker.add(100);
+    tracker.add(50);
+    tracker.add(-120);
+    tracker.add(10);
+
+    ASSERT_EQ(tracker.currentBytes(), 40);
+    ASSERT_EQ(tracker.peakBytes(), 150);
+}
+
+TEST(OperationMemoryTracker, TrackedMemoryUsageAppliesDeltasWithinAnOperation) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    auto tracker = OperationMemoryTracker::get(opCtx.get());
+
+    TrackedMemoryUsage first;
+    TrackedMemoryUsage second;
+    first.set(opCtx.get(), 1000);
+    second.set(opCtx.get(), 500);
+    first.set(opCtx.get(), 200);
+
+    ASSERT_EQ(tracker->currentBytes(), 700);
+    ASSERT_EQ(tracker->peakBytes(), 1500);
+}
+
+TEST(OperationMemoryTracker, TrackedMemoryUsageChargesNewOperationForEverythingHeld) {
+    QueryTestServiceContext serviceContext;
+    TrackedMemoryUsage usage;
+
+    {
+        auto opCtx = serviceContext.makeOperationContext();
+        usage.set(opCtx.get(), 1000);
+        ASSERT_EQ(OperationMemoryTracker::get(opCtx.get())->peakBytes(), 1000);
+    }
+
+    // For example a getMore continuing a cursor whose plan still holds its buffered data.
+    auto opCtx = serviceContext.makeOperationContext();
+    usage.set(opCtx.get(), 800);
+    ASSERT_EQ(OperationMemoryTracker::get(opCtx.get())->currentBytes(), 800);
+    ASSERT_EQ(OperationMemoryTracker::get(opCtx.get())->peakBytes(), 800);
+}
+
+}  // namespace
+}  // namespace mongo
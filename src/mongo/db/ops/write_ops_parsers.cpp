@@ -108,6 +108,19 @@ int32_t getStmtIdForWriteAt(const WriteCommandBase& writeCommandBase, size_t wri
 write_ops::Insert InsertOp::parse(const OpMsgRequest& request) {
     auto insertOp = Insert::parse(IDLParserErrorContext("insert"), request);
 
+    // Documents passed in the command body are unowned views into it. Tie their lifetime to the
+    // body's buffer so that later getOwned() calls on the insert path don't copy them. Documents
+    // from a document sequence already share ownership with the message.
+    if (request.body.isOwned()) {
+        auto documents = insertOp.getDocuments();
+        for (auto&& doc : documents) {
+            if (!doc.isOwned()) {
+                doc.shareOwnershipWith(request.body);
+            }
+        }
+        insertOp.setDocuments(std::move(documents));
+    }
+
     validateInsertOp(insertOp);
     return insertOp;
 }
@@ -129,7 +142,7 @@ write_ops::Insert InsertOp::parseLegacy(const Message& msgRaw) {
     op.setDocuments([&] {
         std::vector<BSONObj> documents;
         while (msg.moreJSObjs()) {
-            documents.push_back(msg.nextJsObj());
+            documents.push_back(msg.nextJsObj().shareOwnershipWith(msgRaw.sharedBuffer()));
         }
 
         return documents;
@@ -273,6 +273,20 @@ TEST(CommandWriteOpsParsers, RealMultiInsert) {
     }
 }
 
+TEST(CommandWriteOpsParsers, InsertDocumentsShareOwnershipWithBody) {
+    const auto ns = NamespaceString("test", "foo");
+    auto cmd = BSON("insert" << ns.coll() << "documents"
+                             << BSON_ARRAY(BSON("x" << 0) << BSON("x" << 1)));
+    auto request = toOpMsg(ns.db(), cmd, false);
+    const auto op = InsertOp::parse(request);
+    ASSERT_EQ(op.getDocuments().size(), 2u);
+    for (auto&& doc : op.getDocuments()) {
+        ASSERT(doc.isOwned());
+        ASSERT_GT(doc.objdata(), request.body.objdata());
+        ASSERT_LT(doc.objdata(), request.body.objdata() + request.body.objsize());
+    }
+}
+
 TEST(CommandWriteOpsParsers, MultiInsertWithStmtId) {
     const auto ns = NamespaceString("test", "foo");
     const BSONObj obj0 = BSON("x" << 0);
@@ -450,6 +464,19 @@ TEST(LegacyWriteOpsParsers, SingleInsert) {
     }
 }
 
+TEST(LegacyWriteOpsParsers, InsertDocumentsShareOwnershipWithMessage) {
+    const std::string ns = "test.foo";
+    auto objs = std::vector<BSONObj>{BSON("x" << 0), BSON("x" << 1)};
+    auto message = makeInsertMessage(ns, objs.data(), objs.size(), 0);
+    const auto op = InsertOp::parseLegacy(message);
+    ASSERT_EQ(op.getDocuments().size(), 2u);
+    for (auto&& doc : op.getDocuments()) {
+        ASSERT(doc.isOwned());
+        ASSERT_GT(doc.objdata(), message.buf());
+        ASSERT_LT(doc.objdata(), message.buf() + message.size());
+    }
+}
+
 TEST(LegacyWriteOpsParsers, EmptyMultiInsertFails) {
     const std::string ns = "test.foo";
     for (bool continueOnError : {false, true}) {
@@ -77,6 +77,15 @@ public:
         processInternal(input, merging);
     }
 
+    /**
+     * Processes each of 'inputs' in order, with the same result as calling process() on each of
+     * them. Numeric accumulators use this to run a single loop without per-value type dispatch
+     * when all inputs have the same numeric type.
+     */
+    void processBatch(const std::vector<Value>& inputs, bool merging) {
+        processBatchInternal(inputs, merging);
+    }
+
     /** Marks the end of the evaluate() phase and return accumulated result.
      *  toBeMerged should be true when the outputs will be merged by process().
      */
@@ -110,6 +119,40 @@ protected:
     /// Update subclass's internal state based on input
     virtual void processInternal(const Value& input, bool merging) = 0;
 
+    /// Update subclass's internal state based on a batch of inputs
+    virtual void processBatchInternal(const std::vector<Value>& inputs, bool merging) {
+        for (auto&& input : inputs) {
+            processInternal(input, merging);
+        }
+    }
+
+    /**
+     * Returns NumberDouble if all of 'inputs' are doubles, NumberInt if they are all 32-bit
+     * integers and NumberLong if they are 64-bit integers, possibly mixed with 32-bit ones.
+     * Returns EOO if 'inputs' is empty or holds any other combination of types.
+     */
+    static BSONType getBatchNumericType(const std::vector<Value>& inputs) {
+        if (inputs.empty())
+            return EOO;
+
+        BSONType batchType = inputs.front().getType();
+        if (batchType != NumberDouble && batchType != NumberInt && batchType != NumberLong)
+            return EOO;
+
+        for (auto&& input : inputs) {
+            const BSONType type = input.getType();
+            if (type == batchType)
+                continue;
+            if ((batchType == NumberInt && type == NumberLong) ||
+                (batchType == NumberLong && type == NumberInt)) {
+                batchType = NumberLong;
+            } else {
+                return EOO;
+            }
+        }
+        return batchType;
+    }
+
     const boost::intrusive_ptr<ExpressionContext>& getExpressionContext() const {
         return _expCtx;
     }
@@ -195,6 +238,7 @@ public:
     explicit AccumulatorSum(const boost::intrusive_ptr<ExpressionContext>& expCtx);
 
     void processInternal(const Value& input, bool merging) final;
+    void processBatchInternal(const std::vector<Value>& inputs, bool merging) final;
     Value getValue(bool toBeMerged) final;
     const char* getOpName() const final;
     void reset() final;
@@ -213,7 +257,7 @@ public:
 private:
     BSONType totalType = NumberInt;
     DoubleDoubleSummation nonDecimalTotal;
-    Decimal128 decimalTotal;
+    DecimalSummation decimalTotal;
 };
 
 
@@ -227,6 +271,7 @@ public:
     AccumulatorMinMax(const boost::intrusive_ptr<ExpressionContext>& expCtx, Sense sense);
 
     void processInternal(const Value& input, bool merging) final;
+    void processBatchInternal(const std::vector<Value>& inputs, bool merging) final;
     Value getValue(bool toBeMerged) final;
     const char* getOpName() const final;
     void reset() final;
@@ -283,6 +328,7 @@ public:
     explicit AccumulatorAvg(const boost::intrusive_ptr<ExpressionContext>& expCtx);
 
     void processInternal(const Value& input, bool merging) final;
+    void processBatchInternal(const std::vector<Value>& inputs, bool merging) final;
     Value getValue(bool toBeMerged) final;
     const char* getOpName() const final;
     void reset() final;
@@ -299,7 +345,7 @@ private:
 
     bool _isDecimal;
     DoubleDoubleSummation _nonDecimalTotal;
-    Decimal128 _decimalTotal;
+    DecimalSummation _decimalTotal;
     long long _count;
 };
 
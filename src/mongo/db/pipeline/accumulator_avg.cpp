@@ -75,7 +75,7 @@ void AccumulatorAvg::processInternal(const Value& input, bool merging) {
 
     switch (input.getType()) {
         case NumberDecimal:
-            _decimalTotal = _decimalTotal.add(input.getDecimal());
+            _decimalTotal.add(input.getDecimal());
             _isDecimal = true;
             break;
         case NumberLong:
@@ -93,13 +93,35 @@ void AccumulatorAvg::processInternal(const Value& input, bool merging) {
     _count++;
 }
 
+void AccumulatorAvg::processBatchInternal(const std::vector<Value>& inputs, bool merging) {
+    // Batches of only doubles or only 32-bit integers are summed in one loop, with the same
+    // additions processInternal() would make. Merged inputs are partial results, not numbers.
+    const BSONType batchType = merging ? EOO : getBatchNumericType(inputs);
+    switch (batchType) {
+        case NumberDouble:
+            for (auto&& input : inputs) {
+                _nonDecimalTotal.addDouble(input.getDouble());
+            }
+            break;
+        case NumberInt:
+            for (auto&& input : inputs) {
+                _nonDecimalTotal.addDouble(input.getInt());
+            }
+            break;
+        default:
+            Accumulator::processBatchInternal(inputs, merging);
+            return;
+    }
+    _count += inputs.size();
+}
+
 intrusive_ptr<Accumulator> AccumulatorAvg::create(
     const boost::intrusive_ptr<ExpressionContext>& expCtx) {
     return new AccumulatorAvg(expCtx);
 }
 
 Decimal128 AccumulatorAvg::_getDecimalTotal() const {
-    return _decimalTotal.add(_nonDecimalTotal.getDecimal());
+    return _decimalTotal.getDecimal().add(_nonDecimalTotal.getDecimal());
 }
 
 Value AccumulatorAvg::getValue(bool toBeMerged) {
@@ -29,6 +29,9 @@
 
 #include "mongo/platform/basic.h"
 
+#include <cmath>
+#include <utility>
+
 #include "mongo/db/pipeline/accumulator.h"
 
 #include "mongo/db/pipeline/accumulation_statement.h"
@@ -62,6 +65,60 @@ void AccumulatorMinMax::processInternal(const Value& input, bool merging) {
     }
 }
 
+namespace {
+/**
+ * Returns the index of the first input that no later input is better than, where 'get' extracts
+ * the number to compare from an input and 'better(a, b)' returns whether 'a' should replace 'b'.
+ */
+template <typename Get, typename Better>
+size_t findFirstExtreme(const std::vector<Value>& inputs, Get get, Better better) {
+    size_t best = 0;
+    auto bestValue = get(inputs[0]);
+    for (size_t i = 1; i < inputs.size(); ++i) {
+        auto value = get(inputs[i]);
+        if (better(value, bestValue)) {
+            best = i;
+            bestValue = value;
+        }
+    }
+    return best;
+}
+}  // namespace
+
+void AccumulatorMinMax::processBatchInternal(const std::vector<Value>& inputs, bool merging) {
+    // For a batch of only doubles or only integers, find the extreme input with plain numeric
+    // comparisons and then compare just that input against the current value. Ties keep the
+    // earlier input, as processInternal() does. Numeric comparisons ignore the collation.
+    const int sense = _sense;
+    switch (getBatchNumericType(inputs)) {
+        case NumberDouble:
+            processInternal(inputs[findFirstExtreme(
+                                inputs,
+                                [](const Value& input) { return input.getDouble(); },
+                                [sense](double a, double b) {
+                                    // NaN sorts before all other numbers.
+                                    if (sense == MAX)
+                                        std::swap(a, b);
+                                    return std::isnan(a) ? !std::isnan(b)
+                                                         : !std::isnan(b) && a < b;
+                                })],
+                            merging);
+            break;
+        case NumberInt:
+        case NumberLong:
+            processInternal(inputs[findFirstExtreme(
+                                inputs,
+                                [](const Value& input) { return input.getLong(); },
+                                [sense](long long a, long long b) {
+                                    return sense == MAX ? b < a : a < b;
+                                })],
+                            merging);
+            break;
+        default:
+            Accumulator::processBatchInternal(inputs, merging);
+    }
+}
+
 Value AccumulatorMinMax::getValue(bool toBeMerged) {
     if (_val.missing()) {
         return Value(BSONNULL);
@@ -78,13 +78,36 @@ void AccumulatorSum::processInternal(const Value& input, bool merging) {
             nonDecimalTotal.addDouble(input.getDouble());
             break;
         case NumberDecimal:
-            decimalTotal = decimalTotal.add(input.coerceToDecimal());
+            decimalTotal.add(input.coerceToDecimal());
             break;
         default:
             MONGO_UNREACHABLE;
     }
 }
 
+void AccumulatorSum::processBatchInternal(const std::vector<Value>& inputs, bool merging) {
+    // Batches of only doubles or only integers are summed in one loop, with the same additions
+    // processInternal() would make.
+    const BSONType batchType = getBatchNumericType(inputs);
+    switch (batchType) {
+        case NumberDouble:
+            totalType = Value::getWidestNumeric(totalType, NumberDouble);
+            for (auto&& input : inputs) {
+                nonDecimalTotal.addDouble(input.getDouble());
+            }
+            break;
+        case NumberInt:
+        case NumberLong:
+            totalType = Value::getWidestNumeric(totalType, batchType);
+            for (auto&& input : inputs) {
+                nonDecimalTotal.addLong(input.getLong());
+            }
+            break;
+        default:
+            Accumulator::processBatchInternal(inputs, merging);
+    }
+}
+
 intrusive_ptr<Accumulator> AccumulatorSum::create(
     const boost::intrusive_ptr<ExpressionContext>& expCtx) {
     return new AccumulatorSum(expCtx);
@@ -127,7 +150,7 @@ Value AccumulatorSum::getValue(bool toBeMerged) {
                 total = total.add(Decimal128(sum, Decimal128::kRoundTo34Digits));
                 total = total.add(Decimal128(error, Decimal128::kRoundTo34Digits));
             }
-            total = total.add(decimalTotal);
+            total = total.add(decimalTotal.getDecimal());
             return Value(total);
         }
         default:
@@ -92,6 +92,28 @@ static void assertExpectedResults(
                 ASSERT_VALUE_EQ(op.second, result);
                 ASSERT_EQUALS(op.second.getType(), result.getType());
             }
+
+            // Asserts that result equals expected result when the input is processed as a batch,
+            // and when the partial results of each input are merged as a batch.
+            {
+                boost::intrusive_ptr<Accumulator> accum(factory(expCtx));
+                accum->processBatch(op.first, false);
+                Value result = accum->getValue(false);
+                ASSERT_VALUE_EQ(op.second, result);
+                ASSERT_EQUALS(op.second.getType(), result.getType());
+
+                std::vector<Value> partialResults;
+                for (auto&& val : op.first) {
+                    boost::intrusive_ptr<Accumulator> shard(factory(expCtx));
+                    shard->process(val, false);
+                    partialResults.push_back(shard->getValue(true));
+                }
+                boost::intrusive_ptr<Accumulator> merger(factory(expCtx));
+                merger->processBatch(partialResults, true);
+                result = merger->getValue(false);
+                ASSERT_VALUE_EQ(op.second, result);
+                ASSERT_EQUALS(op.second.getType(), result.getType());
+            }
         } catch (...) {
             log() << "failed with arguments: " << Value(op.first);
             throw;
@@ -209,7 +231,14 @@ TEST(Accumulators, Min) {
          // The accumulator evaluates two documents and retains the minimum value.
          {{Value(5), Value(7)}, Value(5)},
          // The accumulator evaluates two documents and ignores the missing value.
-         {{Value(7), Value()}, Value(7)}});
+         {{Value(7), Value()}, Value(7)},
+
+         // NaN is lower than all other doubles.
+         {{Value(3.5), Value(numeric_limits<double>::quiet_NaN()), Value(-1.0)},
+          Value(numeric_limits<double>::quiet_NaN())},
+         {{Value(2.5), Value(-1.5), Value(4.0)}, Value(-1.5)},
+         // Ints and longs compare by value.
+         {{Value(7), Value(3LL), Value(5)}, Value(3LL)}});
 }
 
 TEST(Accumulators, MinRespectsCollation) {
@@ -235,7 +264,13 @@ TEST(Accumulators, Max) {
          // The accumulator evaluates two documents and retains the maximum value.
          {{Value(5), Value(7)}, Value(7)},
          // The accumulator evaluates two documents and ignores the missing value.
-         {{Value(7), Value()}, Value(7)}});
+         {{Value(7), Value()}, Value(7)},
+
+         // NaN is lower than all other doubles.
+         {{Value(3.5), Value(numeric_limits<double>::quiet_NaN()), Value(-1.0)}, Value(3.5)},
+         {{Value(2.5), Value(-1.5), Value(4.0)}, Value(4.0)},
+         // Ints and longs compare by value.
+         {{Value(7LL), Value(9), Value(5)}, Value(9)}});
 }
 
 TEST(Accumulators, MaxRespectsCollation) {
@@ -0,0 +1,91 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/change_stream_event_cache.h"
+
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+
+namespace {
+const auto getChangeStreamEventCache = ServiceContext::declareDecoration<ChangeStreamEventCache>();
+}  // namespace
+
+ChangeStreamEventCache& ChangeStreamEventCache::get(ServiceContext* serviceContext) {
+    return getChangeStreamEventCache(serviceContext);
+}
+
+bool ChangeStreamEventCache::isEnabled() const {
+    return internalChangeStreamEventCacheMaxBytes.load() > 0;
+}
+
+boost::optional<Document> ChangeStreamEventCache::find(const std::string& key) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _events.find(key);
+    if (it == _events.end()) {
+        return boost::none;
+    }
+    return it->second.event;
+}
+
+void ChangeStreamEventCache::insert(std::string key, Document event) {
+    const auto maxBytes = static_cast<size_t>(internalChangeStreamEventCacheMaxBytes.load());
+    const auto approximateSize = key.size() + event.getApproximateSize();
+    if (approximateSize > maxBytes) {
+        return;
+    }
+
+    // Other threads may read the event as soon as it is published, so it must not have any fields
+    // left to be read lazily from its underlying BSON.
+    event.loadLazyFields();
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_events.find(key) != _events.end()) {
+        return;
+    }
+    evictUntilWithin(maxBytes - approximateSize);
+    _events.emplace(key, Entry{std::move(event), approximateSize});
+    _insertionOrder.push_back(std::move(key));
+    _totalBytes += approximateSize;
+}
+
+void ChangeStreamEventCache::evictUntilWithin(size_t maxBytes) {
+    while (_totalBytes > maxBytes && !_insertionOrder.empty()) {
+        auto it = _events.find(_insertionOrder.front());
+        invariant(it != _events.end());
+        _totalBytes -= it->second.approximateSize;
+        _events.erase(it);
+        _insertionOrder.pop_front();
+    }
+}
+
+}  // namespace mongo
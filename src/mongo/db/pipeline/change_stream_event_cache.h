@@ -0,0 +1,91 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <deque>
+#include <string>
+
+#include "mongo/db/pipeline/document.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+/**
+ * A process-wide cache of recently produced change stream events, shared by all change stream
+ * cursors on this node. Many cursors tailing the oplog at the same point see the same oplog
+ * entries within a short time of each other, so the first cursor to transform an entry publishes
+ * the resulting event and the others reuse it rather than transforming the entry again.
+ *
+ * The cache holds at most 'internalChangeStreamEventCacheMaxBytes' of events and discards the
+ * oldest ones first. A limit of zero disables it. This class is thread-safe.
+ */
+class ChangeStreamEventCache {
+public:
+    static ChangeStreamEventCache& get(ServiceContext* serviceContext);
+
+    /**
+     * Returns true if events should be looked up and stored in the cache.
+     */
+    bool isEnabled() const;
+
+    /**
+     * Returns the event stored under 'key', or boost::none if there is no such event.
+     */
+    boost::optional<Document> find(const std::string& key) const;
+
+    /**
+     * Stores 'event' under 'key', evicting the oldest events as needed to stay under the memory
+     * limit. Does nothing if an event is already stored under 'key'. 'event' must not be modified
+     * after it has been inserted, since other threads may read it concurrently.
+     */
+    void insert(std::string key, Document event);
+
+private:
+    struct Entry {
+        Document event;
+        size_t approximateSize;
+    };
+
+    // Evicts the oldest entries until the cache is within 'maxBytes'. Requires '_mutex'.
+    void evictUntilWithin(size_t maxBytes);
+
+    mutable stdx::mutex _mutex;
+    StringMap<Entry> _events;
+
+    // The keys of '_events' in the order they were inserted.
+    std::deque<std::string> _insertionOrder;
+    size_t _totalBytes = 0;
+};
+
+}  // namespace mongo
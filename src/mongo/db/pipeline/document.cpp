@@ -31,6 +31,7 @@
 
 #include "mongo/db/pipeline/document.h"
 
+#include <algorithm>
 #include <boost/functional/hash.hpp>
 
 #include "mongo/bson/bson_depth.h"
@@ -51,7 +52,7 @@ const std::vector<StringData> Document::allMetadataFieldNames = {Document::metaF
                                                                  Document::metaFieldGeoNearDistance,
                                                                  Document::metaFieldGeoNearPoint};
 
-Position DocumentStorage::findField(StringData requested) const {
+Position DocumentStorage::findFieldInBuffer(StringData requested) const {
     int reqSize = requested.size();  // get size calculation out of the way if needed
 
     if (_numFields >= HASH_TAB_MIN) {  // hash lookup
@@ -68,7 +69,7 @@ Position DocumentStorage::findField(StringData requested) const {
             pos = elem.nextCollision;
         }
     } else {  // linear scan
-        for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance()) {
+        for (DocumentStorageIterator it = bufferIteratorAll(); !it.atEnd(); it.advance()) {
             if (it->nameLen == reqSize && memcmp(requested.rawData(), it->_name, reqSize) == 0) {
                 return it.position();
             }
@@ -79,6 +80,84 @@ Position DocumentStorage::findField(StringData requested) const {
     return Position();
 }
 
+Value DocumentStorage::getField(StringData name) const {
+    Position pos = findFieldInBuffer(name);
+    if (pos.found())
+        return getField(pos).val;
+    if (!_lazy)
+        return Value();
+    return const_cast<DocumentStorage*>(this)->loadFieldFromBson(name);
+}
+
+Value DocumentStorage::loadFieldFromBson(StringData name) {
+    invariant(_lazy);
+
+    // Fields that are not in the object are cached as missing values, so that looking them up
+    // again does not scan the object again.
+    Value& cached = appendField(name);
+    BSONForEach(elem, _bson) {
+        if (elem.fieldNameStringData() == name) {
+            cached = valueFromBson(elem);
+            break;
+        }
+    }
+    return cached;
+}
+
+void DocumentStorage::loadAllFieldsFromBson() {
+    invariant(_lazy);
+    _lazy = false;
+
+    for (DocumentStorageIterator it = bufferIteratorAll(); !it.atEnd(); it.advance()) {
+        it->val.~Value();  // explicit destructor call
+    }
+    _usedBytes = 0;
+    _numFields = 0;
+
+    BSONForEach(elem, _bson) {
+        appendField(elem.fieldNameStringData()) = valueFromBson(elem);
+    }
+}
+
+Value DocumentStorage::valueFromBson(const BSONElement& elem) const {
+    if (elem.type() != Object) {
+        return Value(elem);
+    }
+
+    // The embedded object is copied, since the Value may outlive this storage.
+    BSONObj embedded = elem.embeddedObject();
+    if (embedded.isEmpty()) {
+        return Value(Document());
+    }
+    return Value(Document(make_intrusive<DocumentStorage>(embedded.getOwned())));
+}
+
+namespace {
+/**
+ * Returns the nesting depth of 'obj', counting both embedded objects and arrays, in the way they
+ * are counted by the recursion level of Document::toBson().
+ */
+size_t computeBsonDepth(const BSONObj& obj) {
+    size_t maxChildDepth = 0;
+    for (auto&& elem : obj) {
+        if (elem.type() == Object || elem.type() == Array) {
+            maxChildDepth = std::max(maxChildDepth, computeBsonDepth(elem.embeddedObject()));
+        }
+    }
+    return maxChildDepth + 1;
+}
+}  // namespace
+
+bool DocumentStorage::canReuseBson(size_t recursionLevel) const {
+    if (_bson.isEmpty()) {
+        return false;
+    }
+    if (!_bsonDepth) {
+        _bsonDepth = computeBsonDepth(_bson);
+    }
+    return recursionLevel - 1 + _bsonDepth <= BSONDepth::getMaxAllowableDepth();
+}
+
 Value& DocumentStorage::appendField(StringData name) {
     Position pos = getNextPosition();
     const int nameSize = name.size();
@@ -189,6 +268,7 @@ void DocumentStorage::reserveFields(size_t expectedFields) {
 }
 
 intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
+    loadAllFields();
     auto out = make_intrusive<DocumentStorage>();
 
     if (_buffer) {
@@ -232,21 +312,15 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
 DocumentStorage::~DocumentStorage() {
     std::unique_ptr<char[]> deleteBufferAtScopeEnd(_buffer);
 
-    for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance()) {
+    for (DocumentStorageIterator it = bufferIteratorAll(); !it.atEnd(); it.advance()) {
         it->val.~Value();  // explicit destructor call
     }
 }
 
 Document::Document(const BSONObj& bson) {
-    MutableDocument md(bson.nFields());
-
-    BSONObjIterator it(bson);
-    while (it.more()) {
-        BSONElement bsonElement(it.next());
-        md.addField(bsonElement.fieldNameStringData(), Value(bsonElement));
+    if (!bson.isEmpty()) {
+        _storage = make_intrusive<DocumentStorage>(bson.getOwned());
     }
-
-    *this = md.freeze();
 }
 
 Document::Document(std::initializer_list<std::pair<StringData, ImplicitValue>> initializerList) {
@@ -273,13 +347,35 @@ void Document::toBson(BSONObjBuilder* builder, size_t recursionLevel) const {
                           << " levels of nesting",
             recursionLevel <= BSONDepth::getMaxAllowableDepth());
 
+    if (storage().canReuseBson(recursionLevel)) {
+        builder->appendElements(storage().bson());
+        return;
+    }
+
     for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
         it->val.addToBsonObj(builder, it->nameSD(), recursionLevel);
     }
 }
 
+namespace {
+/**
+ * Returns the size of the buffer to start serializing 'doc' into. The approximate in-memory size
+ * of a document follows its BSON size closely enough that sizing the buffer from it avoids growing
+ * the buffer repeatedly while the fields are appended.
+ */
+int initialBsonBufferSize(const Document& doc) {
+    const size_t kMinSize = 512;  // BSONObjBuilder's default.
+    return static_cast<int>(std::min(std::max(doc.getApproximateSize(), kMinSize),
+                                     static_cast<size_t>(BSONObjMaxUserSize)));
+}
+}  // namespace
+
 BSONObj Document::toBson() const {
-    BSONObjBuilder bb;
+    if (storage().canReuseBson(1)) {
+        return storage().bson();
+    }
+
+    BSONObjBuilder bb(initialBsonBufferSize(*this));
     toBson(&bb);
     return bb.obj();
 }
@@ -291,7 +387,7 @@ constexpr StringData Document::metaFieldGeoNearDistance;
 constexpr StringData Document::metaFieldGeoNearPoint;
 
 BSONObj Document::toBsonWithMetaData() const {
-    BSONObjBuilder bb;
+    BSONObjBuilder bb(initialBsonBufferSize(*this));
     toBson(&bb);
     if (hasTextScore())
         bb.append(metaFieldTextScore, getTextScore());
@@ -307,6 +403,21 @@ BSONObj Document::toBsonWithMetaData() const {
 }
 
 Document Document::fromBsonWithMetaData(const BSONObj& bson) {
+    // Without metadata fields, the document can read its fields lazily from the object.
+    bool hasMetaData = false;
+    for (auto&& elem : bson) {
+        auto fieldName = elem.fieldNameStringData();
+        if (fieldName[0] == '$' &&
+            std::find(allMetadataFieldNames.begin(), allMetadataFieldNames.end(), fieldName) !=
+                allMetadataFieldNames.end()) {
+            hasMetaData = true;
+            break;
+        }
+    }
+    if (!hasMetaData) {
+        return Document(bson);
+    }
+
     MutableDocument md;
 
     BSONObjIterator it(bson);
@@ -388,18 +499,26 @@ static Value getNestedFieldHelper(const Document& doc,
                                   vector<Position>* positions,
                                   size_t level) {
     const auto fieldName = fieldNames.getFieldName(level);
-    const Position pos = doc.positionOf(fieldName);
 
-    if (!pos.found())
-        return Value();
+    Value val;
+    if (positions) {
+        // Looking up the position converts all of the fields of a lazy document, so only do it
+        // when the caller asks for positions.
+        const Position pos = doc.positionOf(fieldName);
+        if (!pos.found())
+            return Value();
 
-    if (positions)
         positions->push_back(pos);
+        val = doc.getField(pos);
+    } else {
+        val = doc.getField(fieldName);
+        if (val.missing())
+            return Value();
+    }
 
     if (level == fieldNames.getPathLength() - 1)
-        return doc.getField(pos);
+        return val;
 
-    Value val = doc.getField(pos);
     if (val.getType() != Object)
         return Value();
 
@@ -417,6 +536,10 @@ size_t Document::getApproximateSize() const {
 
     size_t size = sizeof(DocumentStorage);
     size += storage().allocatedBytes();
+    if (storage().isLazy()) {
+        // Most of the memory is in the object the fields are read from, which is counted above.
+        return size;
+    }
 
     for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
         size += it->val.getApproximateSize();
@@ -426,6 +549,24 @@ size_t Document::getApproximateSize() const {
     return size;
 }
 
+namespace {
+void loadLazyFieldsInValue(const Value& val) {
+    if (val.getType() == Object) {
+        val.getDocument().loadLazyFields();
+    } else if (val.getType() == Array) {
+        for (auto&& elem : val.getArray()) {
+            loadLazyFieldsInValue(elem);
+        }
+    }
+}
+}  // namespace
+
+void Document::loadLazyFields() const {
+    for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
+        loadLazyFieldsInValue(it->val);
+    }
+}
+
 void Document::hash_combine(size_t& seed,
                             const StringData::ComparatorInterface* stringComparator) const {
     for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
@@ -102,7 +102,11 @@ public:
     /// Empty Document (does no allocation)
     Document() {}
 
-    /// Create a new Document deep-converted from the given BSONObj.
+    /**
+     * Create a new Document holding the given BSONObj, or a copy if it is not owned. Fields are
+     * converted to Values as they are looked up, and the object is reused by toBson() as long as
+     * the Document is not modified.
+     */
     explicit Document(const BSONObj& bson);
 
     /**
@@ -147,7 +151,7 @@ public:
 
     /// True if this document has no fields.
     bool empty() const {
-        return !_storage || storage().iterator().atEnd();
+        return !_storage || storage().empty();
     }
 
     /// Create a new FieldIterator that can be used to examine the Document's fields in order.
@@ -226,6 +230,12 @@ public:
      */
     static BSONObj stripMetadataFields(const BSONObj& bsonWithMetadata);
 
+    /**
+     * Converts the fields of this document and of all documents nested in it that are still only
+     * held as BSON. A Document must be fully loaded before it is read by several threads at once.
+     */
+    void loadLazyFields() const;
+
     // Support BSONObjBuilder and BSONArrayBuilder "stream" API
     friend BSONObjBuilder& operator<<(BSONObjBuilderValueStream& builder, const Document& d);
 
@@ -300,6 +310,7 @@ public:
     }
 
 private:
+    friend class DocumentStorage;
     friend class FieldIterator;
     friend class ValueStorage;
     friend class MutableDocument;
@@ -596,7 +607,9 @@ private:
             return clonedStorage();
 
         // This function exists to ensure this is safe
-        return const_cast<DocumentStorage&>(*storagePtr());
+        auto& storage = const_cast<DocumentStorage&>(*storagePtr());
+        storage.prepareForWrite();
+        return storage;
     }
     DocumentStorage& newStorage() {
         reset(make_intrusive<DocumentStorage>());
@@ -180,7 +180,16 @@ private:
     bool _includeMissing;
 };
 
-/// Storage class used by both Document and MutableDocument
+/** Storage class used by both Document and MutableDocument
+ *
+ *  Storage created from a BSONObj keeps the object and converts its fields to Values only as they
+ *  are looked up by name, caching them in the buffer in lookup order. Anything that depends on
+ *  the order or position of fields, such as iteration, first converts all of the fields in order.
+ *  Until the storage is written to, the object is also reused to serialize it back to BSON.
+ *
+ *  Since loading fields changes the storage behind const methods, a Document that has not been
+ *  fully loaded must not be read by several threads at once. See Document::loadLazyFields().
+ */
 class DocumentStorage : public RefCountable {
 public:
     DocumentStorage()
@@ -194,6 +203,13 @@ public:
           _randVal(0),
           _geoNearDistance(0) {}
 
+    /// Creates storage for the fields of 'bson', which must be owned and not empty.
+    explicit DocumentStorage(BSONObj bson) : DocumentStorage() {
+        dassert(bson.isOwned() && !bson.isEmpty());
+        _bson = std::move(bson);
+        _lazy = true;
+    }
+
     ~DocumentStorage();
 
     enum MetaType : char {
@@ -213,6 +229,7 @@ public:
 
     size_t size() const {
         // can't use _numFields because it includes removed Fields
+        loadAllFields();
         size_t count = 0;
         for (DocumentStorageIterator it = iterator(); !it.atEnd(); it.advance())
             count++;
@@ -224,19 +241,58 @@ public:
         return Position(_usedBytes);
     }
 
+    /// True if there are no fields, not counting missing ones
+    bool empty() const {
+        // Lazy storage is never empty, and only caches missing values for absent fields.
+        return !_lazy && iterator().atEnd();
+    }
+
     /// Returns the position of the named field (may be missing) or Position()
-    Position findField(StringData name) const;
+    Position findField(StringData name) const {
+        loadAllFields();
+        return findFieldInBuffer(name);
+    }
 
     // Document uses these
     const ValueElement& getField(Position pos) const {
         verify(pos.found());
         return *(_firstElement->plusBytes(pos.index));
     }
-    Value getField(StringData name) const {
-        Position pos = findField(name);
-        if (!pos.found())
-            return Value();
-        return getField(pos).val;
+    Value getField(StringData name) const;
+
+    /**
+     * Converts all fields that have not been looked up yet, so that the fields in the buffer are
+     * in the order of the original BSONObj. Positions and iterators are only valid afterwards.
+     */
+    void loadAllFields() const {
+        if (MONGO_unlikely(_lazy)) {
+            const_cast<DocumentStorage*>(this)->loadAllFieldsFromBson();
+        }
+    }
+
+    /**
+     * Returns the object this storage was created from, as long as its fields have not been
+     * written to, or an empty object otherwise.
+     */
+    const BSONObj& bson() const {
+        return _bson;
+    }
+
+    /**
+     * True if the fields of this storage can be serialized by appending those of bson() at the
+     * given recursion level, without going past the BSON depth limit.
+     */
+    bool canReuseBson(size_t recursionLevel) const;
+
+    /**
+     * Loads all fields and drops the object this storage was created from. MutableDocument calls
+     * this before handing out the storage for writes.
+     */
+    void prepareForWrite() {
+        if (MONGO_unlikely(!_bson.isEmpty())) {
+            loadAllFields();
+            _bson = BSONObj();
+        }
     }
 
     // MutableDocument uses these
@@ -261,19 +317,27 @@ public:
 
     /// This skips missing values
     DocumentStorageIterator iterator() const {
+        loadAllFields();
         return DocumentStorageIterator(_firstElement, end(), false);
     }
 
     /// This includes missing values
     DocumentStorageIterator iteratorAll() const {
-        return DocumentStorageIterator(_firstElement, end(), true);
+        loadAllFields();
+        return bufferIteratorAll();
     }
 
     /// Shallow copy of this. Caller owns memory.
     boost::intrusive_ptr<DocumentStorage> clone() const;
 
     size_t allocatedBytes() const {
-        return !_buffer ? 0 : (_bufferEnd - _buffer + hashTabBytes());
+        return (!_buffer ? 0 : (_bufferEnd - _buffer + hashTabBytes())) +
+            (_bson.isEmpty() ? 0 : _bson.objsize());
+    }
+
+    /// True if some fields of the original BSONObj have not been converted yet
+    bool isLazy() const {
+        return _lazy;
     }
 
     /**
@@ -359,6 +423,23 @@ private:
         return _firstElement ? _firstElement->plusBytes(_usedBytes) : nullptr;
     }
 
+    /// Iterates over the fields in the buffer, without loading any.
+    DocumentStorageIterator bufferIteratorAll() const {
+        return DocumentStorageIterator(_firstElement, end(), true);
+    }
+
+    /// Returns the position of the named field among the fields in the buffer or Position()
+    Position findFieldInBuffer(StringData name) const;
+
+    /// Converts the named field of '_bson' and caches it in the buffer, even if it is missing.
+    Value loadFieldFromBson(StringData name);
+
+    /// Replaces the fields in the buffer by all of the fields of '_bson', in order.
+    void loadAllFieldsFromBson();
+
+    /// Converts an element of '_bson' to a Value, keeping embedded objects lazy.
+    Value valueFromBson(const BSONElement& elem) const;
+
     /// Allocates space in _buffer. Copies existing data if there is any.
     void alloc(unsigned newSize);
 
@@ -397,7 +478,7 @@ private:
     /// Adds all fields to the hash table
     void rehash() {
         hashTabInit();
-        for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance())
+        for (DocumentStorageIterator it = bufferIteratorAll(); !it.atEnd(); it.advance())
             addFieldToHashTable(it.position());
     }
 
@@ -439,6 +520,15 @@ private:
     Value _geoNearPoint;
     // When adding a field, make sure to update clone() method
 
+    // The object the fields are read from, until they are written to. See bson().
+    BSONObj _bson;
+    // The nesting depth of '_bson', or 0 until it is first needed.
+    mutable size_t _bsonDepth = 0;
+
+    // Set while some fields of '_bson' are not in the buffer, which then holds the fields looked
+    // up so far in lookup order.
+    bool _lazy = false;
+
     // Defined in document.cpp
     static const DocumentStorage kEmptyDoc;
 };
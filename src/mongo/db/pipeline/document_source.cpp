@@ -91,6 +91,19 @@ intrusive_ptr<DocumentSource> DocumentSource::optimize() {
     return this;
 }
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSource::getNextBatch(
+    size_t maxBatchSize, std::vector<Document>* batch) {
+    invariant(maxBatchSize > 0);
+    for (size_t i = 0; i < maxBatchSize; ++i) {
+        auto next = getNext();
+        if (!next.isAdvanced()) {
+            return next.getStatus();
+        }
+        batch->push_back(next.releaseDocument());
+    }
+    return GetNextResult::ReturnStatus::kAdvanced;
+}
+
 namespace {
 
 /**
@@ -249,6 +249,19 @@ public:
      */
     virtual GetNextResult getNext() = 0;
 
+    /**
+     * Batched variant of getNext(). Appends at most 'maxBatchSize' results from this stage to
+     * 'batch', which must be positive, and returns the status that ended the batch: kAdvanced if
+     * more results may follow, or the kPauseExecution or kEOF that getNext() would have returned
+     * after the appended results. A kAdvanced batch may hold fewer than 'maxBatchSize' results.
+     *
+     * The default implementation simply calls getNext() until the batch is full. Stages override
+     * this when they can amortize their per-document dispatch across a whole batch. Calls to
+     * getNext() and getNextBatch() may be freely interleaved.
+     */
+    virtual GetNextResult::ReturnStatus getNextBatch(size_t maxBatchSize,
+                                                     std::vector<Document>* batch);
+
     /**
      * Returns a struct containing information about any special constraints imposed on using this
      * stage. Input parameter Pipeline::SplitState is used by stages whose requirements change
@@ -0,0 +1,152 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/json.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_group.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/document_source_sort.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/collation/collator_factory_icu.h"
+
+namespace mongo {
+namespace {
+
+using StageFactory = std::function<boost::intrusive_ptr<DocumentSource>(
+    BSONElement, const boost::intrusive_ptr<ExpressionContext>&)>;
+
+std::deque<DocumentSource::GetNextResult> makeInputs(size_t numDocs) {
+    std::deque<DocumentSource::GetNextResult> inputs;
+    for (size_t i = 0; i < numDocs; ++i) {
+        const int n = static_cast<int>(i);
+        inputs.emplace_back(Document{{"_id", n},
+                                     {"k", n % 100},
+                                     {"v", (n * 7919) % 10007},
+                                     {"price", 0.5 * (n % 200)},
+                                     {"name", "item" + std::to_string(n % 1000)}});
+    }
+    return inputs;
+}
+
+/**
+ * Measures the throughput of the stage described by 'spec' over 'state.range(0)' documents
+ * supplied by a DocumentSourceMock, using the ICU collation 'collation' if it is non-empty.
+ * Building the input is excluded from the timings.
+ */
+void runStageBenchmark(benchmark::State& state,
+                       StageFactory createStage,
+                       const char* spec,
+                       const BSONObj& collation = BSONObj()) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    std::unique_ptr<CollatorInterface> collator;
+    if (!collation.isEmpty()) {
+        collator = uassertStatusOK(CollatorFactoryICU().makeFromBSON(collation));
+        expCtx->setCollator(collator.get());
+    }
+    const BSONObj stageSpec = fromjson(spec);
+    const auto inputs = makeInputs(state.range(0));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto mock = DocumentSourceMock::create(inputs);
+        auto stage = createStage(stageSpec.firstElement(), expCtx);
+        stage->setSource(mock.get());
+        state.ResumeTiming();
+
+        for (auto next = stage->getNext(); next.isAdvanced(); next = stage->getNext()) {
+            benchmark::DoNotOptimize(next.getDocument());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * inputs.size());
+}
+
+void BM_GroupFewKeys(benchmark::State& state) {
+    runStageBenchmark(state,
+                      DocumentSourceGroup::createFromBson,
+                      "{$group: {_id: '$k', total: {$sum: '$v'}, avg: {$avg: '$price'}, "
+                      "count: {$sum: 1}}}");
+}
+
+void BM_GroupManyKeys(benchmark::State& state) {
+    runStageBenchmark(state,
+                      DocumentSourceGroup::createFromBson,
+                      "{$group: {_id: '$_id', total: {$sum: '$v'}, names: {$push: '$name'}}}");
+}
+
+void BM_GroupCompoundKey(benchmark::State& state) {
+    runStageBenchmark(state,
+                      DocumentSourceGroup::createFromBson,
+                      "{$group: {_id: {k: '$k', name: '$name'}, max: {$max: '$v'}}}");
+}
+
+void BM_SortSingleField(benchmark::State& state) {
+    runStageBenchmark(state, DocumentSourceSort::createFromBson, "{$sort: {v: 1}}");
+}
+
+void BM_SortCompound(benchmark::State& state) {
+    runStageBenchmark(state, DocumentSourceSort::createFromBson, "{$sort: {k: 1, name: -1}}");
+}
+
+// Case-insensitive collation, as used for sorted listings.
+const BSONObj kCaseInsensitiveCollation = BSON("locale"
+                                               << "en"
+                                               << "strength"
+                                               << 2);
+
+void BM_GroupStringKeyWithCollation(benchmark::State& state) {
+    runStageBenchmark(state,
+                      DocumentSourceGroup::createFromBson,
+                      "{$group: {_id: '$name', count: {$sum: 1}}}",
+                      kCaseInsensitiveCollation);
+}
+
+void BM_SortStringWithCollation(benchmark::State& state) {
+    runStageBenchmark(
+        state, DocumentSourceSort::createFromBson, "{$sort: {name: 1}}", kCaseInsensitiveCollation);
+}
+
+void BM_SortStringSimpleCollation(benchmark::State& state) {
+    runStageBenchmark(state, DocumentSourceSort::createFromBson, "{$sort: {name: 1}}");
+}
+
+BENCHMARK(BM_GroupFewKeys)->Arg(1000)->Arg(100 * 1000);
+BENCHMARK(BM_GroupManyKeys)->Arg(1000)->Arg(100 * 1000);
+BENCHMARK(BM_GroupCompoundKey)->Arg(1000)->Arg(100 * 1000);
+BENCHMARK(BM_SortSingleField)->Arg(1000)->Arg(100 * 1000);
+BENCHMARK(BM_SortCompound)->Arg(1000)->Arg(100 * 1000);
+BENCHMARK(BM_GroupStringKeyWithCollation)->Arg(1000)->Arg(100 * 1000);
+BENCHMARK(BM_SortStringWithCollation)->Arg(1000)->Arg(100 * 1000);
+BENCHMARK(BM_SortStringSimpleCollation)->Arg(1000)->Arg(100 * 1000);
+
+}  // namespace
+}  // namespace mongo
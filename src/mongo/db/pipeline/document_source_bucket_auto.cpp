@@ -31,6 +31,8 @@
 
 #include "mongo/db/pipeline/document_source_bucket_auto.h"
 
+#include <algorithm>
+
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 
@@ -91,13 +93,17 @@ DocumentSource::GetNextResult DocumentSourceBucketAuto::getNext() {
     pExpCtx->checkForInterrupt();
 
     if (!_populated) {
-        const auto populationResult = populateSorter();
+        const auto populationResult = _approximate ? populateCells() : populateSorter();
         if (populationResult.isPaused()) {
             return populationResult;
         }
         invariant(populationResult.isEOF());
 
-        populateBuckets();
+        if (_approximate) {
+            populateBucketsFromCells();
+        } else {
+            populateBuckets();
+        }
 
         _populated = true;
         _bucketsIterator = _buckets.begin();
@@ -293,6 +299,10 @@ void DocumentSourceBucketAuto::populateBuckets() {
         addBucket(currentBucket);
     }
 
+    roundOuterBoundaries();
+}
+
+void DocumentSourceBucketAuto::roundOuterBoundaries() {
     if (!_buckets.empty() && _granularityRounder) {
         // If we we have a granularity, we round the first bucket's minimum down and the last
         // bucket's maximum up. This way all of the bucket boundaries are rounded to numbers in the
@@ -304,6 +314,111 @@ void DocumentSourceBucketAuto::populateBuckets() {
     }
 }
 
+DocumentSource::GetNextResult DocumentSourceBucketAuto::populateCells() {
+    auto next = pSource->getNext();
+    for (; next.isAdvanced(); next = pSource->getNext()) {
+        auto nextDoc = next.releaseDocument();
+        addDocumentToCell(extractKey(nextDoc), nextDoc);
+    }
+    return next;
+}
+
+void DocumentSourceBucketAuto::addDocumentToCell(Value key, const Document& doc) {
+    const auto& valueCmp = pExpCtx->getValueComparator();
+
+    // Find the last cell whose minimum is not greater than 'key'. If 'key' is beyond its maximum,
+    // it falls between two cells and starts a new one.
+    auto cell = std::upper_bound(
+        _cells.begin(), _cells.end(), key, [&valueCmp](const Value& value, const Bucket& cell) {
+            return valueCmp.evaluate(value < cell._min);
+        });
+    if (cell == _cells.begin() || valueCmp.evaluate(key > std::prev(cell)->_max)) {
+        cell = _cells.insert(cell, Bucket(pExpCtx, key, key, _accumulatedFields));
+    } else {
+        cell = std::prev(cell);
+    }
+
+    ++cell->_count;
+    const size_t numAccumulators = _accumulatedFields.size();
+    for (size_t k = 0; k < numAccumulators; k++) {
+        cell->_accums[k]->process(_accumulatedFields[k].expression->evaluate(doc), false);
+    }
+    _nDocuments++;
+
+    if (_cells.size() > 2 * _maxCells) {
+        compressCells();
+    }
+}
+
+void DocumentSourceBucketAuto::compressCells() {
+    // Merging greedily up to this many documents per cell leaves no two neighbouring cells with
+    // fewer documents between them, so at most about '_maxCells' cells remain.
+    const long long maxCells = static_cast<long long>(_maxCells);
+    const long long maxCellSize = (2 * _nDocuments + maxCells - 1) / maxCells;
+
+    std::vector<Bucket> compressed;
+    for (auto&& cell : _cells) {
+        if (!compressed.empty() && compressed.back()._count + cell._count <= maxCellSize) {
+            mergeCell(compressed.back(), cell);
+        } else {
+            compressed.push_back(std::move(cell));
+        }
+    }
+    _cells = std::move(compressed);
+}
+
+void DocumentSourceBucketAuto::mergeCell(Bucket& cell, const Bucket& next) {
+    cell._max = next._max;
+    cell._count += next._count;
+
+    // The accumulators combine their partial results the same way as when merging the output of
+    // $group from several shards.
+    const bool merging = true;
+    const size_t numAccumulators = _accumulatedFields.size();
+    for (size_t k = 0; k < numAccumulators; k++) {
+        cell._accums[k]->process(next._accums[k]->getValue(merging), merging);
+    }
+}
+
+void DocumentSourceBucketAuto::populateBucketsFromCells() {
+    // Calculate the approximate bucket size. We attempt to fill each bucket with this many
+    // documents.
+    const long long approxBucketSize =
+        std::max(1LL, static_cast<long long>(std::round(double(_nDocuments) / double(_nBuckets))));
+
+    // Since all of the documents with the same value are in the same cell, whole cells can be
+    // placed into buckets without splitting equal values between buckets.
+    auto nextCell = _cells.begin();
+    for (int i = 0; i < _nBuckets && nextCell != _cells.end(); i++) {
+        bool isLastBucket = (i == _nBuckets - 1);
+
+        Bucket currentBucket(std::move(*nextCell++));
+        while (nextCell != _cells.end() &&
+               (isLastBucket || currentBucket._count < approxBucketSize)) {
+            mergeCell(currentBucket, *nextCell++);
+        }
+
+        if (_granularityRounder && nextCell != _cells.end()) {
+            // If the following cells start below the rounded boundary, absorb them into this
+            // bucket too.
+            Value boundaryValue = _granularityRounder->roundUp(currentBucket._max);
+            while (nextCell != _cells.end() &&
+                   pExpCtx->getValueComparator().evaluate(boundaryValue > nextCell->_min)) {
+                mergeCell(currentBucket, *nextCell++);
+                boundaryValue = _granularityRounder->roundUp(currentBucket._max);
+            }
+            if (nextCell != _cells.end()) {
+                currentBucket._max = boundaryValue;
+            }
+        }
+
+        addBucket(currentBucket);
+    }
+    _cells.clear();
+
+    roundOuterBoundaries();
+}
+
 DocumentSourceBucketAuto::Bucket::Bucket(
     const boost::intrusive_ptr<ExpressionContext>& expCtx,
     Value min,
@@ -381,6 +496,10 @@ Value DocumentSourceBucketAuto::serialize(
         insides["granularity"] = Value(_granularityRounder->getName());
     }
 
+    if (_approximate) {
+        insides["approximate"] = Value(true);
+    }
+
     MutableDocument outputSpec(_accumulatedFields.size());
     for (auto&& accumulatedField : _accumulatedFields) {
         intrusive_ptr<Accumulator> accum = accumulatedField.makeAccumulator(pExpCtx);
@@ -399,7 +518,8 @@ intrusive_ptr<DocumentSourceBucketAuto> DocumentSourceBucketAuto::create(
     int numBuckets,
     std::vector<AccumulationStatement> accumulationStatements,
     const boost::intrusive_ptr<GranularityRounder>& granularityRounder,
-    uint64_t maxMemoryUsageBytes) {
+    uint64_t maxMemoryUsageBytes,
+    bool approximate) {
     uassert(40243,
             str::stream() << "The $bucketAuto 'buckets' field must be greater than 0, but found: "
                           << numBuckets,
@@ -415,7 +535,8 @@ intrusive_ptr<DocumentSourceBucketAuto> DocumentSourceBucketAuto::create(
                                         numBuckets,
                                         accumulationStatements,
                                         granularityRounder,
-                                        maxMemoryUsageBytes);
+                                        maxMemoryUsageBytes,
+                                        approximate);
 }
 
 DocumentSourceBucketAuto::DocumentSourceBucketAuto(
@@ -424,12 +545,15 @@ DocumentSourceBucketAuto::DocumentSourceBucketAuto(
     int numBuckets,
     std::vector<AccumulationStatement> accumulationStatements,
     const boost::intrusive_ptr<GranularityRounder>& granularityRounder,
-    uint64_t maxMemoryUsageBytes)
+    uint64_t maxMemoryUsageBytes,
+    bool approximate)
     : DocumentSource(pExpCtx),
       _nBuckets(numBuckets),
       _maxMemoryUsageBytes(maxMemoryUsageBytes),
       _groupByExpression(groupByExpression),
-      _granularityRounder(granularityRounder) {
+      _granularityRounder(granularityRounder),
+      _approximate(approximate),
+      _maxCells(static_cast<size_t>(numBuckets) * kApproximateCellsPerBucket) {
 
     invariant(!accumulationStatements.empty());
     for (auto&& accumulationStatement : accumulationStatements) {
@@ -449,6 +573,7 @@ intrusive_ptr<DocumentSource> DocumentSourceBucketAuto::createFromBson(
     boost::intrusive_ptr<Expression> groupByExpression;
     boost::optional<int> numBuckets;
     boost::intrusive_ptr<GranularityRounder> granularityRounder;
+    bool approximate = false;
 
     for (auto&& argument : elem.Obj()) {
         const auto argName = argument.fieldNameStringData();
@@ -489,6 +614,13 @@ intrusive_ptr<DocumentSource> DocumentSourceBucketAuto::createFromBson(
                         << typeName(argument.type()),
                     argument.type() == BSONType::String);
             granularityRounder = GranularityRounder::getGranularityRounder(pExpCtx, argument.str());
+        } else if ("approximate" == argName) {
+            uassert(ErrorCodes::TypeMismatch,
+                    str::stream()
+                        << "The $bucketAuto 'approximate' field must be a boolean, but found type: "
+                        << typeName(argument.type()),
+                    argument.type() == BSONType::Bool);
+            approximate = argument.boolean();
         } else {
             uasserted(40245, str::stream() << "Unrecognized option to $bucketAuto: " << argName);
         }
@@ -498,8 +630,13 @@ intrusive_ptr<DocumentSource> DocumentSourceBucketAuto::createFromBson(
             "$bucketAuto requires 'groupBy' and 'buckets' to be specified",
             groupByExpression && numBuckets);
 
-    return DocumentSourceBucketAuto::create(
-        pExpCtx, groupByExpression, numBuckets.get(), accumulationStatements, granularityRounder);
+    return DocumentSourceBucketAuto::create(pExpCtx,
+                                            groupByExpression,
+                                            numBuckets.get(),
+                                            accumulationStatements,
+                                            granularityRounder,
+                                            kDefaultMaxMemoryUsageBytes,
+                                            approximate);
 }
 
 }  // namespace mongo
@@ -41,6 +41,12 @@ namespace mongo {
 /**
  * The $bucketAuto stage takes a user-specified number of buckets and automatically determines
  * boundaries such that the values are approximately equally distributed between those buckets.
+ *
+ * With the 'approximate' option, the stage doesn't buffer its input. It instead keeps a bounded
+ * number of cells, each covering a range of adjacent 'groupBy' values with the accumulated results
+ * of their documents. Neighbouring cells are merged whenever there are too many of them, and the
+ * buckets are finally assembled out of whole cells, so the bucket sizes are only approximately
+ * equal.
  */
 class DocumentSourceBucketAuto final : public DocumentSource {
 public:
@@ -68,6 +74,11 @@ public:
 
     static const uint64_t kDefaultMaxMemoryUsageBytes = 100 * 1024 * 1024;
 
+    // The number of cells per requested bucket which the approximate mode keeps after merging
+    // cells. This bounds the error in the size of each bucket to roughly 2/kCellsPerBucket of the
+    // bucket size.
+    static const size_t kApproximateCellsPerBucket = 32;
+
     /**
      * Convenience method to create a $bucketAuto stage.
      *
@@ -80,7 +91,8 @@ public:
         int numBuckets,
         std::vector<AccumulationStatement> accumulationStatements = {},
         const boost::intrusive_ptr<GranularityRounder>& granularityRounder = nullptr,
-        uint64_t maxMemoryUsageBytes = kDefaultMaxMemoryUsageBytes);
+        uint64_t maxMemoryUsageBytes = kDefaultMaxMemoryUsageBytes,
+        bool approximate = false);
 
     /**
      * Parses a $bucketAuto stage from the user-supplied BSON.
@@ -97,9 +109,11 @@ private:
                              int numBuckets,
                              std::vector<AccumulationStatement> accumulationStatements,
                              const boost::intrusive_ptr<GranularityRounder>& granularityRounder,
-                             uint64_t maxMemoryUsageBytes);
+                             uint64_t maxMemoryUsageBytes,
+                             bool approximate);
 
-    // struct for holding information about a bucket.
+    // struct for holding information about a bucket. Also used for the cells of the approximate
+    // mode, in which case '_count' is the number of documents in the cell.
     struct Bucket {
         Bucket(const boost::intrusive_ptr<ExpressionContext>& expCtx,
                Value min,
@@ -107,6 +121,7 @@ private:
                const std::vector<AccumulationStatement>& accumulationStatements);
         Value _min;
         Value _max;
+        long long _count = 0;
         std::vector<boost::intrusive_ptr<Accumulator>> _accums;
     };
 
@@ -138,6 +153,39 @@ private:
      */
     void addBucket(Bucket& newBucket);
 
+    /**
+     * Rounds the minimum of the first bucket down and the maximum of the last bucket up to the
+     * granularity, if one is specified.
+     */
+    void roundOuterBoundaries();
+
+    /**
+     * Consumes all of the documents from the source in the pipeline and adds each to the cell
+     * containing its 'groupBy' value. Like populateSorter(), returns the last GetNextResult
+     * encountered, which may be either kEOF or kPauseExecution.
+     */
+    GetNextResult populateCells();
+
+    /**
+     * Adds 'doc' to the cell whose range contains 'key', creating a new cell if there is none.
+     */
+    void addDocumentToCell(Value key, const Document& doc);
+
+    /**
+     * Merges neighbouring cells so that no more than about '_maxCells' of them remain.
+     */
+    void compressCells();
+
+    /**
+     * Merges the cell 'next', whose values are all greater than those of 'cell', into 'cell'.
+     */
+    void mergeCell(Bucket& cell, const Bucket& next);
+
+    /**
+     * Assembles the buckets out of the cells built by populateCells().
+     */
+    void populateBucketsFromCells();
+
     /**
      * Makes a document using the information from bucket. This is what is returned when getNext()
      * is called.
@@ -157,6 +205,12 @@ private:
     boost::intrusive_ptr<Expression> _groupByExpression;
     boost::intrusive_ptr<GranularityRounder> _granularityRounder;
     long long _nDocuments = 0;
+
+    const bool _approximate;
+    const size_t _maxCells;
+
+    // The cells of the approximate mode, ordered by their disjoint ranges of values.
+    std::vector<Bucket> _cells;
 };
 
 }  // namespace mongo
@@ -803,5 +803,75 @@ TEST_F(BucketAutoTests, ShouldFailOnNegativeNumbersWhenGranularitySpecified) {
         AssertionException,
         40260);
 }
+
+TEST_F(BucketAutoTests, ApproximateModeMatchesExactModeWhenCellsAreNotMerged) {
+    deque<Document> inputs;
+    for (int x : {2, 4, 1, 7, 0, 5, 3, 6, 7, 7}) {
+        inputs.push_back(Document{{"x", x}});
+    }
+
+    for (auto&& spec : {"{groupBy : '$x', buckets : 3}",
+                        "{groupBy : '$x', buckets : 2, granularity : 'R5'}",
+                        "{groupBy : '$x', buckets : 4, output : {total : {$sum : '$x'}}}"}) {
+        auto exactSpec = fromjson(spec);
+        auto approximateSpec = exactSpec.addField(BSON("approximate" << true).firstElement());
+        auto exactResults = getResults(BSON("$bucketAuto" << exactSpec), inputs);
+        auto approximateResults = getResults(BSON("$bucketAuto" << approximateSpec), inputs);
+
+        ASSERT_EQUALS(approximateResults.size(), exactResults.size());
+        for (size_t i = 0; i < exactResults.size(); ++i) {
+            ASSERT_DOCUMENT_EQ(approximateResults[i], exactResults[i]);
+        }
+    }
+}
+
+TEST_F(BucketAutoTests, ApproximateModeProducesRoughlyEqualBucketsFromManyValues) {
+    auto bucketAutoSpec = fromjson(
+        "{$bucketAuto : {groupBy : '$x', buckets : 4, approximate : true, output : {count : "
+        "{$sum : 1}, total : {$sum : '$x'}, min : {$min : '$x'}}}}");
+
+    // Values are 0 to 9999, in an order which is not sorted.
+    const int numDocs = 10000;
+    deque<Document> inputs;
+    for (int i = 0; i < numDocs; ++i) {
+        inputs.push_back(Document{{"x", (i * 7919) % numDocs}});
+    }
+    auto results = getResults(bucketAutoSpec, std::move(inputs));
+
+    ASSERT_EQUALS(results.size(), 4UL);
+    long long count = 0;
+    long long total = 0;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& bucket = results[i];
+        ASSERT_GTE(bucket["count"].coerceToLong(), 2000);
+        ASSERT_LTE(bucket["count"].coerceToLong(), 3000);
+        count += bucket["count"].coerceToLong();
+        total += bucket["total"].coerceToLong();
+
+        // The buckets are contiguous, and each minimum is the smallest value in its bucket.
+        ASSERT_VALUE_EQ(bucket["_id"]["min"], bucket["min"]);
+        if (i > 0) {
+            ASSERT_VALUE_EQ(bucket["_id"]["min"], results[i - 1]["_id"]["max"]);
+        }
+    }
+    ASSERT_EQUALS(count, numDocs);
+    ASSERT_EQUALS(total, static_cast<long long>(numDocs) * (numDocs - 1) / 2);
+    ASSERT_VALUE_EQ(results.front()["_id"]["min"], Value(0));
+    ASSERT_VALUE_EQ(results.back()["_id"]["max"], Value(numDocs - 1));
+}
+
+TEST_F(BucketAutoTests, SerializesApproximateFieldIfSpecified) {
+    BSONObj spec = fromjson("{$bucketAuto : {groupBy : '$x', buckets : 2, approximate : true}}");
+    BSONObj expected = fromjson(
+        "{groupBy : '$x', buckets : 2, approximate : true, output : {count : {$sum : {$const : "
+        "1}}}}");
+
+    testSerialize(spec, expected);
+}
+
+TEST_F(BucketAutoTests, FailsWithNonBooleanApproximate) {
+    auto spec = fromjson("{$bucketAuto : {groupBy : '$x', buckets : 2, approximate : 1}}");
+    ASSERT_THROWS_CODE(createBucketAuto(spec), AssertionException, ErrorCodes::TypeMismatch);
+}
 }  // namespace
 }  // namespace mongo
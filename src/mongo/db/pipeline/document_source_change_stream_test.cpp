@@ -51,11 +51,13 @@
 #include "mongo/db/pipeline/stub_mongo_process_interface.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/repl/oplog_entry.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/uuid.h"
 
 namespace mongo {
@@ -498,6 +500,54 @@ TEST_F(ChangeStreamStageTest, TransformInsertDocKeyXAndId) {
     checkTransformation(insert2, expectedInsert, {{"x"}, {"_id"}});
 }
 
+TEST_F(ChangeStreamStageTest, ChangeStreamsShouldShareEventsThroughTheEventCache) {
+    const long long originalCacheMaxBytes = internalChangeStreamEventCacheMaxBytes.load();
+    ON_BLOCK_EXIT([&] { internalChangeStreamEventCacheMaxBytes.store(originalCacheMaxBytes); });
+    internalChangeStreamEventCacheMaxBytes.store(1024 * 1024);
+
+    auto insert = makeOplogEntry(OpTypeEnum::kInsert,           // op type
+                                 nss,                           // namespace
+                                 BSON("_id" << 1 << "x" << 2),  // o
+                                 testUuid(),                    // uuid
+                                 boost::none,                   // fromMigrate
+                                 boost::none);                  // o2
+
+    Document expectedInsert{
+        {DSChangeStream::kIdField,
+         makeResumeToken(kDefaultTs, testUuid(), BSON("x" << 2 << "_id" << 1))},
+        {DSChangeStream::kOperationTypeField, DSChangeStream::kInsertOpType},
+        {DSChangeStream::kClusterTimeField, kDefaultTs},
+        {DSChangeStream::kFullDocumentField, D{{"_id", 1}, {"x", 2}}},
+        {DSChangeStream::kNamespaceField, D{{"db", nss.db()}, {"coll", nss.coll()}}},
+        {DSChangeStream::kDocumentKeyField, D{{"x", 2}, {"_id", 1}}},
+    };
+    checkTransformation(insert, expectedInsert, {{"x"}, {"_id"}});
+
+    // A second stream reading the same oplog entry reuses the event produced by the first, rather
+    // than transforming the entry again with the document key fields it would look up itself.
+    checkTransformation(insert, expectedInsert, {{"_id"}});
+
+    // A different oplog entry is transformed afresh.
+    const Timestamp laterTs(kDefaultTs.getSecs(), kDefaultTs.getInc() + 1);
+    const repl::OpTime laterOpTime(laterTs, kDefaultOpTime.getTerm());
+    auto laterInsert = makeOplogEntry(OpTypeEnum::kInsert,           // op type
+                                      nss,                           // namespace
+                                      BSON("_id" << 1 << "x" << 2),  // o
+                                      testUuid(),                    // uuid
+                                      boost::none,                   // fromMigrate
+                                      boost::none,                   // o2
+                                      laterOpTime);                  // opTime
+    Document expectedLaterInsert{
+        {DSChangeStream::kIdField, makeResumeToken(laterTs, testUuid(), BSON("_id" << 1))},
+        {DSChangeStream::kOperationTypeField, DSChangeStream::kInsertOpType},
+        {DSChangeStream::kClusterTimeField, laterTs},
+        {DSChangeStream::kFullDocumentField, D{{"_id", 1}, {"x", 2}}},
+        {DSChangeStream::kNamespaceField, D{{"db", nss.db()}, {"coll", nss.coll()}}},
+        {DSChangeStream::kDocumentKeyField, D{{"_id", 1}}},
+    };
+    checkTransformation(laterInsert, expectedLaterInsert, {{"_id"}});
+}
+
 TEST_F(ChangeStreamStageTest, TransformInsertDocKeyIdAndX) {
     auto insert = makeOplogEntry(OpTypeEnum::kInsert,           // op type
                                  nss,                           // namespace
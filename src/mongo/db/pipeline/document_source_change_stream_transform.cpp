@@ -39,6 +39,7 @@
 #include "mongo/db/commands/feature_compatibility_version_documentation.h"
 #include "mongo/db/logical_clock.h"
 #include "mongo/db/pipeline/change_stream_constants.h"
+#include "mongo/db/pipeline/change_stream_event_cache.h"
 #include "mongo/db/pipeline/document_path_support.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
@@ -494,7 +495,7 @@ DocumentSource::GetNextResult DocumentSourceChangeStreamTransform::getNext() {
 
             // This oplog entry represents a single change. Apply the transform to it and return the
             // resulting document.
-            return applyTransformation(doc);
+            return applyTransformationOrReuseCachedEvent(doc);
         }
 
         initializeTransactionContext(doc);
@@ -506,6 +507,51 @@ DocumentSource::GetNextResult DocumentSourceChangeStreamTransform::getNext() {
     }
 }
 
+Document DocumentSourceChangeStreamTransform::applyTransformationOrReuseCachedEvent(
+    const Document& input) {
+    auto& eventCache = ChangeStreamEventCache::get(pExpCtx->opCtx->getServiceContext());
+    if (!eventCache.isEnabled()) {
+        return applyTransformation(input);
+    }
+
+    auto key = makeEventCacheKey(input);
+    if (auto event = eventCache.find(key)) {
+        return std::move(*event);
+    }
+    auto event = applyTransformation(input);
+    eventCache.insert(std::move(key), event);
+    return event;
+}
+
+std::string DocumentSourceChangeStreamTransform::makeEventCacheKey(const Document& input) const {
+    // An oplog entry is identified by its timestamp and term. The event produced from it also
+    // depends on the resume token version and sort key format, which are determined by the FCV and
+    // by how the results will be merged.
+    BSONObjBuilder keyBuilder;
+    input[repl::OplogEntry::kTimestampFieldName].addToBsonObj(&keyBuilder, "ts");
+    input[repl::OplogEntry::kTermFieldName].addToBsonObj(&keyBuilder, "t");
+    keyBuilder.append("fcv", static_cast<int>(_fcv));
+    keyBuilder.append("needsMerge", pExpCtx->needsMerge);
+    keyBuilder.append("mergeByPBRT", pExpCtx->mergeByPBRT);
+
+    // Stages whose document key fields for the collection are final use those fields, which may
+    // come from their resume token. All other stages look the fields up in the catalog, and so
+    // agree with each other.
+    auto uuid = input[repl::OplogEntry::kUuidFieldName];
+    if (uuid.getType() == BSONType::BinData) {
+        auto it = _documentKeyCache.find(uuid.getUuid());
+        if (it != _documentKeyCache.end() && it->second.isFinal) {
+            BSONArrayBuilder fieldsBuilder(keyBuilder.subarrayStart("documentKey"));
+            for (auto&& field : it->second.documentKeyFields) {
+                fieldsBuilder.append(field.fullPath());
+            }
+        }
+    }
+
+    auto key = keyBuilder.done();
+    return std::string(key.objdata(), key.objsize());
+}
+
 bool DocumentSourceChangeStreamTransform::isDocumentRelevant(const Document& d) {
     invariant(
         d["op"].getType() == BSONType::String,
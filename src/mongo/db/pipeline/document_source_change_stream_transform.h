@@ -141,6 +141,19 @@ private:
      */
     bool isDocumentRelevant(const Document& d);
 
+    /**
+     * Returns the event for the single oplog entry 'input', reusing the event produced by another
+     * change stream on this node if it is in the ChangeStreamEventCache.
+     */
+    Document applyTransformationOrReuseCachedEvent(const Document& input);
+
+    /**
+     * Returns the ChangeStreamEventCache key of the event this stage produces from 'input'. Two
+     * stages produce the same event from the same oplog entry, and therefore have the same key,
+     * whenever they generate the same resume token format and document key fields.
+     */
+    std::string makeEventCacheKey(const Document& input) const;
+
     BSONObj _changeStreamSpec;
 
     // Map of collection UUID to document key fields.
@@ -33,6 +33,9 @@
 
 #include "mongo/db/pipeline/document_source_cursor.h"
 
+#include <algorithm>
+#include <iterator>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/pipeline/document.h"
@@ -74,6 +77,29 @@ DocumentSource::GetNextResult DocumentSourceCursor::getNext() {
     return std::move(out);
 }
 
+DocumentSource::GetNextResult::ReturnStatus DocumentSourceCursor::getNextBatch(
+    size_t maxBatchSize, std::vector<Document>* batch) {
+    // The cached latest optime must be updated as each document is returned.
+    if (_trackOplogTS) {
+        return DocumentSource::getNextBatch(maxBatchSize, batch);
+    }
+
+    invariant(maxBatchSize > 0);
+    pExpCtx->checkForInterrupt();
+
+    if (_currentBatch.empty()) {
+        loadBatch();
+    }
+
+    if (_currentBatch.empty())
+        return GetNextResult::ReturnStatus::kEOF;
+
+    const auto batchEnd = _currentBatch.begin() + std::min(maxBatchSize, _currentBatch.size());
+    std::move(_currentBatch.begin(), batchEnd, std::back_inserter(*batch));
+    _currentBatch.erase(_currentBatch.begin(), batchEnd);
+    return GetNextResult::ReturnStatus::kAdvanced;
+}
+
 Document DocumentSourceCursor::transformBSONObjToDocument(const BSONObj& obj) const {
     return _dependencies ? _dependencies->extractFields(obj) : Document::fromBsonWithMetaData(obj);
 }
@@ -48,6 +48,8 @@ class DocumentSourceCursor : public DocumentSource {
 public:
     // virtuals from DocumentSource
     GetNextResult getNext() final;
+    GetNextResult::ReturnStatus getNextBatch(size_t maxBatchSize,
+                                             std::vector<Document>* batch) final;
 
     const char* getSourceName() const override;
 
@@ -359,7 +359,8 @@ size_t Exchange::loadNextBatch() {
         switch (_policy) {
             case ExchangePolicyEnum::kBroadcast: {
                 bool full = false;
-                // The document is sent to all consumers.
+                // The document is sent to all consumers, which may read it concurrently.
+                input.getDocument().loadLazyFields();
                 for (auto& c : _consumers) {
                     full = c->appendDocument(input, _maxBufferSize);
                 }
@@ -31,13 +31,18 @@
 
 #include "mongo/db/pipeline/document_source_facet.h"
 
+#include <algorithm>
+#include <functional>
 #include <memory>
+#include <set>
 #include <vector>
 
 #include "mongo/base/string_data.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/bsontypes.h"
+#include "mongo/db/client.h"
+#include "mongo/db/operation_context.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source_tee_consumer.h"
 #include "mongo/db/pipeline/expression_context.h"
@@ -45,8 +50,15 @@
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/pipeline/tee_buffer.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/db/service_context.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/stdx/unordered_set.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -64,7 +76,7 @@ DocumentSourceFacet::DocumentSourceFacet(std::vector<FacetPipeline> facetPipelin
     for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
         auto& facet = _facets[facetId];
         facet.pipeline->addInitialSource(
-            DocumentSourceTeeConsumer::create(pExpCtx, facetId, _teeBuffer));
+            DocumentSourceTeeConsumer::create(facet.pipeline->getContext(), facetId, _teeBuffer));
     }
 }
 
@@ -107,6 +119,111 @@ vector<pair<string, vector<BSONObj>>> extractRawPipelines(const BSONElement& ele
     }
     return rawFacetPipelines;
 }
+
+/**
+ * Runs each of 'tasks' on a thread of its own, giving it an OperationContext that inherits the
+ * deadline of 'opCtx', and waits for all of them to finish. If 'opCtx' is interrupted, the workers
+ * are killed. Throws the first error that any of the tasks failed with.
+ */
+void runOnWorkerThreads(OperationContext* opCtx,
+                        const std::vector<std::function<void(OperationContext*)>>& tasks) {
+    stdx::mutex mutex;
+    stdx::condition_variable workerFinished;
+    size_t numFinished = 0;
+    bool stopped = false;
+    std::vector<OperationContext*> workerOpCtxs(tasks.size(), nullptr);
+    std::vector<Status> workerStatuses(tasks.size(), Status::OK());
+    std::vector<stdx::thread> threads;
+
+    auto serviceContext = opCtx->getServiceContext();
+    const Date_t deadline = opCtx->getDeadline();
+    auto runWorker = [&](size_t workerIndex) {
+        ThreadClient tc(str::stream() << "facet-" << workerIndex, serviceContext);
+        auto workerOpCtx = tc->makeOperationContext();
+        workerOpCtx->setDeadlineByDate(deadline, ErrorCodes::MaxTimeMSExpired);
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            workerOpCtxs[workerIndex] = workerOpCtx.get();
+            if (stopped) {
+                stdx::lock_guard<Client> clientLock(*tc.get());
+                serviceContext->killOperation(clientLock, workerOpCtx.get());
+            }
+        }
+
+        Status status = Status::OK();
+        try {
+            tasks[workerIndex](workerOpCtx.get());
+        } catch (const DBException& ex) {
+            status = ex.toStatus();
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        workerOpCtxs[workerIndex] = nullptr;
+        workerStatuses[workerIndex] = std::move(status);
+        ++numFinished;
+        workerFinished.notify_all();
+    };
+
+    try {
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            threads.emplace_back([&runWorker, i] { runWorker(i); });
+        }
+
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        opCtx->waitForConditionOrInterrupt(
+            workerFinished, lk, [&] { return numFinished == threads.size(); });
+    } catch (...) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            stopped = true;
+            for (auto workerOpCtx : workerOpCtxs) {
+                if (workerOpCtx) {
+                    stdx::lock_guard<Client> clientLock(*workerOpCtx->getClient());
+                    serviceContext->killOperation(clientLock, workerOpCtx);
+                }
+            }
+        }
+        for (auto&& thread : threads) {
+            thread.join();
+        }
+        throw;
+    }
+
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    for (auto&& status : workerStatuses) {
+        uassertStatusOK(status);
+    }
+}
+
+/**
+ * Returns true if 'rawPipeline' only contains stages which use nothing but their own
+ * ExpressionContext, and so can be run on a worker thread with an OperationContext of its own.
+ */
+bool onlyContainsStagesSafeToRunInParallel(const std::vector<BSONObj>& rawPipeline) {
+    static const std::set<StringData> kSafeStages = {"$addFields"_sd,
+                                                     "$bucket"_sd,
+                                                     "$bucketAuto"_sd,
+                                                     "$count"_sd,
+                                                     "$group"_sd,
+                                                     "$limit"_sd,
+                                                     "$match"_sd,
+                                                     "$project"_sd,
+                                                     "$redact"_sd,
+                                                     "$replaceRoot"_sd,
+                                                     "$replaceWith"_sd,
+                                                     "$set"_sd,
+                                                     "$skip"_sd,
+                                                     "$sort"_sd,
+                                                     "$sortByCount"_sd,
+                                                     "$unset"_sd,
+                                                     "$unwind"_sd};
+    return std::all_of(rawPipeline.begin(), rawPipeline.end(), [](const BSONObj& stage) {
+        return kSafeStages.count(stage.firstElementFieldNameStringData()) > 0;
+    });
+}
 }  // namespace
 
 std::unique_ptr<DocumentSourceFacet::LiteParsed> DocumentSourceFacet::LiteParsed::parse(
@@ -177,16 +294,15 @@ DocumentSource::GetNextResult DocumentSourceFacet::getNext() {
     }
 
     vector<vector<Value>> results(_facets.size());
-    bool allPipelinesEOF = false;
-    while (!allPipelinesEOF) {
-        allPipelinesEOF = true;  // Set this to false if any pipeline isn't EOF.
-        for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
-            const auto& pipeline = _facets[facetId].pipeline;
-            auto next = pipeline->getSources().back()->getNext();
-            for (; next.isAdvanced(); next = pipeline->getSources().back()->getNext()) {
-                results[facetId].emplace_back(next.releaseDocument());
+    if (canRunFacetsInParallel()) {
+        runFacetsInParallel(&results);
+    } else {
+        bool allPipelinesEOF = false;
+        while (!allPipelinesEOF) {
+            allPipelinesEOF = true;  // Set this to false if any pipeline isn't EOF.
+            for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
+                allPipelinesEOF = drainFacet(facetId, &results[facetId]) && allPipelinesEOF;
             }
-            allPipelinesEOF = allPipelinesEOF && next.isEOF();
         }
     }
 
@@ -199,6 +315,59 @@ DocumentSource::GetNextResult DocumentSourceFacet::getNext() {
     return resultDoc.freeze();
 }
 
+bool DocumentSourceFacet::drainFacet(size_t facetId, std::vector<Value>* results) {
+    const auto& pipeline = _facets[facetId].pipeline;
+    auto next = pipeline->getSources().back()->getNext();
+    for (; next.isAdvanced(); next = pipeline->getSources().back()->getNext()) {
+        results->emplace_back(next.releaseDocument());
+    }
+    return next.isEOF();
+}
+
+bool DocumentSourceFacet::canRunFacetsInParallel() const {
+    if (!internalQueryEnableParallelFacet.load() || _facets.size() < 2) {
+        return false;
+    }
+
+    stdx::unordered_set<const ExpressionContext*> contexts{pExpCtx.get()};
+    return std::all_of(_facets.begin(), _facets.end(), [&contexts](const FacetPipeline& facet) {
+        return contexts.insert(facet.pipeline->getContext().get()).second;
+    });
+}
+
+void DocumentSourceFacet::runFacetsInParallel(std::vector<std::vector<Value>>* results) {
+    _teeBuffer->setLoadBatchesExternally(true);
+    ON_BLOCK_EXIT([&] { _teeBuffer->setLoadBatchesExternally(false); });
+
+    // Facets that have produced all of their results. This is not a vector<bool>, since the
+    // workers write to their own elements concurrently.
+    std::vector<char> facetEOF(_facets.size(), false);
+    while (std::find(facetEOF.begin(), facetEOF.end(), false) != facetEOF.end()) {
+        // An empty batch means that the input is exhausted, and the facets still need to run once
+        // more to see EOF from it.
+        _teeBuffer->loadNextBatch();
+
+        std::vector<std::function<void(OperationContext*)>> tasks;
+        for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
+            if (facetEOF[facetId]) {
+                continue;
+            }
+            tasks.push_back([this, facetId, results, &facetEOF](OperationContext* opCtx) {
+                const auto& facetExpCtx = _facets[facetId].pipeline->getContext();
+                auto ownerOpCtx = facetExpCtx->opCtx;
+                facetExpCtx->opCtx = opCtx;
+                ON_BLOCK_EXIT([&] { facetExpCtx->opCtx = ownerOpCtx; });
+                facetEOF[facetId] = drainFacet(facetId, &(*results)[facetId]);
+            });
+        }
+        if (tasks.size() == 1) {
+            tasks.front()(pExpCtx->opCtx);
+        } else {
+            runOnWorkerThreads(pExpCtx->opCtx, tasks);
+        }
+    }
+}
+
 Value DocumentSourceFacet::serialize(boost::optional<ExplainOptions::Verbosity> explain) const {
     MutableDocument serialized;
     for (auto&& facet : _facets) {
@@ -319,11 +488,24 @@ intrusive_ptr<DocumentSource> DocumentSourceFacet::createFromBson(
     boost::optional<std::string> needsMongoS;
     boost::optional<std::string> needsShard;
 
+    auto rawFacets = extractRawPipelines(elem);
+
+    // Facets can only run in parallel if each has an ExpressionContext of its own. They cannot be
+    // given copies if variables are defined in this scope, since the copies would not see those
+    // variables change.
+    const bool useExpCtxPerFacet = internalQueryEnableParallelFacet.load() &&
+        rawFacets.size() > 1 && !expCtx->variablesParseState.hasDefinedVariables() &&
+        std::all_of(rawFacets.begin(), rawFacets.end(), [](const auto& rawFacet) {
+            return onlyContainsStagesSafeToRunInParallel(rawFacet.second);
+        });
+
     std::vector<FacetPipeline> facetPipelines;
-    for (auto&& rawFacet : extractRawPipelines(elem)) {
+    for (auto&& rawFacet : rawFacets) {
         const auto facetName = rawFacet.first;
 
-        auto pipeline = uassertStatusOK(Pipeline::parseFacetPipeline(rawFacet.second, expCtx));
+        auto facetExpCtx = useExpCtxPerFacet ? expCtx->copyWith(expCtx->ns, expCtx->uuid) : expCtx;
+        auto pipeline =
+            uassertStatusOK(Pipeline::parseFacetPipeline(rawFacet.second, facetExpCtx));
 
         // Validate that none of the facet pipelines have any conflicting HostTypeRequirements. This
         // verifies both that all stages within each pipeline are consistent, and that the pipelines
@@ -154,6 +154,26 @@ private:
 
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
 
+    /**
+     * Returns true if internalQueryEnableParallelFacet is set and every facet pipeline has an
+     * ExpressionContext of its own, so that the facets can each be run on a thread of their own.
+     * createFromBson() only gives the facets their own contexts if all of their stages are safe to
+     * run on another thread.
+     */
+    bool canRunFacetsInParallel() const;
+
+    /**
+     * Runs the facets over one batch of '_teeBuffer' at a time, running the facets that have not
+     * yet finished concurrently on worker threads. Appends the results of each facet to 'results'.
+     */
+    void runFacetsInParallel(std::vector<std::vector<Value>>* results);
+
+    /**
+     * Appends the results of the facet 'facetId' to 'results' until it has consumed the current
+     * batch of '_teeBuffer'. Returns true if the facet has produced all of its results.
+     */
+    bool drainFacet(size_t facetId, std::vector<Value>* results);
+
     boost::intrusive_ptr<TeeBuffer> _teeBuffer;
     std::vector<FacetPipeline> _facets;
 
@@ -44,8 +44,10 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_source_skip.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 using std::deque;
@@ -451,6 +453,50 @@ DEATH_TEST_F(DocumentSourceFacetTest,
 // Miscellaneous.
 //
 
+TEST_F(DocumentSourceFacetTest, ParallelFacetsShouldProduceTheSameResultsAsSerialFacets) {
+    const bool originalParallelFacet = internalQueryEnableParallelFacet.load();
+    const int originalBufferSizeBytes = internalQueryFacetBufferSizeBytes.load();
+    ON_BLOCK_EXIT([&] {
+        internalQueryEnableParallelFacet.store(originalParallelFacet);
+        internalQueryFacetBufferSizeBytes.store(originalBufferSizeBytes);
+    });
+    // Use a small buffer so that the facets run over several batches.
+    internalQueryFacetBufferSizeBytes.store(100);
+
+    auto ctx = getExpCtx();
+    deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < 20; ++i) {
+        inputs.emplace_back(Document{{"_id", i}, {"a", i % 3}});
+    }
+    auto spec = fromjson(
+        "{$facet: {byA: [{$group: {_id: '$a', n: {$sum: 1}}}, {$sort: {_id: 1}}],"
+        "          firstTwo: [{$limit: 2}],"
+        "          evens: [{$match: {a: 0}}, {$project: {_id: 1}}]}}");
+
+    auto runFacet = [&](bool parallel) {
+        internalQueryEnableParallelFacet.store(parallel);
+        auto facetStage = DocumentSourceFacet::createFromBson(spec.firstElement(), ctx);
+        auto facet = static_cast<DocumentSourceFacet*>(facetStage.get());
+        for (auto&& facetPipeline : facet->getFacetPipelines()) {
+            ASSERT_EQ(parallel, facetPipeline.pipeline->getContext() != ctx);
+        }
+
+        auto mock = DocumentSourceMock::create(inputs);
+        facetStage->setSource(mock.get());
+        auto output = facetStage->getNext();
+        ASSERT(output.isAdvanced());
+        ASSERT(facetStage->getNext().isEOF());
+        return output.releaseDocument();
+    };
+
+    auto serialOutput = runFacet(false);
+    auto parallelOutput = runFacet(true);
+    ASSERT_DOCUMENT_EQ(serialOutput, parallelOutput);
+    ASSERT_VALUE_EQ(parallelOutput["byA"][0]["n"], Value(7));
+    ASSERT_EQ(parallelOutput["firstTwo"].getArrayLength(), 2UL);
+    ASSERT_EQ(parallelOutput["evens"].getArrayLength(), 7UL);
+}
+
 TEST_F(DocumentSourceFacetTest, ShouldBeAbleToReParseSerializedStage) {
     auto ctx = getExpCtx();
 
@@ -31,6 +31,8 @@
 
 #include "mongo/db/pipeline/document_source_graph_lookup.h"
 
+#include <algorithm>
+
 #include "mongo/base/init.h"
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/jsobj.h"
@@ -40,6 +42,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/stdx/memory.h"
 
@@ -49,6 +52,21 @@ using boost::intrusive_ptr;
 
 namespace dps = ::mongo::dotted_path_support;
 
+namespace {
+
+/**
+ * Generates a new file name on each call using a static, atomic and monotonically increasing
+ * number. See the comment on the same function in document_source_group.cpp for why each user of
+ * the Sorter needs its own.
+ */
+std::string nextFileName() {
+    static AtomicWord<unsigned> documentSourceGraphLookupFileCounter;
+    return "extsort-doc-graphlookup." +
+        std::to_string(documentSourceGraphLookupFileCounter.fetchAndAdd(1));
+}
+
+}  // namespace
+
 std::unique_ptr<LiteParsedDocumentSourceForeignCollections> DocumentSourceGraphLookUp::liteParse(
     const AggregationRequest& request, const BSONElement& spec) {
     uassert(ErrorCodes::FailedToParse,
@@ -105,11 +123,9 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNext() {
     performSearch();
 
     std::vector<Value> results;
-    while (!_visited.empty()) {
+    while (auto result = popVisited()) {
         // Remove elements one at a time to avoid consuming more memory.
-        auto it = _visited.begin();
-        results.push_back(Value(it->second));
-        _visited.erase(it);
+        results.push_back(Value(std::move(*result)));
     }
 
     MutableDocument output(*_input);
@@ -128,7 +144,8 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
     // If the unwind is not preserving empty arrays, we might have to process multiple inputs before
     // we get one that will produce an output.
     while (true) {
-        if (_visited.empty()) {
+        auto result = popVisited();
+        if (!result) {
             // No results are left for the current input, so we should move on to the next one and
             // perform a new search.
 
@@ -141,10 +158,11 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
             performSearch();
             _visitedUsageBytes = 0;
             _outputIndex = 0;
+            result = popVisited();
         }
         MutableDocument unwound(*_input);
 
-        if (_visited.empty()) {
+        if (!result) {
             if ((*_unwind)->preserveNullAndEmptyArrays()) {
                 // Since "preserveNullAndEmptyArrays" was specified, output a document even though
                 // we had no result.
@@ -158,23 +176,53 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
                 continue;
             }
         } else {
-            auto it = _visited.begin();
-            unwound.setNestedField(_as, Value(it->second));
+            unwound.setNestedField(_as, Value(std::move(*result)));
             if (indexPath) {
                 unwound.setNestedField(*indexPath, Value(_outputIndex));
                 ++_outputIndex;
             }
-            _visited.erase(it);
         }
 
         return unwound.freeze();
     }
 }
 
+boost::optional<Document> DocumentSourceGraphLookUp::popVisited() {
+    while (!_visited.empty()) {
+        auto it = _visited.begin();
+        Document result = std::move(it->second);
+        _visited.erase(it);
+
+        // Entries whose document was spilled are empty; the document is read back below.
+        if (!result.empty()) {
+            return result;
+        }
+    }
+
+    while (!_visitedRuns.empty()) {
+        auto& run = _visitedRuns.front();
+        if (!_visitedRunIsOpen) {
+            run->openSource();
+            _visitedRunIsOpen = true;
+        }
+        if (run->more()) {
+            return run->next().second;
+        }
+        run->closeSource();
+        _visitedRunIsOpen = false;
+        _visitedRuns.pop_front();
+    }
+
+    return boost::none;
+}
+
 void DocumentSourceGraphLookUp::doDispose() {
     _cache.clear();
     _frontier.clear();
     _visited.clear();
+    _frontierRuns.clear();
+    _visitedRuns.clear();
+    _visitedRunIsOpen = false;
 }
 
 void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
@@ -185,11 +233,13 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
 
         // Check whether each key in the frontier exists in the cache or needs to be queried.
         auto cached = pExpCtx->getDocumentComparator().makeUnorderedDocumentSet();
-        auto matchStage = makeMatchStageFromFrontier(&cached);
+        takeCachedValuesFromFrontier(&cached);
 
         ValueUnorderedSet queried = pExpCtx->getValueComparator().makeUnorderedValueSet();
         _frontier.swap(queried);
         _frontierUsageBytes = 0;
+        auto spilledFrontier = std::move(_frontierRuns);
+        _frontierRuns.clear();
 
         // Process cached values, populating '_frontier' for the next iteration of search.
         while (!cached.empty()) {
@@ -200,27 +250,36 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
             checkMemoryUsage();
         }
 
-        if (matchStage) {
-            // Query for all keys that were in the frontier and not in the cache, populating
-            // '_frontier' for the next iteration of search.
-
-            // We've already allocated space for the trailing $match stage in '_fromPipeline'.
-            _fromPipeline.back() = *matchStage;
-            auto pipeline =
-                pExpCtx->mongoProcessInterface->makePipeline(_fromPipeline, _fromExpCtx);
-            while (auto next = pipeline->getNext()) {
-                uassert(40271,
-                        str::stream()
-                            << "Documents in the '"
-                            << _from.ns()
-                            << "' namespace must contain an _id for de-duplication in $graphLookup",
-                        !(*next)["_id"].missing());
-
+        // Query for all keys that were in the frontier and not in the cache, populating
+        // '_frontier' for the next iteration of search. The keys are queried in chunks of at most
+        // internalDocumentSourceGraphLookupMaxQueryBytes so that a wide frontier cannot produce a
+        // $match over the BSON size limit.
+        const size_t maxChunkBytes = internalDocumentSourceGraphLookupMaxQueryBytes.load();
+        ValueUnorderedSet chunk = pExpCtx->getValueComparator().makeUnorderedValueSet();
+        size_t chunkBytes = 0;
+        auto addToChunk = [&](const Value& value) {
+            chunk.insert(value);
+            chunkBytes += value.getApproximateSize();
+            if (chunkBytes >= maxChunkBytes) {
                 shouldPerformAnotherQuery =
-                    addToVisitedAndFrontier(*next, depth) || shouldPerformAnotherQuery;
-                addToCache(std::move(*next), queried);
+                    queryFrontier(chunk, depth) || shouldPerformAnotherQuery;
+                chunk.clear();
+                chunkBytes = 0;
             }
-            checkMemoryUsage();
+        };
+
+        for (auto&& value : queried) {
+            addToChunk(value);
+        }
+        for (auto&& run : spilledFrontier) {
+            run->openSource();
+            while (run->more()) {
+                addToChunk(run->next().first);
+            }
+            run->closeSource();
+        }
+        if (!chunk.empty()) {
+            shouldPerformAnotherQuery = queryFrontier(chunk, depth) || shouldPerformAnotherQuery;
         }
 
         ++depth;
@@ -228,9 +287,30 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
              (!_maxDepth || depth <= *_maxDepth));
 
     _frontier.clear();
+    _frontierRuns.clear();
     _frontierUsageBytes = 0;
 }
 
+bool DocumentSourceGraphLookUp::queryFrontier(const ValueUnorderedSet& queried, long long depth) {
+    // We've already allocated space for the trailing $match stage in '_fromPipeline'.
+    _fromPipeline.back() = makeMatchStage(queried);
+    auto pipeline = pExpCtx->mongoProcessInterface->makePipeline(_fromPipeline, _fromExpCtx);
+
+    bool addedToVisited = false;
+    while (auto next = pipeline->getNext()) {
+        uassert(40271,
+                str::stream() << "Documents in the '" << _from.ns()
+                              << "' namespace must contain an _id for de-duplication in "
+                                 "$graphLookup",
+                !(*next)["_id"].missing());
+
+        addedToVisited = addToVisitedAndFrontier(*next, depth) || addedToVisited;
+        addToCache(std::move(*next), queried);
+        checkMemoryUsage();
+    }
+    return addedToVisited;
+}
+
 bool DocumentSourceGraphLookUp::addToVisitedAndFrontier(Document result, long long depth) {
     auto id = result.getField("_id");
 
@@ -281,8 +361,7 @@ void DocumentSourceGraphLookUp::addToCache(const Document& result,
         });
 }
 
-boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
-    DocumentUnorderedSet* cached) {
+void DocumentSourceGraphLookUp::takeCachedValuesFromFrontier(DocumentUnorderedSet* cached) {
     // Add any cached values to 'cached' and remove them from '_frontier'.
     for (auto it = _frontier.begin(); it != _frontier.end();) {
         if (auto entry = _cache[*it]) {
@@ -298,7 +377,9 @@ boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
             ++it;
         }
     }
+}
 
+BSONObj DocumentSourceGraphLookUp::makeMatchStage(const ValueUnorderedSet& values) const {
     // Create a query of the form {$and: [_additionalFilter, {_connectToField: {$in: [...]}}]}.
     //
     // We wrap the query in a $match so that it can be parsed into a DocumentSourceMatch when
@@ -318,7 +399,7 @@ boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
                     BSONObjBuilder subObj(connectToObj.subobjStart(_connectToField.fullPath()));
                     {
                         BSONArrayBuilder in(subObj.subarrayStart("$in"));
-                        for (auto&& value : _frontier) {
+                        for (auto&& value : values) {
                             in << value;
                         }
                     }
@@ -327,7 +408,7 @@ boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
         }
     }
 
-    return _frontier.empty() ? boost::none : boost::optional<BSONObj>(match.obj());
+    return match.obj();
 }
 
 void DocumentSourceGraphLookUp::performSearch() {
@@ -377,13 +458,68 @@ Pipeline::SourceContainer::iterator DocumentSourceGraphLookUp::doOptimizeAt(
 }
 
 void DocumentSourceGraphLookUp::checkMemoryUsage() {
-    // TODO SERVER-23980: Implement spilling to disk if allowDiskUse is specified.
+    if ((_visitedUsageBytes + _frontierUsageBytes) >= _maxMemoryUsageBytes &&
+        pExpCtx->allowDiskUse && !pExpCtx->inMongos) {
+        spillVisited();
+        spillFrontier();
+    }
+
+    // The _ids of the visited documents are never spilled, so this can still fail with
+    // 'allowDiskUse' if the search reaches too many distinct nodes.
     uassert(40099,
             "$graphLookup reached maximum memory consumption",
             (_visitedUsageBytes + _frontierUsageBytes) < _maxMemoryUsageBytes);
     _cache.evictDownTo(_maxMemoryUsageBytes - _frontierUsageBytes - _visitedUsageBytes);
 }
 
+void DocumentSourceGraphLookUp::spillVisited() {
+    const bool hasUnspilledDocuments = std::any_of(
+        _visited.begin(), _visited.end(), [](const auto& entry) { return !entry.second.empty(); });
+    if (!hasUnspilledDocuments) {
+        return;
+    }
+
+    if (_fileName.empty()) {
+        _fileName = pExpCtx->tempDir + "/" + nextFileName();
+    }
+    _usedDisk = true;
+
+    SortedFileWriter<Value, Document> writer(
+        SortOptions().TempDir(pExpCtx->tempDir), _fileName, _nextSortedFileWriterOffset);
+    _visitedUsageBytes = 0;
+    for (auto&& entry : _visited) {
+        if (!entry.second.empty()) {
+            writer.addAlreadySorted(entry.first, entry.second);
+            entry.second = Document();
+        }
+        _visitedUsageBytes += entry.first.getApproximateSize();
+    }
+    _visitedRuns.emplace_back(writer.done());
+    _nextSortedFileWriterOffset = writer.getFileEndOffset();
+}
+
+void DocumentSourceGraphLookUp::spillFrontier() {
+    if (_frontier.empty()) {
+        return;
+    }
+
+    if (_fileName.empty()) {
+        _fileName = pExpCtx->tempDir + "/" + nextFileName();
+    }
+    _usedDisk = true;
+
+    SortedFileWriter<Value, Value> writer(
+        SortOptions().TempDir(pExpCtx->tempDir), _fileName, _nextSortedFileWriterOffset);
+    for (auto&& value : _frontier) {
+        writer.addAlreadySorted(value, Value());
+    }
+    _frontierRuns.emplace_back(writer.done());
+    _nextSortedFileWriterOffset = writer.getFileEndOffset();
+
+    _frontier.clear();
+    _frontierUsageBytes = 0;
+}
+
 void DocumentSourceGraphLookUp::serializeToArray(
     std::vector<Value>& array, boost::optional<ExplainOptions::Verbosity> explain) const {
     // Serialize default options.
@@ -453,6 +589,7 @@ DocumentSourceGraphLookUp::DocumentSourceGraphLookUp(
       _additionalFilter(additionalFilter),
       _depthField(depthField),
       _maxDepth(maxDepth),
+      _maxMemoryUsageBytes(internalDocumentSourceGraphLookupMaxMemoryBytes.load()),
       _frontier(pExpCtx->getValueComparator().makeUnorderedValueSet()),
       _visited(ValueComparator::kInstance.makeUnorderedValueMap<Document>()),
       _cache(pExpCtx->getValueComparator()),
@@ -600,3 +737,6 @@ void DocumentSourceGraphLookUp::addInvolvedCollections(
     }
 }
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
@@ -29,11 +29,14 @@
 
 #pragma once
 
+#include <deque>
+
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lookup_set_cache.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/sorter/sorter.h"
 
 namespace mongo {
 
@@ -66,7 +69,7 @@ public:
         StageConstraints constraints(StreamType::kStreaming,
                                      PositionRequirement::kNone,
                                      hostRequirement,
-                                     DiskUseRequirement::kNoDiskUse,
+                                     DiskUseRequirement::kWritesTmpData,
                                      FacetRequirement::kAllowed,
                                      TransactionRequirement::kAllowed);
 
@@ -90,6 +93,10 @@ public:
 
     void reattachToOperationContext(OperationContext* opCtx) final;
 
+    bool usedDisk() final {
+        return _usedDisk;
+    }
+
     static boost::intrusive_ptr<DocumentSourceGraphLookUp> create(
         const boost::intrusive_ptr<ExpressionContext>& expCtx,
         NamespaceString fromNs,
@@ -133,15 +140,22 @@ private:
     }
 
     /**
-     * Prepares the query to execute on the 'from' collection wrapped in a $match by using the
-     * contents of '_frontier'.
-     *
-     * Fills 'cached' with any values that were retrieved from the cache.
-     *
-     * Returns boost::none if no query is necessary, i.e., all values were retrieved from the cache.
-     * Otherwise, returns a query object.
+     * Removes every value of '_frontier' that is present in '_cache', filling 'cached' with the
+     * documents that were retrieved from the cache.
+     */
+    void takeCachedValuesFromFrontier(DocumentUnorderedSet* cached);
+
+    /**
+     * Prepares the query to execute on the 'from' collection wrapped in a $match, matching
+     * documents whose 'connectToField' is one of 'values'.
+     */
+    BSONObj makeMatchStage(const ValueUnorderedSet& values) const;
+
+    /**
+     * Queries the 'from' collection for 'queried', adding each result to '_visited' at the given
+     * 'depth' and to '_cache'. Returns whether '_visited' was updated.
      */
-    boost::optional<BSONObj> makeMatchStageFromFrontier(DocumentUnorderedSet* cached);
+    bool queryFrontier(const ValueUnorderedSet& queried, long long depth);
 
     /**
      * If we have internalized a $unwind, getNext() dispatches to this function.
@@ -169,10 +183,29 @@ private:
 
     /**
      * Assert that '_visited' and '_frontier' have not exceeded the maximum meory usage, and then
-     * evict from '_cache' until this source is using less than '_maxMemoryUsageBytes'.
+     * evict from '_cache' until this source is using less than '_maxMemoryUsageBytes'. If
+     * 'allowDiskUse' was specified, the documents of '_visited' and the values of '_frontier' are
+     * spilled to disk first.
      */
     void checkMemoryUsage();
 
+    /**
+     * Writes every document of '_visited' that is still in memory to a run in '_visitedRuns',
+     * leaving only its _id behind to de-duplicate later results.
+     */
+    void spillVisited();
+
+    /**
+     * Writes the values of '_frontier' to a run in '_frontierRuns' and clears '_frontier'.
+     */
+    void spillFrontier();
+
+    /**
+     * Removes and returns the next document found by the search, first from '_visited' and then
+     * from '_visitedRuns'. Returns boost::none once every result has been returned.
+     */
+    boost::optional<Document> popVisited();
+
     /**
      * Process 'result', adding it to '_visited' with the given 'depth', and updating '_frontier'
      * with the object's 'connectTo' values.
@@ -198,7 +231,7 @@ private:
     // The aggregation pipeline to perform against the '_from' namespace.
     std::vector<BSONObj> _fromPipeline;
 
-    size_t _maxMemoryUsageBytes = 100 * 1024 * 1024;
+    size_t _maxMemoryUsageBytes;
 
     // Track memory usage to ensure we don't exceed '_maxMemoryUsageBytes'.
     size_t _visitedUsageBytes = 0;
@@ -209,9 +242,22 @@ private:
 
     // Tracks nodes that have been discovered for a given input. Keys are the '_id' value of the
     // document from the foreign collection, value is the document itself.  The keys are compared
-    // using the simple collation.
+    // using the simple collation. Once a document has been spilled to '_visitedRuns', its entry
+    // here maps to an empty Document.
     ValueUnorderedMap<Document> _visited;
 
+    // Runs of the documents and frontier values that were spilled to '_fileName' because they did
+    // not fit within '_maxMemoryUsageBytes'. The runs are not sorted; SortedFileWriter is only used
+    // for its on-disk format. '_frontierRuns' together with '_frontier' make up the frontier of the
+    // next level of the search.
+    std::deque<std::shared_ptr<Sorter<Value, Document>::Iterator>> _visitedRuns;
+    std::vector<std::shared_ptr<Sorter<Value, Value>::Iterator>> _frontierRuns;
+    bool _visitedRunIsOpen = false;
+
+    bool _usedDisk = false;
+    std::string _fileName;
+    unsigned int _nextSortedFileWriterOffset = 0;
+
     // Caches query results to avoid repeating any work. This structure is maintained across calls
     // to getNext().
     LookupSetCache _cache;
@@ -38,7 +38,10 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/stub_mongo_process_interface.h"
+#include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/str.h"
 
@@ -628,5 +631,72 @@ TEST_F(DocumentSourceGraphLookUpTest, ShouldNotExpandArraysWithinArraysAtEndOfCo
     ASSERT(graphLookupStage->getNext().isEOF());
 }
 
+TEST_F(DocumentSourceGraphLookUpTest, ShouldSpillVisitedDocumentsAndFrontierWithAllowDiskUse) {
+    const auto originalMaxMemoryBytes = internalDocumentSourceGraphLookupMaxMemoryBytes.load();
+    const auto originalMaxQueryBytes = internalDocumentSourceGraphLookupMaxQueryBytes.load();
+    ON_BLOCK_EXIT([&] {
+        internalDocumentSourceGraphLookupMaxMemoryBytes.store(originalMaxMemoryBytes);
+        internalDocumentSourceGraphLookupMaxQueryBytes.store(originalMaxQueryBytes);
+    });
+    internalDocumentSourceGraphLookupMaxMemoryBytes.store(4000);
+    internalDocumentSourceGraphLookupMaxQueryBytes.store(64);
+
+    // Make a star with 100 leaves, each of which is too large for all of them to fit in memory.
+    const size_t numLeaves = 100;
+    const std::string padding(500, 'x');
+    std::vector<Value> leafIds;
+    std::deque<DocumentSource::GetNextResult> fromContents;
+    for (size_t i = 1; i <= numLeaves; ++i) {
+        leafIds.push_back(Value(static_cast<int>(i)));
+        fromContents.push_back(Document{{"_id", static_cast<int>(i)}, {"padding", padding}});
+    }
+    fromContents.push_back(Document{{"_id", 0}, {"to", leafIds}});
+
+    auto makeGraphLookup = [&](bool allowDiskUse, DocumentSource* source) {
+        auto expCtx = getExpCtx();
+        expCtx->allowDiskUse = allowDiskUse;
+        NamespaceString fromNs("test", "graph_lookup");
+        expCtx->setResolvedNamespaces(StringMap<ExpressionContext::ResolvedNamespace>{
+            {fromNs.coll().toString(), {fromNs, std::vector<BSONObj>()}}});
+        expCtx->mongoProcessInterface = std::make_shared<MockMongoInterface>(fromContents);
+        auto graphLookupStage =
+            DocumentSourceGraphLookUp::create(expCtx,
+                                              fromNs,
+                                              "results",
+                                              "to",
+                                              "_id",
+                                              ExpressionFieldPath::create(expCtx, "startVal"),
+                                              boost::none,
+                                              boost::none,
+                                              boost::none,
+                                              boost::none);
+        graphLookupStage->setSource(source);
+        return graphLookupStage;
+    };
+
+    auto inputMock = DocumentSourceMock::create(Document{{"_id", 0}, {"startVal", 0}});
+    ASSERT_THROWS_CODE(
+        makeGraphLookup(false, inputMock.get())->getNext(), AssertionException, 40099);
+
+    unittest::TempDir tempDir("DocumentSourceGraphLookUpTest");
+    getExpCtx()->tempDir = tempDir.path();
+    inputMock = DocumentSourceMock::create(Document{{"_id", 0}, {"startVal", 0}});
+    auto graphLookupStage = makeGraphLookup(true, inputMock.get());
+
+    auto next = graphLookupStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_TRUE(graphLookupStage->usedDisk());
+
+    auto resultsValue = next.getDocument().getField("results");
+    ASSERT(resultsValue.isArray());
+    auto resultsArray = resultsValue.getArray();
+    ASSERT_EQ(numLeaves + 1, resultsArray.size());
+    for (size_t i = 1; i <= numLeaves; ++i) {
+        Document leaf{{"_id", static_cast<int>(i)}, {"padding", padding}};
+        ASSERT(arrayContains(getExpCtx(), resultsArray, Value(leaf)));
+    }
+    ASSERT(graphLookupStage->getNext().isEOF());
+}
+
 }  // namespace
 }  // namespace mongo
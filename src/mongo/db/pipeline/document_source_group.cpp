@@ -62,6 +62,16 @@ std::string nextFileName() {
     return "extsort-doc-group." + std::to_string(documentSourceGroupFileCounter.fetchAndAdd(1));
 }
 
+/**
+ * Returns the partition that a group with key 'id' is spilled to. The comparator's hash is also
+ * what '_groups' buckets on, so it is scrambled first to keep the keys of a single partition from
+ * clustering in the hash table it is later re-aggregated into.
+ */
+size_t partitionForKey(const ValueComparator& comparator, const Value& id, size_t numPartitions) {
+    const uint64_t hash = static_cast<uint64_t>(comparator.hash(id)) * 0x9E3779B97F4A7C15ULL;
+    return (hash >> 32) % numPartitions;
+}
+
 }  // namespace
 
 using boost::intrusive_ptr;
@@ -148,7 +158,7 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNext() {
     }
 
     if (_spilled) {
-        return getNextSpilled();
+        return _partitionedSpill ? getNextPartitioned() : getNextSpilled();
     } else {
         return getNextStandard();
     }
@@ -201,10 +211,27 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
     return std::move(out);
 }
 
+DocumentSource::GetNextResult DocumentSourceGroup::getNextPartitioned() {
+    // We aren't streaming, and we have spilled to disk by partition. Each partition is loaded back
+    // into '_groups' in turn and returned in the same way as an unspilled $group.
+    while (groupsIterator == _groups->end()) {
+        if (_nextPartition >= _partitionRuns.size()) {
+            dispose();
+            return GetNextResult::makeEOF();
+        }
+        loadSpilledPartition(_nextPartition++);
+    }
+
+    Document out = makeDocument(groupsIterator->first, groupsIterator->second, pExpCtx->needsMerge);
+    ++groupsIterator;
+    return std::move(out);
+}
+
 void DocumentSourceGroup::doDispose() {
     // Free our resources.
     _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
     _sorterIterator.reset();
+    _partitionRuns.clear();
 
     // Make us look done.
     groupsIterator = _groups->end();
@@ -256,10 +283,39 @@ Value DocumentSourceGroup::serialize(boost::optional<ExplainOptions::Verbosity>
         insides["$doingMerge"] = Value(true);
     }
 
+    if (explain && _unwindSrc) {
+        // Our output does not have to be parseable, so report the absorbed $unwind inline.
+        insides["$unwinding"] =
+            Value(DOC("path" << _unwindPath->fullPathWithPrefix() << "preserveNullAndEmptyArrays"
+                             << _unwindSrc->preserveNullAndEmptyArrays()));
+    }
+
+    if (explain && *explain >= ExplainOptions::Verbosity::kExecStats) {
+        MutableDocument out;
+        out[getSourceName()] = Value(insides.freeze());
+        out["usedDisk"] = Value(_usedDisk);
+        out["spills"] = Value(static_cast<long long>(_numSpills));
+        out["spilledRecords"] = Value(_spilledRecords);
+        out["spilledBytes"] = Value(_spilledBytes);
+        return out.freezeToValue();
+    }
+
     return Value(DOC(getSourceName() << insides.freeze()));
 }
 
+void DocumentSourceGroup::serializeToArray(
+    std::vector<Value>& array, boost::optional<ExplainOptions::Verbosity> explain) const {
+    if (_unwindSrc && !explain) {
+        _unwindSrc->serializeToArray(array);
+    }
+    DocumentSource::serializeToArray(array, explain);
+}
+
 DepsTracker::State DocumentSourceGroup::getDependencies(DepsTracker* deps) const {
+    if (_unwindSrc) {
+        _unwindSrc->getDependencies(deps);
+    }
+
     // add the _id
     for (size_t i = 0; i < _idExpressions.size(); i++) {
         _idExpressions[i]->addDependencies(deps);
@@ -275,9 +331,9 @@ DepsTracker::State DocumentSourceGroup::getDependencies(DepsTracker* deps) const
 
 DocumentSource::GetModPathsReturn DocumentSourceGroup::getModifiedPaths() const {
     // We preserve none of the fields, but any fields referenced as part of the group key are
-    // logically just renamed.
+    // logically just renamed. That no longer holds once an absorbed $unwind has modified the input.
     StringMap<std::string> renames;
-    for (std::size_t i = 0; i < _idExpressions.size(); ++i) {
+    for (std::size_t i = 0; !_unwindSrc && i < _idExpressions.size(); ++i) {
         auto idExp = _idExpressions[i];
         auto pathToPutResultOfExpression =
             _idFieldNames.empty() ? "_id" : "_id." + _idFieldNames[i];
@@ -318,7 +374,8 @@ DocumentSourceGroup::DocumentSourceGroup(const intrusive_ptr<ExpressionContext>&
       _initialized(false),
       _groups(pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>()),
       _spilled(false),
-      _allowDiskUse(pExpCtx->allowDiskUse && !pExpCtx->inMongos) {
+      _allowDiskUse(pExpCtx->allowDiskUse && !pExpCtx->inMongos),
+      _partitionedSpill(internalQueryEnableGroupPartitionedSpill.load()) {
     if (!pExpCtx->inMongos && (pExpCtx->allowDiskUse || kDebugBuild)) {
         // We spill to disk in debug mode, regardless of allowDiskUse, to stress the system.
         _fileName = pExpCtx->tempDir + "/" + nextFileName();
@@ -436,93 +493,280 @@ private:
     ValueComparator _valueComparator;
 };
 
+/**
+ * A group about to be spilled, along with the collation comparison key of its _id if one was
+ * computed. Comparison keys compare with the simple collation the same way as the _ids they were
+ * computed from compare with the collation, so sorting by them avoids calling into the collator
+ * for every comparison.
+ */
+struct SpillEntry {
+    const GroupsMap::value_type* group;
+    boost::optional<Value> comparisonKey;
+};
+
+/**
+ * Returns the comparison key of 'id' under 'collator', or boost::none if 'id' must be compared
+ * with the collator itself. Only string _ids are translated, as those are the common case with a
+ * collation; objects and arrays are left to the collator, and so are symbols, which do not compare
+ * symmetrically with strings.
+ */
+boost::optional<Value> getSpillComparisonKey(const Value& id, const CollatorInterface* collator) {
+    if (!collator) {
+        return id;
+    }
+    switch (id.getType()) {
+        case BSONType::String:
+            return Value(collator->getComparisonKey(id.getStringData()).getKeyData());
+        case BSONType::Object:
+        case BSONType::Array:
+        case BSONType::Symbol:
+            return boost::none;
+        default:
+            return id;
+    }
+}
+
 class SpillSTLComparator {
 public:
     SpillSTLComparator(ValueComparator valueComparator) : _valueComparator(valueComparator) {}
 
-    bool operator()(const GroupsMap::value_type* lhs, const GroupsMap::value_type* rhs) const {
-        return _valueComparator.evaluate(lhs->first < rhs->first);
+    bool operator()(const SpillEntry& lhs, const SpillEntry& rhs) const {
+        if (lhs.comparisonKey && rhs.comparisonKey) {
+            return ValueComparator::kInstance.evaluate(*lhs.comparisonKey < *rhs.comparisonKey);
+        }
+        return _valueComparator.evaluate(lhs.group->first < rhs.group->first);
     }
 
 private:
     ValueComparator _valueComparator;
 };
+
+/**
+ * Returns the partial states of 'accums' in the form they are spilled to disk. This mirrors the
+ * switch in DocumentSourceGroup::spill().
+ */
+Value serializeAccumulatorStates(const DocumentSourceGroup::Accumulators& accums) {
+    switch (accums.size()) {
+        case 0:
+            return Value();
+        case 1:
+            return accums[0]->getValue(/*toBeMerged=*/true);
+        default: {
+            vector<Value> states;
+            states.reserve(accums.size());
+            for (auto&& accum : accums) {
+                states.push_back(accum->getValue(/*toBeMerged=*/true));
+            }
+            return Value(std::move(states));
+        }
+    }
+}
+
+/**
+ * Merges spilled partial states produced by serializeAccumulatorStates() into 'accums'.
+ */
+void mergeAccumulatorStates(const DocumentSourceGroup::Accumulators& accums, const Value& states) {
+    switch (accums.size()) {
+        case 0:
+            break;
+        case 1:
+            accums[0]->process(states, true);
+            break;
+        default: {
+            const vector<Value>& accumulatorStates = states.getArray();
+            for (size_t i = 0; i < accums.size(); i++) {
+                accums[i]->process(accumulatorStates[i], true);
+            }
+        }
+    }
+}
 }  // namespace
 
-DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
+void DocumentSourceGroup::processDocument(Document rootDocument) {
+    processGroupRun(computeId(rootDocument), &rootDocument, &rootDocument + 1);
+}
+
+void DocumentSourceGroup::processDocumentUnwinding(Document rootDocument) {
+    // WARNING: This mirrors the unwinding done by DocumentSourceUnwind, minus 'includeArrayIndex'.
+    std::vector<Position> unwindPathPositions;
+    const Value input = rootDocument.getNestedField(*_unwindPath, &unwindPathPositions);
+    if (input.getType() != Array) {
+        // Nullish values are dropped unless asked to preserve them, anything else passes through.
+        if (!input.nullish() || _unwindSrc->preserveNullAndEmptyArrays()) {
+            processDocument(std::move(rootDocument));
+        }
+        return;
+    }
+
+    const auto& elements = input.getArray();
+    MutableDocument output(std::move(rootDocument));
+    if (elements.empty()) {
+        if (_unwindSrc->preserveNullAndEmptyArrays()) {
+            output.removeNestedField(unwindPathPositions);
+            processDocument(output.freeze());
+        }
+        return;
+    }
+
+    // 'output' only holds the sole reference to its storage once the previous element's document
+    // has been released, so each element is written in place. An accumulator which keeps the
+    // whole document, such as {$push: '$$ROOT'}, makes the next write copy it instead.
+    for (auto&& element : elements) {
+        output.setNestedField(unwindPathPositions, element);
+        processDocument(output.peek());
+    }
+}
+
+void DocumentSourceGroup::processBatch(const std::vector<Document>& batch) {
+    std::vector<Value> ids;
+    ids.reserve(batch.size());
+    for (auto&& doc : batch) {
+        ids.push_back(computeId(doc));
+    }
+
+    const auto& valueComparator = pExpCtx->getValueComparator();
+    size_t runEnd;
+    for (size_t runStart = 0; runStart < batch.size(); runStart = runEnd) {
+        runEnd = runStart + 1;
+        while (runEnd < batch.size() && valueComparator.evaluate(ids[runStart] == ids[runEnd])) {
+            ++runEnd;
+        }
+        processGroupRun(ids[runStart], batch.data() + runStart, batch.data() + runEnd);
+    }
+}
+
+void DocumentSourceGroup::processGroupRun(const Value& id,
+                                          const Document* begin,
+                                          const Document* end) {
     const size_t numAccumulators = _accumulatedFields.size();
 
-    // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'.
-    GetNextResult input = pSource->getNext();
-    for (; input.isAdvanced(); input = pSource->getNext()) {
-        if (_memoryUsageBytes > _maxMemoryUsageBytes) {
-            uassert(16945,
-                    "Exceeded memory limit for $group, but didn't allow external sort."
-                    " Pass allowDiskUse:true to opt in.",
-                    _allowDiskUse);
+    _trackedMemory.set(pExpCtx->opCtx, _memoryUsageBytes);
+
+    if (_memoryUsageBytes > _maxMemoryUsageBytes) {
+        uassert(16945,
+                "Exceeded memory limit for $group, but didn't allow external sort."
+                " Pass allowDiskUse:true to opt in.",
+                _allowDiskUse);
+        if (_partitionedSpill) {
+            spillToPartitions();
+        } else {
             _sortedFiles.push_back(spill());
-            _memoryUsageBytes = 0;
         }
+        _memoryUsageBytes = 0;
+    }
 
-        // We release the result document here so that it does not outlive the end of this loop
-        // iteration. Not releasing could lead to an array copy when this group follows an unwind.
-        auto rootDocument = input.releaseDocument();
-        Value id = computeId(rootDocument);
-
-        // Look for the _id value in the map. If it's not there, add a new entry with a blank
-        // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
-        // looking it up in '_groups' multiple times.
-        const size_t oldSize = _groups->size();
-        vector<intrusive_ptr<Accumulator>>& group = (*_groups)[id];
-        const bool inserted = _groups->size() != oldSize;
-
-        if (inserted) {
-            _memoryUsageBytes += id.getApproximateSize();
-
-            // Add the accumulators
-            group.reserve(numAccumulators);
-            for (auto&& accumulatedField : _accumulatedFields) {
-                group.push_back(accumulatedField.makeAccumulator(pExpCtx));
-            }
+    // Look for the _id value in the map. If it's not there, add a new entry with a blank
+    // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
+    // looking it up in '_groups' multiple times.
+    const size_t oldSize = _groups->size();
+    vector<intrusive_ptr<Accumulator>>& group = (*_groups)[id];
+    const bool inserted = _groups->size() != oldSize;
+
+    if (inserted) {
+        _memoryUsageBytes += id.getApproximateSize();
+
+        // Add the accumulators
+        group.reserve(numAccumulators);
+        for (auto&& accumulatedField : _accumulatedFields) {
+            group.push_back(accumulatedField.makeAccumulator(pExpCtx));
+        }
+    } else {
+        for (auto&& groupObj : group) {
+            // subtract old mem usage. New usage added back after processing.
+            _memoryUsageBytes -= groupObj->memUsageForSorter();
+        }
+    }
+
+    /* tickle all the accumulators for the group we found */
+    dassert(numAccumulators == group.size());
+
+    std::vector<Value> inputs;
+    for (size_t i = 0; i < numAccumulators; i++) {
+        const auto& expression = _accumulatedFields[i].expression;
+        if (end - begin == 1) {
+            group[i]->process(expression->evaluate(*begin), _doingMerge);
         } else {
-            for (auto&& groupObj : group) {
-                // subtract old mem usage. New usage added back after processing.
-                _memoryUsageBytes -= groupObj->memUsageForSorter();
+            inputs.clear();
+            for (auto doc = begin; doc != end; ++doc) {
+                inputs.push_back(expression->evaluate(*doc));
             }
+            group[i]->processBatch(inputs, _doingMerge);
         }
 
-        /* tickle all the accumulators for the group we found */
-        dassert(numAccumulators == group.size());
+        _memoryUsageBytes += group[i]->memUsageForSorter();
+    }
 
-        for (size_t i = 0; i < numAccumulators; i++) {
-            group[i]->process(_accumulatedFields[i].expression->evaluate(rootDocument),
-                              _doingMerge);
+    if (kDebugBuild && !storageGlobalParams.readOnly) {
+        // In debug mode, spill every time we have a duplicate id to stress merge logic.
+        if (!inserted &&           // is a dup
+            !pExpCtx->inMongos &&  // can't spill to disk in mongos
+            !_allowDiskUse &&      // don't change behavior when testing external sort
+            _numSpills < 20) {     // don't open too many FDs
 
-            _memoryUsageBytes += group[i]->memUsageForSorter();
+            if (_partitionedSpill) {
+                spillToPartitions();
+            } else {
+                _sortedFiles.push_back(spill());
+            }
         }
+    }
+}
 
-        if (kDebugBuild && !storageGlobalParams.readOnly) {
-            // In debug mode, spill every time we have a duplicate id to stress merge logic.
-            if (!inserted &&                 // is a dup
-                !pExpCtx->inMongos &&        // can't spill to disk in mongos
-                !_allowDiskUse &&            // don't change behavior when testing external sort
-                _sortedFiles.size() < 20) {  // don't open too many FDs
+DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
+    const size_t numAccumulators = _accumulatedFields.size();
 
-                _sortedFiles.push_back(spill());
-            }
+    // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'. When batching is
+    // enabled the input is pulled a batch at a time to save a getNext() call per stage per
+    // document.
+    GetNextResult::ReturnStatus inputStatus;
+    const size_t batchSize = internalDocumentSourceGroupInputBatchSize.load();
+    if (_unwindSrc) {
+        GetNextResult input = pSource->getNext();
+        for (; input.isAdvanced(); input = pSource->getNext()) {
+            pExpCtx->checkForInterrupt();
+            processDocumentUnwinding(input.releaseDocument());
+        }
+        inputStatus = input.getStatus();
+    } else if (batchSize > 0) {
+        std::vector<Document> batch;
+        batch.reserve(batchSize);
+        do {
+            batch.clear();
+            inputStatus = pSource->getNextBatch(batchSize, &batch);
+            processBatch(batch);
+        } while (inputStatus == GetNextResult::ReturnStatus::kAdvanced);
+    } else {
+        GetNextResult input = pSource->getNext();
+        for (; input.isAdvanced(); input = pSource->getNext()) {
+            // We release the result document here so that it does not outlive the end of this
+            // loop iteration. Not releasing could lead to an array copy when this group follows an
+            // unwind.
+            processDocument(input.releaseDocument());
         }
+        inputStatus = input.getStatus();
     }
 
-    switch (input.getStatus()) {
+    switch (inputStatus) {
         case DocumentSource::GetNextResult::ReturnStatus::kAdvanced: {
             MONGO_UNREACHABLE;  // We consumed all advances above.
         }
         case DocumentSource::GetNextResult::ReturnStatus::kPauseExecution: {
-            return input;  // Propagate pause.
+            return GetNextResult::makePauseExecution();  // Propagate pause.
         }
         case DocumentSource::GetNextResult::ReturnStatus::kEOF: {
+            _trackedMemory.set(pExpCtx->opCtx, _memoryUsageBytes);
+
             // Do any final steps necessary to prepare to output results.
-            if (!_sortedFiles.empty()) {
+            if (_partitionedSpill && _numSpills > 0) {
+                _spilled = true;
+                if (!_groups->empty()) {
+                    spillToPartitions();
+                }
+
+                // Partitions are loaded lazily by getNextPartitioned(), starting from an exhausted
+                // '_groups' map.
+                groupsIterator = _groups->end();
+            } else if (!_sortedFiles.empty()) {
                 _spilled = true;
                 if (!_groups->empty()) {
                     _sortedFiles.push_back(spill());
@@ -554,25 +798,50 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
             // This must happen last so that, unless control gets here, we will re-enter
             // initialization after getting a GetNextResult::ResultState::kPauseExecution.
             _initialized = true;
-            return input;
+            return GetNextResult::makeEOF();
         }
     }
     MONGO_UNREACHABLE;
 }
 
+bool DocumentSourceGroup::absorbUnwind(const intrusive_ptr<DocumentSourceUnwind>& unwind) {
+    // A $group in mongos is split before it runs, and a merging $group reads partial results, so
+    // only fuse where the $group will consume its input directly.
+    if (!internalQueryFuseUnwindIntoGroup.load() || _unwindSrc || _doingMerge ||
+        pExpCtx->inMongos || unwind->indexPath()) {
+        return false;
+    }
+
+    _unwindSrc = unwind;
+    _unwindPath.emplace(unwind->getUnwindPath());
+    return true;
+}
+
 bool DocumentSourceGroup::usedDisk() {
     return _usedDisk;
 }
 
 shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
     _usedDisk = true;
-    vector<const GroupsMap::value_type*> ptrs;  // using pointers to speed sorting
-    ptrs.reserve(_groups->size());
+    ++_numSpills;
+    _spilledRecords += _groups->size();
+    // Using pointers to speed sorting. With a non-simple collation, the comparison keys of the
+    // _ids are computed once here rather than on each of the O(n log n) comparisons.
+    const auto collator = pExpCtx->getCollator();
+    vector<SpillEntry> entries;
+    entries.reserve(_groups->size());
     for (GroupsMap::const_iterator it = _groups->begin(), end = _groups->end(); it != end; ++it) {
-        ptrs.push_back(&*it);
+        entries.push_back({&*it, getSpillComparisonKey(it->first, collator)});
     }
 
-    stable_sort(ptrs.begin(), ptrs.end(), SpillSTLComparator(pExpCtx->getValueComparator()));
+    stable_sort(entries.begin(), entries.end(), SpillSTLComparator(pExpCtx->getValueComparator()));
+
+    vector<const GroupsMap::value_type*> ptrs;
+    ptrs.reserve(entries.size());
+    for (auto&& entry : entries) {
+        ptrs.push_back(entry.group);
+    }
+    entries.clear();
 
     SortedFileWriter<Value, Value> writer(
         SortOptions().TempDir(pExpCtx->tempDir), _fileName, _nextSortedFileWriterOffset);
@@ -604,10 +873,79 @@ shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
     _groups->clear();
 
     Sorter<Value, Value>::Iterator* iteratorPtr = writer.done();
+    _spilledBytes += static_cast<long long>(writer.getFileEndOffset()) - _nextSortedFileWriterOffset;
     _nextSortedFileWriterOffset = writer.getFileEndOffset();
     return shared_ptr<Sorter<Value, Value>::Iterator>(iteratorPtr);
 }
 
+void DocumentSourceGroup::spillToPartitions() {
+    _usedDisk = true;
+    ++_numSpills;
+    _spilledRecords += _groups->size();
+
+    if (_partitionRuns.empty()) {
+        _partitionRuns.resize(internalDocumentSourceGroupSpillPartitions.load());
+    }
+    const size_t numPartitions = _partitionRuns.size();
+
+    // Bucket the groups first so that each partition is written as a single contiguous run.
+    vector<vector<const GroupsMap::value_type*>> partitions(numPartitions);
+    const auto& valueComparator = pExpCtx->getValueComparator();
+    for (auto&& group : *_groups) {
+        partitions[partitionForKey(valueComparator, group.first, numPartitions)].push_back(&group);
+    }
+
+    for (size_t i = 0; i < numPartitions; i++) {
+        if (partitions[i].empty()) {
+            continue;
+        }
+
+        // The runs are not actually sorted; SortedFileWriter is only used for its on-disk format,
+        // and the data is read back in insertion order without going through a merge.
+        SortedFileWriter<Value, Value> writer(
+            SortOptions().TempDir(pExpCtx->tempDir), _fileName, _nextSortedFileWriterOffset);
+        for (auto&& group : partitions[i]) {
+            writer.addAlreadySorted(group->first, serializeAccumulatorStates(group->second));
+        }
+
+        _partitionRuns[i].emplace_back(writer.done());
+        _spilledBytes +=
+            static_cast<long long>(writer.getFileEndOffset()) - _nextSortedFileWriterOffset;
+        _nextSortedFileWriterOffset = writer.getFileEndOffset();
+    }
+
+    _groups->clear();
+}
+
+void DocumentSourceGroup::loadSpilledPartition(size_t partition) {
+    // Note that a whole partition must fit in memory. A partition is expected to be roughly
+    // 1/internalDocumentSourceGroupSpillPartitions of the distinct groups, so this is not bounded
+    // by '_maxMemoryUsageBytes'.
+    _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
+    for (auto&& run : _partitionRuns[partition]) {
+        run->openSource();
+        while (run->more()) {
+            auto data = run->next();
+
+            const size_t oldSize = _groups->size();
+            Accumulators& group = (*_groups)[data.first];
+            if (_groups->size() != oldSize) {
+                group.reserve(_accumulatedFields.size());
+                for (auto&& accumulatedField : _accumulatedFields) {
+                    group.push_back(accumulatedField.makeAccumulator(pExpCtx));
+                }
+            }
+
+            mergeAccumulatorStates(group, data.second);
+        }
+        run->closeSource();
+    }
+
+    // Release the file iterators for this partition now that it has been read.
+    _partitionRuns[partition].clear();
+    groupsIterator = _groups->begin();
+}
+
 Value DocumentSourceGroup::computeId(const Document& root) {
     // If only one expression, return result directly
     if (_idExpressions.size() == 1) {
@@ -727,6 +1065,11 @@ bool DocumentSourceGroup::canRunInParallelBeforeOut(
 
 std::unique_ptr<GroupFromFirstDocumentTransformation>
 DocumentSourceGroup::rewriteGroupAsTransformOnFirstDocument() const {
+    if (_unwindSrc) {
+        // The first document of each group is an unwound document, not an input document.
+        return nullptr;
+    }
+
     if (!_idFieldNames.empty()) {
         // This transformation is only intended for $group stages that group on a single field.
         return nullptr;
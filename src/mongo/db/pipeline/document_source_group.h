@@ -32,9 +32,11 @@
 #include <memory>
 #include <utility>
 
+#include "mongo/db/operation_memory_tracker.h"
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/accumulator.h"
 #include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/transformer_interface.h"
 #include "mongo/db/sorter/sorter.h"
 
@@ -96,6 +98,9 @@ public:
     boost::intrusive_ptr<DocumentSource> optimize() final;
     DepsTracker::State getDependencies(DepsTracker* deps) const final;
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+    void serializeToArray(
+        std::vector<Value>& array,
+        boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
     GetNextResult getNext() final;
     const char* getSourceName() const final;
     GetModPathsReturn getModifiedPaths() const final;
@@ -151,6 +156,13 @@ public:
         _doingMerge = doingMerge;
     }
 
+    /**
+     * Attempts to take over the unwinding done by 'unwind', the $unwind stage immediately preceding
+     * this $group, so that the caller can remove it from the pipeline. Returns false if the $unwind
+     * must stay in the pipeline.
+     */
+    bool absorbUnwind(const boost::intrusive_ptr<DocumentSourceUnwind>& unwind);
+
     /**
      * Returns true if this $group stage used disk during execution and false otherwise.
      */
@@ -182,12 +194,13 @@ private:
     ~DocumentSourceGroup();
 
     /**
-     * getNext() dispatches to one of these three depending on what type of $group it is. These
+     * getNext() dispatches to one of these depending on what type of $group it is. These
      * methods expect '_currentAccumulators' to have been reset before being called, and also expect
      * initialize() to have been called already.
      */
     GetNextResult getNextSpilled();
     GetNextResult getNextStandard();
+    GetNextResult getNextPartitioned();
 
     /**
      * Before returning anything, this source must prepare itself. In a streaming $group,
@@ -201,6 +214,31 @@ private:
      */
     GetNextResult initialize();
 
+    /**
+     * Adds 'rootDocument' to its group, spilling first if the memory limit has been exceeded.
+     */
+    void processDocument(Document rootDocument);
+
+    /**
+     * Adds each document that the absorbed $unwind would have produced from 'rootDocument' to its
+     * group. A single copy of 'rootDocument' is reused, with the unwound field overwritten in place
+     * for each array element.
+     */
+    void processDocumentUnwinding(Document rootDocument);
+
+    /**
+     * Adds the documents of 'batch' to their groups. Runs of consecutive documents with the same
+     * _id look up their group once and feed each accumulator all of their inputs in one
+     * Accumulator::processBatch() call.
+     */
+    void processBatch(const std::vector<Document>& batch);
+
+    /**
+     * Adds the documents in [begin, end), which all have the _id 'id', to their group, spilling
+     * first if the memory limit has been exceeded.
+     */
+    void processGroupRun(const Value& id, const Document* begin, const Document* end);
+
     /**
      * Spill groups map to disk and returns an iterator to the file. Note: Since a sorted $group
      * does not exhaust the previous stage before returning, and thus does not maintain as large a
@@ -208,6 +246,20 @@ private:
      */
     std::shared_ptr<Sorter<Value, Value>::Iterator> spill();
 
+    /**
+     * Alternative to spill() used when partitioned spilling is enabled. Instead of sorting the
+     * groups map, each group is appended to one of '_partitionRuns' based on a hash of its key.
+     * Since equal keys always land in the same partition, each partition can later be
+     * re-aggregated independently in memory without a merge sort.
+     */
+    void spillToPartitions();
+
+    /**
+     * Reads back every run spilled for 'partition', merging the partial accumulator states into a
+     * fresh '_groups' map and positioning 'groupsIterator' at its beginning.
+     */
+    void loadSpilledPartition(size_t partition);
+
     Document makeDocument(const Value& id, const Accumulators& accums, bool mergeableOutput);
 
     /**
@@ -229,8 +281,12 @@ private:
     std::vector<AccumulationStatement> _accumulatedFields;
 
     bool _usedDisk;  // Keeps track of whether this $group spilled to disk.
+    size_t _numSpills = 0;
+    long long _spilledRecords = 0;
+    long long _spilledBytes = 0;
     bool _doingMerge;
     size_t _memoryUsageBytes = 0;
+    TrackedMemoryUsage _trackedMemory;  // Reports '_memoryUsageBytes' to the operation.
     size_t _maxMemoryUsageBytes;
     std::string _fileName;
     unsigned int _nextSortedFileWriterOffset = 0;
@@ -255,11 +311,27 @@ private:
     // Only used when '_spilled' is false.
     GroupsMap::iterator groupsIterator;
 
-    // Only used when '_spilled' is true.
+    // Only used when '_spilled' is true and '_partitionedSpill' is false.
     std::unique_ptr<Sorter<Value, Value>::Iterator> _sorterIterator;
+
+    // When true, spilling hash-partitions the groups instead of writing sorted runs. Latched from
+    // 'internalQueryEnableGroupPartitionedSpill' at construction.
+    const bool _partitionedSpill;
+
+    // Only used when '_partitionedSpill' is true. Holds, for each partition, the file ranges written
+    // to '_fileName' by every spill, and the index of the next partition to load once '_groups'
+    // has been exhausted.
+    std::vector<std::vector<std::shared_ptr<Sorter<Value, Value>::Iterator>>> _partitionRuns;
+    size_t _nextPartition = 0;
+
     const bool _allowDiskUse;
 
     std::pair<Value, Value> _firstPartOfNextGroup;
+
+    // Set if a preceding $unwind was absorbed, in which case initialize() unwinds each input
+    // document itself. The $unwind is kept around to be serialized in front of this stage.
+    boost::intrusive_ptr<DocumentSourceUnwind> _unwindSrc;
+    boost::optional<FieldPath> _unwindPath;
 };
 
 }  // namespace mongo
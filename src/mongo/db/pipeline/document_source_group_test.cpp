@@ -44,16 +44,20 @@
 #include "mongo/db/pipeline/dependencies.h"
 #include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_test_service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/unordered_set.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -98,6 +102,154 @@ TEST_F(DocumentSourceGroupTest, ShouldBeAbleToPauseLoading) {
     ASSERT_DOCUMENT_EQ(result.releaseDocument(), (Document{{"_id", BSONNULL}, {"count", 4}}));
 }
 
+TEST_F(DocumentSourceGroupTest, ShouldBeAbleToPauseLoadingWhenBatchingInput) {
+    const int originalBatchSize = internalDocumentSourceGroupInputBatchSize.load();
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGroupInputBatchSize.store(originalBatchSize); });
+    internalDocumentSourceGroupInputBatchSize.store(2);
+
+    auto expCtx = getExpCtx();
+    expCtx->inMongos = true;  // Disallow external sort.
+                              // This is the only way to do this in a debug build.
+    AccumulationStatement countStatement{"count",
+                                         ExpressionConstant::create(expCtx, Value(1)),
+                                         AccumulationStatement::getFactory("$sum")};
+    auto group = DocumentSourceGroup::create(
+        expCtx, ExpressionConstant::create(expCtx, Value(BSONNULL)), {countStatement});
+    auto mock = DocumentSourceMock::create({Document(),
+                                            DocumentSource::GetNextResult::makePauseExecution(),
+                                            Document(),
+                                            Document(),
+                                            Document(),
+                                            DocumentSource::GetNextResult::makePauseExecution(),
+                                            Document()});
+    group->setSource(mock.get());
+
+    // Documents in a batch cut short by a pause must still be counted.
+    ASSERT_TRUE(group->getNext().isPaused());
+    ASSERT_TRUE(group->getNext().isPaused());
+
+    auto result = group->getNext();
+    ASSERT_TRUE(result.isAdvanced());
+    ASSERT_DOCUMENT_EQ(result.releaseDocument(), (Document{{"_id", BSONNULL}, {"count", 5}}));
+    ASSERT_TRUE(group->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldUnwindInputItselfWhenFusedWithUnwind) {
+    const bool originalFuse = internalQueryFuseUnwindIntoGroup.load();
+    ON_BLOCK_EXIT([&] { internalQueryFuseUnwindIntoGroup.store(originalFuse); });
+    internalQueryFuseUnwindIntoGroup.store(true);
+
+    // Debug builds spill on every duplicate _id.
+    auto expCtx = getExpCtx();
+    TempDir tempDir("DocumentSourceGroupTest");
+    expCtx->tempDir = tempDir.path();
+    VariablesParseState vps = expCtx->variablesParseState;
+    AccumulationStatement countStatement{"count",
+                                         ExpressionConstant::create(expCtx, Value(1)),
+                                         AccumulationStatement::getFactory("$sum")};
+    auto group = DocumentSourceGroup::create(
+        expCtx, ExpressionFieldPath::parse(expCtx, "$tags", vps), {countStatement});
+    ASSERT_FALSE(group->absorbUnwind(
+        DocumentSourceUnwind::create(expCtx, "tags", false, std::string("index"))));
+    ASSERT_TRUE(group->absorbUnwind(DocumentSourceUnwind::create(expCtx, "tags", false, {})));
+
+    auto mock = DocumentSourceMock::create({"{tags: ['a', 'b', 'a']}",
+                                            "{tags: []}",
+                                            "{tags: null}",
+                                            "{tags: 'c'}",
+                                            "{other: 1}",
+                                            "{tags: ['b']}"});
+    group->setSource(mock.get());
+
+    std::map<std::string, int> counts;
+    for (auto next = group->getNext(); next.isAdvanced(); next = group->getNext()) {
+        auto doc = next.releaseDocument();
+        counts[doc["_id"].getString()] = doc["count"].getInt();
+    }
+    ASSERT_EQ(3U, counts.size());
+    ASSERT_EQ(2, counts["a"]);
+    ASSERT_EQ(2, counts["b"]);
+    ASSERT_EQ(1, counts["c"]);
+
+    // The absorbed $unwind is serialized back in front of the $group.
+    std::vector<Value> serialized;
+    group->serializeToArray(serialized);
+    ASSERT_EQ(2U, serialized.size());
+    ASSERT_VALUE_EQ(serialized[0], Value(fromjson("{$unwind: {path: '$tags'}}")));
+}
+
+TEST_F(DocumentSourceGroupTest, FusedUnwindShouldNotAliasDocumentsKeptByAccumulators) {
+    const bool originalFuse = internalQueryFuseUnwindIntoGroup.load();
+    ON_BLOCK_EXIT([&] { internalQueryFuseUnwindIntoGroup.store(originalFuse); });
+    internalQueryFuseUnwindIntoGroup.store(true);
+
+    // Debug builds spill on every duplicate _id.
+    auto expCtx = getExpCtx();
+    TempDir tempDir("DocumentSourceGroupTest");
+    expCtx->tempDir = tempDir.path();
+    VariablesParseState vps = expCtx->variablesParseState;
+    AccumulationStatement pushStatement{"docs",
+                                        ExpressionFieldPath::parse(expCtx, "$$ROOT", vps),
+                                        AccumulationStatement::getFactory("$push")};
+    auto group = DocumentSourceGroup::create(
+        expCtx, ExpressionConstant::create(expCtx, Value(BSONNULL)), {pushStatement});
+    ASSERT_TRUE(group->absorbUnwind(DocumentSourceUnwind::create(expCtx, "a.b", true, {})));
+
+    auto mock = DocumentSourceMock::create({"{_id: 0, a: {b: [1, 2]}}", "{_id: 1, a: {b: []}}"});
+    group->setSource(mock.get());
+
+    auto result = group->getNext();
+    ASSERT_TRUE(result.isAdvanced());
+    ASSERT_VALUE_EQ(result.releaseDocument()["docs"],
+                    Value(BSON_ARRAY(BSON("_id" << 0 << "a" << BSON("b" << 1))
+                                     << BSON("_id" << 0 << "a" << BSON("b" << 2))
+                                     << BSON("_id" << 1 << "a" << BSONObj()))));
+    ASSERT_TRUE(group->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldAccumulateRunsOfEqualIdsWhenBatchingInput) {
+    const int originalBatchSize = internalDocumentSourceGroupInputBatchSize.load();
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGroupInputBatchSize.store(originalBatchSize); });
+    internalDocumentSourceGroupInputBatchSize.store(4);
+
+    auto expCtx = getExpCtx();
+    expCtx->inMongos = true;  // Disallow external sort.
+                              // This is the only way to do this in a debug build.
+    VariablesParseState vps = expCtx->variablesParseState;
+    auto x = ExpressionFieldPath::parse(expCtx, "$x", vps);
+    AccumulationStatement sumStatement{"sum", x, AccumulationStatement::getFactory("$sum")};
+    AccumulationStatement minStatement{"min", x, AccumulationStatement::getFactory("$min")};
+    AccumulationStatement avgStatement{"avg", x, AccumulationStatement::getFactory("$avg")};
+    auto group = DocumentSourceGroup::create(expCtx,
+                                             ExpressionFieldPath::parse(expCtx, "$a", vps),
+                                             {sumStatement, minStatement, avgStatement});
+
+    // Runs of equal _ids span batch boundaries and mix numeric and non-numeric inputs.
+    auto mock = DocumentSourceMock::create({Document{{"a", 1}, {"x", 4}},
+                                            Document{{"a", 1LL}, {"x", 2}},
+                                            Document{{"a", 1.0}, {"x", 6}},
+                                            Document{{"a", 2}, {"x", 1.5}},
+                                            Document{{"a", 2}, {"x", 0.5}},
+                                            Document{{"a", 2}, {"x", "str"_sd}},
+                                            Document{{"a", 1}, {"x", 8LL}},
+                                            Document{{"a", 3}, {"x", 1}}});
+    group->setSource(mock.get());
+
+    std::map<int, Document> results;
+    for (auto next = group->getNext(); next.isAdvanced(); next = group->getNext()) {
+        auto doc = next.releaseDocument();
+        results[doc["_id"].coerceToInt()] = doc;
+    }
+    ASSERT_EQ(3U, results.size());
+    ASSERT_VALUE_EQ(Value(20LL), results[1]["sum"]);
+    ASSERT_VALUE_EQ(Value(2), results[1]["min"]);
+    ASSERT_VALUE_EQ(Value(5.0), results[1]["avg"]);
+    ASSERT_VALUE_EQ(Value(2.0), results[2]["sum"]);
+    ASSERT_VALUE_EQ(Value(0.5), results[2]["min"]);
+    ASSERT_VALUE_EQ(Value(1.0), results[2]["avg"]);
+    ASSERT_VALUE_EQ(Value(1), results[3]["sum"]);
+}
+
 TEST_F(DocumentSourceGroupTest, ShouldBeAbleToPauseLoadingWhileSpilled) {
     auto expCtx = getExpCtx();
 
@@ -140,6 +292,129 @@ TEST_F(DocumentSourceGroupTest, ShouldBeAbleToPauseLoadingWhileSpilled) {
     ASSERT_EQ(idSet.count(2), 1UL);
 }
 
+TEST_F(DocumentSourceGroupTest, ShouldMergeGroupsAcrossHashPartitionedSpills) {
+    auto expCtx = getExpCtx();
+
+    const bool originalPartitionedSpill = internalQueryEnableGroupPartitionedSpill.load();
+    const int originalSpillPartitions = internalDocumentSourceGroupSpillPartitions.load();
+    ON_BLOCK_EXIT([&] {
+        internalQueryEnableGroupPartitionedSpill.store(originalPartitionedSpill);
+        internalDocumentSourceGroupSpillPartitions.store(originalSpillPartitions);
+    });
+    internalQueryEnableGroupPartitionedSpill.store(true);
+    internalDocumentSourceGroupSpillPartitions.store(4);
+
+    // Allow the $group stage to spill to disk.
+    TempDir tempDir("DocumentSourceGroupTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+    const size_t maxMemoryUsageBytes = 1000;
+
+    VariablesParseState vps = expCtx->variablesParseState;
+    AccumulationStatement countStatement{"count",
+                                         ExpressionConstant::create(expCtx, Value(1)),
+                                         AccumulationStatement::getFactory("$sum")};
+    AccumulationStatement pushStatement{"spaceHog",
+                                        ExpressionFieldPath::parse(expCtx, "$largeStr", vps),
+                                        AccumulationStatement::getFactory("$push")};
+    auto groupByExpression = ExpressionFieldPath::parse(expCtx, "$_id", vps);
+    auto group = DocumentSourceGroup::create(
+        expCtx, groupByExpression, {countStatement, pushStatement}, maxMemoryUsageBytes);
+
+    // Every key appears in several spills, so each group must be put back together from partial
+    // states read from different runs of the same partition.
+    const int numKeys = 10;
+    const int numCopies = 3;
+    string largeStr(maxMemoryUsageBytes / 4, 'x');
+    deque<DocumentSource::GetNextResult> inputs;
+    for (int copy = 0; copy < numCopies; ++copy) {
+        for (int key = 0; key < numKeys; ++key) {
+            inputs.emplace_back(Document{{"_id", key}, {"largeStr", largeStr}});
+        }
+    }
+    auto mock = DocumentSourceMock::create(inputs);
+    group->setSource(mock.get());
+
+    map<int, int> counts;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        auto doc = result.releaseDocument();
+        ASSERT_EQ(doc["spaceHog"].getArrayLength(), static_cast<size_t>(numCopies));
+        counts[doc["_id"].coerceToInt()] += doc["count"].coerceToInt();
+    }
+    ASSERT_TRUE(group->getNext().isEOF());
+
+    ASSERT_EQ(counts.size(), static_cast<size_t>(numKeys));
+    for (auto&& count : counts) {
+        ASSERT_EQ(count.second, numCopies);
+    }
+
+    ASSERT_TRUE(group->usedDisk());
+    vector<Value> explained;
+    group->serializeToArray(explained, ExplainOptions::Verbosity::kExecStats);
+    ASSERT_EQ(explained.size(), 1UL);
+    ASSERT_VALUE_EQ(explained[0]["usedDisk"], Value(true));
+    ASSERT_GT(explained[0]["spills"].getLong(), 1LL);
+    ASSERT_GT(explained[0]["spilledRecords"].getLong(), 0LL);
+    ASSERT_GT(explained[0]["spilledBytes"].getLong(), 0LL);
+}
+
+TEST_F(DocumentSourceGroupTest, ShouldMergeSpilledGroupsWhoseIdsAreEqualUnderTheCollation) {
+    auto expCtx = getExpCtx();
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    expCtx->setCollator(&collator);
+
+    // Allow the $group stage to spill to disk.
+    TempDir tempDir("DocumentSourceGroupTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+    const size_t maxMemoryUsageBytes = 1000;
+
+    VariablesParseState vps = expCtx->variablesParseState;
+    AccumulationStatement countStatement{"count",
+                                         ExpressionConstant::create(expCtx, Value(1)),
+                                         AccumulationStatement::getFactory("$sum")};
+    AccumulationStatement pushStatement{"spaceHog",
+                                        ExpressionFieldPath::parse(expCtx, "$largeStr", vps),
+                                        AccumulationStatement::getFactory("$push")};
+    auto groupByExpression = ExpressionFieldPath::parse(expCtx, "$_id", vps);
+    auto group = DocumentSourceGroup::create(
+        expCtx, groupByExpression, {countStatement, pushStatement}, maxMemoryUsageBytes);
+
+    // Each key appears in upper and lower case, in separate spills, along with a few non-string
+    // keys which are sorted without comparison keys.
+    string largeStr(maxMemoryUsageBytes / 4, 'x');
+    deque<DocumentSource::GetNextResult> inputs;
+    for (auto&& id : {"b", "C", "a", "D"}) {
+        inputs.emplace_back(Document{{"_id", id}, {"largeStr", largeStr}});
+    }
+    inputs.emplace_back(Document{{"_id", 1}, {"largeStr", largeStr}});
+    inputs.emplace_back(Document{{"_id", Document{{"x", "Y"_sd}}}, {"largeStr", largeStr}});
+    for (auto&& id : {"A", "d", "B", "c"}) {
+        inputs.emplace_back(Document{{"_id", id}, {"largeStr", largeStr}});
+    }
+    inputs.emplace_back(Document{{"_id", Document{{"x", "y"_sd}}}, {"largeStr", largeStr}});
+    auto mock = DocumentSourceMock::create(inputs);
+    group->setSource(mock.get());
+
+    // Sorted spills are merged in collation order.
+    vector<Value> ids;
+    for (auto result = group->getNext(); result.isAdvanced(); result = group->getNext()) {
+        auto doc = result.releaseDocument();
+        ASSERT_EQ(doc["count"].coerceToInt(), doc["_id"].numeric() ? 1 : 2);
+        ids.push_back(doc["_id"]);
+    }
+    ASSERT_TRUE(group->getNext().isEOF());
+    ASSERT_TRUE(group->usedDisk());
+
+    ASSERT_EQ(ids.size(), 6UL);
+    ASSERT_VALUE_EQ(ids[0], Value(1));
+    for (size_t i = 1; i < 5; ++i) {
+        ASSERT_EQ(ids[i].getType(), BSONType::String);
+        ASSERT_EQ(collator.compare(ids[i].getString(), string(1, 'a' + i - 1)), 0);
+    }
+    ASSERT_EQ(ids[5].getType(), BSONType::Object);
+}
+
 TEST_F(DocumentSourceGroupTest, ShouldErrorIfNotAllowedToSpillToDiskAndResultSetIsTooLarge) {
     auto expCtx = getExpCtx();
     const size_t maxMemoryUsageBytes = 1000;
@@ -0,0 +1,294 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_internal_unpack_bucket.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/util/column_codec.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_match.h"
+#include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+REGISTER_DOCUMENT_SOURCE(_internalUnpackBucket,
+                         LiteParsedDocumentSourceDefault::parse,
+                         DocumentSourceInternalUnpackBucket::createFromBson);
+
+constexpr StringData DocumentSourceInternalUnpackBucket::kStageName;
+constexpr StringData DocumentSourceInternalUnpackBucket::kTimeFieldName;
+constexpr StringData DocumentSourceInternalUnpackBucket::kMetaFieldName;
+constexpr StringData DocumentSourceInternalUnpackBucket::kBucketControlMinFieldName;
+constexpr StringData DocumentSourceInternalUnpackBucket::kBucketControlMaxFieldName;
+constexpr StringData DocumentSourceInternalUnpackBucket::kBucketMetaFieldName;
+constexpr StringData DocumentSourceInternalUnpackBucket::kBucketDataFieldName;
+
+DocumentSourceInternalUnpackBucket::DocumentSourceInternalUnpackBucket(
+    const intrusive_ptr<ExpressionContext>& expCtx,
+    std::string timeField,
+    boost::optional<std::string> metaField)
+    : DocumentSource(expCtx), _timeField(std::move(timeField)), _metaField(std::move(metaField)) {}
+
+intrusive_ptr<DocumentSourceInternalUnpackBucket> DocumentSourceInternalUnpackBucket::create(
+    const intrusive_ptr<ExpressionContext>& expCtx,
+    std::string timeField,
+    boost::optional<std::string> metaField) {
+    return new DocumentSourceInternalUnpackBucket(
+        expCtx, std::move(timeField), std::move(metaField));
+}
+
+intrusive_ptr<DocumentSource> DocumentSourceInternalUnpackBucket::createFromBson(
+    BSONElement elem, const intrusive_ptr<ExpressionContext>& expCtx) {
+    uassert(ErrorCodes::FailedToParse,
+            str::stream() << kStageName << " specification must be an object, found "
+                          << typeName(elem.type()),
+            elem.type() == Object);
+
+    std::string timeField;
+    boost::optional<std::string> metaField;
+    for (auto&& option : elem.embeddedObject()) {
+        const auto optionName = option.fieldNameStringData();
+        uassert(ErrorCodes::FailedToParse,
+                str::stream() << "unrecognized option to " << kStageName << ": " << optionName,
+                optionName == kTimeFieldName || optionName == kMetaFieldName);
+
+        const auto fieldName = option.type() == String ? option.valueStringData() : ""_sd;
+        uassert(ErrorCodes::FailedToParse,
+                str::stream() << kStageName << " '" << optionName
+                              << "' must name a top-level field, found: " << option.toString(),
+                !fieldName.empty() && fieldName[0] != '$' &&
+                    fieldName.find('.') == std::string::npos);
+        if (optionName == kTimeFieldName) {
+            timeField = fieldName.toString();
+        } else {
+            metaField = fieldName.toString();
+        }
+    }
+
+    uassert(ErrorCodes::FailedToParse,
+            str::stream() << kStageName << " requires '" << kTimeFieldName << "'",
+            !timeField.empty());
+    uassert(ErrorCodes::FailedToParse,
+            str::stream() << kStageName << " '" << kTimeFieldName << "' and '" << kMetaFieldName
+                          << "' must differ",
+            !metaField || timeField != *metaField);
+
+    return create(expCtx, std::move(timeField), std::move(metaField));
+}
+
+Value DocumentSourceInternalUnpackBucket::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    MutableDocument spec;
+    spec.addField(kTimeFieldName, Value(_timeField));
+    if (_metaField) {
+        spec.addField(kMetaFieldName, Value(*_metaField));
+    }
+    return Value(DOC(getSourceName() << spec.freeze()));
+}
+
+DocumentSource::GetNextResult DocumentSourceInternalUnpackBucket::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    while (_columns.empty() || !_columns[_timeColumn].next) {
+        auto nextInput = pSource->getNext();
+        if (!nextInput.isAdvanced()) {
+            return nextInput;
+        }
+        resetBucket(nextInput.releaseDocument());
+    }
+
+    return nextMeasurement();
+}
+
+void DocumentSourceInternalUnpackBucket::resetBucket(const Document& bucket) {
+    _columns.clear();
+    _meta = _metaField ? bucket[kBucketMetaFieldName] : Value();
+
+    const Value data = bucket[kBucketDataFieldName];
+    uassert(ErrorCodes::BadValue,
+            str::stream() << "time-series bucket '" << kBucketDataFieldName
+                          << "' must be an object, found: " << typeName(data.getType()),
+            data.getType() == Object);
+
+    boost::optional<size_t> timeColumn;
+    for (auto columns = data.getDocument().fieldIterator(); columns.more();) {
+        const auto column = columns.next();
+        const bool isCompressed = column.second.getType() == BinData &&
+            column.second.getBinData().type == BinDataType::Column;
+        uassert(ErrorCodes::BadValue,
+                str::stream() << "time-series bucket data column '" << column.first
+                              << "' must be an object or a compressed column, found: "
+                              << typeName(column.second.getType()),
+                column.second.getType() == Object || isCompressed);
+        uassert(ErrorCodes::BadValue,
+                str::stream() << "time-series bucket data must not hold the meta field '"
+                              << column.first << "'",
+                !_metaField || column.first != *_metaField);
+
+        if (column.first == _timeField) {
+            timeColumn = _columns.size();
+        }
+        if (isCompressed) {
+            const auto binData = column.second.getBinData();
+            _columns.emplace_back(column.first,
+                                  Document(uassertStatusOK(column_codec::decode(ConstDataRange(
+                                      static_cast<const char*>(binData.data), binData.length)))));
+        } else {
+            _columns.emplace_back(column.first, column.second.getDocument());
+        }
+        if (_columns.back().it.more()) {
+            _columns.back().next = _columns.back().it.next();
+        }
+    }
+
+    uassert(ErrorCodes::BadValue,
+            str::stream() << "time-series bucket data is missing the time field '" << _timeField
+                          << "'",
+            timeColumn);
+    _timeColumn = *timeColumn;
+}
+
+Document DocumentSourceInternalUnpackBucket::nextMeasurement() {
+    // The time column holds every position, so its next entry names the next measurement. Other
+    // columns only contribute a field if their next entry is at the same position.
+    const StringData position = _columns[_timeColumn].next->first;
+
+    MutableDocument measurement(_columns.size() + 1);
+    for (auto&& column : _columns) {
+        if (!column.next || column.next->first != position) {
+            continue;
+        }
+        measurement.addField(column.fieldName, column.next->second);
+        if (column.it.more()) {
+            column.next = column.it.next();
+        } else {
+            column.next = boost::none;
+        }
+    }
+
+    if (!_meta.missing()) {
+        measurement.addField(*_metaField, _meta);
+    }
+
+    // Once the last measurement is unpacked, every column must have been consumed entirely.
+    if (!_columns[_timeColumn].next) {
+        for (auto&& column : _columns) {
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "time-series bucket data column '" << column.fieldName
+                                  << "' holds position '" << column.next->first
+                                  << "', which has no time or is out of order",
+                    !column.next);
+        }
+    }
+
+    return measurement.freeze();
+}
+
+boost::optional<BSONObj> DocumentSourceInternalUnpackBucket::createBucketLevelPredicate(
+    const BSONObj& query) const {
+    const std::string minTimePath = str::stream() << kBucketControlMinFieldName << "."
+                                                  << _timeField;
+    const std::string maxTimePath = str::stream() << kBucketControlMaxFieldName << "."
+                                                  << _timeField;
+
+    BSONArrayBuilder predicates;
+    auto addPredicate = [&](const std::string& path, StringData op, const BSONElement& value) {
+        BSONObjBuilder predicate(predicates.subobjStart());
+        BSONObjBuilder condition(predicate.subobjStart(path));
+        condition.appendAs(value, op);
+    };
+    auto addTimePredicate = [&](StringData op, const BSONElement& value) {
+        // Only compare against dates, which is what the bounds in 'control' are.
+        if (value.type() != Date) {
+            return;
+        }
+
+        // A bucket can hold a measurement with a time after 'value' only if its latest time is
+        // after 'value', and similarly for the other comparisons.
+        if (op == "$gt"_sd || op == "$gte"_sd) {
+            addPredicate(maxTimePath, op, value);
+        } else if (op == "$lt"_sd || op == "$lte"_sd) {
+            addPredicate(minTimePath, op, value);
+        } else if (op == "$eq"_sd) {
+            addPredicate(minTimePath, "$lte"_sd, value);
+            addPredicate(maxTimePath, "$gte"_sd, value);
+        }
+    };
+
+    for (auto&& elem : query) {
+        const auto path = elem.fieldNameStringData();
+        if (path == _timeField) {
+            if (elem.type() == Object) {
+                for (auto&& op : elem.embeddedObject()) {
+                    addTimePredicate(op.fieldNameStringData(), op);
+                }
+            } else {
+                addTimePredicate("$eq"_sd, elem);
+            }
+        } else if (_metaField && (path == *_metaField || path.startsWith(*_metaField + "."))) {
+            // All measurements of a bucket share its meta, so the predicate applies unchanged.
+            BSONObjBuilder predicate(predicates.subobjStart());
+            predicate.appendAs(elem,
+                               std::string(str::stream() << kBucketMetaFieldName
+                                                         << path.substr(_metaField->size())));
+        }
+    }
+
+    if (predicates.arrSize() == 0) {
+        return boost::none;
+    }
+    return BSON("$and" << predicates.arr());
+}
+
+Pipeline::SourceContainer::iterator DocumentSourceInternalUnpackBucket::doOptimizeAt(
+    Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
+    invariant(*itr == this);
+
+    auto nextMatch = dynamic_cast<DocumentSourceMatch*>((*std::next(itr)).get());
+    if (!nextMatch || _triedBucketLevelPushdown) {
+        return std::next(itr);
+    }
+    _triedBucketLevelPushdown = true;
+
+    auto bucketLevelPredicate = createBucketLevelPredicate(nextMatch->getQuery());
+    if (!bucketLevelPredicate) {
+        return std::next(itr);
+    }
+
+    // The original $match stays in place to filter the unpacked measurements. Optimize from the
+    // new $match, which may be able to combine with the stages before it.
+    return container->insert(itr, DocumentSourceMatch::create(*bucketLevelPredicate, pExpCtx));
+}
+
+}  // namespace mongo
@@ -0,0 +1,157 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/db/pipeline/document_source.h"
+
+namespace mongo {
+
+/**
+ * Unpacks time-series bucket documents into the individual measurements they hold. A bucket has
+ * the form
+ *
+ *   {_id: ..., control: {min: {<time>: ..., ...}, max: {<time>: ..., ...}}, meta: <meta>,
+ *    data: {<time>: {'0': <time0>, '1': <time1>, ...}, <field>: {'0': <value0>, ...}, ...}}
+ *
+ * where each field of 'data' is a column holding the values of one measurement field, keyed by the
+ * measurement's position in the bucket. Every measurement has a time, so the time column lists
+ * every position, while other columns may omit positions for measurements missing that field. All
+ * columns list their positions in the same order. 'control.min' and 'control.max' hold the
+ * smallest and largest time in the bucket, and 'meta', if present, is shared by all measurements.
+ * A column may instead be stored compressed, as BinData of subtype BinDataType::Column holding the
+ * column object encoded by column_codec::encode().
+ *
+ * The stage is spelled {$_internalUnpackBucket: {timeField: <name>, metaField: <name>}}, where
+ * 'metaField' is optional and names the field that the bucket's 'meta' is unpacked into.
+ */
+class DocumentSourceInternalUnpackBucket final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$_internalUnpackBucket"_sd;
+    static constexpr StringData kTimeFieldName = "timeField"_sd;
+    static constexpr StringData kMetaFieldName = "metaField"_sd;
+
+    static constexpr StringData kBucketControlMinFieldName = "control.min"_sd;
+    static constexpr StringData kBucketControlMaxFieldName = "control.max"_sd;
+    static constexpr StringData kBucketMetaFieldName = "meta"_sd;
+    static constexpr StringData kBucketDataFieldName = "data"_sd;
+
+    static boost::intrusive_ptr<DocumentSourceInternalUnpackBucket> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        std::string timeField,
+        boost::optional<std::string> metaField);
+
+    static boost::intrusive_ptr<DocumentSource> createFromBson(
+        BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    const char* getSourceName() const final {
+        return kStageName.rawData();
+    }
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        return {StreamType::kStreaming,
+                PositionRequirement::kNone,
+                HostTypeRequirement::kNone,
+                DiskUseRequirement::kNoDiskUse,
+                FacetRequirement::kAllowed,
+                TransactionRequirement::kAllowed};
+    }
+
+    boost::optional<MergingLogic> mergingLogic() final {
+        return boost::none;
+    }
+
+    DepsTracker::State getDependencies(DepsTracker* deps) const final {
+        // Measurements are built from the whole bucket, and none of the bucket's fields or
+        // metadata pass through unchanged.
+        deps->needWholeDocument = true;
+        return DepsTracker::State::EXHAUSTIVE_ALL;
+    }
+
+    GetNextResult getNext() final;
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    /**
+     * Translates the predicates of 'query' on the time and meta fields of the measurements into
+     * predicates on the bucket documents, which match every bucket holding a measurement that
+     * matches 'query' but may match other buckets too. Returns boost::none if 'query' has no such
+     * predicates.
+     */
+    boost::optional<BSONObj> createBucketLevelPredicate(const BSONObj& query) const;
+
+    /**
+     * If followed by a $match, places a $match on the equivalent bucket-level predicates in front
+     * of this stage, so that buckets which cannot hold a matching measurement are filtered out
+     * before being unpacked, possibly using an index on the bucket collection.
+     */
+    Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
+                                                     Pipeline::SourceContainer* container) final;
+
+private:
+    DocumentSourceInternalUnpackBucket(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                       std::string timeField,
+                                       boost::optional<std::string> metaField);
+
+    /**
+     * Prepares to unpack the measurements of 'bucket'.
+     */
+    void resetBucket(const Document& bucket);
+
+    /**
+     * Returns the next measurement of the current bucket, which must have one.
+     */
+    Document nextMeasurement();
+
+    // A column of the current bucket's 'data', positioned at its next unconsumed entry.
+    struct Column {
+        Column(StringData fieldName, const Document& values)
+            : fieldName(fieldName.toString()), it(values) {}
+
+        std::string fieldName;
+        FieldIterator it;
+        boost::optional<Document::FieldPair> next;
+    };
+
+    const std::string _timeField;
+    const boost::optional<std::string> _metaField;
+
+    // State of the bucket being unpacked. '_timeColumn' indexes into '_columns'.
+    std::vector<Column> _columns;
+    size_t _timeColumn = 0;
+    Value _meta;
+
+    // Whether doOptimizeAt() has already considered pushing a $match in front of this stage.
+    bool _triedBucketLevelPushdown = false;
+};
+
+}  // namespace mongo
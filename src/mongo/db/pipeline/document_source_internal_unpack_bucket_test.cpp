@@ -0,0 +1,220 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/bson/json.h"
+#include "mongo/bson/util/column_codec.h"
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_internal_unpack_bucket.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using boost::intrusive_ptr;
+
+using DocumentSourceInternalUnpackBucketTest = AggregationContextFixture;
+
+const BSONObj kMeasurementMeta = fromjson("{sensor: 'a'}");
+
+intrusive_ptr<DocumentSource> parseStage(const intrusive_ptr<ExpressionContext>& expCtx,
+                                         const BSONObj& spec) {
+    return DocumentSourceInternalUnpackBucket::createFromBson(spec.firstElement(), expCtx);
+}
+
+TEST_F(DocumentSourceInternalUnpackBucketTest, UnpacksMeasurementsFromSparseColumns) {
+    const auto spec = fromjson("{$_internalUnpackBucket: {timeField: 't', metaField: 'm'}}");
+    auto unpack = parseStage(getExpCtx(), spec);
+    auto mock = DocumentSourceMock::create(
+        {"{_id: 1, meta: {sensor: 'a'}, data: {t: {'0': 1, '1': 2, '2': 3}, x: {'0': 1, '2': 3}}}",
+         "{_id: 2, data: {t: {'0': 4}, y: {'0': 'foo'}}}"});
+    unpack->setSource(mock.get());
+
+    auto next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (DOC("t" << 1 << "x" << 1 << "m" << kMeasurementMeta)));
+    next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), (DOC("t" << 2 << "m" << kMeasurementMeta)));
+    next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (DOC("t" << 3 << "x" << 3 << "m" << kMeasurementMeta)));
+
+    // A bucket without a meta produces measurements without the meta field.
+    next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), Document(fromjson("{t: 4, y: 'foo'}")));
+    ASSERT_TRUE(unpack->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceInternalUnpackBucketTest, SkipsEmptyBucketsAndPropagatesPauses) {
+    auto unpack = parseStage(getExpCtx(), fromjson("{$_internalUnpackBucket: {timeField: 't'}}"));
+    auto mock = DocumentSourceMock::create(
+        {Document(fromjson("{data: {t: {}}}")),
+         DocumentSource::GetNextResult::makePauseExecution(),
+         Document(fromjson("{meta: 'ignored', data: {t: {'0': 1}}}"))});
+    unpack->setSource(mock.get());
+
+    ASSERT_TRUE(unpack->getNext().isPaused());
+    auto next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), Document(fromjson("{t: 1}")));
+    ASSERT_TRUE(unpack->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceInternalUnpackBucketTest, UnpacksCompressedColumns) {
+    BSONObjBuilder bucket;
+    {
+        BSONObjBuilder data(bucket.subobjStart("data"));
+        column_codec::appendEncoded(fromjson("{'0': 1, '1': 2, '2': 3}"), "t", &data);
+        data.append("x", fromjson("{'1': 'foo'}"));
+        column_codec::appendEncoded(fromjson("{'0': 1.5, '2': 2.5}"), "y", &data);
+    }
+    auto unpack = parseStage(getExpCtx(), fromjson("{$_internalUnpackBucket: {timeField: 't'}}"));
+    auto mock = DocumentSourceMock::create(Document(bucket.obj()));
+    unpack->setSource(mock.get());
+
+    auto next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), Document(fromjson("{t: 1, y: 1.5}")));
+    next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), Document(fromjson("{t: 2, x: 'foo'}")));
+    next = unpack->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), Document(fromjson("{t: 3, y: 2.5}")));
+    ASSERT_TRUE(unpack->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceInternalUnpackBucketTest, RejectsMalformedCompressedColumns) {
+    const char malformed[] = {1, NumberInt, 2};
+    const auto bucket =
+        BSON("data" << BSON("t" << BSONBinData(malformed, sizeof(malformed), BinDataType::Column)));
+    auto unpack = parseStage(getExpCtx(), fromjson("{$_internalUnpackBucket: {timeField: 't'}}"));
+    auto mock = DocumentSourceMock::create(Document(bucket));
+    unpack->setSource(mock.get());
+    ASSERT_THROWS_CODE(unpack->getNext(), AssertionException, ErrorCodes::BadValue);
+
+    // BinData of other subtypes is not a column.
+    const auto general =
+        BSON("data" << BSON("t" << BSONBinData(malformed, sizeof(malformed), BinDataGeneral)));
+    unpack = parseStage(getExpCtx(), fromjson("{$_internalUnpackBucket: {timeField: 't'}}"));
+    mock = DocumentSourceMock::create(Document(general));
+    unpack->setSource(mock.get());
+    ASSERT_THROWS_CODE(unpack->getNext(), AssertionException, ErrorCodes::BadValue);
+}
+
+TEST_F(DocumentSourceInternalUnpackBucketTest, RejectsMalformedBuckets) {
+    const auto spec = fromjson("{$_internalUnpackBucket: {timeField: 't'}}");
+    for (auto&& bucket : {"{data: {x: {'0': 1}}}",
+                          "{data: 'str'}",
+                          "{data: {t: {'0': 1}, x: 1}}",
+                          "{data: {t: {'0': 1}, x: {'5': 1}}}"}) {
+        auto unpack = parseStage(getExpCtx(), spec);
+        auto mock = DocumentSourceMock::create(bucket);
+        unpack->setSource(mock.get());
+        ASSERT_THROWS_CODE(unpack->getNext(), AssertionException, ErrorCodes::BadValue);
+    }
+}
+
+TEST_F(DocumentSourceInternalUnpackBucketTest, ParsesAndSerializesSpec) {
+    auto spec = fromjson("{$_internalUnpackBucket: {timeField: 't', metaField: 'm'}}");
+    std::vector<Value> serialized;
+    parseStage(getExpCtx(), spec)->serializeToArray(serialized);
+    ASSERT_EQ(1U, serialized.size());
+    ASSERT_VALUE_EQ(Value(spec), serialized[0]);
+
+    for (auto&& badSpec : {"{$_internalUnpackBucket: 't'}",
+                           "{$_internalUnpackBucket: {}}",
+                           "{$_internalUnpackBucket: {metaField: 'm'}}",
+                           "{$_internalUnpackBucket: {timeField: 'a.b'}}",
+                           "{$_internalUnpackBucket: {timeField: 1}}",
+                           "{$_internalUnpackBucket: {timeField: 't', metaField: 't'}}",
+                           "{$_internalUnpackBucket: {timeField: 't', other: 1}}"}) {
+        ASSERT_THROWS_CODE(parseStage(getExpCtx(), fromjson(badSpec)),
+                           AssertionException,
+                           ErrorCodes::FailedToParse);
+    }
+}
+
+TEST_F(DocumentSourceInternalUnpackBucketTest, CreatesBucketLevelPredicateOnTimeAndMeta) {
+    auto unpack = DocumentSourceInternalUnpackBucket::create(getExpCtx(), "t", std::string("m"));
+    const auto date = Date_t::fromMillisSinceEpoch(1000);
+
+    ASSERT_BSONOBJ_EQ(
+        BSON("$and" << BSON_ARRAY(BSON("control.max.t" << BSON("$gt" << date))
+                                  << BSON("control.min.t" << BSON("$lte" << date))
+                                  << BSON("meta.sensor"
+                                          << "a"))),
+        *unpack->createBucketLevelPredicate(BSON("t" << BSON("$gt" << date << "$lte" << date)
+                                                     << "x" << 5 << "m.sensor"
+                                                     << "a")));
+    ASSERT_BSONOBJ_EQ(BSON("$and" << BSON_ARRAY(BSON("control.min.t" << BSON("$lte" << date))
+                                                << BSON("control.max.t" << BSON("$gte" << date)))),
+                      *unpack->createBucketLevelPredicate(BSON("t" << date)));
+
+    // Predicates on other fields, and time comparisons against non-dates, cannot be pushed down.
+    ASSERT_FALSE(unpack->createBucketLevelPredicate(BSON("x" << 5)).is_initialized());
+    ASSERT_FALSE(
+        unpack->createBucketLevelPredicate(BSON("t" << BSON("$gt" << 5))).is_initialized());
+    ASSERT_FALSE(unpack->createBucketLevelPredicate(BSON("mm" << 5)).is_initialized());
+}
+
+TEST_F(DocumentSourceInternalUnpackBucketTest, OptimizeInsertsBucketLevelMatchOnce) {
+    const auto date = Date_t::fromMillisSinceEpoch(1000);
+    std::vector<BSONObj> rawPipeline = {
+        fromjson("{$_internalUnpackBucket: {timeField: 't'}}"),
+        BSON("$match" << BSON("t" << BSON("$gte" << date)))};
+    auto pipeline = uassertStatusOK(Pipeline::parse(rawPipeline, getExpCtx()));
+    pipeline->optimizePipeline();
+    pipeline->optimizePipeline();
+
+    auto serialized = pipeline->serialize();
+    ASSERT_EQ(3U, serialized.size());
+    ASSERT_VALUE_EQ(Value(fromjson("{$_internalUnpackBucket: {timeField: 't'}}")), serialized[1]);
+    ASSERT_VALUE_EQ(Value(rawPipeline[1]), serialized[2]);
+
+    auto bucketMatch = serialized[0]["$match"];
+    ASSERT_EQ(Object, bucketMatch.getType()) << serialized[0].toString();
+    ASSERT_TRUE(bucketMatch.getDocument().toBson().toString().find("control.max.t") !=
+                std::string::npos)
+        << serialized[0].toString();
+}
+
+}  // namespace
+}  // namespace mongo
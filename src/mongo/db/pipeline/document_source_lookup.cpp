@@ -34,6 +34,8 @@
 #include "mongo/base/init.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression_algo.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_path_support.h"
 #include "mongo/db/pipeline/expression.h"
@@ -41,6 +43,7 @@
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/str.h"
 
 namespace mongo {
 
@@ -184,9 +187,7 @@ StageConstraints DocumentSourceLookUp::constraints(Pipeline::SplitState) const {
         ? HostTypeRequirement::kNone
         : HostTypeRequirement::kPrimaryShard;
 
-    const bool foreignShardedAllowed =
-        getTestCommandsEnabled() && internalQueryAllowShardedLookup.load();
-    if (!foreignShardedAllowed) {
+    if (!internalQueryAllowShardedLookup.load()) {
         // Always run on the primary shard.
         hostRequirement = HostTypeRequirement::kPrimaryShard;
     }
@@ -223,6 +224,85 @@ BSONObj buildEqualityOrQuery(const std::string& fieldName, const BSONArray& valu
     return orBuilder.obj();
 }
 
+/**
+ * Returns true if any component of 'path' is numeric. The query system may interpret such a
+ * component either as an array position or as a field name, so we do not attempt to compute hash
+ * join keys for these paths.
+ */
+bool hasNumericPathComponent(const FieldPath& path) {
+    for (size_t i = 0; i < path.getPathLength(); ++i) {
+        if (str::parseUnsignedBase10Integer(path.getFieldName(i))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Invokes 'callback' for every value which an equality predicate on 'path' could match in
+ * 'current', the value found at the first 'index' components of 'path'. Arrays at the end of the
+ * path produce both the array itself and each of its elements, mirroring the semantics of $eq.
+ *
+ * Sets 'mayMatchNull' if the path is missing or null in some branch of the document, or if a
+ * trailing array is empty. Sets 'irregular' if an array nested within an array is found along the
+ * path, in which case the caller should not rely on the values produced.
+ */
+void visitHashJoinKeys(const Value& current,
+                       const FieldPath& path,
+                       size_t index,
+                       const stdx::function<void(const Value&)>& callback,
+                       bool* mayMatchNull,
+                       bool* irregular) {
+    if (index == path.getPathLength()) {
+        if (current.nullish()) {
+            *mayMatchNull = true;
+        } else if (current.isArray()) {
+            callback(current);
+            const auto& elements = current.getArray();
+            if (elements.empty()) {
+                *mayMatchNull = true;
+            }
+            for (auto&& element : elements) {
+                if (element.nullish()) {
+                    *mayMatchNull = true;
+                } else {
+                    callback(element);
+                }
+            }
+        } else {
+            callback(current);
+        }
+        return;
+    }
+
+    const auto fieldName = path.getFieldName(index);
+    if (current.getType() == BSONType::Object) {
+        visitHashJoinKeys(current.getDocument().getField(fieldName),
+                          path,
+                          index + 1,
+                          callback,
+                          mayMatchNull,
+                          irregular);
+    } else if (current.isArray()) {
+        for (auto&& element : current.getArray()) {
+            if (element.getType() == BSONType::Object) {
+                visitHashJoinKeys(element.getDocument().getField(fieldName),
+                                  path,
+                                  index + 1,
+                                  callback,
+                                  mayMatchNull,
+                                  irregular);
+            } else if (element.isArray()) {
+                *irregular = true;
+            } else {
+                *mayMatchNull = true;
+            }
+        }
+    } else {
+        *mayMatchNull = true;
+    }
+}
+
 }  // namespace
 
 DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
@@ -232,6 +312,18 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
         return unwindResult();
     }
 
+    if (!_batchedOutput.empty()) {
+        auto output = std::move(_batchedOutput.front());
+        _batchedOutput.pop_front();
+        return output;
+    }
+
+    if (_resultAfterBatch) {
+        auto result = std::move(*_resultAfterBatch);
+        _resultAfterBatch = boost::none;
+        return result;
+    }
+
     auto nextInput = pSource->getNext();
     if (!nextInput.isAdvanced()) {
         return nextInput;
@@ -239,24 +331,20 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
 
     auto inputDoc = nextInput.releaseDocument();
 
+    if (!wasConstructedWithPipelineSyntax() && internalLookupStageForeignBatchSize.load() > 1 &&
+        !shouldUseHashJoin()) {
+        return lookUpBatch(std::move(inputDoc));
+    }
+
     // If we have not absorbed a $unwind, we cannot absorb a $match. If we have absorbed a $unwind,
     // '_unwindSrc' would be non-null, and we would not have made it here.
     invariant(!_matchSrc);
 
-    if (!wasConstructedWithPipelineSyntax()) {
-        auto matchStage =
-            makeMatchStageFromInput(inputDoc, *_localField, _foreignField->fullPath(), BSONObj());
-        // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
-        _resolvedPipeline.back() = matchStage;
-    }
-
-    auto pipeline = buildPipeline(inputDoc);
-
     std::vector<Value> results;
     int objsize = 0;
     const auto maxBytes = internalLookupStageIntermediateDocumentMaxSizeBytes.load();
-    while (auto result = pipeline->getNext()) {
-        objsize += result->getApproximateSize();
+    auto addResult = [&](Document result) {
+        objsize += result.getApproximateSize();
         uassert(4568,
                 str::stream() << "Total size of documents in " << _fromNs.coll()
                               << " matching pipeline's $lookup stage exceeds "
@@ -264,16 +352,133 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
                               << " bytes",
 
                 objsize <= maxBytes);
-        results.emplace_back(std::move(*result));
+        results.emplace_back(std::move(result));
+    };
+
+    if (shouldUseHashJoin()) {
+        for (auto&& result : probeHashJoinTable(inputDoc, BSONObj())) {
+            addResult(std::move(result));
+        }
+    } else {
+        if (!wasConstructedWithPipelineSyntax()) {
+            auto matchStage = makeMatchStageFromInput(
+                inputDoc, *_localField, _foreignField->fullPath(), BSONObj());
+            // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
+            _resolvedPipeline.back() = matchStage;
+        }
+
+        auto memoKey = makeMemoizationKey(inputDoc);
+        const std::vector<Document>* memoized =
+            (memoKey && _memoizedResults) ? (*_memoizedResults)[*memoKey] : nullptr;
+        if (memoized) {
+            for (auto&& result : *memoized) {
+                addResult(result);
+            }
+        } else {
+            std::vector<Document> toMemoize;
+            auto pipeline = buildPipeline(inputDoc);
+            while (auto result = pipeline->getNext()) {
+                if (memoKey) {
+                    toMemoize.push_back(*result);
+                }
+                addResult(std::move(*result));
+            }
+            for (auto&& source : pipeline->getSources()) {
+                if (source->usedDisk())
+                    _usedDisk = true;
+            }
+
+            if (memoKey) {
+                if (!_memoizedResults) {
+                    _memoizedResults.emplace(ValueComparator());
+                }
+                _memoizedResults->insert(std::move(*memoKey), std::move(toMemoize));
+                _memoizedResults->evictDownTo(
+                    internalQueryLookupMemoizeCorrelatedResultsMaxBytes.load());
+            }
+        }
+    }
+
+    MutableDocument output(std::move(inputDoc));
+    output.setNestedField(_as, Value(std::move(results)));
+    return output.freeze();
+}
+
+DocumentSource::GetNextResult DocumentSourceLookUp::lookUpBatch(Document firstInput) {
+    const auto batchSize = static_cast<size_t>(internalLookupStageForeignBatchSize.load());
+
+    std::vector<Document> inputs;
+    inputs.push_back(std::move(firstInput));
+    while (inputs.size() < batchSize) {
+        auto nextInput = pSource->getNext();
+        if (!nextInput.isAdvanced()) {
+            // Return the pause or EOF once the documents batched so far have been returned.
+            _resultAfterBatch = std::move(nextInput);
+            break;
+        }
+        inputs.push_back(nextInput.releaseDocument());
+    }
+
+    // Query the foreign collection once for the disjunction of the per-document filters. If the
+    // foreign collection is sharded on 'foreignField', the query only targets the shards which own
+    // the join keys of the batch.
+    std::vector<BSONObj> matchStages;
+    BSONObjBuilder disjunctionBuilder;
+    {
+        BSONArrayBuilder disjuncts(disjunctionBuilder.subarrayStart("$or"));
+        for (auto&& input : inputs) {
+            auto matchStage = makeMatchStageFromInput(
+                input, *_localField, _foreignField->fullPath(), BSONObj());
+            disjuncts.append(matchStage.firstElement().Obj());
+            matchStages.push_back(std::move(matchStage));
+        }
+    }
+    _resolvedPipeline.back() = BSON("$match" << disjunctionBuilder.obj());
+
+    std::vector<BSONObj> foreignDocs;
+    auto pipeline = buildPipeline(inputs.front());
+    while (auto result = pipeline->getNext()) {
+        foreignDocs.push_back(result->toBson());
     }
     for (auto&& source : pipeline->getSources()) {
         if (source->usedDisk())
             _usedDisk = true;
     }
 
-    MutableDocument output(std::move(inputDoc));
-    output.setNestedField(_as, Value(std::move(results)));
-    return output.freeze();
+    // Distribute the foreign documents among the input documents, checking each against the same
+    // filter a query per input document would use, in the order they were returned.
+    const auto maxBytes = internalLookupStageIntermediateDocumentMaxSizeBytes.load();
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        auto matcher =
+            uassertStatusOK(MatchExpressionParser::parse(matchStages[i].firstElement().Obj(),
+                                                         _fromExpCtx,
+                                                         ExtensionsCallbackNoop(),
+                                                         Pipeline::kAllowedMatcherFeatures));
+        std::vector<Value> results;
+        int objsize = 0;
+        for (auto&& foreignDoc : foreignDocs) {
+            if (!matcher->matchesBSON(foreignDoc)) {
+                continue;
+            }
+            Document result(foreignDoc);
+            objsize += result.getApproximateSize();
+            uassert(4568,
+                    str::stream() << "Total size of documents in " << _fromNs.coll()
+                                  << " matching pipeline's $lookup stage exceeds "
+                                  << maxBytes
+                                  << " bytes",
+                    objsize <= maxBytes);
+            results.emplace_back(std::move(result));
+        }
+
+        MutableDocument output(std::move(inputs[i]));
+        output.setNestedField(_as, Value(std::move(results)));
+        _batchedOutput.push_back(output.freeze());
+    }
+
+    auto output = std::move(_batchedOutput.front());
+    _batchedOutput.pop_front();
+    return output;
 }
 
 std::unique_ptr<Pipeline, PipelineDeleter> DocumentSourceLookUp::buildPipeline(
@@ -322,6 +527,122 @@ std::unique_ptr<Pipeline, PipelineDeleter> DocumentSourceLookUp::buildPipeline(
     return pipeline;
 }
 
+bool DocumentSourceLookUp::shouldUseHashJoin() {
+    if (_hashJoinState == HashJoinState::kUninitialized) {
+        const bool eligible = !wasConstructedWithPipelineSyntax() && !pExpCtx->inMongos &&
+            internalQueryEnableLookupHashJoin.load() && !hasNumericPathComponent(*_foreignField);
+        if (eligible) {
+            buildHashJoinTable();
+        } else {
+            _hashJoinState = HashJoinState::kAbandoned;
+        }
+    }
+    return _hashJoinState == HashJoinState::kBuilt;
+}
+
+void DocumentSourceLookUp::buildHashJoinTable() {
+    invariant(_hashJoinState == HashJoinState::kUninitialized);
+
+    // Scan the foreign collection once, applying any predicates absorbed from a following $match.
+    _resolvedPipeline.back() = BSON("$match" << _additionalFilter.value_or(BSONObj()));
+    auto pipeline = buildPipeline(Document());
+
+    _hashJoinTable.emplace(pExpCtx->getValueComparator().makeUnorderedValueMap<std::vector<size_t>>());
+
+    const auto maxBytes = internalQueryLookupHashJoinMaxMemoryBytes.load();
+    long long memUsage = 0;
+    while (auto result = pipeline->getNext()) {
+        auto obj = result->toBson();
+        memUsage += obj.objsize();
+        if (memUsage > maxBytes) {
+            _hashJoinForeignDocs.clear();
+            _hashJoinTable.reset();
+            _hashJoinNullCandidates.clear();
+            _hashJoinAlwaysCandidates.clear();
+            _hashJoinState = HashJoinState::kAbandoned;
+            return;
+        }
+
+        const size_t docIndex = _hashJoinForeignDocs.size();
+        bool mayMatchNull = false;
+        bool irregular = false;
+        visitHashJoinKeys(Value(*result),
+                          *_foreignField,
+                          0,
+                          [&](const Value& key) {
+                              auto& docIndexes = (*_hashJoinTable)[key];
+                              if (docIndexes.empty() || docIndexes.back() != docIndex) {
+                                  docIndexes.push_back(docIndex);
+                                  memUsage += key.getApproximateSize() + sizeof(size_t);
+                              }
+                          },
+                          &mayMatchNull,
+                          &irregular);
+        if (irregular) {
+            _hashJoinAlwaysCandidates.push_back(docIndex);
+        } else if (mayMatchNull) {
+            _hashJoinNullCandidates.push_back(docIndex);
+        }
+        _hashJoinForeignDocs.push_back(std::move(obj));
+    }
+
+    for (auto&& source : pipeline->getSources()) {
+        if (source->usedDisk())
+            _usedDisk = true;
+    }
+    _hashJoinState = HashJoinState::kBuilt;
+}
+
+std::vector<Document> DocumentSourceLookUp::probeHashJoinTable(const Document& input,
+                                                               const BSONObj& additionalFilter) {
+    invariant(_hashJoinState == HashJoinState::kBuilt);
+
+    std::vector<size_t> candidates;
+    bool probeNull = false;
+    bool sawValue = false;
+    document_path_support::visitAllValuesAtPath(input, *_localField, [&](const Value& value) {
+        sawValue = true;
+        if (value.nullish()) {
+            probeNull = true;
+            return;
+        }
+        auto it = _hashJoinTable->find(value);
+        if (it != _hashJoinTable->end()) {
+            candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+        }
+    });
+    if (probeNull || !sawValue) {
+        // Missing local values are treated as null.
+        candidates.insert(
+            candidates.end(), _hashJoinNullCandidates.begin(), _hashJoinNullCandidates.end());
+    }
+    candidates.insert(
+        candidates.end(), _hashJoinAlwaysCandidates.begin(), _hashJoinAlwaysCandidates.end());
+
+    std::vector<Document> results;
+    if (candidates.empty()) {
+        return results;
+    }
+
+    // Return each match once, in the order in which the foreign collection was scanned.
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    auto matchStage = makeMatchStageFromInput(
+        input, *_localField, _foreignField->fullPath(), additionalFilter);
+    auto matcher = uassertStatusOK(MatchExpressionParser::parse(matchStage.firstElement().Obj(),
+                                                                _fromExpCtx,
+                                                                ExtensionsCallbackNoop(),
+                                                                Pipeline::kAllowedMatcherFeatures));
+    for (auto&& docIndex : candidates) {
+        const auto& foreignDoc = _hashJoinForeignDocs[docIndex];
+        if (matcher->matchesBSON(foreignDoc)) {
+            results.emplace_back(foreignDoc);
+        }
+    }
+    return results;
+}
+
 DocumentSource::GetModPathsReturn DocumentSourceLookUp::getModifiedPaths() const {
     std::set<std::string> modifiedPaths{_as.fullPath()};
     if (_unwindSrc) {
@@ -551,7 +872,7 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
     // Loop until we get a document that has at least one match.
     // Note we may return early from this loop if our source stage is exhausted or if the unwind
     // source was asked to return empty arrays and we get a document without a match.
-    while (!_pipeline || !_nextValue) {
+    while (!_nextValue) {
         auto nextInput = pSource->getNext();
         if (!nextInput.isAdvanced()) {
             return nextInput;
@@ -559,28 +880,34 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
 
         _input = nextInput.releaseDocument();
 
-        if (!wasConstructedWithPipelineSyntax()) {
-            BSONObj filter = _additionalFilter.value_or(BSONObj());
-            auto matchStage =
-                makeMatchStageFromInput(*_input, *_localField, _foreignField->fullPath(), filter);
-            // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
-            _resolvedPipeline.back() = matchStage;
-        }
+        if (shouldUseHashJoin()) {
+            _hashJoinResults = probeHashJoinTable(*_input, _additionalFilter.value_or(BSONObj()));
+            _hashJoinResultsIndex = 0;
+        } else {
+            if (!wasConstructedWithPipelineSyntax()) {
+                BSONObj filter = _additionalFilter.value_or(BSONObj());
+                auto matchStage = makeMatchStageFromInput(
+                    *_input, *_localField, _foreignField->fullPath(), filter);
+                // We've already allocated space for the trailing $match stage in
+                // '_resolvedPipeline'.
+                _resolvedPipeline.back() = matchStage;
+            }
 
-        if (_pipeline) {
-            _usedDisk = _usedDisk || _pipeline->usedDisk();
-            _pipeline->dispose(pExpCtx->opCtx);
-        }
+            if (_pipeline) {
+                _usedDisk = _usedDisk || _pipeline->usedDisk();
+                _pipeline->dispose(pExpCtx->opCtx);
+            }
 
-        _pipeline = buildPipeline(*_input);
+            _pipeline = buildPipeline(*_input);
 
-        // The $lookup stage takes responsibility for disposing of its Pipeline, since it will
-        // potentially be used by multiple OperationContexts, and the $lookup stage is part of an
-        // outer Pipeline that will propagate dispose() calls before being destroyed.
-        _pipeline.get_deleter().dismissDisposal();
+            // The $lookup stage takes responsibility for disposing of its Pipeline, since it will
+            // potentially be used by multiple OperationContexts, and the $lookup stage is part of
+            // an outer Pipeline that will propagate dispose() calls before being destroyed.
+            _pipeline.get_deleter().dismissDisposal();
+        }
 
         _cursorIndex = 0;
-        _nextValue = _pipeline->getNext();
+        _nextValue = nextResultToUnwind();
 
         if (_unwindSrc->preserveNullAndEmptyArrays() && !_nextValue) {
             // There were no results for this cursor, but the $unwind was asked to preserve empty
@@ -598,7 +925,7 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
 
     invariant(bool(_input) && bool(_nextValue));
     auto currentValue = *_nextValue;
-    _nextValue = _pipeline->getNext();
+    _nextValue = nextResultToUnwind();
 
     // Move input document into output if this is the last or only result, otherwise perform a copy.
     MutableDocument output(_nextValue ? *_input : std::move(*_input));
@@ -612,6 +939,17 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
     return output.freeze();
 }
 
+boost::optional<Document> DocumentSourceLookUp::nextResultToUnwind() {
+    if (_hashJoinState == HashJoinState::kBuilt) {
+        if (_hashJoinResultsIndex == _hashJoinResults.size()) {
+            _hashJoinResults.clear();
+            return boost::none;
+        }
+        return std::move(_hashJoinResults[_hashJoinResultsIndex++]);
+    }
+    return _pipeline->getNext();
+}
+
 void DocumentSourceLookUp::copyVariablesToExpCtx(const Variables& vars,
                                                  const VariablesParseState& vps,
                                                  ExpressionContext* expCtx) {
@@ -628,6 +966,21 @@ void DocumentSourceLookUp::resolveLetVariables(const Document& localDoc, Variabl
     }
 }
 
+boost::optional<Value> DocumentSourceLookUp::makeMemoizationKey(const Document& localDoc) const {
+    if (_letVariables.empty() || internalQueryLookupMemoizeCorrelatedResultsMaxBytes.load() <= 0) {
+        return boost::none;
+    }
+
+    // Variables which evaluate to missing are omitted from the key, but since each variable is
+    // keyed by its name this cannot make two different sets of values collide.
+    BSONObjBuilder keyBuilder;
+    for (auto& letVar : _letVariables) {
+        letVar.expression->evaluate(localDoc).addToBsonObj(&keyBuilder, letVar.name);
+    }
+    auto keyObj = keyBuilder.done();
+    return Value(StringData(keyObj.objdata(), keyObj.objsize()));
+}
+
 void DocumentSourceLookUp::initializeResolvedIntrospectionPipeline() {
     copyVariablesToExpCtx(_variables, _variablesParseState, _fromExpCtx.get());
     _resolvedIntrospectionPipeline =
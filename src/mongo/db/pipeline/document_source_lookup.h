@@ -30,6 +30,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <deque>
 
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_match.h"
@@ -84,9 +85,7 @@ public:
          * Lookup from a sharded collection may not be allowed.
          */
         bool allowShardedForeignCollection(NamespaceString nss) const override final {
-            const bool foreignShardedAllowed =
-                getTestCommandsEnabled() && internalQueryAllowShardedLookup.load();
-            if (foreignShardedAllowed) {
+            if (internalQueryAllowShardedLookup.load()) {
                 return true;
             }
             return (_foreignNssSet.find(nss) == _foreignNssSet.end());
@@ -250,6 +249,40 @@ private:
 
     GetNextResult unwindResult();
 
+    /**
+     * Returns the next result of the foreign pipeline or hash join probe for the current input
+     * document while unwinding, or boost::none once they are exhausted.
+     */
+    boost::optional<Document> nextResultToUnwind();
+
+    /**
+     * Returns true if this $lookup should join using a hash table built from a single scan of the
+     * foreign collection. Builds the hash table on the first call. Once the table has been
+     * abandoned for exceeding its memory limit, this always returns false and the stage runs a
+     * query per input document.
+     */
+    bool shouldUseHashJoin();
+
+    /**
+     * Scans the foreign collection and populates the hash join table, or abandons it if it grows
+     * beyond 'internalQueryLookupHashJoinMaxMemoryBytes'.
+     */
+    void buildHashJoinTable();
+
+    /**
+     * Returns the foreign documents which join with 'input', in the order they were scanned. Each
+     * candidate found through the hash table is checked against the same filter a query per input
+     * document would use, along with 'additionalFilter', so the results are identical.
+     */
+    std::vector<Document> probeHashJoinTable(const Document& input, const BSONObj& additionalFilter);
+
+    /**
+     * Joins 'firstInput' and up to 'internalLookupStageForeignBatchSize' - 1 further input
+     * documents with a single query against the foreign collection. Returns the first joined
+     * document and queues the rest in '_batchedOutput'.
+     */
+    GetNextResult lookUpBatch(Document firstInput);
+
     /**
      * Copies 'vars' and 'vps' to the Variables and VariablesParseState objects in 'expCtx'. These
      * copies provide access to 'let' defined variables in sub-pipeline execution.
@@ -262,6 +295,14 @@ private:
      */
     void resolveLetVariables(const Document& localDoc, Variables* variables);
 
+    /**
+     * Returns the key under which the sub-pipeline results for 'localDoc' are memoized, or
+     * boost::none if memoization does not apply to this stage. The key is the exact binary
+     * representation of the 'let' values, so that values which compare equal but may produce
+     * different results (e.g. 1 and 1.0) are memoized separately.
+     */
+    boost::optional<Value> makeMemoizationKey(const Document& localDoc) const;
+
     /**
      * Builds a parsed pipeline for introspection (e.g. constraints, dependencies). Any sub-$lookup
      * pipelines will be built recursively.
@@ -323,6 +364,30 @@ private:
 
     std::vector<LetVariable> _letVariables;
 
+    // Results of the correlated sub-pipeline memoized by the values of '_letVariables', bounded by
+    // 'internalQueryLookupMemoizeCorrelatedResultsMaxBytes'. Created on first use.
+    boost::optional<LookupSetCache> _memoizedResults;
+
+    // State used when $lookup joins against a hash table of the foreign collection, keyed on the
+    // values found along '_foreignField'. Documents which have a missing or null value along the
+    // path may match a null local value and are tracked separately, as are documents whose shape
+    // does not allow us to determine their join keys, which are considered for every input.
+    enum class HashJoinState { kUninitialized, kBuilt, kAbandoned };
+    HashJoinState _hashJoinState = HashJoinState::kUninitialized;
+    std::vector<BSONObj> _hashJoinForeignDocs;
+    boost::optional<ValueUnorderedMap<std::vector<size_t>>> _hashJoinTable;
+    std::vector<size_t> _hashJoinNullCandidates;
+    std::vector<size_t> _hashJoinAlwaysCandidates;
+
+    // Results of probing the hash join table for '_input' while unwinding.
+    std::vector<Document> _hashJoinResults;
+    size_t _hashJoinResultsIndex = 0;
+
+    // Joined documents from the last batch which have yet to be returned, followed by the pause or
+    // EOF which ended the batch early, if any. See lookUpBatch().
+    std::deque<Document> _batchedOutput;
+    boost::optional<GetNextResult> _resultAfterBatch;
+
     boost::intrusive_ptr<DocumentSourceMatch> _matchSrc;
     boost::intrusive_ptr<DocumentSourceUnwind> _unwindSrc;
 
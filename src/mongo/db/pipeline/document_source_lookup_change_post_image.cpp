@@ -31,7 +31,11 @@
 
 #include "mongo/db/pipeline/document_source_lookup_change_post_image.h"
 
+#include <algorithm>
+
 #include "mongo/bson/simple_bsonelement_comparator.h"
+#include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs_gen.h"
 
 namespace mongo {
 
@@ -54,24 +58,58 @@ Value assertFieldHasType(const Document& fullDoc, StringData fieldName, BSONType
             val.getType() == expectedType);
     return val;
 }
+
+// Returns true if each of the fields of 'documentKey' has the same value in 'doc'.
+bool matchesDocumentKey(const Document& doc, const Document& documentKey) {
+    auto it = documentKey.fieldIterator();
+    while (it.more()) {
+        auto field = it.next();
+        if (ValueComparator::kInstance.evaluate(doc[field.first] != field.second)) {
+            return false;
+        }
+    }
+    return true;
+}
 }  // namespace
 
 DocumentSource::GetNextResult DocumentSourceLookupChangePostImage::getNext() {
     pExpCtx->checkForInterrupt();
 
-    auto input = pSource->getNext();
-    if (!input.isAdvanced()) {
-        return input;
+    if (_bufferedEvents.empty() && !_pendingResult) {
+        bufferEventsAndLookupPostImages();
     }
-    auto opTypeVal = assertFieldHasType(
-        input.getDocument(), DocumentSourceChangeStream::kOperationTypeField, BSONType::String);
-    if (opTypeVal.getString() != DocumentSourceChangeStream::kUpdateOpType) {
-        return input;
+
+    if (!_bufferedEvents.empty()) {
+        auto next = std::move(_bufferedEvents.front());
+        _bufferedEvents.pop_front();
+        return next;
     }
 
-    MutableDocument output(input.releaseDocument());
-    output[kFullDocumentFieldName] = lookupPostImage(output.peek());
-    return output.freeze();
+    auto result = std::move(*_pendingResult);
+    _pendingResult = boost::none;
+    return result;
+}
+
+void DocumentSourceLookupChangePostImage::bufferEventsAndLookupPostImages() {
+    const auto maxBatchSize =
+        static_cast<size_t>(internalChangeStreamPostImageLookupBatchSize.load());
+    while (_bufferedEvents.size() < maxBatchSize) {
+        auto input = pSource->getNext();
+        if (!input.isAdvanced()) {
+            _pendingResult = std::move(input);
+            break;
+        }
+        auto opTypeVal = assertFieldHasType(
+            input.getDocument(), DocumentSourceChangeStream::kOperationTypeField, BSONType::String);
+        _bufferedEvents.push_back(input.releaseDocument());
+
+        // An "invalidate" is the last event of the stream. The source throws if asked for more, so
+        // stop here to avoid losing the events buffered so far.
+        if (opTypeVal.getString() == DocumentSourceChangeStream::kInvalidateOpType) {
+            break;
+        }
+    }
+    lookupPostImages();
 }
 
 NamespaceString DocumentSourceLookupChangePostImage::assertValidNamespace(
@@ -96,42 +134,132 @@ NamespaceString DocumentSourceLookupChangePostImage::assertValidNamespace(
     return nss;
 }
 
-Value DocumentSourceLookupChangePostImage::lookupPostImage(const Document& updateOp) const {
-    // Make sure we have a well-formed input.
-    auto nss = assertValidNamespace(updateOp);
-
-    auto documentKey = assertFieldHasType(updateOp,
-                                          DocumentSourceChangeStream::kDocumentKeyField,
-                                          BSONType::Object)
-                           .getDocument();
-
-    // Extract the UUID from resume token and do change stream lookups by UUID.
-    auto resumeToken =
-        ResumeToken::parse(updateOp[DocumentSourceChangeStream::kIdField].getDocument());
-
-    const auto readConcern = pExpCtx->inMongos
-        ? boost::optional<BSONObj>(BSON("level"
-                                        << "majority"
-                                        << "afterClusterTime"
-                                        << resumeToken.getData().clusterTime))
-        : boost::none;
-
-
-    // Update lookup queries sent from mongoS to shards are allowed to use speculative majority
-    // reads.
-    const auto allowSpeculativeMajorityRead = pExpCtx->inMongos;
-    invariant(resumeToken.getData().uuid);
-    auto lookedUpDoc =
-        pExpCtx->mongoProcessInterface->lookupSingleDocument(pExpCtx,
-                                                             nss,
-                                                             *resumeToken.getData().uuid,
-                                                             documentKey,
-                                                             readConcern,
-                                                             allowSpeculativeMajorityRead);
-
-    // Check whether the lookup returned any documents. Even if the lookup itself succeeded, it may
-    // not have returned any results if the document was deleted in the time since the update op.
-    return (lookedUpDoc ? Value(*lookedUpDoc) : Value(BSONNULL));
+void DocumentSourceLookupChangePostImage::lookupPostImages() {
+    // The update events on a single collection, with their distinct document keys.
+    struct CollectionLookup {
+        NamespaceString nss;
+        UUID uuid;
+        Timestamp latestClusterTime;
+        std::vector<Document> documentKeys;
+
+        // For each of the events, its position in '_bufferedEvents' and in 'documentKeys'.
+        std::vector<std::pair<size_t, size_t>> events;
+    };
+    std::vector<CollectionLookup> lookups;
+
+    for (size_t eventIndex = 0; eventIndex < _bufferedEvents.size(); ++eventIndex) {
+        const auto& event = _bufferedEvents[eventIndex];
+        auto opTypeVal = assertFieldHasType(
+            event, DocumentSourceChangeStream::kOperationTypeField, BSONType::String);
+        if (opTypeVal.getString() != DocumentSourceChangeStream::kUpdateOpType) {
+            continue;
+        }
+
+        // Make sure we have a well-formed input.
+        auto nss = assertValidNamespace(event);
+        auto documentKey =
+            assertFieldHasType(
+                event, DocumentSourceChangeStream::kDocumentKeyField, BSONType::Object)
+                .getDocument();
+
+        // Extract the UUID from resume token and do change stream lookups by UUID.
+        auto resumeToken =
+            ResumeToken::parse(event[DocumentSourceChangeStream::kIdField].getDocument());
+        const auto tokenData = resumeToken.getData();
+        invariant(tokenData.uuid);
+
+        auto lookup = std::find_if(lookups.begin(), lookups.end(), [&](const auto& lookup) {
+            return lookup.uuid == *tokenData.uuid && lookup.nss == nss;
+        });
+        if (lookup == lookups.end()) {
+            lookups.push_back({nss, *tokenData.uuid, tokenData.clusterTime, {}, {}});
+            lookup = std::prev(lookups.end());
+        }
+        lookup->latestClusterTime = std::max(lookup->latestClusterTime, tokenData.clusterTime);
+
+        auto documentKeyBson = documentKey.toBson();
+        auto key = std::find_if(
+            lookup->documentKeys.begin(), lookup->documentKeys.end(), [&](const auto& key) {
+                return key.toBson().binaryEqual(documentKeyBson);
+            });
+        if (key == lookup->documentKeys.end()) {
+            lookup->documentKeys.push_back(std::move(documentKey));
+            key = std::prev(lookup->documentKeys.end());
+        }
+        lookup->events.emplace_back(eventIndex, key - lookup->documentKeys.begin());
+    }
+
+    for (auto&& lookup : lookups) {
+        // Reading at the time of the latest of the updates also observes all of the earlier ones.
+        const auto readConcern = pExpCtx->inMongos
+            ? boost::optional<BSONObj>(BSON("level"
+                                            << "majority"
+                                            << "afterClusterTime"
+                                            << lookup.latestClusterTime))
+            : boost::none;
+
+        // Update lookup queries sent from mongoS to shards are allowed to use speculative majority
+        // reads.
+        const auto allowSpeculativeMajorityRead = pExpCtx->inMongos;
+        auto lookedUpDocs = pExpCtx->mongoProcessInterface->lookupDocuments(
+            pExpCtx,
+            lookup.nss,
+            lookup.uuid,
+            lookup.documentKeys,
+            readConcern,
+            allowSpeculativeMajorityRead);
+
+        // Match each of the documents to the keys it was looked up by.
+        std::vector<boost::optional<Document>> postImages(lookup.documentKeys.size());
+        bool allDocsMatched = true;
+        for (auto&& lookedUpDoc : lookedUpDocs) {
+            bool matched = false;
+            for (size_t i = 0; i < lookup.documentKeys.size(); ++i) {
+                if (!matchesDocumentKey(lookedUpDoc, lookup.documentKeys[i])) {
+                    continue;
+                }
+                uassert(ErrorCodes::TooManyMatchingDocuments,
+                        str::stream() << "found more than one document with document key "
+                                      << lookup.documentKeys[i].toString()
+                                      << " ["
+                                      << postImages[i]->toString()
+                                      << ", "
+                                      << lookedUpDoc.toString()
+                                      << "]",
+                        !postImages[i]);
+                postImages[i] = lookedUpDoc;
+                matched = true;
+            }
+            allDocsMatched = allDocsMatched && matched;
+        }
+
+        // A document can match its key under the collection's default collation without being
+        // equal to it. Such a document can't be attributed to a key here, so look up the keys which
+        // were left without a document one at a time instead.
+        if (!allDocsMatched) {
+            for (size_t i = 0; i < lookup.documentKeys.size(); ++i) {
+                if (!postImages[i]) {
+                    postImages[i] = pExpCtx->mongoProcessInterface->lookupSingleDocument(
+                        pExpCtx,
+                        lookup.nss,
+                        lookup.uuid,
+                        lookup.documentKeys[i],
+                        readConcern,
+                        allowSpeculativeMajorityRead);
+                }
+            }
+        }
+
+        // Check whether the lookup returned any documents. Even if the lookup itself succeeded, it
+        // may not have returned any results if the document was deleted in the time since the
+        // update op.
+        for (auto&& event : lookup.events) {
+            const auto& postImage = postImages[event.second];
+            MutableDocument output(std::move(_bufferedEvents[event.first]));
+            output[kFullDocumentFieldName] = postImage ? Value(*postImage) : Value(BSONNULL);
+            _bufferedEvents[event.first] = output.freeze();
+        }
+    }
 }
 
 }  // namespace mongo
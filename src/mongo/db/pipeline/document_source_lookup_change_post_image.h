@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <deque>
+
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
 
@@ -37,6 +39,11 @@ namespace mongo {
 /**
  * Part of the change stream API machinery used to look up the post-image of a document. Uses the
  * "documentKey" field of the input to look up the new version of the document.
+ *
+ * Rather than looking up each post-image as its event arrives, the stage buffers the events which
+ * are immediately available from its source, up to 'internalChangeStreamPostImageLookupBatchSize'
+ * of them, and looks up the post-images of all of the buffered update events on each collection at
+ * once. Events are returned in the order they were received.
  */
 class DocumentSourceLookupChangePostImage final : public DocumentSource {
 public:
@@ -97,6 +104,14 @@ public:
      */
     GetNextResult getNext() final;
 
+    /**
+     * Returns true if this stage holds events which it has received from its source but not yet
+     * returned. The postBatchResumeToken of a change stream must not advance past such events.
+     */
+    bool hasBufferedEvents() const {
+        return !_bufferedEvents.empty();
+    }
+
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final {
         if (explain) {
             return Value{Document{{kStageName, Document()}}};
@@ -113,10 +128,17 @@ private:
         : DocumentSource(expCtx) {}
 
     /**
-     * Uses the "documentKey" field from 'updateOp' to look up the current version of the document.
-     * Returns Value(BSONNULL) if the document couldn't be found.
+     * Pulls events from the source into '_bufferedEvents' until the batch is full or the source
+     * has no more events available, then fills in the post-images of the buffered update events.
      */
-    Value lookupPostImage(const Document& updateOp) const;
+    void bufferEventsAndLookupPostImages();
+
+    /**
+     * Sets the "fullDocument" field of each update event in '_bufferedEvents' to the current
+     * version of the document identified by its "documentKey", or to null if the document
+     * couldn't be found. Documents on the same collection are looked up with a single query.
+     */
+    void lookupPostImages();
 
     /**
      * Throws a AssertionException if the namespace found in 'inputDoc' doesn't match the one on the
@@ -124,6 +146,12 @@ private:
      * function verifies that the only the database names match.
      */
     NamespaceString assertValidNamespace(const Document& inputDoc) const;
+
+    // Events received from the source which have not been returned yet, in order.
+    std::deque<Document> _bufferedEvents;
+
+    // A non-advanced result from the source, to be returned once '_bufferedEvents' is drained.
+    boost::optional<GetNextResult> _pendingResult;
 };
 
 }  // namespace mongo
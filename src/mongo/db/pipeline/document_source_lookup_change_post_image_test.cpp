@@ -324,5 +324,62 @@ TEST_F(DocumentSourceLookupChangePostImageTest, ShouldPropagatePauses) {
     ASSERT_TRUE(lookupChangeStage->getNext().isEOF());
 }
 
+TEST_F(DocumentSourceLookupChangePostImageTest, ShouldBatchLookupsInOrder) {
+    auto expCtx = getExpCtx();
+
+    // Set up the lookup change post image stage.
+    auto lookupChangeStage = DocumentSourceLookupChangePostImage::create(expCtx);
+
+    // Mock its input with several updates, one of them to a document which has since been deleted,
+    // and two of them to the same document, separated by an insert.
+    const auto ns = Document{{"db", expCtx->ns.db()}, {"coll", expCtx->ns.coll()}};
+    auto makeUpdate = [&](int id) {
+        return Document{{"_id", makeResumeToken(id)},
+                        {"documentKey", Document{{"_id", id}}},
+                        {"operationType", "update"_sd},
+                        {"ns", ns}};
+    };
+    const auto insert = Document{{"_id", makeResumeToken(2)},
+                                 {"documentKey", Document{{"_id", 2}}},
+                                 {"operationType", "insert"_sd},
+                                 {"ns", ns},
+                                 {"fullDocument", Document{{"_id", 2}}}};
+    auto mockLocalSource = DocumentSourceMock::create(
+        {makeUpdate(0), makeUpdate(1), insert, makeUpdate(3), makeUpdate(0)});
+
+    lookupChangeStage->setSource(mockLocalSource.get());
+
+    // Mock out the foreign collection, without the document with _id 1.
+    deque<DocumentSource::GetNextResult> mockForeignContents{Document{{"_id", 3}, {"x", 3}},
+                                                             Document{{"_id", 2}, {"x", 2}},
+                                                             Document{{"_id", 0}, {"x", 0}}};
+    getExpCtx()->mongoProcessInterface =
+        stdx::make_unique<MockMongoInterface>(std::move(mockForeignContents));
+
+    auto expectUpdate = [&](int id, Value fullDocument) {
+        auto next = lookupChangeStage->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                           (Document{{"_id", makeResumeToken(id)},
+                                     {"documentKey", Document{{"_id", id}}},
+                                     {"operationType", "update"_sd},
+                                     {"ns", ns},
+                                     {"fullDocument", fullDocument}}));
+    };
+
+    expectUpdate(0, Value(Document{{"_id", 0}, {"x", 0}}));
+    expectUpdate(1, Value(BSONNULL));
+
+    // The insert is passed through unmodified.
+    auto next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), insert);
+
+    expectUpdate(3, Value(Document{{"_id", 3}, {"x", 3}}));
+    expectUpdate(0, Value(Document{{"_id", 0}, {"x", 0}}));
+
+    ASSERT_TRUE(lookupChangeStage->getNext().isEOF());
+}
+
 }  // namespace
 }  // namespace mongo
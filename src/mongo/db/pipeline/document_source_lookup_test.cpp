@@ -48,6 +48,7 @@
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/server_options.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -508,6 +509,7 @@ public:
         const std::vector<BSONObj>& rawPipeline,
         const boost::intrusive_ptr<ExpressionContext>& expCtx,
         const MakePipelineOptions opts) final {
+        ++_numPipelinesMade;
         auto pipeline = uassertStatusOK(Pipeline::parse(rawPipeline, expCtx));
 
         if (opts.optimize) {
@@ -538,9 +540,14 @@ public:
         return pipeline;
     }
 
+    size_t numPipelinesMade() const {
+        return _numPipelinesMade;
+    }
+
 private:
     deque<DocumentSource::GetNextResult> _mockResults;
     bool _removeLeadingQueryStages = false;
+    size_t _numPipelinesMade = 0;
 };
 
 TEST_F(DocumentSourceLookUpTest, ShouldPropagatePauses) {
@@ -649,6 +656,260 @@ TEST_F(DocumentSourceLookUpTest, ShouldPropagatePausesWhileUnwinding) {
     lookup->dispose();
 }
 
+TEST_F(DocumentSourceLookUpTest, HashJoinProducesSameResultsAsQueryPerDocument) {
+    internalQueryEnableLookupHashJoin.store(true);
+    ON_BLOCK_EXIT([] { internalQueryEnableLookupHashJoin.store(false); });
+
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespaces(StringMap<ExpressionContext::ResolvedNamespace>{
+        {fromNs.coll().toString(), {fromNs, std::vector<BSONObj>()}}});
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "a"_sd},
+                                         {"foreignField", "b.c"_sd},
+                                         {"as", "joined"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+
+    auto mockLocalSource = DocumentSourceMock::create({Document{{"a", 1}},
+                                                       Document{{"a", vector<Value>{Value(2), Value(3)}}},
+                                                       Document{{"x", 1}},
+                                                       Document{{"a", 4}}});
+    lookup->setSource(mockLocalSource.get());
+
+    // The foreign documents exercise numeric equivalence, arrays along the path, and missing values.
+    auto foreign0 = Document{{"_id", 0}, {"b", Document{{"c", 1.0}}}};
+    auto foreign1 =
+        Document{{"_id", 1},
+                 {"b", vector<Value>{Value(Document{{"c", 2}}), Value(Document{{"c", 1}})}}};
+    auto foreign2 = Document{{"_id", 2}, {"b", Document{{"c", vector<Value>{Value(3), Value(5)}}}}};
+    auto foreign3 = Document{{"_id", 3}, {"b", 7}};
+    deque<DocumentSource::GetNextResult> mockForeignContents;
+    for (auto&& foreignDoc : {foreign0, foreign1, foreign2, foreign3}) {
+        mockForeignContents.emplace_back(Document(foreignDoc));
+    }
+    expCtx->mongoProcessInterface =
+        std::make_shared<MockMongoInterface>(std::move(mockForeignContents));
+
+    auto next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"a", 1}, {"joined", vector<Value>{Value(foreign0), Value(foreign1)}}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"a", vector<Value>{Value(2), Value(3)}},
+                                 {"joined", vector<Value>{Value(foreign1), Value(foreign2)}}}));
+
+    // A missing local value joins with foreign documents which are missing the foreign field.
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"x", 1}, {"joined", vector<Value>{Value(foreign3)}}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), (Document{{"a", 4}, {"joined", vector<Value>{}}}));
+
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    lookup->dispose();
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldMemoizeCorrelatedResultsByLetValues) {
+    internalQueryLookupMemoizeCorrelatedResultsMaxBytes.store(1024 * 1024);
+    ON_BLOCK_EXIT([] { internalQueryLookupMemoizeCorrelatedResultsMaxBytes.store(0); });
+
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "coll");
+    expCtx->setResolvedNamespaces(StringMap<ExpressionContext::ResolvedNamespace>{
+        {fromNs.coll().toString(), {fromNs, std::vector<BSONObj>()}}});
+
+    auto docSource = DocumentSourceLookUp::createFromBson(
+        fromjson("{$lookup: {let: {var1: '$a'}, pipeline: [{$match: {$expr: {$eq: ['$x', "
+                 "'$$var1']}}}, {$addFields: {var: '$$var1'}}], from: 'coll', as: 'as'}}")
+            .firstElement(),
+        expCtx);
+    auto lookupStage = static_cast<DocumentSourceLookUp*>(docSource.get());
+
+    // The numerically equal values 1 and 1.0 must not share a memoized result, since the
+    // sub-pipeline output differs between them.
+    auto mockLocalSource = DocumentSourceMock::create({Document{{"a", 1}},
+                                                       Document{{"a", 2}},
+                                                       Document{{"a", 1}},
+                                                       Document{{"a", 1.0}},
+                                                       Document{{"a", 2}}});
+    lookupStage->setSource(mockLocalSource.get());
+
+    deque<DocumentSource::GetNextResult> mockForeignContents{
+        Document{{"x", 1}}, Document{{"x", 1}}, Document{{"x", 3}}};
+    auto mongoInterface = std::make_shared<MockMongoInterface>(mockForeignContents);
+    expCtx->mongoProcessInterface = mongoInterface;
+
+    const std::vector<BSONObj> expected{
+        fromjson("{a: 1, as: [{x: 1, var: 1}, {x: 1, var: 1}]}"),
+        fromjson("{a: 2, as: []}"),
+        fromjson("{a: 1, as: [{x: 1, var: 1}, {x: 1, var: 1}]}"),
+        fromjson("{a: 1.0, as: [{x: 1, var: 1.0}, {x: 1, var: 1.0}]}"),
+        fromjson("{a: 2, as: []}")};
+    for (auto&& expectedDoc : expected) {
+        auto next = lookupStage->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        auto doc = next.releaseDocument();
+        ASSERT_DOCUMENT_EQ(doc, Document(expectedDoc));
+        for (auto&& joined : doc["as"].getArray()) {
+            ASSERT_EQ(joined["var"].getType(), doc["a"].getType());
+        }
+    }
+    ASSERT_TRUE(lookupStage->getNext().isEOF());
+
+    // Only the three distinct sets of 'let' values ran the sub-pipeline.
+    ASSERT_EQ(mongoInterface->numPipelinesMade(), 3U);
+    lookupStage->dispose();
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldJoinBatchesOfInputDocumentsWithOneQuery) {
+    internalLookupStageForeignBatchSize.store(3);
+    ON_BLOCK_EXIT([] { internalLookupStageForeignBatchSize.store(0); });
+
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespaces(StringMap<ExpressionContext::ResolvedNamespace>{
+        {fromNs.coll().toString(), {fromNs, std::vector<BSONObj>()}}});
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "a"_sd},
+                                         {"foreignField", "b"_sd},
+                                         {"as", "joined"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+
+    // The first batch is cut short by a pause, which must still be returned in order.
+    auto mockLocalSource =
+        DocumentSourceMock::create({Document{{"a", 1}},
+                                    Document{{"a", vector<Value>{Value(2), Value(3)}}},
+                                    DocumentSource::GetNextResult::makePauseExecution(),
+                                    Document{{"x", 1}},
+                                    Document{{"a", 1}},
+                                    Document{{"a", 4}},
+                                    Document{{"a", 2}}});
+    lookup->setSource(mockLocalSource.get());
+
+    auto foreign0 = Document{{"_id", 0}, {"b", 1}};
+    auto foreign1 = Document{{"_id", 1}, {"b", 2}};
+    auto foreign2 = Document{{"_id", 2}, {"b", 3}};
+    auto foreign3 = Document{{"_id", 3}, {"b", 1.0}};
+    auto foreign4 = Document{{"_id", 4}};
+    deque<DocumentSource::GetNextResult> mockForeignContents;
+    for (auto&& foreignDoc : {foreign0, foreign1, foreign2, foreign3, foreign4}) {
+        mockForeignContents.emplace_back(Document(foreignDoc));
+    }
+    auto mongoInterface = std::make_shared<MockMongoInterface>(std::move(mockForeignContents));
+    expCtx->mongoProcessInterface = mongoInterface;
+
+    auto next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"a", 1}, {"joined", vector<Value>{Value(foreign0), Value(foreign3)}}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"a", vector<Value>{Value(2), Value(3)}},
+                                 {"joined", vector<Value>{Value(foreign1), Value(foreign2)}}}));
+
+    ASSERT_TRUE(lookup->getNext().isPaused());
+
+    // A missing local value joins with foreign documents which are missing the foreign field.
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"x", 1}, {"joined", vector<Value>{Value(foreign4)}}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"a", 1}, {"joined", vector<Value>{Value(foreign0), Value(foreign3)}}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), (Document{{"a", 4}, {"joined", vector<Value>{}}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"a", 2}, {"joined", vector<Value>{Value(foreign1)}}}));
+
+    ASSERT_TRUE(lookup->getNext().isEOF());
+
+    // Seven input documents were joined with three queries.
+    ASSERT_EQ(mongoInterface->numPipelinesMade(), 3U);
+    lookup->dispose();
+}
+
+TEST_F(DocumentSourceLookUpTest, HashJoinSupportsAbsorbedUnwind) {
+    internalQueryEnableLookupHashJoin.store(true);
+    ON_BLOCK_EXIT([] { internalQueryEnableLookupHashJoin.store(false); });
+
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespaces(StringMap<ExpressionContext::ResolvedNamespace>{
+        {fromNs.coll().toString(), {fromNs, std::vector<BSONObj>()}}});
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "foreignId"_sd},
+                                         {"foreignField", "key"_sd},
+                                         {"as", "foreignDoc"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+
+    const bool preserveNullAndEmptyArrays = true;
+    const boost::optional<std::string> includeArrayIndex = std::string("idx");
+    lookup->setUnwindStage(DocumentSourceUnwind::create(
+        expCtx, "foreignDoc", preserveNullAndEmptyArrays, includeArrayIndex));
+
+    auto mockLocalSource =
+        DocumentSourceMock::create({Document{{"foreignId", 0}}, Document{{"foreignId", 1}}});
+    lookup->setSource(mockLocalSource.get());
+
+    auto foreign0 = Document{{"_id", 0}, {"key", 0}};
+    auto foreign1 = Document{{"_id", 1}, {"key", 0}};
+    deque<DocumentSource::GetNextResult> mockForeignContents;
+    for (auto&& foreignDoc : {foreign0, foreign1}) {
+        mockForeignContents.emplace_back(Document(foreignDoc));
+    }
+    expCtx->mongoProcessInterface =
+        std::make_shared<MockMongoInterface>(std::move(mockForeignContents));
+
+    auto next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"foreignId", 0}, {"foreignDoc", foreign0}, {"idx", 0LL}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"foreignId", 0}, {"foreignDoc", foreign1}, {"idx", 1LL}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"foreignId", 1}, {"idx", BSONNULL}}));
+
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    lookup->dispose();
+}
+
 TEST_F(DocumentSourceLookUpTest, LookupReportsAsFieldIsModified) {
     auto expCtx = getExpCtx();
     NamespaceString fromNs("test", "foreign");
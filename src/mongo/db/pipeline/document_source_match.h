@@ -43,6 +43,8 @@ public:
     virtual ~DocumentSourceMatch() = default;
 
     GetNextResult getNext() override;
+    GetNextResult::ReturnStatus getNextBatch(size_t maxBatchSize,
+                                             std::vector<Document>* batch) override;
 
     boost::intrusive_ptr<DocumentSource> optimize() final;
 
@@ -169,6 +171,11 @@ protected:
     BSONObj _predicate;
 
 private:
+    /**
+     * Returns whether 'doc' satisfies this stage's filter.
+     */
+    bool matches(const Document& doc) const;
+
     std::unique_ptr<MatchExpression> _expression;
 
     const bool _isTextQuery;
@@ -30,6 +30,7 @@
 #include "mongo/platform/basic.h"
 
 #include <string>
+#include <vector>
 
 #include "mongo/bson/bsonmisc.h"
 #include "mongo/bson/bsonobj.h"
@@ -498,6 +499,34 @@ TEST_F(DocumentSourceMatchTest, ShouldPropagatePauses) {
     ASSERT_TRUE(match->getNext().isEOF());
 }
 
+TEST_F(DocumentSourceMatchTest, ShouldFilterBatchesAndPropagatePauses) {
+    auto match = DocumentSourceMatch::create(BSON("a" << 1), getExpCtx());
+    auto mock = DocumentSourceMock::create({Document{{"a", 1}, {"b", 0}},
+                                            Document{{"a", 2}},
+                                            Document{{"a", 1}, {"b", 1}},
+                                            DocumentSource::GetNextResult::makePauseExecution(),
+                                            Document{{"a", 2}},
+                                            Document{{"a", 2}},
+                                            Document{{"a", 1}, {"b", 2}}});
+    match->setSource(mock.get());
+
+    // The first batch is cut short by the pause, which is reported once the matching documents
+    // before it have been returned.
+    std::vector<Document> batch;
+    ASSERT(match->getNextBatch(10, &batch) ==
+           DocumentSource::GetNextResult::ReturnStatus::kPauseExecution);
+    ASSERT_EQ(batch.size(), 2UL);
+    ASSERT_DOCUMENT_EQ(batch[0], (Document{{"a", 1}, {"b", 0}}));
+    ASSERT_DOCUMENT_EQ(batch[1], (Document{{"a", 1}, {"b", 1}}));
+
+    // A source batch in which nothing matches is skipped rather than returned empty.
+    batch.clear();
+    ASSERT(match->getNextBatch(2, &batch) == DocumentSource::GetNextResult::ReturnStatus::kEOF);
+    ASSERT_EQ(batch.size(), 1UL);
+    ASSERT_DOCUMENT_EQ(batch[0], (Document{{"a", 1}, {"b", 2}}));
+    ASSERT_TRUE(match->getNext().isEOF());
+}
+
 TEST_F(DocumentSourceMatchTest, ShouldCorrectlyJoinWithSubsequentMatch) {
     const auto match = DocumentSourceMatch::create(BSON("a" << 1), getExpCtx());
     const auto secondMatch = DocumentSourceMatch::create(BSON("b" << 1), getExpCtx());
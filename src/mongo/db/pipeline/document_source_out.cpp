@@ -38,6 +38,8 @@
 #include "mongo/db/pipeline/document_source_out_gen.h"
 #include "mongo/db/pipeline/document_source_out_in_place.h"
 #include "mongo/db/pipeline/document_source_out_replace_coll.h"
+#include "mongo/db/pipeline/out_stage_parallel_writer.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 
@@ -206,10 +208,46 @@ DocumentSource::GetNextResult DocumentSourceOut::getNext() {
                               << ExplainOptions::verbosityString(*pExpCtx->explain),
                 !pExpCtx->explain);
 
+        const auto numWriterThreads = internalQueryAggregationOutWriterThreads.load();
+        if (numWriterThreads > 1 && canSpillInParallel()) {
+            _numParallelWriters = static_cast<size_t>(numWriterThreads);
+        }
+
         initializeWriteNs();
         _initialized = true;
     }
 
+    // The writer threads, if any, are started on the first batch and stopped before returning, so
+    // that they never outlive this call.
+    std::vector<intrusive_ptr<ExpressionContext>> writerExpCtxs;
+    std::unique_ptr<OutStageParallelWriter> parallelWriter;
+    auto spillBatch = [&](BatchedObjects&& batch) {
+        if (_numParallelWriters == 0) {
+            spill(std::move(batch));
+            return;
+        }
+
+        if (!parallelWriter) {
+            for (size_t i = 0; i < _numParallelWriters; ++i) {
+                writerExpCtxs.push_back(pExpCtx->copyWith(getWriteNs()));
+            }
+            parallelWriter = stdx::make_unique<OutStageParallelWriter>(
+                pExpCtx->opCtx,
+                _numParallelWriters,
+                [&](size_t writerIndex, OperationContext* opCtx, std::vector<BSONObj> objects) {
+                    const auto& writerExpCtx = writerExpCtxs[writerIndex];
+                    writerExpCtx->opCtx = opCtx;
+                    OutStageWriteBlock writeBlock(opCtx);
+                    writerExpCtx->mongoProcessInterface->insert(writerExpCtx,
+                                                                getWriteNs(),
+                                                                std::move(objects),
+                                                                _writeConcern,
+                                                                _targetEpoch());
+                });
+        }
+        parallelWriter->write(pExpCtx->opCtx, std::move(batch.objects));
+    };
+
     BatchedObjects batch;
     int bufferedBytes = 0;
 
@@ -242,16 +280,19 @@ DocumentSource::GetNextResult DocumentSourceOut::getNext() {
         bufferedBytes += insertObj.objsize();
         if (!batch.empty() &&
             (bufferedBytes > BSONObjMaxUserSize || batch.size() >= write_ops::kMaxWriteBatchSize)) {
-            spill(std::move(batch));
+            spillBatch(std::move(batch));
             batch.clear();
             bufferedBytes = insertObj.objsize();
         }
         batch.emplace(std::move(insertObj), std::move(uniqueKey));
     }
     if (!batch.empty()) {
-        spill(std::move(batch));
+        spillBatch(std::move(batch));
         batch.clear();
     }
+    if (parallelWriter) {
+        parallelWriter->finish(pExpCtx->opCtx);
+    }
 
     switch (nextInput.getStatus()) {
         case GetNextResult::ReturnStatus::kAdvanced: {
@@ -233,6 +233,15 @@ public:
      */
     virtual void finalize() = 0;
 
+    /**
+     * Returns true if the batches may be inserted concurrently by writer threads, each with an
+     * OperationContext of its own, rather than by spill(). This is only the case for inserts into
+     * a collection which nothing else writes to.
+     */
+    virtual bool canSpillInParallel() const {
+        return false;
+    }
+
     /**
      * Creates a new $out stage from the given arguments.
      */
@@ -265,6 +274,10 @@ protected:
                                         : boost::none;
     }
 
+    // The number of threads which insert the batches into the write namespace, decided before
+    // initializeWriteNs() is called. Zero if the batches are written by spill() on this thread.
+    size_t _numParallelWriters = 0;
+
 private:
     /**
      * If 'spec' does not specify a uniqueKey, uses the sharding catalog to pick a default key of
@@ -114,6 +114,10 @@ void DocumentSourceOutReplaceColl::initializeWriteNs() {
         // collection.
         tempNsIndexes.push_back(indexSpec.addField(BSON("ns" << _tempNs.ns()).firstElement()));
     }
+    if (_numParallelWriters > 0) {
+        _deferredIndexes = std::move(tempNsIndexes);
+        return;
+    }
     try {
         conn->createIndexes(_tempNs.ns(), tempNsIndexes);
     } catch (DBException& ex) {
@@ -125,6 +129,17 @@ void DocumentSourceOutReplaceColl::initializeWriteNs() {
 void DocumentSourceOutReplaceColl::finalize() {
     OutStageWriteBlock writeBlock(pExpCtx->opCtx);
 
+    if (!_deferredIndexes.empty()) {
+        try {
+            pExpCtx->mongoProcessInterface->directClient()->createIndexes(_tempNs.ns(),
+                                                                          _deferredIndexes);
+        } catch (DBException& ex) {
+            ex.addContext("Copying indexes for $out failed");
+            throw;
+        }
+        _deferredIndexes.clear();
+    }
+
     const auto& outputNs = getOutputNs();
     auto renameCommandObj =
         BSON("renameCollection" << _tempNs.ns() << "to" << outputNs.ns() << "dropTarget" << true);
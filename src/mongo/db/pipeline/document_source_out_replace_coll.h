@@ -52,10 +52,18 @@ public:
 
     /**
      * Renames the temp collection to the output collection with the 'dropTarget' option set to
-     * true.
+     * true. If the indexes of the temp collection were deferred, builds them first.
      */
     void finalize() final;
 
+    /**
+     * The temp collection is only written to by this stage, so the order of its inserts doesn't
+     * matter. Parallel writes are limited to a single node, where the inserts are local.
+     */
+    bool canSpillInParallel() const final {
+        return !pExpCtx->inMongos && !pExpCtx->fromMongos;
+    }
+
     const NamespaceString& getWriteNs() const final {
         return _tempNs;
     };
@@ -68,6 +76,11 @@ private:
 
     // The temporary namespace for the $out writes.
     NamespaceString _tempNs;
+
+    // Specs of the indexes to build on the temp collection once all of the documents are inserted.
+    // When the inserts are made by parallel writers, building the indexes in bulk afterwards is
+    // cheaper than maintaining them on every insert.
+    std::vector<BSONObj> _deferredIndexes;
 };
 
 }  // namespace mongo
@@ -0,0 +1,312 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_parallel_collection_scan.h"
+
+#include <algorithm>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/exec/collection_scan.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/matcher/extensions_callback_real.h"
+#include "mongo/db/pipeline/document_source_cursor.h"
+#include "mongo/db/pipeline/document_source_group.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/query_request.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+namespace {
+// The number of RecordIds sampled for each partition when choosing the partition boundaries.
+const size_t kSamplesPerPartition = 64;
+}  // namespace
+
+constexpr StringData DocumentSourceParallelCollectionScan::kStageName;
+
+DocumentSourceParallelCollectionScan::DocumentSourceParallelCollectionScan(
+    const intrusive_ptr<ExpressionContext>& expCtx,
+    NamespaceString nss,
+    UUID uuid,
+    BSONObj query,
+    BSONObj groupSpec,
+    std::vector<Partition> partitions)
+    : DocumentSource(expCtx),
+      _nss(std::move(nss)),
+      _uuid(std::move(uuid)),
+      _query(query.getOwned()),
+      _groupSpec(groupSpec.getOwned()),
+      _partitions(std::move(partitions)) {
+    invariant(!_partitions.empty());
+}
+
+intrusive_ptr<DocumentSourceParallelCollectionScan> DocumentSourceParallelCollectionScan::create(
+    const intrusive_ptr<ExpressionContext>& expCtx,
+    NamespaceString nss,
+    UUID uuid,
+    BSONObj query,
+    BSONObj groupSpec,
+    std::vector<Partition> partitions) {
+    return new DocumentSourceParallelCollectionScan(expCtx,
+                                                    std::move(nss),
+                                                    std::move(uuid),
+                                                    std::move(query),
+                                                    std::move(groupSpec),
+                                                    std::move(partitions));
+}
+
+DocumentSourceParallelCollectionScan::~DocumentSourceParallelCollectionScan() {
+    stopWorkers();
+}
+
+std::vector<DocumentSourceParallelCollectionScan::Partition>
+DocumentSourceParallelCollectionScan::partitionRecordIds(OperationContext* opCtx,
+                                                         const Collection* collection,
+                                                         size_t numPartitions) {
+    std::vector<RecordId> sample;
+    if (numPartitions > 1) {
+        if (auto cursor = collection->getRecordStore()->getRandomCursor(opCtx)) {
+            const size_t sampleSize = numPartitions * kSamplesPerPartition;
+            while (sample.size() < sampleSize) {
+                auto record = cursor->next();
+                if (!record) {
+                    break;
+                }
+                sample.push_back(record->id);
+            }
+        }
+    }
+    std::sort(sample.begin(), sample.end());
+    sample.erase(std::unique(sample.begin(), sample.end()), sample.end());
+
+    // Use evenly spaced quantiles of the sample as the boundaries between partitions.
+    std::vector<Partition> partitions;
+    boost::optional<RecordId> lowerBound;
+    for (size_t i = 1; i < numPartitions && !sample.empty(); ++i) {
+        const RecordId& upperBound = sample[i * sample.size() / numPartitions];
+        if (lowerBound && upperBound <= *lowerBound) {
+            continue;
+        }
+        partitions.push_back({lowerBound, upperBound});
+        lowerBound = upperBound;
+    }
+    partitions.push_back({lowerBound, boost::none});
+    return partitions;
+}
+
+const char* DocumentSourceParallelCollectionScan::getSourceName() const {
+    return kStageName.rawData();
+}
+
+Value DocumentSourceParallelCollectionScan::serialize(
+    boost::optional<ExplainOptions::Verbosity> explain) const {
+    const auto numWorkers = static_cast<long long>(_partitions.size());
+    return Value(DOC(getSourceName() << DOC("query" << _query << "group" << _groupSpec
+                                                    << "workers"
+                                                    << numWorkers)));
+}
+
+DocumentSource::GetNextResult DocumentSourceParallelCollectionScan::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    if (_workerResults.empty()) {
+        runWorkers();
+    }
+
+    while (_resultWorker < _workerResults.size()) {
+        auto& results = _workerResults[_resultWorker];
+        if (_resultIndex < results.size()) {
+            return std::move(results[_resultIndex++]);
+        }
+        results.clear();
+        ++_resultWorker;
+        _resultIndex = 0;
+    }
+    return GetNextResult::makeEOF();
+}
+
+void DocumentSourceParallelCollectionScan::doDispose() {
+    stopWorkers();
+    _workerResults.clear();
+}
+
+void DocumentSourceParallelCollectionScan::runWorkers() {
+    const size_t numWorkers = _partitions.size();
+    _workerOpCtxs.assign(numWorkers, nullptr);
+    _workerStatuses.assign(numWorkers, Status::OK());
+    _workerResults.resize(numWorkers);
+
+    // Each worker outputs partial groups for the merging $group that follows this stage.
+    for (size_t i = 0; i < numWorkers; ++i) {
+        _workerExpCtxs.push_back(pExpCtx->copyWith(_nss, _uuid));
+        _workerExpCtxs.back()->needsMerge = true;
+    }
+
+    auto serviceContext = pExpCtx->opCtx->getServiceContext();
+    const Date_t deadline = pExpCtx->opCtx->getDeadline();
+    try {
+        for (size_t i = 0; i < numWorkers; ++i) {
+            _threads.emplace_back(
+                [this, i, serviceContext, deadline] { runWorker(i, serviceContext, deadline); });
+        }
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        pExpCtx->opCtx->waitForConditionOrInterrupt(
+            _workerFinished, lk, [&] { return _numFinished == _threads.size(); });
+    } catch (...) {
+        stopWorkers();
+        throw;
+    }
+
+    for (auto&& thread : _threads) {
+        thread.join();
+    }
+    _threads.clear();
+
+    for (auto&& status : _workerStatuses) {
+        if (!status.isOK()) {
+            uassertStatusOK(status.withContext("Error in parallel collection scan"));
+        }
+    }
+}
+
+void DocumentSourceParallelCollectionScan::runWorker(size_t workerIndex,
+                                                     ServiceContext* serviceContext,
+                                                     Date_t deadline) {
+    ThreadClient tc(str::stream() << "parallelCollectionScan-" << workerIndex, serviceContext);
+    auto opCtx = tc->makeOperationContext();
+    opCtx->setDeadlineByDate(deadline, ErrorCodes::MaxTimeMSExpired);
+    _workerExpCtxs[workerIndex]->opCtx = opCtx.get();
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _workerOpCtxs[workerIndex] = opCtx.get();
+        if (_stopped) {
+            stdx::lock_guard<Client> clientLock(*tc.get());
+            serviceContext->killOperation(clientLock, opCtx.get());
+        }
+    }
+
+    Status status = Status::OK();
+    std::vector<Document> results;
+    try {
+        results = scanPartition(workerIndex);
+    } catch (const DBException& ex) {
+        status = ex.toStatus();
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _workerOpCtxs[workerIndex] = nullptr;
+    _workerStatuses[workerIndex] = std::move(status);
+    _workerResults[workerIndex] = std::move(results);
+    ++_numFinished;
+    _workerFinished.notify_all();
+}
+
+std::vector<Document> DocumentSourceParallelCollectionScan::scanPartition(size_t workerIndex) {
+    const auto& expCtx = _workerExpCtxs[workerIndex];
+    const auto& partition = _partitions[workerIndex];
+    auto opCtx = expCtx->opCtx;
+
+    auto group = DocumentSourceGroup::createFromBson(_groupSpec.firstElement(), expCtx);
+    intrusive_ptr<DocumentSourceCursor> cursor;
+    {
+        AutoGetCollectionForRead autoColl(opCtx,
+                                          NamespaceStringOrUUID(_nss.db().toString(), _uuid));
+        auto collection = autoColl.getCollection();
+        uassert(ErrorCodes::QueryPlanKilled,
+                str::stream() << "collection " << _nss.ns() << " was dropped during the scan",
+                collection);
+
+        auto qr = stdx::make_unique<QueryRequest>(_nss);
+        qr->setFilter(_query);
+        qr->setCollation(expCtx->getCollator() ? expCtx->getCollator()->getSpec().toBSON()
+                                               : expCtx->collation);
+        const ExtensionsCallbackReal extensionsCallback(opCtx, &_nss);
+        auto cq = uassertStatusOK(CanonicalQuery::canonicalize(
+            opCtx, std::move(qr), expCtx, extensionsCallback, Pipeline::kAllowedMatcherFeatures));
+
+        CollectionScanParams params;
+        params.direction = CollectionScanParams::FORWARD;
+        params.minRecord = partition.min;
+        params.maxRecord = partition.max;
+        auto ws = stdx::make_unique<WorkingSet>();
+        auto root =
+            stdx::make_unique<CollectionScan>(opCtx, collection, params, ws.get(), cq->root());
+        auto exec = uassertStatusOK(PlanExecutor::make(opCtx,
+                                                       std::move(ws),
+                                                       std::move(root),
+                                                       std::move(cq),
+                                                       collection,
+                                                       PlanExecutor::YIELD_AUTO));
+        cursor = DocumentSourceCursor::create(collection, std::move(exec), expCtx);
+    }
+
+    // The cursor acquires the collection lock itself each time it reads a batch.
+    group->setSource(cursor.get());
+    ON_BLOCK_EXIT([&] { group->dispose(); });
+
+    std::vector<Document> results;
+    auto next = group->getNext();
+    for (; next.isAdvanced(); next = group->getNext()) {
+        results.push_back(next.releaseDocument());
+    }
+    invariant(next.isEOF());
+    return results;
+}
+
+void DocumentSourceParallelCollectionScan::stopWorkers() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _stopped = true;
+        for (auto opCtx : _workerOpCtxs) {
+            if (opCtx) {
+                stdx::lock_guard<Client> clientLock(*opCtx->getClient());
+                opCtx->getServiceContext()->killOperation(clientLock, opCtx);
+            }
+        }
+    }
+
+    for (auto&& thread : _threads) {
+        thread.join();
+    }
+    _threads.clear();
+}
+
+}  // namespace mongo
@@ -0,0 +1,169 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/record_id.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/uuid.h"
+
+namespace mongo {
+
+class Collection;
+
+/**
+ * This class is not a registered stage, it is only used by PipelineD as an optimized replacement
+ * for a $cursor stage over a collection scan that feeds a $group. The stage splits the collection
+ * into ranges of RecordIds and scans each range on its own worker thread. Every worker applies the
+ * pipeline's initial query to the documents of its range and computes a partial $group over them.
+ * The stage outputs the partial groups of all workers, which a merging $group that follows it
+ * combines into the final result.
+ */
+class DocumentSourceParallelCollectionScan final : public DocumentSource {
+public:
+    static constexpr StringData kStageName = "$_internalParallelCollectionScan"_sd;
+
+    /**
+     * A range of RecordIds, including 'min' and excluding 'max'. A missing bound leaves that side
+     * of the range open.
+     */
+    struct Partition {
+        boost::optional<RecordId> min;
+        boost::optional<RecordId> max;
+    };
+
+    /**
+     * Splits the RecordIds of 'collection' into at most 'numPartitions' ranges of roughly equal
+     * numbers of records, using a sample taken from a random cursor. Returns a single range
+     * covering the whole collection if the storage engine has no random cursor support.
+     */
+    static std::vector<Partition> partitionRecordIds(OperationContext* opCtx,
+                                                     const Collection* collection,
+                                                     size_t numPartitions);
+
+    /**
+     * Creates a stage that scans 'partitions' of the collection 'nss' with the given 'uuid'.
+     * 'query' is the initial query of the pipeline and 'groupSpec' the serialization of the
+     * $group stage computed by each worker.
+     */
+    static boost::intrusive_ptr<DocumentSourceParallelCollectionScan> create(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        NamespaceString nss,
+        UUID uuid,
+        BSONObj query,
+        BSONObj groupSpec,
+        std::vector<Partition> partitions);
+
+    ~DocumentSourceParallelCollectionScan();
+
+    GetNextResult getNext() final;
+    const char* getSourceName() const final;
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        StageConstraints constraints(StreamType::kBlocking,
+                                     PositionRequirement::kFirst,
+                                     HostTypeRequirement::kAnyShard,
+                                     DiskUseRequirement::kNoDiskUse,
+                                     FacetRequirement::kNotAllowed,
+                                     TransactionRequirement::kNotAllowed);
+
+        constraints.requiresInputDocSource = false;
+        return constraints;
+    }
+
+    boost::optional<MergingLogic> mergingLogic() final {
+        return boost::none;
+    }
+
+protected:
+    void doDispose() final;
+
+private:
+    DocumentSourceParallelCollectionScan(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                         NamespaceString nss,
+                                         UUID uuid,
+                                         BSONObj query,
+                                         BSONObj groupSpec,
+                                         std::vector<Partition> partitions);
+
+    /**
+     * Starts one worker thread per partition and waits until all of them have finished. Throws if
+     * this operation is interrupted or if any worker failed.
+     */
+    void runWorkers();
+
+    /**
+     * Runs on the thread of the worker with index 'workerIndex', which gets its own Client and
+     * OperationContext with the given 'deadline'.
+     */
+    void runWorker(size_t workerIndex, ServiceContext* serviceContext, Date_t deadline);
+
+    /**
+     * Applies the query and a partial $group to the documents of the partition with index
+     * 'workerIndex' and returns the groups.
+     */
+    std::vector<Document> scanPartition(size_t workerIndex);
+
+    /**
+     * Interrupts the operations of all running workers and waits for their threads to exit.
+     */
+    void stopWorkers();
+
+    const NamespaceString _nss;
+    const UUID _uuid;
+    const BSONObj _query;
+    const BSONObj _groupSpec;
+    const std::vector<Partition> _partitions;
+
+    // An ExpressionContext per worker, copied from ours on the thread that owns this stage.
+    std::vector<boost::intrusive_ptr<ExpressionContext>> _workerExpCtxs;
+    std::vector<stdx::thread> _threads;
+
+    // Protects the members below, which the worker threads write to.
+    stdx::mutex _mutex;
+    stdx::condition_variable _workerFinished;
+    size_t _numFinished = 0;
+    bool _stopped = false;
+    std::vector<OperationContext*> _workerOpCtxs;
+    std::vector<Status> _workerStatuses;
+    std::vector<std::vector<Document>> _workerResults;
+
+    // Position in '_workerResults' of the next document to return.
+    size_t _resultWorker = 0;
+    size_t _resultIndex = 0;
+};
+
+}  // namespace mongo
@@ -70,6 +70,21 @@ DocumentSource::GetNextResult DocumentSourceSingleDocumentTransformation::getNex
     return _parsedTransform->applyTransformation(input.releaseDocument());
 }
 
+DocumentSource::GetNextResult::ReturnStatus
+DocumentSourceSingleDocumentTransformation::getNextBatch(size_t maxBatchSize,
+                                                         std::vector<Document>* batch) {
+    pExpCtx->checkForInterrupt();
+
+    // Transform the documents appended by our source in place.
+    const size_t batchStart = batch->size();
+    auto status = pSource->getNextBatch(maxBatchSize, batch);
+    for (auto it = batch->begin() + batchStart; it != batch->end(); ++it) {
+        Document input = std::move(*it);
+        *it = _parsedTransform->applyTransformation(input);
+    }
+    return status;
+}
+
 intrusive_ptr<DocumentSource> DocumentSourceSingleDocumentTransformation::optimize() {
     _parsedTransform->optimize();
     return this;
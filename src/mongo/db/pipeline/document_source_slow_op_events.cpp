@@ -0,0 +1,79 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source_slow_op_events.h"
+
+#include "mongo/db/slow_op_event_buffer.h"
+
+namespace mongo {
+
+REGISTER_DOCUMENT_SOURCE(slowOpEvents,
+                         DocumentSourceSlowOpEvents::LiteParsed::parse,
+                         DocumentSourceSlowOpEvents::createFromBson);
+
+constexpr StringData DocumentSourceSlowOpEvents::kStageName;
+
+DocumentSource::GetNextResult DocumentSourceSlowOpEvents::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    if (_index == _events.size()) {
+        return GetNextResult::makeEOF();
+    }
+    return Document(_events[_index++]);
+}
+
+boost::intrusive_ptr<DocumentSource> DocumentSourceSlowOpEvents::createFromBson(
+    BSONElement spec, const boost::intrusive_ptr<ExpressionContext>& pExpCtx) {
+    uassert(ErrorCodes::FailedToParse,
+            str::stream() << kStageName << " must be specified as an empty object, but found: "
+                          << spec,
+            spec.type() == BSONType::Object && spec.embeddedObject().isEmpty());
+
+    const NamespaceString& nss = pExpCtx->ns;
+    uassert(ErrorCodes::InvalidNamespace,
+            str::stream() << kStageName
+                          << " must be run against the 'admin' database with {aggregate: 1}",
+            nss.db() == NamespaceString::kAdminDb && nss.isCollectionlessAggregateNS());
+
+    auto buffer = SlowOpEventBuffer::get(pExpCtx->opCtx->getServiceContext());
+    uassert(ErrorCodes::IllegalOperation,
+            str::stream() << kStageName
+                          << " requires the slowOpEventBufferSize server parameter to be set",
+            buffer && buffer->isEnabled());
+
+    return new DocumentSourceSlowOpEvents(pExpCtx, buffer->snapshot());
+}
+
+DocumentSourceSlowOpEvents::DocumentSourceSlowOpEvents(
+    const boost::intrusive_ptr<ExpressionContext>& pExpCtx, std::vector<BSONObj> events)
+    : DocumentSource(pExpCtx), _events(std::move(events)) {}
+
+}  // namespace mongo
@@ -40,6 +40,7 @@
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/query/collation/collation_index_key.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/platform/overflow_arithmetic.h"
 #include "mongo/s/query/document_source_merge_cursors.h"
 
@@ -316,6 +317,14 @@ intrusive_ptr<DocumentSourceSort> DocumentSourceSort::create(
         pSort->sortKeyPattern(SortKeySerialization::kForPipelineSerialization).toBson(),
         pExpCtx->getCollator()};
 
+    if (pSort->_sortPattern.size() <= Ordering::kMaxCompoundIndexKeys) {
+        BSONObjBuilder orderingBuilder;
+        for (auto&& patternPart : pSort->_sortPattern) {
+            orderingBuilder.append("", patternPart.isAscending ? 1 : -1);
+        }
+        pSort->_keyOrdering = Ordering::make(orderingBuilder.done());
+    }
+
     if (limit > 0) {
         pSort->setLimitSrc(DocumentSourceLimit::create(pExpCtx, limit));
     }
@@ -492,10 +501,43 @@ std::pair<Value, Document> DocumentSourceSort::extractSortKey(Document&& doc) co
         invariant(serializedSortKey);
         toBeSorted.setSortKeyMetaField(*serializedSortKey);
     }
+
+    if (_keyOrdering) {
+        inMemorySortKey = encodeSortKey(inMemorySortKey);
+    }
     return {inMemorySortKey, toBeSorted.freeze()};
 }
 
+Value DocumentSourceSort::encodeSortKey(const Value& inMemorySortKey) const {
+    BSONObjBuilder keyBuilder;
+    auto appendPart = [&keyBuilder](const Value& part) {
+        if (part.missing()) {
+            // Missing sorts before null, as undefined does, but cannot be stored in BSON.
+            keyBuilder.appendUndefined("");
+        } else {
+            part.addToBsonObj(&keyBuilder, ""_sd);
+        }
+    };
+
+    if (_sortPattern.size() == 1) {
+        appendPart(inMemorySortKey);
+    } else {
+        for (auto&& part : inMemorySortKey.getArray()) {
+            appendPart(part);
+        }
+    }
+
+    KeyString encoded(KeyString::Version::V1, keyBuilder.done(), *_keyOrdering);
+    return Value(StringData(encoded.getBuffer(), encoded.getSize()));
+}
+
 int DocumentSourceSort::compare(const Value& lhs, const Value& rhs) const {
+    if (_keyOrdering) {
+        // The keys were encoded by encodeSortKey(), in which the direction of each part is already
+        // accounted for.
+        return lhs.getStringData().compare(rhs.getStringData());
+    }
+
     // DocumentSourceSort::populate() has already guaranteed that the sort key is non-empty.
     // However, the tricky part is deciding what to do if none of the sort keys are present. In that
     // case, consider the document "less".
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include "mongo/bson/ordering.h"
 #include "mongo/db/index/sort_key_generator.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_limit.h"
@@ -228,6 +229,12 @@ private:
      */
     Value getCollationComparisonKey(const Value& val) const;
 
+    /**
+     * Encodes an in-memory sort key as a KeyString in the order of '_keyOrdering', returned as a
+     * string Value so that sort keys compare with a single memcmp.
+     */
+    Value encodeSortKey(const Value& inMemorySortKey) const;
+
     int compare(const Value& lhs, const Value& rhs) const;
 
     /**
@@ -248,6 +255,10 @@ private:
 
     SortPattern _sortPattern;
 
+    // Set if '_sortPattern' has few enough parts to encode sort keys as KeyStrings, in which case
+    // the keys held by '_sorter' are encoded by encodeSortKey().
+    boost::optional<Ordering> _keyOrdering;
+
     // The set of paths on which we're sorting.
     std::set<std::string> _paths;
 
@@ -304,6 +304,28 @@ TEST_F(DocumentSourceSortExecutionTest, NullValue) {
                  "[{_id:1,a:null},{_id:0,a:1}]");
 }
 
+/** A missing value sorts before null, as it does when comparing Values. */
+TEST_F(DocumentSourceSortExecutionTest, MissingValueSortsBeforeNull) {
+    checkResults({Document{{"_id", 0}, {"a", BSONNULL}}, Document{{"_id", 1}}},
+                 BSON("a" << 1),
+                 "[{_id:1},{_id:0,a:null}]");
+    checkResults({Document{{"_id", 0}}, Document{{"_id", 1}, {"a", BSONNULL}}},
+                 BSON("a" << -1),
+                 "[{_id:1,a:null},{_id:0}]");
+}
+
+/** A pattern with too many fields to encode its keys as KeyStrings is still sorted correctly. */
+TEST_F(DocumentSourceSortExecutionTest, PatternWithMoreFieldsThanAnOrderingAllows) {
+    BSONObjBuilder pattern;
+    for (size_t i = 0; i < Ordering::kMaxCompoundIndexKeys; ++i) {
+        pattern.append(std::string(str::stream() << "f" << i), 1);
+    }
+    pattern.append("a", -1);
+    checkResults({Document{{"_id", 0}, {"a", 1}}, Document{{"_id", 1}, {"a", 2}}},
+                 pattern.obj(),
+                 "[{_id:1,a:2},{_id:0,a:1}]");
+}
+
 /**
  * Order by text score.
  */
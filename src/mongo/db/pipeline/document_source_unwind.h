@@ -90,6 +90,14 @@ public:
         return _indexPath;
     }
 
+protected:
+    /**
+     * Attempts to hand the unwinding over to a subsequent $group stage, removing this stage from
+     * the pipeline.
+     */
+    Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
+                                                     Pipeline::SourceContainer* container) final;
+
 private:
     DocumentSourceUnwind(const boost::intrusive_ptr<ExpressionContext>& pExpCtx,
                          const FieldPath& fieldPath,
@@ -95,6 +95,50 @@ TEST(DocumentConstruction, FromNonEmptyBson) {
     ASSERT_EQUALS("q", getNthField(document, 1).second.getString());
 }
 
+TEST(DocumentConstruction, FromBsonLooksUpFieldsBeforeIterating) {
+    BSONObj obj = BSON("a" << 1 << "b" << BSON("c" << 2 << "d" << 3) << "e"
+                           << "x"
+                           << "a" << 4);
+    Document document = fromBson(obj);
+
+    // Look up fields out of order, including missing and duplicated ones.
+    ASSERT_EQUALS("x", document["e"].getString());
+    ASSERT_VALUE_EQ(mongo::Value(), document["f"]);
+    ASSERT_EQUALS(3, document.getNestedField(FieldPath("b.d")).getInt());
+    ASSERT_VALUE_EQ(mongo::Value(), document.getNestedField(FieldPath("b.z")));
+    ASSERT_EQUALS(1, document["a"].getInt());
+
+    // Iteration still sees every field once, in the original order.
+    ASSERT_EQUALS(4U, document.size());
+    ASSERT_EQUALS("a", getNthField(document, 0).first.toString());
+    ASSERT_EQUALS("b", getNthField(document, 1).first.toString());
+    ASSERT_EQUALS("e", getNthField(document, 2).first.toString());
+    ASSERT_EQUALS("a", getNthField(document, 3).first.toString());
+    ASSERT_EQUALS(4, getNthField(document, 3).second.getInt());
+    ASSERT_BSONOBJ_EQ(obj, toBson(document));
+}
+
+TEST(DocumentConstruction, FromBsonReusesObjectUntilModified) {
+    BSONObj obj = BSON("a" << 1 << "b" << BSON("c" << 2));
+    Document document = fromBson(obj);
+    ASSERT_EQUALS(2, document["b"]["c"].getInt());
+    ASSERT_EQUALS(obj.objdata(), toBson(document).objdata());
+
+    // A copy that is written to serializes its own fields, while the original is unchanged.
+    MutableDocument md(document);
+    md["b"]["c"] = mongo::Value(5);
+    Document modified = md.freeze();
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1 << "b" << BSON("c" << 5)), toBson(modified));
+    ASSERT_NOT_EQUALS(obj.objdata(), toBson(modified).objdata());
+    ASSERT_EQUALS(obj.objdata(), toBson(document).objdata());
+
+    // An unowned object is copied.
+    BSONObj unowned(obj.objdata());
+    Document fromUnowned = fromBson(unowned);
+    ASSERT_NOT_EQUALS(obj.objdata(), toBson(fromUnowned).objdata());
+    ASSERT_BSONOBJ_EQ(obj, toBson(fromUnowned));
+}
+
 TEST(DocumentConstruction, FromInitializerList) {
     auto document = Document{{"a", 1}, {"b", "q"_sd}};
     ASSERT_EQUALS(2U, document.size());
@@ -744,6 +744,29 @@ Value ExpressionCoerceToBool::serialize(bool explain) const {
     return Value(DOC(name << DOC_ARRAY(pExpression->serialize(explain))));
 }
 
+/* ------------------- ExpressionCommonSubexpression ------------------- */
+
+intrusive_ptr<Expression> ExpressionCommonSubexpression::optimize() {
+    // The wrapped expression was already optimized before it was shared. Optimizing it again could
+    // replace it with an expression that no longer shares this cache, so leave it as it is.
+    return this;
+}
+
+void ExpressionCommonSubexpression::_doAddDependencies(DepsTracker* deps) const {
+    _expression->addDependencies(deps);
+}
+
+Value ExpressionCommonSubexpression::evaluate(const Document& root) const {
+    if (!_cachedResult) {
+        _cachedResult = _expression->evaluate(root);
+    }
+    return *_cachedResult;
+}
+
+Value ExpressionCommonSubexpression::serialize(bool explain) const {
+    return _expression->serialize(explain);
+}
+
 /* ----------------------- ExpressionCompare --------------------------- */
 
 namespace {
@@ -301,6 +301,15 @@ public:
         return vpOperand;
     }
 
+    /**
+     * Replaces the operand at position 'index' with 'operand', which must evaluate to the same
+     * value as the operand it replaces.
+     */
+    void setOperand(size_t index, boost::intrusive_ptr<Expression> operand) {
+        invariant(index < vpOperand.size());
+        vpOperand[index] = std::move(operand);
+    }
+
 protected:
     explicit ExpressionNary(const boost::intrusive_ptr<ExpressionContext>& expCtx)
         : Expression(expCtx) {}
@@ -890,6 +899,51 @@ private:
 };
 
 
+/**
+ * Wraps a subexpression which appears more than once within the same projection, so that it is
+ * evaluated at most once per input document. The cached result is only valid for the document it
+ * was computed from: the owner of the projection must call reset() before evaluating it against
+ * each new document. Serializes as the wrapped expression.
+ */
+class ExpressionCommonSubexpression final : public Expression {
+public:
+    ExpressionCommonSubexpression(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                  boost::intrusive_ptr<Expression> expression)
+        : Expression(expCtx), _expression(std::move(expression)) {}
+
+    boost::intrusive_ptr<Expression> optimize() final;
+    Value evaluate(const Document& root) const final;
+    Value serialize(bool explain) const final;
+
+    ComputedPaths getComputedPaths(const std::string& exprFieldPath,
+                                   Variables::Id renamingVar) const final {
+        return _expression->getComputedPaths(exprFieldPath, renamingVar);
+    }
+
+    /**
+     * Discards the cached result, so that the next call to evaluate() recomputes it.
+     */
+    void reset() const {
+        _cachedResult = boost::none;
+    }
+
+    const boost::intrusive_ptr<Expression>& getExpression() const {
+        return _expression;
+    }
+
+    void acceptVisitor(ExpressionVisitor* visitor) final {
+        return visitor->visit(this);
+    }
+
+protected:
+    void _doAddDependencies(DepsTracker* deps) const final;
+
+private:
+    boost::intrusive_ptr<Expression> _expression;
+    mutable boost::optional<Value> _cachedResult;
+};
+
+
 class ExpressionCompare final : public ExpressionFixedArity<ExpressionCompare, 2> {
 public:
     /**
@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/json.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+
+namespace mongo {
+namespace {
+
+std::vector<Document> makeDocuments() {
+    std::vector<Document> docs;
+    for (int i = 0; i < 100; ++i) {
+        const std::vector<Value> scores{Value(i % 10), Value(50), Value(95)};
+        docs.push_back(Document{{"_id", i},
+                                {"name", "user" + std::to_string(i)},
+                                {"price", 1.25 * (i % 40)},
+                                {"qty", i % 7},
+                                {"address", Document{{"city", "Springfield"}, {"zip", 10000 + i}}},
+                                {"scores", scores}});
+    }
+    return docs;
+}
+
+void runExpressionBenchmark(benchmark::State& state, const char* expression) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    const BSONObj spec = fromjson(expression);
+    auto expr = Expression::parseOperand(expCtx, spec.firstElement(), expCtx->variablesParseState)
+                    ->optimize();
+    const auto docs = makeDocuments();
+
+    for (auto _ : state) {
+        for (auto&& doc : docs) {
+            benchmark::DoNotOptimize(expr->evaluate(doc));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * docs.size());
+}
+
+void BM_EvaluateFieldPath(benchmark::State& state) {
+    runExpressionBenchmark(state, "{expr: '$address.zip'}");
+}
+
+void BM_EvaluateArithmetic(benchmark::State& state) {
+    runExpressionBenchmark(state, "{expr: {$add: [{$multiply: ['$price', '$qty']}, 1]}}");
+}
+
+void BM_EvaluateConcat(benchmark::State& state) {
+    runExpressionBenchmark(state, "{expr: {$concat: [{$toUpper: '$name'}, '@', '$address.city']}}");
+}
+
+void BM_EvaluateCond(benchmark::State& state) {
+    runExpressionBenchmark(
+        state, "{expr: {$cond: {if: {$gte: ['$qty', 3]}, then: 'bulk', else: 'single'}}}");
+}
+
+void BM_EvaluateFilterArray(benchmark::State& state) {
+    runExpressionBenchmark(
+        state, "{expr: {$size: {$filter: {input: '$scores', cond: {$gte: ['$$this', 50]}}}}}");
+}
+
+void BM_EvaluateObject(benchmark::State& state) {
+    runExpressionBenchmark(
+        state, "{expr: {total: {$multiply: ['$price', '$qty']}, zip: '$address.zip'}}");
+}
+
+BENCHMARK(BM_EvaluateFieldPath);
+BENCHMARK(BM_EvaluateArithmetic);
+BENCHMARK(BM_EvaluateConcat);
+BENCHMARK(BM_EvaluateCond);
+BENCHMARK(BM_EvaluateFilterArray);
+BENCHMARK(BM_EvaluateObject);
+
+}  // namespace
+}  // namespace mongo
@@ -49,6 +49,7 @@ class ExpressionObjectToArray;
 class ExpressionArrayToObject;
 class ExpressionCeil;
 class ExpressionCoerceToBool;
+class ExpressionCommonSubexpression;
 class ExpressionCompare;
 class ExpressionConcat;
 class ExpressionConcatArrays;
@@ -176,6 +177,7 @@ public:
     virtual void visit(ExpressionArrayToObject*) = 0;
     virtual void visit(ExpressionCeil*) = 0;
     virtual void visit(ExpressionCoerceToBool*) = 0;
+    virtual void visit(ExpressionCommonSubexpression*) = 0;
     virtual void visit(ExpressionCompare*) = 0;
     virtual void visit(ExpressionConcat*) = 0;
     virtual void visit(ExpressionConcatArrays*) = 0;
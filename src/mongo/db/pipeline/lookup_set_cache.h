@@ -36,6 +36,7 @@
 #include <boost/multi_index/sequenced_index.hpp>
 #include <boost/multi_index_container.hpp>
 #include <boost/optional.hpp>
+#include <iterator>
 #include <vector>
 
 #include "mongo/base/string_data_comparator_interface.h"
@@ -122,6 +123,33 @@ public:
         _memoryUsage += docSize;
     }
 
+    /**
+     * Insert "docs" into the set with key "key", creating the entry even if "docs" is empty so that
+     * an empty result can be looked up later. Follows the same placement rules as the single
+     * document overload above.
+     */
+    void insert(Value key, std::vector<Document> docs) {
+        size_t middle = size() / 2;
+        auto it = _container.begin();
+        std::advance(it, middle);
+        const auto keySize = key.getApproximateSize();
+
+        auto insertionResult = _container.insert(it, {std::move(key), {}});
+        if (insertionResult.second) {
+            _memoryUsage += keySize;
+        } else {
+            _container.relocate(it, insertionResult.first);
+        }
+
+        for (auto&& doc : docs) {
+            _memoryUsage += doc.getApproximateSize();
+        }
+        _container.modify(insertionResult.first,
+                          [&docs](std::pair<Value, std::vector<Document>>& entry) {
+                              std::move(docs.begin(), docs.end(), std::back_inserter(entry.second));
+                          });
+    }
+
     /**
      * Evict the least-recently-used item.
      */
@@ -269,6 +269,19 @@ public:
         boost::optional<BSONObj> readConcern,
         bool allowSpeculativeMajorityRead = false) = 0;
 
+    /**
+     * Returns every document which lookupSingleDocument() would return for any of the document keys
+     * in 'documentKeys', in no particular order, using as few queries as possible. Returns an empty
+     * vector if the given namespace does not exist.
+     */
+    virtual std::vector<Document> lookupDocuments(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        const NamespaceString& nss,
+        UUID,
+        const std::vector<Document>& documentKeys,
+        boost::optional<BSONObj> readConcern,
+        bool allowSpeculativeMajorityRead = false) = 0;
+
     /**
      * Returns a vector of all idle (non-pinned) local cursors.
      */
@@ -242,6 +242,117 @@ boost::optional<Document> MongoSInterface::lookupSingleDocument(
     return (!batch.empty() ? Document(batch.front()) : boost::optional<Document>{});
 }
 
+std::vector<Document> MongoSInterface::lookupDocuments(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    UUID collectionUUID,
+    const std::vector<Document>& documentKeys,
+    boost::optional<BSONObj> readConcern,
+    bool allowSpeculativeMajorityRead) {
+    auto foreignExpCtx = expCtx->copyWith(nss, collectionUUID);
+    auto executor = Grid::get(expCtx->opCtx)->getExecutorPool()->getArbitraryExecutor();
+
+    size_t numAttempts = 0;
+    while (++numAttempts <= kMaxNumStaleVersionRetries) {
+        // Verify that the collection exists, with the correct UUID.
+        auto catalogCache = Grid::get(expCtx->opCtx)->catalogCache();
+        auto swRoutingInfo = getCollectionRoutingInfo(foreignExpCtx);
+        if (swRoutingInfo == ErrorCodes::NamespaceNotFound) {
+            return {};
+        }
+        auto routingInfo = uassertStatusOK(std::move(swRoutingInfo));
+
+        // Group the document keys by the shard which owns each of them. Find by UUID and shard
+        // versioning do not work together (SERVER-31946), so the find is only by UUID if the
+        // collection is unsharded. See lookupSingleDocument() for why this is safe.
+        std::map<ShardId, std::pair<ChunkVersion, std::vector<size_t>>> keysByShard;
+        for (size_t i = 0; i < documentKeys.size(); ++i) {
+            auto shardInfo = getSingleTargetedShardForQuery(
+                expCtx->opCtx, routingInfo, documentKeys[i].toBson());
+            auto& shardKeys = keysByShard[shardInfo.first];
+            shardKeys.first = shardInfo.second;
+            shardKeys.second.push_back(i);
+        }
+
+        std::vector<std::pair<ShardId, BSONObj>> requests;
+        for (auto&& shardKeys : keysByShard) {
+            BSONObjBuilder cmdBuilder;
+            if (foreignExpCtx->uuid && !routingInfo.cm()) {
+                foreignExpCtx->uuid->appendToBuilder(&cmdBuilder, "find");
+            } else {
+                cmdBuilder.append("find", nss.coll());
+            }
+            BSONObjBuilder filterBuilder(cmdBuilder.subobjStart("filter"));
+            BSONArrayBuilder orBuilder(filterBuilder.subarrayStart("$or"));
+            for (auto i : shardKeys.second.second) {
+                orBuilder << documentKeys[i].toBson();
+            }
+            orBuilder.doneFast();
+            filterBuilder.doneFast();
+            cmdBuilder.append("batchSize", static_cast<long long>(shardKeys.second.second.size()));
+            cmdBuilder.append("comment", expCtx->comment);
+            if (readConcern) {
+                cmdBuilder.append(repl::ReadConcernArgs::kReadConcernFieldName, *readConcern);
+            }
+            if (allowSpeculativeMajorityRead) {
+                cmdBuilder.append("allowSpeculativeMajorityRead", true);
+            }
+            requests.emplace_back(shardKeys.first,
+                                  appendShardVersion(cmdBuilder.obj(), shardKeys.second.first));
+        }
+
+        // Dispatch the requests to all of the targeted shards in parallel.
+        std::vector<RemoteCursor> shardResults;
+        try {
+            shardResults = establishCursors(expCtx->opCtx,
+                                            executor,
+                                            nss,
+                                            ReadPreferenceSetting::get(expCtx->opCtx),
+                                            requests,
+                                            false);
+        } catch (const ExceptionFor<ErrorCodes::NamespaceNotFound>&) {
+            // If it's an unsharded collection which has been deleted and re-created, we may get a
+            // NamespaceNotFound error when looking up by UUID.
+            return {};
+        } catch (const ExceptionForCat<ErrorCategory::StaleShardVersionError>&) {
+            // If we hit a stale shardVersion exception, invalidate the routing table cache.
+            catalogCache->onStaleShardVersion(std::move(routingInfo));
+            continue;  // Try again if allowed.
+        }
+
+        std::vector<Document> lookedUpDocuments;
+        for (auto&& shardResult : shardResults) {
+            auto& cursor = shardResult.getCursorResponse();
+            if (cursor.getCursorId() == 0) {
+                for (auto&& obj : cursor.getBatch()) {
+                    lookedUpDocuments.emplace_back(obj.getOwned());
+                }
+                continue;
+            }
+
+            // The matching documents did not fit in a single batch. Rather than iterating the
+            // cursor, close it and look up each of this shard's documents individually.
+            const auto shardId = ShardId(shardResult.getShardId().toString());
+            killRemoteCursor(expCtx->opCtx, executor, std::move(shardResult), nss);
+            for (auto i : keysByShard[shardId].second) {
+                if (auto doc = lookupSingleDocument(expCtx,
+                                                    nss,
+                                                    collectionUUID,
+                                                    documentKeys[i],
+                                                    readConcern,
+                                                    allowSpeculativeMajorityRead)) {
+                    lookedUpDocuments.push_back(std::move(*doc));
+                }
+            }
+        }
+        return lookedUpDocuments;
+    }
+
+    uasserted(ErrorCodes::StaleShardVersion,
+              str::stream() << "Exceeded the maximum number of retries looking up documents in "
+                            << nss.ns());
+}
+
 BSONObj MongoSInterface::_reportCurrentOpForClient(OperationContext* opCtx,
                                                    Client* client,
                                                    CurrentOpTruncateMode truncateOps) const {
@@ -0,0 +1,169 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/out_stage_parallel_writer.h"
+
+#include "mongo/db/client.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+
+OutStageParallelWriter::OutStageParallelWriter(OperationContext* opCtx,
+                                               size_t numWriters,
+                                               WriteBatchFn writeBatch)
+    : _maxQueuedBatches(2 * numWriters),
+      _writeBatch(std::move(writeBatch)),
+      _writerOpCtxs(numWriters, nullptr),
+      _writerStatuses(numWriters, Status::OK()) {
+    invariant(numWriters > 0);
+
+    auto serviceContext = opCtx->getServiceContext();
+    const Date_t deadline = opCtx->getDeadline();
+    try {
+        for (size_t i = 0; i < numWriters; ++i) {
+            _threads.emplace_back(
+                [this, i, serviceContext, deadline] { _runWriter(i, serviceContext, deadline); });
+        }
+    } catch (...) {
+        _stopWriters();
+        throw;
+    }
+}
+
+OutStageParallelWriter::~OutStageParallelWriter() {
+    _stopWriters();
+}
+
+void OutStageParallelWriter::write(OperationContext* opCtx, std::vector<BSONObj> batch) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    invariant(!_noMoreBatches);
+    opCtx->waitForConditionOrInterrupt(_batchTaken, lk, [&] {
+        return _queue.size() < _maxQueuedBatches || _numFinished > 0;
+    });
+
+    // A writer only exits early if it failed.
+    _throwIfAnyWriterFailed();
+    _queue.push_back(std::move(batch));
+    _batchQueued.notify_one();
+}
+
+void OutStageParallelWriter::finish(OperationContext* opCtx) {
+    {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _noMoreBatches = true;
+        _batchQueued.notify_all();
+        opCtx->waitForConditionOrInterrupt(
+            _writerFinished, lk, [&] { return _numFinished == _threads.size(); });
+        _throwIfAnyWriterFailed();
+    }
+
+    for (auto&& thread : _threads) {
+        thread.join();
+    }
+    _threads.clear();
+}
+
+void OutStageParallelWriter::_runWriter(size_t writerIndex,
+                                        ServiceContext* serviceContext,
+                                        Date_t deadline) {
+    ThreadClient tc(str::stream() << "outWriter-" << writerIndex, serviceContext);
+    auto opCtx = tc->makeOperationContext();
+    opCtx->setDeadlineByDate(deadline, ErrorCodes::MaxTimeMSExpired);
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _writerOpCtxs[writerIndex] = opCtx.get();
+        if (_stopped) {
+            stdx::lock_guard<Client> clientLock(*tc.get());
+            serviceContext->killOperation(clientLock, opCtx.get());
+        }
+    }
+
+    Status status = Status::OK();
+    try {
+        while (true) {
+            std::vector<BSONObj> batch;
+            {
+                stdx::unique_lock<stdx::mutex> lk(_mutex);
+                opCtx->waitForConditionOrInterrupt(
+                    _batchQueued, lk, [&] { return !_queue.empty() || _noMoreBatches; });
+                if (_queue.empty()) {
+                    break;
+                }
+                batch = std::move(_queue.front());
+                _queue.pop_front();
+                _batchTaken.notify_one();
+            }
+            _writeBatch(writerIndex, opCtx.get(), std::move(batch));
+        }
+    } catch (const DBException& ex) {
+        status = ex.toStatus();
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _writerOpCtxs[writerIndex] = nullptr;
+    _writerStatuses[writerIndex] = std::move(status);
+    ++_numFinished;
+    _writerFinished.notify_all();
+    _batchTaken.notify_all();
+}
+
+void OutStageParallelWriter::_throwIfAnyWriterFailed() const {
+    for (auto&& status : _writerStatuses) {
+        if (!status.isOK()) {
+            uassertStatusOK(status.withContext("Error in parallel $out writer"));
+        }
+    }
+}
+
+void OutStageParallelWriter::_stopWriters() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _stopped = true;
+        for (auto opCtx : _writerOpCtxs) {
+            if (opCtx) {
+                stdx::lock_guard<Client> clientLock(*opCtx->getClient());
+                opCtx->getServiceContext()->killOperation(clientLock, opCtx);
+            }
+        }
+    }
+
+    for (auto&& thread : _threads) {
+        thread.join();
+    }
+    _threads.clear();
+}
+
+}  // namespace mongo
@@ -0,0 +1,122 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "mongo/base/status.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Hands batches of documents produced by a $out stage to a fixed number of writer threads, which
+ * write them concurrently. Each writer has its own Client and OperationContext, which inherits the
+ * deadline of the aggregation, and takes the next queued batch whenever it finishes one. At most
+ * two batches per writer are queued at a time, so the producer blocks once the writers fall
+ * behind.
+ *
+ * Batches are written in no particular order, so this must only be used for writes whose outcome
+ * does not depend on their order, such as inserts into a collection that no one else writes to.
+ */
+class OutStageParallelWriter {
+public:
+    /**
+     * Writes 'batch' on the thread of the writer with index 'writerIndex', using its
+     * OperationContext 'opCtx'.
+     */
+    using WriteBatchFn = std::function<void(
+        size_t writerIndex, OperationContext* opCtx, std::vector<BSONObj> batch)>;
+
+    OutStageParallelWriter(OperationContext* opCtx, size_t numWriters, WriteBatchFn writeBatch);
+
+    /**
+     * Interrupts any writers that are still running and waits for their threads to exit.
+     */
+    ~OutStageParallelWriter();
+
+    /**
+     * Queues 'batch' to be written, first waiting for space in the queue. Throws if 'opCtx' is
+     * interrupted while waiting, or if a writer has failed.
+     */
+    void write(OperationContext* opCtx, std::vector<BSONObj> batch);
+
+    /**
+     * Waits until all of the queued batches are written and the writers have exited. Throws the
+     * first error that any of the writers failed with.
+     */
+    void finish(OperationContext* opCtx);
+
+private:
+    /**
+     * Runs on the thread of the writer with index 'writerIndex', which gets its own Client and
+     * OperationContext with the given 'deadline'.
+     */
+    void _runWriter(size_t writerIndex, ServiceContext* serviceContext, Date_t deadline);
+
+    /**
+     * Throws the first error that a writer failed with, if any. Must hold '_mutex'.
+     */
+    void _throwIfAnyWriterFailed() const;
+
+    /**
+     * Interrupts the operations of all running writers and waits for their threads to exit.
+     */
+    void _stopWriters();
+
+    const size_t _maxQueuedBatches;
+    const WriteBatchFn _writeBatch;
+
+    std::vector<stdx::thread> _threads;
+
+    // Protects the members below, which the writer threads also access.
+    stdx::mutex _mutex;
+    stdx::condition_variable _batchQueued;
+    stdx::condition_variable _batchTaken;
+    stdx::condition_variable _writerFinished;
+    std::deque<std::vector<BSONObj>> _queue;
+    size_t _numFinished = 0;
+    bool _noMoreBatches = false;
+    bool _stopped = false;
+    std::vector<OperationContext*> _writerOpCtxs;
+    std::vector<Status> _writerStatuses;
+};
+
+}  // namespace mongo
@@ -84,6 +84,7 @@ void ParsedAddFields::parse(const BSONObj& spec) {
 Document ParsedAddFields::applyProjection(const Document& inputDoc) const {
     // The output doc is the same as the input doc, with the added fields.
     MutableDocument output(inputDoc);
+    _root->resetCommonSubexpressions();
     _root->applyExpressions(inputDoc, &output);
 
     // Pass through the metadata.
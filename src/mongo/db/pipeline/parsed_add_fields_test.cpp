@@ -534,6 +534,42 @@ TEST(ParsedAddFieldsExecutionTest, AddsNestedAddedFieldsInOrderSpecified) {
     ASSERT_DOCUMENT_EQ(result, expectedResult);
 }
 
+// Verify that subexpressions shared between computed fields are evaluated afresh for each document.
+TEST(ParsedAddFieldsExecutionTest, ShouldReevaluateCommonSubexpressionsForEachDocument) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    ParsedAddFields addition(expCtx);
+    addition.parse(fromjson(
+        "{a: {$add: [{$multiply: ['$x', '$y']}, 1]}, b: {$multiply: ['$x', '$y']},"
+        " 'c.d': {$multiply: ['$x', '$y']},"
+        " e: {$map: {input: [1, 2], in: {$add: ['$$this', '$x']}}},"
+        " f: {$map: {input: [3], in: {$add: ['$$this', '$x']}}}}"));
+    const auto serializationBeforeOptimize = addition.serializeTransformation(boost::none);
+    addition.optimize();
+
+    // Sharing subexpressions must not change the serialized form of the projection.
+    ASSERT_DOCUMENT_EQ(serializationBeforeOptimize, addition.serializeTransformation(boost::none));
+
+    auto result = addition.applyProjection(Document{{"x", 2}, {"y", 3}});
+    auto expectedResult = Document{{"x", 2},
+                                   {"y", 3},
+                                   {"a", 7},
+                                   {"b", 6},
+                                   {"c", Document{{"d", 6}}},
+                                   {"e", Value(vector<Value>{Value(3), Value(4)})},
+                                   {"f", Value(vector<Value>{Value(5)})}};
+    ASSERT_DOCUMENT_EQ(result, expectedResult);
+
+    result = addition.applyProjection(Document{{"x", 4}, {"y", 5}});
+    expectedResult = Document{{"x", 4},
+                              {"y", 5},
+                              {"a", 21},
+                              {"b", 20},
+                              {"c", Document{{"d", 20}}},
+                              {"e", Value(vector<Value>{Value(5), Value(6)})},
+                              {"f", Value(vector<Value>{Value(7)})}};
+    ASSERT_DOCUMENT_EQ(result, expectedResult);
+}
+
 //
 // Misc/Metadata.
 //
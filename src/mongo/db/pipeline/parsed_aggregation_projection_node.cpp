@@ -31,6 +31,8 @@
 
 #include "mongo/db/pipeline/parsed_aggregation_projection_node.h"
 
+#include "mongo/db/pipeline/dependencies.h"
+
 namespace mongo {
 namespace parsed_aggregation_projection {
 
@@ -233,6 +235,124 @@ void ProjectionNode::optimize() {
     }
 }
 
+namespace {
+/**
+ * Returns a key identifying 'expr' by its serialized form, or boost::none if 'expr' should never be
+ * shared. Constants and field paths are cheaper to evaluate than to share, and expressions which
+ * reference user variables, such as the "in" argument of $map, can't be cached per document.
+ */
+boost::optional<std::string> getCommonSubexpressionKey(
+    const boost::intrusive_ptr<Expression>& expr) {
+    if (dynamic_cast<ExpressionConstant*>(expr.get()) ||
+        dynamic_cast<ExpressionFieldPath*>(expr.get()) ||
+        dynamic_cast<ExpressionCommonSubexpression*>(expr.get())) {
+        return boost::none;
+    }
+    DepsTracker deps;
+    expr->addDependencies(&deps);
+    if (!deps.vars.empty()) {
+        return boost::none;
+    }
+    const auto serialized = Document{{"", expr->serialize(false)}}.toBson();
+    return std::string(serialized.objdata(), serialized.objsize());
+}
+
+void countSubexpressionsOf(const boost::intrusive_ptr<Expression>& expr, StringMap<int>* counts) {
+    if (auto key = getCommonSubexpressionKey(expr)) {
+        ++(*counts)[*key];
+    }
+    if (auto nary = dynamic_cast<ExpressionNary*>(expr.get())) {
+        for (auto&& operand : nary->getOperandList()) {
+            countSubexpressionsOf(operand, counts);
+        }
+    }
+}
+
+boost::intrusive_ptr<Expression> replaceCommonSubexpressionsOf(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    boost::intrusive_ptr<Expression> expr,
+    const StringMap<int>& counts,
+    StringMap<boost::intrusive_ptr<ExpressionCommonSubexpression>>* shared);
+
+void replaceCommonSubexpressionsInOperands(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const boost::intrusive_ptr<Expression>& expr,
+    const StringMap<int>& counts,
+    StringMap<boost::intrusive_ptr<ExpressionCommonSubexpression>>* shared) {
+    if (auto nary = dynamic_cast<ExpressionNary*>(expr.get())) {
+        for (size_t i = 0; i < nary->getOperandList().size(); ++i) {
+            nary->setOperand(i,
+                             replaceCommonSubexpressionsOf(
+                                 expCtx, nary->getOperandList()[i], counts, shared));
+        }
+    }
+}
+
+boost::intrusive_ptr<Expression> replaceCommonSubexpressionsOf(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    boost::intrusive_ptr<Expression> expr,
+    const StringMap<int>& counts,
+    StringMap<boost::intrusive_ptr<ExpressionCommonSubexpression>>* shared) {
+    auto key = getCommonSubexpressionKey(expr);
+    if (!key || counts.find(*key)->second < 2) {
+        replaceCommonSubexpressionsInOperands(expCtx, expr, counts, shared);
+        return expr;
+    }
+    auto& sharedExpr = (*shared)[*key];
+    if (!sharedExpr) {
+        // The first occurrence becomes the shared expression, so it may itself contain
+        // subexpressions which are shared with other parts of the projection.
+        replaceCommonSubexpressionsInOperands(expCtx, expr, counts, shared);
+        sharedExpr = new ExpressionCommonSubexpression(expCtx, expr);
+    }
+    return sharedExpr;
+}
+}  // namespace
+
+void ProjectionNode::shareCommonSubexpressions(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    if (_sharedCommonSubexpressions) {
+        return;
+    }
+    _sharedCommonSubexpressions = true;
+
+    StringMap<int> counts;
+    countSubexpressions(&counts);
+    StringMap<boost::intrusive_ptr<ExpressionCommonSubexpression>> shared;
+    replaceCommonSubexpressions(expCtx, counts, &shared);
+    for (auto&& sharedPair : shared) {
+        _commonSubexpressions.push_back(std::move(sharedPair.second));
+    }
+}
+
+void ProjectionNode::resetCommonSubexpressions() const {
+    for (auto&& expr : _commonSubexpressions) {
+        expr->reset();
+    }
+}
+
+void ProjectionNode::countSubexpressions(StringMap<int>* counts) const {
+    for (auto&& expressionIt : _expressions) {
+        countSubexpressionsOf(expressionIt.second, counts);
+    }
+    for (auto&& childPair : _children) {
+        childPair.second->countSubexpressions(counts);
+    }
+}
+
+void ProjectionNode::replaceCommonSubexpressions(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const StringMap<int>& counts,
+    StringMap<boost::intrusive_ptr<ExpressionCommonSubexpression>>* shared) {
+    for (auto&& expressionIt : _expressions) {
+        expressionIt.second =
+            replaceCommonSubexpressionsOf(expCtx, expressionIt.second, counts, shared);
+    }
+    for (auto&& childPair : _children) {
+        childPair.second->replaceCommonSubexpressions(expCtx, counts, shared);
+    }
+}
+
 Document ProjectionNode::serialize(boost::optional<ExplainOptions::Verbosity> explain) const {
     MutableDocument outputDoc;
     serialize(explain, &outputDoc);
@@ -115,6 +115,20 @@ public:
 
     void optimize();
 
+    /**
+     * Replaces each subexpression which appears more than once among the expressions of this tree
+     * with a shared ExpressionCommonSubexpression, so that it is evaluated at most once per input
+     * document. Must only be called on the root of the tree, after optimize(). Calls after the
+     * first have no effect.
+     */
+    void shareCommonSubexpressions(const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    /**
+     * Discards the cached results of the subexpressions shared by shareCommonSubexpressions(). Must
+     * be called on the root of the tree before the projection is applied to each input document.
+     */
+    void resetCommonSubexpressions() const;
+
     Document serialize(boost::optional<ExplainOptions::Verbosity> explain) const;
 
     void serialize(boost::optional<ExplainOptions::Verbosity> explain,
@@ -179,6 +193,18 @@ private:
     // Returns true if this node or any child of this node contains a computed field.
     bool subtreeContainsComputedFields() const;
 
+    // Helpers for 'shareCommonSubexpressions'. Count the occurrences of each subexpression in this
+    // subtree, then replace those which occur more than once with a shared expression.
+    void countSubexpressions(StringMap<int>* counts) const;
+    void replaceCommonSubexpressions(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        const StringMap<int>& counts,
+        StringMap<boost::intrusive_ptr<ExpressionCommonSubexpression>>* shared);
+
+    // The subexpressions shared between the expressions of this tree. Only populated on the root.
+    std::vector<boost::intrusive_ptr<ExpressionCommonSubexpression>> _commonSubexpressions;
+    bool _sharedCommonSubexpressions = false;
+
     // Our projection semantics are such that all field additions need to be processed in the order
     // specified. '_orderToProcessAdditionsAndChildren' tracks that order.
     //
@@ -155,6 +155,7 @@ void ParsedInclusionProjection::parse(const BSONObj& spec) {
 Document ParsedInclusionProjection::applyProjection(const Document& inputDoc) const {
     // All expressions will be evaluated in the context of the input document, before any
     // transformations have been applied.
+    _root->resetCommonSubexpressions();
     return _root->applyToDocument(inputDoc);
 }
 
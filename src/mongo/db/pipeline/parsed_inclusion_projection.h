@@ -121,6 +121,7 @@ public:
      */
     void optimize() final {
         _root->optimize();
+        _root->shareCommonSubexpressions(_expCtx);
     }
 
     DepsTracker::State addDependencies(DepsTracker* deps) const final {
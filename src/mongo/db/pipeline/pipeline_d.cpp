@@ -41,6 +41,7 @@
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/exec/block_sample_cursor.h"
 #include "mongo/db/exec/collection_scan.h"
 #include "mongo/db/exec/fetch.h"
 #include "mongo/db/exec/multi_iterator.h"
@@ -60,15 +61,19 @@
 #include "mongo/db/pipeline/document_source_geo_near_cursor.h"
 #include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/document_source_match.h"
+#include "mongo/db/pipeline/document_source_parallel_collection_scan.h"
 #include "mongo/db/pipeline/document_source_sample.h"
 #include "mongo/db/pipeline/document_source_sample_from_random_cursor.h"
 #include "mongo/db/pipeline/document_source_single_document_transformation.h"
 #include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/explain.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/operation_sharding_state.h"
 #include "mongo/db/service_context.h"
@@ -100,6 +105,9 @@ namespace {
  * Returns a PlanExecutor which uses a random cursor to sample documents if successful. Returns {}
  * if the storage engine doesn't support random cursors, or if 'sampleSize' is a large enough
  * percentage of the collection.
+ *
+ * Samples of up to half of an unsharded collection which are too large for a random cursor use a
+ * BlockSampleRecordCursor instead, if internalQueryAggregationSampleBlockSize is set.
  */
 StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> createRandomCursorExecutor(
     Collection* coll, OperationContext* opCtx, long long sampleSize, long long numRecords) {
@@ -108,12 +116,26 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> createRandomCursorEx
     invariant(opCtx->lockState()->isCollectionLockedForMode(coll->ns(), MODE_IS));
 
     static const double kMaxSampleRatioForRandCursor = 0.05;
-    if (sampleSize > numRecords * kMaxSampleRatioForRandCursor || numRecords <= 100) {
+    static const double kMaxSampleRatioForBlockSampling = 0.5;
+    if (numRecords <= 100) {
         return {nullptr};
     }
 
-    // Attempt to get a random cursor from the RecordStore.
-    auto rsRandCursor = coll->getRecordStore()->getRandomCursor(opCtx);
+    std::unique_ptr<RecordCursor> rsRandCursor;
+    if (sampleSize <= numRecords * kMaxSampleRatioForRandCursor) {
+        // Attempt to get a random cursor from the RecordStore.
+        rsRandCursor = coll->getRecordStore()->getRandomCursor(opCtx);
+    } else {
+        // The orphans of a sharded collection would skew the choice of blocks, so block sampling
+        // is only used by unversioned operations.
+        const auto blockSize = internalQueryAggregationSampleBlockSize.load();
+        if (blockSize <= 0 || sampleSize > numRecords * kMaxSampleRatioForBlockSampling ||
+            OperationShardingState::isOperationVersioned(opCtx)) {
+            return {nullptr};
+        }
+        rsRandCursor = BlockSampleRecordCursor::make(
+            opCtx, coll->getRecordStore(), static_cast<size_t>(blockSize));
+    }
     if (!rsRandCursor) {
         // The storage engine has no random cursor support.
         return {nullptr};
@@ -424,6 +446,47 @@ getSortAndGroupStagesFromPipeline(const Pipeline::SourceContainer& sources) {
     return std::make_pair(sortStage, groupStage);
 }
 
+/**
+ * Returns the number of worker threads with which to scan 'collection' for 'pipeline', or 0 if
+ * the scan should not run in parallel. Only a plain collection scan whose output goes straight
+ * into a $group runs in parallel, since the $group can then be split into a partial $group per
+ * worker and a merging $group. The workers read with their own OperationContexts, so the scan must
+ * not need the read source, transaction or shard version of this operation.
+ */
+size_t getParallelScanWorkers(Collection* collection,
+                              const Pipeline* pipeline,
+                              const PlanExecutor* exec) {
+    const auto& sources = pipeline->getSources();
+    const auto numWorkers = internalQueryAggregationParallelScanWorkers.load();
+    if (numWorkers < 2 || sources.empty() ||
+        !dynamic_cast<DocumentSourceGroup*>(sources.front().get())) {
+        return 0;
+    }
+
+    const auto& expCtx = pipeline->getContext();
+    auto opCtx = expCtx->opCtx;
+    const auto readConcernLevel = repl::ReadConcernArgs::get(opCtx).getLevel();
+    const auto txnParticipant = TransactionParticipant::get(opCtx);
+    if (expCtx->explain || expCtx->needsMerge || expCtx->fromMongos || expCtx->inMongos ||
+        expCtx->subPipelineDepth > 0 || expCtx->tailableMode != TailableModeEnum::kNormal ||
+        (txnParticipant && txnParticipant.inMultiDocumentTransaction()) ||
+        opCtx->getClient()->isInDirectClient() ||
+        OperationShardingState::isOperationVersioned(opCtx) || !collection->uuid() ||
+        (readConcernLevel != repl::ReadConcernLevel::kLocalReadConcern &&
+         readConcernLevel != repl::ReadConcernLevel::kAvailableReadConcern)) {
+        return 0;
+    }
+
+    if (Explain::getPlanSummary(exec) != "COLLSCAN") {
+        return 0;
+    }
+
+    const auto minRecordsPerWorker =
+        internalQueryAggregationParallelScanMinRecordsPerWorker.load();
+    const auto numRecords = collection->numRecords(opCtx);
+    return std::min<uint64_t>(numWorkers, numRecords / minRecordsPerWorker);
+}
+
 }  // namespace
 
 std::pair<PipelineD::AttachExecutorCallback, std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>>
@@ -507,6 +570,42 @@ PipelineD::buildInnerQueryExecutorGeneric(Collection* collection,
     const bool trackOplogTS =
         (pipeline->peekFront() && pipeline->peekFront()->constraints().isChangeStreamStage());
 
+    if (const auto numWorkers = getParallelScanWorkers(collection, pipeline, exec.get())) {
+        auto partitions = DocumentSourceParallelCollectionScan::partitionRecordIds(
+            expCtx->opCtx, collection, numWorkers);
+        if (partitions.size() > 1) {
+            auto attachParallelScanCallback = [nss, queryObj, partitions](
+                Collection* collection,
+                std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> exec,
+                Pipeline* pipeline) {
+                // The executor only served to choose the collection scan, which is run by the
+                // workers of the parallel scan instead.
+                exec.reset();
+
+                // Replace the $group by a merging $group over the partial groups of the workers.
+                auto& sources = pipeline->_sources;
+                auto groupStage = sources.front();
+                std::vector<Value> serializedGroup;
+                groupStage->serializeToArray(serializedGroup);
+                invariant(serializedGroup.size() == 1);
+                auto mergingLogic = groupStage->mergingLogic();
+                invariant(mergingLogic && mergingLogic->mergingStage);
+                sources.pop_front();
+                sources.push_front(mergingLogic->mergingStage);
+
+                sources.push_front(DocumentSourceParallelCollectionScan::create(
+                    pipeline->getContext(),
+                    nss,
+                    *collection->uuid(),
+                    queryObj,
+                    serializedGroup.front().getDocument().toBson(),
+                    partitions));
+                pipeline->stitch();
+            };
+            return std::make_pair(std::move(attachParallelScanCallback), std::move(exec));
+        }
+    }
+
     auto attachExecutorCallback = [deps, queryObj, sortObj, projForQuery, trackOplogTS](
         Collection* collection,
         std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> exec,
@@ -692,8 +791,12 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
     // the projection. In all other cases, unless the query system can do an index-covered
     // projection and avoid going to the raw record at all, it is faster to have ParsedDeps filter
     // the fields we need.
+    //
+    // When we only accept a covered projection, also let the planner consider scanning a whole
+    // index that covers it, since without a $match or $sort no index would be considered at all.
     if (!deps.getNeedsAnyMetadata()) {
-        plannerOpts |= QueryPlannerParams::NO_UNCOVERED_PROJECTIONS;
+        plannerOpts |= QueryPlannerParams::NO_UNCOVERED_PROJECTIONS |
+            QueryPlannerParams::GENERATE_COVERED_IXSCANS;
     }
 
     if (sortStage) {
@@ -773,7 +876,8 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
         // before, but now we know the query system won't cover the sort, so we will be able to
         // compute the sort key ourselves during the $sort stage, and thus don't need a query
         // projection to do so.
-        plannerOpts |= QueryPlannerParams::NO_UNCOVERED_PROJECTIONS;
+        plannerOpts |= QueryPlannerParams::NO_UNCOVERED_PROJECTIONS |
+            QueryPlannerParams::GENERATE_COVERED_IXSCANS;
     }
 
     // See if the query system can cover the projection.
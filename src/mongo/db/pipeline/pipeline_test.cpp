@@ -56,12 +56,14 @@
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/pipeline/stub_mongo_process_interface.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_test_service_context.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/s/query/cluster_aggregation_planner.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/temp_dir.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -340,6 +342,37 @@ TEST(PipelineOptimizationTest, LookupWithPipelineSyntaxShouldCoalesceWithUnwindO
     assertPipelineOptimizesAndSerializesTo(inputPipe, outputPipe, serializedPipe);
 }
 
+TEST(PipelineOptimizationTest, GroupShouldAbsorbPrecedingUnwindWhenEnabled) {
+    const bool originalFuse = internalQueryFuseUnwindIntoGroup.load();
+    ON_BLOCK_EXIT([&] { internalQueryFuseUnwindIntoGroup.store(originalFuse); });
+
+    string inputPipe =
+        "[{$unwind: {path: '$tags', preserveNullAndEmptyArrays: true}}"
+        ",{$group: {_id: '$tags', n: {$sum: 1}}}"
+        "]";
+    string serializedPipe =
+        "[{$unwind: {path: '$tags', preserveNullAndEmptyArrays: true}}"
+        ",{$group: {_id: '$tags', n: {$sum: {$const: 1}}}}"
+        "]";
+    assertPipelineOptimizesTo(inputPipe, serializedPipe);
+
+    internalQueryFuseUnwindIntoGroup.store(true);
+    string outputPipe =
+        "[{$group: {_id: '$tags', n: {$sum: {$const: 1}}, "
+        "$unwinding: {path: '$tags', preserveNullAndEmptyArrays: true}}}]";
+    assertPipelineOptimizesAndSerializesTo(inputPipe, outputPipe, serializedPipe);
+
+    // The array index cannot be reported without materializing the unwound documents.
+    inputPipe =
+        "[{$unwind: {path: '$tags', includeArrayIndex: 'i'}}"
+        ",{$group: {_id: '$i'}}"
+        "]";
+    assertPipelineOptimizesTo(inputPipe,
+                              "[{$unwind: {path: '$tags', includeArrayIndex: 'i'}}"
+                              ",{$group: {_id: '$i'}}"
+                              "]");
+}
+
 TEST(PipelineOptimizationTest, LookupShouldCoalesceWithUnwindOnAsWithPreserveEmpty) {
     string inputPipe =
         "[{$lookup: {from : 'lookupColl', as : 'same', localField: 'left', foreignField: "
@@ -187,9 +187,7 @@ unique_ptr<Pipeline, PipelineDeleter> MongoInterfaceShardServer::attachCursorSou
     }();
 
     if (isSharded) {
-        const bool foreignShardedAllowed =
-            getTestCommandsEnabled() && internalQueryAllowShardedLookup.load();
-        if (foreignShardedAllowed) {
+        if (internalQueryAllowShardedLookup.load()) {
             // For a sharded collection we may have to establish cursors on a remote host.
             return sharded_agg_helpers::targetShardsAndAddMergeCursors(expCtx, pipeline.release());
         }
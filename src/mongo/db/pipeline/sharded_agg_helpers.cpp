@@ -271,6 +271,10 @@ DispatchShardPipelineResults dispatchShardPipeline(
 
         exchangeSpec = cluster_aggregation_planner::checkIfEligibleForExchange(
             opCtx, splitPipeline->mergePipeline.get());
+        if (!exchangeSpec) {
+            exchangeSpec = cluster_aggregation_planner::checkIfEligibleForGroupMergeExchange(
+                opCtx, splitPipeline->mergePipeline.get(), shardIds);
+        }
     }
 
     // Generate the command object for the targeted shards.
@@ -96,4 +96,27 @@ boost::optional<Document> StubMongoProcessInterfaceLookupSingleDocument::lookupS
     return lookedUpDocument;
 }
 
+std::vector<Document> StubMongoProcessInterfaceLookupSingleDocument::lookupDocuments(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    UUID collectionUUID,
+    const std::vector<Document>& documentKeys,
+    boost::optional<BSONObj> readConcern,
+    bool allowSpeculativeMajorityRead) {
+    auto foreignExpCtx = expCtx->copyWith(nss, collectionUUID, boost::none);
+    const Value orClauses(std::vector<Value>(documentKeys.begin(), documentKeys.end()));
+    std::unique_ptr<Pipeline, PipelineDeleter> pipeline;
+    try {
+        pipeline = makePipeline({BSON("$match" << BSON("$or" << orClauses))}, foreignExpCtx);
+    } catch (ExceptionFor<ErrorCodes::NamespaceNotFound>&) {
+        return {};
+    }
+
+    std::vector<Document> lookedUpDocuments;
+    while (auto next = pipeline->getNext()) {
+        lookedUpDocuments.push_back(std::move(*next));
+    }
+    return lookedUpDocuments;
+}
+
 }  // namespace mongo
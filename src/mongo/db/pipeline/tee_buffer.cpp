@@ -49,14 +49,40 @@ boost::intrusive_ptr<TeeBuffer> TeeBuffer::create(size_t nConsumers, int bufferS
     return new TeeBuffer(nConsumers, bufferSizeBytes);
 }
 
-DocumentSource::GetNextResult TeeBuffer::getNext(size_t consumerId) {
-    size_t nConsumersStillProcessingThisBatch =
-        std::count_if(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
-            return info.nLeftToReturn > 0;
-        });
+void TeeBuffer::dispose(size_t consumerId) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _consumers[consumerId].stillInUse = false;
+    _consumers[consumerId].nLeftToReturn = 0;
+    if (!_loadBatchesExternally && allConsumersDisposed()) {
+        _buffer.clear();
+        if (_source) {
+            _source->dispose();
+        }
+    }
+}
 
-    if (_buffer.empty() || nConsumersStillProcessingThisBatch == 0) {
-        loadNextBatch();
+void TeeBuffer::setLoadBatchesExternally(bool loadBatchesExternally) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _loadBatchesExternally = loadBatchesExternally;
+    if (!_loadBatchesExternally && allConsumersDisposed()) {
+        _buffer.clear();
+        if (_source) {
+            _source->dispose();
+        }
+    }
+}
+
+DocumentSource::GetNextResult TeeBuffer::getNext(size_t consumerId) {
+    // When batches are loaded externally, a consumer only looks at its own entry of '_consumers'.
+    if (!_loadBatchesExternally) {
+        size_t nConsumersStillProcessingThisBatch =
+            std::count_if(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
+                return info.nLeftToReturn > 0;
+            });
+
+        if (_buffer.empty() || nConsumersStillProcessingThisBatch == 0) {
+            loadNextBatch();
+        }
     }
 
     if (_buffer.empty()) {
@@ -82,6 +108,11 @@ void TeeBuffer::loadNextBatch() {
 
     auto input = _source->getNext();
     for (; input.isAdvanced(); input = _source->getNext()) {
+        // Consumers read the buffered documents concurrently when batches are loaded externally,
+        // so any fields they would otherwise load lazily on lookup are loaded up front.
+        if (_loadBatchesExternally) {
+            input.getDocument().loadLazyFields();
+        }
         bytesInBuffer += input.getDocument().getApproximateSize();
         _buffer.push_back(std::move(input));
 
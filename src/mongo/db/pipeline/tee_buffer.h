@@ -36,6 +36,7 @@
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/query/query_knobs_gen.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/intrusive_counter.h"
 
 namespace mongo {
@@ -63,18 +64,22 @@ public:
      * Removes 'consumerId' as a consumer of this buffer. This is required to be called if a
      * consumer will not consume all input.
      */
-    void dispose(size_t consumerId) {
-        _consumers[consumerId].stillInUse = false;
-        _consumers[consumerId].nLeftToReturn = 0;
-        if (std::none_of(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
-                return info.stillInUse;
-            })) {
-            _buffer.clear();
-            if (_source) {
-                _source->dispose();
-            }
-        }
-    }
+    void dispose(size_t consumerId);
+
+    /**
+     * While set, batches are only loaded by calls to loadNextBatch() from the owner of this
+     * buffer, so that consumers may call getNext() and dispose() concurrently from different
+     * threads. A consumer that reaches the end of a batch sees kPauseExecution, and the source is
+     * disposed of once this is unset if every consumer was disposed of in the meantime.
+     */
+    void setLoadBatchesExternally(bool loadBatchesExternally);
+
+    /**
+     * Clears '_buffer', then keeps requesting results from '_source' and pushing them all into
+     * '_buffer', until more than '_bufferSizeBytes' of documents have been returned, or until
+     * '_source' is exhausted.
+     */
+    void loadNextBatch();
 
     /**
      * Retrieves the next document meant to be consumed by the pipeline given by 'consumerId'.
@@ -86,15 +91,18 @@ public:
 private:
     TeeBuffer(size_t nConsumers, size_t bufferSizeBytes);
 
-    /**
-     * Clears '_buffer', then keeps requesting results from '_source' and pushing them all into
-     * '_buffer', until more than '_bufferSizeBytes' of documents have been returned, or until
-     * '_source' is exhausted.
-     */
-    void loadNextBatch();
+    bool allConsumersDisposed() const {
+        return std::none_of(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
+            return info.stillInUse;
+        });
+    }
 
     DocumentSource* _source = nullptr;
 
+    // Guards 'stillInUse' while '_loadBatchesExternally' is set.
+    stdx::mutex _mutex;
+    bool _loadBatchesExternally = false;
+
     const size_t _bufferSizeBytes;
     std::vector<DocumentSource::GetNextResult> _buffer;
 
@@ -35,6 +35,7 @@
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression_array.h"
+#include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/canonical_query_encoder.h"
@@ -107,6 +108,23 @@ bool parsingCanProduceNoopMatchNodes(const ExtensionsCallback& extensionsCallbac
          allowedFeatures & MatchExpressionParser::AllowedFeatures::kJavascript);
 }
 
+/**
+ * Returns the lone element of 'filter' if it is a single equality on '_id' against a literal, for
+ * which the MatchExpressionParser would produce nothing but an EqualityMatchExpression. Returns an
+ * EOO element otherwise.
+ */
+BSONElement getSimpleIdEquality(const BSONObj& filter) {
+    BSONObjIterator it(filter);
+    if (!it.more()) {
+        return BSONElement();
+    }
+    BSONElement idElt = it.next();
+    if (it.more() || !CanonicalQuery::isSimpleIdQuery(filter)) {
+        return BSONElement();
+    }
+    return idElt;
+}
+
 }  // namespace
 
 // static
@@ -157,12 +175,21 @@ StatusWith<std::unique_ptr<CanonicalQuery>> CanonicalQuery::canonicalize(
         invariant(CollatorInterface::collatorsMatch(collator.get(), expCtx->getCollator()));
     }
 
-    StatusWithMatchExpression statusWithMatcher = MatchExpressionParser::parse(
-        qr->getFilter(), newExpCtx, extensionsCallback, allowedFeatures);
-    if (!statusWithMatcher.isOK()) {
-        return statusWithMatcher.getStatus();
+    std::unique_ptr<MatchExpression> me;
+    if (auto idElt = getSimpleIdEquality(qr->getFilter())) {
+        // Point reads by _id are the most common query shape. Bind the literal straight into the
+        // equality the parser would have produced, without running the general parser.
+        auto eq = std::make_unique<EqualityMatchExpression>(idElt.fieldNameStringData(), idElt);
+        eq->setCollator(newExpCtx->getCollator());
+        me = std::move(eq);
+    } else {
+        StatusWithMatchExpression statusWithMatcher = MatchExpressionParser::parse(
+            qr->getFilter(), newExpCtx, extensionsCallback, allowedFeatures);
+        if (!statusWithMatcher.isOK()) {
+            return statusWithMatcher.getStatus();
+        }
+        me = std::move(statusWithMatcher.getValue());
     }
-    std::unique_ptr<MatchExpression> me = std::move(statusWithMatcher.getValue());
 
     // Make the CQ we'll hopefully return.
     std::unique_ptr<CanonicalQuery> cq(new CanonicalQuery());
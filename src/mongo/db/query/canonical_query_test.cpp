@@ -30,6 +30,7 @@
 #include "mongo/db/query/canonical_query.h"
 
 #include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
@@ -307,6 +308,33 @@ TEST(CanonicalQueryTest, CanonicalQueryFromQRWithCollation) {
     ASSERT_TRUE(CollatorInterface::collatorsMatch(cq->getCollator(), &collator));
 }
 
+TEST(CanonicalQueryTest, SimpleIdQueryCanonicalizesToTheParsedEquality) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+
+    for (auto&& filter : {fromjson("{_id: 1}"),
+                          fromjson("{_id: 'abc'}"),
+                          fromjson("{_id: {a: 1, b: 'x'}}"),
+                          fromjson("{_id: {}}")}) {
+        auto qr = stdx::make_unique<QueryRequest>(nss);
+        qr->setFilter(filter);
+        qr->setCollation(BSON("locale"
+                              << "reverse"));
+        auto cq = assertGet(CanonicalQuery::canonicalize(opCtx.get(), std::move(qr)));
+
+        const boost::intrusive_ptr<ExpressionContextForTest> expCtx(
+            new ExpressionContextForTest());
+        CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+        expCtx->setCollator(&collator);
+        auto parsed = assertGet(MatchExpressionParser::parse(filter, expCtx));
+
+        ASSERT_EQ(MatchExpression::EQ, cq->root()->matchType());
+        ASSERT_TRUE(cq->root()->equivalent(parsed.get())) << filter;
+        auto eq = static_cast<const EqualityMatchExpression*>(cq->root());
+        ASSERT_EQ(eq->getCollator(), cq->getCollator());
+    }
+}
+
 TEST(CanonicalQueryTest, CanonicalQueryFromBaseQueryWithNoCollation) {
     QueryTestServiceContext serviceContext;
     auto opCtx = serviceContext.makeOperationContext();
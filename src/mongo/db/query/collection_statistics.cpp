@@ -0,0 +1,239 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collection_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/bson/dotted_path_support.h"
+
+namespace mongo {
+
+namespace dps = ::mongo::dotted_path_support;
+
+namespace {
+
+int compareValues(const BSONElement& lhs, const BSONElement& rhs) {
+    return lhs.woCompare(rhs, false);
+}
+
+BSONObj ownValue(const BSONElement& elt) {
+    BSONObjBuilder bob;
+    bob.appendAs(elt, "");
+    return bob.obj();
+}
+
+}  // namespace
+
+// static
+FieldHistogram FieldHistogram::make(std::vector<BSONElement> values,
+                                    long long numDocuments,
+                                    double samplingRatio,
+                                    size_t maxBuckets) {
+    invariant(maxBuckets > 0);
+
+    FieldHistogram histogram;
+    histogram._numDocuments = numDocuments;
+    if (values.empty()) {
+        return histogram;
+    }
+
+    std::sort(values.begin(), values.end(), [](const BSONElement& lhs, const BSONElement& rhs) {
+        return compareValues(lhs, rhs) < 0;
+    });
+    histogram._minValue = ownValue(values.front());
+
+    // Close a bucket once it holds its share of the values, but never split a run of equal
+    // values across two buckets, so that every frequent value becomes an upper bound.
+    const size_t bucketDepth = (values.size() + maxBuckets - 1) / maxBuckets;
+    long long numDistinct = 0;
+    long long numSingletons = 0;
+    Bucket bucket{BSONObj(), 0, 0, 0};
+    size_t ix = 0;
+    while (ix < values.size()) {
+        size_t runEnd = ix + 1;
+        while (runEnd < values.size() && compareValues(values[ix], values[runEnd]) == 0) {
+            ++runEnd;
+        }
+        const long long runLength = static_cast<long long>(runEnd - ix);
+
+        ++numDistinct;
+        if (runLength == 1) {
+            ++numSingletons;
+        }
+
+        bucket.count += runLength;
+        bucket.upperBoundCount = runLength;
+        ++bucket.numDistinct;
+        if (static_cast<size_t>(bucket.count) >= bucketDepth || runEnd == values.size()) {
+            bucket.upperBound = ownValue(values[ix]);
+            histogram._buckets.push_back(std::move(bucket));
+            bucket = Bucket{BSONObj(), 0, 0, 0};
+        }
+        ix = runEnd;
+    }
+
+    // Scale up the values seen only once in the sample, as they stand for the values which the
+    // sample missed.
+    if (samplingRatio >= 1.0 || samplingRatio <= 0.0) {
+        histogram._numDistinct = static_cast<double>(numDistinct);
+    } else {
+        histogram._numDistinct = std::sqrt(1.0 / samplingRatio) * numSingletons +
+            static_cast<double>(numDistinct - numSingletons);
+    }
+    return histogram;
+}
+
+double FieldHistogram::estimateCount(const Interval& interval) const {
+    if (interval.isEmpty()) {
+        return 0;
+    }
+
+    const Interval ascending = interval.getDirection() == Interval::Direction::kDirectionDescending
+        ? interval.reverseClone()
+        : interval;
+    const BSONElement& start = ascending.start;
+    const BSONElement& end = ascending.end;
+
+    auto containsValue = [&](const BSONElement& value) {
+        const int startCmp = compareValues(start, value);
+        const int endCmp = compareValues(value, end);
+        return (startCmp < 0 || (startCmp == 0 && ascending.startInclusive)) &&
+            (endCmp < 0 || (endCmp == 0 && ascending.endInclusive));
+    };
+
+    // The interior of the first bucket starts at, and includes, the least sampled value. The
+    // interior of every other bucket starts just after the upper bound of the one before.
+    double count = 0;
+    BSONElement lower = _minValue.firstElement();
+    bool lowerInclusive = true;
+    for (auto&& bucket : _buckets) {
+        const BSONElement upper = bucket.upperBound.firstElement();
+        const long long interiorCount = bucket.count - bucket.upperBoundCount;
+        const long long interiorDistinct = bucket.numDistinct - 1;
+
+        if (containsValue(upper)) {
+            count += bucket.upperBoundCount;
+        }
+
+        const int endLowerCmp = compareValues(end, lower);
+        if (interiorCount > 0 && compareValues(start, upper) < 0 &&
+            (endLowerCmp > 0 || (endLowerCmp == 0 && lowerInclusive))) {
+            if (ascending.isPoint()) {
+                // Assume the values within the bucket are equally frequent.
+                count += static_cast<double>(interiorCount) / std::max(interiorDistinct, 1LL);
+            } else if (compareValues(start, lower) <= 0 && compareValues(end, upper) >= 0) {
+                count += interiorCount;
+            } else {
+                count += interiorCount / 2.0;
+            }
+        }
+        lower = upper;
+        lowerInclusive = false;
+    }
+    return count;
+}
+
+double FieldHistogram::estimateFraction(const OrderedIntervalList& oil) const {
+    if (_numDocuments == 0) {
+        return 0;
+    }
+
+    double count = 0;
+    for (auto&& interval : oil.intervals) {
+        count += estimateCount(interval);
+    }
+    return count / _numDocuments;
+}
+
+BSONObj FieldHistogram::toBSON() const {
+    BSONObjBuilder bob;
+    bob.appendNumber("numDistinct", static_cast<long long>(std::llround(_numDistinct)));
+    BSONArrayBuilder buckets(bob.subarrayStart("buckets"));
+    for (auto&& bucket : _buckets) {
+        BSONObjBuilder bucketBob(buckets.subobjStart());
+        bucketBob.appendAs(bucket.upperBound.firstElement(), "upperBound");
+        bucketBob.appendNumber("count", bucket.count);
+        bucketBob.appendNumber("upperBoundCount", bucket.upperBoundCount);
+        bucketBob.appendNumber("numDistinct", bucket.numDistinct);
+    }
+    buckets.doneFast();
+    return bob.obj();
+}
+
+// static
+CollectionStatistics CollectionStatistics::make(const std::vector<BSONObj>& sample,
+                                                long long numRecords,
+                                                const std::set<std::string>& paths,
+                                                size_t maxBuckets) {
+    CollectionStatistics stats;
+    stats._numRecords = numRecords;
+    stats._sampleSize = static_cast<long long>(sample.size());
+
+    const double samplingRatio =
+        numRecords > 0 ? static_cast<double>(sample.size()) / numRecords : 1.0;
+    const BSONObj nullObj = BSON("" << BSONNULL);
+    for (auto&& path : paths) {
+        std::vector<BSONElement> values;
+        for (auto&& doc : sample) {
+            BSONElementSet docValues;
+            dps::extractAllElementsAlongPath(doc, path, docValues);
+            if (docValues.empty()) {
+                values.push_back(nullObj.firstElement());
+            }
+            values.insert(values.end(), docValues.begin(), docValues.end());
+        }
+        stats._histograms[path] =
+            FieldHistogram::make(std::move(values), stats._sampleSize, samplingRatio, maxBuckets);
+    }
+    return stats;
+}
+
+const FieldHistogram* CollectionStatistics::getHistogram(StringData path) const {
+    auto it = _histograms.find(path);
+    return it == _histograms.end() ? nullptr : &it->second;
+}
+
+BSONObj CollectionStatistics::toBSON() const {
+    BSONObjBuilder bob;
+    bob.appendNumber("numRecords", _numRecords);
+    bob.appendNumber("sampleSize", _sampleSize);
+    BSONObjBuilder fields(bob.subobjStart("fields"));
+    for (auto&& histogram : _histograms) {
+        fields.append(histogram.first, histogram.second.toBSON());
+    }
+    fields.doneFast();
+    return bob.obj();
+}
+
+}  // namespace mongo
@@ -0,0 +1,134 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/index_bounds.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+/**
+ * An equi-depth histogram of the values of one field, built from a sample of a collection. The
+ * values are the ones an index over the field would hold keys for, so array elements are counted
+ * individually and a missing field counts as null.
+ */
+class FieldHistogram {
+public:
+    /**
+     * Builds a histogram of at most 'maxBuckets' buckets over 'values', which were taken from
+     * 'numDocuments' sampled documents. 'samplingRatio' is the fraction of the collection the
+     * sample covers and is used to scale the estimated number of distinct values.
+     */
+    static FieldHistogram make(std::vector<BSONElement> values,
+                               long long numDocuments,
+                               double samplingRatio,
+                               size_t maxBuckets);
+
+    /**
+     * Returns the estimated number of values, per document, which fall within 'oil'.
+     */
+    double estimateFraction(const OrderedIntervalList& oil) const;
+
+    /**
+     * Returns the estimated number of distinct values of the field in the whole collection.
+     */
+    double getNumDistinct() const {
+        return _numDistinct;
+    }
+
+    size_t getNumBuckets() const {
+        return _buckets.size();
+    }
+
+    BSONObj toBSON() const;
+
+private:
+    struct Bucket {
+        // The greatest value in the bucket, as the only element of an object with an empty name.
+        BSONObj upperBound;
+
+        // The number of sampled values in the bucket, of which 'upperBoundCount' are equal to the
+        // upper bound.
+        long long count;
+        long long upperBoundCount;
+        long long numDistinct;
+    };
+
+    /**
+     * Returns the estimated number of sampled values within 'interval'.
+     */
+    double estimateCount(const Interval& interval) const;
+
+    // The least sampled value, as the only element of an object with an empty name.
+    BSONObj _minValue;
+
+    std::vector<Bucket> _buckets;
+    long long _numDocuments = 0;
+    double _numDistinct = 0;
+};
+
+/**
+ * The statistics gathered for a collection by the 'analyze' command: a histogram for each field
+ * path which leads a btree index, or is part of one.
+ */
+class CollectionStatistics {
+public:
+    /**
+     * Builds a histogram for each of 'paths' from the documents in 'sample', which were taken
+     * from a collection of 'numRecords' documents.
+     */
+    static CollectionStatistics make(const std::vector<BSONObj>& sample,
+                                     long long numRecords,
+                                     const std::set<std::string>& paths,
+                                     size_t maxBuckets);
+
+    /**
+     * Returns the histogram of 'path', or nullptr if none was built.
+     */
+    const FieldHistogram* getHistogram(StringData path) const;
+
+    long long getSampleSize() const {
+        return _sampleSize;
+    }
+
+    BSONObj toBSON() const;
+
+private:
+    long long _numRecords = 0;
+    long long _sampleSize = 0;
+    StringMap<FieldHistogram> _histograms;
+};
+
+}  // namespace mongo
@@ -0,0 +1,146 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collection_statistics.h"
+
+#include <cmath>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/json.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+OrderedIntervalList makeOil(BSONObj bounds, bool startInclusive = true, bool endInclusive = true) {
+    OrderedIntervalList oil("a");
+    oil.intervals.push_back(Interval(bounds, startInclusive, endInclusive));
+    return oil;
+}
+
+OrderedIntervalList makePointOil(BSONObj point) {
+    BSONObjBuilder bob;
+    bob.appendAs(point.firstElement(), "");
+    bob.appendAs(point.firstElement(), "");
+    return makeOil(bob.obj());
+}
+
+CollectionStatistics makeStatistics(const std::vector<BSONObj>& docs,
+                                    long long numRecords,
+                                    size_t maxBuckets = 10) {
+    return CollectionStatistics::make(docs, numRecords, {"a"}, maxBuckets);
+}
+
+TEST(CollectionStatisticsTest, UniformValues) {
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < 1000; ++i) {
+        docs.push_back(BSON("a" << i));
+    }
+    auto stats = makeStatistics(docs, 1000);
+    const FieldHistogram* histogram = stats.getHistogram("a");
+    ASSERT(histogram);
+    ASSERT_EQ(histogram->getNumBuckets(), 10U);
+    ASSERT_EQ(histogram->getNumDistinct(), 1000);
+
+    ASSERT_APPROX_EQUAL(histogram->estimateFraction(makePointOil(BSON("" << 500))), 0.001, 1e-4);
+    ASSERT_APPROX_EQUAL(
+        histogram->estimateFraction(makeOil(BSON("" << 0 << "" << 499))), 0.5, 0.05);
+    ASSERT_APPROX_EQUAL(histogram->estimateFraction(makeOil(BSON("" << MINKEY << "" << MAXKEY))),
+                        1.0,
+                        1e-9);
+    ASSERT_EQ(histogram->estimateFraction(makeOil(BSON("" << 1000 << "" << 2000))), 0);
+    ASSERT_EQ(histogram->estimateFraction(makeOil(BSON("" << "a"
+                                                          << ""
+                                                          << "z"))),
+              0);
+}
+
+TEST(CollectionStatisticsTest, DescendingIntervalMatchesAscending) {
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < 1000; ++i) {
+        docs.push_back(BSON("a" << i));
+    }
+    auto stats = makeStatistics(docs, 1000);
+    const FieldHistogram* histogram = stats.getHistogram("a");
+    ASSERT(histogram);
+    ASSERT_EQ(histogram->estimateFraction(makeOil(BSON("" << 750 << "" << 100))),
+              histogram->estimateFraction(makeOil(BSON("" << 100 << "" << 750))));
+}
+
+TEST(CollectionStatisticsTest, FrequentValueIsCountedExactly) {
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < 500; ++i) {
+        docs.push_back(BSON("a" << 7));
+        docs.push_back(BSON("a" << 1000 + i));
+    }
+    auto stats = makeStatistics(docs, 1000);
+    const FieldHistogram* histogram = stats.getHistogram("a");
+    ASSERT(histogram);
+    ASSERT_EQ(histogram->estimateFraction(makePointOil(BSON("" << 7))), 0.5);
+    ASSERT_APPROX_EQUAL(
+        histogram->estimateFraction(makeOil(BSON("" << 1000 << "" << 1499))), 0.5, 0.1);
+}
+
+TEST(CollectionStatisticsTest, ArrayElementsAndMissingFieldsAreCounted) {
+    std::vector<BSONObj> docs = {fromjson("{a: [1, 2]}"), fromjson("{b: 1}")};
+    auto stats = makeStatistics(docs, 2);
+    const FieldHistogram* histogram = stats.getHistogram("a");
+    ASSERT(histogram);
+    ASSERT_EQ(histogram->estimateFraction(makePointOil(BSON("" << BSONNULL))), 0.5);
+    ASSERT_EQ(histogram->estimateFraction(makeOil(BSON("" << 1 << "" << 2))), 1.0);
+    ASSERT_FALSE(stats.getHistogram("b"));
+}
+
+TEST(CollectionStatisticsTest, DistinctValuesAreScaledBySamplingRatio) {
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < 100; ++i) {
+        docs.push_back(BSON("a" << i));
+        docs.push_back(BSON("a" << -1));
+    }
+    auto stats = makeStatistics(docs, 400);
+    const FieldHistogram* histogram = stats.getHistogram("a");
+    ASSERT(histogram);
+    ASSERT_APPROX_EQUAL(histogram->getNumDistinct(), std::sqrt(2.0) * 100 + 1, 1e-9);
+    ASSERT_EQ(stats.getSampleSize(), 200);
+}
+
+TEST(CollectionStatisticsTest, ToBSONReportsEveryField) {
+    std::vector<BSONObj> docs = {BSON("a" << 1), BSON("a" << 2)};
+    auto stats = CollectionStatistics::make(docs, 2, {"a", "b"}, 10);
+    BSONObj obj = stats.toBSON();
+    ASSERT_EQ(obj["numRecords"].numberLong(), 2);
+    ASSERT_EQ(obj["sampleSize"].numberLong(), 2);
+    ASSERT_EQ(obj["fields"]["a"]["numDistinct"].numberLong(), 2);
+    ASSERT_EQ(obj["fields"]["b"]["numDistinct"].numberLong(), 1);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -105,6 +105,26 @@ TEST(CountCommandTest, ParserParsesCommandWithAllFieldsCorrectly) {
                       fromjson("{ $readPreference: 'secondary' }"));
 }
 
+TEST(CountCommandTest, ParserParsesEstimateSampleSize) {
+    auto commandObj = BSON("count"
+                           << "TestColl"
+                           << "$db"
+                           << "TestDB"
+                           << "estimateSampleSize"
+                           << 1000);
+    auto countCmd = CountCommand::parse(ctxt, commandObj);
+    ASSERT_EQ(countCmd.getEstimateSampleSize().get(), 1000);
+
+    auto badCommandObj = BSON("count"
+                              << "TestColl"
+                              << "$db"
+                              << "TestDB"
+                              << "estimateSampleSize"
+                              << "many");
+    ASSERT_THROWS_CODE(
+        CountCommand::parse(ctxt, badCommandObj), AssertionException, ErrorCodes::TypeMismatch);
+}
+
 TEST(CountCommandTest, ParsingNegativeLimitGivesPositiveLimit) {
     auto commandObj = BSON("count"
                            << "TestColl"
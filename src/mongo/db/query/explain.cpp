@@ -48,6 +48,7 @@
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/plan_yield_policy.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/query/stage_builder.h"
@@ -538,6 +539,7 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("memUsage", spec->memUsage);
             bob->appendNumber("memLimit", spec->memLimit);
+            bob->appendBool("usedDisk", spec->usedDisk);
         }
 
         if (spec->limit > 0) {
@@ -799,6 +801,17 @@ void Explain::generateExecutionInfo(PlanExecutor* exec,
     const auto winningExecStats = getWinningPlanStatsTree(exec);
     generateSinglePlanExecutionInfo(winningExecStats.get(), verbosity, totalTimeMillis, &execBob);
 
+    // Report what yielding has cost the plan so far, for plans which yield on their own.
+    const PlanYieldPolicy* yieldPolicy = exec->getYieldPolicy();
+    if (yieldPolicy && yieldPolicy->canAutoYield()) {
+        const auto& yieldStats = yieldPolicy->getYieldStats();
+        BSONObjBuilder yieldBob(execBob.subobjStart("yieldStats"));
+        yieldBob.appendNumber("numYields", yieldStats.numYields);
+        yieldBob.appendNumber("numSkippedYields", yieldStats.numSkippedYields);
+        yieldBob.appendNumber("yieldTimeMicros", durationCount<Microseconds>(yieldStats.yieldTime));
+        yieldBob.doneFast();
+    }
+
     // Also generate exec stats for all plans, if the verbosity level is high enough.
     // These stats reflect what happened during the trial period that ranked the plans.
     if (verbosity >= ExplainOptions::Verbosity::kExecAllPlans) {
@@ -972,6 +985,10 @@ void Explain::getSummaryStats(const PlanExecutor& exec, PlanSummaryStats* statsO
 
         if (STAGE_SORT == stages[i]->stageType()) {
             statsOut->hasSortStage = true;
+
+            const SortStats* sortStats =
+                static_cast<const SortStats*>(stages[i]->getSpecificStats());
+            statsOut->usedDisk = statsOut->usedDisk || sortStats->usedDisk;
         }
 
         if (STAGE_IXSCAN == stages[i]->stageType()) {
@@ -30,6 +30,8 @@
 #include "mongo/db/query/expression_index.h"
 
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <unordered_set>
 
 #include "mongo/db/geo/geoconstants.h"
@@ -37,6 +39,8 @@
 #include "mongo/db/hasher.h"
 #include "mongo/db/index/expression_params.h"
 #include "mongo/db/query/expression_index_knobs_gen.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/lru_cache.h"
 #include "third_party/s2/s2cellid.h"
 #include "third_party/s2/s2region.h"
 #include "third_party/s2/s2regioncoverer.h"
@@ -108,10 +112,12 @@ void ExpressionMapping::cover2d(const R2Region& region,
     GeoHashsToIntervalsWithParents(unorderedCovering, oilOut);
 }
 
-std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const S2Region& region) {
-    auto minLevel = gInternalQueryS2GeoCoarsestLevel.load();
-    auto maxLevel = gInternalQueryS2GeoFinestLevel.load();
+namespace {
 
+std::vector<S2CellId> compute2dsphereCovering(const S2Region& region,
+                                              int minLevel,
+                                              int maxLevel,
+                                              int maxCells) {
     uassert(28739, "Geo coarsest level must be in range [0,30]", 0 <= minLevel && minLevel <= 30);
     uassert(28740, "Geo finest level must be in range [0,30]", 0 <= maxLevel && maxLevel <= 30);
     uassert(28741, "Geo coarsest level must be less than or equal to finest", minLevel <= maxLevel);
@@ -119,13 +125,81 @@ std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const S2Region& reg
     S2RegionCoverer coverer;
     coverer.set_min_level(minLevel);
     coverer.set_max_level(maxLevel);
-    coverer.set_max_cells(gInternalQueryS2GeoMaxCells.load());
+    coverer.set_max_cells(maxCells);
 
     std::vector<S2CellId> cover;
     coverer.GetCovering(region, &cover);
     return cover;
 }
 
+/**
+ * Caches the coverings of recently queried 2dsphere geometries. The key is the query geometry
+ * followed by the covering parameters, which can change at runtime.
+ */
+class S2CoveringCache {
+public:
+    boost::optional<std::vector<S2CellId>> find(const std::string& key) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _cache.find(key);
+        if (it == _cache.end()) {
+            return boost::none;
+        }
+        _cache.promote(it);
+        return it->second;
+    }
+
+    void add(const std::string& key, std::vector<S2CellId> cover, size_t maxSize) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _cache.add(key, std::move(cover));
+        while (_cache.size() > maxSize) {
+            _cache.erase(std::prev(_cache.end()));
+        }
+    }
+
+private:
+    // The size limit is enforced by add(), since it can change at runtime.
+    static constexpr size_t kMaxSize = std::numeric_limits<size_t>::max();
+
+    stdx::mutex _mutex;
+    LRUCache<std::string, std::vector<S2CellId>> _cache{kMaxSize};
+};
+
+S2CoveringCache s2CoveringCache;
+
+}  // namespace
+
+std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const S2Region& region) {
+    return compute2dsphereCovering(region,
+                                   gInternalQueryS2GeoCoarsestLevel.load(),
+                                   gInternalQueryS2GeoFinestLevel.load(),
+                                   gInternalQueryS2GeoMaxCells.load());
+}
+
+std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const S2Region& region,
+                                                             const BSONObj& geometry) {
+    const int cacheSize = gInternalQueryS2CoveringCacheSize.load();
+    if (cacheSize == 0 || geometry.isEmpty()) {
+        return get2dsphereCovering(region);
+    }
+
+    const int minLevel = gInternalQueryS2GeoCoarsestLevel.load();
+    const int maxLevel = gInternalQueryS2GeoFinestLevel.load();
+    const int maxCells = gInternalQueryS2GeoMaxCells.load();
+
+    std::string key(geometry.objdata(), geometry.objsize());
+    for (int param : {minLevel, maxLevel, maxCells}) {
+        key.append(reinterpret_cast<const char*>(&param), sizeof(param));
+    }
+
+    if (auto cover = s2CoveringCache.find(key)) {
+        return std::move(*cover);
+    }
+
+    std::vector<S2CellId> cover = compute2dsphereCovering(region, minLevel, maxLevel, maxCells);
+    s2CoveringCache.add(key, cover, cacheSize);
+    return cover;
+}
+
 void ExpressionMapping::cover2dsphere(const S2Region& region,
                                       const S2IndexingParams& indexingParams,
                                       OrderedIntervalList* oilOut) {
@@ -133,6 +207,14 @@ void ExpressionMapping::cover2dsphere(const S2Region& region,
     S2CellIdsToIntervalsWithParents(cover, indexingParams, oilOut);
 }
 
+void ExpressionMapping::cover2dsphere(const S2Region& region,
+                                      const BSONObj& geometry,
+                                      const S2IndexingParams& indexingParams,
+                                      OrderedIntervalList* oilOut) {
+    std::vector<S2CellId> cover = get2dsphereCovering(region, geometry);
+    S2CellIdsToIntervalsWithParents(cover, indexingParams, oilOut);
+}
+
 namespace {
 bool compareIntervals(const Interval& a, const Interval& b) {
     return a.precedes(b);
@@ -31,6 +31,8 @@
 
 #include "mongo/db/query/find_common.h"
 
+#include <algorithm>
+
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/query/query_request.h"
@@ -60,6 +62,17 @@ bool FindCommon::enoughForFirstBatch(const QueryRequest& qr, long long numDocs)
     return numDocs >= qr.getEffectiveBatchSize().value();
 }
 
+int FindCommon::bytesToReserveForFirstBatch(const QueryRequest& qr, int averageObjSize) {
+    long long numDocs = qr.getEffectiveBatchSize().value_or(QueryRequest::kDefaultBatchSize);
+    if (qr.getLimit()) {
+        numDocs = std::min(numDocs, *qr.getLimit());
+    }
+
+    const long long bytes = std::min(numDocs * std::max(averageObjSize, 0),
+                                     static_cast<long long>(kMaxBytesToReturnToClientAtOnce));
+    return bytes > kInitReplyBufferSize ? static_cast<int>(bytes) : 0;
+}
+
 bool FindCommon::haveSpaceForNext(const BSONObj& nextDoc, long long numDocs, int bytesBuffered) {
     invariant(numDocs >= 0);
     if (!numDocs) {
@@ -98,6 +98,14 @@ public:
      */
     static bool enoughForFirstBatch(const QueryRequest& qr, long long numDocs);
 
+    /**
+     * Returns the number of bytes worth reserving up front in the reply buffer for the first batch
+     * of 'qr', given the average size of the documents it will return. Reserving the space once
+     * avoids repeatedly reallocating and copying the reply as a large batch is appended to it.
+     * Returns zero when the initial reply buffer is expected to be large enough.
+     */
+    static int bytesToReserveForFirstBatch(const QueryRequest& qr, int averageObjSize);
+
     /**
      * Returns true if the batchSize for the getMore has been satisfied.
      *
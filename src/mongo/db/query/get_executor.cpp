@@ -81,6 +81,7 @@
 #include "mongo/db/s/operation_sharding_state.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/clustered_id.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/scripting/engine.h"
@@ -227,6 +228,8 @@ void fillOutPlannerParams(OperationContext* opCtx,
         }
     }
 
+    plannerParams->statistics = collection->infoCache()->getStatistics();
+
     // We will not output collection scans unless there are no indexed solutions. NO_TABLE_SCAN
     // overrides this behavior by not outputting a collscan even if there are no indexed
     // solutions.
@@ -312,6 +315,26 @@ struct PrepareExecutionResult {
     unique_ptr<PlanStage> root;
 };
 
+/**
+ * Builds a stage which answers the simple _id query 'canonicalQuery' against a clustered
+ * collection by seeking straight to the RecordId derived from the queried _id.
+ */
+unique_ptr<PlanStage> buildClusteredIdLookup(OperationContext* opCtx,
+                                             Collection* collection,
+                                             WorkingSet* ws,
+                                             const CanonicalQuery& canonicalQuery) {
+    auto key = clusteredid::keyForId(canonicalQuery.getQueryObj()["_id"]);
+    if (!key.isOK()) {
+        // Every document in a clustered collection has an _id which maps to a RecordId.
+        return make_unique<EOFStage>(opCtx);
+    }
+
+    CollectionScanParams params;
+    params.start = key.getValue();
+    params.maxRecord = RecordId(key.getValue().repr() + 1);
+    return make_unique<CollectionScan>(opCtx, collection, params, ws, canonicalQuery.root());
+}
+
 /**
  * Build an execution tree for the query described in 'canonicalQuery'.
  *
@@ -355,11 +378,21 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
 
     const IndexDescriptor* descriptor = collection->getIndexCatalog()->findIdIndex(opCtx);
 
-    // If we have an _id index we can use an idhack plan.
-    if (descriptor && IDHackStage::supportsQuery(collection, *canonicalQuery)) {
-        LOG(2) << "Using idhack: " << redact(canonicalQuery->toStringShort());
-
-        root = make_unique<IDHackStage>(opCtx, canonicalQuery.get(), ws, descriptor);
+    // A clustered collection has no _id index, but can seek to a document by its _id.
+    const bool canUseClusteredIdLookup = !descriptor &&
+        collection->getRecordStore()->isClustered() &&
+        (!canonicalQuery->getProj() || !canonicalQuery->getProj()->wantIndexKey());
+
+    // If we have an _id index, or the collection is clustered, we can use an idhack plan.
+    if ((descriptor || canUseClusteredIdLookup) &&
+        IDHackStage::supportsQuery(collection, *canonicalQuery)) {
+        if (descriptor) {
+            LOG(2) << "Using idhack: " << redact(canonicalQuery->toStringShort());
+            root = make_unique<IDHackStage>(opCtx, canonicalQuery.get(), ws, descriptor);
+        } else {
+            LOG(2) << "Using clustered _id lookup: " << redact(canonicalQuery->toStringShort());
+            root = buildClusteredIdLookup(opCtx, collection, ws, *canonicalQuery);
+        }
 
         // Might have to filter out orphaned docs.
         if (plannerParams.options & QueryPlannerParams::INCLUDE_SHARD_FILTER) {
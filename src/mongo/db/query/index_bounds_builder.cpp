@@ -31,6 +31,8 @@
 
 #include "mongo/db/query/index_bounds_builder.h"
 
+#include <algorithm>
+#include <cctype>
 #include <cmath>
 #include <limits>
 
@@ -252,6 +254,58 @@ string IndexBoundsBuilder::simpleRegex(const char* regex,
 }
 
 
+// static
+std::vector<std::string> IndexBoundsBuilder::caseInsensitiveRegexPrefixes(const char* regex,
+                                                                          const char* flags,
+                                                                          const IndexEntry& index,
+                                                                          size_t maxPrefixes) {
+    std::string caseSensitiveFlags;
+    bool caseInsensitive = false;
+    for (; *flags; ++flags) {
+        if (*flags == 'i') {
+            caseInsensitive = true;
+        } else {
+            caseSensitiveFlags += *flags;
+        }
+    }
+    if (!caseInsensitive || maxPrefixes < 2) {
+        return {};
+    }
+
+    BoundsTightness unused;
+    const string prefix = simpleRegex(regex, caseSensitiveFlags.c_str(), index, &unused);
+
+    std::vector<std::string> prefixes{""};
+    for (char c : prefix) {
+        // Stop at non-ASCII characters, whose case variants we do not enumerate, and at 'k' and
+        // 's', which PCRE also matches case-insensitively against the Kelvin sign and long s.
+        if (static_cast<unsigned char>(c) >= 0x80 || c == 'k' || c == 'K' || c == 's' ||
+            c == 'S') {
+            break;
+        }
+        if (!std::isalpha(static_cast<unsigned char>(c))) {
+            for (auto& p : prefixes) {
+                p += c;
+            }
+            continue;
+        }
+        if (prefixes.size() * 2 > maxPrefixes) {
+            break;
+        }
+        const auto numPrefixes = prefixes.size();
+        for (size_t i = 0; i < numPrefixes; ++i) {
+            prefixes.push_back(prefixes[i] + static_cast<char>(std::toupper(c)));
+            prefixes[i] += static_cast<char>(std::tolower(c));
+        }
+    }
+
+    if (prefixes.front().empty()) {
+        return {};
+    }
+    std::sort(prefixes.begin(), prefixes.end());
+    return prefixes;
+}
+
 // static
 void IndexBoundsBuilder::allValuesForField(const BSONElement& elt, OrderedIntervalList* out) {
     // ARGH, BSONValue would make this shorter.
@@ -721,7 +775,7 @@ void IndexBoundsBuilder::_translatePredicate(const MatchExpression* expr,
             const S2Region& region = gme->getGeoExpression().getGeometry().getS2Region();
             S2IndexingParams indexParams;
             ExpressionParams::initialize2dsphereParams(index.infoObj, index.collator, &indexParams);
-            ExpressionMapping::cover2dsphere(region, indexParams, oilOut);
+            ExpressionMapping::cover2dsphere(region, gme->getRawObj(), indexParams, oilOut);
             *tightnessOut = IndexBoundsBuilder::INEXACT_FETCH;
         } else if ("2d" == elt.valueStringDataSafe()) {
             verify(gme->getGeoExpression().getGeometry().hasR2Region());
@@ -922,8 +976,22 @@ void IndexBoundsBuilder::translateRegex(const RegexMatchExpression* rme,
     const string start =
         simpleRegex(rme->getString().c_str(), rme->getFlags().c_str(), index, tightnessOut);
 
+    // A case-insensitive regex gets one interval per upper and lower case spelling of its prefix.
+    const auto caseInsensitivePrefixes =
+        caseInsensitiveRegexPrefixes(rme->getString().c_str(),
+                                     rme->getFlags().c_str(),
+                                     index,
+                                     internalQueryCaseInsensitiveRegexMaxPrefixes.load());
+
     // Note that 'tightnessOut' is set by simpleRegex above.
-    if (!start.empty()) {
+    if (!caseInsensitivePrefixes.empty()) {
+        for (auto&& prefix : caseInsensitivePrefixes) {
+            string end = prefix;
+            end[end.size() - 1]++;
+            oilOut->intervals.push_back(
+                makeRangeInterval(prefix, end, BoundInclusion::kIncludeStartKeyOnly));
+        }
+    } else if (!start.empty()) {
         string end = start;
         end[end.size() - 1]++;
         oilOut->intervals.push_back(
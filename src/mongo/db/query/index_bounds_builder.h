@@ -160,6 +160,18 @@ public:
                                    const IndexEntry& index,
                                    BoundsTightness* tightnessOut);
 
+    /**
+     * Returns the prefixes which the strings matched by a case-insensitive regex must start with,
+     * one for each upper and lower case spelling of the regex's literal prefix, in ascending
+     * order. Letters are only expanded while there would be at most 'maxPrefixes' prefixes.
+     *
+     * Returns an empty vector if the regex is not case-insensitive or has no usable prefix.
+     */
+    static std::vector<std::string> caseInsensitiveRegexPrefixes(const char* regex,
+                                                                 const char* flags,
+                                                                 const IndexEntry& index,
+                                                                 size_t maxPrefixes);
+
     /**
      * Returns an Interval from minKey to maxKey
      */
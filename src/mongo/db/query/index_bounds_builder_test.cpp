@@ -1527,6 +1527,32 @@ TEST(SimpleRegexTest, FalsePositiveOnPipeInCharacterClassUsesInexactBounds) {
     ASSERT_EQUALS(tightness, IndexBoundsBuilder::INEXACT_COVERED);
 }
 
+TEST(SimpleRegexTest, CaseInsensitivePrefixesExpandLetters) {
+    auto testIndex = buildSimpleIndexEntry();
+    ASSERT(IndexBoundsBuilder::caseInsensitiveRegexPrefixes("^a1b", "i", testIndex, 8) ==
+           (std::vector<std::string>{"A1B", "A1b", "a1B", "a1b"}));
+
+    // Letters are only expanded while the number of prefixes stays within the limit.
+    ASSERT(IndexBoundsBuilder::caseInsensitiveRegexPrefixes("^abc.*", "i", testIndex, 5) ==
+           (std::vector<std::string>{"AB", "Ab", "aB", "ab"}));
+
+    // Expansion stops at 'k' and 's', which also match non-ASCII characters case-insensitively.
+    ASSERT(IndexBoundsBuilder::caseInsensitiveRegexPrefixes("^xsy", "i", testIndex, 64) ==
+           (std::vector<std::string>{"X", "x"}));
+}
+
+TEST(SimpleRegexTest, CaseInsensitivePrefixesRequireUsablePrefix) {
+    auto testIndex = buildSimpleIndexEntry();
+    ASSERT(IndexBoundsBuilder::caseInsensitiveRegexPrefixes("^abc", "", testIndex, 8).empty());
+    ASSERT(IndexBoundsBuilder::caseInsensitiveRegexPrefixes("abc", "i", testIndex, 8).empty());
+    ASSERT(IndexBoundsBuilder::caseInsensitiveRegexPrefixes("^abc", "i", testIndex, 1).empty());
+    ASSERT(IndexBoundsBuilder::caseInsensitiveRegexPrefixes("^sabc", "i", testIndex, 8).empty());
+
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+    testIndex.collator = &collator;
+    ASSERT(IndexBoundsBuilder::caseInsensitiveRegexPrefixes("^abc", "i", testIndex, 8).empty());
+}
+
 // SERVER-9035
 TEST(SimpleRegexTest, RootedSingleLineMode) {
     auto testIndex = buildSimpleIndexEntry();
@@ -41,12 +41,16 @@
 #include <vector>
 
 #include "mongo/base/owned_pointer_vector.h"
+#include "mongo/base/counter.h"
 #include "mongo/base/string_data_comparator_interface.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/matcher/expression_array.h"
 #include "mongo/db/matcher/expression_geo.h"
 #include "mongo/db/query/canonical_query_encoder.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/plan_ranker.h"
+#include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/planner_ixselect.h"
 #include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_solution.h"
@@ -58,6 +62,65 @@
 namespace mongo {
 namespace {
 
+// Node-wide plan cache metrics, summed over the plan caches of all collections.
+Counter64 planCacheHits;
+Counter64 planCacheMisses;
+Counter64 planCacheEvictions;
+Counter64 planCacheTotalSizeEstimateBytes;
+
+ServerStatusMetricField<Counter64> displayPlanCacheHits("query.planCache.hits", &planCacheHits);
+ServerStatusMetricField<Counter64> displayPlanCacheMisses("query.planCache.misses",
+                                                          &planCacheMisses);
+ServerStatusMetricField<Counter64> displayPlanCacheEvictions("query.planCache.evictions",
+                                                             &planCacheEvictions);
+ServerStatusMetricField<Counter64> displayPlanCacheTotalSizeEstimateBytes(
+    "query.planCache.totalSizeEstimateBytes", &planCacheTotalSizeEstimateBytes);
+
+uint64_t estimateIndexTreeSizeInBytes(const PlanCacheIndexTree& tree) {
+    uint64_t size = sizeof(PlanCacheIndexTree) +
+        tree.orPushdowns.size() * sizeof(PlanCacheIndexTree::OrPushdown);
+    if (tree.entry) {
+        size += sizeof(IndexEntry) + tree.entry->keyPattern.objsize() +
+            tree.entry->infoObj.objsize() + tree.entry->identifier.catalogName.size() +
+            tree.entry->identifier.disambiguator.size();
+    }
+    for (auto&& child : tree.children) {
+        size += estimateIndexTreeSizeInBytes(*child);
+    }
+    return size;
+}
+
+uint64_t estimateStatsTreeSizeInBytes(const PlanStageStats& stats) {
+    uint64_t size = sizeof(PlanStageStats);
+    if (auto ixscanStats = dynamic_cast<const IndexScanStats*>(stats.specific.get())) {
+        // Index bounds can grow with the size of the query, e.g. for a large $in.
+        size += sizeof(IndexScanStats) + ixscanStats->keyPattern.objsize() +
+            ixscanStats->indexBounds.objsize() + ixscanStats->collation.objsize();
+    } else if (stats.specific) {
+        // Other specific stats are small and fixed-size for the stages that can be cached.
+        size += sizeof(SpecificStats);
+    }
+    for (auto&& child : stats.children) {
+        size += estimateStatsTreeSizeInBytes(*child);
+    }
+    return size;
+}
+
+uint64_t estimateSolutionTemplateSizeInBytes(const QuerySolutionNode& solnTemplate) {
+    invariant(STAGE_IXSCAN == solnTemplate.getType());
+    const auto& ixscan = static_cast<const IndexScanNode&>(solnTemplate);
+    uint64_t size = sizeof(IndexScanNode) + ixscan.index.keyPattern.objsize() +
+        ixscan.index.infoObj.objsize() + ixscan.index.identifier.catalogName.size() +
+        ixscan.index.identifier.disambiguator.size();
+    for (auto&& oil : ixscan.bounds.fields) {
+        size += sizeof(OrderedIntervalList) + oil.name.size();
+        for (auto&& interval : oil.intervals) {
+            size += sizeof(Interval) + interval._intervalData.objsize();
+        }
+    }
+    return size;
+}
+
 // Delimiters for cache key encoding.
 const char kEncodeDiscriminatorsBegin = '<';
 const char kEncodeDiscriminatorsEnd = '>';
@@ -170,7 +233,8 @@ CachedSolution::CachedSolution(const PlanCacheKey& key, const PlanCacheEntry& en
       sort(entry.sort.getOwned()),
       projection(entry.projection.getOwned()),
       collation(entry.collation.getOwned()),
-      decisionWorks(entry.works) {
+      decisionWorks(entry.works),
+      solutionTemplate(entry.solutionTemplate ? entry.solutionTemplate->clone() : nullptr) {
     // CachedSolution should not having any references into
     // cache entry. All relevant data should be cloned/copied.
     for (size_t i = 0; i < entry.plannerData.size(); ++i) {
@@ -211,6 +275,11 @@ PlanCacheEntry::PlanCacheEntry(const std::vector<QuerySolution*>& solutions,
         invariant(solutions[i]->cacheData.get());
         plannerData[i] = solutions[i]->cacheData->clone();
     }
+
+    // The winning solution comes first.
+    if (!solutions.empty() && internalQueryCacheReuseParameterizedSolutions.load()) {
+        solutionTemplate = QueryPlanner::makeSolutionTemplate(*solutions[0]);
+    }
 }
 
 PlanCacheEntry::~PlanCacheEntry() {
@@ -240,6 +309,10 @@ PlanCacheEntry* PlanCacheEntry::clone() const {
     entry->timeOfCreation = timeOfCreation;
     entry->isActive = isActive;
     entry->works = works;
+    entry->estimatedEntrySizeBytes = estimatedEntrySizeBytes;
+    if (solutionTemplate) {
+        entry->solutionTemplate.reset(solutionTemplate->clone());
+    }
 
     // Copy performance stats.
     entry->feedback = feedback;
@@ -247,6 +320,32 @@ PlanCacheEntry* PlanCacheEntry::clone() const {
     return entry;
 }
 
+uint64_t PlanCacheEntry::estimateObjectSizeInBytes() const {
+    uint64_t size = sizeof(PlanCacheEntry) + query.objsize() + sort.objsize() +
+        projection.objsize() + collation.objsize() + feedback.capacity() * sizeof(double);
+
+    for (auto&& data : plannerData) {
+        size += sizeof(SolutionCacheData);
+        if (data->tree) {
+            size += estimateIndexTreeSizeInBytes(*data->tree);
+        }
+    }
+
+    if (solutionTemplate) {
+        size += estimateSolutionTemplateSizeInBytes(*solutionTemplate);
+    }
+
+    if (decision) {
+        size += sizeof(PlanRankingDecision) + decision->scores.capacity() * sizeof(double) +
+            decision->candidateOrder.capacity() * sizeof(size_t);
+        for (auto&& stats : decision->stats) {
+            size += estimateStatsTreeSizeInBytes(*stats);
+        }
+    }
+
+    return size;
+}
+
 std::string PlanCacheEntry::toString() const {
     return str::stream() << "(query: " << query.toString() << ";sort: " << sort.toString()
                          << ";projection: " << projection.toString()
@@ -364,7 +463,15 @@ PlanCache::PlanCache(size_t size) : _cache(size) {}
 
 PlanCache::PlanCache(const std::string& ns) : _cache(internalQueryCacheSize.load()), _ns(ns) {}
 
-PlanCache::~PlanCache() {}
+PlanCache::~PlanCache() {
+    planCacheTotalSizeEstimateBytes.decrement(_totalSizeEstimateBytes);
+}
+
+void PlanCache::releaseEntry(const PlanCacheEntry& entry) {
+    invariant(_totalSizeEstimateBytes >= entry.estimatedEntrySizeBytes);
+    _totalSizeEstimateBytes -= entry.estimatedEntrySizeBytes;
+    planCacheTotalSizeEstimateBytes.decrement(entry.estimatedEntrySizeBytes);
+}
 
 std::unique_ptr<CachedSolution> PlanCache::getCacheEntryIfActive(const PlanCacheKey& key) const {
 
@@ -372,9 +479,15 @@ std::unique_ptr<CachedSolution> PlanCache::getCacheEntryIfActive(const PlanCache
     if (res.state == PlanCache::CacheEntryState::kPresentInactive) {
         LOG(2) << "Not using cached entry for " << redact(res.cachedSolution->toString())
                << " since it is inactive";
+        planCacheMisses.increment();
         return nullptr;
     }
 
+    if (res.cachedSolution) {
+        planCacheHits.increment();
+    } else {
+        planCacheMisses.increment();
+    }
     return std::move(res.cachedSolution);
 }
 
@@ -539,14 +652,38 @@ Status PlanCache::set(const CanonicalQuery& query,
         projBuilder.append(elem);
     }
     newEntry->projection = projBuilder.obj();
+    newEntry->estimatedEntrySizeBytes =
+        newEntry->estimateObjectSizeInBytes() + key.stringData().size();
 
+    // The entry being replaced, if any, is deleted by add().
+    PlanCacheEntry* replacedEntry = nullptr;
+    if (_cache.get(key, &replacedEntry).isOK()) {
+        releaseEntry(*replacedEntry);
+    }
+
+    _totalSizeEstimateBytes += newEntry->estimatedEntrySizeBytes;
+    planCacheTotalSizeEstimateBytes.increment(newEntry->estimatedEntrySizeBytes);
     std::unique_ptr<PlanCacheEntry> evictedEntry = _cache.add(key, newEntry.release());
 
     if (NULL != evictedEntry.get()) {
+        releaseEntry(*evictedEntry);
+        planCacheEvictions.increment();
         LOG(1) << _ns << ": plan cache maximum size exceeded - "
                << "removed least recently used entry " << redact(evictedEntry->toString());
     }
 
+    // The memory budget is shared by the plan caches of all collections. Once it is exceeded,
+    // make room by evicting this collection's least recently used entries, but never the entry
+    // just added.
+    const long long maxTotalBytes = internalQueryCacheMaxTotalSizeBytes.load();
+    while (planCacheTotalSizeEstimateBytes.get() > maxTotalBytes && _cache.size() > 1) {
+        evictedEntry = _cache.removeLeastRecentlyUsed();
+        releaseEntry(*evictedEntry);
+        planCacheEvictions.increment();
+        LOG(1) << _ns << ": plan cache memory budget of " << maxTotalBytes << " bytes exceeded - "
+               << "removed least recently used entry " << redact(evictedEntry->toString());
+    }
+
     return Status::OK();
 }
 
@@ -608,13 +745,20 @@ Status PlanCache::feedback(const CanonicalQuery& cq, double score) {
 }
 
 Status PlanCache::remove(const CanonicalQuery& canonicalQuery) {
+    const auto key = computeKey(canonicalQuery);
     stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.remove(computeKey(canonicalQuery));
+    PlanCacheEntry* entry = nullptr;
+    if (_cache.get(key, &entry).isOK()) {
+        releaseEntry(*entry);
+    }
+    return _cache.remove(key);
 }
 
 void PlanCache::clear() {
     stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
     _cache.clear();
+    planCacheTotalSizeEstimateBytes.decrement(_totalSizeEstimateBytes);
+    _totalSizeEstimateBytes = 0;
 }
 
 PlanCacheKey PlanCache::computeKey(const CanonicalQuery& cq) const {
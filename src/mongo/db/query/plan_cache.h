@@ -268,6 +268,10 @@ public:
     // The number of work cycles taken to decide on a winning plan when the plan was first
     // cached.
     size_t decisionWorks;
+
+    // Owned here. A copy of the winning solution's index scan, or null if the entry has none. See
+    // PlanCacheEntry::solutionTemplate.
+    std::unique_ptr<QuerySolutionNode> solutionTemplate;
 };
 
 /**
@@ -300,6 +304,12 @@ public:
     // For debugging.
     std::string toString() const;
 
+    /**
+     * Returns an estimate of the memory held by this entry, including its planner data and the
+     * stats trees stored in its ranking decision.
+     */
+    uint64_t estimateObjectSizeInBytes() const;
+
     //
     // Planner data
     //
@@ -309,6 +319,12 @@ public:
     // it from the cache a deep copy is made and returned inside CachedSolution.
     std::vector<SolutionCacheData*> plannerData;
 
+    // If the winning solution is a single index scan whose constants all appear as point
+    // intervals in its bounds, a copy of that index scan. Queries of the same shape can bind their
+    // own constants into it rather than rebuilding the solution from 'plannerData'. Null if the
+    // winning solution cannot be parameterized. See QueryPlanner::makeSolutionTemplate().
+    std::unique_ptr<QuerySolutionNode> solutionTemplate;
+
     // TODO: Do we really want to just hold a copy of the CanonicalQuery?  For now we just
     // extract the data we need.
     //
@@ -347,6 +363,10 @@ public:
     // trigger a replan. Running a query of the same shape while this cache entry is inactive may
     // cause this value to be increased.
     size_t works = 0;
+
+    // The size of this entry and its key as charged against the plan cache memory budget when it
+    // was inserted. See internalQueryCacheMaxTotalSizeBytes.
+    uint64_t estimatedEntrySizeBytes = 0;
 };
 
 /**
@@ -546,9 +566,17 @@ private:
                                    size_t newWorks,
                                    double growthCoefficient);
 
+    /**
+     * Accounts for an entry that has been removed from '_cache'. Callers must hold '_cacheMutex'.
+     */
+    void releaseEntry(const PlanCacheEntry& entry);
+
     LRUKeyValue<PlanCacheKey, PlanCacheEntry, PlanCacheKeyHasher> _cache;
 
-    // Protects _cache.
+    // Sum of 'estimatedEntrySizeBytes' over the entries in '_cache'.
+    uint64_t _totalSizeEstimateBytes = 0;
+
+    // Protects _cache and _totalSizeEstimateBytes.
     mutable stdx::mutex _cacheMutex;
 
     // Full namespace of collection.
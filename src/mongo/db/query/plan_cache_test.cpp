@@ -567,6 +567,39 @@ TEST(PlanCacheTest, PlanCacheLRUPolicyRemovesInactiveEntries) {
     ASSERT_EQ(planCache.get(*cqC).state, PlanCache::CacheEntryState::kPresentInactive);
 }
 
+TEST(PlanCacheTest, PlanCacheMemoryBudgetRemovesLeastRecentlyUsedEntries) {
+    const long long originalMaxTotalSizeBytes = internalQueryCacheMaxTotalSizeBytes.load();
+    ON_BLOCK_EXIT([&] { internalQueryCacheMaxTotalSizeBytes.store(originalMaxTotalSizeBytes); });
+
+    PlanCache planCache;
+    QueryTestServiceContext serviceContext;
+
+    unique_ptr<CanonicalQuery> cqA(canonicalize("{a: 1}"));
+    addCacheEntryForShape(*cqA.get(), &planCache);
+    auto entry = unittest::assertGet(planCache.getEntry(*cqA));
+    ASSERT_GT(entry->estimatedEntrySizeBytes, 0U);
+
+    // The entries for these shapes all have the same estimated size, so a budget of two and a half
+    // entries leaves room for only two of them.
+    const long long entrySize = entry->estimatedEntrySizeBytes;
+    internalQueryCacheMaxTotalSizeBytes.store(2 * entrySize + entrySize / 2);
+
+    unique_ptr<CanonicalQuery> cqB(canonicalize("{b: 1}"));
+    addCacheEntryForShape(*cqB.get(), &planCache);
+    ASSERT_EQ(planCache.size(), 2U);
+
+    // Access the cached solution for the {a: 1} shape. Now the entry for {b: 1} will be the least
+    // recently used, and will be evicted to make room for {c: 1}.
+    ASSERT_EQ(planCache.get(*cqA).state, PlanCache::CacheEntryState::kPresentInactive);
+    unique_ptr<CanonicalQuery> cqC(canonicalize("{c: 1}"));
+    addCacheEntryForShape(*cqC.get(), &planCache);
+
+    ASSERT_EQ(planCache.size(), 2U);
+    ASSERT_EQ(planCache.get(*cqB).state, PlanCache::CacheEntryState::kNotPresent);
+    ASSERT_EQ(planCache.get(*cqA).state, PlanCache::CacheEntryState::kPresentInactive);
+    ASSERT_EQ(planCache.get(*cqC).state, PlanCache::CacheEntryState::kPresentInactive);
+}
+
 TEST(PlanCacheTest, PlanCacheRemoveDeletesInactiveEntries) {
     PlanCache planCache;
     unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
@@ -1250,6 +1283,65 @@ TEST_F(CachePlanSelectionTest, EqualityIndexScanWithTrailingFields) {
         BSON("x" << 5), "{fetch: {filter: null, node: {ixscan: {pattern: {x: 1, y: 1}}}}}");
 }
 
+TEST_F(CachePlanSelectionTest, ParameterizedSolutionBindsNewEqualityConstants) {
+    const bool oldReuseParameterizedSolutions =
+        internalQueryCacheReuseParameterizedSolutions.load();
+    internalQueryCacheReuseParameterizedSolutions.store(true);
+    ON_BLOCK_EXIT([oldReuseParameterizedSolutions] {
+        internalQueryCacheReuseParameterizedSolutions.store(oldReuseParameterizedSolutions);
+    });
+
+    addIndex(BSON("x" << 1 << "y" << 1), "x_1_y_1");
+    runQuery(BSON("x" << 5 << "y"
+                      << "foo"));
+    auto bestSoln =
+        firstMatchingSolution("{fetch: {filter: null, node: {ixscan: {pattern: {x: 1, y: 1}}}}}");
+
+    // Build the cache entry from the whole winning solution so that it keeps a template.
+    std::vector<QuerySolution*> solutions{bestSoln};
+    uint32_t queryHash = canonical_query_encoder::computeHash(ck.stringData());
+    PlanCacheEntry entry(solutions, createDecision(1U).release(), queryHash, queryHash);
+    ASSERT(entry.solutionTemplate);
+    CachedSolution cachedSoln(ck, entry);
+
+    unique_ptr<CanonicalQuery> cq(canonicalize("{x: 7, y: 'bar'}"));
+    auto statusWithQs = QueryPlanner::planFromCache(*cq, params, cachedSoln);
+    ASSERT_OK(statusWithQs.getStatus());
+    assertSolutionMatches(statusWithQs.getValue().get(),
+                          "{fetch: {filter: null, node: {ixscan: {pattern: {x: 1, y: 1}, "
+                          "bounds: {x: [[7, 7, true, true]], y: [['bar', 'bar', true, true]]}}}}}");
+}
+
+TEST_F(CachePlanSelectionTest, ParameterizedSolutionIsNotBoundForSpecialConstantsOrExtraStages) {
+    addIndex(BSON("x" << 1), "x_1");
+    runQuery(BSON("x" << 5));
+    auto bestSoln =
+        firstMatchingSolution("{fetch: {filter: null, node: {ixscan: {pattern: {x: 1}}}}}");
+    auto solnTemplate = QueryPlanner::makeSolutionTemplate(*bestSoln);
+    ASSERT(solnTemplate);
+
+    unique_ptr<CanonicalQuery> cq(canonicalize("{x: 6}"));
+    ASSERT(QueryPlanner::bindSolutionTemplate(*cq, params, *solnTemplate));
+
+    // Equality to null or to an array does not translate to a single point interval.
+    cq = canonicalize("{x: null}");
+    ASSERT_FALSE(QueryPlanner::bindSolutionTemplate(*cq, params, *solnTemplate));
+    cq = canonicalize("{x: [1, 2]}");
+    ASSERT_FALSE(QueryPlanner::bindSolutionTemplate(*cq, params, *solnTemplate));
+
+    // A projection would need stages the template doesn't have.
+    cq = canonicalize("{x: 6}", "{}", "{_id: 0, x: 1}", "{}");
+    ASSERT_FALSE(QueryPlanner::bindSolutionTemplate(*cq, params, *solnTemplate));
+}
+
+TEST_F(CachePlanSelectionTest, SolutionWithResidualFilterIsNotParameterized) {
+    addIndex(BSON("x" << 1), "x_1");
+    runQuery(BSON("x" << 5 << "y" << 6));
+    auto bestSoln =
+        firstMatchingSolution("{fetch: {filter: {y: 6}, node: {ixscan: {pattern: {x: 1}}}}}");
+    ASSERT_FALSE(QueryPlanner::makeSolutionTemplate(*bestSoln));
+}
+
 //
 // Geo
 //
@@ -287,6 +287,11 @@ public:
      */
     virtual OperationContext* getOpCtx() const = 0;
 
+    /**
+     * Return the policy which decides when this plan yields, without transferring ownership.
+     */
+    virtual const PlanYieldPolicy* getYieldPolicy() const = 0;
+
     //
     // Methods that just pass down to the PlanStage tree.
     //
@@ -319,6 +319,10 @@ OperationContext* PlanExecutorImpl::getOpCtx() const {
     return _opCtx;
 }
 
+const PlanYieldPolicy* PlanExecutorImpl::getYieldPolicy() const {
+    return _yieldPolicy.get();
+}
+
 void PlanExecutorImpl::saveState() {
     invariant(_currentState == kUsable || _currentState == kSaved);
 
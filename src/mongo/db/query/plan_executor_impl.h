@@ -60,6 +60,7 @@ public:
     CanonicalQuery* getCanonicalQuery() const final;
     const NamespaceString& nss() const final;
     OperationContext* getOpCtx() const final;
+    const PlanYieldPolicy* getYieldPolicy() const final;
     void saveState() final;
     void restoreState() final;
     void detachFromOperationContext() final;
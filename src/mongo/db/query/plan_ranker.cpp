@@ -111,6 +111,14 @@ size_t PlanRanker::pickBestPlan(const vector<CandidatePlan>& candidates, PlanRan
     std::stable_sort(
         scoresAndCandidateindices.begin(), scoresAndCandidateindices.end(), scoreComparator);
 
+    // Plans pruned during the trial period stopped accumulating work early, so their scores are
+    // not comparable with those of the plans that ran for the whole trial.
+    std::stable_partition(scoresAndCandidateindices.begin(),
+                          scoresAndCandidateindices.end(),
+                          [&](const std::pair<double, size_t>& scoreAndCandidate) {
+                              return !candidates[scoreAndCandidate.second].pruned;
+                          });
+
     // Determine whether plans tied for the win.
     if (scoresAndCandidateindices.size() > 1U) {
         double bestScore = scoresAndCandidateindices[0].first;
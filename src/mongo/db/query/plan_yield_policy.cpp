@@ -31,6 +31,9 @@
 
 #include "mongo/db/query/plan_yield_policy.h"
 
+#include <utility>
+
+#include "mongo/db/concurrency/lock_state.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/curop_failpoint_helpers.h"
@@ -41,6 +44,7 @@
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -52,18 +56,24 @@ PlanYieldPolicy::PlanYieldPolicy(PlanExecutor* exec, PlanExecutor::YieldPolicy p
     : _policy(exec->getOpCtx()->lockState()->isGlobalLockedRecursively() ? PlanExecutor::NO_YIELD
                                                                          : policy),
       _forceYield(false),
-      _elapsedTracker(exec->getOpCtx()->getServiceContext()->getFastClockSource(),
+      _clockSource(exec->getOpCtx()->getServiceContext()->getFastClockSource()),
+      _elapsedTracker(_clockSource,
                       internalQueryExecYieldIterations.load(),
                       Milliseconds(internalQueryExecYieldPeriodMS.load())),
+      _numConflictingRequestsAtLastYield(getGlobalLockManager()->getNumConflictingRequests()),
+      _lastYieldTime(_clockSource->now()),
       _planYielding(exec) {}
 
 
 PlanYieldPolicy::PlanYieldPolicy(PlanExecutor::YieldPolicy policy, ClockSource* cs)
     : _policy(policy),
       _forceYield(false),
+      _clockSource(cs),
       _elapsedTracker(cs,
                       internalQueryExecYieldIterations.load(),
                       Milliseconds(internalQueryExecYieldPeriodMS.load())),
+      _numConflictingRequestsAtLastYield(getGlobalLockManager()->getNumConflictingRequests()),
+      _lastYieldTime(cs->now()),
       _planYielding(nullptr) {}
 
 bool PlanYieldPolicy::shouldYieldOrInterrupt() {
@@ -86,6 +96,24 @@ void PlanYieldPolicy::resetTimer() {
     _elapsedTracker.resetLastTime();
 }
 
+bool PlanYieldPolicy::yieldIsNeeded() const {
+    if (!internalQueryExecYieldOnlyWhenNeeded.load()) {
+        return true;
+    }
+
+    // A request queued behind a lock we hold may be waiting on this plan. The count is global, so
+    // any conflict anywhere forces a yield, which errs on the side of yielding.
+    if (getGlobalLockManager()->getNumConflictingRequests() !=
+        _numConflictingRequestsAtLastYield) {
+        return true;
+    }
+
+    // Bound how long the plan pins an old snapshot, which also bounds how long a waiter that
+    // queued before the last yield, and so is not reflected in the count, can be made to wait.
+    return _clockSource->now() - _lastYieldTime >=
+        Milliseconds(internalQueryExecYieldMaxSnapshotAgeMS.load());
+}
+
 Status PlanYieldPolicy::yieldOrInterrupt(stdx::function<void()> whileYieldingFn) {
     invariant(_planYielding);
 
@@ -117,12 +145,30 @@ Status PlanYieldPolicy::yield(stdx::function<void()> whileYieldingFn) {
     // until after we return from the yield.
     ON_BLOCK_EXIT([this]() { resetTimer(); });
 
-    _forceYield = false;
+    const bool forced = std::exchange(_forceYield, false);
 
     OperationContext* opCtx = _planYielding->getOpCtx();
     invariant(opCtx);
     invariant(!opCtx->lockState()->inAWriteUnitOfWork());
 
+    // Forced yields and yields with work to do while unlocked must always release their locks.
+    // Periodic ones may keep them if nobody needs them and the snapshot is still recent.
+    if (_policy == PlanExecutor::YIELD_AUTO && !forced && !whileYieldingFn && !yieldIsNeeded()) {
+        auto interruptStatus = opCtx->checkForInterruptNoAssert();
+        if (interruptStatus.isOK()) {
+            ++_yieldStats.numSkippedYields;
+        }
+        return interruptStatus;
+    }
+
+    ++_yieldStats.numYields;
+    _numConflictingRequestsAtLastYield = getGlobalLockManager()->getNumConflictingRequests();
+    Timer yieldTimer;
+    ON_BLOCK_EXIT([&] {
+        _yieldStats.yieldTime += Microseconds(yieldTimer.micros());
+        _lastYieldTime = _clockSource->now();
+    });
+
     // Can't use writeConflictRetry since we need to call saveState before reseting the transaction.
     for (int attempt = 1; true; attempt++) {
         try {
@@ -40,6 +40,21 @@ class ClockSource;
 
 class PlanYieldPolicy {
 public:
+    /**
+     * Counts what yielding has cost this plan, for reporting in explain.
+     */
+    struct YieldStats {
+        // The number of times locks or storage engine state were actually released.
+        long long numYields = 0;
+
+        // The number of periodic yields skipped because nothing was waiting on this plan's locks
+        // and its snapshot was still recent.
+        long long numSkippedYields = 0;
+
+        // The time spent saving state, yielding and restoring state.
+        Microseconds yieldTime{0};
+    };
+
     virtual ~PlanYieldPolicy() {}
 
     PlanYieldPolicy(PlanExecutor* exec, PlanExecutor::YieldPolicy policy);
@@ -134,12 +149,25 @@ public:
         return _policy;
     }
 
+    const YieldStats& getYieldStats() const {
+        return _yieldStats;
+    }
+
 private:
     const PlanExecutor::YieldPolicy _policy;
 
     bool _forceYield;
+    ClockSource* const _clockSource;
     ElapsedTracker _elapsedTracker;
 
+    // The lock manager's count of conflicting lock requests and the time, as of this plan's last
+    // yield. Used to skip yields that would not help anyone when
+    // 'internalQueryExecYieldOnlyWhenNeeded' is set.
+    unsigned long long _numConflictingRequestsAtLastYield;
+    Date_t _lastYieldTime;
+
+    YieldStats _yieldStats;
+
     // The plan executor which this yield policy is responsible for yielding. Must
     // not outlive the plan executor.
     PlanExecutor* const _planYielding;
@@ -147,6 +175,10 @@ private:
     // Returns true to indicate it's time to release locks or storage engine state.
     bool shouldYield();
 
+    // Returns false if a periodic yield can be skipped because no lock request has had to wait
+    // since the last yield and the storage snapshot is still recent.
+    bool yieldIsNeeded() const;
+
     // Releases locks or storage engine state.
     Status yield(stdx::function<void()> whileYieldingFn);
 };
@@ -41,6 +41,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression_geo.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/util/log.h"
 
@@ -724,6 +725,14 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
         sort->limit = 0;
     }
 
+    // A text search which keeps only the best 'limit' documents by score can stop reading the text
+    // index early, provided that nothing between the sort and the TEXT node discards documents.
+    if (sort->limit && internalQueryTextOrTopK.load() && sortObj.nFields() == 1 &&
+        QueryRequest::isTextScoreMeta(sortObj.firstElement()) &&
+        STAGE_TEXT == keyGenNode->children[0]->getType()) {
+        static_cast<TextNode*>(keyGenNode->children[0])->topK = sort->limit;
+    }
+
     *blockingSortOut = true;
 
     return solnRoot;
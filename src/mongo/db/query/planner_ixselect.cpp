@@ -46,6 +46,7 @@
 #include "mongo/db/query/index_tag.h"
 #include "mongo/db/query/indexability.h"
 #include "mongo/db/query/planner_wildcard_helpers.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/util/log.h"
 
@@ -308,18 +309,37 @@ std::vector<IndexEntry> QueryPlannerIXSelect::findIndexesByHint(
 std::vector<IndexEntry> QueryPlannerIXSelect::findRelevantIndices(
     const stdx::unordered_set<std::string>& fields, const std::vector<IndexEntry>& allIndices) {
 
+    const bool skipScan = internalQueryPlannerEnableSkipScan.load();
+
     std::vector<IndexEntry> out;
     for (auto&& entry : allIndices) {
         BSONObjIterator it(entry.keyPattern);
         BSONElement elt = it.next();
         if (fields.end() != fields.find(elt.fieldName())) {
             out.push_back(entry);
+            continue;
+        }
+
+        if (skipScan && canSkipScan(entry)) {
+            while (it.more()) {
+                if (fields.end() != fields.find(it.next().fieldName())) {
+                    out.push_back(entry);
+                    break;
+                }
+            }
         }
     }
 
     return out;
 }
 
+bool QueryPlannerIXSelect::canSkipScan(const IndexEntry& index) {
+    // Multikey and sparse indexes are excluded to keep the usual compounding rules, which assume a
+    // predicate over the leading field, sufficient.
+    return index.type == IndexType::INDEX_BTREE && !index.multikey && !index.sparse &&
+        index.keyPattern.nFields() > 1;
+}
+
 std::vector<IndexEntry> QueryPlannerIXSelect::expandIndexes(
     const stdx::unordered_set<std::string>& fields, std::vector<IndexEntry> relevantIndices) {
     std::vector<IndexEntry> out;
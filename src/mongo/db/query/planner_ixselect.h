@@ -69,11 +69,18 @@ public:
 
     /**
      * Finds all indices prefixed by fields we have predicates over.  Only these indices are
-     * useful in answering the query.
+     * useful in answering the query. When skip scans are enabled, also finds the indices which
+     * can be skip scanned over any field we have predicates over.
      */
     static std::vector<IndexEntry> findRelevantIndices(
         const stdx::unordered_set<std::string>& fields, const std::vector<IndexEntry>& allIndices);
 
+    /**
+     * Returns true if 'index' can answer predicates over its non-leading fields alone, by seeking
+     * from each distinct value of its leading fields to the bounds of the later fields.
+     */
+    static bool canSkipScan(const IndexEntry& index);
+
     /**
      * Determine how useful all of our relevant 'indices' are to all predicates in the subtree
      * rooted at 'node'.  Affixes a RelevantTag to all predicate nodes which can use an index.
@@ -33,6 +33,7 @@
 
 #include "mongo/db/query/query_planner.h"
 
+#include <algorithm>
 #include <boost/optional.hpp>
 #include <vector>
 
@@ -43,15 +44,18 @@
 #include "mongo/db/index_names.h"
 #include "mongo/db/matcher/expression_algo.h"
 #include "mongo/db/matcher/expression_geo.h"
+#include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/matcher/expression_text.h"
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/collation/collation_index_key.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_enumerator.h"
 #include "mongo/db/query/planner_access.h"
 #include "mongo/db/query/planner_analysis.h"
 #include "mongo/db/query/planner_ixselect.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/db/query/query_solution.h"
 #include "mongo/util/log.h"
@@ -290,10 +294,133 @@ std::unique_ptr<QuerySolution> buildWholeIXSoln(const IndexEntry& index,
     return QueryPlannerAnalysis::analyzeDataAccess(query, params, std::move(solnRoot));
 }
 
+/**
+ * Returns true if 'node' has an index scan descendant which has no bounds over the leading field
+ * of its index but has bounds over a later field, that is, a skip scan.
+ */
+static bool hasSkipScan(const QuerySolutionNode* node) {
+    if (STAGE_IXSCAN == node->getType()) {
+        const auto& bounds = static_cast<const IndexScanNode*>(node)->bounds;
+        auto isAllValues = [](const OrderedIntervalList& oil) {
+            return oil.intervals.size() == 1 &&
+                (oil.intervals[0].isMinToMax() ||
+                 (oil.intervals[0].start.type() == BSONType::MaxKey &&
+                  oil.intervals[0].end.type() == BSONType::MinKey));
+        };
+        if (!bounds.isSimpleRange && bounds.fields.size() > 1 && isAllValues(bounds.fields[0]) &&
+            !std::all_of(bounds.fields.begin() + 1, bounds.fields.end(), isAllValues)) {
+            return true;
+        }
+    }
+
+    for (auto&& child : node->children) {
+        if (hasSkipScan(child)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Returns the number of index keys or documents which 'node' is expected to examine, per document
+ * in the collection, according to 'statistics'.
+ */
+static double estimateKeysExamined(const QuerySolutionNode* node,
+                                   const CollectionStatistics& statistics) {
+    if (STAGE_IXSCAN == node->getType()) {
+        const auto* ixn = static_cast<const IndexScanNode*>(node);
+        if (ixn->bounds.isSimpleRange || ixn->index.collator || INDEX_BTREE != ixn->index.type) {
+            return 1.0;
+        }
+
+        // Assume the fields are independent. After the first field with a range, the bounds of
+        // the later ones no longer narrow the scan.
+        double estimate = 1.0;
+        BSONObjIterator kpIt(ixn->index.keyPattern);
+        for (auto&& oil : ixn->bounds.fields) {
+            const FieldHistogram* histogram =
+                statistics.getHistogram(kpIt.next().fieldNameStringData());
+            if (!histogram) {
+                break;
+            }
+            estimate *= histogram->estimateFraction(oil);
+            if (!std::all_of(oil.intervals.begin(),
+                             oil.intervals.end(),
+                             [](const Interval& interval) { return interval.isPoint(); })) {
+                break;
+            }
+        }
+        return estimate;
+    }
+
+    if (node->children.empty()) {
+        return 1.0;
+    }
+
+    // Index intersection and $or scan every branch.
+    double estimate = 0;
+    for (auto&& child : node->children) {
+        estimate += estimateKeysExamined(child, statistics);
+    }
+    return estimate;
+}
+
 bool providesSort(const CanonicalQuery& query, const BSONObj& kp) {
     return query.getQueryRequest().getSort().isPrefixOf(kp, SimpleBSONElementComparator::kInstance);
 }
 
+/**
+ * Returns the index scan of a solution tree consisting of a single btree IXSCAN, optionally beneath
+ * a FETCH, with no filter anywhere in the tree. Returns nullptr if the tree has any other shape, or
+ * if the index scan's bounds could depend on anything other than the equality constants of the
+ * query, such as a collation or a partial filter.
+ */
+const IndexScanNode* getParameterizableIndexScan(const QuerySolutionNode* root) {
+    if (root->filter) {
+        return nullptr;
+    }
+
+    if (STAGE_FETCH == root->getType()) {
+        if (root->children.size() != 1) {
+            return nullptr;
+        }
+        root = root->children[0];
+        if (root->filter) {
+            return nullptr;
+        }
+    }
+
+    if (STAGE_IXSCAN != root->getType()) {
+        return nullptr;
+    }
+
+    auto ixscan = static_cast<const IndexScanNode*>(root);
+    const IndexEntry& index = ixscan->index;
+    if (INDEX_BTREE != index.type || index.collator || index.filterExpr || ixscan->queryCollator ||
+        ixscan->addKeyMetadata || ixscan->bounds.isSimpleRange) {
+        return nullptr;
+    }
+    return ixscan;
+}
+
+/**
+ * Returns true if an equality to 'data' is answered exactly by the point interval [data, data],
+ * which is the case for all types except the ones that equality bounds special-case.
+ */
+bool isPointEqualityConstant(const BSONElement& data) {
+    switch (data.type()) {
+        case jstNULL:
+        case Undefined:
+        case Array:
+        case RegEx:
+        case MinKey:
+        case MaxKey:
+            return false;
+        default:
+            return true;
+    }
+}
+
 // static
 const int QueryPlanner::kPlannerVersion = 1;
 
@@ -437,6 +564,101 @@ Status QueryPlanner::tagAccordingToCache(MatchExpression* filter,
     return Status::OK();
 }
 
+// static
+std::unique_ptr<QuerySolutionNode> QueryPlanner::makeSolutionTemplate(const QuerySolution& soln) {
+    if (!soln.root) {
+        return nullptr;
+    }
+
+    // Only the index scan is kept. Whether it needs a FETCH depends on the caller's planner
+    // parameters, so bindSolutionTemplate() adds one when required.
+    auto ixscan = getParameterizableIndexScan(soln.root.get());
+    if (!ixscan) {
+        return nullptr;
+    }
+    return std::unique_ptr<QuerySolutionNode>(ixscan->clone());
+}
+
+// static
+std::unique_ptr<QuerySolution> QueryPlanner::bindSolutionTemplate(
+    const CanonicalQuery& query,
+    const QueryPlannerParams& params,
+    const QuerySolutionNode& solnTemplate) {
+    // Skip, limit, projections and the shard filter are not part of the query shape but add
+    // stages on top of the index scan, so such queries go through the regular cache path.
+    const QueryRequest& qr = query.getQueryRequest();
+    if (query.getCollator() || query.getProj() || qr.getSkip() || qr.getLimit() ||
+        (qr.getNToReturn() && !qr.wantMore()) || qr.returnKey() ||
+        (params.options & QueryPlannerParams::INCLUDE_SHARD_FILTER)) {
+        return nullptr;
+    }
+
+    std::vector<const ComparisonMatchExpression*> equalities;
+    const MatchExpression* root = query.root();
+    if (MatchExpression::EQ == root->matchType()) {
+        equalities.push_back(static_cast<const ComparisonMatchExpression*>(root));
+    } else if (MatchExpression::AND == root->matchType()) {
+        for (size_t i = 0; i < root->numChildren(); ++i) {
+            const MatchExpression* child = root->getChild(i);
+            if (MatchExpression::EQ != child->matchType()) {
+                return nullptr;
+            }
+            equalities.push_back(static_cast<const ComparisonMatchExpression*>(child));
+        }
+    } else {
+        return nullptr;
+    }
+
+    invariant(STAGE_IXSCAN == solnTemplate.getType());
+    std::unique_ptr<IndexScanNode> ixscan(static_cast<IndexScanNode*>(solnTemplate.clone()));
+
+    // Every equality must replace the point interval of exactly one index field. Fields without
+    // an equality keep the template's bounds, which do not depend on the query's constants.
+    size_t numBound = 0;
+    for (auto&& oil : ixscan->bounds.fields) {
+        const ComparisonMatchExpression* equality = nullptr;
+        for (auto&& candidate : equalities) {
+            if (candidate->path() == oil.name) {
+                if (equality) {
+                    return nullptr;
+                }
+                equality = candidate;
+            }
+        }
+        if (!equality) {
+            continue;
+        }
+
+        if (!isPointEqualityConstant(equality->getData()) || oil.intervals.size() != 1 ||
+            !oil.intervals[0].isPoint()) {
+            return nullptr;
+        }
+        oil.intervals[0] = IndexBoundsBuilder::makePointInterval(
+            IndexBoundsBuilder::objFromElement(equality->getData(), nullptr));
+        ++numBound;
+    }
+
+    if (numBound != equalities.size()) {
+        return nullptr;
+    }
+
+    std::unique_ptr<QuerySolutionNode> solnRoot = std::move(ixscan);
+    if (!(params.options & QueryPlannerParams::IS_COUNT)) {
+        auto fetch = stdx::make_unique<FetchNode>();
+        fetch->children.push_back(solnRoot.release());
+        solnRoot = std::move(fetch);
+    }
+    solnRoot->computeProperties();
+
+    auto soln = stdx::make_unique<QuerySolution>();
+    soln->filterData = query.getQueryObj();
+    soln->indexFilterApplied = params.indexFiltersApplied;
+    soln->root = std::move(solnRoot);
+
+    LOG(5) << "Planner: solution bound from the cached template:\n" << redact(soln->toString());
+    return soln;
+}
+
 StatusWith<std::unique_ptr<QuerySolution>> QueryPlanner::planFromCache(
     const CanonicalQuery& query,
     const QueryPlannerParams& params,
@@ -470,6 +692,12 @@ StatusWith<std::unique_ptr<QuerySolution>> QueryPlanner::planFromCache(
         }
     }
 
+    if (cachedSoln.solutionTemplate && internalQueryCacheReuseParameterizedSolutions.load()) {
+        if (auto soln = bindSolutionTemplate(query, params, *cachedSoln.solutionTemplate)) {
+            return {std::move(soln)};
+        }
+    }
+
     // SolutionCacheData::USE_TAGS_SOLN == cacheData->solnType
     // If we're here then this is neither the whole index scan or collection scan
     // cases, and we proceed by using the PlanCacheIndexTree to tag the query tree.
@@ -994,7 +1222,32 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
     bool collscanRequested = (params.options & QueryPlannerParams::INCLUDE_COLLSCAN);
 
     // No indexed plans?  We must provide a collscan if possible or else we can't run the query.
+    // A skip scan can be much slower than a collscan when the leading field has many distinct
+    // values, so if every indexed plan is one, the collscan competes with them too.
     bool collscanNeeded = (0 == out.size() && canTableScan);
+    if (!collscanNeeded && canTableScan && internalQueryPlannerEnableSkipScan.load()) {
+        collscanNeeded = std::all_of(out.begin(), out.end(), [](const auto& soln) {
+            return hasSkipScan(soln->root.get());
+        });
+    }
+
+    // The plan ranker breaks ties in favor of the earlier candidate, so order the candidates by
+    // how selective the statistics say they are.
+    if (params.statistics && out.size() > 1) {
+        std::vector<std::pair<double, std::unique_ptr<QuerySolution>>> estimated;
+        for (auto&& soln : out) {
+            double estimate = estimateKeysExamined(soln->root.get(), *params.statistics);
+            estimated.emplace_back(estimate, std::move(soln));
+        }
+        std::stable_sort(estimated.begin(), estimated.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.first < rhs.first;
+        });
+        for (size_t ix = 0; ix < out.size(); ++ix) {
+            LOG(5) << "Planner: solution " << ix << " is estimated to examine "
+                   << estimated[ix].first << " keys per document";
+            out[ix] = std::move(estimated[ix].second);
+        }
+    }
 
     if (possibleToCollscan && (collscanRequested || collscanNeeded)) {
         auto collscan = buildCollscanSoln(query, isTailable, params);
@@ -67,6 +67,26 @@ public:
         const QueryPlannerParams& params,
         const CachedSolution& cachedSoln);
 
+    /**
+     * Returns a copy of the index scan in 'soln' which can be kept in the plan cache and reused by
+     * bindSolutionTemplate() for later queries of the same shape, or nullptr if 'soln' cannot be
+     * parameterized. Only solutions made up of a single btree index scan, optionally beneath a
+     * fetch, and with no filters are eligible: the query's constants then appear only as point
+     * intervals in the index bounds.
+     */
+    static std::unique_ptr<QuerySolutionNode> makeSolutionTemplate(const QuerySolution& soln);
+
+    /**
+     * Builds a solution for 'query' by cloning 'solnTemplate', as returned by
+     * makeSolutionTemplate(), and replacing the point intervals in its bounds with the equality
+     * constants of 'query'. Returns nullptr if 'query' cannot be answered this way, in which case
+     * the caller should plan from the cached index tags instead.
+     */
+    static std::unique_ptr<QuerySolution> bindSolutionTemplate(
+        const CanonicalQuery& query,
+        const QueryPlannerParams& params,
+        const QuerySolutionNode& solnTemplate);
+
     /**
      * Generates and returns the index tag tree that will be inserted into the plan cache. This data
      * gets stashed inside a QuerySolution until it can be inserted into the cache proper.
@@ -0,0 +1,173 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/index_names.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_planner.h"
+#include "mongo/db/query/query_planner_params.h"
+#include "mongo/db/query/query_solution.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("test.query_planner_bm");
+
+const std::vector<std::string> kIndexedFields{"a", "b", "c", "d", "e", "f", "g", "h"};
+
+// A conjunction over several indexed fields, as sent by a typical application.
+BSONObj makeFilter() {
+    return BSON("a" << 1 << "b" << BSON("$gt" << 5 << "$lt" << 50) << "c"
+                    << BSON("$in" << BSON_ARRAY(1 << 2 << 3))
+                    << "d"
+                    << "x"
+                    << "e.f"
+                    << BSON("$exists" << true));
+}
+
+std::unique_ptr<CanonicalQuery> canonicalize(OperationContext* opCtx,
+                                             const BSONObj& filter,
+                                             const BSONObj& sort,
+                                             const BSONObj& proj) {
+    auto qr = std::make_unique<QueryRequest>(kNss);
+    qr->setFilter(filter);
+    qr->setSort(sort);
+    qr->setProj(proj);
+    const boost::intrusive_ptr<ExpressionContext> expCtx;
+    auto statusWithCQ =
+        CanonicalQuery::canonicalize(opCtx,
+                                     std::move(qr),
+                                     expCtx,
+                                     ExtensionsCallbackNoop(),
+                                     MatchExpressionParser::kAllowAllSpecialFeatures);
+    return uassertStatusOK(std::move(statusWithCQ));
+}
+
+IndexEntry makeIndexEntry(const BSONObj& keyPattern, const std::string& name) {
+    return {keyPattern,
+            IndexNames::nameToType(IndexNames::findPluginName(keyPattern)),
+            false,  // multikey
+            {},
+            {},
+            false,  // sparse
+            false,  // unique
+            IndexEntry::Identifier{name},
+            nullptr,  // filterExpr
+            BSONObj(),
+            nullptr,
+            nullptr};
+}
+
+// Returns 'numIndexes' indexes over the fields the filter refers to: first one single-field index
+// per field, then compound indexes over pairs of fields.
+std::vector<IndexEntry> makeIndexes(size_t numIndexes) {
+    std::vector<BSONObj> keyPatterns;
+    for (auto&& field : kIndexedFields) {
+        keyPatterns.push_back(BSON(field << 1));
+    }
+    for (auto&& first : kIndexedFields) {
+        for (auto&& second : kIndexedFields) {
+            if (first != second) {
+                keyPatterns.push_back(BSON(first << 1 << second << 1));
+            }
+        }
+    }
+    invariant(numIndexes <= keyPatterns.size());
+
+    std::vector<IndexEntry> indexes;
+    for (size_t i = 0; i < numIndexes; ++i) {
+        indexes.push_back(makeIndexEntry(keyPatterns[i], str::stream() << "index_" << i));
+    }
+    return indexes;
+}
+
+void BM_CanonicalQueryParse(benchmark::State& state) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    const auto filter = makeFilter();
+    const auto sort = BSON("a" << 1 << "b" << -1);
+    const auto proj = BSON("_id" << 0 << "a" << 1 << "b" << 1);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(canonicalize(opCtx.get(), filter, sort, proj));
+    }
+}
+
+void BM_CanonicalQueryEncodeKey(benchmark::State& state) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    const auto cq = canonicalize(
+        opCtx.get(), makeFilter(), BSON("a" << 1 << "b" << -1), BSON("_id" << 0 << "a" << 1));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cq->encodeKey());
+    }
+}
+
+void BM_QueryPlannerPlan(benchmark::State& state) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    const auto cq = canonicalize(opCtx.get(), makeFilter(), BSONObj(), BSONObj());
+
+    QueryPlannerParams params;
+    params.indices = makeIndexes(state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(uassertStatusOK(QueryPlanner::plan(*cq, params)));
+    }
+}
+
+void BM_QueryPlannerPlanWithSort(benchmark::State& state) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    const auto cq = canonicalize(opCtx.get(), makeFilter(), BSON("g" << 1), BSONObj());
+
+    QueryPlannerParams params;
+    params.indices = makeIndexes(state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(uassertStatusOK(QueryPlanner::plan(*cq, params)));
+    }
+}
+
+BENCHMARK(BM_CanonicalQueryParse);
+BENCHMARK(BM_CanonicalQueryEncodeKey);
+BENCHMARK(BM_QueryPlannerPlan)->Arg(1)->Arg(8)->Arg(32)->Arg(64);
+BENCHMARK(BM_QueryPlannerPlanWithSort)->Arg(1)->Arg(8)->Arg(32)->Arg(64);
+
+}  // namespace
+}  // namespace mongo
@@ -29,9 +29,11 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "mongo/db/jsobj.h"
+#include "mongo/db/query/collection_statistics.h"
 #include "mongo/db/query/index_entry.h"
 #include "mongo/db/query/query_knobs_gen.h"
 
@@ -118,6 +120,10 @@ struct QueryPlannerParams {
     // plans via the MultiPlanStage, and the set of possible plans is very large for certain
     // index+query combinations.
     size_t maxIndexedSolutions;
+
+    // Sampled statistics of the collection, if it has been analyzed. Used to put the indexed
+    // solutions expected to examine the fewest keys first.
+    std::shared_ptr<const CollectionStatistics> statistics;
 };
 
 }  // namespace mongo
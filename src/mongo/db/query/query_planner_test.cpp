@@ -37,6 +37,7 @@
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/expression_always_boolean.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_test_fixture.h"
 
@@ -5957,4 +5958,78 @@ TEST_F(QueryPlannerTest, FetchAfterSortWhenOnlyProjectNeedsDocuments) {
         "{sortKeyGen:{node: {ixscan: "
         "{pattern: {a: 1, b: 1}}}}}}}}}}}");
 }
+
+//
+// Skip scans
+//
+
+class QueryPlannerSkipScanTest : public QueryPlannerTest {
+protected:
+    void setUp() final {
+        QueryPlannerTest::setUp();
+        _oldEnableSkipScan = internalQueryPlannerEnableSkipScan.load();
+        internalQueryPlannerEnableSkipScan.store(true);
+    }
+
+    void tearDown() final {
+        internalQueryPlannerEnableSkipScan.store(_oldEnableSkipScan);
+        QueryPlannerTest::tearDown();
+    }
+
+private:
+    bool _oldEnableSkipScan;
+};
+
+TEST_F(QueryPlannerTest, NoSkipScanOnNonLeadingFieldByDefault) {
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5}}}");
+}
+
+TEST_F(QueryPlannerSkipScanTest, SkipScanOnNonLeadingField) {
+    addIndex(BSON("a" << 1 << "b" << 1 << "c" << 1));
+    runQuery(fromjson("{b: 5, c: {$gt: 3}}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5, c: {$gt: 3}}}}");
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {pattern: {a: 1, b: 1, c: 1}, bounds: "
+        "{a: [['MinKey', 'MaxKey', true, true]], b: [[5, 5, true, true]], "
+        "c: [[3, Infinity, false, true]]}}}}}");
+}
+
+TEST_F(QueryPlannerSkipScanTest, SkipScanCompetesWithCollscanWhenNotRequested) {
+    params.options = QueryPlannerParams::DEFAULT;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5}}}");
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {pattern: {a: 1, b: 1}, bounds: "
+        "{a: [['MinKey', 'MaxKey', true, true]], b: [[5, 5, true, true]]}}}}}");
+}
+
+TEST_F(QueryPlannerSkipScanTest, NoSkipScanWhenLeadingFieldHasPredicate) {
+    params.options = QueryPlannerParams::DEFAULT;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuery(fromjson("{a: 1, b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {pattern: {a: 1, b: 1}, bounds: "
+        "{a: [[1, 1, true, true]], b: [[5, 5, true, true]]}}}}}");
+}
+
+TEST_F(QueryPlannerSkipScanTest, NoSkipScanOnMultikeyOrSparseIndex) {
+    addIndex(BSON("a" << 1 << "b" << 1), true /* multikey */);
+    addIndex(BSON("c" << 1 << "b" << 1), false /* multikey */, true /* sparse */);
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5}}}");
+}
+
 }  // namespace
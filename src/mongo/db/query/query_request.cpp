@@ -102,6 +102,7 @@ const char kTermField[] = "term";
 const char kOptionsField[] = "options";
 const char kReadOnceField[] = "readOnce";
 const char kAllowSpeculativeMajorityReadField[] = "allowSpeculativeMajorityRead";
+const char kAllowDiskUseField[] = "allowDiskUse";
 const char kInternalReadAtClusterTimeField[] = "$_internalReadAtClusterTime";
 
 // Field names for sorting options.
@@ -323,6 +324,13 @@ StatusWith<unique_ptr<QueryRequest>> QueryRequest::parseFromFindCommand(unique_p
             }
 
             qr->_noCursorTimeout = el.boolean();
+        } else if (fieldName == kAllowDiskUseField) {
+            Status status = checkFieldType(el, Bool);
+            if (!status.isOK()) {
+                return status;
+            }
+
+            qr->_allowDiskUse = el.boolean();
         } else if (fieldName == kAwaitDataField) {
             Status status = checkFieldType(el, Bool);
             if (!status.isOK()) {
@@ -540,6 +548,10 @@ void QueryRequest::asFindCommandInternal(BSONObjBuilder* cmdBuilder) const {
         cmdBuilder->append(kNoCursorTimeoutField, true);
     }
 
+    if (_allowDiskUse) {
+        cmdBuilder->append(kAllowDiskUseField, true);
+    }
+
     if (_allowPartialResults) {
         cmdBuilder->append(kPartialResultsField, true);
     }
@@ -1107,6 +1119,9 @@ StatusWith<BSONObj> QueryRequest::asAggregationCommand() const {
     if (!_hint.isEmpty()) {
         aggregationBuilder.append("hint", _hint);
     }
+    if (_allowDiskUse) {
+        aggregationBuilder.append(kAllowDiskUseField, true);
+    }
     if (!_comment.empty()) {
         aggregationBuilder.append("comment", _comment);
     }
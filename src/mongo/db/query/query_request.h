@@ -353,6 +353,14 @@ public:
         _noCursorTimeout = noCursorTimeout;
     }
 
+    bool allowDiskUse() const {
+        return _allowDiskUse;
+    }
+
+    void setAllowDiskUse(bool allowDiskUse) {
+        _allowDiskUse = allowDiskUse;
+    }
+
     bool isExhaust() const {
         return _exhaust;
     }
@@ -524,6 +532,9 @@ private:
     bool _readOnce = false;
     bool _allowSpeculativeMajorityRead = false;
 
+    // Whether a blocking sort may spill to disk rather than fail when over its memory limit.
+    bool _allowDiskUse = false;
+
     boost::optional<long long> _replicationTerm;
 
     // The Timestamp that RecoveryUnit::setTimestampReadSource() should be called with. The optional
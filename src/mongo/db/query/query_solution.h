@@ -287,6 +287,11 @@ struct TextNode : public QuerySolutionNode {
     // text node while creating the text leaf node and convert them into a BSONObj index prefix
     // when we finish the text leaf node.
     BSONObj indexPrefix;
+
+    // If non-zero, the results of this node are sorted by text score and only the best 'topK' of
+    // them are consumed, so the TEXT_OR stage may stop reading the index once no other document
+    // can score higher.
+    size_t topK = 0u;
 };
 
 struct CollectionScanNode : public QuerySolutionNode {
@@ -310,6 +310,17 @@ MONGO_REGISTER_SHIM(waitForReadConcern)
             return {ErrorCodes::NotAReplicaSet,
                     "node needs to be a replica set member to use readConcern: snapshot"};
         }
+
+        // A snapshot read outside of a transaction has no commit at which to wait for what it read
+        // to become majority committed, so wait for the majority snapshot to reach atClusterTime.
+        if (atClusterTime && !opCtx->getTxnNumber()) {
+            auto status = replCoord->waitUntilOpTimeForRead(
+                opCtx,
+                repl::ReadConcernArgs(atClusterTime, repl::ReadConcernLevel::kMajorityReadConcern));
+            if (!status.isOK()) {
+                return status;
+            }
+        }
     }
 
     if (atClusterTime) {
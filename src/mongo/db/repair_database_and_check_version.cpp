@@ -57,6 +57,7 @@
 #include "mongo/util/fail_point.h"
 #include "mongo/util/log.h"
 #include "mongo/util/quick_exit.h"
+#include "mongo/util/timer.h"
 
 #if !defined(_WIN32)
 #include <sys/file.h>
@@ -256,8 +257,11 @@ void checkForCappedOplog(OperationContext* opCtx, Database* db) {
 }
 
 void rebuildIndexes(OperationContext* opCtx, StorageEngine* storageEngine) {
+    Timer timer;
     std::vector<StorageEngine::CollectionIndexNamePair> indexesToRebuild =
         fassert(40593, storageEngine->reconcileCatalogAndIdents(opCtx));
+    log() << "Reconciled the catalog with the storage engine's idents in " << timer.millis()
+          << "ms";
 
     // Determine which indexes need to be rebuilt. rebuildIndexesOnCollection() requires that all
     // indexes on that collection are done at once, so we use a map to group them together.
@@ -466,6 +470,7 @@ bool repairDatabasesAndCheckVersion(OperationContext* opCtx) {
 
     // Refresh list of database names to include newly-created admin, if it exists.
     dbNames = storageEngine->listDatabases();
+    Timer openDatabasesTimer;
     for (const auto& dbName : dbNames) {
         if (dbName != "local") {
             nonLocalDatabases = true;
@@ -569,6 +574,8 @@ bool repairDatabasesAndCheckVersion(OperationContext* opCtx) {
             db->clearTmpCollections(opCtx);
         }
     }
+    log() << "Opened " << dbNames.size() << " databases in " << openDatabasesTimer.millis()
+          << "ms";
 
     // Fail to start up if there is no featureCompatibilityVersion document and there are non-local
     // databases present.
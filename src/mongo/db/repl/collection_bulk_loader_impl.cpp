@@ -44,6 +44,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/collection_bulk_loader_impl.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/util/destructor_guard.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
@@ -109,6 +110,14 @@ Status CollectionBulkLoaderImpl::init(const std::vector<BSONObj>& secondaryIndex
                 _idIndexBlock.reset();
             }
 
+            // Capped collections and collections with validators go through the regular insert
+            // path, which enforces capping and document validation.
+            const bool hasIndexBlocks = _idIndexBlock || _secondaryIndexesBlock;
+            if (initialSyncBulkLoadRecordStore.load() && hasIndexBlocks && !coll->isCapped() &&
+                coll->getCatalogEntry()->getCollectionOptions(_opCtx.get()).validator.isEmpty()) {
+                _recordLoader = coll->getRecordStore()->makeBulkLoader(_opCtx.get());
+            }
+
             return Status::OK();
         });
 }
@@ -119,7 +128,23 @@ Status CollectionBulkLoaderImpl::insertDocuments(const std::vector<BSONObj>::con
     return _runTaskReleaseResourcesOnFailure([&] {
         UnreplicatedWritesBlock uwb(_opCtx.get());
 
+        // Index keys are generated for the whole batch once its documents are inserted, so that
+        // the indexes can be filled concurrently.
+        std::vector<BsonRecord> insertedRecords;
         for (auto iter = begin; iter != end; ++iter) {
+            if (_recordLoader) {
+                // Bulk-loaded records are not part of any unit of work, so there is nothing to
+                // retry and no op observer to notify for these unreplicated writes.
+                auto loc = _recordLoader->insertRecord(iter->objdata(), iter->objsize());
+                if (!loc.isOK()) {
+                    return loc.getStatus();
+                }
+                insertedRecords.push_back(BsonRecord{loc.getValue(), Timestamp(), &*iter});
+                ++count;
+                continue;
+            }
+
+            RecordId insertedLoc;
             Status status = writeConflictRetry(
                 _opCtx.get(), "CollectionBulkLoaderImpl::insertDocuments", _nss.ns(), [&] {
                     WriteUnitOfWork wunit(_opCtx.get());
@@ -128,7 +153,8 @@ Status CollectionBulkLoaderImpl::insertDocuments(const std::vector<BSONObj>::con
                         // This flavor of insertDocument will not update any pre-existing indexes,
                         // only the indexers passed in.
                         auto onRecordInserted = [&](const RecordId& loc) {
-                            return _addDocumentToIndexBlocks(doc, loc);
+                            insertedLoc = loc;
+                            return Status::OK();
                         };
                         const auto status = _autoColl->getCollection()->insertDocumentForBulkLoader(
                             _opCtx.get(), doc, onRecordInserted);
@@ -154,9 +180,21 @@ Status CollectionBulkLoaderImpl::insertDocuments(const std::vector<BSONObj>::con
                 return status;
             }
 
+            if (!insertedLoc.isNull()) {
+                insertedRecords.push_back(BsonRecord{insertedLoc, Timestamp(), &*iter});
+            }
             ++count;
         }
-        return Status::OK();
+        return writeConflictRetry(
+            _opCtx.get(), "CollectionBulkLoaderImpl::insertDocuments", _nss.ns(), [&] {
+                WriteUnitOfWork wunit(_opCtx.get());
+                const auto status = _addDocumentsToIndexBlocks(insertedRecords);
+                if (!status.isOK()) {
+                    return status;
+                }
+                wunit.commit();
+                return Status::OK();
+            });
     });
 }
 
@@ -166,6 +204,9 @@ Status CollectionBulkLoaderImpl::commit() {
         LOG(2) << "Creating indexes for ns: " << _nss.ns();
         UnreplicatedWritesBlock uwb(_opCtx.get());
 
+        // Close the bulk cursor so that the collection can be read and written normally.
+        _recordLoader.reset();
+
         // Commit before deleting dups, so the dups will be removed from secondary indexes when
         // deleted.
         if (_secondaryIndexesBlock) {
@@ -261,6 +302,8 @@ Status CollectionBulkLoaderImpl::commit() {
 
 void CollectionBulkLoaderImpl::_releaseResources() {
     invariant(&cc() == _opCtx->getClient());
+    _recordLoader.reset();
+
     if (_secondaryIndexesBlock) {
         _secondaryIndexesBlock->cleanUpAfterBuild(_opCtx.get(), _collection);
         _secondaryIndexesBlock.reset();
@@ -290,17 +333,17 @@ Status CollectionBulkLoaderImpl::_runTaskReleaseResourcesOnFailure(const F& task
     }
 }
 
-Status CollectionBulkLoaderImpl::_addDocumentToIndexBlocks(const BSONObj& doc,
-                                                           const RecordId& loc) {
+Status CollectionBulkLoaderImpl::_addDocumentsToIndexBlocks(
+    const std::vector<BsonRecord>& records) {
     if (_idIndexBlock) {
-        auto status = _idIndexBlock->insert(_opCtx.get(), doc, loc);
+        auto status = _idIndexBlock->insertBatch(_opCtx.get(), records);
         if (!status.isOK()) {
             return status.withContext("failed to add document to _id index");
         }
     }
 
     if (_secondaryIndexesBlock) {
-        auto status = _secondaryIndexesBlock->insert(_opCtx.get(), doc, loc);
+        auto status = _secondaryIndexesBlock->insertBatch(_opCtx.get(), records);
         if (!status.isOK()) {
             return status.withContext("failed to add document to secondary indexes");
         }
@@ -38,6 +38,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/repl/collection_bulk_loader.h"
 #include "mongo/db/repl/storage_interface.h"
+#include "mongo/db/storage/record_store.h"
 
 namespace mongo {
 namespace repl {
@@ -84,9 +85,9 @@ private:
     Status _runTaskReleaseResourcesOnFailure(const F& task) noexcept;
 
     /**
-     * Adds document and associated RecordId to index blocks after inserting into RecordStore.
+     * Adds documents and associated RecordIds to index blocks after inserting into RecordStore.
      */
-    Status _addDocumentToIndexBlocks(const BSONObj& doc, const RecordId& loc);
+    Status _addDocumentsToIndexBlocks(const std::vector<BsonRecord>& records);
 
     ServiceContext::UniqueClient _client;
     ServiceContext::UniqueOperationContext _opCtx;
@@ -95,6 +96,9 @@ private:
     NamespaceString _nss;
     std::unique_ptr<MultiIndexBlock> _idIndexBlock;
     std::unique_ptr<MultiIndexBlock> _secondaryIndexesBlock;
+    // Set while the collection's documents can be appended through the storage engine's bulk
+    // load path. Released before the collection is read or committed.
+    std::unique_ptr<RecordStore::BulkLoader> _recordLoader;
     BSONObj _idIndexSpec;
     Stats _stats;
 };
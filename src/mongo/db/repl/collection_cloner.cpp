@@ -33,9 +33,11 @@
 
 #include "mongo/db/repl/collection_cloner.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "mongo/base/string_data.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/client/dbclient_connection.h"
 #include "mongo/client/remote_command_retry_scheduler.h"
@@ -47,6 +49,7 @@
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/destructor_guard.h"
 #include "mongo/util/fail_point_service.h"
@@ -66,6 +69,13 @@ constexpr auto kCountResponseDocumentCountFieldName = "n"_sd;
 const int kProgressMeterSecondsBetween = 60;
 const int kProgressMeterCheckInterval = 128;
 
+// Collections are only split into ranges of at least this many documents, since smaller ranges are
+// not worth the extra connections.
+const size_t kMinDocumentsPerRange = 10 * 1000;
+
+// The number of _id values sampled per range when choosing range boundaries.
+const int kSamplesPerRange = 10;
+
 }  // namespace
 
 // Failpoint which causes initial sync to hang before establishing its cursor to clone the
@@ -258,6 +268,9 @@ void CollectionCloner::_cancelRemainingWork_inlock() {
     if (_queryState == QueryState::kRunning) {
         _queryState = QueryState::kCanceling;
         _clientConnection->shutdownAndDisallowReconnect();
+        for (auto&& connection : _rangeConnections) {
+            connection->shutdownAndDisallowReconnect();
+        }
     } else {
         _queryState = QueryState::kFinished;
     }
@@ -486,6 +499,7 @@ void CollectionCloner::_beginCollectionCallback(const executor::TaskExecutor::Ca
                     stdx::lock_guard<stdx::mutex> lock(_mutex);
                     _queryState = QueryState::kFinished;
                     _clientConnection.reset();
+                    _rangeConnections.clear();
                 }
                 _condition.notify_all();
                 _finishCallback(status);
@@ -552,13 +566,117 @@ void CollectionCloner::_runQuery(const executor::TaskExecutor::CallbackArgs& cal
     // The admin database is always cloned first, so all user data should use readOnce.
     const bool readOnceAvailable = serverGlobalParams.featureCompatibility.getVersionUnsafe() ==
         ServerGlobalParams::FeatureCompatibility::Version::kFullyUpgradedTo42;
+
+    const auto boundaries = _getRangeBoundaries();
+    auto makeRangeQuery = [&](size_t range) {
+        if (boundaries.empty()) {
+            return readOnceAvailable ? QUERY("query" << BSONObj() << "$readOnce" << true) : Query();
+        }
+        BSONObjBuilder queryBob;
+        queryBob.append("query", BSONObj());
+        if (readOnceAvailable) {
+            queryBob.append("$readOnce", true);
+        }
+        // Unlike a predicate on _id, index bounds are not limited to the boundary's BSON type, so
+        // the ranges cover documents of every _id type between them.
+        if (range > 0) {
+            queryBob.append("$min", boundaries[range - 1]);
+        }
+        if (range < boundaries.size()) {
+            queryBob.append("$max", boundaries[range]);
+        }
+        queryBob.append("$hint", BSON("_id" << 1));
+        return Query(queryBob.obj());
+    };
+
+    // The first range is copied on this thread over '_clientConnection', the others on threads
+    // of their own.
+    std::vector<char> rangeFinished(boundaries.size() + 1, false);
+    std::vector<stdx::thread> rangeThreads;
+    for (size_t range = 1; range <= boundaries.size(); ++range) {
+        rangeThreads.emplace_back(
+            [this, range, &makeRangeQuery, &rangeFinished, onCompletionGuard] {
+                rangeFinished[range] =
+                    _runRangeQueryOnNewConnection(makeRangeQuery(range), onCompletionGuard);
+            });
+    }
+    rangeFinished[0] =
+        _runRangeQuery(_clientConnection.get(), makeRangeQuery(0), onCompletionGuard);
+    for (auto&& thread : rangeThreads) {
+        thread.join();
+    }
+    if (std::find(rangeFinished.begin(), rangeFinished.end(), false) != rangeFinished.end()) {
+        return;
+    }
+
+    waitForDbWorker();
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    onCompletionGuard->setResultAndCancelRemainingWork_inlock(lock, Status::OK());
+}
+
+std::vector<BSONObj> CollectionCloner::_getRangeBoundaries() {
+    size_t documentsToCopy;
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        documentsToCopy = _stats.documentToCopy;
+    }
+    // Range bounds are _id index keys, which only compare like the sampled values under the simple
+    // collation.
+    const size_t numRanges = std::min(static_cast<size_t>(collectionClonerParallelRanges),
+                                      documentsToCopy / kMinDocumentsPerRange);
+    if (numRanges < 2 || _idIndexSpec.isEmpty() || !_options.collation.isEmpty()) {
+        return {};
+    }
+
+    const int numSamples = numRanges * kSamplesPerRange;
+    BSONObj sampleCmd = BSON("aggregate" << _sourceNss.coll() << "pipeline"
+                                         << BSON_ARRAY(BSON("$sample" << BSON("size" << numSamples))
+                                                       << BSON("$project" << BSON("_id" << 1)))
+                                         << "cursor"
+                                         << BSON("batchSize" << numSamples));
+    std::vector<BSONObj> samples;
     try {
-        _clientConnection->query(
+        BSONObj result;
+        _clientConnection->runCommand(
+            _sourceNss.db().toString(), sampleCmd, result, QueryOption_SlaveOk);
+        auto response = uassertStatusOK(CursorResponse::parseFromBSON(result));
+        for (auto&& doc : response.getBatch()) {
+            auto id = doc["_id"];
+            if (!id.eoo()) {
+                samples.push_back(id.wrap());
+            }
+        }
+    } catch (const DBException& e) {
+        log() << "CollectionCloner ns:" << _destNss
+              << " could not sample _id values, copying it with a single query: " << redact(e);
+        return {};
+    }
+
+    std::sort(samples.begin(), samples.end(), SimpleBSONObjComparator::kInstance.makeLessThan());
+    std::vector<BSONObj> boundaries;
+    for (size_t range = 1; range < numRanges && !samples.empty(); ++range) {
+        const auto& boundary = samples[range * samples.size() / numRanges];
+        if (boundaries.empty() || SimpleBSONObjComparator::kInstance.evaluate(boundaries.back() <
+                                                                              boundary)) {
+            boundaries.push_back(boundary);
+        }
+    }
+
+    log() << "CollectionCloner ns:" << _destNss << " copying " << boundaries.size() + 1
+          << " _id ranges in parallel";
+    return boundaries;
+}
+
+bool CollectionCloner::_runRangeQuery(DBClientConnection* connection,
+                                      const Query& query,
+                                      std::shared_ptr<OnCompletionGuard> onCompletionGuard) {
+    try {
+        connection->query(
             [this, onCompletionGuard](DBClientCursorBatchIterator& iter) {
                 _handleNextBatch(onCompletionGuard, iter);
             },
             NamespaceStringOrUUID(_sourceNss.db().toString(), *_options.uuid),
-            readOnceAvailable ? QUERY("query" << BSONObj() << "$readOnce" << true) : Query(),
+            query,
             nullptr /* fieldsToReturn */,
             QueryOption_NoCursorTimeout | QueryOption_SlaveOk |
                 (collectionClonerUsesExhaust ? QueryOption_Exhaust : 0),
@@ -577,24 +695,48 @@ void CollectionCloner::_runQuery(const executor::TaskExecutor::CallbackArgs& cal
             // A 4.2 node should only ever raise QueryPlanKilled, but an older node could raise
             // OperationFailed or CursorNotFound.
             _verifyCollectionWasDropped(lock, queryStatus, onCompletionGuard);
-            return;
+            return false;
         } else if (queryStatus.code() != ErrorCodes::NamespaceNotFound) {
             // NamespaceNotFound means the collection was dropped before we started cloning, so
             // we're OK to ignore the error.  Any other error we must report.
             onCompletionGuard->setResultAndCancelRemainingWork_inlock(lock, queryStatus);
-            return;
+            return false;
         }
     }
-    waitForDbWorker();
-    stdx::lock_guard<stdx::mutex> lock(_mutex);
-    onCompletionGuard->setResultAndCancelRemainingWork_inlock(lock, Status::OK());
+    return true;
+}
+
+bool CollectionCloner::_runRangeQueryOnNewConnection(
+    const Query& query, std::shared_ptr<OnCompletionGuard> onCompletionGuard) {
+    DBClientConnection* connection;
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        // Cancellation has already reported a result and shut down the connections it knew of.
+        if (_queryState != QueryState::kRunning) {
+            return false;
+        }
+        _rangeConnections.push_back(_createClientFn());
+        connection = _rangeConnections.back().get();
+    }
+
+    Status connectStatus = connection->connect(_source, StringData());
+    if (connectStatus.isOK() && !replAuthenticate(connection)) {
+        connectStatus = {ErrorCodes::AuthenticationFailed,
+                         str::stream() << "Failed to authenticate to " << _source};
+    }
+    if (!connectStatus.isOK()) {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        onCompletionGuard->setResultAndCancelRemainingWork_inlock(lock, connectStatus);
+        return false;
+    }
+    return _runRangeQuery(connection, query, onCompletionGuard);
 }
 
 void CollectionCloner::_handleNextBatch(std::shared_ptr<OnCompletionGuard> onCompletionGuard,
                                         DBClientCursorBatchIterator& iter) {
-    _stats.receivedBatches++;
     {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _stats.receivedBatches++;
         uassert(ErrorCodes::CallbackCanceled,
                 "Collection cloning cancelled.",
                 _queryState != QueryState::kCanceling);
@@ -704,7 +846,8 @@ void CollectionCloner::_insertDocumentsCallback(
     UniqueLock lk(_mutex);
     std::vector<BSONObj> docs;
     if (_documentsToInsert.size() == 0) {
-        warning() << "_insertDocumentsCallback, but no documents to insert for ns:" << _destNss;
+        // With parallel ranges, an earlier callback may already have inserted this batch.
+        LOG(1) << "_insertDocumentsCallback, but no documents to insert for ns:" << _destNss;
         return;
     }
     _documentsToInsert.swap(docs);
@@ -219,6 +219,30 @@ private:
     void _runQuery(const executor::TaskExecutor::CallbackArgs& callbackData,
                    std::shared_ptr<OnCompletionGuard> onCompletionGuard);
 
+    /**
+     * Samples _id values from the source collection and returns the sorted, distinct _id keys
+     * (as {_id: <value>} documents) at which to split it into ranges that are copied in parallel.
+     * Returns no boundaries if the collection should be copied with a single query, including when
+     * sampling fails.
+     */
+    std::vector<BSONObj> _getRangeBoundaries();
+
+    /**
+     * Copies the documents returned by 'query' over 'connection'. Returns true if the query ran to
+     * completion or the collection no longer exists. Otherwise the error has been reported through
+     * 'onCompletionGuard' and false is returned.
+     */
+    bool _runRangeQuery(DBClientConnection* connection,
+                        const Query& query,
+                        std::shared_ptr<OnCompletionGuard> onCompletionGuard);
+
+    /**
+     * Opens and authenticates an additional connection to the sync source, then runs
+     * _runRangeQuery() on it.
+     */
+    bool _runRangeQueryOnNewConnection(const Query& query,
+                                       std::shared_ptr<OnCompletionGuard> onCompletionGuard);
+
     /**
      * Put all results from a query batch into a buffer to be inserted, and schedule
      * it to be inserted.
@@ -302,6 +326,10 @@ private:
     // allow cancellation, and those other threads may access it only when holding '_mutex'.
     std::unique_ptr<DBClientConnection> _clientConnection;
 
+    // (M) Additional connections used to copy _id ranges of the collection in parallel. They are
+    // added only while the query is kRunning and released along with '_clientConnection'.
+    std::vector<std::unique_ptr<DBClientConnection>> _rangeConnections;
+
     // State transitions:
     // PreStart --> Running --> ShuttingDown --> Complete
     // It is possible to skip intermediate states. For example,
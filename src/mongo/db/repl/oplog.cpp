@@ -33,6 +33,7 @@
 
 #include "mongo/db/repl/oplog.h"
 
+#include <algorithm>
 #include <deque>
 #include <set>
 #include <vector>
@@ -365,11 +366,14 @@ void appendSessionInfo(OperationContext* opCtx,
     }
 }
 
-OplogDocWriter _logOpWriter(OperationContext* opCtx,
+/**
+ * Appends every field of an oplog entry except 'o' to 'b'.
+ */
+void _appendOplogEntryFrame(BSONObjBuilder* b,
+                            OperationContext* opCtx,
                             const char* opstr,
                             const NamespaceString& nss,
                             OptionalCollectionUUID uuid,
-                            const BSONObj& obj,
                             const BSONObj* o2,
                             bool fromMigrate,
                             OpTime optime,
@@ -379,40 +383,68 @@ OplogDocWriter _logOpWriter(OperationContext* opCtx,
                             const OplogLink& oplogLink,
                             bool prepare,
                             bool inTxn) {
-    BSONObjBuilder b(256);
-
-    b.append("ts", optime.getTimestamp());
+    b->append("ts", optime.getTimestamp());
     if (optime.getTerm() != -1)
-        b.append("t", optime.getTerm());
+        b->append("t", optime.getTerm());
 
     // Always write zero hash instead of using FCV to gate this for retryable writes
     // and change stream, who expect to be able to read oplog across FCV's.
-    b.append("h", 0LL);
-    b.append("v", OplogEntry::kOplogVersion);
-    b.append("op", opstr);
-    b.append("ns", nss.ns());
+    b->append("h", 0LL);
+    b->append("v", OplogEntry::kOplogVersion);
+    b->append("op", opstr);
+    b->append("ns", nss.ns());
     if (uuid)
-        uuid->appendToBuilder(&b, "ui");
+        uuid->appendToBuilder(b, "ui");
 
     if (fromMigrate)
-        b.appendBool("fromMigrate", true);
+        b->appendBool("fromMigrate", true);
 
     if (o2)
-        b.append("o2", *o2);
+        b->append("o2", *o2);
 
     invariant(wallTime != Date_t{});
-    b.appendDate(OplogEntryBase::kWallClockTimeFieldName, wallTime);
+    b->appendDate(OplogEntryBase::kWallClockTimeFieldName, wallTime);
 
-    appendSessionInfo(opCtx, &b, statementId, sessionInfo, oplogLink);
+    appendSessionInfo(opCtx, b, statementId, sessionInfo, oplogLink);
 
     if (prepare) {
-        b.appendBool(OplogEntryBase::kPrepareFieldName, true);
+        b->appendBool(OplogEntryBase::kPrepareFieldName, true);
     }
 
     if (inTxn) {
-        b.appendBool(OplogEntryBase::kInTxnFieldName, true);
+        b->appendBool(OplogEntryBase::kInTxnFieldName, true);
     }
+}
 
+OplogDocWriter _logOpWriter(OperationContext* opCtx,
+                            const char* opstr,
+                            const NamespaceString& nss,
+                            OptionalCollectionUUID uuid,
+                            const BSONObj& obj,
+                            const BSONObj* o2,
+                            bool fromMigrate,
+                            OpTime optime,
+                            Date_t wallTime,
+                            const OperationSessionInfo& sessionInfo,
+                            StmtId statementId,
+                            const OplogLink& oplogLink,
+                            bool prepare,
+                            bool inTxn) {
+    BSONObjBuilder b(256);
+    _appendOplogEntryFrame(&b,
+                           opCtx,
+                           opstr,
+                           nss,
+                           uuid,
+                           o2,
+                           fromMigrate,
+                           optime,
+                           wallTime,
+                           sessionInfo,
+                           statementId,
+                           oplogLink,
+                           prepare,
+                           inTxn);
     return OplogDocWriter(OplogDocWriter(b.obj(), obj));
 }
 }  // end anon namespace
@@ -604,36 +636,60 @@ std::vector<OpTime> logInsertOps(OperationContext* opCtx,
         oplogLink.prevOpTime = txnParticipant.getLastWriteOpTime();
     }
 
+    // Reserve the optimes which were not reserved by the caller with a single call, so that they
+    // are contiguous and the reservation's mutex is only taken once.
+    const size_t numUnreserved = std::count_if(
+        begin, end, [](const InsertStatement& stmt) { return stmt.oplogSlot.isNull(); });
+    std::vector<OplogSlot> reservedSlots;
+    if (numUnreserved > 0) {
+        reservedSlots = oplogInfo->getNextOpTimes(opCtx, numUnreserved);
+    }
+    auto nextReservedSlot = reservedSlots.begin();
+
+    // Build the frames of all the entries into one buffer. Their BSONObjs are only created once
+    // the buffer has stopped growing.
+    BufBuilder frames(count * 256);
+    std::vector<int> frameOffsets;
+    frameOffsets.reserve(count);
+
     auto timestamps = stdx::make_unique<Timestamp[]>(count);
     std::vector<OpTime> opTimes;
+    opTimes.reserve(count);
     for (size_t i = 0; i < count; i++) {
         // Make a mutable copy.
         auto insertStatementOplogSlot = begin[i].oplogSlot;
-        // Fetch optime now, if not already fetched.
         if (insertStatementOplogSlot.isNull()) {
-            insertStatementOplogSlot = oplogInfo->getNextOpTimes(opCtx, 1U)[0];
+            insertStatementOplogSlot = *nextReservedSlot++;
         }
         // Only 'applyOps' oplog entries can be prepared.
         constexpr bool prepare = false;
-        writers.emplace_back(_logOpWriter(opCtx,
-                                          "i",
-                                          nss,
-                                          uuid,
-                                          begin[i].doc,
-                                          NULL,
-                                          fromMigrate,
-                                          insertStatementOplogSlot,
-                                          wallClockTime,
-                                          sessionInfo,
-                                          begin[i].stmtId,
-                                          oplogLink,
-                                          prepare,
-                                          false /* inTxn */));
+        frameOffsets.push_back(frames.len());
+        {
+            BSONObjBuilder frameBuilder(frames);
+            _appendOplogEntryFrame(&frameBuilder,
+                                   opCtx,
+                                   "i",
+                                   nss,
+                                   uuid,
+                                   NULL,
+                                   fromMigrate,
+                                   insertStatementOplogSlot,
+                                   wallClockTime,
+                                   sessionInfo,
+                                   begin[i].stmtId,
+                                   oplogLink,
+                                   prepare,
+                                   false /* inTxn */);
+        }
         oplogLink.prevOpTime = insertStatementOplogSlot;
         timestamps[i] = oplogLink.prevOpTime.getTimestamp();
         opTimes.push_back(insertStatementOplogSlot);
     }
 
+    for (size_t i = 0; i < count; i++) {
+        writers.emplace_back(BSONObj(frames.buf() + frameOffsets[i]), begin[i].doc);
+    }
+
     MONGO_FAIL_POINT_BLOCK(sleepBetweenInsertOpTimeGenerationAndLogOp, customWait) {
         const BSONObj& data = customWait.getData();
         auto numMillis = data["waitForMillis"].numberInt();
@@ -0,0 +1,465 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kReplication
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/oplog_buffer_ring_file.h"
+
+#include <boost/filesystem.hpp>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+#include "mongo/base/data_view.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/str.h"
+#include "mongo/util/text.h"
+
+namespace mongo {
+namespace repl {
+
+namespace {
+
+// Every entry starts with its size, which is never zero. A zero size where the next entry would
+// start means that the writer skipped the rest of the file and wrapped around to its start. When
+// fewer than this many bytes were skipped, there is no room for a zero size, and the reader wraps
+// around because no entry can fit there.
+constexpr std::size_t kSizeFieldBytes = sizeof(int32_t);
+
+std::size_t getDocumentSize(const BSONObj& o) {
+    return static_cast<std::size_t>(o.objsize());
+}
+
+}  // namespace
+
+/**
+ * A temporary file of a fixed size mapped into memory for reading and writing. The file is removed
+ * by the time the mapping is destroyed.
+ */
+class OplogBufferRingFile::MappedFile {
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+public:
+    MappedFile(const std::string& path, std::size_t size);
+    ~MappedFile();
+
+    char* data() const {
+        return _data;
+    }
+
+private:
+    const std::size_t _size;
+    char* _data = nullptr;
+#ifdef _WIN32
+    HANDLE _fileHandle = INVALID_HANDLE_VALUE;
+    HANDLE _mappingHandle = nullptr;
+#endif
+};
+
+#ifdef _WIN32
+
+OplogBufferRingFile::MappedFile::MappedFile(const std::string& path, std::size_t size)
+    : _size(size) {
+    _fileHandle = CreateFileW(toWideString(path.c_str()).c_str(),
+                              GENERIC_READ | GENERIC_WRITE,
+                              0,
+                              nullptr,
+                              CREATE_ALWAYS,
+                              FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE,
+                              nullptr);
+    if (_fileHandle == INVALID_HANDLE_VALUE) {
+        auto ec = GetLastError();
+        uasserted(ErrorCodes::FileOpenFailed,
+                  str::stream() << "Failed to create oplog buffer file " << path << ": "
+                                << errnoWithDescription(ec));
+    }
+
+    const auto size64 = static_cast<unsigned long long>(size);
+    _mappingHandle = CreateFileMappingW(_fileHandle,
+                                        nullptr,
+                                        PAGE_READWRITE,
+                                        static_cast<DWORD>(size64 >> 32),
+                                        static_cast<DWORD>(size64 & 0xffffffff),
+                                        nullptr);
+    if (!_mappingHandle) {
+        auto ec = GetLastError();
+        CloseHandle(_fileHandle);
+        uasserted(ErrorCodes::FileOpenFailed,
+                  str::stream() << "Failed to map oplog buffer file " << path << ": "
+                                << errnoWithDescription(ec));
+    }
+
+    _data = static_cast<char*>(MapViewOfFile(_mappingHandle, FILE_MAP_ALL_ACCESS, 0, 0, size));
+    if (!_data) {
+        auto ec = GetLastError();
+        CloseHandle(_mappingHandle);
+        CloseHandle(_fileHandle);
+        uasserted(ErrorCodes::FileOpenFailed,
+                  str::stream() << "Failed to map oplog buffer file " << path << ": "
+                                << errnoWithDescription(ec));
+    }
+}
+
+OplogBufferRingFile::MappedFile::~MappedFile() {
+    UnmapViewOfFile(_data);
+    CloseHandle(_mappingHandle);
+    CloseHandle(_fileHandle);
+}
+
+#else
+
+OplogBufferRingFile::MappedFile::MappedFile(const std::string& path, std::size_t size)
+    : _size(size) {
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        auto ec = errno;
+        uasserted(ErrorCodes::FileOpenFailed,
+                  str::stream() << "Failed to create oplog buffer file " << path << ": "
+                                << errnoWithDescription(ec));
+    }
+    ON_BLOCK_EXIT([&] { ::close(fd); });
+
+    // Nothing needs the file once it is mapped, so remove it now to avoid leaving it behind if the
+    // process exits uncleanly.
+    ::unlink(path.c_str());
+
+    // Allocate the file's blocks up front where possible. Writing to a page of a sparse file when
+    // the disk is full would otherwise raise SIGBUS rather than return an error.
+#if defined(__linux__)
+    int sizeError = ::posix_fallocate(fd, 0, size);
+#else
+    int sizeError = ::ftruncate(fd, size) == 0 ? 0 : errno;
+#endif
+    if (sizeError != 0) {
+        uasserted(ErrorCodes::FileOpenFailed,
+                  str::stream() << "Failed to size oplog buffer file " << path << " to " << size
+                                << " bytes: "
+                                << errnoWithDescription(sizeError));
+    }
+
+    void* addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        auto ec = errno;
+        uasserted(ErrorCodes::FileOpenFailed,
+                  str::stream() << "Failed to map oplog buffer file " << path << ": "
+                                << errnoWithDescription(ec));
+    }
+    _data = static_cast<char*>(addr);
+}
+
+OplogBufferRingFile::MappedFile::~MappedFile() {
+    if (::munmap(_data, _size) != 0) {
+        auto ec = errno;
+        warning() << "Failed to unmap oplog buffer file: " << errnoWithDescription(ec);
+    }
+}
+
+#endif
+
+OplogBufferRingFile::OplogBufferRingFile(Options options, Counters* counters)
+    : _options(std::move(options)), _counters(counters) {
+    invariant(!_options.filePath.empty());
+    invariant(_options.capacityBytes > 0);
+}
+
+OplogBufferRingFile::~OplogBufferRingFile() = default;
+
+void OplogBufferRingFile::startup(OperationContext*) {
+    invariant(!_file);
+
+    const auto dir = boost::filesystem::path(_options.filePath).parent_path();
+    boost::system::error_code ec;
+    if (!dir.empty()) {
+        boost::filesystem::create_directories(dir, ec);
+    }
+    uassert(ErrorCodes::FileOpenFailed,
+            str::stream() << "Failed to create directory " << dir.string()
+                          << " for oplog buffer file: "
+                          << ec.message(),
+            !ec);
+
+    _file = std::make_unique<MappedFile>(_options.filePath, _options.capacityBytes);
+    LOG(1) << "Created oplog buffer file " << _options.filePath << " of "
+           << _options.capacityBytes << " bytes";
+
+    // Update server status metric to reflect the current oplog buffer's max size.
+    if (_counters) {
+        _counters->setMaxSize(getMaxSize());
+    }
+}
+
+void OplogBufferRingFile::shutdown(OperationContext* opCtx) {
+    // The mapping is kept until destruction so that an entry returned by peek() stays readable by a
+    // consumer that races with shutdown.
+    clear(opCtx);
+}
+
+void OplogBufferRingFile::pushEvenIfFull(OperationContext*, const Value& value) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _pushNonBlocking_inlock(value);
+    _notEmptyCv.notify_one();
+}
+
+void OplogBufferRingFile::push(OperationContext*, const Value& value) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+
+    // Wait for the consumer to free space. If the ring is empty, no pop may ever come to free more
+    // space, so hold the entry in memory instead.
+    const auto size = getDocumentSize(value);
+    std::size_t offset;
+    std::size_t padding;
+    _notFullCv.wait(lk, [&] {
+        return _ringCount == 0 ||
+            (_overflow.empty() && _findSpace_inlock(size, &offset, &padding));
+    });
+    _pushNonBlocking_inlock(value);
+    _notEmptyCv.notify_one();
+}
+
+void OplogBufferRingFile::pushAllNonBlocking(OperationContext*,
+                                             Batch::const_iterator begin,
+                                             Batch::const_iterator end) {
+    if (begin == end) {
+        return;
+    }
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (auto i = begin; i != end; ++i) {
+        _pushNonBlocking_inlock(*i);
+    }
+    _notEmptyCv.notify_one();
+}
+
+void OplogBufferRingFile::waitForSpace(OperationContext*, std::size_t size) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _notFullCv.wait(lk, [&] {
+        return _ringCount == 0 ||
+            (_overflow.empty() && _usedBytes + size <= _options.capacityBytes);
+    });
+}
+
+bool OplogBufferRingFile::isEmpty() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _ringCount == 0 && _overflow.empty();
+}
+
+std::size_t OplogBufferRingFile::getMaxSize() const {
+    return _options.capacityBytes;
+}
+
+std::size_t OplogBufferRingFile::getSize() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _ringSize + _overflowSize;
+}
+
+std::size_t OplogBufferRingFile::getCount() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _ringCount + _overflow.size();
+}
+
+void OplogBufferRingFile::clear(OperationContext*) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _clear_inlock();
+    _notFullCv.notify_all();
+}
+
+bool OplogBufferRingFile::tryPop(OperationContext*, Value* value) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _releasePopped_inlock();
+
+    if (_ringCount > 0) {
+        const auto offset = _frontOffset_inlock();
+        *value = BSONObj(_file->data() + offset);
+        const auto size = getDocumentSize(*value);
+
+        // Keep the entry, and any padding skipped before it, until the next pop.
+        _poppedBytes = (offset == _head ? 0 : _options.capacityBytes - _head) + size;
+        _head = offset + size;
+        --_ringCount;
+        _ringSize -= size;
+    } else if (!_overflow.empty()) {
+        *value = std::move(_overflow.front());
+        _overflow.pop_front();
+        _overflowSize -= getDocumentSize(*value);
+    } else {
+        return false;
+    }
+
+    if (_counters) {
+        _counters->decrement(*value);
+    }
+    _drainOverflow_inlock();
+    _notFullCv.notify_all();
+    return true;
+}
+
+bool OplogBufferRingFile::waitForData(Seconds waitDuration) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    return _notEmptyCv.wait_for(lk, waitDuration.toSystemDuration(), [&] {
+        return _ringCount > 0 || !_overflow.empty();
+    });
+}
+
+bool OplogBufferRingFile::peek(OperationContext*, Value* value) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_ringCount > 0) {
+        *value = BSONObj(_file->data() + _frontOffset_inlock());
+        return true;
+    }
+    if (!_overflow.empty()) {
+        *value = _overflow.front();
+        return true;
+    }
+    return false;
+}
+
+boost::optional<OplogBuffer::Value> OplogBufferRingFile::lastObjectPushed(
+    OperationContext*) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_overflow.empty()) {
+        return _overflow.back();
+    }
+    if (_ringCount > 0) {
+        return BSONObj(_file->data() + _lastWritten).getOwned();
+    }
+    return boost::none;
+}
+
+std::size_t OplogBufferRingFile::getOverflowCount_forTest() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _overflow.size();
+}
+
+bool OplogBufferRingFile::_findSpace_inlock(std::size_t size,
+                                            std::size_t* offset,
+                                            std::size_t* padding) const {
+    *padding = 0;
+    if (_usedBytes == 0) {
+        // Nothing is in use, so start again at the beginning of the file.
+        *offset = 0;
+        return size <= _options.capacityBytes;
+    }
+    if (_tail <= _begin) {
+        // The ring has wrapped around, so the free space lies between the last entry and the
+        // first one still in use.
+        *offset = _tail;
+        return _begin - _tail >= size;
+    }
+    if (_options.capacityBytes - _tail >= size) {
+        *offset = _tail;
+        return true;
+    }
+    *offset = 0;
+    *padding = _options.capacityBytes - _tail;
+    return _begin >= size;
+}
+
+bool OplogBufferRingFile::_tryAppend_inlock(const Value& value) {
+    invariant(_file);
+    const auto size = getDocumentSize(value);
+    std::size_t offset;
+    std::size_t padding;
+    if (!_findSpace_inlock(size, &offset, &padding)) {
+        return false;
+    }
+
+    if (_usedBytes == 0) {
+        _begin = _head = 0;
+    }
+    if (padding >= kSizeFieldBytes) {
+        DataView(_file->data() + _tail).write<LittleEndian<int32_t>>(0);
+    }
+    std::memcpy(_file->data() + offset, value.objdata(), size);
+
+    _lastWritten = offset;
+    _tail = offset + size;
+    _usedBytes += padding + size;
+    ++_ringCount;
+    _ringSize += size;
+    return true;
+}
+
+void OplogBufferRingFile::_pushNonBlocking_inlock(const Value& value) {
+    if (!_overflow.empty() || !_tryAppend_inlock(value)) {
+        _overflow.push_back(value.getOwned());
+        _overflowSize += getDocumentSize(value);
+    }
+    if (_counters) {
+        _counters->increment(value);
+    }
+}
+
+void OplogBufferRingFile::_drainOverflow_inlock() {
+    while (!_overflow.empty() && _tryAppend_inlock(_overflow.front())) {
+        _overflowSize -= getDocumentSize(_overflow.front());
+        _overflow.pop_front();
+    }
+}
+
+std::size_t OplogBufferRingFile::_frontOffset_inlock() const {
+    invariant(_ringCount > 0);
+    if (_options.capacityBytes - _head < kSizeFieldBytes ||
+        ConstDataView(_file->data() + _head).read<LittleEndian<int32_t>>() == 0) {
+        return 0;
+    }
+    return _head;
+}
+
+void OplogBufferRingFile::_releasePopped_inlock() {
+    _usedBytes -= _poppedBytes;
+    _poppedBytes = 0;
+    _begin = _head;
+}
+
+void OplogBufferRingFile::_clear_inlock() {
+    _begin = _head = _tail = _lastWritten = 0;
+    _usedBytes = _poppedBytes = 0;
+    _ringCount = _ringSize = 0;
+    _overflow.clear();
+    _overflowSize = 0;
+    if (_counters) {
+        _counters->clear();
+    }
+}
+
+}  // namespace repl
+}  // namespace mongo
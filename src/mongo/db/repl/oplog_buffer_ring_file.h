@@ -0,0 +1,173 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <string>
+
+#include "mongo/db/repl/oplog_buffer.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+namespace repl {
+
+/**
+ * Oplog buffer backed by a fixed-size temporary file that is memory-mapped and used as a ring of
+ * raw BSON oplog entries. Entries are copied byte for byte from the pushed BSONObjs, which usually
+ * point into the OplogFetcher's reply buffers, so they are never re-encoded. Unlike the
+ * OplogBufferCollection there is no storage engine involved, and unlike the
+ * OplogBufferBlockingQueue the buffered entries do not need to stay resident in memory: the
+ * operating system may page them out to the backing file.
+ *
+ * peek() and tryPop() return BSONObjs that point directly into the mapping and do not own their
+ * data. A peeked entry stays valid until it is popped; a popped entry stays valid until the next
+ * call to tryPop(), clear() or shutdown(). Callers that need an entry for longer must call
+ * getOwned() on it, as OplogEntry does.
+ *
+ * pushEvenIfFull() and pushAllNonBlocking() may not block, so entries that do not fit in the ring
+ * are held in memory and moved into the ring, in order, as space is freed by popping.
+ */
+class OplogBufferRingFile final : public OplogBuffer {
+public:
+    struct Options {
+        // Path of the backing file, which is created by startup() and removed no later than the
+        // destruction of this oplog buffer.
+        std::string filePath;
+
+        // Size of the backing file. This is the maximum size of the entries held in the ring.
+        std::size_t capacityBytes = 0;
+    };
+
+    explicit OplogBufferRingFile(Options options, Counters* counters = nullptr);
+    ~OplogBufferRingFile();
+
+    void startup(OperationContext* opCtx) override;
+    void shutdown(OperationContext* opCtx) override;
+    void pushEvenIfFull(OperationContext* opCtx, const Value& value) override;
+    void push(OperationContext* opCtx, const Value& value) override;
+    void pushAllNonBlocking(OperationContext* opCtx,
+                            Batch::const_iterator begin,
+                            Batch::const_iterator end) override;
+    void waitForSpace(OperationContext* opCtx, std::size_t size) override;
+    bool isEmpty() const override;
+    std::size_t getMaxSize() const override;
+    std::size_t getSize() const override;
+    std::size_t getCount() const override;
+    void clear(OperationContext* opCtx) override;
+    bool tryPop(OperationContext* opCtx, Value* value) override;
+    bool waitForData(Seconds waitDuration) override;
+    bool peek(OperationContext* opCtx, Value* value) override;
+    boost::optional<Value> lastObjectPushed(OperationContext* opCtx) const override;
+
+    /**
+     * Returns the number of entries that did not fit in the ring and are held in memory.
+     */
+    std::size_t getOverflowCount_forTest() const;
+
+private:
+    class MappedFile;
+
+    /**
+     * Returns true if there is contiguous space for an entry of 'size' bytes at the end of the
+     * ring. If so, sets 'offset' to where the entry would be written and 'padding' to the number of
+     * bytes that would be skipped at the end of the file to wrap around to its start.
+     */
+    bool _findSpace_inlock(std::size_t size, std::size_t* offset, std::size_t* padding) const;
+
+    /**
+     * Copies 'value' to the end of the ring if there is contiguous space for it, and returns
+     * whether it did.
+     */
+    bool _tryAppend_inlock(const Value& value);
+
+    /**
+     * Appends 'value' to the ring, or to the in-memory overflow if it does not fit or earlier
+     * entries are already waiting there.
+     */
+    void _pushNonBlocking_inlock(const Value& value);
+
+    /**
+     * Moves entries from the in-memory overflow into the ring while they fit.
+     */
+    void _drainOverflow_inlock();
+
+    /**
+     * Returns the offset of the entry at the front of the ring, skipping the padding left when an
+     * entry was wrapped around to the start of the file. The ring must not be empty.
+     */
+    std::size_t _frontOffset_inlock() const;
+
+    /**
+     * Releases the space of the entry returned by the last call to tryPop().
+     */
+    void _releasePopped_inlock();
+
+    void _clear_inlock();
+
+    const Options _options;
+    Counters* const _counters;
+
+    std::unique_ptr<MappedFile> _file;
+
+    mutable stdx::mutex _mutex;
+    stdx::condition_variable _notEmptyCv;
+    stdx::condition_variable _notFullCv;
+
+    // Offset of the first byte that the writer may not overwrite. This is either '_head' or the
+    // start of the entry most recently returned by tryPop().
+    std::size_t _begin = 0;
+
+    // Offset of the next entry to be popped, possibly preceded by wrap-around padding.
+    std::size_t _head = 0;
+
+    // Offset at which the next entry will be written.
+    std::size_t _tail = 0;
+
+    // Offset of the most recently written entry.
+    std::size_t _lastWritten = 0;
+
+    // Number of bytes between '_begin' and '_tail', including wrap-around padding.
+    std::size_t _usedBytes = 0;
+
+    // Number of bytes, starting at '_begin', held by the entry most recently returned by tryPop().
+    std::size_t _poppedBytes = 0;
+
+    // Number of entries in the ring and the sum of their sizes.
+    std::size_t _ringCount = 0;
+    std::size_t _ringSize = 0;
+
+    // Entries that did not fit in the ring, in order, and the sum of their sizes.
+    std::deque<BSONObj> _overflow;
+    std::size_t _overflowSize = 0;
+};
+
+}  // namespace repl
+}  // namespace mongo
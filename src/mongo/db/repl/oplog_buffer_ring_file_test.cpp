@@ -0,0 +1,213 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/repl/oplog_buffer_ring_file.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+using namespace mongo::repl;
+
+BSONObj makeOplogEntry(int t, std::size_t padding = 0) {
+    return BSON("ts" << Timestamp(t, t) << "ns"
+                     << "a.a"
+                     << "v"
+                     << 2
+                     << "op"
+                     << "i"
+                     << "o"
+                     << BSON("_id" << t << "a" << std::string(padding, 'x')));
+}
+
+class OplogBufferRingFileTest : public unittest::Test {
+protected:
+    std::unique_ptr<OplogBufferRingFile> makeBuffer(std::size_t capacityBytes,
+                                                    OplogBuffer::Counters* counters = nullptr) {
+        OplogBufferRingFile::Options options;
+        options.filePath = _tempDir.path() + "/oplogBuffer.ring";
+        options.capacityBytes = capacityBytes;
+        auto buffer = stdx::make_unique<OplogBufferRingFile>(std::move(options), counters);
+        buffer->startup(nullptr);
+        return buffer;
+    }
+
+private:
+    unittest::TempDir _tempDir{"oplog_buffer_ring_file_test"};
+};
+
+TEST_F(OplogBufferRingFileTest, PushThenPopReturnsEntriesInOrder) {
+    auto buffer = makeBuffer(64 * 1024);
+    ASSERT_TRUE(buffer->isEmpty());
+
+    for (int i = 0; i < 10; i++) {
+        buffer->push(nullptr, makeOplogEntry(i));
+    }
+    ASSERT_EQUALS(10U, buffer->getCount());
+    ASSERT_EQUALS(10U * makeOplogEntry(0).objsize(), buffer->getSize());
+    ASSERT_BSONOBJ_EQ(makeOplogEntry(9), *buffer->lastObjectPushed(nullptr));
+
+    for (int i = 0; i < 10; i++) {
+        BSONObj value;
+        ASSERT_TRUE(buffer->tryPop(nullptr, &value));
+        ASSERT_BSONOBJ_EQ(makeOplogEntry(i), value);
+    }
+    BSONObj value;
+    ASSERT_FALSE(buffer->tryPop(nullptr, &value));
+    ASSERT_TRUE(buffer->isEmpty());
+    ASSERT_EQUALS(0U, buffer->getSize());
+    ASSERT_FALSE(buffer->lastObjectPushed(nullptr));
+}
+
+TEST_F(OplogBufferRingFileTest, PeekReturnsEntryInPlaceWithoutCopying) {
+    auto buffer = makeBuffer(64 * 1024);
+    const auto entry = makeOplogEntry(1);
+    buffer->push(nullptr, entry);
+
+    BSONObj first;
+    BSONObj second;
+    ASSERT_TRUE(buffer->peek(nullptr, &first));
+    ASSERT_TRUE(buffer->peek(nullptr, &second));
+    ASSERT_FALSE(first.isOwned());
+    ASSERT_EQUALS(first.objdata(), second.objdata());
+    ASSERT_NOT_EQUALS(entry.objdata(), first.objdata());
+    ASSERT_BSONOBJ_EQ(entry, first);
+
+    // The popped entry stays readable until the next pop.
+    BSONObj popped;
+    ASSERT_TRUE(buffer->tryPop(nullptr, &popped));
+    ASSERT_EQUALS(first.objdata(), popped.objdata());
+    buffer->push(nullptr, makeOplogEntry(2));
+    ASSERT_BSONOBJ_EQ(entry, popped);
+}
+
+TEST_F(OplogBufferRingFileTest, EntriesWrapAroundTheEndOfTheFile) {
+    const std::size_t entrySize = makeOplogEntry(0, 100).objsize();
+    auto buffer = makeBuffer(entrySize * 5 + entrySize / 2);
+
+    // Keep the ring mostly full while pushing many times its capacity through it, with entries of
+    // varying size so that entries wrap at different offsets.
+    int pushed = 0;
+    int popped = 0;
+    for (int round = 0; round < 100; round++) {
+        while (buffer->getSize() + entrySize * 2 < buffer->getMaxSize()) {
+            buffer->pushEvenIfFull(nullptr, makeOplogEntry(pushed, 50 + (pushed % 7) * 10));
+            pushed++;
+        }
+        for (int i = 0; i < 2; i++) {
+            BSONObj value;
+            ASSERT_TRUE(buffer->tryPop(nullptr, &value));
+            ASSERT_BSONOBJ_EQ(makeOplogEntry(popped, 50 + (popped % 7) * 10), value);
+            popped++;
+        }
+    }
+
+    BSONObj value;
+    while (buffer->tryPop(nullptr, &value)) {
+        ASSERT_BSONOBJ_EQ(makeOplogEntry(popped, 50 + (popped % 7) * 10), value);
+        popped++;
+    }
+    ASSERT_EQUALS(pushed, popped);
+}
+
+TEST_F(OplogBufferRingFileTest, NonBlockingPushesHoldEntriesThatDoNotFitInMemory) {
+    const std::size_t entrySize = makeOplogEntry(0).objsize();
+    auto buffer = makeBuffer(entrySize * 4);
+
+    OplogBuffer::Batch batch;
+    for (int i = 0; i < 10; i++) {
+        batch.push_back(makeOplogEntry(i));
+    }
+    buffer->pushAllNonBlocking(nullptr, batch.cbegin(), batch.cend());
+    buffer->pushEvenIfFull(nullptr, makeOplogEntry(10));
+    ASSERT_EQUALS(11U, buffer->getCount());
+    ASSERT_EQUALS(7U, buffer->getOverflowCount_forTest());
+    ASSERT_BSONOBJ_EQ(makeOplogEntry(10), *buffer->lastObjectPushed(nullptr));
+
+    // Popping moves held entries into the ring without changing their order.
+    for (int i = 0; i < 11; i++) {
+        BSONObj value;
+        ASSERT_TRUE(buffer->tryPop(nullptr, &value));
+        ASSERT_BSONOBJ_EQ(makeOplogEntry(i), value);
+    }
+    ASSERT_TRUE(buffer->isEmpty());
+    ASSERT_EQUALS(0U, buffer->getOverflowCount_forTest());
+}
+
+TEST_F(OplogBufferRingFileTest, EntryLargerThanTheFileIsHeldInMemory) {
+    auto buffer = makeBuffer(1024);
+    const auto entry = makeOplogEntry(1, 2048);
+    buffer->push(nullptr, entry);
+    ASSERT_EQUALS(1U, buffer->getOverflowCount_forTest());
+
+    BSONObj value;
+    ASSERT_TRUE(buffer->peek(nullptr, &value));
+    ASSERT_BSONOBJ_EQ(entry, value);
+    ASSERT_TRUE(buffer->tryPop(nullptr, &value));
+    ASSERT_BSONOBJ_EQ(entry, value);
+    ASSERT_TRUE(buffer->isEmpty());
+}
+
+TEST_F(OplogBufferRingFileTest, ClearRemovesAllEntriesAndUpdatesCounters) {
+    OplogBuffer::Counters counters;
+    auto buffer = makeBuffer(64 * 1024, &counters);
+    ASSERT_EQUALS(64 * 1024, counters.maxSize.get());
+
+    const std::size_t entrySize = makeOplogEntry(0).objsize();
+    buffer->push(nullptr, makeOplogEntry(0));
+    buffer->push(nullptr, makeOplogEntry(1));
+    ASSERT_EQUALS(2, counters.count.get());
+    ASSERT_EQUALS(static_cast<long long>(2 * entrySize), counters.size.get());
+
+    BSONObj value;
+    ASSERT_TRUE(buffer->tryPop(nullptr, &value));
+    ASSERT_EQUALS(1, counters.count.get());
+    ASSERT_EQUALS(static_cast<long long>(entrySize), counters.size.get());
+
+    buffer->clear(nullptr);
+    ASSERT_TRUE(buffer->isEmpty());
+    ASSERT_EQUALS(0, counters.count.get());
+    ASSERT_EQUALS(0, counters.size.get());
+    ASSERT_FALSE(buffer->waitForData(Seconds(0)));
+
+    buffer->push(nullptr, makeOplogEntry(2));
+    ASSERT_TRUE(buffer->waitForData(Seconds(0)));
+    ASSERT_TRUE(buffer->peek(nullptr, &value));
+    ASSERT_BSONOBJ_EQ(makeOplogEntry(2), value);
+
+    buffer->shutdown(nullptr);
+    ASSERT_TRUE(buffer->isEmpty());
+}
+
+}  // namespace
@@ -135,6 +135,46 @@ TEST_F(OplogTest, LogOpReturnsOpTimeOnSuccessfulInsertIntoOplogCollection) {
     ASSERT_EQUALS(ReplClientInfo::forClient(&cc()).getLastOp(), opTime);
 }
 
+TEST_F(OplogTest, LogInsertOpsWritesOneEntryPerDocumentWithContiguousOpTimes) {
+    auto opCtx = cc().makeOperationContext();
+
+    const NamespaceString nss("test.coll");
+    const auto uuid = UUID::gen();
+    std::vector<InsertStatement> inserts;
+    for (int i = 0; i < 10; ++i) {
+        inserts.emplace_back(BSON("_id" << i << "payload" << std::string(i * 100, 'x')));
+    }
+
+    std::vector<OpTime> opTimes;
+    {
+        AutoGetDb autoDb(opCtx.get(), nss.db(), MODE_X);
+        WriteUnitOfWork wunit(opCtx.get());
+        opTimes = logInsertOps(
+            opCtx.get(), nss, uuid, inserts.begin(), inserts.end(), false, Date_t::now());
+        wunit.commit();
+    }
+
+    ASSERT_EQUALS(inserts.size(), opTimes.size());
+    for (size_t i = 1; i < opTimes.size(); ++i) {
+        ASSERT_EQUALS(opTimes[i - 1].getTimestamp().asULL() + 1,
+                      opTimes[i].getTimestamp().asULL());
+    }
+
+    OplogInterfaceLocal oplogInterface(opCtx.get());
+    auto oplogIter = oplogInterface.makeIterator();
+    // The iterator returns the newest entry first.
+    for (size_t i = inserts.size(); i > 0; --i) {
+        auto oplogEntry = unittest::assertGet(
+            OplogEntry::parse(unittest::assertGet(oplogIter->next()).first));
+        ASSERT(OpTypeEnum::kInsert == oplogEntry.getOpType()) << oplogEntry.toBSON();
+        ASSERT_EQUALS(opTimes[i - 1], oplogEntry.getOpTime());
+        ASSERT_EQUALS(nss, oplogEntry.getNss());
+        ASSERT_EQUALS(uuid, *oplogEntry.getUuid());
+        ASSERT_BSONOBJ_EQ(inserts[i - 1].doc, oplogEntry.getObject());
+    }
+    ASSERT_EQUALS(ErrorCodes::CollectionIsEmpty, oplogIter->next().getStatus());
+}
+
 /**
  * Checks optime and namespace in oplog entry.
  */
@@ -0,0 +1,131 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/phi_accrual_failure_detector.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+/**
+ * Returns phi for a heartbeat which is 'y' standard deviations late, using the logistic
+ * approximation of the normal cumulative distribution function. Unlike computing 1 - CDF directly,
+ * this does not lose all precision for large 'y'.
+ */
+double phiForDeviation(double y) {
+    const double e = std::exp(-y * (1.5976 + 0.070566 * y * y));
+    if (y > 0) {
+        return -std::log10(e / (1.0 + e));
+    }
+    return -std::log10(1.0 - 1.0 / (1.0 + e));
+}
+
+}  // namespace
+
+PhiAccrualFailureDetector::PhiAccrualFailureDetector(std::size_t maxSamples,
+                                                     Milliseconds minStdDev)
+    : _maxSamples(maxSamples), _minStdDev(minStdDev) {
+    invariant(_maxSamples >= kMinSamples);
+}
+
+void PhiAccrualFailureDetector::recordHeartbeat(Date_t now) {
+    if (_lastArrival && now >= *_lastArrival) {
+        const auto interval = now - *_lastArrival;
+        const double millis = durationCount<Milliseconds>(interval);
+        _intervals.push_back(interval);
+        _sum += millis;
+        _sumOfSquares += millis * millis;
+
+        if (_intervals.size() > _maxSamples) {
+            const double oldest = durationCount<Milliseconds>(_intervals.front());
+            _intervals.pop_front();
+            _sum -= oldest;
+            _sumOfSquares -= oldest * oldest;
+        }
+    }
+    _lastArrival = now;
+}
+
+void PhiAccrualFailureDetector::reset() {
+    _lastArrival = boost::none;
+    _intervals.clear();
+    _sum = 0;
+    _sumOfSquares = 0;
+}
+
+double PhiAccrualFailureDetector::_mean() const {
+    return _intervals.empty() ? 0 : _sum / _intervals.size();
+}
+
+double PhiAccrualFailureDetector::_stdDev() const {
+    const double mean = _mean();
+    const double variance =
+        _intervals.empty() ? 0 : std::max(0.0, _sumOfSquares / _intervals.size() - mean * mean);
+    return std::max(std::sqrt(variance), double(durationCount<Milliseconds>(_minStdDev)));
+}
+
+double PhiAccrualFailureDetector::phi(Date_t now) const {
+    if (!_lastArrival || _intervals.empty()) {
+        return 0;
+    }
+    const double elapsed = durationCount<Milliseconds>(now - *_lastArrival);
+    return phiForDeviation((elapsed - _mean()) / _stdDev());
+}
+
+boost::optional<Milliseconds> PhiAccrualFailureDetector::timeoutForPhi(double threshold) const {
+    if (_intervals.size() < kMinSamples) {
+        return boost::none;
+    }
+
+    // phiForDeviation() is increasing, so bisect for the deviation at which it reaches the
+    // threshold. Beyond 40 standard deviations phi is far larger than any useful threshold.
+    double low = -40;
+    double high = 40;
+    for (int i = 0; i < 64; ++i) {
+        const double mid = (low + high) / 2;
+        if (phiForDeviation(mid) < threshold) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+
+    const double timeout = _mean() + high * _stdDev();
+    return Milliseconds(static_cast<long long>(std::ceil(std::max(0.0, timeout))));
+}
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <cstddef>
+#include <deque>
+
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace repl {
+
+/**
+ * Estimates how likely it is that a node has failed from the times at which its heartbeats have
+ * arrived, following the phi accrual failure detector of Hayashibara et al. The intervals between
+ * recent arrivals are treated as normally distributed, and phi is -log10 of the probability that
+ * the next heartbeat arrives later than the time which has elapsed since the last one. A phi of 8
+ * thus means that the node would be suspected wrongly about once in 10^8 times.
+ *
+ * This class is not thread-safe.
+ */
+class PhiAccrualFailureDetector {
+public:
+    // The number of intervals which must be observed before timeoutForPhi() returns an estimate.
+    static constexpr std::size_t kMinSamples = 5;
+
+    /**
+     * Keeps the last 'maxSamples' intervals between heartbeats. The standard deviation of those
+     * intervals is taken to be at least 'minStdDev', so that a very regular sender is not
+     * suspected as soon as a single heartbeat is slightly late.
+     */
+    PhiAccrualFailureDetector(std::size_t maxSamples, Milliseconds minStdDev);
+
+    /**
+     * Records that a heartbeat arrived at 'now'.
+     */
+    void recordHeartbeat(Date_t now);
+
+    /**
+     * Forgets all heartbeats, for example because another node should now be monitored.
+     */
+    void reset();
+
+    /**
+     * Returns the number of intervals between heartbeats currently used for the estimate.
+     */
+    std::size_t getNumSamples() const {
+        return _intervals.size();
+    }
+
+    /**
+     * Returns the suspicion level at 'now'. Returns 0 if there are no samples yet.
+     */
+    double phi(Date_t now) const;
+
+    /**
+     * Returns how long after the last heartbeat phi reaches 'threshold', or boost::none if fewer
+     * than kMinSamples intervals have been observed.
+     */
+    boost::optional<Milliseconds> timeoutForPhi(double threshold) const;
+
+private:
+    double _mean() const;
+    double _stdDev() const;
+
+    const std::size_t _maxSamples;
+    const Milliseconds _minStdDev;
+
+    boost::optional<Date_t> _lastArrival;
+    std::deque<Milliseconds> _intervals;
+
+    // Running sums over '_intervals', in milliseconds.
+    double _sum = 0;
+    double _sumOfSquares = 0;
+};
+
+}  // namespace repl
+}  // namespace mongo
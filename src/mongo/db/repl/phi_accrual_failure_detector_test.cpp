@@ -0,0 +1,131 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/phi_accrual_failure_detector.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+const Date_t kStart = Date_t::fromMillisSinceEpoch(1000 * 1000);
+
+TEST(PhiAccrualFailureDetector, NoEstimateUntilEnoughSamples) {
+    PhiAccrualFailureDetector detector(100, Milliseconds(100));
+    ASSERT_EQ(0, detector.phi(kStart));
+    for (std::size_t i = 0; i < PhiAccrualFailureDetector::kMinSamples; ++i) {
+        ASSERT_FALSE(detector.timeoutForPhi(8));
+        detector.recordHeartbeat(kStart + Milliseconds(500) * i);
+    }
+    ASSERT_EQ(PhiAccrualFailureDetector::kMinSamples - 1, detector.getNumSamples());
+    detector.recordHeartbeat(kStart + Milliseconds(500) * PhiAccrualFailureDetector::kMinSamples);
+    ASSERT_TRUE(detector.timeoutForPhi(8));
+}
+
+TEST(PhiAccrualFailureDetector, PhiGrowsWithTimeSinceLastHeartbeat) {
+    PhiAccrualFailureDetector detector(100, Milliseconds(100));
+    Date_t now = kStart;
+    for (int i = 0; i < 20; ++i) {
+        detector.recordHeartbeat(now);
+        now += Milliseconds(500);
+    }
+    const Date_t last = now - Milliseconds(500);
+
+    ASSERT_LT(detector.phi(last + Milliseconds(250)), 0.1);
+    ASSERT_APPROX_EQUAL(detector.phi(last + Milliseconds(500)), 0.30103, 0.001);
+    ASSERT_LT(detector.phi(last + Milliseconds(600)), detector.phi(last + Milliseconds(700)));
+    ASSERT_GT(detector.phi(last + Milliseconds(2000)), 8);
+}
+
+TEST(PhiAccrualFailureDetector, TimeoutMatchesPhiThreshold) {
+    PhiAccrualFailureDetector detector(100, Milliseconds(100));
+    Date_t now = kStart;
+    for (int i = 0; i < 20; ++i) {
+        detector.recordHeartbeat(now);
+        now += Milliseconds(i % 2 ? 450 : 550);
+    }
+
+    const auto timeout = detector.timeoutForPhi(8);
+    ASSERT_TRUE(timeout);
+    ASSERT_GT(*timeout, Milliseconds(500));
+    ASSERT_LT(*timeout, Milliseconds(2000));
+
+    const Date_t last = now - Milliseconds(450);
+    ASSERT_LT(detector.phi(last + *timeout - Milliseconds(10)), 8);
+    ASSERT_GTE(detector.phi(last + *timeout), 8);
+
+    // A higher threshold waits longer.
+    ASSERT_GT(*detector.timeoutForPhi(12), *timeout);
+}
+
+TEST(PhiAccrualFailureDetector, JitterWidensTimeout) {
+    PhiAccrualFailureDetector steady(100, Milliseconds(10));
+    PhiAccrualFailureDetector jittery(100, Milliseconds(10));
+    Date_t steadyNow = kStart;
+    Date_t jitteryNow = kStart;
+    for (int i = 0; i < 20; ++i) {
+        steady.recordHeartbeat(steadyNow);
+        jittery.recordHeartbeat(jitteryNow);
+        steadyNow += Milliseconds(500);
+        jitteryNow += Milliseconds(i % 2 ? 200 : 800);
+    }
+    ASSERT_GT(*jittery.timeoutForPhi(8), *steady.timeoutForPhi(8));
+}
+
+TEST(PhiAccrualFailureDetector, KeepsOnlyMostRecentSamples) {
+    PhiAccrualFailureDetector detector(10, Milliseconds(10));
+    Date_t now = kStart;
+    for (int i = 0; i < 20; ++i) {
+        detector.recordHeartbeat(now);
+        now += Milliseconds(5000);
+    }
+    for (int i = 0; i < 11; ++i) {
+        detector.recordHeartbeat(now);
+        now += Milliseconds(500);
+    }
+    ASSERT_EQ(10U, detector.getNumSamples());
+    ASSERT_LT(*detector.timeoutForPhi(8), Milliseconds(1000));
+}
+
+TEST(PhiAccrualFailureDetector, ResetForgetsHeartbeats) {
+    PhiAccrualFailureDetector detector(100, Milliseconds(100));
+    for (int i = 0; i < 10; ++i) {
+        detector.recordHeartbeat(kStart + Milliseconds(500) * i);
+    }
+    detector.reset();
+    ASSERT_EQ(0U, detector.getNumSamples());
+    ASSERT_EQ(0, detector.phi(kStart + Milliseconds(100 * 1000)));
+    ASSERT_FALSE(detector.timeoutForPhi(8));
+}
+
+}  // namespace
+}  // namespace repl
+}  // namespace mongo
@@ -303,6 +303,13 @@ Status ReadConcernArgs::upconvertReadConcernLevelToSnapshot() {
     return Status::OK();
 }
 
+void ReadConcernArgs::setArgsAtClusterTimeForSnapshot(Timestamp atClusterTime) {
+    invariant(getLevel() == ReadConcernLevel::kSnapshotReadConcern);
+    invariant(!atClusterTime.isNull());
+    _afterClusterTime = boost::none;
+    _atClusterTime = LogicalTime(atClusterTime);
+}
+
 void ReadConcernArgs::appendInfo(BSONObjBuilder* builder) const {
     BSONObjBuilder rcBuilder(builder->subobjStart(kReadConcernFieldName));
 
@@ -109,6 +109,14 @@ public:
      */
     Status upconvertReadConcernLevelToSnapshot();
 
+    /**
+     * Sets the timestamp at which a 'snapshot' read outside of a transaction reads, replacing any
+     * afterClusterTime. Used by mongos to choose one point in time for all the shards it targets.
+     *
+     * Invalid to call unless the read concern level is 'kSnapshotReadConcern'.
+     */
+    void setArgsAtClusterTimeForSnapshot(Timestamp atClusterTime);
+
     /**
      * Sets the mechanism we should use to satisfy 'majority' reads.
      *
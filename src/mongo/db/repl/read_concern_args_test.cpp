@@ -636,6 +636,29 @@ TEST(UpconvertReadConcernLevelToSnapshot, AfterOpTime) {
     ASSERT_TRUE(readConcern.getArgsOpTime());
 }
 
+TEST(SetArgsAtClusterTimeForSnapshot, ReplacesAfterClusterTime) {
+    ReadConcernArgs readConcern;
+    auto afterClusterTime = LogicalTime(Timestamp(20, 30));
+    ASSERT_OK(readConcern.initialize(BSON("find"
+                                          << "test"
+                                          << ReadConcernArgs::kReadConcernFieldName
+                                          << BSON(ReadConcernArgs::kAfterClusterTimeFieldName
+                                                  << afterClusterTime.asTimestamp()
+                                                  << ReadConcernArgs::kLevelFieldName
+                                                  << "snapshot"))));
+
+    readConcern.setArgsAtClusterTimeForSnapshot(Timestamp(40, 1));
+    ASSERT(ReadConcernLevel::kSnapshotReadConcern == readConcern.getLevel());
+    ASSERT_FALSE(readConcern.getArgsAfterClusterTime());
+    ASSERT_EQ(Timestamp(40, 1), readConcern.getArgsAtClusterTime()->asTimestamp());
+    ASSERT_BSONOBJ_EQ(BSON(ReadConcernArgs::kReadConcernFieldName << BSON(
+                               ReadConcernArgs::kLevelFieldName
+                               << "snapshot"
+                               << ReadConcernArgs::kAtClusterTimeFieldName
+                               << Timestamp(40, 1))),
+                      readConcern.toBSON());
+}
+
 }  // unnamed namespace
 }  // namespace repl
 }  // namespace mongo
@@ -35,6 +35,7 @@
 
 #include <string>
 
+#include "mongo/base/init.h"
 #include "mongo/base/status_with.h"
 #include "mongo/bson/oid.h"
 #include "mongo/bson/util/bson_extract.h"
@@ -66,6 +67,7 @@
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/oplog_applier_impl.h"
 #include "mongo/db/repl/oplog_buffer_blocking_queue.h"
+#include "mongo/db/repl/oplog_buffer_ring_file.h"
 #include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/replication_coordinator.h"
@@ -82,6 +84,7 @@
 #include "mongo/db/service_context.h"
 #include "mongo/db/session_catalog_mongod.h"
 #include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/db/system_index.h"
 #include "mongo/executor/network_connection_hook.h"
 #include "mongo/executor/network_interface.h"
@@ -125,6 +128,18 @@ const char tsFieldName[] = "ts";
 
 MONGO_FAIL_POINT_DEFINE(dropPendingCollectionReaperHang);
 
+const char kBlockingQueueOplogBufferName[] = "inMemoryBlockingQueue";
+const char kRingFileOplogBufferName[] = "ringFile";
+
+MONGO_INITIALIZER(steadyStateOplogBuffer)(InitializerContext*) {
+    if ((steadyStateOplogBuffer != kBlockingQueueOplogBufferName) &&
+        (steadyStateOplogBuffer != kRingFileOplogBufferName)) {
+        return Status(ErrorCodes::BadValue,
+                      "unsupported steady state oplog buffer option: " + steadyStateOplogBuffer);
+    }
+    return Status::OK();
+}
+
 // The count of items in the buffer
 OplogBuffer::Counters bufferGauge;
 ServerStatusMetricField<Counter64> displayBufferCount("repl.buffer.count", &bufferGauge.count);
@@ -217,10 +232,17 @@ void ReplicationCoordinatorExternalStateImpl::startSteadyStateReplication(
         return;
 
     invariant(replCoord);
-    _oplogBuffer = std::make_unique<OplogBufferBlockingQueue>(&bufferGauge);
+    if (steadyStateOplogBuffer == kRingFileOplogBufferName) {
+        OplogBufferRingFile::Options options;
+        options.filePath = storageGlobalParams.dbpath + "/_tmp/steadyStateOplogBuffer.ring";
+        options.capacityBytes = std::size_t(oplogBufferRingFileSizeMB) * 1024 * 1024;
+        _oplogBuffer = std::make_unique<OplogBufferRingFile>(std::move(options), &bufferGauge);
+    } else {
+        _oplogBuffer = std::make_unique<OplogBufferBlockingQueue>(&bufferGauge);
+    }
 
-    // No need to log OplogBuffer::startup because the blocking queue implementation
-    // does not start any threads or access the storage layer.
+    // No need to log OplogBuffer::startup because neither implementation starts any threads or
+    // accesses the storage layer.
     _oplogBuffer->startup(opCtx);
 
     invariant(!_oplogApplier);
@@ -3554,7 +3554,8 @@ Status ReplicationCoordinatorImpl::processReplSetRequestVotes(
             return Status(ErrorCodes::ShutdownInProgress, "In the process of shutting down");
         }
 
-        _topCoord->processReplSetRequestVotes(args, response);
+        _topCoord->processReplSetRequestVotes(
+            args, response, _isPrimaryHeartbeatOnTime_inlock(_replExecutor->now()));
     }
 
     if (!args.isADryRun() && response->getVoteGranted()) {
@@ -39,6 +39,7 @@
 #include "mongo/db/repl/initial_syncer.h"
 #include "mongo/db/repl/member_state.h"
 #include "mongo/db/repl/optime.h"
+#include "mongo/db/repl/phi_accrual_failure_detector.h"
 #include "mongo/db/repl/repl_set_config.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/replication_coordinator_external_state.h"
@@ -832,6 +833,25 @@ private:
      */
     Milliseconds _getRandomizedElectionOffset_inlock();
 
+    /**
+     * Records that a heartbeat response from 'primary' arrived at 'now', for the adaptive election
+     * timeout.
+     */
+    void _recordPrimaryHeartbeat_inlock(const HostAndPort& primary, Date_t now);
+
+    /**
+     * Returns the election timeout to use, which is shorter than the configured one if the
+     * adaptive election timeout is enabled and the heartbeats from the primary have been regular
+     * enough to detect its failure sooner.
+     */
+    Milliseconds _getElectionTimeoutPeriod_inlock() const;
+
+    /**
+     * Returns true if the adaptive election timeout is enabled and this node still expects the
+     * next heartbeat from the primary, i.e. it has no reason yet to suspect that it failed.
+     */
+    bool _isPrimaryHeartbeatOnTime_inlock(Date_t now) const;
+
     /**
      * Starts a heartbeat for each member in the current config.  Called while holding _mutex.
      */
@@ -1433,6 +1453,13 @@ private:
     // Used for testing only.
     Date_t _catchupTakeoverWhen;  // (M)
 
+    // Tracks when heartbeat responses from the primary arrive, to decide how long to wait for the
+    // next one before suspecting that the primary has failed.
+    PhiAccrualFailureDetector _primaryHeartbeatDetector{100, Milliseconds(100)};  // (M)
+
+    // The primary whose heartbeats _primaryHeartbeatDetector tracks.
+    HostAndPort _primaryHeartbeatDetectorTarget;  // (M)
+
     // Callback handle used by _waitForStartUpComplete() to block until configuration
     // is loaded and external state threads have been started (unless this node is an arbiter).
     CallbackHandle _finishLoadLocalConfigCbh;  // (M)
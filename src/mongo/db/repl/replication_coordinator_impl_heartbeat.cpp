@@ -51,6 +51,7 @@
 #include "mongo/db/repl/replication_coordinator_impl.h"
 #include "mongo/db/repl/replication_process.h"
 #include "mongo/db/repl/topology_coordinator.h"
+#include "mongo/db/repl/topology_coordinator_gen.h"
 #include "mongo/db/repl/vote_requester.h"
 #include "mongo/db/service_context.h"
 #include "mongo/rpc/get_status_from_command_result.h"
@@ -88,6 +89,36 @@ Milliseconds ReplicationCoordinatorImpl::_getRandomizedElectionOffset_inlock() {
     return Milliseconds{_nextRandomInt64_inlock(randomOffsetUpperBound)};
 }
 
+void ReplicationCoordinatorImpl::_recordPrimaryHeartbeat_inlock(const HostAndPort& primary,
+                                                                Date_t now) {
+    if (primary != _primaryHeartbeatDetectorTarget) {
+        _primaryHeartbeatDetector.reset();
+        _primaryHeartbeatDetectorTarget = primary;
+    }
+    _primaryHeartbeatDetector.recordHeartbeat(now);
+}
+
+Milliseconds ReplicationCoordinatorImpl::_getElectionTimeoutPeriod_inlock() const {
+    const auto electionTimeout = _rsConfig.getElectionTimeoutPeriod();
+    if (!gEnableAdaptiveElectionTimeout.load()) {
+        return electionTimeout;
+    }
+
+    const auto adaptiveTimeout =
+        _primaryHeartbeatDetector.timeoutForPhi(gAdaptiveElectionTimeoutPhiThreshold.load());
+    if (!adaptiveTimeout) {
+        return electionTimeout;
+    }
+    const Milliseconds minTimeout(gAdaptiveElectionTimeoutMinMillis.load());
+    return std::min(electionTimeout, std::max(*adaptiveTimeout, minTimeout));
+}
+
+bool ReplicationCoordinatorImpl::_isPrimaryHeartbeatOnTime_inlock(Date_t now) const {
+    return gEnableAdaptiveElectionTimeout.load() &&
+        _primaryHeartbeatDetector.getNumSamples() >= PhiAccrualFailureDetector::kMinSamples &&
+        _primaryHeartbeatDetector.phi(now) < gAdaptiveElectionTimeoutPhiThreshold.load();
+}
+
 void ReplicationCoordinatorImpl::_doMemberHeartbeat(executor::TaskExecutor::CallbackArgs cbData,
                                                     const HostAndPort& target,
                                                     int targetIndex) {
@@ -221,6 +252,7 @@ void ReplicationCoordinatorImpl::_handleHeartbeatResponse(
         if (hbResponse.hasState() && hbResponse.getState().primary() &&
             hbResponse.getTerm() == _topCoord->getTerm()) {
             LOG_FOR_ELECTION(4) << "Postponing election timeout due to heartbeat from primary";
+            _recordPrimaryHeartbeat_inlock(target, now);
             _cancelAndRescheduleElectionTimeout_inlock();
         }
     } else {
@@ -817,9 +849,17 @@ void ReplicationCoordinatorImpl::_cancelAndRescheduleElectionTimeout_inlock() {
         return;
     }
 
+    // The random offset is scaled down along with a shortened election timeout, so that it does
+    // not dominate the time it takes to detect a failed primary.
+    const auto configuredTimeout = _rsConfig.getElectionTimeoutPeriod();
+    const auto electionTimeout = _getElectionTimeoutPeriod_inlock();
     Milliseconds randomOffset = _getRandomizedElectionOffset_inlock();
+    if (electionTimeout < configuredTimeout) {
+        randomOffset = randomOffset * durationCount<Milliseconds>(electionTimeout) /
+            durationCount<Milliseconds>(configuredTimeout);
+    }
     auto now = _replExecutor->now();
-    auto when = now + _rsConfig.getElectionTimeoutPeriod() + randomOffset;
+    auto when = now + electionTimeout + randomOffset;
     invariant(when > now);
     LOG_FOR_ELECTION(4) << "Scheduling election timeout callback at " << when;
     _handleElectionTimeoutWhen = when;
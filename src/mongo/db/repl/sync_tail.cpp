@@ -44,6 +44,7 @@
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/document_validation.h"
+#include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/catalog/uuid_catalog.h"
 #include "mongo/db/catalog_raii.h"
 #include "mongo/db/client.h"
@@ -56,6 +57,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/dbhelpers.h"
 #include "mongo/db/logical_session_id.h"
 #include "mongo/db/multi_key_path_tracker.h"
 #include "mongo/db/namespace_string.h"
@@ -67,6 +69,7 @@
 #include "mongo/db/repl/multiapplier.h"
 #include "mongo/db/repl/oplogreader.h"
 #include "mongo/db/repl/repl_client_info.h"
+#include "mongo/db/repl/repl_server_parameters_gen.h"
 #include "mongo/db/repl/repl_set_config.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/transaction_oplog_application.h"
@@ -109,6 +112,11 @@ ServerStatusMetricField<Counter64> displayAttemptsToBecomeSecondary(
 TimerStats applyBatchStats;
 ServerStatusMetricField<TimerStats> displayOpBatchesApplied("repl.apply.batches", &applyBatchStats);
 
+// The oplog entries whose documents were read ahead of their application
+Counter64 prefetchedOpsStats;
+ServerStatusMetricField<Counter64> displayPrefetchedOps("repl.apply.prefetchedOps",
+                                                        &prefetchedOpsStats);
+
 class ApplyBatchFinalizer {
 public:
     ApplyBatchFinalizer(ReplicationCoordinator* replCoord) : _replCoord(replCoord) {}
@@ -572,6 +580,58 @@ void tryToGoLiveAsASecondary(OperationContext* opCtx,
 
 }  // namespace
 
+namespace {
+
+/**
+ * Looks up the _id index entry and document that each CRUD op in 'ops' will touch, so that their
+ * pages are in cache by the time the batch is applied. Updates and deletes read the document they
+ * will modify, and inserts read the part of the _id index their key will go into. This only warms
+ * the cache, so ops on collections that cannot be found or read are skipped.
+ */
+void prefetchBatchDocuments(OperationContext* opCtx, const OplogApplier::Operations& ops) {
+    // The previous batch is being applied under the PBWM lock while this runs.
+    ShouldNotConflictWithSecondaryBatchApplicationBlock shouldNotConflictBlock(opCtx->lockState());
+    // Documents of prepared transactions are committed by a later batch, so waiting for them here
+    // would never finish.
+    opCtx->recoveryUnit()->setIgnorePrepared(true);
+
+    for (const auto& op : ops) {
+        if (!op.isCrudOpType() || (op.getOpType() == OpTypeEnum::kUpdate && !op.getObject2())) {
+            continue;
+        }
+        BSONElement id = op.getIdElement();
+        if (id.eoo()) {
+            continue;
+        }
+
+        try {
+            const auto& nss = op.getNss();
+            Lock::DBLock dbLock(opCtx, nss.db(), MODE_IS);
+            Lock::CollectionLock collLock(opCtx, nss, MODE_IS);
+            auto db = DatabaseHolder::get(opCtx)->getDb(opCtx, nss.db());
+            auto collection = db ? db->getCollection(opCtx, nss) : nullptr;
+            if (!collection ||
+                (!collection->getIndexCatalog()->findIdIndex(opCtx) &&
+                 !collection->getRecordStore()->isClustered())) {
+                continue;
+            }
+
+            auto recordId = Helpers::findById(opCtx, collection, id.wrap());
+            Snapshotted<BSONObj> doc;
+            if (!recordId.isNull()) {
+                collection->findDoc(opCtx, recordId, &doc);
+            }
+            prefetchedOpsStats.increment();
+        } catch (const DBException& ex) {
+            LOG(2) << "Failed to prefetch the document for oplog entry " << redact(op.toBSON())
+                   << causedBy(redact(ex));
+        }
+        opCtx->recoveryUnit()->abandonSnapshot();
+    }
+}
+
+}  // namespace
+
 class SyncTail::OpQueueBatcher {
     OpQueueBatcher(const OpQueueBatcher&) = delete;
     OpQueueBatcher& operator=(const OpQueueBatcher&) = delete;
@@ -639,6 +699,7 @@ private:
             batchLimits.ops = OplogApplier::getBatchLimitOperations();
 
             OpQueue ops(batchLimits.ops);
+            OplogApplier::Operations oplogEntries;
             {
                 auto opCtx = cc().makeOperationContext();
 
@@ -650,7 +711,7 @@ private:
                 // handling.
                 UninterruptibleLockGuard noInterrupt(opCtx->lockState());
 
-                auto oplogEntries =
+                oplogEntries =
                     fassertNoTrace(31004, _getNextApplierBatchFn(opCtx.get(), batchLimits));
                 for (const auto& oplogEntry : oplogEntries) {
                     ops.emplace_back(oplogEntry.raw);
@@ -681,6 +742,13 @@ private:
                 _isDead = true;
                 return;
             }
+            lk.unlock();
+
+            // The batch just handed over usually waits for the previous one to finish applying,
+            // so read the documents it will touch in the meantime.
+            if (replPrefetchBatchDocuments.load()) {
+                prefetchBatchDocuments(cc().makeOperationContext().get(), oplogEntries);
+            }
         }
     }
 
@@ -1103,6 +1171,36 @@ Status multiSyncApply(OperationContext* opCtx,
     return Status::OK();
 }
 
+namespace {
+
+/**
+ * Returns the index of the writer to give an op whose conflict key hashes to 'hash'. Ops with the
+ * same hash must be applied in order by one writer, so the first of them in a batch goes to the
+ * writer with the fewest ops and the rest follow it. Unlike taking the hash modulo the number of
+ * writers, this keeps many unrelated documents from piling onto the same writer.
+ */
+uint32_t assignWriter(uint32_t hash,
+                      const std::vector<MultiApplier::OperationPtrs>& writerVectors,
+                      stdx::unordered_map<uint32_t, uint32_t>* writerAssignments) {
+    auto it = writerAssignments->find(hash);
+    if (it != writerAssignments->end()) {
+        return it->second;
+    }
+
+    // Start from the hashed writer so that ties do not always favor the first writer.
+    const uint32_t numWriters = writerVectors.size();
+    uint32_t leastLoaded = hash % numWriters;
+    for (uint32_t i = 0; i < numWriters; ++i) {
+        if (writerVectors[i].size() < writerVectors[leastLoaded].size()) {
+            leastLoaded = i;
+        }
+    }
+    writerAssignments->emplace(hash, leastLoaded);
+    return leastLoaded;
+}
+
+}  // namespace
+
 /**
  * ops - This only modifies the isForCappedCollection field on each op. It does not alter the ops
  *      vector in any other way.
@@ -1111,17 +1209,19 @@ Status multiSyncApply(OperationContext* opCtx,
  *      and instructions for updating the transactions table.  Required if processing oplogs
  *      with transactions.
  * sessionUpdateTracker - if provided, keeps track of session info from ops.
+ * writerAssignments - Writers already given to conflict keys in this batch. Shared by all
+ *      (recursive) calls filling the same writerVectors.
  */
 void SyncTail::_fillWriterVectors(OperationContext* opCtx,
                                   MultiApplier::Operations* ops,
                                   std::vector<MultiApplier::OperationPtrs>* writerVectors,
                                   std::vector<MultiApplier::Operations>* derivedOps,
-                                  SessionUpdateTracker* sessionUpdateTracker) {
+                                  SessionUpdateTracker* sessionUpdateTracker,
+                                  WriterAssignments* writerAssignments) {
     const auto serviceContext = opCtx->getServiceContext();
     const auto storageEngine = serviceContext->getStorageEngine();
 
     const bool supportsDocLocking = storageEngine->supportsDocLocking();
-    const uint32_t numWriters = writerVectors->size();
 
     CachedCollectionProperties collPropertiesCache;
     LogicalSessionIdMap<std::vector<OplogEntry*>> partialTxnOps;
@@ -1144,7 +1244,12 @@ void SyncTail::_fillWriterVectors(OperationContext* opCtx,
         if (sessionUpdateTracker) {
             if (auto newOplogWrites = sessionUpdateTracker->updateSession(op)) {
                 derivedOps->emplace_back(std::move(*newOplogWrites));
-                _fillWriterVectors(opCtx, &derivedOps->back(), writerVectors, derivedOps, nullptr);
+                _fillWriterVectors(opCtx,
+                                   &derivedOps->back(),
+                                   writerVectors,
+                                   derivedOps,
+                                   nullptr,
+                                   writerAssignments);
             }
         }
 
@@ -1193,7 +1298,12 @@ void SyncTail::_fillWriterVectors(OperationContext* opCtx,
                 derivedOps->emplace_back(ApplyOps::extractOperations(op));
 
                 // Nested entries cannot have different session updates.
-                _fillWriterVectors(opCtx, &derivedOps->back(), writerVectors, derivedOps, nullptr);
+                _fillWriterVectors(opCtx,
+                                   &derivedOps->back(),
+                                   writerVectors,
+                                   derivedOps,
+                                   nullptr,
+                                   writerAssignments);
             } catch (...) {
                 fassertFailedWithStatusNoTrace(
                     50711,
@@ -1218,7 +1328,12 @@ void SyncTail::_fillWriterVectors(OperationContext* opCtx,
                     partialTxnList.clear();
                 }
                 // Transaction entries cannot have different session updates.
-                _fillWriterVectors(opCtx, &derivedOps->back(), writerVectors, derivedOps, nullptr);
+                _fillWriterVectors(opCtx,
+                                   &derivedOps->back(),
+                                   writerVectors,
+                                   derivedOps,
+                                   nullptr,
+                                   writerAssignments);
             } catch (...) {
                 fassertFailedWithStatusNoTrace(
                     51116,
@@ -1230,7 +1345,7 @@ void SyncTail::_fillWriterVectors(OperationContext* opCtx,
             continue;
         }
 
-        auto& writer = (*writerVectors)[hash % numWriters];
+        auto& writer = (*writerVectors)[assignWriter(hash, *writerVectors, writerAssignments)];
         if (writer.empty()) {
             writer.reserve(8);  // Skip a few growth rounds
         }
@@ -1243,12 +1358,19 @@ void SyncTail::fillWriterVectors(OperationContext* opCtx,
                                  std::vector<MultiApplier::OperationPtrs>* writerVectors,
                                  std::vector<MultiApplier::Operations>* derivedOps) {
     SessionUpdateTracker sessionUpdateTracker;
-    _fillWriterVectors(opCtx, ops, writerVectors, derivedOps, &sessionUpdateTracker);
+    WriterAssignments writerAssignments;
+    _fillWriterVectors(
+        opCtx, ops, writerVectors, derivedOps, &sessionUpdateTracker, &writerAssignments);
 
     auto newOplogWrites = sessionUpdateTracker.flushAll();
     if (!newOplogWrites.empty()) {
         derivedOps->emplace_back(std::move(newOplogWrites));
-        _fillWriterVectors(opCtx, &derivedOps->back(), writerVectors, derivedOps, nullptr);
+        _fillWriterVectors(opCtx,
+                           &derivedOps->back(),
+                           writerVectors,
+                           derivedOps,
+                           nullptr,
+                           &writerAssignments);
     }
 }
 
@@ -44,6 +44,7 @@
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/util/concurrency/thread_pool.h"
 
 namespace mongo {
@@ -240,11 +241,16 @@ private:
 
     void _oplogApplication(ReplicationCoordinator* replCoord, OpQueueBatcher* batcher) noexcept;
 
+    // Maps the hash of an op's conflict key (its namespace, plus its _id when ops on different
+    // documents of the collection may be applied in parallel) to the writer it was given.
+    using WriterAssignments = stdx::unordered_map<uint32_t, uint32_t>;
+
     void _fillWriterVectors(OperationContext* opCtx,
                             MultiApplier::Operations* ops,
                             std::vector<MultiApplier::OperationPtrs>* writerVectors,
                             std::vector<MultiApplier::Operations>* derivedOps,
-                            SessionUpdateTracker* sessionUpdateTracker);
+                            SessionUpdateTracker* sessionUpdateTracker,
+                            WriterAssignments* writerAssignments);
 
     /**
      * Doles out all the work to the writer pool threads. Does not modify writerVectors, but passes
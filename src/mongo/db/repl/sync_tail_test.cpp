@@ -461,6 +461,38 @@ TEST_F(SyncTailTest,
                                                      createOplogCollectionOptions()));
 }
 
+TEST_F(SyncTailTest, FillWriterVectorsBalancesUnrelatedOpsAcrossWriters) {
+    SyncTail syncTail(nullptr, getConsistencyMarkers(), getStorageInterface(), {}, nullptr);
+
+    // Two ops on the same document of each of 16 collections.
+    const size_t numCollections = 16;
+    MultiApplier::Operations ops;
+    for (size_t i = 0; i < numCollections; ++i) {
+        NamespaceString nss("test." + _agent.getTestName() + std::to_string(i));
+        ops.push_back(makeInsertDocumentOplogEntry(
+            {Timestamp(Seconds(1), 2 * i), 1LL}, nss, BSON("_id" << 1)));
+        ops.push_back(makeUpdateDocumentOplogEntry({Timestamp(Seconds(1), 2 * i + 1), 1LL},
+                                                   nss,
+                                                   BSON("_id" << 1),
+                                                   BSON("$set" << BSON("x" << 1))));
+    }
+
+    std::vector<MultiApplier::OperationPtrs> writerVectors(4);
+    std::vector<MultiApplier::Operations> derivedOps;
+    syncTail.fillWriterVectors(_opCtx.get(), &ops, &writerVectors, &derivedOps);
+
+    // Each writer gets the same number of collections, and the ops on a document stay together on
+    // one writer in oplog order.
+    for (auto&& writer : writerVectors) {
+        ASSERT_EQUALS(2 * numCollections / writerVectors.size(), writer.size());
+        for (size_t i = 0; i < writer.size(); i += 2) {
+            ASSERT_EQUALS(writer[i]->getNss(), writer[i + 1]->getNss());
+            ASSERT(writer[i]->getOpType() == OpTypeEnum::kInsert);
+            ASSERT(writer[i + 1]->getOpType() == OpTypeEnum::kUpdate);
+        }
+    }
+}
+
 TEST_F(SyncTailTest, MultiSyncApplyUsesSyncApplyToApplyOperation) {
     NamespaceString nss("local." + _agent.getSuiteName() + "_" + _agent.getTestName());
     auto op = makeCreateCollectionOplogEntry({Timestamp(Seconds(1), 0), 1LL}, nss);
@@ -838,14 +870,14 @@ TEST_F(MultiOplogEntrySyncTailTest, MultiApplyTwoTransactionsOneBatch) {
     // Note the insert counter so we can check it later.  It is necessary to use opCounters as
     // inserts are idempotent so we will not detect duplicate inserts just by checking inserts in
     // the opObserver.
-    int insertsBefore = replOpCounters.getInsert()->load();
+    int insertsBefore = replOpCounters.getInsert();
     // Insert all the oplog entries in one batch.  All inserts should be executed, in order, exactly
     // once.
     ASSERT_OK(syncTail.multiApply(
         _opCtx.get(),
         {insertOps1[0], insertOps1[1], commitOp1, insertOps2[0], insertOps2[1], commitOp2}));
     ASSERT_EQ(6U, oplogDocs().size());
-    ASSERT_EQ(4, replOpCounters.getInsert()->load() - insertsBefore);
+    ASSERT_EQ(4, replOpCounters.getInsert() - insertsBefore);
     ASSERT_EQ(4U, _insertedDocs[_nss1].size());
     checkTxnTable(_lsid,
                   txnNum2,
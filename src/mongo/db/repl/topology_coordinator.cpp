@@ -2704,7 +2704,8 @@ rpc::OplogQueryMetadata TopologyCoordinator::prepareOplogQueryMetadata(int rbid)
 }
 
 void TopologyCoordinator::processReplSetRequestVotes(const ReplSetRequestVotesArgs& args,
-                                                     ReplSetRequestVotesResponse* response) {
+                                                     ReplSetRequestVotesResponse* response,
+                                                     bool primaryHeartbeatOnTime) {
     response->setTerm(_term);
 
     if (args.getTerm() < _term) {
@@ -2750,6 +2751,19 @@ void TopologyCoordinator::processReplSetRequestVotes(const ReplSetRequestVotesAr
                                 << "can see a healthy primary ("
                                 << _rsConfig.getMemberAt(betterPrimary).getHostAndPort()
                                 << ") of equal or greater priority");
+        } else if (args.isADryRun() && primaryHeartbeatOnTime && betterPrimary >= 0 &&
+                   args.getLastDurableOpTime() <=
+                       _memberData.at(betterPrimary).getHeartbeatAppliedOpTime()) {
+            // With adaptive election timeouts a candidate may suspect the primary early. Only let
+            // it proceed to a real election, which would depose the primary, if a majority of
+            // voters suspect the primary as well, or if it is ahead of the primary as in a catchup
+            // takeover.
+            response->setVoteGranted(false);
+            response->setReason(str::stream()
+                                << "can see a healthy primary ("
+                                << _rsConfig.getMemberAt(betterPrimary).getHostAndPort()
+                                << ") of equal or greater priority which is not behind the "
+                                   "candidate");
         } else {
             if (!args.isADryRun()) {
                 _lastVote.setTerm(args.getTerm());
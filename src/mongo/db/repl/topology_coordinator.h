@@ -612,9 +612,14 @@ public:
 
     /**
      * Prepares a ReplSetRequestVotesResponse.
+     *
+     * 'primaryHeartbeatOnTime' is true if this node's adaptive failure detector does not suspect
+     * the primary, in which case dry-run requests from candidates which are not ahead of the
+     * primary are refused.
      */
     void processReplSetRequestVotes(const ReplSetRequestVotesArgs& args,
-                                    ReplSetRequestVotesResponse* response);
+                                    ReplSetRequestVotesResponse* response,
+                                    bool primaryHeartbeatOnTime = false);
 
     /**
      * Loads an initial LastVote document, which was read from local storage.
@@ -3286,6 +3286,64 @@ TEST_F(TopoCoordTest, DoNotGrantDryRunVoteWhenOpTimeIsStale) {
     ASSERT_FALSE(response.getVoteGranted());
 }
 
+TEST_F(TopoCoordTest, DoNotGrantDryRunVoteWhenPrimaryHeartbeatIsOnTime) {
+    updateConfig(BSON("_id"
+                      << "rs0"
+                      << "version"
+                      << 1
+                      << "members"
+                      << BSON_ARRAY(BSON("_id" << 10 << "host"
+                                               << "hself")
+                                    << BSON("_id" << 20 << "host"
+                                                  << "h2")
+                                    << BSON("_id" << 30 << "host"
+                                                  << "h3"))),
+                 0);
+    setSelfMemberState(MemberState::RS_SECONDARY);
+    ASSERT(TopologyCoordinator::UpdateTermResult::kUpdatedTerm ==
+           getTopoCoord().updateTerm(1, now()));
+    heartbeatFromMember(
+        HostAndPort("h2"), "rs0", MemberState::RS_PRIMARY, OpTime(Timestamp(10, 0), 1));
+
+    auto makeDryRunArgs = [](Timestamp lastDurable) {
+        ReplSetRequestVotesArgs args;
+        args.initialize(BSON("replSetRequestVotes" << 1 << "setName"
+                                                   << "rs0"
+                                                   << "dryRun"
+                                                   << true
+                                                   << "term"
+                                                   << 1LL
+                                                   << "candidateIndex"
+                                                   << 2LL
+                                                   << "configVersion"
+                                                   << 1LL
+                                                   << "lastCommittedOp"
+                                                   << BSON("ts" << lastDurable << "term" << 1LL)))
+            .transitional_ignore();
+        return args;
+    };
+
+    // The candidate is not ahead of a primary that this node does not suspect.
+    ReplSetRequestVotesResponse response;
+    getTopoCoord().processReplSetRequestVotes(makeDryRunArgs(Timestamp(10, 0)), &response, true);
+    ASSERT_FALSE(response.getVoteGranted());
+    ASSERT_STRING_CONTAINS(response.getReason(), "can see a healthy primary (h2:27017)");
+
+    // This node suspects the primary too.
+    ReplSetRequestVotesResponse suspectedResponse;
+    getTopoCoord().processReplSetRequestVotes(
+        makeDryRunArgs(Timestamp(10, 0)), &suspectedResponse, false);
+    ASSERT_EQUALS("", suspectedResponse.getReason());
+    ASSERT_TRUE(suspectedResponse.getVoteGranted());
+
+    // The candidate is ahead of the primary, as in a catchup takeover.
+    ReplSetRequestVotesResponse aheadResponse;
+    getTopoCoord().processReplSetRequestVotes(
+        makeDryRunArgs(Timestamp(20, 0)), &aheadResponse, true);
+    ASSERT_EQUALS("", aheadResponse.getReason());
+    ASSERT_TRUE(aheadResponse.getVoteGranted());
+}
+
 TEST_F(TopoCoordTest, NodeTransitionsToRemovedIfCSRSButHaveNoReadCommittedSupport) {
     ON_BLOCK_EXIT([]() { serverGlobalParams.clusterRole = ClusterRole::None; });
     serverGlobalParams.clusterRole = ClusterRole::ConfigServer;
@@ -33,6 +33,8 @@
 
 #include "mongo/db/repl/transaction_oplog_application.h"
 
+#include <boost/optional.hpp>
+
 #include "mongo/db/background.h"
 #include "mongo/db/catalog_raii.h"
 #include "mongo/db/commands/txn_cmds_gen.h"
@@ -43,6 +45,7 @@
 #include "mongo/db/session_catalog_mongod.h"
 #include "mongo/db/transaction_history_iterator.h"
 #include "mongo/db/transaction_participant.h"
+#include "mongo/stdx/unordered_set.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -56,11 +59,18 @@ MONGO_FAIL_POINT_DEFINE(applyPrepareCommandHangBeforePreparingTransaction);
 Status _applyOperationsForTransaction(OperationContext* opCtx,
                                       const repl::MultiApplier::Operations& ops,
                                       repl::OplogApplication::Mode oplogApplicationMode) {
-    // Apply each the operations via repl::applyOperation.
+    // Apply each the operations via repl::applyOperation. All of them run in the same storage
+    // transaction, which keeps its locks until it ends, so the collection lock is only reacquired
+    // when the namespace changes. This matters for large transactions, whose operations tend to
+    // target a handful of collections.
+    boost::optional<AutoGetCollection> coll;
     for (const auto& op : ops) {
-        AutoGetCollection coll(opCtx, op.getNss(), MODE_IX);
+        if (!coll || coll->getNss() != op.getNss()) {
+            coll.reset();
+            coll.emplace(opCtx, op.getNss(), MODE_IX);
+        }
         auto status = repl::applyOperation_inlock(
-            opCtx, coll.getDb(), op.toBSON(), false /*alwaysUpsert*/, oplogApplicationMode);
+            opCtx, coll->getDb(), op.raw, false /*alwaysUpsert*/, oplogApplicationMode);
         if (!status.isOK()) {
             return status;
         }
@@ -322,10 +332,14 @@ Status _applyPrepareTransaction(OperationContext* opCtx,
     // This will prevent hybrid index builds from corrupting an index on secondary nodes if a
     // prepared transaction becomes prepared during a build but commits after the index build
     // commits.
+    // Each collection only needs to be checked once, however many operations target it.
+    stdx::unordered_set<UUID, UUID::Hash> checkedCollections;
     for (const auto& op : ops) {
-        auto ns = op.getNss();
         auto uuid = *op.getUuid();
-        BackgroundOperation::awaitNoBgOpInProgForNs(ns);
+        if (!checkedCollections.insert(uuid).second) {
+            continue;
+        }
+        BackgroundOperation::awaitNoBgOpInProgForNs(op.getNss());
         IndexBuildsCoordinator::get(opCtx)->awaitNoIndexBuildInProgressForCollection(uuid);
     }
 
@@ -63,10 +63,20 @@ void RetryableWritesStats::incrementTransactionsCollectionWriteCount() {
     _transactionsCollectionWriteCount.fetchAndAdd(1);
 }
 
+void RetryableWritesStats::incrementTransactionsCollectionCacheHitCount() {
+    _transactionsCollectionCacheHitCount.fetchAndAdd(1);
+}
+
+void RetryableWritesStats::incrementDeferredWriteHistoryFetchCount() {
+    _deferredWriteHistoryFetchCount.fetchAndAdd(1);
+}
+
 void RetryableWritesStats::updateStats(TransactionsStats* stats) {
     stats->setRetriedCommandsCount(_retriedCommandsCount.load());
     stats->setRetriedStatementsCount(_retriedStatementsCount.load());
     stats->setTransactionsCollectionWriteCount(_transactionsCollectionWriteCount.load());
+    stats->setTransactionsCollectionCacheHitCount(_transactionsCollectionCacheHitCount.load());
+    stats->setDeferredWriteHistoryFetchCount(_deferredWriteHistoryFetchCount.load());
 }
 
 }  // namespace mongo
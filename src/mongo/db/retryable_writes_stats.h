@@ -55,6 +55,10 @@ public:
 
     void incrementTransactionsCollectionWriteCount();
 
+    void incrementTransactionsCollectionCacheHitCount();
+
+    void incrementDeferredWriteHistoryFetchCount();
+
     /**
      * Appends the accumulated stats to a transactions stats object to be returned through
      * serverStatus.
@@ -71,6 +75,14 @@ private:
     // The number of writes to the config.transactions collection. Includes writes initiated by a
     // migration.
     AtomicWord<unsigned long long> _transactionsCollectionWriteCount{0};
+
+    // The number of sessions refreshed from a config.transactions record cached at step up rather
+    // than one read from storage.
+    AtomicWord<unsigned long long> _transactionsCollectionCacheHitCount{0};
+
+    // The number of times the oplog chain of a retryable write was walked when the write was
+    // retried, rather than when its session was refreshed from storage.
+    AtomicWord<unsigned long long> _deferredWriteHistoryFetchCount{0};
 };
 
 }  // namespace mongo
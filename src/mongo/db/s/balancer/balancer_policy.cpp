@@ -33,6 +33,9 @@
 
 #include "mongo/db/s/balancer/balancer_policy.h"
 
+#include <algorithm>
+
+#include "mongo/db/s/balancer/balancer_policy_params_gen.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/catalog/type_tags.h"
 #include "mongo/util/log.h"
@@ -52,6 +55,33 @@ namespace {
 // optimal average across all shards for a zone for a rebalancing migration to be initiated.
 const size_t kDefaultImbalanceThreshold = 1;
 
+// When balancing by load, shards may deviate from the optimal number of chunks per shard for a zone
+// by this fraction of the optimum (and always by at least one chunk).
+const size_t kLoadImbalanceChunkCountBandDivisor = 10;
+
+/**
+ * Returns whether load-aware balancing is enabled and 'stat' serves more than
+ * 'balancerLoadImbalanceRatio' times as many operations per second as the least busy shard in the
+ * specified zone. An idle shard is treated as serving one operation per second.
+ */
+bool isHotShard(const ShardStatisticsVector& shardStats,
+                const ClusterStatistics::ShardStatistics& stat,
+                const string& tag) {
+    const double ratio = gBalancerLoadImbalanceRatio.load();
+    if (ratio == 0) {
+        return false;
+    }
+
+    double minOpsPerSecond = stat.opsPerSecond;
+    for (const auto& other : shardStats) {
+        if (tag.empty() || other.shardTags.count(tag)) {
+            minOpsPerSecond = std::min(minOpsPerSecond, other.opsPerSecond);
+        }
+    }
+
+    return stat.opsPerSecond > ratio * std::max(minOpsPerSecond, 1.0);
+}
+
 }  // namespace
 
 DistributionStatus::DistributionStatus(NamespaceString nss, ShardToChunksMap shardToChunksMap)
@@ -426,6 +456,15 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
                                   &migrations,
                                   usedShards))
             ;
+
+        if (gBalancerLoadImbalanceRatio.load() > 0) {
+            _singleZoneLoadBalance(shardStats,
+                                   distribution,
+                                   tag,
+                                   idealNumberOfChunksPerShardForTag,
+                                   &migrations,
+                                   usedShards);
+        }
     }
 
     return migrations;
@@ -462,7 +501,17 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
     if (max <= idealNumberOfChunksPerShardForTag)
         return false;
 
-    const ShardId to = _getLeastLoadedReceiverShard(shardStats, distribution, tag, *usedShards);
+    // Shards which are much busier than the rest of the zone do not receive chunks, so that count
+    // balancing does not undo the migrations made by load balancing.
+    auto excludedReceivers = *usedShards;
+    for (const auto& stat : shardStats) {
+        if (isHotShard(shardStats, stat, tag)) {
+            excludedReceivers.insert(stat.shardId);
+        }
+    }
+
+    const ShardId to =
+        _getLeastLoadedReceiverShard(shardStats, distribution, tag, excludedReceivers);
     if (!to.isValid()) {
         if (migrations->empty()) {
             log() << "No available shards to take chunks for zone [" << tag << "]";
@@ -517,6 +566,74 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
     return false;
 }
 
+bool BalancerPolicy::_singleZoneLoadBalance(const ShardStatisticsVector& shardStats,
+                                            const DistributionStatus& distribution,
+                                            const string& tag,
+                                            size_t idealNumberOfChunksPerShardForTag,
+                                            vector<MigrateInfo>* migrations,
+                                            set<ShardId>* usedShards) {
+    const ClusterStatistics::ShardStatistics* hottest = nullptr;
+    const ClusterStatistics::ShardStatistics* coldest = nullptr;
+
+    for (const auto& stat : shardStats) {
+        if (usedShards->count(stat.shardId))
+            continue;
+
+        if (!tag.empty() && !stat.shardTags.count(tag))
+            continue;
+
+        if (!hottest || stat.opsPerSecond > hottest->opsPerSecond) {
+            hottest = &stat;
+        }
+
+        if (!isShardSuitableReceiver(stat, tag).isOK())
+            continue;
+
+        if (!coldest || stat.opsPerSecond < coldest->opsPerSecond) {
+            coldest = &stat;
+        }
+    }
+
+    if (!hottest || !coldest || hottest == coldest)
+        return false;
+
+    if (!isHotShard(shardStats, *hottest, tag))
+        return false;
+
+    // Only move chunks while both shards stay close to the optimal number of chunks, so that
+    // balancing by load never creates an imbalance which count balancing would need to correct.
+    const size_t band = std::max<size_t>(
+        1, idealNumberOfChunksPerShardForTag / kLoadImbalanceChunkCountBandDivisor);
+    const size_t donorChunks = distribution.numberOfChunksInShardWithTag(hottest->shardId, tag);
+    const size_t receiverChunks = distribution.numberOfChunksInShardWithTag(coldest->shardId, tag);
+    if (donorChunks + band <= idealNumberOfChunksPerShardForTag ||
+        receiverChunks >= idealNumberOfChunksPerShardForTag + band)
+        return false;
+
+    LOG(1) << "collection : " << distribution.nss().ns();
+    LOG(1) << "zone       : " << tag;
+    LOG(1) << "donor      : " << hottest->shardId << " ops/sec " << hottest->opsPerSecond
+           << " chunks on " << donorChunks;
+    LOG(1) << "receiver   : " << coldest->shardId << " ops/sec " << coldest->opsPerSecond
+           << " chunks on " << receiverChunks;
+    LOG(1) << "ideal      : " << idealNumberOfChunksPerShardForTag;
+
+    for (const auto& chunk : distribution.getChunks(hottest->shardId)) {
+        if (distribution.getTagForChunk(chunk) != tag)
+            continue;
+
+        if (chunk.getJumbo())
+            continue;
+
+        migrations->emplace_back(coldest->shardId, chunk);
+        invariant(usedShards->insert(chunk.getShard()).second);
+        invariant(usedShards->insert(coldest->shardId).second);
+        return true;
+    }
+
+    return false;
+}
+
 ZoneRange::ZoneRange(const BSONObj& a_min, const BSONObj& a_max, const std::string& _zone)
     : min(a_min.getOwned()), max(a_max.getOwned()), zone(_zone) {}
 
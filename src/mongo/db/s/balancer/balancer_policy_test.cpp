@@ -33,10 +33,12 @@
 
 #include "mongo/db/keypattern.h"
 #include "mongo/db/s/balancer/balancer_policy.h"
+#include "mongo/db/s/balancer/balancer_policy_params_gen.h"
 #include "mongo/platform/random.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -609,6 +611,73 @@ TEST(BalancerPolicy, BalancerHandlesNoShardsWithTag) {
     ASSERT(balanceChunks(cluster.first, distribution, false).empty());
 }
 
+TEST(BalancerPolicy, LoadBalancingIsDisabledByDefault) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 5, false, emptyTagSet, emptyShardVersion), 5},
+         {ShardStatistics(kShardId1, kNoMaxSize, 5, false, emptyTagSet, emptyShardVersion), 5},
+         {ShardStatistics(kShardId2, kNoMaxSize, 5, false, emptyTagSet, emptyShardVersion), 5}});
+    cluster.first[0].opsPerSecond = 1000;
+
+    const auto migrations(
+        balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false));
+    ASSERT(migrations.empty());
+}
+
+TEST(BalancerPolicy, LoadBalancingMovesChunkFromBusiestToLeastBusyShard) {
+    gBalancerLoadImbalanceRatio.store(2);
+    ON_BLOCK_EXIT([] { gBalancerLoadImbalanceRatio.store(0); });
+
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 5, false, emptyTagSet, emptyShardVersion), 5},
+         {ShardStatistics(kShardId1, kNoMaxSize, 5, false, emptyTagSet, emptyShardVersion), 5},
+         {ShardStatistics(kShardId2, kNoMaxSize, 5, false, emptyTagSet, emptyShardVersion), 5}});
+    cluster.first[0].opsPerSecond = 1000;
+    cluster.first[1].opsPerSecond = 100;
+    cluster.first[2].opsPerSecond = 50;
+
+    const auto migrations(
+        balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId2, migrations[0].to);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][0].getMin(), migrations[0].minKey);
+}
+
+TEST(BalancerPolicy, LoadBalancingDoesNotMoveChunksBetweenShardsWithSimilarLoad) {
+    gBalancerLoadImbalanceRatio.store(2);
+    ON_BLOCK_EXIT([] { gBalancerLoadImbalanceRatio.store(0); });
+
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 5, false, emptyTagSet, emptyShardVersion), 5},
+         {ShardStatistics(kShardId1, kNoMaxSize, 5, false, emptyTagSet, emptyShardVersion), 5}});
+    cluster.first[0].opsPerSecond = 150;
+    cluster.first[1].opsPerSecond = 100;
+
+    const auto migrations(
+        balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false));
+    ASSERT(migrations.empty());
+}
+
+TEST(BalancerPolicy, LoadBalancingStaysCloseToTheIdealChunkCount) {
+    gBalancerLoadImbalanceRatio.store(2);
+    ON_BLOCK_EXIT([] { gBalancerLoadImbalanceRatio.store(0); });
+
+    // The busy shard already has one chunk fewer than the ideal, and the idle shard has one more.
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 4, false, emptyTagSet, emptyShardVersion), 4},
+         {ShardStatistics(kShardId1, kNoMaxSize, 5, false, emptyTagSet, emptyShardVersion), 5},
+         {ShardStatistics(kShardId2, kNoMaxSize, 6, false, emptyTagSet, emptyShardVersion), 6}});
+    cluster.first[0].opsPerSecond = 1000;
+    cluster.first[1].opsPerSecond = 900;
+    cluster.first[2].opsPerSecond = 10;
+
+    // Count balancing would move a chunk from shard2 to shard0, but shard0 is too busy to receive
+    // chunks, and load balancing may not move any more chunks off of it.
+    const auto migrations(
+        balanceChunks(cluster.first, DistributionStatus(kNamespace, cluster.second), false));
+    ASSERT(migrations.empty());
+}
+
 TEST(DistributionStatus, AddTagRangeOverlap) {
     DistributionStatus d(kNamespace, ShardToChunksMap{});
 
@@ -93,6 +93,10 @@ public:
 
         // Version of mongod, which runs on this shard's primary
         std::string mongoVersion;
+
+        // Rate of CRUD operations served by this shard's primary since the previous statistics
+        // snapshot. Zero if the rate is not yet known.
+        double opsPerSecond{0};
     };
 
     virtual ~ClusterStatistics();
@@ -49,16 +49,15 @@ namespace mongo {
 namespace {
 
 const char kVersionField[] = "version";
+const char kOpCountersField[] = "opcounters";
 
 /**
- * Executes the serverStatus command against the specified shard and obtains the version of the
- * running MongoD service.
+ * Executes the serverStatus command against the specified shard's primary and returns its result.
  *
- * Returns the MongoD version in strig format or an error. Known error codes are:
+ * Known error codes are:
  *  ShardNotFound if shard by that id is not available on the registry
- *  NoSuchKey if the version could not be retrieved
  */
-StatusWith<std::string> retrieveShardMongoDVersion(OperationContext* opCtx, ShardId shardId) {
+StatusWith<BSONObj> retrieveShardServerStatus(OperationContext* opCtx, ShardId shardId) {
     auto shardRegistry = Grid::get(opCtx)->shardRegistry();
     auto shardStatus = shardRegistry->getShard(opCtx, shardId);
     if (!shardStatus.isOK()) {
@@ -79,15 +78,24 @@ StatusWith<std::string> retrieveShardMongoDVersion(OperationContext* opCtx, Shar
         return commandResponse.getValue().commandStatus;
     }
 
-    BSONObj serverStatus = std::move(commandResponse.getValue().response);
+    return std::move(commandResponse.getValue().response);
+}
 
-    std::string version;
-    Status status = bsonExtractStringField(serverStatus, kVersionField, &version);
-    if (!status.isOK()) {
-        return status;
+/**
+ * Returns the total number of CRUD operations reported in the 'opcounters' section of a shard's
+ * serverStatus, or boost::none if the section is missing.
+ */
+boost::optional<long long> extractNumCrudOps(const BSONObj& serverStatus) {
+    const auto opCounters = serverStatus[kOpCountersField];
+    if (opCounters.type() != Object) {
+        return boost::none;
     }
 
-    return version;
+    long long numOps = 0;
+    for (auto fieldName : {"insert", "query", "update", "delete", "getmore"}) {
+        numOps += opCounters.Obj()[fieldName].safeNumberLong();
+    }
+    return numOps;
 }
 
 }  // namespace
@@ -134,15 +142,24 @@ StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(Operati
         }
 
         std::string mongoDVersion;
+        boost::optional<long long> numCrudOps;
 
-        auto mongoDVersionStatus = retrieveShardMongoDVersion(opCtx, shard.getName());
-        if (mongoDVersionStatus.isOK()) {
-            mongoDVersion = std::move(mongoDVersionStatus.getValue());
+        auto serverStatus = retrieveShardServerStatus(opCtx, shard.getName());
+        if (serverStatus.isOK()) {
+            numCrudOps = extractNumCrudOps(serverStatus.getValue());
+
+            auto versionStatus =
+                bsonExtractStringField(serverStatus.getValue(), kVersionField, &mongoDVersion);
+            if (!versionStatus.isOK()) {
+                log() << "Unable to obtain shard version for " << shard.getName()
+                      << causedBy(versionStatus);
+            }
         } else {
-            // Since the mongod version is only used for reporting, there is no need to fail the
-            // entire round if it cannot be retrieved, so just leave it empty
+            // Since the mongod version and load are only used for reporting and for load-aware
+            // balancing, there is no need to fail the entire round if they cannot be retrieved,
+            // so just leave them empty
             log() << "Unable to obtain shard version for " << shard.getName()
-                  << causedBy(mongoDVersionStatus.getStatus());
+                  << causedBy(serverStatus.getStatus());
         }
 
         std::set<std::string> shardTags;
@@ -157,9 +174,38 @@ StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(Operati
                            shard.getDraining(),
                            std::move(shardTags),
                            std::move(mongoDVersion));
+
+        if (numCrudOps) {
+            stats.back().opsPerSecond =
+                _updateOpsPerSecond(shard.getName(), *numCrudOps, Date_t::now());
+        }
     }
 
     return stats;
 }
 
+double ClusterStatisticsImpl::_updateOpsPerSecond(const ShardId& shardId,
+                                                  long long numOps,
+                                                  Date_t now) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _lastOpCountSamples.find(shardId);
+    if (it == _lastOpCountSamples.end()) {
+        _lastOpCountSamples.emplace(shardId, OpCountSample{numOps, now});
+        return 0;
+    }
+
+    const auto previous = it->second;
+    it->second = OpCountSample{numOps, now};
+
+    // A counter which went backwards means the shard's primary restarted or changed, so the
+    // previous sample does not describe the same process.
+    const auto elapsed = now - previous.sampledAt;
+    if (numOps < previous.numOps || elapsed <= Milliseconds(0)) {
+        return 0;
+    }
+
+    return (numOps - previous.numOps) * 1000.0 / durationCount<Milliseconds>(elapsed);
+}
+
 }  // namespace mongo
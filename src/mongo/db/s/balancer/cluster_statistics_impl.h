@@ -31,6 +31,9 @@
 
 #include "mongo/db/s/balancer/balancer_random.h"
 #include "mongo/db/s/balancer/cluster_statistics.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -47,8 +50,29 @@ public:
     StatusWith<std::vector<ShardStatistics>> getStats(OperationContext* opCtx) override;
 
 private:
+    /**
+     * Total number of CRUD operations a shard's primary had served at the time it was sampled.
+     */
+    struct OpCountSample {
+        long long numOps;
+        Date_t sampledAt;
+    };
+
+    /**
+     * Records 'numOps' as the latest operation count for 'shardId' and returns the rate of
+     * operations per second since the previous sample, or zero if there is no usable previous
+     * sample.
+     */
+    double _updateOpsPerSecond(const ShardId& shardId, long long numOps, Date_t now);
+
     // Source of randomness when metadata needs to be randomized.
     BalancerRandomSource& _random;
+
+    // Protects '_lastOpCountSamples'.
+    stdx::mutex _mutex;
+
+    // The most recent operation count sampled from each shard.
+    stdx::unordered_map<ShardId, OpCountSample, ShardId::Hasher> _lastOpCountSamples;
 };
 
 }  // namespace mongo
@@ -53,6 +53,8 @@ ChunkSplitStateDriver::ChunkSplitStateDriver(ChunkSplitStateDriver&& source) noe
     _stashedBytesWritten = source._stashedBytesWritten;
     source._stashedBytesWritten = 0;
 
+    _sampledKeys = std::move(source._sampledKeys);
+
     _splitState = source._splitState;
     source._splitState = SplitState::kNotSplitting;
 }
@@ -75,6 +77,7 @@ void ChunkSplitStateDriver::prepareSplit() {
     uassert(50873, "Split interrupted due to chunk metadata change.", wt);
     // Clear bytes written and get the previous bytes written.
     _stashedBytesWritten = wt->clearBytesWritten();
+    _sampledKeys = wt->getSampledKeys();
 }
 
 void ChunkSplitStateDriver::abandonPrepare() {
@@ -32,6 +32,7 @@
 
 #include <boost/optional.hpp>
 #include <memory>
+#include <vector>
 
 #include "mongo/s/chunk_writes_tracker.h"
 
@@ -77,10 +78,19 @@ public:
 
     /**
      * Clears the current bytes written, but stashes them in a variable in case
-     * the split is later canceled.
+     * the split is later canceled. Also takes a copy of the shard keys sampled
+     * from the writes to the chunk.
      */
     void prepareSplit();
 
+    /**
+     * Returns the shard keys sampled from the writes to the chunk, as of
+     * prepareSplit.
+     */
+    const std::vector<BSONObj>& getSampledKeys() const {
+        return _sampledKeys;
+    }
+
     /**
      * In the case that we trigger a split but decide not to split due to the
      * actual size of a chunk on disk being too small, we update our estimate
@@ -113,6 +123,11 @@ private:
      */
     uint64_t _stashedBytesWritten{0};
 
+    /**
+     * Copy of the writes tracker's sample of written shard keys, taken in prepare.
+     */
+    std::vector<BSONObj> _sampledKeys;
+
     /**
      * The current state of the chunk with respect to its progress being split.
      */
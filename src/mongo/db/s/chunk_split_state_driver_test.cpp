@@ -31,6 +31,7 @@
 
 #include "mongo/db/s/chunk_split_state_driver.h"
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
 
@@ -86,6 +87,16 @@ TEST_F(ChunkSplitStateDriverTest, PrepareSplitClearsBytesWritten) {
     ASSERT_EQ(writesTracker().getBytesWritten(), 0ull);
 }
 
+TEST_F(ChunkSplitStateDriverTest, PrepareSplitTakesTheSampledKeys) {
+    writesTracker().addSampledKey(BSON("x" << 1));
+    writesTracker().addSampledKey(BSON("x" << 2));
+    ASSERT(splitDriver()->getSampledKeys().empty());
+
+    splitDriver()->prepareSplit();
+    ASSERT_EQ(2U, splitDriver()->getSampledKeys().size());
+    ASSERT_EQ(2U, writesTracker().getSampledKeys().size());
+}
+
 TEST_F(ChunkSplitStateDriverTestNoTeardown,
        PrepareSplitFollowedByDestructorWithoutCommitRestoresBytesWritten) {
     auto bytesInTracker = writesTracker().getBytesWritten();
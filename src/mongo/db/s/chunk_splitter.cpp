@@ -33,13 +33,18 @@
 
 #include "mongo/db/s/chunk_splitter.h"
 
+#include <algorithm>
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/client/dbclient_cursor.h"
 #include "mongo/client/query.h"
+#include "mongo/db/catalog_raii.h"
 #include "mongo/db/client.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/s/chunk_split_state_driver.h"
 #include "mongo/db/s/shard_filtering_metadata_refresh.h"
+#include "mongo/db/s/sharding_runtime_d_params_gen.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/s/split_chunk.h"
 #include "mongo/db/s/split_vector.h"
@@ -194,6 +199,78 @@ BSONObj findExtremeKeyForShard(OperationContext* opCtx,
     return shardKeyPattern.extractShardKeyFromDoc(end);
 }
 
+/**
+ * The fewest sampled shard keys from which split points will be chosen. With fewer samples the
+ * split points are found by scanning the chunk instead.
+ */
+const size_t kMinSampledKeysForSplit = 10;
+
+/**
+ * Chooses split points for 'chunk' from the shard keys sampled from the writes to it, without
+ * scanning the chunk. Like splitVector, returns a split point for every half of
+ * 'maxChunkSizeBytes' of data. The chunk's size is estimated as the collection's data size spread
+ * evenly over the chunks this shard owns.
+ *
+ * Returns boost::none if there are too few sampled keys inside the chunk to choose from, or if the
+ * estimate does not show the chunk to be over 'maxChunkSizeBytes', since a chunk which receives
+ * more writes than the others may still be larger than the estimate.
+ */
+boost::optional<std::vector<BSONObj>> chooseSampledSplitPoints(
+    OperationContext* opCtx,
+    const NamespaceString& nss,
+    const ChunkManager& cm,
+    const Chunk& chunk,
+    const std::vector<BSONObj>& sampledKeys,
+    uint64_t maxChunkSizeBytes) {
+    BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    for (const auto& key : sampledKeys) {
+        if (chunk.containsKey(key) && key.woCompare(chunk.getMin()) != 0) {
+            keys.insert(key);
+        }
+    }
+
+    if (keys.size() < kMinSampledKeysForSplit) {
+        return boost::none;
+    }
+
+    long long dataSize;
+    {
+        AutoGetCollection autoColl(opCtx, nss, MODE_IS);
+        const auto collection = autoColl.getCollection();
+        if (!collection) {
+            return boost::none;
+        }
+        dataSize = collection->dataSize(opCtx);
+    }
+
+    uint64_t numChunksOnShard = 0;
+    for (const auto& c : cm.chunks()) {
+        if (c.getShardId() == chunk.getShardId()) {
+            ++numChunksOnShard;
+        }
+    }
+    invariant(numChunksOnShard > 0);
+
+    const uint64_t estimatedChunkBytes = static_cast<uint64_t>(dataSize) / numChunksOnShard;
+    if (estimatedChunkBytes < maxChunkSizeBytes) {
+        return boost::none;
+    }
+
+    // Place the split points at evenly spaced quantiles of the sampled keys.
+    const std::vector<BSONObj> sortedKeys(keys.begin(), keys.end());
+    const size_t numSplitPoints =
+        std::min<uint64_t>(estimatedChunkBytes / (maxChunkSizeBytes / 2), sortedKeys.size());
+
+    std::vector<BSONObj> splitPoints;
+    for (size_t i = 1; i <= numSplitPoints; ++i) {
+        const auto& key = sortedKeys[i * sortedKeys.size() / (numSplitPoints + 1)];
+        if (splitPoints.empty() || splitPoints.back().woCompare(key) != 0) {
+            splitPoints.push_back(key);
+        }
+    }
+    return splitPoints;
+}
+
 /**
  * Checks if autobalance is enabled on the current sharded collection.
  */
@@ -318,16 +395,29 @@ void ChunkSplitter::_runAutosplit(std::shared_ptr<ChunkSplitStateDriver> chunkSp
                << " maxChunkSizeBytes: " << maxChunkSizeBytes;
 
         chunkSplitStateDriver->prepareSplit();
-        auto splitPoints = uassertStatusOK(splitVector(opCtx.get(),
-                                                       nss,
-                                                       shardKeyPattern.toBSON(),
-                                                       chunk.getMin(),
-                                                       chunk.getMax(),
-                                                       false,
-                                                       boost::none,
-                                                       boost::none,
-                                                       boost::none,
-                                                       maxChunkSizeBytes));
+
+        boost::optional<std::vector<BSONObj>> sampledSplitPoints;
+        if (autoSplitUseSampledSplitPoints.load()) {
+            sampledSplitPoints = chooseSampledSplitPoints(opCtx.get(),
+                                                          nss,
+                                                          *cm,
+                                                          chunk,
+                                                          chunkSplitStateDriver->getSampledKeys(),
+                                                          maxChunkSizeBytes);
+        }
+
+        auto splitPoints = sampledSplitPoints
+            ? std::move(*sampledSplitPoints)
+            : uassertStatusOK(splitVector(opCtx.get(),
+                                          nss,
+                                          shardKeyPattern.toBSON(),
+                                          chunk.getMin(),
+                                          chunk.getMax(),
+                                          false,
+                                          boost::none,
+                                          boost::none,
+                                          boost::none,
+                                          maxChunkSizeBytes));
 
         if (splitPoints.size() <= 1) {
             LOG(1)
@@ -36,6 +36,7 @@
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
@@ -43,8 +44,59 @@
 
 namespace mongo {
 
+OwnedChunkRanges::OwnedChunkRanges(const ChunkManager& cm, const ShardId& shardId)
+    : _ordering(Ordering::make(cm.getShardKeyPattern().toBSON())) {
+    for (const auto& chunk : cm.chunks()) {
+        if (chunk.getShardId() != shardId) {
+            continue;
+        }
+
+        auto max = _encode(chunk.getMax());
+        if (!_maxes.empty() && _maxes.back() == _encode(chunk.getMin())) {
+            // The chunk continues the previous owned range.
+            _maxes.back() = std::move(max);
+        } else {
+            _mins.push_back(_encode(chunk.getMin()));
+            _maxes.push_back(std::move(max));
+        }
+    }
+}
+
+bool OwnedChunkRanges::containsKey(const BSONObj& shardKey) const {
+    if (shardKey.isEmpty()) {
+        return false;
+    }
+
+    const auto key = _encode(shardKey);
+    const auto it = std::upper_bound(_maxes.begin(), _maxes.end(), key);
+    return it != _maxes.end() && _mins[it - _maxes.begin()] <= key;
+}
+
+std::string OwnedChunkRanges::_encode(const BSONObj& shardKey) const {
+    // KeyString interprets field names as discriminators, so strip them.
+    BSONObjBuilder strippedKey;
+    for (const auto& elem : shardKey) {
+        strippedKey.appendAs(elem, ""_sd);
+    }
+
+    KeyString ks(KeyString::Version::V1, strippedKey.done(), _ordering);
+    return {ks.getBuffer(), ks.getSize()};
+}
+
 CollectionMetadata::CollectionMetadata(std::shared_ptr<ChunkManager> cm, const ShardId& thisShardId)
-    : _cm(std::move(cm)), _thisShardId(thisShardId) {}
+    : _cm(std::move(cm)),
+      _thisShardId(thisShardId),
+      _ownedChunkRangesCache(_cm ? std::make_shared<OwnedChunkRangesCache>() : nullptr) {}
+
+std::shared_ptr<const OwnedChunkRanges> CollectionMetadata::getOwnedChunkRanges() const {
+    invariant(isSharded());
+
+    stdx::lock_guard<stdx::mutex> lk(_ownedChunkRangesCache->mutex);
+    if (!_ownedChunkRangesCache->ranges) {
+        _ownedChunkRangesCache->ranges = std::make_shared<OwnedChunkRanges>(*_cm, _thisShardId);
+    }
+    return _ownedChunkRangesCache->ranges;
+}
 
 BSONObj CollectionMetadata::extractDocumentKey(const BSONObj& doc) const {
     BSONObj key;
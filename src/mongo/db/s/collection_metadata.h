@@ -29,11 +29,53 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
+#include "mongo/bson/ordering.h"
 #include "mongo/db/range_arithmetic.h"
 #include "mongo/s/chunk_manager.h"
+#include "mongo/stdx/mutex.h"
 
 namespace mongo {
 
+/**
+ * The ranges of shard key values owned by one shard, with adjacent chunks merged, kept as two
+ * parallel sorted arrays of KeyString-encoded bounds. Deciding whether a key is owned is a single
+ * binary search over contiguous memory, without consulting the chunks of other shards or any
+ * chunk history.
+ *
+ * This class is immutable once constructed.
+ */
+class OwnedChunkRanges {
+public:
+    /**
+     * Collects the ranges owned by 'shardId' as of the cluster time of 'cm'.
+     */
+    OwnedChunkRanges(const ChunkManager& cm, const ShardId& shardId);
+
+    /**
+     * Returns true if 'shardKey' falls in one of the owned ranges. Returns false for an empty key.
+     */
+    bool containsKey(const BSONObj& shardKey) const;
+
+    /**
+     * Returns the number of disjoint ranges, after adjacent chunks were merged.
+     */
+    size_t numRanges() const {
+        return _mins.size();
+    }
+
+private:
+    std::string _encode(const BSONObj& shardKey) const;
+
+    const Ordering _ordering;
+
+    // The inclusive lower and exclusive upper bounds of the owned ranges, in ascending order.
+    std::vector<std::string> _mins;
+    std::vector<std::string> _maxes;
+};
+
 /**
  * The collection metadata has metadata information about a collection, in particular the
  * sharding information. It's main goal in life is to be capable of answering if a certain
@@ -158,6 +200,13 @@ public:
         return _cm->keyBelongsToShard(key, _thisShardId);
     }
 
+    /**
+     * Returns the ranges owned by this shard, for callers which check the ownership of many keys
+     * against the same metadata. The ranges are computed on the first call and shared by all
+     * copies of this metadata.
+     */
+    std::shared_ptr<const OwnedChunkRanges> getOwnedChunkRanges() const;
+
     /**
      * Given a key 'lookupKey' in the shard key range, get the next chunk which overlaps or is
      * greater than this key.  Returns true if a chunk exists, false otherwise.
@@ -217,6 +266,14 @@ private:
     // The identity of this shard, for the purpose of answering "key belongs to me" queries. If the
     // collection is not sharded (_cm is nullptr), then this value will be empty.
     ShardId _thisShardId;
+
+    // Holds the ranges owned by this shard once they have been computed. Is nullptr if the
+    // collection is not sharded.
+    struct OwnedChunkRangesCache {
+        stdx::mutex mutex;
+        std::shared_ptr<const OwnedChunkRanges> ranges;
+    };
+    std::shared_ptr<OwnedChunkRangesCache> _ownedChunkRangesCache;
 };
 
 }  // namespace mongo
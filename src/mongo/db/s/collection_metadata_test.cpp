@@ -347,6 +347,31 @@ TEST_F(ThreeChunkWithRangeGapFixture, KeyBelongsToMe) {
     ASSERT(!makeCollectionMetadata()->keyBelongsToMe(BSONObj()));
 }
 
+TEST_F(ThreeChunkWithRangeGapFixture, OwnedChunkRanges) {
+    auto metadata(makeCollectionMetadata());
+    auto ranges = metadata->getOwnedChunkRanges();
+
+    // The two adjacent chunks at the start are merged into one range.
+    ASSERT_EQ(2U, ranges->numRanges());
+    ASSERT(ranges == metadata->getOwnedChunkRanges());
+
+    for (const auto& key : {BSON("a" << MINKEY),
+                            BSON("a" << 5),
+                            BSON("a" << 10),
+                            BSON("a" << 19),
+                            BSON("a" << 20),
+                            BSON("a" << 25),
+                            BSON("a" << 30),
+                            BSON("a" << 40),
+                            BSON("a" << MAXKEY),
+                            BSON("a"
+                                 << "string")}) {
+        ASSERT_EQ(metadata->keyBelongsToMe(key), ranges->containsKey(key)) << key;
+    }
+
+    ASSERT(!ranges->containsKey(BSONObj()));
+}
+
 TEST_F(ThreeChunkWithRangeGapFixture, GetNextChunkFromBeginning) {
     ChunkType nextChunk;
     ASSERT(
@@ -391,5 +416,11 @@ TEST_F(StaleChunkFixture, KeyBelongsToMe) {
                        ErrorCodes::StaleChunkHistory);
 }
 
+TEST_F(StaleChunkFixture, OwnedChunkRanges) {
+    ASSERT_THROWS_CODE(makeCollectionMetadata()->getOwnedChunkRanges(),
+                       AssertionException,
+                       ErrorCodes::StaleChunkHistory);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -74,6 +74,62 @@ const WriteConcernOptions kMajorityWriteConcern(WriteConcernOptions::kMajority,
                                                 WriteConcernOptions::SyncMode::UNSET,
                                                 WriteConcernOptions::kWriteConcernTimeoutSharding);
 
+/**
+ * Deletes up to 'maxToDelete' documents whose entries in the index 'descriptor' fall in
+ * [min, max), all within a single WriteUnitOfWork. The RecordIds are gathered with an index scan
+ * first and the documents are then removed in RecordId order, so that the record store is walked
+ * sequentially. Every document still gets its own fromMigrate oplog entry.
+ *
+ * Returns the number of documents deleted.
+ */
+int deleteBatchInRecordIdOrder(OperationContext* opCtx,
+                               Collection* collection,
+                               const IndexDescriptor* descriptor,
+                               const BSONObj& min,
+                               const BSONObj& max,
+                               int maxToDelete) {
+    return writeConflictRetry(opCtx, "range deletion", collection->ns().ns(), [&] {
+        WriteUnitOfWork wuow(opCtx);
+
+        std::vector<RecordId> recordIds;
+        {
+            auto exec = InternalPlanner::indexScan(opCtx,
+                                                   collection,
+                                                   descriptor,
+                                                   min,
+                                                   max,
+                                                   BoundInclusion::kIncludeStartKeyOnly,
+                                                   PlanExecutor::NO_YIELD,
+                                                   InternalPlanner::FORWARD);
+
+            BSONObj obj;
+            RecordId rid;
+            PlanExecutor::ExecState state = PlanExecutor::ADVANCED;
+            while (recordIds.size() < static_cast<size_t>(maxToDelete) &&
+                   PlanExecutor::ADVANCED == (state = exec->getNext(&obj, &rid))) {
+                recordIds.push_back(rid);
+            }
+
+            if (state == PlanExecutor::FAILURE) {
+                uassertStatusOK(WorkingSetCommon::getMemberObjectStatus(obj).withContext(
+                    str::stream() << "cursor error while trying to delete " << redact(min)
+                                  << " to "
+                                  << redact(max)
+                                  << " in "
+                                  << collection->ns()));
+            }
+        }
+
+        std::sort(recordIds.begin(), recordIds.end());
+        for (const auto& rid : recordIds) {
+            collection->deleteDocument(opCtx, kUninitializedStmtId, rid, nullptr, true);
+        }
+
+        wuow.commit();
+        return static_cast<int>(recordIds.size());
+    });
+}
+
 boost::optional<DeleteNotification> checkOverlap(std::list<Deletion> const& deletions,
                                                  ChunkRange const& range) {
     // Start search with newest entries by using reverse iterators
@@ -372,6 +428,13 @@ StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
         return {ErrorCodes::InternalError, msg};
     }
 
+    if (rangeDeleterBatchedWrites.load() && !serverGlobalParams.moveParanoia) {
+        const auto numDeleted =
+            deleteBatchInRecordIdOrder(opCtx, collection, descriptor, min, max, maxToDelete);
+        ShardingStatistics::get(opCtx).countDocsDeletedOnDonor.addAndFetch(numDeleted);
+        return numDeleted;
+    }
+
     auto deleteStageParams = std::make_unique<DeleteStageParams>();
     deleteStageParams->fromMigrate = true;
     deleteStageParams->isMulti = true;
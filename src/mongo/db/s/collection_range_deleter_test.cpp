@@ -40,12 +40,14 @@
 #include "mongo/db/keypattern.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/s/collection_sharding_runtime.h"
+#include "mongo/db/s/sharding_runtime_d_params_gen.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/s/balancer_configuration.h"
 #include "mongo/s/chunk_version.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/shard_server_test_fixture.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -232,6 +234,39 @@ TEST_F(CollectionRangeDeleterTest, MultipleCleanupNextRangeCalls) {
     ASSERT_EQUALS(0ULL, dbclient.count(kAdminSysVer.ns(), BSON(kShardKey << "startRangeDeletion")));
 }
 
+// Tests that a batch deletes exactly the requested number of documents in the range, whether or not
+// the documents of a batch are deleted within a single storage transaction.
+TEST_F(CollectionRangeDeleterTest, BatchDeletesOnlyDocumentsInRange) {
+    for (bool batchedWrites : {true, false}) {
+        const bool wasBatchedWrites = rangeDeleterBatchedWrites.load();
+        rangeDeleterBatchedWrites.store(batchedWrites);
+        ON_BLOCK_EXIT([&] { rangeDeleterBatchedWrites.store(wasBatchedWrites); });
+
+        CollectionRangeDeleter rangeDeleter;
+        DBDirectClient dbclient(operationContext());
+        for (int key = 10; key >= 0; --key) {
+            dbclient.insert(kNss.toString(), BSON(kShardKey << key));
+        }
+
+        std::list<Deletion> ranges;
+        ranges.emplace_back(
+            Deletion{ChunkRange(BSON(kShardKey << 0), BSON(kShardKey << 10)), Date_t{}});
+        rangeDeleter.add(std::move(ranges));
+
+        ASSERT_TRUE(next(rangeDeleter, 4));
+        ASSERT_EQUALS(7ULL, dbclient.count(kNss.toString(), BSONObj()));
+
+        ASSERT_TRUE(next(rangeDeleter, 100));
+        ASSERT_TRUE(next(rangeDeleter, 100));
+        ASSERT_TRUE(rangeDeleter.isEmpty());
+        ASSERT_EQUALS(1ULL, dbclient.count(kNss.toString(), BSONObj()));
+        ASSERT_BSONOBJ_EQ(BSON(kShardKey << 10),
+                          dbclient.findOne(kNss.toString(), QUERY(kShardKey << 10)));
+
+        dbclient.remove(kNss.toString(), BSONObj());
+    }
+}
+
 // Tests the case that there are two ranges to clean, each containing multiple documents.
 TEST_F(CollectionRangeDeleterTest, MultipleDocumentsInMultipleRangesToClean) {
     CollectionRangeDeleter rangeDeleter;
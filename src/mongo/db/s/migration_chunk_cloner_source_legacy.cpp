@@ -525,22 +525,42 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
                            internalQueryExecYieldIterations.load(),
                            Milliseconds(internalQueryExecYieldPeriodMS.load()));
 
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-    auto iter = _cloneLocs.begin();
+    // The recipient may fetch batches in several concurrent streams, so claim the record ids of
+    // this batch up front. Those which do not fit in the batch are put back afterwards.
+    std::vector<RecordId> claimedLocs;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+        const auto remainingBytes = std::max(BSONObjMaxUserSize - arrBuilder->len(), 0);
+        const auto numToClaim = std::min(
+            _cloneLocs.size(),
+            static_cast<size_t>(remainingBytes / std::max<uint64_t>(_averageObjectSizeForCloneLocs,
+                                                                    1)) +
+                1);
+
+        auto end = _cloneLocs.begin();
+        std::advance(end, numToClaim);
+        claimedLocs.assign(_cloneLocs.begin(), end);
+        _cloneLocs.erase(_cloneLocs.begin(), end);
+    }
+
+    auto iter = claimedLocs.begin();
+    ON_BLOCK_EXIT([&] {
+        if (iter != claimedLocs.end()) {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _cloneLocs.insert(iter, claimedLocs.end());
+        }
+    });
 
-    for (; iter != _cloneLocs.end(); ++iter) {
+    for (; iter != claimedLocs.end(); ++iter) {
         // We must always make progress in this method by at least one document because empty return
         // indicates there is no more initial clone data.
         if (arrBuilder->arrSize() && tracker.intervalHasElapsed()) {
             break;
         }
 
-        auto nextRecordId = *iter;
-
-        lk.unlock();
-
         Snapshotted<BSONObj> doc;
-        if (collection->findDoc(opCtx, nextRecordId, &doc)) {
+        if (collection->findDoc(opCtx, *iter, &doc)) {
             // Use the builder size instead of accumulating the document sizes directly so
             // that we take into consideration the overhead of BSONArray indices.
             if (arrBuilder->arrSize() &&
@@ -551,12 +571,8 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
             arrBuilder->append(doc.value());
             ShardingStatistics::get(opCtx).countDocsClonedOnDonor.addAndFetch(1);
         }
-
-        lk.lock();
     }
 
-    _cloneLocs.erase(_cloneLocs.begin(), iter);
-
     return Status::OK();
 }
 
@@ -84,6 +84,38 @@ const WriteConcernOptions kMajorityWriteConcern(WriteConcernOptions::kMajority,
                                                 WriteConcernOptions::SyncMode::UNSET,
                                                 -1);
 
+/**
+ * Limits the rate at which the cloning step of a migration inserts documents, across all of its
+ * streams.
+ */
+class CloneThrottle {
+public:
+    /**
+     * Accounts for 'bytes' more cloned bytes and waits until they fit the 'bytesPerSecond' budget.
+     * Does not wait if 'bytesPerSecond' is not positive.
+     */
+    void waitForBudget(OperationContext* opCtx, long long bytes, long long bytesPerSecond) {
+        if (bytesPerSecond <= 0) {
+            return;
+        }
+
+        const auto deadline = [&] {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _budgetAvailableAt = std::max(_budgetAvailableAt, Date_t::now()) +
+                Microseconds(bytes * 1000 * 1000 / bytesPerSecond);
+            return _budgetAvailableAt;
+        }();
+
+        opCtx->sleepUntil(deadline);
+    }
+
+private:
+    stdx::mutex _mutex;
+
+    // The time until which the bytes cloned so far use up the budget.
+    Date_t _budgetAvailableAt;
+};
+
 /**
  * Returns a human-readabale name of the migration manager's state.
  */
@@ -379,7 +411,84 @@ Status MigrationDestinationManager::start(OperationContext* opCtx,
 void MigrationDestinationManager::cloneDocumentsFromDonor(
     OperationContext* opCtx,
     stdx::function<void(OperationContext*, BSONObj)> insertBatchFn,
-    stdx::function<BSONObj(OperationContext*)> fetchBatchFn) {
+    stdx::function<BSONObj(OperationContext*)> fetchBatchFn,
+    int numStreams) {
+    if (numStreams <= 1) {
+        _cloneDocumentsFromDonorStream(opCtx, insertBatchFn, fetchBatchFn);
+        return;
+    }
+
+    // The calling thread runs one of the streams and the others run on their own threads. The
+    // first stream to fail interrupts the others, and its error is the one which is reported.
+    stdx::mutex mutex;
+    Status firstError = Status::OK();
+    std::vector<OperationContext*> streamOpCtxs;
+
+    const auto interruptStreams = [&](WithLock) {
+        for (auto streamOpCtx : streamOpCtxs) {
+            stdx::lock_guard<Client> lk(*streamOpCtx->getClient());
+            streamOpCtx->getServiceContext()->killOperation(
+                lk, streamOpCtx, ErrorCodes::Interrupted);
+        }
+    };
+
+    std::vector<stdx::thread> streamThreads;
+    for (int i = 1; i < numStreams; ++i) {
+        streamThreads.emplace_back([&, i] {
+            ThreadClient tc(str::stream() << "chunkCloner-" << i, opCtx->getServiceContext());
+            auto streamOpCtx = Client::getCurrent()->makeOperationContext();
+            {
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                if (!firstError.isOK()) {
+                    return;
+                }
+                streamOpCtxs.push_back(streamOpCtx.get());
+            }
+            ON_BLOCK_EXIT([&] {
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                streamOpCtxs.erase(
+                    std::find(streamOpCtxs.begin(), streamOpCtxs.end(), streamOpCtx.get()));
+            });
+
+            try {
+                _cloneDocumentsFromDonorStream(streamOpCtx.get(), insertBatchFn, fetchBatchFn);
+            } catch (const DBException& ex) {
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                if (firstError.isOK()) {
+                    firstError = ex.toStatus();
+                    log() << "Chunk cloning stream failed " << causedBy(redact(firstError));
+
+                    stdx::lock_guard<Client> clientLock(*opCtx->getClient());
+                    opCtx->getServiceContext()->killOperation(
+                        clientLock, opCtx, ErrorCodes::Error(51008));
+                    interruptStreams(lk);
+                }
+            }
+        });
+    }
+
+    try {
+        _cloneDocumentsFromDonorStream(opCtx, insertBatchFn, fetchBatchFn);
+    } catch (const DBException& ex) {
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        if (firstError.isOK()) {
+            firstError = ex.toStatus();
+            interruptStreams(lk);
+        }
+    }
+
+    for (auto& streamThread : streamThreads) {
+        streamThread.join();
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(mutex);
+    uassertStatusOK(firstError);
+}
+
+void MigrationDestinationManager::_cloneDocumentsFromDonorStream(
+    OperationContext* opCtx,
+    const stdx::function<void(OperationContext*, BSONObj)>& insertBatchFn,
+    const stdx::function<BSONObj(OperationContext*)>& fetchBatchFn) {
 
     SingleProducerSingleConsumerQueue<BSONObj>::Options options;
     options.maxQueueDepth = 1;
@@ -788,6 +897,8 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx) {
             uassert(50748, "Migration aborted while copying documents", getState() != ABORT);
         };
 
+        CloneThrottle cloneThrottle;
+
         auto insertBatchFn = [&](OperationContext* opCtx, BSONObj arr) {
             auto it = arr.begin();
             while (it != arr.end()) {
@@ -842,7 +953,12 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx) {
                     }
                 }
 
-                sleepmillis(migrateCloneInsertionBatchDelayMS.load());
+                const auto bytesPerSecond = migrateCloneBytesPerSecond.load();
+                if (bytesPerSecond > 0) {
+                    cloneThrottle.waitForBudget(opCtx, batchClonedBytes, bytesPerSecond);
+                } else {
+                    sleepmillis(migrateCloneInsertionBatchDelayMS.load());
+                }
             }
         };
 
@@ -861,7 +977,7 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx) {
             return res.response;
         };
 
-        cloneDocumentsFromDonor(opCtx, insertBatchFn, fetchBatchFn);
+        cloneDocumentsFromDonor(opCtx, insertBatchFn, fetchBatchFn, migrateCloneStreams.load());
 
         timing.done(3);
         MONGO_FAIL_POINT_PAUSE_WHILE_SET(migrateThreadHangAtStep3);
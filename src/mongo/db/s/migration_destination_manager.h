@@ -109,12 +109,15 @@ public:
                  const WriteConcernOptions& writeConcern);
 
     /**
-     * Clones documents from a donor shard.
+     * Clones documents from a donor shard, in 'numStreams' concurrent streams which each fetch
+     * batches and insert them until the donor returns an empty batch. With more than one stream,
+     * 'insertBatchFn' and 'fetchBatchFn' are called concurrently from several threads.
      */
     static void cloneDocumentsFromDonor(
         OperationContext* opCtx,
         stdx::function<void(OperationContext*, BSONObj)> insertBatchFn,
-        stdx::function<BSONObj(OperationContext*)> fetchBatchFn);
+        stdx::function<BSONObj(OperationContext*)> fetchBatchFn,
+        int numStreams = 1);
 
     /**
      * Idempotent method, which causes the current ongoing migration to abort only if it has the
@@ -138,6 +141,16 @@ public:
                                                  const ShardId& fromShardId);
 
 private:
+    /**
+     * Runs a single stream of cloneDocumentsFromDonor on the calling thread. Batches are fetched
+     * on the calling thread and inserted on a separate thread, so that fetching the next batch
+     * overlaps with inserting the previous one.
+     */
+    static void _cloneDocumentsFromDonorStream(
+        OperationContext* opCtx,
+        const stdx::function<void(OperationContext*, BSONObj)>& insertBatchFn,
+        const stdx::function<BSONObj(OperationContext*)>& fetchBatchFn);
+
     /**
      * These log the argument msg; then, under lock, move msg to _errmsg and set the state to FAIL.
      * The setStateWailWarn version logs with "warning() << msg".
@@ -29,6 +29,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+
 #include "mongo/db/s/migration_destination_manager.h"
 #include "mongo/s/shard_server_test_fixture.h"
 #include "mongo/unittest/unittest.h"
@@ -157,5 +159,67 @@ TEST_F(MigrationDestinationManagerTest, CloneDocumentsCatchesInsertErrors) {
     ASSERT_EQ(operationContext()->getKillStatus(), 51008);
 }
 
+// Tests that concurrent streams together clone every document exactly once.
+TEST_F(MigrationDestinationManagerTest, CloneDocumentsFromDonorInMultipleStreams) {
+    const int kNumBatches = 20;
+
+    stdx::mutex mutex;
+    int nextBatch = 0;
+    std::vector<BSONObj> resultDocs;
+
+    auto fetchBatchFn = [&](OperationContext* opCtx) {
+        BSONArrayBuilder batchBuilder;
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            if (nextBatch < kNumBatches) {
+                batchBuilder.append(createDocument(nextBatch++));
+            }
+        }
+        return BSON("objects" << batchBuilder.arr());
+    };
+
+    auto insertBatchFn = [&](OperationContext* opCtx, BSONObj docs) {
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        for (auto&& docToClone : docs) {
+            resultDocs.push_back(docToClone.Obj().getOwned());
+        }
+    };
+
+    MigrationDestinationManager::cloneDocumentsFromDonor(
+        operationContext(), insertBatchFn, fetchBatchFn, 4);
+
+    ASSERT_EQ(static_cast<size_t>(kNumBatches), resultDocs.size());
+    std::sort(resultDocs.begin(), resultDocs.end(), [](const BSONObj& a, const BSONObj& b) {
+        return a["_id"].numberInt() < b["_id"].numberInt();
+    });
+    for (int i = 0; i < kNumBatches; ++i) {
+        ASSERT_BSONOBJ_EQ(createDocument(i), resultDocs[i]);
+    }
+}
+
+// Tests that an exception in the fetch logic of any stream is thrown on the main thread.
+TEST_F(MigrationDestinationManagerTest, CloneDocumentsInMultipleStreamsThrowsFetchErrors) {
+    stdx::mutex mutex;
+    int numFetches = 0;
+
+    auto fetchBatchFn = [&](OperationContext* opCtx) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            if (++numFetches > 6) {
+                uasserted(ErrorCodes::NetworkTimeout, "network error");
+            }
+        }
+        return BSON("objects" << createDocumentsToCloneArray());
+    };
+
+    auto insertBatchFn = [&](OperationContext* opCtx, BSONObj docs) {};
+
+    ASSERT_THROWS_CODE_AND_WHAT(MigrationDestinationManager::cloneDocumentsFromDonor(
+                                    operationContext(), insertBatchFn, fetchBatchFn, 3),
+                                DBException,
+                                ErrorCodes::NetworkTimeout,
+                                "network error");
+}
+
 }  // namespace
 }  // namespace mongo
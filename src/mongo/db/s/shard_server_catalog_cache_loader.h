@@ -44,6 +44,12 @@ namespace mongo {
  * If a shard primary, retrieves chunk metadata from the config server and maintains a persisted
  * copy of that chunk metadata so shard secondaries can access the metadata. If a shard secondary,
  * retrieves chunk metadata from the shard persisted chunk metadata.
+ *
+ * Refreshes are incremental, including the first one after a restart: a primary asks the config
+ * server only for the chunks newer than the highest version it has persisted (or enqueued), and
+ * answers the CatalogCache from the persisted chunks newer than the version the CatalogCache
+ * already has. The CatalogCache builds each collection's routing table on its first use, so a
+ * restart does not reload the metadata of collections which are not accessed.
  */
 class ShardServerCatalogCacheLoader : public CatalogCacheLoader {
     ShardServerCatalogCacheLoader(const ShardServerCatalogCacheLoader&) = delete;
@@ -33,8 +33,16 @@
 
 #include "mongo/db/s/transaction_coordinator.h"
 
+#include <algorithm>
+#include <array>
+
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/logical_clock.h"
+#include "mongo/db/server_options.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/bits.h"
 #include "mongo/util/log.h"
+#include "mongo/util/tick_source.h"
 
 namespace mongo {
 namespace {
@@ -44,6 +52,106 @@ using CoordinatorCommitDecision = txn::CoordinatorCommitDecision;
 using PrepareVoteConsensus = txn::PrepareVoteConsensus;
 using TransactionCoordinatorDocument = txn::TransactionCoordinatorDocument;
 
+/**
+ * Cumulative latency histograms for the steps of the two-phase commit sequence, across all the
+ * coordinators which ran on this node. Steps which a coordinator skips, because it was recovered
+ * on step-up past them, and steps which fail are not recorded.
+ */
+class CoordinatorStepLatencies {
+public:
+    enum Step {
+        kWritingParticipantList,
+        kWaitingForVotes,
+        kWritingDecision,
+        kWaitingForDecisionAcks,
+        kDeletingCoordinatorDoc,
+        kNumSteps
+    };
+
+    void record(Step step, Microseconds latency) {
+        const auto micros = std::max(durationCount<Microseconds>(latency), 0LL);
+
+        // Bucket 0 counts zero latencies and bucket i > 0 counts those in [2^(i-1), 2^i).
+        const int bucket = micros == 0
+            ? 0
+            : std::min(64 - countLeadingZeros64(static_cast<unsigned long long>(micros)),
+                       kNumBuckets - 1);
+
+        auto& stepData = _steps[step];
+        stepData.count.fetchAndAdd(1);
+        stepData.totalMicros.fetchAndAdd(micros);
+        stepData.buckets[bucket].fetchAndAdd(1);
+    }
+
+    void report(BSONObjBuilder* builder) const {
+        static constexpr StringData kStepNames[kNumSteps] = {"writingParticipantList"_sd,
+                                                             "waitingForVotes"_sd,
+                                                             "writingDecision"_sd,
+                                                             "waitingForDecisionAcks"_sd,
+                                                             "deletingCoordinatorDoc"_sd};
+
+        for (int step = 0; step < kNumSteps; ++step) {
+            const auto& stepData = _steps[step];
+
+            BSONObjBuilder stepBuilder(builder->subobjStart(kStepNames[step]));
+            stepBuilder.append("count", stepData.count.load());
+            stepBuilder.append("totalMicros", stepData.totalMicros.load());
+
+            BSONArrayBuilder histogramBuilder(stepBuilder.subarrayStart("histogram"));
+            for (int bucket = 0; bucket < kNumBuckets; ++bucket) {
+                const auto count = stepData.buckets[bucket].load();
+                if (count == 0) {
+                    continue;
+                }
+                const long long lowerBound = bucket == 0 ? 0 : 1LL << (bucket - 1);
+                histogramBuilder.append(BSON("micros" << lowerBound << "count" << count));
+            }
+        }
+    }
+
+private:
+    static constexpr int kNumBuckets = 40;
+
+    struct StepData {
+        AtomicWord<long long> count;
+        AtomicWord<long long> totalMicros;
+        std::array<AtomicWord<long long>, kNumBuckets> buckets;
+    };
+
+    std::array<StepData, kNumSteps> _steps;
+};
+
+CoordinatorStepLatencies coordinatorStepLatencies;
+
+/**
+ * Records how long a step of the two-phase commit sequence took, given the tick at which it began.
+ */
+void recordStepLatency(ServiceContext* serviceContext,
+                       CoordinatorStepLatencies::Step step,
+                       TickSource::Tick stepStart) {
+    auto tickSource = serviceContext->getTickSource();
+    coordinatorStepLatencies.record(
+        step, tickSource->ticksTo<Microseconds>(tickSource->getTicks() - stepStart));
+}
+
+class TransactionCoordinatorServerStatus final : public ServerStatusSection {
+public:
+    TransactionCoordinatorServerStatus() : ServerStatusSection("twoPhaseCommitCoordinator") {}
+
+    bool includeByDefault() const override {
+        return serverGlobalParams.clusterRole == ClusterRole::ShardServer;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder result;
+        BSONObjBuilder stepLatenciesBuilder(result.subobjStart("stepLatencies"));
+        coordinatorStepLatencies.report(&stepLatenciesBuilder);
+        stepLatenciesBuilder.doneFast();
+        return result.obj();
+    }
+} transactionCoordinatorServerStatus;
+
 }  // namespace
 
 TransactionCoordinator::TransactionCoordinator(ServiceContext* serviceContext,
@@ -96,9 +204,14 @@ TransactionCoordinator::TransactionCoordinator(ServiceContext* serviceContext,
                     return Future<void>::makeReady();
             }
 
+            const auto stepStart = _serviceContext->getTickSource()->getTicks();
             return txn::persistParticipantsList(
                        *_sendPrepareScheduler, _lsid, _txnNumber, *_participants)
-                .then([this] {
+                .then([this, stepStart] {
+                    recordStepLatency(_serviceContext,
+                                      CoordinatorStepLatencies::kWritingParticipantList,
+                                      stepStart);
+
                     stdx::lock_guard<stdx::mutex> lg(_mutex);
                     _participantsDurable = true;
                 });
@@ -117,9 +230,13 @@ TransactionCoordinator::TransactionCoordinator(ServiceContext* serviceContext,
                     return Future<void>::makeReady();
             }
 
+            const auto stepStart = _serviceContext->getTickSource()->getTicks();
             return txn::sendPrepare(
                        _serviceContext, *_sendPrepareScheduler, _lsid, _txnNumber, *_participants)
-                .then([this](PrepareVoteConsensus consensus) mutable {
+                .then([this, stepStart](PrepareVoteConsensus consensus) mutable {
+                    recordStepLatency(
+                        _serviceContext, CoordinatorStepLatencies::kWaitingForVotes, stepStart);
+
                     {
                         stdx::lock_guard<stdx::mutex> lg(_mutex);
                         _decision = consensus.decision();
@@ -150,12 +267,16 @@ TransactionCoordinator::TransactionCoordinator(ServiceContext* serviceContext,
                     return Future<void>::makeReady();
             }
 
+            const auto stepStart = _serviceContext->getTickSource()->getTicks();
             return txn::persistDecision(*_scheduler,
                                         _lsid,
                                         _txnNumber,
                                         *_participants,
                                         _decision->getCommitTimestamp())
-                .then([this] {
+                .then([this, stepStart] {
+                    recordStepLatency(
+                        _serviceContext, CoordinatorStepLatencies::kWritingDecision, stepStart);
+
                     stdx::lock_guard<stdx::mutex> lg(_mutex);
                     _decisionDurable = true;
                 });
@@ -171,28 +292,44 @@ TransactionCoordinator::TransactionCoordinator(ServiceContext* serviceContext,
 
             _decisionPromise.emplaceValue(_decision->getDecision());
 
-            switch (_decision->getDecision()) {
-                case CommitDecision::kCommit:
-                    return txn::sendCommit(_serviceContext,
-                                           *_scheduler,
-                                           _lsid,
-                                           _txnNumber,
-                                           *_participants,
-                                           *_decision->getCommitTimestamp());
-                case CommitDecision::kAbort:
-                    return txn::sendAbort(
-                        _serviceContext, *_scheduler, _lsid, _txnNumber, *_participants);
-                default:
-                    MONGO_UNREACHABLE;
-            };
+            const auto stepStart = _serviceContext->getTickSource()->getTicks();
+            auto sendDecisionFuture = [&] {
+                switch (_decision->getDecision()) {
+                    case CommitDecision::kCommit:
+                        return txn::sendCommit(_serviceContext,
+                                               *_scheduler,
+                                               _lsid,
+                                               _txnNumber,
+                                               *_participants,
+                                               *_decision->getCommitTimestamp());
+                    case CommitDecision::kAbort:
+                        return txn::sendAbort(
+                            _serviceContext, *_scheduler, _lsid, _txnNumber, *_participants);
+                    default:
+                        MONGO_UNREACHABLE;
+                };
+            }();
+
+            return std::move(sendDecisionFuture).then([this, stepStart] {
+                recordStepLatency(
+                    _serviceContext, CoordinatorStepLatencies::kWaitingForDecisionAcks, stepStart);
+            });
         })
         .onCompletion([this](Status s) {
             // Do a best-effort attempt to delete the coordinator document from disk, regardless of
             // the success of the commit sequence.
             LOG(3) << "Two-phase commit completed for " << _lsid.getId() << ':' << _txnNumber;
 
+            const auto stepStart = _serviceContext->getTickSource()->getTicks();
             return txn::deleteCoordinatorDoc(*_scheduler, _lsid, _txnNumber)
-                .onCompletion([ this, chainStatus = std::move(s) ](Status deleteDocStatus) {
+                .onCompletion([ this, stepStart, chainStatus = std::move(s) ](
+                    Status deleteDocStatus) {
+                    if (deleteDocStatus.isOK()) {
+                        recordStepLatency(_serviceContext,
+                                          CoordinatorStepLatencies::kDeletingCoordinatorDoc,
+                                          stepStart);
+                    }
+
                     if (_participantsDurable) {
                         LOG(0) << redact(deleteDocStatus);
                     }
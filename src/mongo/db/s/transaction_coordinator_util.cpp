@@ -33,14 +33,20 @@
 
 #include "mongo/db/s/transaction_coordinator_util.h"
 
+#include <algorithm>
+#include <memory>
+
 #include "mongo/client/remote_command_retry_scheduler.h"
 #include "mongo/db/commands/txn_cmds_gen.h"
 #include "mongo/db/commands/txn_two_phase_commit_cmds_gen.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/ops/write_ops.h"
 #include "mongo/db/repl/repl_client_info.h"
+#include "mongo/db/s/transaction_coordinator_params_gen.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 
@@ -100,6 +106,144 @@ bool shouldRetryPersistingCoordinatorState(const Status& responseStatus) {
     return responseStatus == ErrorCodes::Interrupted;
 }
 
+/**
+ * Groups the coordinator document updates issued concurrently by different coordinators into a
+ * single unordered update command followed by a single majority write concern wait.
+ *
+ * The first caller to find no batch in flight becomes the leader and writes every update queued
+ * at that point, including its own. Callers which arrive while a batch is in flight queue up for
+ * the next one. A leader never reports errors for individual updates; an update which did not
+ * provably succeed is reported as not written, and its caller is expected to redo it on its own,
+ * which is safe because the coordinator document updates are idempotent.
+ */
+class CoordinatorDocumentWriteBatcher {
+public:
+    /**
+     * Returns true if 'entry' was applied and majority committed as part of a batch, or false if
+     * the caller must apply it individually. Throws if 'opCtx' is interrupted while waiting.
+     */
+    bool write(OperationContext* opCtx, write_ops::UpdateOpEntry entry) {
+        auto request = std::make_shared<Request>(std::move(entry));
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _pending.push_back(request);
+
+        while (!request->done) {
+            if (!_batchInProgress) {
+                _batchInProgress = true;
+                auto batch = std::move(_pending);
+                _pending.clear();
+
+                lk.unlock();
+                _writeBatch(opCtx, batch);
+                lk.lock();
+
+                for (auto& batchRequest : batch) {
+                    batchRequest->done = true;
+                }
+                _batchInProgress = false;
+                _cv.notify_all();
+                continue;
+            }
+
+            try {
+                opCtx->waitForConditionOrInterrupt(
+                    _cv, lk, [&] { return request->done || !_batchInProgress; });
+            } catch (const DBException&) {
+                // Withdraw the update unless a leader has already picked it up.
+                _pending.erase(std::remove(_pending.begin(), _pending.end(), request),
+                               _pending.end());
+                throw;
+            }
+        }
+
+        return request->written;
+    }
+
+private:
+    struct Request {
+        explicit Request(write_ops::UpdateOpEntry entry) : entry(std::move(entry)) {}
+
+        const write_ops::UpdateOpEntry entry;
+
+        // Both are protected by the batcher's mutex until 'done' is set.
+        bool done{false};
+        bool written{false};
+    };
+
+    using Batch = std::vector<std::shared_ptr<Request>>;
+
+    static void _writeBatch(OperationContext* opCtx, const Batch& batch) {
+        try {
+            DBDirectClient client(opCtx);
+
+            const auto commandResponse = client.runCommand([&] {
+                write_ops::Update updateOp(NamespaceString::kTransactionCoordinatorsNamespace);
+                updateOp.setWriteCommandBase([] {
+                    write_ops::WriteCommandBase base;
+                    base.setOrdered(false);
+                    return base;
+                }());
+
+                std::vector<write_ops::UpdateOpEntry> updates;
+                updates.reserve(batch.size());
+                for (const auto& request : batch) {
+                    updates.push_back(request->entry);
+                }
+                updateOp.setUpdates(std::move(updates));
+                return updateOp.serialize({});
+            }());
+
+            const auto commandReply = commandResponse->getCommandReply();
+            uassertStatusOK(getStatusFromCommandResult(commandReply));
+
+            std::vector<bool> failed(batch.size(), false);
+            size_t numFailed = 0;
+            for (const auto& writeError : commandReply.getObjectField("writeErrors")) {
+                const auto index = writeError.Obj()["index"].numberInt();
+                if (index >= 0 && static_cast<size_t>(index) < batch.size() && !failed[index]) {
+                    failed[index] = true;
+                    ++numFailed;
+                }
+            }
+
+            // Every update is expected to match (or upsert) exactly one document. The reply does
+            // not say which of them did, so if any did not, they are all redone individually.
+            if (commandReply.getIntField("n") != static_cast<int>(batch.size() - numFailed)) {
+                return;
+            }
+
+            WriteConcernResult unusedWCResult;
+            uassertStatusOK(
+                waitForWriteConcern(opCtx,
+                                    repl::ReplClientInfo::forClient(opCtx->getClient()).getLastOp(),
+                                    kMajorityWriteConcern,
+                                    &unusedWCResult));
+
+            for (size_t i = 0; i < batch.size(); ++i) {
+                batch[i]->written = !failed[i];
+            }
+
+            LOG(3) << "Wrote batch of " << batch.size() << " coordinator document updates with "
+                   << numFailed << " failures";
+        } catch (const DBException& ex) {
+            LOG(3) << "Failed to write batch of " << batch.size()
+                   << " coordinator document updates: " << redact(ex);
+        }
+    }
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _cv;
+
+    // Updates queued for the next batch
+    Batch _pending;
+
+    // Whether some caller is currently writing a batch
+    bool _batchInProgress{false};
+};
+
+CoordinatorDocumentWriteBatcher coordinatorDocumentWriteBatcher;
+
 }  // namespace
 
 namespace {
@@ -118,35 +262,44 @@ void persistParticipantListBlocking(OperationContext* opCtx,
     sessionInfo.setSessionId(lsid);
     sessionInfo.setTxnNumber(txnNumber);
 
+    const auto updateEntry = [&] {
+        write_ops::UpdateOpEntry entry;
+
+        // Ensure that the document for the (lsid, txnNumber) either has no participant list or
+        // has the same participant list. The document may have the same participant list if an
+        // earlier attempt to write the participant list failed waiting for writeConcern.
+        BSONObj noParticipantList = BSON(TransactionCoordinatorDocument::kParticipantsFieldName
+                                         << BSON("$exists" << false));
+        BSONObj sameParticipantList =
+            BSON("$and" << buildParticipantListMatchesConditions(participantList));
+        entry.setQ(BSON(TransactionCoordinatorDocument::kIdFieldName
+                        << sessionInfo.toBSON()
+                        << "$or"
+                        << BSON_ARRAY(noParticipantList << sameParticipantList)));
+
+        // Update with participant list.
+        TransactionCoordinatorDocument doc;
+        doc.setId(sessionInfo);
+        doc.setParticipants(participantList);
+        entry.setU(doc.toBSON());
+
+        entry.setUpsert(true);
+        return entry;
+    }();
+
+    if (gCoordinatorBatchedDocumentWrites.load() &&
+        coordinatorDocumentWriteBatcher.write(opCtx, updateEntry)) {
+        LOG(3) << "Wrote participant list for " << lsid.getId() << ':' << txnNumber
+               << " as part of a batch";
+        return;
+    }
+
     DBDirectClient client(opCtx);
 
     // Throws if serializing the request or deserializing the response fails.
     const auto commandResponse = client.runCommand([&] {
         write_ops::Update updateOp(NamespaceString::kTransactionCoordinatorsNamespace);
-        updateOp.setUpdates({[&] {
-            write_ops::UpdateOpEntry entry;
-
-            // Ensure that the document for the (lsid, txnNumber) either has no participant list or
-            // has the same participant list. The document may have the same participant list if an
-            // earlier attempt to write the participant list failed waiting for writeConcern.
-            BSONObj noParticipantList = BSON(TransactionCoordinatorDocument::kParticipantsFieldName
-                                             << BSON("$exists" << false));
-            BSONObj sameParticipantList =
-                BSON("$and" << buildParticipantListMatchesConditions(participantList));
-            entry.setQ(BSON(TransactionCoordinatorDocument::kIdFieldName
-                            << sessionInfo.toBSON()
-                            << "$or"
-                            << BSON_ARRAY(noParticipantList << sameParticipantList)));
-
-            // Update with participant list.
-            TransactionCoordinatorDocument doc;
-            doc.setId(std::move(sessionInfo));
-            doc.setParticipants(std::move(participantList));
-            entry.setU(doc.toBSON());
-
-            entry.setUpsert(true);
-            return entry;
-        }()});
+        updateOp.setUpdates({updateEntry});
         return updateOp.serialize({});
     }());
 
@@ -298,54 +451,63 @@ void persistDecisionBlocking(OperationContext* opCtx,
     sessionInfo.setSessionId(lsid);
     sessionInfo.setTxnNumber(txnNumber);
 
+    const auto updateEntry = [&] {
+        write_ops::UpdateOpEntry entry;
+
+        // Ensure that the document for the (lsid, txnNumber) has the same participant list and
+        // either has no decision or the same decision. The document may have the same decision
+        // if an earlier attempt to write the decision failed waiting for writeConcern.
+        BSONObj noDecision = BSON(TransactionCoordinatorDocument::kDecisionFieldName
+                                  << BSON("$exists" << false));
+        BSONObj sameDecision;
+        if (commitTimestamp) {
+            sameDecision = BSON(TransactionCoordinatorDocument::kDecisionFieldName
+                                << BSON(TransactionCoordinatorDocument::kDecisionFieldName
+                                        << "commit"
+                                        << "commitTimestamp"
+                                        << *commitTimestamp));
+        } else {
+            sameDecision =
+                BSON(TransactionCoordinatorDocument::kDecisionFieldName
+                     << BSON(TransactionCoordinatorDocument::kDecisionFieldName << "abort"));
+        }
+        entry.setQ(BSON(TransactionCoordinatorDocument::kIdFieldName
+                        << sessionInfo.toBSON()
+                        << "$and"
+                        << buildParticipantListMatchesConditions(participantList)
+                        << "$or"
+                        << BSON_ARRAY(noDecision << sameDecision)));
+
+        // Update with decision.
+        TransactionCoordinatorDocument doc;
+        doc.setId(sessionInfo);
+        doc.setParticipants(participantList);
+        txn::CoordinatorCommitDecision decision;
+        if (commitTimestamp) {
+            decision.setDecision(CommitDecision::kCommit);
+            decision.setCommitTimestamp(commitTimestamp);
+        } else {
+            decision.setDecision(CommitDecision::kAbort);
+        }
+        doc.setDecision(decision);
+        entry.setU(doc.toBSON());
+
+        return entry;
+    }();
+
+    if (gCoordinatorBatchedDocumentWrites.load() &&
+        coordinatorDocumentWriteBatcher.write(opCtx, updateEntry)) {
+        LOG(3) << "Wrote decision " << (commitTimestamp ? "commit" : "abort") << " for "
+               << lsid.getId() << ':' << txnNumber << " as part of a batch";
+        return;
+    }
+
     DBDirectClient client(opCtx);
 
     // Throws if serializing the request or deserializing the response fails.
     const auto commandResponse = client.runCommand([&] {
         write_ops::Update updateOp(NamespaceString::kTransactionCoordinatorsNamespace);
-        updateOp.setUpdates({[&] {
-            write_ops::UpdateOpEntry entry;
-
-            // Ensure that the document for the (lsid, txnNumber) has the same participant list and
-            // either has no decision or the same decision. The document may have the same decision
-            // if an earlier attempt to write the decision failed waiting for writeConcern.
-            BSONObj noDecision = BSON(TransactionCoordinatorDocument::kDecisionFieldName
-                                      << BSON("$exists" << false));
-            BSONObj sameDecision;
-            if (commitTimestamp) {
-                sameDecision = BSON(TransactionCoordinatorDocument::kDecisionFieldName
-                                    << BSON(TransactionCoordinatorDocument::kDecisionFieldName
-                                            << "commit"
-                                            << "commitTimestamp"
-                                            << *commitTimestamp));
-            } else {
-                sameDecision =
-                    BSON(TransactionCoordinatorDocument::kDecisionFieldName
-                         << BSON(TransactionCoordinatorDocument::kDecisionFieldName << "abort"));
-            }
-            entry.setQ(BSON(TransactionCoordinatorDocument::kIdFieldName
-                            << sessionInfo.toBSON()
-                            << "$and"
-                            << buildParticipantListMatchesConditions(participantList)
-                            << "$or"
-                            << BSON_ARRAY(noDecision << sameDecision)));
-
-            // Update with decision.
-            TransactionCoordinatorDocument doc;
-            doc.setId(sessionInfo);
-            doc.setParticipants(std::move(participantList));
-            txn::CoordinatorCommitDecision decision;
-            if (commitTimestamp) {
-                decision.setDecision(CommitDecision::kCommit);
-                decision.setCommitTimestamp(commitTimestamp);
-            } else {
-                decision.setDecision(CommitDecision::kAbort);
-            }
-            doc.setDecision(decision);
-            entry.setU(doc.toBSON());
-
-            return entry;
-        }()});
+        updateOp.setUpdates({updateEntry});
         return updateOp.serialize({});
     }());
 
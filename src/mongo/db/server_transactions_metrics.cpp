@@ -37,6 +37,7 @@
 #include "mongo/db/repl/optime.h"
 #include "mongo/db/retryable_writes_stats.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/session_txn_record_cache.h"
 #include "mongo/db/transactions_stats_gen.h"
 
 namespace mongo {
@@ -183,6 +184,7 @@ public:
         // referred to as “transactions”.
         RetryableWritesStats::get(opCtx)->updateStats(&stats);
         ServerTransactionsMetrics::get(opCtx)->updateStats(&stats);
+        stats.setTransactionsCollectionCacheSize(SessionTxnRecordCache::get(opCtx)->size());
         return stats.toBSON();
     }
 
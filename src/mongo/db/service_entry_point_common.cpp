@@ -74,6 +74,7 @@
 #include "mongo/db/s/transaction_coordinator_factory.h"
 #include "mongo/db/service_entry_point_common.h"
 #include "mongo/db/session_catalog_mongod.h"
+#include "mongo/db/snapshot_window_options.h"
 #include "mongo/db/snapshot_window_util.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/db/stats/server_read_concern_metrics.h"
@@ -90,6 +91,8 @@
 #include "mongo/rpc/metadata/tracking_metadata.h"
 #include "mongo/rpc/op_msg.h"
 #include "mongo/rpc/reply_builder_interface.h"
+#include "mongo/transport/session.h"
+#include "mongo/util/concurrency/ticketholder.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
@@ -575,6 +578,36 @@ bool runCommandImpl(OperationContext* opCtx,
     return ok;
 }
 
+/**
+ * Chooses the class the command's ticket requests queue in when the ticket holders admit by
+ * priority. A "priority:<class>" comment takes precedence. Otherwise internal cluster traffic is
+ * high priority and long-running analytics commands are low priority.
+ */
+AdmissionPriority chooseAdmissionPriority(OperationContext* opCtx,
+                                          const Command* command,
+                                          const OpMsgRequest& request) {
+    const auto comment = request.body["comment"];
+    if (comment.type() == String) {
+        const auto tag = comment.valueStringData();
+        if (tag == "priority:low"_sd)
+            return AdmissionPriority::kLow;
+        if (tag == "priority:normal"_sd)
+            return AdmissionPriority::kNormal;
+        if (tag == "priority:high"_sd)
+            return AdmissionPriority::kHigh;
+    }
+
+    const auto& session = opCtx->getClient()->session();
+    if (session && (session->getTags() & transport::Session::kInternalClient))
+        return AdmissionPriority::kHigh;
+
+    const auto name = command->getName();
+    if (name == "aggregate" || name == "mapReduce")
+        return AdmissionPriority::kLow;
+
+    return AdmissionPriority::kNormal;
+}
+
 /**
  * Executes a command after stripping metadata, performing authorization checks,
  * handling audit impersonation, and (potentially) setting maintenance mode. This method
@@ -664,6 +697,8 @@ void execCommandDatabase(OperationContext* opCtx,
         ImpersonationSessionGuard guard(opCtx);
         invocation->checkAuthorization(opCtx, request);
 
+        TicketHolder::setAdmissionPriority(opCtx, chooseAdmissionPriority(opCtx, command, request));
+
         const bool iAmPrimary = replCoord->canAcceptWritesForDatabase_UNSAFE(opCtx, dbname);
 
         if (!opCtx->getClient()->isInDirectClient() &&
@@ -750,7 +785,23 @@ void execCommandDatabase(OperationContext* opCtx,
             }
         }
 
-        if (readConcernArgs.getLevel() == repl::ReadConcernLevel::kSnapshotReadConcern) {
+        const auto& commandName = invocation->definition()->getName();
+        const bool isNonTransactionalSnapshotRead =
+            readConcernArgs.getLevel() == repl::ReadConcernLevel::kSnapshotReadConcern &&
+            !opCtx->getClient()->isInDirectClient() && !sessionOptions.getStartTransaction() &&
+            !sessionOptions.getAutocommit() &&
+            (commandName == "find" || commandName == "aggregate") &&
+            snapshotWindowParams.enableNonTransactionalSnapshotReads.load();
+        if (isNonTransactionalSnapshotRead) {
+            // Outside of a transaction, every batch of the cursor is read at 'atClusterTime', which
+            // the caller (normally mongos) must choose once for all shards. No locks or storage
+            // snapshot are held between batches.
+            uassert(ErrorCodes::InvalidOptions,
+                    "readConcern level snapshot outside of a transaction requires atClusterTime",
+                    readConcernArgs.getArgsAtClusterTime());
+
+            opCtx->lockState()->setShouldConflictWithSecondaryBatchApplication(false);
+        } else if (readConcernArgs.getLevel() == repl::ReadConcernLevel::kSnapshotReadConcern) {
             uassert(ErrorCodes::InvalidOptions,
                     "readConcern level snapshot is only valid for the first transaction operation",
                     opCtx->getClient()->isInDirectClient() || sessionOptions.getStartTransaction());
@@ -1199,6 +1250,10 @@ DbResponse ServiceEntryPointCommon::handleRequest(OperationContext* opCtx,
 
     DbMessage dbmsg(m);
 
+    if (op == dbMsg) {
+        opCtx->setExhaust(OpMsg::isFlagSet(m, OpMsg::kExhaustSupported));
+    }
+
     Client& c = *opCtx->getClient();
 
     if (c.isInDirectClient()) {
@@ -1314,7 +1369,8 @@ DbResponse ServiceEntryPointCommon::handleRequest(OperationContext* opCtx,
         .incrementGlobalLatencyStats(
             opCtx,
             durationCount<Microseconds>(currentOp.elapsedTimeExcludingPauses()),
-            currentOp.getReadWriteType());
+            currentOp.getReadWriteType(),
+            currentOp.getCommand() ? StringData(currentOp.getCommand()->getName()) : StringData());
 
     if (currentOp.shouldDBProfile(shouldSample)) {
         // Performance profiling is on
@@ -39,6 +39,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/session_txn_record_cache.h"
 #include "mongo/db/transaction_participant.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/util/concurrency/thread_pool.h"
@@ -128,6 +129,10 @@ void MongoDSessionCatalog::onStepUp(OperationContext* opCtx) {
     });
     killSessionTokensFunction(opCtx, sessionKillTokens);
 
+    // Start warming the cache of config.transactions records for the sessions which were killed
+    // above and for any which have not been checked out on this node yet.
+    SessionTxnRecordCache::get(opCtx)->onStepUp(opCtx);
+
     {
         // Create a new opCtx because we need an empty locker to refresh the locks.
         auto newClient = opCtx->getServiceContext()->makeClient("restore-prepared-txn");
@@ -196,15 +201,20 @@ void MongoDSessionCatalog::invalidateSessions(OperationContext* opCtx,
     }
 
     const auto catalog = SessionCatalog::get(opCtx);
+    const auto txnRecordCache = SessionTxnRecordCache::get(opCtx);
 
     // The use of shared_ptr here is in order to work around the limitation of stdx::function that
     // the functor must be copyable.
     auto sessionKillTokens = std::make_shared<std::vector<SessionCatalog::KillToken>>();
 
     if (singleSessionDoc) {
-        sessionKillTokens->emplace_back(catalog->killSession(LogicalSessionId::parse(
-            IDLParserErrorContext("lsid"), singleSessionDoc->getField("_id").Obj())));
+        const auto lsid = LogicalSessionId::parse(IDLParserErrorContext("lsid"),
+                                                  singleSessionDoc->getField("_id").Obj());
+        txnRecordCache->invalidate(lsid);
+        sessionKillTokens->emplace_back(catalog->killSession(lsid));
     } else {
+        txnRecordCache->invalidateAll();
+
         SessionKiller::Matcher matcher(
             KillAllSessionsByPatternSet{makeKillAllSessionsByPattern(opCtx)});
         catalog->scanSessions(matcher, [&sessionKillTokens](const ObservableSession& session) {
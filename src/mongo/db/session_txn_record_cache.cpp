@@ -0,0 +1,211 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kTransaction
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/session_txn_record_cache.h"
+
+#include "mongo/db/client.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/transaction_participant_gen.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+namespace {
+
+const auto sessionTxnRecordCacheDecoration =
+    ServiceContext::declareDecoration<SessionTxnRecordCache>();
+
+struct SessionTxnRecordCacheLoader {
+    SessionTxnRecordCacheLoader()
+        : threadPool([] {
+              ThreadPool::Options options;
+              options.threadNamePrefix = "SessionTxnRecordCacheLoader";
+              options.minThreads = 0;
+              options.maxThreads = 1;
+              return options;
+          }()) {}
+
+    ThreadPool threadPool;
+};
+
+const auto sessionTxnRecordCacheLoader =
+    ServiceContext::declareDecoration<SessionTxnRecordCacheLoader>();
+const ServiceContext::ConstructorActionRegisterer sessionTxnRecordCacheLoaderRegisterer{
+    "SessionTxnRecordCacheLoader",
+    [](ServiceContext* service) { sessionTxnRecordCacheLoader(service).threadPool.startup(); },
+    [](ServiceContext* service) {
+        auto& pool = sessionTxnRecordCacheLoader(service).threadPool;
+        pool.shutdown();
+        pool.join();
+    }};
+
+}  // namespace
+
+SessionTxnRecordCache* SessionTxnRecordCache::get(ServiceContext* service) {
+    return &sessionTxnRecordCacheDecoration(service);
+}
+
+SessionTxnRecordCache* SessionTxnRecordCache::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+void SessionTxnRecordCache::onStepUp(OperationContext* opCtx) {
+    const auto maxEntries = gTransactionsCollectionCacheMaxEntries.load();
+    const auto term = repl::ReplicationCoordinator::get(opCtx)->getTerm();
+
+    long long generation;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        generation = ++_generation;
+        _term = term;
+        _loading = maxEntries > 0;
+        _records.clear();
+        _touchedWhileLoading.clear();
+    }
+
+    if (maxEntries <= 0)
+        return;
+
+    const auto service = opCtx->getServiceContext();
+    sessionTxnRecordCacheLoader(service).threadPool.schedule(
+        [this, service, generation, maxEntries](auto status) {
+            if (!status.isOK())
+                return;
+
+            auto uniqueClient = service->makeClient("SessionTxnRecordCacheLoader");
+            auto uniqueOpCtx = uniqueClient->makeOperationContext();
+
+            try {
+                _load(uniqueOpCtx.get(), generation, static_cast<size_t>(maxEntries));
+            } catch (const DBException& ex) {
+                log() << "Failed to load the "
+                      << NamespaceString::kSessionTransactionsTableNamespace
+                      << " cache after step up" << causedBy(ex.toStatus());
+            }
+
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            if (_generation == generation) {
+                _loading = false;
+                _touchedWhileLoading.clear();
+                LOG(1) << "Loaded " << _records.size() << " records of "
+                       << NamespaceString::kSessionTransactionsTableNamespace
+                       << " after step up in term " << _term;
+            }
+        });
+}
+
+void SessionTxnRecordCache::_load(OperationContext* opCtx,
+                                  long long generation,
+                                  size_t maxEntries) {
+    DBDirectClient client(opCtx);
+    auto cursor = client.query(NamespaceString::kSessionTransactionsTableNamespace, Query());
+
+    while (cursor->more()) {
+        auto record = SessionTxnRecord::parse(
+            IDLParserErrorContext("load session txn record cache"), cursor->next());
+
+        // Sessions with a prepared or in-progress transaction are kept in memory across the step
+        // up, so they never need to be refreshed from storage.
+        const auto state = record.getState();
+        if (state == DurableTxnStateEnum::kPrepared || state == DurableTxnStateEnum::kInProgress)
+            continue;
+
+        if (!_add(generation, maxEntries, std::move(record)))
+            return;
+    }
+}
+
+bool SessionTxnRecordCache::_add(long long generation,
+                                 size_t maxEntries,
+                                 SessionTxnRecord record) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_generation != generation || _records.size() >= maxEntries)
+        return false;
+
+    const auto& lsid = record.getSessionId();
+    if (_touchedWhileLoading.count(lsid))
+        return true;
+
+    _records.emplace(lsid, std::move(record));
+    return true;
+}
+
+boost::optional<SessionTxnRecord> SessionTxnRecordCache::take(OperationContext* opCtx,
+                                                              const LogicalSessionId& lsid) {
+    const auto replCoord = repl::ReplicationCoordinator::get(opCtx);
+    const auto term = replCoord->getTerm();
+    const bool isPrimary = replCoord->canAcceptWritesForDatabase_UNSAFE(opCtx, "admin");
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_loading)
+        _touchedWhileLoading.insert(lsid);
+
+    auto it = _records.find(lsid);
+    if (it == _records.end())
+        return boost::none;
+
+    auto record = std::move(it->second);
+    _records.erase(it);
+
+    if (term != _term || !isPrimary)
+        return boost::none;
+
+    return record;
+}
+
+void SessionTxnRecordCache::invalidate(const LogicalSessionId& lsid) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_loading)
+        _touchedWhileLoading.insert(lsid);
+
+    _records.erase(lsid);
+}
+
+void SessionTxnRecordCache::invalidateAll() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    ++_generation;
+    _loading = false;
+    _records.clear();
+    _touchedWhileLoading.clear();
+}
+
+size_t SessionTxnRecordCache::size() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _records.size();
+}
+
+}  // namespace mongo
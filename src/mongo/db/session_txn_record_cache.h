@@ -0,0 +1,110 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/db/logical_session_id.h"
+#include "mongo/db/session_txn_record_gen.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Bounded in-memory cache of config.transactions records, which is bulk-loaded in the background
+ * when a node steps up so that the first check-out of each session after a failover does not have
+ * to read its record from storage.
+ *
+ * Entries are only served in the term in which they were loaded, are consumed by the lookup which
+ * returns them and are dropped whenever the corresponding on-disk record may have changed, so a
+ * record obtained from the cache is never older than the one in the collection.
+ */
+class SessionTxnRecordCache {
+    SessionTxnRecordCache(const SessionTxnRecordCache&) = delete;
+    SessionTxnRecordCache& operator=(const SessionTxnRecordCache&) = delete;
+
+public:
+    SessionTxnRecordCache() = default;
+
+    static SessionTxnRecordCache* get(ServiceContext* service);
+    static SessionTxnRecordCache* get(OperationContext* opCtx);
+
+    /**
+     * Discards the current contents and, if 'transactionsCollectionCacheMaxEntries' is non-zero,
+     * schedules a background load of up to that many records for the current term.
+     */
+    void onStepUp(OperationContext* opCtx);
+
+    /**
+     * Removes and returns the cached record for 'lsid', if there is one for the current term and
+     * this node is still primary.
+     */
+    boost::optional<SessionTxnRecord> take(OperationContext* opCtx, const LogicalSessionId& lsid);
+
+    /**
+     * Drops the cached record for 'lsid', or all records, because the on-disk state may have
+     * changed. A load which is in progress will not add back a record it read before the change.
+     */
+    void invalidate(const LogicalSessionId& lsid);
+    void invalidateAll();
+
+    size_t size() const;
+
+private:
+    /**
+     * Scans config.transactions on behalf of the load started for 'generation'. Stops early once
+     * 'maxEntries' records are cached or a newer generation has started.
+     */
+    void _load(OperationContext* opCtx, long long generation, size_t maxEntries);
+
+    // Returns false if the record could not be added because the load for 'generation' is stale or
+    // the cache is full.
+    bool _add(long long generation, size_t maxEntries, SessionTxnRecord record);
+
+    mutable stdx::mutex _mutex;
+
+    // Incremented every time the contents are discarded, so that stale loads stop adding records.
+    long long _generation{0};
+
+    // The term in which the cached records were loaded.
+    long long _term{-1};
+
+    // Whether a load is running for the current generation.
+    bool _loading{false};
+
+    LogicalSessionIdMap<SessionTxnRecord> _records;
+
+    // Sessions which have been looked up or written to while the load is running. Their records
+    // are skipped by the load, since what it read from storage may be out of date.
+    LogicalSessionIdSet _touchedWhileLoading;
+};
+
+}  // namespace mongo
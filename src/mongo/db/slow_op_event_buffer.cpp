@@ -0,0 +1,90 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/slow_op_event_buffer.h"
+
+#include "mongo/db/service_context.h"
+#include "mongo/db/slow_op_event_buffer_gen.h"
+
+namespace mongo {
+namespace {
+
+const auto getSlowOpEventBuffer =
+    ServiceContext::declareDecoration<std::unique_ptr<SlowOpEventBuffer>>();
+
+ServiceContext::ConstructorActionRegisterer slowOpEventBufferRegisterer{
+    "SlowOpEventBuffer", {"EndStartupOptionStorage"}, [](ServiceContext* service) {
+        getSlowOpEventBuffer(service) =
+            std::make_unique<SlowOpEventBuffer>(static_cast<size_t>(gSlowOpEventBufferSize));
+    }};
+
+}  // namespace
+
+SlowOpEventBuffer* SlowOpEventBuffer::get(ServiceContext* service) {
+    return getSlowOpEventBuffer(service).get();
+}
+
+SlowOpEventBuffer::SlowOpEventBuffer(size_t capacity) : _capacity(capacity) {}
+
+void SlowOpEventBuffer::record(BSONObj event) {
+    if (!isEnabled()) {
+        return;
+    }
+
+    // Destroy the overwritten event outside of the lock.
+    BSONObj evicted;
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    ++_numRecorded;
+    if (_events.size() < _capacity) {
+        _events.push_back(std::move(event));
+        return;
+    }
+
+    evicted = std::exchange(_events[_next], std::move(event));
+    _next = (_next + 1) % _capacity;
+}
+
+std::vector<BSONObj> SlowOpEventBuffer::snapshot() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    std::vector<BSONObj> events;
+    events.reserve(_events.size());
+    events.insert(events.end(), _events.begin() + _next, _events.end());
+    events.insert(events.end(), _events.begin(), _events.begin() + _next);
+    return events;
+}
+
+long long SlowOpEventBuffer::getNumRecorded() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _numRecorded;
+}
+
+}  // namespace mongo
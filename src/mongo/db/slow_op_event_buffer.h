@@ -0,0 +1,89 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+/**
+ * A fixed-size, in-memory ring of structured records describing slow operations. Recording an
+ * event costs one BSON build and a short critical section, which is much cheaper than formatting
+ * the equivalent log line, so the slow operation threshold can stay low on busy servers. Once the
+ * ring is full, each new event overwrites the oldest one.
+ *
+ * The events are read back through the $slowOpEvents aggregation stage.
+ */
+class SlowOpEventBuffer {
+    SlowOpEventBuffer(const SlowOpEventBuffer&) = delete;
+    SlowOpEventBuffer& operator=(const SlowOpEventBuffer&) = delete;
+
+public:
+    /**
+     * Returns the buffer for 'service', sized by the 'slowOpEventBufferSize' startup parameter.
+     */
+    static SlowOpEventBuffer* get(ServiceContext* service);
+
+    explicit SlowOpEventBuffer(size_t capacity);
+
+    /**
+     * A buffer with a capacity of zero records nothing.
+     */
+    bool isEnabled() const {
+        return _capacity > 0;
+    }
+
+    void record(BSONObj event);
+
+    /**
+     * Returns the retained events, oldest first.
+     */
+    std::vector<BSONObj> snapshot() const;
+
+    /**
+     * Returns the number of events recorded since startup, including overwritten ones.
+     */
+    long long getNumRecorded() const;
+
+private:
+    const size_t _capacity;
+
+    mutable stdx::mutex _mutex;
+    std::vector<BSONObj> _events;
+    size_t _next = 0;
+    long long _numRecorded = 0;
+};
+
+}  // namespace mongo
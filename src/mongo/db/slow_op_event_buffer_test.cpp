@@ -0,0 +1,76 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/slow_op_event_buffer.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(SlowOpEventBufferTest, ZeroCapacityRecordsNothing) {
+    SlowOpEventBuffer buffer(0);
+    ASSERT_FALSE(buffer.isEnabled());
+    buffer.record(BSON("i" << 0));
+    ASSERT_EQ(0, buffer.getNumRecorded());
+    ASSERT_TRUE(buffer.snapshot().empty());
+}
+
+TEST(SlowOpEventBufferTest, SnapshotIsOldestFirstBeforeWrapping) {
+    SlowOpEventBuffer buffer(4);
+    for (int i = 0; i < 3; ++i) {
+        buffer.record(BSON("i" << i));
+    }
+
+    const auto events = buffer.snapshot();
+    ASSERT_EQ(3U, events.size());
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_BSONOBJ_EQ(BSON("i" << i), events[i]);
+    }
+}
+
+TEST(SlowOpEventBufferTest, NewEventsOverwriteTheOldest) {
+    SlowOpEventBuffer buffer(4);
+    for (int i = 0; i < 10; ++i) {
+        buffer.record(BSON("i" << i));
+    }
+    ASSERT_EQ(10, buffer.getNumRecorded());
+
+    const auto events = buffer.snapshot();
+    ASSERT_EQ(4U, events.size());
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_BSONOBJ_EQ(BSON("i" << 6 + i), events[i]);
+    }
+}
+
+}  // namespace
+}  // namespace mongo
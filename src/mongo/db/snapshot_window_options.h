@@ -104,6 +104,14 @@ struct SnapshotWindowParams {
     // the storage engine to attempt to act on the new setting.
     AtomicWord<int> checkCachePressurePeriodSeconds{5};
 
+    // enableNonTransactionalSnapshotReads (startup & runtime server parameter).
+    //
+    // Allows find and aggregate to use readConcern level 'snapshot' with an atClusterTime outside
+    // of a multi-statement transaction. Such cursors read every batch at the same timestamp but do
+    // not hold a storage snapshot open between batches, so they rely on the snapshot window above
+    // and fail with SnapshotTooOld once their timestamp falls out of it.
+    AtomicWord<bool> enableNonTransactionalSnapshotReads{false};
+
     static inline MutableObeserverRegistry<decltype(checkCachePressurePeriodSeconds)::WordType>
         observeCheckCachePressurePeriodSeconds;
 };
@@ -51,13 +51,16 @@
 #include <boost/filesystem/operations.hpp>
 #include <snappy.h>
 #include <vector>
+#include <zstd.h>
 
+#include "mongo/base/data_view.h"
 #include "mongo/base/string_data.h"
 #include "mongo/config.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/encryption_hooks.h"
 #include "mongo/db/storage/storage_options.h"
+#include "mongo/db/storage/storage_parameters_gen.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/overflow_arithmetic.h"
 #include "mongo/s/is_mongos.h"
@@ -73,6 +76,16 @@ namespace sorter {
 
 using std::shared_ptr;
 
+// Compressed blocks which start with the zstd frame magic number were compressed with zstd, and the
+// rest with snappy. A snappy block can never start with these bytes, since it would have to begin
+// with a back-reference.
+const std::uint32_t kZstdFrameMagic = 0xFD2FB528;
+
+inline bool isZstdFrame(const char* data, size_t size) {
+    return size >= sizeof(kZstdFrameMagic) &&
+        ConstDataView(data).read<LittleEndian<std::uint32_t>>() == kZstdFrameMagic;
+}
+
 // We need to use the "real" errno everywhere, not GetLastError() on Windows
 inline std::string myErrnoWithDescription() {
     int errnoCopy = errno;
@@ -263,6 +276,25 @@ private:
             return;
         }
 
+        if (isZstdFrame(_buffer.get(), blockSize)) {
+            const auto uncompressedSize = ZSTD_getFrameContentSize(_buffer.get(), blockSize);
+            uassert(51772,
+                    "couldn't get uncompressed length",
+                    uncompressedSize != ZSTD_CONTENTSIZE_UNKNOWN &&
+                        uncompressedSize != ZSTD_CONTENTSIZE_ERROR);
+
+            std::unique_ptr<char[]> decompressionBuffer(new char[uncompressedSize]);
+            const size_t ret = ZSTD_decompress(
+                decompressionBuffer.get(), uncompressedSize, _buffer.get(), blockSize);
+            uassert(51773,
+                    str::stream() << "decompression failed: " << ZSTD_getErrorName(ret),
+                    !ZSTD_isError(ret) && ret == uncompressedSize);
+
+            _buffer.swap(decompressionBuffer);
+            _bufferReader.reset(new BufReader(_buffer.get(), uncompressedSize));
+            return;
+        }
+
         dassert(snappy::IsValidCompressedBuffer(_buffer.get(), blockSize));
 
         size_t uncompressedSize;
@@ -951,7 +983,18 @@ void SortedFileWriter<Key, Value>::spill() {
         return;
 
     std::string compressed;
-    snappy::Compress(outBuffer, size, &compressed);
+    const int zstdLevel = gSorterSpillZstdCompressionLevel.load();
+    if (zstdLevel > 0) {
+        compressed.resize(ZSTD_compressBound(size));
+        const size_t ret =
+            ZSTD_compress(&compressed[0], compressed.size(), outBuffer, size, zstdLevel);
+        uassert(51774,
+                str::stream() << "compression failed: " << ZSTD_getErrorName(ret),
+                !ZSTD_isError(ret));
+        compressed.resize(ret);
+    } else {
+        snappy::Compress(outBuffer, size, &compressed);
+    }
     verify(compressed.size() <= size_t(std::numeric_limits<int32_t>::max()));
 
     const bool shouldCompress = compressed.size() < size_t(_buffer.len() / 10 * 9);
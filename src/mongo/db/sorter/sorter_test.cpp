@@ -38,10 +38,12 @@
 #include "mongo/base/static_assert.h"
 #include "mongo/config.h"
 #include "mongo/db/service_context_test_fixture.h"
+#include "mongo/db/storage/storage_parameters_gen.h"
 #include "mongo/platform/random.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
 
 #include <memory>
@@ -309,6 +311,36 @@ public:
     }
 };
 
+class SortedFileWriterZstdTests : public ScopedGlobalServiceContextForTest {
+public:
+    void run() {
+        unittest::TempDir tempDir("sortedFileWriterZstdTests");
+        const SortOptions opts = SortOptions().TempDir(tempDir.path());
+        const std::string fileName = opts.tempDir + "/" + nextFileName();
+        const int originalLevel = gSorterSpillZstdCompressionLevel.load();
+        ON_BLOCK_EXIT([&] { gSorterSpillZstdCompressionLevel.store(originalLevel); });
+
+        // Write one range compressed with zstd, then one with snappy into the same file.
+        gSorterSpillZstdCompressionLevel.store(3);
+        SortedFileWriter<IntWrapper, IntWrapper> zstdWriter(opts, fileName, 0);
+        for (int i = 0; i < 1000 * 1000; i++)
+            zstdWriter.addAlreadySorted(i, -i);
+        std::shared_ptr<IWIterator> zstdIter(zstdWriter.done());
+
+        gSorterSpillZstdCompressionLevel.store(0);
+        SortedFileWriter<IntWrapper, IntWrapper> snappyWriter(
+            opts, fileName, zstdWriter.getFileEndOffset());
+        for (int i = 0; i < 1000 * 1000; i++)
+            snappyWriter.addAlreadySorted(i, -i);
+        std::shared_ptr<IWIterator> snappyIter(snappyWriter.done());
+
+        ASSERT_ITERATORS_EQUIVALENT(zstdIter, make_shared<IntIterator>(0, 1000 * 1000));
+        ASSERT_ITERATORS_EQUIVALENT(snappyIter, make_shared<IntIterator>(0, 1000 * 1000));
+
+        ASSERT_TRUE(boost::filesystem::remove(fileName));
+    }
+};
+
 
 class MergeIteratorTests {
 public:
@@ -588,6 +620,7 @@ public:
     void setupTests() override {
         add<InMemIterTests>();
         add<SortedFileWriterAndFileIteratorTests>();
+        add<SortedFileWriterZstdTests>();
         add<MergeIteratorTests>();
         add<SorterTests::Basic>();
         add<SorterTests::Limit>();
@@ -34,6 +34,7 @@
 #include "mongo/db/stats/counters.h"
 
 #include "mongo/db/jsobj.h"
+#include "mongo/db/stats/stats_shard.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -66,27 +67,37 @@ void OpCounters::gotOp(int op, bool isCommand) {
     }
 }
 
-void OpCounters::_checkWrap(CacheAligned<AtomicWord<long long>> OpCounters::*counter, int n) {
+void OpCounters::_checkWrap(AtomicWord<long long> Shard::*counter, int n) {
     static constexpr auto maxCount = 1LL << 60;
-    auto oldValue = (this->*counter).fetchAndAddRelaxed(n);
+    auto oldValue = (_shards[getStatsShard(kNumShards)].*counter).fetchAndAddRelaxed(n);
     if (oldValue > maxCount) {
-        _insert.store(0);
-        _query.store(0);
-        _update.store(0);
-        _delete.store(0);
-        _getmore.store(0);
-        _command.store(0);
+        for (auto& shard : _shards) {
+            shard.insert.store(0);
+            shard.query.store(0);
+            shard.update.store(0);
+            shard.remove.store(0);
+            shard.getmore.store(0);
+            shard.command.store(0);
+        }
     }
 }
 
+long long OpCounters::_sum(AtomicWord<long long> Shard::*counter) const {
+    long long sum = 0;
+    for (const auto& shard : _shards) {
+        sum += (shard.*counter).loadRelaxed();
+    }
+    return sum;
+}
+
 BSONObj OpCounters::getObj() const {
     BSONObjBuilder b;
-    b.append("insert", _insert.loadRelaxed());
-    b.append("query", _query.loadRelaxed());
-    b.append("update", _update.loadRelaxed());
-    b.append("delete", _delete.loadRelaxed());
-    b.append("getmore", _getmore.loadRelaxed());
-    b.append("command", _command.loadRelaxed());
+    b.append("insert", getInsert());
+    b.append("query", getQuery());
+    b.append("update", getUpdate());
+    b.append("delete", getDelete());
+    b.append("getmore", getGetMore());
+    b.append("command", getCommand());
     return b.obj();
 }
 
@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <array>
+
 #include "mongo/db/jsobj.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/basic.h"
@@ -41,32 +43,34 @@ namespace mongo {
 
 /**
  * for storing operation counters
- * note: not thread safe.  ok with that for speed
+ *
+ * The counters are sharded by CPU and summed when read, so that counting an operation never
+ * contends with other CPUs. All the counters of a shard share one cache line.
  */
 class OpCounters {
 public:
     OpCounters() = default;
 
     void gotInserts(int n) {
-        _checkWrap(&OpCounters::_insert, n);
+        _checkWrap(&Shard::insert, n);
     }
     void gotInsert() {
-        _checkWrap(&OpCounters::_insert, 1);
+        _checkWrap(&Shard::insert, 1);
     }
     void gotQuery() {
-        _checkWrap(&OpCounters::_query, 1);
+        _checkWrap(&Shard::query, 1);
     }
     void gotUpdate() {
-        _checkWrap(&OpCounters::_update, 1);
+        _checkWrap(&Shard::update, 1);
     }
     void gotDelete() {
-        _checkWrap(&OpCounters::_delete, 1);
+        _checkWrap(&Shard::remove, 1);
     }
     void gotGetMore() {
-        _checkWrap(&OpCounters::_getmore, 1);
+        _checkWrap(&Shard::getmore, 1);
     }
     void gotCommand() {
-        _checkWrap(&OpCounters::_command, 1);
+        _checkWrap(&Shard::command, 1);
     }
 
     void gotOp(int op, bool isCommand);
@@ -74,35 +78,46 @@ public:
     BSONObj getObj() const;
 
     // thse are used by snmp, and other things, do not remove
-    const AtomicWord<long long>* getInsert() const {
-        return &_insert;
+    long long getInsert() const {
+        return _sum(&Shard::insert);
     }
-    const AtomicWord<long long>* getQuery() const {
-        return &_query;
+    long long getQuery() const {
+        return _sum(&Shard::query);
     }
-    const AtomicWord<long long>* getUpdate() const {
-        return &_update;
+    long long getUpdate() const {
+        return _sum(&Shard::update);
     }
-    const AtomicWord<long long>* getDelete() const {
-        return &_delete;
+    long long getDelete() const {
+        return _sum(&Shard::remove);
     }
-    const AtomicWord<long long>* getGetMore() const {
-        return &_getmore;
+    long long getGetMore() const {
+        return _sum(&Shard::getmore);
     }
-    const AtomicWord<long long>* getCommand() const {
-        return &_command;
+    long long getCommand() const {
+        return _sum(&Shard::command);
     }
 
 private:
-    // Increment member `counter` by `n`, resetting all counters if it was > 2^60.
-    void _checkWrap(CacheAligned<AtomicWord<long long>> OpCounters::*counter, int n);
-
-    CacheAligned<AtomicWord<long long>> _insert;
-    CacheAligned<AtomicWord<long long>> _query;
-    CacheAligned<AtomicWord<long long>> _update;
-    CacheAligned<AtomicWord<long long>> _delete;
-    CacheAligned<AtomicWord<long long>> _getmore;
-    CacheAligned<AtomicWord<long long>> _command;
+    static constexpr size_t kNumShards = 32;
+
+    struct Shard {
+        AtomicWord<long long> insert{0};
+        AtomicWord<long long> query{0};
+        AtomicWord<long long> update{0};
+        AtomicWord<long long> remove{0};
+        AtomicWord<long long> getmore{0};
+        AtomicWord<long long> command{0};
+    };
+    static_assert(sizeof(Shard) <= stdx::hardware_constructive_interference_size,
+                  "cache line spill");
+
+    // Increment member `counter` of the calling CPU's shard by `n`, resetting all counters if it
+    // was > 2^60.
+    void _checkWrap(AtomicWord<long long> Shard::*counter, int n);
+
+    long long _sum(AtomicWord<long long> Shard::*counter) const;
+
+    std::array<CacheAligned<Shard>, kNumShards> _shards;
 };
 
 extern OpCounters globalOpCounters;
@@ -113,6 +113,10 @@ public:
         return true;
     }
 
+    Cost cost() const override {
+        return Cost::kExpensive;
+    }
+
     BSONObj generateSection(OperationContext* opCtx,
                             const BSONElement& configElement) const override {
         BSONObjBuilder ret;
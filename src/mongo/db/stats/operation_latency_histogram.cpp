@@ -35,6 +35,7 @@
 
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/stats/top_gen.h"
 #include "mongo/platform/bits.h"
 
 namespace mongo {
@@ -92,34 +93,101 @@ const std::array<uint64_t, OperationLatencyHistogram::kMaxBuckets>
                                                549755813888,
                                                1099511627776};
 
-void OperationLatencyHistogram::_append(const HistogramData& data,
-                                        const char* key,
-                                        bool includeHistograms,
-                                        BSONObjBuilder* builder) const {
-
+void OperationLatencyHistogram::HistogramData::append(StringData key,
+                                                     bool includeHistograms,
+                                                     BSONObjBuilder* builder) const {
     BSONObjBuilder histogramBuilder(builder->subobjStart(key));
     if (includeHistograms) {
         BSONArrayBuilder arrayBuilder(histogramBuilder.subarrayStart("histogram"));
-        for (int i = 0; i < kMaxBuckets; i++) {
-            if (data.buckets[i] == 0)
-                continue;
+        const auto appendBucket = [&](uint64_t lowerBound, uint64_t count) {
             BSONObjBuilder entryBuilder(arrayBuilder.subobjStart());
-            entryBuilder.append("micros", static_cast<long long>(kLowerBounds[i]));
-            entryBuilder.append("count", static_cast<long long>(data.buckets[i]));
+            entryBuilder.append("micros", static_cast<long long>(lowerBound));
+            entryBuilder.append("count", static_cast<long long>(count));
             entryBuilder.doneFast();
+        };
+        if (!_fineBuckets.empty()) {
+            for (size_t i = 0; i < _fineBuckets.size(); i++) {
+                if (_fineBuckets[i] != 0) {
+                    appendBucket(getFineBucketLowerBound(i, gOpLatencyHistogramPrecisionBits),
+                                 _fineBuckets[i]);
+                }
+            }
+        } else {
+            for (int i = 0; i < kMaxBuckets; i++) {
+                if (_buckets[i] != 0) {
+                    appendBucket(kLowerBounds[i], _buckets[i]);
+                }
+            }
         }
         arrayBuilder.doneFast();
     }
-    histogramBuilder.append("latency", static_cast<long long>(data.sum));
-    histogramBuilder.append("ops", static_cast<long long>(data.entryCount));
+    histogramBuilder.append("latency", static_cast<long long>(_sum));
+    histogramBuilder.append("ops", static_cast<long long>(_entryCount));
     histogramBuilder.doneFast();
 }
 
+void OperationLatencyHistogram::HistogramData::increment(uint64_t latency) {
+    const int precisionBits = gOpLatencyHistogramPrecisionBits;
+    if (precisionBits > 0) {
+        if (_fineBuckets.empty()) {
+            _fineBuckets.resize(getNumFineBuckets(precisionBits));
+        }
+        _fineBuckets[getFineBucket(latency, precisionBits)]++;
+    } else {
+        _buckets[_getBucket(latency)]++;
+    }
+    _entryCount++;
+    _sum += latency;
+}
+
+void OperationLatencyHistogram::HistogramData::merge(const HistogramData& other) {
+    for (int i = 0; i < kMaxBuckets; i++) {
+        _buckets[i] += other._buckets[i];
+    }
+    if (!other._fineBuckets.empty()) {
+        _fineBuckets.resize(other._fineBuckets.size());
+        for (size_t i = 0; i < other._fineBuckets.size(); i++) {
+            _fineBuckets[i] += other._fineBuckets[i];
+        }
+    }
+    _entryCount += other._entryCount;
+    _sum += other._sum;
+}
+
 void OperationLatencyHistogram::append(bool includeHistograms, BSONObjBuilder* builder) const {
-    _append(_reads, "reads", includeHistograms, builder);
-    _append(_writes, "writes", includeHistograms, builder);
-    _append(_commands, "commands", includeHistograms, builder);
-    _append(_transactions, "transactions", includeHistograms, builder);
+    _reads.append("reads", includeHistograms, builder);
+    _writes.append("writes", includeHistograms, builder);
+    _commands.append("commands", includeHistograms, builder);
+    _transactions.append("transactions", includeHistograms, builder);
+}
+
+int OperationLatencyHistogram::getFineBucket(uint64_t value, int precisionBits) {
+    const uint64_t subBuckets = 1ULL << precisionBits;
+    // Values below 2^precisionBits each have their own bucket.
+    if (value < subBuckets) {
+        return value;
+    }
+
+    value = std::min(value, (2ULL << kMaxFineLog2) - 1);
+    const int log2 = 63 - countLeadingZeros64(value);
+    // The top 'precisionBits' bits below the leading one select the bucket within [2^k, 2^(k+1)).
+    const uint64_t subBucket = (value >> (log2 - precisionBits)) - subBuckets;
+    return (log2 - precisionBits + 1) * subBuckets + subBucket;
+}
+
+uint64_t OperationLatencyHistogram::getFineBucketLowerBound(int bucket, int precisionBits) {
+    const uint64_t subBuckets = 1ULL << precisionBits;
+    if (static_cast<uint64_t>(bucket) < subBuckets) {
+        return bucket;
+    }
+
+    const int group = bucket / subBuckets;
+    const uint64_t subBucket = bucket % subBuckets;
+    return (subBuckets + subBucket) << (group - 1);
+}
+
+int OperationLatencyHistogram::getNumFineBuckets(int precisionBits) {
+    return (kMaxFineLog2 - precisionBits + 2) << precisionBits;
 }
 
 // Computes the log base 2 of value, and checks for cases of split buckets.
@@ -149,26 +217,26 @@ int OperationLatencyHistogram::_getBucket(uint64_t value) {
     }
 }
 
-void OperationLatencyHistogram::_incrementData(uint64_t latency, int bucket, HistogramData* data) {
-    data->buckets[bucket]++;
-    data->entryCount++;
-    data->sum += latency;
+void OperationLatencyHistogram::merge(const OperationLatencyHistogram& other) {
+    _reads.merge(other._reads);
+    _writes.merge(other._writes);
+    _commands.merge(other._commands);
+    _transactions.merge(other._transactions);
 }
 
 void OperationLatencyHistogram::increment(uint64_t latency, Command::ReadWriteType type) {
-    int bucket = _getBucket(latency);
     switch (type) {
         case Command::ReadWriteType::kRead:
-            _incrementData(latency, bucket, &_reads);
+            _reads.increment(latency);
             break;
         case Command::ReadWriteType::kWrite:
-            _incrementData(latency, bucket, &_writes);
+            _writes.increment(latency);
             break;
         case Command::ReadWriteType::kCommand:
-            _incrementData(latency, bucket, &_commands);
+            _commands.increment(latency);
             break;
         case Command::ReadWriteType::kTransaction:
-            _incrementData(latency, bucket, &_transactions);
+            _transactions.increment(latency);
             break;
         default:
             MONGO_UNREACHABLE;
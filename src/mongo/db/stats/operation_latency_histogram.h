@@ -29,6 +29,7 @@
 #pragma once
 
 #include <array>
+#include <vector>
 
 #include "mongo/db/commands.h"
 
@@ -40,6 +41,11 @@ class BSONObjBuilder;
  * Stores statistics for latencies of read, write, command, and multi-document transaction
  * operations.
  *
+ * By default the histograms use the buckets in 'kLowerBounds', which are powers of two, some split
+ * in half. With 'opLatencyHistogramPrecisionBits' set to p, they instead use log-linear buckets:
+ * every power of two range [2^k, 2^(k+1)) is split into 2^p equal buckets, so a bucket's width is
+ * within 1/2^p of its lower bound.
+ *
  * Note: This class is not thread-safe.
  */
 class OperationLatencyHistogram {
@@ -49,33 +55,64 @@ public:
     // Inclusive lower bounds of the histogram buckets.
     static const std::array<uint64_t, kMaxBuckets> kLowerBounds;
 
+    // Latencies of 2^(kMaxFineLog2 + 1) microseconds and above share the last log-linear bucket.
+    static const int kMaxFineLog2 = 40;
+
+    /**
+     * A single latency histogram, with its latency total and operation count.
+     */
+    class HistogramData {
+    public:
+        void increment(uint64_t latency);
+
+        void merge(const HistogramData& other);
+
+        /**
+         * Appends the latency total, the operation count and, if 'includeHistograms' is true,
+         * the non-empty buckets as a subobject named 'key'.
+         */
+        void append(StringData key, bool includeHistograms, BSONObjBuilder* builder) const;
+
+    private:
+        std::array<uint64_t, kMaxBuckets> _buckets{};
+
+        // Log-linear buckets, used instead of '_buckets' when 'opLatencyHistogramPrecisionBits'
+        // is set. Allocated on the first increment, since most histograms stay empty.
+        std::vector<uint64_t> _fineBuckets;
+
+        uint64_t _entryCount = 0;
+        uint64_t _sum = 0;
+    };
+
     /**
      * Increments the bucket of the histogram based on the operation type.
      */
     void increment(uint64_t latency, Command::ReadWriteType type);
 
+    /**
+     * Adds the counts of 'other' to this histogram.
+     */
+    void merge(const OperationLatencyHistogram& other);
+
     /**
      * Appends the four histograms with latency totals and operation counts.
      */
     void append(bool includeHistograms, BSONObjBuilder* builder) const;
 
-private:
-    struct HistogramData {
-        std::array<uint64_t, kMaxBuckets> buckets{};
-        uint64_t entryCount = 0;
-        uint64_t sum = 0;
-    };
-
-    static int _getBucket(uint64_t latency);
-
-    static uint64_t _getBucketMicros(int bucket);
+    /**
+     * Returns the index of the log-linear bucket for 'latency' with 'precisionBits' bits of
+     * precision, and the inclusive lower bound of the bucket at 'bucket'.
+     */
+    static int getFineBucket(uint64_t latency, int precisionBits);
+    static uint64_t getFineBucketLowerBound(int bucket, int precisionBits);
 
-    void _append(const HistogramData& data,
-                 const char* key,
-                 bool includeHistograms,
-                 BSONObjBuilder* builder) const;
+    /**
+     * Returns the number of log-linear buckets with 'precisionBits' bits of precision.
+     */
+    static int getNumFineBuckets(int precisionBits);
 
-    void _incrementData(uint64_t latency, int bucket, HistogramData* data);
+private:
+    static int _getBucket(uint64_t latency);
 
     HistogramData _reads, _writes, _commands, _transactions;
 };
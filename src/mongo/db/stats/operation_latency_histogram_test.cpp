@@ -38,7 +38,9 @@
 
 #include "mongo/db/commands.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/stats/top_gen.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -92,4 +94,75 @@ TEST(OperationLatencyHistogram, CheckBucketCountsAndTotalLatency) {
         ASSERT_EQUALS(bucket["count"].Long(), (i < kMaxBuckets - 1) ? 3 : 2);
     }
 }
+
+TEST(OperationLatencyHistogram, MergeAddsCountsAndLatency) {
+    OperationLatencyHistogram first, second;
+    first.increment(10, Command::ReadWriteType::kRead);
+    second.increment(10, Command::ReadWriteType::kRead);
+    second.increment(5000, Command::ReadWriteType::kWrite);
+    first.merge(second);
+
+    BSONObjBuilder outBuilder;
+    first.append(true, &outBuilder);
+    BSONObj out = outBuilder.done();
+    ASSERT_EQUALS(out["reads"]["ops"].Long(), 2);
+    ASSERT_EQUALS(out["reads"]["latency"].Long(), 20);
+    ASSERT_EQUALS(out["reads"]["histogram"].Array()[0]["count"].Long(), 2);
+    ASSERT_EQUALS(out["writes"]["ops"].Long(), 1);
+    ASSERT_EQUALS(out["writes"]["latency"].Long(), 5000);
+    ASSERT_EQUALS(out["commands"]["ops"].Long(), 0);
+}
+
+TEST(OperationLatencyHistogram, FineBucketsAreContiguousAndBoundLatencies) {
+    for (int precisionBits = 1; precisionBits <= 5; precisionBits++) {
+        const int numBuckets = OperationLatencyHistogram::getNumFineBuckets(precisionBits);
+        for (int i = 0; i < numBuckets; i++) {
+            const uint64_t lowerBound =
+                OperationLatencyHistogram::getFineBucketLowerBound(i, precisionBits);
+            ASSERT_EQUALS(OperationLatencyHistogram::getFineBucket(lowerBound, precisionBits), i);
+            if (i > 0) {
+                ASSERT_EQUALS(
+                    OperationLatencyHistogram::getFineBucket(lowerBound - 1, precisionBits), i - 1);
+                // Every bucket is at most 1/2^precisionBits of its lower bound wide.
+                const uint64_t width = lowerBound -
+                    OperationLatencyHistogram::getFineBucketLowerBound(i - 1, precisionBits);
+                ASSERT_LTE(width << precisionBits,
+                           std::max<uint64_t>(lowerBound, 1ULL << precisionBits));
+            }
+        }
+
+        // Latencies past the last bucket are counted in it.
+        ASSERT_EQUALS(OperationLatencyHistogram::getFineBucket(~0ULL, precisionBits),
+                      numBuckets - 1);
+    }
+}
+
+TEST(OperationLatencyHistogram, FineBucketsAreReportedWhenEnabled) {
+    const auto precisionBits = gOpLatencyHistogramPrecisionBits;
+    gOpLatencyHistogramPrecisionBits = 3;
+    ON_BLOCK_EXIT([&] { gOpLatencyHistogramPrecisionBits = precisionBits; });
+
+    OperationLatencyHistogram first, second;
+    first.increment(1000, Command::ReadWriteType::kRead);
+    second.increment(1100, Command::ReadWriteType::kRead);
+    second.increment(1500, Command::ReadWriteType::kRead);
+    first.merge(second);
+
+    BSONObjBuilder outBuilder;
+    first.append(true, &outBuilder);
+    BSONObj out = outBuilder.done();
+    ASSERT_EQUALS(out["reads"]["ops"].Long(), 3);
+    ASSERT_EQUALS(out["reads"]["latency"].Long(), 3600);
+
+    // With 8 buckets per power of two, [512, 1024) and [1024, 2048) have 64 and 128 microsecond
+    // buckets.
+    std::vector<BSONElement> readBuckets = out["reads"]["histogram"].Array();
+    ASSERT_EQUALS(readBuckets.size(), 3U);
+    ASSERT_EQUALS(readBuckets[0]["micros"].Long(), 960);
+    ASSERT_EQUALS(readBuckets[1]["micros"].Long(), 1024);
+    ASSERT_EQUALS(readBuckets[2]["micros"].Long(), 1408);
+    for (auto&& bucket : readBuckets) {
+        ASSERT_EQUALS(bucket["count"].Long(), 1);
+    }
+}
 }  // namespace mongo
@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/query_shape_stats.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/stats/query_shape_stats_gen.h"
+#include "mongo/util/hex.h"
+
+namespace mongo {
+namespace {
+
+const auto getQueryShapeStats = ServiceContext::declareDecoration<QueryShapeStats>();
+
+Counter64 queryShapeStatsShapes;
+Counter64 queryShapeStatsDropped;
+ServerStatusMetricField<Counter64> displayShapes("queryShapeStats.shapes",
+                                                 &queryShapeStatsShapes);
+ServerStatusMetricField<Counter64> displayDropped("queryShapeStats.dropped",
+                                                  &queryShapeStatsDropped);
+
+}  // namespace
+
+QueryShapeStats& QueryShapeStats::get(ServiceContext* service) {
+    return getQueryShapeStats(service);
+}
+
+bool QueryShapeStats::isEnabled() {
+    return gQueryShapeStatsEnabled.load();
+}
+
+size_t QueryShapeStats::KeyHasher::operator()(const Key& key) const {
+    return std::hash<std::string>()(key.ns) ^ (static_cast<size_t>(key.queryHash) * 0x9E3779B1);
+}
+
+void QueryShapeStats::record(StringData ns,
+                             uint32_t queryHash,
+                             uint64_t latencyMicros,
+                             Command::ReadWriteType readWriteType,
+                             const Observation& observation) {
+    auto& stripe = _stripes[queryHash % kNumStripes];
+    Key key{ns.toString(), queryHash};
+    const auto now = Date_t::now();
+
+    stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+    auto it = stripe.entries.find(key);
+    if (it == stripe.entries.end()) {
+        if (_numEntries.fetchAndAdd(1) >= gQueryShapeStatsMaxEntries.load()) {
+            _numEntries.fetchAndSubtract(1);
+            queryShapeStatsDropped.increment();
+            return;
+        }
+        queryShapeStatsShapes.increment();
+        it = stripe.entries.emplace(std::move(key), Entry{}).first;
+        it->second.firstSeen = now;
+    }
+
+    auto& entry = it->second;
+    entry.lastSeen = now;
+    ++entry.count;
+    entry.totals.docsExamined += observation.docsExamined;
+    entry.totals.keysExamined += observation.keysExamined;
+    entry.totals.nreturned += observation.nreturned;
+    entry.totals.bytesReturned += observation.bytesReturned;
+    entry.latency.increment(latencyMicros, readWriteType);
+}
+
+std::vector<BSONObj> QueryShapeStats::snapshot() const {
+    std::vector<BSONObj> shapes;
+    for (const auto& stripe : _stripes) {
+        stdx::lock_guard<stdx::mutex> lk(stripe.mutex);
+        for (const auto& shape : stripe.entries) {
+            const auto& key = shape.first;
+            const auto& entry = shape.second;
+            BSONObjBuilder builder;
+            builder.append("ns", key.ns);
+            builder.append("queryHash", unsignedIntToFixedLengthHex(key.queryHash));
+            builder.append("firstSeen", entry.firstSeen);
+            builder.append("lastSeen", entry.lastSeen);
+            builder.append("count", entry.count);
+            builder.append("docsExamined", entry.totals.docsExamined);
+            builder.append("keysExamined", entry.totals.keysExamined);
+            builder.append("nreturned", entry.totals.nreturned);
+            builder.append("bytesReturned", entry.totals.bytesReturned);
+            {
+                BSONObjBuilder latencyBuilder(builder.subobjStart("latencyStats"));
+                entry.latency.append(true, &latencyBuilder);
+            }
+            shapes.push_back(builder.obj());
+        }
+    }
+    return shapes;
+}
+
+size_t QueryShapeStats::size() const {
+    return static_cast<size_t>(_numEntries.load());
+}
+
+}  // namespace mongo
@@ -0,0 +1,128 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/stats/operation_latency_histogram.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+/**
+ * Aggregates latency and resource statistics in memory for each query shape, identified by the
+ * namespace and the queryHash computed from the canonical query encoding. This gives the same
+ * per-shape view as post-processing system.profile, without writing a profile entry per
+ * operation.
+ *
+ * The table is striped by queryHash so that operations on different shapes rarely contend. It
+ * holds at most 'queryShapeStatsMaxEntries' shapes. Operations on shapes first seen after the
+ * table is full are counted in metrics.queryShapeStats.dropped.
+ */
+class QueryShapeStats {
+    QueryShapeStats(const QueryShapeStats&) = delete;
+    QueryShapeStats& operator=(const QueryShapeStats&) = delete;
+
+public:
+    /**
+     * Execution metrics of a single operation.
+     */
+    struct Observation {
+        long long docsExamined = 0;
+        long long keysExamined = 0;
+        long long nreturned = 0;
+        long long bytesReturned = 0;
+    };
+
+    static QueryShapeStats& get(ServiceContext* service);
+
+    /**
+     * Returns whether the 'queryShapeStatsEnabled' server parameter is set.
+     */
+    static bool isEnabled();
+
+    QueryShapeStats() = default;
+
+    void record(StringData ns,
+                uint32_t queryHash,
+                uint64_t latencyMicros,
+                Command::ReadWriteType readWriteType,
+                const Observation& observation);
+
+    /**
+     * Returns one document per tracked shape, in no particular order.
+     */
+    std::vector<BSONObj> snapshot() const;
+
+    size_t size() const;
+
+private:
+    static constexpr size_t kNumStripes = 16;
+
+    struct Key {
+        bool operator==(const Key& other) const {
+            return queryHash == other.queryHash && ns == other.ns;
+        }
+
+        std::string ns;
+        uint32_t queryHash;
+    };
+
+    struct KeyHasher {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct Entry {
+        Date_t firstSeen;
+        Date_t lastSeen;
+        long long count = 0;
+        Observation totals;
+        OperationLatencyHistogram latency;
+    };
+
+    struct Stripe {
+        mutable stdx::mutex mutex;
+        stdx::unordered_map<Key, Entry, KeyHasher> entries;
+    };
+
+    std::array<Stripe, kNumStripes> _stripes;
+    AtomicWord<long long> _numEntries{0};
+};
+
+}  // namespace mongo
@@ -0,0 +1,99 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/query_shape_stats.h"
+
+#include "mongo/db/stats/query_shape_stats_gen.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+BSONObj findShape(const std::vector<BSONObj>& shapes, StringData ns, StringData queryHash) {
+    for (auto&& shape : shapes) {
+        if (shape["ns"].str() == ns && shape["queryHash"].str() == queryHash) {
+            return shape;
+        }
+    }
+    return BSONObj();
+}
+
+TEST(QueryShapeStatsTest, AggregatesOperationsOfTheSameShape) {
+    QueryShapeStats stats;
+    QueryShapeStats::Observation observation;
+    observation.docsExamined = 10;
+    observation.keysExamined = 4;
+    observation.nreturned = 2;
+    observation.bytesReturned = 100;
+
+    stats.record("test.a", 1, 50, Command::ReadWriteType::kRead, observation);
+    stats.record("test.a", 1, 150, Command::ReadWriteType::kRead, observation);
+    stats.record("test.a", 2, 10, Command::ReadWriteType::kRead, observation);
+    stats.record("test.b", 1, 10, Command::ReadWriteType::kWrite, observation);
+    ASSERT_EQ(3U, stats.size());
+
+    const auto shapes = stats.snapshot();
+    ASSERT_EQ(3U, shapes.size());
+
+    const auto shape = findShape(shapes, "test.a", "00000001");
+    ASSERT_FALSE(shape.isEmpty());
+    ASSERT_EQ(2, shape["count"].numberLong());
+    ASSERT_EQ(20, shape["docsExamined"].numberLong());
+    ASSERT_EQ(8, shape["keysExamined"].numberLong());
+    ASSERT_EQ(4, shape["nreturned"].numberLong());
+    ASSERT_EQ(200, shape["bytesReturned"].numberLong());
+    ASSERT_EQ(200, shape["latencyStats"]["reads"]["latency"].numberLong());
+    ASSERT_EQ(2, shape["latencyStats"]["reads"]["ops"].numberLong());
+    ASSERT_EQ(0, shape["latencyStats"]["writes"]["ops"].numberLong());
+
+    ASSERT_FALSE(findShape(shapes, "test.a", "00000002").isEmpty());
+    ASSERT_FALSE(findShape(shapes, "test.b", "00000001").isEmpty());
+}
+
+TEST(QueryShapeStatsTest, StopsTrackingNewShapesWhenFull) {
+    const auto maxEntries = gQueryShapeStatsMaxEntries.load();
+    gQueryShapeStatsMaxEntries.store(2);
+    ON_BLOCK_EXIT([&] { gQueryShapeStatsMaxEntries.store(maxEntries); });
+
+    QueryShapeStats stats;
+    for (uint32_t queryHash = 0; queryHash < 5; ++queryHash) {
+        stats.record("test.a", queryHash, 1, Command::ReadWriteType::kRead, {});
+    }
+    ASSERT_EQ(2U, stats.size());
+
+    // Shapes already tracked keep being updated.
+    stats.record("test.a", 0, 1, Command::ReadWriteType::kRead, {});
+    ASSERT_EQ(2, findShape(stats.snapshot(), "test.a", "00000000")["count"].numberLong());
+}
+
+}  // namespace
+}  // namespace mongo
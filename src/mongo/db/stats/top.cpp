@@ -33,8 +33,11 @@
 
 #include "mongo/db/stats/top.h"
 
+#include <map>
+
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/stats/top_gen.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -67,11 +70,26 @@ Top::CollectionData::CollectionData(const CollectionData& older, const Collectio
       remove(older.remove, newer.remove),
       commands(older.commands, newer.commands) {}
 
+void Top::CollectionData::add(const CollectionData& other) {
+    total.add(other.total);
+    readLock.add(other.readLock);
+    writeLock.add(other.writeLock);
+    queries.add(other.queries);
+    getmore.add(other.getmore);
+    insert.add(other.insert);
+    update.add(other.update);
+    remove.add(other.remove);
+    commands.add(other.commands);
+    opLatencyHistogram.merge(other.opLatencyHistogram);
+}
+
 // static
 Top& Top::get(ServiceContext* service) {
     return getTop(service);
 }
 
+Top::Top() : _shards(static_cast<size_t>(gTopStatsShards)) {}
+
 void Top::record(OperationContext* opCtx,
                  StringData ns,
                  LogicalOp logicalOp,
@@ -82,19 +100,30 @@ void Top::record(OperationContext* opCtx,
     if (ns[0] == '?')
         return;
 
-    auto hashedNs = UsageMap::hasher().hashed_key(ns);
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-
-    if ((command || logicalOp == LogicalOp::opQuery) &&
-        _collDropNs.find(ns.toString()) != _collDropNs.end()) {
-        _collDropNs.erase(ns.toString());
+    if ((command || logicalOp == LogicalOp::opQuery) && _consumeCollDrop(ns)) {
         return;
     }
 
-    CollectionData& coll = _usage[hashedNs];
+    auto hashedNs = UsageMap::hasher().hashed_key(ns);
+    auto& shard = _getShard();
+    stdx::lock_guard<SimpleMutex> lk(shard.lock);
+    CollectionData& coll = shard.usage[hashedNs];
     _record(opCtx, coll, logicalOp, lockType, micros, readWriteType);
 }
 
+bool Top::_consumeCollDrop(StringData ns) {
+    if (_numCollDropNs.load() == 0) {
+        return false;
+    }
+
+    stdx::lock_guard<SimpleMutex> lk(_collDropLock);
+    if (_collDropNs.erase(ns.toString()) == 0) {
+        return false;
+    }
+    _numCollDropNs.store(_collDropNs.size());
+    return true;
+}
+
 void Top::_record(OperationContext* opCtx,
                   CollectionData& c,
                   LogicalOp logicalOp,
@@ -141,24 +170,34 @@ void Top::_record(OperationContext* opCtx,
 }
 
 void Top::collectionDropped(StringData ns, bool databaseDropped) {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    _usage.erase(ns);
+    for (auto& shard : _shards) {
+        stdx::lock_guard<SimpleMutex> lk(shard.lock);
+        shard.usage.erase(ns);
+    }
 
     if (!databaseDropped) {
         // If a collection drop occurred, there will be a subsequent call to record for this
         // collection namespace which must be ignored. This does not apply to a database drop.
+        stdx::lock_guard<SimpleMutex> lk(_collDropLock);
         _collDropNs.insert(ns.toString());
+        _numCollDropNs.store(_collDropNs.size());
     }
 }
 
 void Top::cloneMap(Top::UsageMap& out) const {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    out = _usage;
+    out.clear();
+    for (const auto& shard : _shards) {
+        stdx::lock_guard<SimpleMutex> lk(shard.lock);
+        for (const auto& entry : shard.usage) {
+            out[entry.first].add(entry.second);
+        }
+    }
 }
 
 void Top::append(BSONObjBuilder& b) {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    _appendToUsageMap(b, _usage);
+    UsageMap usage;
+    cloneMap(usage);
+    _appendToUsageMap(b, usage);
 }
 
 void Top::_appendToUsageMap(BSONObjBuilder& b, const UsageMap& map) const {
@@ -201,28 +240,68 @@ void Top::_appendStatsEntry(BSONObjBuilder& b, const char* statsName, const Usag
 
 void Top::appendLatencyStats(StringData ns, bool includeHistograms, BSONObjBuilder* builder) {
     auto hashedNs = UsageMap::hasher().hashed_key(ns);
-    stdx::lock_guard<SimpleMutex> lk(_lock);
+    OperationLatencyHistogram histogram;
+    for (const auto& shard : _shards) {
+        stdx::lock_guard<SimpleMutex> lk(shard.lock);
+        auto it = shard.usage.find(hashedNs);
+        if (it != shard.usage.end()) {
+            histogram.merge(it->second.opLatencyHistogram);
+        }
+    }
+
     BSONObjBuilder latencyStatsBuilder;
-    _usage[hashedNs].opLatencyHistogram.append(includeHistograms, &latencyStatsBuilder);
+    histogram.append(includeHistograms, &latencyStatsBuilder);
     builder->append("ns", ns);
     builder->append("latencyStats", latencyStatsBuilder.obj());
 }
 
 void Top::incrementGlobalLatencyStats(OperationContext* opCtx,
                                       uint64_t latency,
-                                      Command::ReadWriteType readWriteType) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _incrementHistogram(opCtx, latency, &_globalHistogramStats, readWriteType);
+                                      Command::ReadWriteType readWriteType,
+                                      StringData commandName) {
+    auto& shard = _getShard();
+    stdx::lock_guard<SimpleMutex> guard(shard.lock);
+    _incrementHistogram(opCtx, latency, &shard.globalHistogramStats, readWriteType);
+
+    Client* client = opCtx->getClient();
+    if (!commandName.empty() && gOpLatencyHistogramsByCommand.load() &&
+        client->isFromUserConnection() && !client->isInDirectClient()) {
+        auto hashedName = UsageMap::hasher().hashed_key(commandName);
+        shard.commandHistogramStats[hashedName].increment(latency);
+    }
 }
 
 void Top::appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _globalHistogramStats.append(includeHistograms, builder);
+    OperationLatencyHistogram histogram;
+    StringMap<OperationLatencyHistogram::HistogramData> commandHistograms;
+    for (const auto& shard : _shards) {
+        stdx::lock_guard<SimpleMutex> guard(shard.lock);
+        histogram.merge(shard.globalHistogramStats);
+        for (const auto& entry : shard.commandHistogramStats) {
+            commandHistograms[entry.first].merge(entry.second);
+        }
+    }
+    histogram.append(includeHistograms, builder);
+
+    if (gOpLatencyHistogramsByCommand.load()) {
+        // Sort by command name so that the section keeps the same shape between samples.
+        std::map<StringData, const OperationLatencyHistogram::HistogramData*> sorted;
+        for (const auto& entry : commandHistograms) {
+            sorted.emplace(entry.first, &entry.second);
+        }
+
+        BSONObjBuilder byCommandBuilder(builder->subobjStart("byCommand"));
+        for (const auto& entry : sorted) {
+            entry.second->append(entry.first, includeHistograms, &byCommandBuilder);
+        }
+        byCommandBuilder.doneFast();
+    }
 }
 
 void Top::incrementGlobalTransactionLatencyStats(uint64_t latency) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _globalHistogramStats.increment(latency, Command::ReadWriteType::kTransaction);
+    auto& shard = _getShard();
+    stdx::lock_guard<SimpleMutex> guard(shard.lock);
+    shard.globalHistogramStats.increment(latency, Command::ReadWriteType::kTransaction);
 }
 
 void Top::_incrementHistogram(OperationContext* opCtx,
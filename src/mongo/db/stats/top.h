@@ -34,12 +34,16 @@
  */
 
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <vector>
 
 #include "mongo/db/commands.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/stats/operation_latency_histogram.h"
+#include "mongo/db/stats/stats_shard.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/string_map.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
@@ -47,12 +51,15 @@ class ServiceContext;
 
 /**
  * tracks usage by collection
+ *
+ * The usage data is split into 'topStatsShards' shards, each with its own mutex. An operation only
+ * updates the shard of the CPU it runs on, and readers merge all the shards.
  */
 class Top {
 public:
     static Top& get(ServiceContext* service);
 
-    Top() = default;
+    Top();
 
     struct UsageData {
         UsageData() : time(0), count(0) {}
@@ -64,6 +71,11 @@ public:
             count++;
             time += micros;
         }
+
+        void add(const UsageData& other) {
+            count += other.count;
+            time += other.time;
+        }
     };
 
     struct CollectionData {
@@ -73,6 +85,11 @@ public:
         CollectionData() {}
         CollectionData(const CollectionData& older, const CollectionData& newer);
 
+        /**
+         * Adds the usage of 'other' to this one.
+         */
+        void add(const CollectionData& other);
+
         UsageData total;
 
         UsageData readLock;
@@ -116,11 +133,13 @@ public:
     void appendLatencyStats(StringData ns, bool includeHistograms, BSONObjBuilder* builder);
 
     /**
-     * Increments the global histogram only if the operation came from a user.
+     * Increments the global histogram only if the operation came from a user. Also increments the
+     * histogram for 'commandName', if not empty, when 'opLatencyHistogramsByCommand' is set.
      */
     void incrementGlobalLatencyStats(OperationContext* opCtx,
                                      uint64_t latency,
-                                     Command::ReadWriteType readWriteType);
+                                     Command::ReadWriteType readWriteType,
+                                     StringData commandName = StringData());
 
     /**
      * Increments the global transactions histogram.
@@ -128,11 +147,19 @@ public:
     void incrementGlobalTransactionLatencyStats(uint64_t latency);
 
     /**
-     * Appends the global latency statistics.
+     * Appends the global latency statistics, and the per-command ones under 'byCommand' when
+     * 'opLatencyHistogramsByCommand' is set.
      */
     void appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder);
 
 private:
+    struct Shard {
+        mutable SimpleMutex lock;
+        OperationLatencyHistogram globalHistogramStats;
+        StringMap<OperationLatencyHistogram::HistogramData> commandHistogramStats;
+        UsageMap usage;
+    };
+
     void _appendToUsageMap(BSONObjBuilder& b, const UsageMap& map) const;
 
     void _appendStatsEntry(BSONObjBuilder& b, const char* statsName, const UsageData& map) const;
@@ -149,9 +176,20 @@ private:
                              OperationLatencyHistogram* histogram,
                              Command::ReadWriteType readWriteType);
 
-    mutable SimpleMutex _lock;
-    OperationLatencyHistogram _globalHistogramStats;
-    UsageMap _usage;
+    Shard& _getShard() {
+        return _shards[getStatsShard(_shards.size())];
+    }
+
+    /**
+     * Returns true, and forgets 'ns', if 'ns' was dropped and not recorded since.
+     */
+    bool _consumeCollDrop(StringData ns);
+
+    std::vector<CacheAligned<Shard>> _shards;
+
+    // Lets record() skip _collDropLock while no drop is pending.
+    AtomicWord<int> _numCollDropNs{0};
+    SimpleMutex _collDropLock;
     std::set<std::string> _collDropNs;
 };
 
@@ -29,8 +29,11 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/db/service_context_test_fixture.h"
 #include "mongo/db/stats/top.h"
+#include "mongo/db/stats/top_gen.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace {
 
@@ -40,4 +43,42 @@ TEST(TopTest, CollectionDropped) {
     Top().collectionDropped("coll");
 }
 
+class TopShardsTest : public ServiceContextTest {};
+
+TEST_F(TopShardsTest, ReadsMergeAllShards) {
+    const auto numShards = gTopStatsShards;
+    gTopStatsShards = 4;
+    ON_BLOCK_EXIT([&] { gTopStatsShards = numShards; });
+
+    Top top;
+    auto opCtx = makeOperationContext();
+    for (int i = 0; i < 3; ++i) {
+        top.record(opCtx.get(),
+                   "test.coll",
+                   LogicalOp::opInsert,
+                   Top::LockType::WriteLocked,
+                   10,
+                   false,
+                   Command::ReadWriteType::kWrite);
+    }
+
+    Top::UsageMap usage;
+    top.cloneMap(usage);
+    ASSERT_EQ(1U, usage.size());
+    ASSERT_EQ(3, usage["test.coll"].insert.count);
+    ASSERT_EQ(30, usage["test.coll"].writeLock.time);
+
+    // The command that follows a drop is not recorded, and neither are the dropped stats.
+    top.collectionDropped("test.coll");
+    top.record(opCtx.get(),
+               "test.coll",
+               LogicalOp::opCommand,
+               Top::LockType::NotLocked,
+               10,
+               true,
+               Command::ReadWriteType::kCommand);
+    top.cloneMap(usage);
+    ASSERT_EQ(0U, usage.size());
+}
+
 }  // namespace
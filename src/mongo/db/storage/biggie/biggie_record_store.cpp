@@ -37,6 +37,7 @@
 
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/storage/biggie/biggie_parameters_gen.h"
 #include "mongo/db/storage/biggie/biggie_record_store.h"
 #include "mongo/db/storage/biggie/biggie_recovery_unit.h"
 #include "mongo/db/storage/biggie/biggie_visibility_manager.h"
@@ -71,6 +72,20 @@ RecordId extractRecordId(const std::string& keyStr) {
     ++it;
     return RecordId((*it).Long());
 }
+
+/**
+ * Returns ExceededMemoryLimit if storing 'bytesToInsert' more bytes in 'workingCopy' would take it
+ * past 'biggieMaxDataSizeBytes'. Capped collections bound their own size and are not checked.
+ */
+Status checkMemoryLimit(const StringStore& workingCopy, int64_t bytesToInsert) {
+    const long long limit = gBiggieMaxDataSizeBytes.load();
+    if (limit == 0 || static_cast<long long>(workingCopy.dataSize()) + bytesToInsert <= limit)
+        return Status::OK();
+    return Status(ErrorCodes::ExceededMemoryLimit,
+                  str::stream() << "inserting " << bytesToInsert
+                                << " bytes would exceed biggieMaxDataSizeBytes (" << limit
+                                << "); currently storing " << workingCopy.dataSize() << " bytes");
+}
 }  // namespace
 
 RecordStore::RecordStore(StringData ns,
@@ -162,6 +177,11 @@ Status RecordStore::insertRecords(OperationContext* opCtx,
 
     auto ru = RecoveryUnit::get(opCtx);
     StringStore* workingCopy(ru->getHead());
+    if (!_isCapped) {
+        Status status = checkMemoryLimit(*workingCopy, totalSize);
+        if (!status.isOK())
+            return status;
+    }
     {
         SizeAdjuster adjuster(opCtx, this);
         for (auto& record : *inOutRecords) {
@@ -202,6 +222,11 @@ Status RecordStore::insertRecordsWithDocWriter(OperationContext* opCtx,
 
     auto ru = RecoveryUnit::get(opCtx);
     StringStore* workingCopy(ru->getHead());
+    if (!_isCapped) {
+        Status status = checkMemoryLimit(*workingCopy, totalSize);
+        if (!status.isOK())
+            return status;
+    }
     {
         SizeAdjuster adjuster(opCtx, this);
         for (size_t i = 0; i < nDocs; i++) {
@@ -31,12 +31,15 @@
 
 #include "mongo/base/init.h"
 #include "mongo/db/storage/biggie/biggie_kv_engine.h"
+#include "mongo/db/storage/biggie/biggie_parameters_gen.h"
 #include "mongo/db/storage/biggie/biggie_record_store.h"
 #include "mongo/db/storage/biggie/biggie_recovery_unit.h"
 #include "mongo/db/storage/biggie/store.h"
 #include "mongo/db/storage/record_store_test_harness.h"
+#include "mongo/db/storage/write_unit_of_work.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace biggie {
@@ -97,6 +100,37 @@ MONGO_INITIALIZER(RegisterHarnessFactory)(InitializerContext* const) {
     mongo::registerHarnessHelperFactory(makeHarnessHelper);
     return Status::OK();
 }
+
+TEST(BiggieRecordStoreTest, InsertBeyondMemoryLimitFails) {
+    RecordStoreHarnessHelper harnessHelper;
+    auto rs = harnessHelper.newNonCappedRecordStore();
+    gBiggieMaxDataSizeBytes.store(100);
+    ON_BLOCK_EXIT([] { gBiggieMaxDataSizeBytes.store(0); });
+
+    const std::string data(60, 'x');
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(rs->insertRecord(opCtx.get(), data.c_str(), data.size(), Timestamp()));
+        uow.commit();
+    }
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_EQ(ErrorCodes::ExceededMemoryLimit,
+                  rs->insertRecord(opCtx.get(), data.c_str(), data.size(), Timestamp())
+                      .getStatus()
+                      .code());
+    }
+
+    gBiggieMaxDataSizeBytes.store(0);
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(rs->insertRecord(opCtx.get(), data.c_str(), data.size(), Timestamp()));
+        uow.commit();
+    }
+}
 }  // namespace
 }  // namespace biggie
 }  // namespace mongo
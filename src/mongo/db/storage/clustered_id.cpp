@@ -0,0 +1,100 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/clustered_id.h"
+
+#include <cmath>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace clusteredid {
+
+StatusWith<RecordId> keyForId(const BSONElement& id) {
+    long long repr;
+    switch (id.type()) {
+        case NumberInt:
+        case NumberLong:
+            repr = id.numberLong();
+            break;
+        case NumberDouble: {
+            const double value = id.numberDouble();
+            // Doubles at or above 2^63 cannot be represented as a RecordId; the bound is exact.
+            if (std::trunc(value) != value || value < 1 || value >= 9223372036854775808.0) {
+                return {ErrorCodes::BadValue,
+                        str::stream() << "_id of a clustered collection must be a positive "
+                                         "integer, found: "
+                                      << id};
+            }
+            repr = static_cast<long long>(value);
+            break;
+        }
+        case NumberDecimal: {
+            std::uint32_t signalingFlags = Decimal128::SignalingFlag::kNoFlag;
+            repr = id.numberDecimal().toLongExact(&signalingFlags);
+            if (signalingFlags != Decimal128::SignalingFlag::kNoFlag) {
+                return {ErrorCodes::BadValue,
+                        str::stream() << "_id of a clustered collection must be a positive "
+                                         "integer, found: "
+                                      << id};
+            }
+            break;
+        }
+        default:
+            return {ErrorCodes::BadValue,
+                    str::stream() << "_id of a clustered collection must be an integral number, "
+                                     "found type: "
+                                  << typeName(id.type())};
+    }
+
+    const RecordId out(repr);
+    if (!out.isNormal()) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "_id of a clustered collection is out of range: " << id};
+    }
+    return out;
+}
+
+StatusWith<RecordId> extractKey(const char* data, int len) {
+    const BSONObj obj(data);
+    invariant(obj.objsize() == len);
+
+    const BSONElement elem = obj["_id"];
+    if (elem.eoo())
+        return {ErrorCodes::BadValue, "document in a clustered collection must have an _id"};
+
+    return keyForId(elem);
+}
+
+}  // namespace clusteredid
+}  // namespace mongo
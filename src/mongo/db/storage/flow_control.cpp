@@ -91,7 +91,8 @@ FlowControl::FlowControl(ServiceContext* service, repl::ReplicationCoordinator*
     service->getPeriodicRunner()->scheduleJob(
         {"FlowControlRefresher",
          [this](Client* client) {
-             FlowControlTicketholder::get(client->getServiceContext())->refreshTo(getNumTickets());
+             FlowControlTicketholder::get(client->getServiceContext())
+                 ->refreshTo(getNumTickets(), gFlowControlShareByClient.load());
          },
          Seconds(1)});
 }
@@ -157,6 +158,7 @@ BSONObj FlowControl::generateSection(OperationContext* opCtx,
     bob.append("locksPerOp", _lastLocksPerOp.load());
     bob.append("sustainerRate", _lastSustainerAppliedCount.load());
     bob.append("isLagged", isFCV42 && !isArbiter && isLagged(myLastAppliedWall, lastCommittedWall));
+    FlowControlTicketholder::get(opCtx)->appendClientShares(&bob);
 
     return bob.obj();
 }
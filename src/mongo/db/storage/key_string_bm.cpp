@@ -35,6 +35,8 @@
 #include <random>
 #include <vector>
 
+#include "mongo/db/query/collation/collation_index_key.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
 #include "mongo/db/storage/key_string.h"
 #include "mongo/platform/decimal128.h"
 #include "mongo/util/bufreader.h"
@@ -47,6 +49,7 @@ std::mt19937_64 seedGen(1234);
 const int kSampleSize = 500;
 const int kStrLenMultiplier = 100;
 const int kArrLenMultiplier = 40;
+const int kBinDataLenMultiplier = 1000;
 
 const Ordering ALL_ASCENDING = Ordering::make(BSONObj());
 
@@ -66,8 +69,31 @@ enum BsonValueType {
     STRING,
     ARRAY,
     DECIMAL,
+    COLLATED_STRING,
+    NESTED_OBJECT,
+    BINDATA,
+    COMPOUND,
 };
 
+Decimal128 generateDecimal(std::mt19937& gen, std::exponential_distribution<double>& dist) {
+    return Decimal128(dist(gen), Decimal128::kRoundTo34Digits, Decimal128::kRoundTiesToAway)
+        .quantize(Decimal128("0.01", Decimal128::kRoundTiesToAway));
+}
+
+/**
+ * Returns a string of random lower and upper case letters, so that collation keys differ from the
+ * original strings.
+ */
+std::string generateLetters(std::mt19937& gen, size_t len) {
+    std::uniform_int_distribution<int> letter(0, 51);
+    std::string str(len, 'x');
+    for (auto&& c : str) {
+        int i = letter(gen);
+        c = i < 26 ? 'a' + i : 'A' + (i - 26);
+    }
+    return str;
+}
+
 BSONObj generateBson(BsonValueType bsonValueType) {
     std::mt19937 gen(seedGen());
     std::exponential_distribution<double> expReal(1e-3);
@@ -89,10 +115,37 @@ BSONObj generateBson(BsonValueType bsonValueType) {
             return BSON("" << BSON("a" << bab.arr()));
         }
         case DECIMAL:
-            return BSON("" << Decimal128(expReal(gen),
-                                         Decimal128::kRoundTo34Digits,
-                                         Decimal128::kRoundTiesToAway)
-                                  .quantize(Decimal128("0.01", Decimal128::kRoundTiesToAway)));
+            return BSON("" << generateDecimal(gen, expReal));
+        case COLLATED_STRING: {
+            // Index keys for strings are collation keys when the index has a collation.
+            static const CollatorInterfaceMock collator(
+                CollatorInterfaceMock::MockType::kToLowerString);
+            BSONObj str = BSON("" << generateLetters(gen, expDist(gen) * kStrLenMultiplier));
+            BSONObjBuilder bob;
+            CollationIndexKey::collationAwareIndexKeyAppend(str.firstElement(), &collator, &bob);
+            return bob.obj();
+        }
+        case NESTED_OBJECT:
+            return BSON("" << BSON("a" << static_cast<int>(expReal(gen)) << "b"
+                                       << BSON("c" << std::string(expDist(gen) * 10, 'x') << "d"
+                                                   << expReal(gen))
+                                       << "e"
+                                       << BSON_ARRAY(static_cast<long long>(expReal(gen))
+                                                     << true)));
+        case BINDATA: {
+            std::string data(expDist(gen) * kBinDataLenMultiplier, 'x');
+            BSONObjBuilder bob;
+            bob.appendBinData("", data.size(), BinDataGeneral, data.data());
+            return bob.obj();
+        }
+        case COMPOUND: {
+            // Resembles the key of a compound index such as {tenant: 1, status: 1, ts: 1, amt: 1}.
+            const auto ts =
+                Date_t::fromMillisSinceEpoch(static_cast<long long>(expReal(gen) * 1e6));
+            return BSON("" << static_cast<int>(expReal(gen)) << ""
+                           << generateLetters(gen, 1 + expDist(gen) * 10) << "" << ts << ""
+                           << generateDecimal(gen, expReal));
+        }
     }
     MONGO_UNREACHABLE;
 }
@@ -115,7 +168,7 @@ static BsonsAndKeyStrings generateBsonsAndKeyStrings(BsonValueType bsonValueType
 
         result.typebits[i] = SharedBuffer::allocate(ks.getTypeBits().getSize());
         memcpy(result.typebits[i].get(), ks.getTypeBits().getBuffer(), ks.getTypeBits().getSize());
-        result.typebitsLens[i] = ks.getSize();
+        result.typebitsLens[i] = ks.getTypeBits().getSize();
     }
     return result;
 }
@@ -153,6 +206,47 @@ void BM_KeyStringToBSON(benchmark::State& state,
     state.SetItemsProcessed(state.iterations() * kSampleSize);
 }
 
+void BM_KeyStringCompare(benchmark::State& state,
+                         const KeyString::Version version,
+                         BsonValueType bsonType) {
+    const BsonsAndKeyStrings bsonsAndKeyStrings = generateBsonsAndKeyStrings(bsonType, version);
+    std::vector<std::unique_ptr<KeyString>> keys;
+    for (size_t i = 0; i < kSampleSize; i++) {
+        keys.push_back(std::make_unique<KeyString>(version));
+        keys.back()->resetFromBuffer(bsonsAndKeyStrings.keystrings[i].get(),
+                                     bsonsAndKeyStrings.keystringLens[i]);
+    }
+
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        for (size_t i = 0; i + 1 < kSampleSize; i++) {
+            benchmark::DoNotOptimize(keys[i]->compare(*keys[i + 1]));
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * bsonsAndKeyStrings.keystringSize);
+    state.SetItemsProcessed(state.iterations() * (kSampleSize - 1));
+}
+
+void BM_TypeBitsFromBuffer(benchmark::State& state,
+                           const KeyString::Version version,
+                           BsonValueType bsonType) {
+    const BsonsAndKeyStrings bsonsAndKeyStrings = generateBsonsAndKeyStrings(bsonType, version);
+    size_t typeBitsSize = 0;
+    for (size_t i = 0; i < kSampleSize; i++) {
+        typeBitsSize += bsonsAndKeyStrings.typebitsLens[i];
+    }
+
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        for (size_t i = 0; i < kSampleSize; i++) {
+            BufReader buf(bsonsAndKeyStrings.typebits[i].get(), bsonsAndKeyStrings.typebitsLens[i]);
+            benchmark::DoNotOptimize(KeyString::TypeBits::fromBuffer(version, &buf));
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * typeBitsSize);
+    state.SetItemsProcessed(state.iterations() * kSampleSize);
+}
+
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_Int, KeyString::Version::V0, INT);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_Int, KeyString::Version::V1, INT);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_Double, KeyString::Version::V0, DOUBLE);
@@ -162,6 +256,13 @@ BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_String, KeyString::Version::V0, STRING)
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_String, KeyString::Version::V1, STRING);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_Array, KeyString::Version::V0, ARRAY);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_Array, KeyString::Version::V1, ARRAY);
+BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_CollatedString, KeyString::Version::V0, COLLATED_STRING);
+BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_CollatedString, KeyString::Version::V1, COLLATED_STRING);
+BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_NestedObject, KeyString::Version::V0, NESTED_OBJECT);
+BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_NestedObject, KeyString::Version::V1, NESTED_OBJECT);
+BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_BinData, KeyString::Version::V0, BINDATA);
+BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_BinData, KeyString::Version::V1, BINDATA);
+BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_Compound, KeyString::Version::V1, COMPOUND);
 
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V0_Int, KeyString::Version::V0, INT);
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_Int, KeyString::Version::V1, INT);
@@ -172,5 +273,52 @@ BENCHMARK_CAPTURE(BM_KeyStringToBSON, V0_String, KeyString::Version::V0, STRING)
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_String, KeyString::Version::V1, STRING);
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V0_Array, KeyString::Version::V0, ARRAY);
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_Array, KeyString::Version::V1, ARRAY);
+BENCHMARK_CAPTURE(BM_KeyStringToBSON, V0_CollatedString, KeyString::Version::V0, COLLATED_STRING);
+BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_CollatedString, KeyString::Version::V1, COLLATED_STRING);
+BENCHMARK_CAPTURE(BM_KeyStringToBSON, V0_NestedObject, KeyString::Version::V0, NESTED_OBJECT);
+BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_NestedObject, KeyString::Version::V1, NESTED_OBJECT);
+BENCHMARK_CAPTURE(BM_KeyStringToBSON, V0_BinData, KeyString::Version::V0, BINDATA);
+BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_BinData, KeyString::Version::V1, BINDATA);
+BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_Compound, KeyString::Version::V1, COMPOUND);
+
+BENCHMARK_CAPTURE(BM_KeyStringCompare, V0_Int, KeyString::Version::V0, INT);
+BENCHMARK_CAPTURE(BM_KeyStringCompare, V1_Int, KeyString::Version::V1, INT);
+BENCHMARK_CAPTURE(BM_KeyStringCompare, V0_Double, KeyString::Version::V0, DOUBLE);
+BENCHMARK_CAPTURE(BM_KeyStringCompare, V1_Double, KeyString::Version::V1, DOUBLE);
+BENCHMARK_CAPTURE(BM_KeyStringCompare, V1_Decimal, KeyString::Version::V1, DECIMAL);
+BENCHMARK_CAPTURE(BM_KeyStringCompare, V0_String, KeyString::Version::V0, STRING);
+BENCHMARK_CAPTURE(BM_KeyStringCompare, V1_String, KeyString::Version::V1, STRING);
+BENCHMARK_CAPTURE(BM_KeyStringCompare, V0_Array, KeyString::Version::V0, ARRAY);
+BENCHMARK_CAPTURE(BM_KeyStringCompare, V1_Array, KeyString::Version::V1, ARRAY);
+BENCHMARK_CAPTURE(BM_KeyStringCompare, V0_CollatedString, KeyString::Version::V0, COLLATED_STRING);
+BENCHMARK_CAPTURE(BM_KeyStringCompare, V1_CollatedString, KeyString::Version::V1, COLLATED_STRING);
+BENCHMARK_CAPTURE(BM_KeyStringCompare, V0_NestedObject, KeyString::Version::V0, NESTED_OBJECT);
+BENCHMARK_CAPTURE(BM_KeyStringCompare, V1_NestedObject, KeyString::Version::V1, NESTED_OBJECT);
+BENCHMARK_CAPTURE(BM_KeyStringCompare, V0_BinData, KeyString::Version::V0, BINDATA);
+BENCHMARK_CAPTURE(BM_KeyStringCompare, V1_BinData, KeyString::Version::V1, BINDATA);
+BENCHMARK_CAPTURE(BM_KeyStringCompare, V1_Compound, KeyString::Version::V1, COMPOUND);
+
+BENCHMARK_CAPTURE(BM_TypeBitsFromBuffer, V0_Int, KeyString::Version::V0, INT);
+BENCHMARK_CAPTURE(BM_TypeBitsFromBuffer, V1_Int, KeyString::Version::V1, INT);
+BENCHMARK_CAPTURE(BM_TypeBitsFromBuffer, V0_Double, KeyString::Version::V0, DOUBLE);
+BENCHMARK_CAPTURE(BM_TypeBitsFromBuffer, V1_Double, KeyString::Version::V1, DOUBLE);
+BENCHMARK_CAPTURE(BM_TypeBitsFromBuffer, V1_Decimal, KeyString::Version::V1, DECIMAL);
+BENCHMARK_CAPTURE(BM_TypeBitsFromBuffer, V0_String, KeyString::Version::V0, STRING);
+BENCHMARK_CAPTURE(BM_TypeBitsFromBuffer, V1_String, KeyString::Version::V1, STRING);
+BENCHMARK_CAPTURE(BM_TypeBitsFromBuffer, V0_Array, KeyString::Version::V0, ARRAY);
+BENCHMARK_CAPTURE(BM_TypeBitsFromBuffer, V1_Array, KeyString::Version::V1, ARRAY);
+BENCHMARK_CAPTURE(BM_TypeBitsFromBuffer,
+                  V0_CollatedString,
+                  KeyString::Version::V0,
+                  COLLATED_STRING);
+BENCHMARK_CAPTURE(BM_TypeBitsFromBuffer,
+                  V1_CollatedString,
+                  KeyString::Version::V1,
+                  COLLATED_STRING);
+BENCHMARK_CAPTURE(BM_TypeBitsFromBuffer, V0_NestedObject, KeyString::Version::V0, NESTED_OBJECT);
+BENCHMARK_CAPTURE(BM_TypeBitsFromBuffer, V1_NestedObject, KeyString::Version::V1, NESTED_OBJECT);
+BENCHMARK_CAPTURE(BM_TypeBitsFromBuffer, V0_BinData, KeyString::Version::V0, BINDATA);
+BENCHMARK_CAPTURE(BM_TypeBitsFromBuffer, V1_BinData, KeyString::Version::V1, BINDATA);
+BENCHMARK_CAPTURE(BM_TypeBitsFromBuffer, V1_Compound, KeyString::Version::V1, COMPOUND);
 }  // namespace
 }  // namespace mongo
@@ -226,6 +226,12 @@ public:
                       "The current storage engine doesn't support backup mode");
     }
 
+    virtual StatusWith<std::vector<StorageEngine::BackupFile>> beginNonBlockingIncrementalBackup(
+        OperationContext* opCtx, const StorageEngine::IncrementalBackupOptions& options) {
+        return Status(ErrorCodes::CommandNotSupported,
+                      "The current storage engine doesn't support incremental backup");
+    }
+
     virtual void endNonBlockingBackup(OperationContext* opCtx) {
         MONGO_UNREACHABLE;
     }
@@ -262,6 +268,13 @@ public:
         return true;
     }
 
+    /**
+     * This must not change over the lifetime of the engine.
+     */
+    virtual bool supportsClusteredCollections() const {
+        return false;
+    }
+
     /**
      * Returns true if storage engine supports --directoryperdb.
      * See:
@@ -43,13 +43,19 @@
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/db/storage/kv/kv_catalog_feature_tracker.h"
 #include "mongo/db/storage/kv/kv_engine.h"
+#include "mongo/db/storage/kv/spillable_record_store.h"
 #include "mongo/db/storage/kv/temporary_kv_record_store.h"
+#include "mongo/db/storage/storage_parameters_gen.h"
 #include "mongo/db/storage/storage_repair_observer.h"
 #include "mongo/db/unclean_shutdown.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -70,7 +76,8 @@ KVStorageEngine::KVStorageEngine(KVEngine* engine, KVStorageEngineOptions option
           [this](Timestamp timestamp) { _onMinOfCheckpointAndOldestTimestampChanged(timestamp); }),
       _supportsDocLocking(_engine->supportsDocLocking()),
       _supportsDBLocking(_engine->supportsDBLocking()),
-      _supportsCappedCollections(_engine->supportsCappedCollections()) {
+      _supportsCappedCollections(_engine->supportsCappedCollections()),
+      _supportsClusteredCollections(_engine->supportsClusteredCollections()) {
     uassert(28601,
             "Storage engine does not support --directoryperdb",
             !(options.directoryPerDB && !engine->supportsDirectoryPerDB()));
@@ -181,7 +188,9 @@ void KVStorageEngine::loadCatalog(OperationContext* opCtx) {
         }
     }
 
-    KVPrefix maxSeenPrefix = KVPrefix::kNotPrefixed;
+    Timer timer;
+    std::vector<std::string> collectionsToInit;
+    collectionsToInit.reserve(collectionsKnownToCatalog.size());
     for (const auto& coll : collectionsKnownToCatalog) {
         NamespaceString nss(coll);
         std::string dbName = nss.db().toString();
@@ -217,15 +226,19 @@ void KVStorageEngine::loadCatalog(OperationContext* opCtx) {
             }
         }
 
-        _catalog->initCollection(opCtx, coll, _options.forRepair);
-        auto maxPrefixForCollection = _catalog->getMetaData(opCtx, coll).getMaxPrefix();
-        maxSeenPrefix = std::max(maxSeenPrefix, maxPrefixForCollection);
-
         if (nss.isOrphanCollection()) {
             log() << "Orphaned collection found: " << nss;
         }
+        collectionsToInit.push_back(coll);
     }
 
+    const size_t numThreads =
+        std::min(static_cast<size_t>(gStorageEngineCatalogLoadThreads.load()),
+                 collectionsToInit.size());
+    const KVPrefix maxSeenPrefix = _initCollections(opCtx, collectionsToInit, numThreads);
+    log() << "Opened " << collectionsToInit.size() << " collections from the catalog in "
+          << timer.millis() << "ms using " << std::max(numThreads, size_t(1)) << " thread(s)";
+
     KVPrefix::setLargestPrefix(maxSeenPrefix);
     opCtx->recoveryUnit()->abandonSnapshot();
 
@@ -234,6 +247,64 @@ void KVStorageEngine::loadCatalog(OperationContext* opCtx) {
     startingAfterUncleanShutdown(getGlobalServiceContext()) = false;
 }
 
+KVPrefix KVStorageEngine::_initCollections(OperationContext* opCtx,
+                                          const std::vector<std::string>& collections,
+                                          size_t numThreads) {
+    KVPrefix maxSeenPrefix = KVPrefix::kNotPrefixed;
+    if (numThreads <= 1) {
+        for (const auto& coll : collections) {
+            _catalog->initCollection(opCtx, coll, _options.forRepair);
+            maxSeenPrefix =
+                std::max(maxSeenPrefix, _catalog->getMetaData(opCtx, coll).getMaxPrefix());
+        }
+        return maxSeenPrefix;
+    }
+
+    // Opening a record store reads its metadata from the storage engine, which dominates the time
+    // to load a catalog with many collections. Each thread claims the next unopened collection and
+    // reads through its own recovery unit. The KVCatalog and the UUIDCatalog are safe for
+    // concurrent use.
+    AtomicWord<size_t> nextCollection{0};
+    stdx::mutex mutex;
+    std::exception_ptr firstError;
+    auto initCollections = [&] {
+        OperationContextNoop workerOpCtx(_engine->newRecoveryUnit());
+        KVPrefix threadMaxPrefix = KVPrefix::kNotPrefixed;
+        try {
+            for (size_t i = nextCollection.fetchAndAdd(1); i < collections.size();
+                 i = nextCollection.fetchAndAdd(1)) {
+                _catalog->initCollection(&workerOpCtx, collections[i], _options.forRepair);
+                threadMaxPrefix = std::max(
+                    threadMaxPrefix,
+                    _catalog->getMetaData(&workerOpCtx, collections[i]).getMaxPrefix());
+            }
+        } catch (...) {
+            // Stop the other threads from claiming more work and report the first failure.
+            nextCollection.store(collections.size());
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            if (!firstError) {
+                firstError = std::current_exception();
+            }
+        }
+        workerOpCtx.recoveryUnit()->abandonSnapshot();
+
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        maxSeenPrefix = std::max(maxSeenPrefix, threadMaxPrefix);
+    };
+
+    std::vector<stdx::thread> threads;
+    for (size_t i = 0; i < numThreads; ++i) {
+        threads.emplace_back(initCollections);
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+    return maxSeenPrefix;
+}
+
 void KVStorageEngine::closeCatalog(OperationContext* opCtx) {
     dassert(opCtx->lockState()->isLocked());
     if (shouldLog(::mongo::logger::LogComponent::kStorageRecovery, kCatalogLogLevel)) {
@@ -605,6 +676,12 @@ StatusWith<std::vector<std::string>> KVStorageEngine::beginNonBlockingBackup(
     return _engine->beginNonBlockingBackup(opCtx);
 }
 
+StatusWith<std::vector<StorageEngine::BackupFile>>
+KVStorageEngine::beginNonBlockingIncrementalBackup(OperationContext* opCtx,
+                                                   const IncrementalBackupOptions& options) {
+    return _engine->beginNonBlockingIncrementalBackup(opCtx, options);
+}
+
 void KVStorageEngine::endNonBlockingBackup(OperationContext* opCtx) {
     return _engine->endNonBlockingBackup(opCtx);
 }
@@ -646,8 +723,19 @@ Status KVStorageEngine::repairRecordStore(OperationContext* opCtx, const std::st
 
 std::unique_ptr<TemporaryRecordStore> KVStorageEngine::makeTemporaryRecordStore(
     OperationContext* opCtx) {
-    std::unique_ptr<RecordStore> rs =
-        _engine->makeTemporaryRecordStore(opCtx, _catalog->newInternalIdent());
+    const std::string ident = _catalog->newInternalIdent();
+    const long long memoryLimitBytes = gTemporaryRecordStoreMemoryLimitBytes.load();
+    if (memoryLimitBytes > 0) {
+        // The table is only created in the engine if the records outgrow the memory limit.
+        LOG(1) << "created spillable temporary record store: " << ident;
+        auto rs = std::make_unique<SpillableRecordStore>(
+            ident, memoryLimitBytes, [ engine = _engine.get(), ident ](OperationContext * opCtx) {
+                return engine->makeTemporaryRecordStore(opCtx, ident);
+            });
+        return std::make_unique<TemporaryKVRecordStore>(getEngine(), std::move(rs));
+    }
+
+    std::unique_ptr<RecordStore> rs = _engine->makeTemporaryRecordStore(opCtx, ident);
     LOG(1) << "created temporary record store: " << rs->getIdent();
     return std::make_unique<TemporaryKVRecordStore>(getEngine(), std::move(rs));
 }
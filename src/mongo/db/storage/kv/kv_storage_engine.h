@@ -87,6 +87,10 @@ public:
         return _supportsCappedCollections;
     }
 
+    virtual bool supportsClusteredCollections() const {
+        return _supportsClusteredCollections;
+    }
+
     virtual Status closeDatabase(OperationContext* opCtx, StringData db);
 
     virtual Status dropDatabase(OperationContext* opCtx, StringData db);
@@ -99,6 +103,9 @@ public:
 
     virtual StatusWith<std::vector<std::string>> beginNonBlockingBackup(OperationContext* opCtx);
 
+    virtual StatusWith<std::vector<BackupFile>> beginNonBlockingIncrementalBackup(
+        OperationContext* opCtx, const IncrementalBackupOptions& options);
+
     virtual void endNonBlockingBackup(OperationContext* opCtx);
 
     virtual StatusWith<std::vector<std::string>> extendBackupCursor(OperationContext* opCtx);
@@ -363,6 +370,14 @@ private:
                                       const NamespaceString& collectionName,
                                       StringData collectionIdent);
 
+    /**
+     * Opens the record stores of 'collections' and registers their catalog entries, spreading the
+     * work over 'numThreads' threads. Returns the largest KVPrefix used by any of the collections.
+     */
+    KVPrefix _initCollections(OperationContext* opCtx,
+                              const std::vector<std::string>& collections,
+                              size_t numThreads);
+
     void _dumpCatalog(OperationContext* opCtx);
 
     /**
@@ -387,6 +402,7 @@ private:
     const bool _supportsDocLocking;
     const bool _supportsDBLocking;
     const bool _supportsCappedCollections;
+    const bool _supportsClusteredCollections;
     Timestamp _initialDataTimestamp = Timestamp::kAllowUnstableCheckpointsSentinel;
 
     std::unique_ptr<RecordStore> _catalogRecordStore;
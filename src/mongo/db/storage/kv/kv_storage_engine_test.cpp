@@ -46,12 +46,15 @@
 #include "mongo/db/storage/kv/kv_engine.h"
 #include "mongo/db/storage/kv/kv_storage_engine.h"
 #include "mongo/db/storage/kv/kv_storage_engine_test_fixture.h"
+#include "mongo/db/storage/storage_parameters_gen.h"
 #include "mongo/db/storage/storage_repair_observer.h"
+#include "mongo/db/storage/write_unit_of_work.h"
 #include "mongo/db/unclean_shutdown.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/barrier.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/periodic_runner_factory.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -154,6 +157,87 @@ TEST_F(KVStorageEngineTest, TemporaryDropsItself) {
     ASSERT(!identExists(opCtx.get(), ident));
 }
 
+TEST_F(KVStorageEngineTest, SpillableTemporaryCreatesIdentOnlyWhenItSpills) {
+    auto opCtx = cc().makeOperationContext();
+
+    gTemporaryRecordStoreMemoryLimitBytes.store(100);
+    ON_BLOCK_EXIT([] { gTemporaryRecordStoreMemoryLimitBytes.store(0); });
+
+    auto rs = makeTemporary(opCtx.get());
+    const std::string ident = rs->rs()->getIdent();
+    ASSERT(!identExists(opCtx.get(), ident));
+
+    auto insert = [&](const std::string& data) {
+        WriteUnitOfWork wuow(opCtx.get());
+        auto id = unittest::assertGet(
+            rs->rs()->insertRecord(opCtx.get(), data.c_str(), data.size(), Timestamp()));
+        wuow.commit();
+        return id;
+    };
+
+    // The first record fits in memory.
+    const std::string inMemory(60, 'a');
+    const RecordId first = insert(inMemory);
+    ASSERT(!identExists(opCtx.get(), ident));
+    ASSERT_EQ(1, rs->rs()->numRecords(opCtx.get()));
+
+    // The second record exceeds the limit, so it is written to the storage engine.
+    const std::string onDisk(60, 'b');
+    const RecordId second = insert(onDisk);
+    ASSERT(identExists(opCtx.get(), ident));
+    ASSERT_LT(first, second);
+    ASSERT_EQ(2, rs->rs()->numRecords(opCtx.get()));
+
+    // Cursors see the records of both tiers in RecordId order.
+    auto cursor = rs->rs()->getCursor(opCtx.get());
+    auto record = cursor->next();
+    ASSERT(record);
+    ASSERT_EQ(first, record->id);
+    ASSERT_EQ(inMemory, std::string(record->data.data(), record->data.size()));
+    record = cursor->next();
+    ASSERT(record);
+    ASSERT_EQ(second, record->id);
+    ASSERT_EQ(onDisk, std::string(record->data.data(), record->data.size()));
+    ASSERT(!cursor->next());
+
+    auto reverse = rs->rs()->getCursor(opCtx.get(), false);
+    ASSERT_EQ(second, reverse->next()->id);
+    ASSERT_EQ(first, reverse->next()->id);
+    ASSERT(!reverse->next());
+
+    {
+        WriteUnitOfWork wuow(opCtx.get());
+        rs->rs()->deleteRecord(opCtx.get(), first);
+        rs->rs()->deleteRecord(opCtx.get(), second);
+        wuow.commit();
+    }
+    ASSERT_EQ(0, rs->rs()->numRecords(opCtx.get()));
+
+    rs->deleteTemporaryTable(opCtx.get());
+    ASSERT(!identExists(opCtx.get(), ident));
+}
+
+TEST_F(KVStorageEngineTest, SpillableTemporaryThatNeverSpillsHasNoIdent) {
+    auto opCtx = cc().makeOperationContext();
+
+    gTemporaryRecordStoreMemoryLimitBytes.store(1024);
+    ON_BLOCK_EXIT([] { gTemporaryRecordStoreMemoryLimitBytes.store(0); });
+
+    auto rs = makeTemporary(opCtx.get());
+    const std::string data(10, 'a');
+    {
+        WriteUnitOfWork wuow(opCtx.get());
+        ASSERT_OK(rs->rs()
+                      ->insertRecord(opCtx.get(), data.c_str(), data.size(), Timestamp())
+                      .getStatus());
+        wuow.commit();
+    }
+    ASSERT(!identExists(opCtx.get(), rs->rs()->getIdent()));
+
+    // Deleting the temporary table does not need to drop anything.
+    rs->deleteTemporaryTable(opCtx.get());
+}
+
 TEST_F(KVStorageEngineTest, ReconcileDoesNotDropIndexBuildTempTables) {
     auto opCtx = cc().makeOperationContext();
 
@@ -0,0 +1,434 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/kv/spillable_record_store.h"
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/storage/recovery_unit.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+/**
+ * Iterates the in-memory records and then the on-disk records, or the reverse for a backward
+ * cursor. Because on-disk RecordIds sort after in-memory ones, this is RecordId order.
+ */
+class SpillableRecordStore::Cursor final : public SeekableRecordCursor {
+public:
+    Cursor(OperationContext* opCtx, const SpillableRecordStore& rs, bool forward)
+        : _opCtx(opCtx), _rs(rs), _forward(forward), _inMemoryPhase(forward) {}
+
+    boost::optional<Record> next() final {
+        if (_eof)
+            return {};
+
+        if (_inMemoryPhase) {
+            if (auto record = _rs._nextInMemory(_lastInMemory, _forward)) {
+                _lastInMemory = record->id;
+                return record;
+            }
+            if (!_forward) {
+                _eof = true;
+                return {};
+            }
+            _inMemoryPhase = false;
+        }
+
+        if (!_diskCursor) {
+            auto disk = _rs._diskRecordStore();
+            if (!disk) {
+                // Nothing has spilled. A backward cursor continues with the in-memory records.
+                _inMemoryPhase = !_forward;
+                return _forward ? boost::none : next();
+            }
+            _diskCursor = disk->getCursor(_opCtx, _forward);
+        }
+
+        auto record = _diskCursor->next();
+        if (!record) {
+            if (_forward) {
+                _eof = true;
+                return {};
+            }
+            _inMemoryPhase = true;
+            return next();
+        }
+        record->id = _rs._fromDiskId(record->id);
+        return record;
+    }
+
+    boost::optional<Record> seekExact(const RecordId& id) final {
+        _eof = false;
+        if (_rs._isInMemory(id)) {
+            _inMemoryPhase = true;
+            _lastInMemory = id;
+            RecordData data;
+            if (!_rs.findRecord(_opCtx, id, &data))
+                return {};
+            return Record{id, std::move(data)};
+        }
+
+        _inMemoryPhase = false;
+        if (!_diskCursor)
+            _diskCursor = _rs._diskRecordStore()->getCursor(_opCtx, _forward);
+        auto record = _diskCursor->seekExact(_rs._toDiskId(id));
+        if (record)
+            record->id = id;
+        return record;
+    }
+
+    void save() final {
+        if (_diskCursor)
+            _diskCursor->save();
+    }
+
+    void saveUnpositioned() final {
+        if (_diskCursor)
+            _diskCursor->saveUnpositioned();
+    }
+
+    bool restore() final {
+        return _diskCursor ? _diskCursor->restore() : true;
+    }
+
+    void detachFromOperationContext() final {
+        _opCtx = nullptr;
+        if (_diskCursor)
+            _diskCursor->detachFromOperationContext();
+    }
+
+    void reattachToOperationContext(OperationContext* opCtx) final {
+        _opCtx = opCtx;
+        if (_diskCursor)
+            _diskCursor->reattachToOperationContext(opCtx);
+    }
+
+private:
+    OperationContext* _opCtx;
+    const SpillableRecordStore& _rs;
+    const bool _forward;
+
+    bool _inMemoryPhase;
+    bool _eof = false;
+    boost::optional<RecordId> _lastInMemory;
+    std::unique_ptr<SeekableRecordCursor> _diskCursor;
+};
+
+SpillableRecordStore::SpillableRecordStore(StringData ident,
+                                           long long memoryLimitBytes,
+                                           MakeRecordStoreFn makeDiskRecordStore)
+    : RecordStore(""),
+      _ident(ident.toString()),
+      _memoryLimitBytes(memoryLimitBytes),
+      _makeDiskRecordStore(std::move(makeDiskRecordStore)) {}
+
+const char* SpillableRecordStore::name() const {
+    return "spillable";
+}
+
+const std::string& SpillableRecordStore::getIdent() const {
+    return _ident;
+}
+
+long long SpillableRecordStore::dataSize(OperationContext* opCtx) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _inMemoryBytes + (_disk ? _disk->dataSize(opCtx) : 0);
+}
+
+long long SpillableRecordStore::numRecords(OperationContext* opCtx) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return static_cast<long long>(_inMemory.size()) + (_disk ? _disk->numRecords(opCtx) : 0);
+}
+
+bool SpillableRecordStore::isCapped() const {
+    return false;
+}
+
+int64_t SpillableRecordStore::storageSize(OperationContext* opCtx,
+                                          BSONObjBuilder* extraInfo,
+                                          int infoLevel) const {
+    auto disk = _diskRecordStore();
+    return disk ? disk->storageSize(opCtx, extraInfo, infoLevel) : 0;
+}
+
+bool SpillableRecordStore::findRecord(OperationContext* opCtx,
+                                      const RecordId& loc,
+                                      RecordData* out) const {
+    if (!_isInMemory(loc))
+        return _diskRecordStore()->findRecord(opCtx, _toDiskId(loc), out);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _inMemory.find(loc);
+    if (it == _inMemory.end())
+        return false;
+    *out = RecordData(it->second.c_str(), it->second.size()).getOwned();
+    return true;
+}
+
+void SpillableRecordStore::deleteRecord(OperationContext* opCtx, const RecordId& dl) {
+    if (!_isInMemory(dl)) {
+        _diskRecordStore()->deleteRecord(opCtx, _toDiskId(dl));
+        return;
+    }
+
+    opCtx->recoveryUnit()->onCommit([this, dl](boost::optional<Timestamp>) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _inMemory.find(dl);
+        if (it == _inMemory.end())
+            return;
+        _inMemoryBytes -= it->second.size();
+        _inMemory.erase(it);
+    });
+}
+
+Status SpillableRecordStore::insertRecords(OperationContext* opCtx,
+                                           std::vector<Record>* inOutRecords,
+                                           const std::vector<Timestamp>& timestamps) {
+    long long bytes = 0;
+    for (auto& record : *inOutRecords) {
+        bytes += record.data.size();
+    }
+
+    std::vector<RecordId> ids;
+    if (auto disk = _reserveForInsert(opCtx, bytes, inOutRecords->size(), &ids)) {
+        auto status = disk->insertRecords(opCtx, inOutRecords, timestamps);
+        if (!status.isOK())
+            return status;
+        for (auto& record : *inOutRecords) {
+            record.id = _fromDiskId(record.id);
+        }
+        return Status::OK();
+    }
+
+    std::vector<std::pair<RecordId, std::string>> records;
+    records.reserve(inOutRecords->size());
+    for (size_t i = 0; i < inOutRecords->size(); i++) {
+        auto& record = (*inOutRecords)[i];
+        record.id = ids[i];
+        records.emplace_back(record.id, std::string(record.data.data(), record.data.size()));
+    }
+    _insertInMemoryOnCommit(opCtx, std::move(records), bytes);
+    return Status::OK();
+}
+
+Status SpillableRecordStore::insertRecordsWithDocWriter(OperationContext* opCtx,
+                                                        const DocWriter* const* docs,
+                                                        const Timestamp* timestamps,
+                                                        size_t nDocs,
+                                                        RecordId* idsOut) {
+    long long bytes = 0;
+    for (size_t i = 0; i < nDocs; i++) {
+        bytes += docs[i]->documentSize();
+    }
+
+    std::vector<RecordId> ids;
+    if (auto disk = _reserveForInsert(opCtx, bytes, nDocs, &ids)) {
+        std::vector<RecordId> diskIds(nDocs);
+        auto status =
+            disk->insertRecordsWithDocWriter(opCtx, docs, timestamps, nDocs, diskIds.data());
+        if (!status.isOK())
+            return status;
+        if (idsOut) {
+            for (size_t i = 0; i < nDocs; i++) {
+                idsOut[i] = _fromDiskId(diskIds[i]);
+            }
+        }
+        return Status::OK();
+    }
+
+    std::vector<std::pair<RecordId, std::string>> records;
+    records.reserve(nDocs);
+    for (size_t i = 0; i < nDocs; i++) {
+        std::string data(docs[i]->documentSize(), '\0');
+        docs[i]->writeDocument(&data[0]);
+        records.emplace_back(ids[i], std::move(data));
+        if (idsOut)
+            idsOut[i] = ids[i];
+    }
+    _insertInMemoryOnCommit(opCtx, std::move(records), bytes);
+    return Status::OK();
+}
+
+Status SpillableRecordStore::updateRecord(OperationContext* opCtx,
+                                          const RecordId& oldLocation,
+                                          const char* data,
+                                          int len) {
+    if (!_isInMemory(oldLocation))
+        return _diskRecordStore()->updateRecord(opCtx, _toDiskId(oldLocation), data, len);
+
+    opCtx->recoveryUnit()->onCommit(
+        [ this, oldLocation, newData = std::string(data, len) ](boost::optional<Timestamp>) {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            auto it = _inMemory.find(oldLocation);
+            if (it == _inMemory.end())
+                return;
+            _inMemoryBytes += static_cast<long long>(newData.size()) -
+                static_cast<long long>(it->second.size());
+            it->second = std::move(newData);
+        });
+    return Status::OK();
+}
+
+bool SpillableRecordStore::updateWithDamagesSupported() const {
+    return false;
+}
+
+StatusWith<RecordData> SpillableRecordStore::updateWithDamages(
+    OperationContext* opCtx,
+    const RecordId& loc,
+    const RecordData& oldRec,
+    const char* damageSource,
+    const mutablebson::DamageVector& damages) {
+    MONGO_UNREACHABLE;
+}
+
+std::unique_ptr<SeekableRecordCursor> SpillableRecordStore::getCursor(OperationContext* opCtx,
+                                                                      bool forward) const {
+    return std::make_unique<Cursor>(opCtx, *this, forward);
+}
+
+Status SpillableRecordStore::truncate(OperationContext* opCtx) {
+    if (auto disk = _diskRecordStore()) {
+        auto status = disk->truncate(opCtx);
+        if (!status.isOK())
+            return status;
+    }
+
+    opCtx->recoveryUnit()->onCommit([this](boost::optional<Timestamp>) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _inMemory.clear();
+        _inMemoryBytes = 0;
+    });
+    return Status::OK();
+}
+
+void SpillableRecordStore::cappedTruncateAfter(OperationContext* opCtx,
+                                               RecordId end,
+                                               bool inclusive) {
+    MONGO_UNREACHABLE;
+}
+
+void SpillableRecordStore::appendCustomStats(OperationContext* opCtx,
+                                             BSONObjBuilder* result,
+                                             double scale) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    result->appendNumber("inMemoryRecords", static_cast<long long>(_inMemory.size()));
+    result->appendNumber("inMemoryBytes", _inMemoryBytes / scale);
+    result->appendBool("spilled", static_cast<bool>(_disk));
+}
+
+bool SpillableRecordStore::hasSpilled() const {
+    return _diskRecordStore() != nullptr;
+}
+
+RecordStore* SpillableRecordStore::_reserveForInsert(OperationContext* opCtx,
+                                                     long long bytes,
+                                                     size_t numIds,
+                                                     std::vector<RecordId>* ids) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_disk && _inMemoryBytes + _pendingBytes + bytes > _memoryLimitBytes) {
+        // Every in-memory RecordId handed out so far sorts before the on-disk ones.
+        _diskIdOffset = _nextInMemoryId - 1;
+        _disk = _makeDiskRecordStore(opCtx);
+        LOG(1) << "temporary record store " << _ident << " spilled to disk after "
+               << _inMemory.size() << " records and " << _inMemoryBytes << " bytes";
+    }
+    if (_disk)
+        return _disk.get();
+
+    _pendingBytes += bytes;
+    ids->reserve(numIds);
+    for (size_t i = 0; i < numIds; i++) {
+        ids->push_back(RecordId(_nextInMemoryId++));
+    }
+    return nullptr;
+}
+
+void SpillableRecordStore::_insertInMemoryOnCommit(
+    OperationContext* opCtx,
+    std::vector<std::pair<RecordId, std::string>> records,
+    long long bytes) {
+    auto shared =
+        std::make_shared<std::vector<std::pair<RecordId, std::string>>>(std::move(records));
+    opCtx->recoveryUnit()->onCommit([this, shared, bytes](boost::optional<Timestamp>) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        for (auto& record : *shared) {
+            _inMemory.emplace(record.first, std::move(record.second));
+        }
+        _inMemoryBytes += bytes;
+        _pendingBytes -= bytes;
+    });
+    opCtx->recoveryUnit()->onRollback([this, bytes]() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _pendingBytes -= bytes;
+    });
+}
+
+RecordStore* SpillableRecordStore::_diskRecordStore() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _disk.get();
+}
+
+bool SpillableRecordStore::_isInMemory(const RecordId& id) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return !_disk || id.repr() <= _diskIdOffset;
+}
+
+RecordId SpillableRecordStore::_toDiskId(const RecordId& id) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return RecordId(id.repr() - _diskIdOffset);
+}
+
+RecordId SpillableRecordStore::_fromDiskId(const RecordId& id) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return RecordId(id.repr() + _diskIdOffset);
+}
+
+boost::optional<Record> SpillableRecordStore::_nextInMemory(
+    const boost::optional<RecordId>& last, bool forward) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    std::map<RecordId, std::string>::const_iterator it;
+    if (forward) {
+        it = last ? _inMemory.upper_bound(*last) : _inMemory.begin();
+        if (it == _inMemory.end())
+            return {};
+    } else {
+        it = last ? _inMemory.lower_bound(*last) : _inMemory.end();
+        if (it == _inMemory.begin())
+            return {};
+        --it;
+    }
+    return Record{it->first, RecordData(it->second.c_str(), it->second.size()).getOwned()};
+}
+
+}  // namespace mongo
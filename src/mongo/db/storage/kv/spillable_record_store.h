@@ -0,0 +1,175 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "mongo/db/storage/record_store.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+/**
+ * A RecordStore for temporary tables that keeps its records in memory until they exceed a size
+ * limit, and only then creates the on-disk record store and writes new records to it. Records
+ * already held in memory stay there, so short-lived temporary tables never touch the storage
+ * engine.
+ *
+ * Records held in memory become visible when their WriteUnitOfWork commits rather than through
+ * the recovery unit's snapshot, which is sufficient for the single-writer temporary tables used by
+ * index builds. Records are not durable until the store spills.
+ */
+class SpillableRecordStore final : public RecordStore {
+public:
+    using MakeRecordStoreFn = stdx::function<std::unique_ptr<RecordStore>(OperationContext*)>;
+
+    SpillableRecordStore(StringData ident,
+                         long long memoryLimitBytes,
+                         MakeRecordStoreFn makeDiskRecordStore);
+
+    const char* name() const final;
+    const std::string& getIdent() const final;
+    long long dataSize(OperationContext* opCtx) const final;
+    long long numRecords(OperationContext* opCtx) const final;
+    bool isCapped() const final;
+    int64_t storageSize(OperationContext* opCtx,
+                        BSONObjBuilder* extraInfo = nullptr,
+                        int infoLevel = 0) const final;
+
+    bool findRecord(OperationContext* opCtx, const RecordId& loc, RecordData* out) const final;
+
+    void deleteRecord(OperationContext* opCtx, const RecordId& dl) final;
+
+    Status insertRecords(OperationContext* opCtx,
+                         std::vector<Record>* inOutRecords,
+                         const std::vector<Timestamp>& timestamps) final;
+
+    Status insertRecordsWithDocWriter(OperationContext* opCtx,
+                                      const DocWriter* const* docs,
+                                      const Timestamp* timestamps,
+                                      size_t nDocs,
+                                      RecordId* idsOut) final;
+
+    Status updateRecord(OperationContext* opCtx,
+                        const RecordId& oldLocation,
+                        const char* data,
+                        int len) final;
+
+    bool updateWithDamagesSupported() const final;
+
+    StatusWith<RecordData> updateWithDamages(OperationContext* opCtx,
+                                             const RecordId& loc,
+                                             const RecordData& oldRec,
+                                             const char* damageSource,
+                                             const mutablebson::DamageVector& damages) final;
+
+    std::unique_ptr<SeekableRecordCursor> getCursor(OperationContext* opCtx,
+                                                    bool forward = true) const final;
+
+    Status truncate(OperationContext* opCtx) final;
+
+    void cappedTruncateAfter(OperationContext* opCtx, RecordId end, bool inclusive) final;
+
+    void appendCustomStats(OperationContext* opCtx,
+                           BSONObjBuilder* result,
+                           double scale) const final;
+
+    void waitForAllEarlierOplogWritesToBeVisible(OperationContext* opCtx) const final {}
+
+    void updateStatsAfterRepair(OperationContext* opCtx,
+                                long long numRecords,
+                                long long dataSize) final {}
+
+    /**
+     * Returns true once the on-disk record store has been created. Only then does the ident exist
+     * in the storage engine.
+     */
+    bool hasSpilled() const;
+
+private:
+    class Cursor;
+
+    /**
+     * Returns the on-disk record store that 'bytes' more bytes of inserts should go to, creating
+     * it if they no longer fit in memory, or nullptr if they should be held in memory. On return
+     * with nullptr, 'ids' holds 'numIds' newly reserved in-memory RecordIds.
+     */
+    RecordStore* _reserveForInsert(OperationContext* opCtx,
+                                   long long bytes,
+                                   size_t numIds,
+                                   std::vector<RecordId>* ids);
+
+    /**
+     * Holds 'records' in memory once the current WriteUnitOfWork commits.
+     */
+    void _insertInMemoryOnCommit(OperationContext* opCtx,
+                                 std::vector<std::pair<RecordId, std::string>> records,
+                                 long long bytes);
+
+    /**
+     * Returns the on-disk record store, or nullptr if the store has not spilled.
+     */
+    RecordStore* _diskRecordStore() const;
+
+    bool _isInMemory(const RecordId& id) const;
+    RecordId _toDiskId(const RecordId& id) const;
+    RecordId _fromDiskId(const RecordId& id) const;
+
+    /**
+     * Returns an owned copy of the first in-memory record after 'last' in the direction of
+     * iteration, or of the first record if 'last' is unset.
+     */
+    boost::optional<Record> _nextInMemory(const boost::optional<RecordId>& last,
+                                          bool forward) const;
+
+    const std::string _ident;
+    const long long _memoryLimitBytes;
+    const MakeRecordStoreFn _makeDiskRecordStore;
+
+    mutable stdx::mutex _mutex;
+
+    // Committed in-memory records and their total size.
+    std::map<RecordId, std::string> _inMemory;
+    long long _inMemoryBytes = 0;
+
+    // Bytes reserved by inserts whose WriteUnitOfWork has not yet resolved.
+    long long _pendingBytes = 0;
+    int64_t _nextInMemoryId = 1;
+
+    // Set once when spilling, and never reset. On-disk RecordIds are offset by '_diskIdOffset' so
+    // that they sort after every in-memory RecordId.
+    std::unique_ptr<RecordStore> _disk;
+    int64_t _diskIdOffset = 0;
+};
+
+}  // namespace mongo
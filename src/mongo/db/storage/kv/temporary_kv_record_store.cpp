@@ -34,6 +34,7 @@
 #include "mongo/db/storage/kv/temporary_kv_record_store.h"
 
 #include "mongo/db/storage/kv/kv_engine.h"
+#include "mongo/db/storage/kv/spillable_record_store.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/str.h"
 
@@ -44,6 +45,13 @@ TemporaryKVRecordStore::~TemporaryKVRecordStore() {
 }
 
 void TemporaryKVRecordStore::deleteTemporaryTable(OperationContext* opCtx) {
+    // A spillable record store that never spilled has no table in the storage engine.
+    auto spillable = dynamic_cast<SpillableRecordStore*>(_rs.get());
+    if (spillable && !spillable->hasSpilled()) {
+        _recordStoreHasBeenDeleted = true;
+        return;
+    }
+
     auto status = _kvEngine->dropIdent(opCtx, _rs->getIdent());
     fassert(
         51032,
@@ -0,0 +1,188 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <boost/filesystem/path.hpp>
+#include <random>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/client.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/storage/mobile/mobile_options.h"
+#include "mongo/db/storage/mobile/mobile_record_store.h"
+#include "mongo/db/storage/mobile/mobile_recovery_unit.h"
+#include "mongo/db/storage/mobile/mobile_session_pool.h"
+#include "mongo/db/storage/write_unit_of_work.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+const std::string kIdent = "mobile_bm";
+
+/**
+ * Returns a document shaped like a typical reading uploaded by an edge device.
+ */
+BSONObj makeEdgePayload(int i) {
+    BSONObjBuilder bob;
+    bob.append("deviceId", "sensor-" + std::to_string(i % 64));
+    bob.appendDate("ts", Date_t::fromMillisSinceEpoch(1546300800000LL + i * 1000LL));
+    bob.append("temperature", 20.0 + (i % 100) / 10.0);
+    bob.append("humidity", 40 + i % 30);
+    bob.append("battery", 100 - i % 100);
+    bob.append("status", i % 10 ? "ok" : "degraded");
+    return bob.obj();
+}
+
+/**
+ * Opens a mobile record store in a temporary directory, with the statement cache sized by
+ * 'statementCacheSize'.
+ */
+class MobileBenchmarkHarness {
+public:
+    explicit MobileBenchmarkHarness(int statementCacheSize)
+        : _dbPath("mobile_bm"), _threadClient(getGlobalServiceContext()) {
+        embedded::mobileGlobalOptions.durabilityLevel = 1;
+        embedded::mobileGlobalOptions.cacheSizeKB = 10240;
+        embedded::mobileGlobalOptions.mmapSizeKB = 51200;
+        embedded::mobileGlobalOptions.journalSizeLimitKB = 5120;
+        embedded::mobileGlobalOptions.walAutoCheckpointPages = 1000;
+        embedded::mobileGlobalOptions.statementCacheSize = statementCacheSize;
+
+        const std::string path =
+            (boost::filesystem::path(_dbPath.path()) / "mobile.sqlite").string();
+        _sessionPool = std::make_unique<MobileSessionPool>(path, embedded::mobileGlobalOptions);
+
+        _opCtx = cc().makeOperationContext();
+        _opCtx->setRecoveryUnit(std::make_unique<MobileRecoveryUnit>(_sessionPool.get()),
+                                WriteUnitOfWork::RecoveryUnitState::kNotInUnitOfWork);
+
+        MobileRecordStore::create(_opCtx.get(), kIdent);
+        _rs = std::make_unique<MobileRecordStore>(
+            _opCtx.get(), kIdent, path, kIdent, CollectionOptions());
+    }
+
+    ~MobileBenchmarkHarness() {
+        _rs.reset();
+        _opCtx.reset();
+        _sessionPool->shutDown();
+    }
+
+    OperationContext* opCtx() const {
+        return _opCtx.get();
+    }
+
+    RecordStore* rs() const {
+        return _rs.get();
+    }
+
+    /**
+     * Inserts 'numDocs' payloads in write units of 'batchSize' documents each.
+     */
+    void insert(int numDocs, int batchSize) {
+        int i = 0;
+        while (i < numDocs) {
+            WriteUnitOfWork wuow(opCtx());
+            for (int j = 0; j < batchSize && i < numDocs; j++, i++) {
+                BSONObj doc = makeEdgePayload(i);
+                invariant(
+                    rs()->insertRecord(opCtx(), doc.objdata(), doc.objsize(), Timestamp()).isOK());
+            }
+            wuow.commit();
+        }
+    }
+
+private:
+    unittest::TempDir _dbPath;
+    ThreadClient _threadClient;
+    std::unique_ptr<MobileSessionPool> _sessionPool;
+    ServiceContext::UniqueOperationContext _opCtx;
+    std::unique_ptr<RecordStore> _rs;
+};
+
+void BM_MobileInsert(benchmark::State& state) {
+    const int batchSize = state.range(0);
+    MobileBenchmarkHarness harness(state.range(1));
+
+    int i = 0;
+    for (auto keepRunning : state) {
+        WriteUnitOfWork wuow(harness.opCtx());
+        for (int j = 0; j < batchSize; j++, i++) {
+            BSONObj doc = makeEdgePayload(i);
+            benchmark::DoNotOptimize(harness.rs()->insertRecord(
+                harness.opCtx(), doc.objdata(), doc.objsize(), Timestamp()));
+        }
+        wuow.commit();
+    }
+    state.SetItemsProcessed(state.iterations() * batchSize);
+}
+
+void BM_MobileFindRecord(benchmark::State& state) {
+    const int numDocs = 10000;
+    MobileBenchmarkHarness harness(state.range(0));
+    harness.insert(numDocs, 100);
+
+    std::mt19937 gen(1234);
+    std::uniform_int_distribution<int64_t> dist(1, numDocs);
+    for (auto keepRunning : state) {
+        RecordData data;
+        benchmark::DoNotOptimize(
+            harness.rs()->findRecord(harness.opCtx(), RecordId(dist(gen)), &data));
+        harness.opCtx()->recoveryUnit()->abandonSnapshot();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_MobileScan(benchmark::State& state) {
+    const int numDocs = 10000;
+    MobileBenchmarkHarness harness(state.range(0));
+    harness.insert(numDocs, 100);
+
+    for (auto keepRunning : state) {
+        auto cursor = harness.rs()->getCursor(harness.opCtx());
+        while (auto record = cursor->next()) {
+            benchmark::DoNotOptimize(record->data.size());
+        }
+        cursor.reset();
+        harness.opCtx()->recoveryUnit()->abandonSnapshot();
+    }
+    state.SetItemsProcessed(state.iterations() * numDocs);
+}
+
+// Arguments are the number of inserts per write unit and the statement cache size.
+BENCHMARK(BM_MobileInsert)->Args({1, 0})->Args({1, 64})->Args({16, 64})->Args({256, 64});
+// The argument is the statement cache size.
+BENCHMARK(BM_MobileFindRecord)->Arg(0)->Arg(64);
+BENCHMARK(BM_MobileScan)->Arg(0)->Arg(64);
+
+}  // namespace
+}  // namespace mongo
@@ -103,6 +103,18 @@ MobileKVEngine::MobileKVEngine(const std::string& path,
                                         Minutes(options.vacuumCheckIntervalMinutes)));
         _vacuumJob->start();
     }
+
+    if (_options.walCheckpointIntervalSeconds > 0) {
+        _walCheckpointJob = serviceContext->getPeriodicRunner()->makeJob(
+            PeriodicRunner::PeriodicJob("SQLiteWALCheckpointJob",
+                                        [this](Client* client) {
+                                            if (!client->getServiceContext()->getStorageEngine())
+                                                return;
+                                            _checkpointWAL(client);
+                                        },
+                                        Seconds(options.walCheckpointIntervalSeconds)));
+        _walCheckpointJob->start();
+    }
 }
 
 void MobileKVEngine::cleanShutdown() {
@@ -154,6 +166,29 @@ void MobileKVEngine::maybeVacuum(Client* client, Date_t deadline) {
     }
 }
 
+void MobileKVEngine::_checkpointWAL(Client* client) {
+    auto opCtx = client->makeOperationContext();
+
+    // Taking an intent lock keeps the checkpoint from racing with shutdown.
+    Lock::GlobalLock lk(opCtx.get(), MODE_IS);
+    auto session = _sessionPool->getSession(opCtx.get());
+
+    int framesInWAL = 0;
+    int checkpointedFrames = 0;
+    int ret = sqlite3_wal_checkpoint_v2(session->getSession(),
+                                        NULL,
+                                        SQLITE_CHECKPOINT_PASSIVE,
+                                        &framesInWAL,
+                                        &checkpointedFrames);
+    if (ret == SQLITE_BUSY) {
+        // Another checkpoint is running, so there is nothing for this one to do.
+        return;
+    }
+    embedded::checkStatus(ret, SQLITE_OK, "sqlite3_wal_checkpoint_v2");
+    LOG(MOBILE_LOG_LEVEL_LOW) << "MobileSE: Checkpointed " << checkpointedFrames << " of the "
+                              << framesInWAL << " total frames in the WAL";
+}
+
 void MobileKVEngine::_initDBPath(const std::string& path) {
     boost::system::error_code err;
     boost::filesystem::path dbPath(path);
@@ -139,6 +139,11 @@ public:
 private:
     void maybeVacuum(Client* client, Date_t deadline);
 
+    /**
+     * Checkpoints as much of the write-ahead log as possible without waiting on other sessions.
+     */
+    void _checkpointWAL(Client* client);
+
     mutable stdx::mutex _mutex;
     void _initDBPath(const std::string& path);
     std::int32_t _setSQLitePragma(const std::string& pragma, sqlite3* session);
@@ -152,6 +157,7 @@ private:
     embedded::MobileOptions _options;
 
     std::unique_ptr<PeriodicRunner::PeriodicJobHandle> _vacuumJob;
+    std::unique_ptr<PeriodicRunner::PeriodicJobHandle> _walCheckpointJob;
 };
 
 }  // namespace mongo
@@ -43,6 +43,9 @@ struct MobileOptions {
     uint32_t cacheSizeKB = 0;
     uint32_t mmapSizeKB = 0;
     uint32_t journalSizeLimitKB = 0;
+    uint32_t statementCacheSize = 0;
+    uint32_t walAutoCheckpointPages = 0;
+    uint32_t walCheckpointIntervalSeconds = 0;
 
     double vacuumFreePageRatio = 0.0;
     uint32_t vacuumFreeSizeMB = 0;
@@ -36,8 +36,53 @@
 
 namespace mongo {
 
-MobileSession::MobileSession(sqlite3* session, MobileSessionPool* sessionPool)
-    : _session(session), _sessionPool(sessionPool) {}
+MobileStatementCache::MobileStatementCache(size_t capacity) : _capacity(capacity) {}
+
+MobileStatementCache::~MobileStatementCache() {
+    for (auto&& entry : _statements) {
+        sqlite3_finalize(entry.second);
+    }
+}
+
+sqlite3_stmt* MobileStatementCache::take(const char* sql) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _index.find(sql);
+    if (it == _index.end()) {
+        return nullptr;
+    }
+    sqlite3_stmt* stmt = it->second->second;
+    _statements.erase(it->second);
+    _index.erase(it);
+    return stmt;
+}
+
+void MobileStatementCache::put(const char* sql, sqlite3_stmt* stmt) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    if (_capacity == 0 || _index.count(sql)) {
+        lk.unlock();
+        sqlite3_finalize(stmt);
+        return;
+    }
+
+    sqlite3_stmt* evicted = nullptr;
+    if (_statements.size() == _capacity) {
+        evicted = _statements.back().second;
+        _index.erase(_statements.back().first);
+        _statements.pop_back();
+    }
+    _statements.emplace_front(sql, stmt);
+    _index.emplace(_statements.front().first, _statements.begin());
+    lk.unlock();
+
+    if (evicted) {
+        sqlite3_finalize(evicted);
+    }
+}
+
+MobileSession::MobileSession(sqlite3* session,
+                             MobileSessionPool* sessionPool,
+                             MobileStatementCache* statementCache)
+    : _session(session), _sessionPool(sessionPool), _statementCache(statementCache) {}
 
 MobileSession::~MobileSession() {
     // Releases this session back to the session pool.
@@ -29,14 +29,56 @@
 
 #pragma once
 
+#include <list>
 #include <sqlite3.h>
 #include <string>
 
 #include "mongo/db/storage/mobile/mobile_session_pool.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
 class MobileSessionPool;
 
+/**
+ * This class caches prepared statements of a SQLite database connection by their SQL text, so that
+ * statements run repeatedly on the connection are only prepared once. It keeps at most 'capacity'
+ * statements, evicting the least recently used one.
+ */
+class MobileStatementCache final {
+    MobileStatementCache(const MobileStatementCache&) = delete;
+    MobileStatementCache& operator=(const MobileStatementCache&) = delete;
+
+public:
+    explicit MobileStatementCache(size_t capacity);
+
+    /**
+     * Finalizes all cached statements.
+     */
+    ~MobileStatementCache();
+
+    /**
+     * Removes and returns a cached statement for 'sql', or returns nullptr if there is none.
+     */
+    sqlite3_stmt* take(const char* sql);
+
+    /**
+     * Caches a reset statement for 'sql', or finalizes it if the cache is disabled or already holds
+     * a statement for 'sql'.
+     */
+    void put(const char* sql, sqlite3_stmt* stmt);
+
+private:
+    using StatementList = std::list<std::pair<std::string, sqlite3_stmt*>>;
+
+    const size_t _capacity;
+
+    stdx::mutex _mutex;
+    // Most recently used first.
+    StatementList _statements;
+    stdx::unordered_map<std::string, StatementList::iterator> _index;
+};
+
 /**
  * This class manages a SQLite database connection object.
  */
@@ -45,7 +87,9 @@ class MobileSession final {
     MobileSession& operator=(const MobileSession&) = delete;
 
 public:
-    MobileSession(sqlite3* session, MobileSessionPool* sessionPool);
+    MobileSession(sqlite3* session,
+                  MobileSessionPool* sessionPool,
+                  MobileStatementCache* statementCache = nullptr);
 
     ~MobileSession();
 
@@ -54,8 +98,17 @@ public:
      */
     sqlite3* getSession() const;
 
+    /**
+     * Returns the prepared statement cache of the underlying connection, or nullptr if the
+     * connection does not cache statements.
+     */
+    MobileStatementCache* getStatementCache() const {
+        return _statementCache;
+    }
+
 private:
     sqlite3* _session;
     MobileSessionPool* _sessionPool;
+    MobileStatementCache* _statementCache;
 };
 }  // namespace mongo
@@ -55,6 +55,19 @@ void SqliteStatement::finalize() {
     if (!_stmt) {
         return;
     }
+
+    // A statement that has not failed resets cleanly, so it can be reused.
+    if (_statementCache && _exceptionStatus == SQLITE_OK &&
+        (_lastStepStatus == SQLITE_OK || _lastStepStatus == SQLITE_ROW ||
+         _lastStepStatus == SQLITE_DONE)) {
+        SQLITE_STMT_TRACE() << "Returning to statement cache: " << _sqlQuery.data();
+        reset();
+        clearBindings();
+        _statementCache->put(_sqlQuery.data(), _stmt);
+        _stmt = NULL;
+        return;
+    }
+
     SQLITE_STMT_TRACE() << "Finalize: " << _sqlQuery.data();
 
     int status = sqlite3_finalize(_stmt);
@@ -63,6 +76,13 @@ void SqliteStatement::finalize() {
 }
 
 void SqliteStatement::prepare(const MobileSession& session) {
+    _statementCache = session.getStatementCache();
+    _lastStepStatus = SQLITE_OK;
+    if (_statementCache && (_stmt = _statementCache->take(_sqlQuery.data()))) {
+        SQLITE_STMT_TRACE() << "Reusing cached statement: " << _sqlQuery.data();
+        return;
+    }
+
     SQLITE_STMT_TRACE() << "Preparing: " << _sqlQuery.data();
 
     int status =
@@ -114,6 +134,7 @@ void SqliteStatement::clearBindings() {
 
 int SqliteStatement::step(int desiredStatus) {
     int status = sqlite3_step(_stmt);
+    _lastStepStatus = status;
 
     // A non-negative desiredStatus indicates that checkStatus should assert that the returned
     // status is equivalent to the desired status.
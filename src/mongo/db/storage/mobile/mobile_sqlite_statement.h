@@ -143,12 +143,14 @@ public:
     }
 
     /**
-     * Finalizes a prepared statement.
+     * Finalizes a prepared statement. If the statement came from a session with a statement cache
+     * and did not fail, it is reset and returned to the cache instead.
      */
     void finalize();
 
     /**
-     * Prepare a statement with the given mobile session.
+     * Prepare a statement with the given mobile session, reusing a statement from the session's
+     * statement cache if it has one with the same SQL text.
      */
     void prepare(const MobileSession& session);
 
@@ -162,6 +164,12 @@ private:
     static AtomicWord<long long> _nextID;
     sqlite3_stmt* _stmt;
 
+    // The cache of the session this statement was prepared on, if any.
+    MobileStatementCache* _statementCache = nullptr;
+
+    // The status returned by the most recent call to sqlite3_step on this statement.
+    int _lastStepStatus = SQLITE_OK;
+
     // If the most recent call to sqlite3_step on this statement returned an error, the error is
     // returned again when the statement is finalized. This is used to verify that the last error
     // code returned matches the finalize error code, if there is any.
@@ -209,6 +209,7 @@ void configureSession(sqlite3* session, const MobileOptions& options) {
     executePragma("cache_size"_sd, std::to_string(-static_cast<int32_t>(options.cacheSizeKB)));
     executePragma("mmap_size"_sd, std::to_string(options.mmapSizeKB * 1024));
     executePragma("journal_size_limit"_sd, std::to_string(options.journalSizeLimitKB * 1024));
+    executePragma("wal_autocheckpoint"_sd, std::to_string(options.walAutoCheckpointPages));
 }
 
 }  // namespace embedded
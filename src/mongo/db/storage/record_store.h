@@ -37,6 +37,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/record_data.h"
+#include "mongo/util/duration.h"
 
 namespace mongo {
 
@@ -56,10 +57,19 @@ struct CompactOptions {
     // other
     bool validateDocuments = true;
 
+    // Compact in short chunks that hold the collection lock in MODE_IX, releasing it in between.
+    bool online = false;
+
+    // With 'online', the rate in bytes per second at which to reclaim space, or 0 for no limit.
+    long long maxBytesPerSecond = 0;
+
     std::string toString() const;
 };
 
-struct CompactStats {};
+struct CompactStats {
+    // The number of bytes of storage an online compaction gave back.
+    long long bytesReclaimed = 0;
+};
 
 /**
  * Allows inserting a Record "in-place" without creating a copy ahead of time.
@@ -280,6 +290,14 @@ public:
 
     virtual bool isCapped() const = 0;
 
+    /**
+     * Returns true if records are keyed by the RecordId derived from their _id (see
+     * clustered_id.h), so that a document can be found by _id without an index.
+     */
+    virtual bool isClustered() const {
+        return false;
+    }
+
     virtual void setCappedCallback(CappedCallback*) {
         MONGO_UNREACHABLE;
     }
@@ -390,6 +408,32 @@ public:
         return out;
     }
 
+    /**
+     * Appends records to an empty RecordStore without going through the storage engine's
+     * transactional write path. Appended records are untimestamped and are not undone if the
+     * enclosing unit of work rolls back, and the RecordStore may not be read or written by anyone
+     * else until the loader is destroyed.
+     */
+    class BulkLoader {
+    public:
+        virtual ~BulkLoader() = default;
+
+        /**
+         * Appends a copy of the record and returns its RecordId.
+         */
+        virtual StatusWith<RecordId> insertRecord(const char* data, int len) = 0;
+    };
+
+    /**
+     * Returns a BulkLoader for this RecordStore, or nullptr if it is not empty or the storage
+     * engine cannot bulk load it, in which case callers should fall back to insertRecords(). Only
+     * for collections which are not yet visible to other operations and are discarded as a whole
+     * if loading fails, such as those being cloned by initial sync.
+     */
+    virtual std::unique_ptr<BulkLoader> makeBulkLoader(OperationContext* opCtx) {
+        return nullptr;
+    }
+
     /**
      * Updates the record with id 'recordId', replacing its contents with those described by
      * 'data' and 'len'.
@@ -500,6 +544,27 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    /**
+     * Can compactChunk() run while other operations read and write the RecordStore?
+     *
+     * Only called if compactSupported() returns true.
+     */
+    virtual bool compactsOnline() const {
+        return false;
+    }
+
+    /**
+     * Attempt to reduce the storage space used by this RecordStore for about 'timeLimit' at most,
+     * keeping any space reclaimed if the time runs out. Returns true once there is nothing left to
+     * compact, and false if it should be called again. Only needs the collection locked in
+     * MODE_IX.
+     *
+     * Only called if compactsOnline() returns true.
+     */
+    virtual StatusWith<bool> compactChunk(OperationContext* opCtx, Seconds timeLimit) {
+        MONGO_UNREACHABLE;
+    }
+
     /**
      * Does the RecordStore cursor retrieve its document in RecordId Order?
      *
@@ -129,6 +129,15 @@ public:
         return Status::OK();
     }
 
+    /**
+     * Attempt to reduce the storage space used by this index for about 'timeLimit' at most, while
+     * other operations read and write it. Returns true once there is nothing left to compact.
+     * Only called if the indexed record store supports online compaction.
+     */
+    virtual StatusWith<bool> compactChunk(OperationContext* opCtx, Seconds timeLimit) {
+        return true;
+    }
+
     //
     // Information about the tree
     //
@@ -32,6 +32,8 @@
 #include <string>
 #include <vector>
 
+#include <boost/optional.hpp>
+
 #include "mongo/base/status.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/timestamp.h"
@@ -195,6 +197,14 @@ public:
         return true;
     }
 
+    /**
+     * Returns whether the storage engine supports clustered collections, whose records are keyed
+     * by their _id rather than by a generated RecordId.
+     */
+    virtual bool supportsClusteredCollections() const {
+        return false;
+    }
+
     /**
      * Returns whether the engine supports a journalling concept or not.
      */
@@ -269,6 +279,33 @@ public:
                       "The current storage engine does not support a concurrent mode.");
     }
 
+    /**
+     * A file to copy for an incremental backup. Files that are not 'changed' have the same
+     * content as in the backup the incremental backup was taken relative to.
+     */
+    struct BackupFile {
+        std::string filename;
+        bool changed;
+    };
+
+    struct IncrementalBackupOptions {
+        // Name under which the state of this backup is recorded, so that later backups can be
+        // taken relative to it.
+        std::string thisBackupName;
+        // Backup to compare against. If unset, every file is reported as changed.
+        boost::optional<std::string> srcBackupName;
+    };
+
+    /**
+     * Like beginNonBlockingBackup(), but reports for each file whether it changed since the backup
+     * named by 'options.srcBackupName'. The backup is closed with endNonBlockingBackup().
+     */
+    virtual StatusWith<std::vector<BackupFile>> beginNonBlockingIncrementalBackup(
+        OperationContext* opCtx, const IncrementalBackupOptions& options) {
+        return Status(ErrorCodes::CommandNotSupported,
+                      "The current storage engine does not support incremental backup.");
+    }
+
     virtual void endNonBlockingBackup(OperationContext* opCtx) {
         return;
     }
@@ -0,0 +1,250 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_incremental_backup.h"
+
+#include <boost/filesystem.hpp>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+
+#include "mongo/base/data_range.h"
+#include "mongo/base/data_type_validated.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/storage/storage_file_util.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/rpc/object_check.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace wiredtiger_incremental_backup {
+
+const char kIncrementalBackupDirName[] = "incremental_backups";
+
+namespace {
+
+const char kBackupMetadataFileName[] = "WiredTiger.backup";
+const StringData kFileUriPrefix = "file:"_sd;
+const size_t kMaxBackupNameLength = 64;
+
+Status validateBackupName(StringData backupName) {
+    if (backupName.empty() || backupName.size() > kMaxBackupNameLength) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Backup name must be between 1 and " << kMaxBackupNameLength
+                              << " characters long: '"
+                              << backupName
+                              << "'"};
+    }
+    for (char c : backupName) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '-') {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "Backup name may only contain letters, digits, '_' and '-': '"
+                                  << backupName
+                                  << "'"};
+        }
+    }
+    return Status::OK();
+}
+
+boost::filesystem::path checkpointsPath(const std::string& dbPath, StringData backupName) {
+    return boost::filesystem::path(dbPath) / kIncrementalBackupDirName /
+        (backupName.toString() + ".bson");
+}
+
+StatusWith<std::string> readFile(const boost::filesystem::path& path) {
+    try {
+        std::ifstream ifs(path.c_str(), std::ios_base::in | std::ios_base::binary);
+        if (!ifs) {
+            return Status(ErrorCodes::FileNotOpen,
+                          str::stream() << "Failed to open " << path.string());
+        }
+        std::ostringstream contents;
+        contents << ifs.rdbuf();
+        if (ifs.bad()) {
+            return Status(ErrorCodes::FileStreamFailed,
+                          str::stream() << "Unable to read " << path.string());
+        }
+        return contents.str();
+    } catch (const std::exception& ex) {
+        return Status(ErrorCodes::FileStreamFailed,
+                      str::stream() << "Unexpected error reading " << path.string() << ": "
+                                    << ex.what());
+    }
+}
+
+}  // namespace
+
+StatusWith<FileCheckpoints> parseBackupMetadata(StringData contents) {
+    FileCheckpoints checkpoints;
+    size_t pos = 0;
+    while (pos < contents.size()) {
+        size_t keyEnd = contents.find('\n', pos);
+        if (keyEnd == std::string::npos) {
+            return Status(ErrorCodes::FailedToParse,
+                          "Backup metadata ends with a key that has no value");
+        }
+        StringData key = contents.substr(pos, keyEnd - pos);
+
+        size_t valueEnd = contents.find('\n', keyEnd + 1);
+        if (valueEnd == std::string::npos) {
+            valueEnd = contents.size();
+        }
+        StringData value = contents.substr(keyEnd + 1, valueEnd - keyEnd - 1);
+        pos = valueEnd + 1;
+
+        if (!key.startsWith(kFileUriPrefix)) {
+            continue;
+        }
+
+        WiredTigerConfigParser parser(value);
+        WT_CONFIG_ITEM checkpoint;
+        int ret = parser.get("checkpoint", &checkpoint);
+        if (ret == WT_NOTFOUND || checkpoint.len == 0) {
+            continue;
+        }
+        if (ret != 0) {
+            return wtRCToStatus(ret, "Failed to parse backup metadata");
+        }
+        checkpoints[key.substr(kFileUriPrefix.size()).toString()] =
+            std::string(checkpoint.str, checkpoint.len);
+    }
+    return checkpoints;
+}
+
+StatusWith<FileCheckpoints> readBackupMetadata(const std::string& dbPath) {
+    auto swContents = readFile(boost::filesystem::path(dbPath) / kBackupMetadataFileName);
+    if (!swContents.isOK()) {
+        return swContents.getStatus();
+    }
+    return parseBackupMetadata(swContents.getValue());
+}
+
+Status writeCheckpoints(const std::string& dbPath,
+                        StringData backupName,
+                        const FileCheckpoints& checkpoints) {
+    auto status = validateBackupName(backupName);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    BSONObjBuilder builder;
+    for (auto&& entry : checkpoints) {
+        builder.append(entry.first, entry.second);
+    }
+    BSONObj obj = builder.obj();
+
+    const auto path = checkpointsPath(dbPath, backupName);
+    const auto tempPath = boost::filesystem::path(path.string() + ".tmp");
+    try {
+        boost::filesystem::create_directories(path.parent_path());
+        {
+            std::ofstream ofs(tempPath.c_str(), std::ios_base::out | std::ios_base::binary);
+            if (!ofs) {
+                return Status(ErrorCodes::FileNotOpen,
+                              str::stream() << "Failed to open " << tempPath.string() << ": "
+                                            << errnoWithDescription());
+            }
+            ofs.write(obj.objdata(), obj.objsize());
+            if (!ofs) {
+                return Status(ErrorCodes::OperationFailed,
+                              str::stream() << "Failed to write BSON data to "
+                                            << tempPath.string()
+                                            << ": "
+                                            << errnoWithDescription());
+            }
+        }
+
+        status = fsyncFile(tempPath);
+        if (!status.isOK()) {
+            return status;
+        }
+        boost::filesystem::rename(tempPath, path);
+        return fsyncParentDirectory(path);
+    } catch (const std::exception& ex) {
+        return Status(ErrorCodes::FileRenameFailed,
+                      str::stream() << "Unexpected error while recording backup '" << backupName
+                                    << "' to "
+                                    << path.string()
+                                    << ": "
+                                    << ex.what());
+    }
+}
+
+StatusWith<FileCheckpoints> readCheckpoints(const std::string& dbPath, StringData backupName) {
+    auto status = validateBackupName(backupName);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    const auto path = checkpointsPath(dbPath, backupName);
+    if (!boost::filesystem::exists(path)) {
+        return Status(ErrorCodes::NoSuchKey,
+                      str::stream() << "No incremental backup named '" << backupName
+                                    << "' has been taken");
+    }
+
+    auto swContents = readFile(path);
+    if (!swContents.isOK()) {
+        return swContents.getStatus();
+    }
+    const auto& contents = swContents.getValue();
+    ConstDataRange cdr(contents.data(), contents.size());
+    auto swObj = cdr.readNoThrow<Validated<BSONObj>>();
+    if (!swObj.isOK()) {
+        return swObj.getStatus();
+    }
+
+    FileCheckpoints checkpoints;
+    for (auto&& elem : swObj.getValue().val) {
+        if (elem.type() != String) {
+            return Status(ErrorCodes::FailedToParse,
+                          str::stream() << "Corrupt incremental backup state in "
+                                        << path.string());
+        }
+        checkpoints[elem.fieldName()] = elem.str();
+    }
+    return checkpoints;
+}
+
+bool isUnchanged(const FileCheckpoints& previous,
+                 const FileCheckpoints& current,
+                 const std::string& file) {
+    auto previousIt = previous.find(file);
+    if (previousIt == previous.end()) {
+        return false;
+    }
+    auto currentIt = current.find(file);
+    return currentIt != current.end() && currentIt->second == previousIt->second;
+}
+
+}  // namespace wiredtiger_incremental_backup
+}  // namespace mongo
@@ -0,0 +1,99 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+
+namespace mongo {
+
+/**
+ * Support for incremental backups of a WiredTiger data directory.
+ *
+ * While a backup cursor is open, WiredTiger writes the metadata of every file in the backup to
+ * "WiredTiger.backup" in the database path. A file's metadata includes the checkpoint the backup
+ * copies, and the blocks of a checkpoint are never modified in place. A file whose checkpoint is
+ * the same in two backups therefore has the same content in both, and an incremental backup can
+ * skip copying it.
+ *
+ * The checkpoints seen by each named backup are persisted under
+ * "<dbpath>/incremental_backups/<name>.bson" so that a later backup can be taken relative to it.
+ */
+namespace wiredtiger_incremental_backup {
+
+/**
+ * Maps a file name, relative to the database path, to the checkpoint configuration of the file.
+ */
+using FileCheckpoints = std::map<std::string, std::string>;
+
+/**
+ * Name of the directory, relative to the database path, holding the persisted checkpoints.
+ */
+extern const char kIncrementalBackupDirName[];
+
+/**
+ * Parses the contents of a "WiredTiger.backup" metadata file, which holds alternating lines of
+ * metadata keys and values. Only "file:" entries with a checkpoint are returned.
+ */
+StatusWith<FileCheckpoints> parseBackupMetadata(StringData contents);
+
+/**
+ * Reads and parses the "WiredTiger.backup" file in 'dbPath'.
+ */
+StatusWith<FileCheckpoints> readBackupMetadata(const std::string& dbPath);
+
+/**
+ * Durably records 'checkpoints' as the state of the backup named 'backupName', replacing any
+ * previous state recorded under that name.
+ */
+Status writeCheckpoints(const std::string& dbPath,
+                        StringData backupName,
+                        const FileCheckpoints& checkpoints);
+
+/**
+ * Returns the checkpoints recorded for the backup named 'backupName', or NoSuchKey if no backup
+ * with that name has been taken.
+ */
+StatusWith<FileCheckpoints> readCheckpoints(const std::string& dbPath, StringData backupName);
+
+/**
+ * Returns true if 'file' has the same checkpoint in 'previous' and 'current'. Files missing from
+ * either map are treated as changed.
+ */
+bool isUnchanged(const FileCheckpoints& previous,
+                 const FileCheckpoints& current,
+                 const std::string& file);
+
+}  // namespace wiredtiger_incremental_backup
+}  // namespace mongo
@@ -0,0 +1,153 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+
+#include <wiredtiger.h>
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_incremental_backup.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace wiredtiger_incremental_backup {
+namespace {
+
+TEST(WiredTigerIncrementalBackupTest, ParsesFileCheckpoints) {
+    const std::string contents =
+        "file:collection-2.wt\n"
+        "allocation_size=4KB,checkpoint=(WiredTigerCheckpoint.3=(addr=\"01e3\",order=3)),"
+        "key_format=q\n"
+        "table:collection-2\n"
+        "colgroups=,key_format=q,value_format=u\n"
+        "file:db/index-3.wt\n"
+        "checkpoint=(WiredTigerCheckpoint.7=(addr=\"0a11\",order=7))\n"
+        "file:_mdb_catalog.wt\n"
+        "allocation_size=4KB,key_format=q\n";
+
+    auto swCheckpoints = parseBackupMetadata(contents);
+    ASSERT_OK(swCheckpoints.getStatus());
+    const auto& checkpoints = swCheckpoints.getValue();
+
+    // Only "file:" entries that have a checkpoint are reported.
+    ASSERT_EQ(2U, checkpoints.size());
+    ASSERT_EQ(1U, checkpoints.count("collection-2.wt"));
+    ASSERT_EQ(1U, checkpoints.count("db/index-3.wt"));
+    ASSERT_NE(checkpoints.at("collection-2.wt"), checkpoints.at("db/index-3.wt"));
+}
+
+TEST(WiredTigerIncrementalBackupTest, RejectsKeyWithoutValue) {
+    ASSERT_EQ(ErrorCodes::FailedToParse, parseBackupMetadata("file:collection-2.wt").getStatus());
+}
+
+TEST(WiredTigerIncrementalBackupTest, CheckpointsRoundTrip) {
+    unittest::TempDir dbPath("wiredtiger_incremental_backup_test");
+    const FileCheckpoints checkpoints{{"collection-2.wt", "(WiredTigerCheckpoint.3=(order=3))"},
+                                      {"db/index-3.wt", "(WiredTigerCheckpoint.7=(order=7))"}};
+
+    ASSERT_EQ(ErrorCodes::NoSuchKey, readCheckpoints(dbPath.path(), "nightly").getStatus());
+    ASSERT_OK(writeCheckpoints(dbPath.path(), "nightly", checkpoints));
+
+    auto swRead = readCheckpoints(dbPath.path(), "nightly");
+    ASSERT_OK(swRead.getStatus());
+    ASSERT(checkpoints == swRead.getValue());
+
+    // Writing a backup again under the same name replaces its state.
+    ASSERT_OK(writeCheckpoints(dbPath.path(), "nightly", {}));
+    swRead = readCheckpoints(dbPath.path(), "nightly");
+    ASSERT_OK(swRead.getStatus());
+    ASSERT(swRead.getValue().empty());
+}
+
+TEST(WiredTigerIncrementalBackupTest, RejectsInvalidBackupNames) {
+    unittest::TempDir dbPath("wiredtiger_incremental_backup_test");
+    ASSERT_EQ(ErrorCodes::BadValue, writeCheckpoints(dbPath.path(), "", {}));
+    ASSERT_EQ(ErrorCodes::BadValue, writeCheckpoints(dbPath.path(), "../escape", {}));
+    ASSERT_EQ(ErrorCodes::BadValue, writeCheckpoints(dbPath.path(), std::string(65, 'a'), {}));
+    ASSERT_EQ(ErrorCodes::BadValue, readCheckpoints(dbPath.path(), "a/b").getStatus());
+}
+
+TEST(WiredTigerIncrementalBackupTest, ComparesCheckpoints) {
+    const FileCheckpoints previous{{"a.wt", "(c.1)"}, {"b.wt", "(c.1)"}, {"c.wt", "(c.1)"}};
+    const FileCheckpoints current{{"a.wt", "(c.1)"}, {"b.wt", "(c.2)"}, {"d.wt", "(c.1)"}};
+
+    ASSERT_TRUE(isUnchanged(previous, current, "a.wt"));
+    ASSERT_FALSE(isUnchanged(previous, current, "b.wt"));
+    ASSERT_FALSE(isUnchanged(previous, current, "c.wt"));
+    ASSERT_FALSE(isUnchanged(previous, current, "d.wt"));
+    ASSERT_FALSE(isUnchanged(previous, current, "WiredTiger.wt"));
+}
+
+TEST(WiredTigerIncrementalBackupTest, UnmodifiedFilesKeepTheirCheckpoint) {
+    unittest::TempDir dbPath("wiredtiger_incremental_backup_test");
+    WT_CONNECTION* conn;
+    ASSERT_OK(wtRCToStatus(wiredtiger_open(dbPath.path().c_str(), NULL, "create", &conn)));
+    WT_SESSION* session;
+    ASSERT_OK(wtRCToStatus(conn->open_session(conn, NULL, NULL, &session)));
+
+    auto insert = [&](const char* uri, const char* key) {
+        WT_CURSOR* cursor;
+        ASSERT_OK(wtRCToStatus(session->open_cursor(session, uri, NULL, NULL, &cursor)));
+        cursor->set_key(cursor, key);
+        cursor->set_value(cursor, "value");
+        ASSERT_OK(wtRCToStatus(cursor->insert(cursor)));
+        ASSERT_OK(wtRCToStatus(cursor->close(cursor)));
+    };
+    auto checkpointAndBackup = [&]() {
+        ASSERT_OK(wtRCToStatus(session->checkpoint(session, NULL)));
+        WT_CURSOR* backupCursor;
+        ASSERT_OK(
+            wtRCToStatus(session->open_cursor(session, "backup:", NULL, NULL, &backupCursor)));
+        auto swCheckpoints = readBackupMetadata(dbPath.path());
+        ASSERT_OK(wtRCToStatus(backupCursor->close(backupCursor)));
+        ASSERT_OK(swCheckpoints.getStatus());
+        return swCheckpoints.getValue();
+    };
+
+    for (auto uri : {"table:a", "table:b"}) {
+        ASSERT_OK(wtRCToStatus(session->create(session, uri, "key_format=S,value_format=S")));
+        insert(uri, "k1");
+    }
+    const auto first = checkpointAndBackup();
+
+    insert("table:a", "k2");
+    const auto second = checkpointAndBackup();
+
+    ASSERT_FALSE(isUnchanged(first, second, "a.wt"));
+    ASSERT_TRUE(isUnchanged(first, second, "b.wt"));
+
+    ASSERT_OK(wtRCToStatus(conn->close(conn, NULL)));
+}
+
+}  // namespace
+}  // namespace wiredtiger_incremental_backup
+}  // namespace mongo
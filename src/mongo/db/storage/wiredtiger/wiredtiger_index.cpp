@@ -106,6 +106,14 @@ BSONObj stripFieldNames(const BSONObj& query) {
 // Keystring format 7 was used in 3.3.6 - 3.3.8 development releases. 4.2 onwards, unique indexes
 // can be either format version 11 or 12. On upgrading to 4.2, an existing format 6 unique index
 // will upgrade to format 11 and an existing format 8 unique index will upgrade to format 12.
+//
+// Entry layout by index type:
+//   standard and timestamp-safe unique: key = KeyString(key) + RecordId, value = TypeBits.
+//   _id and timestamp-unsafe unique:    key = KeyString(key), value = RecordId + TypeBits.
+// TypeBits which are all zero (the common case of keys with no type ambiguity) are never written,
+// so such entries carry an empty value or a bare RecordId. Keys are compared with memcmp, so
+// repeated leading field values are not dictionary-encoded; they are instead left to WiredTiger's
+// page-level prefix compression, which is on by default for indexes.
 const int kDataFormatV1KeyStringV0IndexVersionV1 = 6;
 const int kDataFormatV2KeyStringV1IndexVersionV2 = 8;
 const int kDataFormatV3KeyStringV0UniqueIndexVersionV1 = 11;
@@ -540,6 +548,14 @@ Status WiredTigerIndex::compact(OperationContext* opCtx) {
     return Status::OK();
 }
 
+StatusWith<bool> WiredTigerIndex::compactChunk(OperationContext* opCtx, Seconds timeLimit) {
+    WiredTigerSessionCache* cache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
+    if (cache->isEphemeral()) {
+        return true;
+    }
+    return WiredTigerUtil::compactChunk(opCtx, uri(), timeLimit);
+}
+
 /**
  * Base class for WiredTigerIndex bulk builders.
  *
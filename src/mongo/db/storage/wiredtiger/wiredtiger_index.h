@@ -119,6 +119,8 @@ public:
 
     virtual Status compact(OperationContext* opCtx);
 
+    StatusWith<bool> compactChunk(OperationContext* opCtx, Seconds timeLimit) override;
+
     const std::string& uri() const {
         return _uri;
     }
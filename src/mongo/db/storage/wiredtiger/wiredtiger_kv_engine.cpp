@@ -39,6 +39,7 @@
 #define NVALGRIND
 #endif
 
+#include <array>
 #include <memory>
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
@@ -73,6 +74,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_extensions.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_incremental_backup.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_index.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
@@ -89,6 +91,7 @@
 #include "mongo/util/processinfo.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 #if !defined(__has_feature)
 #define __has_feature(x) 0
@@ -291,13 +294,7 @@ public:
         LOG(1) << "starting " << name() << " thread";
 
         while (!_shuttingDown.load()) {
-            {
-                stdx::unique_lock<stdx::mutex> lock(_mutex);
-                MONGO_IDLE_THREAD_BLOCK;
-                _condvar.wait_for(lock,
-                                  stdx::chrono::seconds(static_cast<std::int64_t>(
-                                      wiredTigerGlobalOptions.checkpointDelaySecs)));
-            }
+            _waitForNextCheckpoint();
 
             // Might have been awakened by another thread shutting us down.
             if (_shuttingDown.load()) {
@@ -324,6 +321,10 @@ public:
             // we can safely assume that the oplog needed for crash recovery has caught up to the
             // recorded value. After the checkpoint, this value will be published such that actors
             // which truncate the oplog can read an updated value.
+            Timer checkpointTimer;
+            const auto bytesWrittenBefore =
+                _getConnectionStatistic(WT_STAT_CONN_BLOCK_BYTE_WRITE_CHECKPOINT);
+            bool tookCheckpoint = false;
             try {
                 // Three cases:
                 //
@@ -341,6 +342,7 @@ public:
                     UniqueWiredTigerSession session = _sessionCache->getSession();
                     WT_SESSION* s = session->getSession();
                     invariantWTOK(s->checkpoint(s, "use_timestamp=false"));
+                    tookCheckpoint = true;
                 } else if (stableTimestamp < initialDataTimestamp) {
                     LOG_FOR_RECOVERY(2)
                         << "Stable timestamp is behind the initial data timestamp, skipping "
@@ -357,6 +359,7 @@ public:
                     UniqueWiredTigerSession session = _sessionCache->getSession();
                     WT_SESSION* s = session->getSession();
                     invariantWTOK(s->checkpoint(s, "use_timestamp=true"));
+                    tookCheckpoint = true;
 
                     if (oplogNeededForRollback.isOK()) {
                         // Now that the checkpoint is durable, publish the oplog needed to recover
@@ -372,10 +375,29 @@ public:
             } catch (const AssertionException& exc) {
                 invariant(ErrorCodes::isShutdownError(exc.code()), exc.what());
             }
+
+            if (tookCheckpoint) {
+                const long long durationMillis = checkpointTimer.millis();
+                const long long bytesWritten =
+                    _getConnectionStatistic(WT_STAT_CONN_BLOCK_BYTE_WRITE_CHECKPOINT) -
+                    bytesWrittenBefore;
+                _checkpointCount.fetchAndAdd(1);
+                _lastCheckpointDurationMillis.store(durationMillis);
+                _lastCheckpointBytesWritten.store(bytesWritten);
+                LOG(1) << "Checkpoint took " << durationMillis << "ms and wrote " << bytesWritten
+                       << " bytes";
+            }
         }
         LOG(1) << "stopping " << name() << " thread";
     }
 
+    void appendStats(BSONObjBuilder* builder) const {
+        builder->append("checkpoints", _checkpointCount.load());
+        builder->append("checkpointsTriggeredByDirtyBytes", _dirtyBytesTriggeredCount.load());
+        builder->append("lastCheckpointDurationMillis", _lastCheckpointDurationMillis.load());
+        builder->append("lastCheckpointBytesWritten", _lastCheckpointBytesWritten.load());
+    }
+
     /**
      * Returns true if we have already triggered taking the first checkpoint.
      */
@@ -431,6 +453,52 @@ public:
     }
 
 private:
+    /**
+     * Returns once the next checkpoint is due: 'checkpointDelaySecs' after the previous one, when
+     * another thread wakes this one, or, if 'wiredTigerCheckpointDirtyBytesTrigger' is set, as soon
+     * as the cache holds that many dirty bytes. Checkpointing early under heavy writes keeps each
+     * checkpoint small rather than letting a full interval of dirty data pile up.
+     */
+    void _waitForNextCheckpoint() {
+        const Date_t waitStart = Date_t::now();
+        while (true) {
+            const auto delay =
+                Seconds(static_cast<std::int64_t>(wiredTigerGlobalOptions.checkpointDelaySecs));
+            const long long dirtyBytesTrigger = gWiredTigerCheckpointDirtyBytesTrigger.load();
+            const Milliseconds remaining = delay - (Date_t::now() - waitStart);
+            const Milliseconds pollInterval =
+                dirtyBytesTrigger > 0 ? std::min(remaining, Milliseconds(1000)) : remaining;
+
+            if (pollInterval > Milliseconds(0)) {
+                stdx::unique_lock<stdx::mutex> lock(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+                if (_condvar.wait_for(lock, pollInterval.toSystemDuration()) ==
+                    stdx::cv_status::no_timeout) {
+                    return;
+                }
+            }
+
+            if (_shuttingDown.load() || Date_t::now() - waitStart >= delay) {
+                return;
+            }
+
+            if (dirtyBytesTrigger > 0 &&
+                _getConnectionStatistic(WT_STAT_CONN_CACHE_BYTES_DIRTY) >= dirtyBytesTrigger) {
+                _dirtyBytesTriggeredCount.fetchAndAdd(1);
+                LOG(1) << "Starting a checkpoint early because the cache holds more than "
+                       << dirtyBytesTrigger << " dirty bytes";
+                return;
+            }
+        }
+    }
+
+    long long _getConnectionStatistic(int statisticsKey) {
+        UniqueWiredTigerSession session = _sessionCache->getSession();
+        auto result = WiredTigerUtil::getStatisticsValueAs<long long>(
+            session->getSession(), "statistics:", "statistics=(fast)", statisticsKey);
+        return result.isOK() ? result.getValue() : 0;
+    }
+
     WiredTigerKVEngine* _wiredTigerKVEngine;
     WiredTigerSessionCache* _sessionCache;
 
@@ -445,6 +513,11 @@ private:
 
     stdx::mutex _oplogNeededForCrashRecoveryMutex;
     AtomicWord<std::uint64_t> _oplogNeededForCrashRecovery;
+
+    AtomicWord<long long> _checkpointCount{0};
+    AtomicWord<long long> _dirtyBytesTriggeredCount{0};
+    AtomicWord<long long> _lastCheckpointDurationMillis{0};
+    AtomicWord<long long> _lastCheckpointBytesWritten{0};
 };
 
 namespace {
@@ -494,6 +567,209 @@ Status OpenReadTransactionParam::setFromString(const std::string& str) {
     return _data->resize(num);
 }
 
+/**
+ * Periodically resizes the read and write ticket pools to track the concurrency the node can
+ * sustain. While requests queue for tickets the pool grows additively, and steps back when the
+ * last increase lowered transaction throughput. When the cache is filled past WiredTiger's
+ * eviction triggers, application threads are drafted into eviction and more concurrency only
+ * deepens the stall, so both pools shrink multiplicatively until the pressure clears.
+ */
+class WiredTigerKVEngine::WiredTigerTicketController : public BackgroundJob {
+public:
+    explicit WiredTigerTicketController(WiredTigerSessionCache* sessionCache)
+        : BackgroundJob(false /* deleteSelf */),
+          _sessionCache(sessionCache),
+          _pools{{{"read", &openReadTransaction}, {"write", &openWriteTransaction}}} {}
+
+    virtual string name() const {
+        return "WTTicketController";
+    }
+
+    virtual void run() {
+        ThreadClient tc(name(), getGlobalServiceContext());
+        LOG(1) << "starting " << name() << " thread";
+
+        for (auto& pool : _pools) {
+            pool.lastQueueStats = pool.holder->getQueueStats();
+        }
+        long long lastTransactions = _getTransactionCount();
+        Timer intervalTimer;
+
+        while (!_shuttingDown.load()) {
+            {
+                const Milliseconds interval(gWiredTigerAdaptiveTicketsIntervalMillis.load());
+                stdx::unique_lock<stdx::mutex> lock(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+                _condvar.wait_for(lock, interval.toSystemDuration());
+            }
+            if (_shuttingDown.load()) {
+                break;
+            }
+
+            const long long transactions = _getTransactionCount();
+            const long long elapsedMicros = std::max(intervalTimer.micros(), 1LL);
+            intervalTimer.reset();
+            const long long throughput =
+                (transactions - lastTransactions) * 1000 * 1000 / elapsedMicros;
+            lastTransactions = transactions;
+
+            const double cacheFillRatio = _getCacheRatio(WT_STAT_CONN_CACHE_BYTES_INUSE);
+            const double cacheDirtyRatio = _getCacheRatio(WT_STAT_CONN_CACHE_BYTES_DIRTY);
+            const bool underCachePressure =
+                cacheFillRatio >= kEvictionTrigger || cacheDirtyRatio >= kEvictionDirtyTrigger;
+
+            _lastThroughputPerSec.store(throughput);
+            _lastCacheFillRatio.store(cacheFillRatio);
+            _lastCacheDirtyRatio.store(cacheDirtyRatio);
+
+            for (auto& pool : _pools) {
+                _adjust(&pool, throughput, underCachePressure);
+            }
+        }
+        LOG(1) << "stopping " << name() << " thread";
+    }
+
+    void appendStats(BSONObjBuilder* builder) const {
+        builder->append("lastThroughputPerSec", _lastThroughputPerSec.load());
+        builder->append("lastCacheFillRatio", _lastCacheFillRatio.load());
+        builder->append("lastCacheDirtyRatio", _lastCacheDirtyRatio.load());
+        for (const auto& pool : _pools) {
+            BSONObjBuilder poolBuilder(builder->subobjStart(pool.name));
+            poolBuilder.append("increases", pool.increases.load());
+            poolBuilder.append("decreases", pool.decreases.load());
+            poolBuilder.append("decreasesForCachePressure", pool.decreasesForCachePressure.load());
+            poolBuilder.append("lastQueuedAcquisitions", pool.lastQueuedAcquisitions.load());
+            poolBuilder.append("lastAverageQueuedMicros", pool.lastAverageQueuedMicros.load());
+        }
+    }
+
+    void shutdown() {
+        _shuttingDown.store(true);
+        {
+            stdx::unique_lock<stdx::mutex> lock(_mutex);
+            _condvar.notify_one();
+        }
+        wait();
+    }
+
+private:
+    // WiredTiger's default 'eviction_trigger' and 'eviction_dirty_trigger'. Past these, application
+    // threads must help evict pages before they can proceed.
+    static constexpr double kEvictionTrigger = 0.95;
+    static constexpr double kEvictionDirtyTrigger = 0.20;
+
+    // Throughput must fall by more than this fraction after an increase to count as a loss.
+    static constexpr double kThroughputTolerance = 0.05;
+
+    struct Pool {
+        Pool(StringData name, TicketHolder* holder) : name(name), holder(holder) {}
+
+        const StringData name;
+        TicketHolder* const holder;
+
+        TicketHolder::QueueStats lastQueueStats;
+        // Throughput of the interval before the last increase, and whether the last interval
+        // ended with an increase.
+        long long throughputBeforeIncrease = 0;
+        bool lastAdjustmentWasIncrease = false;
+
+        AtomicWord<long long> increases{0};
+        AtomicWord<long long> decreases{0};
+        AtomicWord<long long> decreasesForCachePressure{0};
+        AtomicWord<long long> lastQueuedAcquisitions{0};
+        AtomicWord<long long> lastAverageQueuedMicros{0};
+    };
+
+    void _adjust(Pool* pool, long long throughput, bool underCachePressure) {
+        const auto queueStats = pool->holder->getQueueStats();
+        const long long queued =
+            queueStats.queuedAcquisitions - pool->lastQueueStats.queuedAcquisitions;
+        const long long queuedMicros =
+            queueStats.totalQueuedMicros - pool->lastQueueStats.totalQueuedMicros;
+        pool->lastQueuedAcquisitions.store(queued);
+        pool->lastAverageQueuedMicros.store(queued > 0 ? queuedMicros / queued : 0);
+
+        const int minTickets = gWiredTigerAdaptiveTicketsMin.load();
+        const int maxTickets = std::max(minTickets, gWiredTigerAdaptiveTicketsMax.load());
+        const int current = pool->holder->outof();
+        const int step = std::max(1, current / 16);
+
+        int target = current;
+        bool increase = false;
+        if (underCachePressure) {
+            target = current * 3 / 4;
+        } else if (queued > 0) {
+            // The limit is binding. Keep growing unless the last increase cost throughput.
+            if (pool->lastAdjustmentWasIncrease &&
+                throughput < pool->throughputBeforeIncrease * (1 - kThroughputTolerance)) {
+                target = current - step;
+            } else {
+                target = current + step;
+                increase = true;
+            }
+        }
+        target = std::max(minTickets, std::min(maxTickets, target));
+
+        pool->lastAdjustmentWasIncrease = false;
+        if (target != current) {
+            LOG(2) << "Resizing the " << pool->name << " ticket pool from " << current << " to "
+                   << target << "; throughput: " << throughput << "/s, queued: " << queued
+                   << ", cache pressure: " << underCachePressure;
+            Status status = pool->holder->resize(target);
+            if (status.isOK()) {
+                if (target > current) {
+                    pool->increases.fetchAndAdd(1);
+                    pool->lastAdjustmentWasIncrease = increase;
+                    pool->throughputBeforeIncrease = throughput;
+                } else if (underCachePressure) {
+                    pool->decreasesForCachePressure.fetchAndAdd(1);
+                } else {
+                    pool->decreases.fetchAndAdd(1);
+                }
+            } else {
+                LOG(1) << "Failed to resize the " << pool->name << " ticket pool: " << status;
+            }
+        }
+
+        // Shrinking waits for tickets itself; start the next interval after those waits.
+        pool->lastQueueStats = pool->holder->getQueueStats();
+    }
+
+    long long _getConnectionStatistic(int statisticsKey) {
+        UniqueWiredTigerSession session = _sessionCache->getSession();
+        auto result = WiredTigerUtil::getStatisticsValueAs<long long>(
+            session->getSession(), "statistics:", "statistics=(fast)", statisticsKey);
+        return result.isOK() ? result.getValue() : 0;
+    }
+
+    long long _getTransactionCount() {
+        return _getConnectionStatistic(WT_STAT_CONN_TXN_COMMIT) +
+            _getConnectionStatistic(WT_STAT_CONN_TXN_ROLLBACK);
+    }
+
+    double _getCacheRatio(int statisticsKey) {
+        const long long cacheBytes = _getConnectionStatistic(WT_STAT_CONN_CACHE_BYTES_MAX);
+        if (cacheBytes <= 0) {
+            return 0;
+        }
+        return static_cast<double>(_getConnectionStatistic(statisticsKey)) / cacheBytes;
+    }
+
+    WiredTigerSessionCache* _sessionCache;
+    std::array<Pool, 2> _pools;
+
+    stdx::mutex _mutex;  // protects _condvar
+    // The controller idles on this condition variable between adjustments. It is signalled to
+    // expedite shutdown.
+    stdx::condition_variable _condvar;
+
+    AtomicWord<bool> _shuttingDown{false};
+
+    AtomicWord<long long> _lastThroughputPerSec{0};
+    AtomicWord<double> _lastCacheFillRatio{0};
+    AtomicWord<double> _lastCacheDirtyRatio{0};
+};
+
 namespace {
 
 stdx::function<bool(StringData)> initRsOplogBackgroundThreadCallback = [](StringData) -> bool {
@@ -531,6 +807,7 @@ StatusWith<std::vector<std::string>> getDataFilesFromBackupCursor(WT_CURSOR* cur
 }  // namespace
 
 StringData WiredTigerKVEngine::kTableUriPrefix = "table:"_sd;
+StringData WiredTigerKVEngine::kOplogStonesIdent = "oplogStones"_sd;
 
 WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
                                        const std::string& path,
@@ -597,6 +874,11 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
     ss << WiredTigerCustomizationHooks::get(getGlobalServiceContext())
               ->getTableCreateConfig("system");
     ss << WiredTigerExtensions::get(getGlobalServiceContext())->getOpenExtensionsConfig();
+    if (const auto ioCapacityMB = gWiredTigerIOCapacityMBPerSec) {
+        // Throttles checkpoint and eviction writes. Earlier in the string than extraOpenOptions so
+        // an explicit engine config string still takes precedence.
+        ss << "io_capacity=(total=" << ioCapacityMB << "MB),";
+    }
     ss << extraOpenOptions;
     if (_readOnly) {
         invariant(!_durable);
@@ -685,7 +967,16 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
 
     _sizeStorer = std::make_unique<WiredTigerSizeStorer>(_conn, _sizeStorerUri, _readOnly);
 
+    if (gWiredTigerTicketAdmissionPriority) {
+        openReadTransaction.enablePriorityAdmission();
+        openWriteTransaction.enablePriorityAdmission();
+    }
     Locker::setGlobalThrottling(&openReadTransaction, &openWriteTransaction);
+
+    if (gWiredTigerAdaptiveTickets && !_readOnly) {
+        _ticketController = stdx::make_unique<WiredTigerTicketController>(_sessionCache.get());
+        _ticketController->go();
+    }
 }
 
 
@@ -704,6 +995,10 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("out", openWriteTransaction.used());
         bbb.append("available", openWriteTransaction.available());
         bbb.append("totalTickets", openWriteTransaction.outof());
+        if (openWriteTransaction.priorityAdmissionEnabled()) {
+            BSONObjBuilder priorities(bbb.subobjStart("priorities"));
+            openWriteTransaction.appendPriorityStats(&priorities);
+        }
         bbb.done();
     }
     {
@@ -711,11 +1006,25 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("out", openReadTransaction.used());
         bbb.append("available", openReadTransaction.available());
         bbb.append("totalTickets", openReadTransaction.outof());
+        if (openReadTransaction.priorityAdmissionEnabled()) {
+            BSONObjBuilder priorities(bbb.subobjStart("priorities"));
+            openReadTransaction.appendPriorityStats(&priorities);
+        }
         bbb.done();
     }
+    if (_ticketController) {
+        BSONObjBuilder adaptive(bb.subobjStart("adaptive"));
+        _ticketController->appendStats(&adaptive);
+    }
     bb.done();
 }
 
+void WiredTigerKVEngine::appendCheckpointStats(BSONObjBuilder* builder) const {
+    if (_checkpointThread) {
+        _checkpointThread->appendStats(builder);
+    }
+}
+
 void WiredTigerKVEngine::_openWiredTiger(const std::string& path, const std::string& wtOpenConfig) {
     std::string configStr = wtOpenConfig + ",compatibility=(require_min=\"3.1.0\")";
 
@@ -787,6 +1096,11 @@ void WiredTigerKVEngine::cleanShutdown() {
     }
 
     // these must be the last things we do before _conn->close();
+    if (_ticketController) {
+        log() << "Shutting down ticket controller thread";
+        _ticketController->shutdown();
+        log() << "Finished shutting down ticket controller thread";
+    }
     if (_sessionSweeper) {
         log() << "Shutting down session sweeper thread";
         _sessionSweeper->shutdown();
@@ -1034,6 +1348,51 @@ StatusWith<std::vector<std::string>> WiredTigerKVEngine::beginNonBlockingBackup(
     return swFilesToCopy;
 }
 
+StatusWith<std::vector<StorageEngine::BackupFile>>
+WiredTigerKVEngine::beginNonBlockingIncrementalBackup(
+    OperationContext* opCtx, const StorageEngine::IncrementalBackupOptions& options) {
+    namespace incremental = wiredtiger_incremental_backup;
+
+    auto swFilesToCopy = beginNonBlockingBackup(opCtx);
+    if (!swFilesToCopy.isOK()) {
+        return swFilesToCopy.getStatus();
+    }
+    auto endBackupGuard = makeGuard([&] { endNonBlockingBackup(opCtx); });
+
+    // The backup cursor records the checkpoint it copies for every file in WiredTiger.backup,
+    // which only exists while the cursor is open.
+    auto swCurrent = incremental::readBackupMetadata(_path);
+    if (!swCurrent.isOK()) {
+        return swCurrent.getStatus();
+    }
+    const auto& current = swCurrent.getValue();
+
+    incremental::FileCheckpoints previous;
+    if (options.srcBackupName) {
+        auto swPrevious = incremental::readCheckpoints(_path, *options.srcBackupName);
+        if (!swPrevious.isOK()) {
+            return swPrevious.getStatus();
+        }
+        previous = std::move(swPrevious.getValue());
+    }
+
+    auto status = incremental::writeCheckpoints(_path, options.thisBackupName, current);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    const boost::filesystem::path dbPath(_path);
+    std::vector<StorageEngine::BackupFile> files;
+    for (auto&& filename : swFilesToCopy.getValue()) {
+        const auto relativeName =
+            boost::filesystem::path(filename).lexically_relative(dbPath).generic_string();
+        files.push_back({filename, !incremental::isUnchanged(previous, current, relativeName)});
+    }
+
+    endBackupGuard.dismiss();
+    return files;
+}
+
 void WiredTigerKVEngine::endNonBlockingBackup(OperationContext* opCtx) {
     _backupSession.reset();
     // Oplog truncation thread can now remove the pinned oplog.
@@ -1204,6 +1563,7 @@ std::unique_ptr<RecordStore> WiredTigerKVEngine::getGroupedRecordStore(
     params.cappedCallback = nullptr;
     params.sizeStorer = _sizeStorer.get();
     params.isReadOnly = _readOnly;
+    params.isClustered = options.clustered;
 
     params.cappedMaxSize = -1;
     if (options.capped) {
@@ -1496,7 +1856,7 @@ std::vector<std::string> WiredTigerKVEngine::getAllIdents(OperationContext* opCt
             continue;
 
         StringData ident = key.substr(idx + 1);
-        if (ident == "sizeStorer")
+        if (ident == "sizeStorer" || ident == kOplogStonesIdent)
             continue;
 
         all.push_back(ident.toString());
@@ -67,6 +67,8 @@ class WiredTigerKVEngine final : public KVEngine {
 public:
     static const int kDefaultJournalDelayMillis;
     static StringData kTableUriPrefix;
+    // Ident of the table holding the persisted oplog stones of each oplog, keyed by oplog URI.
+    static StringData kOplogStonesIdent;
 
     WiredTigerKVEngine(const std::string& canonicalName,
                        const std::string& path,
@@ -87,6 +89,10 @@ public:
 
     bool supportsDirectoryPerDB() const override;
 
+    bool supportsClusteredCollections() const override {
+        return true;
+    }
+
     bool isDurable() const override {
         return _durable;
     }
@@ -171,6 +177,9 @@ public:
 
     StatusWith<std::vector<std::string>> beginNonBlockingBackup(OperationContext* opCtx) override;
 
+    StatusWith<std::vector<StorageEngine::BackupFile>> beginNonBlockingIncrementalBackup(
+        OperationContext* opCtx, const StorageEngine::IncrementalBackupOptions& options) override;
+
     void endNonBlockingBackup(OperationContext* opCtx) override;
 
     virtual StatusWith<std::vector<std::string>> extendBackupCursor(
@@ -308,6 +317,11 @@ public:
 
     static void appendGlobalStats(BSONObjBuilder& b);
 
+    /**
+     * Appends the number, duration and size of checkpoints taken by the checkpoint thread.
+     */
+    void appendCheckpointStats(BSONObjBuilder* builder) const;
+
     Timestamp getStableTimestamp() const override;
     Timestamp getOldestTimestamp() const override;
     Timestamp getCheckpointTimestamp() const override;
@@ -357,6 +371,7 @@ private:
     class WiredTigerSessionSweeper;
     class WiredTigerJournalFlusher;
     class WiredTigerCheckpointThread;
+    class WiredTigerTicketController;
 
     /**
      * Opens a connection on the WiredTiger database 'path' with the configuration 'wtOpenConfig'.
@@ -446,6 +461,7 @@ private:
     std::unique_ptr<WiredTigerSessionSweeper> _sessionSweeper;
     std::unique_ptr<WiredTigerJournalFlusher> _journalFlusher;  // Depends on _sizeStorer
     std::unique_ptr<WiredTigerCheckpointThread> _checkpointThread;
+    std::unique_ptr<WiredTigerTicketController> _ticketController;
 
     std::string _rsOptions;
     std::string _indexOptions;
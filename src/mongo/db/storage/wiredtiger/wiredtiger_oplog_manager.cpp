@@ -35,6 +35,7 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_oplog_manager.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
@@ -163,10 +164,15 @@ void WiredTigerOplogManager::_oplogJournalThreadLoop(WiredTigerSessionCache* ses
     // have uncommitted entries ahead of them.
     while (true) {
         stdx::unique_lock<stdx::mutex> lk(_oplogVisibilityStateMutex);
+
+        // When set, visibility is published from the all_committed timestamp alone. Durability is
+        // left to the journal flusher and to writers which wait for it themselves.
+        bool visibleBeforeDurable = false;
         {
             MONGO_IDLE_THREAD_BLOCK;
             _opsWaitingForJournalCV.wait(lk,
                                          [&] { return _shuttingDown || _opsWaitingForJournal; });
+            visibleBeforeDurable = gWiredTigerOplogVisibilityWithoutJournalFlush.load();
 
             // If we're not shutting down and nobody is actively waiting for the oplog to become
             // durable, delay journaling a bit to reduce the sync rate.
@@ -177,7 +183,7 @@ void WiredTigerOplogManager::_oplogJournalThreadLoop(WiredTigerSessionCache* ses
             auto now = Date_t::now();
             auto deadline = now + journalDelay;
             auto shouldSyncOpsWaitingForJournal = [&] {
-                return _shuttingDown || _opsWaitingForVisibility ||
+                return _shuttingDown || visibleBeforeDurable || _opsWaitingForVisibility ||
                     oplogRecordStore->haveCappedWaiters();
             };
 
@@ -221,8 +227,11 @@ void WiredTigerOplogManager::_oplogJournalThreadLoop(WiredTigerSessionCache* ses
         }
 
         // In order to avoid oplog holes after an unclean shutdown, we must ensure this proposed
-        // oplog read timestamp's documents are durable before publishing that timestamp.
-        sessionCache->waitUntilDurable(/*forceCheckpoint=*/false, false);
+        // oplog read timestamp's documents are durable before publishing that timestamp, unless
+        // we have been configured to trade that guarantee for lower visibility latency.
+        if (!visibleBeforeDurable) {
+            sessionCache->waitUntilDurable(/*forceCheckpoint=*/false, false);
+        }
 
         lk.lock();
         // Publish the new timestamp value.  Avoid going backward.
@@ -47,10 +47,14 @@
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/server_recovery.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/clustered_id.h"
+#include "mongo/db/storage/index_entry_comparison.h"
 #include "mongo/db/storage/oplog_hack.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_prepare_conflict.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
@@ -85,6 +89,26 @@ void checkOplogFormatVersion(OperationContext* opCtx, const std::string& uri) {
 
     fassertNoTrace(39998, appMetadata.getValue().getIntField("oplogKeyExtractionVersion") == 1);
 }
+
+// Statistics about computing the oplog stones at startup and truncating the oplog, reported in
+// serverStatus under 'wiredTiger.oplogTruncation'.
+struct OplogTruncationStats {
+    stdx::mutex mutex;
+    std::string processingMethod;  // Guarded by 'mutex'.
+    AtomicWord<long long> totalTimeProcessingMicros;
+    AtomicWord<long long> truncateCount;
+    AtomicWord<long long> totalTimeTruncatingMicros;
+} oplogTruncationStats;
+
+void setOplogStonesProcessingMethod(StringData method) {
+    stdx::lock_guard<stdx::mutex> lk(oplogTruncationStats.mutex);
+    oplogTruncationStats.processingMethod = method.toString();
+}
+
+std::string oplogStonesTableUri() {
+    return str::stream() << WiredTigerKVEngine::kTableUriPrefix
+                         << WiredTigerKVEngine::kOplogStonesIdent;
+}
 }  // namespace
 
 MONGO_FAIL_POINT_DEFINE(WTWriteConflictException);
@@ -145,6 +169,7 @@ public:
 
         stdx::lock_guard<stdx::mutex> lk(_oplogStones->_mutex);
         _oplogStones->_stones.clear();
+        _oplogStones->_persistStones_inlock();
     }
 
     void rollback() final {}
@@ -169,7 +194,21 @@ WiredTigerRecordStore::OplogStones::OplogStones(OperationContext* opCtx, WiredTi
     _minBytesPerStone = maxSize / numStonesToKeep;
     invariant(_minBytesPerStone > 0);
 
+    // An in-memory oplog doesn't survive a restart, so there is nothing to reload its stones for.
+    if (!rs->_isEphemeral && !storageGlobalParams.readOnly) {
+        _sessionCache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
+
+        UniqueWiredTigerSession session = _sessionCache->getSession();
+        WT_SESSION* s = session->getSession();
+        const std::string uri = oplogStonesTableUri();
+        const std::string config = WiredTigerCustomizationHooks::get(getGlobalServiceContext())
+                                       ->getTableCreateConfig(uri);
+        invariantWTOK(s->create(s, uri.c_str(), config.c_str()));
+    }
+
+    Timer timer;
     _calculateStones(opCtx, numStonesToKeep);
+    oplogTruncationStats.totalTimeProcessingMicros.store(timer.micros());
     _pokeReclaimThreadIfNeeded();  // Reclaim stones if over the limit.
 }
 
@@ -204,7 +243,8 @@ void WiredTigerRecordStore::OplogStones::awaitHasExcessStonesOrDead() {
                 auto stone = _stones.front();
                 invariant(stone.lastRecord.isValid());
                 if (static_cast<std::uint64_t>(stone.lastRecord.repr()) <
-                    _rs->getPinnedOplog().asULL()) {
+                        _rs->getPinnedOplog().asULL() &&
+                    !_isRetained(stone)) {
                     break;
                 }
             }
@@ -217,7 +257,7 @@ boost::optional<WiredTigerRecordStore::OplogStones::Stone>
 WiredTigerRecordStore::OplogStones::peekOldestStoneIfNeeded() const {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
 
-    if (!hasExcessStones_inlock()) {
+    if (!hasExcessStones_inlock() || _isRetained(_stones.front())) {
         return {};
     }
 
@@ -227,6 +267,7 @@ WiredTigerRecordStore::OplogStones::peekOldestStoneIfNeeded() const {
 void WiredTigerRecordStore::OplogStones::popOldestStone() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     _stones.pop_front();
+    _persistStones_inlock();
 }
 
 void WiredTigerRecordStore::OplogStones::createNewStoneIfNeeded(RecordId lastRecord) {
@@ -252,6 +293,7 @@ void WiredTigerRecordStore::OplogStones::createNewStoneIfNeeded(RecordId lastRec
     LOG(2) << "create new oplogStone, current stones:" << _stones.size();
     OplogStones::Stone stone = {_currentRecords.swap(0), _currentBytes.swap(0), lastRecord};
     _stones.push_back(stone);
+    _persistStones_inlock();
 
     _pokeReclaimThreadIfNeeded();
 }
@@ -291,6 +333,7 @@ void WiredTigerRecordStore::OplogStones::updateStonesAfterCappedTruncateAfter(
     // Remove the stones corresponding to the records that were deleted.
     int64_t offset = _stones.size() - numStonesToRemove;
     _stones.erase(_stones.begin() + offset, _stones.end());
+    _persistStones_inlock();
 
     // Account for any remaining records from a partially truncated stone in the stone currently
     // being filled.
@@ -316,6 +359,10 @@ void WiredTigerRecordStore::OplogStones::_calculateStones(OperationContext* opCt
     log() << "The size storer reports that the oplog contains " << numRecords
           << " records totaling to " << dataSize << " bytes";
 
+    if (_loadStones(opCtx)) {
+        return;
+    }
+
     // Only use sampling to estimate where to place the oplog stones if the number of samples drawn
     // is less than 5% of the collection.
     const uint64_t kMinSampleRatioForRandCursor = 20;
@@ -326,20 +373,126 @@ void WiredTigerRecordStore::OplogStones::_calculateStones(OperationContext* opCt
         uint64_t(numRecords) <
             kMinSampleRatioForRandCursor * kRandomSamplesPerStone * numStonesToKeep) {
         _calculateStonesByScanning(opCtx);
-        return;
+    } else {
+        // Use the oplog's average record size to estimate the number of records in each stone, and
+        // thus estimate the combined size of the records.
+        double avgRecordSize = double(dataSize) / double(numRecords);
+        double estRecordsPerStone = std::ceil(_minBytesPerStone / avgRecordSize);
+        double estBytesPerStone = estRecordsPerStone * avgRecordSize;
+
+        _calculateStonesBySampling(opCtx, int64_t(estRecordsPerStone), int64_t(estBytesPerStone));
+    }
+
+    _persistStones_inlock();
+}
+
+bool WiredTigerRecordStore::OplogStones::_loadStones(OperationContext* opCtx) {
+    if (!_sessionCache) {
+        return false;
+    }
+
+    BSONObj persisted;
+    {
+        UniqueWiredTigerSession session = _sessionCache->getSession();
+        WT_SESSION* s = session->getSession();
+        WT_CURSOR* cursor;
+        int ret = s->open_cursor(s, oplogStonesTableUri().c_str(), nullptr, nullptr, &cursor);
+        if (ret != 0) {
+            warning() << "Failed to open the persisted oplog truncation markers: "
+                      << wtRCToStatus(ret);
+            return false;
+        }
+        ON_BLOCK_EXIT([&] { cursor->close(cursor); });
+
+        WT_ITEM key = {_rs->_uri.data(), _rs->_uri.size()};
+        cursor->set_key(cursor, &key);
+        ret = cursor->search(cursor);
+        if (ret == WT_NOTFOUND) {
+            return false;
+        }
+        if (ret != 0) {
+            warning() << "Failed to read the persisted oplog truncation markers: "
+                      << wtRCToStatus(ret);
+            return false;
+        }
+
+        WT_ITEM value;
+        invariantWTOK(cursor->get_value(cursor, &value));
+        persisted = BSONObj(static_cast<const char*>(value.data)).getOwned();
+    }
+
+    if (persisted["minBytesPerStone"].safeNumberLong() != _minBytesPerStone ||
+        persisted["stones"].type() != Array) {
+        log() << "The persisted oplog truncation markers were placed for a different oplog size";
+        return false;
+    }
+
+    // The persisted stones are written outside of the transactions that change the oplog, so they
+    // may describe records that were truncated or that did not survive the restart. Only keep the
+    // stones that fall between the first and last records of the oplog.
+    RecordId earliest;
+    RecordId latest;
+    {
+        auto record = _rs->getCursor(opCtx, /*forward=*/true)->next();
+        if (!record) {
+            return false;
+        }
+        earliest = record->id;
+    }
+    {
+        auto record = _rs->getCursor(opCtx, /*forward=*/false)->next();
+        if (!record) {
+            return false;
+        }
+        latest = record->id;
     }
 
-    // Use the oplog's average record size to estimate the number of records in each stone, and thus
-    // estimate the combined size of the records.
-    double avgRecordSize = double(dataSize) / double(numRecords);
-    double estRecordsPerStone = std::ceil(_minBytesPerStone / avgRecordSize);
-    double estBytesPerStone = estRecordsPerStone * avgRecordSize;
+    std::deque<OplogStones::Stone> stones;
+    int64_t recordsInStones = 0;
+    int64_t bytesInStones = 0;
+    RecordId previous;
+    for (auto&& elem : persisted["stones"].Obj()) {
+        if (elem.type() != Object) {
+            return false;
+        }
+        BSONObj obj = elem.Obj();
+        OplogStones::Stone stone = {obj["records"].safeNumberLong(),
+                                    obj["bytes"].safeNumberLong(),
+                                    RecordId(obj["lastRecord"].safeNumberLong())};
+        if (!stone.lastRecord.isNormal() || stone.lastRecord <= previous) {
+            log() << "The persisted oplog truncation markers are not in increasing order";
+            return false;
+        }
+        previous = stone.lastRecord;
 
-    _calculateStonesBySampling(opCtx, int64_t(estRecordsPerStone), int64_t(estBytesPerStone));
+        if (stone.lastRecord < earliest) {
+            continue;
+        }
+        if (stone.lastRecord > latest) {
+            break;
+        }
+
+        stones.push_back(stone);
+        recordsInStones += stone.records;
+        bytesInStones += stone.bytes;
+    }
+
+    log() << "Loaded " << stones.size() << " persisted markers for truncating the oplog between "
+          << Timestamp(earliest.repr()).toStringPretty() << " and "
+          << Timestamp(latest.repr()).toStringPretty();
+    setOplogStonesProcessingMethod("persisted");
+
+    _stones = std::move(stones);
+
+    // Account for the partially filled chunk.
+    _currentRecords.store(std::max<int64_t>(0, _rs->numRecords(opCtx) - recordsInStones));
+    _currentBytes.store(std::max<int64_t>(0, _rs->dataSize(opCtx) - bytesInStones));
+    return true;
 }
 
 void WiredTigerRecordStore::OplogStones::_calculateStonesByScanning(OperationContext* opCtx) {
     log() << "Scanning the oplog to determine where to place markers for truncation";
+    setOplogStonesProcessingMethod("scanning");
 
     long long numRecords = 0;
     long long dataSize = 0;
@@ -399,6 +552,7 @@ void WiredTigerRecordStore::OplogStones::_calculateStonesBySampling(OperationCon
 
     log() << "Sampling from the oplog between " << earliestOpTime.toStringPretty() << " and "
           << latestOpTime.toStringPretty() << " to determine where to place markers for truncation";
+    setOplogStonesProcessingMethod("sampling");
 
     int64_t wholeStones = _rs->numRecords(opCtx) / estRecordsPerStone;
     int64_t numSamples = kRandomSamplesPerStone * _rs->numRecords(opCtx) / estRecordsPerStone;
@@ -452,6 +606,70 @@ void WiredTigerRecordStore::OplogStones::_pokeReclaimThreadIfNeeded() {
     }
 }
 
+bool WiredTigerRecordStore::OplogStones::_isRetained(const OplogStones::Stone& stone) const {
+    const double minRetentionHours = gOplogMinRetentionHours.load();
+    if (minRetentionHours <= 0.0) {
+        return false;
+    }
+
+    // The seconds of an oplog RecordId follow the wall clock of the node that wrote the entry.
+    const long long minRetentionSecs = static_cast<long long>(minRetentionHours * 3600);
+    const long long stoneSecs = Timestamp(stone.lastRecord.repr()).getSecs();
+    return stoneSecs + minRetentionSecs > static_cast<long long>(Date_t::now().toTimeT());
+}
+
+void WiredTigerRecordStore::OplogStones::_persistStones_inlock() {
+    if (!_sessionCache) {
+        return;
+    }
+
+    BSONObjBuilder builder;
+    builder.append("minBytesPerStone", static_cast<long long>(_minBytesPerStone));
+    {
+        BSONArrayBuilder stonesBuilder(builder.subarrayStart("stones"));
+        for (auto&& stone : _stones) {
+            BSONObjBuilder stoneBuilder(stonesBuilder.subobjStart());
+            stoneBuilder.append("records", static_cast<long long>(stone.records));
+            stoneBuilder.append("bytes", static_cast<long long>(stone.bytes));
+            stoneBuilder.append("lastRecord", static_cast<long long>(stone.lastRecord.repr()));
+        }
+    }
+    BSONObj obj = builder.obj();
+
+    // The stones table is only a hint for the next startup, which validates it against the oplog,
+    // so a failed write is not fatal.
+    UniqueWiredTigerSession session = _sessionCache->getSession();
+    WT_SESSION* s = session->getSession();
+    WT_CURSOR* cursor;
+    int ret = s->open_cursor(s, oplogStonesTableUri().c_str(), nullptr, "overwrite=true", &cursor);
+    if (ret != 0) {
+        warning() << "Failed to persist the oplog truncation markers: " << wtRCToStatus(ret);
+        return;
+    }
+    ON_BLOCK_EXIT([&] { cursor->close(cursor); });
+
+    WT_ITEM key = {_rs->_uri.data(), _rs->_uri.size()};
+    WT_ITEM value = {obj.objdata(), static_cast<size_t>(obj.objsize())};
+    cursor->set_key(cursor, &key);
+    cursor->set_value(cursor, &value);
+    ret = cursor->insert(cursor);
+    if (ret != 0) {
+        warning() << "Failed to persist the oplog truncation markers: " << wtRCToStatus(ret);
+    }
+}
+
+void WiredTigerRecordStore::OplogStones::appendStats(BSONObjBuilder* builder) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(oplogTruncationStats.mutex);
+        builder->append("processingMethod", oplogTruncationStats.processingMethod);
+    }
+    builder->append("totalTimeProcessingMicros",
+                    oplogTruncationStats.totalTimeProcessingMicros.load());
+    builder->append("truncateCount", oplogTruncationStats.truncateCount.load());
+    builder->append("totalTimeTruncatingMicros",
+                    oplogTruncationStats.totalTimeTruncatingMicros.load());
+}
+
 void WiredTigerRecordStore::OplogStones::adjust(int64_t maxSize) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     const unsigned long long kMinStonesToKeep = 10ULL;
@@ -461,6 +679,7 @@ void WiredTigerRecordStore::OplogStones::adjust(int64_t maxSize) {
     size_t numStonesToKeep = std::min(kMaxStonesToKeep, std::max(kMinStonesToKeep, numStones));
     _minBytesPerStone = maxSize / numStonesToKeep;
     invariant(_minBytesPerStone > 0);
+    _persistStones_inlock();
     _pokeReclaimThreadIfNeeded();
 }
 
@@ -642,6 +861,7 @@ WiredTigerRecordStore::WiredTigerRecordStore(WiredTigerKVEngine* kvEngine,
       _isCapped(params.isCapped),
       _isEphemeral(params.isEphemeral),
       _isOplog(NamespaceString::oplog(params.ns)),
+      _isClustered(params.isClustered),
       _cappedMaxSize(params.cappedMaxSize),
       _cappedMaxSizeSlack(std::min(params.cappedMaxSize / 10, int64_t(16 * 1024 * 1024))),
       _cappedMaxDocs(params.cappedMaxDocs),
@@ -1175,6 +1395,9 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx) {
 
 void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx, Timestamp mayTruncateUpTo) {
     Timer timer;
+    ON_BLOCK_EXIT([&] {
+        oplogTruncationStats.totalTimeTruncatingMicros.fetchAndAdd(timer.micros());
+    });
     while (auto stone = _oplogStones->peekOldestStoneIfNeeded()) {
         invariant(stone->lastRecord.isValid());
 
@@ -1214,6 +1437,7 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx, Timestamp mayT
 
             // Remove the stone after a successful truncation.
             _oplogStones->popOldestStone();
+            oplogTruncationStats.truncateCount.fetchAndAdd(1);
 
             // Stash the truncate point for next time to cleanly skip over tombstones, etc.
             _oplogStones->firstRecord = stone->lastRecord;
@@ -1265,13 +1489,20 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
             if (!status.isOK())
                 return status.getStatus();
             record.id = status.getValue();
+        } else if (_isClustered) {
+            StatusWith<RecordId> status =
+                clusteredid::extractKey(record.data.data(), record.data.size());
+            if (!status.isOK())
+                return status.getStatus();
+            record.id = status.getValue();
         } else if (_isCapped) {
             record.id = _nextId();
         } else {
             record.id = _nextId();
         }
-        dassert(record.id > highestId);
-        highestId = record.id;
+        // Clustered keys come from the documents, so they arrive in no particular order.
+        dassert(_isClustered || record.id > highestId);
+        highestId = std::max(highestId, record.id);
     }
 
     for (size_t i = 0; i < nRecords; i++) {
@@ -1294,6 +1525,19 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
             fassert(39001, opCtx->recoveryUnit()->setTimestamp(ts));
         }
         setKey(c, record.id);
+        if (_isClustered) {
+            // Record store cursors overwrite on insert, and without an _id index nothing else
+            // would reject a second document with the same _id.
+            int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search(c); });
+            if (ret == 0) {
+                const BSONObj obj(record.data.data());
+                return buildDupKeyErrorStatus(
+                    BSON("" << obj["_id"]), NamespaceString(ns()), "_id_", BSON("_id" << 1));
+            }
+            if (ret != WT_NOTFOUND)
+                return wtRCToStatus(ret, "WiredTigerRecordStore::insertRecord");
+            setKey(c, record.id);
+        }
         WiredTigerItem value(record.data.data(), record.data.size());
         c->set_value(c, value.Get());
         int ret = WT_OP_CHECK(c->insert(c));
@@ -1376,6 +1620,72 @@ Status WiredTigerRecordStore::insertRecordsWithDocWriter(OperationContext* opCtx
     return s;
 }
 
+class WiredTigerRecordStore::BulkRecordLoader final : public RecordStore::BulkLoader {
+public:
+    BulkRecordLoader(WiredTigerRecordStore* rs, UniqueWiredTigerSession session, WT_CURSOR* cursor)
+        : _rs(rs),
+          _session(std::move(session)),
+          _cursor(cursor),
+          _adjustSize(sizeRecoveryState(getGlobalServiceContext())
+                          .collectionNeedsSizeAdjustment(_rs->_ident)) {}
+
+    ~BulkRecordLoader() {
+        invariantWTOK(_cursor->close(_cursor));
+        if (_adjustSize && _rs->_sizeStorer)
+            _rs->_sizeStorer->store(_rs->_uri, _rs->_sizeInfo);
+    }
+
+    StatusWith<RecordId> insertRecord(const char* data, int len) override {
+        // RecordIds are handed out in increasing order, as bulk cursors require.
+        const RecordId id = _rs->_nextId();
+        _rs->setKey(_cursor, id);
+        WiredTigerItem value(data, len);
+        _cursor->set_value(_cursor, value.Get());
+        int ret = WT_OP_CHECK(_cursor->insert(_cursor));
+        if (ret)
+            return wtRCToStatus(ret, "WiredTigerRecordStore::BulkRecordLoader::insertRecord");
+
+        // Bulk-loaded records are never rolled back, so neither are the size adjustments.
+        if (_adjustSize) {
+            _rs->_sizeInfo->numRecords.fetchAndAdd(1);
+            _rs->_sizeInfo->dataSize.fetchAndAdd(len);
+        }
+        return id;
+    }
+
+private:
+    WiredTigerRecordStore* const _rs;
+    const UniqueWiredTigerSession _session;
+    WT_CURSOR* const _cursor;
+    const bool _adjustSize;
+};
+
+std::unique_ptr<RecordStore::BulkLoader> WiredTigerRecordStore::makeBulkLoader(
+    OperationContext* opCtx) {
+    if (_isCapped || _isOplog || _isClustered || numRecords(opCtx) != 0) {
+        return nullptr;
+    }
+
+    // Cursors cached on this operation's session would make the bulk open fail with EBUSY.
+    WiredTigerSession* outerSession = _getRecoveryUnit(opCtx)->getSession();
+    outerSession->closeAllCursors(_uri);
+
+    // Use a separate session so that the bulk cursor is outside of the operation's transaction,
+    // and fail quickly rather than waiting for a checkpoint to complete.
+    auto session = _getRecoveryUnit(opCtx)->getSessionCache()->getSession();
+    WT_SESSION* wtSession = session->getSession();
+    WT_CURSOR* cursor;
+    int ret = wtSession->open_cursor(
+        wtSession, _uri.c_str(), nullptr, "bulk,checkpoint_wait=false", &cursor);
+    if (ret != 0) {
+        LOG(1) << "Not bulk loading " << ns() << ", failed to open a bulk cursor: "
+               << wiredtiger_strerror(ret);
+        return nullptr;
+    }
+
+    return stdx::make_unique<BulkRecordLoader>(this, std::move(session), cursor);
+}
+
 Status WiredTigerRecordStore::updateRecord(OperationContext* opCtx,
                                            const RecordId& id,
                                            const char* data,
@@ -1494,6 +1804,13 @@ Status WiredTigerRecordStore::compact(OperationContext* opCtx) {
     return Status::OK();
 }
 
+StatusWith<bool> WiredTigerRecordStore::compactChunk(OperationContext* opCtx, Seconds timeLimit) {
+    if (_isEphemeral) {
+        return true;
+    }
+    return WiredTigerUtil::compactChunk(opCtx, getURI(), timeLimit);
+}
+
 void WiredTigerRecordStore::validate(OperationContext* opCtx,
                                      ValidateCmdLevel level,
                                      ValidateResults* results,
@@ -112,6 +112,8 @@ public:
         CappedCallback* cappedCallback;
         WiredTigerSizeStorer* sizeStorer;
         bool isReadOnly;
+        // Records are keyed by the RecordId derived from their _id; see clustered_id.h.
+        bool isClustered = false;
     };
 
     WiredTigerRecordStore(WiredTigerKVEngine* kvEngine, OperationContext* opCtx, Params params);
@@ -129,6 +131,10 @@ public:
 
     virtual bool isCapped() const;
 
+    bool isClustered() const override {
+        return _isClustered;
+    }
+
     virtual int64_t storageSize(OperationContext* opCtx,
                                 BSONObjBuilder* extraInfo = NULL,
                                 int infoLevel = 0) const;
@@ -149,6 +155,12 @@ public:
                                               size_t nDocs,
                                               RecordId* idsOut);
 
+    /**
+     * Returns a loader which appends through a WiredTiger bulk cursor. Bulk cursors can only be
+     * opened on a table which has never held data and has no other open cursors.
+     */
+    std::unique_ptr<BulkLoader> makeBulkLoader(OperationContext* opCtx) override;
+
     virtual Status updateRecord(OperationContext* opCtx,
                                 const RecordId& recordId,
                                 const char* data,
@@ -183,6 +195,12 @@ public:
 
     virtual Status compact(OperationContext* opCtx) final;
 
+    bool compactsOnline() const final {
+        return true;
+    }
+
+    StatusWith<bool> compactChunk(OperationContext* opCtx, Seconds timeLimit) final;
+
     virtual bool isInRecordIdOrder() const override {
         return true;
     }
@@ -274,6 +292,7 @@ protected:
 
 private:
     class RandomCursor;
+    class BulkRecordLoader;
 
     class NumRecordsChange;
     class DataSizeChange;
@@ -341,6 +360,8 @@ private:
     const bool _isEphemeral;
     // True if the namespace of this record store starts with "local.oplog.", and false otherwise.
     const bool _isOplog;
+    // True if records are keyed by the RecordId derived from their _id.
+    const bool _isClustered;
     int64_t _cappedMaxSize;
     const int64_t _cappedMaxSizeSlack;  // when to start applying backpressure
     const int64_t _cappedMaxDocs;
@@ -401,6 +422,11 @@ public:
         return _prefix;
     }
 
+    std::unique_ptr<BulkLoader> makeBulkLoader(OperationContext* opCtx) override {
+        // The table is shared with other prefixed record stores, so it is never empty.
+        return nullptr;
+    }
+
 protected:
     virtual RecordId getKey(WT_CURSOR* cursor) const;
 
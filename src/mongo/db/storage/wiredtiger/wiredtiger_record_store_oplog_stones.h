@@ -38,8 +38,10 @@
 
 namespace mongo {
 
+class BSONObjBuilder;
 class OperationContext;
 class RecordId;
+class WiredTigerSessionCache;
 
 // Keep "milestones" against the oplog to efficiently remove the old records when the collection
 // grows beyond its desired maximum size.
@@ -53,6 +55,9 @@ public:
 
     OplogStones(OperationContext* opCtx, WiredTigerRecordStore* rs);
 
+    // Reports how the stones were computed at startup and how long truncation has taken so far.
+    static void appendStats(BSONObjBuilder* builder);
+
     bool isDead();
 
     void kill();
@@ -118,6 +123,7 @@ private:
     class TruncateChange;
 
     void _calculateStones(OperationContext* opCtx, size_t size);
+    bool _loadStones(OperationContext* opCtx);
     void _calculateStonesByScanning(OperationContext* opCtx);
     void _calculateStonesBySampling(OperationContext* opCtx,
                                     int64_t estRecordsPerStone,
@@ -125,10 +131,22 @@ private:
 
     void _pokeReclaimThreadIfNeeded();
 
+    // Returns true if the oplog entries covered by 'stone' are younger than the minimum retention
+    // period configured by 'oplogMinRetentionHours'.
+    bool _isRetained(const OplogStones::Stone& stone) const;
+
+    // Writes the current deque of stones to the stones table so that the next startup can reload
+    // them instead of sampling or scanning the oplog. Must be called while holding '_mutex'.
+    void _persistStones_inlock();
+
     static const uint64_t kRandomSamplesPerStone = 10;
 
     WiredTigerRecordStore* _rs;
 
+    // Used to write the stones table outside of the transaction of the operation that caused the
+    // stones to change. Null if the stones are not persisted.
+    WiredTigerSessionCache* _sessionCache = nullptr;
+
     stdx::mutex _oplogReclaimMutex;
     stdx::condition_variable _oplogReclaimCv;
 
@@ -43,6 +43,7 @@
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
 #include "mongo/db/storage/record_store_test_harness.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_parameters_gen.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
@@ -867,5 +868,101 @@ TEST(WiredTigerRecordStoreTest, OplogStones_AscendingOrder) {
     }
 }
 
+// Verify that the oplog stones are reloaded from the stones table rather than recomputed when the
+// oplog's record store is reopened.
+TEST(WiredTigerRecordStoreTest, OplogStones_ReloadPersistedStones) {
+    std::unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
+
+    // With a 10KB oplog, each stone holds at least 1KB.
+    const int64_t cappedMaxSize = 10 * 1024;
+    unique_ptr<RecordStore> rs(
+        harnessHelper->newCappedRecordStore("local.oplog.stones", cappedMaxSize, -1));
+
+    {
+        WiredTigerRecordStore::OplogStones* oplogStones =
+            static_cast<WiredTigerRecordStore*>(rs.get())->oplogStones();
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 1), 1024), RecordId(1, 1));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 2), 1024), RecordId(1, 2));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 3), 100), RecordId(1, 3));
+        ASSERT_EQ(2U, oplogStones->numStones());
+        ASSERT_EQ(1, oplogStones->currentRecords());
+        ASSERT_EQ(100, oplogStones->currentBytes());
+    }
+
+    rs.reset();
+    rs = harnessHelper->newCappedRecordStore("local.oplog.stones", cappedMaxSize, -1);
+    WiredTigerRecordStore::OplogStones* oplogStones =
+        static_cast<WiredTigerRecordStore*>(rs.get())->oplogStones();
+
+    ASSERT_EQ(2U, oplogStones->numStones());
+    ASSERT_EQ(1, oplogStones->currentRecords());
+    ASSERT_EQ(100, oplogStones->currentBytes());
+
+    BSONObjBuilder builder;
+    WiredTigerRecordStore::OplogStones::appendStats(&builder);
+    ASSERT_EQ("persisted", builder.obj()["processingMethod"].str());
+}
+
+// Verify that oplog stones younger than 'oplogMinRetentionHours' are not truncated, even when the
+// oplog exceeds its maximum size.
+TEST(WiredTigerRecordStoreTest, OplogStones_MinRetentionHours) {
+    std::unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
+
+    const int64_t cappedMaxSize = 10 * 1024;  // 10KB
+    unique_ptr<RecordStore> rs(
+        harnessHelper->newCappedRecordStore("local.oplog.stones", cappedMaxSize, -1));
+
+    WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+    WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_OK(wtrs->updateCappedSize(opCtx.get(), 230U));
+    }
+
+    oplogStones->setMinBytesPerStone(100);
+
+    const unsigned now = Date_t::now().toTimeT();
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(now, 1), 100),
+                  RecordId(now, 1));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(now, 2), 110),
+                  RecordId(now, 2));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(now, 3), 120),
+                  RecordId(now, 3));
+        ASSERT_EQ(3U, oplogStones->numStones());
+    }
+
+    gOplogMinRetentionHours.store(1.0);
+    ON_BLOCK_EXIT([] { gOplogMinRetentionHours.store(0.0); });
+
+    // The oldest stone was written less than an hour ago, so it must be kept.
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        wtrs->reclaimOplog(opCtx.get(), Timestamp::max());
+
+        ASSERT_EQ(3, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(330, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(3U, oplogStones->numStones());
+    }
+
+    // Once the retention period no longer covers the oldest stone, it is truncated as usual.
+    gOplogMinRetentionHours.store(0.0);
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        wtrs->reclaimOplog(opCtx.get(), Timestamp::max());
+
+        ASSERT_EQ(2, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(230, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(2U, oplogStones->numStones());
+    }
+}
+
 }  // namespace
 }  // namespace mongo
@@ -36,6 +36,7 @@
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
@@ -76,6 +77,21 @@ BSONObj WiredTigerServerStatusSection::generateSection(OperationContext* opCtx,
 
     WiredTigerKVEngine::appendGlobalStats(bob);
 
+    {
+        BSONObjBuilder checkpointBuilder(bob.subobjStart("checkpointScheduler"));
+        _engine->appendCheckpointStats(&checkpointBuilder);
+    }
+
+    {
+        BSONObjBuilder sessionCacheBuilder(bob.subobjStart("sessionCache"));
+        WiredTigerRecoveryUnit::get(opCtx)->getSessionCache()->appendStats(&sessionCacheBuilder);
+    }
+
+    {
+        BSONObjBuilder oplogTruncationBuilder(bob.subobjStart("oplogTruncation"));
+        WiredTigerRecordStore::OplogStones::appendStats(&oplogTruncationBuilder);
+    }
+
     WiredTigerUtil::appendSnapshotWindowSettings(_engine, session, &bob);
 
     return bob.obj();
@@ -42,6 +42,9 @@ class WiredTigerServerStatusSection : public ServerStatusSection {
 public:
     WiredTigerServerStatusSection(WiredTigerKVEngine* engine);
     bool includeByDefault() const override;
+    Cost cost() const override {
+        return Cost::kExpensive;
+    }
     BSONObj generateSection(OperationContext* opCtx,
                             const BSONElement& configElement) const override;
 
@@ -33,7 +33,12 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
+#include <algorithm>
+#include <iterator>
+
 #include "mongo/base/error_codes.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/client.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/global_settings.h"
 #include "mongo/db/repl/repl_settings.h"
@@ -43,6 +48,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
 
@@ -52,6 +58,15 @@ const std::string kWTRepairMsg =
     "Please read the documentation for starting MongoDB with --repair here: "
     "http://dochub.mongodb.org/core/repair";
 
+namespace {
+
+// Hands out preferred session cache partitions to threads round robin.
+AtomicWord<unsigned> nextPreferredPartition{0};
+
+}  // namespace
+
+constexpr size_t WiredTigerSessionCache::kNumPartitions;
+
 WiredTigerSession::WiredTigerSession(WT_CONNECTION* conn, uint64_t epoch, uint64_t cursorEpoch)
     : _epoch(epoch),
       _cursorEpoch(cursorEpoch),
@@ -106,18 +121,24 @@ void _openCursor(WT_SESSION* session,
 
 WT_CURSOR* WiredTigerSession::getCursor(const std::string& uri, uint64_t id, bool allowOverwrite) {
     // Find the most recently used cursor
-    for (CursorCache::iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-        if (i->_id == id) {
-            WT_CURSOR* c = i->_cursor;
-            _cursors.erase(i);
-            _cursorsOut++;
-            return c;
+    auto indexed = _cursorIndex.find(id);
+    if (indexed != _cursorIndex.end()) {
+        auto i = indexed->second.back();
+        WT_CURSOR* c = i->_cursor;
+        indexed->second.pop_back();
+        if (indexed->second.empty()) {
+            _cursorIndex.erase(indexed);
         }
+        _cursors.erase(i);
+        _cursorsOut++;
+        _cursorCacheHits++;
+        return c;
     }
 
     WT_CURSOR* cursor = NULL;
     _openCursor(_session, uri, allowOverwrite ? "" : "overwrite=false", &cursor);
     _cursorsOut++;
+    _cursorCacheMisses++;
     return cursor;
 }
 
@@ -139,13 +160,16 @@ void WiredTigerSession::releaseCursor(uint64_t id, WT_CURSOR* cursor) {
 
     // Cursors are pushed to the front of the list and removed from the back
     _cursors.push_front(WiredTigerCachedCursor(id, _cursorGen++, cursor));
+    _cursorIndex[id].push_back(_cursors.begin());
 
     // A negative value for wiredTigercursorCacheSize means to use hybrid caching.
     std::uint32_t cacheSize = abs(gWiredTigerCursorCacheSize.load());
 
     while (!_cursors.empty() && _cursorGen - _cursors.back()._gen > cacheSize) {
-        cursor = _cursors.back()._cursor;
-        _cursors.pop_back();
+        auto oldest = std::prev(_cursors.end());
+        cursor = oldest->_cursor;
+        _unindexCursor(oldest);
+        _cursors.erase(oldest);
         invariantWTOK(cursor->close(cursor));
     }
 }
@@ -166,6 +190,7 @@ void WiredTigerSession::closeAllCursors(const std::string& uri) {
         WT_CURSOR* cursor = i->_cursor;
         if (cursor && (all || uri == cursor->uri)) {
             invariantWTOK(cursor->close(cursor));
+            _unindexCursor(i);
             i = _cursors.erase(i);
         } else
             ++i;
@@ -177,6 +202,9 @@ void WiredTigerSession::closeCursorsForQueuedDrops(WiredTigerKVEngine* engine) {
 
     _cursorEpoch = _cache->getCursorEpoch();
     auto toDrop = engine->filterCursorsWithQueuedDrops(&_cursors);
+    if (!toDrop.empty()) {
+        _rebuildCursorIndex();
+    }
 
     for (auto i = toDrop.begin(); i != toDrop.end(); i++) {
         WT_CURSOR* cursor = i->_cursor;
@@ -186,6 +214,26 @@ void WiredTigerSession::closeCursorsForQueuedDrops(WiredTigerKVEngine* engine) {
     }
 }
 
+void WiredTigerSession::_unindexCursor(CursorCache::iterator it) {
+    auto indexed = _cursorIndex.find(it->_id);
+    invariant(indexed != _cursorIndex.end());
+    auto& cursors = indexed->second;
+    cursors.erase(std::find(cursors.begin(), cursors.end(), it));
+    if (cursors.empty()) {
+        _cursorIndex.erase(indexed);
+    }
+}
+
+void WiredTigerSession::_rebuildCursorIndex() {
+    _cursorIndex.clear();
+    // The list is ordered from most to least recently released, so walk it backwards to keep each
+    // ID's cursors ordered oldest first.
+    for (auto i = _cursors.end(); i != _cursors.begin();) {
+        --i;
+        _cursorIndex[i->_id].push_back(i);
+    }
+}
+
 namespace {
 AtomicWord<unsigned long long> nextTableId(1);
 }
@@ -231,6 +279,17 @@ void WiredTigerSessionCache::shuttingDown() {
         sleepmillis(1);
     }
 
+    // Nobody can be queued for a group commit anymore, since every caller of waitUntilDurable has
+    // returned and new ones fail the shutdown check.
+    {
+        stdx::lock_guard<stdx::mutex> lk(_groupCommitMutex);
+        _groupCommitShutdown = true;
+        _groupCommitCV.notify_one();
+    }
+    if (_groupCommitThread.joinable()) {
+        _groupCommitThread.join();
+    }
+
     closeAll();
 }
 
@@ -273,6 +332,11 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         return;
     }
 
+    if (gWiredTigerJournalGroupCommit.load() && _engine && _engine->isDurable()) {
+        _queueForGroupCommit().get();
+        return;
+    }
+
     uint32_t start = _lastSyncTime.load();
     // Do the remainder in a critical section that ensures only a single thread at a time
     // will attempt to synchronize.
@@ -285,7 +349,10 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
     _lastSyncTime.store(current + 1);
 
     // Nobody has synched yet, so we have to sync ourselves.
+    _syncAndNotifyListener();
+}
 
+void WiredTigerSessionCache::_syncAndNotifyListener() {
     // This gets the token (OpTime) from the last write, before flushing (either the journal, or a
     // checkpoint), and then reports that token (OpTime) as a durable write.
     stdx::unique_lock<stdx::mutex> jlk(_journalListenerMutex);
@@ -308,6 +375,76 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
     _journalListener->onDurable(token);
 }
 
+Future<void> WiredTigerSessionCache::_queueForGroupCommit() {
+    auto pf = makePromiseFuture<void>();
+    stdx::lock_guard<stdx::mutex> lk(_groupCommitMutex);
+    invariant(!_groupCommitShutdown);
+    if (!_groupCommitThread.joinable()) {
+        _groupCommitThread = stdx::thread([this] { _groupCommitThreadLoop(); });
+    }
+    _groupCommitWaiters.push_back(std::move(pf.promise));
+    _groupCommitCV.notify_one();
+    return std::move(pf.future);
+}
+
+void WiredTigerSessionCache::_groupCommitThreadLoop() {
+    Client::initThread("WTJournalGroupCommitter");
+
+    stdx::unique_lock<stdx::mutex> lk(_groupCommitMutex);
+    while (true) {
+        {
+            MONGO_IDLE_THREAD_BLOCK;
+            _groupCommitCV.wait(
+                lk, [&] { return _groupCommitShutdown || !_groupCommitWaiters.empty(); });
+        }
+        if (_groupCommitWaiters.empty()) {
+            invariant(_groupCommitShutdown);
+            return;
+        }
+
+        // Under concurrency, waiting briefly for more callers to queue lets one sync cover all of
+        // them instead of each paying for its own. Scale the wait by the previous batch size so
+        // that a lone caller is not delayed for company that isn't coming.
+        const size_t targetBatchSize = gWiredTigerJournalGroupCommitTargetBatchSize.load();
+        const auto maxDelay = Microseconds(gWiredTigerJournalGroupCommitMaxDelayMicros.load());
+        if (_lastGroupCommitBatchSize > 1 && _groupCommitWaiters.size() < targetBatchSize) {
+            const auto delay = maxDelay *
+                static_cast<long long>(std::min(_lastGroupCommitBatchSize, targetBatchSize)) /
+                static_cast<long long>(targetBatchSize);
+            _groupCommitCV.wait_for(lk, delay.toSystemDuration(), [&] {
+                return _groupCommitShutdown || _groupCommitWaiters.size() >= targetBatchSize;
+            });
+        }
+
+        // Every caller in this batch queued before the sync below begins, so the sync covers all
+        // of their commits.
+        auto batch = std::move(_groupCommitWaiters);
+        _groupCommitWaiters.clear();
+        _lastGroupCommitBatchSize = batch.size();
+        lk.unlock();
+
+        Status status = Status::OK();
+        try {
+            stdx::lock_guard<stdx::mutex> syncLk(_lastSyncMutex);
+            _lastSyncTime.fetchAndAdd(1);
+            _syncAndNotifyListener();
+        } catch (const DBException& ex) {
+            status = ex.toStatus();
+        }
+        _groupCommitBatchCount.fetchAndAdd(1);
+        _groupCommitWaiterCount.fetchAndAdd(static_cast<long long>(batch.size()));
+        for (auto& promise : batch) {
+            if (status.isOK()) {
+                promise.emplaceValue();
+            } else {
+                promise.setError(status);
+            }
+        }
+
+        lk.lock();
+    }
+}
+
 void WiredTigerSessionCache::waitUntilPreparedUnitOfWorkCommitsOrAborts(OperationContext* opCtx,
                                                                         std::uint64_t lastCount) {
     invariant(opCtx);
@@ -327,9 +464,11 @@ void WiredTigerSessionCache::notifyPreparedUnitOfWorkHasCommittedOrAborted() {
 
 
 void WiredTigerSessionCache::closeAllCursors(const std::string& uri) {
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeAllCursors(uri);
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition.mutex);
+        for (auto&& session : partition.sessions) {
+            session->closeAllCursors(uri);
+        }
     }
 }
 
@@ -337,15 +476,47 @@ void WiredTigerSessionCache::closeCursorsForQueuedDrops() {
     // Increment the cursor epoch so that all cursors from this epoch are closed.
     _cursorEpoch.fetchAndAdd(1);
 
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeCursorsForQueuedDrops(_engine);
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition.mutex);
+        for (auto&& session : partition.sessions) {
+            session->closeCursorsForQueuedDrops(_engine);
+        }
     }
 }
 
 size_t WiredTigerSessionCache::getIdleSessionsCount() {
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    return _sessions.size();
+    size_t count = 0;
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition.mutex);
+        count += partition.sessions.size();
+    }
+    return count;
+}
+
+void WiredTigerSessionCache::appendStats(BSONObjBuilder* builder) {
+    builder->append("idleSessions", static_cast<long long>(getIdleSessionsCount()));
+    builder->append("partitions", static_cast<long long>(kNumPartitions));
+    builder->append("partitionContention", _partitionContentionCount.load());
+    builder->append("stolenSessions", _stolenSessionCount.load());
+    builder->append("openedSessions", _openedSessionCount.load());
+    builder->append("cursorCacheHits", _cursorCacheHitCount.load());
+    builder->append("cursorCacheMisses", _cursorCacheMissCount.load());
+    builder->append("journalGroupCommits", _groupCommitBatchCount.load());
+    builder->append("journalGroupCommitWaiters", _groupCommitWaiterCount.load());
+}
+
+size_t WiredTigerSessionCache::_getPreferredPartition() {
+    static thread_local size_t partition = nextPreferredPartition.fetchAndAdd(1) % kNumPartitions;
+    return partition;
+}
+
+stdx::unique_lock<stdx::mutex> WiredTigerSessionCache::_lockPartition(Partition& partition) {
+    stdx::unique_lock<stdx::mutex> lock(partition.mutex, stdx::try_to_lock);
+    if (!lock.owns_lock()) {
+        _partitionContentionCount.fetchAndAdd(1);
+        lock.lock();
+    }
+    return lock;
 }
 
 void WiredTigerSessionCache::closeExpiredIdleSessions(int64_t idleTimeMillis) {
@@ -355,14 +526,14 @@ void WiredTigerSessionCache::closeExpiredIdleSessions(int64_t idleTimeMillis) {
     }
 
     auto cutoffTime = _clockSource->now() - Milliseconds(idleTimeMillis);
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition.mutex);
         // Discard all sessions that became idle before the cutoff time
-        for (auto it = _sessions.begin(); it != _sessions.end();) {
+        for (auto it = partition.sessions.begin(); it != partition.sessions.end();) {
             auto session = *it;
             invariant(session->getIdleExpireTime() != Date_t::min());
             if (session->getIdleExpireTime() < cutoffTime) {
-                it = _sessions.erase(it);
+                it = partition.sessions.erase(it);
                 delete (session);
             } else {
                 ++it;
@@ -372,17 +543,21 @@ void WiredTigerSessionCache::closeExpiredIdleSessions(int64_t idleTimeMillis) {
 }
 
 void WiredTigerSessionCache::closeAll() {
-    // Increment the epoch as we are now closing all sessions with this epoch.
-    SessionCache swap;
+    // Increment the epoch as we are now closing all sessions with this epoch. This happens before
+    // any partition is emptied: releaseSession() checks the epoch under the partition lock, so a
+    // session of the old epoch is either rejected there or cached before we empty its partition.
+    _epoch.fetchAndAdd(1);
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        _epoch.fetchAndAdd(1);
-        _sessions.swap(swap);
-    }
+    for (auto&& partition : _partitions) {
+        SessionCache swap;
+        {
+            stdx::lock_guard<stdx::mutex> lock(partition.mutex);
+            partition.sessions.swap(swap);
+        }
 
-    for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
-        delete (*i);
+        for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
+            delete (*i);
+        }
     }
 }
 
@@ -395,19 +570,38 @@ UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
+    // Get the most recently used session so that if we discard sessions, we're discarding older
+    // ones.
+    auto takeSession = [](SessionCache& sessions) {
+        WiredTigerSession* cachedSession = sessions.back();
+        sessions.pop_back();
+        // Reset the idle time
+        cachedSession->setIdleExpireTime(Date_t::min());
+        return UniqueWiredTigerSession(cachedSession);
+    };
+
+    const size_t preferred = _getPreferredPartition();
     {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        if (!_sessions.empty()) {
-            // Get the most recently used session so that if we discard sessions, we're
-            // discarding older ones
-            WiredTigerSession* cachedSession = _sessions.back();
-            _sessions.pop_back();
-            // Reset the idle time
-            cachedSession->setIdleExpireTime(Date_t::min());
-            return UniqueWiredTigerSession(cachedSession);
+        auto& partition = _partitions[preferred];
+        auto lock = _lockPartition(partition);
+        if (!partition.sessions.empty()) {
+            return takeSession(partition.sessions);
         }
     }
 
+    // Take a session from another partition before opening a new one. Partitions in use by other
+    // threads are skipped rather than waited for.
+    for (size_t i = 1; i < kNumPartitions; ++i) {
+        auto& partition = _partitions[(preferred + i) % kNumPartitions];
+        stdx::unique_lock<stdx::mutex> lock(partition.mutex, stdx::try_to_lock);
+        if (lock.owns_lock() && !partition.sessions.empty()) {
+            _stolenSessionCount.fetchAndAdd(1);
+            return takeSession(partition.sessions);
+        }
+    }
+
+    _openedSessionCount.fetchAndAdd(1);
+
     // Outside of the cache partition lock, but on release will be put back on the cache
     return UniqueWiredTigerSession(
         new WiredTigerSession(_conn, this, _epoch.load(), _cursorEpoch.load()));
@@ -448,6 +642,14 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
         invariantWTOK(ss->reset(ss));
     }
 
+    // Fold the cursor cache statistics gathered since the session was last released into the totals.
+    _cursorCacheHitCount.fetchAndAdd(session->_cursorCacheHits -
+                                     session->_reportedCursorCacheHits);
+    _cursorCacheMissCount.fetchAndAdd(session->_cursorCacheMisses -
+                                      session->_reportedCursorCacheMisses);
+    session->_reportedCursorCacheHits = session->_cursorCacheHits;
+    session->_reportedCursorCacheMisses = session->_cursorCacheMisses;
+
     // If the cursor epoch has moved on, close all cursors in the session.
     uint64_t cursorEpoch = _cursorEpoch.load();
     if (session->_getCursorEpoch() != cursorEpoch)
@@ -463,10 +665,11 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     session->setIdleExpireTime(_clockSource->now());
 
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        auto& partition = _partitions[_getPreferredPartition()];
+        auto lock = _lockPartition(partition);
         if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
             returnedToCache = true;
-            _sessions.push_back(session);
+            partition.sessions.push_back(session);
         }
     } else
         invariant(session->_getEpoch() < currentEpoch);
@@ -29,19 +29,27 @@
 
 #pragma once
 
+#include <array>
 #include <list>
 #include <string>
+#include <vector>
 
 #include <wiredtiger.h>
 
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_snapshot_manager.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/util/concurrency/spin_lock.h"
+#include "mongo/util/future.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
 class WiredTigerKVEngine;
 class WiredTigerSessionCache;
 
@@ -138,6 +146,18 @@ public:
         return _cursors.size();
     }
 
+    /**
+     * Number of getCursor() calls on this session that were satisfied from, or missed, the cursor
+     * cache.
+     */
+    uint64_t cursorCacheHits() const {
+        return _cursorCacheHits;
+    }
+
+    uint64_t cursorCacheMisses() const {
+        return _cursorCacheMisses;
+    }
+
     bool isDropQueuedIdentsAtSessionEndAllowed() const {
         return _dropQueuedIdentsAtSessionEnd;
     }
@@ -167,6 +187,16 @@ private:
     // The cursor cache is a list of pairs that contain an ID and cursor
     typedef std::list<WiredTigerCachedCursor> CursorCache;
 
+    // Indexes the cursor cache by table ID. Each ID maps to its cached cursors ordered from least
+    // to most recently released.
+    typedef stdx::unordered_map<uint64_t, std::vector<CursorCache::iterator>> CursorIndex;
+
+    // Removes a cached cursor from '_cursorIndex'. Call this before erasing it from '_cursors'.
+    void _unindexCursor(CursorCache::iterator it);
+
+    // Rebuilds '_cursorIndex' after cursors were erased from '_cursors' without being unindexed.
+    void _rebuildCursorIndex();
+
     // Used internally by WiredTigerSessionCache
     uint64_t _getEpoch() const {
         return _epoch;
@@ -182,8 +212,15 @@ private:
     WiredTigerSessionCache* _cache;  // not owned
     WT_SESSION* _session;            // owned
     CursorCache _cursors;            // owned
+    CursorIndex _cursorIndex;
     uint64_t _cursorGen;
     int _cursorsOut;
+    uint64_t _cursorCacheHits = 0;
+    uint64_t _cursorCacheMisses = 0;
+
+    // The portion of the hit and miss counts already added to the owning session cache's totals.
+    uint64_t _reportedCursorCacheHits = 0;
+    uint64_t _reportedCursorCacheMisses = 0;
     bool _dropQueuedIdentsAtSessionEnd = true;
     Date_t _idleExpireTime;
 };
@@ -191,6 +228,10 @@ private:
 /**
  *  This cache implements a shared pool of WiredTiger sessions with the goal to amortize the
  *  cost of session creation and destruction over multiple uses.
+ *
+ *  The pool is split into partitions, each with its own lock, to avoid a single lock being taken by
+ *  every operation. Each thread prefers one partition, and takes a session from another partition
+ *  when its own is empty.
  */
 class WiredTigerSessionCache {
 public:
@@ -223,6 +264,12 @@ public:
      */
     size_t getIdleSessionsCount();
 
+    /**
+     * Appends the number of idle sessions, counters describing contention on the cache's
+     * partitions and journal group commit counters to 'builder'.
+     */
+    void appendStats(BSONObjBuilder* builder);
+
     /**
      * Closes all cached sessions whose idle expiration time has been reached.
      */
@@ -257,6 +304,10 @@ public:
      * Waits until all commits that happened before this call are durable, either by flushing
      * the log or forcing a checkpoint if forceCheckpoint is true or the journal is disabled.
      * Uses a temporary session. Safe to call without any locks, even during shutdown.
+     *
+     * When 'wiredTigerJournalGroupCommit' is enabled, journal flushes are not issued by the
+     * caller. Instead the caller queues behind the group commit flusher thread, which syncs the
+     * journal once for every caller queued before that sync began.
      */
     void waitUntilDurable(bool forceCheckpoint, bool stableCheckpoint);
 
@@ -317,9 +368,40 @@ private:
     AtomicWord<unsigned> _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
-    stdx::mutex _cacheLock;
     typedef std::vector<WiredTigerSession*> SessionCache;
-    SessionCache _sessions;
+
+    struct Partition {
+        stdx::mutex mutex;
+        SessionCache sessions;
+    };
+
+    static constexpr size_t kNumPartitions = 16;
+
+    /**
+     * Returns the index of the partition the calling thread takes sessions from and releases them
+     * to. Threads are assigned partitions round robin the first time they call this.
+     */
+    static size_t _getPreferredPartition();
+
+    /**
+     * Locks 'partition', counting the acquisition as contended if another thread holds the lock.
+     */
+    stdx::unique_lock<stdx::mutex> _lockPartition(Partition& partition);
+
+    std::array<CacheAligned<Partition>, kNumPartitions> _partitions;
+
+    // Number of times a thread found its preferred partition locked by another thread.
+    AtomicWord<long long> _partitionContentionCount{0};
+
+    // Number of sessions taken from a partition other than the thread's preferred one.
+    AtomicWord<long long> _stolenSessionCount{0};
+
+    // Number of sessions opened because every partition was empty.
+    AtomicWord<long long> _openedSessionCount{0};
+
+    // Cursor cache hits and misses of sessions that have been released back to this cache.
+    AtomicWord<long long> _cursorCacheHitCount{0};
+    AtomicWord<long long> _cursorCacheMissCount{0};
 
     // Bumped when all open sessions need to be closed
     AtomicWord<unsigned long long> _epoch;  // atomic so we can check it outside of the lock
@@ -331,6 +413,19 @@ private:
     AtomicWord<unsigned> _lastSyncTime;
     stdx::mutex _lastSyncMutex;
 
+    // State of the group commit flusher. The thread is started by the first caller that queues
+    // for a group commit and stopped by shuttingDown().
+    stdx::mutex _groupCommitMutex;
+    stdx::condition_variable _groupCommitCV;
+    std::vector<Promise<void>> _groupCommitWaiters;
+    stdx::thread _groupCommitThread;
+    bool _groupCommitShutdown = false;
+    size_t _lastGroupCommitBatchSize = 0;
+
+    // Number of journal syncs issued by the group commit flusher and callers they made durable.
+    AtomicWord<long long> _groupCommitBatchCount{0};
+    AtomicWord<long long> _groupCommitWaiterCount{0};
+
     // Mutex and cond var for waiting on prepare commit or abort.
     stdx::mutex _prepareCommittedOrAbortedMutex;
     stdx::condition_variable _prepareCommittedOrAbortedCond;
@@ -344,6 +439,20 @@ private:
     WT_SESSION* _waitUntilDurableSession = nullptr;  // owned, and never explicitly closed
                                                      // (uses connection close to clean up)
 
+    /**
+     * Syncs the journal, or takes a checkpoint if the engine is not durable, and reports the last
+     * applied write as durable to the journal listener. Callers must hold '_lastSyncMutex'.
+     */
+    void _syncAndNotifyListener();
+
+    /**
+     * Queues the caller for the next group commit, starting the flusher thread if necessary. The
+     * returned future is ready once a journal sync that began after this call has completed.
+     */
+    Future<void> _queueForGroupCommit();
+
+    void _groupCommitThreadLoop();
+
     /**
      * Returns a session to the cache for later reuse. If closeAll was called between getting this
      * session and releasing it, the session is directly released. This method is thread safe.
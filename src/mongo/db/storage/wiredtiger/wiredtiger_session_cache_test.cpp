@@ -31,10 +31,13 @@
 
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/system_clock_source.h"
@@ -113,4 +116,95 @@ TEST(WiredTigerSessionCacheTest, CheckSessionCacheCleanup) {
     ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
 }
 
+TEST(WiredTigerSessionCacheTest, SessionsReleasedByOtherThreadsAreReused) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+
+    // Threads are assigned partitions round robin, so sessions released by these threads end up in
+    // partitions other than this thread's.
+    const size_t numThreads = 4;
+    std::vector<stdx::thread> threads;
+    for (size_t i = 0; i < numThreads; ++i) {
+        threads.emplace_back(
+            [sessionCache] { UniqueWiredTigerSession session = sessionCache->getSession(); });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    ASSERT_GTE(sessionCache->getIdleSessionsCount(), 1U);
+    const size_t idleSessions = sessionCache->getIdleSessionsCount();
+
+    // Taking every idle session must not open any new session.
+    std::vector<UniqueWiredTigerSession> sessions;
+    for (size_t i = 0; i < idleSessions; ++i) {
+        sessions.push_back(sessionCache->getSession());
+    }
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
+
+    BSONObjBuilder builder;
+    sessionCache->appendStats(&builder);
+    BSONObj stats = builder.obj();
+    ASSERT_EQUALS(stats["idleSessions"].numberLong(), 0);
+    ASSERT_EQUALS(stats["openedSessions"].numberLong(), static_cast<long long>(idleSessions));
+
+    sessions.clear();
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), idleSessions);
+
+    // After closeAll(), sessions of the old epoch are not returned to any partition.
+    {
+        UniqueWiredTigerSession session = sessionCache->getSession();
+        sessionCache->closeAll();
+        ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
+    }
+    ASSERT_EQUALS(sessionCache->getIdleSessionsCount(), 0U);
+}
+
+TEST(WiredTigerSessionCacheTest, CursorCacheLooksUpCursorsById) {
+    WiredTigerSessionCacheHarnessHelper harnessHelper("");
+    WiredTigerSessionCache* sessionCache = harnessHelper.getSessionCache();
+    UniqueWiredTigerSession session = sessionCache->getSession();
+    WT_SESSION* wtSession = session->getSession();
+
+    const std::vector<std::string> uris = {"table:a", "table:b", "table:c"};
+    std::vector<uint64_t> ids;
+    for (auto&& uri : uris) {
+        ASSERT_OK(wtRCToStatus(wtSession->create(wtSession, uri.c_str(), NULL)));
+        ids.push_back(WiredTigerSession::genTableId());
+    }
+
+    for (size_t i = 0; i < uris.size(); ++i) {
+        session->releaseCursor(ids[i], session->getCursor(uris[i], ids[i], true));
+    }
+    ASSERT_EQUALS(session->cursorCacheMisses(), 3U);
+    ASSERT_EQUALS(session->cursorCacheHits(), 0U);
+    ASSERT_EQUALS(session->cachedCursors(), 3);
+
+    // Two cursors on the same table are cached separately and handed back out in turn.
+    WT_CURSOR* first = session->getCursor(uris[1], ids[1], true);
+    WT_CURSOR* second = session->getCursor(uris[1], ids[1], true);
+    ASSERT_EQUALS(session->cursorCacheHits(), 1U);
+    ASSERT_EQUALS(session->cursorCacheMisses(), 4U);
+    session->releaseCursor(ids[1], first);
+    session->releaseCursor(ids[1], second);
+    ASSERT_EQUALS(session->cachedCursors(), 4);
+    ASSERT(session->getCursor(uris[1], ids[1], true) == second);
+    ASSERT(session->getCursor(uris[1], ids[1], true) == first);
+    ASSERT_EQUALS(session->cursorCacheHits(), 3U);
+    session->releaseCursor(ids[1], first);
+    session->releaseCursor(ids[1], second);
+
+    // Closing the cursors of one table leaves the others reachable.
+    session->closeAllCursors(uris[0]);
+    ASSERT_EQUALS(session->cachedCursors(), 3);
+    session->closeAllCursors(uris[1]);
+    ASSERT_EQUALS(session->cachedCursors(), 1);
+    session->releaseCursor(ids[2], session->getCursor(uris[2], ids[2], true));
+    ASSERT_EQUALS(session->cursorCacheHits(), 4U);
+    session->releaseCursor(ids[1], session->getCursor(uris[1], ids[1], true));
+    ASSERT_EQUALS(session->cursorCacheMisses(), 5U);
+
+    session->closeAllCursors("");
+    ASSERT_EQUALS(session->cachedCursors(), 0);
+}
+
 }  // namespace mongo
@@ -69,19 +69,24 @@ WiredTigerSizeStorer::~WiredTigerSizeStorer() {
 }
 
 void WiredTigerSizeStorer::store(StringData uri, std::shared_ptr<SizeInfo> sizeInfo) {
-    // If the SizeInfo is still dirty, we're done.
-    if (sizeInfo->_dirty.load() || _readOnly)
+    if (_readOnly)
         return;
 
-    // Ordering is important: as the entry may be flushed concurrently, set the dirty flag last.
-    stdx::lock_guard<stdx::mutex> lk(_bufferMutex);
-    auto& entry = _buffer[uri];
+    // If the SizeInfo was already dirty, it is buffered or about to be, so we're done. Otherwise
+    // this caller is the only one responsible for buffering it. A concurrent flush cannot miss the
+    // entry: flush clears the dirty flag before reading the counters, and any entry inserted after
+    // a flush swapped out the buffer is written by the next flush.
+    if (sizeInfo->_dirty.compareAndSwap(false, true))
+        return;
+
+    auto& partition = _partitionFor(uri);
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+    auto& entry = partition.buffer[uri];
     // During rollback it is possible to get a new SizeInfo. In that case clear the dirty flag,
     // so the SizeInfo can be destructed without triggering the dirty check invariant.
     if (entry && entry.get() != sizeInfo.get())
         entry->_dirty.store(false);
     entry = sizeInfo;
-    entry->_dirty.store(true);
     LOG(2) << "WiredTigerSizeStorer::store Marking " << uri
            << " dirty, numRecords: " << sizeInfo->numRecords.load()
            << ", dataSize: " << sizeInfo->dataSize.load() << ", use_count: " << entry.use_count();
@@ -90,9 +95,10 @@ void WiredTigerSizeStorer::store(StringData uri, std::shared_ptr<SizeInfo> sizeI
 std::shared_ptr<WiredTigerSizeStorer::SizeInfo> WiredTigerSizeStorer::load(StringData uri) const {
     {
         // Check if we can satisfy the read from the buffer.
-        stdx::lock_guard<stdx::mutex> bufferLock(_bufferMutex);
-        Buffer::const_iterator it = _buffer.find(uri);
-        if (it != _buffer.end())
+        const auto& partition = _partitionFor(uri);
+        stdx::lock_guard<stdx::mutex> bufferLock(partition.mutex);
+        Buffer::const_iterator it = partition.buffer.find(uri);
+        if (it != partition.buffer.end())
             return it->second;
     }
 
@@ -124,9 +130,14 @@ std::shared_ptr<WiredTigerSizeStorer::SizeInfo> WiredTigerSizeStorer::load(Strin
 
 void WiredTigerSizeStorer::flush(bool syncToDisk) {
     Buffer buffer;
-    {
-        stdx::lock_guard<stdx::mutex> bufferLock(_bufferMutex);
-        _buffer.swap(buffer);
+    for (auto& partition : _buffers) {
+        Buffer partitionBuffer;
+        {
+            stdx::lock_guard<stdx::mutex> bufferLock(partition.mutex);
+            partition.buffer.swap(partitionBuffer);
+        }
+        for (auto& it : partitionBuffer)
+            buffer.emplace(it.first, std::move(it.second));
     }
 
     if (buffer.empty())
@@ -138,10 +149,10 @@ void WiredTigerSizeStorer::flush(bool syncToDisk) {
         // On failure, place entries back into the map, unless a newer value already exists.
         ON_BLOCK_EXIT([this, &buffer]() {
             this->_cursor->reset(this->_cursor);
-            if (!buffer.empty()) {
-                stdx::lock_guard<stdx::mutex> bufferLock(this->_bufferMutex);
-                for (auto& it : buffer)
-                    this->_buffer.try_emplace(it.first, it.second);
+            for (auto& it : buffer) {
+                auto& partition = this->_partitionFor(it.first);
+                stdx::lock_guard<stdx::mutex> bufferLock(partition.mutex);
+                partition.buffer.try_emplace(it.first, it.second);
             }
         });
 
@@ -174,4 +185,13 @@ void WiredTigerSizeStorer::flush(bool syncToDisk) {
     auto micros = t.micros();
     LOG(2) << "WiredTigerSizeStorer flush took " << micros << " µs";
 }
+
+WiredTigerSizeStorer::BufferPartition& WiredTigerSizeStorer::_partitionFor(StringData uri) {
+    return _buffers[StringMapHasher()(uri) % kNumBufferPartitions];
+}
+
+const WiredTigerSizeStorer::BufferPartition& WiredTigerSizeStorer::_partitionFor(
+    StringData uri) const {
+    return _buffers[StringMapHasher()(uri) % kNumBufferPartitions];
+}
 }  // namespace mongo
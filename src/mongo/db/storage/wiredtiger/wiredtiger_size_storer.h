@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <array>
 #include <string>
 
 #include <wiredtiger.h>
@@ -38,6 +39,7 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/string_map.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
@@ -59,7 +61,8 @@ public:
      * and their data size. Storing a SizeInfo in the WiredTigerSizeStorer results in shared
      * ownership. The SizeInfo may still be updated after it is stored in the SizeStorer.
      * The 'dirty' field is used by the size storer to cheaply merge duplicate stores of the same
-     * SizeInfo.
+     * SizeInfo: only the store that flips it from false to true touches the buffer, so repeated
+     * stores between two flushes never take a lock.
      */
     struct SizeInfo {
         ~SizeInfo() {
@@ -94,13 +97,24 @@ public:
 private:
     const WiredTigerSession _session;
     const bool _readOnly;
-    // Guards _cursor. Acquire *before* _bufferMutex.
+    // Guards _cursor. Acquire *before* any buffer partition mutex.
     mutable stdx::mutex _cursorMutex;
     WT_CURSOR* _cursor;  // pointer is const after constructor
 
     using Buffer = StringMap<std::shared_ptr<SizeInfo>>;
 
-    mutable stdx::mutex _bufferMutex;  // Guards _buffer
-    Buffer _buffer;
+    // The buffer is split into partitions by URI, so that collections becoming dirty at the same
+    // time don't serialize on a single mutex.
+    struct BufferPartition {
+        mutable stdx::mutex mutex;  // Guards buffer
+        Buffer buffer;
+    };
+
+    static constexpr size_t kNumBufferPartitions = 16;
+
+    BufferPartition& _partitionFor(StringData uri);
+    const BufferPartition& _partitionFor(StringData uri) const;
+
+    std::array<CacheAligned<BufferPartition>, kNumBufferPartitions> _buffers;
 };
 }
@@ -33,6 +33,7 @@
 #include <sstream>
 #include <string>
 #include <time.h>
+#include <vector>
 
 #include "mongo/base/checked_cast.h"
 #include "mongo/base/init.h"
@@ -55,6 +56,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
@@ -344,5 +346,43 @@ TEST_F(SizeStorerUpdateTest, Basic) {
     ASSERT_EQUALS(getDataSize(), val);
 }
 
+// Concurrent stores of many collections' sizes are all buffered and written back by one flush.
+TEST_F(SizeStorerUpdateTest, ConcurrentStoresAcrossUris) {
+    const int kThreads = 8;
+    const int kUrisPerThread = 50;
+    std::vector<std::shared_ptr<WiredTigerSizeStorer::SizeInfo>> infos;
+    for (int i = 0; i < kThreads * kUrisPerThread; ++i) {
+        infos.push_back(std::make_shared<WiredTigerSizeStorer::SizeInfo>());
+    }
+
+    std::vector<stdx::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = t * kUrisPerThread; i < (t + 1) * kUrisPerThread; ++i) {
+                // Repeated stores of a dirty SizeInfo only update its counters.
+                for (int j = 0; j < 10; ++j) {
+                    infos[i]->numRecords.fetchAndAdd(1);
+                    infos[i]->dataSize.fetchAndAdd(i);
+                    sizeStorer->store("table:concurrent" + std::to_string(i), infos[i]);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    sizeStorer->flush(false);
+
+    const bool enableWtLogging = false;
+    WiredTigerSizeStorer reloaded(
+        harnessHelper->conn(), WiredTigerKVEngine::kTableUriPrefix + "sizeStorer", enableWtLogging);
+    for (int i = 0; i < kThreads * kUrisPerThread; ++i) {
+        auto info = reloaded.load("table:concurrent" + std::to_string(i));
+        ASSERT_EQUALS(10, info->numRecords.load());
+        ASSERT_EQUALS(10LL * i, info->dataSize.load());
+    }
+}
+
 }  // namespace
 }  // namespace mongo
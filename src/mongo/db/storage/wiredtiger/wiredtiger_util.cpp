@@ -363,6 +363,25 @@ int64_t WiredTigerUtil::getIdentSize(WT_SESSION* s, const std::string& uri) {
     return result.getValue();
 }
 
+StatusWith<bool> WiredTigerUtil::compactChunk(OperationContext* opCtx,
+                                               const std::string& uri,
+                                               Seconds timeLimit) {
+    WT_SESSION* s = WiredTigerRecoveryUnit::get(opCtx)->getSession()->getSession();
+    opCtx->recoveryUnit()->abandonSnapshot();
+
+    // A timeout of 0 would mean no limit at all.
+    const std::string config = str::stream()
+        << "timeout=" << std::max(durationCount<Seconds>(timeLimit), 1LL);
+    int ret = s->compact(s, uri.c_str(), config.c_str());
+    if (ret == ETIMEDOUT) {
+        return false;
+    }
+    if (ret != 0) {
+        return wtRCToStatus(ret);
+    }
+    return true;
+}
+
 size_t WiredTigerUtil::getCacheSizeMB(double requestedCacheSizeGB) {
     double cacheSizeMB;
     const double kMaxSizeCacheMB = 10 * 1000 * 1000;
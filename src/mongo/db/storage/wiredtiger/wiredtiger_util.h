@@ -37,6 +37,7 @@
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/duration.h"
 
 namespace mongo {
 
@@ -231,6 +232,15 @@ public:
 
     static int64_t getIdentSize(WT_SESSION* s, const std::string& uri);
 
+    /**
+     * Compacts the table at 'uri' for about 'timeLimit' at most. WiredTiger keeps the blocks it
+     * has moved when the time runs out, so repeated calls make progress. Returns true once the
+     * table has nothing left to compact.
+     */
+    static StatusWith<bool> compactChunk(OperationContext* opCtx,
+                                         const std::string& uri,
+                                         Seconds timeLimit);
+
 
     /**
      * Return amount of memory to use for the WiredTiger cache based on either the startup
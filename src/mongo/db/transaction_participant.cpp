@@ -60,6 +60,7 @@
 #include "mongo/db/server_transactions_metrics.h"
 #include "mongo/db/session.h"
 #include "mongo/db/session_catalog.h"
+#include "mongo/db/session_txn_record_cache.h"
 #include "mongo/db/stats/fill_locker_info.h"
 #include "mongo/db/transaction_history_iterator.h"
 #include "mongo/db/transaction_participant_gen.h"
@@ -107,14 +108,79 @@ struct ActiveTransactionHistory {
     bool hasIncompleteHistory{false};
 };
 
-ActiveTransactionHistory fetchActiveTransactionHistory(OperationContext* opCtx,
-                                                       const LogicalSessionId& lsid) {
+/**
+ * Walks the oplog chain of the session's last write, which ends at 'lastWriteOpTime', and records
+ * the statements it finds in 'result'.
+ */
+void fetchCommittedStatements(OperationContext* opCtx,
+                              const LogicalSessionId& lsid,
+                              TxnNumber txnNumber,
+                              const repl::OpTime& lastWriteOpTime,
+                              ActiveTransactionHistory* result) {
+    auto it = TransactionHistoryIterator(lastWriteOpTime);
+    while (it.hasNext()) {
+        try {
+            const auto entry = it.next(opCtx);
+            invariant(entry.getStatementId());
+
+            if (*entry.getStatementId() == kIncompleteHistoryStmtId) {
+                // Only the dead end sentinel can have this id for oplog write history
+                invariant(entry.getObject2());
+                invariant(entry.getObject2()->woCompare(TransactionParticipant::kDeadEndSentinel) ==
+                          0);
+                result->hasIncompleteHistory = true;
+                continue;
+            }
+
+            const auto insertRes =
+                result->committedStatements.emplace(*entry.getStatementId(), entry.getOpTime());
+            if (!insertRes.second) {
+                const auto& existingOpTime = insertRes.first->second;
+                fassertOnRepeatedExecution(
+                    lsid, txnNumber, *entry.getStatementId(), existingOpTime, entry.getOpTime());
+            }
+
+            // State is a new field in FCV 4.2, so look for an applyOps oplog entry without a
+            // prepare flag to mark a committed transaction in FCV 4.0 or downgrading to 4.0. Check
+            // when upgrading as well so sessions refreshed at the beginning of upgrade enter the
+            // correct state.
+            if ((serverGlobalParams.featureCompatibility.getVersion() <=
+                 ServerGlobalParams::FeatureCompatibility::Version::kUpgradingTo42) &&
+                (entry.getCommandType() == repl::OplogEntry::CommandType::kApplyOps &&
+                 !entry.shouldPrepare())) {
+                result->state = result->TxnRecordState::kCommitted;
+            }
+        } catch (const DBException& ex) {
+            if (ex.code() == ErrorCodes::IncompleteTransactionHistory) {
+                result->hasIncompleteHistory = true;
+                break;
+            }
+
+            throw;
+        }
+    }
+}
+
+/**
+ * Reads the session's config.transactions record, unless 'cachedTxnRecord' is provided, and
+ * derives the state of its last transaction. Unless 'fetchStatements' is false, also walks the
+ * oplog chain of the session's last write to find which statements have been executed.
+ */
+ActiveTransactionHistory fetchActiveTransactionHistory(
+    OperationContext* opCtx,
+    const LogicalSessionId& lsid,
+    boost::optional<SessionTxnRecord> cachedTxnRecord,
+    bool fetchStatements) {
     // Restore the current timestamp read source after fetching transaction history.
     ReadSourceScope readSourceScope(opCtx);
 
     ActiveTransactionHistory result;
 
     result.lastTxnRecord = [&]() -> boost::optional<SessionTxnRecord> {
+        if (cachedTxnRecord) {
+            return std::move(cachedTxnRecord);
+        }
+
         DBDirectClient client(opCtx);
         auto result =
             client.findOne(NamespaceString::kSessionTransactionsTableNamespace.ns(),
@@ -154,50 +220,12 @@ ActiveTransactionHistory fetchActiveTransactionHistory(OperationContext* opCtx,
         invariant(result.lastTxnRecord->getState() != DurableTxnStateEnum::kPrepared);
     }
 
-    auto it = TransactionHistoryIterator(result.lastTxnRecord->getLastWriteOpTime());
-    while (it.hasNext()) {
-        try {
-            const auto entry = it.next(opCtx);
-            invariant(entry.getStatementId());
-
-            if (*entry.getStatementId() == kIncompleteHistoryStmtId) {
-                // Only the dead end sentinel can have this id for oplog write history
-                invariant(entry.getObject2());
-                invariant(entry.getObject2()->woCompare(TransactionParticipant::kDeadEndSentinel) ==
-                          0);
-                result.hasIncompleteHistory = true;
-                continue;
-            }
-
-            const auto insertRes =
-                result.committedStatements.emplace(*entry.getStatementId(), entry.getOpTime());
-            if (!insertRes.second) {
-                const auto& existingOpTime = insertRes.first->second;
-                fassertOnRepeatedExecution(lsid,
-                                           result.lastTxnRecord->getTxnNum(),
-                                           *entry.getStatementId(),
-                                           existingOpTime,
-                                           entry.getOpTime());
-            }
-
-            // State is a new field in FCV 4.2, so look for an applyOps oplog entry without a
-            // prepare flag to mark a committed transaction in FCV 4.0 or downgrading to 4.0. Check
-            // when upgrading as well so sessions refreshed at the beginning of upgrade enter the
-            // correct state.
-            if ((serverGlobalParams.featureCompatibility.getVersion() <=
-                 ServerGlobalParams::FeatureCompatibility::Version::kUpgradingTo42) &&
-                (entry.getCommandType() == repl::OplogEntry::CommandType::kApplyOps &&
-                 !entry.shouldPrepare())) {
-                result.state = result.TxnRecordState::kCommitted;
-            }
-        } catch (const DBException& ex) {
-            if (ex.code() == ErrorCodes::IncompleteTransactionHistory) {
-                result.hasIncompleteHistory = true;
-                break;
-            }
-
-            throw;
-        }
+    if (fetchStatements) {
+        fetchCommittedStatements(opCtx,
+                                 lsid,
+                                 result.lastTxnRecord->getTxnNum(),
+                                 result.lastTxnRecord->getLastWriteOpTime(),
+                                 &result);
     }
 
     return result;
@@ -479,6 +507,12 @@ void TransactionParticipant::Participant::beginOrContinue(OperationContext* opCt
                                                           TxnNumber txnNumber,
                                                           boost::optional<bool> autocommit,
                                                           boost::optional<bool> startTransaction) {
+    // A retried write needs to know which statements have already executed. Walk the oplog chain
+    // for them before acquiring the RSTL, since it reads from storage.
+    if (!autocommit && txnNumber == o().activeTxnNumber) {
+        _fetchCommittedStatementsIfNeeded(opCtx);
+    }
+
     // Make sure we are still a primary. We need to hold on to the RSTL through the end of this
     // method, as we otherwise risk stepping down in the interim and incorrectly updating the
     // transaction number, which can abort active transactions.
@@ -1113,6 +1147,14 @@ void TransactionParticipant::Participant::addTransactionOperation(
                           << p().transactionOperationBytes,
             (gUseMultipleOplogEntryFormatForTransactions && isFCV42) ||
                 p().transactionOperationBytes <= BSONObjMaxInternalSize);
+
+    const auto sizeLimit = gTransactionSizeLimitBytes.load();
+    uassert(ErrorCodes::TransactionTooLarge,
+            str::stream() << "Total size of all transaction operations must be less than "
+                          << "server parameter 'transactionSizeLimitBytes' = " << sizeLimit
+                          << ". Actual size is " << p().transactionOperationBytes,
+            sizeLimit == 0 ||
+                p().transactionOperationBytes <= static_cast<size_t>(sizeLimit));
 }
 
 std::vector<repl::ReplOperation>&
@@ -1151,7 +1193,7 @@ void TransactionParticipant::Participant::commitUnpreparedTransaction(OperationC
             "commitTransaction must provide commitTimestamp to prepared transaction.",
             !o().txnState.isPrepared());
 
-    auto txnOps = retrieveCompletedTransactionOperations(opCtx);
+    auto& txnOps = retrieveCompletedTransactionOperations(opCtx);
     auto opObserver = opCtx->getServiceContext()->getOpObserver();
     invariant(opObserver);
     opObserver->onUnpreparedTransactionCommit(opCtx, txnOps);
@@ -1828,7 +1870,25 @@ void TransactionParticipant::Participant::refreshFromStorageIfNeeded(OperationCo
     if (p().isValid)
         return;
 
-    auto activeTxnHistory = fetchActiveTransactionHistory(opCtx, _sessionId());
+    // The state of the last transaction can only be derived from the record alone, without walking
+    // the oplog chain, once the record's state field is authoritative.
+    const bool recordStateIsAuthoritative =
+        serverGlobalParams.featureCompatibility.getVersion() ==
+        ServerGlobalParams::FeatureCompatibility::Version::kFullyUpgradedTo42;
+
+    boost::optional<SessionTxnRecord> cachedTxnRecord;
+    if (recordStateIsAuthoritative) {
+        cachedTxnRecord = SessionTxnRecordCache::get(opCtx)->take(opCtx, _sessionId());
+        if (cachedTxnRecord) {
+            RetryableWritesStats::get(opCtx)->incrementTransactionsCollectionCacheHitCount();
+        }
+    }
+
+    const bool deferStatements = recordStateIsAuthoritative &&
+        (cachedTxnRecord || gDeferRetryableWriteHistoryLoad.load());
+
+    auto activeTxnHistory = fetchActiveTransactionHistory(
+        opCtx, _sessionId(), std::move(cachedTxnRecord), !deferStatements);
     const auto& lastTxnRecord = activeTxnHistory.lastTxnRecord;
     if (lastTxnRecord) {
         stdx::lock_guard<Client> lg(*opCtx->getClient());
@@ -1858,9 +1918,30 @@ void TransactionParticipant::Participant::refreshFromStorageIfNeeded(OperationCo
         }
     }
 
+    p().hasFetchedCommittedStatements = !deferStatements || !lastTxnRecord;
     p().isValid = true;
 }
 
+void TransactionParticipant::Participant::_fetchCommittedStatementsIfNeeded(
+    OperationContext* opCtx) {
+    if (p().hasFetchedCommittedStatements)
+        return;
+
+    ActiveTransactionHistory activeTxnHistory;
+    {
+        // Restore the current timestamp read source after fetching transaction history.
+        ReadSourceScope readSourceScope(opCtx);
+        fetchCommittedStatements(
+            opCtx, _sessionId(), o().activeTxnNumber, o().lastWriteOpTime, &activeTxnHistory);
+    }
+
+    RetryableWritesStats::get(opCtx)->incrementDeferredWriteHistoryFetchCount();
+
+    p().activeTxnCommittedStatements = std::move(activeTxnHistory.committedStatements);
+    p().hasIncompleteHistory = activeTxnHistory.hasIncompleteHistory;
+    p().hasFetchedCommittedStatements = true;
+}
+
 void TransactionParticipant::Participant::onWriteOpCompletedOnPrimary(
     OperationContext* opCtx,
     TxnNumber txnNumber,
@@ -1886,6 +1967,7 @@ void TransactionParticipant::Participant::onWriteOpCompletedOnPrimary(
 
     repl::UnreplicatedWritesBlock doNotReplicateWrites(opCtx);
 
+    SessionTxnRecordCache::get(opCtx)->invalidate(_sessionId());
     updateSessionEntry(opCtx, updateRequest);
     _registerUpdateCacheOnCommit(opCtx, std::move(stmtIdsWritten), lastStmtIdWriteOpTime);
 }
@@ -1906,6 +1988,7 @@ void TransactionParticipant::Participant::onMigrateCompletedOnPrimary(
 
     repl::UnreplicatedWritesBlock doNotReplicateWrites(opCtx);
 
+    SessionTxnRecordCache::get(opCtx)->invalidate(_sessionId());
     updateSessionEntry(opCtx, updateRequest);
     _registerUpdateCacheOnCommit(opCtx, std::move(stmtIdsWritten), lastStmtIdWriteOpTime);
 }
@@ -1922,6 +2005,7 @@ void TransactionParticipant::Participant::_invalidate(WithLock wl) {
 void TransactionParticipant::Participant::_resetRetryableWriteState() {
     p().activeTxnCommittedStatements.clear();
     p().hasIncompleteHistory = false;
+    p().hasFetchedCommittedStatements = true;
 }
 
 void TransactionParticipant::Participant::_resetTransactionState(
@@ -2007,6 +2091,7 @@ bool TransactionParticipant::Participant::checkStatementExecutedNoOplogEntryFetc
 boost::optional<repl::OpTime> TransactionParticipant::Participant::_checkStatementExecuted(
     StmtId stmtId) const {
     invariant(p().isValid);
+    invariant(p().hasFetchedCommittedStatements);
 
     const auto it = p().activeTxnCommittedStatements.find(stmtId);
     if (it == p().activeTxnCommittedStatements.end()) {
@@ -663,6 +663,10 @@ public:
     private:
         boost::optional<repl::OpTime> _checkStatementExecuted(StmtId stmtId) const;
 
+        // Walks the oplog chain of the active retryable write to find which of its statements have
+        // executed, if that was deferred when the session was refreshed from storage.
+        void _fetchCommittedStatementsIfNeeded(OperationContext* opCtx);
+
         UpdateRequest _makeUpdateRequest(const repl::OpTime& newLastWriteOpTime,
                                          Date_t newLastWriteDate,
                                          boost::optional<DurableTxnStateEnum> newState,
@@ -921,6 +925,10 @@ private:
         // truncated because it was too old.
         bool hasIncompleteHistory{false};
 
+        // Set to false if the session was refreshed from storage without walking the oplog chain of
+        // the active txn, in which case activeTxnCommittedStatements is not yet populated.
+        bool hasFetchedCommittedStatements{true};
+
         // For the active txn, tracks which statement ids have been committed and at which oplog
         // opTime. Used for fast retryability check and retrieving the previous write's data without
         // having to scan through the oplog.
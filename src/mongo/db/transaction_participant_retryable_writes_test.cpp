@@ -44,11 +44,14 @@
 #include "mongo/db/service_context.h"
 #include "mongo/db/session_catalog_mongod.h"
 #include "mongo/db/transaction_participant.h"
+#include "mongo/db/transaction_participant_gen.h"
 #include "mongo/stdx/future.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/death_test.h"
+#include "mongo/unittest/ensure_fcv.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/net/socket_utils.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -433,6 +436,36 @@ TEST_F(TransactionParticipantRetryableWritesTest, CheckStatementExecuted) {
     ASSERT(txnParticipant.checkStatementExecutedNoOplogEntryFetch(2000));
 }
 
+TEST_F(TransactionParticipantRetryableWritesTest, CheckStatementExecutedWithDeferredHistoryFetch) {
+    unittest::EnsureFCV guard(unittest::EnsureFCV::Version::kFullyUpgradedTo42);
+    gDeferRetryableWriteHistoryLoad.store(true);
+    ON_BLOCK_EXIT([] { gDeferRetryableWriteHistoryLoad.store(false); });
+
+    auto txnParticipant = TransactionParticipant::get(opCtx());
+    txnParticipant.refreshFromStorageIfNeeded(opCtx());
+
+    const TxnNumber txnNum = 100;
+    const auto firstOpTime = writeTxnRecord(txnNum, 1000, {}, boost::none);
+    writeTxnRecord(txnNum, 2000, firstOpTime, boost::none);
+
+    // Refreshing only reads the transaction record, and retrying at the active transaction number
+    // fetches the statements which have executed.
+    txnParticipant.invalidate(opCtx());
+    txnParticipant.refreshFromStorageIfNeeded(opCtx());
+    ASSERT_EQ(txnNum, txnParticipant.getActiveTxnNumber());
+
+    txnParticipant.beginOrContinue(opCtx(), txnNum, boost::none, boost::none);
+    ASSERT(txnParticipant.checkStatementExecuted(opCtx(), 1000));
+    ASSERT(txnParticipant.checkStatementExecutedNoOplogEntryFetch(2000));
+    ASSERT(!txnParticipant.checkStatementExecutedNoOplogEntryFetch(3000));
+
+    // A newer retryable write never needs the history of the previous one.
+    txnParticipant.invalidate(opCtx());
+    txnParticipant.refreshFromStorageIfNeeded(opCtx());
+    txnParticipant.beginOrContinue(opCtx(), txnNum + 1, boost::none, boost::none);
+    ASSERT(!txnParticipant.checkStatementExecutedNoOplogEntryFetch(1000));
+}
+
 DEATH_TEST_F(TransactionParticipantRetryableWritesTest,
              CheckStatementExecutedForInvalidatedTransactionInvariants,
              "Invariant failure p().isValid") {
@@ -55,6 +55,7 @@
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
 #include "mongo/util/net/socket_utils.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/tick_source_mock.h"
 
 namespace mongo {
@@ -1092,6 +1093,30 @@ TEST_F(TxnParticipantTest, TransactionTooLargeWhileBuilding) {
                        ErrorCodes::TransactionTooLarge);
 }
 
+// Tests that 'transactionSizeLimitBytes' caps the operations buffered by a transaction.
+TEST_F(TxnParticipantTest, TransactionTooLargeForSizeLimitParameter) {
+    const auto originalLimit = gTransactionSizeLimitBytes.load();
+    gTransactionSizeLimitBytes.store(1024 * 1024);
+    ON_BLOCK_EXIT([&] { gTransactionSizeLimitBytes.store(originalLimit); });
+
+    auto sessionCheckout = checkOutSession();
+    auto txnParticipant = TransactionParticipant::get(opCtx());
+
+    txnParticipant.unstashTransactionResources(opCtx(), "insert");
+
+    // A 600KB operation fits within the 1MB limit; a second one does not.
+    constexpr size_t kDataSize = 600 * 1024;
+    std::unique_ptr<uint8_t[]> data(new uint8_t[kDataSize]());
+    auto operation = repl::OplogEntry::makeInsertOperation(
+        kNss,
+        _uuid,
+        BSON("_id" << 0 << "data" << BSONBinData(data.get(), kDataSize, BinDataGeneral)));
+    txnParticipant.addTransactionOperation(opCtx(), operation);
+    ASSERT_THROWS_CODE(txnParticipant.addTransactionOperation(opCtx(), operation),
+                       AssertionException,
+                       ErrorCodes::TransactionTooLarge);
+}
+
 TEST_F(TxnParticipantTest, StashInNestedSessionIsANoop) {
     auto outerScopedSession = checkOutSession();
     Locker* originalLocker = opCtx()->lockState();
@@ -46,7 +46,9 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/delete.h"
+#include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/logical_session_id.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/ops/insert.h"
 #include "mongo/db/query/internal_plans.h"
@@ -57,6 +59,8 @@
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -85,7 +89,7 @@ public:
         while (!globalInShutdownDeprecated()) {
             {
                 MONGO_IDLE_THREAD_BLOCK;
-                sleepsecs(ttlMonitorSleepSecs.load());
+                sleepsecs(_nextSleepSecs());
             }
 
             LOG(3) << "thread awake";
@@ -103,7 +107,8 @@ public:
             }
 
             try {
-                doTTLPass();
+                const bool backlog = doTTLPass();
+                _consecutiveBacklogPasses = backlog ? _consecutiveBacklogPasses + 1 : 0;
             } catch (const WriteConflictException&) {
                 LOG(1) << "got WriteConflictException";
             }
@@ -111,7 +116,25 @@ public:
     }
 
 private:
-    void doTTLPass() {
+    /**
+     * Returns the number of seconds to sleep before the next pass. While batched deletes leave
+     * expired documents behind, the period is halved after every such pass, down to one second,
+     * so that a backlog is worked off without waiting out the full 'ttlMonitorSleepSecs'.
+     */
+    int _nextSleepSecs() const {
+        const int sleepSecs = ttlMonitorSleepSecs.load();
+        if (_consecutiveBacklogPasses == 0) {
+            return sleepSecs;
+        }
+        const int shift = std::min(_consecutiveBacklogPasses, 30);
+        return std::max(1, sleepSecs >> shift);
+    }
+
+    /**
+     * Runs the TTL job for every TTL index. Returns true if any index still has expired documents
+     * left to delete at the end of the pass.
+     */
+    bool doTTLPass() {
         const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
         OperationContext& opCtx = *opCtxPtr;
 
@@ -119,7 +142,7 @@ private:
         if (repl::ReplicationCoordinator::get(&opCtx)->getReplicationMode() ==
                 repl::ReplicationCoordinator::modeReplSet &&
             !repl::ReplicationCoordinator::get(&opCtx)->getMemberState().readable())
-            return;
+            return false;
 
         TTLCollectionCache& ttlCollectionCache = TTLCollectionCache::get(getGlobalServiceContext());
         std::vector<std::string> ttlCollections = ttlCollectionCache.getCollections();
@@ -149,57 +172,61 @@ private:
             }
         }
 
+        bool backlog = false;
         for (const BSONObj& idx : ttlIndexes) {
             try {
-                doTTLForIndex(&opCtx, idx);
+                backlog |= doTTLForIndex(&opCtx, idx);
             } catch (const DBException& dbex) {
                 error() << "Error processing ttl index: " << idx << " -- " << dbex.toString();
                 // Continue on to the next index.
                 continue;
             }
         }
+        return backlog;
     }
 
     /**
      * Remove documents from the collection using the specified TTL index after a sufficient amount
-     * of time has passed according to its expiry specification.
+     * of time has passed according to its expiry specification. Returns true if expired documents
+     * were left behind for a later pass.
      */
-    void doTTLForIndex(OperationContext* opCtx, BSONObj idx) {
+    bool doTTLForIndex(OperationContext* opCtx, BSONObj idx) {
         const NamespaceString collectionNSS(idx["ns"].String());
         if (collectionNSS.isDropPendingNamespace()) {
-            return;
+            return false;
         }
         if (!userAllowedWriteNS(collectionNSS).isOK()) {
             error() << "namespace '" << collectionNSS
                     << "' doesn't allow deletes, skipping ttl job for: " << idx;
-            return;
+            return false;
         }
 
         const BSONObj key = idx["key"].Obj();
-        const StringData name = idx["name"].valueStringData();
+        const std::string name = idx["name"].str();
         if (key.nFields() != 1) {
             error() << "key for ttl index can only have 1 field, skipping ttl job for: " << idx;
-            return;
+            return false;
         }
 
         LOG(1) << "ns: " << collectionNSS << " key: " << key << " name: " << name;
 
-        AutoGetCollection autoGetCollection(opCtx, collectionNSS, MODE_IX);
-        Collection* collection = autoGetCollection.getCollection();
+        boost::optional<AutoGetCollection> autoGetCollection;
+        autoGetCollection.emplace(opCtx, collectionNSS, MODE_IX);
+        Collection* collection = autoGetCollection->getCollection();
         if (!collection) {
             // Collection was dropped.
-            return;
+            return false;
         }
 
         if (!repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesFor(opCtx, collectionNSS)) {
-            return;
+            return false;
         }
 
         const IndexDescriptor* desc = collection->getIndexCatalog()->findIndexByName(opCtx, name);
         if (!desc) {
             LOG(1) << "index not found (index build in progress? index dropped?), skipping "
                    << "ttl job for: " << idx;
-            return;
+            return false;
         }
 
         // Re-read 'idx' from the descriptor, in case the collection or index definition changed
@@ -208,7 +235,7 @@ private:
 
         if (IndexType::INDEX_BTREE != IndexNames::nameToType(desc->getAccessMethodName())) {
             error() << "special index can't be used as a ttl index, skipping ttl job for: " << idx;
-            return;
+            return false;
         }
 
         BSONElement secondsExpireElt = idx[secondsExpireField];
@@ -216,7 +243,7 @@ private:
             error() << "ttl indexes require the " << secondsExpireField << " field to be "
                     << "numeric but received a type of " << typeName(secondsExpireElt.type())
                     << ", skipping ttl job for: " << idx;
-            return;
+            return false;
         }
 
         const Date_t kDawnOfTime =
@@ -241,6 +268,19 @@ private:
         auto canonicalQuery = CanonicalQuery::canonicalize(opCtx, std::move(qr));
         invariant(canonicalQuery.getStatus());
 
+        if (ttlMonitorBatchedDeletes.load()) {
+            // Batched deletes take the collection lock once per batch so that the rate limit can
+            // be enforced without holding it.
+            autoGetCollection.reset();
+            return deleteExpiredInBatches(opCtx,
+                                          collectionNSS,
+                                          name,
+                                          startKey,
+                                          endKey,
+                                          direction,
+                                          canonicalQuery.getValue()->root());
+        }
+
         auto params = std::make_unique<DeleteStageParams>();
         params->isMulti = true;
         params->canonicalQuery = canonicalQuery.getValue().get();
@@ -260,13 +300,125 @@ private:
         if (!result.isOK()) {
             error() << "ttl query execution for index " << idx
                     << " failed with status: " << redact(result);
-            return;
+            return false;
         }
 
         const long long numDeleted = DeleteStage::getNumDeleted(*exec);
         ttlDeletedDocuments.increment(numDeleted);
         LOG(1) << "deleted: " << numDeleted;
+        return false;
     }
+
+    /**
+     * Deletes the documents whose keys in index 'indexName' fall within ['startKey', 'endKey'].
+     * Each batch scans the index for up to 'ttlMonitorBatchedDeletesBatchSize' RecordIds and
+     * deletes the documents that still match 'filter' in a single WriteUnitOfWork. Batches are
+     * paced to 'ttlMonitorMaxDeletesPerSecond', and at most
+     * 'ttlMonitorBatchedDeletesPerIndexPerPass' documents are deleted. Returns true if that limit
+     * was reached.
+     */
+    bool deleteExpiredInBatches(OperationContext* opCtx,
+                                const NamespaceString& collectionNSS,
+                                const std::string& indexName,
+                                const BSONObj& startKey,
+                                const BSONObj& endKey,
+                                InternalPlanner::Direction direction,
+                                const MatchExpression* filter) {
+        const long long maxDeletes = ttlMonitorBatchedDeletesPerIndexPerPass.load();
+        long long numDeleted = 0;
+        Timer timer;
+
+        ON_BLOCK_EXIT([&] {
+            ttlDeletedDocuments.increment(numDeleted);
+            LOG(1) << "deleted: " << numDeleted;
+        });
+
+        while (numDeleted < maxDeletes) {
+            const long long batchSize = std::min<long long>(
+                ttlMonitorBatchedDeletesBatchSize.load(), maxDeletes - numDeleted);
+            long long batchDeleted = 0;
+            bool exhausted = false;
+
+            {
+                AutoGetCollection autoGetCollection(opCtx, collectionNSS, MODE_IX);
+                Collection* collection = autoGetCollection.getCollection();
+                if (!collection ||
+                    !repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesFor(opCtx,
+                                                                                  collectionNSS)) {
+                    return false;
+                }
+                const IndexDescriptor* desc =
+                    collection->getIndexCatalog()->findIndexByName(opCtx, indexName);
+                if (!desc) {
+                    return false;
+                }
+
+                writeConflictRetry(opCtx, "ttl batched delete", collectionNSS.ns(), [&] {
+                    batchDeleted = 0;
+
+                    // The scan and the deletes share a snapshot, so the RecordIds collected here
+                    // are still valid inside the WriteUnitOfWork below.
+                    std::vector<RecordId> rids;
+                    auto exec =
+                        InternalPlanner::indexScan(opCtx,
+                                                   collection,
+                                                   desc,
+                                                   startKey,
+                                                   endKey,
+                                                   BoundInclusion::kIncludeBothStartAndEndKeys,
+                                                   PlanExecutor::NO_YIELD,
+                                                   direction);
+                    BSONObj obj;
+                    RecordId rid;
+                    PlanExecutor::ExecState state = PlanExecutor::ADVANCED;
+                    while (static_cast<long long>(rids.size()) < batchSize &&
+                           PlanExecutor::ADVANCED == (state = exec->getNext(&obj, &rid))) {
+                        rids.push_back(rid);
+                    }
+                    if (PlanExecutor::FAILURE == state || PlanExecutor::DEAD == state) {
+                        uassertStatusOK(WorkingSetCommon::getMemberObjectStatus(obj).withContext(
+                            "ttl index scan failed"));
+                    }
+                    exhausted = (PlanExecutor::IS_EOF == state);
+                    exec.reset();
+
+                    WriteUnitOfWork wuow(opCtx);
+                    for (const auto& id : rids) {
+                        Snapshotted<BSONObj> doc;
+                        if (!collection->findDoc(opCtx, id, &doc) ||
+                            !filter->matchesBSON(doc.value())) {
+                            continue;
+                        }
+                        collection->deleteDocument(opCtx, kUninitializedStmtId, id, nullptr);
+                        ++batchDeleted;
+                    }
+                    wuow.commit();
+                });
+            }
+
+            numDeleted += batchDeleted;
+            if (exhausted || batchDeleted == 0) {
+                // Either every expired document is gone, or the remaining index entries refer to
+                // documents that no longer match; rescanning would make no progress.
+                return false;
+            }
+
+            opCtx->checkForInterrupt();
+
+            const long long maxDeletesPerSecond = ttlMonitorMaxDeletesPerSecond.load();
+            if (maxDeletesPerSecond > 0) {
+                const long long targetMillis = numDeleted * 1000 / maxDeletesPerSecond;
+                const long long aheadMillis = targetMillis - timer.millis();
+                if (aheadMillis > 0) {
+                    MONGO_IDLE_THREAD_BLOCK;
+                    sleepmillis(aheadMillis);
+                }
+            }
+        }
+        return true;
+    }
+
+    int _consecutiveBacklogPasses = 0;
 };
 
 namespace {
@@ -29,6 +29,8 @@
 
 #include "mongo/db/update/update_driver.h"
 
+#include <algorithm>
+#include <cstring>
 
 #include "mongo/base/error_codes.h"
 #include "mongo/base/string_data.h"
@@ -38,6 +40,7 @@
 #include "mongo/db/field_ref.h"
 #include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/update/log_builder.h"
 #include "mongo/db/update/modifier_table.h"
@@ -45,6 +48,7 @@
 #include "mongo/db/update/path_support.h"
 #include "mongo/db/update/storage_validation.h"
 #include "mongo/util/embedded_builder.h"
+#include "mongo/util/safe_num.h"
 #include "mongo/util/str.h"
 
 namespace mongo {
@@ -53,6 +57,22 @@ using pathsupport::EqualityMatches;
 
 namespace {
 
+bool isFixedWidthType(BSONType type) {
+    switch (type) {
+        case NumberInt:
+        case NumberLong:
+        case NumberDouble:
+        case NumberDecimal:
+        case Bool:
+        case Date:
+        case bsonTimestamp:
+        case jstOID:
+            return true;
+        default:
+            return false;
+    }
+}
+
 StatusWith<UpdateSemantics> updateSemanticsFromElement(BSONElement element) {
     if (element.type() != BSONType::NumberInt && element.type() != BSONType::NumberLong) {
         return {ErrorCodes::BadValue, "'$v' (UpdateSemantics) field must be an integer."};
@@ -193,6 +213,57 @@ void UpdateDriver::parse(
     auto root = stdx::make_unique<UpdateObjectNode>();
     _positional = parseUpdateExpression(updateExpr, root.get(), _expCtx, arrayFilters);
     _updateExecutor = std::move(root);
+
+    if (internalUpdateInPlaceFastPath.load() && arrayFilters.empty()) {
+        _parseInPlaceModifiers(updateExpr);
+    }
+}
+
+void UpdateDriver::_parseInPlaceModifiers(const BSONObj& updateExpr) {
+    _inPlaceUpdateExpr = updateExpr.getOwned();
+
+    std::vector<InPlaceModifier> modifiers;
+    for (auto&& modExpr : _inPlaceUpdateExpr) {
+        const auto modName = modExpr.fieldNameStringData();
+        if (modName == LogBuilder::kUpdateSemanticsFieldName) {
+            continue;
+        }
+
+        InPlaceModifier::Type type;
+        if (modName == "$set"_sd) {
+            type = InPlaceModifier::Type::kSet;
+        } else if (modName == "$inc"_sd) {
+            type = InPlaceModifier::Type::kInc;
+        } else {
+            return;
+        }
+
+        for (auto&& elem : modExpr.embeddedObject()) {
+            const auto fieldName = elem.fieldNameStringData();
+            if (fieldName.find('.') != std::string::npos || fieldName.startsWith("$") ||
+                fieldName == "_id"_sd) {
+                return;
+            }
+
+            // Only values whose size is fixed by their type can overwrite an existing value of
+            // the same type without moving the bytes that follow it.
+            const bool eligibleValue = type == InPlaceModifier::Type::kSet
+                ? isFixedWidthType(elem.type())
+                : elem.type() == NumberInt || elem.type() == NumberLong ||
+                    elem.type() == NumberDouble;
+            if (!eligibleValue) {
+                return;
+            }
+
+            modifiers.push_back({type, FieldRef(fieldName), elem});
+        }
+    }
+
+    // Log the modifications in the order the UpdateObjectNode applies them.
+    std::sort(modifiers.begin(), modifiers.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.path.dottedField() < rhs.path.dottedField();
+    });
+    _inPlaceModifiers = std::move(modifiers);
 }
 
 Status UpdateDriver::populateDocumentWithQueryFields(OperationContext* opCtx,
@@ -304,6 +375,91 @@ Status UpdateDriver::update(StringData matchedField,
     return Status::OK();
 }
 
+bool UpdateDriver::updateInPlace(const BSONObj& oldObj,
+                                 const FieldRefSet& immutablePaths,
+                                 BufBuilder* damageSource,
+                                 mutablebson::DamageVector* damages,
+                                 BSONObj* logOpRec,
+                                 bool* docWasModified) {
+    if (_inPlaceModifiers.empty()) {
+        return false;
+    }
+
+    // update() moves an _id which is not the first field to the front, which changes the layout.
+    if (oldObj.firstElementFieldNameStringData() != "_id"_sd) {
+        return false;
+    }
+
+    // Compute every new value before touching the outputs, so that any modifier which cannot be
+    // applied in place leaves them unchanged.
+    std::vector<std::pair<BSONElement, BSONElement>> changes;
+    std::vector<BSONObj> computedValues;
+    for (const auto& modifier : _inPlaceModifiers) {
+        if (immutablePaths.findConflicts(&modifier.path, nullptr) ||
+            (_indexedFields && _indexedFields->mightBeIndexed(modifier.path))) {
+            return false;
+        }
+
+        const BSONElement existing = oldObj[modifier.path.dottedField()];
+        if (!existing) {
+            return false;
+        }
+
+        BSONElement newValue = modifier.value;
+        if (modifier.type == InPlaceModifier::Type::kInc) {
+            // $inc can change the type, for example when an int overflows into a long.
+            const SafeNum result = SafeNum(existing) + SafeNum(modifier.value);
+            if (!result.isValid() || result.type() != existing.type()) {
+                return false;
+            }
+
+            BSONObjBuilder resultBuilder;
+            result.toBSON(existing.fieldNameStringData(), &resultBuilder);
+            computedValues.push_back(resultBuilder.obj());
+            newValue = computedValues.back().firstElement();
+        }
+
+        if (newValue.type() != existing.type() || newValue.valuesize() != existing.valuesize()) {
+            return false;
+        }
+
+        if (memcmp(newValue.value(), existing.value(), existing.valuesize()) != 0) {
+            changes.emplace_back(existing, newValue);
+        }
+    }
+
+    _affectIndices = false;
+    damages->clear();
+    BSONObjBuilder setBuilder;
+    for (const auto& change : changes) {
+        const auto& existing = change.first;
+        const auto& newValue = change.second;
+        mutablebson::DamageEvent damage;
+        damage.sourceOffset = damageSource->len();
+        damage.targetOffset = existing.value() - oldObj.objdata();
+        damage.size = existing.valuesize();
+        damages->push_back(damage);
+        damageSource->appendBuf(newValue.value(), existing.valuesize());
+        setBuilder.appendAs(newValue, existing.fieldNameStringData());
+    }
+
+    if (docWasModified) {
+        *docWasModified = !changes.empty();
+    }
+
+    if (_logOp && logOpRec) {
+        BSONObjBuilder logBuilder;
+        logBuilder.append(LogBuilder::kUpdateSemanticsFieldName,
+                          static_cast<int>(UpdateSemantics::kUpdateNode));
+        if (!changes.empty()) {
+            logBuilder.append("$set", setBuilder.obj());
+        }
+        *logOpRec = logBuilder.obj();
+    }
+
+    return true;
+}
+
 void UpdateDriver::setCollator(const CollatorInterface* collator) {
     if (_updateExecutor) {
         _updateExecutor->setCollator(collator);
@@ -34,7 +34,9 @@
 
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/base/status.h"
+#include "mongo/bson/mutable/damage_vector.h"
 #include "mongo/bson/mutable/document.h"
+#include "mongo/db/field_ref.h"
 #include "mongo/db/field_ref_set.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/ops/write_ops_parsers.h"
@@ -122,6 +124,24 @@ public:
                   bool* docWasModified = nullptr,
                   FieldRefSetWithStorage* modifiedPaths = nullptr);
 
+    /**
+     * Attempts to apply the update by patching the bytes of 'oldObj' instead of going through a
+     * mutablebson::Document. This succeeds only for updates made entirely of $set of fixed-width
+     * values and $inc on top-level fields which already exist in 'oldObj', keep their BSON type,
+     * are not indexed and are not in 'immutablePaths', so that the document's layout does not
+     * change.
+     *
+     * On success, returns true, appends the new values to 'damageSource', fills 'damages' with
+     * the regions of 'oldObj' to overwrite and fills 'logOpRec' like update() does. Returns false,
+     * having changed nothing, when the update has to be applied with update() instead.
+     */
+    bool updateInPlace(const BSONObj& oldObj,
+                       const FieldRefSet& immutablePaths,
+                       BufBuilder* damageSource,
+                       mutablebson::DamageVector* damages,
+                       BSONObj* logOpRec,
+                       bool* docWasModified);
+
     /**
      * Passes the visitor through to the root of the update tree. The visitor is responsible for
      * implementing methods that operate on the nodes of the tree.
@@ -201,6 +221,22 @@ private:
     /** Create the modifier and add it to the back of the modifiers vector */
     inline Status addAndParse(const modifiertable::ModifierType type, const BSONElement& elem);
 
+    /**
+     * A top-level $set or $inc which updateInPlace() can apply.
+     */
+    struct InPlaceModifier {
+        enum class Type { kSet, kInc };
+
+        Type type;
+        FieldRef path;
+        BSONElement value;
+    };
+
+    /**
+     * Fills '_inPlaceModifiers' if every modifier in 'updateExpr' can be applied in place.
+     */
+    void _parseInPlaceModifiers(const BSONObj& updateExpr);
+
     //
     // immutable properties after parsing
     //
@@ -209,6 +245,11 @@ private:
 
     std::unique_ptr<UpdateExecutor> _updateExecutor;
 
+    // The modifiers of the update, ordered by field name, when updateInPlace() may apply them.
+    // Their values point into '_inPlaceUpdateExpr'.
+    std::vector<InPlaceModifier> _inPlaceModifiers;
+    BSONObj _inPlaceUpdateExpr;
+
     // What are the list of fields in the collection over which the update is going to be
     // applied that participate in indices?
     //
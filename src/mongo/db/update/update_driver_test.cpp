@@ -30,6 +30,8 @@
 #include "mongo/db/update/update_driver.h"
 
 
+#include <cstring>
+#include <limits>
 #include <map>
 
 #include "mongo/base/owned_pointer_vector.h"
@@ -42,6 +44,7 @@
 #include "mongo/db/field_ref.h"
 #include "mongo/db/json.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/query_knobs_gen.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
 #include "mongo/db/query/query_test_service_context.h"
 #include "mongo/db/update_index_data.h"
@@ -641,5 +644,138 @@ TEST_F(ModifiedPathsTestFixture, ArrayFilterThatMatchesNoElements) {
     ASSERT_EQ(getModifiedPaths(&doc, spec, ""_sd, {arrayFilter}), "{a}");
 }
 
+class UpdateInPlaceFixture : public mongo::unittest::Test {
+public:
+    void setUp() override {
+        internalUpdateInPlaceFastPath.store(true);
+        _immutablePaths.insert(&_idPath);
+    }
+
+    void tearDown() override {
+        internalUpdateInPlaceFastPath.store(false);
+    }
+
+    void parse(const BSONObj& updateSpec) {
+        boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+        _driver = stdx::make_unique<UpdateDriver>(expCtx);
+        _driver->setLogOp(true);
+        std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> arrayFilters;
+        _driver->parse(updateSpec, arrayFilters);
+    }
+
+    /**
+     * Applies the parsed update to 'oldObj' with updateInPlace(). On success, returns the
+     * updated document and fills 'logObj' and 'docWasModified'.
+     */
+    boost::optional<BSONObj> updateInPlace(const BSONObj& oldObj,
+                                           BSONObj* logObj = nullptr,
+                                           bool* docWasModified = nullptr) {
+        BufBuilder damageSource;
+        mutablebson::DamageVector damages;
+        BSONObj log;
+        bool modified = false;
+        if (!_driver->updateInPlace(
+                oldObj, _immutablePaths, &damageSource, &damages, &log, &modified)) {
+            return boost::none;
+        }
+
+        std::string newObj(oldObj.objdata(), oldObj.objsize());
+        for (const auto& damage : damages) {
+            std::memcpy(&newObj[damage.targetOffset],
+                        damageSource.buf() + damage.sourceOffset,
+                        damage.size);
+        }
+        if (logObj) {
+            *logObj = log;
+        }
+        if (docWasModified) {
+            *docWasModified = modified;
+        }
+        return BSONObj(newObj.data()).getOwned();
+    }
+
+    UpdateDriver* driver() {
+        return _driver.get();
+    }
+
+private:
+    std::unique_ptr<UpdateDriver> _driver;
+    FieldRef _idPath{"_id"};
+    FieldRefSet _immutablePaths;
+};
+
+TEST_F(UpdateInPlaceFixture, SetAndIncOverwriteValues) {
+    parse(fromjson("{$set: {b: true, a: 5}, $inc: {c: 2.5}}"));
+
+    BSONObj logObj;
+    bool docWasModified = false;
+    auto newObj =
+        updateInPlace(fromjson("{_id: 0, a: 1, b: false, c: 1.0}"), &logObj, &docWasModified);
+    ASSERT(newObj);
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 0, a: 5, b: true, c: 3.5}"), *newObj);
+    ASSERT_TRUE(docWasModified);
+    ASSERT_FALSE(driver()->modsAffectIndices());
+    ASSERT_BSONOBJ_EQ(fromjson("{$v: 1, $set: {a: 5, b: true, c: 3.5}}"), logObj);
+}
+
+TEST_F(UpdateInPlaceFixture, IdenticalValuesAreANoop) {
+    parse(fromjson("{$set: {a: 1}, $inc: {b: 0}}"));
+
+    BSONObj logObj;
+    bool docWasModified = true;
+    auto newObj = updateInPlace(fromjson("{_id: 0, a: 1, b: 2}"), &logObj, &docWasModified);
+    ASSERT(newObj);
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 0, a: 1, b: 2}"), *newObj);
+    ASSERT_FALSE(docWasModified);
+    ASSERT_BSONOBJ_EQ(fromjson("{$v: 1}"), logObj);
+}
+
+TEST_F(UpdateInPlaceFixture, FallsBackWhenTheLayoutWouldChange) {
+    parse(fromjson("{$set: {a: 1}}"));
+    ASSERT_FALSE(updateInPlace(fromjson("{_id: 0}")));
+    ASSERT_FALSE(updateInPlace(fromjson("{_id: 0, a: 1.5}")));
+    ASSERT_FALSE(updateInPlace(fromjson("{a: 0, _id: 0}")));
+
+    parse(fromjson("{$inc: {a: 1}}"));
+    ASSERT_FALSE(updateInPlace(BSON("_id" << 0 << "a" << std::numeric_limits<int>::max())));
+    ASSERT_FALSE(updateInPlace(fromjson("{_id: 0, a: 'str'}")));
+}
+
+TEST_F(UpdateInPlaceFixture, FallsBackForIndexedAndImmutableFields) {
+    parse(fromjson("{$set: {a: 1}}"));
+    UpdateIndexData indexedFields;
+    indexedFields.addPath(FieldRef("a"));
+    driver()->refreshIndexKeys(&indexedFields);
+    ASSERT_FALSE(updateInPlace(fromjson("{_id: 0, a: 0}")));
+
+    UpdateIndexData otherIndexedFields;
+    otherIndexedFields.addPath(FieldRef("b"));
+    driver()->refreshIndexKeys(&otherIndexedFields);
+    ASSERT(updateInPlace(fromjson("{_id: 0, a: 0}")));
+
+    parse(fromjson("{$set: {_id: 1}}"));
+    ASSERT_FALSE(updateInPlace(fromjson("{_id: 0}")));
+}
+
+TEST_F(UpdateInPlaceFixture, UnsupportedUpdatesAreNotEligible) {
+    parse(fromjson("{$set: {a: 'str'}}"));
+    ASSERT_FALSE(updateInPlace(fromjson("{_id: 0, a: 'abc'}")));
+
+    parse(fromjson("{$set: {'a.b': 1}}"));
+    ASSERT_FALSE(updateInPlace(fromjson("{_id: 0, a: {b: 0}}")));
+
+    parse(fromjson("{$set: {a: 1}, $unset: {b: 1}}"));
+    ASSERT_FALSE(updateInPlace(fromjson("{_id: 0, a: 0, b: 0}")));
+
+    parse(fromjson("{$mul: {a: 2}}"));
+    ASSERT_FALSE(updateInPlace(fromjson("{_id: 0, a: 1}")));
+}
+
+TEST_F(UpdateInPlaceFixture, DisabledByDefault) {
+    internalUpdateInPlaceFastPath.store(false);
+    parse(fromjson("{$set: {a: 1}}"));
+    ASSERT_FALSE(updateInPlace(fromjson("{_id: 0, a: 0}")));
+}
+
 }  // namespace
 }  // namespace mongo
@@ -94,6 +94,8 @@ Status ViewCatalog::_reloadIfNeeded(WithLock lk, OperationContext* opCtx) {
 
     // Need to reload, first clear our cache.
     _viewMap.clear();
+    _resolvedViewCache.clear();
+    _bumpViewMapVersion();
 
     Status status = _durable->iterate(opCtx, [&](const BSONObj& view) -> Status {
         BSONObj collationSpec = view.hasField("collation") ? view["collation"].Obj() : BSONObj();
@@ -175,9 +177,11 @@ Status ViewCatalog::_createOrUpdateView(WithLock lk,
 
     _durable->upsert(opCtx, viewName, viewDefBuilder.obj());
     _viewMap[viewName.ns()] = view;
+    _bumpViewMapVersion();
     opCtx->recoveryUnit()->onRollback([this, viewName]() {
         this->_viewMap.erase(viewName.ns());
         this->_viewGraphNeedsRefresh = true;
+        this->_bumpViewMapVersion();
     });
 
     // We may get invalidated, but we're exclusively locked, so the change must be ours.
@@ -390,6 +394,7 @@ Status ViewCatalog::modifyView(OperationContext* opCtx,
     ViewDefinition savedDefinition = *viewPtr;
     opCtx->recoveryUnit()->onRollback([this, viewName, savedDefinition]() {
         this->_viewMap[viewName.ns()] = std::make_shared<ViewDefinition>(savedDefinition);
+        this->_bumpViewMapVersion();
     });
 
     return _createOrUpdateView(lk,
@@ -422,9 +427,12 @@ Status ViewCatalog::dropView(OperationContext* opCtx, const NamespaceString& vie
     _durable->remove(opCtx, viewName);
     _viewGraph.remove(savedDefinition.name());
     _viewMap.erase(viewName.ns());
+    _resolvedViewCache.erase(viewName.ns());
+    _bumpViewMapVersion();
     opCtx->recoveryUnit()->onRollback([this, viewName, savedDefinition]() {
         this->_viewGraphNeedsRefresh = true;
         this->_viewMap[viewName.ns()] = std::make_shared<ViewDefinition>(savedDefinition);
+        this->_bumpViewMapVersion();
     });
 
     // We may get invalidated, but we're exclusively locked, so the change must be ours.
@@ -467,9 +475,28 @@ StatusWith<ResolvedView> ViewCatalog::resolveView(OperationContext* opCtx,
                                                   const NamespaceString& nss) {
     stdx::unique_lock<stdx::mutex> lock(_mutex);
 
+    // A view resolved earlier against the same catalog contents resolves the same way again.
+    if (_valid.load()) {
+        auto it = _resolvedViewCache.find(nss.ns());
+        if (it != _resolvedViewCache.end() &&
+            it->second.viewMapVersion == _viewMapVersion.load()) {
+            return *it->second.resolvedView;
+        }
+    }
+
+    // Caches the resolution of the view 'nss' before returning it.
+    auto cacheAndReturn = [&](unsigned long long viewMapVersion, ResolvedView resolvedView) {
+        auto& cached = _resolvedViewCache[nss.ns()];
+        cached.viewMapVersion = viewMapVersion;
+        cached.resolvedView = std::make_shared<const ResolvedView>(resolvedView);
+        return StatusWith<ResolvedView>(std::move(resolvedView));
+    };
+
     // Keep looping until the resolution completes. If the catalog is invalidated during the
     // resolution, we start over from the beginning.
     while (true) {
+        const auto viewMapVersion = _viewMapVersion.load();
+
         // Points to the name of the most resolved namespace.
         const NamespaceString* resolvedNss = &nss;
 
@@ -504,10 +531,16 @@ StatusWith<ResolvedView> ViewCatalog::resolveView(OperationContext* opCtx,
                             str::stream() << "View pipeline exceeds maximum size; maximum size is "
                                           << ViewGraph::kMaxViewPipelineSizeBytes};
                 }
-                return StatusWith<ResolvedView>(
-                    {*resolvedNss,
-                     std::move(resolvedPipeline),
-                     collation ? std::move(collation.get()) : CollationSpec::kSimpleSpec});
+                ResolvedView resolvedView{
+                    *resolvedNss,
+                    std::move(resolvedPipeline),
+                    collation ? std::move(collation.get()) : CollationSpec::kSimpleSpec};
+
+                // Only cache views, so that resolving collection namespaces cannot grow the cache.
+                if (depth == 0) {
+                    return StatusWith<ResolvedView>(std::move(resolvedView));
+                }
+                return cacheAndReturn(viewMapVersion, std::move(resolvedView));
             }
 
             resolvedNss = &view->viewOn();
@@ -522,8 +555,10 @@ StatusWith<ResolvedView> ViewCatalog::resolveView(OperationContext* opCtx,
 
             // If the first stage is a $collStats, then we return early with the viewOn namespace.
             if (toPrepend.size() > 0 && !toPrepend[0]["$collStats"].eoo()) {
-                return StatusWith<ResolvedView>(
-                    {*resolvedNss, std::move(resolvedPipeline), std::move(collation.get())});
+                return cacheAndReturn(viewMapVersion,
+                                      {*resolvedNss,
+                                       std::move(resolvedPipeline),
+                                       std::move(collation.get())});
             }
         }
 
@@ -121,7 +121,8 @@ public:
     /**
      * Resolve the views on 'nss', transforming the pipeline appropriately. This function returns a
      * fully-resolved view definition containing the backing namespace, the resolved pipeline and
-     * the collation to use for the operation.
+     * the collation to use for the operation. Resolutions of views are cached until the catalog
+     * next changes.
      */
     StatusWith<ResolvedView> resolveView(OperationContext* opCtx, const NamespaceString& nss);
 
@@ -173,6 +174,14 @@ private:
                               const std::vector<NamespaceString>& refs);
 
     std::shared_ptr<ViewDefinition> _lookup(WithLock, OperationContext* opCtx, StringData ns);
+
+    /**
+     * Marks every cached view resolution as stale. Must be called whenever '_viewMap' changes,
+     * including from rollback handlers.
+     */
+    void _bumpViewMapVersion() {
+        _viewMapVersion.fetchAndAdd(1);
+    }
     Status _reloadIfNeeded(WithLock, OperationContext* opCtx);
 
     void _requireValidCatalog(WithLock lk, OperationContext* opCtx) {
@@ -186,5 +195,15 @@ private:
     AtomicWord<bool> _valid;
     ViewGraph _viewGraph;
     bool _viewGraphNeedsRefresh = true;  // Defers initializing the graph until the first insert.
+
+    // Views resolved by resolveView(), keyed by view namespace and tagged with the
+    // '_viewMapVersion' they were resolved against, so that views which are queried over and over
+    // skip walking the view graph and re-assembling the pipeline.
+    struct CachedResolvedView {
+        unsigned long long viewMapVersion = 0;
+        std::shared_ptr<const ResolvedView> resolvedView;
+    };
+    StringMap<CachedResolvedView> _resolvedViewCache;
+    AtomicWord<unsigned long long> _viewMapVersion{0};
 };
 }  // namespace mongo
@@ -573,6 +573,44 @@ TEST_F(ViewCatalogFixture, ResolveViewCorrectlyExtractsDefaultCollation) {
                       expectedCollation.getValue()->getSpec().toBSON());
 }
 
+TEST_F(ViewCatalogFixture, ResolveViewReflectsChangesToTheViewGraph) {
+    const NamespaceString view1("db.view1");
+    const NamespaceString view2("db.view2");
+    const NamespaceString viewOn("db.coll");
+    const NamespaceString otherViewOn("db.otherColl");
+    BSONArrayBuilder pipeline1;
+    BSONArrayBuilder pipeline2;
+    BSONArrayBuilder modifiedPipeline1;
+
+    pipeline1 << BSON("$match" << BSON("foo" << 1));
+    pipeline2 << BSON("$match" << BSON("foo" << 2));
+    modifiedPipeline1 << BSON("$match" << BSON("foo" << 3));
+
+    ASSERT_OK(viewCatalog.createView(opCtx.get(), view1, viewOn, pipeline1.arr(), emptyCollation));
+    ASSERT_OK(viewCatalog.createView(opCtx.get(), view2, view1, pipeline2.arr(), emptyCollation));
+
+    // Resolving twice gives the same answer, the second time from the cache.
+    for (int i = 0; i < 2; ++i) {
+        auto resolvedView = uassertStatusOK(viewCatalog.resolveView(opCtx.get(), view2));
+        ASSERT_EQ(resolvedView.getNamespace(), viewOn);
+        ASSERT_EQ(2U, resolvedView.getPipeline().size());
+        ASSERT_BSONOBJ_EQ(BSON("$match" << BSON("foo" << 1)), resolvedView.getPipeline()[0]);
+    }
+
+    // Modifying a view further down the graph is seen by views defined on it.
+    ASSERT_OK(viewCatalog.modifyView(opCtx.get(), view1, otherViewOn, modifiedPipeline1.arr()));
+    auto resolvedView = uassertStatusOK(viewCatalog.resolveView(opCtx.get(), view2));
+    ASSERT_EQ(resolvedView.getNamespace(), otherViewOn);
+    ASSERT_EQ(2U, resolvedView.getPipeline().size());
+    ASSERT_BSONOBJ_EQ(BSON("$match" << BSON("foo" << 3)), resolvedView.getPipeline()[0]);
+
+    // Once the view is dropped, its namespace resolves to itself.
+    ASSERT_OK(viewCatalog.dropView(opCtx.get(), view2));
+    resolvedView = uassertStatusOK(viewCatalog.resolveView(opCtx.get(), view2));
+    ASSERT_EQ(resolvedView.getNamespace(), view2);
+    ASSERT_EQ(0U, resolvedView.getPipeline().size());
+}
+
 TEST_F(ViewCatalogFixture, InvalidateThenReload) {
     const NamespaceString viewName("db.view");
     const NamespaceString viewOn("db.coll");
@@ -30,6 +30,7 @@
 #include "mongo/platform/basic.h"
 
 #include <algorithm>
+#include <set>
 
 #include <boost/optional/optional.hpp>
 #include <boost/optional/optional_io.hpp>
@@ -559,6 +560,32 @@ TEST(CursorManagerTest, RegisteredWithGlobalServiceContext) {
     ASSERT(cursorManager);
 }
 
+/**
+ * Test that newly registered cursors get distinct, positive ids which are spread across every
+ * partition of the cursor manager, and that each of them can be pinned by id.
+ */
+TEST_F(CursorManagerTest, RegisteredCursorIdsAreSpreadAcrossPartitions) {
+    CursorManager* cursorManager = useCursorManager();
+    const size_t kNumCursors = 64;
+
+    stdx::unordered_set<CursorId> cursorIds;
+    std::set<CursorId> lowBits;
+    for (size_t i = 0; i < kNumCursors; ++i) {
+        auto cursorPin = makeCursor(_opCtx.get());
+        auto cursorId = cursorPin.getCursor()->cursorid();
+        ASSERT_GT(cursorId, 0);
+        cursorIds.insert(cursorId);
+        lowBits.insert(cursorId % 16);
+    }
+    ASSERT_EQ(kNumCursors, cursorIds.size());
+    ASSERT_EQ(kNumCursors, cursorManager->numCursors());
+    ASSERT_EQ(16UL, lowBits.size());
+
+    for (auto cursorId : cursorIds) {
+        ASSERT_OK(cursorManager->pinCursor(_opCtx.get(), cursorId).getStatus());
+    }
+}
+
 /**
  * Test that a CursorManager is registered with a custom ServiceContext.
  */
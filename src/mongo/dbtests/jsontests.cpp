@@ -102,6 +102,15 @@ public:
     }
 };
 
+class EscapedCharactersWithinRuns {
+public:
+    void run() {
+        BSONObjBuilder b;
+        b.append("abc\"def", "ghi\njkl\\");
+        ASSERT_EQUALS("{ \"abc\\\"def\" : \"ghi\\njkl\\\\\" }", b.done().jsonString(Strict));
+    }
+};
+
 class EscapeFieldName {
 public:
     void run() {
@@ -205,6 +214,16 @@ public:
     }
 };
 
+class NumberLongStrictMin {
+public:
+    void run() {
+        BSONObjBuilder b;
+        b.append("a", std::numeric_limits<long long>::min());
+        ASSERT_EQUALS("{ \"a\" : { \"$numberLong\" : \"-9223372036854775808\" } }",
+                      b.done().jsonString(Strict));
+    }
+};
+
 class NumberDecimal {
 public:
     void run() {
@@ -2716,6 +2735,7 @@ public:
         add<JsonStringTests::EscapedCharacters>();
         add<JsonStringTests::AdditionalControlCharacters>();
         add<JsonStringTests::ExtendedAscii>();
+        add<JsonStringTests::EscapedCharactersWithinRuns>();
         add<JsonStringTests::EscapeFieldName>();
         add<JsonStringTests::SingleIntMember>();
         add<JsonStringTests::SingleNumberMember>();
@@ -2726,6 +2746,7 @@ public:
         add<JsonStringTests::NumberLongStrict>();
         add<JsonStringTests::NumberLongStrictLarge>();
         add<JsonStringTests::NumberLongStrictNegative>();
+        add<JsonStringTests::NumberLongStrictMin>();
         add<JsonStringTests::NumberDecimal>();
         add<JsonStringTests::NumberDecimalStrict>();
         add<JsonStringTests::NumberDoubleNaN>();
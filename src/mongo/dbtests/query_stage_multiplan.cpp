@@ -55,6 +55,7 @@
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/clock_source_mock.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -560,6 +561,64 @@ TEST_F(QueryStageMultiPlanTest, MPSSummaryStats) {
     ASSERT_LTE(stats.totalKeysExamined, static_cast<size_t>(N));
 }
 
+// Test that the lower-scoring half of the candidates stop being worked once the plans are
+// checked for pruning, and that the winner is picked among the survivors.
+TEST_F(QueryStageMultiPlanTest, MPSPrunesLowScoringCandidates) {
+    const int N = 5000;
+    for (int i = 0; i < N; ++i) {
+        insert(BSON("foo" << (i % 10)));
+    }
+
+    addIndex(BSON("foo" << 1));
+
+    const int oldPruneWorks = internalQueryPlanEvaluationPruneWorks.load();
+    const int oldPruneMinCandidates = internalQueryPlanEvaluationPruneMinCandidates.load();
+    ON_BLOCK_EXIT([&] {
+        internalQueryPlanEvaluationPruneWorks.store(oldPruneWorks);
+        internalQueryPlanEvaluationPruneMinCandidates.store(oldPruneMinCandidates);
+    });
+    const size_t pruneWorks = 10;
+    internalQueryPlanEvaluationPruneWorks.store(static_cast<int>(pruneWorks));
+    internalQueryPlanEvaluationPruneMinCandidates.store(8);
+
+    AutoGetCollectionForReadCommand ctx(_opCtx.get(), nss);
+    const Collection* coll = ctx.getCollection();
+
+    // Plan 0 is the selective index scan, followed by eight equally good collection scans.
+    BSONObj filterObj = BSON("foo" << 7);
+    const size_t numCollScans = 8;
+    std::vector<unique_ptr<MatchExpression>> filters;
+    unique_ptr<WorkingSet> sharedWs(new WorkingSet());
+    auto cq = makeCanonicalQuery(_opCtx.get(), nss, filterObj);
+    unique_ptr<MultiPlanStage> mps = make_unique<MultiPlanStage>(_opCtx.get(), coll, cq.get());
+    mps->addPlan(createQuerySolution(),
+                 getIxScanPlan(_opCtx.get(), coll, sharedWs.get(), 7).release(),
+                 sharedWs.get());
+    for (size_t i = 0; i < numCollScans; ++i) {
+        filters.push_back(makeMatchExpressionFromFilter(_opCtx.get(), filterObj));
+        mps->addPlan(createQuerySolution(),
+                     getCollScanPlan(_opCtx.get(), coll, sharedWs.get(), filters.back().get())
+                         .release(),
+                     sharedWs.get());
+    }
+
+    PlanYieldPolicy yieldPolicy(PlanExecutor::NO_YIELD, _clock);
+    ASSERT_OK(mps->pickBestPlan(&yieldPolicy));
+    ASSERT(mps->bestPlanChosen());
+    ASSERT_EQUALS(0, mps->bestPlanIdx());
+
+    // Of the nine live plans, the index scan and the first four collection scans survive the first
+    // check. Five live plans are too few to be pruned again.
+    const auto& children = mps->getChildren();
+    ASSERT_GT(children[0]->getStats()->common.works, pruneWorks);
+    for (size_t i = 1; i <= numCollScans / 2; ++i) {
+        ASSERT_GT(children[i]->getStats()->common.works, pruneWorks);
+    }
+    for (size_t i = numCollScans / 2 + 1; i <= numCollScans; ++i) {
+        ASSERT_EQ(children[i]->getStats()->common.works, pruneWorks);
+    }
+}
+
 TEST_F(QueryStageMultiPlanTest, ShouldReportErrorIfExceedsTimeLimitDuringPlanning) {
     const int N = 5000;
     for (int i = 0; i < N; ++i) {
@@ -571,6 +571,66 @@ public:
     }
 };
 
+// Sorts on a compound pattern of mixed directions over numbers of mixed types, keeping the top
+// results in a heap.
+class QueryStageSortCompoundWithLimit : public QueryStageSortTestBase {
+public:
+    virtual int numObj() {
+        return 200;
+    }
+
+    virtual int limit() const {
+        return 25;
+    }
+
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+
+        auto ws = make_unique<WorkingSet>();
+        auto queuedDataStage = make_unique<QueuedDataStage>(&_opCtx, ws.get());
+
+        // 'a' alternates between ints and doubles, which compare equal when their values match.
+        std::vector<std::pair<int, int>> expected;
+        for (int i = 0; i < numObj(); ++i) {
+            const int a = (i * 7) % 5;
+            WorkingSetID id = ws->allocate();
+            WorkingSetMember* member = ws->get(id);
+            const BSONObj doc = i % 2 ? BSON("a" << a << "b" << i)
+                                      : BSON("a" << static_cast<double>(a) << "b" << i);
+            member->obj = Snapshotted<BSONObj>(SnapshotId(), doc);
+            member->transitionToOwnedObj();
+            queuedDataStage->pushBack(id);
+            expected.emplace_back(a, -i);
+        }
+        std::sort(expected.begin(), expected.end());
+        expected.resize(limit());
+
+        SortStageParams params;
+        params.pattern = BSON("a" << 1 << "b" << -1);
+        params.limit = limit();
+
+        auto keyGenStage = make_unique<SortKeyGeneratorStage>(
+            &_opCtx, queuedDataStage.release(), ws.get(), params.pattern, nullptr);
+        auto sortStage = make_unique<SortStage>(&_opCtx, params, ws.get(), keyGenStage.release());
+
+        auto statusWithPlanExecutor = PlanExecutor::make(&_opCtx,
+                                                         std::move(ws),
+                                                         std::move(sortStage),
+                                                         NamespaceString(ns()),
+                                                         PlanExecutor::NO_YIELD);
+        ASSERT_OK(statusWithPlanExecutor.getStatus());
+        auto exec = std::move(statusWithPlanExecutor.getValue());
+
+        BSONObj obj;
+        for (auto&& pair : expected) {
+            ASSERT_EQUALS(PlanExecutor::ADVANCED, exec->getNext(&obj, NULL));
+            ASSERT_EQUALS(pair.first, obj["a"].numberInt());
+            ASSERT_EQUALS(-pair.second, obj["b"].numberInt());
+        }
+        ASSERT_EQUALS(PlanExecutor::IS_EOF, exec->getNext(&obj, NULL));
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_sort") {}
@@ -588,6 +648,7 @@ public:
         add<QueryStageSortDeletionInvalidationWithLimit<10>>();
         add<QueryStageSortDeletionInvalidationWithLimit<1>>();
         add<QueryStageSortParallelArrays>();
+        add<QueryStageSortCompoundWithLimit>();
     }
 };
 
@@ -68,6 +68,7 @@
 #include "mongo/util/periodic_runner_factory.h"
 #include "mongo/util/quick_exit.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 #include <boost/filesystem.hpp>
 
@@ -91,6 +92,10 @@ void initWireSpec() {
 }
 
 
+// Time spent in each phase of initialize(), in the order the phases ran.
+using StartupTimings = std::vector<std::pair<std::string, Microseconds>>;
+const auto getStartupTimings = ServiceContext::declareDecoration<StartupTimings>();
+
 // Noop, to fulfull dependencies for other initializers
 MONGO_INITIALIZER_GENERAL(ForkServer, ("EndStartupOptionHandling"), ("default"))
 (InitializerContext* context) {
@@ -185,9 +190,28 @@ void shutdown(ServiceContext* srvContext) {
 }
 
 
+void appendStartupTimings(ServiceContext* serviceContext, BSONObjBuilder* builder) {
+    Microseconds total{0};
+    BSONArrayBuilder phases(builder->subarrayStart("phases"));
+    for (auto&& phase : getStartupTimings(serviceContext)) {
+        phases.append(BSON("name" << phase.first << "micros"
+                                  << durationCount<Microseconds>(phase.second)));
+        total += phase.second;
+    }
+    phases.doneFast();
+    builder->append("totalMicros", durationCount<Microseconds>(total));
+}
+
 ServiceContext* initialize(const char* yaml_config) {
     srand(static_cast<unsigned>(curTimeMicros64()));
 
+    StartupTimings startupTimings;
+    Timer phaseTimer;
+    auto endPhase = [&](std::string name) {
+        startupTimings.emplace_back(std::move(name), Microseconds(phaseTimer.micros()));
+        phaseTimer.reset();
+    };
+
     // yaml_config is passed to the options parser through the argc/argv interface that already
     // existed. If it is nullptr then use 0 count which will be interpreted as empty string.
     const char* argv[2] = {yaml_config, nullptr};
@@ -195,6 +219,7 @@ ServiceContext* initialize(const char* yaml_config) {
     Status status = mongo::runGlobalInitializers(yaml_config ? 1 : 0, argv, nullptr);
     uassertStatusOKWithContext(status, "Global initilization failed");
     auto giGuard = makeGuard([] { mongo::runGlobalDeinitializers().ignore(); });
+    endPhase("globalInitializers");
     setGlobalServiceContext(ServiceContext::make());
 
     Client::initThread("initandlisten");
@@ -226,6 +251,7 @@ ServiceContext* initialize(const char* yaml_config) {
     }
 
     DEV log(LogComponent::kControl) << "DEBUG build (which is slower)" << endl;
+    endPhase("serviceContext");
 
     // The periodic runner is required by the storage engine to be running beforehand.
     auto periodicRunner = std::make_unique<PeriodicRunnerEmbedded>(
@@ -235,6 +261,7 @@ ServiceContext* initialize(const char* yaml_config) {
 
     initializeStorageEngine(serviceContext, StorageEngineInitFlags::kAllowNoLockFile);
     setUpCatalog(serviceContext);
+    endPhase("storageEngine");
 
     // Warn if we detect configurations for multiple registered storage engines in the same
     // configuration file/environment.
@@ -301,6 +328,7 @@ ServiceContext* initialize(const char* yaml_config) {
         log() << "finished checking dbs";
         exitCleanly(EXIT_CLEAN);
     }
+    endPhase("repairDatabasesAndCheckVersion");
 
     // This is for security on certain platforms (nonce generation)
     srand((unsigned)(curTimeMicros64()) ^ (unsigned(uintptr_t(&startupOpCtx))));
@@ -308,6 +336,7 @@ ServiceContext* initialize(const char* yaml_config) {
     // Set up the logical session cache
     auto sessionCache = makeLogicalSessionCacheEmbedded();
     LogicalSessionCache::set(serviceContext, std::move(sessionCache));
+    endPhase("logicalSessionCache");
 
     // MessageServer::run will return when exit code closes its socket and we don't need the
     // operation context anymore
@@ -315,6 +344,13 @@ ServiceContext* initialize(const char* yaml_config) {
 
     serviceContext->notifyStartupComplete();
 
+    getStartupTimings(serviceContext) = std::move(startupTimings);
+    {
+        BSONObjBuilder timings;
+        appendStartupTimings(serviceContext, &timings);
+        log(LogComponent::kControl) << "startup timings: " << timings.obj();
+    }
+
     // Init succeeded, no need for global deinit.
     giGuard.dismiss();
 
@@ -32,10 +32,17 @@
 #include "mongo/platform/basic.h"
 
 namespace mongo {
+class BSONObjBuilder;
 class ServiceContext;
 
 namespace embedded {
 ServiceContext* initialize(const char* yaml_config);
 void shutdown(ServiceContext* serviceContext);
+
+/**
+ * Appends how long each phase of initialize() took for 'serviceContext', in the order the phases
+ * ran, along with the total.
+ */
+void appendStartupTimings(ServiceContext* serviceContext, BSONObjBuilder* builder);
 }  // namespace embedded
 }  // namespace mongo
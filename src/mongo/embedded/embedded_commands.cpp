@@ -30,6 +30,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/commands.h"
+#include "mongo/embedded/embedded.h"
 
 namespace mongo {
 
@@ -82,6 +83,41 @@ public:
 
 } cmdTrimMemory;
 
+class CmdGetStartupTimings : public BasicCommand {
+public:
+    CmdGetStartupTimings() : BasicCommand("getStartupTimings") {}
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kAlways;
+    }
+
+    bool adminOnly() const override {
+        return false;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) const override {
+    }  // No auth in embedded
+
+    std::string help() const override {
+        return "Reports how long each phase of library instance startup took, in microseconds.";
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& jsobj,
+             BSONObjBuilder& result) override {
+        embedded::appendStartupTimings(opCtx->getServiceContext(), &result);
+        return true;
+    }
+
+} cmdGetStartupTimings;
+
 class CmdBatteryLevel : public BasicCommand {
 public:
     CmdBatteryLevel() : BasicCommand("setBatteryLevel") {}
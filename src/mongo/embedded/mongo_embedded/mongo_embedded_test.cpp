@@ -329,6 +329,17 @@ TEST_F(MongodbCAPITest, BatteryLevel) {
     performRpc(client, inputOpMsg);
 }
 
+TEST_F(MongodbCAPITest, StartupTimings) {
+    auto client = createClient();
+
+    mongo::BSONObj inputObj = mongo::fromjson("{getStartupTimings: 1}");
+    auto inputOpMsg = mongo::OpMsgRequest::fromDBAndBody("admin", inputObj);
+    auto output = performRpc(client, inputOpMsg);
+    ASSERT(output.getField("ok").numberDouble() == 1.0) << output;
+    ASSERT(!output.getField("phases").Obj().isEmpty()) << output;
+    ASSERT(output.getField("totalMicros").numberLong() >= 0) << output;
+}
+
 
 TEST_F(MongodbCAPITest, InsertDocument) {
     auto client = createClient();
@@ -587,6 +598,7 @@ TEST_F(MongodbCAPITest, RunListCommands) {
         "getLastError",
         "getMore",
         "getParameter",
+        "getStartupTimings",
         "httpClientRequest",
         "insert",
         "isMaster",
@@ -100,9 +100,9 @@ public:
      *
      * The complexity comes from the need to hold a lock when writing to the
      * _activeClients param on the specific pool.  Because the code beneath the client needs to lock
-     * and unlock the parent mutex (and can leave unlocked), we want to start the client with the
-     * lock acquired, move it into the client, then re-acquire to decrement the counter on the way
-     * out.
+     * and unlock the specific pool's mutex (and can leave unlocked), we want to start the client
+     * with the lock acquired, move it into the client, then re-acquire to decrement the counter on
+     * the way out.
      *
      * This callback also (perhaps overly aggressively) binds a shared pointer to the guard.
      * It is *always* safe to reference the original specific pool in the guarded function object.
@@ -116,11 +116,11 @@ public:
     template <typename Callback>
     auto guardCallback(Callback&& cb) {
         return [ cb = std::forward<Callback>(cb), anchor = shared_from_this() ](auto&&... args) {
-            stdx::unique_lock<stdx::mutex> lk(anchor->_parent->_mutex);
+            stdx::unique_lock<stdx::mutex> lk(anchor->_mutex);
             ++(anchor->_activeClients);
 
             ON_BLOCK_EXIT([anchor]() {
-                stdx::unique_lock<stdx::mutex> lk(anchor->_parent->_mutex);
+                stdx::unique_lock<stdx::mutex> lk(anchor->_mutex);
                 --(anchor->_activeClients);
             });
 
@@ -134,8 +134,24 @@ public:
     ~SpecificPool();
 
     /**
-     * Gets a connection from the specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Locks this pool's mutex. The specific pool's state is only accessed under its own mutex,
+     * which is never acquired while holding the parent's mutex, so requests to different hosts do
+     * not contend with each other.
+     */
+    stdx::unique_lock<stdx::mutex> lock() {
+        return stdx::unique_lock<stdx::mutex>(_mutex);
+    }
+
+    /**
+     * Returns true if the pool has been shut down and must not hand out any more connections.
+     */
+    bool isInShutdown(const stdx::unique_lock<stdx::mutex>& lk) const {
+        return _state == State::kInShutdown;
+    }
+
+    /**
+     * Gets a connection from the specific pool. Sinks a unique_lock to preserve the lock on
+     * _mutex
      */
     Future<ConnectionHandle> getConnection(Milliseconds timeout, stdx::unique_lock<stdx::mutex> lk);
 
@@ -155,8 +171,8 @@ public:
     void processFailure(const Status& status, stdx::unique_lock<stdx::mutex> lk);
 
     /**
-     * Returns a connection to a specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Returns a connection to a specific pool. Sinks a unique_lock to preserve the lock on
+     * _mutex
      */
     void returnConnection(ConnectionInterface* connection, stdx::unique_lock<stdx::mutex> lk);
 
@@ -180,6 +196,13 @@ public:
      */
     size_t createdConnections(const stdx::unique_lock<stdx::mutex>& lk);
 
+    /**
+     * Returns how long requests have waited to check out connections from this pool.
+     */
+    const ConnectionCheckoutHistogram& checkouts(const stdx::unique_lock<stdx::mutex>& lk) const {
+        return _checkouts;
+    }
+
     /**
      * Returns the total number of connections currently open that belong to
      * this pool. This is the sum of refreshingConnections, availableConnections,
@@ -215,10 +238,14 @@ private:
     using OwnedConnection = std::shared_ptr<ConnectionInterface>;
     using OwnershipPool = stdx::unordered_map<ConnectionInterface*, OwnedConnection>;
     using LRUOwnershipPool = LRUCache<OwnershipPool::key_type, OwnershipPool::mapped_type>;
-    using Request = std::pair<Date_t, Promise<ConnectionHandle>>;
+    struct Request {
+        Date_t expiration;
+        Date_t requestedAt;
+        Promise<ConnectionHandle> promise;
+    };
     struct RequestComparator {
         bool operator()(const Request& a, const Request& b) {
-            return a.first > b.first;
+            return a.expiration > b.expiration;
         }
     };
 
@@ -249,6 +276,9 @@ private:
 private:
     ConnectionPool* const _parent;
 
+    // Guards all of the state below
+    stdx::mutex _mutex;
+
     const transport::ConnectSSLMode _sslMode;
     const HostAndPort _hostAndPort;
 
@@ -268,6 +298,8 @@ private:
 
     size_t _created;
 
+    ConnectionCheckoutHistogram _checkouts;
+
     transport::Session::TagMask _tags = transport::Session::kPending;
 
     /**
@@ -338,7 +370,7 @@ void ConnectionPool::shutdown() {
     }();
 
     for (const auto& pair : pools) {
-        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        auto lk = pair.second->lock();
         pair.second->triggerShutdown(
             Status(ErrorCodes::ShutdownInProgress, "Shutting down the connection pool"),
             std::move(lk));
@@ -346,14 +378,11 @@ void ConnectionPool::shutdown() {
 }
 
 void ConnectionPool::dropConnections(const HostAndPort& hostAndPort) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-
-    auto iter = _pools.find(hostAndPort);
-
-    if (iter == _pools.end())
+    auto pool = _findPool(hostAndPort);
+    if (!pool)
         return;
 
-    auto pool = iter->second;
+    auto lk = pool->lock();
     pool->processFailure(Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"),
                          std::move(lk));
 }
@@ -368,7 +397,7 @@ void ConnectionPool::dropConnections(transport::Session::TagMask tags) {
     for (const auto& pair : pools) {
         auto& pool = pair.second;
 
-        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        auto lk = pool->lock();
         if (pool->matchesTags(lk, tags))
             continue;
 
@@ -381,14 +410,11 @@ void ConnectionPool::dropConnections(transport::Session::TagMask tags) {
 void ConnectionPool::mutateTags(
     const HostAndPort& hostAndPort,
     const stdx::function<transport::Session::TagMask(transport::Session::TagMask)>& mutateFunc) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-
-    auto iter = _pools.find(hostAndPort);
-
-    if (iter == _pools.end())
+    auto pool = _findPool(hostAndPort);
+    if (!pool)
         return;
 
-    auto pool = iter->second;
+    auto lk = pool->lock();
     pool->mutateTags(lk, mutateFunc);
 }
 
@@ -401,63 +427,95 @@ void ConnectionPool::get_forTest(const HostAndPort& hostAndPort,
 Future<ConnectionPool::ConnectionHandle> ConnectionPool::get(const HostAndPort& hostAndPort,
                                                              transport::ConnectSSLMode sslMode,
                                                              Milliseconds timeout) {
-    std::shared_ptr<SpecificPool> pool;
+    for (;;) {
+        auto pool = [&] {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
 
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+            auto iter = _pools.find(hostAndPort);
 
-    auto iter = _pools.find(hostAndPort);
+            if (iter == _pools.end()) {
+                auto newPool = std::make_shared<SpecificPool>(this, hostAndPort, sslMode);
+                _pools[hostAndPort] = newPool;
+                return newPool;
+            }
 
-    if (iter == _pools.end()) {
-        pool = stdx::make_unique<SpecificPool>(this, hostAndPort, sslMode);
-        _pools[hostAndPort] = pool;
-    } else {
-        pool = iter->second;
-        pool->fassertSSLModeIs(sslMode);
-    }
+            iter->second->fassertSSLModeIs(sslMode);
+            return iter->second;
+        }();
+
+        invariant(pool);
 
-    invariant(pool);
+        auto lk = pool->lock();
+        if (!pool->isInShutdown(lk)) {
+            return pool->getConnection(timeout, std::move(lk));
+        }
+        lk.unlock();
 
-    return pool->getConnection(timeout, std::move(lk));
+        // The pool shut down between looking it up and locking it. It delists itself once its
+        // remaining connections have drained, so make sure a new pool replaces it.
+        stdx::lock_guard<stdx::mutex> parentLk(_mutex);
+        auto iter = _pools.find(hostAndPort);
+        if (iter != _pools.end() && iter->second == pool) {
+            _pools.erase(iter);
+        }
+    }
 }
 
 void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    // Grab all current pools (under the lock)
+    auto pools = [&] {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _pools;
+    }();
 
-    for (const auto& kv : _pools) {
+    for (const auto& kv : pools) {
         HostAndPort host = kv.first;
 
         auto& pool = kv.second;
+        auto lk = pool->lock();
         ConnectionStatsPer hostStats{pool->inUseConnections(lk),
                                      pool->availableConnections(lk),
                                      pool->createdConnections(lk),
                                      pool->refreshingConnections(lk)};
+        hostStats.checkouts = pool->checkouts(lk);
+        lk.unlock();
+
         stats->updateStatsForHost(_name, host, hostStats);
     }
 }
 
 size_t ConnectionPool::getNumConnectionsPerHost(const HostAndPort& hostAndPort) const {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-    auto iter = _pools.find(hostAndPort);
-    if (iter != _pools.end()) {
-        return iter->second->openConnections(lk);
+    auto pool = _findPool(hostAndPort);
+    if (pool) {
+        auto lk = pool->lock();
+        return pool->openConnections(lk);
     }
 
     return 0;
 }
 
 void ConnectionPool::returnConnection(ConnectionInterface* conn) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-
-    auto iter = _pools.find(conn->getHostAndPort());
+    auto pool = _findPool(conn->getHostAndPort());
 
-    invariant(iter != _pools.end(),
+    invariant(pool,
               str::stream() << "Tried to return connection but no pool found for "
                             << conn->getHostAndPort());
 
-    auto pool = iter->second;
+    auto lk = pool->lock();
     pool->returnConnection(conn, std::move(lk));
 }
 
+std::shared_ptr<ConnectionPool::SpecificPool> ConnectionPool::_findPool(
+    const HostAndPort& hostAndPort) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto iter = _pools.find(hostAndPort);
+    if (iter == _pools.end())
+        return nullptr;
+
+    return iter->second;
+}
+
 ConnectionPool::SpecificPool::SpecificPool(ConnectionPool* parent,
                                            const HostAndPort& hostAndPort,
                                            transport::ConnectSSLMode sslMode)
@@ -511,6 +569,7 @@ Future<ConnectionPool::ConnectionHandle> ConnectionPool::SpecificPool::getConnec
     updateStateInLock();
 
     if (conn) {
+        _checkouts.increment(Milliseconds(0));
         return Future<ConnectionPool::ConnectionHandle>::makeReady(std::move(conn));
     }
 
@@ -518,10 +577,10 @@ Future<ConnectionPool::ConnectionHandle> ConnectionPool::SpecificPool::getConnec
         timeout = _parent->_options.refreshTimeout;
     }
 
-    const auto expiration = _parent->_factory->now() + timeout;
+    const auto now = _parent->_factory->now();
     auto pf = makePromiseFuture<ConnectionHandle>();
 
-    _requests.push_back(make_pair(expiration, std::move(pf.promise)));
+    _requests.push_back(Request{now + timeout, now, std::move(pf.promise)});
     std::push_heap(begin(_requests), end(_requests), RequestComparator{});
 
     updateStateInLock();
@@ -763,7 +822,7 @@ void ConnectionPool::SpecificPool::processFailure(const Status& status,
     lk.unlock();
 
     for (auto& request : requestsToFail) {
-        request.second.setError(status);
+        request.promise.setError(status);
     }
 }
 
@@ -790,7 +849,8 @@ void ConnectionPool::SpecificPool::fulfillRequests(stdx::unique_lock<stdx::mutex
         }
 
         // Grab the request and callback
-        auto promise = std::move(_requests.front().second);
+        auto promise = std::move(_requests.front().promise);
+        _checkouts.increment(_parent->_factory->now() - _requests.front().requestedAt);
         std::pop_heap(begin(_requests), end(_requests), RequestComparator{});
         _requests.pop_back();
 
@@ -887,9 +947,15 @@ void ConnectionPool::SpecificPool::updateStateInLock() {
     if (_state == State::kInShutdown) {
         // If we're in shutdown, there is nothing to update. Our clients are all gone.
         if (_processingPool.empty() && !_activeClients) {
-            // If we have no more clients that require access to us, delist from the parent pool
+            // If we have no more clients that require access to us, delist from the parent pool.
+            // A replacement pool may already have taken our place if a request raced with our
+            // shutdown, so only remove ourselves.
             LOG(2) << "Delisting connection pool for " << _hostAndPort;
-            _parent->_pools.erase(_hostAndPort);
+            stdx::lock_guard<stdx::mutex> parentLk(_parent->_mutex);
+            auto iter = _parent->_pools.find(_hostAndPort);
+            if (iter != _parent->_pools.end() && iter->second.get() == this) {
+                _parent->_pools.erase(iter);
+            }
         }
         return;
     }
@@ -899,16 +965,16 @@ void ConnectionPool::SpecificPool::updateStateInLock() {
 
         // If we were already running and the timer is the same as it was
         // before, nothing to do
-        if (_state == State::kRunning && _requestTimerExpiration == _requests.front().first)
+        if (_state == State::kRunning && _requestTimerExpiration == _requests.front().expiration)
             return;
 
         _state = State::kRunning;
 
         _requestTimer->cancelTimeout();
 
-        _requestTimerExpiration = _requests.front().first;
+        _requestTimerExpiration = _requests.front().expiration;
 
-        auto timeout = _requests.front().first - _parent->_factory->now();
+        auto timeout = _requests.front().expiration - _parent->_factory->now();
 
         // We set a timer for the most recent request, then invoke each timed
         // out request we couldn't service
@@ -919,8 +985,8 @@ void ConnectionPool::SpecificPool::updateStateInLock() {
                 while (_requests.size()) {
                     auto& x = _requests.front();
 
-                    if (x.first <= now) {
-                        auto promise = std::move(x.second);
+                    if (x.expiration <= now) {
+                        auto promise = std::move(x.promise);
                         std::pop_heap(begin(_requests), end(_requests), RequestComparator{});
                         _requests.pop_back();
 
@@ -959,7 +1025,7 @@ void ConnectionPool::SpecificPool::updateStateInLock() {
 
         // Set the shutdown timer, this gets reset on any request
         _requestTimer->setTimeout(timeout, [ this, anchor = shared_from_this() ]() {
-            stdx::unique_lock<stdx::mutex> lk(anchor->_parent->_mutex);
+            stdx::unique_lock<stdx::mutex> lk(anchor->_mutex);
             if (_state != State::kIdle)
                 return;
 
@@ -169,6 +169,11 @@ public:
 private:
     void returnConnection(ConnectionInterface* connection);
 
+    /**
+     * Returns the specific pool for 'hostAndPort', or nullptr if there is none.
+     */
+    std::shared_ptr<SpecificPool> _findPool(const HostAndPort& hostAndPort) const;
+
     std::string _name;
 
     // Options are set at startup and never changed at run time, so these are
@@ -177,7 +182,8 @@ private:
 
     const std::shared_ptr<DependentTypeFactoryInterface> _factory;
 
-    // The global mutex for specific pool access and the generation counter
+    // Guards the map of specific pools. Each specific pool guards its own state with its own
+    // mutex, which may be acquired before this one but never while holding it.
     mutable stdx::mutex _mutex;
     stdx::unordered_map<HostAndPort, std::shared_ptr<SpecificPool>> _pools;
 
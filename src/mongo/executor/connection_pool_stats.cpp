@@ -37,6 +37,52 @@
 namespace mongo {
 namespace executor {
 
+const std::array<Milliseconds, ConnectionCheckoutHistogram::kNumBuckets>
+    ConnectionCheckoutHistogram::kLowerBounds = {Milliseconds(0),
+                                                 Milliseconds(1),
+                                                 Milliseconds(10),
+                                                 Milliseconds(100),
+                                                 Milliseconds(1000),
+                                                 Milliseconds(10000)};
+
+void ConnectionCheckoutHistogram::increment(Milliseconds waitTime) {
+    auto bucket = kNumBuckets - 1;
+    while (waitTime < kLowerBounds[bucket]) {
+        --bucket;
+    }
+
+    ++buckets[bucket];
+    ++count;
+    totalWaitTime += waitTime;
+}
+
+ConnectionCheckoutHistogram& ConnectionCheckoutHistogram::operator+=(
+    const ConnectionCheckoutHistogram& other) {
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+        buckets[i] += other.buckets[i];
+    }
+    count += other.count;
+    totalWaitTime += other.totalWaitTime;
+
+    return *this;
+}
+
+void ConnectionCheckoutHistogram::appendToBSON(BSONObjBuilder& result) const {
+    BSONObjBuilder checkoutsBuilder(result.subobjStart("checkouts"));
+    {
+        BSONArrayBuilder histogramBuilder(checkoutsBuilder.subarrayStart("histogram"));
+        for (size_t i = 0; i < kNumBuckets; ++i) {
+            if (buckets[i] == 0)
+                continue;
+            BSONObjBuilder entryBuilder(histogramBuilder.subobjStart());
+            entryBuilder.append("millis", durationCount<Milliseconds>(kLowerBounds[i]));
+            entryBuilder.append("count", buckets[i]);
+        }
+    }
+    checkoutsBuilder.append("count", count);
+    checkoutsBuilder.append("totalWaitMillis", durationCount<Milliseconds>(totalWaitTime));
+}
+
 ConnectionStatsPer::ConnectionStatsPer(size_t nInUse,
                                        size_t nAvailable,
                                        size_t nCreated,
@@ -50,6 +96,7 @@ ConnectionStatsPer& ConnectionStatsPer::operator+=(const ConnectionStatsPer& oth
     available += other.available;
     created += other.created;
     refreshing += other.refreshing;
+    checkouts += other.checkouts;
 
     return *this;
 }
@@ -84,6 +131,7 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
             poolInfo.appendNumber("poolAvailable", poolStats.available);
             poolInfo.appendNumber("poolCreated", poolStats.created);
             poolInfo.appendNumber("poolRefreshing", poolStats.refreshing);
+            poolStats.checkouts.appendToBSON(poolInfo);
             for (auto&& host : statsByPoolHost[pool.first]) {
                 BSONObjBuilder hostInfo(poolInfo.subobjStart(host.first.toString()));
                 auto hostStats = host.second;
@@ -91,6 +139,7 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
                 hostInfo.appendNumber("available", hostStats.available);
                 hostInfo.appendNumber("created", hostStats.created);
                 hostInfo.appendNumber("refreshing", hostStats.refreshing);
+                hostStats.checkouts.appendToBSON(hostInfo);
             }
         }
     }
@@ -103,6 +152,7 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
             hostInfo.appendNumber("available", hostStats.available);
             hostInfo.appendNumber("created", hostStats.created);
             hostInfo.appendNumber("refreshing", hostStats.refreshing);
+            hostStats.checkouts.appendToBSON(hostInfo);
         }
     }
 }
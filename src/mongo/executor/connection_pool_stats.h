@@ -29,12 +29,39 @@
 
 #pragma once
 
+#include <array>
+
 #include "mongo/stdx/unordered_map.h"
+#include "mongo/util/duration.h"
 #include "mongo/util/net/hostandport.h"
 
 namespace mongo {
+
+class BSONObjBuilder;
+
 namespace executor {
 
+/**
+ * Counts how long requests waited to check a connection out of a pool, in buckets whose lower
+ * bounds grow by a factor of ten.
+ */
+struct ConnectionCheckoutHistogram {
+    static constexpr size_t kNumBuckets = 6;
+
+    // Inclusive lower bounds of the buckets.
+    static const std::array<Milliseconds, kNumBuckets> kLowerBounds;
+
+    void increment(Milliseconds waitTime);
+
+    ConnectionCheckoutHistogram& operator+=(const ConnectionCheckoutHistogram& other);
+
+    void appendToBSON(BSONObjBuilder& result) const;
+
+    std::array<long long, kNumBuckets> buckets{};
+    long long count = 0;
+    Milliseconds totalWaitTime{0};
+};
+
 /**
  * Holds connection information for a specific pool or remote host. These objects are maintained by
  * a parent ConnectionPoolStats object and should not need to be created directly.
@@ -50,6 +77,7 @@ struct ConnectionStatsPer {
     size_t available = 0u;
     size_t created = 0u;
     size_t refreshing = 0u;
+    ConnectionCheckoutHistogram checkouts;
 };
 
 /**
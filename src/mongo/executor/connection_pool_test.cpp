@@ -37,6 +37,7 @@
 #include "mongo/executor/connection_pool_test_fixture.h"
 
 #include "mongo/executor/connection_pool.h"
+#include "mongo/executor/connection_pool_stats.h"
 #include "mongo/stdx/future.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
@@ -1482,6 +1483,43 @@ TEST_F(ConnectionPoolTest, AsyncGet) {
     }
 }
 
+/**
+ * Verify that checkouts are recorded in the pool's stats along with how long they waited.
+ */
+TEST_F(ConnectionPoolTest, CheckoutWaitTimesAreRecorded) {
+    ConnectionPool::Options options;
+    options.maxConnections = 1;
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool", options);
+
+    auto now = Date_t::now();
+    PoolImpl::setNow(now);
+
+    // The first request waits for its connection to be set up.
+    auto connFuture = pool.get(HostAndPort(), transport::kGlobalSSLMode, Seconds{10});
+    ASSERT_FALSE(connFuture.isReady());
+    PoolImpl::setNow(now + Milliseconds(50));
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT_TRUE(connFuture.isReady());
+    std::move(connFuture).getAsync([&](StatusWithConn swConn) {
+        ASSERT(verifyAndGetId(swConn));
+        doneWith(swConn.getValue());
+    });
+
+    // The second request is served from the ready pool.
+    pool.get_forTest(HostAndPort(), Seconds{10}, [&](StatusWithConn swConn) {
+        ASSERT(verifyAndGetId(swConn));
+        doneWith(swConn.getValue());
+    });
+
+    ConnectionPoolStats stats;
+    pool.appendConnectionStats(&stats);
+    const auto& checkouts = stats.statsByHost[HostAndPort()].checkouts;
+    ASSERT_EQ(2, checkouts.count);
+    ASSERT_EQ(1, checkouts.buckets[0]);
+    ASSERT_EQ(1, checkouts.buckets[2]);
+    ASSERT_EQ(Milliseconds(50), checkouts.totalWaitTime);
+}
+
 }  // namespace connection_pool_test_details
 }  // namespace executor
 }  // namespace mongo
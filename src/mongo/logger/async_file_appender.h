@@ -0,0 +1,82 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <sstream>
+
+#include "mongo/base/status.h"
+#include "mongo/logger/appender.h"
+#include "mongo/logger/async_log_writer.h"
+#include "mongo/logger/encoder.h"
+#include "mongo/logger/log_severity.h"
+#include "mongo/util/exit.h"
+
+namespace mongo {
+namespace logger {
+
+/**
+ * Appender that formats events on the logging thread and hands them to an AsyncLogWriter.
+ *
+ * Severe messages, and every message once the process has begun shutting down, are written
+ * synchronously along with anything still queued, so they reach the file before the process exits.
+ */
+template <typename Event>
+class AsyncFileAppender : public Appender<Event> {
+    AsyncFileAppender(const AsyncFileAppender&) = delete;
+    AsyncFileAppender& operator=(const AsyncFileAppender&) = delete;
+
+public:
+    typedef Encoder<Event> EventEncoder;
+
+    /**
+     * Constructs an appender, that owns "encoder", but not "writer."  Caller must keep "writer" in
+     * scope at least as long as the constructed appender.
+     */
+    AsyncFileAppender(std::unique_ptr<EventEncoder> encoder, AsyncLogWriter* writer)
+        : _encoder(std::move(encoder)), _writer(writer) {}
+
+    Status append(const Event& event) override {
+        std::ostringstream os;
+        _encoder->encode(event, os);
+        if (event.getSeverity() >= LogSeverity::Severe() || globalInShutdownDeprecated()) {
+            return _writer->writeNow(os.str());
+        }
+        _writer->enqueue(os.str());
+        return Status::OK();
+    }
+
+private:
+    std::unique_ptr<EventEncoder> _encoder;
+    AsyncLogWriter* _writer;
+};
+
+}  // namespace logger
+}  // namespace mongo
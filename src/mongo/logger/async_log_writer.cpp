@@ -0,0 +1,248 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/logger/async_log_writer.h"
+
+#include <boost/optional.hpp>
+
+#include "mongo/logger/rotatable_file_writer.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/duration.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+namespace logger {
+
+namespace {
+
+// Upper bound on how long the background thread or a blocked logging thread sleeps before checking
+// the buffer again, in case a wakeup was missed.
+constexpr Milliseconds kMaxSleep{100};
+
+size_t roundUpToPowerOfTwo(size_t n) {
+    size_t result = 2;
+    while (result < n) {
+        result <<= 1;
+    }
+    return result;
+}
+
+}  // namespace
+
+StatusWith<AsyncLogWriter::OverflowPolicy> AsyncLogWriter::parseOverflowPolicy(
+    StringData policy) {
+    if (policy == "drop") {
+        return OverflowPolicy::kDrop;
+    }
+    if (policy == "block") {
+        return OverflowPolicy::kBlock;
+    }
+    return {ErrorCodes::BadValue,
+            str::stream() << "Unknown log overflow policy '" << policy
+                          << "'; expected 'drop' or 'block'"};
+}
+
+AsyncLogWriter::AsyncLogWriter(RotatableFileWriter* writer, size_t capacity, OverflowPolicy policy)
+    : _writer(writer),
+      _policy(policy),
+      _mask(roundUpToPowerOfTwo(capacity) - 1),
+      _cells(new Cell[_mask + 1]) {
+    for (size_t i = 0; i <= _mask; ++i) {
+        _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    _thread = stdx::thread([this] { _run(); });
+}
+
+AsyncLogWriter::~AsyncLogWriter() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _shutdown = true;
+        _workAvailable.notify_one();
+        _spaceAvailable.notify_all();
+    }
+    _thread.join();
+}
+
+bool AsyncLogWriter::enqueue(std::string line) {
+    if (!_tryPush(&line)) {
+        if (_policy == OverflowPolicy::kDrop) {
+            _linesDropped.fetchAndAdd(1);
+            return false;
+        }
+
+        _blockedAppends.fetchAndAdd(1);
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _numBlockedProducers.fetchAndAdd(1);
+        _workAvailable.notify_one();
+        bool pushed;
+        while (!(pushed = _tryPush(&line)) && !_shutdown) {
+            _spaceAvailable.wait_for(lk, kMaxSleep.toSystemDuration());
+        }
+        _numBlockedProducers.fetchAndSubtract(1);
+        if (!pushed) {
+            // The background thread has stopped, so nothing will drain the buffer again.
+            lk.unlock();
+            return writeNow(line).isOK();
+        }
+    }
+
+    // Pairs with the fence in _run(): either this thread sees that the background thread is going
+    // to sleep, or the background thread sees this line.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_consumerSleeping.load()) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _workAvailable.notify_one();
+    }
+    return true;
+}
+
+Status AsyncLogWriter::writeNow(const std::string& line) {
+    stdx::lock_guard<stdx::mutex> lk(_drainMutex);
+    _drain_inlock().ignore();
+
+    RotatableFileWriter::Use useWriter(_writer);
+    Status status = useWriter.status();
+    if (!status.isOK()) {
+        return status;
+    }
+    useWriter.stream() << line;
+    useWriter.stream().flush();
+    _linesWritten.fetchAndAdd(1);
+    return useWriter.status();
+}
+
+AsyncLogWriter::Stats AsyncLogWriter::getStats() const {
+    const size_t enqueued = _enqueuePos.load();
+    const size_t dequeued = _dequeuePos.load();
+    return {_linesWritten.load(),
+            _linesDropped.load(),
+            _blockedAppends.load(),
+            enqueued > dequeued ? enqueued - dequeued : 0};
+}
+
+bool AsyncLogWriter::_tryPush(std::string* line) {
+    // Bounded queue from Dmitry Vyukov: each cell's sequence number says whether it is free for
+    // the producer claiming position "pos" or holds a line for the consumer.
+    size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+    while (true) {
+        Cell& cell = _cells[pos & _mask];
+        const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        const auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                cell.line = std::move(*line);
+                cell.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = _enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool AsyncLogWriter::_hasQueuedLine() const {
+    return _enqueuePos.load() != _dequeuePos.load();
+}
+
+Status AsyncLogWriter::_drain_inlock() {
+    // Take the file's lock once for the whole batch, and only if there is something to write.
+    boost::optional<RotatableFileWriter::Use> useWriter;
+    Status status = Status::OK();
+    long long written = 0;
+
+    size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+    while (true) {
+        Cell& cell = _cells[pos & _mask];
+        if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+            break;
+        }
+        std::string line = std::move(cell.line);
+        cell.line.clear();
+        cell.sequence.store(pos + _mask + 1, std::memory_order_release);
+        _dequeuePos.store(++pos);
+
+        if (!useWriter) {
+            useWriter.emplace(_writer);
+            status = useWriter->status();
+        }
+        if (status.isOK()) {
+            useWriter->stream() << line;
+            ++written;
+        }
+    }
+
+    if (useWriter && status.isOK()) {
+        useWriter->stream().flush();
+        status = useWriter->status();
+    }
+    useWriter.reset();
+    _linesWritten.fetchAndAdd(written);
+
+    // Pairs with the increment in enqueue(), which is followed by another attempt to push.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_numBlockedProducers.load() > 0) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _spaceAvailable.notify_all();
+    }
+    return status;
+}
+
+void AsyncLogWriter::_run() {
+    setThreadName("AsyncLogWriter");
+    while (true) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_drainMutex);
+            _drain_inlock().ignore();
+        }
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        if (_shutdown) {
+            lk.unlock();
+            stdx::lock_guard<stdx::mutex> drainLock(_drainMutex);
+            _drain_inlock().ignore();
+            return;
+        }
+
+        _consumerSleeping.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!_hasQueuedLine()) {
+            MONGO_IDLE_THREAD_BLOCK;
+            _workAvailable.wait_for(lk, kMaxSleep.toSystemDuration());
+        }
+        _consumerSleeping.store(false);
+    }
+}
+
+}  // namespace logger
+}  // namespace mongo
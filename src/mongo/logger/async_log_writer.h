@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+
+namespace mongo {
+namespace logger {
+
+class RotatableFileWriter;
+
+/**
+ * Writes formatted log lines to a RotatableFileWriter from a background thread, so that threads
+ * which log never wait on the log file.
+ *
+ * Lines pass through a bounded, lock-free multi-producer single-consumer ring buffer. When it is
+ * full, the overflow policy decides whether the logging thread drops its line or waits for space.
+ */
+class AsyncLogWriter {
+    AsyncLogWriter(const AsyncLogWriter&) = delete;
+    AsyncLogWriter& operator=(const AsyncLogWriter&) = delete;
+
+public:
+    enum class OverflowPolicy { kDrop, kBlock };
+
+    struct Stats {
+        long long linesWritten;
+        long long linesDropped;
+        // Number of times a logging thread waited for space under OverflowPolicy::kBlock.
+        long long blockedAppends;
+        size_t queueDepth;
+    };
+
+    /**
+     * Parses "drop" or "block".
+     */
+    static StatusWith<OverflowPolicy> parseOverflowPolicy(StringData policy);
+
+    /**
+     * Starts the background thread. The ring buffer holds "capacity" lines, rounded up to a power
+     * of two. "writer" must outlive this object.
+     */
+    AsyncLogWriter(RotatableFileWriter* writer, size_t capacity, OverflowPolicy policy);
+
+    /**
+     * Writes any queued lines and stops the background thread.
+     */
+    ~AsyncLogWriter();
+
+    /**
+     * Queues "line" for writing. Returns false if the line was dropped because the buffer was full.
+     */
+    bool enqueue(std::string line);
+
+    /**
+     * Writes every queued line and then "line" from the calling thread, so that the line is in the
+     * file when this returns. For messages that must not be lost if the process exits next.
+     */
+    Status writeNow(const std::string& line);
+
+    Stats getStats() const;
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;  // NOLINT
+        std::string line;
+    };
+
+    bool _tryPush(std::string* line);
+    bool _hasQueuedLine() const;
+
+    /**
+     * Writes every queued line to the file. Caller must hold _drainMutex.
+     */
+    Status _drain_inlock();
+
+    void _run();
+
+    RotatableFileWriter* const _writer;
+    const OverflowPolicy _policy;
+    const size_t _mask;
+    std::unique_ptr<Cell[]> _cells;
+
+    alignas(64) std::atomic<size_t> _enqueuePos{0};  // NOLINT
+
+    // Held by whichever thread is taking lines off the buffer: the background thread, or a caller
+    // of writeNow(). _dequeuePos is only written with it held, but is read without it.
+    stdx::mutex _drainMutex;
+    std::atomic<size_t> _dequeuePos{0};  // NOLINT
+
+    // Guards the sleeping and shutdown state below, and is used by waiters on both conditions.
+    stdx::mutex _mutex;
+    stdx::condition_variable _workAvailable;
+    stdx::condition_variable _spaceAvailable;
+    bool _shutdown = false;
+    AtomicWord<bool> _consumerSleeping{false};
+    AtomicWord<int> _numBlockedProducers{0};
+
+    AtomicWord<long long> _linesWritten{0};
+    AtomicWord<long long> _linesDropped{0};
+    AtomicWord<long long> _blockedAppends{0};
+
+    stdx::thread _thread;
+};
+
+}  // namespace logger
+}  // namespace mongo
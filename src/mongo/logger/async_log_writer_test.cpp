@@ -0,0 +1,147 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <fstream>
+
+#include "mongo/logger/async_log_writer.h"
+#include "mongo/logger/rotatable_file_writer.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/str.h"
+#include "mongo/util/time_support.h"
+
+namespace {
+using namespace mongo;
+using namespace mongo::logger;
+
+const std::string logFileName("LogTest_AsyncLogWriter.txt");
+
+class AsyncLogWriterTest : public mongo::unittest::Test {
+public:
+    AsyncLogWriterTest() {
+        unlink(logFileName.c_str());
+        RotatableFileWriter::Use writerUse(&fileWriter);
+        ASSERT_OK(writerUse.setFileName(logFileName, false));
+    }
+
+    virtual ~AsyncLogWriterTest() {
+        unlink(logFileName.c_str());
+    }
+
+    std::vector<std::string> readLines() {
+        std::ifstream ifs(logFileName.c_str());
+        ASSERT_TRUE(ifs.is_open());
+        std::vector<std::string> lines;
+        std::string line;
+        while (std::getline(ifs, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+    RotatableFileWriter fileWriter;
+};
+
+std::string makeLine(int i) {
+    return str::stream() << "line " << i << '\n';
+}
+
+TEST_F(AsyncLogWriterTest, LinesReachFileInOrder) {
+    {
+        AsyncLogWriter writer(&fileWriter, 16, AsyncLogWriter::OverflowPolicy::kBlock);
+        for (int i = 0; i < 1000; ++i) {
+            ASSERT_TRUE(writer.enqueue(makeLine(i)));
+        }
+        ASSERT_OK(writer.writeNow("last\n"));
+        ASSERT_EQ(1001, writer.getStats().linesWritten);
+        ASSERT_EQ(0U, writer.getStats().queueDepth);
+    }
+
+    const auto lines = readLines();
+    ASSERT_EQ(1001U, lines.size());
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQ(str::stream() << "line " << i, lines[i]);
+    }
+    ASSERT_EQ("last", lines.back());
+}
+
+TEST_F(AsyncLogWriterTest, DropPolicyDropsLinesWhileTheFileIsStalled) {
+    const int kLines = 20;
+    long long dropped;
+    {
+        AsyncLogWriter writer(&fileWriter, 4, AsyncLogWriter::OverflowPolicy::kDrop);
+        {
+            // Holding the file stalls the background thread, as a stuck disk would.
+            RotatableFileWriter::Use stall(&fileWriter);
+            for (int i = 0; i < kLines; ++i) {
+                writer.enqueue(makeLine(i));
+            }
+            dropped = writer.getStats().linesDropped;
+
+            // The buffer holds four lines, and the background thread holds at most one more.
+            ASSERT_GTE(dropped, kLines - 5);
+        }
+    }
+    ASSERT_EQ(static_cast<size_t>(kLines - dropped), readLines().size());
+}
+
+TEST_F(AsyncLogWriterTest, BlockPolicyWaitsForSpace) {
+    const int kLines = 20;
+    AsyncLogWriter writer(&fileWriter, 2, AsyncLogWriter::OverflowPolicy::kBlock);
+    stdx::thread producer;
+    {
+        RotatableFileWriter::Use stall(&fileWriter);
+        producer = stdx::thread([&] {
+            for (int i = 0; i < kLines; ++i) {
+                writer.enqueue(makeLine(i));
+            }
+        });
+        while (writer.getStats().blockedAppends == 0) {
+            sleepmillis(1);
+        }
+    }
+    producer.join();
+    ASSERT_OK(writer.writeNow("last\n"));
+
+    const auto lines = readLines();
+    ASSERT_EQ(static_cast<size_t>(kLines + 1), lines.size());
+    ASSERT_EQ(0, writer.getStats().linesDropped);
+}
+
+TEST(AsyncLogWriterPolicyTest, ParseOverflowPolicy) {
+    ASSERT(AsyncLogWriter::OverflowPolicy::kDrop ==
+           AsyncLogWriter::parseOverflowPolicy("drop").getValue());
+    ASSERT(AsyncLogWriter::OverflowPolicy::kBlock ==
+           AsyncLogWriter::parseOverflowPolicy("block").getValue());
+    ASSERT_EQ(ErrorCodes::BadValue, AsyncLogWriter::parseOverflowPolicy("wait").getStatus());
+}
+
+}  // namespace
@@ -34,10 +34,15 @@
 #include "mongo/s/async_requests_sender.h"
 
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/client/replica_set_monitor.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
+#include "mongo/s/hedged_reads.h"
+#include "mongo/s/hedged_reads_gen.h"
+#include "mongo/s/request_coalescer.h"
+#include "mongo/s/request_coalescer_gen.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/transport/baton.h"
 #include "mongo/transport/transport_layer.h"
@@ -52,6 +57,19 @@ namespace {
 // Maximum number of retries for network and replication notMaster errors (per host).
 const int kMaxNumFailedHostRetryAttempts = 3;
 
+/**
+ * Returns true if 'cmdObj' is a read whose duplicate can be canceled without leaving anything
+ * behind on the remote. Commands which may establish a cursor are excluded, because the cursor of
+ * the request that loses the race would stay open on its host until it times out.
+ */
+bool isHedgeableCommand(const BSONObj& cmdObj) {
+    const auto cmdName = cmdObj.firstElementFieldNameStringData();
+    if (cmdName == "count"_sd || cmdName == "distinct"_sd) {
+        return true;
+    }
+    return cmdName == "find"_sd && cmdObj["singleBatch"].trueValue();
+}
+
 }  // namespace
 
 AsyncRequestsSender::AsyncRequestsSender(OperationContext* opCtx,
@@ -64,7 +82,11 @@ AsyncRequestsSender::AsyncRequestsSender(OperationContext* opCtx,
       _executor(executor),
       _db(dbName.toString()),
       _readPreference(readPreference),
-      _retryPolicy(retryPolicy) {
+      _retryPolicy(retryPolicy),
+      _hedgingEnabled(gEnableHedgedReads.load() &&
+                      readPreference.pref == ReadPreference::Nearest &&
+                      readPreference.tags == TagSet() &&
+                      !readPreference.maxStalenessSeconds.count()) {
     for (const auto& request : requests) {
         auto cmdObj = request.cmdObj;
         _remotes.emplace_back(request.shardId, cmdObj);
@@ -85,6 +107,12 @@ AsyncRequestsSender::~AsyncRequestsSender() {
         while (!done()) {
             next();
         }
+
+        // Wait for the callbacks of hedge timers and of requests which lost against their hedged
+        // counterpart, which may still be outstanding after all responses have been returned.
+        while (_hasOutstandingCallbacks()) {
+            _opCtx->runWithoutInterruptionExceptAtGlobalShutdown([&] { _makeProgress(); });
+        }
     } catch (const ExceptionFor<ErrorCodes::InterruptedAtShutdown>&) {
         // Ignore interrupted at shutdown.  No need to cleanup if we're going into process-wide
         // shutdown.
@@ -116,6 +144,24 @@ AsyncRequestsSender::Response AsyncRequestsSender::next() {
     return *readyResponse;
 }
 
+void AsyncRequestsSender::addRequest(const Request& request) {
+    _remotes.emplace_back(request.shardId, request.cmdObj);
+
+    if (!_interruptStatus.isOK()) {
+        _remotes.back().swResponse = _interruptStatus;
+        return;
+    }
+
+    auto scheduleStatus = _scheduleRequest(_remotes.size() - 1);
+    if (!scheduleStatus.isOK()) {
+        _remotes.back().swResponse = std::move(scheduleStatus);
+
+        // Push a noop response to the queue to indicate that a remote is ready for re-processing
+        // due to failure.
+        _responseQueue.producer.push(boost::none);
+    }
+}
+
 void AsyncRequestsSender::stopRetrying() {
     _stopRetrying = true;
 }
@@ -133,9 +179,22 @@ void AsyncRequestsSender::_cancelPendingRequests() {
         if (remote.cbHandle.isValid()) {
             _executor->cancel(remote.cbHandle);
         }
+        if (remote.hedgeCbHandle.isValid()) {
+            _executor->cancel(remote.hedgeCbHandle);
+        }
+        if (remote.hedgeTimerHandle.isValid()) {
+            _executor->cancel(remote.hedgeTimerHandle);
+        }
     }
 }
 
+bool AsyncRequestsSender::_hasOutstandingCallbacks() const {
+    return std::any_of(_remotes.begin(), _remotes.end(), [](const RemoteData& remote) {
+        return remote.cbHandle.isValid() || remote.hedgeCbHandle.isValid() ||
+            remote.hedgeTimerHandle.isValid() || remote.numAbandonedRequests > 0;
+    });
+}
+
 boost::optional<AsyncRequestsSender::Response> AsyncRequestsSender::_ready() {
     if (!_stopRetrying) {
         _scheduleRequests();
@@ -211,7 +270,7 @@ void AsyncRequestsSender::_scheduleRequests() {
         }
 
         // If the remote does not have a response or pending request, schedule remote work for it.
-        if (!remote.swResponse && !remote.cbHandle.isValid()) {
+        if (!remote.swResponse && !remote.cbHandle.isValid() && !remote.hedgeCbHandle.isValid()) {
             auto scheduleStatus = _scheduleRequest(i);
             if (!scheduleStatus.isOK()) {
                 remote.swResponse = std::move(scheduleStatus);
@@ -235,22 +294,189 @@ Status AsyncRequestsSender::_scheduleRequest(size_t remoteIndex) {
         return resolveStatus;
     }
 
+    auto callbackStatus = _isCoalescable(remoteIndex)
+        ? _scheduleCoalescedRemoteCommand(remoteIndex, *remote.shardHostAndPort)
+        : _scheduleRemoteCommand(remoteIndex, *remote.shardHostAndPort);
+    if (!callbackStatus.isOK()) {
+        return callbackStatus.getStatus();
+    }
+
+    remote.cbHandle = callbackStatus.getValue();
+
+    if (_isHedgeable(remoteIndex)) {
+        HedgingMetrics::get(_opCtx->getServiceContext()).numTotalOperations.addAndFetch(1);
+        _scheduleHedgeTimer(remoteIndex);
+    }
+    return Status::OK();
+}
+
+StatusWith<executor::TaskExecutor::CallbackHandle> AsyncRequestsSender::_scheduleRemoteCommand(
+    size_t remoteIndex, const HostAndPort& host) {
     executor::RemoteCommandRequest request(
-        *remote.shardHostAndPort, _db, remote.cmdObj, _metadataObj, _opCtx);
+        host, _db, _remotes[remoteIndex].cmdObj, _metadataObj, _opCtx);
 
-    auto callbackStatus = _executor->scheduleRemoteCommand(
+    return _executor->scheduleRemoteCommand(
         request,
         [ remoteIndex, producer = _responseQueue.producer ](
             const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData) {
             producer.push(Job{cbData, remoteIndex});
         },
         _opCtx->getBaton());
+}
+
+bool AsyncRequestsSender::_isCoalescable(size_t remoteIndex) const {
+    const auto& remote = _remotes[remoteIndex];
+    return gEnableCoalescedShardReads.load() && remote.mayCoalesce &&
+        RequestCoalescer::isCoalescableCommand(remote.cmdObj);
+}
+
+StatusWith<executor::TaskExecutor::CallbackHandle>
+AsyncRequestsSender::_scheduleCoalescedRemoteCommand(size_t remoteIndex, const HostAndPort& host) {
+    executor::RemoteCommandRequest request(
+        host, _db, _remotes[remoteIndex].cmdObj, _metadataObj, _opCtx);
+
+    auto& coalescer = RequestCoalescer::get(_opCtx->getServiceContext());
+    auto key = RequestCoalescer::makeKey(request);
+    auto swFollower = coalescer.join(key, _executor);
+    if (!swFollower.isOK()) {
+        return swFollower.getStatus();
+    }
+
+    auto follower = std::move(swFollower.getValue());
+    if (!follower) {
+        // This is the first such request in flight, so send it and hand its response to any
+        // identical requests which wait for it in the meantime.
+        auto callbackStatus = _executor->scheduleRemoteCommand(
+            request,
+            [ remoteIndex, producer = _responseQueue.producer, &coalescer, key ](
+                const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData) {
+                coalescer.complete(key, cbData.response);
+                producer.push(Job{cbData, remoteIndex});
+            },
+            _opCtx->getBaton());
+        if (!callbackStatus.isOK()) {
+            coalescer.complete(key, callbackStatus.getStatus());
+        }
+        return callbackStatus;
+    }
+
+    return _executor->onEvent(
+        follower->event,
+        [ remoteIndex, producer = _responseQueue.producer, follower, request ](
+            const executor::TaskExecutor::CallbackArgs& args) {
+            if (!args.status.isOK()) {
+                producer.push(Job{executor::TaskExecutor::RemoteCommandCallbackArgs(
+                                      args.executor, args.myHandle, request, args.status),
+                                  remoteIndex});
+                return;
+            }
+
+            if (!follower->response) {
+                producer.push(Job{executor::TaskExecutor::RemoteCommandCallbackArgs(
+                                      args.executor, args.myHandle, request, args.status),
+                                  remoteIndex,
+                                  false,
+                                  true});
+                return;
+            }
+
+            // This request was not sent, so its response time is not recorded for the host.
+            auto response = *follower->response;
+            response.elapsedMillis = boost::none;
+            producer.push(Job{executor::TaskExecutor::RemoteCommandCallbackArgs(
+                                  args.executor, args.myHandle, request, response),
+                              remoteIndex});
+        });
+}
+
+bool AsyncRequestsSender::_isHedgeable(size_t remoteIndex) const {
+    return _hedgingEnabled && isHedgeableCommand(_remotes[remoteIndex].cmdObj);
+}
+
+void AsyncRequestsSender::_scheduleHedgeTimer(size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+
+    // If the timer of a previous attempt was canceled but has not run yet, this attempt is not
+    // hedged.
+    if (remote.hedgeTimerHandle.isValid()) {
+        return;
+    }
+
+    const Milliseconds maxDelay(gHedgedReadsMaxDelayMS.load());
+    const auto percentile = HostLatencyTracker::get(_opCtx->getServiceContext())
+                                .getPercentile(*remote.shardHostAndPort,
+                                               gHedgedReadsDelayPercentile.load());
+    const auto delay = percentile ? std::min(*percentile, maxDelay) : maxDelay;
+
+    auto callbackStatus = _executor->scheduleWorkAt(
+        _executor->now() + delay,
+        [ remoteIndex, producer = _responseQueue.producer ](
+            const executor::TaskExecutor::CallbackArgs& args) {
+            producer.push(Job{boost::none, remoteIndex, args.status.isOK()});
+        });
     if (!callbackStatus.isOK()) {
-        return callbackStatus.getStatus();
+        // The request is simply not hedged.
+        return;
     }
 
-    remote.cbHandle = callbackStatus.getValue();
-    return Status::OK();
+    remote.hedgeTimerHandle = callbackStatus.getValue();
+}
+
+void AsyncRequestsSender::_sendHedgedRequest(size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+
+    auto shard = remote.getShard();
+    if (!shard) {
+        return;
+    }
+
+    boost::optional<HostAndPort> hedgeHost;
+    try {
+        const auto connStr = shard->getTargeter()->connectionString();
+        if (connStr.type() != ConnectionString::SET) {
+            return;
+        }
+
+        auto monitor = ReplicaSetMonitor::get(connStr.getSetName());
+        if (!monitor) {
+            return;
+        }
+
+        // Hosts whose response times are unknown are only chosen if no other host is up.
+        auto& tracker = HostLatencyTracker::get(_opCtx->getServiceContext());
+        const auto percentile = gHedgedReadsDelayPercentile.load();
+        boost::optional<Milliseconds> hedgeHostLatency;
+        for (const auto& host : connStr.getServers()) {
+            if (host == *remote.shardHostAndPort || !monitor->isHostUp(host)) {
+                continue;
+            }
+
+            const auto latency = tracker.getPercentile(host, percentile);
+            if (!hedgeHost || (latency && (!hedgeHostLatency || *latency < *hedgeHostLatency))) {
+                hedgeHost = host;
+                hedgeHostLatency = latency;
+            }
+        }
+    } catch (const DBException& ex) {
+        LOG(1) << "Not hedging request to remote " << remote.shardId << causedBy(redact(ex));
+        return;
+    }
+
+    if (!hedgeHost) {
+        return;
+    }
+
+    auto callbackStatus = _scheduleRemoteCommand(remoteIndex, *hedgeHost);
+    if (!callbackStatus.isOK()) {
+        return;
+    }
+
+    LOG(2) << "Hedging request to remote " << remote.shardId << " at host "
+           << *remote.shardHostAndPort << " by also sending it to " << *hedgeHost;
+
+    remote.hedgeCbHandle = callbackStatus.getValue();
+    remote.hedgeHostAndPort = std::move(hedgeHost);
+    HedgingMetrics::get(_opCtx->getServiceContext()).numTotalHedgedOperations.addAndFetch(1);
 }
 
 // Passing opCtx means you'd like to opt into opCtx interruption.  During cleanup we actually don't.
@@ -262,18 +488,77 @@ void AsyncRequestsSender::_makeProgress() {
     }
 
     auto& remote = _remotes[job->remoteIndex];
+
+    if (!job->cbData) {
+        remote.hedgeTimerHandle = executor::TaskExecutor::CallbackHandle();
+
+        // Only hedge if the request the timer was started for is still waiting for its response.
+        if (job->hedgeTimerExpired && !_stopRetrying && !remote.swResponse &&
+            remote.cbHandle.isValid() && !remote.hedgeCbHandle.isValid()) {
+            _sendHedgedRequest(job->remoteIndex);
+        }
+        return;
+    }
+
+    auto& cbData = *job->cbData;
+    const bool isHedge = remote.hedgeCbHandle.isValid() && cbData.myHandle == remote.hedgeCbHandle;
+    if (!isHedge && !(remote.cbHandle.isValid() && cbData.myHandle == remote.cbHandle)) {
+        // The request lost the race against its hedged counterpart and was canceled.
+        invariant(remote.numAbandonedRequests > 0);
+        --remote.numAbandonedRequests;
+        return;
+    }
+
     invariant(!remote.swResponse);
 
-    // Clear the callback handle. This indicates that we are no longer waiting on a response from
-    // 'remote'.
-    remote.cbHandle = executor::TaskExecutor::CallbackHandle();
+    if (job->mustResend) {
+        // The identical request this one waited for had a response which could not be shared.
+        // Clearing the callback handle makes _scheduleRequests() send the command again.
+        remote.cbHandle = executor::TaskExecutor::CallbackHandle();
+        remote.mayCoalesce = false;
+        return;
+    }
+
+    if (cbData.response.isOK() && cbData.response.elapsedMillis) {
+        HostLatencyTracker::get(_opCtx->getServiceContext())
+            .record(cbData.request.target, *cbData.response.elapsedMillis);
+    }
+
+    // Clear the callback handle. This indicates that we are no longer waiting on this response
+    // from 'remote'.
+    auto& cbHandle = isHedge ? remote.hedgeCbHandle : remote.cbHandle;
+    auto& otherCbHandle = isHedge ? remote.cbHandle : remote.hedgeCbHandle;
+    cbHandle = executor::TaskExecutor::CallbackHandle();
+
+    if (otherCbHandle.isValid()) {
+        // If this request failed, the other one may still succeed.
+        if (!cbData.response.isOK()) {
+            return;
+        }
+
+        _executor->cancel(otherCbHandle);
+        otherCbHandle = executor::TaskExecutor::CallbackHandle();
+        ++remote.numAbandonedRequests;
+    }
+
+    if (remote.hedgeTimerHandle.isValid()) {
+        _executor->cancel(remote.hedgeTimerHandle);
+    }
+
+    if (isHedge) {
+        remote.shardHostAndPort = remote.hedgeHostAndPort;
+        if (cbData.response.isOK()) {
+            HedgingMetrics::get(_opCtx->getServiceContext())
+                .numAdvantageouslyHedgedOperations.addAndFetch(1);
+        }
+    }
 
     // Store the response or error.
-    if (job->cbData.response.status.isOK()) {
-        remote.swResponse = std::move(job->cbData.response);
+    if (cbData.response.status.isOK()) {
+        remote.swResponse = std::move(cbData.response);
     } else {
         // TODO: call participant.markAsCommandSent on "transaction already started" errors?
-        remote.swResponse = std::move(job->cbData.response.status);
+        remote.swResponse = std::move(cbData.response.status);
     }
 }
 
@@ -77,6 +77,14 @@ namespace mongo {
  *     }
  * }
  *
+ * If hedged reads are enabled and the readPreference is 'nearest', a request to a replica set shard
+ * that the chosen host has not answered within an adaptive delay is also sent to a second member
+ * of the set. The first successful response is used and the other request is canceled.
+ *
+ * If coalesced shard reads are enabled, a read which is identical to one already in flight to the
+ * same host, from this or another ARS, waits for that request's response instead of sending its
+ * own. See RequestCoalescer.
+ *
  * Does not throw exceptions.
  */
 class AsyncRequestsSender {
@@ -152,6 +160,13 @@ public:
      */
     Response next();
 
+    /**
+     * Schedules one more request, whose response is returned by next() like those of the requests
+     * the ARS was constructed with. If the operation has already been interrupted, the request is
+     * not sent and its response is the interruption status.
+     */
+    void addRequest(const Request& request);
+
     /**
      * Stops the ARS from retrying requests.
      *
@@ -201,8 +216,26 @@ private:
         // The callback handle to an outstanding request for this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
+        // The callback handle to the timer after which a hedged request is sent for this remote.
+        executor::TaskExecutor::CallbackHandle hedgeTimerHandle;
+
+        // The callback handle to an outstanding hedged request for this remote.
+        executor::TaskExecutor::CallbackHandle hedgeCbHandle;
+
+        // The host to which the hedged request was sent. Is unset until a hedged request has been
+        // sent.
+        boost::optional<HostAndPort> hedgeHostAndPort;
+
+        // The number of requests which lost the race against their hedged counterpart and were
+        // canceled, but whose callbacks have not run yet.
+        int numAbandonedRequests = 0;
+
         // Whether this remote's result has been returned.
         bool done = false;
+
+        // Whether the command may wait for the response of an identical request in flight. Is
+        // cleared once such a response could not be shared.
+        bool mayCoalesce = true;
     };
 
     /**
@@ -210,8 +243,16 @@ private:
      * off thread, and this wraps up the arguments for that call.
      */
     struct Job {
-        executor::TaskExecutor::RemoteCommandCallbackArgs cbData;
+        // Is unset if the job signals that the remote's hedge timer has run.
+        boost::optional<executor::TaskExecutor::RemoteCommandCallbackArgs> cbData;
         size_t remoteIndex;
+
+        // For hedge timer jobs, whether the timer expired rather than being canceled.
+        bool hedgeTimerExpired = false;
+
+        // For requests which waited for an identical request in flight, whether that request's
+        // response could not be shared, so that the command has to be sent again.
+        bool mustResend = false;
     };
 
     /**
@@ -248,6 +289,49 @@ private:
      */
     Status _scheduleRequest(size_t remoteIndex);
 
+    /**
+     * Schedules the command of the remote at 'remoteIndex' to run on 'host'.
+     */
+    StatusWith<executor::TaskExecutor::CallbackHandle> _scheduleRemoteCommand(
+        size_t remoteIndex, const HostAndPort& host);
+
+    /**
+     * Returns true if the command of the remote at 'remoteIndex' may share the response of an
+     * identical request.
+     */
+    bool _isCoalescable(size_t remoteIndex) const;
+
+    /**
+     * Schedules the command of the remote at 'remoteIndex' to run on 'host', unless an identical
+     * request is already in flight, in which case it waits for that request's response instead.
+     */
+    StatusWith<executor::TaskExecutor::CallbackHandle> _scheduleCoalescedRemoteCommand(
+        size_t remoteIndex, const HostAndPort& host);
+
+    /**
+     * Returns true if the command of the remote at 'remoteIndex' may be hedged.
+     */
+    bool _isHedgeable(size_t remoteIndex) const;
+
+    /**
+     * Schedules the timer after which a hedged request is sent for the remote at 'remoteIndex'.
+     * The delay is a percentile of the recent response times of the host the request was sent to.
+     */
+    void _scheduleHedgeTimer(size_t remoteIndex);
+
+    /**
+     * Sends the command of the remote at 'remoteIndex' to a second member of the shard's replica
+     * set, preferring the member with the lowest recent response times. Does nothing if there is
+     * no other member which is up.
+     */
+    void _sendHedgedRequest(size_t remoteIndex);
+
+    /**
+     * Returns true if any callback scheduled by this ARS has not run yet, including those of
+     * hedge timers and of abandoned requests.
+     */
+    bool _hasOutstandingCallbacks() const;
+
     /**
      * Waits for forward progress in gathering responses from a remote.
      *
@@ -272,6 +356,9 @@ private:
     // The policy to use when deciding whether to retry on an error.
     Shard::RetryPolicy _retryPolicy;
 
+    // Whether hedged reads were enabled and are allowed by the readPreference.
+    bool _hedgingEnabled = false;
+
     // Is set to a non-OK status if the client operation is interrupted.
     // When waiting for a remote to be ready, we only check for interrupt if the _interruptStatus
     // has not already been set to an error (so we can wait for callbacks for (canceled) outstanding
@@ -462,6 +462,29 @@ void CatalogCache::report(BSONObjBuilder* builder) const {
     cacheStatsBuilder.append("numCollectionEntries", static_cast<long long>(numCollectionEntries));
 
     _stats.report(&cacheStatsBuilder);
+
+    // Per-collection refresh statistics, for the collections which have been refreshed at least
+    // once.
+    BSONObjBuilder collectionsBuilder(cacheStatsBuilder.subobjStart("collections"));
+    stdx::lock_guard<stdx::mutex> ul(_mutex);
+    for (const auto& dbEntry : _collectionsByDb) {
+        for (const auto& collEntry : dbEntry.second) {
+            const auto& entry = *collEntry.second;
+            const auto countRefreshes = entry.countRefreshes.load();
+            if (!countRefreshes) {
+                continue;
+            }
+
+            BSONObjBuilder collBuilder(collectionsBuilder.subobjStart(collEntry.first));
+            collBuilder.append("countRefreshes", countRefreshes);
+            collBuilder.append("lastRefreshTimeMicros", entry.lastRefreshTimeMicros.load());
+            collBuilder.append("totalRefreshTimeMicros", entry.totalRefreshTimeMicros.load());
+            if (entry.routingInfo) {
+                collBuilder.append("numChunks",
+                                   static_cast<long long>(entry.routingInfo->getChunkMap().size()));
+            }
+        }
+    }
 }
 
 void CatalogCache::_scheduleDatabaseRefresh(WithLock,
@@ -557,8 +580,14 @@ void CatalogCache::_scheduleCollectionRefresh(WithLock lk,
     }
 
     // Invoked when one iteration of getChunksSince has completed, whether with success or error
-    const auto onRefreshCompleted = [ this, t = Timer(), nss, isIncremental, existingRoutingInfo ](
-        const Status& status, RoutingTableHistory* routingInfoAfterRefresh) {
+    const auto onRefreshCompleted =
+        [ this, t = Timer(), collEntry, nss, isIncremental, existingRoutingInfo ](
+            const Status& status, RoutingTableHistory* routingInfoAfterRefresh) {
+        const auto refreshTimeMicros = t.micros();
+        collEntry->countRefreshes.addAndFetch(1);
+        collEntry->lastRefreshTimeMicros.store(refreshTimeMicros);
+        collEntry->totalRefreshTimeMicros.addAndFetch(refreshTimeMicros);
+
         if (isIncremental) {
             _stats.numActiveIncrementalRefreshes.subtractAndFetch(1);
         } else {
@@ -268,6 +268,11 @@ private:
 
         // Contains the cached routing information (only available if needsRefresh is false)
         std::shared_ptr<RoutingTableHistory> routingInfo;
+
+        // Refresh statistics for this collection, reported in serverStatus
+        AtomicWord<long long> countRefreshes{0};
+        AtomicWord<long long> lastRefreshTimeMicros{0};
+        AtomicWord<long long> totalRefreshTimeMicros{0};
     };
 
     /**
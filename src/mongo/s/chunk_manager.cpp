@@ -70,6 +70,121 @@ std::string extractKeyStringInternal(const BSONObj& shardKeyValue, Ordering orde
 
 }  // namespace
 
+constexpr size_t ChunkInfoMap::kTargetBlockSize;
+
+ChunkInfoMap::ChunkInfoMap(std::vector<value_type> sortedEntries) : _size(sortedEntries.size()) {
+    for (size_t first = 0; first < sortedEntries.size(); first += kTargetBlockSize) {
+        const size_t last = std::min(first + kTargetBlockSize, sortedEntries.size());
+        _blocks.push_back(
+            std::make_shared<Block>(std::make_move_iterator(sortedEntries.begin() + first),
+                                    std::make_move_iterator(sortedEntries.begin() + last)));
+    }
+}
+
+ChunkInfoMap::const_iterator ChunkInfoMap::upper_bound(const std::string& key) const {
+    const auto blockIt = std::upper_bound(
+        _blocks.begin(),
+        _blocks.end(),
+        key,
+        [](const std::string& k, const std::shared_ptr<Block>& block) {
+            return k < block->back().first;
+        });
+    if (blockIt == _blocks.end()) {
+        return end();
+    }
+
+    const auto& block = **blockIt;
+    const auto it = std::upper_bound(
+        block.begin(), block.end(), key, [](const std::string& k, const value_type& entry) {
+            return k < entry.first;
+        });
+    return {&_blocks, size_t(blockIt - _blocks.begin()), size_t(it - block.begin())};
+}
+
+ChunkInfoMap::const_iterator ChunkInfoMap::lower_bound(const std::string& key) const {
+    const auto blockIt = std::lower_bound(
+        _blocks.begin(),
+        _blocks.end(),
+        key,
+        [](const std::shared_ptr<Block>& block, const std::string& k) {
+            return block->back().first < k;
+        });
+    if (blockIt == _blocks.end()) {
+        return end();
+    }
+
+    const auto& block = **blockIt;
+    const auto it = std::lower_bound(
+        block.begin(), block.end(), key, [](const value_type& entry, const std::string& k) {
+            return entry.first < k;
+        });
+    return {&_blocks, size_t(blockIt - _blocks.begin()), size_t(it - block.begin())};
+}
+
+void ChunkInfoMap::insert(value_type entry) {
+    if (_blocks.empty()) {
+        _blocks.push_back(std::make_shared<Block>(1, std::move(entry)));
+        _size = 1;
+        return;
+    }
+
+    // Insert into the first block whose largest key is not less than the new one, or append to
+    // the last block if the new key sorts after every existing one.
+    auto blockIndex = size_t(lower_bound(entry.first)._block);
+    if (blockIndex == _blocks.size()) {
+        --blockIndex;
+    }
+
+    auto& block = _mutableBlock(blockIndex);
+    const auto it = std::lower_bound(
+        block.begin(), block.end(), entry.first, [](const value_type& e, const std::string& k) {
+            return e.first < k;
+        });
+    if (it != block.end() && it->first == entry.first) {
+        return;
+    }
+    block.insert(it, std::move(entry));
+    ++_size;
+
+    if (block.size() > 2 * kTargetBlockSize) {
+        auto upperHalf = std::make_shared<Block>(
+            std::make_move_iterator(block.begin() + block.size() / 2),
+            std::make_move_iterator(block.end()));
+        block.erase(block.begin() + block.size() / 2, block.end());
+        _blocks.insert(_blocks.begin() + blockIndex + 1, std::move(upperHalf));
+    }
+}
+
+void ChunkInfoMap::erase(const_iterator first, const_iterator last) {
+    const size_t lastBlock = std::min(last._block, _blocks.size() - 1);
+    for (size_t blockIndex = first._block; blockIndex <= lastBlock && blockIndex < _blocks.size();
+         ++blockIndex) {
+        const size_t begin = (blockIndex == first._block) ? first._pos : 0;
+        const size_t end =
+            (blockIndex == last._block) ? last._pos : _blocks[blockIndex]->size();
+        if (begin < end) {
+            auto& block = _mutableBlock(blockIndex);
+            block.erase(block.begin() + begin, block.begin() + end);
+            _size -= end - begin;
+        }
+    }
+
+    // Iterators rely on every block being non-empty.
+    const auto rangeEnd = _blocks.begin() + std::min(last._block + 1, _blocks.size());
+    _blocks.erase(std::remove_if(_blocks.begin() + first._block,
+                                 rangeEnd,
+                                 [](const auto& block) { return block->empty(); }),
+                  rangeEnd);
+}
+
+ChunkInfoMap::Block& ChunkInfoMap::_mutableBlock(size_t index) {
+    auto& block = _blocks[index];
+    if (block.use_count() > 1) {
+        block = std::make_shared<Block>(*block);
+    }
+    return *block;
+}
+
 RoutingTableHistory::RoutingTableHistory(NamespaceString nss,
                                          boost::optional<UUID> uuid,
                                          KeyPattern shardKeyPattern,
@@ -449,18 +564,19 @@ ShardVersionMap RoutingTableHistory::_constructShardVersionMap() const {
 
         // Check the continuity of the chunks map
         if (lastMax && !SimpleBSONObjComparator::kInstance.evaluate(*lastMax == rangeMin)) {
+            const auto& lastChunk = _chunkMap.lower_bound(_extractKeyString(*lastMax))->second;
             if (SimpleBSONObjComparator::kInstance.evaluate(*lastMax < rangeMin))
                 uasserted(ErrorCodes::ConflictingOperationInProgress,
                           str::stream()
                               << "Gap exists in the routing table between chunks "
-                              << _chunkMap.at(_extractKeyString(*lastMax))->getRange().toString()
+                              << lastChunk->getRange().toString()
                               << " and "
                               << rangeLast->second->getRange().toString());
             else
                 uasserted(ErrorCodes::ConflictingOperationInProgress,
                           str::stream()
                               << "Overlap exists in the routing table between chunks "
-                              << _chunkMap.at(_extractKeyString(*lastMax))->getRange().toString()
+                              << lastChunk->getRange().toString()
                               << " and "
                               << rangeLast->second->getRange().toString());
         }
@@ -513,60 +629,77 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
     const std::vector<ChunkType>& changedChunks) {
 
     const auto startingCollectionVersion = getVersion();
-    auto chunkMap = _chunkMap;
 
     ChunkVersion collectionVersion = startingCollectionVersion;
-    for (const auto& chunk : changedChunks) {
-        const auto& chunkVersion = chunk.getVersion();
-
-        uassert(ErrorCodes::ConflictingOperationInProgress,
-                str::stream() << "Chunk " << chunk.genID(getns(), chunk.getMin())
-                              << " has epoch different from that of the collection "
-                              << chunkVersion.epoch(),
-                collectionVersion.epoch() == chunkVersion.epoch());
-
-        // Chunks must always come in incrementally sorted order
-        invariant(chunkVersion >= collectionVersion);
-        collectionVersion = chunkVersion;
-
-        const auto chunkMinKeyString = _extractKeyString(chunk.getMin());
-        const auto chunkMaxKeyString = _extractKeyString(chunk.getMax());
-
-        // Returns the first chunk with a max key that is > min - implies that the chunk overlaps
-        // min
-        const auto low = chunkMap.upper_bound(chunkMinKeyString);
-
-        // Returns the first chunk with a max key that is > max - implies that the next chunk cannot
-        // not overlap max
-        const auto high = chunkMap.upper_bound(chunkMaxKeyString);
-
-        // If we are in the middle of splitting a chunk, for the first few
-        // chunks inserted, low == high, because both lookups will point to the
-        // same chunk (the one being split). If we're inserting the last chunk
-        // for the current chunk being split, low will point to the chunk that
-        // we're splitting, and high will point to the next chunk past the one
-        // we're splitting (which could be chunkMap.end()). In this case,
-        // std::distance(low, high) == 1. Lastly, this does not apply during
-        // the creation of the original routing table, in which case the map is
-        // empty and the first chunk that is inserted will find that low ==
-        // high, but low == chunkMap.end(), and we aren't doing a split in that
-        // case.
-        auto foundSingleChunk =
-            ((low == high || std::distance(low, high) == 1) && low != chunkMap.end());
-
-        auto newChunk = std::make_shared<ChunkInfo>(chunk);
-        if (foundSingleChunk) {
-            auto chunkBeingReplacedBySplit = low->second;
-            auto bytesInReplacedChunk =
-                chunkBeingReplacedBySplit->getWritesTracker()->getBytesWritten();
-            newChunk->getWritesTracker()->addBytesWritten(bytesInReplacedChunk);
-        }
+    const auto applyChanges = [&](auto& chunkMap) {
+        for (const auto& chunk : changedChunks) {
+            const auto& chunkVersion = chunk.getVersion();
+
+            uassert(ErrorCodes::ConflictingOperationInProgress,
+                    str::stream() << "Chunk " << chunk.genID(getns(), chunk.getMin())
+                                  << " has epoch different from that of the collection "
+                                  << chunkVersion.epoch(),
+                    collectionVersion.epoch() == chunkVersion.epoch());
+
+            // Chunks must always come in incrementally sorted order
+            invariant(chunkVersion >= collectionVersion);
+            collectionVersion = chunkVersion;
+
+            const auto chunkMinKeyString = _extractKeyString(chunk.getMin());
+            const auto chunkMaxKeyString = _extractKeyString(chunk.getMax());
+
+            // Returns the first chunk with a max key that is > min - implies that the chunk
+            // overlaps min
+            const auto low = chunkMap.upper_bound(chunkMinKeyString);
+
+            // Returns the first chunk with a max key that is > max - implies that the next chunk
+            // cannot not overlap max
+            const auto high = chunkMap.upper_bound(chunkMaxKeyString);
+
+            // If we are in the middle of splitting a chunk, for the first few
+            // chunks inserted, low == high, because both lookups will point to the
+            // same chunk (the one being split). If we're inserting the last chunk
+            // for the current chunk being split, low will point to the chunk that
+            // we're splitting, and high will point to the next chunk past the one
+            // we're splitting (which could be chunkMap.end()). In this case,
+            // std::distance(low, high) == 1. Lastly, this does not apply during
+            // the creation of the original routing table, in which case the map is
+            // empty and the first chunk that is inserted will find that low ==
+            // high, but low == chunkMap.end(), and we aren't doing a split in that
+            // case.
+            auto foundSingleChunk =
+                ((low == high || std::distance(low, high) == 1) && low != chunkMap.end());
+
+            auto newChunk = std::make_shared<ChunkInfo>(chunk);
+            if (foundSingleChunk) {
+                auto chunkBeingReplacedBySplit = low->second;
+                auto bytesInReplacedChunk =
+                    chunkBeingReplacedBySplit->getWritesTracker()->getBytesWritten();
+                newChunk->getWritesTracker()->addBytesWritten(bytesInReplacedChunk);
+            }
 
-        // Erase all chunks from the map, which overlap the chunk we got from the persistent store
-        chunkMap.erase(low, high);
+            // Erase all chunks from the map, which overlap the chunk we got from the persistent
+            // store
+            chunkMap.erase(low, high);
 
-        // Insert only the chunk itself
-        chunkMap.insert(std::make_pair(chunkMaxKeyString, newChunk));
+            // Insert only the chunk itself
+            chunkMap.insert(std::make_pair(chunkMaxKeyString, newChunk));
+        }
+    };
+
+    // A full load inserts every chunk, in version rather than key order, so it is applied to an
+    // ordered map which is then packed into the routing table's blocks. An incremental refresh
+    // modifies a copy of the current routing table, which shares all the blocks except those
+    // containing changed chunks.
+    ChunkInfoMap chunkMap;
+    if (_chunkMap.empty()) {
+        std::map<std::string, std::shared_ptr<ChunkInfo>> orderedChunkMap;
+        applyChanges(orderedChunkMap);
+        chunkMap = ChunkInfoMap(std::vector<ChunkInfoMap::value_type>(orderedChunkMap.begin(),
+                                                                      orderedChunkMap.end()));
+    } else {
+        chunkMap = _chunkMap;
+        applyChanges(chunkMap);
     }
 
     // If at least one diff was applied, the metadata is correct, but it might not have changed so
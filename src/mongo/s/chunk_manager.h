@@ -49,8 +49,138 @@ struct QuerySolutionNode;
 class OperationContext;
 class ChunkManager;
 
-// Ordered map from the max for each chunk to an entry describing the chunk
-using ChunkInfoMap = std::map<std::string, std::shared_ptr<ChunkInfo>>;
+/**
+ * Ordered map from the KeyString-encoded max of each chunk to an entry describing the chunk.
+ *
+ * The entries are stored sorted in contiguous blocks, which are shared between copies of the map
+ * and only copied when a copy is modified. Copying the map therefore costs one pointer per block,
+ * and applying an incremental refresh to a copy only duplicates the blocks holding changed chunks,
+ * while lookups remain binary searches over contiguous memory.
+ *
+ * A map which is shared between threads must not be modified.
+ */
+class ChunkInfoMap {
+public:
+    using value_type = std::pair<std::string, std::shared_ptr<ChunkInfo>>;
+
+private:
+    using Block = std::vector<value_type>;
+    using Blocks = std::vector<std::shared_ptr<Block>>;
+
+public:
+    class const_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = ChunkInfoMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        const_iterator() = default;
+
+        reference operator*() const {
+            return (*(*_blocks)[_block])[_pos];
+        }
+        pointer operator->() const {
+            return &**this;
+        }
+
+        const_iterator& operator++() {
+            if (++_pos == (*_blocks)[_block]->size()) {
+                ++_block;
+                _pos = 0;
+            }
+            return *this;
+        }
+        const_iterator operator++(int) {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+        const_iterator& operator--() {
+            if (_pos == 0) {
+                --_block;
+                _pos = (*_blocks)[_block]->size();
+            }
+            --_pos;
+            return *this;
+        }
+        const_iterator operator--(int) {
+            auto result = *this;
+            --*this;
+            return result;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return _block == other._block && _pos == other._pos;
+        }
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        friend class ChunkInfoMap;
+
+        const_iterator(const Blocks* blocks, size_t block, size_t pos)
+            : _blocks(blocks), _block(block), _pos(pos) {}
+
+        const Blocks* _blocks{nullptr};
+        size_t _block{0};
+        size_t _pos{0};
+    };
+
+    ChunkInfoMap() = default;
+
+    /**
+     * Builds a map from entries which are already sorted by key and contain no duplicates.
+     */
+    explicit ChunkInfoMap(std::vector<value_type> sortedEntries);
+
+    const_iterator begin() const {
+        return {&_blocks, 0, 0};
+    }
+    const_iterator end() const {
+        return {&_blocks, _blocks.size(), 0};
+    }
+    const_iterator cbegin() const {
+        return begin();
+    }
+    const_iterator cend() const {
+        return end();
+    }
+
+    size_t size() const {
+        return _size;
+    }
+    bool empty() const {
+        return _size == 0;
+    }
+
+    const_iterator upper_bound(const std::string& key) const;
+    const_iterator lower_bound(const std::string& key) const;
+
+    /**
+     * Inserts 'entry' unless an entry with the same key already exists.
+     */
+    void insert(value_type entry);
+
+    /**
+     * Removes the entries in ['first', 'last'). Invalidates all iterators into the map.
+     */
+    void erase(const_iterator first, const_iterator last);
+
+private:
+    // Blocks are split in two once they grow past twice this size.
+    static constexpr size_t kTargetBlockSize = 128;
+
+    /**
+     * Returns the block at 'index', first copying it if it is shared with another map.
+     */
+    Block& _mutableBlock(size_t index);
+
+    Blocks _blocks;
+    size_t _size{0};
+};
 
 // Map from a shard is to the max chunk version on that shard
 using ShardVersionMap = std::map<ShardId, ChunkVersion>;
@@ -246,6 +246,33 @@ void BM_FindIntersectingChunk(benchmark::State& state,
     state.SetItemsProcessed(state.iterations());
 }
 
+template <typename CollectionMetadataBuilderFn>
+void BM_RouteDocuments(benchmark::State& state,
+                       CollectionMetadataBuilderFn makeCollectionMetadata) {
+    const int nShards = state.range(0);
+    const int nChunks = state.range(1);
+    constexpr int kBatchSize = 1000;
+
+    auto cm = makeCollectionMetadata(nShards, nChunks);
+    const auto& shardKeyPattern = cm->getChunkManager()->getShardKeyPattern();
+
+    std::vector<BSONObj> docs;
+    for (const auto& key : makeKeys(nChunks)) {
+        docs.emplace_back(BSON("_id" << key["_id"] << "x" << 1));
+    }
+    auto docsIter = makeCircularIterator(docs);
+
+    for (auto keepRunning : state) {
+        for (int i = 0; i < kBatchSize; ++i, ++docsIter) {
+            const auto shardKey = shardKeyPattern.extractShardKeyFromDoc(*docsIter);
+            benchmark::DoNotOptimize(
+                cm->getChunkManager()->findIntersectingChunkWithSimpleCollation(shardKey));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+
 template <typename CollectionMetadataBuilderFn>
 void BM_GetShardIdsForRange(benchmark::State& state,
                             CollectionMetadataBuilderFn makeCollectionMetadata) {
@@ -350,6 +377,20 @@ MONGO_INITIALIZER(RegisterBenchmarks)(InitializerContext* context) {
             ->Args({2, 2});
     }
 
+    // Routing throughput against large routing tables.
+    std::initializer_list<benchmark::internal::Benchmark*> routingCases{
+        REGISTER_BENCHMARK_CAPTURE(
+            BM_RouteDocuments, Pessimal, makeChunkManagerWithPessimalBalancedDistribution),
+        REGISTER_BENCHMARK_CAPTURE(
+            BM_RouteDocuments, Optimal, makeChunkManagerWithOptimalBalancedDistribution),
+        REGISTER_BENCHMARK_CAPTURE(
+            BM_FindIntersectingChunk, Large, makeChunkManagerWithOptimalBalancedDistribution),
+    };
+
+    for (auto bmCase : routingCases) {
+        bmCase->Args({10, 50000})->Args({100, 500000})->Args({1000, 1000000});
+    }
+
     return Status::OK();
 }
 
@@ -35,13 +35,39 @@
 
 #include "mongo/s/chunk_writes_tracker.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
+ChunkWritesTracker::ChunkWritesTracker()
+    : _random(static_cast<int64_t>(curTimeMicros64() ^ reinterpret_cast<uintptr_t>(this))) {}
+
 uint64_t ChunkWritesTracker::clearBytesWritten() {
     return _bytesWritten.swap(0);
 }
 
+void ChunkWritesTracker::addSampledKey(const BSONObj& shardKey) {
+    stdx::lock_guard<stdx::mutex> lk(_sampleMutex);
+
+    const auto numKeysOffered = ++_numKeysOffered;
+    if (_sampledKeys.size() < kMaxSampledKeys) {
+        _sampledKeys.push_back(shardKey.getOwned());
+        return;
+    }
+
+    // Keep the new key with probability kMaxSampledKeys / numKeysOffered, in place of a random one
+    // of the keys already sampled.
+    const auto slot = static_cast<uint64_t>(_random.nextInt64()) % numKeysOffered;
+    if (slot < kMaxSampledKeys) {
+        _sampledKeys[slot] = shardKey.getOwned();
+    }
+}
+
+std::vector<BSONObj> ChunkWritesTracker::getSampledKeys() {
+    stdx::lock_guard<stdx::mutex> lk(_sampleMutex);
+    return _sampledKeys;
+}
+
 bool ChunkWritesTracker::shouldSplit(uint64_t maxChunkSize) {
     if (_isLockedForSplitting) {
         return false;
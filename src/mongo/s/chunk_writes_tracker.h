@@ -29,7 +29,11 @@
 
 #pragma once
 
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/platform/random.h"
 #include "mongo/stdx/mutex.h"
 
 namespace mongo {
@@ -42,6 +46,13 @@ public:
      */
     static constexpr uint64_t kSplitTestFactor = 5;
 
+    /**
+     * The maximum number of shard keys kept in the sample of keys written to the chunk.
+     */
+    static constexpr size_t kMaxSampledKeys = 256;
+
+    ChunkWritesTracker();
+
     /**
      * Add more bytes written to the chunk.
      */
@@ -62,6 +73,17 @@ public:
      */
     uint64_t clearBytesWritten();
 
+    /**
+     * Offers the shard key of a document written to the chunk to a uniform random sample of the
+     * written shard keys, which can be used to choose split points without scanning the chunk.
+     */
+    void addSampledKey(const BSONObj& shardKey);
+
+    /**
+     * Returns a copy of the sample of shard keys written to the chunk.
+     */
+    std::vector<BSONObj> getSampledKeys();
+
     /**
      * Returns whether or not this chunk is ready to be split based on the
      * maximum allowable size of a chunk.
@@ -95,6 +117,26 @@ private:
      * Whether or not a current split is in progress for this chunk.
      */
     bool _isLockedForSplitting{false};
+
+    /**
+     * Protects the sample of written shard keys and the state used to maintain it.
+     */
+    stdx::mutex _sampleMutex;
+
+    /**
+     * The number of shard keys which have been offered to the sample.
+     */
+    uint64_t _numKeysOffered{0};
+
+    /**
+     * Reservoir sample of at most kMaxSampledKeys of the shard keys offered so far.
+     */
+    std::vector<BSONObj> _sampledKeys;
+
+    /**
+     * Source of randomness for choosing which sampled keys to replace.
+     */
+    PseudoRandom _random;
 };
 
 }  // namespace mongo
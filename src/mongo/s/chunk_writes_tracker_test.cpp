@@ -31,6 +31,7 @@
 
 #include "mongo/s/chunk_writes_tracker.h"
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
 
@@ -144,6 +145,45 @@ TEST(ChunkWritesTrackerTest, AcquireSplitLockThenReleaseThenReacquireReturnsTrue
     ASSERT_TRUE(wt.acquireSplitLock());
 }
 
+TEST(ChunkWritesTrackerTest, SampledKeysStartEmpty) {
+    ChunkWritesTracker wt;
+    ASSERT(wt.getSampledKeys().empty());
+}
+
+TEST(ChunkWritesTrackerTest, SampleKeepsEveryKeyUntilFull) {
+    ChunkWritesTracker wt;
+    for (int i = 0; i < 10; ++i) {
+        wt.addSampledKey(BSON("x" << i));
+    }
+
+    const auto sampledKeys = wt.getSampledKeys();
+    ASSERT_EQ(10U, sampledKeys.size());
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_BSONOBJ_EQ(BSON("x" << i), sampledKeys[i]);
+    }
+}
+
+TEST(ChunkWritesTrackerTest, SampleIsBoundedAndDrawnFromOfferedKeys) {
+    ChunkWritesTracker wt;
+    const int numKeys = 10 * ChunkWritesTracker::kMaxSampledKeys;
+    for (int i = 0; i < numKeys; ++i) {
+        wt.addSampledKey(BSON("x" << i));
+    }
+
+    const auto sampledKeys = wt.getSampledKeys();
+    ASSERT_EQ(ChunkWritesTracker::kMaxSampledKeys, sampledKeys.size());
+
+    // Some of the keys offered after the sample filled up have replaced earlier ones.
+    bool sampledLaterKey = false;
+    for (const auto& key : sampledKeys) {
+        const int x = key["x"].numberInt();
+        ASSERT_GTE(x, 0);
+        ASSERT_LT(x, numKeys);
+        sampledLaterKey |= x >= static_cast<int>(ChunkWritesTracker::kMaxSampledKeys);
+    }
+    ASSERT(sampledLaterKey);
+}
+
 DEATH_TEST(ChunkWritesTrackerTest, ReleaseSplitLockWithoutAcquiringErrors, "Invariant failure") {
     ChunkWritesTracker wt;
     wt.releaseSplitLock();
@@ -186,6 +186,25 @@ boost::optional<WouldChangeOwningShardInfo> getWouldChangeOwningShardErrorInfo(
  * document. If the delete and insert succeed, modifies the response object to reflect that we
  * successfully updated one document.
  */
+/**
+ * Reports how many child batches were sent to each shard and how long they took to come back.
+ */
+void appendShardRoundTrips(const BatchWriteExecStats& stats, BSONObjBuilder* result) {
+    if (stats.getShardRoundTrips().empty()) {
+        return;
+    }
+
+    BSONArrayBuilder roundTripsBuilder(result->subarrayStart("shardRoundTrips"));
+    for (auto&& entry : stats.getShardRoundTrips()) {
+        const auto& roundTrips = entry.second;
+        BSONObjBuilder shardBuilder(roundTripsBuilder.subobjStart());
+        shardBuilder.append("shard", entry.first.toString());
+        shardBuilder.append("batches", roundTrips.numBatches);
+        shardBuilder.append("totalMicros", durationCount<Microseconds>(roundTrips.totalTime));
+        shardBuilder.append("maxMicros", durationCount<Microseconds>(roundTrips.maxTime));
+    }
+}
+
 bool updateShardKeyValue(OperationContext* opCtx,
                          const BatchedCommandRequest& request,
                          BatchedCommandResponse* response,
@@ -497,6 +516,7 @@ private:
         }
 
         result.appendElements(response.toBSON());
+        appendShardRoundTrips(stats, &result);
         return response.getOk();
     }
 
@@ -90,6 +90,13 @@ namespace {
 
 const auto kOperationTime = "operationTime"_sd;
 
+/**
+ * Returns whether 'commandName' may use read concern snapshot outside of a transaction.
+ */
+bool isNonTransactionalSnapshotReadCommand(StringData commandName) {
+    return commandName == "find"_sd || commandName == "aggregate"_sd;
+}
+
 /**
  * Extract and process metadata from the command request body.
  */
@@ -261,8 +268,10 @@ void execCommandClient(OperationContext* opCtx,
     auto& readConcernArgs = repl::ReadConcernArgs::get(opCtx);
     if (readConcernArgs.getLevel() == repl::ReadConcernLevel::kSnapshotReadConcern) {
         uassert(ErrorCodes::InvalidOptions,
-                "read concern snapshot is only supported in a multi-statement transaction",
-                TransactionRouter::get(opCtx));
+                "read concern snapshot is only supported in a multi-statement transaction or "
+                "for find and aggregate",
+                TransactionRouter::get(opCtx) ||
+                    isNonTransactionalSnapshotReadCommand(c->getName()));
     }
 
     // attach tracking
@@ -277,6 +286,16 @@ void execCommandClient(OperationContext* opCtx,
         return;
     }
 
+    // Outside of a transaction, choose the snapshot once so that every shard targeted by the read,
+    // and every batch of its cursors, sees the same point in time. The shards reject the read
+    // unless they have 'enableNonTransactionalSnapshotReads' set.
+    if (readConcernArgs.getLevel() == repl::ReadConcernLevel::kSnapshotReadConcern &&
+        !TransactionRouter::get(opCtx) && !readConcernArgs.getArgsAtClusterTime()) {
+        stdx::lock_guard<Client> lk(*opCtx->getClient());
+        readConcernArgs.setArgsAtClusterTimeForSnapshot(
+            LogicalClock::get(opCtx)->getClusterTime().asTimestamp());
+    }
+
     auto txnRouter = TransactionRouter::get(opCtx);
     if (!supportsWriteConcern) {
         if (txnRouter) {
@@ -401,8 +420,10 @@ void runCommand(OperationContext* opCtx,
                               << commandName,
                 invocation->supportsReadConcern(readConcernArgs.getLevel()));
         uassert(ErrorCodes::InvalidOptions,
-                "read concern snapshot is not supported with atClusterTime on mongos",
-                !readConcernArgs.getArgsAtClusterTime());
+                "read concern snapshot is not supported with atClusterTime in a transaction on "
+                "mongos",
+                !readConcernArgs.getArgsAtClusterTime() ||
+                    (!osi.getAutocommit() && isNonTransactionalSnapshotReadCommand(commandName)));
     }
 
     boost::optional<RouterOperationContextSession> routerSession;
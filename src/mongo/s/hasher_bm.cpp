@@ -0,0 +1,112 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/hasher.h"
+#include "mongo/s/shard_key_pattern.h"
+
+namespace mongo {
+namespace {
+
+std::vector<BSONObj> makeDocs(size_t numDocs) {
+    std::vector<BSONObj> docs;
+    docs.reserve(numDocs);
+    for (size_t i = 0; i < numDocs; ++i) {
+        docs.push_back(BSON("_id" << OID::gen() << "x" << static_cast<long long>(i) << "payload"
+                                  << "abcdefghijklmnopqrstuvwxyz"));
+    }
+    return docs;
+}
+
+void BM_HashElements(benchmark::State& state) {
+    const auto docs = makeDocs(state.range(0));
+    std::vector<BSONElement> elements;
+    for (const auto& doc : docs) {
+        elements.push_back(doc["_id"]);
+    }
+
+    for (auto _ : state) {
+        for (const auto& element : elements) {
+            benchmark::DoNotOptimize(
+                BSONElementHasher::hash64(element, BSONElementHasher::DEFAULT_HASH_SEED));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * elements.size());
+}
+
+void BM_HashElementsBatch(benchmark::State& state) {
+    const auto docs = makeDocs(state.range(0));
+    std::vector<BSONElement> elements;
+    for (const auto& doc : docs) {
+        elements.push_back(doc["_id"]);
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(
+            BSONElementHasher::hash64Batch(elements, BSONElementHasher::DEFAULT_HASH_SEED));
+    }
+    state.SetItemsProcessed(state.iterations() * elements.size());
+}
+
+// The per-document cost of extracting the hashed shard key when targeting an insert batch.
+void BM_ExtractHashedShardKey(benchmark::State& state) {
+    const ShardKeyPattern shardKeyPattern(BSON("_id"
+                                               << "hashed"));
+    const auto docs = makeDocs(state.range(0));
+
+    for (auto _ : state) {
+        for (const auto& doc : docs) {
+            benchmark::DoNotOptimize(shardKeyPattern.extractShardKeyFromDoc(doc));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * docs.size());
+}
+
+void BM_ExtractHashedShardKeysBatch(benchmark::State& state) {
+    const ShardKeyPattern shardKeyPattern(BSON("_id"
+                                               << "hashed"));
+    const auto docs = makeDocs(state.range(0));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(shardKeyPattern.extractShardKeysFromDocs(docs));
+    }
+    state.SetItemsProcessed(state.iterations() * docs.size());
+}
+
+BENCHMARK(BM_HashElements)->Arg(1)->Arg(64)->Arg(1000);
+BENCHMARK(BM_HashElementsBatch)->Arg(1)->Arg(64)->Arg(1000);
+BENCHMARK(BM_ExtractHashedShardKey)->Arg(1)->Arg(64)->Arg(1000);
+BENCHMARK(BM_ExtractHashedShardKeysBatch)->Arg(1)->Arg(64)->Arg(1000);
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,90 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/hedged_reads.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+namespace {
+
+const auto getHostLatencyTracker = ServiceContext::declareDecoration<HostLatencyTracker>();
+const auto getHedgingMetrics = ServiceContext::declareDecoration<HedgingMetrics>();
+
+}  // namespace
+
+HostLatencyTracker& HostLatencyTracker::get(ServiceContext* serviceContext) {
+    return getHostLatencyTracker(serviceContext);
+}
+
+void HostLatencyTracker::record(const HostAndPort& host, Milliseconds latency) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto& latencies = _latencies[host];
+    latencies.push_back(latency);
+    if (latencies.size() > kMaxSamplesPerHost) {
+        latencies.pop_front();
+    }
+}
+
+boost::optional<Milliseconds> HostLatencyTracker::getPercentile(const HostAndPort& host,
+                                                                int percentile) const {
+    std::vector<Milliseconds> latencies;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+        auto it = _latencies.find(host);
+        if (it == _latencies.end() || it->second.size() < kMinSamplesPerHost) {
+            return boost::none;
+        }
+        latencies.assign(it->second.begin(), it->second.end());
+    }
+
+    const auto rank = std::min(latencies.size() - 1, latencies.size() * percentile / 100);
+    std::nth_element(latencies.begin(), latencies.begin() + rank, latencies.end());
+    return latencies[rank];
+}
+
+HedgingMetrics& HedgingMetrics::get(ServiceContext* serviceContext) {
+    return getHedgingMetrics(serviceContext);
+}
+
+void HedgingMetrics::report(BSONObjBuilder* builder) const {
+    builder->append("numTotalOperations", numTotalOperations.load());
+    builder->append("numTotalHedgedOperations", numTotalHedgedOperations.load());
+    builder->append("numAdvantageouslyHedgedOperations", numAdvantageouslyHedgedOperations.load());
+}
+
+}  // namespace mongo
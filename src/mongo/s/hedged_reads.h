@@ -0,0 +1,96 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <deque>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/duration.h"
+#include "mongo/util/net/hostandport.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class ServiceContext;
+
+/**
+ * Remembers the response times of the most recent requests mongos sent to each remote host, so
+ * that hedged reads can wait about as long as a host usually takes to answer before hedging.
+ *
+ * Is thread safe.
+ */
+class HostLatencyTracker {
+public:
+    // The number of most recent response times remembered per host.
+    static constexpr size_t kMaxSamplesPerHost = 128;
+
+    // Percentiles are not computed for hosts with fewer response times than this.
+    static constexpr size_t kMinSamplesPerHost = 16;
+
+    static HostLatencyTracker& get(ServiceContext* serviceContext);
+
+    /**
+     * Records the time 'host' took to answer a request.
+     */
+    void record(const HostAndPort& host, Milliseconds latency);
+
+    /**
+     * Returns the given percentile of the recent response times of 'host', or boost::none if too
+     * few responses from it have been recorded.
+     */
+    boost::optional<Milliseconds> getPercentile(const HostAndPort& host, int percentile) const;
+
+private:
+    mutable stdx::mutex _mutex;
+    stdx::unordered_map<HostAndPort, std::deque<Milliseconds>> _latencies;
+};
+
+/**
+ * Counts hedged reads, reported in serverStatus.
+ */
+struct HedgingMetrics {
+    static HedgingMetrics& get(ServiceContext* serviceContext);
+
+    void report(BSONObjBuilder* builder) const;
+
+    // Requests which were eligible for hedging.
+    AtomicWord<long long> numTotalOperations{0};
+
+    // Requests for which a hedged request was sent to a second host.
+    AtomicWord<long long> numTotalHedgedOperations{0};
+
+    // Hedged requests which were answered before the original request.
+    AtomicWord<long long> numAdvantageouslyHedgedOperations{0};
+};
+
+}  // namespace mongo
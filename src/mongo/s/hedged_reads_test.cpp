@@ -0,0 +1,92 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/hedged_reads.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/service_context.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(HostLatencyTrackerTest, NoPercentileUntilEnoughLatenciesAreRecorded) {
+    auto serviceContext = ServiceContext::make();
+    auto& tracker = HostLatencyTracker::get(serviceContext.get());
+    const HostAndPort host("a", 1);
+
+    ASSERT_FALSE(tracker.getPercentile(host, 95));
+    for (size_t i = 1; i < HostLatencyTracker::kMinSamplesPerHost; ++i) {
+        tracker.record(host, Milliseconds(1));
+    }
+    ASSERT_FALSE(tracker.getPercentile(host, 95));
+
+    tracker.record(host, Milliseconds(1));
+    ASSERT_EQ(Milliseconds(1), *tracker.getPercentile(host, 95));
+    ASSERT_FALSE(tracker.getPercentile(HostAndPort("b", 1), 95));
+}
+
+TEST(HostLatencyTrackerTest, PercentilesOfRecentLatencies) {
+    auto serviceContext = ServiceContext::make();
+    auto& tracker = HostLatencyTracker::get(serviceContext.get());
+    const HostAndPort host("a", 1);
+
+    for (int i = 0; i < 100; ++i) {
+        tracker.record(host, Milliseconds(i));
+    }
+    ASSERT_EQ(Milliseconds(50), *tracker.getPercentile(host, 50));
+    ASSERT_EQ(Milliseconds(95), *tracker.getPercentile(host, 95));
+    ASSERT_EQ(Milliseconds(99), *tracker.getPercentile(host, 99));
+
+    // Only the most recent latencies are remembered.
+    for (size_t i = 0; i < HostLatencyTracker::kMaxSamplesPerHost; ++i) {
+        tracker.record(host, Milliseconds(500));
+    }
+    ASSERT_EQ(Milliseconds(500), *tracker.getPercentile(host, 1));
+}
+
+TEST(HedgingMetricsTest, Report) {
+    auto serviceContext = ServiceContext::make();
+    auto& metrics = HedgingMetrics::get(serviceContext.get());
+    metrics.numTotalOperations.addAndFetch(3);
+    metrics.numTotalHedgedOperations.addAndFetch(2);
+    metrics.numAdvantageouslyHedgedOperations.addAndFetch(1);
+
+    BSONObjBuilder builder;
+    metrics.report(&builder);
+    ASSERT_BSONOBJ_EQ(BSON("numTotalOperations" << 3LL << "numTotalHedgedOperations" << 2LL
+                                                << "numAdvantageouslyHedgedOperations"
+                                                << 1LL),
+                      builder.obj());
+}
+
+}  // namespace
+}  // namespace mongo
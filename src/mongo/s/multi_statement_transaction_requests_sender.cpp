@@ -31,17 +31,52 @@
 
 #include "mongo/s/multi_statement_transaction_requests_sender.h"
 
+#include "mongo/db/repl/read_concern_args.h"
 #include "mongo/s/transaction_router.h"
 
 namespace mongo {
 
 namespace {
 
+/**
+ * Outside of a transaction, a snapshot read carries the atClusterTime chosen by the router on its
+ * read concern so that every shard reads at the same point in time.
+ */
+std::vector<AsyncRequestsSender::Request> attachSnapshotTime(
+    OperationContext* opCtx, const std::vector<AsyncRequestsSender::Request>& requests) {
+    const auto& readConcernArgs = repl::ReadConcernArgs::get(opCtx);
+    if (readConcernArgs.getLevel() != repl::ReadConcernLevel::kSnapshotReadConcern ||
+        !readConcernArgs.getArgsAtClusterTime()) {
+        return requests;
+    }
+
+    std::vector<AsyncRequestsSender::Request> newRequests;
+    newRequests.reserve(requests.size());
+
+    for (auto request : requests) {
+        if (!request.cmdObj.hasField(repl::ReadConcernArgs::kReadConcernFieldName)) {
+            newRequests.push_back(request);
+            continue;
+        }
+
+        BSONObjBuilder cmdBob;
+        for (auto&& elem : request.cmdObj) {
+            if (elem.fieldNameStringData() != repl::ReadConcernArgs::kReadConcernFieldName) {
+                cmdBob.append(elem);
+            }
+        }
+        readConcernArgs.appendInfo(&cmdBob);
+        newRequests.emplace_back(request.shardId, cmdBob.obj());
+    }
+
+    return newRequests;
+}
+
 std::vector<AsyncRequestsSender::Request> attachTxnDetails(
     OperationContext* opCtx, const std::vector<AsyncRequestsSender::Request>& requests) {
     auto txnRouter = TransactionRouter::get(opCtx);
     if (!txnRouter) {
-        return requests;
+        return attachSnapshotTime(opCtx, requests);
     }
 
     std::vector<AsyncRequestsSender::Request> newRequests;
@@ -92,6 +127,11 @@ AsyncRequestsSender::Response MultiStatementTransactionRequestsSender::next() {
     return response;
 }
 
+void MultiStatementTransactionRequestsSender::addRequest(
+    const AsyncRequestsSender::Request& request) {
+    _ars.addRequest(attachTxnDetails(_opCtx, {request}).front());
+}
+
 void MultiStatementTransactionRequestsSender::stopRetrying() {
     _ars.stopRetrying();
 }
@@ -33,14 +33,18 @@
 
 #include "mongo/s/query/async_results_merger.h"
 
+#include <limits>
+
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/client/remote_command_targeter.h"
 #include "mongo/db/pipeline/change_stream_constants.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/killcursors_request.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
+#include "mongo/s/query/async_results_merger_knobs_gen.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 
@@ -79,6 +83,18 @@ int compareSortKeys(BSONObj leftSortKey, BSONObj rightSortKey, BSONObj sortKeyPa
     return leftSortKey.woCompare(rightSortKey, sortKeyPattern, considerFieldName);
 }
 
+/**
+ * Returns the ordering with which sort keys are encoded as KeyStrings, or boost::none if the merge
+ * is unsorted or the sort pattern has more fields than a KeyString ordering can describe.
+ */
+boost::optional<Ordering> makeSortKeyOrdering(const AsyncResultsMergerParams& params) {
+    const auto& sort = params.getSort();
+    if (!sort || static_cast<size_t>(sort->nFields()) > Ordering::kMaxCompoundIndexKeys) {
+        return boost::none;
+    }
+    return Ordering::make(*sort);
+}
+
 }  // namespace
 
 AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
@@ -91,8 +107,11 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
       // since that is not supported we treat boost::none (unspecified) to mean 'kNormal'.
       _tailableMode(params.getTailableMode().value_or(TailableModeEnum::kNormal)),
       _params(std::move(params)),
-      _mergeQueue(MergingComparator(
-          _remotes, _params.getSort().value_or(BSONObj()), _params.getCompareWholeSortKey())),
+      _sortKeyOrdering(makeSortKeyOrdering(_params)),
+      _mergeQueue(MergingComparator(_remotes,
+                                    _params.getSort().value_or(BSONObj()),
+                                    _params.getCompareWholeSortKey(),
+                                    static_cast<bool>(_sortKeyOrdering))),
       _promisedMinSortKeys(PromisedMinSortKeyComparator(_params.getSort().value_or(BSONObj()))) {
     if (params.getTxnNumber()) {
         invariant(params.getSessionId());
@@ -161,6 +180,7 @@ bool AsyncResultsMerger::ready() {
 
 void AsyncResultsMerger::detachFromOperationContext() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _prefetchNextBatches(lk);
     _opCtx = nullptr;
     // If we were about ready to return a boost::none because a tailable cursor reached the end of
     // the batch, that should no longer apply to the next use - when we are reattached to a
@@ -290,7 +310,7 @@ StatusWith<ClusterQueryResult> AsyncResultsMerger::nextReady() {
     return _params.getSort() ? _nextReadySorted(lk) : _nextReadyUnsorted(lk);
 }
 
-ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
+ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock lk) {
     // Tailable non-awaitData cursors cannot have a sort.
     invariant(_tailableMode != TailableModeEnum::kTailable);
 
@@ -299,18 +319,20 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
     }
 
     size_t smallestRemote = _mergeQueue.top();
-    _mergeQueue.pop();
 
     invariant(!_remotes[smallestRemote].docBuffer.empty());
     invariant(_remotes[smallestRemote].status.isOK());
 
     ClusterQueryResult front = _remotes[smallestRemote].docBuffer.front();
     _remotes[smallestRemote].docBuffer.pop();
+    _remotes[smallestRemote].bufferedBytes -= front.getResult()->objsize();
 
-    // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
-    // next result.
+    // Keep 'smallestRemote' in the merge with its next result, if it has a next result.
     if (!_remotes[smallestRemote].docBuffer.empty()) {
-        _mergeQueue.push(smallestRemote);
+        _encodeFrontSortKey(lk, smallestRemote);
+        _mergeQueue.replaceTop();
+    } else {
+        _mergeQueue.pop();
     }
 
     // For sorted tailable awaitData cursors, update the high water mark to the document's sort key.
@@ -331,6 +353,7 @@ ClusterQueryResult AsyncResultsMerger::_nextReadyUnsorted(WithLock) {
         if (_remotes[_gettingFromRemote].hasNext()) {
             ClusterQueryResult front = _remotes[_gettingFromRemote].docBuffer.front();
             _remotes[_gettingFromRemote].docBuffer.pop();
+            _remotes[_gettingFromRemote].bufferedBytes -= front.getResult()->objsize();
 
             if (_tailableMode == TailableModeEnum::kTailable &&
                 !_remotes[_gettingFromRemote].hasNext()) {
@@ -412,6 +435,38 @@ Status AsyncResultsMerger::_askForNextBatch(WithLock, size_t remoteIndex) {
     return Status::OK();
 }
 
+void AsyncResultsMerger::_prefetchNextBatches(WithLock lk) {
+    if (!_opCtx || _lifecycleState != kAlive || _tailableMode != TailableModeEnum::kNormal) {
+        return;
+    }
+
+    // An exhaust stream issues the next getMore as soon as this one's reply is sent, so without an
+    // explicit budget each drained remote is asked for exactly one batch ahead.
+    auto prefetchBytes = internalQueryCursorPrefetchBytes.load();
+    if (prefetchBytes <= 0 && _opCtx->isExhaust()) {
+        prefetchBytes = std::numeric_limits<long long>::max();
+    }
+    if (prefetchBytes <= 0) {
+        return;
+    }
+
+    long long bufferedBytes = 0;
+    for (const auto& remote : _remotes) {
+        if (!remote.status.isOK()) {
+            return;
+        }
+        bufferedBytes += remote.bufferedBytes;
+    }
+
+    for (size_t i = 0; i < _remotes.size() && bufferedBytes < prefetchBytes; ++i) {
+        auto& remote = _remotes[i];
+        if (!remote.hasNext() && !remote.exhausted() && !remote.cbHandle.isValid()) {
+            // A failure to schedule the getMore is reported by the next call to ready().
+            remote.status = _askForNextBatch(lk, i);
+        }
+    }
+}
+
 Status AsyncResultsMerger::scheduleGetMores() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     return _scheduleGetMores(lk);
@@ -592,6 +647,7 @@ void AsyncResultsMerger::_cleanUpFailedBatch(WithLock lk, Status status, size_t
         // Clear the results buffer and cursor id.
         std::queue<ClusterQueryResult> emptyBuffer;
         std::swap(remote.docBuffer, emptyBuffer);
+        remote.bufferedBytes = 0;
         remote.cursorId = 0;
     }
 }
@@ -669,12 +725,14 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
 
         ClusterQueryResult result(obj);
         remote.docBuffer.push(result);
+        remote.bufferedBytes += obj.objsize();
         ++remote.fetchedCount;
     }
 
     // If we're doing a sorted merge, then we have to make sure to put this remote onto the merge
     // queue.
     if (_params.getSort() && !response.getBatch().empty()) {
+        _encodeFrontSortKey(lk, remoteIndex);
         _mergeQueue.push(remoteIndex);
     }
     return true;
@@ -782,17 +840,95 @@ bool AsyncResultsMerger::RemoteCursorData::exhausted() const {
     return cursorId == 0;
 }
 
+void AsyncResultsMerger::_encodeFrontSortKey(WithLock, size_t remoteIndex) {
+    if (!_sortKeyOrdering) {
+        return;
+    }
+
+    auto& remote = _remotes[remoteIndex];
+    const auto sortKey = extractSortKey(*remote.docBuffer.front().getResult(),
+                                        _params.getCompareWholeSortKey());
+    KeyString ks(KeyString::Version::V1, sortKey, *_sortKeyOrdering);
+    remote.frontSortKey.assign(ks.getBuffer(), ks.getSize());
+}
+
 //
 // AsyncResultsMerger::MergingComparator
 //
 
-bool AsyncResultsMerger::MergingComparator::operator()(const size_t& lhs, const size_t& rhs) {
+bool AsyncResultsMerger::MergingComparator::operator()(const size_t& lhs,
+                                                       const size_t& rhs) const {
+    if (_compareEncodedSortKeys) {
+        return _remotes[lhs].frontSortKey < _remotes[rhs].frontSortKey;
+    }
+
     const ClusterQueryResult& leftDoc = _remotes[lhs].docBuffer.front();
     const ClusterQueryResult& rightDoc = _remotes[rhs].docBuffer.front();
 
     return compareSortKeys(extractSortKey(*leftDoc.getResult(), _compareWholeSortKey),
                            extractSortKey(*rightDoc.getResult(), _compareWholeSortKey),
-                           _sort) > 0;
+                           _sort) < 0;
+}
+
+//
+// AsyncResultsMerger::MergingTournament
+//
+
+constexpr size_t AsyncResultsMerger::MergingTournament::kNone;
+
+void AsyncResultsMerger::MergingTournament::push(size_t remoteIndex) {
+    if (remoteIndex >= _numLeaves) {
+        // Grow to the next power of two which can hold 'remoteIndex' and rebuild the internal
+        // nodes from the remotes which are already present.
+        size_t numLeaves = std::max(_numLeaves, size_t{1});
+        while (numLeaves <= remoteIndex) {
+            numLeaves *= 2;
+        }
+
+        std::vector<size_t> nodes(2 * numLeaves, kNone);
+        for (size_t i = 0; i < _numLeaves; ++i) {
+            nodes[numLeaves + i] = _nodes[_numLeaves + i];
+        }
+        for (size_t node = numLeaves - 1; node >= 1; --node) {
+            nodes[node] = _winner(nodes[2 * node], nodes[2 * node + 1]);
+        }
+
+        _numLeaves = numLeaves;
+        _nodes = std::move(nodes);
+    }
+
+    invariant(_nodes[_numLeaves + remoteIndex] == kNone);
+    _replay(remoteIndex, true);
+}
+
+void AsyncResultsMerger::MergingTournament::pop() {
+    invariant(!empty());
+    _replay(top(), false);
+}
+
+void AsyncResultsMerger::MergingTournament::replaceTop() {
+    invariant(!empty());
+    _replay(top(), true);
+}
+
+void AsyncResultsMerger::MergingTournament::_replay(size_t remoteIndex, bool present) {
+    size_t node = _numLeaves + remoteIndex;
+    _nodes[node] = present ? remoteIndex : kNone;
+    for (node /= 2; node >= 1; node /= 2) {
+        _nodes[node] = _winner(_nodes[2 * node], _nodes[2 * node + 1]);
+    }
+}
+
+size_t AsyncResultsMerger::MergingTournament::_winner(size_t lhs, size_t rhs) const {
+    if (lhs == kNone) {
+        return rhs;
+    }
+    if (rhs == kNone) {
+        return lhs;
+    }
+
+    // On ties, prefer the remote with the lower index so the merge order is deterministic.
+    return _comparator(rhs, lhs) ? rhs : lhs;
 }
 
 bool AsyncResultsMerger::PromisedMinSortKeyComparator::operator()(
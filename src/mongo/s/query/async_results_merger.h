@@ -30,11 +30,14 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <limits>
 #include <queue>
+#include <string>
 #include <vector>
 
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/ordering.h"
 #include "mongo/db/cursor_id.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/s/query/async_results_merger_params_gen.h"
@@ -123,7 +126,9 @@ public:
 
     /**
      * Signals to the AsyncResultsMerger that the caller is finished using it in the current
-     * context.
+     * context. If 'internalQueryCursorPrefetchBytes' is set, or the current request is part of an
+     * exhaust stream, first asks for the next batch from the remotes whose buffered results have
+     * been used up.
      */
     void detachFromOperationContext();
 
@@ -292,6 +297,10 @@ private:
         // The buffer of results that have been retrieved but not yet returned to the caller.
         std::queue<ClusterQueryResult> docBuffer;
 
+        // The KeyString encoding of the sort key of the result at the front of 'docBuffer'. Only
+        // maintained for sorted merges whose sort pattern can be encoded as a KeyString.
+        std::string frontSortKey;
+
         // Is valid if there is currently a pending request to this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
@@ -302,16 +311,26 @@ private:
         // Count of fetched docs during ARM processing of the current batch. Used to reduce the
         // batchSize in getMore when mongod returned less docs than the requested batchSize.
         long long fetchedCount = 0;
+
+        // The total size of the results in 'docBuffer'.
+        long long bufferedBytes = 0;
     };
 
+    /**
+     * Returns true if the next result of remote 'lhs' sorts before the next result of remote 'rhs'.
+     */
     class MergingComparator {
     public:
         MergingComparator(const std::vector<RemoteCursorData>& remotes,
                           const BSONObj& sort,
-                          bool compareWholeSortKey)
-            : _remotes(remotes), _sort(sort), _compareWholeSortKey(compareWholeSortKey) {}
+                          bool compareWholeSortKey,
+                          bool compareEncodedSortKeys)
+            : _remotes(remotes),
+              _sort(sort),
+              _compareWholeSortKey(compareWholeSortKey),
+              _compareEncodedSortKeys(compareEncodedSortKeys) {}
 
-        bool operator()(const size_t& lhs, const size_t& rhs);
+        bool operator()(const size_t& lhs, const size_t& rhs) const;
 
     private:
         const std::vector<RemoteCursorData>& _remotes;
@@ -322,6 +341,62 @@ private:
         // We extract the sort key {$sortKey: <value>}. The sort key pattern '_sort' is verified to
         // be {$sortKey: 1}.
         const bool _compareWholeSortKey;
+
+        // When true, remotes are compared using the KeyString encoded 'frontSortKey' of each
+        // remote instead of by extracting and comparing the BSON sort keys.
+        const bool _compareEncodedSortKeys;
+    };
+
+    /**
+     * Tournament tree over the remotes which have a buffered result, used to pick the remote whose
+     * next result sorts first. Each internal node holds the winner of the two subtrees below it,
+     * so adding or removing a remote, or changing the next result of one, replays a single
+     * leaf-to-root path with one comparison per level.
+     */
+    class MergingTournament {
+    public:
+        explicit MergingTournament(MergingComparator comparator)
+            : _comparator(std::move(comparator)) {}
+
+        bool empty() const {
+            return _nodes.empty() || _nodes[1] == kNone;
+        }
+
+        /**
+         * Returns the remote whose next result sorts first. Must not be empty.
+         */
+        size_t top() const {
+            return _nodes[1];
+        }
+
+        /**
+         * Adds 'remoteIndex', which must not already be in the tournament.
+         */
+        void push(size_t remoteIndex);
+
+        /**
+         * Removes the remote returned by top().
+         */
+        void pop();
+
+        /**
+         * Re-evaluates the position of the remote returned by top() after its next result changed.
+         */
+        void replaceTop();
+
+    private:
+        static constexpr size_t kNone = std::numeric_limits<size_t>::max();
+
+        void _replay(size_t remoteIndex, bool present);
+
+        size_t _winner(size_t lhs, size_t rhs) const;
+
+        MergingComparator _comparator;
+
+        // Number of leaves, always a power of two. Leaf 'i' is stored at '_nodes[_numLeaves + i]'
+        // and the children of node 'n' are nodes '2n' and '2n + 1', with the root at index 1.
+        size_t _numLeaves = 0;
+        std::vector<size_t> _nodes;
     };
 
     using MinSortKeyRemoteIdPair = std::pair<BSONObj, size_t>;
@@ -435,11 +510,25 @@ private:
      */
     Status _scheduleGetMores(WithLock);
 
+    /**
+     * Called before detaching from the OperationContext. If cursor prefetching is enabled or the
+     * operation is part of an exhaust stream, asks for the next batch from each remote whose buffer
+     * is empty, so that the batch is there by the time the next getMore needs it. Stops once the
+     * buffered results reach the prefetch budget.
+     */
+    void _prefetchNextBatches(WithLock);
+
     /**
      * Schedules a killCursors command to be run on all remote hosts that have open cursors.
      */
     void _scheduleKillCursors(WithLock, OperationContext* opCtx);
 
+    /**
+     * Encodes the sort key of the result at the front of the given remote's buffer into its
+     * 'frontSortKey', if sort keys are compared in their KeyString encoding.
+     */
+    void _encodeFrontSortKey(WithLock, size_t remoteIndex);
+
     /**
      * Updates the given remote's metadata (e.g. the cursor id) based on information in 'response'.
      */
@@ -456,9 +545,13 @@ private:
     // Data tracking the state of our communication with each of the remote nodes.
     std::vector<RemoteCursorData> _remotes;
 
-    // The top of this priority queue is the index into '_remotes' for the remote host that has the
+    // Ordering used to encode sort keys as KeyStrings, which can then be compared with memcmp. Not
+    // set if there is no sort, or if the sort pattern has too many fields to be encoded.
+    boost::optional<Ordering> _sortKeyOrdering;
+
+    // The top of this tournament is the index into '_remotes' for the remote host that has the
     // next document to return, according to the sort order. Used only if there is a sort.
-    std::priority_queue<size_t, std::vector<size_t>, MergingComparator> _mergeQueue;
+    MergingTournament _mergeQueue;
 
     // The index into '_remotes' for the remote from which we are currently retrieving results.
     // Used only if there is *not* a sort.
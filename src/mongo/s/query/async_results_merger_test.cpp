@@ -39,11 +39,13 @@
 #include "mongo/db/query/query_request.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/s/client/shard_registry.h"
+#include "mongo/s/query/async_results_merger_knobs_gen.h"
 #include "mongo/s/query/results_merger_test_fixture.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -443,6 +445,44 @@ TEST_F(AsyncResultsMergerTest, CompoundSortKey) {
     ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
 }
 
+TEST_F(AsyncResultsMergerTest, SortKeysOfMixedTypesAreMergedInBSONOrder) {
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {a: 1, b: -1}}");
+    std::vector<BSONObj> batch1 = {fromjson("{$sortKey: {'': null, '': 1}}"),
+                                   fromjson("{$sortKey: {'': 2, '': 3}}"),
+                                   fromjson("{$sortKey: {'': 'abc', '': 1}}")};
+    std::vector<BSONObj> batch2 = {fromjson("{$sortKey: {'': 1.5, '': 0}}"),
+                                   fromjson("{$sortKey: {'': 2.0, '': 2}}"),
+                                   fromjson("{$sortKey: {'': 'ab', '': 0}}")};
+    std::vector<BSONObj> batch3 = {BSON("$sortKey" << BSON("" << MINKEY << "" << 0)),
+                                   BSON("$sortKey" << BSON("" << 2LL << "" << 1)),
+                                   BSON("$sortKey" << BSON("" << BSON("x" << 1) << "" << 0))};
+    std::vector<RemoteCursor> cursors;
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 0, batch1)));
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[1], kTestShardHosts[1], CursorResponse(kTestNss, 0, batch2)));
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[2], kTestShardHosts[2], CursorResponse(kTestNss, 0, batch3)));
+    auto arm = makeARMFromExistingCursors(std::move(cursors), findCmd);
+
+    std::vector<BSONObj> expected = {BSON("$sortKey" << BSON("" << MINKEY << "" << 0)),
+                                     fromjson("{$sortKey: {'': null, '': 1}}"),
+                                     fromjson("{$sortKey: {'': 1.5, '': 0}}"),
+                                     fromjson("{$sortKey: {'': 2, '': 3}}"),
+                                     fromjson("{$sortKey: {'': 2.0, '': 2}}"),
+                                     BSON("$sortKey" << BSON("" << 2LL << "" << 1)),
+                                     fromjson("{$sortKey: {'': 'ab', '': 0}}"),
+                                     fromjson("{$sortKey: {'': 'abc', '': 1}}"),
+                                     BSON("$sortKey" << BSON("" << BSON("x" << 1) << "" << 0))};
+    for (const auto& obj : expected) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_BSONOBJ_EQ(obj, *unittest::assertGet(arm->nextReady()).getResult());
+    }
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
 TEST_F(AsyncResultsMergerTest, SortedButNoSortKey) {
     BSONObj findCmd = fromjson("{find: 'testcoll', sort: {a: -1, b: 1}}");
     std::vector<RemoteCursor> cursors;
@@ -2007,5 +2047,101 @@ TEST_F(AsyncResultsMergerTest, ShouldNotScheduleGetMoresWithoutAnOperationContex
     executor()->waitForEvent(killedEvent);
 }
 
+TEST_F(AsyncResultsMergerTest, PrefetchesNextBatchesWhenDetachedFromOperationContext) {
+    const auto oldPrefetchBytes = internalQueryCursorPrefetchBytes.load();
+    internalQueryCursorPrefetchBytes.store(1024 * 1024);
+    ON_BLOCK_EXIT([&] { internalQueryCursorPrefetchBytes.store(oldPrefetchBytes); });
+
+    std::vector<RemoteCursor> cursors;
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 1, {fromjson("{_id: 1}")})));
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[1], kTestShardHosts[1], CursorResponse(kTestNss, 2, {fromjson("{_id: 2}")})));
+    auto arm = makeARMFromExistingCursors(std::move(cursors));
+
+    // Hand out the first shard's results only.
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 1}"), *unittest::assertGet(arm->nextReady()).getResult());
+
+    // Once the batch has been handed out, the next batch is requested from the first shard, whose
+    // buffer is empty, but not from the second shard, which still has a result buffered.
+    arm->detachFromOperationContext();
+    {
+        std::vector<CursorResponse> responses;
+        std::vector<BSONObj> batch = {fromjson("{_id: 3}")};
+        responses.emplace_back(kTestNss, CursorId(0), batch);
+        scheduleNetworkResponses(std::move(responses));
+    }
+    ASSERT_FALSE(networkHasReadyRequests());
+
+    // The next getMore is served from the buffers without waiting on a shard.
+    arm->reattachToOperationContext(operationContext());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 3}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 2}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_FALSE(arm->ready());
+
+    auto killedEvent = arm->kill(operationContext());
+    executor()->waitForEvent(killedEvent);
+}
+
+TEST_F(AsyncResultsMergerTest, DoesNotPrefetchPastTheBudget) {
+    const auto oldPrefetchBytes = internalQueryCursorPrefetchBytes.load();
+    internalQueryCursorPrefetchBytes.store(1);
+    ON_BLOCK_EXIT([&] { internalQueryCursorPrefetchBytes.store(oldPrefetchBytes); });
+
+    std::vector<RemoteCursor> cursors;
+    cursors.push_back(
+        makeRemoteCursor(kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 1, {})));
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[1], kTestShardHosts[1], CursorResponse(kTestNss, 2, {fromjson("{_id: 2}")})));
+    auto arm = makeARMFromExistingCursors(std::move(cursors));
+
+    // The result buffered for the second shard already exceeds the budget.
+    arm->detachFromOperationContext();
+    ASSERT_FALSE(networkHasReadyRequests());
+
+    arm->reattachToOperationContext(operationContext());
+    auto killedEvent = arm->kill(operationContext());
+    executor()->waitForEvent(killedEvent);
+}
+
+TEST_F(AsyncResultsMergerTest, PrefetchesOneBatchAheadForExhaustGetMores) {
+    ASSERT_EQ(0, internalQueryCursorPrefetchBytes.load());
+    operationContext()->setExhaust(true);
+    ON_BLOCK_EXIT([&] { operationContext()->setExhaust(false); });
+
+    std::vector<RemoteCursor> cursors;
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(kTestNss, 1, {fromjson("{_id: 1}")})));
+    cursors.push_back(makeRemoteCursor(
+        kTestShardIds[1], kTestShardHosts[1], CursorResponse(kTestNss, 2, {fromjson("{_id: 2}")})));
+    auto arm = makeARMFromExistingCursors(std::move(cursors));
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 1}"), *unittest::assertGet(arm->nextReady()).getResult());
+
+    // Without a prefetch budget, an exhaust getMore still asks the drained shard for its next
+    // batch so that it is in flight while the reply is streamed to the client.
+    arm->detachFromOperationContext();
+    {
+        std::vector<CursorResponse> responses;
+        std::vector<BSONObj> batch = {fromjson("{_id: 3}")};
+        responses.emplace_back(kTestNss, CursorId(0), batch);
+        scheduleNetworkResponses(std::move(responses));
+    }
+    ASSERT_FALSE(networkHasReadyRequests());
+
+    arm->reattachToOperationContext(operationContext());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 3}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 2}"), *unittest::assertGet(arm->nextReady()).getResult());
+
+    auto killedEvent = arm->kill(operationContext());
+    executor()->waitForEvent(killedEvent);
+}
+
 }  // namespace
 }  // namespace mongo
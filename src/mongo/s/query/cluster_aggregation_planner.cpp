@@ -31,6 +31,9 @@
 
 #include "mongo/s/query/cluster_aggregation_planner.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/document_source_limit.h"
 #include "mongo/db/pipeline/document_source_match.h"
@@ -440,6 +443,31 @@ boost::optional<ShardedExchangePolicy> walkPipelineBackwardsTrackingShardKey(
     return ShardedExchangePolicy{std::move(exchangeSpec), std::move(consumerShards)};
 }
 
+/**
+ * The most consumers an $exchange accepts.
+ */
+const size_t kMaxGroupMergeExchangeConsumers = 100;
+
+/**
+ * Returns 'numConsumers' + 1 points which split the space of 64-bit hashes into 'numConsumers'
+ * ranges of equal width, starting at MinKey and ending at MaxKey.
+ */
+std::vector<BSONObj> makeEvenHashBoundaries(StringData fieldName, size_t numConsumers) {
+    // 2^64 / 'numConsumers', rounded up.
+    const auto step = std::numeric_limits<unsigned long long>::max() / numConsumers + 1;
+    const auto lowest = static_cast<unsigned long long>(std::numeric_limits<long long>::min());
+
+    std::vector<BSONObj> boundaries;
+    boundaries.emplace_back(BSON(fieldName << MINKEY));
+    for (size_t idx = 1; idx < numConsumers; ++idx) {
+        boundaries.emplace_back(
+            BSON(fieldName << static_cast<long long>(lowest + static_cast<unsigned long long>(idx) *
+                                                               step)));
+    }
+    boundaries.emplace_back(BSON(fieldName << MAXKEY));
+    return boundaries;
+}
+
 /**
  * Non-correlated pipeline caching is only supported locally. When the
  * DocumentSourceSequentialDocumentCache stage has been moved to the shards pipeline, abandon the
@@ -588,5 +616,67 @@ boost::optional<ShardedExchangePolicy> checkIfEligibleForExchange(OperationConte
     return walkPipelineBackwardsTrackingShardKey(opCtx, outStage, mergePipeline, *routingInfo.cm());
 }
 
+boost::optional<ShardedExchangePolicy> checkIfEligibleForGroupMergeExchange(
+    OperationContext* opCtx,
+    const Pipeline* mergePipeline,
+    const std::set<ShardId>& targetedShards) {
+    if (internalQueryDisableExchange.load() || !internalQueryEnableGroupMergeExchange.load()) {
+        return boost::none;
+    }
+
+    const auto& expCtx = mergePipeline->getContext();
+    const auto& stages = mergePipeline->getSources();
+    if (stages.empty() || targetedShards.empty() ||
+        expCtx->tailableMode != TailableModeEnum::kNormal) {
+        return boost::none;
+    }
+
+    // Partial groups are routed by a hash of their _id, so two _id values which the merging $group
+    // considers equal must hash to the same consumer. That only holds for the simple collation.
+    if (expCtx->getCollator()) {
+        return boost::none;
+    }
+
+    const auto leadingGroup = dynamic_cast<DocumentSourceGroup*>(stages.front().get());
+    if (!leadingGroup || !leadingGroup->doingMerge()) {
+        return boost::none;
+    }
+
+    // The consumers' outputs are simply concatenated, so every stage after the $group has to be
+    // correct when applied to each partition on its own and must be able to run on any shard.
+    for (auto it = std::next(stages.begin()); it != stages.end(); ++it) {
+        const auto& stage = *it;
+        if (stage->mergingLogic() || dynamic_cast<DocumentSourceOut*>(stage.get()) ||
+            stage->constraints(Pipeline::SplitState::kSplitForMerge).hostRequirement !=
+                StageConstraints::HostTypeRequirement::kNone) {
+            return boost::none;
+        }
+    }
+
+    const size_t consumersPerShard = internalQueryGroupMergeExchangeConsumersPerShard.load();
+    const size_t numConsumers =
+        std::min(targetedShards.size() * consumersPerShard, kMaxGroupMergeExchangeConsumers);
+    if (numConsumers < 2) {
+        return boost::none;
+    }
+
+    // Spread the consumers round robin over the targeted shards so that each shard runs the same
+    // number of merging $groups.
+    std::vector<ShardId> shards(targetedShards.begin(), targetedShards.end());
+    std::vector<ShardId> consumerShards;
+    for (size_t idx = 0; idx < numConsumers; ++idx) {
+        consumerShards.emplace_back(shards[idx % shards.size()]);
+    }
+
+    ExchangeSpec exchangeSpec;
+    exchangeSpec.setPolicy(ExchangePolicyEnum::kKeyRange);
+    exchangeSpec.setKey(BSON("_id"
+                             << "hashed"));
+    exchangeSpec.setBoundaries(makeEvenHashBoundaries("_id", numConsumers));
+    exchangeSpec.setConsumers(numConsumers);
+
+    return ShardedExchangePolicy{std::move(exchangeSpec), std::move(consumerShards)};
+}
+
 }  // namespace cluster_aggregation_planner
 }  // namespace mongo
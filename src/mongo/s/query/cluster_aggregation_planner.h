@@ -109,5 +109,16 @@ struct ShardedExchangePolicy {
  */
 boost::optional<ShardedExchangePolicy> checkIfEligibleForExchange(OperationContext* opCtx,
                                                                   const Pipeline* mergePipeline);
+
+/**
+ * If the merging pipeline starts with a merging $group and nothing after it needs a single merged
+ * stream, returns an exchange which hash-partitions the partial groups on their _id so that each
+ * consumer placed on 'targetedShards' merges a disjoint set of groups. Returns boost::none if the
+ * pipeline is not eligible or internalQueryEnableGroupMergeExchange is not set.
+ */
+boost::optional<ShardedExchangePolicy> checkIfEligibleForGroupMergeExchange(
+    OperationContext* opCtx,
+    const Pipeline* mergePipeline,
+    const std::set<ShardId>& targetedShards);
 }  // namespace cluster_aggregation_planner
 }  // namespace mongo
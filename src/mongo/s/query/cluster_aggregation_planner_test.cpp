@@ -43,6 +43,7 @@
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/catalog_cache_test_fixture.h"
 #include "mongo/s/query/cluster_aggregation_planner.h"
+#include "mongo/s/query/cluster_query_knobs_gen.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/scopeguard.h"
 
@@ -597,5 +598,71 @@ TEST_F(ClusterExchangeTest, CompoundShardKeyThreeShards) {
 
     future.default_timed_get();
 }
+
+TEST_F(ClusterExchangeTest, GroupMergeIsNotPartitionedUnlessEnabled) {
+    auto mergePipe = unittest::assertGet(Pipeline::create(
+        {parse("{$group: {_id: '$word', count: {$sum: 1}, $doingMerge: true}}")}, expCtx()));
+    ASSERT_FALSE(cluster_aggregation_planner::checkIfEligibleForGroupMergeExchange(
+        operationContext(), mergePipe.get(), {ShardId("0"), ShardId("1")}));
+}
+
+TEST_F(ClusterExchangeTest, GroupMergeIsHashPartitionedAcrossTargetedShards) {
+    internalQueryEnableGroupMergeExchange.store(true);
+    internalQueryGroupMergeExchangeConsumersPerShard.store(2);
+    ON_BLOCK_EXIT([&]() {
+        internalQueryEnableGroupMergeExchange.store(false);
+        internalQueryGroupMergeExchangeConsumersPerShard.store(1);
+    });
+
+    auto mergePipe = unittest::assertGet(
+        Pipeline::create({parse("{$group: {_id: '$word', count: {$sum: 1}, $doingMerge: true}}"),
+                          DocumentSourceMatch::create(BSON("count" << BSON("$gt" << 1)), expCtx())},
+                         expCtx()));
+
+    auto exchangeSpec = cluster_aggregation_planner::checkIfEligibleForGroupMergeExchange(
+        operationContext(), mergePipe.get(), {ShardId("0"), ShardId("1")});
+    ASSERT_TRUE(exchangeSpec);
+    ASSERT(exchangeSpec->exchangeSpec.getPolicy() == ExchangePolicyEnum::kKeyRange);
+    ASSERT_BSONOBJ_EQ(exchangeSpec->exchangeSpec.getKey(),
+                      BSON("_id"
+                           << "hashed"));
+    ASSERT_EQ(exchangeSpec->exchangeSpec.getConsumers(), 4);
+    ASSERT_FALSE(exchangeSpec->exchangeSpec.getConsumerIds());
+
+    // Two consumers on each shard, assigned round robin.
+    ASSERT_EQ(exchangeSpec->consumerShards.size(), 4UL);
+    ASSERT_EQ(exchangeSpec->consumerShards[0], ShardId("0"));
+    ASSERT_EQ(exchangeSpec->consumerShards[1], ShardId("1"));
+    ASSERT_EQ(exchangeSpec->consumerShards[2], ShardId("0"));
+    ASSERT_EQ(exchangeSpec->consumerShards[3], ShardId("1"));
+
+    // The boundaries split the hash space into ranges of equal width.
+    const auto& boundaries = exchangeSpec->exchangeSpec.getBoundaries().get();
+    ASSERT_EQ(boundaries.size(), 5UL);
+    ASSERT_BSONOBJ_EQ(boundaries[0], BSON("_id" << MINKEY));
+    ASSERT_BSONOBJ_EQ(boundaries[1], BSON("_id" << std::numeric_limits<long long>::min() / 2));
+    ASSERT_BSONOBJ_EQ(boundaries[2], BSON("_id" << 0LL));
+    ASSERT_BSONOBJ_EQ(boundaries[3], BSON("_id" << std::numeric_limits<long long>::max() / 2 + 1));
+    ASSERT_BSONOBJ_EQ(boundaries[4], BSON("_id" << MAXKEY));
+}
+
+TEST_F(ClusterExchangeTest, GroupMergeIsNotPartitionedIfALaterStageNeedsASingleStream) {
+    internalQueryEnableGroupMergeExchange.store(true);
+    ON_BLOCK_EXIT([&]() { internalQueryEnableGroupMergeExchange.store(false); });
+
+    auto mergePipe = unittest::assertGet(
+        Pipeline::create({parse("{$group: {_id: '$word', count: {$sum: 1}, $doingMerge: true}}"),
+                          DocumentSourceSort::create(expCtx(), BSON("count" << -1))},
+                         expCtx()));
+    ASSERT_FALSE(cluster_aggregation_planner::checkIfEligibleForGroupMergeExchange(
+        operationContext(), mergePipe.get(), {ShardId("0"), ShardId("1")}));
+
+    // A $group which is not the merging half of a split $group is not eligible either.
+    mergePipe = unittest::assertGet(Pipeline::create(
+        {parse("{$group: {_id: '$word', count: {$sum: 1}}}")}, expCtx()));
+    ASSERT_FALSE(cluster_aggregation_planner::checkIfEligibleForGroupMergeExchange(
+        operationContext(), mergePipe.get(), {ShardId("0"), ShardId("1")}));
+}
+
 }  // namespace
 }  // namespace mongo
@@ -45,6 +45,11 @@ RouterStagePipeline::RouterStagePipeline(std::unique_ptr<Pipeline, PipelineDelet
     invariant(!_mergePipeline->getSources().empty());
     _mergeCursorsStage =
         dynamic_cast<DocumentSourceMergeCursors*>(_mergePipeline->getSources().front().get());
+    for (auto&& source : _mergePipeline->getSources()) {
+        if (auto lookupStage = dynamic_cast<DocumentSourceLookupChangePostImage*>(source.get())) {
+            _lookupChangePostImageStage = lookupStage;
+        }
+    }
 }
 
 StatusWith<ClusterQueryResult> RouterStagePipeline::next(RouterExecStage::ExecContext execContext) {
@@ -87,6 +92,11 @@ std::size_t RouterStagePipeline::getNumRemotes() const {
 }
 
 BSONObj RouterStagePipeline::getPostBatchResumeToken() const {
+    // The high water mark of the remote cursors has already advanced past any events which are
+    // still buffered in the pipeline, so the stream must resume after the last event returned.
+    if (_lookupChangePostImageStage && _lookupChangePostImageStage->hasBufferedEvents()) {
+        return _latestReturnedResumeToken;
+    }
     return _mergeCursorsStage ? _mergeCursorsStage->getHighWaterMark() : BSONObj();
 }
 
@@ -110,6 +120,7 @@ BSONObj RouterStagePipeline::_validateAndConvertToBSON(const Document& event) {
                           << " but found: "
                           << (eventBSON["_id"] ? BSON("_id" << eventBSON["_id"]) : BSONObj()),
             idField.binaryEqual(resumeToken));
+    _latestReturnedResumeToken = resumeToken.getOwned();
 
     // Return the event in BSONObj form, minus the $sortKey metadata.
     return eventBSON;
@@ -32,6 +32,7 @@
 #include "mongo/s/query/router_exec_stage.h"
 
 #include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/document_source_lookup_change_post_image.h"
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/s/query/document_source_merge_cursors.h"
 
@@ -69,5 +70,12 @@ private:
 
     // May be null if this pipeline runs exclusively on mongos without contacting the shards at all.
     boost::intrusive_ptr<DocumentSourceMergeCursors> _mergeCursorsStage;
+
+    // Null unless this is a change stream which looks up post-images of updates. That stage may
+    // hold events which the remote cursors have already returned.
+    boost::intrusive_ptr<DocumentSourceLookupChangePostImage> _lookupChangePostImageStage;
+
+    // The resume token of the last change stream event returned by this stage.
+    BSONObj _latestReturnedResumeToken;
 };
 }  // namespace mongo
@@ -0,0 +1,153 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/request_coalescer.h"
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+namespace {
+
+const auto getRequestCoalescer = ServiceContext::declareDecoration<RequestCoalescer>();
+
+/**
+ * Returns true if 'response' may be handed to reads other than the one which sent the request. A
+ * response which left a cursor open may not, since only one read can continue the cursor.
+ */
+bool isShareableResponse(const executor::RemoteCommandResponse& response) {
+    if (!response.isOK()) {
+        return false;
+    }
+
+    const auto cursor = response.data["cursor"];
+    return cursor.eoo() || (cursor.type() == Object && cursor.Obj()["id"].safeNumberLong() == 0);
+}
+
+}  // namespace
+
+RequestCoalescer& RequestCoalescer::get(ServiceContext* serviceContext) {
+    return getRequestCoalescer(serviceContext);
+}
+
+bool RequestCoalescer::isCoalescableCommand(const BSONObj& cmdObj) {
+    const auto cmdName = cmdObj.firstElementFieldNameStringData();
+    if (cmdName != "find"_sd && cmdName != "count"_sd && cmdName != "distinct"_sd) {
+        return false;
+    }
+
+    // Reads in a transaction must see the transaction's own writes.
+    if (cmdObj.hasField("txnNumber")) {
+        return false;
+    }
+
+    const auto readConcern = cmdObj["readConcern"];
+    if (readConcern.eoo()) {
+        return true;
+    }
+    if (readConcern.type() != Object) {
+        return false;
+    }
+
+    const auto level = readConcern.Obj()["level"];
+    return level.eoo() || (level.type() == String && level.valueStringData() == "local"_sd);
+}
+
+std::string RequestCoalescer::makeKey(const executor::RemoteCommandRequest& request) {
+    std::string key = request.target.toString();
+    key.push_back('\0');
+    key.append(request.dbname);
+    key.push_back('\0');
+    key.append(request.cmdObj.objdata(), request.cmdObj.objsize());
+    key.append(request.metadata.objdata(), request.metadata.objsize());
+    return key;
+}
+
+StatusWith<std::shared_ptr<RequestCoalescer::Follower>> RequestCoalescer::join(
+    const std::string& key, executor::TaskExecutor* executor) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _inFlight.find(key);
+    if (it == _inFlight.end()) {
+        _inFlight.emplace(key, std::vector<std::shared_ptr<Follower>>());
+        return std::shared_ptr<Follower>();
+    }
+
+    auto swEvent = executor->makeEvent();
+    if (!swEvent.isOK()) {
+        return swEvent.getStatus();
+    }
+
+    auto follower = std::make_shared<Follower>();
+    follower->executor = executor;
+    follower->event = std::move(swEvent.getValue());
+    it->second.push_back(follower);
+    return follower;
+}
+
+void RequestCoalescer::complete(const std::string& key,
+                                const executor::RemoteCommandResponse& response) {
+    std::vector<std::shared_ptr<Follower>> followers;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+        auto it = _inFlight.find(key);
+        invariant(it != _inFlight.end());
+        followers = std::move(it->second);
+        _inFlight.erase(it);
+    }
+
+    if (followers.empty()) {
+        return;
+    }
+
+    if (isShareableResponse(response)) {
+        _numCoalescedRequests.addAndFetch(followers.size());
+        for (auto& follower : followers) {
+            follower->response = response;
+        }
+    } else {
+        _numUnshareableResponses.addAndFetch(followers.size());
+    }
+
+    // The events are signaled without holding the mutex, since signaling them may run callbacks.
+    for (auto& follower : followers) {
+        follower->executor->signalEvent(follower->event);
+    }
+}
+
+void RequestCoalescer::report(BSONObjBuilder* builder) const {
+    builder->append("numCoalescedRequests", _numCoalescedRequests.load());
+    builder->append("numUnshareableResponses", _numUnshareableResponses.load());
+}
+
+}  // namespace mongo
@@ -0,0 +1,117 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/status_with.h"
+#include "mongo/executor/remote_command_request.h"
+#include "mongo/executor/remote_command_response.h"
+#include "mongo/executor/task_executor.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+
+namespace mongo {
+
+class BSONObj;
+class BSONObjBuilder;
+class ServiceContext;
+
+/**
+ * Lets concurrent identical reads to the same host share one remote request. The first read to
+ * ask for a request becomes its leader and sends it. Reads which ask for the same request while
+ * it is in flight become its followers and are handed the leader's response, unless the response
+ * cannot be shared, in which case they have to send their own request. Followers are woken up
+ * when the leader's request completes, even if they were canceled in the meantime.
+ *
+ * Is thread safe.
+ */
+class RequestCoalescer {
+public:
+    /**
+     * A read waiting for the response of a request sent by another read.
+     */
+    struct Follower {
+        executor::TaskExecutor* executor;
+
+        // Signaled once the leader's request completes.
+        executor::TaskExecutor::EventHandle event;
+
+        // The leader's response, if it can be shared. Is set before 'event' is signaled.
+        boost::optional<executor::RemoteCommandResponse> response;
+    };
+
+    static RequestCoalescer& get(ServiceContext* serviceContext);
+
+    /**
+     * Returns true if 'cmdObj' is a read with readConcern 'local' which may share the response to
+     * an identical request. The response of a find is only shared if it did not leave a cursor
+     * open, which is checked once it arrives.
+     */
+    static bool isCoalescableCommand(const BSONObj& cmdObj);
+
+    /**
+     * Returns the key which identifies requests identical to 'request'.
+     */
+    static std::string makeKey(const executor::RemoteCommandRequest& request);
+
+    /**
+     * If a request with 'key' is in flight, makes the caller one of its followers, waiting on an
+     * event of 'executor', and returns the follower. Otherwise makes the caller the leader for
+     * 'key' and returns nullptr, in which case the caller must send the request and call
+     * complete() once it completes, whether or not it could be sent.
+     */
+    StatusWith<std::shared_ptr<Follower>> join(const std::string& key,
+                                               executor::TaskExecutor* executor);
+
+    /**
+     * Ends the request with 'key', handing 'response' to its followers if it can be shared.
+     */
+    void complete(const std::string& key, const executor::RemoteCommandResponse& response);
+
+    void report(BSONObjBuilder* builder) const;
+
+private:
+    mutable stdx::mutex _mutex;
+
+    // The followers of each request which is in flight.
+    stdx::unordered_map<std::string, std::vector<std::shared_ptr<Follower>>> _inFlight;
+
+    // Followers which were handed the response to their leader's request.
+    AtomicWord<long long> _numCoalescedRequests{0};
+
+    // Followers which had to send their own request, because the response could not be shared.
+    AtomicWord<long long> _numUnshareableResponses{0};
+};
+
+}  // namespace mongo
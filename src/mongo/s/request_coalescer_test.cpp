@@ -0,0 +1,175 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/request_coalescer.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/executor/thread_pool_task_executor_test_fixture.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class RequestCoalescerTest : public executor::ThreadPoolExecutorTest {
+public:
+    void setUp() override {
+        executor::ThreadPoolExecutorTest::setUp();
+        launchExecutorThread();
+    }
+
+protected:
+    std::shared_ptr<RequestCoalescer::Follower> join(const std::string& key) {
+        return uassertStatusOK(_coalescer.join(key, &getExecutor()));
+    }
+
+    RequestCoalescer _coalescer;
+};
+
+TEST(RequestCoalescerCommandTest, OnlyReadsWithLocalReadConcernAreCoalescable) {
+    ASSERT_TRUE(RequestCoalescer::isCoalescableCommand(BSON("find"
+                                                            << "coll")));
+    ASSERT_TRUE(RequestCoalescer::isCoalescableCommand(BSON("count"
+                                                            << "coll")));
+    ASSERT_TRUE(RequestCoalescer::isCoalescableCommand(
+        BSON("distinct"
+             << "coll"
+             << "readConcern"
+             << BSON("level"
+                     << "local"))));
+    ASSERT_FALSE(RequestCoalescer::isCoalescableCommand(
+        BSON("find"
+             << "coll"
+             << "readConcern"
+             << BSON("level"
+                     << "majority"))));
+    ASSERT_FALSE(RequestCoalescer::isCoalescableCommand(BSON("find"
+                                                             << "coll"
+                                                             << "txnNumber"
+                                                             << 1LL)));
+    ASSERT_FALSE(RequestCoalescer::isCoalescableCommand(BSON("aggregate"
+                                                             << "coll")));
+    ASSERT_FALSE(RequestCoalescer::isCoalescableCommand(BSON("insert"
+                                                             << "coll")));
+}
+
+TEST(RequestCoalescerCommandTest, KeysIdentifyHostDatabaseAndCommand) {
+    const auto cmdObj = BSON("find"
+                             << "coll"
+                             << "filter"
+                             << BSON("x" << 1));
+    const executor::RemoteCommandRequest request(
+        HostAndPort("a", 1), "db", cmdObj, BSONObj(), nullptr);
+
+    ASSERT_EQ(RequestCoalescer::makeKey(request),
+              RequestCoalescer::makeKey(executor::RemoteCommandRequest(
+                  HostAndPort("a", 1), "db", cmdObj.copy(), BSONObj(), nullptr)));
+    ASSERT_NE(RequestCoalescer::makeKey(request),
+              RequestCoalescer::makeKey(executor::RemoteCommandRequest(
+                  HostAndPort("b", 1), "db", cmdObj, BSONObj(), nullptr)));
+    ASSERT_NE(RequestCoalescer::makeKey(request),
+              RequestCoalescer::makeKey(executor::RemoteCommandRequest(
+                  HostAndPort("a", 1), "otherdb", cmdObj, BSONObj(), nullptr)));
+    ASSERT_NE(RequestCoalescer::makeKey(request),
+              RequestCoalescer::makeKey(executor::RemoteCommandRequest(
+                  HostAndPort("a", 1),
+                  "db",
+                  BSON("find"
+                       << "coll"
+                       << "filter"
+                       << BSON("x" << 2)),
+                  BSONObj(),
+                  nullptr)));
+}
+
+TEST_F(RequestCoalescerTest, FollowersAreHandedTheLeadersResponse) {
+    ASSERT_FALSE(join("key"));
+    auto follower1 = join("key");
+    auto follower2 = join("key");
+    ASSERT_TRUE(follower1);
+    ASSERT_TRUE(follower2);
+
+    // Other requests are not affected.
+    ASSERT_FALSE(join("otherKey"));
+
+    _coalescer.complete("key", executor::RemoteCommandResponse(BSON("n" << 3 << "ok" << 1),
+                                                               Milliseconds(1)));
+    for (const auto& follower : {follower1, follower2}) {
+        getExecutor().waitForEvent(follower->event);
+        ASSERT(follower->response);
+        ASSERT_BSONOBJ_EQ(BSON("n" << 3 << "ok" << 1), follower->response->data);
+    }
+
+    // Once the request has completed, the next identical request is sent again.
+    ASSERT_FALSE(join("key"));
+    _coalescer.complete("key", executor::RemoteCommandResponse(BSON("ok" << 1), Milliseconds(1)));
+    _coalescer.complete("otherKey",
+                        executor::RemoteCommandResponse(BSON("ok" << 1), Milliseconds(1)));
+
+    BSONObjBuilder builder;
+    _coalescer.report(&builder);
+    ASSERT_BSONOBJ_EQ(BSON("numCoalescedRequests" << 2LL << "numUnshareableResponses" << 0LL),
+                      builder.obj());
+}
+
+TEST_F(RequestCoalescerTest, ResponsesWhichLeaveACursorOpenAreNotShared) {
+    ASSERT_FALSE(join("key"));
+    auto follower = join("key");
+
+    _coalescer.complete(
+        "key",
+        executor::RemoteCommandResponse(BSON("cursor" << BSON("id" << 5LL << "ns"
+                                                                   << "db.coll"
+                                                                   << "firstBatch"
+                                                                   << BSONArray())
+                                                      << "ok"
+                                                      << 1),
+                                        Milliseconds(1)));
+    getExecutor().waitForEvent(follower->event);
+    ASSERT_FALSE(follower->response);
+}
+
+TEST_F(RequestCoalescerTest, ErrorsAreNotShared) {
+    ASSERT_FALSE(join("key"));
+    auto follower = join("key");
+
+    _coalescer.complete(
+        "key", executor::RemoteCommandResponse(ErrorCodes::HostUnreachable, "unreachable"));
+    getExecutor().waitForEvent(follower->event);
+    ASSERT_FALSE(follower->response);
+
+    BSONObjBuilder builder;
+    _coalescer.report(&builder);
+    ASSERT_BSONOBJ_EQ(BSON("numCoalescedRequests" << 0LL << "numUnshareableResponses" << 1LL),
+                      builder.obj());
+}
+
+}  // namespace
+}  // namespace mongo
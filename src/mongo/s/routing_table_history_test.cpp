@@ -318,5 +318,57 @@ TEST_F(RoutingTableHistoryTestThreeInitialChunks,
                               expectedBytesInChunksNotSplit);
 }
 
+/**
+ * Checks that the chunks in 'rt' are contiguous, cover the whole key space and are each found by a
+ * lookup of their min.
+ */
+void assertRoutingTableIsConsistent(const std::shared_ptr<RoutingTableHistory>& rt,
+                                    const KeyPattern& shardKeyPattern) {
+    ChunkManager cm(rt, boost::none);
+    BSONObj lastMax = shardKeyPattern.globalMin();
+    for (const auto& chunk : cm.chunks()) {
+        ASSERT_BSONOBJ_EQ(chunk.getMin(), lastMax);
+        ASSERT_BSONOBJ_EQ(cm.findIntersectingChunkWithSimpleCollation(chunk.getMin()).getMax(),
+                          chunk.getMax());
+        lastMax = chunk.getMax();
+    }
+    ASSERT_BSONOBJ_EQ(lastMax, shardKeyPattern.globalMax());
+}
+
+TEST_F(RoutingTableHistoryTest, IncrementalRefreshesOfLargeRoutingTable) {
+    const int kNumChunks = 1000;
+    std::vector<BSONObj> boundaryPoints{getShardKeyPattern().globalMin()};
+    for (int i = 1; i < kNumChunks; ++i) {
+        boundaryPoints.push_back(BSON("a" << i * 10));
+    }
+    boundaryPoints.push_back(getShardKeyPattern().globalMax());
+
+    const auto initialRt = splitChunk(getInitialRoutingTable(), boundaryPoints);
+    ASSERT_EQ(initialRt->getChunkMap().size(), size_t(kNumChunks));
+    assertRoutingTableIsConsistent(initialRt, getShardKeyPattern());
+
+    // Split chunks spread over the whole routing table.
+    auto rt = initialRt;
+    for (int i = 1; i < kNumChunks - 1; i += 97) {
+        rt = splitChunk(
+            rt, {BSON("a" << i * 10), BSON("a" << i * 10 + 5), BSON("a" << (i + 1) * 10)});
+    }
+    const size_t numSplits = (kNumChunks - 2 + 96) / 97;
+    ASSERT_EQ(rt->getChunkMap().size(), kNumChunks + numSplits);
+    assertRoutingTableIsConsistent(rt, getShardKeyPattern());
+
+    // Merge a range of chunks which spans several of the blocks the routing table is stored in.
+    rt = splitChunk(rt, {BSON("a" << 100), BSON("a" << 9000)});
+    assertRoutingTableIsConsistent(rt, getShardKeyPattern());
+    ASSERT_BSONOBJ_EQ(ChunkManager(rt, boost::none)
+                          .findIntersectingChunkWithSimpleCollation(BSON("a" << 5000))
+                          .getMin(),
+                      BSON("a" << 100));
+
+    // The routing tables the updates were applied to are left untouched.
+    ASSERT_EQ(initialRt->getChunkMap().size(), size_t(kNumChunks));
+    assertRoutingTableIsConsistent(initialRt, getShardKeyPattern());
+}
+
 }  // namespace
 }  // namespace mongo
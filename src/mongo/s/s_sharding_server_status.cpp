@@ -35,6 +35,8 @@
 #include "mongo/s/catalog_cache.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
+#include "mongo/s/hedged_reads.h"
+#include "mongo/s/request_coalescer.h"
 
 namespace mongo {
 namespace {
@@ -88,5 +90,39 @@ public:
 
 } shardingStatisticsServerStatus;
 
+class HedgingMetricsServerStatus final : public ServerStatusSection {
+public:
+    HedgingMetricsServerStatus() : ServerStatusSection("hedgingMetrics") {}
+
+    bool includeByDefault() const override {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder result;
+        HedgingMetrics::get(opCtx->getServiceContext()).report(&result);
+        return result.obj();
+    }
+
+} hedgingMetricsServerStatus;
+
+class CoalescedShardReadsServerStatus final : public ServerStatusSection {
+public:
+    CoalescedShardReadsServerStatus() : ServerStatusSection("coalescedShardReads") {}
+
+    bool includeByDefault() const override {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder result;
+        RequestCoalescer::get(opCtx->getServiceContext()).report(&result);
+        return result.obj();
+    }
+
+} coalescedShardReadsServerStatus;
+
 }  // namespace
 }  // namespace mongo
@@ -41,6 +41,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/service_context.h"
 #include "mongo/rpc/message.h"
+#include "mongo/rpc/op_msg.h"
 #include "mongo/s/client/shard_connection.h"
 #include "mongo/s/cluster_last_error_info.h"
 #include "mongo/s/commands/strategy.h"
@@ -89,6 +90,10 @@ DbResponse ServiceEntryPointMongos::handleRequest(OperationContext* opCtx, const
 
     DbMessage dbm(message);
 
+    if (op == dbMsg) {
+        opCtx->setExhaust(OpMsg::isFlagSet(message, OpMsg::kExhaustSupported));
+    }
+
     // This is before the try block since it handles all exceptions that should not cause the
     // connection to close.
     if (op == dbMsg || (op == dbQuery && NamespaceString(dbm.getns()).isCommand())) {
@@ -33,6 +33,7 @@
 
 #include <vector>
 
+#include "mongo/db/bson/bsonobj_field_index.h"
 #include "mongo/db/field_ref.h"
 #include "mongo/db/field_ref_set.h"
 #include "mongo/db/hasher.h"
@@ -153,6 +154,36 @@ BSONElement findEqualityElement(const EqualityMatches& equalities, const FieldRe
     return extractKeyElementFromMatchable(matchable, suffixStr);
 }
 
+/**
+ * Builds the shard key for 'keyPattern' from the elements which 'extractElement' returns for each
+ * of its paths, or returns an empty object if any of them is not a valid shard key value.
+ */
+template <typename ExtractElementFn>
+BSONObj extractShardKey(const BSONObj& keyPattern, ExtractElementFn&& extractElement) {
+    BSONObjBuilder keyBuilder;
+
+    BSONObjIterator patternIt(keyPattern);
+    while (patternIt.more()) {
+        BSONElement patternEl = patternIt.next();
+        BSONElement matchEl = extractElement(patternEl.fieldNameStringData());
+
+        if (!isValidShardKeyElement(matchEl))
+            return BSONObj();
+
+        if (ShardKeyPattern::isHashedPatternEl(patternEl)) {
+            keyBuilder.append(
+                patternEl.fieldName(),
+                BSONElementHasher::hash64(matchEl, BSONElementHasher::DEFAULT_HASH_SEED));
+        } else {
+            // NOTE: The matched element may *not* have the same field name as the path -
+            // index keys don't contain field names, for example
+            keyBuilder.appendAs(matchEl, patternEl.fieldName());
+        }
+    }
+
+    return keyBuilder.obj();
+}
+
 }  // namespace
 
 constexpr int ShardKeyPattern::kMaxShardKeySizeBytes;
@@ -249,35 +280,69 @@ BSONObj ShardKeyPattern::normalizeShardKey(const BSONObj& shardKey) const {
 }
 
 BSONObj ShardKeyPattern::extractShardKeyFromMatchable(const MatchableDocument& matchable) const {
-    BSONObjBuilder keyBuilder;
+    auto shardKey = extractShardKey(_keyPattern.toBSON(), [&](StringData path) {
+        return extractKeyElementFromMatchable(matchable, path);
+    });
 
-    BSONObjIterator patternIt(_keyPattern.toBSON());
-    while (patternIt.more()) {
-        BSONElement patternEl = patternIt.next();
-        BSONElement matchEl =
-            extractKeyElementFromMatchable(matchable, patternEl.fieldNameStringData());
+    dassert(shardKey.isEmpty() || isShardKey(shardKey));
+    return shardKey;
+}
 
-        if (!isValidShardKeyElement(matchEl))
-            return BSONObj();
+BSONObj ShardKeyPattern::extractShardKeyFromDoc(const BSONObj& doc) const {
+    BSONMatchableDocument matchable(doc);
+    BSONObjFieldIndex fieldIndex(doc);
 
-        if (isHashedPatternEl(patternEl)) {
-            keyBuilder.append(
-                patternEl.fieldName(),
-                BSONElementHasher::hash64(matchEl, BSONElementHasher::DEFAULT_HASH_SEED));
-        } else {
-            // NOTE: The matched element may *not* have the same field name as the path -
-            // index keys don't contain field names, for example
-            keyBuilder.appendAs(matchEl, patternEl.fieldName());
+    auto shardKey = extractShardKey(_keyPattern.toBSON(), [&](StringData path) {
+        // A top-level field needs no path traversal, so look it up directly rather than through
+        // the matchable document, which would scan the document again for every such field.
+        if (path.find('.') == std::string::npos) {
+            return fieldIndex.getField(path);
         }
-    }
+        return extractKeyElementFromMatchable(matchable, path);
+    });
 
-    dassert(isShardKey(keyBuilder.asTempObj()));
-    return keyBuilder.obj();
+    dassert(shardKey.isEmpty() || isShardKey(shardKey));
+    return shardKey;
 }
 
-BSONObj ShardKeyPattern::extractShardKeyFromDoc(const BSONObj& doc) const {
-    BSONMatchableDocument matchable(doc);
-    return extractShardKeyFromMatchable(matchable);
+std::vector<BSONObj> ShardKeyPattern::extractShardKeysFromDocs(
+    const std::vector<BSONObj>& docs) const {
+    std::vector<BSONObj> shardKeys;
+    shardKeys.reserve(docs.size());
+
+    if (!isHashedPattern()) {
+        for (const auto& doc : docs) {
+            shardKeys.push_back(extractShardKeyFromDoc(doc));
+        }
+        return shardKeys;
+    }
+
+    // A hashed shard key has a single field. Documents without a valid value for it get an empty
+    // shard key, and are left out of the batch to hash.
+    const BSONElement patternEl = _keyPattern.toBSON().firstElement();
+    std::vector<BSONElement> keyElements;
+    std::vector<bool> hasShardKey;
+    keyElements.reserve(docs.size());
+    hasShardKey.reserve(docs.size());
+    for (const auto& doc : docs) {
+        BSONMatchableDocument matchable(doc);
+        BSONElement keyEl =
+            extractKeyElementFromMatchable(matchable, patternEl.fieldNameStringData());
+        hasShardKey.push_back(isValidShardKeyElement(keyEl));
+        if (hasShardKey.back()) {
+            keyElements.push_back(keyEl);
+        }
+    }
+
+    const auto hashes =
+        BSONElementHasher::hash64Batch(keyElements, BSONElementHasher::DEFAULT_HASH_SEED);
+
+    auto hashIt = hashes.begin();
+    for (bool hasKey : hasShardKey) {
+        shardKeys.push_back(hasKey ? BSON(patternEl.fieldName() << *hashIt++) : BSONObj());
+    }
+    invariant(hashIt == hashes.end());
+    return shardKeys;
 }
 
 std::vector<StringData> ShardKeyPattern::findMissingShardKeyFieldsFromDoc(const BSONObj doc) const {
@@ -150,6 +150,12 @@ public:
      */
     BSONObj extractShardKeyFromDoc(const BSONObj& doc) const;
 
+    /**
+     * Extracts the shard key of each of the given documents, as extractShardKeyFromDoc() does.
+     * For a hashed key pattern, the values of all documents are hashed in one batch.
+     */
+    std::vector<BSONObj> extractShardKeysFromDocs(const std::vector<BSONObj>& docs) const;
+
     /**
      * Returns the set of shard key fields which are absent from the given document. Note that the
      * vector returned by this method contains StringData elements pointing into ShardKeyPattern's
@@ -33,6 +33,9 @@
 
 #include "mongo/s/write_ops/batch_write_exec.h"
 
+#include <algorithm>
+#include <memory>
+
 #include "mongo/base/error_codes.h"
 #include "mongo/base/owned_pointer_map.h"
 #include "mongo/base/status.h"
@@ -48,6 +51,7 @@
 #include "mongo/s/write_ops/batch_write_op.h"
 #include "mongo/s/write_ops/write_error_detail.h"
 #include "mongo/util/log.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace {
@@ -110,6 +114,11 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
 
     BatchWriteOp batchOp(opCtx, clientRequest);
 
+    // Unordered batches outside of transactions hand each shard its next child batch as soon as
+    // that shard responds, so one slow shard does not hold up the writes destined for the others.
+    const bool streamChildBatchesEnabled =
+        !clientRequest.getWriteCommandBase().getOrdered() && !TransactionRouter::get(opCtx);
+
     // Current batch status
     bool refreshedTargeter = false;
     int rounds = 0;
@@ -173,7 +182,7 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
         // Send all child batches
         //
 
-        const size_t numToSend = childBatches.size();
+        size_t numToSend = childBatches.size();
         size_t numSent = 0;
 
         while (numSent != numToSend) {
@@ -181,60 +190,70 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
             OwnedShardBatchMap ownedPendingBatches;
             OwnedShardBatchMap::MapType& pendingBatches = ownedPendingBatches.mutableMap();
 
+            // When the outstanding batch to each shard was sent, for the round trip stats
+            std::map<ShardId, Timer> sentTimers;
+
             //
             // Construct the requests.
             //
 
-            std::vector<AsyncRequestsSender::Request> requests;
-
             // Get as many batches as we can at once
-            for (auto& childBatch : childBatches) {
-                TargetedWriteBatch* const nextBatch = childBatch.second;
+            auto takeRequests = [&] {
+                std::vector<AsyncRequestsSender::Request> requests;
 
-                // If the batch is nullptr, we sent it previously, so skip
-                if (!nextBatch)
-                    continue;
+                for (auto& childBatch : childBatches) {
+                    TargetedWriteBatch* const nextBatch = childBatch.second;
 
-                // If we already have a batch for this shard, wait until the next time
-                const auto& targetShardId = nextBatch->getEndpoint().shardName;
+                    // If the batch is nullptr, we sent it previously, so skip
+                    if (!nextBatch)
+                        continue;
 
-                if (pendingBatches.count(targetShardId))
-                    continue;
+                    // If we already have a batch for this shard, wait until the next time
+                    const auto& targetShardId = nextBatch->getEndpoint().shardName;
+
+                    if (pendingBatches.count(targetShardId))
+                        continue;
 
-                stats->noteTargetedShard(targetShardId);
+                    stats->noteTargetedShard(targetShardId);
 
-                const auto request = [&] {
-                    const auto shardBatchRequest(batchOp.buildBatchRequest(*nextBatch));
+                    const auto request = [&] {
+                        const auto shardBatchRequest(batchOp.buildBatchRequest(*nextBatch));
 
-                    BSONObjBuilder requestBuilder;
-                    shardBatchRequest.serialize(&requestBuilder);
+                        BSONObjBuilder requestBuilder;
+                        shardBatchRequest.serialize(&requestBuilder);
 
-                    {
-                        OperationSessionInfo sessionInfo;
+                        {
+                            OperationSessionInfo sessionInfo;
 
-                        if (opCtx->getLogicalSessionId()) {
-                            sessionInfo.setSessionId(*opCtx->getLogicalSessionId());
+                            if (opCtx->getLogicalSessionId()) {
+                                sessionInfo.setSessionId(*opCtx->getLogicalSessionId());
+                            }
+
+                            sessionInfo.setTxnNumber(opCtx->getTxnNumber());
+                            sessionInfo.serialize(&requestBuilder);
                         }
 
-                        sessionInfo.setTxnNumber(opCtx->getTxnNumber());
-                        sessionInfo.serialize(&requestBuilder);
-                    }
+                        return requestBuilder.obj();
+                    }();
 
-                    return requestBuilder.obj();
-                }();
+                    LOG(4) << "Sending write batch to " << targetShardId << ": "
+                           << redact(request);
 
-                LOG(4) << "Sending write batch to " << targetShardId << ": " << redact(request);
+                    requests.emplace_back(targetShardId, request);
 
-                requests.emplace_back(targetShardId, request);
+                    // Indicate we're done by setting the batch to nullptr. We'll only get duplicate
+                    // hostEndpoints if we have broadcast and non-broadcast endpoints for the same
+                    // host, so this should be pretty efficient without moving stuff around.
+                    childBatch.second = nullptr;
 
-                // Indicate we're done by setting the batch to nullptr. We'll only get duplicate
-                // hostEndpoints if we have broadcast and non-broadcast endpoints for the same host,
-                // so this should be pretty efficient without moving stuff around.
-                childBatch.second = nullptr;
+                    // Recv-side is responsible for cleaning up the nextBatch when used
+                    pendingBatches.emplace(targetShardId, nextBatch);
+                    sentTimers[targetShardId].reset();
+                    ++numSent;
+                }
 
-                // Recv-side is responsible for cleaning up the nextBatch when used
-                pendingBatches.emplace(targetShardId, nextBatch);
-            }
+                return requests;
+            };
 
             bool isRetryableWrite = opCtx->getTxnNumber() && !TransactionRouter::get(opCtx);
 
@@ -242,10 +261,44 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
                 opCtx,
                 Grid::get(opCtx)->getExecutorPool()->getArbitraryExecutor(),
                 clientRequest.getNS().db().toString(),
-                requests,
+                takeRequests(),
                 kPrimaryOnlyReadPreference,
                 isRetryableWrite ? Shard::RetryPolicy::kIdempotent : Shard::RetryPolicy::kNoRetry);
-            numSent += pendingBatches.size();
+
+            // Set once a response shows that the targeter needs a refresh, after which the writes
+            // which are still ready wait for the next round to be retargeted.
+            bool stopStreaming = false;
+
+            // Sends the next batch to every shard without an outstanding one, targeting the ready
+            // writes again once everything targeted so far has been sent.
+            auto streamChildBatches = [&] {
+                if (!streamChildBatchesEnabled || abortBatch || stopStreaming) {
+                    return;
+                }
+
+                const bool allSent =
+                    std::none_of(childBatches.begin(), childBatches.end(), [](const auto& entry) {
+                        return entry.second != nullptr;
+                    });
+                if (allSent && batchOp.numWriteOpsIn(WriteOpState_Ready) > 0) {
+                    std::map<ShardId, TargetedWriteBatch*> nextBatches;
+                    if (!batchOp.targetBatch(targeter, refreshedTargeter, &nextBatches).isOK()) {
+                        // The targeting error is handled by the next round.
+                        stopStreaming = true;
+                        return;
+                    }
+
+                    for (auto&& nextBatch : nextBatches) {
+                        invariant(!childBatches[nextBatch.first]);
+                        childBatches[nextBatch.first] = nextBatch.second;
+                    }
+                    numToSend += nextBatches.size();
+                }
+
+                for (auto&& request : takeRequests()) {
+                    ars.addRequest(request);
+                }
+            };
 
             //
             // Receive the responses.
@@ -255,9 +308,15 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
                 // Block until a response is available.
                 auto response = ars.next();
 
-                // Get the TargetedWriteBatch to find where to put the response
-                dassert(pendingBatches.find(response.shardId) != pendingBatches.end());
-                TargetedWriteBatch* batch = pendingBatches.find(response.shardId)->second;
+                // Get the TargetedWriteBatch to find where to put the response. Once the response
+                // is noted the shard is free to receive its next batch.
+                auto pendingIt = pendingBatches.find(response.shardId);
+                invariant(pendingIt != pendingBatches.end());
+                std::unique_ptr<TargetedWriteBatch> ownedBatch(pendingIt->second);
+                TargetedWriteBatch* batch = ownedBatch.get();
+                pendingBatches.erase(pendingIt);
+
+                stats->noteShardRoundTrip(response.shardId, sentTimers[response.shardId].elapsed());
 
                 // First check if we were able to target a shard host.
                 if (!response.shardHostAndPort) {
@@ -272,11 +331,7 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
                     LOG(4) << "Unable to send write batch to " << batch->getEndpoint().shardName
                            << causedBy(response.swResponse.getStatus());
 
-                    // We're done with this batch. Clean up when we can't resolve a host.
-                    auto it = childBatches.find(batch->getEndpoint().shardName);
-                    invariant(it != childBatches.end());
-                    delete it->second;
-                    it->second = nullptr;
+                    streamChildBatches();
                     continue;
                 }
 
@@ -334,6 +389,7 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
                     if (!staleErrors.empty()) {
                         noteStaleResponses(staleErrors, &targeter);
                         ++stats->numStaleBatches;
+                        stopStreaming = true;
                     }
 
                     const auto& cannotImplicitlyCreateErrors =
@@ -342,6 +398,7 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
                         // This forces the chunk manager to reload so we can attach the correct
                         // version on retry and make sure we route to the correct shard.
                         targeter.noteCouldNotTarget();
+                        stopStreaming = true;
 
                         // It is also possible that information about which shard is the primary
                         // for this collection collection is stale, so refresh the database as
@@ -385,6 +442,8 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
                         break;
                     }
                 }
+
+                streamChildBatches();
             }
         }
 
@@ -469,4 +528,16 @@ const HostOpTimeMap& BatchWriteExecStats::getWriteOpTimes() const {
     return _writeOpTimes;
 }
 
+void BatchWriteExecStats::noteShardRoundTrip(const ShardId& shardId, Microseconds duration) {
+    auto& roundTrips = _shardRoundTrips[shardId];
+    ++roundTrips.numBatches;
+    roundTrips.totalTime += duration;
+    roundTrips.maxTime = std::max(roundTrips.maxTime, duration);
+}
+
+const std::map<ShardId, BatchWriteExecStats::ShardRoundTrips>&
+BatchWriteExecStats::getShardRoundTrips() const {
+    return _shardRoundTrips;
+}
+
 }  // namespace
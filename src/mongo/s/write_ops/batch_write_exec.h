@@ -38,6 +38,7 @@
 #include "mongo/s/ns_targeter.h"
 #include "mongo/s/write_ops/batched_command_request.h"
 #include "mongo/s/write_ops/batched_command_response.h"
+#include "mongo/util/duration.h"
 
 namespace mongo {
 
@@ -88,11 +89,22 @@ public:
     BatchWriteExecStats()
         : numRounds(0), numTargetErrors(0), numResolveErrors(0), numStaleBatches(0) {}
 
+    /**
+     * Round trips of the child batches sent to a single shard.
+     */
+    struct ShardRoundTrips {
+        int numBatches = 0;
+        Microseconds totalTime{0};
+        Microseconds maxTime{0};
+    };
+
     void noteWriteAt(const HostAndPort& host, repl::OpTime opTime, const OID& electionId);
     void noteTargetedShard(const ShardId& shardId);
+    void noteShardRoundTrip(const ShardId& shardId, Microseconds duration);
 
     const std::set<ShardId>& getTargetedShards() const;
     const HostOpTimeMap& getWriteOpTimes() const;
+    const std::map<ShardId, ShardRoundTrips>& getShardRoundTrips() const;
 
     // Expose via helpers if this gets more complex
 
@@ -108,6 +120,7 @@ public:
 private:
     std::set<ShardId> _targetedShards;
     HostOpTimeMap _writeOpTimes;
+    std::map<ShardId, ShardRoundTrips> _shardRoundTrips;
 };
 
 }  // namespace mongo
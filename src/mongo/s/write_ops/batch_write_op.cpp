@@ -64,6 +64,9 @@ struct WriteErrorDetailComp {
 const int kEstUpdateOverheadBytes = (BSONObjMaxInternalSize - BSONObjMaxUserSize) / 100;
 const int kEstDeleteOverheadBytes = (BSONObjMaxInternalSize - BSONObjMaxUserSize) / 100;
 
+// The number of inserts targeted together by targetBatch().
+const size_t kInsertTargetingWindow = 64;
+
 /**
  * Returns a new write concern that has the copy of every field from the original
  * document but with a w set to 1. This is intended for upgrading { w: 0 } write
@@ -294,6 +297,13 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
 
     const size_t numWriteOps = _clientRequest.sizeWriteOps();
 
+    // Inserts are targeted a window of documents at a time, so that the targeter can share work,
+    // such as hashing shard keys, between them. The window is kept small since targeting may stop
+    // short of its end, for example when an ordered batch reaches a write for another shard.
+    const bool isInsert = _clientRequest.getBatchType() == BatchedCommandRequest::BatchType_Insert;
+    std::vector<StatusWith<ShardEndpoint>> insertEndpoints;
+    size_t nextInsertEndpoint = 0;
+
     for (size_t i = 0; i < numWriteOps; ++i) {
         WriteOp& writeOp = _writeOps[i];
 
@@ -301,6 +311,17 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
         if (writeOp.getWriteState() != WriteOpState_Ready)
             continue;
 
+        if (isInsert && nextInsertEndpoint == insertEndpoints.size()) {
+            std::vector<BSONObj> docs;
+            for (size_t j = i; j < numWriteOps && docs.size() < kInsertTargetingWindow; ++j) {
+                if (_writeOps[j].getWriteState() == WriteOpState_Ready) {
+                    docs.push_back(_clientRequest.getInsertRequest().getDocuments()[j]);
+                }
+            }
+            insertEndpoints = targeter.targetInserts(_opCtx, docs);
+            nextInsertEndpoint = 0;
+        }
+
         //
         // Get TargetedWrites from the targeter for the write operation
         //
@@ -309,7 +330,8 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
         OwnedPointerVector<TargetedWrite> writesOwned;
         vector<TargetedWrite*>& writes = writesOwned.mutableVector();
 
-        Status targetStatus = writeOp.targetWrites(_opCtx, targeter, &writes);
+        Status targetStatus = writeOp.targetWrites(
+            _opCtx, targeter, &writes, isInsert ? &insertEndpoints[nextInsertEndpoint++] : nullptr);
 
         if (!targetStatus.isOK()) {
             WriteErrorDetail targetError;
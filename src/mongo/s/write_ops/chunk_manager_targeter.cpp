@@ -363,7 +363,31 @@ const NamespaceString& ChunkManagerTargeter::getNS() const {
 StatusWith<ShardEndpoint> ChunkManagerTargeter::targetInsert(OperationContext* opCtx,
                                                              const BSONObj& doc) const {
     BSONObj shardKey;
+    if (_routingInfo->cm()) {
+        shardKey = _routingInfo->cm()->getShardKeyPattern().extractShardKeyFromDoc(doc);
+    }
+    return _targetInsert(doc, shardKey);
+}
+
+std::vector<StatusWith<ShardEndpoint>> ChunkManagerTargeter::targetInserts(
+    OperationContext* opCtx, const std::vector<BSONObj>& docs) const {
+    std::vector<BSONObj> shardKeys;
+    if (_routingInfo->cm()) {
+        shardKeys = _routingInfo->cm()->getShardKeyPattern().extractShardKeysFromDocs(docs);
+    } else {
+        shardKeys.resize(docs.size());
+    }
 
+    std::vector<StatusWith<ShardEndpoint>> endpoints;
+    endpoints.reserve(docs.size());
+    for (size_t i = 0; i < docs.size(); ++i) {
+        endpoints.push_back(_targetInsert(docs[i], shardKeys[i]));
+    }
+    return endpoints;
+}
+
+StatusWith<ShardEndpoint> ChunkManagerTargeter::_targetInsert(const BSONObj& doc,
+                                                              const BSONObj& shardKey) const {
     if (_routingInfo->cm()) {
         //
         // Sharded collections have the following requirements for targeting:
@@ -371,8 +395,6 @@ StatusWith<ShardEndpoint> ChunkManagerTargeter::targetInsert(OperationContext* o
         // Inserts must contain the exact shard key.
         //
 
-        shardKey = _routingInfo->cm()->getShardKeyPattern().extractShardKeyFromDoc(doc);
-
         // Check shard key exists
         if (shardKey.isEmpty()) {
             return {ErrorCodes::ShardKeyNotFound,
@@ -80,6 +80,11 @@ public:
     StatusWith<ShardEndpoint> targetInsert(OperationContext* opCtx,
                                            const BSONObj& doc) const override;
 
+    // Extracts the shard keys of all the documents at once, so that hashed shard keys are hashed
+    // in a batch.
+    std::vector<StatusWith<ShardEndpoint>> targetInserts(
+        OperationContext* opCtx, const std::vector<BSONObj>& docs) const override;
+
     // Returns ShardKeyNotFound if the update can't be targeted without a shard key.
     StatusWith<std::vector<ShardEndpoint>> targetUpdate(
         OperationContext* opCtx, const write_ops::UpdateOpEntry& updateDoc) const override;
@@ -159,6 +164,11 @@ private:
      *
      * If 'collation' is empty, we use the collection default collation for targeting.
      */
+    /**
+     * Targets the insert of 'doc', whose shard key, if the collection is sharded, is 'shardKey'.
+     */
+    StatusWith<ShardEndpoint> _targetInsert(const BSONObj& doc, const BSONObj& shardKey) const;
+
     ShardEndpoint _targetShardKey(const BSONObj& shardKey,
                                   const BSONObj& collation,
                                   long long estDataSize) const;
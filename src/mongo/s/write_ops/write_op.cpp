@@ -54,10 +54,12 @@ const WriteErrorDetail& WriteOp::getOpError() const {
 
 Status WriteOp::targetWrites(OperationContext* opCtx,
                              const NSTargeter& targeter,
-                             std::vector<TargetedWrite*>* targetedWrites) {
+                             std::vector<TargetedWrite*>* targetedWrites,
+                             const StatusWith<ShardEndpoint>* insertEndpoint) {
     auto swEndpoints = [&]() -> StatusWith<std::vector<ShardEndpoint>> {
         if (_itemRef.getOpType() == BatchedCommandRequest::BatchType_Insert) {
-            auto swEndpoint = targeter.targetInsert(opCtx, _itemRef.getDocument());
+            auto swEndpoint = insertEndpoint ? *insertEndpoint
+                                             : targeter.targetInsert(opCtx, _itemRef.getDocument());
             if (!swEndpoint.isOK())
                 return swEndpoint.getStatus();
 
@@ -115,12 +115,16 @@ public:
      * The ShardTargeter determines the ShardEndpoints to send child writes to, but is not
      * modified by this operation.
      *
+     * If 'insertEndpoint' is not null, an insert is sent to it rather than targeted again; it must
+     * be what targeter.targetInsert() returns for the document.
+     *
      * Returns !OK if the targeting process itself fails
      *             (no TargetedWrites will be added, state unchanged)
      */
     Status targetWrites(OperationContext* opCtx,
                         const NSTargeter& targeter,
-                        std::vector<TargetedWrite*>* targetedWrites);
+                        std::vector<TargetedWrite*>* targetedWrites,
+                        const StatusWith<ShardEndpoint>* insertEndpoint = nullptr);
 
     /**
      * Returns the number of child writes that were last targeted.
@@ -41,6 +41,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/service_context.h"
 #include "mongo/scripting/dbdirectclient_factory.h"
+#include "mongo/scripting/scope_cache_gen.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/file.h"
 #include "mongo/util/log.h"
@@ -341,14 +342,22 @@ public:
             return;
         }
 
-        if (Date_t::now() - scope->getCreateTime() > kMaxScopeReuseTime)
+        const auto maxReuseTime = Seconds(gScriptingScopeCacheMaxReuseTimeSecs.load());
+        if (Date_t::now() - scope->getCreateTime() > maxReuseTime)
             return;  // too old to save
 
         if (!scope->getError().empty())
             return;  // not saving errored scopes
 
-        if (_pools.size() >= kMaxPoolSize) {
-            // prefer to keep recently-used scopes
+        const auto maxPoolSize = static_cast<size_t>(gScriptingScopeCacheMaxSize.load());
+        if (maxPoolSize == 0) {
+            _pools.clear();
+            return;
+        }
+
+        // Prefer to keep recently-used scopes. The limit may have been lowered at runtime, so
+        // trim the pool down to it rather than dropping a single scope.
+        while (_pools.size() >= maxPoolSize) {
             _pools.pop_back();
         }
 
@@ -385,10 +394,8 @@ private:
         string poolName;
     };
 
-    // Note: if these numbers change, reconsider choice of datastructure for _pools
-    static const unsigned kMaxPoolSize = 10;
-    constexpr static inline Seconds kMaxScopeReuseTime = Seconds(10);
-
+    // Note: the pool size is bounded by the 'scriptingScopeCacheMaxSize' server parameter. If
+    // it is raised far beyond its default, reconsider the choice of datastructure for _pools.
     typedef std::deque<ScopeAndPool> Pools;  // More-recently used Scopes are kept at the front.
     Pools _pools;                            // protected by _mutex
     stdx::mutex _mutex;
@@ -33,6 +33,8 @@
 
 #include "mongo/shell/bench.h"
 
+#include <algorithm>
+#include <cmath>
 #include <pcrecpp.h>
 
 #include "mongo/client/dbclient_cursor.h"
@@ -40,6 +42,7 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/query_request.h"
+#include "mongo/platform/bits.h"
 #include "mongo/scripting/bson_template_evaluator.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
@@ -74,6 +77,15 @@ const int kMultiStatementTransactionOption = 1 << 1;
 const BSONObj readConcernSnapshot = BSON("level"
                                          << "snapshot");
 
+// Latencies below 2^kLatencySubBucketBits microseconds are counted exactly. Each larger power of
+// two is split into 2^(kLatencySubBucketBits - 1) equally sized buckets.
+const int kLatencySubBucketBits = 7;
+const long long kLatencySubBucketCount = 1LL << kLatencySubBucketBits;
+const long long kLatencySubBucketHalfCount = kLatencySubBucketCount / 2;
+const int kLatencyMaxMagnitude = 40;
+const size_t kLatencyNumBuckets = kLatencySubBucketCount +
+    (kLatencyMaxMagnitude - kLatencySubBucketBits) * kLatencySubBucketHalfCount;
+
 class BenchRunWorkerStateGuard {
     BenchRunWorkerStateGuard(const BenchRunWorkerStateGuard&) = delete;
     BenchRunWorkerStateGuard& operator=(const BenchRunWorkerStateGuard&) = delete;
@@ -325,11 +337,83 @@ Timestamp getAClusterTimeSecondsInThePast(DBClientBase* conn, int numSecondsInTh
 
 }  // namespace
 
+size_t BenchRunLatencyHistogram::bucketFor(long long micros) {
+    micros = std::max(0LL, std::min(micros, kMaxTrackableMicros));
+    if (micros < kLatencySubBucketCount) {
+        return micros;
+    }
+    const int magnitude = 63 - countLeadingZeros64(micros);
+    const int shift = magnitude - (kLatencySubBucketBits - 1);
+    return kLatencySubBucketCount +
+        (magnitude - kLatencySubBucketBits) * kLatencySubBucketHalfCount +
+        ((micros >> shift) - kLatencySubBucketHalfCount);
+}
+
+long long BenchRunLatencyHistogram::highestValueInBucket(size_t bucket) {
+    if (bucket < static_cast<size_t>(kLatencySubBucketCount)) {
+        return bucket;
+    }
+    const long long offset = bucket - kLatencySubBucketCount;
+    const int magnitude = kLatencySubBucketBits + offset / kLatencySubBucketHalfCount;
+    const int shift = magnitude - (kLatencySubBucketBits - 1);
+    const long long subBucket = kLatencySubBucketHalfCount + offset % kLatencySubBucketHalfCount;
+    return ((subBucket + 1) << shift) - 1;
+}
+
+void BenchRunLatencyHistogram::record(long long micros) {
+    if (_buckets.empty()) {
+        _buckets.resize(kLatencyNumBuckets);
+    }
+    ++_buckets[bucketFor(micros)];
+    ++_count;
+    _max = std::max(_max, std::min(micros, kMaxTrackableMicros));
+}
+
+void BenchRunLatencyHistogram::updateFrom(const BenchRunLatencyHistogram& other) {
+    if (other._buckets.empty()) {
+        return;
+    }
+    if (_buckets.empty()) {
+        _buckets.resize(kLatencyNumBuckets);
+    }
+    for (size_t i = 0; i < kLatencyNumBuckets; ++i) {
+        _buckets[i] += other._buckets[i];
+    }
+    _count += other._count;
+    _max = std::max(_max, other._max);
+}
+
+long long BenchRunLatencyHistogram::valueAtPercentile(double percentile) const {
+    if (_count == 0) {
+        return 0;
+    }
+    const double clamped = std::max(0.0, std::min(percentile, 100.0));
+    const long long target =
+        std::max(1LL, static_cast<long long>(std::ceil(clamped / 100.0 * _count)));
+    long long seen = 0;
+    for (size_t i = 0; i < kLatencyNumBuckets; ++i) {
+        seen += _buckets[i];
+        if (seen >= target) {
+            return std::min(highestValueInBucket(i), _max);
+        }
+    }
+    return _max;
+}
+
+void BenchRunLatencyHistogram::appendPercentiles(BSONObjBuilder* builder) const {
+    builder->append("p50", valueAtPercentile(50));
+    builder->append("p95", valueAtPercentile(95));
+    builder->append("p99", valueAtPercentile(99));
+    builder->append("p99_9", valueAtPercentile(99.9));
+    builder->append("max", _max);
+}
+
 BenchRunEventCounter::BenchRunEventCounter() = default;
 
 void BenchRunEventCounter::updateFrom(const BenchRunEventCounter& other) {
     _numEvents += other._numEvents;
     _totalTimeMicros += other._totalTimeMicros;
+    _latencies.updateFrom(other._latencies);
 }
 
 void BenchRunStats::updateFrom(const BenchRunStats& other) {
@@ -362,6 +446,7 @@ void BenchRunConfig::initializeToDefaults() {
 
     parallel = 1;
     seconds = 1.0;
+    opsPerSecond = 0;
     hideResults = true;
     handleErrors = false;
     hideErrors = false;
@@ -692,6 +777,11 @@ void BenchRunConfig::initializeFromBson(const BSONObj& args) {
                                   << typeName(arg.type()),
                     arg.isBoolean());
             useSnapshotReads = arg.boolean();
+        } else if (name == "opsPerSecond") {
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "Field '" << name << "' should be a non-negative number",
+                    arg.isNumber() && arg.number() >= 0);
+            opsPerSecond = arg.number();
         } else if (name == "delayMillisOnFailedOperation") {
             uassert(ErrorCodes::BadValue,
                     str::stream() << "Field '" << name << "' should be a number. Type is "
@@ -889,6 +979,13 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
         }
     });
 
+    // With a target arrival rate, each worker starts its operations every 'intervalMicros', with
+    // the workers' schedules staggered evenly across the interval.
+    const double intervalMicros =
+        _config->opsPerSecond > 0 ? 1000 * 1000 * _config->parallel / _config->opsPerSecond : 0;
+    const double firstStartMicros = intervalMicros * _id / _config->parallel;
+    long long numScheduled = 0;
+
     while (!shouldStop()) {
         for (const auto& op : _config->ops) {
             if (shouldStop())
@@ -896,6 +993,16 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
 
             opState.stats = shouldCollectStats() ? &_stats : &_statsBlackHole;
 
+            if (intervalMicros > 0) {
+                const auto scheduledMicros =
+                    static_cast<long long>(firstStartMicros + intervalMicros * numScheduled++);
+                const auto nowMicros = timer.micros();
+                if (nowMicros < scheduledMicros) {
+                    sleepmicros(scheduledMicros - nowMicros);
+                }
+                opState.scheduleDelayMicros = std::max(0LL, timer.micros() - scheduledMicros);
+            }
+
             try {
                 op.executeOnce(conn, lsid, *_config, &opState);
             } catch (const DBException& ex) {
@@ -993,7 +1100,7 @@ void BenchRunOp::executeOnce(DBClientBase* conn,
                 }
                 invariant(qr->validate());
 
-                BenchRunEventTrace _bret(&state->stats->findOneCounter);
+                BenchRunEventTrace _bret(&state->stats->findOneCounter, state->scheduleDelayMicros);
                 boost::optional<TxnNumber> txnNumberForOp;
                 if (config.useSnapshotReads) {
                     ++state->txnNumber;
@@ -1003,7 +1110,7 @@ void BenchRunOp::executeOnce(DBClientBase* conn,
                 runQueryWithReadCommands(
                     conn, lsid, txnNumberForOp, std::move(qr), Milliseconds(0), &result);
             } else {
-                BenchRunEventTrace _bret(&state->stats->findOneCounter);
+                BenchRunEventTrace _bret(&state->stats->findOneCounter, state->scheduleDelayMicros);
                 result = conn->findOne(
                     this->ns, fixedQuery, nullptr, DBClientCursor::QueryOptionLocal_forceOpQuery);
             }
@@ -1015,7 +1122,7 @@ void BenchRunOp::executeOnce(DBClientBase* conn,
             bool ok;
             BSONObj result;
             {
-                BenchRunEventTrace _bret(&state->stats->commandCounter);
+                BenchRunEventTrace _bret(&state->stats->commandCounter, state->scheduleDelayMicros);
                 ok = runCommandWithSession(conn,
                                            this->ns,
                                            fixQuery(this->command, *state->bsonTemplateEvaluator),
@@ -1094,7 +1201,7 @@ void BenchRunOp::executeOnce(DBClientBase* conn,
 
                 invariant(qr->validate());
 
-                BenchRunEventTrace _bret(&state->stats->queryCounter);
+                BenchRunEventTrace _bret(&state->stats->queryCounter, state->scheduleDelayMicros);
                 boost::optional<TxnNumber> txnNumberForOp;
                 if (config.useSnapshotReads) {
                     ++state->txnNumber;
@@ -1115,7 +1222,8 @@ void BenchRunOp::executeOnce(DBClientBase* conn,
             } else {
                 // Use special query function for exhaust query option.
                 if (this->options & QueryOption_Exhaust) {
-                    BenchRunEventTrace _bret(&state->stats->queryCounter);
+                    BenchRunEventTrace _bret(&state->stats->queryCounter,
+                                             state->scheduleDelayMicros);
                     stdx::function<void(const BSONObj&)> castedDoNothing(doNothing);
                     count =
                         conn->query(castedDoNothing,
@@ -1124,7 +1232,8 @@ void BenchRunOp::executeOnce(DBClientBase* conn,
                                     &this->projection,
                                     this->options | DBClientCursor::QueryOptionLocal_forceOpQuery);
                 } else {
-                    BenchRunEventTrace _bret(&state->stats->queryCounter);
+                    BenchRunEventTrace _bret(&state->stats->queryCounter,
+                                             state->scheduleDelayMicros);
                     std::unique_ptr<DBClientCursor> cursor(
                         conn->query(NamespaceString(this->ns),
                                     fixedQuery,
@@ -1149,7 +1258,7 @@ void BenchRunOp::executeOnce(DBClientBase* conn,
         case OpType::UPDATE: {
             BSONObj result;
             {
-                BenchRunEventTrace _bret(&state->stats->updateCounter);
+                BenchRunEventTrace _bret(&state->stats->updateCounter, state->scheduleDelayMicros);
                 BSONObj query = fixQuery(this->query, *state->bsonTemplateEvaluator);
                 BSONObj update = fixQuery(this->update, *state->bsonTemplateEvaluator);
 
@@ -1200,7 +1309,7 @@ void BenchRunOp::executeOnce(DBClientBase* conn,
         case OpType::INSERT: {
             BSONObj result;
             {
-                BenchRunEventTrace _bret(&state->stats->insertCounter);
+                BenchRunEventTrace _bret(&state->stats->insertCounter, state->scheduleDelayMicros);
 
                 BSONObj insertDoc;
                 if (this->useWriteCmd) {
@@ -1264,7 +1373,7 @@ void BenchRunOp::executeOnce(DBClientBase* conn,
         case OpType::REMOVE: {
             BSONObj result;
             {
-                BenchRunEventTrace _bret(&state->stats->deleteCounter);
+                BenchRunEventTrace _bret(&state->stats->deleteCounter, state->scheduleDelayMicros);
                 BSONObj predicate = fixQuery(this->query, *state->bsonTemplateEvaluator);
                 if (this->useWriteCmd) {
                     BSONObjBuilder builder;
@@ -1471,6 +1580,21 @@ BSONObj BenchRunner::finish(BenchRunner* runner) {
     appendAverageMicrosIfAvailable("queryLatencyAverageMicros", stats.queryCounter);
     appendAverageMicrosIfAvailable("commandsLatencyAverageMicros", stats.commandCounter);
 
+    const auto appendLatencyPercentilesIfAvailable = [&buf](StringData name,
+                                                            const BenchRunEventCounter& counter) {
+        if (counter.getNumEvents() > 0) {
+            BSONObjBuilder percentiles(buf.subobjStart(name));
+            counter.getLatencyHistogram().appendPercentiles(&percentiles);
+        }
+    };
+
+    appendLatencyPercentilesIfAvailable("findOneLatencyMicros", stats.findOneCounter);
+    appendLatencyPercentilesIfAvailable("insertLatencyMicros", stats.insertCounter);
+    appendLatencyPercentilesIfAvailable("deleteLatencyMicros", stats.deleteCounter);
+    appendLatencyPercentilesIfAvailable("updateLatencyMicros", stats.updateCounter);
+    appendLatencyPercentilesIfAvailable("queryLatencyMicros", stats.queryCounter);
+    appendLatencyPercentilesIfAvailable("commandsLatencyMicros", stats.commandCounter);
+
     buf.append("totalOps", static_cast<long long>(stats.opCount));
 
     const auto appendPerSec = [&buf, runner](StringData name, double total) {
@@ -31,6 +31,7 @@
 
 #include <boost/optional.hpp>
 #include <string>
+#include <vector>
 
 #include "mongo/base/shim.h"
 #include "mongo/client/dbclient_base.h"
@@ -85,6 +86,11 @@ struct BenchRunOp {
         // Transaction state
         TxnNumber txnNumber = 0;
         bool inProgressMultiStatementTxn = false;
+
+        // How long the current operation started after its scheduled start time, when running at
+        // a fixed arrival rate. Counted towards the operation's latency so that a slow response
+        // does not hide the delay it imposes on the operations queued behind it.
+        long long scheduleDelayMicros = 0;
     };
 
     void executeOnce(DBClientBase* conn,
@@ -218,6 +224,17 @@ public:
      */
     bool useSnapshotReads{false};
 
+    /**
+     * Target rate, across all threads, at which operations are started. If zero, each thread
+     * starts its next operation as soon as the previous one completes.
+     *
+     * With a target rate, each thread schedules its operations at fixed intervals and latencies
+     * are measured from the scheduled start time. An operation held up by a slow predecessor
+     * counts the wait in its latency. This avoids coordinated omission, where a stalled server
+     * also stalls the load generator and the stall is undercounted in the latency distribution.
+     */
+    double opsPerSecond{0};
+
     /**
      * How many milliseconds to sleep for if an operation fails, before continuing to the next op.
      */
@@ -256,6 +273,58 @@ private:
     void initializeToDefaults();
 };
 
+/**
+ * A latency histogram with logarithmic buckets, in the style of HdrHistogram.
+ *
+ * Values below 128 microseconds are counted exactly. Larger values are counted in buckets whose
+ * width is 1/64th of the power of two they fall in, so a reported percentile is within 1.6% of
+ * the true value. Values above kMaxTrackableMicros are counted as kMaxTrackableMicros.
+ *
+ * Not thread safe. Expected use is one instance per thread during parallel execution.
+ */
+class BenchRunLatencyHistogram {
+public:
+    static constexpr long long kMaxTrackableMicros = (1LL << 40) - 1;
+
+    /**
+     * Count one event which took "micros" microseconds.
+     */
+    void record(long long micros);
+
+    /**
+     * Conceptually the equivalent of "+=". Adds "other" into this.
+     */
+    void updateFrom(const BenchRunLatencyHistogram& other);
+
+    long long getCount() const {
+        return _count;
+    }
+
+    long long getMax() const {
+        return _max;
+    }
+
+    /**
+     * Returns the smallest value that at least "percentile" percent of the recorded events took no
+     * longer than, or 0 if no events were recorded.
+     */
+    long long valueAtPercentile(double percentile) const;
+
+    /**
+     * Appends the 50th, 95th, 99th and 99.9th percentiles and the maximum to "builder".
+     */
+    void appendPercentiles(BSONObjBuilder* builder) const;
+
+private:
+    static size_t bucketFor(long long micros);
+    static long long highestValueInBucket(size_t bucket);
+
+    // Allocated on the first record() so that unused histograms stay small.
+    std::vector<long long> _buckets;
+    long long _count{0};
+    long long _max{0};
+};
+
 /**
  * An event counter for events that have an associated duration.
  *
@@ -280,6 +349,7 @@ public:
         }
         ++_numEvents;
         _totalTimeMicros += timeMicros;
+        _latencies.record(timeMicros);
     }
 
     /**
@@ -296,9 +366,17 @@ public:
         return _numEvents;
     }
 
+    /**
+     * Get the distribution of the durations of the observed events.
+     */
+    const BenchRunLatencyHistogram& getLatencyHistogram() const {
+        return _latencies;
+    }
+
 private:
     long long _totalTimeMicros{0};
     long long _numEvents{0};
+    BenchRunLatencyHistogram _latencies;
 };
 
 /**
@@ -323,6 +401,15 @@ public:
         initialize(eventCounter, eventCounter, false);
     }
 
+    /**
+     * Also counts "scheduleDelayMicros", the time the event waited past its scheduled start, as
+     * part of the event's duration.
+     */
+    BenchRunEventTrace(BenchRunEventCounter* eventCounter, long long scheduleDelayMicros)
+        : _scheduleDelayMicros(scheduleDelayMicros) {
+        initialize(eventCounter, eventCounter, false);
+    }
+
     BenchRunEventTrace(BenchRunEventCounter* successCounter,
                        BenchRunEventCounter* failCounter,
                        bool defaultToFailure = true) {
@@ -330,7 +417,8 @@ public:
     }
 
     ~BenchRunEventTrace() {
-        (_succeeded ? _successCounter : _failCounter)->countOne(_timer.micros());
+        (_succeeded ? _successCounter : _failCounter)
+            ->countOne(_timer.micros() + _scheduleDelayMicros);
     }
 
     void succeed() {
@@ -350,6 +438,7 @@ private:
     }
 
     Timer _timer;
+    long long _scheduleDelayMicros{0};
     BenchRunEventCounter* _successCounter;
     BenchRunEventCounter* _failCounter;
     bool _succeeded;
@@ -0,0 +1,163 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/shell/bench.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(BenchRunLatencyHistogramTest, EmptyHistogramReportsZero) {
+    BenchRunLatencyHistogram histogram;
+    ASSERT_EQ(0, histogram.getCount());
+    ASSERT_EQ(0, histogram.valueAtPercentile(50));
+    ASSERT_EQ(0, histogram.valueAtPercentile(100));
+}
+
+TEST(BenchRunLatencyHistogramTest, SmallValuesAreExact) {
+    BenchRunLatencyHistogram histogram;
+    for (long long micros = 1; micros <= 100; ++micros) {
+        histogram.record(micros);
+    }
+    ASSERT_EQ(100, histogram.getCount());
+    ASSERT_EQ(50, histogram.valueAtPercentile(50));
+    ASSERT_EQ(95, histogram.valueAtPercentile(95));
+    ASSERT_EQ(99, histogram.valueAtPercentile(99));
+    ASSERT_EQ(100, histogram.valueAtPercentile(100));
+    ASSERT_EQ(100, histogram.getMax());
+}
+
+TEST(BenchRunLatencyHistogramTest, LargeValuesAreWithinRelativeError) {
+    BenchRunLatencyHistogram histogram;
+    for (long long micros = 1000; micros <= 1000 * 1000; micros += 1000) {
+        histogram.record(micros);
+    }
+    const auto p50 = histogram.valueAtPercentile(50);
+    ASSERT_GTE(p50, 500 * 1000);
+    ASSERT_LTE(p50, 500 * 1000 * 65 / 64);
+    const auto p99 = histogram.valueAtPercentile(99);
+    ASSERT_GTE(p99, 990 * 1000);
+    ASSERT_LTE(p99, 990 * 1000 * 65 / 64);
+
+    // Percentiles never exceed the largest recorded value.
+    ASSERT_EQ(1000 * 1000, histogram.valueAtPercentile(100));
+}
+
+TEST(BenchRunLatencyHistogramTest, OutliersShowInTail) {
+    BenchRunLatencyHistogram histogram;
+    for (int i = 0; i < 990; ++i) {
+        histogram.record(100);
+    }
+    for (int i = 0; i < 10; ++i) {
+        histogram.record(1000 * 1000);
+    }
+    ASSERT_EQ(100, histogram.valueAtPercentile(50));
+    ASSERT_EQ(100, histogram.valueAtPercentile(99));
+    ASSERT_GTE(histogram.valueAtPercentile(99.9), 1000 * 1000 * 63 / 64);
+}
+
+TEST(BenchRunLatencyHistogramTest, ClampsValuesOutOfRange) {
+    BenchRunLatencyHistogram histogram;
+    histogram.record(-5);
+    histogram.record(BenchRunLatencyHistogram::kMaxTrackableMicros * 2);
+    ASSERT_EQ(2, histogram.getCount());
+    ASSERT_EQ(0, histogram.valueAtPercentile(50));
+    ASSERT_EQ(BenchRunLatencyHistogram::kMaxTrackableMicros, histogram.getMax());
+}
+
+TEST(BenchRunLatencyHistogramTest, UpdateFromMergesCounts) {
+    BenchRunLatencyHistogram first;
+    BenchRunLatencyHistogram second;
+    BenchRunLatencyHistogram empty;
+    for (long long micros = 1; micros <= 50; ++micros) {
+        first.record(micros);
+        second.record(micros + 50);
+    }
+    first.updateFrom(second);
+    first.updateFrom(empty);
+    ASSERT_EQ(100, first.getCount());
+    ASSERT_EQ(100, first.getMax());
+    ASSERT_EQ(50, first.valueAtPercentile(50));
+
+    empty.updateFrom(first);
+    ASSERT_EQ(100, empty.getCount());
+    ASSERT_EQ(75, empty.valueAtPercentile(75));
+}
+
+TEST(BenchRunLatencyHistogramTest, AppendsPercentiles) {
+    BenchRunLatencyHistogram histogram;
+    histogram.record(10);
+    BSONObjBuilder builder;
+    histogram.appendPercentiles(&builder);
+    ASSERT_BSONOBJ_EQ(BSON("p50" << 10LL << "p95" << 10LL << "p99" << 10LL << "p99_9" << 10LL
+                                 << "max"
+                                 << 10LL),
+                      builder.obj());
+}
+
+TEST(BenchRunEventCounterTest, TracksLatencyDistribution) {
+    BenchRunEventCounter counter;
+    counter.countOne(10);
+    counter.countOne(30);
+    ASSERT_EQ(2, counter.getNumEvents());
+    ASSERT_EQ(40U, counter.getTotalTimeMicros());
+    ASSERT_EQ(2, counter.getLatencyHistogram().getCount());
+    ASSERT_EQ(30, counter.getLatencyHistogram().getMax());
+}
+
+TEST(BenchRunEventTraceTest, CountsScheduleDelay) {
+    BenchRunEventCounter counter;
+    {
+        BenchRunEventTrace trace(&counter, 5000);
+    }
+    ASSERT_EQ(1, counter.getNumEvents());
+    ASSERT_GTE(counter.getLatencyHistogram().getMax(), 5000);
+}
+
+TEST(BenchRunConfigTest, ParsesOpsPerSecond) {
+    std::unique_ptr<BenchRunConfig> config(BenchRunConfig::createFromBson(BSONObj()));
+    ASSERT_EQ(0, config->opsPerSecond);
+
+    config.reset(BenchRunConfig::createFromBson(BSON("opsPerSecond" << 2500)));
+    ASSERT_EQ(2500, config->opsPerSecond);
+
+    ASSERT_THROWS_CODE(BenchRunConfig::createFromBson(BSON("opsPerSecond" << -1)),
+                       AssertionException,
+                       ErrorCodes::BadValue);
+    ASSERT_THROWS_CODE(BenchRunConfig::createFromBson(BSON("opsPerSecond"
+                                                           << "fast")),
+                       AssertionException,
+                       ErrorCodes::BadValue);
+}
+
+}  // namespace
+}  // namespace mongo
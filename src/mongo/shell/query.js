@@ -45,6 +45,7 @@ DBQuery.prototype.help = function() {
     print("\t.tailable(<isAwaitData>)");
     print("\t.noCursorTimeout()");
     print("\t.allowPartialResults()");
+    print("\t.allowDiskUse() - allows a blocking sort to spill to disk");
     print("\t.returnKey()");
     print("\t.showRecordId() - adds a $recordId field to each returned object");
 
@@ -225,6 +226,10 @@ DBQuery.prototype._convertToCommand = function(canAttachReadPref) {
         cmd["collation"] = this._query.collation;
     }
 
+    if ("allowDiskUse" in this._query) {
+        cmd["allowDiskUse"] = this._query.allowDiskUse;
+    }
+
     if ((this._options & DBQuery.Option.tailable) != 0) {
         cmd["tailable"] = true;
     }
@@ -471,6 +476,10 @@ DBQuery.prototype.collation = function(collationSpec) {
     return this._addSpecial("collation", collationSpec);
 };
 
+DBQuery.prototype.allowDiskUse = function() {
+    return this._addSpecial("allowDiskUse", true);
+};
+
 /**
  * Sets the read preference for this cursor.
  *
@@ -0,0 +1,146 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include <boost/filesystem/fstream.hpp>
+
+#include "mongo/base/initializer.h"
+#include "mongo/client/connection_string.h"
+#include "mongo/client/dbclient_base.h"
+#include "mongo/db/service_context.h"
+#include "mongo/scripting/bson_template_evaluator.h"
+#include "mongo/shell/bench.h"
+#include "mongo/tools/mongobench_options.h"
+#include "mongo/transport/transport_layer_asio.h"
+#include "mongo/util/exit.h"
+#include "mongo/util/log.h"
+#include "mongo/util/signal_handlers.h"
+#include "mongo/util/text.h"
+
+namespace mongo {
+namespace {
+
+int mongoBenchMain(int argc, char* argv[], char** envp) {
+    setupSignalHandlers();
+    runGlobalInitializersOrDie(argc, argv, envp);
+    startSignalProcessingThread(LogFileStatus::kNoLogFileToRotate);
+
+    log() << "MongoDB benchRun load generator, for testing purposes only";
+
+    try {
+        setGlobalServiceContext(ServiceContext::make());
+        transport::TransportLayerASIO::Options opts;
+        opts.mode = transport::TransportLayerASIO::Options::kEgress;
+
+        auto serviceContext = getGlobalServiceContext();
+        serviceContext->setTransportLayer(
+            std::make_unique<transport::TransportLayerASIO>(opts, nullptr));
+        auto tl = serviceContext->getTransportLayer();
+        uassertStatusOK(tl->setup());
+        uassertStatusOK(tl->start());
+    } catch (const std::exception& ex) {
+        error() << "Failed to start the transport layer: " << ex.what();
+        return EXIT_NET_ERROR;
+    }
+
+    try {
+        // If a "pre" section was present in the workload file, then we run its operations once
+        // before running the operations from the "ops" section.
+        if (mongoBenchGlobalParams.preConfig) {
+            const auto& preConfig = *mongoBenchGlobalParams.preConfig;
+            auto conn = preConfig.createConnection();
+            boost::optional<LogicalSessionIdToClient> lsid;
+
+            PseudoRandom rng(preConfig.randomSeed);
+            BsonTemplateEvaluator bsonTemplateEvaluator(preConfig.randomSeed);
+            BenchRunStats stats;
+            BenchRunOp::State state(&rng, &bsonTemplateEvaluator, &stats);
+
+            for (auto&& op : preConfig.ops) {
+                op.executeOnce(conn.get(), lsid, preConfig, &state);
+            }
+        }
+
+        // If an "ops" section was present in the workload file, then we repeatedly run its
+        // operations across the configured number of threads for the configured number of seconds.
+        if (mongoBenchGlobalParams.opsConfig) {
+            const double seconds = mongoBenchGlobalParams.opsConfig->seconds;
+            auto runner = std::make_unique<BenchRunner>(mongoBenchGlobalParams.opsConfig.release());
+            runner->start();
+
+            sleepmillis(static_cast<long long>(seconds * 1000));
+
+            BSONObj stats = BenchRunner::finish(runner.release());
+            log() << "writing stats to " << mongoBenchGlobalParams.outputFile.string() << ": "
+                  << stats;
+
+            boost::filesystem::ofstream outfile(mongoBenchGlobalParams.outputFile);
+            outfile << stats.jsonString() << '\n';
+        }
+    } catch (const DBException& ex) {
+        error() << "mongobench failed" << causedBy(ex);
+        shutdown(EXIT_UNCAUGHT);
+    }
+
+    shutdown(EXIT_CLEAN);
+}
+
+}  // namespace
+
+MONGO_REGISTER_SHIM(BenchRunConfig::createConnectionImpl)
+(const BenchRunConfig& config)->std::unique_ptr<DBClientBase> {
+    const ConnectionString connectionString = uassertStatusOK(ConnectionString::parse(config.host));
+
+    std::string errorMessage;
+    std::unique_ptr<DBClientBase> connection(connectionString.connect("mongobench", errorMessage));
+    uassert(ErrorCodes::HostUnreachable, errorMessage, connection);
+
+    return connection;
+}
+
+}  // namespace mongo
+
+#if defined(_WIN32)
+// In Windows, wmain() is an alternate entry point for main(), and receives the same parameters as
+// main() but encoded in Windows Unicode (UTF-16); "wide" 16-bit wchar_t characters. The
+// WindowsCommandLine object converts these wide character strings to a UTF-8 coded equivalent and
+// makes them available through the argv() and envp() members. This enables mongoBenchMain() to
+// process UTF-8 encoded arguments and environment variables without regard to platform.
+int wmain(int argc, wchar_t* argvW[], wchar_t* envpW[]) {
+    mongo::WindowsCommandLine wcl(argc, argvW, envpW);
+    return mongo::mongoBenchMain(argc, wcl.argv(), wcl.envp());
+}
+#else
+int main(int argc, char* argv[], char** envp) {
+    return mongo::mongoBenchMain(argc, argv, envp);
+}
+#endif
@@ -0,0 +1,251 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/tools/mongobench_options.h"
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <yaml-cpp/yaml.h>
+
+#include "mongo/base/parse_number.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/json.h"
+#include "mongo/platform/random.h"
+#include "mongo/shell/bench.h"
+#include "mongo/util/options_parser/startup_options.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+
+MongoBenchGlobalParams mongoBenchGlobalParams;
+
+void printMongoBenchHelp(std::ostream* out) {
+    *out << "Usage: mongobench <workload file> [options]" << std::endl;
+    *out << moe::startupOptions.helpString();
+    *out << std::flush;
+}
+
+bool handlePreValidationMongoBenchOptions(const moe::Environment& params) {
+    if (params.count("help")) {
+        printMongoBenchHelp(&std::cout);
+        return false;
+    }
+    return true;
+}
+
+namespace {
+
+void appendYamlNode(BSONObjBuilder* builder, StringData fieldName, const YAML::Node& node);
+
+void appendYamlScalar(BSONObjBuilder* builder, StringData fieldName, const YAML::Node& node) {
+    const auto& value = node.Scalar();
+
+    // yaml-cpp tags quoted scalars with "!", which keeps them strings.
+    if (node.Tag() == "!") {
+        builder->append(fieldName, value);
+        return;
+    }
+
+    if (value == "true" || value == "false") {
+        builder->append(fieldName, value == "true");
+        return;
+    }
+    if (value == "null" || value == "~") {
+        builder->appendNull(fieldName);
+        return;
+    }
+
+    long long integer;
+    if (parseNumberFromStringWithBase(value, 10, &integer).isOK()) {
+        if (integer >= std::numeric_limits<int>::min() &&
+            integer <= std::numeric_limits<int>::max()) {
+            builder->append(fieldName, static_cast<int>(integer));
+        } else {
+            builder->append(fieldName, integer);
+        }
+        return;
+    }
+
+    double number;
+    if (parseNumberFromString(value, &number).isOK()) {
+        builder->append(fieldName, number);
+        return;
+    }
+
+    builder->append(fieldName, value);
+}
+
+void appendYamlNode(BSONObjBuilder* builder, StringData fieldName, const YAML::Node& node) {
+    switch (node.Type()) {
+        case YAML::NodeType::Map: {
+            BSONObjBuilder subobj(builder->subobjStart(fieldName));
+            for (auto&& entry : node) {
+                appendYamlNode(&subobj, entry.first.Scalar(), entry.second);
+            }
+            break;
+        }
+        case YAML::NodeType::Sequence: {
+            // Arrays are objects whose field names are the element indexes.
+            BSONObjBuilder subarr(builder->subarrayStart(fieldName));
+            int index = 0;
+            for (auto&& element : node) {
+                appendYamlNode(&subarr, BSONObjBuilder::numStr(index++), element);
+            }
+            break;
+        }
+        case YAML::NodeType::Scalar:
+            appendYamlScalar(builder, fieldName, node);
+            break;
+        case YAML::NodeType::Null:
+        case YAML::NodeType::Undefined:
+            builder->appendNull(fieldName);
+            break;
+    }
+}
+
+bool isYamlFile(const std::string& filename) {
+    auto extension = boost::filesystem::path(filename).extension().string();
+    return extension == ".yml" || extension == ".yaml";
+}
+
+StatusWith<BSONObj> readWorkloadFile(const std::string& filename) {
+    std::ifstream infile(filename.c_str());
+    if (!infile) {
+        return Status(ErrorCodes::FileNotOpen,
+                      str::stream() << "Failed to open workload file " << filename);
+    }
+    std::string data((std::istreambuf_iterator<char>(infile)), std::istreambuf_iterator<char>());
+
+    if (isYamlFile(filename)) {
+        return parseYamlWorkload(data);
+    }
+    try {
+        return fromjson(data);
+    } catch (const DBException& ex) {
+        return ex.toStatus(str::stream() << "Failed to parse workload file " << filename);
+    }
+}
+
+}  // namespace
+
+StatusWith<BSONObj> parseYamlWorkload(const std::string& yaml) {
+    YAML::Node root;
+    try {
+        root = YAML::Load(yaml);
+    } catch (const YAML::Exception& ex) {
+        return Status(ErrorCodes::FailedToParse,
+                      str::stream() << "Failed to parse YAML workload: " << ex.what());
+    }
+    if (!root.IsMap()) {
+        return Status(ErrorCodes::FailedToParse, "A YAML workload must be a mapping");
+    }
+
+    BSONObjBuilder builder;
+    try {
+        for (auto&& entry : root) {
+            appendYamlNode(&builder, entry.first.Scalar(), entry.second);
+        }
+    } catch (const YAML::Exception& ex) {
+        return Status(ErrorCodes::FailedToParse,
+                      str::stream() << "Failed to convert YAML workload: " << ex.what());
+    }
+    return builder.obj();
+}
+
+Status storeMongoBenchOptions(const moe::Environment& params,
+                              const std::vector<std::string>& args) {
+    if (!params.count("workloadFile")) {
+        return {ErrorCodes::BadValue, "No workload file was specified"};
+    }
+
+    auto swConfig = readWorkloadFile(params["workloadFile"].as<std::string>());
+    if (!swConfig.isOK()) {
+        return swConfig.getStatus();
+    }
+
+    try {
+        for (auto&& elem : swConfig.getValue()) {
+            const auto fieldName = elem.fieldNameStringData();
+            if (fieldName == "pre") {
+                mongoBenchGlobalParams.preConfig.reset(
+                    BenchRunConfig::createFromBson(elem.wrap("ops")));
+            } else if (fieldName == "ops") {
+                mongoBenchGlobalParams.opsConfig.reset(
+                    BenchRunConfig::createFromBson(elem.wrap()));
+            } else {
+                return {ErrorCodes::BadValue,
+                        str::stream() << "Unrecognized key in workload file: " << fieldName};
+            }
+        }
+    } catch (const DBException& ex) {
+        return ex.toStatus("Invalid workload file");
+    }
+
+    const auto host = params["host"].as<std::string>();
+    int64_t seed = params.count("seed") ? static_cast<int64_t>(params["seed"].as<long>())
+                                        : SecureRandom::create()->nextInt64();
+
+    if (mongoBenchGlobalParams.preConfig) {
+        mongoBenchGlobalParams.preConfig->host = host;
+        mongoBenchGlobalParams.preConfig->randomSeed = seed;
+    }
+
+    if (mongoBenchGlobalParams.opsConfig) {
+        mongoBenchGlobalParams.opsConfig->host = host;
+        mongoBenchGlobalParams.opsConfig->randomSeed = seed;
+        mongoBenchGlobalParams.opsConfig->parallel = params["threads"].as<unsigned>();
+        mongoBenchGlobalParams.opsConfig->seconds = params["time"].as<double>();
+
+        if (params.count("opsPerSecond")) {
+            const auto opsPerSecond = params["opsPerSecond"].as<double>();
+            if (opsPerSecond <= 0) {
+                return {ErrorCodes::BadValue, "--opsPerSecond must be positive"};
+            }
+            mongoBenchGlobalParams.opsConfig->opsPerSecond = opsPerSecond;
+        }
+    }
+
+    mongoBenchGlobalParams.outputFile =
+        boost::filesystem::path(params["output"].as<std::string>()).lexically_normal();
+    auto parentPath = mongoBenchGlobalParams.outputFile.parent_path();
+    if (!parentPath.empty() && !boost::filesystem::exists(parentPath)) {
+        return {ErrorCodes::NonExistentPath,
+                str::stream() << "Directory containing output file must already exist, but "
+                              << parentPath.string()
+                              << " wasn't found"};
+    }
+
+    return Status::OK();
+}
+
+}  // namespace mongo
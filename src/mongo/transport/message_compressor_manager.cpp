@@ -38,6 +38,7 @@
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/rpc/message.h"
+#include "mongo/transport/message_compressor_parameters_gen.h"
 #include "mongo/transport/message_compressor_registry.h"
 #include "mongo/transport/session.h"
 #include "mongo/util/log.h"
@@ -85,6 +86,12 @@ MessageCompressorManager::MessageCompressorManager(MessageCompressorRegistry* fa
 StatusWith<Message> MessageCompressorManager::compressMessage(
     const Message& msg, const MessageCompressorId* compressorId) {
 
+    if (msg.dataSize() < gNetworkMessageCompressionMinSizeBytes.load()) {
+        LOG(3) << "Message body of " << msg.dataSize()
+               << " bytes is below the compression threshold, sending it uncompressed";
+        return {msg};
+    }
+
     MessageCompressorBase* compressor = nullptr;
     if (compressorId) {
         compressor = _registry->getCompressor(*compressorId);
@@ -36,12 +36,14 @@
 #include "mongo/stdx/memory.h"
 #include "mongo/transport/message_compressor_manager.h"
 #include "mongo/transport/message_compressor_noop.h"
+#include "mongo/transport/message_compressor_parameters_gen.h"
 #include "mongo/transport/message_compressor_registry.h"
 #include "mongo/transport/message_compressor_snappy.h"
 #include "mongo/transport/message_compressor_zlib.h"
 #include "mongo/transport/message_compressor_zstd.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 #include <string>
 #include <vector>
@@ -240,6 +242,27 @@ TEST(ZstdMessageCompressor, Fidelity) {
     checkFidelity(testMessage, stdx::make_unique<ZstdMessageCompressor>());
 }
 
+TEST(ZstdDictMessageCompressor, Fidelity) {
+    auto testMessage = buildMessage();
+    checkFidelity(testMessage,
+                  stdx::make_unique<ZstdDictMessageCompressor>("Hello, world! Hello, world!"));
+}
+
+TEST(ZstdDictMessageCompressor, DictionaryMismatchFailsToDecompress) {
+    const std::string data = "Hello, world! Hello, world! Hello, world!";
+    ZstdDictMessageCompressor compressor("Hello, world!");
+    ZstdDictMessageCompressor otherCompressor("Goodbye, world!");
+
+    std::vector<char> buffer(compressor.getMaxCompressedSize(data.size()));
+    auto sws = compressor.compressData(ConstDataRange(data.data(), data.size()),
+                                       DataRange(buffer.data(), buffer.size()));
+    ASSERT_OK(sws);
+
+    std::vector<char> scratch(data.size());
+    ASSERT_NOT_OK(otherCompressor.decompressData(ConstDataRange(buffer.data(), sws.getValue()),
+                                                 DataRange(scratch.data(), scratch.size())));
+}
+
 TEST(SnappyMessageCompressor, Overflow) {
     checkOverflow(stdx::make_unique<SnappyMessageCompressor>());
 }
@@ -252,6 +275,33 @@ TEST(ZstdMessageCompressor, Overflow) {
     checkOverflow(stdx::make_unique<ZstdMessageCompressor>());
 }
 
+TEST(ZstdDictMessageCompressor, Overflow) {
+    checkOverflow(stdx::make_unique<ZstdDictMessageCompressor>("We embrace reality."));
+}
+
+TEST(MessageCompressorManager, SmallMessagesAreNotCompressed) {
+    auto registry = buildRegistry();
+    MessageCompressorManager manager(&registry);
+    BSONObjBuilder negotiatorOut;
+    manager.serverNegotiate(BSON("isMaster" << 1 << "compression" << BSON_ARRAY("noop")),
+                            &negotiatorOut);
+
+    auto testMessage = buildMessage();
+    const auto noopId = registry.getCompressor("noop")->getId();
+    const auto originalMinSize = gNetworkMessageCompressionMinSizeBytes.load();
+    ON_BLOCK_EXIT([&] { gNetworkMessageCompressionMinSizeBytes.store(originalMinSize); });
+
+    gNetworkMessageCompressionMinSizeBytes.store(testMessage.dataSize() + 1);
+    auto sent = assertOk(manager.compressMessage(testMessage));
+    ASSERT_EQ(sent.operation(), dbQuery);
+    sent = assertOk(manager.compressMessage(testMessage, &noopId));
+    ASSERT_EQ(sent.operation(), dbQuery);
+
+    gNetworkMessageCompressionMinSizeBytes.store(testMessage.dataSize());
+    sent = assertOk(manager.compressMessage(testMessage));
+    ASSERT_EQ(sent.operation(), dbCompressed);
+}
+
 TEST(MessageCompressorManager, SERVER_28008) {
 
     // Create a client and server that will negotiate the same compressors,
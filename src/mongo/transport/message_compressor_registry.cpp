@@ -57,6 +57,8 @@ StringData getMessageCompressorName(MessageCompressor id) {
             return "zlib"_sd;
         case MessageCompressor::kZstd:
             return "zstd"_sd;
+        case MessageCompressor::kZstdDict:
+            return "zstdDict"_sd;
         default:
             fassert(40269, "Invalid message compressor ID");
     }
@@ -31,12 +31,19 @@
 
 #include "mongo/platform/basic.h"
 
+#define ZSTD_STATIC_LINKING_ONLY
 #include <zstd.h>
 
+#include <fstream>
+#include <iterator>
+
 #include "mongo/base/init.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/transport/message_compressor_parameters_gen.h"
 #include "mongo/transport/message_compressor_registry.h"
 #include "mongo/transport/message_compressor_zstd.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/log.h"
 
 namespace mongo {
 
@@ -75,7 +82,80 @@ StatusWith<std::size_t> ZstdMessageCompressor::decompressData(ConstDataRange inp
     counterHitDecompress(input.length(), ret);
     return {ret};
 }
+namespace {
+// Compression contexts are expensive to create, so each thread keeps one of each for its lifetime.
+struct ZstdContextDeleter {
+    void operator()(ZSTD_CCtx* cctx) const {
+        ZSTD_freeCCtx(cctx);
+    }
+    void operator()(ZSTD_DCtx* dctx) const {
+        ZSTD_freeDCtx(dctx);
+    }
+};
+
+ZSTD_CCtx* threadCompressionContext() {
+    static thread_local std::unique_ptr<ZSTD_CCtx, ZstdContextDeleter> cctx(ZSTD_createCCtx());
+    return cctx.get();
+}
+
+ZSTD_DCtx* threadDecompressionContext() {
+    static thread_local std::unique_ptr<ZSTD_DCtx, ZstdContextDeleter> dctx(ZSTD_createDCtx());
+    return dctx.get();
+}
+}  // namespace
+
+ZstdDictMessageCompressor::ZstdDictMessageCompressor(const std::string& dictionary)
+    : MessageCompressorBase(MessageCompressor::kZstdDict),
+      _cdict(ZSTD_createCDict(dictionary.data(), dictionary.size(), ZSTD_CLEVEL_DEFAULT)),
+      _ddict(ZSTD_createDDict(dictionary.data(), dictionary.size())) {
+    uassert(ErrorCodes::BadValue,
+            "Could not load zstd message compression dictionary",
+            _cdict && _ddict);
+}
+
+ZstdDictMessageCompressor::~ZstdDictMessageCompressor() {
+    ZSTD_freeCDict(_cdict);
+    ZSTD_freeDDict(_ddict);
+}
+
+std::size_t ZstdDictMessageCompressor::getMaxCompressedSize(size_t inputSize) {
+    return ZSTD_compressBound(inputSize);
+}
+
+StatusWith<std::size_t> ZstdDictMessageCompressor::compressData(ConstDataRange input,
+                                                                DataRange output) {
+    size_t ret = ZSTD_compress_usingCDict(threadCompressionContext(),
+                                          const_cast<char*>(output.data()),
+                                          output.length(),
+                                          input.data(),
+                                          input.length(),
+                                          _cdict);
+
+    if (ZSTD_isError(ret)) {
+        return Status{ErrorCodes::BadValue,
+                      str::stream() << "Could not compress input: " << ZSTD_getErrorName(ret)};
+    }
+    counterHitCompress(input.length(), ret);
+    return {ret};
+}
+
+StatusWith<std::size_t> ZstdDictMessageCompressor::decompressData(ConstDataRange input,
+                                                                  DataRange output) {
+    size_t ret = ZSTD_decompress_usingDDict(threadDecompressionContext(),
+                                            const_cast<char*>(output.data()),
+                                            output.length(),
+                                            input.data(),
+                                            input.length(),
+                                            _ddict);
 
+    if (ZSTD_isError(ret)) {
+        return Status{ErrorCodes::BadValue,
+                      str::stream() << "Could not decompress message: " << ZSTD_getErrorName(ret)};
+    }
+
+    counterHitDecompress(input.length(), ret);
+    return {ret};
+}
 
 MONGO_INITIALIZER_GENERAL(ZstdMessageCompressorInit,
                           ("EndStartupOptionHandling"),
@@ -85,4 +165,35 @@ MONGO_INITIALIZER_GENERAL(ZstdMessageCompressorInit,
     compressorRegistry.registerImplementation(stdx::make_unique<ZstdMessageCompressor>());
     return Status::OK();
 }
+
+// The dictionary compressor only exists when a dictionary has been configured, so listing
+// 'zstdDict' in net.compression.compressors without one fails startup.
+MONGO_INITIALIZER_GENERAL(ZstdDictMessageCompressorInit,
+                          ("EndStartupOptionHandling"),
+                          ("AllCompressorsRegistered"))
+(InitializerContext* context) {
+    const auto& path = gNetworkMessageCompressionZstdDictionaryPath;
+    if (path.empty()) {
+        return Status::OK();
+    }
+
+    std::ifstream file(path, std::ios::in | std::ios::binary);
+    if (!file) {
+        return {ErrorCodes::FileOpenFailed,
+                str::stream() << "Could not open zstd message compression dictionary " << path};
+    }
+    std::string dictionary{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+    std::unique_ptr<MessageCompressorBase> compressor;
+    try {
+        compressor = stdx::make_unique<ZstdDictMessageCompressor>(dictionary);
+    } catch (const DBException& ex) {
+        return ex.toStatus(str::stream() << "Invalid dictionary " << path);
+    }
+
+    log() << "Loaded zstd message compression dictionary " << path << " with id "
+          << ZSTD_getDictID_fromDict(dictionary.data(), dictionary.size());
+    MessageCompressorRegistry::get().registerImplementation(std::move(compressor));
+    return Status::OK();
+}
 }  // namespace mongo
@@ -27,8 +27,15 @@
  *    it in the license file.
  */
 
+#include <string>
+
 #include "mongo/transport/message_compressor_base.h"
 
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+typedef struct ZSTD_CDict_s ZSTD_CDict;
+typedef struct ZSTD_DDict_s ZSTD_DDict;
+
 namespace mongo {
 class ZstdMessageCompressor final : public MessageCompressorBase {
 public:
@@ -41,5 +48,29 @@ public:
     StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override;
 };
 
+/**
+ * A zstd compressor that primes both directions with a shared dictionary. Dictionaries trained on
+ * a deployment's own traffic let zstd find the repeated field names and values of small messages,
+ * which plain zstd cannot exploit because it starts every message with an empty window.
+ *
+ * Both ends must load the same dictionary; a frame compressed against another dictionary fails to
+ * decompress.
+ */
+class ZstdDictMessageCompressor final : public MessageCompressorBase {
+public:
+    explicit ZstdDictMessageCompressor(const std::string& dictionary);
+    ~ZstdDictMessageCompressor();
+
+    std::size_t getMaxCompressedSize(size_t inputSize) override;
+
+    StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) override;
+
+    StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override;
+
+private:
+    ZSTD_CDict* _cdict;
+    ZSTD_DDict* _ddict;
+};
+
 
 }  // namespace mongo
@@ -36,11 +36,18 @@
 #include <array>
 #include <random>
 
+#ifdef __linux__
+#include <fstream>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 #include "mongo/transport/service_entry_point_utils.h"
 #include "mongo/transport/service_executor_gen.h"
 #include "mongo/transport/service_executor_task_names.h"
 #include "mongo/util/concurrency/thread_name.h"
 #include "mongo/util/duration.h"
+#include "mongo/util/errno_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/scopeguard.h"
@@ -66,6 +73,12 @@ constexpr auto kStuckDetection = "stuckThreadsDetected"_sd;
 constexpr auto kStarvation = "starvation"_sd;
 constexpr auto kReserveMinimum = "belowReserveMinimum"_sd;
 constexpr auto kThreadReasons = "threadCreationCauses"_sd;
+constexpr auto kTotalTasksStolen = "totalTasksStolen"_sd;
+constexpr auto kWorkers = "workers"_sd;
+constexpr auto kWorkerThreadId = "threadId"_sd;
+constexpr auto kQueueDepth = "queueDepth"_sd;
+constexpr auto kExecutedLocally = "executedLocally"_sd;
+constexpr auto kTasksStolen = "tasksStolen"_sd;
 
 int64_t ticksToMicros(TickSource::Tick ticks, TickSource* tickSource) {
     invariant(tickSource->getTicksPerSecond() >= 1000000);
@@ -117,6 +130,18 @@ struct ServerParameterOptions : public ServiceExecutorAdaptive::Options {
     int recursionLimit() const final {
         return adaptiveServiceExecutorRecursionLimit.load();
     }
+
+    bool useWorkerQueues() const final {
+        return adaptiveServiceExecutorUseWorkerQueues.load();
+    }
+
+    bool pinWorkerThreads() const final {
+        return adaptiveServiceExecutorPinWorkerThreads.load();
+    }
+
+    bool pinWorkerThreadsToNumaNodes() const final {
+        return adaptiveServiceExecutorPinWorkerThreadsToNumaNodes.load();
+    }
 };
 
 }  // namespace
@@ -142,6 +167,49 @@ ServiceExecutorAdaptive::~ServiceExecutorAdaptive() {
 
 Status ServiceExecutorAdaptive::start() {
     invariant(!_isRunning.load());
+
+#ifdef __linux__
+    cpu_set_t cpus;
+    if (sched_getaffinity(0, sizeof(cpus), &cpus) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &cpus)) {
+                _availableCpus.push_back(cpu);
+            }
+        }
+
+        if (_config->pinWorkerThreadsToNumaNodes()) {
+            for (int node = 0;; ++node) {
+                std::ifstream cpuListFile(str::stream() << "/sys/devices/system/node/node" << node
+                                                        << "/cpulist");
+                if (!cpuListFile) {
+                    break;
+                }
+                std::string cpuList;
+                std::getline(cpuListFile, cpuList);
+
+                std::vector<int> nodeCpus;
+                for (int cpu : parseCpuList(cpuList)) {
+                    if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &cpus)) {
+                        nodeCpus.push_back(cpu);
+                    }
+                }
+                if (!nodeCpus.empty()) {
+                    _numaNodeCpus.push_back(std::move(nodeCpus));
+                }
+            }
+
+            if (_numaNodeCpus.size() < 2) {
+                log() << "Not pinning worker threads to NUMA nodes, since this process may "
+                      << "only run on " << _numaNodeCpus.size() << " NUMA node(s)";
+                _numaNodeCpus.clear();
+            } else {
+                log() << "Spreading worker threads across " << _numaNodeCpus.size()
+                      << " NUMA nodes";
+            }
+        }
+    }
+#endif
+
     _isRunning.store(true);
     _controllerThread = stdx::thread(&ServiceExecutorAdaptive::_controllerThreadRoutine, this);
     for (auto i = 0; i < _config->reservedThreads(); i++) {
@@ -210,6 +278,11 @@ Status ServiceExecutorAdaptive::schedule(ServiceExecutorAdaptive::Task task,
         task();
         _localThreadState->threadMetrics[static_cast<size_t>(taskName)]
             ._totalSpentExecuting.addAndFetch(_localTimer.sinceStartTicks());
+
+        // Once the outermost task returns, run the tasks it queued on this worker.
+        if (_localThreadState->recursionDepth == 1) {
+            _drainWorkerQueue();
+        }
     };
 
     // Dispatching a task on the io_context will run the task immediately, and may run it
@@ -219,9 +292,15 @@ Status ServiceExecutorAdaptive::schedule(ServiceExecutorAdaptive::Task task,
     //
     // If the task is allowed to recurse and we are not over the depth limit, dispatch it so it
     // can be called immediately and recursively.
+    //
+    // Otherwise, a task scheduled from one of this executor's worker threads is queued on that
+    // worker so that a connection tends to stay on the same thread.
     if ((flags & kMayRecurse) &&
         (_localThreadState->recursionDepth + 1 < _config->recursionLimit())) {
         _reactorHandle->dispatch(std::move(wrappedTask));
+    } else if (_localThreadState && _localThreadState->executor == this &&
+               _config->useWorkerQueues()) {
+        _queueOnWorker(std::move(wrappedTask));
     } else {
         _reactorHandle->schedule(std::move(wrappedTask));
     }
@@ -259,6 +338,58 @@ bool ServiceExecutorAdaptive::_isStarved() const {
     return (tasksQueued > available);
 }
 
+void ServiceExecutorAdaptive::_queueOnWorker(Reactor::Task task) {
+    auto queue = _localThreadState->queue;
+    {
+        stdx::lock_guard<stdx::mutex> lk(queue->mutex);
+        queue->tasks.push_back(std::move(task));
+    }
+
+    // Every queued task is paired with a handler on the reactor, so that an idle worker can steal
+    // it while this one is still busy. Handlers whose task this worker already ran do nothing.
+    _reactorHandle->schedule([this, queue](Status) { _runQueuedTask(queue); });
+}
+
+void ServiceExecutorAdaptive::_runQueuedTask(const std::shared_ptr<WorkerQueue>& queue) {
+    Reactor::Task task;
+    {
+        stdx::lock_guard<stdx::mutex> lk(queue->mutex);
+        if (queue->tasks.empty()) {
+            return;
+        }
+        task = std::move(queue->tasks.front());
+        queue->tasks.pop_front();
+    }
+
+    if (_localThreadState && queue == _localThreadState->queue) {
+        queue->executedLocally.addAndFetch(1);
+    } else {
+        queue->stolen.addAndFetch(1);
+    }
+    task(Status::OK());
+}
+
+void ServiceExecutorAdaptive::_drainWorkerQueue() {
+    auto& queue = *_localThreadState->queue;
+
+    // Tasks are run oldest first so that a connection generating a steady stream of tasks can't
+    // starve the others queued on this worker.
+    while (_isRunning.load()) {
+        Reactor::Task task;
+        {
+            stdx::lock_guard<stdx::mutex> lk(queue.mutex);
+            if (queue.tasks.empty()) {
+                return;
+            }
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+
+        queue.executedLocally.addAndFetch(1);
+        task(Status::OK());
+    }
+}
+
 /*
  * The pool of worker threads can become unhealthy in several ways, and the controller thread
  * tries to keep the pool healthy by starting new threads when it is:
@@ -430,6 +561,8 @@ void ServiceExecutorAdaptive::_startWorkerThread(ThreadCreationReason reason) {
     stdx::unique_lock<stdx::mutex> lk(_threadsMutex);
     auto it = _threads.emplace(_threads.begin(), _tickSource);
     auto num = _threads.size();
+    it->executor = this;
+    it->threadId = num;
 
     _threadsPending.addAndFetch(1);
     _threadsRunning.addAndFetch(1);
@@ -450,6 +583,86 @@ void ServiceExecutorAdaptive::_startWorkerThread(ThreadCreationReason reason) {
     }
 }
 
+std::vector<int> ServiceExecutorAdaptive::parseCpuList(StringData cpuList) {
+    // Far more CPUs than any host has; bounds the ranges we expand.
+    const int kMaxCpu = 1 << 16;
+
+    std::vector<int> cpus;
+    size_t pos = 0;
+    auto parseNumber = [&](int* out) {
+        const size_t start = pos;
+        int value = 0;
+        while (pos < cpuList.size() && cpuList[pos] >= '0' && cpuList[pos] <= '9') {
+            value = value * 10 + (cpuList[pos++] - '0');
+            if (value > kMaxCpu) {
+                return false;
+            }
+        }
+        *out = value;
+        return pos > start;
+    };
+
+    while (pos < cpuList.size() && cpuList[pos] != '\n') {
+        int first, last;
+        if (!parseNumber(&first)) {
+            return {};
+        }
+        last = first;
+        if (pos < cpuList.size() && cpuList[pos] == '-') {
+            ++pos;
+            if (!parseNumber(&last) || last < first) {
+                return {};
+            }
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+        if (pos < cpuList.size() && cpuList[pos] == ',') {
+            ++pos;
+        }
+    }
+    return cpus;
+}
+
+void ServiceExecutorAdaptive::_pinWorkerThread(int threadId) const {
+#ifdef __linux__
+    if (!_numaNodeCpus.empty()) {
+        const auto node = threadId % _numaNodeCpus.size();
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (int cpu : _numaNodeCpus[node]) {
+            CPU_SET(cpu, &cpus);
+        }
+        int err = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (err != 0) {
+            warning() << "Failed to pin worker thread " << threadId << " to NUMA node " << node
+                      << ": " << errnoWithDescription(err);
+            return;
+        }
+        LOG(1) << "Pinned worker thread " << threadId << " to NUMA node " << node;
+        return;
+    }
+#endif
+
+    if (!_config->pinWorkerThreads() || _availableCpus.empty()) {
+        return;
+    }
+
+#ifdef __linux__
+    const int cpu = _availableCpus[threadId % _availableCpus.size()];
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    int err = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    if (err != 0) {
+        warning() << "Failed to pin worker thread " << threadId << " to CPU " << cpu << ": "
+                  << errnoWithDescription(err);
+        return;
+    }
+    LOG(1) << "Pinned worker thread " << threadId << " to CPU " << cpu;
+#endif
+}
+
 Milliseconds ServiceExecutorAdaptive::_getThreadJitter() const {
     static stdx::mutex jitterMutex;
     static std::default_random_engine randomEngine = [] {
@@ -528,6 +741,7 @@ void ServiceExecutorAdaptive::_workerThreadRoutine(
     }
 
     log() << "Started new database worker thread " << threadId;
+    _pinWorkerThread(threadId);
 
     bool guardThreadsRunning = true;
     const auto guard = makeGuard([this, &guardThreadsRunning, state] {
@@ -536,9 +750,23 @@ void ServiceExecutorAdaptive::_workerThreadRoutine(
         _pastThreadsSpentRunning.addAndFetch(state->running.totalTime());
         _pastThreadsSpentExecuting.addAndFetch(state->executing.totalTime());
 
+        // Hand the tasks still queued on this thread back to the reactor; the handlers that were
+        // posted to steal them will find the queue empty.
+        std::deque<Reactor::Task> orphanedTasks;
+        {
+            stdx::lock_guard<stdx::mutex> lk(state->queue->mutex);
+            orphanedTasks.swap(state->queue->tasks);
+        }
+        if (_isRunning.load()) {
+            for (auto&& task : orphanedTasks) {
+                _reactorHandle->schedule(std::move(task));
+            }
+        }
+
         _accumulateTaskMetrics(&_accumulatedMetrics, state->threadMetrics);
         {
             stdx::lock_guard<stdx::mutex> lk(_threadsMutex);
+            _pastThreadsTasksStolen.addAndFetch(state->queue->stolen.load());
             _threads.erase(state);
         }
         _deathCondition.notify_one();
@@ -652,6 +880,26 @@ void ServiceExecutorAdaptive::appendStats(BSONObjBuilder* bob) const {
 
     threadStartReasons.doneFast();
 
+    int64_t totalTasksStolen = _pastThreadsTasksStolen.load();
+    BSONArrayBuilder workers(bob->subarrayStart(kWorkers));
+    for (auto& thread : _threads) {
+        size_t queueDepth;
+        {
+            stdx::lock_guard<stdx::mutex> queueLk(thread.queue->mutex);
+            queueDepth = thread.queue->tasks.size();
+        }
+        auto tasksStolen = thread.queue->stolen.load();
+        totalTasksStolen += tasksStolen;
+
+        BSONObjBuilder worker(workers.subobjStart());
+        worker << kWorkerThreadId << thread.threadId << kQueueDepth
+               << static_cast<long long>(queueDepth) << kExecutedLocally
+               << thread.queue->executedLocally.load() << kTasksStolen << tasksStolen;
+        worker.doneFast();
+    }
+    workers.doneFast();
+    *bob << kTotalTasksStolen << totalTasksStolen;
+
     BSONObjBuilder metricsByTask(bob->subobjStart("metricsByTask"));
     MetricsArray totalMetrics;
     _accumulateAllTaskMetrics(&totalMetrics, lk);
@@ -30,6 +30,8 @@
 #pragma once
 
 #include <array>
+#include <deque>
+#include <memory>
 #include <vector>
 
 #include "mongo/db/service_context.h"
@@ -80,6 +82,18 @@ public:
         // The maximum allowable depth of recursion for tasks scheduled with the MayRecurse flag
         // before stack unwinding is forced.
         virtual int recursionLimit() const = 0;
+
+        // Whether tasks scheduled from a worker thread are queued on that worker, so that a
+        // connection's next task stays on the thread that ran its previous one unless another
+        // worker steals it.
+        virtual bool useWorkerQueues() const = 0;
+
+        // Whether each worker thread is pinned to its own CPU.
+        virtual bool pinWorkerThreads() const = 0;
+
+        // Whether worker threads are spread across NUMA nodes, each restricted to the CPUs of its
+        // node.
+        virtual bool pinWorkerThreadsToNumaNodes() const = 0;
     };
 
     explicit ServiceExecutorAdaptive(ServiceContext* ctx, ReactorHandle reactor);
@@ -105,6 +119,13 @@ public:
         return _threadsRunning.load();
     }
 
+    /**
+     * Parses a Linux CPU list such as "0-3,8,10-11", as found in
+     * /sys/devices/system/node/node<N>/cpulist, into the CPU numbers it names. Returns an empty
+     * list if 'cpuList' is malformed.
+     */
+    static std::vector<int> parseCpuList(StringData cpuList);
+
 private:
     class TickTimer {
     public:
@@ -180,6 +201,18 @@ private:
     enum class ThreadCreationReason { kStuckDetection, kStarvation, kReserveMinimum, kMax };
     enum class ThreadTimer { kRunning, kExecuting };
 
+    /**
+     * The tasks a worker thread scheduled for itself. The owning thread runs them in order once its
+     * current task completes, while any other worker may steal the oldest one. It is shared with
+     * the steal handlers posted on the reactor, which may outlive the worker.
+     */
+    struct WorkerQueue {
+        stdx::mutex mutex;
+        std::deque<Reactor::Task> tasks;
+        AtomicWord<int64_t> executedLocally{0};
+        AtomicWord<int64_t> stolen{0};
+    };
+
     struct ThreadState {
         ThreadState(TickSource* ts) : running(ts), executing(ts) {}
 
@@ -189,6 +222,10 @@ private:
         MetricsArray threadMetrics;
         std::int64_t markIdleCounter = 0;
         int recursionDepth = 0;
+
+        const ServiceExecutorAdaptive* executor = nullptr;
+        int threadId = 0;
+        std::shared_ptr<WorkerQueue> queue = std::make_shared<WorkerQueue>();
     };
 
     using ThreadList = stdx::list<ThreadState>;
@@ -199,6 +236,11 @@ private:
     void _controllerThreadRoutine();
     bool _isStarved() const;
     Milliseconds _getThreadJitter() const;
+    void _pinWorkerThread(int threadId) const;
+
+    void _queueOnWorker(Reactor::Task task);
+    void _runQueuedTask(const std::shared_ptr<WorkerQueue>& queue);
+    void _drainWorkerQueue();
 
     void _accumulateTaskMetrics(MetricsArray* outArray, const MetricsArray& inputArray) const;
     void _accumulateAllTaskMetrics(MetricsArray* outputMetricsArray,
@@ -228,8 +270,16 @@ private:
     TickTimer _lastScheduleTimer;
     AtomicWord<TickSource::Tick> _pastThreadsSpentExecuting{0};
     AtomicWord<TickSource::Tick> _pastThreadsSpentRunning{0};
+    AtomicWord<int64_t> _pastThreadsTasksStolen{0};
     static thread_local ThreadState* _localThreadState;
 
+    // The CPUs this process may run on, in the order worker threads get pinned to them.
+    std::vector<int> _availableCpus;
+
+    // The CPUs this process may run on, grouped by NUMA node. Only populated when worker threads
+    // are pinned to NUMA nodes and the host has more than one node.
+    std::vector<std::vector<int>> _numaNodeCpus;
+
     // These counters are only used for reporting in serverStatus.
     AtomicWord<int64_t> _totalQueued{0};
     AtomicWord<int64_t> _totalExecuted{0};
@@ -73,6 +73,18 @@ struct TestOptions : public ServiceExecutorAdaptive::Options {
     int recursionLimit() const final {
         return 0;
     }
+
+    bool useWorkerQueues() const final {
+        return true;
+    }
+
+    bool pinWorkerThreads() const final {
+        return false;
+    }
+
+    bool pinWorkerThreadsToNumaNodes() const final {
+        return false;
+    }
 };
 
 struct RecursionOptions : public ServiceExecutorAdaptive::Options {
@@ -103,6 +115,18 @@ struct RecursionOptions : public ServiceExecutorAdaptive::Options {
     int recursionLimit() const final {
         return 10;
     }
+
+    bool useWorkerQueues() const final {
+        return true;
+    }
+
+    bool pinWorkerThreads() const final {
+        return false;
+    }
+
+    bool pinWorkerThreadsToNumaNodes() const final {
+        return false;
+    }
 };
 
 class ServiceExecutorAdaptiveFixture : public unittest::Test {
@@ -391,5 +415,15 @@ TEST_F(ServiceExecutorAdaptiveFixture, TestDeferredTasks) {
     waitForCallback(0);
 }
 
+TEST(ServiceExecutorAdaptive, ParseCpuList) {
+    ASSERT_TRUE(ServiceExecutorAdaptive::parseCpuList("0-3,8,10-11\n") ==
+                (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    ASSERT_TRUE(ServiceExecutorAdaptive::parseCpuList("5") == std::vector<int>{5});
+    ASSERT_TRUE(ServiceExecutorAdaptive::parseCpuList("").empty());
+    ASSERT_TRUE(ServiceExecutorAdaptive::parseCpuList("3-1").empty());
+    ASSERT_TRUE(ServiceExecutorAdaptive::parseCpuList("0-").empty());
+    ASSERT_TRUE(ServiceExecutorAdaptive::parseCpuList("a,b").empty());
+}
+
 }  // namespace
 }  // namespace mongo
@@ -81,6 +81,14 @@ struct TestOptions : public ServiceExecutorAdaptive::Options {
     int recursionLimit() const final {
         return 0;
     }
+
+    bool useWorkerQueues() const final {
+        return true;
+    }
+
+    bool pinWorkerThreads() const final {
+        return false;
+    }
 };
 
 /* This implements the portions of the transport::Reactor based on ASIO, but leaves out
@@ -206,6 +214,46 @@ TEST_F(ServiceExecutorAdaptiveFixture, ScheduleFailsBeforeStartup) {
     scheduleBasicTask(executor.get(), false);
 }
 
+TEST_F(ServiceExecutorAdaptiveFixture, QueuedTaskIsStolenFromBusyWorker) {
+    ASSERT_OK(executor->start());
+    auto guard = makeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
+
+    stdx::condition_variable cond;
+    stdx::mutex mutex;
+    bool queuedTaskRan = false;
+    bool outerTaskDone = false;
+
+    auto outerTask = [&] {
+        // Scheduling from a worker queues the task on that worker, which stays busy until another
+        // worker steals and runs it.
+        ASSERT_OK(executor->schedule(
+            [&] {
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                queuedTaskRan = true;
+                cond.notify_all();
+            },
+            ServiceExecutor::kEmptyFlags,
+            ServiceExecutorTaskName::kSSMProcessMessage));
+
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cond.wait(lk, [&] { return queuedTaskRan; });
+        outerTaskDone = true;
+        cond.notify_all();
+    };
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    ASSERT_OK(executor->schedule(std::move(outerTask),
+                                 ServiceExecutor::kEmptyFlags,
+                                 ServiceExecutorTaskName::kSSMStartSession));
+    ASSERT_TRUE(cond.wait_for(
+        lk, kWorkerThreadRunTime.toSystemDuration(), [&] { return outerTaskDone; }));
+    lk.unlock();
+
+    BSONObjBuilder bob;
+    executor->appendStats(&bob);
+    ASSERT_EQ(bob.obj()["totalTasksStolen"].numberLong(), 1);
+}
+
 TEST_F(ServiceExecutorSynchronousFixture, BasicTaskRuns) {
     ASSERT_OK(executor->start());
     auto guard = makeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <memory>
 #include <utility>
 
 #include "mongo/base/system_error.h"
@@ -37,6 +38,7 @@
 #include "mongo/transport/asio_utils.h"
 #include "mongo/transport/baton.h"
 #include "mongo/transport/transport_layer_asio.h"
+#include "mongo/transport/transport_layer_asio_gen.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/net/socket_utils.h"
 #ifdef MONGO_CONFIG_SSL
@@ -83,7 +85,8 @@ public:
     ASIOSession(TransportLayerASIO* tl, GenericSocket socket, bool isIngressSession) try
         : _socket(std::move(socket)),
           _tl(tl),
-          _isIngressSession(isIngressSession) {
+          _isIngressSession(isIngressSession),
+          _readAheadBufferSize(static_cast<size_t>(gTransportLayerASIOReadAheadBytes)) {
         auto family = endpointToSockAddr(_socket.local_endpoint()).getType();
         if (family == AF_INET || family == AF_INET6) {
             _socket.set_option(asio::ip::tcp::no_delay(true));
@@ -180,6 +183,10 @@ public:
         if (!getSocket().is_open())
             return false;
 
+        // Bytes which were already read ahead off the socket are still waiting to be consumed.
+        if (_readAheadBegin < _readAheadEnd)
+            return true;
+
         auto swPollEvents = pollASIOSocket(getSocket(), POLLIN, Milliseconds{0});
         if (!swPollEvents.isOK()) {
             if (swPollEvents != ErrorCodes::NetworkTimeout) {
@@ -222,6 +229,7 @@ protected:
 
         _sslSocket.emplace(
             std::move(_socket), *_tl->_egressSSLContext, removeFQDNRoot(target.host()));
+        getSSLManager()->prepareClientSessionResumption(_sslSocket->native_handle(), target);
         lk.unlock();
 
         auto doHandshake = [&] {
@@ -407,7 +415,51 @@ private:
                 });
         }
 #endif
-        return opportunisticRead(_socket, buffers, baton);
+        return readAheadRead(buffers, baton);
+    }
+
+    /**
+     * Reads into 'buffers' from the plain socket, first draining any bytes left over in the
+     * read-ahead buffer. When read-ahead is enabled and the remainder of the request is smaller
+     * than the read-ahead buffer, a single read_some() fills the buffer with whatever the socket
+     * has available, so that a message's header and body are usually received by one recv().
+     */
+    template <typename MutableBufferSequence>
+    Future<void> readAheadRead(const MutableBufferSequence& buffers, const BatonHandle& baton) {
+        MutableBufferSequence remaining(buffers);
+        while (true) {
+            const auto copied = asio::buffer_copy(
+                remaining,
+                asio::buffer(_readAheadBuffer.get() + _readAheadBegin,
+                             _readAheadEnd - _readAheadBegin));
+            _readAheadBegin += copied;
+            remaining += copied;
+            if (asio::buffer_size(remaining) == 0) {
+                return Future<void>::makeReady();
+            }
+
+            if (asio::buffer_size(remaining) >= _readAheadBufferSize ||
+                MONGO_FAIL_POINT(transportLayerASIOshortOpportunisticReadWrite)) {
+                return opportunisticRead(_socket, remaining, baton);
+            }
+
+            if (!_readAheadBuffer) {
+                _readAheadBuffer = std::make_unique<char[]>(_readAheadBufferSize);
+            }
+
+            std::error_code ec;
+            _readAheadBegin = 0;
+            _readAheadEnd = _socket.read_some(
+                asio::buffer(_readAheadBuffer.get(), _readAheadBufferSize), ec);
+            if (((ec == asio::error::would_block) || (ec == asio::error::try_again)) &&
+                (_blockingMode == Async)) {
+                // Nothing is available yet, so wait for the rest of the request directly rather
+                // than arranging to be woken up for the read-ahead buffer.
+                return opportunisticRead(_socket, remaining, baton);
+            } else if (ec) {
+                return futurize(ec);
+            }
+        }
     }
 
     template <typename ConstBufferSequence>
@@ -710,6 +762,13 @@ private:
 
     TransportLayerASIO* const _tl;
     bool _isIngressSession;
+
+    // Bytes in [_readAheadBegin, _readAheadEnd) of _readAheadBuffer were read off the socket but
+    // not yet consumed. The buffer is allocated on first use and only when read-ahead is enabled.
+    const size_t _readAheadBufferSize;
+    std::unique_ptr<char[]> _readAheadBuffer;
+    size_t _readAheadBegin = 0;
+    size_t _readAheadEnd = 0;
 };
 
 }  // namespace transport
@@ -35,10 +35,12 @@
 #include "mongo/db/server_options.h"
 #include "mongo/rpc/op_msg.h"
 #include "mongo/transport/service_entry_point.h"
+#include "mongo/transport/transport_layer_asio_gen.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/sock.h"
+#include "mongo/util/scopeguard.h"
 
 #include "asio.hpp"
 
@@ -254,14 +256,24 @@ public:
     }
 
     void sendMessage() {
+        sendPipelinedMessages(1);
+    }
+
+    // Sends 'count' messages back to back with a single write.
+    void sendPipelinedMessages(size_t count) {
         OpMsgBuilder builder;
         builder.setBody(BSON("ping" << 1));
         Message msg = builder.finish();
         msg.header().setResponseToMsgId(0);
         msg.header().setId(0);
 
+        std::string buf;
+        for (size_t i = 0; i < count; ++i) {
+            buf.append(msg.buf(), msg.size());
+        }
+
         std::error_code ec;
-        asio::write(_sock, asio::buffer(msg.buf(), msg.size()), ec);
+        asio::write(_sock, asio::buffer(buf.data(), buf.size()), ec);
         ASSERT_FALSE(ec);
     }
 
@@ -363,5 +375,40 @@ TEST(TransportLayerASIO, SwitchTimeoutModes) {
     tla->shutdown();
 }
 
+/* check that messages received together are all sourced when reading ahead off the socket */
+class ReadAheadSEP : public TimeoutSEP {
+public:
+    void startSession(transport::SessionHandle session) override {
+        log() << "Accepted connection from " << session->remote();
+        stdx::thread([ this, session = std::move(session) ]() mutable {
+            for (int i = 0; i < 3; ++i) {
+                auto swMsg = session->sourceMessage();
+                ASSERT_OK(swMsg.getStatus());
+                auto request = OpMsg::parse(swMsg.getValue());
+                ASSERT_BSONOBJ_EQ(request.body, BSON("ping" << 1));
+            }
+
+            session.reset();
+            notifyComplete();
+        }).detach();
+    }
+};
+
+TEST(TransportLayerASIO, SourcePipelinedMessagesWithReadAhead) {
+    const auto oldReadAheadBytes = transport::gTransportLayerASIOReadAheadBytes;
+    transport::gTransportLayerASIOReadAheadBytes = 64;
+    ON_BLOCK_EXIT([&] { transport::gTransportLayerASIOReadAheadBytes = oldReadAheadBytes; });
+
+    ReadAheadSEP sep;
+    auto tla = makeAndStartTL(&sep);
+
+    // With a read-ahead buffer smaller than the three messages, some messages span reads.
+    TimeoutConnector connector(tla->listenerPort(), false);
+    connector.sendPipelinedMessages(3);
+
+    sep.waitForTimeout();
+    tla->shutdown();
+}
+
 }  // namespace
 }  // namespace mongo
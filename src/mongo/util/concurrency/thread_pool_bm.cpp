@@ -0,0 +1,148 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+namespace mongo {
+namespace {
+
+std::unique_ptr<ThreadPoolInterface> makeThreadPool(size_t numThreads) {
+    ThreadPool::Options options;
+    options.minThreads = numThreads;
+    options.maxThreads = numThreads;
+    return stdx::make_unique<ThreadPool>(options);
+}
+
+std::unique_ptr<ThreadPoolInterface> makeWorkStealingThreadPool(size_t numThreads) {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = numThreads;
+    return stdx::make_unique<WorkStealingThreadPool>(options);
+}
+
+/**
+ * Counts down as tasks complete and lets one thread wait for all of them.
+ */
+class Latch {
+public:
+    explicit Latch(int count) : _count(count) {}
+
+    void countDown() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (--_count == 0) {
+            _cv.notify_all();
+        }
+    }
+
+    void wait() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _cv.wait(lk, [this] { return _count == 0; });
+    }
+
+private:
+    stdx::mutex _mutex;
+    stdx::condition_variable _cv;
+    int _count;
+};
+
+void doWork(int iterations) {
+    for (int i = 0; i < iterations; ++i) {
+        benchmark::ClobberMemory();
+    }
+}
+
+/**
+ * Schedules one batch of state.range(0) small tasks from outside the pool and waits for all of
+ * them, the way the oplog applier hands a batch to its writer threads.
+ */
+template <std::unique_ptr<ThreadPoolInterface> (*makePool)(size_t)>
+void BM_batchFanOut(benchmark::State& state) {
+    const int numTasks = state.range(0);
+    auto pool = makePool(state.range(1));
+    pool->startup();
+    for (auto _ : state) {
+        Latch latch(numTasks);
+        for (int i = 0; i < numTasks; ++i) {
+            pool->schedule([&latch](auto status) {
+                doWork(1000);
+                latch.countDown();
+            });
+        }
+        latch.wait();
+    }
+    pool->shutdown();
+    pool->join();
+    state.SetItemsProcessed(state.iterations() * numTasks);
+}
+
+/**
+ * Schedules one task which recursively splits into a binary tree of state.range(0) leaf tasks, so
+ * that most tasks are scheduled from inside the pool.
+ */
+template <std::unique_ptr<ThreadPoolInterface> (*makePool)(size_t)>
+void BM_recursiveSplit(benchmark::State& state) {
+    const int numLeaves = state.range(0);
+    auto pool = makePool(state.range(1));
+    pool->startup();
+    for (auto _ : state) {
+        Latch latch(numLeaves);
+        stdx::function<void(int)> split = [&](int leaves) {
+            if (leaves == 1) {
+                doWork(1000);
+                latch.countDown();
+                return;
+            }
+            pool->schedule([&split, leaves](auto status) { split(leaves / 2); });
+            pool->schedule([&split, leaves](auto status) { split(leaves - leaves / 2); });
+        };
+        pool->schedule([&split, numLeaves](auto status) { split(numLeaves); });
+        latch.wait();
+    }
+    pool->shutdown();
+    pool->join();
+    state.SetItemsProcessed(state.iterations() * numLeaves);
+}
+
+BENCHMARK_TEMPLATE(BM_batchFanOut, makeThreadPool)->Args({16, 16})->Args({1024, 16});
+BENCHMARK_TEMPLATE(BM_batchFanOut, makeWorkStealingThreadPool)->Args({16, 16})->Args({1024, 16});
+BENCHMARK_TEMPLATE(BM_recursiveSplit, makeThreadPool)->Args({1024, 4})->Args({1024, 16});
+BENCHMARK_TEMPLATE(BM_recursiveSplit, makeWorkStealingThreadPool)
+    ->Args({1024, 4})
+    ->Args({1024, 16});
+
+}  // namespace
+}  // namespace mongo
@@ -33,13 +33,282 @@
 
 #include "mongo/util/concurrency/ticketholder.h"
 
+#include <algorithm>
+#include <array>
+#include <deque>
 #include <iostream>
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/util/log.h"
 #include "mongo/util/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
+namespace {
+
+struct AdmissionPriorityDecoration {
+    AdmissionPriority priority = AdmissionPriority::kNormal;
+};
+
+const auto getAdmissionPriorityDecoration =
+    OperationContext::declareDecoration<AdmissionPriorityDecoration>();
+
+}  // namespace
+
+/**
+ * Hands out tickets to waiters queued by priority class. Within a class waiters are admitted in
+ * arrival order; across classes, stride scheduling admits each class in proportion to its weight.
+ */
+class TicketHolder::PriorityAdmission {
+public:
+    PriorityAdmission(TicketHolder* holder, int available)
+        : _holder(holder), _available(available) {}
+
+    bool tryAcquire() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _tryAcquire_inlock();
+    }
+
+    bool waitForTicketUntil(OperationContext* opCtx,
+                            Date_t until,
+                            AdmissionPriority priority,
+                            bool timeSliced) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        auto& priorityClass = _classes[static_cast<int>(priority)];
+        if (timeSliced)
+            priorityClass.timeSliced++;
+
+        if (_tryAcquire_inlock()) {
+            priorityClass.recordAdmission(Microseconds(0));
+            return true;
+        }
+
+        // A class that was idle joins at the current virtual time, so it cannot claim the turns
+        // it did not use while it had no waiters.
+        if (priorityClass.waiters.empty())
+            priorityClass.pass = std::max(priorityClass.pass, _virtualTime);
+
+        Waiter waiter;
+        priorityClass.waiters.push_back(&waiter);
+        _numWaiters++;
+
+        Timer timer;
+        auto granted = [&waiter] { return waiter.granted; };
+        bool acquired;
+        try {
+            if (opCtx) {
+                acquired = opCtx->waitForConditionOrInterruptUntil(waiter.cv, lk, until, granted);
+            } else {
+                acquired = waiter.cv.wait_until(lk, until.toSystemTimePoint(), granted);
+            }
+        } catch (...) {
+            _abandon_inlock(&waiter, &priorityClass);
+            throw;
+        }
+
+        if (!acquired) {
+            _abandon_inlock(&waiter, &priorityClass);
+            return false;
+        }
+        const Microseconds wait(timer.micros());
+        priorityClass.recordAdmission(wait);
+        _holder->_recordQueuedWait(wait);
+        return true;
+    }
+
+    void release() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _release_inlock();
+    }
+
+    /**
+     * Adds 'delta' tickets. Shrinking may leave fewer than zero available, in which case
+     * released tickets are retired until the count is positive again.
+     */
+    void resize(int delta) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _available += delta;
+        while (_available > 0 && _numWaiters > 0) {
+            _available--;
+            _grantNext_inlock();
+        }
+    }
+
+    int available() const {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _available;
+    }
+
+    void appendStats(BSONObjBuilder* builder) const {
+        static constexpr std::array<const char*, kNumPriorities> kNames{"low", "normal", "high"};
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        for (int i = 0; i < kNumPriorities; i++) {
+            const auto& priorityClass = _classes[i];
+            BSONObjBuilder classBuilder(builder->subobjStart(kNames[i]));
+            classBuilder.append("weight", kWeights[i]);
+            classBuilder.append("queued", static_cast<int>(priorityClass.waiters.size()));
+            classBuilder.append("admitted", priorityClass.admitted);
+            classBuilder.append("timeSliced", priorityClass.timeSliced);
+            classBuilder.append("totalWaitMicros", priorityClass.totalWaitMicros);
+
+            BSONObjBuilder histogramBuilder(classBuilder.subobjStart("waitMillis"));
+            for (size_t bucket = 0; bucket < kWaitBucketNames.size(); bucket++) {
+                histogramBuilder.append(kWaitBucketNames[bucket],
+                                        priorityClass.waitHistogram[bucket]);
+            }
+        }
+    }
+
+private:
+    // Admission weights of the low, normal and high classes.
+    static constexpr std::array<int, kNumPriorities> kWeights{1, 4, 16};
+    static constexpr uint64_t kStride = 1 << 16;
+
+    // Upper bounds, in milliseconds, of the wait time histogram buckets. The last bucket counts
+    // every longer wait.
+    static constexpr std::array<long long, 4> kWaitBucketBounds{1, 10, 100, 1000};
+    static constexpr std::array<const char*, 5> kWaitBucketNames{
+        "lt1", "lt10", "lt100", "lt1000", "ge1000"};
+
+    struct Waiter {
+        stdx::condition_variable cv;
+        bool granted = false;
+    };
+
+    struct PriorityClass {
+        void recordAdmission(Microseconds wait) {
+            admitted++;
+            totalWaitMicros += durationCount<Microseconds>(wait);
+            const long long waitMillis = durationCount<Milliseconds>(wait);
+            size_t bucket = 0;
+            while (bucket < kWaitBucketBounds.size() && waitMillis >= kWaitBucketBounds[bucket])
+                bucket++;
+            waitHistogram[bucket]++;
+        }
+
+        std::deque<Waiter*> waiters;
+        uint64_t pass = 0;
+
+        long long admitted = 0;
+        long long timeSliced = 0;
+        long long totalWaitMicros = 0;
+        std::array<long long, kWaitBucketNames.size()> waitHistogram{};
+    };
+
+    bool _tryAcquire_inlock() {
+        // Queued waiters are served first, so new arrivals cannot overtake them.
+        if (_numWaiters > 0 || _available <= 0)
+            return false;
+        _available--;
+        return true;
+    }
+
+    void _release_inlock() {
+        if (_available < 0 || _numWaiters == 0) {
+            _available++;
+            return;
+        }
+        _grantNext_inlock();
+    }
+
+    /**
+     * Hands a ticket to the first waiter of the class with the lowest pass, then advances that
+     * class's pass by its stride.
+     */
+    void _grantNext_inlock() {
+        int next = -1;
+        for (int i = kNumPriorities - 1; i >= 0; i--) {
+            if (!_classes[i].waiters.empty() &&
+                (next < 0 || _classes[i].pass < _classes[next].pass)) {
+                next = i;
+            }
+        }
+        invariant(next >= 0);
+
+        auto& priorityClass = _classes[next];
+        Waiter* waiter = priorityClass.waiters.front();
+        priorityClass.waiters.pop_front();
+        _numWaiters--;
+
+        _virtualTime = priorityClass.pass;
+        priorityClass.pass += kStride / kWeights[next];
+
+        waiter->granted = true;
+        waiter->cv.notify_one();
+    }
+
+    /**
+     * Removes a waiter that timed out or was interrupted, giving back a ticket it was handed in
+     * the meantime.
+     */
+    void _abandon_inlock(Waiter* waiter, PriorityClass* priorityClass) {
+        if (waiter->granted) {
+            _release_inlock();
+            return;
+        }
+        auto it = std::find(priorityClass->waiters.begin(), priorityClass->waiters.end(), waiter);
+        invariant(it != priorityClass->waiters.end());
+        priorityClass->waiters.erase(it);
+        _numWaiters--;
+    }
+
+    TicketHolder* const _holder;
+
+    mutable stdx::mutex _mutex;
+    int _available;
+    int _numWaiters = 0;
+    uint64_t _virtualTime = 0;
+    std::array<PriorityClass, kNumPriorities> _classes;
+};
+
+AdmissionPriority TicketHolder::getAdmissionPriority(OperationContext* opCtx) {
+    return getAdmissionPriorityDecoration(opCtx).priority;
+}
+
+void TicketHolder::setAdmissionPriority(OperationContext* opCtx, AdmissionPriority priority) {
+    getAdmissionPriorityDecoration(opCtx).priority = priority;
+}
+
+void TicketHolder::enablePriorityAdmission() {
+    if (_priorityAdmission)
+        return;
+    invariant(used() == 0);
+    _priorityAdmission = std::make_unique<PriorityAdmission>(this, outof());
+}
+
+bool TicketHolder::waitForTicketUntil(OperationContext* opCtx,
+                                      Date_t until,
+                                      AdmissionPriority priority,
+                                      bool timeSliced) {
+    if (_priorityAdmission)
+        return _priorityAdmission->waitForTicketUntil(opCtx, until, priority, timeSliced);
+
+    if (until == Date_t::max()) {
+        waitForTicket(opCtx);
+        return true;
+    }
+    return waitForTicketUntil(opCtx, until);
+}
+
+void TicketHolder::appendPriorityStats(BSONObjBuilder* builder) const {
+    if (_priorityAdmission)
+        _priorityAdmission->appendStats(builder);
+}
+
+TicketHolder::QueueStats TicketHolder::getQueueStats() const {
+    QueueStats stats;
+    stats.queuedAcquisitions = _queuedAcquisitions.load();
+    stats.totalQueuedMicros = _totalQueuedMicros.load();
+    return stats;
+}
+
+void TicketHolder::_recordQueuedWait(Microseconds wait) {
+    _queuedAcquisitions.fetchAndAdd(1);
+    _totalQueuedMicros.fetchAndAdd(durationCount<Microseconds>(wait));
+}
+
 #if defined(__linux__)
 namespace {
 
@@ -79,6 +348,9 @@ TicketHolder::~TicketHolder() {
 }
 
 bool TicketHolder::tryAcquire() {
+    if (_priorityAdmission)
+        return _priorityAdmission->tryAcquire();
+
     while (0 != sem_trywait(&_sem)) {
         if (errno == EAGAIN)
             return false;
@@ -93,6 +365,13 @@ void TicketHolder::waitForTicket(OperationContext* opCtx) {
 }
 
 bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
+    if (_priorityAdmission)
+        return waitForTicketUntil(opCtx, until, AdmissionPriority::kNormal, false);
+
+    if (tryAcquire())
+        return true;
+
+    Timer timer;
     const Milliseconds intervalMs(500);
     struct timespec ts;
 
@@ -120,16 +399,28 @@ bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
         if (opCtx)
             opCtx->checkForInterrupt();
     }
+    _recordQueuedWait(Microseconds(timer.micros()));
     return true;
 }
 
 void TicketHolder::release() {
+    if (_priorityAdmission) {
+        _priorityAdmission->release();
+        return;
+    }
+
     check(sem_post(&_sem));
 }
 
 Status TicketHolder::resize(int newSize) {
     stdx::lock_guard<stdx::mutex> lk(_resizeMutex);
 
+    if (_priorityAdmission) {
+        _priorityAdmission->resize(newSize - _outof.load());
+        _outof.store(newSize);
+        return Status::OK();
+    }
+
     if (newSize < 5)
         return Status(ErrorCodes::BadValue,
                       str::stream() << "Minimum value for semaphore is 5; given " << newSize);
@@ -155,6 +446,9 @@ Status TicketHolder::resize(int newSize) {
 }
 
 int TicketHolder::available() const {
+    if (_priorityAdmission)
+        return _priorityAdmission->available();
+
     int val = 0;
     check(sem_getvalue(&_sem, &val));
     return val;
@@ -175,33 +469,60 @@ TicketHolder::TicketHolder(int num) : _outof(num), _num(num) {}
 TicketHolder::~TicketHolder() = default;
 
 bool TicketHolder::tryAcquire() {
+    if (_priorityAdmission)
+        return _priorityAdmission->tryAcquire();
+
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     return _tryAcquire();
 }
 
 void TicketHolder::waitForTicket(OperationContext* opCtx) {
+    if (_priorityAdmission) {
+        waitForTicketUntil(opCtx, Date_t::max());
+        return;
+    }
+
     stdx::unique_lock<stdx::mutex> lk(_mutex);
+    if (_tryAcquire())
+        return;
 
+    Timer timer;
     if (opCtx) {
         opCtx->waitForConditionOrInterrupt(_newTicket, lk, [this] { return _tryAcquire(); });
     } else {
         _newTicket.wait(lk, [this] { return _tryAcquire(); });
     }
+    _recordQueuedWait(Microseconds(timer.micros()));
 }
 
 bool TicketHolder::waitForTicketUntil(OperationContext* opCtx, Date_t until) {
+    if (_priorityAdmission)
+        return waitForTicketUntil(opCtx, until, AdmissionPriority::kNormal, false);
+
     stdx::unique_lock<stdx::mutex> lk(_mutex);
+    if (_tryAcquire())
+        return true;
 
+    Timer timer;
+    bool acquired;
     if (opCtx) {
-        return opCtx->waitForConditionOrInterruptUntil(
+        acquired = opCtx->waitForConditionOrInterruptUntil(
             _newTicket, lk, until, [this] { return _tryAcquire(); });
     } else {
-        return _newTicket.wait_until(
-            lk, until.toSystemTimePoint(), [this] { return _tryAcquire(); });
+        acquired =
+            _newTicket.wait_until(lk, until.toSystemTimePoint(), [this] { return _tryAcquire(); });
     }
+    if (acquired)
+        _recordQueuedWait(Microseconds(timer.micros()));
+    return acquired;
 }
 
 void TicketHolder::release() {
+    if (_priorityAdmission) {
+        _priorityAdmission->release();
+        return;
+    }
+
     {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
         _num++;
@@ -212,6 +533,12 @@ void TicketHolder::release() {
 Status TicketHolder::resize(int newSize) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
 
+    if (_priorityAdmission) {
+        _priorityAdmission->resize(newSize - _outof.load());
+        _outof.store(newSize);
+        return Status::OK();
+    }
+
     int used = _outof.load() - _num;
     if (used > newSize) {
         std::stringstream ss;
@@ -232,6 +559,9 @@ Status TicketHolder::resize(int newSize) {
 }
 
 int TicketHolder::available() const {
+    if (_priorityAdmission)
+        return _priorityAdmission->available();
+
     return _num;
 }
 
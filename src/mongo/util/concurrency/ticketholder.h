@@ -32,6 +32,8 @@
 #include <semaphore.h>
 #endif
 
+#include <memory>
+
 #include "mongo/db/operation_context.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
@@ -40,14 +42,41 @@
 
 namespace mongo {
 
+class BSONObjBuilder;
+
+/**
+ * The class an operation's ticket requests are admitted in when a TicketHolder admits by priority.
+ */
+enum class AdmissionPriority { kLow = 0, kNormal = 1, kHigh = 2 };
+
 class TicketHolder {
     TicketHolder(const TicketHolder&) = delete;
     TicketHolder& operator=(const TicketHolder&) = delete;
 
 public:
+    static constexpr int kNumPriorities = 3;
+
     explicit TicketHolder(int num);
     ~TicketHolder();
 
+    /**
+     * Gets and sets the priority class of the ticket requests made on behalf of 'opCtx'. Defaults
+     * to AdmissionPriority::kNormal.
+     */
+    static AdmissionPriority getAdmissionPriority(OperationContext* opCtx);
+    static void setAdmissionPriority(OperationContext* opCtx, AdmissionPriority priority);
+
+    /**
+     * Switches this holder from admitting waiters in arrival order to admitting them by priority
+     * class, dequeueing across classes in proportion to their weights so that lower classes are
+     * slowed down but never starved. Must be called before any ticket is acquired.
+     */
+    void enablePriorityAdmission();
+
+    bool priorityAdmissionEnabled() const {
+        return static_cast<bool>(_priorityAdmission);
+    }
+
     bool tryAcquire();
 
     /**
@@ -71,6 +100,17 @@ public:
     bool waitForTicketUntil(Date_t until) {
         return waitForTicketUntil(nullptr, until);
     }
+
+    /**
+     * Like waitForTicketUntil(), but queues the request in the 'priority' class when this holder
+     * admits by priority. 'timeSliced' marks a request from an operation that released its ticket
+     * to yield and is now queueing for it again.
+     */
+    bool waitForTicketUntil(OperationContext* opCtx,
+                            Date_t until,
+                            AdmissionPriority priority,
+                            bool timeSliced);
+
     void release();
 
     Status resize(int newSize);
@@ -81,7 +121,34 @@ public:
 
     int outof() const;
 
+    /**
+     * Appends the queue depth, admission counts and wait time histogram of each priority class.
+     * Appends nothing unless priority admission is enabled.
+     */
+    void appendPriorityStats(BSONObjBuilder* builder) const;
+
+    /**
+     * Counts the ticket requests that found no ticket available and had to queue before being
+     * admitted, and the total time they spent queued. Requests admitted immediately, and requests
+     * that timed out or were interrupted, are not counted.
+     */
+    struct QueueStats {
+        long long queuedAcquisitions = 0;
+        long long totalQueuedMicros = 0;
+    };
+    QueueStats getQueueStats() const;
+
 private:
+    class PriorityAdmission;
+
+    void _recordQueuedWait(Microseconds wait);
+
+    AtomicWord<long long> _queuedAcquisitions{0};
+    AtomicWord<long long> _totalQueuedMicros{0};
+
+    // Set once, before any ticket is acquired. When set, all tickets are handed out by it.
+    std::unique_ptr<PriorityAdmission> _priorityAdmission;
+
 #if defined(__linux__)
     mutable sem_t _sem;
 
@@ -32,6 +32,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/concurrency/ticketholder.h"
 
@@ -72,4 +74,97 @@ TEST(TicketholderTest, BasicTimeout) {
     holder.release();
     ASSERT_EQ(holder.used(), 0);
 }
+
+TEST(TicketholderTest, QueueStatsCountOnlyRequestsThatWaited) {
+    TicketHolder holder(1);
+    holder.enablePriorityAdmission();
+    ASSERT(holder.waitForTicketUntil(Date_t::now() + Milliseconds(20)));
+    ASSERT_FALSE(holder.waitForTicketUntil(Date_t::now() + Milliseconds(2)));
+    ASSERT_EQ(0, holder.getQueueStats().queuedAcquisitions);
+
+    stdx::thread waiter([&] {
+        holder.waitForTicket();
+        holder.release();
+    });
+    auto queued = [&] {
+        BSONObjBuilder builder;
+        holder.appendPriorityStats(&builder);
+        return builder.obj()["normal"]["queued"].numberInt();
+    };
+    while (queued() == 0) {
+        sleepmillis(1);
+    }
+    holder.release();
+    waiter.join();
+
+    ASSERT_EQ(1, holder.getQueueStats().queuedAcquisitions);
+}
+
+TEST(TicketholderTest, PriorityAdmissionBasicTimeout) {
+    TicketHolder holder(1);
+    holder.enablePriorityAdmission();
+    ASSERT(holder.priorityAdmissionEnabled());
+
+    ASSERT(holder.tryAcquire());
+    ASSERT_EQ(holder.used(), 1);
+    ASSERT_EQ(holder.available(), 0);
+    ASSERT_FALSE(holder.tryAcquire());
+    ASSERT_FALSE(holder.waitForTicketUntil(
+        nullptr, Date_t::now() + Milliseconds(2), AdmissionPriority::kHigh, false));
+
+    holder.release();
+    ASSERT_EQ(holder.used(), 0);
+    ASSERT(holder.waitForTicketUntil(nullptr, Date_t::now(), AdmissionPriority::kLow, true));
+    holder.release();
+
+    BSONObjBuilder builder;
+    holder.appendPriorityStats(&builder);
+    const auto stats = builder.obj();
+    ASSERT_EQ(1, stats["low"]["admitted"].numberLong());
+    ASSERT_EQ(1, stats["low"]["timeSliced"].numberLong());
+    ASSERT_EQ(0, stats["high"]["admitted"].numberLong());
+    ASSERT_EQ(0, stats["high"]["queued"].numberInt());
+}
+
+TEST(TicketholderTest, PriorityAdmissionServesHigherClassFirst) {
+    TicketHolder holder(1);
+    holder.enablePriorityAdmission();
+    ASSERT(holder.tryAcquire());
+
+    auto queued = [&](StringData className) {
+        BSONObjBuilder builder;
+        holder.appendPriorityStats(&builder);
+        return builder.obj()[className]["queued"].numberInt();
+    };
+
+    stdx::mutex mutex;
+    std::vector<AdmissionPriority> admitted;
+    auto waitFor = [&](AdmissionPriority priority) {
+        ASSERT(holder.waitForTicketUntil(nullptr, Date_t::max(), priority, false));
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            admitted.push_back(priority);
+        }
+        holder.release();
+    };
+
+    // The low priority request queues first.
+    stdx::thread low([&] { waitFor(AdmissionPriority::kLow); });
+    while (queued("low") == 0) {
+        sleepmillis(1);
+    }
+    stdx::thread high([&] { waitFor(AdmissionPriority::kHigh); });
+    while (queued("high") == 0) {
+        sleepmillis(1);
+    }
+
+    holder.release();
+    low.join();
+    high.join();
+
+    ASSERT_EQ(2U, admitted.size());
+    ASSERT(admitted[0] == AdmissionPriority::kHigh);
+    ASSERT(admitted[1] == AdmissionPriority::kLow);
+    ASSERT_EQ(0, holder.used());
+}
 }  // namespace
@@ -0,0 +1,535 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kExecutor
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+#include "mongo/base/status.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/log.h"
+#include "mongo/util/str.h"
+
+namespace mongo {
+
+namespace {
+
+using Task = OutOfLineExecutor::Task;
+
+// Counter used to assign unique names to otherwise-unnamed thread pools.
+AtomicWord<int> nextUnnamedWorkStealingPoolId{1};
+
+// The pool and worker index of the current thread, if it is a worker of a WorkStealingThreadPool.
+thread_local const WorkStealingThreadPool* currentPool = nullptr;
+thread_local size_t currentWorkerIndex = 0;
+
+// Upper bound on the number of injected tasks a worker moves onto its own deque at once.
+constexpr size_t kMaxInjectedBatch = 32;
+
+WorkStealingThreadPool::Options cleanUpOptions(WorkStealingThreadPool::Options&& options) {
+    if (options.poolName.empty()) {
+        options.poolName = str::stream() << "WorkStealingThreadPool"
+                                         << nextUnnamedWorkStealingPoolId.fetchAndAdd(1);
+    }
+    if (options.threadNamePrefix.empty()) {
+        options.threadNamePrefix = str::stream() << options.poolName << '-';
+    }
+    if (options.numThreads < 1) {
+        severe() << "Tried to create pool " << options.poolName << " with " << options.numThreads
+                 << " threads but it must have at least 1";
+        fassertFailed(51201);
+    }
+    return {std::move(options)};
+}
+
+/**
+ * Chase-Lev work-stealing deque of heap-allocated tasks, using the memory orderings from "Correct
+ * and Efficient Work-Stealing for Weak Memory Models" (Le et al., PPoPP 2013).
+ *
+ * Only the owning worker may call push() and pop(), which operate on the bottom end. Any thread may
+ * call steal(), which takes from the top end. The ring buffer doubles when full; retired buffers
+ * are kept until the deque is destroyed, since a concurrent thief may still be reading one.
+ */
+class TaskDeque {
+    TaskDeque(const TaskDeque&) = delete;
+    TaskDeque& operator=(const TaskDeque&) = delete;
+
+public:
+    TaskDeque() {
+        _buffers.push_back(stdx::make_unique<Buffer>(kInitialCapacity));
+        _buffer.store(_buffers.back().get(), std::memory_order_relaxed);
+    }
+
+    ~TaskDeque() {
+        while (Task* task = pop()) {
+            delete task;
+        }
+    }
+
+    void push(Task* task) {
+        const int64_t bottom = _bottom.load(std::memory_order_relaxed);
+        const int64_t top = _top.load(std::memory_order_acquire);
+        Buffer* buffer = _buffer.load(std::memory_order_relaxed);
+        if (bottom - top > buffer->capacity() - 1) {
+            buffer = _grow(buffer, top, bottom);
+        }
+        buffer->put(bottom, task);
+        std::atomic_thread_fence(std::memory_order_release);
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    Task* pop() {
+        const int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+        Buffer* buffer = _buffer.load(std::memory_order_relaxed);
+        _bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = _top.load(std::memory_order_relaxed);
+        if (top > bottom) {
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Task* task = buffer->get(bottom);
+        if (top == bottom) {
+            // This is the last task, so a thief may be racing for it.
+            if (!_top.compare_exchange_strong(
+                    top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                task = nullptr;
+            }
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    /**
+     * Returns the oldest task, or nullptr if the deque was empty or another thread won the race
+     * for the task. In the latter case "contended" is set to true.
+     */
+    Task* steal(bool* contended) {
+        int64_t top = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t bottom = _bottom.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return nullptr;
+        }
+        Buffer* buffer = _buffer.load(std::memory_order_acquire);
+        Task* task = buffer->get(top);
+        if (!_top.compare_exchange_strong(
+                top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            *contended = true;
+            return nullptr;
+        }
+        return task;
+    }
+
+    size_t size() const {
+        const int64_t bottom = _bottom.load(std::memory_order_acquire);
+        const int64_t top = _top.load(std::memory_order_acquire);
+        return bottom > top ? bottom - top : 0;
+    }
+
+private:
+    static constexpr int64_t kInitialCapacity = 64;
+
+    class Buffer {
+    public:
+        explicit Buffer(int64_t capacity)
+            : _mask(capacity - 1), _slots(new std::atomic<Task*>[capacity]) {}  // NOLINT
+
+        int64_t capacity() const {
+            return _mask + 1;
+        }
+
+        Task* get(int64_t index) const {
+            return _slots[index & _mask].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t index, Task* task) {
+            _slots[index & _mask].store(task, std::memory_order_relaxed);
+        }
+
+    private:
+        const int64_t _mask;
+        std::unique_ptr<std::atomic<Task*>[]> _slots;  // NOLINT
+    };
+
+    Buffer* _grow(Buffer* old, int64_t top, int64_t bottom) {
+        _buffers.push_back(stdx::make_unique<Buffer>(old->capacity() * 2));
+        Buffer* grown = _buffers.back().get();
+        for (int64_t i = top; i < bottom; ++i) {
+            grown->put(i, old->get(i));
+        }
+        _buffer.store(grown, std::memory_order_release);
+        return grown;
+    }
+
+    // The top and bottom indexes are written by different threads, so keep them on separate cache
+    // lines.
+    alignas(64) std::atomic<int64_t> _top{0};     // NOLINT
+    alignas(64) std::atomic<int64_t> _bottom{0};  // NOLINT
+    std::atomic<Buffer*> _buffer{nullptr};        // NOLINT
+
+    // Every buffer this deque has used, the current one last. Only touched by the owner.
+    std::vector<std::unique_ptr<Buffer>> _buffers;
+};
+
+}  // namespace
+
+class WorkStealingThreadPool::Worker {
+public:
+    explicit Worker(size_t index) : index(index), stealSeed(index + 1) {}
+
+    const size_t index;
+    TaskDeque deque;
+    stdx::thread thread;
+
+    // Used by the worker to pick its first victim when stealing.
+    size_t stealSeed;
+
+    AtomicWord<long long> numExecuted{0};
+    AtomicWord<long long> numStolen{0};
+    AtomicWord<long long> numStealAttempts{0};
+
+    // Guarded by the pool's _mutex.
+    bool notified = false;
+    stdx::condition_variable wakeUp;
+};
+
+WorkStealingThreadPool::WorkStealingThreadPool(Options options)
+    : _options(cleanUpOptions(std::move(options))) {
+    for (size_t i = 0; i < _options.numThreads; ++i) {
+        _workers.push_back(stdx::make_unique<Worker>(i));
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _shutdown_inlock();
+    if (shutdownComplete != _state) {
+        _join_inlock(&lk);
+    }
+
+    invariant(_state == shutdownComplete);
+    invariant(_injectedTasks.empty());
+}
+
+void WorkStealingThreadPool::startup() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_state != preStart) {
+        severe() << "Attempting to start pool " << _options.poolName
+                 << ", but it has already started";
+        fassertFailed(51202);
+    }
+    _setState_inlock(running);
+    _startWorkerThreads_inlock();
+}
+
+void WorkStealingThreadPool::shutdown() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _shutdown_inlock();
+}
+
+void WorkStealingThreadPool::_shutdown_inlock() {
+    switch (_state) {
+        case preStart:
+        case running:
+            _setState_inlock(joinRequired);
+            _shutdownRequested.store(true);
+            while (!_idleWorkers.empty()) {
+                _wakeOneIdleWorker_inlock();
+            }
+            return;
+        case joinRequired:
+        case joining:
+        case shutdownComplete:
+            return;
+    }
+    MONGO_UNREACHABLE;
+}
+
+void WorkStealingThreadPool::join() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _join_inlock(&lk);
+}
+
+void WorkStealingThreadPool::_join_inlock(stdx::unique_lock<stdx::mutex>* lk) {
+    _stateChange.wait(*lk, [this] {
+        switch (_state) {
+            case preStart:
+            case running:
+                return false;
+            case joinRequired:
+                return true;
+            case joining:
+            case shutdownComplete:
+                severe() << "Attempted to join pool " << _options.poolName << " more than once";
+                fassertFailed(51203);
+        }
+        MONGO_UNREACHABLE;
+    });
+    _setState_inlock(joining);
+
+    // A pool that was never started still runs the tasks scheduled on it. They cannot be run
+    // inline because they can create OperationContexts and the join() caller may already have one
+    // associated with its thread, so start the workers, which exit once everything has run.
+    _startWorkerThreads_inlock();
+
+    lk->unlock();
+    for (auto& worker : _workers) {
+        worker->thread.join();
+    }
+    lk->lock();
+    invariant(_state == joining);
+    _setState_inlock(shutdownComplete);
+}
+
+void WorkStealingThreadPool::schedule(Task task) {
+    if (currentPool == this && !_shutdownRequested.load()) {
+        // Scheduled by one of our own workers, which may be racing with shutdown. That is fine,
+        // since a worker drains its own deque before exiting.
+        _workers[currentWorkerIndex]->deque.push(new Task(std::move(task)));
+
+        // Pairs with the fence in _waitForWork(): either this thread sees the idle worker, or the
+        // idle worker sees the task that was just pushed.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_numIdleWorkers.load() > 0) {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _wakeOneIdleWorker_inlock();
+        }
+        return;
+    }
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    switch (_state) {
+        case joinRequired:
+        case joining:
+        case shutdownComplete: {
+            auto status = Status(ErrorCodes::ShutdownInProgress,
+                                 str::stream() << "Shutdown of thread pool " << _options.poolName
+                                               << " in progress");
+
+            lk.unlock();
+            task(status);
+            return;
+        }
+        case preStart:
+        case running:
+            break;
+    }
+    _injectedTasks.emplace_back(std::move(task));
+    _numPendingInjectedTasks.store(_injectedTasks.size());
+    _numInjectedTasks.fetchAndAddRelaxed(1);
+    _wakeOneIdleWorker_inlock();
+}
+
+WorkStealingThreadPool::Stats WorkStealingThreadPool::getStats() const {
+    Stats result;
+    result.options = _options;
+    result.numInjectedTasks = _numInjectedTasks.load();
+    for (const auto& worker : _workers) {
+        result.workers.push_back({worker->deque.size(),
+                                  worker->numExecuted.load(),
+                                  worker->numStolen.load(),
+                                  worker->numStealAttempts.load()});
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    result.numIdleThreads = _idleWorkers.size();
+    result.numPendingInjectedTasks = _injectedTasks.size();
+    return result;
+}
+
+void WorkStealingThreadPool::_workerThreadBody(size_t index, const std::string& threadName) {
+    setThreadName(threadName);
+    _options.onCreateThread(threadName);
+    LOG(1) << "starting thread in pool " << _options.poolName;
+
+    currentPool = this;
+    currentWorkerIndex = index;
+    Worker* worker = _workers[index].get();
+    do {
+        while (Task* task = _findTask(worker)) {
+            _runTask(worker, task);
+        }
+    } while (_waitForWork(worker));
+    currentPool = nullptr;
+
+    LOG(1) << "shutting down thread in pool " << _options.poolName;
+}
+
+void WorkStealingThreadPool::_runTask(Worker* worker, Task* task) noexcept {
+    std::unique_ptr<Task> owned(task);
+    (*owned)(Status::OK());
+    worker->numExecuted.fetchAndAddRelaxed(1);
+}
+
+OutOfLineExecutor::Task* WorkStealingThreadPool::_findTask(Worker* worker) {
+    if (Task* task = worker->deque.pop()) {
+        return task;
+    }
+    if (Task* task = _takeInjected(worker)) {
+        return task;
+    }
+    return _steal(worker);
+}
+
+OutOfLineExecutor::Task* WorkStealingThreadPool::_takeInjected(Worker* worker) {
+    if (_numPendingInjectedTasks.load() == 0) {
+        return nullptr;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_injectedTasks.empty()) {
+        return nullptr;
+    }
+    auto task = stdx::make_unique<Task>(std::move(_injectedTasks.front()));
+    _injectedTasks.pop_front();
+
+    // Take this worker's share of what is left, so that a burst of scheduled tasks is spread over
+    // the deques rather than every worker contending on _mutex for each task.
+    const size_t batch = std::min(_injectedTasks.size() / _workers.size(), kMaxInjectedBatch);
+    for (size_t i = 0; i < batch; ++i) {
+        worker->deque.push(new Task(std::move(_injectedTasks.front())));
+        _injectedTasks.pop_front();
+    }
+    _numPendingInjectedTasks.store(_injectedTasks.size());
+    if (batch > 0 || !_injectedTasks.empty()) {
+        _wakeOneIdleWorker_inlock();
+    }
+    return task.release();
+}
+
+OutOfLineExecutor::Task* WorkStealingThreadPool::_steal(Worker* worker) {
+    const size_t numWorkers = _workers.size();
+    if (numWorkers == 1) {
+        return nullptr;
+    }
+
+    // Start from a different victim each time so that thieves spread out, and make a second pass
+    // if another thread won a race, since the deque it raced on may still hold tasks.
+    bool contended = true;
+    for (int pass = 0; pass < 2 && contended; ++pass) {
+        contended = false;
+        worker->stealSeed = worker->stealSeed * 1103515245 + 12345;
+        const size_t start = worker->stealSeed % numWorkers;
+        for (size_t i = 0; i < numWorkers; ++i) {
+            Worker* victim = _workers[(start + i) % numWorkers].get();
+            if (victim == worker) {
+                continue;
+            }
+            worker->numStealAttempts.fetchAndAddRelaxed(1);
+            if (Task* task = victim->deque.steal(&contended)) {
+                worker->numStolen.fetchAndAddRelaxed(1);
+                return task;
+            }
+        }
+    }
+    return nullptr;
+}
+
+bool WorkStealingThreadPool::_waitForWork(Worker* worker) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _numIdleWorkers.fetchAndAdd(1);
+
+    // Pairs with the fence in schedule().
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_hasWork_inlock()) {
+        _numIdleWorkers.fetchAndSubtract(1);
+        return true;
+    }
+    if (_state != running) {
+        // Nothing can be scheduled once the pool is shutting down, and every worker drains its
+        // own deque before getting here, so this worker is done.
+        _numIdleWorkers.fetchAndSubtract(1);
+        return false;
+    }
+
+    worker->notified = false;
+    _idleWorkers.push_back(worker);
+    {
+        MONGO_IDLE_THREAD_BLOCK;
+        worker->wakeUp.wait(lk, [worker] { return worker->notified; });
+    }
+    _numIdleWorkers.fetchAndSubtract(1);
+    return true;
+}
+
+bool WorkStealingThreadPool::_hasWork_inlock() const {
+    if (!_injectedTasks.empty()) {
+        return true;
+    }
+    for (const auto& worker : _workers) {
+        if (worker->deque.size() > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingThreadPool::_wakeOneIdleWorker_inlock() {
+    if (_idleWorkers.empty()) {
+        return;
+    }
+    Worker* worker = _idleWorkers.back();
+    _idleWorkers.pop_back();
+    worker->notified = true;
+    worker->wakeUp.notify_one();
+}
+
+void WorkStealingThreadPool::_startWorkerThreads_inlock() {
+    if (_threadsStarted) {
+        return;
+    }
+    _threadsStarted = true;
+    for (auto& worker : _workers) {
+        const size_t index = worker->index;
+        const std::string threadName = str::stream() << _options.threadNamePrefix << index;
+        worker->thread =
+            stdx::thread([this, index, threadName] { _workerThreadBody(index, threadName); });
+    }
+}
+
+void WorkStealingThreadPool::_setState_inlock(const LifecycleState newState) {
+    if (newState == _state) {
+        return;
+    }
+    _state = newState;
+    _stateChange.notify_all();
+}
+
+}  // namespace mongo
@@ -0,0 +1,232 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool_interface.h"
+
+namespace mongo {
+
+/**
+ * A fixed-size thread pool in which every worker owns a Chase-Lev work-stealing deque.
+ *
+ * Tasks scheduled by a worker of the pool are pushed onto that worker's own deque without taking
+ * any lock, and idle workers steal from the other end of their peers' deques. Tasks scheduled from
+ * outside the pool go through a shared injection queue, from which workers take them in batches.
+ * Idle workers each sleep on their own condition variable and are woken one at a time, so
+ * scheduling a task never wakes more than one thread.
+ *
+ * Unlike ThreadPool, the number of threads is fixed for the lifetime of the pool.
+ */
+class WorkStealingThreadPool final : public ThreadPoolInterface {
+    WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+    WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+
+public:
+    /**
+     * Structure used to configure an instance of WorkStealingThreadPool.
+     */
+    struct Options {
+        // Name of the thread pool. If this string is empty, the pool will be assigned a
+        // name unique to the current process.
+        std::string poolName;
+
+        // Prefix used to name threads for logging purposes. If this is empty, the prefix will be
+        // the pool name followed by a hyphen.
+        std::string threadNamePrefix;
+
+        // Number of worker threads, all of which are started by startup().
+        size_t numThreads = 8;
+
+        // This function is run before each worker thread begins consuming tasks.
+        using OnCreateThreadFn = stdx::function<void(const std::string& threadName)>;
+        OnCreateThreadFn onCreateThread = [](const std::string&) {};
+    };
+
+    /**
+     * Counters for one worker thread, as returned by getStats().
+     */
+    struct WorkerStats {
+        // The number of tasks currently in this worker's deque.
+        size_t queueDepth;
+
+        // The number of tasks this worker has run.
+        long long numExecuted;
+
+        // The number of tasks this worker took from the deque of another worker.
+        long long numStolen;
+
+        // The number of times this worker inspected another worker's deque looking for a task.
+        long long numStealAttempts;
+    };
+
+    /**
+     * Structure used to return information about the thread pool via getStats().
+     */
+    struct Stats {
+        // The options for the instance of the pool returning these stats.
+        Options options;
+
+        // The number of idle threads currently in the pool.
+        size_t numIdleThreads;
+
+        // The number of tasks scheduled from outside the pool that no worker has taken yet.
+        size_t numPendingInjectedTasks;
+
+        // The total number of tasks scheduled from outside the pool.
+        long long numInjectedTasks;
+
+        // Per-worker counters, indexed by worker.
+        std::vector<WorkerStats> workers;
+    };
+
+    /**
+     * Constructs a thread pool, configured with the given "options".
+     */
+    explicit WorkStealingThreadPool(Options options);
+
+    ~WorkStealingThreadPool() override;
+
+    void startup() override;
+    void shutdown() override;
+    void join() override;
+    void schedule(Task task) override;
+
+    /**
+     * Returns statistics about the thread pool's queues and stealing.
+     */
+    Stats getStats() const;
+
+private:
+    class Worker;
+
+    /**
+     * Representation of the stage of life of a thread pool, with the same transitions as
+     * ThreadPool::LifecycleState.
+     */
+    enum LifecycleState { preStart, running, joinRequired, joining, shutdownComplete };
+
+    /**
+     * Run loop of the worker thread at "index".
+     */
+    void _workerThreadBody(size_t index, const std::string& threadName);
+
+    /**
+     * Returns a task for "worker" from its own deque, the injection queue or another worker's
+     * deque, in that order, or nullptr if none was found.
+     */
+    Task* _findTask(Worker* worker);
+
+    /**
+     * Takes a task from the injection queue, moving a share of the remaining injected tasks onto
+     * the deque of "worker" so that they can be stolen by its peers.
+     */
+    Task* _takeInjected(Worker* worker);
+
+    /**
+     * Runs "task", which was taken by "worker", and frees it.
+     */
+    void _runTask(Worker* worker, Task* task) noexcept;
+
+    /**
+     * Tries to steal one task from a worker other than "worker".
+     */
+    Task* _steal(Worker* worker);
+
+    /**
+     * Puts "worker" to sleep until there may be work for it. Returns false if the worker should
+     * exit because the pool is shutting down and no work is left.
+     */
+    bool _waitForWork(Worker* worker);
+
+    /**
+     * Returns true if any deque or the injection queue holds a task. Caller must hold _mutex.
+     */
+    bool _hasWork_inlock() const;
+
+    /**
+     * Wakes the most recently idled worker, if there is one. Caller must hold _mutex.
+     */
+    void _wakeOneIdleWorker_inlock();
+
+    /**
+     * Starts all worker threads. Caller must hold _mutex.
+     */
+    void _startWorkerThreads_inlock();
+
+    void _shutdown_inlock();
+    void _join_inlock(stdx::unique_lock<stdx::mutex>* lk);
+    void _setState_inlock(LifecycleState newState);
+
+    // These are the options with which the pool was configured at construction time.
+    const Options _options;
+
+    // One entry per worker thread, created at construction time.
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    // Number of workers that are idle or about to become idle. Read without _mutex by workers that
+    // have just pushed onto their deque, to decide whether one of their peers needs waking.
+    AtomicWord<size_t> _numIdleWorkers{0};
+
+    // Set once shutdown() has been called, for the lock-free scheduling path of workers.
+    AtomicWord<bool> _shutdownRequested{false};
+
+    // Approximate size of _injectedTasks, so that workers can skip taking _mutex when it is empty.
+    AtomicWord<size_t> _numPendingInjectedTasks{0};
+
+    AtomicWord<long long> _numInjectedTasks{0};
+
+    // Mutex guarding all members below.
+    mutable stdx::mutex _mutex;
+
+    LifecycleState _state = preStart;
+
+    // Set once the worker threads have been started, either by startup() or by join().
+    bool _threadsStarted = false;
+
+    // Tasks scheduled from outside the pool.
+    std::deque<Task> _injectedTasks;
+
+    // Sleeping workers, in the order in which they went idle.
+    std::vector<Worker*> _idleWorkers;
+
+    // Condition variable signaled whenever _state changes.
+    stdx::condition_variable _stateChange;
+};
+
+}  // namespace mongo
@@ -0,0 +1,163 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/base/init.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/death_test.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/thread_pool_test_common.h"
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+namespace {
+using namespace mongo;
+
+MONGO_INITIALIZER(WorkStealingThreadPoolCommonTests)(InitializerContext*) {
+    addTestsForThreadPool("WorkStealingThreadPoolCommon", []() {
+        return stdx::make_unique<WorkStealingThreadPool>(WorkStealingThreadPool::Options());
+    });
+    return Status::OK();
+}
+
+long long totalExecuted(const WorkStealingThreadPool::Stats& stats) {
+    long long total = 0;
+    for (const auto& worker : stats.workers) {
+        total += worker.numExecuted;
+    }
+    return total;
+}
+
+TEST(WorkStealingThreadPoolTest, InjectedTasksArePendingUntilStartup) {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = 4;
+    WorkStealingThreadPool pool(options);
+    for (int i = 0; i < 3; ++i) {
+        pool.schedule([](auto status) { ASSERT_OK(status); });
+    }
+
+    auto stats = pool.getStats();
+    ASSERT_EQ(4U, stats.workers.size());
+    ASSERT_EQ(3U, stats.numPendingInjectedTasks);
+    ASSERT_EQ(3, stats.numInjectedTasks);
+    ASSERT_EQ(0, totalExecuted(stats));
+
+    pool.startup();
+    pool.shutdown();
+    pool.join();
+
+    stats = pool.getStats();
+    ASSERT_EQ(0U, stats.numPendingInjectedTasks);
+    ASSERT_EQ(3, totalExecuted(stats));
+    for (const auto& worker : stats.workers) {
+        ASSERT_EQ(0U, worker.queueDepth);
+    }
+}
+
+TEST(WorkStealingThreadPoolTest, TaskScheduledByBlockedWorkerIsStolen) {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = 2;
+    WorkStealingThreadPool pool(options);
+    pool.startup();
+
+    stdx::mutex mutex;
+    stdx::condition_variable cv;
+    bool childRan = false;
+    stdx::thread::id parentThread;
+    stdx::thread::id childThread;
+
+    // The child lands on the parent's own deque, and the parent does not return until the child
+    // has run, so only the other worker can run it, by stealing it.
+    pool.schedule([&](auto status) {
+        ASSERT_OK(status);
+        parentThread = stdx::this_thread::get_id();
+        pool.schedule([&](auto childStatus) {
+            ASSERT_OK(childStatus);
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            childThread = stdx::this_thread::get_id();
+            childRan = true;
+            cv.notify_all();
+        });
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cv.wait(lk, [&] { return childRan; });
+    });
+
+    pool.shutdown();
+    pool.join();
+
+    ASSERT_TRUE(childRan);
+    ASSERT_NE(parentThread, childThread);
+
+    const auto stats = pool.getStats();
+    ASSERT_EQ(1, stats.numInjectedTasks);
+    ASSERT_EQ(2, totalExecuted(stats));
+    long long stolen = 0;
+    long long stealAttempts = 0;
+    for (const auto& worker : stats.workers) {
+        stolen += worker.numStolen;
+        stealAttempts += worker.numStealAttempts;
+    }
+    ASSERT_EQ(1, stolen);
+    ASSERT_GTE(stealAttempts, stolen);
+}
+
+TEST(WorkStealingThreadPoolTest, WorkersDrainTheirDequesOnJoin) {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = 3;
+    WorkStealingThreadPool pool(options);
+    pool.startup();
+
+    const int kFanOut = 1000;
+    AtomicWord<int> ran{0};
+    pool.schedule([&](auto status) {
+        ASSERT_OK(status);
+        for (int i = 0; i < kFanOut; ++i) {
+            pool.schedule([&](auto childStatus) {
+                ASSERT_OK(childStatus);
+                ran.fetchAndAdd(1);
+            });
+        }
+        pool.shutdown();
+    });
+    pool.join();
+
+    ASSERT_EQ(kFanOut, ran.load());
+    ASSERT_EQ(kFanOut + 1, totalExecuted(pool.getStats()));
+}
+
+DEATH_TEST(WorkStealingThreadPoolTest, NoThreadsDies, "it must have at least 1") {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = 0;
+    WorkStealingThreadPool pool(options);
+}
+
+}  // namespace
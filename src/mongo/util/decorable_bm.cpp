@@ -0,0 +1,91 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <string>
+#include <utility>
+
+#include "mongo/util/decorable.h"
+
+namespace mongo {
+namespace {
+
+// Roughly the mix of decorations found on an OperationContext: mostly flags, counters and
+// pointers, with a few members that own memory.
+constexpr size_t kNumTrivialDecorations = 64;
+constexpr size_t kNumNonTrivialDecorations = 16;
+
+class TrivialDecorated : public Decorable<TrivialDecorated> {};
+class NonTrivialDecorated : public Decorable<NonTrivialDecorated> {};
+
+template <typename D, typename T, size_t... Is>
+auto declareDecorations(std::index_sequence<Is...>) {
+    return std::array<typename D::template Decoration<T>, sizeof...(Is)>{
+        {((void)Is, D::template declareDecoration<T>())...}};
+}
+
+const auto trivialDecorations = declareDecorations<TrivialDecorated, long long>(
+    std::make_index_sequence<kNumTrivialDecorations>());
+const auto nonTrivialDecorations = declareDecorations<NonTrivialDecorated, std::string>(
+    std::make_index_sequence<kNumNonTrivialDecorations>());
+
+void BM_ConstructTrivialDecorations(benchmark::State& state) {
+    for (auto _ : state) {
+        TrivialDecorated decorated;
+        benchmark::DoNotOptimize(trivialDecorations[0](decorated));
+    }
+}
+
+void BM_ConstructNonTrivialDecorations(benchmark::State& state) {
+    for (auto _ : state) {
+        NonTrivialDecorated decorated;
+        benchmark::DoNotOptimize(nonTrivialDecorations[0](decorated));
+    }
+}
+
+void BM_AccessDecorations(benchmark::State& state) {
+    TrivialDecorated decorated;
+    for (auto _ : state) {
+        long long sum = 0;
+        for (auto&& decoration : trivialDecorations) {
+            sum += decoration(decorated)++;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+BENCHMARK(BM_ConstructTrivialDecorations);
+BENCHMARK(BM_ConstructNonTrivialDecorations);
+BENCHMARK(BM_AccessDecorations);
+
+}  // namespace
+}  // namespace mongo
@@ -154,6 +154,37 @@ TEST(DecorableTest, ThrowingConstructor) {
     ASSERT_EQ(1, numDestructedAs);
 }
 
+TEST(DecorableTest, TrivialDecorationsAreValueInitialized) {
+    struct Trivial {
+        int i;
+        double d;
+        void* p;
+    };
+
+    DecorationRegistry<MyDecorable> registry;
+    const auto trivial = registry.declareDecoration<Trivial>();
+    const auto a = registry.declareDecoration<A>();
+    const auto flag = registry.declareDecoration<bool>();
+
+    numConstructedAs = 0;
+    numDestructedAs = 0;
+    for (int round = 0; round < 2; ++round) {
+        DecorationContainer<MyDecorable> d(nullptr, &registry);
+        ASSERT_EQ(0, d.getDecoration(trivial).i);
+        ASSERT_EQ(0.0, d.getDecoration(trivial).d);
+        ASSERT_EQ(nullptr, d.getDecoration(trivial).p);
+        ASSERT_FALSE(d.getDecoration(flag));
+        ASSERT_EQ(0, d.getDecoration(a).value);
+
+        // Dirty the decorations so that a reused allocation would show up in the next round.
+        d.getDecoration(trivial) = Trivial{1, 1.0, &d};
+        d.getDecoration(flag) = true;
+        d.getDecoration(a).value = 1;
+    }
+    ASSERT_EQ(2, numConstructedAs);
+    ASSERT_EQ(2, numDestructedAs);
+}
+
 TEST(DecorableTest, Alignment) {
     DecorationRegistry<MyDecorable> registry;
     const auto firstChar = registry.declareDecoration<char>();
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cstring>
 #include <functional>
 #include <iterator>
 #include <type_traits>
@@ -63,15 +64,22 @@ public:
      * returns a descriptor for accessing that decoration.
      *
      * NOTE: T's destructor must not throw exceptions.
+     *
+     * A trivial T is not constructed or destroyed one at a time. It is value-initialized along with
+     * every other trivial decoration when construct() zeroes the decoration buffer.
      */
     template <typename T>
     auto declareDecoration() {
         MONGO_STATIC_ASSERT_MSG(std::is_nothrow_destructible<T>::value,
                                 "Decorations must be nothrow destructible");
+        constexpr bool isTrivial = std::is_trivially_default_constructible<T>::value &&
+            std::is_trivially_destructible<T>::value;
         return
             typename DecorationContainer<DecoratedType>::template DecorationDescriptorWithType<T>(
-                std::move(declareDecoration(
-                    sizeof(T), std::alignment_of<T>::value, &constructAt<T>, &destroyAt<T>)));
+                std::move(declareDecoration(sizeof(T),
+                                            std::alignment_of<T>::value,
+                                            isTrivial ? nullptr : &constructAt<T>,
+                                            isTrivial ? nullptr : &destroyAt<T>)));
     }
 
     size_t getDecorationBufferSizeBytes() const {
@@ -85,6 +93,14 @@ public:
      * Called by the DecorationContainer constructor. Do not call directly.
      */
     void construct(DecorationContainer<DecoratedType>* const container) const {
+        // Zero everything after the back link in one pass, which value-initializes the trivial
+        // decorations. The others are constructed over it below.
+        std::memset(container->getDecoration(
+                        typename DecorationContainer<DecoratedType>::DecorationDescriptor(
+                            sizeof(void*))),
+                    0,
+                    _totalSizeBytes - sizeof(void*));
+
         using std::cbegin;
 
         auto iter = cbegin(_decorationInfo);
@@ -177,11 +193,14 @@ private:
             _totalSizeBytes += alignBytes - misalignment;
         }
         typename DecorationContainer<DecoratedType>::DecorationDescriptor result(_totalSizeBytes);
-        _decorationInfo.push_back(DecorationInfo(result, constructor, destructor));
+        if (constructor) {
+            _decorationInfo.push_back(DecorationInfo(result, constructor, destructor));
+        }
         _totalSizeBytes += sizeBytes;
         return result;
     }
 
+    // Only the decorations which need their constructor and destructor run.
     DecorationInfoVector _decorationInfo;
     size_t _totalSizeBytes{sizeof(void*)};
 };
@@ -29,11 +29,15 @@
 
 #pragma once
 
+#include <cstddef>
 #include <functional>
+#include <new>
 #include <type_traits>
+#include <utility>
 
 #include "mongo/stdx/type_traits.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/if_constexpr.h"
 
 namespace mongo {
 template <typename Function>
@@ -45,6 +49,9 @@ class unique_function;
  * it is incapable of being copied.  Often this happens with C++14 or later lambdas which capture a
  * `std::unique_ptr` by move.  The interface of `unique_function` is nearly identical to
  * `std::function`, except that it is not copyable.
+ *
+ * Functors that are small enough and cannot throw when moved are stored inside the
+ * `unique_function` itself, so wrapping them does not allocate. Larger functors live on the heap.
  */
 template <typename RetType, typename... Args>
 class unique_function<RetType(Args...)> {
@@ -65,18 +72,30 @@ private:
 public:
     using result_type = RetType;
 
-    ~unique_function() noexcept = default;
+    ~unique_function() noexcept {
+        reset();
+    }
     unique_function() = default;
 
     unique_function(const unique_function&) = delete;
     unique_function& operator=(const unique_function&) = delete;
 
-    unique_function(unique_function&&) noexcept = default;
-    unique_function& operator=(unique_function&&) noexcept = default;
+    unique_function(unique_function&& that) noexcept {
+        takeFrom(that);
+    }
+
+    unique_function& operator=(unique_function&& that) noexcept {
+        if (this != &that) {
+            reset();
+            takeFrom(that);
+        }
+        return *this;
+    }
 
     void swap(unique_function& that) noexcept {
-        using std::swap;
-        swap(this->impl, that.impl);
+        unique_function tmp(std::move(that));
+        that = std::move(*this);
+        *this = std::move(tmp);
     }
 
     friend void swap(unique_function& a, unique_function& b) noexcept {
@@ -98,18 +117,19 @@ public:
         std::enable_if_t<stdx::is_invocable_r<RetType, Functor, Args...>::value, TagType> =
             makeTag(),
         std::enable_if_t<std::is_move_constructible<Functor>::value, TagType> = makeTag(),
-        std::enable_if_t<!std::is_same<Functor, unique_function>::value, TagType> = makeTag())
-        : impl(makeImpl(std::forward<Functor>(functor))) {}
+        std::enable_if_t<!std::is_same<Functor, unique_function>::value, TagType> = makeTag()) {
+        emplace(std::forward<Functor>(functor));
+    }
 
     unique_function(std::nullptr_t) noexcept {}
 
     RetType operator()(Args... args) const {
         invariant(static_cast<bool>(*this));
-        return impl->call(std::forward<Args>(args)...);
+        return ops->call(storage, std::forward<Args>(args)...);
     }
 
     explicit operator bool() const noexcept {
-        return static_cast<bool>(this->impl);
+        return ops != nullptr;
     }
 
     // Needed to make `std::is_convertible<mongo::unique_function<...>, std::function<...>>` be
@@ -131,9 +151,16 @@ private:
         return {};
     }
 
-    struct Impl {
-        virtual ~Impl() noexcept = default;
-        virtual RetType call(Args&&... args) = 0;
+    // Large enough for a functor capturing a few pointers, or a `std::shared_ptr` and a pointer.
+    static constexpr std::size_t kInlineSize = 4 * sizeof(void*);
+    using Storage = std::aligned_storage_t<kInlineSize, alignof(void*)>;
+
+    // Type-erased operations on the functor held in `storage`.
+    struct Ops {
+        RetType (*call)(Storage& storage, Args&&... args);
+        // Move-constructs the functor in `from` into `to`, and destroys the one in `from`.
+        void (*relocate)(Storage& from, Storage& to) noexcept;
+        void (*destroy)(Storage& storage) noexcept;
     };
 
     // These overload helpers are needed to squelch problems in the `T ()` -> `void ()` case.
@@ -149,22 +176,86 @@ private:
         return f(std::forward<Args>(args)...);
     }
 
-    template <typename Functor>
-    static auto makeImpl(Functor&& functor) {
-        struct SpecificImpl : Impl {
-            explicit SpecificImpl(Functor&& func) : f(std::forward<Functor>(func)) {}
+    template <typename F>
+    static constexpr bool storedInline = sizeof(F) <= sizeof(Storage) &&
+        alignof(F) <= alignof(Storage) && std::is_nothrow_move_constructible<F>::value;
+
+    template <typename F>
+    struct InlineOps {
+        static F& get(Storage& storage) {
+            return *reinterpret_cast<F*>(&storage);
+        }
+
+        static RetType call(Storage& storage, Args&&... args) {
+            return callRegularVoid(
+                std::is_void<RetType>(), get(storage), std::forward<Args>(args)...);
+        }
+
+        static void relocate(Storage& from, Storage& to) noexcept {
+            new (&to) F(std::move(get(from)));
+            get(from).~F();
+        }
+
+        static void destroy(Storage& storage) noexcept {
+            get(storage).~F();
+        }
 
-            RetType call(Args&&... args) override {
-                return callRegularVoid(std::is_void<RetType>(), f, std::forward<Args>(args)...);
-            }
+        static constexpr Ops ops{&call, &relocate, &destroy};
+    };
+
+    template <typename F>
+    struct HeapOps {
+        static F*& get(Storage& storage) {
+            return *reinterpret_cast<F**>(&storage);
+        }
+
+        static RetType call(Storage& storage, Args&&... args) {
+            return callRegularVoid(
+                std::is_void<RetType>(), *get(storage), std::forward<Args>(args)...);
+        }
+
+        static void relocate(Storage& from, Storage& to) noexcept {
+            new (&to) F*(get(from));
+        }
+
+        static void destroy(Storage& storage) noexcept {
+            delete get(storage);
+        }
+
+        static constexpr Ops ops{&call, &relocate, &destroy};
+    };
+
+    template <typename Functor>
+    void emplace(Functor&& functor) {
+        using F = std::decay_t<Functor>;
+        IF_CONSTEXPR(storedInline<F>) {
+            new (&storage) F(std::forward<Functor>(functor));
+            ops = &InlineOps<F>::ops;
+        }
+        else {
+            new (&storage) F*(new F(std::forward<Functor>(functor)));
+            ops = &HeapOps<F>::ops;
+        }
+    }
 
-            std::decay_t<Functor> f;
-        };
+    void takeFrom(unique_function& that) noexcept {
+        if (that.ops) {
+            that.ops->relocate(that.storage, storage);
+            ops = std::exchange(that.ops, nullptr);
+        }
+    }
 
-        return std::make_unique<SpecificImpl>(std::forward<Functor>(functor));
+    void reset() noexcept {
+        if (ops) {
+            std::exchange(ops, nullptr)->destroy(storage);
+        }
     }
 
-    std::unique_ptr<Impl> impl;
+    const Ops* ops = nullptr;
+
+    // Mutable because invoking a functor through a const `unique_function` may modify it, as it
+    // could when the functor was held through a pointer.
+    mutable Storage storage;
 };
 
 template <typename Signature>
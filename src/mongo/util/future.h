@@ -1161,6 +1161,8 @@ template <typename T>
     using Out = SharedSemiFuture<FakeVoidToVoid<T>>;
     if (_immediate)
         return Out(SharedStateHolder<FakeVoidToVoid<T>>::makeReady(std::move(*_immediate)));
+    if (!_immediateError.isOK())
+        return Out(SharedStateHolder<FakeVoidToVoid<T>>::makeReady(std::move(_immediateError)));
     return Out(SharedStateHolder<FakeVoidToVoid<T>>(std::move(_shared)));
 }
 
@@ -29,19 +29,69 @@
 
 #include "mongo/platform/basic.h"
 
+#include <array>
 #include <benchmark/benchmark.h>
 
 #include "mongo/bson/inline_decls.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/functional.h"
 #include "mongo/util/future.h"
 
+#ifdef MONGO_FUTURE_BM_COUNT_ALLOCATIONS
+#include <gperftools/malloc_hook.h>
+#endif
+
 namespace mongo {
 
+#ifdef MONGO_FUTURE_BM_COUNT_ALLOCATIONS
+constexpr bool kCountAllocations = true;
+#else
+constexpr bool kCountAllocations = false;
+#endif
+
+/**
+ * Reports the average number of heap allocations per iteration of a benchmark in its "allocs"
+ * counter. Allocations are only counted when the build provides tcmalloc's allocation hooks, which
+ * SConscript signals by defining MONGO_FUTURE_BM_COUNT_ALLOCATIONS.
+ */
+class AllocationCounter {
+public:
+    explicit AllocationCounter(benchmark::State& state) : _state(state), _start(_count.load()) {
+#ifdef MONGO_FUTURE_BM_COUNT_ALLOCATIONS
+        MallocHook::AddNewHook(&onNew);
+#endif
+    }
+
+    ~AllocationCounter() {
+#ifdef MONGO_FUTURE_BM_COUNT_ALLOCATIONS
+        MallocHook::RemoveNewHook(&onNew);
+#endif
+        if (kCountAllocations && _state.iterations() > 0) {
+            _state.counters["allocs"] =
+                static_cast<double>(_count.load() - _start) / _state.iterations();
+        }
+    }
+
+private:
+    static void onNew(const void*, size_t) {
+        _count.fetchAndAddRelaxed(1);
+    }
+
+    static AtomicWord<long long> _count;
+
+    benchmark::State& _state;
+    const long long _start;
+};
+
+AtomicWord<long long> AllocationCounter::_count{0};
+
 NOINLINE_DECL int makeReadyInt() {
     benchmark::ClobberMemory();
     return 1;
 }
 
 void BM_plainIntReady(benchmark::State& state) {
+    AllocationCounter allocs(state);
     for (auto _ : state) {
         benchmark::DoNotOptimize(makeReadyInt() + 1);
     }
@@ -53,12 +103,14 @@ NOINLINE_DECL Future<int> makeReadyFut() {
 }
 
 void BM_futureIntReady(benchmark::State& state) {
+    AllocationCounter allocs(state);
     for (auto _ : state) {
         benchmark::DoNotOptimize(makeReadyFut().get() + 1);
     }
 }
 
 void BM_futureIntReadyThen(benchmark::State& state) {
+    AllocationCounter allocs(state);
     for (auto _ : state) {
         benchmark::DoNotOptimize(makeReadyFut().then([](int i) { return i + 1; }).get());
     }
@@ -72,19 +124,55 @@ NOINLINE_DECL Future<int> makeReadyFutWithPromise() {
 }
 
 void BM_futureIntReadyWithPromise(benchmark::State& state) {
+    AllocationCounter allocs(state);
     for (auto _ : state) {
         benchmark::DoNotOptimize(makeReadyFutWithPromise().get() + 1);
     }
 }
 
 void BM_futureIntReadyWithPromiseThen(benchmark::State& state) {
+    AllocationCounter allocs(state);
     for (auto _ : state) {
         int i = makeReadyFutWithPromise().then([](int i) { return i + 1; }).get();
         benchmark::DoNotOptimize(i);
     }
 }
 
+NOINLINE_DECL Future<int> makeReadyFutError() {
+    benchmark::ClobberMemory();
+    return Future<int>::makeReady(Status(ErrorCodes::BadValue, "bad value"));
+}
+
+void BM_futureIntReadyErrorThen(benchmark::State& state) {
+    AllocationCounter allocs(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(makeReadyFutError()
+                                     .then([](int i) { return i + 1; })
+                                     .onError([](Status) { return 0; })
+                                     .get());
+    }
+}
+
+void BM_uniqueFunctionSmall(benchmark::State& state) {
+    AllocationCounter allocs(state);
+    int captured = 1;
+    for (auto _ : state) {
+        unique_function<int(int)> func = [&captured](int i) { return i + captured; };
+        benchmark::DoNotOptimize(func(1));
+    }
+}
+
+void BM_uniqueFunctionLarge(benchmark::State& state) {
+    AllocationCounter allocs(state);
+    std::array<int, 16> captured{};
+    for (auto _ : state) {
+        unique_function<int(int)> func = [captured](int i) { return i + captured[0]; };
+        benchmark::DoNotOptimize(func(1));
+    }
+}
+
 void BM_futureIntDeferredThen(benchmark::State& state) {
+    AllocationCounter allocs(state);
     for (auto _ : state) {
         benchmark::ClobberMemory();
         auto pf = makePromiseFuture<int>();
@@ -95,6 +183,7 @@ void BM_futureIntDeferredThen(benchmark::State& state) {
 }
 
 void BM_futureIntDeferredThenImmediate(benchmark::State& state) {
+    AllocationCounter allocs(state);
     for (auto _ : state) {
         benchmark::ClobberMemory();
         auto pf = makePromiseFuture<int>();
@@ -106,6 +195,7 @@ void BM_futureIntDeferredThenImmediate(benchmark::State& state) {
 
 
 void BM_futureIntDeferredThenReady(benchmark::State& state) {
+    AllocationCounter allocs(state);
     for (auto _ : state) {
         benchmark::ClobberMemory();
         auto pf = makePromiseFuture<int>();
@@ -116,6 +206,7 @@ void BM_futureIntDeferredThenReady(benchmark::State& state) {
 }
 
 void BM_futureIntDoubleDeferredThen(benchmark::State& state) {
+    AllocationCounter allocs(state);
     for (auto _ : state) {
         benchmark::ClobberMemory();
         auto pf1 = makePromiseFuture<int>();
@@ -128,6 +219,7 @@ void BM_futureIntDoubleDeferredThen(benchmark::State& state) {
 }
 
 void BM_futureInt3xDeferredThenNested(benchmark::State& state) {
+    AllocationCounter allocs(state);
     for (auto _ : state) {
         benchmark::ClobberMemory();
         auto pf1 = makePromiseFuture<int>();
@@ -144,6 +236,7 @@ void BM_futureInt3xDeferredThenNested(benchmark::State& state) {
 }
 
 void BM_futureInt3xDeferredThenChained(benchmark::State& state) {
+    AllocationCounter allocs(state);
     for (auto _ : state) {
         benchmark::ClobberMemory();
         auto pf1 = makePromiseFuture<int>();
@@ -161,6 +254,7 @@ void BM_futureInt3xDeferredThenChained(benchmark::State& state) {
 
 
 void BM_futureInt4xDeferredThenNested(benchmark::State& state) {
+    AllocationCounter allocs(state);
     for (auto _ : state) {
         benchmark::ClobberMemory();
         auto pf1 = makePromiseFuture<int>();
@@ -181,6 +275,7 @@ void BM_futureInt4xDeferredThenNested(benchmark::State& state) {
 }
 
 void BM_futureInt4xDeferredThenChained(benchmark::State& state) {
+    AllocationCounter allocs(state);
     for (auto _ : state) {
         benchmark::ClobberMemory();
         auto pf1 = makePromiseFuture<int>();
@@ -205,6 +300,9 @@ BENCHMARK(BM_futureIntReady);
 BENCHMARK(BM_futureIntReadyThen);
 BENCHMARK(BM_futureIntReadyWithPromise);
 BENCHMARK(BM_futureIntReadyWithPromiseThen);
+BENCHMARK(BM_futureIntReadyErrorThen);
+BENCHMARK(BM_uniqueFunctionSmall);
+BENCHMARK(BM_uniqueFunctionLarge);
 BENCHMARK(BM_futureIntDeferredThen);
 BENCHMARK(BM_futureIntDeferredThenImmediate);
 BENCHMARK(BM_futureIntDeferredThenReady);
@@ -804,7 +804,10 @@ public:
     }
 
     static FutureImpl<T> makeReady(Status status) {
-        return FutureImpl(SharedStateHolder<T>::makeReady(std::move(status)));
+        invariant(!status.isOK());
+        FutureImpl out;
+        out._immediateError = std::move(status);
+        return out;
     }
 
     static FutureImpl<T> makeReady(StatusWith<T> val) {
@@ -816,17 +819,17 @@ public:
     SharedSemiFuture<FakeVoidToVoid<T>> share() && noexcept;
 
     bool isReady() const {
-        return _immediate || _shared.isReady();
+        return _immediate || !_immediateError.isOK() || _shared.isReady();
     }
 
     void wait(Interruptible* interruptible) const {
-        if (_immediate)
+        if (_immediate || !_immediateError.isOK())
             return;
         _shared.wait(interruptible);
     }
 
     Status waitNoThrow(Interruptible* interruptible) const noexcept {
-        if (_immediate)
+        if (_immediate || !_immediateError.isOK())
             return Status::OK();
         return _shared.waitNoThrow(interruptible);
     }
@@ -834,27 +837,34 @@ public:
     T get(Interruptible* interruptible) && {
         if (_immediate)
             return std::move(*_immediate);
+        uassertStatusOK(std::move(_immediateError));
         return std::move(_shared).get(interruptible);
     }
     T& get(Interruptible* interruptible) & {
         if (_immediate)
             return *_immediate;
+        uassertStatusOK(_immediateError);
         return _shared.get(interruptible);
     }
     const T& get(Interruptible* interruptible) const& {
         if (_immediate)
             return *_immediate;
+        uassertStatusOK(_immediateError);
         return _shared.get(interruptible);
     }
 
     StatusWith<T> getNoThrow(Interruptible* interruptible) && noexcept {
         if (_immediate)
             return std::move(*_immediate);
+        if (!_immediateError.isOK())
+            return std::move(_immediateError);
         return std::move(_shared).getNoThrow(interruptible);
     }
     StatusWith<T> getNoThrow(Interruptible* interruptible) const& noexcept {
         if (_immediate)
             return *_immediate;
+        if (!_immediateError.isOK())
+            return _immediateError;
         return _shared.getNoThrow(interruptible);
     }
 
@@ -1091,7 +1101,7 @@ public:
             std::is_same_v<VoidToFakeVoid<UnwrappedType<Result>>, T>,
             "func passed to Future<T>::onError must return T, StatusWith<T>, or Future<T>");
 
-        if (_immediate || (isReady() && _shared->status.isOK()))
+        if (_isReadyAndOK())
             return std::move(*this);  // Avoid copy/moving func if we know we won't call it.
 
         // TODO in C++17 with constexpr if this can be done cleaner and more efficiently by not
@@ -1111,7 +1121,7 @@ public:
                       "func passed to Future<T>::onErrorCategory must return T, StatusWith<T>, "
                       "or Future<T>");
 
-        if (_immediate || (isReady() && _shared->status.isOK()))
+        if (_isReadyAndOK())
             return std::move(*this);
 
         return std::move(*this).onError([func =
@@ -1200,6 +1210,9 @@ private:
         if (_immediate) {
             return success(std::move(*_immediate));
         }
+        if (!_immediateError.isOK()) {
+            return fail(std::move(_immediateError));
+        }
 
         auto oldState = _shared->state.load(std::memory_order_acquire);
         dassert(oldState != SSBState::kHaveCallback);
@@ -1260,6 +1273,14 @@ private:
             });
     }
 
+    bool _isReadyAndOK() {
+        if (_immediate)
+            return true;
+        if (!_immediateError.isOK())
+            return false;
+        return _shared.isReady() && _shared->status.isOK();
+    }
+
     template <typename Result, typename OnReady>
     inline FutureImpl<Result> makeContinuation(OnReady&& onReady) {
         invariant(!_shared->callback && !_shared->continuation);
@@ -1276,8 +1297,10 @@ private:
         return FutureImpl<Result>(SharedStateHolder<Result>(std::move(continuation)));
     }
 
-    // At most one of these will be active.
+    // At most one of these will be active. Futures that are ready at construction use _immediate or
+    // _immediateError so that they never allocate a SharedState.
     boost::optional<T> _immediate;
+    Status _immediateError = Status::OK();
     SharedStateHolder<T> _shared;
 };
 
@@ -0,0 +1,171 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kControl
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/hardware_counters.h"
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+BSONObj HardwareCounterSample::toBSON() const {
+    BSONObjBuilder builder;
+    builder.append("instructions", instructions);
+    builder.append("cycles", cycles);
+    builder.append("cacheMisses", cacheMisses);
+    builder.append("branchMisses", branchMisses);
+    return builder.obj();
+}
+
+#if defined(__linux__)
+
+namespace {
+
+constexpr uint64_t kEvents[] = {
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+};
+constexpr size_t kNumEvents = sizeof(kEvents) / sizeof(kEvents[0]);
+
+AtomicWord<bool> loggedUnavailable{false};
+
+/**
+ * The counters of one thread, opened as a single perf event group so that one read(2) returns all
+ * of them, scheduled onto the PMU together.
+ */
+class CounterGroup {
+public:
+    CounterGroup() {
+        for (size_t i = 0; i < kNumEvents; ++i) {
+            perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = kEvents[i];
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            // Measure the calling thread on whichever CPU it runs.
+            const int groupFd = i == 0 ? -1 : _fds[0];
+            const long fd =
+                syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, PERF_FLAG_FD_CLOEXEC);
+            if (fd < 0) {
+                const int err = errno;
+                if (!loggedUnavailable.swap(true)) {
+                    warning() << "Hardware performance counters are unavailable: "
+                              << errnoWithDescription(err);
+                }
+                _close();
+                return;
+            }
+            _fds[i] = static_cast<int>(fd);
+        }
+    }
+
+    ~CounterGroup() {
+        _close();
+    }
+
+    boost::optional<HardwareCounterSample> read() const {
+        if (_fds[0] < 0) {
+            return boost::none;
+        }
+
+        struct {
+            uint64_t nr;
+            uint64_t timeEnabled;
+            uint64_t timeRunning;
+            uint64_t values[kNumEvents];
+        } data;
+        if (::read(_fds[0], &data, sizeof(data)) != sizeof(data) || data.nr != kNumEvents) {
+            return boost::none;
+        }
+
+        // When more events are requested than the PMU has counters, the kernel multiplexes them
+        // and the raw values only cover the time the group was running.
+        const double scale = (data.timeRunning == 0 || data.timeRunning >= data.timeEnabled)
+            ? 1.0
+            : static_cast<double>(data.timeEnabled) / data.timeRunning;
+        auto scaled = [&](size_t i) { return static_cast<long long>(data.values[i] * scale); };
+
+        HardwareCounterSample sample;
+        sample.instructions = scaled(0);
+        sample.cycles = scaled(1);
+        sample.cacheMisses = scaled(2);
+        sample.branchMisses = scaled(3);
+        return sample;
+    }
+
+private:
+    void _close() {
+        for (auto& fd : _fds) {
+            if (fd >= 0) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+    }
+
+    int _fds[kNumEvents] = {-1, -1, -1, -1};
+};
+
+}  // namespace
+
+boost::optional<HardwareCounterSample> ThreadHardwareCounters::read() {
+    thread_local const CounterGroup group;
+    return group.read();
+}
+
+#else
+
+boost::optional<HardwareCounterSample> ThreadHardwareCounters::read() {
+    return boost::none;
+}
+
+#endif
+
+}  // namespace mongo
@@ -0,0 +1,79 @@
+/**
+ *    Copyright (C) 2018-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+/**
+ * Hardware performance counter values, counting user space execution only.
+ */
+struct HardwareCounterSample {
+    BSONObj toBSON() const;
+
+    HardwareCounterSample& operator-=(const HardwareCounterSample& other) {
+        instructions -= other.instructions;
+        cycles -= other.cycles;
+        cacheMisses -= other.cacheMisses;
+        branchMisses -= other.branchMisses;
+        return *this;
+    }
+
+    friend HardwareCounterSample operator-(HardwareCounterSample lhs,
+                                           const HardwareCounterSample& rhs) {
+        return lhs -= rhs;
+    }
+
+    long long instructions = 0;
+    long long cycles = 0;
+    long long cacheMisses = 0;
+    long long branchMisses = 0;
+};
+
+/**
+ * Reads the hardware performance counters of the calling thread. On Linux the counters are opened
+ * through perf_event_open(2) the first time a thread reads them, and stay open until the thread
+ * exits. Reading them costs a single read(2).
+ */
+class ThreadHardwareCounters {
+public:
+    /**
+     * Returns the counters accumulated by the calling thread since they were opened, or
+     * boost::none if hardware counters are unavailable on this platform or to this process, for
+     * example because of the kernel.perf_event_paranoid setting or a hypervisor that does not
+     * expose them.
+     */
+    static boost::optional<HardwareCounterSample> read();
+};
+
+}  // namespace mongo
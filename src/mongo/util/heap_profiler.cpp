@@ -34,11 +34,16 @@
 #include "mongo/base/init.h"
 #include "mongo/base/static_assert.h"
 #include "mongo/config.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/commands.h"
 #include "mongo/db/commands/server_status.h"
 #include "mongo/util/log.h"
 #include "mongo/util/stacktrace.h"
 #include "mongo/util/tcmalloc_parameters_gen.h"
 
+#include <chrono>
+#include <cmath>
 #include <gperftools/malloc_hook.h>
 #include <third_party/murmurhash3/MurmurHash3.h>
 
@@ -96,7 +101,14 @@
 // Each new stack encountered is also logged to mongod log with a message like
 //     .... stack_n_: {0: "frame0", 1: "frame1", ...}
 //
-// Can be used in one of two ways:
+// With --setParameter heapProfilingPoissonSampling=true each thread instead samples its own
+// allocations as a Poisson process over allocated bytes, with a mean of sampleIntervalBytes between
+// samples, and charges each sampled allocation of s bytes with the unbiased estimate
+// s / (1 - exp(-s / sampleIntervalBytes)). This avoids updating the shared bytesAllocated counter
+// on every allocation, which makes the profiler cheap enough to leave enabled; bytesAllocated then
+// only reflects the sampled estimate.
+//
+// Can be used in one of three ways:
 //
 // Via FTDC - strings are not captured by FTDC, so the information
 // recorded in FTDC for each sample is essentially of the form
@@ -111,6 +123,11 @@
 // be obtained and examined manually, and can be further processed by
 // tools.
 //
+// Via the heapProfileTopSites command - returns, on demand, the stacks with the most active
+// bytes, e.g. {heapProfileTopSites: 1, limit: 10}. Each frame is reported both as a demangled
+// name and in the {b: base, o: offset, s: symbol} form used by the backtraces that mongod logs,
+// so that the sites can be symbolized offline against the same binary.
+//
 // We will need about 1 active ObjInfo for every sampleIntervalBytes live bytes,
 // so max active memory we can handle is sampleIntervalBytes * kMaxObjInfos.
 // With the current defaults of
@@ -285,6 +302,9 @@ private:
     stdx::mutex hashtable_mutex;  // guards updates to both object and stack hash tables
     stdx::mutex stackinfo_mutex;  // guards against races updating the StackInfo bson representation
 
+    // whether samples are taken by the per-thread Poisson process rather than bytesAllocated
+    bool poissonSampling = false;
+
     // cumulative bytes allocated - determines when samples are taken
     std::atomic_size_t bytesAllocated{0};  // NOLINT
 
@@ -383,6 +403,49 @@ private:
         log() << msg;
     }
 
+    // Per-thread state for Poisson sampling. Only constant-initialized members, so that touching
+    // it from within the allocator hook never allocates.
+    struct PoissonSampleState {
+        bool initialized;
+        size_t bytesUntilSample;
+        uint64_t randomState;
+    };
+    static thread_local PoissonSampleState poissonSampleState;
+
+    // Draws the number of bytes until the next sample from an exponential distribution with a
+    // mean of sampleIntervalBytes.
+    static size_t nextPoissonSampleGap(PoissonSampleState& state, size_t interval) {
+        // xorshift64*; cheap, allocation-free, and good enough to space out samples.
+        state.randomState ^= state.randomState >> 12;
+        state.randomState ^= state.randomState << 25;
+        state.randomState ^= state.randomState >> 27;
+        const uint64_t random = state.randomState * 0x2545F4914F6CDD1DULL;
+        const double uniform = ((random >> 11) + 1) * (1.0 / (1ULL << 53));  // in (0, 1]
+        return static_cast<size_t>(-std::log(uniform) * interval) + 1;
+    }
+
+    // Returns the number of bytes to charge for an allocation of 'objLen' bytes, or 0 if it is not
+    // sampled.
+    size_t poissonAccountedLen(size_t objLen, size_t interval) {
+        auto& state = poissonSampleState;
+        if (!state.initialized) {
+            state.randomState = reinterpret_cast<uintptr_t>(&state) ^
+                std::chrono::steady_clock::now().time_since_epoch().count();
+            state.randomState |= 1;
+            state.bytesUntilSample = nextPoissonSampleGap(state, interval);
+            state.initialized = true;
+        }
+
+        if (objLen < state.bytesUntilSample) {
+            state.bytesUntilSample -= objLen;
+            return 0;
+        }
+        state.bytesUntilSample = nextPoissonSampleGap(state, interval);
+
+        const double sampleProbability = -std::expm1(-static_cast<double>(objLen) / interval);
+        return std::max(objLen, static_cast<size_t>(objLen / sampleProbability));
+    }
+
     //
     // Record an allocation.
     //
@@ -391,16 +454,24 @@ private:
         if (sampleIntervalBytes == 0)
             return;
 
-        // Sample every sampleIntervalBytes bytes of allocation.
-        // We charge each sampled stack with the amount of memory allocated since the last sample
-        // this could grossly overcharge any given stack sample, but on average over a large
-        // number of samples will be correct.
-        size_t lastSample = bytesAllocated.fetch_add(objLen);
-        size_t currentSample = lastSample + objLen;
-        size_t accountedLen = sampleIntervalBytes *
-            (currentSample / sampleIntervalBytes - lastSample / sampleIntervalBytes);
-        if (accountedLen == 0)
-            return;
+        size_t accountedLen;
+        if (poissonSampling) {
+            accountedLen = poissonAccountedLen(objLen, sampleIntervalBytes);
+            if (accountedLen == 0)
+                return;
+            bytesAllocated.fetch_add(accountedLen);
+        } else {
+            // Sample every sampleIntervalBytes bytes of allocation.
+            // We charge each sampled stack with the amount of memory allocated since the last
+            // sample this could grossly overcharge any given stack sample, but on average over a
+            // large number of samples will be correct.
+            size_t lastSample = bytesAllocated.fetch_add(objLen);
+            size_t currentSample = lastSample + objLen;
+            accountedLen = sampleIntervalBytes *
+                (currentSample / sampleIntervalBytes - lastSample / sampleIntervalBytes);
+            if (accountedLen == 0)
+                return;
+        }
 
         // Get backtrace.
         Stack tempStack;
@@ -601,6 +672,65 @@ private:
         }
     }
 
+    //
+    // Generate the heapProfileTopSites command response.
+    //
+
+    void _generateTopSites(BSONObjBuilder& builder, size_t limit) {
+        builder.append("poissonSampling", poissonSampling);
+        builder.appendNumber("sampleIntervalBytes", sampleIntervalBytes);
+        builder.appendNumber("totalActiveBytes", totalActiveBytes);
+        builder.appendNumber("numStacks", stackHashTable.size());
+
+        // Guard against races updating the StackInfo bson representation; see
+        // _generateServerStatusSection() for why traversing stackHashTable is safe.
+        stdx::lock_guard<stdx::mutex> lk(stackinfo_mutex);
+
+        // Snapshot activeBytes, which allocating threads may update while we sort.
+        struct Site {
+            size_t activeBytes;
+            Stack* stack;
+            StackInfo* stackInfo;
+        };
+        std::vector<Site> sites;
+        stackHashTable.forEach([&](Stack& stack, StackInfo& stackInfo) {
+            if (size_t activeBytes = stackInfo.activeBytes)
+                sites.push_back({activeBytes, &stack, &stackInfo});
+        });
+        std::sort(sites.begin(), sites.end(), [](const Site& a, const Site& b) {
+            return a.activeBytes > b.activeBytes;
+        });
+        if (sites.size() > limit)
+            sites.resize(limit);
+
+        BSONArrayBuilder sitesBuilder(builder.subarrayStart("sites"));
+        for (auto&& site : sites) {
+            generateStackIfNeeded(*site.stack, *site.stackInfo);
+            BSONObjBuilder siteBuilder(sitesBuilder.subobjStart());
+            siteBuilder.append("stackNum", site.stackInfo->stackNum);
+            siteBuilder.appendNumber("activeBytes", site.activeBytes);
+            siteBuilder.append("stack", site.stackInfo->stackObj);
+
+            BSONArrayBuilder framesBuilder(siteBuilder.subarrayStart("backtrace"));
+            for (int j = skipStartFrames; j < site.stack->numFrames - skipEndFrames; j++) {
+                BSONObjBuilder frameBuilder(framesBuilder.subobjStart());
+                Dl_info dli;
+                if (!dladdr(site.stack->frames[j], &dli)) {
+                    dli.dli_fbase = nullptr;
+                    dli.dli_sname = nullptr;
+                }
+                std::ostringstream base, offset;
+                base << std::hex << std::uppercase << uintptr_t(dli.dli_fbase);
+                offset << std::hex << std::uppercase
+                       << uintptr_t(site.stack->frames[j]) - uintptr_t(dli.dli_fbase);
+                frameBuilder.append("b", base.str());
+                frameBuilder.append("o", offset.str());
+                if (dli.dli_sname)
+                    frameBuilder.append("s", dli.dli_sname);
+            }
+        }
+    }
+
     //
     // Static hooks to give to the allocator.
     //
@@ -619,6 +749,7 @@ public:
     HeapProfiler() {
         // Set sample interval from the parameter.
         sampleIntervalBytes = HeapProfilingSampleIntervalBytes;
+        poissonSampling = HeapProfilingPoissonSampling;
 
         // This is our only allocator dependency - ifdef and change as
         // appropriate for other allocators, using hooks or shims.
@@ -634,8 +765,15 @@ public:
         if (heapProfiler)
             heapProfiler->_generateServerStatusSection(builder);
     }
+
+    static void generateTopSites(BSONObjBuilder& builder, size_t limit) {
+        if (heapProfiler)
+            heapProfiler->_generateTopSites(builder, limit);
+    }
 };
 
+thread_local HeapProfiler::PoissonSampleState HeapProfiler::poissonSampleState;
+
 //
 // serverStatus section
 //
@@ -656,6 +794,61 @@ public:
     }
 } heapProfilerServerStatusSection;
 
+//
+// heapProfileTopSites command
+//
+
+class CmdHeapProfileTopSites final : public BasicCommand {
+public:
+    CmdHeapProfileTopSites() : BasicCommand("heapProfileTopSites") {}
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kAlways;
+    }
+
+    bool adminOnly() const override {
+        return true;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    std::string help() const override {
+        return "returns the heap profiler's allocation sites with the most active bytes; "
+               "{heapProfileTopSites: 1, limit: <number of sites, default 20>}";
+    }
+
+    Status checkAuthForCommand(Client* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) const override {
+        bool isAuthorized = AuthorizationSession::get(client)->isAuthorizedForActionsOnResource(
+            ResourcePattern::forClusterResource(), ActionType::serverStatus);
+        return isAuthorized ? Status::OK() : Status(ErrorCodes::Unauthorized, "Unauthorized");
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        uassert(ErrorCodes::IllegalOperation,
+                "heap profiling is not enabled; start the server with "
+                "--setParameter heapProfilingEnabled=true",
+                HeapProfilingEnabled);
+
+        long long limit = 20;
+        if (auto limitElem = cmdObj["limit"]) {
+            uassert(ErrorCodes::BadValue,
+                    "'limit' must be a positive number",
+                    limitElem.isNumber() && limitElem.safeNumberLong() > 0);
+            limit = limitElem.safeNumberLong();
+        }
+
+        HeapProfiler::generateTopSites(result, static_cast<size_t>(limit));
+        return true;
+    }
+} cmdHeapProfileTopSites;
+
 //
 // startup
 //
@@ -70,7 +70,11 @@ public:
     };
 
     friend void intrusive_ptr_release(const RefCountable* ptr) {
-        if (ptr->_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        // A count of one means the caller holds the only reference, so no other thread can add or
+        // drop one concurrently and the atomic decrement can be skipped. Most pipeline values are
+        // released this way. The acquire load pairs with the release half of other decrements.
+        if (ptr->_count.load(std::memory_order_acquire) == 1 ||
+            ptr->_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
             delete ptr;
         }
     };
@@ -246,6 +246,13 @@ public:
         SSLConnectionType ssl,
         const std::string& remoteHost,
         const HostAndPort& hostForLogging) = 0;
+
+    /**
+     * Offers the TLS session cached from an earlier outgoing connection to "target", if any, on a
+     * connection which has not yet started its handshake, so that the handshake may resume it.
+     * Providers which do not cache client sessions ignore this.
+     */
+    virtual void prepareClientSessionResumption(SSLConnectionType ssl, const HostAndPort& target) {}
 };
 
 // Access SSL functions through this instance.
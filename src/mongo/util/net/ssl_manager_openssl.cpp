@@ -49,6 +49,8 @@
 #include "mongo/config.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/transport/session.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/debug_util.h"
@@ -59,6 +61,7 @@
 #include "mongo/util/net/private/ssl_expiration.h"
 #include "mongo/util/net/socket_exception.h"
 #include "mongo/util/net/ssl_options.h"
+#include "mongo/util/net/ssl_parameters_gen.h"
 #include "mongo/util/net/ssl_types.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/str.h"
@@ -388,6 +391,70 @@ static const int DATE_LEN = 128;
 
 using UniqueX509 = std::unique_ptr<X509, OpenSSLDeleter<decltype(X509_free), ::X509_free>>;
 
+using UniqueSSLSession =
+    std::unique_ptr<SSL_SESSION, OpenSSLDeleter<decltype(::SSL_SESSION_free), ::SSL_SESSION_free>>;
+
+/**
+ * Holds the most recent session issued to outgoing connections for each "host:port", so that
+ * later connections to the same server can resume it instead of doing a full handshake.
+ */
+class ClientSessionCache {
+public:
+    static constexpr size_t kMaxSessions = 1024;
+
+    static ClientSessionCache& get() {
+        static ClientSessionCache cache;
+        return cache;
+    }
+
+    /**
+     * Offers the session cached for "key" to "ssl" and tags "ssl" with "key", so that the session
+     * the server issues on it replaces the cached one.
+     */
+    void prepare(SSL* ssl, const std::string& key) {
+        SSL_set_ex_data(ssl, _keyIndex, new std::string(key));
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _sessions.find(key);
+        if (it != _sessions.end()) {
+            // SSL_set_session() takes its own reference to the session.
+            ::SSL_set_session(ssl, it->second.get());
+        }
+    }
+
+    /**
+     * Registered with SSL_CTX_sess_set_new_cb(). Takes ownership of "session" if "ssl" was
+     * prepared for resumption.
+     */
+    static int onNewSession(SSL* ssl, SSL_SESSION* session) {
+        auto& cache = get();
+        auto key = static_cast<std::string*>(SSL_get_ex_data(ssl, cache._keyIndex));
+        if (!key) {
+            return 0;
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(cache._mutex);
+        if (cache._sessions.size() >= kMaxSessions && !cache._sessions.count(*key)) {
+            cache._sessions.erase(cache._sessions.begin());
+        }
+        cache._sessions[*key] = UniqueSSLSession(session);
+        return 1;
+    }
+
+private:
+    ClientSessionCache()
+        : _keyIndex(SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, &_freeKey)) {}
+
+    static void _freeKey(void*, void* ptr, CRYPTO_EX_DATA*, int, long, void*) {
+        delete static_cast<std::string*>(ptr);
+    }
+
+    const int _keyIndex;
+
+    stdx::mutex _mutex;
+    stdx::unordered_map<std::string, UniqueSSLSession> _sessions;
+};
+
 class SSLManagerOpenSSL : public SSLManagerInterface {
 public:
     explicit SSLManagerOpenSSL(const SSLParams& params, bool isServer);
@@ -411,6 +478,8 @@ public:
     StatusWith<boost::optional<SSLPeerInfo>> parseAndValidatePeerCertificate(
         SSL* conn, const std::string& remoteHost, const HostAndPort& hostForLogging) final;
 
+    void prepareClientSessionResumption(SSL* ssl, const HostAndPort& target) final;
+
     const SSLConfiguration& getSSLConfiguration() const final {
         return _sslConfiguration;
     }
@@ -923,6 +992,14 @@ Status SSLManagerOpenSSL::initSSLContext(SSL_CTX* context,
                                     << getSSLErrorMessage(ERR_get_error()));
     }
 
+    // Servers cache sessions and issue session tickets by default. Clients only resume sessions
+    // they are handed, so keep the ones servers issue to us for later connections.
+    if (direction == ConnectionDirection::kOutgoing && gTLSClientSessionResumption) {
+        ::SSL_CTX_set_session_cache_mode(context,
+                                         SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        ::SSL_CTX_sess_set_new_cb(context, &ClientSessionCache::onNewSession);
+    }
+
     if (direction == ConnectionDirection::kOutgoing && params.tlsWithholdClientCertificate) {
         // Do not send a client certificate if they have been suppressed.
 
@@ -1005,6 +1082,12 @@ Status SSLManagerOpenSSL::initSSLContext(SSL_CTX* context,
     return Status::OK();
 }
 
+void SSLManagerOpenSSL::prepareClientSessionResumption(SSL* ssl, const HostAndPort& target) {
+    if (gTLSClientSessionResumption) {
+        ClientSessionCache::get().prepare(ssl, target.toString());
+    }
+}
+
 bool SSLManagerOpenSSL::_initSynchronousSSLContext(UniqueSSLContext* contextPtr,
                                                    const SSLParams& params,
                                                    ConnectionDirection direction) {
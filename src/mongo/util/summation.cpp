@@ -87,4 +87,76 @@ long long DoubleDoubleSummation::getLong() const {
     sum += llround((_sum - sum) + _addend);
     return sum;
 }
+
+namespace {
+// The largest coefficient of a Decimal128, 10**34 - 1, split into its high and low 64 bits.
+const uint64_t kMaxCoefficientHigh = 0x0001ed09bead87c0ull;
+const uint64_t kMaxCoefficientLow = 0x378d8e63ffffffffull;
+
+/**
+ * Returns whether the 128-bit unsigned integer a is less than b.
+ */
+bool lessThan(uint64_t aHigh, uint64_t aLow, uint64_t bHigh, uint64_t bLow) {
+    return aHigh < bHigh || (aHigh == bHigh && aLow < bLow);
+}
+}  // namespace
+
+void DecimalSummation::add(const Decimal128& x) {
+    const uint32_t exponent = x.getBiasedExponent();
+    const uint64_t high = x.getCoefficientHigh();
+    const uint64_t low = x.getCoefficientLow();
+    if (exponent > Decimal128::kMaxBiasedExponent ||
+        lessThan(kMaxCoefficientHigh, kMaxCoefficientLow, high, low)) {
+        // NaNs, infinities and non-canonical coefficients are left to the decimal library.
+        _flushRun();
+        _total = _total.add(x);
+        return;
+    }
+
+    const bool negative = x.getValue().high64 >> 63;
+    if (_runActive && exponent == _runExponent) {
+        if (negative != _runNegative) {
+            // Subtract the smaller magnitude from the larger one, which cannot overflow.
+            if (lessThan(_runHigh, _runLow, high, low)) {
+                _runHigh = high - _runHigh - (low < _runLow);
+                _runLow = low - _runLow;
+                _runNegative = negative;
+            } else {
+                _runHigh = _runHigh - high - (_runLow < low);
+                _runLow = _runLow - low;
+            }
+            return;
+        }
+
+        // Both magnitudes are below 2**113, so their sum cannot overflow 128 bits.
+        const uint64_t sumLow = _runLow + low;
+        const uint64_t sumHigh = _runHigh + high + (sumLow < low);
+        if (!lessThan(kMaxCoefficientHigh, kMaxCoefficientLow, sumHigh, sumLow)) {
+            _runHigh = sumHigh;
+            _runLow = sumLow;
+            return;
+        }
+        // The sum needs more than 34 digits, so let the decimal library round it.
+    }
+
+    _flushRun();
+    _runActive = true;
+    _runNegative = negative;
+    _runExponent = exponent;
+    _runHigh = high;
+    _runLow = low;
+}
+
+Decimal128 DecimalSummation::_runToDecimal() const {
+    // Runs that cancel out produce a positive zero, as Decimal128::add() would.
+    const bool negative = _runNegative && (_runHigh || _runLow);
+    return Decimal128(negative, _runExponent, _runHigh, _runLow);
+}
+
+void DecimalSummation::_flushRun() {
+    if (!_runActive)
+        return;
+    _total = _total.add(_runToDecimal());
+    _runActive = false;
+}
 }  // namespace mongo
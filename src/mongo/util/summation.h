@@ -152,4 +152,48 @@ private:
     // using compensated addition.
     double _special = 0.0;
 };
+
+/**
+ * Class to sum a series of Decimal128 values. Consecutive finite values with the same exponent are
+ * accumulated exactly by adding their coefficients as 128-bit integers, and only folded into the
+ * decimal total using the decimal library when the exponent changes, the coefficient sum outgrows
+ * 34 digits or a NaN or infinity is added. Unless an intermediate sum needs rounding, the result
+ * is identical to adding all values to 0E0 one at a time using Decimal128::add().
+ */
+class DecimalSummation {
+public:
+    /**
+     * Adds x to the sum.
+     */
+    void add(const Decimal128& x);
+
+    /**
+     * Returns the accumulated sum.
+     */
+    Decimal128 getDecimal() const {
+        return _runActive ? _total.add(_runToDecimal()) : _total;
+    }
+
+private:
+    /**
+     * Returns the sum of the current run as a Decimal128.
+     */
+    Decimal128 _runToDecimal() const;
+
+    /**
+     * Folds the current run, if any, into _total.
+     */
+    void _flushRun();
+
+    // Sum of all values that are not part of the current run.
+    Decimal128 _total;
+
+    // The current run is the sum of values sharing _runExponent. Its coefficient is kept as a
+    // 128-bit magnitude and sign, and never exceeds the largest 34 digit coefficient.
+    bool _runActive = false;
+    bool _runNegative = false;
+    uint32_t _runExponent = 0;
+    uint64_t _runHigh = 0;
+    uint64_t _runLow = 0;
+};
 }  // namespace mongo
@@ -204,4 +204,81 @@ TEST(Summation, AddDoubles) {
     ASSERT_EQUALS(sum.getDouble(), doubleValuesSum);
     ASSERT(straightSum != sum.getDouble());
 }
+
+namespace {
+void assertSameDecimal(Decimal128 expected, Decimal128 actual) {
+    ASSERT_EQUALS(expected.toString(), actual.toString());
+    ASSERT_EQUALS(expected.getValue().high64, actual.getValue().high64);
+    ASSERT_EQUALS(expected.getValue().low64, actual.getValue().low64);
+}
+
+Decimal128 addOneAtATime(const std::vector<Decimal128>& values) {
+    Decimal128 total;
+    for (auto&& x : values) {
+        total = total.add(x);
+    }
+    return total;
+}
+
+DecimalSummation sumDecimals(const std::vector<Decimal128>& values) {
+    DecimalSummation sum;
+    for (auto&& x : values) {
+        sum.add(x);
+    }
+    return sum;
+}
+}  // namespace
+
+TEST(Summation, AddDecimalsMatchesDecimalAdd) {
+    // Long runs of values sharing an exponent, followed by values alternating between exponents.
+    std::vector<Decimal128> values;
+    for (int i = -500; i < 1000; ++i) {
+        values.push_back(Decimal128(std::to_string(i) + ".25"));
+    }
+    for (int i = -500; i < 1000; ++i) {
+        values.push_back(Decimal128(std::to_string(-3 * i) + "E3"));
+    }
+    for (int i = -500; i < 1000; ++i) {
+        values.push_back(Decimal128(std::to_string(i * 7) + ".5"));
+        values.push_back(Decimal128(std::to_string(-3 * i)));
+    }
+    values.push_back(Decimal128("-0.00"));
+    values.push_back(Decimal128("1.000000000000000000000000000000001"));
+    values.push_back(Decimal128::kLargestNegativeExponentZero);
+
+    assertSameDecimal(addOneAtATime(values), sumDecimals(values).getDecimal());
+}
+
+TEST(Summation, AddDecimalsCancellingOut) {
+    std::vector<Decimal128> values = {
+        Decimal128("12.34"), Decimal128("-0.01"), Decimal128("-12.33"), Decimal128("-0.00")};
+    assertSameDecimal(addOneAtATime(values), sumDecimals(values).getDecimal());
+    ASSERT_EQUALS("0.00", sumDecimals(values).getDecimal().toString());
+    assertSameDecimal(Decimal128(), DecimalSummation().getDecimal());
+}
+
+TEST(Summation, AddDecimalsBeyond34Digits) {
+    const Decimal128 largest("9999999999999999999999999999999999");
+    assertSameDecimal(largest.add(Decimal128(1)),
+                      sumDecimals({largest, Decimal128(1)}).getDecimal());
+    assertSameDecimal(largest.add(largest).add(largest),
+                      sumDecimals({largest, largest, largest}).getDecimal());
+    assertSameDecimal(Decimal128::kLargestPositive,
+                      sumDecimals({Decimal128::kLargestPositive, Decimal128(-1)}).getDecimal());
+    assertSameDecimal(Decimal128::kPositiveInfinity,
+                      sumDecimals({Decimal128::kLargestPositive, Decimal128::kLargestPositive})
+                          .getDecimal());
+}
+
+TEST(Summation, AddDecimalsSpecial) {
+    ASSERT(sumDecimals({Decimal128(1), Decimal128::kPositiveNaN, Decimal128(2)})
+               .getDecimal()
+               .isNaN());
+    assertSameDecimal(
+        Decimal128::kNegativeInfinity,
+        sumDecimals({Decimal128(1), Decimal128::kNegativeInfinity, Decimal128(2)}).getDecimal());
+    ASSERT(sumDecimals({Decimal128::kPositiveInfinity, Decimal128::kNegativeInfinity})
+               .getDecimal()
+               .isNaN());
+}
 }  // namespace mongo
@@ -32,6 +32,8 @@
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/tick_source.h"
 #include "mongo/util/tick_source_mock.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/tsc_tick_source.h"
 
 namespace mongo {
 namespace {
@@ -52,5 +54,23 @@ TEST(TickSourceTest, TicksToDurationConversion) {
     tsMicros.reset(1);
     ASSERT_EQ(tsMicros.ticksTo<Microseconds>(tsMicros.getTicks()).count(), 1);
 }
+
+TEST(TickSourceTest, TscTickSourceMeasuresElapsedTime) {
+    auto tsc = TscTickSource::create();
+    if (!tsc) {
+        return;
+    }
+    ASSERT_GT(tsc->getTicksPerSecond(), 0);
+
+    const auto start = tsc->getTicks();
+    sleepmillis(100);
+    const auto end = tsc->getTicks();
+    ASSERT_GT(end, start);
+
+    // Generous bounds, since the sleep may overrun on a loaded machine.
+    const auto elapsed = tsc->ticksTo<Milliseconds>(end - start);
+    ASSERT_GTE(elapsed, Milliseconds(90));
+    ASSERT_LT(elapsed, Milliseconds(10 * 1000));
+}
 }
 }  // namespace mongo
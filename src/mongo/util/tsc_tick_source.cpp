@@ -0,0 +1,97 @@
+/**
+ *    Copyright (C) 2019-present MongoDB, Inc.
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the Server Side Public License, version 1,
+ *    as published by MongoDB, Inc.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    Server Side Public License for more details.
+ *
+ *    You should have received a copy of the Server Side Public License
+ *    along with this program. If not, see
+ *    <http://www.mongodb.com/licensing/server-side-public-license>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the Server Side Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/tsc_tick_source.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <cpuid.h>
+#include <x86intrin.h>
+#define MONGO_HAVE_TSC_TICK_SOURCE
+#endif
+
+#include "mongo/util/assert_util.h"
+#include "mongo/util/system_tick_source.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+namespace {
+
+// Long enough that the resolution of SystemTickSource does not skew the calibration.
+const long long kCalibrationMillis = 20;
+
+#if defined(MONGO_HAVE_TSC_TICK_SOURCE)
+bool hasInvariantTsc() {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    return edx & (1u << 8);
+}
+#endif
+
+}  // namespace
+
+std::unique_ptr<TscTickSource> TscTickSource::create() {
+#if defined(MONGO_HAVE_TSC_TICK_SOURCE)
+    if (!hasInvariantTsc()) {
+        return nullptr;
+    }
+
+    auto systemTickSource = SystemTickSource::get();
+    const auto systemStart = systemTickSource->getTicks();
+    const auto tscStart = __rdtsc();
+    sleepmillis(kCalibrationMillis);
+    const auto systemEnd = systemTickSource->getTicks();
+    const auto tscEnd = __rdtsc();
+
+    const double seconds = static_cast<double>(systemEnd - systemStart) /
+        systemTickSource->getTicksPerSecond();
+    if (seconds <= 0 || tscEnd <= tscStart) {
+        return nullptr;
+    }
+
+    return std::unique_ptr<TscTickSource>(
+        new TscTickSource(static_cast<TickSource::Tick>((tscEnd - tscStart) / seconds)));
+#else
+    return nullptr;
+#endif
+}
+
+TickSource::Tick TscTickSource::getTicks() {
+#if defined(MONGO_HAVE_TSC_TICK_SOURCE)
+    return __rdtsc();
+#else
+    MONGO_UNREACHABLE;
+#endif
+}
+
+}  // namespace mongo
@@ -131,6 +131,63 @@ TEST(UniqueFunctionTest, dtor_releases_functor_object_and_does_not_call_function
     ASSERT_FALSE(runDetection1.itRan);
 }
 
+struct Counts {
+    int live = 0;
+    int calls = 0;
+};
+
+// Tracks how many copies of a functor are alive, so that leaked or double-destroyed functors show
+// up whether they are held inline or on the heap.
+template <size_t padding>
+struct Tracked {
+    explicit Tracked(Counts* counts) : counts(counts) {
+        ++counts->live;
+    }
+    Tracked(Tracked&& other) noexcept : counts(other.counts) {
+        ++counts->live;
+    }
+    ~Tracked() {
+        --counts->live;
+    }
+    void operator()() {
+        ++counts->calls;
+    }
+
+    Counts* counts;
+    char pad[padding] = {};
+};
+
+TEST(UniqueFunctionTest, small_and_large_functors_survive_moves_and_swaps) {
+    Counts small;
+    Counts large;
+    {
+        mongo::unique_function<void()> smallFunc = Tracked<1>(&small);
+        mongo::unique_function<void()> largeFunc = Tracked<256>(&large);
+        ASSERT_EQ(1, small.live);
+        ASSERT_EQ(1, large.live);
+
+        smallFunc.swap(largeFunc);
+        smallFunc();
+        largeFunc();
+        ASSERT_EQ(1, small.calls);
+        ASSERT_EQ(1, large.calls);
+        ASSERT_EQ(1, small.live);
+        ASSERT_EQ(1, large.live);
+
+        mongo::unique_function<void()> moved = std::move(largeFunc);
+        ASSERT_FALSE(largeFunc);
+        moved();
+        ASSERT_EQ(2, small.calls);
+        ASSERT_EQ(1, small.live);
+
+        moved = std::move(smallFunc);
+        ASSERT_EQ(0, small.live);
+        ASSERT_EQ(1, large.live);
+    }
+    ASSERT_EQ(0, small.live);
+    ASSERT_EQ(0, large.live);
+}
+
 TEST(UniqueFunctionTest, comparison_checks) {
     mongo::unique_function<void()> uf;
 